@@ -0,0 +1,151 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file aux_spi_pins.h
+/// @brief Use GPIO pins with the auxiliary SPI masters SPI1 and SPI2:
+///        type definitions.
+///
+/// As well as the main SPI0 master the BCM2835 has two auxiliary SPI
+/// masters, SPI1 and SPI2, in its auxiliary peripherals block. Each is an
+/// independent bus with its own clock, shift register and 4 entry FIFOs, so
+/// devices can be spread over separate buses driven from different threads.
+/// SPI1 is available on GPIO pins 16 to 21, SPI2 on pins 40 to 45. For more
+/// details see the
+/// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+/// Broadcom BCM2835 ARM Peripherals Datasheet</a> Chapter 2 Auxiliaries.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_AUX_SPI_PINS_H
+# define DIBASE_RPI_PERIPHERALS_AUX_SPI_PINS_H
+
+# include "pin_id.h"
+# include "clockdefs.h"
+# include <array>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Pin id value for optional auxiliary SPI chip select pins
+  /// meaning the chip select line is not used.
+    constexpr pin_id_int_t aux_spi_pin_not_used{53U};
+
+  /// @brief Auxiliary SPI clock polarity values.
+  ///
+  /// As for the Linux driver, data is shifted out on the clock edge leaving
+  /// the idle state and in on the edge returning to it, giving SPI modes 0
+  /// (low) and 2 (high).
+    enum class aux_spi_clk_polarity
+    { low     ///< Clock idles low
+    , high    ///< Clock idles high
+    };
+
+  /// @brief Use GPIO pins with an auxiliary SPI master, SPI1 or SPI2.
+  ///
+  /// Which master is used is determined by the pins passed on construction,
+  /// which must all support functions of the same master. If the pins
+  /// support the functions and they and the master are not already in use
+  /// locally within the same process then the master is enabled and set up
+  /// and the pins allocated and set to their alt-fns. Note that no attempt
+  /// is made to see if the master is in use externally by other processes.
+  ///
+  /// Data is shifted most significant bit first. Byte transfers use the
+  /// masters' variable width mode with three bytes per FIFO entry, keeping
+  /// the chip select asserted from the first byte to the last.
+    class aux_spi_pins
+    {
+      constexpr static unsigned number_of_pins = 6U;
+
+      std::array<pin_id_int_t, number_of_pins>  pins;
+      std::size_t                               spi_idx;
+      std::uint32_t                             control0;
+
+      void select(unsigned chip);
+
+    public:
+    /// @brief Construct from GPIO pins and bus parameters.
+    ///
+    /// @param[in] sclk Pin to use for the master's SCLK function.
+    /// @param[in] mosi Pin to use for the master's MOSI function.
+    /// @param[in] miso Pin to use for the master's MISO function.
+    /// @param[in] ce0  Pin to use for the master's CE0 chip select function.
+    /// @param[in] f    SPI clock frequency. Must be in the range
+    ///                 [fc/8192, fc/2].
+    /// @param[in] cpol Clock polarity. Defaults to aux_spi_clk_polarity::low.
+    /// @param[in] ce1  Optional pin to use for the master's CE1 function,
+    ///                 default aux_spi_pin_not_used.
+    /// @param[in] ce2  Optional pin to use for the master's CE2 function,
+    ///                 default aux_spi_pin_not_used.
+    /// @param[in] fc   Frequency of core clock driving the master. Defaults to
+    ///                 \ref rpi_apb_core_frequency.
+    ///
+    /// @throws std::invalid_argument if any pin does not support the required
+    ///         function or the pins are for different masters.
+    /// @throws std::out_of_range if f is out of range.
+    /// @throws bad_peripheral_alloc if any of the pins or the master are
+    ///         already in use.
+      aux_spi_pins
+      ( pin_id sclk
+      , pin_id mosi
+      , pin_id miso
+      , pin_id ce0
+      , hertz f
+      , aux_spi_clk_polarity cpol = aux_spi_clk_polarity::low
+      , pin_id_int_t ce1 = aux_spi_pin_not_used
+      , pin_id_int_t ce2 = aux_spi_pin_not_used
+      , hertz fc = rpi_apb_core_frequency
+      );
+
+    /// @brief Destroy: disable the master and de-allocate GPIO pins.
+      ~aux_spi_pins();
+
+      aux_spi_pins(aux_spi_pins const &) = delete;
+      aux_spi_pins& operator=(aux_spi_pins const &) = delete;
+      aux_spi_pins(aux_spi_pins &&) = delete;
+      aux_spi_pins& operator=(aux_spi_pins &&) = delete;
+
+    /// @brief Returns the auxiliary SPI master in use: 1 for SPI1, 2 for SPI2
+      unsigned bus() const
+      {
+        return static_cast<unsigned>(spi_idx)+1U;
+      }
+
+    /// @brief Full-duplex transfer with a slave device.
+    ///
+    /// Blocks until count bytes have been written to and read from the slave
+    /// selected by chip, which is selected for the whole transfer.
+    ///
+    /// @param[in] chip   Chip select line of slave: 0, 1 or 2. The line's
+    ///                   pin must have been passed on construction.
+    /// @param[in] ptx    Bytes to write, or \c nullptr to write zeros.
+    /// @param[out] prx   Buffer for read bytes, or \c nullptr to discard them.
+    /// @param[in] count  Number of bytes to transfer.
+    /// @returns Number of bytes transferred.
+    /// @throws std::invalid_argument if chip is not a chip select line in use.
+      std::size_t transfer
+      ( unsigned chip
+      , std::uint8_t const * ptx
+      , std::uint8_t * prx
+      , std::size_t count
+      );
+
+    /// @brief Shift a word of 1 to 24 bits to and from a slave device.
+    ///
+    /// Uses the master's variable shift width so devices with word sizes that
+    /// are not a multiple of 8 bits can be driven directly.
+    ///
+    /// @param[in] chip   Chip select line of slave: 0, 1 or 2.
+    /// @param[in] data   Bits to write, right justified.
+    /// @param[in] bits   Number of bits to shift, 1 to 24.
+    /// @returns Bits read, right justified.
+    /// @throws std::invalid_argument if chip is not a chip select line in use
+    ///         or bits is out of range.
+      std::uint32_t transfer_bits
+      ( unsigned chip
+      , std::uint32_t data
+      , unsigned bits
+      );
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_AUX_SPI_PINS_H
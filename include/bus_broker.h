@@ -0,0 +1,238 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file bus_broker.h
+/// @brief Sharing SPI0 and I2C buses between processes through a broker
+/// process : class definitions
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_BUS_BROKER_H
+# define DIBASE_RPI_PERIPHERALS_BUS_BROKER_H
+
+# include "spi0_pins.h"
+# include "i2c_pins.h"
+# include <atomic>
+# include <cstddef>
+# include <cstdint>
+# include <memory>
+# include <thread>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      class bus_broker_channel;
+    }
+
+  /// @brief Perform SPI0 and I2C transactions for other processes.
+  ///
+  /// Only one process may own the SPI0 and each BSC I2C master peripheral.
+  /// A bus_broker lets other processes use them: the owning process creates
+  /// a bus_broker from its spi0_pins and/or i2c_pins objects and client
+  /// processes submit transactions through bus_broker_client objects.
+  ///
+  /// Requests pass through a POSIX shared memory object. Each request's
+  /// bytes are written and read in place in a buffer in the shared object,
+  /// so are not copied between processes. The broker's service thread is
+  /// woken by a futex when a request is submitted and wakes the submitting
+  /// client by a futex when the request is complete, so the broker adds a
+  /// few microseconds to each transaction rather than the milliseconds of
+  /// a socket round trip.
+  ///
+  /// SPI0 transactions are full-duplex standard mode transfers to one of the
+  /// slave contexts given on construction, identified by index, with the chip
+  /// select deasserted between transactions as for spi0_transaction_queue.
+  ///
+  /// The spi0_pins and i2c_pins objects must outlive the broker and must not
+  /// be used by other code while the broker exists.
+    class bus_broker
+    {
+      spi0_pins *                                   spi0;
+      std::vector<spi0_slave_context>               spi0_slaves;
+      i2c_pins *                                    i2c;
+      std::unique_ptr<internal::bus_broker_channel> channel;
+      std::atomic<bool>                             stopping;
+      std::thread                                   worker;
+
+      void run_requests();
+
+    public:
+    /// @brief Default shared memory object name for brokers and clients
+      static constexpr char const * default_name = "/dibase-rpi-bus-broker";
+
+    /// @brief Size in bytes of the buffer of each request.
+      static std::size_t const buffer_size;
+
+    /// @brief Construct, creating the shared memory object, and start the
+    /// service thread.
+    /// @param[in] sp       Pointer to open spi0_pins object with standard
+    ///                     mode support, or nullptr if SPI0 is not brokered.
+    ///                     Any conversation is stopped.
+    /// @param[in] slaves   Slave contexts SPI0 clients may use, identified by
+    ///                     their index. Must be for spi0_mode::standard.
+    /// @param[in] ip       Pointer to open i2c_pins object, or nullptr if I2C
+    ///                     is not brokered.
+    /// @param[in] name     Shared memory object name. Defaults to
+    ///                     default_name.
+    /// @throws std::invalid_argument if sp is not nullptr and does not
+    ///         support standard mode or any of slaves are not for standard
+    ///         mode.
+    /// @throws bad_peripheral_alloc if another live process is brokering
+    ///         under name.
+    /// @throws std::system_error if the shared memory object cannot be
+    ///         created or the service thread started.
+      bus_broker
+      ( spi0_pins * sp
+      , std::vector<spi0_slave_context> slaves
+      , i2c_pins * ip
+      , char const * name = default_name
+      );
+
+    /// @brief Destroy: stop and join the service thread and remove the
+    /// shared memory object. Clients waiting on requests not yet performed
+    /// fail. The SPI0 conversation is stopped.
+      ~bus_broker();
+
+      bus_broker(bus_broker const &) = delete;
+      bus_broker& operator=(bus_broker const &) = delete;
+      bus_broker(bus_broker &&) = delete;
+      bus_broker& operator=(bus_broker &&) = delete;
+    };
+
+  /// @brief Submit SPI0 and I2C transactions to a bus_broker in another (or
+  /// the same) process.
+  ///
+  /// A transaction's bytes are placed in a buffer obtained from acquire, in
+  /// the broker's shared memory, and received bytes are read into the same
+  /// buffer. A client object may be used by one thread at a time; use one
+  /// per thread for concurrent requests.
+    class bus_broker_client
+    {
+      std::unique_ptr<internal::bus_broker_channel> channel;
+
+    public:
+    /// @brief A claimed request buffer in the broker's shared memory.
+    ///
+    /// Released for reuse on destruction.
+      class buffer
+      {
+      friend class bus_broker_client;
+
+        internal::bus_broker_channel *  channel;
+        std::uint32_t                   index;
+        std::uint8_t *                  bytes;
+
+        buffer(internal::bus_broker_channel & c, std::uint32_t idx);
+
+      public:
+        ~buffer();
+
+        buffer(buffer const &) = delete;
+        buffer& operator=(buffer const &) = delete;
+
+      /// @brief Move construct, leaving other not holding a buffer.
+        buffer(buffer && other) noexcept;
+
+      /// @brief Returns pointer to the buffer's bytes.
+        std::uint8_t * data() const
+        {
+          return bytes;
+        }
+
+      /// @brief Returns the size of the buffer in bytes.
+        std::size_t size() const
+        {
+          return bus_broker::buffer_size;
+        }
+      };
+
+    /// @brief Construct, opening the shared memory object of a running
+    /// broker.
+    /// @param[in] name Shared memory object name. Defaults to
+    ///                 bus_broker::default_name.
+    /// @throws std::runtime_error if no broker is running under name.
+    /// @throws std::system_error if the shared memory object cannot be
+    ///         opened.
+      explicit bus_broker_client(char const * name = bus_broker::default_name);
+
+      ~bus_broker_client();
+
+      bus_broker_client(bus_broker_client const &) = delete;
+      bus_broker_client& operator=(bus_broker_client const &) = delete;
+
+    /// @brief Claim a request buffer, yielding while none are free.
+      buffer acquire();
+
+    /// @brief Full-duplex SPI0 transfer of the first count bytes of b.
+    ///
+    /// Bytes read replace the bytes written in b.
+    /// @param[in,out] b  Buffer holding bytes to write, receives bytes read.
+    /// @param[in] slave  Index of slave context passed to the broker.
+    /// @param[in] count  Number of bytes to transfer [1, b.size()].
+    /// @returns Number of bytes transferred.
+    /// @throws std::invalid_argument if SPI0 is not brokered, slave is not
+    ///         a valid index or count is not in range.
+    /// @throws std::runtime_error if the transfer fails or the broker exits
+    ///         before performing it.
+      std::size_t spi0_transfer
+      ( buffer & b
+      , std::size_t slave
+      , std::size_t count
+      );
+
+    /// @brief I2C write of the first count bytes of b.
+    /// @param[in] b        Buffer holding bytes to write.
+    /// @param[in] addrs    Slave address [0,127].
+    /// @param[in] count    Number of bytes to write [0, b.size()].
+    /// @param[out] pwritten Defaults to \c nullptr. If not \c nullptr the
+    ///                     number of bytes written is written to it.
+    /// @returns As for i2c_pins::write_all.
+    /// @throws std::invalid_argument if I2C is not brokered or count is not
+    ///         in range.
+    /// @throws std::runtime_error if the write fails, e.g. addrs is not in
+    ///         range, or the broker exits before performing it.
+      int i2c_write
+      ( buffer & b
+      , std::uint32_t addrs
+      , std::size_t count
+      , std::size_t * pwritten = nullptr
+      );
+
+    /// @brief I2C read of count bytes into b.
+    /// @param[out] b       Buffer to receive bytes read.
+    /// @param[in] addrs    Slave address [0,127].
+    /// @param[in] count    Number of bytes to read [0, b.size()].
+    /// @param[out] pread   Defaults to \c nullptr. If not \c nullptr the
+    ///                     number of bytes read is written to it.
+    /// @returns As for i2c_pins::read_all.
+    /// @throws As for i2c_write.
+      int i2c_read
+      ( buffer & b
+      , std::uint32_t addrs
+      , std::size_t count
+      , std::size_t * pread = nullptr
+      );
+
+    /// @brief I2C combined write of the first tx_count bytes of b then
+    /// read of rx_count bytes into b.
+    /// @param[in,out] b    Buffer holding bytes to write, receives bytes read.
+    /// @param[in] addrs    Slave address [0,127].
+    /// @param[in] tx_count Number of bytes to write [1,16].
+    /// @param[in] rx_count Number of bytes to read [0, b.size()].
+    /// @param[out] pread   Defaults to \c nullptr. If not \c nullptr the
+    ///                     number of bytes read is written to it.
+    /// @returns As for i2c_pins::write_then_read.
+    /// @throws As for i2c_write.
+      int i2c_write_then_read
+      ( buffer & b
+      , std::uint32_t addrs
+      , std::size_t tx_count
+      , std::size_t rx_count
+      , std::size_t * pread = nullptr
+      );
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_BUS_BROKER_H
@@ -0,0 +1,203 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file capture_recorder.h
+/// @brief Record edge events and GPIO level samples to a memory mapped
+/// binary file and read them back : class definitions
+///
+/// Logging captured events as text through iostreams costs far more than
+/// capturing them. A capture_recorder instead appends fixed size binary
+/// capture_records to a file pre-allocated to hold a given number of
+/// records and mapped into memory, so recording one is a 16 byte store and
+/// an update of the record count in the file header. Dirty pages are
+/// written back asynchronously with msync every so many records and
+/// synchronously by flush and on destruction. A capture_reader maps a
+/// recorded file read-only for processing, or for monitoring while it is
+/// still being recorded.
+///
+/// File layout: a capture_file_header followed by capacity capture_records,
+/// in the byte order of the recording machine.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_CAPTURE_RECORDER_H
+# define DIBASE_RPI_PERIPHERALS_CAPTURE_RECORDER_H
+
+# include "pin_line_event.h"
+# include <chrono>
+# include <cstddef>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief One recorded edge event or GPIO level register sample.
+    struct capture_record
+    {
+    /// @brief Value of pin for a sample of GPLEV0, pins 0..31.
+      constexpr static std::uint32_t levels_bank0 = 0x100U;
+
+    /// @brief Value of pin for a sample of GPLEV1, pins 32..53.
+      constexpr static std::uint32_t levels_bank1 = 0x101U;
+
+      std::int64_t  timestamp;  ///< Time in nanoseconds, as recorded
+      std::uint32_t pin;        ///< Pin id of edge, or levels_bank0/1
+      std::uint32_t value;      ///< Edge: 1 rising, 0 falling; or levels
+    };
+
+  /// @brief Header at the start of a capture file.
+    struct capture_file_header
+    {
+      char          magic[8];     ///< "DBRPICAP"
+      std::uint32_t version;      ///< File format version, 1
+      std::uint32_t record_size;  ///< sizeof(capture_record)
+      std::uint64_t capacity;     ///< Number of records the file can hold
+      std::uint64_t count;        ///< Number of records recorded
+    };
+
+  /// @brief Append capture_records to a pre-allocated memory mapped file.
+  ///
+  /// Recording functions do not throw and do not make system calls other
+  /// than the periodic msync. Once the file is full further records are
+  /// discarded and counted. Only one thread may record at a time.
+    class capture_recorder
+    {
+      capture_file_header * header;
+      capture_record *      records;
+      std::size_t           mapped_size;
+      std::size_t           sync_interval;
+      std::size_t           unsynced;
+      std::size_t           synced_count;
+      std::uint64_t         dropped_count;
+
+      bool append(capture_record const & r) noexcept;
+      bool sync(int flags) noexcept;
+
+    public:
+    /// @brief Create, pre-allocate and map a capture file.
+    /// @param[in] path     File to create. Any existing file is replaced.
+    /// @param[in] capacity Number of records the file is to hold.
+    /// @param[in] sync_records Records between asynchronous write backs of
+    ///                     the records recorded since the last. 0 for none
+    ///                     other than by flush.
+    /// @throws std::invalid_argument if capacity is zero.
+    /// @throws std::system_error if the file cannot be created, allocated or
+    ///         mapped.
+      capture_recorder
+      ( char const * path
+      , std::size_t capacity
+      , std::size_t sync_records = 4096U
+      );
+
+    /// @brief Write back all records synchronously and unmap the file.
+      ~capture_recorder();
+
+      capture_recorder(capture_recorder const &) = delete;
+      capture_recorder & operator=(capture_recorder const &) = delete;
+
+    /// @brief Record an edge event.
+    /// @param[in] event  Event to record. Its time stamp is recorded.
+    /// @returns true if recorded, false if the file is full.
+      bool record(edge_event_record const & event) noexcept;
+
+    /// @brief Record a batch of edge events, such as popped from an
+    /// edge_event_stream or debouncer.
+    /// @param[in] events Events to record.
+    /// @param[in] count  Number of events.
+    /// @returns Number of events recorded, less than count if the file
+    ///          fills.
+      std::size_t record
+      ( edge_event_record const * events
+      , std::size_t count
+      ) noexcept;
+
+    /// @brief Record a sample of the GPIO level registers as two records,
+    /// one per bank.
+    /// @param[in] timestamp  Time of the sample.
+    /// @param[in] levels     GPLEV0, GPLEV1 values, as in gplev_sampler
+    ///                       samples.
+    /// @returns true if recorded, false if the file is full, in which case
+    ///          neither record is recorded.
+      bool record_levels
+      ( std::chrono::nanoseconds timestamp
+      , std::uint32_t const volatile * levels
+      ) noexcept;
+
+    /// @brief Synchronously write back all records recorded so far and the
+    /// header.
+    /// @throws std::system_error if msync fails.
+      void flush();
+
+    /// @brief Returns number of records recorded.
+      std::size_t size() const
+      {
+        return static_cast<std::size_t>(header->count);
+      }
+
+    /// @brief Returns number of records the file can hold.
+      std::size_t capacity() const
+      {
+        return static_cast<std::size_t>(header->capacity);
+      }
+
+    /// @brief Returns number of records discarded because the file was full.
+      std::uint64_t dropped() const
+      {
+        return dropped_count;
+      }
+    };
+
+  /// @brief Read-only memory mapped view of a capture file.
+  ///
+  /// The number of records is read from the file header on each call to
+  /// size, so a file still being recorded may be monitored.
+    class capture_reader
+    {
+      capture_file_header const * header;
+      capture_record const *      records;
+      std::size_t                 mapped_size;
+
+    public:
+    /// @brief Open and map a capture file.
+    /// @param[in] path File to read.
+    /// @throws std::system_error if the file cannot be opened or mapped.
+    /// @throws std::runtime_error if the file is not a capture file of
+    ///         this format version and record size or is truncated.
+      explicit capture_reader(char const * path);
+
+    /// @brief Unmap the file.
+      ~capture_reader();
+
+      capture_reader(capture_reader const &) = delete;
+      capture_reader & operator=(capture_reader const &) = delete;
+
+    /// @brief Returns number of records recorded.
+      std::size_t size() const;
+
+    /// @brief Returns number of records the file can hold.
+      std::size_t capacity() const
+      {
+        return static_cast<std::size_t>(header->capacity);
+      }
+
+    /// @brief Returns a record.
+    /// @param[in] n  Index of record. Not range checked.
+      capture_record const & operator[](std::size_t n) const
+      {
+        return records[n];
+      }
+
+    /// @brief Returns pointer to the first record.
+      capture_record const * begin() const
+      {
+        return records;
+      }
+
+    /// @brief Returns pointer past the last record recorded.
+      capture_record const * end() const
+      {
+        return records+size();
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_CAPTURE_RECORDER_H
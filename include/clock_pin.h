@@ -9,10 +9,17 @@
 # define DIBASE_RPI_PERIPHERALS_CLOCK_PIN_H
 # include "pin_id.h"
 # include "clockdefs.h"
+# include "static_clock_parameters.h"
+# include <vector>
 
 namespace dibase { namespace rpi {
   namespace peripherals
   {
+    namespace internal
+    {
+      class clock_parameters;
+    }
+
   /// @brief Use a GPIO pin as general purpose clock.
   ///
   /// General purpose clocks 0, 1 and 2 may be output to GPIO pins when set
@@ -30,17 +37,45 @@ namespace dibase { namespace rpi {
   /// see if the clock is in use externally by other processes.
   ///
   /// Once constructed the clock can be started and stopped.
+  ///
+  /// For frequency hopping, such as FSK signalling, a table of target
+  /// frequencies can be set with set_tuning_table, whose divisors are
+  /// calculated in advance, and the running clock switched between them with
+  /// retune. Retuning only rewrites the clock's divisor register so does not
+  /// stop the clock or wait for it to be not busy.
+  ///
+  /// Only construction switches between peripherals - the clock manager and
+  /// GPIO - and so uses peripheral_barrier(). Starting, stopping, querying
+  /// and retuning access just the clock manager and contain no barriers.
     class clock_pin
     {
+    friend class start_group;
+
+    /// @brief Precomputed divisor and frequencies for one tuning table entry
+      struct tuning
+      {
+        std::uint32_t divi;     ///< Clock divisor DIVI field value
+        std::uint32_t divf;     ///< Clock divisor DIVF field value
+        hertz         freq_min; ///< Clock minimum frequency
+        hertz         freq_avg; ///< Clock average frequency
+        hertz         freq_max; ///< Clock maximum frequency
+      };
+
       unsigned  construct( pin_id pin
                          , hertz src_freq
                          , clock_source src_type
                          , clock_frequency const & freq
                          );
+      unsigned  construct( pin_id pin
+                         , internal::clock_parameters const & cp
+                         );
 
       hertz           freq_min;
       hertz           freq_avg;
       hertz           freq_max;
+      hertz           src_freq;
+      clock_source    src_type;
+      std::vector<tuning> tunings;
       unsigned const  clk;
       pin_id const    pin;
 
@@ -76,6 +111,22 @@ namespace dibase { namespace rpi {
       , pin{p}
       {}
 
+    /// @brief Construct from GPIO pin and compile time clock parameters
+    ///
+    /// As for the clock source and frequency constructor except that the
+    /// clock parameters were calculated and checked at compile time, so only
+    /// the GPIO pin and clock allocations are checked.
+    /// @param[in] p      Pin id of GPIO pin to use with clock
+    /// @param[in] s      Value of a static_clock_parameters instantiation.
+    /// @throws std::invalid_argument if the requested pin has no clock
+    ///         function.
+    /// @throws std::range_error if the pin supports more than one clock
+    ///         function or the special function type is not one of the GPCLK
+    ///         values (neither of which should occur).
+    /// @throws bad_peripheral_alloc if either the pin or the clock related to
+    ///         the pin are already in use.
+      clock_pin(pin_id p, static_clock_settings const & s);
+
     /// @brief Destroy: stop the clock and de-allocate clock and GPIO pin.
       ~clock_pin();
 
@@ -105,6 +156,33 @@ namespace dibase { namespace rpi {
     /// @brief Return clock maximum frequency calculated during construction
     /// @returns Calculated clock maximum frequency in Hertz
       hertz frequency_max() const { return freq_max; }
+
+    /// @brief Precompute the divisors used to retune the clock.
+    ///
+    /// The divisor values for each requested frequency are calculated using
+    /// the clock's source as for construction and replace any previous
+    /// table. Each frequency must use the same MASH filtering mode as the
+    /// clock, as the mode cannot be changed while the clock runs.
+    /// @param[in] freqs  Requested frequency characteristics for each table
+    ///                   entry.
+    /// @throws std::invalid_argument if a frequency is out of range as for
+    ///         construction or needs a MASH mode other than the clock's.
+    /// @throws std::range_error if a DIVI value is too small for the MASH mode.
+      void set_tuning_table(std::vector<clock_frequency> const & freqs);
+
+    /// @brief Return number of entries in the tuning table.
+      std::size_t tuning_table_size() const { return tunings.size(); }
+
+    /// @brief Switch the clock to a precomputed tuning table frequency
+    ///
+    /// Writes the entry's DIVI and DIVF values to the clock's divisor
+    /// register in a single write without stopping the clock, which changes
+    /// frequency at its next cycle. Works whether the clock is running or not.
+    /// frequency_min, frequency_avg and frequency_max return the values for
+    /// the entry afterwards.
+    /// @param[in] idx  Index of tuning table entry, [0, tuning_table_size()).
+    /// @throws std::out_of_range if idx is not a tuning table index.
+      void retune(std::size_t idx);
     };
   } // namespace peripherals closed
 }} // namespaces rpi and dibase closed
@@ -134,6 +134,12 @@ namespace dibase { namespace rpi {
   /// @tparam Multiplier  std::mega - i.e. 1000000:1
     typedef frequency<unsigned, std::mega>  i_megahertz;
 
+  /// @brief Alias for (double) floating point /ref frequency type alias
+  /// Count of 1.0==1Hz
+  /// @tparam Rep         double
+  /// @tparam Multiplier  std::ratio<1> - i.e. 1:1
+    typedef frequency<double>               f_hertz;
+
   /// @brief Alias for (double) floating point /ref frequency type alias
   /// Count of 1.0==1000Hz (i.e. 1KHz)
   /// @tparam Rep         double
@@ -266,6 +272,14 @@ namespace dibase { namespace rpi {
   /// Raspberry Pi /boot/config.txt file).
     constexpr hertz rpi_apb_core_frequency(megahertz(250));
 
+  /// @brief Raspberry Pi _default_ 3MHz PL011 UART reference clock frequency
+  ///
+  /// Note: This is a _fixed_ constant value and represents the _default_
+  /// value. It will be _incorrect_ if this value has been altered by setting
+  /// the init_uart_clock parameter in the Raspberry Pi /boot/config.txt file,
+  /// as is required for baud rates above 187500 (clock/16).
+    constexpr hertz rpi_uart_clock_frequency(megahertz(3));
+
   } // namespace peripherals closed
 }} // namespaces rpi and dibase closed
 #endif // DIBASE_RPI_PERIPHERALS_CLOCKDEFS_H
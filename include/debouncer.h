@@ -0,0 +1,175 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file debouncer.h
+/// @brief Periodic debouncing of many GPIO input pins on one thread : class
+/// definitions.
+///
+/// Debouncing a switch by polling it until it stays in one state ties up a
+/// thread per switch. A debouncer instead samples all pins of an ipin_group
+/// together once per tick on a single thread and runs an integrating filter
+/// for each pin, reporting debounced edges as edge_event_records through a
+/// lock-free ring in the same way as \ref edge_event_stream.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_DEBOUNCER_H
+# define DIBASE_RPI_PERIPHERALS_DEBOUNCER_H
+
+# include "pin_group.h"
+# include "pin_line_event.h"
+# include "rt_thread.h"
+# include "spsc_ring.h"
+# include <array>
+# include <atomic>
+# include <chrono>
+# include <cstdint>
+# include <exception>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Integrating debounce filter for up to 64 inputs.
+  ///
+  /// Each input has a counter which each update increments, up to the
+  /// threshold, if the input is high and decrements, down to zero, if it is
+  /// low. An input's debounced state becomes high when its counter reaches
+  /// the threshold and low when it reaches zero, so a change is reported
+  /// only once an input has been more often in its new state than its old
+  /// for threshold updates. Noise shorter than that is filtered out while a
+  /// clean change is reported after exactly threshold updates.
+  ///
+  /// Only inputs whose sample differs from their debounced state or whose
+  /// counter is not at rest are examined on each update.
+    class debounce_filter
+    {
+      pin_group_value_t mask;
+      pin_group_value_t debounced;
+      pin_group_value_t moving;
+      std::uint16_t     threshold;
+      std::array<std::uint16_t, 64U> counters;
+
+    public:
+    /// @brief Largest supported threshold value.
+      static unsigned const max_threshold = 0xFFFFU;
+
+    /// @brief Construct with inputs in a known initial state.
+    /// @param[in] inputs   Mask of inputs filtered: bit n for input n. Other
+    ///                     inputs' debounced states are always low.
+    /// @param[in] initial  Initial debounced states: bit n for input n.
+    /// @param[in] updates  Threshold number of updates, [1, max_threshold].
+    ///                     1 reports every change immediately.
+    /// @throws std::invalid_argument if updates is out of range.
+      debounce_filter
+      ( pin_group_value_t inputs
+      , pin_group_value_t initial
+      , unsigned updates
+      );
+
+    /// @brief Filter a new sample of all inputs.
+    /// @param[in] sample  Input states: bit n set if input n is high.
+    /// @returns Mask of inputs whose debounced state changed.
+      pin_group_value_t update(pin_group_value_t sample);
+
+    /// @brief Returns debounced states: bit n set if input n is high.
+      pin_group_value_t state() const
+      {
+        return debounced;
+      }
+    };
+
+  /// @brief Debounce the pins of an ipin_group on a periodic thread.
+  ///
+  /// A polling thread reads the group's pins once per tick, paced by an
+  /// \ref rt_period, and passes the value through a debounce_filter. Each
+  /// debounced change of a pin is pushed into a fixed capacity lock-free
+  /// single producer single consumer ring as an edge_event_record, whose
+  /// time stamp is the CLOCK_MONOTONIC time of the tick at which the change
+  /// was decided. One consumer thread pops records in batches. If the ring is
+  /// full a record is discarded and counted as an overrun.
+    class debouncer
+    {
+      ipin_group &                  group;
+      std::chrono::nanoseconds      tick_period;
+      debounce_filter               filter;
+      spsc_ring<edge_event_record>  ring;
+      std::atomic<pin_group_value_t> debounced;
+      std::atomic<std::uint64_t>    overrun_count;
+      std::atomic<std::uint64_t>    missed_count;
+      std::atomic<bool>             stopping;
+      std::atomic<bool>             poller_failed;
+      std::exception_ptr            poller_error;
+      rt_thread                     poller;
+
+      void poll_pins();
+
+    public:
+    /// @brief Read the pins' initial states and start the polling thread.
+    /// @param[in] pins     Group of input pins to debounce. Must outlive the
+    ///                     debouncer and must not be read by other threads
+    ///                     while it exists.
+    /// @param[in] tick     Time between samples. Must be greater than zero.
+    /// @param[in] stable_ticks Ticks a pin must predominantly be in a new
+    ///                     state for before it is reported,
+    ///                     [1, debounce_filter::max_threshold].
+    /// @param[in] capacity Number of records the ring can hold. Must be a
+    ///                     power of two.
+    /// @param[in] config   Real-time configuration of the polling thread.
+    /// @throws std::invalid_argument if tick is not greater than zero,
+    ///         stable_ticks is out of range or capacity is not a power of
+    ///         two.
+    /// @throws As for rt_thread construction if the polling thread cannot be
+    ///         created or config cannot be applied to it.
+      debouncer
+      ( ipin_group & pins
+      , std::chrono::microseconds tick
+      , unsigned stable_ticks
+      , std::size_t capacity
+      , rt_config const & config = rt_config{}
+      );
+
+    /// @brief Destroy, stopping and joining the polling thread.
+      ~debouncer();
+
+      debouncer(debouncer const &) = delete;
+      debouncer& operator=(debouncer const &) = delete;
+      debouncer(debouncer &&) = delete;
+      debouncer& operator=(debouncer &&) = delete;
+
+    /// @brief Pop available debounced edges. Does not wait. Must only be
+    /// called by one thread at a time.
+    /// @param[out] events  Array of at least max_events records to fill.
+    /// @param[in] max_events  Maximum number of records to pop.
+    /// @returns Number of records popped into events.
+    /// @throws Exception thrown by the polling thread, once all records it
+    ///         pushed before failing have been popped.
+      std::size_t pop(edge_event_record * events, std::size_t max_events);
+
+    /// @brief Returns the latest debounced pin states: bit n set if the nth
+    /// pin of the group is high.
+      pin_group_value_t state() const
+      {
+        return debounced.load(std::memory_order_acquire);
+      }
+
+    /// @brief Returns number of records discarded because the ring was full.
+      std::uint64_t overruns() const
+      {
+        return overrun_count.load(std::memory_order_relaxed);
+      }
+
+    /// @brief Returns number of ticks whose deadline had passed before the
+    /// polling thread waited for it.
+      std::uint64_t missed_ticks() const
+      {
+        return missed_count.load(std::memory_order_relaxed);
+      }
+
+    /// @brief Returns the ring capacity.
+      std::size_t capacity() const
+      {
+        return ring.capacity();
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_DEBOUNCER_H
@@ -0,0 +1,99 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file edge_event_stream.h
+/// @brief Stream of GPIO pin edge events read by a dedicated thread :
+/// class definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_EDGE_EVENT_STREAM_H
+# define DIBASE_RPI_PERIPHERALS_EDGE_EVENT_STREAM_H
+
+# include "pin_line_event.h"
+# include "pin_edge_event_set.h"
+# include "spsc_ring.h"
+# include <initializer_list>
+# include <exception>
+# include <thread>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Edge events from one or more pin_line_events delivered to a
+  /// consumer without locking.
+  ///
+  /// An edge_event_stream owns a reader thread which waits on all its source
+  /// pin_line_events and drains their queued events into a fixed capacity
+  /// lock-free single producer single consumer ring. One consumer thread pops
+  /// events from the ring in batches. If the ring is full when an event is
+  /// read the event is discarded and counted as an overrun.
+  ///
+  /// The source pin_line_events must outlive the edge_event_stream and must
+  /// not be read, waited on or queried for lost events by other code while
+  /// the stream exists.
+    class edge_event_stream
+    {
+      std::vector<pin_line_event const *>   sources;
+      spsc_ring<edge_event_record>          ring;
+      pin_edge_event_set                    event_set;
+      std::atomic<std::uint64_t>            overrun_count;
+      std::atomic<bool>                     reader_failed;
+      std::exception_ptr                    reader_error;
+      std::thread                           reader;
+
+      void read_events();
+
+    public:
+    /// @brief Value for cpu parameter meaning do not set reader thread's CPU
+    /// affinity.
+      static int const any_cpu = -1;
+
+    /// @brief Construct and start the reader thread.
+    /// @param[in] lines    Source pin_line_events. Each must be distinct.
+    /// @param[in] capacity Number of events the ring can hold. Must be a
+    ///                     power of two.
+    /// @param[in] cpu      CPU the reader thread is restricted to run on or
+    ///                     any_cpu.
+    /// @throws std::invalid_argument if lines is empty or capacity is not a
+    ///         power of two.
+    /// @throws std::system_error if the reader thread cannot be created or
+    ///         its CPU affinity cannot be set.
+      edge_event_stream
+      ( std::initializer_list<pin_line_event const *> lines
+      , std::size_t capacity
+      , int cpu = any_cpu
+      );
+
+    /// @brief Destroy, stopping and joining the reader thread.
+      ~edge_event_stream();
+
+      edge_event_stream(edge_event_stream const &) = delete;
+      edge_event_stream& operator=(edge_event_stream const &) = delete;
+      edge_event_stream(edge_event_stream &&) = delete;
+      edge_event_stream& operator=(edge_event_stream &&) = delete;
+
+    /// @brief Pop available events. Does not wait. Must only be called by
+    /// one thread at a time.
+    /// @param[out] events  Array of at least max_events records to fill.
+    /// @param[in] max_events  Maximum number of events to pop.
+    /// @returns Number of events popped into events.
+    /// @throws Exception thrown by the reader thread, once all events it
+    ///         read before failing have been popped.
+      std::size_t pop(edge_event_record * events, std::size_t max_events);
+
+    /// @brief Returns number of events discarded because the ring was full.
+      std::uint64_t overruns() const
+      {
+        return overrun_count.load(std::memory_order_relaxed);
+      }
+
+    /// @brief Returns the ring capacity.
+      std::size_t capacity() const
+      {
+        return ring.capacity();
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_EDGE_EVENT_STREAM_H
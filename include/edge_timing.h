@@ -0,0 +1,105 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file edge_timing.h
+/// @brief Inter-edge intervals and frequency over a sliding window of edge
+/// timestamps : class definition.
+///
+/// Timestamps are typically system_timer time points captured by
+/// \ref pin_edge_event::wait_for or \ref pin_event_detector::poll as close to
+/// the edge as each allows, or kernel timestamps of \ref edge_event_record
+/// values read from a \ref pin_line_event. Timestamps of different sources
+/// have different epochs so must not be mixed in one edge_timing object.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_EDGE_TIMING_H
+# define DIBASE_RPI_PERIPHERALS_EDGE_TIMING_H
+
+# include "system_timer.h"
+# include "clockdefs.h"
+# include <chrono>
+# include <cstddef>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Sliding window of the most recent edge timestamps.
+  ///
+  /// Holds up to a fixed number of timestamps; recording a timestamp when
+  /// the window is full drops the oldest. Intervals and frequency are
+  /// computed from the timestamps in the window. Timestamps must be recorded
+  /// in non-decreasing order.
+    class edge_timing
+    {
+      std::vector<std::chrono::nanoseconds> stamps;
+      std::size_t                           first;
+      std::size_t                           count;
+
+      std::chrono::nanoseconds at(std::size_t i) const
+      {
+        return stamps[(first+i)%stamps.size()];
+      }
+
+    public:
+    /// @brief Construct with an empty window.
+    /// @param[in] window Maximum number of timestamps held. Must be at least
+    ///                   2 so there is at least one interval.
+    /// @throws std::invalid_argument if window is less than 2.
+      explicit edge_timing(std::size_t window);
+
+    /// @brief Record an edge timestamp.
+    /// @param[in] t  Time of edge since some epoch, e.g. the timestamp of an
+    ///               \ref edge_event_record.
+      void record(std::chrono::nanoseconds t);
+
+    /// @brief Record an edge system timer timestamp.
+    /// @param[in] t  System timer time of edge.
+      void record(system_timer::time_point t)
+      {
+        record(std::chrono::nanoseconds{t.time_since_epoch()});
+      }
+
+    /// @brief Discard all timestamps.
+      void reset()
+      {
+        first = 0U;
+        count = 0U;
+      }
+
+    /// @brief Returns number of timestamps in the window.
+      std::size_t size() const
+      {
+        return count;
+      }
+
+    /// @brief Returns maximum number of timestamps in the window.
+      std::size_t window() const
+      {
+        return stamps.size();
+      }
+
+    /// @brief Returns interval between the two most recent edges, or zero if
+    /// fewer than two edges are in the window.
+      std::chrono::nanoseconds last_interval() const;
+
+    /// @brief Returns shortest interval between consecutive edges in the
+    /// window, or zero if fewer than two edges are in the window.
+      std::chrono::nanoseconds min_interval() const;
+
+    /// @brief Returns longest interval between consecutive edges in the
+    /// window, or zero if fewer than two edges are in the window.
+      std::chrono::nanoseconds max_interval() const;
+
+    /// @brief Returns time spanned by the edges in the window: from the
+    /// oldest to the most recent.
+      std::chrono::nanoseconds span() const;
+
+    /// @brief Returns mean edge frequency over the window: the number of
+    /// intervals divided by the span. Zero if fewer than two edges are in the
+    /// window or they span no time.
+      f_hertz frequency() const;
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_EDGE_TIMING_H
@@ -0,0 +1,179 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file event_executor.h
+/// @brief Run completion handlers for edge events, timers and bus commands
+/// on a few threads : class definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_EVENT_EXECUTOR_H
+# define DIBASE_RPI_PERIPHERALS_EVENT_EXECUTOR_H
+
+# include "pin_edge_event.h"
+# include "pin_line_event.h"
+# include "periodic_timer.h"
+# include "io_service.h"
+# include <atomic>
+# include <cstdint>
+# include <deque>
+# include <functional>
+# include <future>
+# include <memory>
+# include <mutex>
+# include <type_traits>
+# include <unordered_map>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief epoll based executor of asynchronous waits and posted handlers.
+  ///
+  /// Rather than a thread blocking in pin_edge_event::wait or a bus
+  /// transfer for each logical wait, asynchronous operations are started
+  /// with a completion handler which is run by one of the threads calling
+  /// run once the operation completes:
+  ///   - async_wait on a pin_edge_event, pin_line_event or periodic_timer
+  ///     runs the handler once the event or timer is next signalled. As with
+  ///     pin_edge_event_set, events and timers remain signalled until
+  ///     cleared or acknowledged, normally by the handler.
+  ///   - async_call runs a blocking call, such as an spi0_pins or i2c_pins
+  ///     transfer on objects adopted by an io_service, on the io_service's
+  ///     thread and passes a ready future for its result to the handler.
+  ///   - post runs a handler as soon as possible.
+  ///
+  /// Any number of waits so share the few threads that call run. Handlers
+  /// are the building block for other styles of asynchronous code: for
+  /// example a coroutine awaitable can start an operation from its suspend
+  /// step with a handler that resumes the coroutine.
+  ///
+  /// Only one wait per event or timer may be outstanding at a time, and an
+  /// event or timer must not be destroyed while a wait on it is outstanding:
+  /// use cancel first.
+    class event_executor
+    {
+      typedef std::function<void()> handler;
+
+      int                                     epoll_fd;
+      int                                     wake_fd;
+      std::atomic<bool>                       stopping;
+      std::atomic<std::uint64_t>              failures;
+      std::mutex                              guard;
+      std::unordered_map<int, handler>        waits;
+      std::deque<handler>                     posted;
+
+      void wait_on(int fd, std::uint32_t events, handler h);
+      void cancel(int fd);
+      bool run_posted();
+      void invoke(handler & h);
+
+    public:
+    /// @brief Construct an executor with no outstanding operations.
+    /// @throws std::system_error if the epoll instance or wake eventfd
+    ///         cannot be created.
+      event_executor();
+
+    /// @brief Destroy, discarding handlers of outstanding operations.
+      ~event_executor();
+
+      event_executor(event_executor const &) = delete;
+      event_executor& operator=(event_executor const &) = delete;
+      event_executor(event_executor &&) = delete;
+      event_executor& operator=(event_executor &&) = delete;
+
+    /// @brief Run handlers of completed operations until stopped.
+    ///
+    /// May be called by several threads together: each completed operation's
+    /// handler is run by only one of them. Exceptions thrown by handlers are
+    /// counted by failed_handlers and otherwise ignored.
+    /// @throws std::system_error if any system function call returns failure.
+      void run();
+
+    /// @brief Make all current and future calls to run return.
+    /// @throws std::system_error if the wake eventfd write fails.
+      void stop();
+
+    /// @brief Returns true if stop has been called, false otherwise.
+      bool is_stopped() const
+      {
+        return stopping.load(std::memory_order_acquire);
+      }
+
+    /// @brief Queue a handler to be run by a thread calling run.
+    ///
+    /// May be called from any thread, including from handlers.
+    /// @param[in] h  Handler to run.
+    /// @throws std::system_error if the wake eventfd write fails.
+      void post(std::function<void()> h);
+
+    /// @brief Run a handler once an edge event is signalled.
+    /// @param[in] e  Edge event to wait on.
+    /// @param[in] h  Handler to run. Normally clears e.
+    /// @throws std::logic_error if a wait on e is already outstanding.
+    /// @throws std::system_error if e cannot be added to the epoll instance.
+      void async_wait(pin_edge_event const & e, std::function<void()> h);
+
+    /// @brief Run a handler once a line event is signalled.
+    /// @param[in] e  Line event to wait on.
+    /// @param[in] h  Handler to run. Normally clears e.
+    /// @throws std::logic_error if a wait on e is already outstanding.
+    /// @throws std::system_error if e cannot be added to the epoll instance.
+      void async_wait(pin_line_event const & e, std::function<void()> h);
+
+    /// @brief Run a handler once a timer deadline passes.
+    /// @param[in] t  Timer to wait on.
+    /// @param[in] h  Handler to run. Normally acknowledges t.
+    /// @throws std::logic_error if a wait on t is already outstanding.
+    /// @throws std::system_error if t cannot be added to the epoll instance.
+      void async_wait(periodic_timer const & t, std::function<void()> h);
+
+    /// @brief Cancel any outstanding wait on an edge event, discarding its
+    /// handler.
+    /// @param[in] e  Edge event waited on.
+      void cancel(pin_edge_event const & e);
+
+    /// @brief Cancel any outstanding wait on a line event, discarding its
+    /// handler.
+    /// @param[in] e  Line event waited on.
+      void cancel(pin_line_event const & e);
+
+    /// @brief Cancel any outstanding wait on a timer, discarding its handler.
+    /// @param[in] t  Timer waited on.
+      void cancel(periodic_timer const & t);
+
+    /// @brief Run a blocking call on an io_service's thread then pass its
+    /// result to a handler run by this executor.
+    ///
+    /// @tparam F     Callable type taking no arguments.
+    /// @tparam H     Callable type taking a std::future for F's result.
+    /// @param[in] service  io_service to run f on, normally one owning the
+    ///                     peripheral objects f uses.
+    /// @param[in] f  Call to make on the service thread.
+    /// @param[in] h  Handler passed a ready future for the result of f, or
+    ///               the exception it threw.
+      template <typename F, typename H>
+      void async_call(io_service & service, F f, H h)
+      {
+        typedef typename std::result_of<F()>::type result_type;
+        typedef std::packaged_task<result_type()> task_type;
+        typedef std::future<result_type> future_type;
+        std::shared_ptr<task_type> task{std::make_shared<task_type>(f)};
+        std::shared_ptr<H> done{std::make_shared<H>(h)};
+        service.post([this, task, done]()
+                     {
+                       (*task)();
+                       std::shared_ptr<future_type> result
+                         {std::make_shared<future_type>(task->get_future())};
+                       post([done, result]{ (*done)(std::move(*result)); });
+                     }
+                    );
+      }
+
+    /// @brief Returns the number of handlers that threw exceptions.
+      std::uint64_t failed_handlers() const
+      {
+        return failures.load(std::memory_order_relaxed);
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_EVENT_EXECUTOR_H
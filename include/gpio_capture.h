@@ -0,0 +1,234 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_capture.h
+/// @brief DMA sampled logic analyser capture of all GPIO pin levels : type
+/// definitions.
+///
+/// A gpio_capture has a DMA channel copy the GPIO pin level registers
+/// (GPLEV0, GPLEV1) into a ring buffer at a fixed rate paced by the PWM
+/// controller's DMA request signal, as for \ref pulse_counter. Captures read
+/// samples from the ring as they are taken and deliver them as runs of
+/// samples with unchanging pin levels, either to a user function or written
+/// to a stream in a compact run-length encoded format that may be read back
+/// with a gpio_rle_reader.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_GPIO_CAPTURE_H
+# define DIBASE_RPI_PERIPHERALS_GPIO_CAPTURE_H
+
+# include "pin_id.h"
+# include "clockdefs.h"
+# include <cstdint>
+# include <functional>
+# include <istream>
+# include <memory>
+# include <ostream>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      class gplev_sampler;
+    }
+
+  /// @brief Pin mask value selecting all GPIO pins: bit n selects pin n.
+    constexpr std::uint64_t all_gpio_pins
+                  {(std::uint64_t(1)<<pin_id::number_of_pins)-1U};
+
+  /// @brief Consecutive samples in which selected GPIO pin levels were the
+  /// same.
+    struct gpio_level_run
+    {
+      std::uint64_t levels; ///< Bit n is set if GPIO pin n was high
+      std::uint64_t length; ///< Number of samples in the run
+    };
+
+  /// @brief Combine GPIO level samples into runs.
+    class gpio_run_encoder
+    {
+      std::uint64_t mask;
+      std::uint64_t levels;
+      std::uint64_t length;
+
+    public:
+    /// @brief Construct with no samples added.
+    /// @param[in] pin_mask Pins whose levels are compared: bit n selects GPIO
+    ///                     pin n. Levels of other pins are zero in runs.
+      explicit gpio_run_encoder(std::uint64_t pin_mask = all_gpio_pins)
+      : mask{pin_mask&all_gpio_pins}
+      , levels{0U}
+      , length{0U}
+      {}
+
+    /// @brief Add a sample, completing the current run if levels differ.
+    /// @param[in]  sample    Levels: bit n set if GPIO pin n is high.
+    /// @param[out] completed Set to the completed run if true is returned.
+    /// @returns true if a run was completed.
+      bool add(std::uint64_t sample, gpio_level_run & completed);
+
+    /// @brief Complete the current run, if any.
+    /// @param[out] completed Set to the completed run if true is returned.
+    /// @returns true if there was a run to complete.
+      bool flush(gpio_level_run & completed);
+    };
+
+  /// @brief Description of a capture written at the start of a run-length
+  /// encoded capture stream.
+    struct gpio_capture_header
+    {
+      std::uint64_t sample_period_ps; ///< Picoseconds between samples
+      std::uint64_t pin_mask;         ///< Pins captured: bit n for pin n
+      std::uint64_t start_us;         ///< System timer time of first sample
+    };
+
+  /// @brief Write GPIO level runs to a stream in run-length encoded format.
+  ///
+  /// The format is the 8 bytes "DBGPCAP1", the header fields as 64-bit little
+  /// endian values, then for each run the exclusive or of its levels with the
+  /// previous run's levels (zero for the first) followed by its length, each
+  /// as an unsigned LEB128 variable length value. Runs usually change few
+  /// pins and short runs are common, so most runs take only a few bytes.
+    class gpio_rle_writer
+    {
+      std::ostream &  out;
+      std::uint64_t   previous;
+
+    public:
+    /// @brief Write the stream header.
+    /// @param[in] os     Stream, opened in binary mode, to write to. Must
+    ///                   outlive the writer.
+    /// @param[in] header Capture description.
+    /// @throws std::ios_base::failure if writing fails.
+      gpio_rle_writer(std::ostream & os, gpio_capture_header const & header);
+
+    /// @brief Write a run.
+    /// @param[in] run  Run to write.
+    /// @throws std::ios_base::failure if writing fails.
+      void write(gpio_level_run const & run);
+    };
+
+  /// @brief Read GPIO level runs from a stream written by a gpio_rle_writer.
+    class gpio_rle_reader
+    {
+      std::istream &      in;
+      gpio_capture_header hdr;
+      std::uint64_t       previous;
+
+    public:
+    /// @brief Read the stream header.
+    /// @param[in] is   Stream, opened in binary mode, to read from. Must
+    ///                 outlive the reader.
+    /// @throws std::runtime_error if the stream does not start with a valid
+    ///         header.
+      explicit gpio_rle_reader(std::istream & is);
+
+    /// @brief Returns the capture description read from the stream header.
+      gpio_capture_header const & header() const
+      {
+        return hdr;
+      }
+
+    /// @brief Read the next run.
+    /// @param[out] run Set to the run read if true is returned.
+    /// @returns true if a run was read, false at the end of the stream.
+    /// @throws std::runtime_error if the stream ends part way through a run
+    ///         or holds an invalid value.
+      bool read(gpio_level_run & run);
+    };
+
+  /// @brief Logic analyser capture of GPIO pin levels sampled by DMA.
+  ///
+  /// Sampling starts on construction and continues into a ring buffer of
+  /// buffer_samples samples until destruction. Each capture reads a number
+  /// of samples from the first sample taken after it is started, waking a
+  /// few times per ring buffer's worth of samples. If the capturing thread
+  /// is not scheduled before the DMA overwrites samples it has not read the
+  /// capture fails, so high rate captures are best made from a thread with
+  /// a real-time configuration (see \ref rt_thread).
+  ///
+  /// Sampling requires the PWM controller, whose clock is set to pace the
+  /// samples, and a DMA channel, so while a gpio_capture exists no PWM pins,
+  /// waveform, pulse_counter or other user of the PWM FIFO may be used.
+  ///
+  /// Each sample takes two DMA control blocks, which limits the sample rate
+  /// to 1MHz.
+    class gpio_capture
+    {
+      std::uint64_t                             mask;
+      std::unique_ptr<internal::gplev_sampler>  sampler;
+
+      gpio_capture_header capture_
+      ( std::uint64_t samples
+      , std::function<void(gpio_capture_header const &)> const & started
+      , std::function<void(gpio_level_run const &)> const & sink
+      );
+
+    public:
+    /// @brief Type of function given runs by capture.
+      typedef std::function<void(gpio_level_run const &)> run_sink;
+
+    /// @brief Number of samples in the DMA ring buffer.
+      static std::size_t const buffer_samples = 16384U;
+
+    /// @brief Start sampling.
+    /// @param[in] rate     Requested sample rate, (0Hz, 1MHz]. The achieved
+    ///                     rate, see sample_rate(), is 10MHz divided by a
+    ///                     whole number.
+    /// @param[in] pin_mask GPIO pins captured: bit n selects pin n. Levels of
+    ///                     other pins are reported as zero. Pins need not be
+    ///                     open.
+    /// @throws std::invalid_argument if rate is out of range or pin_mask
+    ///         selects no pins.
+    /// @throws peripheral_in_use if any PWM channel is in use.
+    /// @throws bad_peripheral_alloc if the PWM FIFO or a DMA channel are not
+    ///         available.
+    /// @throws std::system_error or std::bad_alloc if DMA memory cannot be
+    ///         obtained.
+      explicit gpio_capture(hertz rate, std::uint64_t pin_mask = all_gpio_pins);
+
+    /// @brief Stop sampling and release resources.
+      ~gpio_capture();
+
+      gpio_capture(gpio_capture const &) = delete;
+      gpio_capture& operator=(gpio_capture const &) = delete;
+
+    /// @brief Capture samples, passing runs to a function.
+    ///
+    /// Blocks until all samples have been taken and their runs passed to
+    /// sink. Runs are passed as they complete; the final run is passed when
+    /// the last sample has been read so may be shorter than the levels
+    /// lasted. Each call starts a new capture.
+    ///
+    /// @param[in] samples  Number of samples to capture.
+    /// @param[in] sink     Function called with each run.
+    /// @returns Capture description of the samples read.
+    /// @throws std::runtime_error if samples were overwritten before being
+    ///         read.
+    /// @throws Any exception thrown by sink.
+      gpio_capture_header capture(std::uint64_t samples, run_sink const & sink);
+
+    /// @brief Capture samples, writing them to a stream in run-length
+    /// encoded format.
+    /// @param[in] samples  Number of samples to capture.
+    /// @param[in] os       Stream, opened in binary mode, to write to.
+    /// @returns Capture description of the samples written, as written in
+    ///          the stream header.
+    /// @throws std::runtime_error if samples were overwritten before being
+    ///         read.
+    /// @throws std::ios_base::failure if writing fails.
+      gpio_capture_header capture(std::uint64_t samples, std::ostream & os);
+
+    /// @brief Returns achieved sample rate.
+      f_hertz sample_rate() const;
+
+    /// @brief Returns mask of pins captured.
+      std::uint64_t pin_mask() const
+      {
+        return mask;
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_GPIO_CAPTURE_H
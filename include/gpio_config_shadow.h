@@ -0,0 +1,44 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_config_shadow.h
+/// @brief Opt-in process local shadowing of GPIO configuration registers.
+///
+/// Opening pins, setting pin alternative functions, switching open drain
+/// lines and enabling pin edge event detection all read-modify-write GPIO
+/// function select (GPFSELn) or detect enable (GPRENn, GPFENn...) registers.
+/// Each such update begins with a read of an uncached peripheral register,
+/// which stalls the CPU. With shadowing enabled the library keeps a copy of
+/// these registers as this process last wrote them, so updates are a single
+/// register store and pin function queries need no register read.
+///
+/// Shadowing is off by default. Only enable it when no other process, nor
+/// the kernel, changes these registers - or call resync_gpio_config_shadow()
+/// after they may have done so. Other GPIO registers, such as those setting
+/// and reading pin levels, are never shadowed.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_GPIO_CONFIG_SHADOW_H
+# define DIBASE_RPI_PERIPHERALS_GPIO_CONFIG_SHADOW_H
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Read the GPIO configuration registers into the shadow and use it
+  /// for all further updates.
+    void enable_gpio_config_shadow();
+
+  /// @brief Stop using the shadow: updates read-modify-write the registers.
+    void disable_gpio_config_shadow();
+
+  /// @brief Returns \c true if GPIO configuration registers are shadowed.
+    bool gpio_config_shadowed();
+
+  /// @brief Re-read the GPIO configuration registers into the shadow.
+  ///
+  /// Call after another process or the kernel may have changed pin
+  /// functions or detect enables while shadowing is enabled.
+    void resync_gpio_config_shadow();
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_GPIO_CONFIG_SHADOW_H
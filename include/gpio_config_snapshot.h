@@ -0,0 +1,82 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_config_snapshot.h
+/// @brief Save and restore the configuration of a set of GPIO pins : class
+/// definition
+///
+/// Switching a board between personalities by closing one set of pin
+/// objects and opening another read-modify-writes a GPFSELn register per
+/// pin and runs a pull sequence, with its waits, per input pin. A
+/// gpio_config_snapshot records the configuration of a set of pins:
+///   - their GPFSELn function select fields
+///   - their edge and level detect enable bits
+///   - their logical pull state: the pull last applied to each pin by this
+///     process, as pulls cannot be read back from the hardware.
+///
+/// Restoring a snapshot writes only the register words holding a field that
+/// differs, each at most once, and runs one pull sequence for each pull
+/// state that some pins must change to. Taking a snapshot of each
+/// personality once it is set up allows switching between them with a few
+/// register writes.
+///
+/// A snapshot does not own its pins. allocate_pins and deallocate_pins
+/// claim and release all of a snapshot's pins in one request, normally
+/// using a snapshot covering the pins of all personalities.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_GPIO_CONFIG_SNAPSHOT_H
+# define DIBASE_RPI_PERIPHERALS_GPIO_CONFIG_SNAPSHOT_H
+
+# include "pin_id.h"
+# include <cstdint>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Configuration of a set of GPIO pins that may be restored later.
+    class gpio_config_snapshot
+    {
+      std::uint32_t pin_masks[2];   ///< Pins covered, per bank
+      std::uint32_t fsels[6];       ///< GPFSEL0..5 fields of pins covered
+      std::uint32_t detects[6][2];  ///< Detect enable bits of pins covered
+      std::uint32_t pulls[3][2];    ///< Pins covered per logical pull state
+
+      std::vector<pin_id> pins() const;
+
+    public:
+    /// @brief Record the current configuration of a set of GPIO pins.
+    /// @param[in] pins Ids of GPIO pins to cover. Repeated ids are ignored.
+      explicit gpio_config_snapshot(std::vector<pin_id> const & pins);
+
+    /// @brief Record the current configuration of the pins covered,
+    /// replacing the previous record.
+      void capture();
+
+    /// @brief Set the pins covered to the configuration recorded.
+    ///
+    /// Pins whose pull state had not been set by this process when captured
+    /// have their pull left unchanged.
+      void restore() const;
+
+    /// @brief Returns \c true if a GPIO pin is covered by the snapshot.
+    /// @param[in] pin  Id of GPIO pin to query.
+      bool covers(pin_id pin) const;
+
+    /// @brief Allocate all the pins covered for use by this process.
+    ///
+    /// Either all pins are allocated or, if an exception is thrown, none
+    /// are.
+    /// @throws bad_peripheral_alloc if any pin is already in use by this
+    ///         process or elsewhere.
+      void allocate_pins() const;
+
+    /// @brief Deallocate all the pins covered.
+    /// @throws std::logic_error if any pin is not allocated by this process,
+    ///         in which case none are deallocated.
+      void deallocate_pins() const;
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_GPIO_CONFIG_SNAPSHOT_H
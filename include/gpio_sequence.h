@@ -0,0 +1,137 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_sequence.h
+/// @brief Precompiled GPIO output sequences played at system timer times :
+/// class definition.
+///
+/// A gpio_sequence is a series of steps, each changing the state of some of
+/// the pins of an \ref opin_group, played at a fixed interval. Steps are
+/// described as lists of (pin position, state) changes, like those of the
+/// led-string-display example, and compiled when added into GPSETn and
+/// GPCLRn masks held in one flat array, so playing a step is at most one
+/// GPSETn and one GPCLRn write per pin bank with no allocation or iteration
+/// over the changes. Steps are played at times read from the system timer:
+/// the player sleeps until shortly before each step is due then busy-waits
+/// for the exact microsecond, and step times are fixed from the start time so
+/// lateness of one step does not delay those after it.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_GPIO_SEQUENCE_H
+# define DIBASE_RPI_PERIPHERALS_GPIO_SEQUENCE_H
+
+# include "pin_group.h"
+# include "system_timer.h"
+# include <stdexcept>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Sequence of output pin group changes played at a fixed interval.
+    class gpio_sequence
+    {
+      opin_group const &          group;    ///< Pins the sequence drives
+      system_timer::duration      interval; ///< Time between steps
+      std::vector<std::uint32_t>  masks;    ///< GPSET0/1, GPCLR0/1 per step
+
+    public:
+    /// @brief Microseconds before a step is due that the player stops
+    /// sleeping and starts busy-waiting on the system timer.
+      constexpr static std::uint32_t spin_us = 200U;
+
+    /// @brief Create an empty sequence.
+    /// @param[in] pins           Group of output pins the sequence drives.
+    ///                           Must outlive the sequence.
+    /// @param[in] step_interval  Time from the start of one step to the next.
+    /// @throws std::invalid_argument if step_interval is negative.
+      gpio_sequence
+      ( opin_group const & pins
+      , system_timer::duration step_interval
+      );
+
+    /// @brief Returns the number of steps.
+      std::size_t size() const
+      {
+        return masks.size()/4U;
+      }
+
+    /// @brief Returns the time between steps.
+      system_timer::duration step_interval() const
+      {
+        return interval;
+      }
+
+    /// @brief Returns the time a whole sequence takes to play.
+      system_timer::duration duration() const
+      {
+        return interval*static_cast<system_timer::duration::rep>(size());
+      }
+
+    /// @brief Append a step changing the state of selected pins.
+    /// @param[in] mask   Bit n set if nth pin of the group is changed.
+    /// @param[in] values Bit n is the state of the nth pin of the group if
+    ///                   selected by mask: 1 for high, 0 for low.
+    /// @throws std::invalid_argument if mask has bits set for pins not in the
+    ///         group.
+      void append(pin_group_value_t mask, pin_group_value_t values);
+
+    /// @brief Append a step from a list of pin state changes.
+    ///
+    /// Later changes to a pin replace earlier ones in the same step.
+    /// @tparam Changes   Range type whose elements have members first, the
+    ///                   pin's position in the group, and second, its state
+    ///                   - for example std::vector<std::pair<int,bool>>.
+    /// @param[in] changes  Pin state changes of the step.
+    /// @throws std::invalid_argument if a position is not in the group.
+      template <class Changes>
+      void append(Changes const & changes)
+      {
+        pin_group_value_t mask{0U};
+        pin_group_value_t values{0U};
+        for (auto const & change : changes)
+          {
+            if ( change.first<0
+              || static_cast<std::size_t>(change.first)>=group.size()
+               )
+              {
+                throw std::invalid_argument{"gpio_sequence::append: pin "
+                                            "position is not in the group."};
+              }
+            pin_group_value_t const bit
+                                  {pin_group_value_t(1)<<change.first};
+            mask |= bit;
+            values = change.second ? values|bit : values&~bit;
+          }
+        append(mask, values);
+      }
+
+    /// @brief Remove all steps.
+      void clear()
+      {
+        masks.clear();
+      }
+
+    /// @brief Apply a step's changes to the pins now.
+    /// @param[in] step   Step index, less than size().
+    /// @throws std::out_of_range if step is not less than size().
+      void apply(std::size_t step) const;
+
+    /// @brief Wait until a given system timer time then apply a step.
+    ///
+    /// If due has already passed the step is applied immediately.
+    /// @param[in] step   Step index, less than size().
+    /// @param[in] due    System timer time to apply the step at.
+    /// @throws std::out_of_range if step is not less than size().
+      void play_step(std::size_t step, system_timer::time_point due) const;
+
+    /// @brief Play all steps, the first at a given time and each following
+    /// step_interval() after the one before.
+    /// @param[in] start  System timer time to apply the first step at.
+    /// @returns start+duration(): the time the step after the last is due, so
+    ///          plays may be chained without drift.
+      system_timer::time_point play(system_timer::time_point start) const;
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_GPIO_SEQUENCE_H
@@ -0,0 +1,77 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_transaction.h
+/// @brief Coalesce GPIO output pin writes until committed : class definition.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_GPIO_TRANSACTION_H
+# define DIBASE_RPI_PERIPHERALS_GPIO_TRANSACTION_H
+
+# include "pin.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+
+  /// @brief Collect opin::put calls and output them together.
+  ///
+  /// While a gpio_transaction is active, from construction to destruction,
+  /// opin::put calls made by the thread that created it do not write to the
+  /// GPIO registers. Instead the values are accumulated as set and clear
+  /// masks for each pin bank, later puts to a pin replacing earlier ones,
+  /// and output by commit or on destruction with at most one GPSETn and one
+  /// GPCLRn write per bank. Code making many separate opin::put calls can so
+  /// have its output batched without being restructured to use pin groups.
+  /// Only opin::put is affected: other output such as opin_group and
+  /// static_opin is immediate.
+  ///
+  /// Transactions may be nested within a thread: committing an inner
+  /// transaction adds its values to the enclosing one, so only the outermost
+  /// transaction writes to the GPIO registers and all values collected by
+  /// it and the transactions it encloses are output together.
+    class gpio_transaction
+    {
+      internal::gpio_put_batch    batch;
+      internal::gpio_put_batch *  outer;
+
+    public:
+    /// @brief Start collecting the calling thread's opin::put calls, within
+    /// its innermost active transaction if it has one.
+      gpio_transaction();
+
+    /// @brief Commit collected values and stop collecting.
+    ///
+    /// Must be destroyed by the thread that created it, and transactions
+    /// must be destroyed in the reverse order of their construction.
+      ~gpio_transaction();
+
+      gpio_transaction(gpio_transaction const &) = delete;
+      gpio_transaction & operator=(gpio_transaction const &) = delete;
+      gpio_transaction(gpio_transaction &&) = delete;
+      gpio_transaction & operator=(gpio_transaction &&) = delete;
+
+    /// @brief Output values collected so far and clear them.
+    ///
+    /// Collecting continues. If this is the outermost transaction then for
+    /// each bank pins put high are set with one write to GPSETn followed by
+    /// pins put low cleared by one write to GPCLRn. Banks with no pins to
+    /// set or clear are not written. Otherwise the values are added to the
+    /// enclosing transaction to be output when it is committed.
+      void commit();
+
+    /// @brief Discard values collected so far without outputting them.
+      void discard();
+
+    /// @brief Returns true if any values have been collected since
+    /// construction or the last commit or discard.
+      bool pending() const
+      {
+        return (batch.set_masks[0]|batch.set_masks[1]
+               |batch.clear_masks[0]|batch.clear_masks[1]
+               )!=0U;
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_GPIO_TRANSACTION_H
@@ -0,0 +1,136 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file i2c_device.h
+/// @brief I2C slave device with 8-bit registers and a shadow register cache :
+/// class definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_I2C_DEVICE_H
+# define DIBASE_RPI_PERIPHERALS_I2C_DEVICE_H
+
+# include "i2c_pins.h"
+# include <array>
+# include <bitset>
+# include <initializer_list>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief An I2C slave device with up to 256 8-bit registers, keeping a
+  /// shadow copy of the registers marked cacheable.
+  ///
+  /// Registers are addressed in the common way: a register is read by a
+  /// write of its number followed by a repeated start read, and written by
+  /// writing its number followed by its value. Writing or reading several
+  /// bytes accesses consecutive registers (the device auto-increments the
+  /// register number).
+  ///
+  /// Cacheable registers should be ones only changed by the host, such as
+  /// configuration registers. Reading a cacheable register only uses the bus
+  /// the first time, and modify() updates bits of a cacheable register in
+  /// the shadow copy only, marking it changed. flush() then writes the
+  /// changed registers, each run of consecutive changed registers in one
+  /// write transaction. write() writes through to the device, updating the
+  /// shadow copy of a cacheable register.
+  ///
+  /// Transactions that fail throw std::runtime_error, with the i2c_pins
+  /// error states cleared.
+  ///
+  /// The i2c_pins object must outlive the i2c_device object.
+    class i2c_device
+    {
+      constexpr static std::size_t number_of_registers = 256U;
+
+      i2c_pins &                          pins;
+      std::uint32_t                       address;
+      std::array<std::uint8_t, number_of_registers> shadow;
+      std::bitset<number_of_registers>    cacheable;
+      std::bitset<number_of_registers>    valid;
+      std::bitset<number_of_registers>    dirty;
+
+      void check(int state, char const * what);
+
+    public:
+    /// @brief Construct from bus, slave address and cacheable registers.
+    /// @param[in] p        i2c_pins object for the bus the device is on.
+    /// @param[in] addrs    Slave address [0,127].
+    /// @param[in] cached   Numbers of registers that may be cached.
+    /// @throws std::out_of_range if addrs is out of range.
+      i2c_device
+      ( i2c_pins & p
+      , std::uint32_t addrs
+      , std::initializer_list<std::uint8_t> cached
+      );
+
+      i2c_device(i2c_device const &) = delete;
+      i2c_device& operator=(i2c_device const &) = delete;
+
+    /// @brief Returns the device's slave address.
+      std::uint32_t slave_address() const
+      {
+        return address;
+      }
+
+    /// @brief Query whether a register may be cached.
+      bool is_cacheable(std::uint8_t reg) const
+      {
+        return cacheable.test(reg);
+      }
+
+    /// @brief Query whether a cacheable register has changes to flush.
+      bool is_dirty(std::uint8_t reg) const
+      {
+        return dirty.test(reg);
+      }
+
+    /// @brief Read a register.
+    ///
+    /// A cacheable register's shadow value is returned if it has one,
+    /// otherwise the register is read from the device (and shadowed if
+    /// cacheable).
+    /// @param[in] reg  Register number.
+    /// @returns register value.
+    /// @throws std::runtime_error if a transaction fails.
+      std::uint8_t read(std::uint8_t reg);
+
+    /// @brief Write a register to the device.
+    ///
+    /// Writes through to the device, replacing any shadow value and any
+    /// unflushed changes to the register.
+    /// @param[in] reg    Register number.
+    /// @param[in] value  Value to write.
+    /// @throws std::runtime_error if the transaction fails.
+      void write(std::uint8_t reg, std::uint8_t value);
+
+    /// @brief Update bits of a cacheable register's shadow value.
+    ///
+    /// The register is read from the device first if it has no shadow value.
+    /// The register is marked changed only if its value changes.
+    /// @param[in] reg    Register number. Must be cacheable.
+    /// @param[in] mask   Bits to update.
+    /// @param[in] bits   New values for the bits in mask.
+    /// @throws std::invalid_argument if reg is not cacheable.
+    /// @throws std::runtime_error if a read transaction fails.
+      void modify(std::uint8_t reg, std::uint8_t mask, std::uint8_t bits);
+
+    /// @brief Write changed cacheable registers to the device.
+    ///
+    /// Each run of consecutive changed registers is written in one
+    /// transaction.
+    /// @returns Number of write transactions performed.
+    /// @throws std::runtime_error if a transaction fails. Registers not yet
+    ///         written remain marked changed.
+      std::size_t flush();
+
+    /// @brief Discard all shadow values and unflushed changes, for example
+    /// after the device has been reset.
+      void invalidate()
+      {
+        valid.reset();
+        dirty.reset();
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_I2C_DEVICE_H
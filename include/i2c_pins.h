@@ -6,8 +6,10 @@
 /// The BCM2835 supports 3 I2C style serial interfaces called BSC (for
 /// Broadcom Serial Controller) in the Broadcom documentation. The peripherals
 /// are known as BSC0, BSC1 and BSC2. Only BSC0 and BSC1 are for general use
-/// (BSC2 is used by the HDMI interface). Each BSC peripheral requires 2 GPIO
-/// lines for the I2C SCL (serial clock) and SDA (serial data) lines.
+/// (BSC2 is used by the HDMI interface). The BCM2711 adds BSC3 to BSC6, each
+/// of which can be used in parallel with BSC0 and BSC1 on its own GPIO pin
+/// pairs. Each BSC peripheral requires 2 GPIO lines for the I2C SCL (serial
+/// clock) and SDA (serial data) lines.
 /// For more details see the
 /// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
 /// Broadcom BCM2835 ARM Peripherals Datasheet</a> Chapter 3 BSC.
@@ -22,8 +24,13 @@
 # define DIBASE_RPI_PERIPHERALS_I2C_PINS_H
 # include "pin_id.h"
 # include "clockdefs.h"
+# include "wait_policy.h"
+# include "io_counters.h"
+# include "system_timer.h"
 # include <array>
 # include <cstdint>
+# include <system_error>
+# include <vector>
 
 namespace dibase { namespace rpi {
   namespace peripherals
@@ -40,6 +47,182 @@ namespace dibase { namespace rpi {
     ///
       constexpr hertz  i2c_pins_default_frequency = hertz{100000};
 
+    /// @brief How i2c_pins::scan probes each address for a device.
+      enum class i2c_probe
+      { automatic   ///< As i2cdetect: read_byte for addresses 0x30..0x37 and
+                    ///< 0x50..0x5f (EEPROMs, which a quick write may corrupt)
+                    ///< and quick_write for others
+      , quick_write ///< Zero length write: the address alone is sent
+      , read_byte   ///< Single byte read
+      };
+
+    /// @brief Default highest frequency tried by i2c_pins::tune_timing: 1MHz,
+    /// the maximum for I2C fast mode plus.
+      constexpr hertz  i2c_pins_max_tune_frequency = hertz{1000000};
+
+    /// @brief I2C/BSC bus clock frequency and timing settings.
+    ///
+    /// The values of the i2c_pins constructor parameters of the same names.
+    /// Returned by i2c_pins::timing and i2c_pins::tune_timing and applied by
+    /// i2c_pins::set_timing, so settings found by tuning can be reused.
+      struct i2c_timing
+      {
+        hertz         frequency;  ///< SCL frequency
+        std::uint16_t tout;       ///< Clock stretch time out, SCL cycles
+        std::uint16_t fedl;       ///< SCL falling edge delay, core clocks
+        std::uint16_t redl;       ///< SCL rising edge delay, core clocks
+      };
+
+  /// @brief Enumeration of the I2C/BSC lines of a BSC peripheral
+    enum class i2c_line : unsigned
+    { sda   ///< Serial data
+    , scl   ///< Serial clock
+    };
+
+  /// @brief A GPIO pin alternative function supporting a BSC peripheral line
+    struct i2c_pin_alt_fn_entry
+    {
+      pin_id_int_t  pin;  ///< GPIO pin number
+      int           bsc;  ///< BSC peripheral number, 0, 1 or 3..6
+      i2c_line      line; ///< BSC peripheral line
+      int           alt;  ///< Alternative function number, 0..5
+    };
+
+  /// @brief Number of i2c_pin_alt_fns entries
+    constexpr std::size_t number_of_i2c_pin_alt_fns{26U};
+
+  /// @brief GPIO pin alternative functions supporting BSC0, BSC1 and the
+  /// BCM2711 only BSC3 to BSC6 lines
+  ///
+  /// BSC0 and BSC1 entries from table 6-31 of the BCM2835 ARM Peripherals
+  /// datasheet, BSC3 to BSC6 entries from section 5.3 of the BCM2711 ARM
+  /// Peripherals datasheet.
+    constexpr i2c_pin_alt_fn_entry
+    i2c_pin_alt_fns[number_of_i2c_pin_alt_fns]
+    { { 0U, 0, i2c_line::sda, 0}, { 1U, 0, i2c_line::scl, 0}
+    , {28U, 0, i2c_line::sda, 0}, {29U, 0, i2c_line::scl, 0}
+    , {44U, 0, i2c_line::sda, 1}, {45U, 0, i2c_line::scl, 1}
+    , { 2U, 1, i2c_line::sda, 0}, { 3U, 1, i2c_line::scl, 0}
+    , {44U, 1, i2c_line::sda, 2}, {45U, 1, i2c_line::scl, 2}
+    , { 2U, 3, i2c_line::sda, 5}, { 3U, 3, i2c_line::scl, 5}
+    , { 4U, 3, i2c_line::sda, 5}, { 5U, 3, i2c_line::scl, 5}
+    , { 6U, 4, i2c_line::sda, 5}, { 7U, 4, i2c_line::scl, 5}
+    , { 8U, 4, i2c_line::sda, 5}, { 9U, 4, i2c_line::scl, 5}
+    , {10U, 5, i2c_line::sda, 5}, {11U, 5, i2c_line::scl, 5}
+    , {12U, 5, i2c_line::sda, 5}, {13U, 5, i2c_line::scl, 5}
+    , { 0U, 6, i2c_line::sda, 5}, { 1U, 6, i2c_line::scl, 5}
+    , {22U, 6, i2c_line::sda, 5}, {23U, 6, i2c_line::scl, 5}
+    };
+
+  /// @brief Returns \c true if a BSC peripheral number is one of the
+  /// BCM2711 only BSC3 to BSC6.
+  /// @param[in] bsc  BSC peripheral number
+    constexpr bool is_bcm2711_bsc(int bsc)
+    {
+      return bsc>=3 && bsc<=6;
+    }
+
+  /// @brief Returns the alternative function number selecting a BSC
+  /// peripheral line on a GPIO pin, or -1 if the pin does not support it.
+  /// @param[in] pin  GPIO pin number
+  /// @param[in] bsc  BSC peripheral number
+  /// @param[in] line BSC peripheral line
+  /// @param[in] idx  i2c_pin_alt_fns index to start search from
+    constexpr int i2c_pin_alt_fn
+    ( pin_id_int_t pin
+    , int bsc
+    , i2c_line line
+    , std::size_t idx = 0U
+    )
+    {
+      return idx==number_of_i2c_pin_alt_fns ? -1
+           : ( i2c_pin_alt_fns[idx].pin==pin
+            && i2c_pin_alt_fns[idx].bsc==bsc
+            && i2c_pin_alt_fns[idx].line==line
+             ) ? i2c_pin_alt_fns[idx].alt
+           : i2c_pin_alt_fn(pin, bsc, line, idx+1U);
+    }
+
+  /// @brief Returns \c true if a GPIO pin pair supports the SDA and SCL
+  /// lines of a BSC peripheral.
+  /// @param[in] sda  SDA GPIO pin number
+  /// @param[in] scl  SCL GPIO pin number
+  /// @param[in] bsc  BSC peripheral number
+    constexpr bool i2c_pin_pair_supports
+    ( pin_id_int_t sda
+    , pin_id_int_t scl
+    , int bsc
+    )
+    {
+      return i2c_pin_alt_fn(sda, bsc, i2c_line::sda)>=0
+          && i2c_pin_alt_fn(scl, bsc, i2c_line::scl)>=0;
+    }
+
+  /// @brief Value returned by i2c_pin_pair_bsc if a pin pair supports both
+  /// BSC0 and BSC1.
+    constexpr int i2c_bsc_ambiguous{-2};
+
+  /// @brief Returns the BCM2711 only BSC peripheral, BSC3 to BSC6, supported
+  /// by a GPIO pin pair, or -1 if none is.
+  /// @param[in] sda  SDA GPIO pin number
+  /// @param[in] scl  SCL GPIO pin number
+  /// @param[in] bsc  BSC peripheral number to start search from
+    constexpr int i2c_pin_pair_bcm2711_bsc
+    ( pin_id_int_t sda
+    , pin_id_int_t scl
+    , int bsc = 3
+    )
+    {
+      return !is_bcm2711_bsc(bsc) ? -1
+           : i2c_pin_pair_supports(sda, scl, bsc) ? bsc
+           : i2c_pin_pair_bcm2711_bsc(sda, scl, bsc+1);
+    }
+
+  /// @brief Returns the BSC peripheral supported by a GPIO pin pair.
+  ///
+  /// BSC0 and BSC1, available on all SoCs, are preferred to the BCM2711 only
+  /// BSC peripherals: pins 2 and 3, for example, select BSC1 not BSC3.
+  /// @param[in] sda  SDA GPIO pin number
+  /// @param[in] scl  SCL GPIO pin number
+  /// @returns 0 or 1 if the pair supports only BSC0 or BSC1,
+  ///          \ref i2c_bsc_ambiguous if it supports both, otherwise the one
+  ///          of BSC3 to BSC6 it supports or -1 if none.
+    constexpr int i2c_pin_pair_bsc(pin_id_int_t sda, pin_id_int_t scl)
+    {
+      return i2c_pin_pair_supports(sda, scl, 0)
+              ? (i2c_pin_pair_supports(sda, scl, 1) ? i2c_bsc_ambiguous : 0)
+           : i2c_pin_pair_supports(sda, scl, 1) ? 1
+           : i2c_pin_pair_bcm2711_bsc(sda, scl);
+    }
+
+  /// @brief Simple constexpr type template to hold I2C/BSC pin pairs
+  /// @tparam SDA SDA (serial data) GPIO pin number
+  /// @tparam SCL SCL (serial clock) GPIO pin number
+  /// @tparam BSC BSC peripheral number. Defaults to the one BSC peripheral
+  ///             supported by the pins. Must be given if they support both.
+    template  < pin_id_int_t SDA
+              , pin_id_int_t SCL
+              , int BSC = i2c_pin_pair_bsc(SDA, SCL)
+              >
+    struct i2c_pin_set
+    {
+    /// @returns Specialisation type's SDA parameter value
+      constexpr pin_id_int_t sda() { return SDA; }
+
+    /// @returns Specialisation type's SCL parameter value
+      constexpr pin_id_int_t scl() { return SCL; }
+
+    /// @returns Specialisation type's BSC parameter value
+      constexpr int bsc() { return BSC; }
+    };
+
+  /// @brief BSC0 pin pair on a revision 1 Raspberry Pi's P1 connector
+    constexpr i2c_pin_set<0U, 1U>  rpi_p1_rev1_i2c_pin_set;
+
+  /// @brief BSC1 pin pair on a revision 2 or later Raspberry Pi's P1
+  /// connector
+    constexpr i2c_pin_set<2U, 3U>  rpi_p1_rev2_i2c_pin_set;
+
   /// @brief Use a pair of GPIO pins with a I2C / BSC peripheral.
   ///
   /// Each of the BSC peripherals that can be mapped to GPIO pins have multiple
@@ -58,12 +241,57 @@ namespace dibase { namespace rpi {
   /// BSC peripheral is set-up as per the parameters, with the GPIO pins and
   /// BSC peripheral marked as in use. Note that no attempt is made to see if
   /// the BSC peripheral is in use externally by other processes.
+  ///
+  /// Only construction accesses the GPIO as well as the BSC peripheral and
+  /// places a peripheral_barrier() at each switch between them. Transfer and
+  /// status operations access just the BSC registers so are barrier free.
     class i2c_pins
     {
       constexpr static unsigned number_of_pins = 2U;
 
       std::array<pin_id_int_t, number_of_pins>  pins;
-      std::size_t                               bsc_idx; // 0 or 1
+      std::size_t                               bsc_idx; // 0, 1 or 3..6
+      wait_policy                               waiting;
+      wait_stats                                wait_counts;
+      io_counter_set                            counters;
+
+      void release();
+      void construct
+      ( pin_id        sda_pin
+      , pin_id        scl_pin
+      , int           bsc_num
+      , int           sda_alt
+      , int           scl_alt
+      , hertz         f
+      , std::uint16_t tout
+      , std::uint16_t fedl
+      , std::uint16_t redl
+      , hertz         fc
+      );
+      void enable_interrupts(bool enable);
+      void count_errors(int state);
+      int combined_transfer
+      ( std::uint8_t const * ptx
+      , std::size_t tx_count
+      , std::uint8_t * prx
+      , std::size_t rx_count
+      , std::size_t * pread
+      , bool clean
+      );
+      int write_all_until
+      ( std::uint32_t addrs
+      , std::uint8_t const * ptx
+      , std::size_t count
+      , std::size_t * pwritten
+      , std::uint64_t const * pdeadline_us
+      );
+      int read_all_until
+      ( std::uint32_t addrs
+      , std::uint8_t * prx
+      , std::size_t count
+      , std::size_t * pread
+      , std::uint64_t const * pdeadline_us
+      );
 
     public:
     /// @brief Error state enumeration
@@ -71,6 +299,8 @@ namespace dibase { namespace rpi {
       { goodbit = 0         ///< No BSC errors
       , timeoutbit = 1      ///< Slave stretched clock beyond the set time out
       , noackowledgebit = 2 ///< Slave did not acknowledge its address
+      , incompletebit = 4   ///< Combined transaction did not complete
+      , expiredbit = 8      ///< Call's time out expired before transaction done
       };
 
     /// @brief Default value for constructor \c tout parameters, the BSC/I2C
@@ -94,7 +324,8 @@ namespace dibase { namespace rpi {
     /// Creates a i2c_pins object from a pair of GPIO pins values and
     /// optionally BSC frequency and timing values. The pair of GPIO pins
     /// specified _must_ both support a function for exactly _one_ ( 1 ) BSC
-    /// peripheral.
+    /// peripheral. Pins supporting BSC0 or BSC1 use it in preference to any
+    /// of the BCM2711 only BSC3 to BSC6 they also support.
     ///
     /// @post The GPIO pins indicated by the \c sda_pin and \c scl_pin
     ///       parameters will be allocated as in use within the process and
@@ -134,7 +365,8 @@ namespace dibase { namespace rpi {
     ///
     /// @throws std::invalid_argument if either requested pin does not support
     ///         the required special function or their functions are for
-    ///         different BSC peripherals.
+    ///         different BSC peripherals, or if they are for one of BSC3 to
+    ///         BSC6 and the running SoC is not a BCM2711.
     /// @throws std::range_error if any pin supports the same BSC function
     ///         by more than one alternative function -- use the constructor
     ///         taking an integer index indicating which BSC peripheral
@@ -178,6 +410,8 @@ namespace dibase { namespace rpi {
     ///                     line
     /// @param[in] bsc_num  BSC peripheral number specifying BSC0 or BSC1
     ///                     In the range [0,1]; 0 to use BSC0, 1 to use BSC1.
+    ///                     On a BCM2711 may also be in the range [3,6] to use
+    ///                     BSC3 to BSC6.
     /// @param[in] f        Frequency of the I2C/BSC clock SCL in the range 
     ///                     [\c fc/2, \c fc/32768]. Non-integral values of
     ///                     \c fc/f are rounded down so the actual frequency
@@ -203,9 +437,10 @@ namespace dibase { namespace rpi {
     ///
     /// @throws std::invalid_argument if either requested pin does not support
     ///         the required special function or their functions are for
-    ///         different BSC peripherals.
+    ///         different BSC peripherals, or if \c bsc_num is in [3,6] and
+    ///         the running SoC is not a BCM2711.
     /// @throws std::out_of_range if the \c f, \c fedl or \c redl parameters
-    ///         are not in range or \c bsc_num is not 0 or 1.
+    ///         are not in range or \c bsc_num is not 0, 1 or in [3,6].
     /// @throws bad_peripheral_alloc if either of the pins or the BSC
     ///         peripheral are already in use.
     /// @throws !std::range_error <em>Should not occur. 
@@ -220,6 +455,59 @@ namespace dibase { namespace rpi {
               , hertz         fc    = rpi_apb_core_frequency
               );
 
+    /// @brief Construct from a i2c_pin_set specialisation and BSC
+    /// parameters.
+    ///
+    /// As the constructors taking GPIO pin ids except that the pins' support
+    /// for the BSC peripheral's SDA and SCL functions, and the alternative
+    /// functions selecting them, are determined at compile time: a pin set
+    /// whose pins do not support the lines of one BSC peripheral fails to
+    /// compile. Construction is just allocating the pins and BSC peripheral
+    /// and a batched GPFSELn update.
+    ///
+    /// @tparam SDA i2c_pin_set SDA template parameter.
+    /// @tparam SCL i2c_pin_set SCL template parameter.
+    /// @tparam BSC i2c_pin_set BSC template parameter.
+    /// @param[in] ps   i2c_pin_set specialisation specifying the GPIO pins
+    ///                 and BSC peripheral to use.
+    /// @param[in] f    As for the constructors taking GPIO pin ids.
+    /// @param[in] tout As for the constructors taking GPIO pin ids.
+    /// @param[in] fedl As for the constructors taking GPIO pin ids.
+    /// @param[in] redl As for the constructors taking GPIO pin ids.
+    /// @param[in] fc   As for the constructors taking GPIO pin ids.
+    ///
+    /// @throws std::out_of_range if the \c f, \c fedl or \c redl parameters
+    ///         are not in range.
+    /// @throws std::invalid_argument if BSC is one of BSC3 to BSC6 and the
+    ///         running SoC is not a BCM2711.
+    /// @throws bad_peripheral_alloc if either of the pins or the BSC
+    ///         peripheral are already in use.
+      template <pin_id_int_t SDA, pin_id_int_t SCL, int BSC>
+      explicit i2c_pins
+      ( i2c_pin_set<SDA,SCL,BSC> ps
+      , hertz         f     = i2c_pins_default_frequency
+      , std::uint16_t tout  = default_tout
+      , std::uint16_t fedl  = default_fedl
+      , std::uint16_t redl  = default_redl
+      , hertz         fc    = rpi_apb_core_frequency
+      )
+      {
+        static_assert( BSC!=i2c_bsc_ambiguous
+                     , "i2c_pins: pins support both BSC peripherals: give "
+                       "the i2c_pin_set BSC parameter"
+                     );
+        static_assert( (BSC==0 || BSC==1 || is_bcm2711_bsc(BSC))
+                    && i2c_pin_pair_supports(SDA, SCL, BSC)
+                     , "i2c_pins: pins do not support the SDA and SCL lines "
+                       "of one BSC peripheral"
+                     );
+        construct( pin_id(ps.sda()), pin_id(ps.scl()), ps.bsc()
+                 , i2c_pin_alt_fn(SDA, BSC, i2c_line::sda)
+                 , i2c_pin_alt_fn(SCL, BSC, i2c_line::scl)
+                 , f, tout, fedl, redl, fc
+                 );
+      }
+
     /// @brief Destroy: Clear data, abort any transfer, free GPIO pins & BSC
     /// peripheral.
     /// @post The FIFO is cleared, any in progress transfer is aborted.
@@ -230,8 +518,15 @@ namespace dibase { namespace rpi {
 
       i2c_pins(i2c_pins const &) = delete;
       i2c_pins& operator=(i2c_pins const &) = delete;
-      i2c_pins(i2c_pins &&) = delete;
-      i2c_pins& operator=(i2c_pins &&) = delete;
+
+    /// @brief Move construct, taking over other's pins and BSC peripheral.
+    ///
+    /// other is left owning nothing: it may only be destroyed or assigned to.
+      i2c_pins(i2c_pins && other) noexcept;
+
+    /// @brief Move assign: release anything owned by this object as for
+    /// destruction then take over other's pins and BSC peripheral.
+      i2c_pins& operator=(i2c_pins && other);
 
     /// @brief Start a write transaction to the specified slave device and
     /// write initial bytes from a buffer to the FIFO for transmission to the
@@ -256,6 +551,29 @@ namespace dibase { namespace rpi {
       , std::size_t count
       );
 
+    /// @brief Start a write transaction as \ref start_write but reporting
+    /// failure without throwing, for use in polling loops.
+    ///
+    /// @param[in] addrs  Slave address [0,127].
+    /// @param[in] dlen   Number of bytes to be written [0,65535].
+    /// @param[in] pdata  Pointer to data bytes to write. Pass \c nullptr to
+    ///                   write nothing to the FIFO initially.
+    /// @param[in] count  Maximum number of bytes to write in this call.
+    /// @param[out] ec    Set to std::errc::device_or_resource_busy if there
+    ///                   is already a transaction in progress,
+    ///                   std::errc::invalid_argument if \c addrs or \c dlen
+    ///                   are out of range, in which case no transaction is
+    ///                   started, and cleared otherwise.
+    /// @returns  Number of bytes actually written to the FIFO, zero on
+    ///           failure.
+      std::size_t start_write
+      ( std::uint32_t addrs
+      , std::uint32_t dlen
+      , std::uint8_t const * pdata
+      , std::size_t count
+      , std::error_code & ec
+      ) noexcept;
+
     /// @brief Write bytes from buffer to the FIFO for transmission to the
     /// slave addressed in a currently active write operation
     ///
@@ -325,6 +643,367 @@ namespace dibase { namespace rpi {
       , std::uint32_t dlen
       );
 
+    /// @brief Perform a complete write transaction of up to 65535 bytes.
+    ///
+    /// The FIFO is refilled as it empties, a whole FIFO's worth at a time
+    /// when it is found empty, until the transaction is done. Blocks until
+    /// the transaction completes or fails.
+    ///
+    /// Any error states set before the call are cleared.
+    ///
+    /// @param[in] addrs    Slave address [0,127].
+    /// @param[in] ptx      Pointer to bytes to write.
+    /// @param[in] count    Number of bytes to write [0,65535].
+    /// @param[out] pwritten Defaults to \c nullptr. If not \c nullptr the
+    ///                     number of bytes written to the FIFO is written to
+    ///                     it.
+    /// @returns i2c_pins::goodbit if all bytes were transferred, otherwise
+    ///          one or both i2c_pins::timeoutbit, i2c_pins::noackowledgebit
+    ///          if errors occurred, or i2c_pins::incompletebit if the
+    ///          transaction ended before all bytes were written with no error
+    ///          set.
+    /// @throws std::out_of_range if the \c addrs or \c count parameters are
+    ///         not in the allowed range of values.
+    /// @throws std::logic_error if there is already a transaction in progress.
+      int write_all
+      ( std::uint32_t addrs
+      , std::uint8_t const * ptx
+      , std::size_t count
+      , std::size_t * pwritten = nullptr
+      )
+      {
+        return write_all_until(addrs, ptx, count, pwritten, nullptr);
+      }
+
+    /// @brief Perform a complete write transaction of up to 65535 bytes,
+    /// giving up if it is not done within a time out.
+    ///
+    /// As write_all without a time out, except that if the transaction is
+    /// not done when the time out expires it is aborted.
+    ///
+    /// @param[in] addrs    Slave address [0,127].
+    /// @param[in] ptx      Pointer to bytes to write.
+    /// @param[in] count    Number of bytes to write [0,65535].
+    /// @param[in] timeout  Longest time to wait for the transaction to be
+    ///                     done. Only checked while waiting.
+    /// @param[out] pwritten Defaults to \c nullptr. If not \c nullptr the
+    ///                     number of bytes written to the FIFO is written to
+    ///                     it.
+    /// @returns As for write_all without a time out, with
+    ///          i2c_pins::expiredbit set if the time out expired.
+    /// @throws std::out_of_range if the \c addrs or \c count parameters are
+    ///         not in the allowed range of values.
+    /// @throws std::logic_error if there is already a transaction in progress.
+      int write_all
+      ( std::uint32_t addrs
+      , std::uint8_t const * ptx
+      , std::size_t count
+      , system_timer::duration timeout
+      , std::size_t * pwritten = nullptr
+      );
+
+    /// @brief Perform a complete read transaction of up to 65535 bytes.
+    ///
+    /// The FIFO is drained as data arrives, a whole FIFO's worth at a time
+    /// when it is found full, until the transaction is done. Blocks until
+    /// the transaction completes or fails.
+    ///
+    /// Any error states set before the call are cleared.
+    ///
+    /// @param[in] addrs    Slave address [0,127].
+    /// @param[out] prx     Pointer to buffer for bytes received.
+    /// @param[in] count    Number of bytes to read [0,65535].
+    /// @param[out] pread   Defaults to \c nullptr. If not \c nullptr the
+    ///                     number of bytes received is written to it.
+    /// @returns As for write_all, with i2c_pins::incompletebit meaning fewer
+    ///          than count bytes were received.
+    /// @throws std::out_of_range if the \c addrs or \c count parameters are
+    ///         not in the allowed range of values.
+    /// @throws std::logic_error if there is already a transaction in progress.
+      int read_all
+      ( std::uint32_t addrs
+      , std::uint8_t * prx
+      , std::size_t count
+      , std::size_t * pread = nullptr
+      )
+      {
+        return read_all_until(addrs, prx, count, pread, nullptr);
+      }
+
+    /// @brief Perform a complete read transaction of up to 65535 bytes,
+    /// giving up if it is not done within a time out.
+    ///
+    /// As read_all without a time out, except that if fewer than count bytes
+    /// have been received when the time out expires the transaction is
+    /// aborted.
+    ///
+    /// @param[in] addrs    Slave address [0,127].
+    /// @param[out] prx     Pointer to buffer for bytes received.
+    /// @param[in] count    Number of bytes to read [0,65535].
+    /// @param[in] timeout  Longest time to wait for the transaction to be
+    ///                     done. Only checked while waiting.
+    /// @param[out] pread   Defaults to \c nullptr. If not \c nullptr the
+    ///                     number of bytes received is written to it.
+    /// @returns As for read_all without a time out, with i2c_pins::expiredbit
+    ///          set if the time out expired.
+    /// @throws std::out_of_range if the \c addrs or \c count parameters are
+    ///         not in the allowed range of values.
+    /// @throws std::logic_error if there is already a transaction in progress.
+      int read_all
+      ( std::uint32_t addrs
+      , std::uint8_t * prx
+      , std::size_t count
+      , system_timer::duration timeout
+      , std::size_t * pread = nullptr
+      );
+
+    /// @brief Returns the BSC master in use: 0 for BSC0, 1 for BSC1
+      unsigned bus() const
+      {
+        return static_cast<unsigned>(bsc_idx);
+      }
+
+    /// @brief Perform a complete write then read (repeated start) combined
+    /// transaction with the specified slave device.
+    ///
+    /// The bytes to write are placed in the FIFO and the write started, then
+    /// the read is set up to follow with an I2C repeated start. Received
+    /// bytes are read from the FIFO as they arrive until the transaction is
+    /// done. Blocks until the transaction completes or fails.
+    ///
+    /// Any error states set before the call are cleared.
+    ///
+    /// @param[in] addrs    Slave address [0,127]. Note that values [0,7] and
+    ///                     [120,127] have special meanings in the I2C
+    ///                     specification.
+    /// @param[in] ptx      Pointer to bytes to write.
+    /// @param[in] tx_count Number of bytes to write [1,16]. All must fit
+    ///                     into the FIFO.
+    /// @param[out] prx     Pointer to buffer for bytes received.
+    /// @param[in] rx_count Number of bytes to receive from slave [0,65535].
+    /// @param[out] pread   Defaults to \c nullptr. If not \c nullptr the
+    ///                     number of bytes received is written to it.
+    /// @returns i2c_pins::goodbit if all bytes were transferred, otherwise
+    ///          one or both i2c_pins::timeoutbit, i2c_pins::noackowledgebit
+    ///          if errors occurred, or i2c_pins::incompletebit if the start of
+    ///          the write was missed or fewer than rx_count bytes were
+    ///          received with no error set. The error states are left set
+    ///          for error_state() to report them.
+    /// @throws std::out_of_range if the \c addrs, \c tx_count or \c rx_count
+    ///         parameters are not in the allowed range of values.
+    /// @throws std::logic_error if there is already a transaction in progress.
+      int write_then_read
+      ( std::uint32_t addrs
+      , std::uint8_t const * ptx
+      , std::size_t tx_count
+      , std::uint8_t * prx
+      , std::size_t rx_count
+      , std::size_t * pread = nullptr
+      );
+
+    /// @brief Read bytes from a slave register: a combined transaction
+    /// writing the single byte register number then reading.
+    ///
+    /// Equivalent to write_then_read(addrs, &reg, 1, prx, count, pread).
+    ///
+    /// @param[in] addrs  Slave address [0,127].
+    /// @param[in] reg    Slave register number to write.
+    /// @param[out] prx   Pointer to buffer for bytes received.
+    /// @param[in] count  Number of bytes to receive from slave [0,65535].
+    /// @param[out] pread Defaults to \c nullptr. If not \c nullptr the number
+    ///                   of bytes received is written to it.
+    /// @returns As for write_then_read.
+    /// @throws std::out_of_range if the \c addrs or \c count parameters are
+    ///         not in the allowed range of values.
+    /// @throws std::logic_error if there is already a transaction in progress.
+      int read_register
+      ( std::uint32_t addrs
+      , std::uint8_t reg
+      , std::uint8_t * prx
+      , std::size_t count
+      , std::size_t * pread = nullptr
+      )
+      {
+        return write_then_read(addrs, &reg, 1U, prx, count, pread);
+      }
+
+    /// @brief Read one byte register from each of a list of slaves.
+    ///
+    /// For each address in turn performs a combined transaction writing reg
+    /// then reading one byte, as read_register(addrs[n], reg, &values[n], 1)
+    /// would, but with all parameter checks made once up front and the error
+    /// state and FIFO only cleared after a device's transaction fails, so
+    /// the transactions run back to back.
+    ///
+    /// @param[in] paddrs   Pointer to slave addresses [0,127].
+    /// @param[in] count    Number of slave addresses.
+    /// @param[in] reg      Slave register number to read from each slave.
+    /// @param[out] pvalues Pointer to buffer for count register values. The
+    ///                     value of a slave whose transaction fails is 0.
+    /// @param[out] pstates Defaults to \c nullptr. If not \c nullptr
+    ///                     pointer to buffer for count transaction results,
+    ///                     as returned by read_register.
+    /// @returns i2c_pins::goodbit if all transactions succeeded, otherwise
+    ///          the bitwise or of the failed transactions' results.
+    /// @throws std::out_of_range if any address is not in the range [0,127].
+    /// @throws std::logic_error if there is already a transaction in progress.
+      int poll_register
+      ( std::uint32_t const * paddrs
+      , std::size_t count
+      , std::uint8_t reg
+      , std::uint8_t * pvalues
+      , int * pstates = nullptr
+      );
+
+    /// @brief Default clock stretch time out used while scanning, in SCL
+    /// cycles.
+      constexpr static std::uint16_t default_scan_tout = 0x08U;
+
+    /// @brief Find the slave devices on the bus.
+    ///
+    /// Probes each address in [first, last] with a minimal transaction - a
+    /// quick write of just the address or a single byte read - and records
+    /// those acknowledging their address. Each probe waits only for the
+    /// transaction to be done, which for an absent device is after its
+    /// address byte, and a short clock stretch time out stops a misbehaving
+    /// device from holding up the scan. The previous clock stretch time out
+    /// is restored afterwards.
+    ///
+    /// @param[in] first  First address to probe. Defaults to 0x08, the
+    ///                   first address not reserved by the I2C
+    ///                   specification.
+    /// @param[in] last   Last address to probe [first,127]. Defaults to 0x77,
+    ///                   the last address not reserved.
+    /// @param[in] probe  Probe transaction to use. Defaults to
+    ///                   i2c_probe::automatic.
+    /// @param[in] tout   Clock stretch time out in SCL cycles used while
+    ///                   scanning. Defaults to default_scan_tout.
+    /// @returns Addresses of the devices found, in ascending order.
+    /// @throws std::out_of_range if last is greater than 127 or less than
+    ///         first.
+    /// @throws std::logic_error if there is already a transaction in progress.
+      std::vector<std::uint32_t> scan
+      ( std::uint32_t first = 0x08U
+      , std::uint32_t last = 0x77U
+      , i2c_probe probe = i2c_probe::automatic
+      , std::uint16_t tout = default_scan_tout
+      );
+
+    /// @brief Set the clock stretch time out.
+    ///
+    /// Overrides the value passed on construction.
+    /// @param[in] tout Time out in SCL cycles, 0 disables the time out.
+      void set_clock_stretch_timeout(std::uint16_t tout);
+
+    /// @brief Returns the clock stretch time out in SCL cycles.
+      std::uint16_t clock_stretch_timeout() const;
+
+    /// @brief Returns the bus clock frequency and timing settings in use.
+    /// @param[in] fc APB core frequency. Defaults to
+    ///               \ref rpi_apb_core_frequency.
+      i2c_timing timing(hertz fc = rpi_apb_core_frequency) const;
+
+    /// @brief Change the bus clock frequency and timing settings.
+    ///
+    /// @param[in] t  New settings, with the ranges of the constructor
+    ///               parameters of the same names.
+    /// @param[in] fc APB core frequency. Defaults to
+    ///               \ref rpi_apb_core_frequency.
+    /// @throws std::out_of_range if the frequency, fedl or redl values are
+    ///         not in range.
+    /// @throws std::logic_error if there is a transaction in progress.
+      void set_timing(i2c_timing const & t, hertz fc = rpi_apb_core_frequency);
+
+    /// @brief Default number of reads each setting must pass when tuning.
+      constexpr static unsigned default_tune_trials = 16U;
+
+    /// @brief Find the highest bus frequency a slave reliably works at.
+    ///
+    /// A reference value of register reg of slave addrs is read using the
+    /// current settings. Clock divisors are then stepped from that for
+    /// max_f, in roughly 12% frequency steps, down towards the current
+    /// divisor. At each divisor the current read and write delays (limited
+    /// to half a clock period) then delays of a quarter and an eighth of a
+    /// clock period are tried. A setting passes if trials reads of the
+    /// register all succeed with no time out or no acknowledge error and
+    /// return the reference value.
+    ///
+    /// The register read should be one whose value does not change, such as
+    /// a device identity register.
+    ///
+    /// @post The peripheral uses the returned settings.
+    /// @param[in] addrs  Slave address [0,127].
+    /// @param[in] reg    Slave register number to read.
+    /// @param[in] max_f  Highest frequency to try. Defaults to
+    ///                   i2c_pins_max_tune_frequency.
+    /// @param[in] trials Reads each setting must pass. Defaults to
+    ///                   default_tune_trials.
+    /// @param[in] fc     APB core frequency. Defaults to
+    ///                   \ref rpi_apb_core_frequency.
+    /// @returns The fastest passing settings, or the current settings if no
+    ///          faster setting passed. The clock stretch time out is
+    ///          unchanged.
+    /// @throws std::out_of_range if addrs is not in the range [0,127] or
+    ///         max_f or trials are 0.
+    /// @throws std::logic_error if there is a transaction in progress.
+    /// @throws std::runtime_error if the reference read fails.
+      i2c_timing tune_timing
+      ( std::uint32_t addrs
+      , std::uint8_t reg
+      , hertz max_f = i2c_pins_max_tune_frequency
+      , unsigned trials = default_tune_trials
+      , hertz fc = rpi_apb_core_frequency
+      );
+
+    /// @brief Set the wait policy used while write_all, read_all,
+    /// write_then_read and read_register wait for written bytes to be sent
+    /// and for received data.
+    ///
+    /// Defaults to a default constructed wait_policy.
+    ///
+    /// Supports interrupt waits: if p has an interrupt, which should be the
+    /// I2C (BSC) interrupt, the BSC peripheral's interrupt on done, on TXW
+    /// and on RXR are enabled so long transfers block on the interrupt once
+    /// the policy's spin stage ends. They are disabled again when a policy
+    /// without an interrupt is set.
+    /// @param[in] p  Policy to use.
+      void set_wait_policy(wait_policy const & p);
+
+    /// @brief Returns the wait policy in use.
+      wait_policy const & get_wait_policy() const
+      {
+        return waiting;
+      }
+
+    /// @brief Returns counts of waits by the stage they finished in.
+      wait_stats const & wait_statistics() const
+      {
+        return wait_counts;
+      }
+
+    /// @brief Reset wait counts to zero.
+      void reset_wait_statistics()
+      {
+        wait_counts = wait_stats{};
+      }
+
+    /// @brief Returns a snapshot of the performance counters.
+    ///
+    /// Counts bytes written and read, FIFO stalls and wait polls of
+    /// write_all, read_all and write_then_read, and clock stretch and call
+    /// time outs and slave acknowledgement errors ending transactions. All
+    /// counts are zero unless counting is enabled - see io_counters.h.
+      io_counters counter_snapshot() const
+      {
+        return counters.snapshot();
+      }
+
+    /// @brief Reset the performance counters to zero.
+      void reset_counters()
+      {
+        counters.reset();
+      }
+
     /// @brief Read bytes received from the slave addressed in a currently
     /// active read operation from the FIFO into a buffer
     ///
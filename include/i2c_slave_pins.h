@@ -0,0 +1,114 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file i2c_slave_pins.h
+/// @brief Use a pair of GPIO pins with the BSC slave peripheral as an I2C
+///        slave: type definitions.
+///
+/// As well as the BSC masters the BCM2835 has one BSC slave peripheral,
+/// shared with the SPI slave function, allowing the Raspberry Pi to act as
+/// an I2C slave device to another bus master such as a microcontroller. It
+/// has 16 byte transmit and receive FIFOs so bytes can be handled in
+/// batches rather than one at a time. For more details see the
+/// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+/// Broadcom BCM2835 ARM Peripherals Datasheet</a> Chapter 11 SPI/BSC SLAVE.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_I2C_SLAVE_PINS_H
+# define DIBASE_RPI_PERIPHERALS_I2C_SLAVE_PINS_H
+
+# include "pin_id.h"
+# include <array>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Use a pair of GPIO pins with the BSC slave peripheral.
+  ///
+  /// If the pins support the BSC slave SDA and SCL functions and they and
+  /// the slave peripheral are not already in use locally within the same
+  /// process then the slave is set up to respond to the given address and
+  /// the pins allocated and set to their alt-fns. Note that no attempt is
+  /// made to see if the slave is in use externally by other processes.
+  ///
+  /// Bytes written by the bus master are read from the receive FIFO with
+  /// read(). Bytes for the master to read are written ahead of time to the
+  /// transmit FIFO with write(). Neither operation waits: each transfers as
+  /// many bytes as the FIFOs allow. See \ref i2c_slave_service for a thread
+  /// that services the FIFOs continuously.
+    class i2c_slave_pins
+    {
+      constexpr static unsigned number_of_pins = 2U;
+
+      std::array<pin_id_int_t, number_of_pins>  pins;
+      std::uint32_t                             address;
+
+    public:
+    /// @brief Error state enumeration
+      enum state
+      { goodbit = 0         ///< No slave errors
+      , overrunbit = 1      ///< Byte received while receive FIFO full
+      , underrunbit = 2     ///< Master read while transmit FIFO empty
+      };
+
+    /// @brief Construct from GPIO pin pair and slave address.
+    ///
+    /// @param[in] sda_pin  Pin to use for the BSC slave SDA function.
+    /// @param[in] scl_pin  Pin to use for the BSC slave SCL function.
+    /// @param[in] addrs    Slave address to respond to, [0,127].
+    ///
+    /// @throws std::invalid_argument if either pin does not support the
+    ///         required function.
+    /// @throws std::out_of_range if addrs is out of range.
+    /// @throws bad_peripheral_alloc if either of the pins or the slave
+    ///         peripheral is already in use.
+      i2c_slave_pins(pin_id sda_pin, pin_id scl_pin, std::uint32_t addrs);
+
+    /// @brief Destroy: disable the slave and de-allocate GPIO pins.
+      ~i2c_slave_pins();
+
+      i2c_slave_pins(i2c_slave_pins const &) = delete;
+      i2c_slave_pins& operator=(i2c_slave_pins const &) = delete;
+      i2c_slave_pins(i2c_slave_pins &&) = delete;
+      i2c_slave_pins& operator=(i2c_slave_pins &&) = delete;
+
+    /// @brief Returns the slave address responded to.
+      std::uint32_t slave_address() const
+      {
+        return address;
+      }
+
+    /// @brief Read bytes received from the bus master. Does not wait.
+    /// @param[out] prx   Buffer of at least max_count bytes.
+    /// @param[in] max_count Maximum number of bytes to read.
+    /// @returns Number of bytes read into prx.
+      std::size_t read(std::uint8_t * prx, std::size_t max_count);
+
+    /// @brief Write bytes for the bus master to read. Does not wait.
+    /// @param[in] ptx    Bytes to write.
+    /// @param[in] count  Number of bytes to write.
+    /// @returns Number of bytes written, less than count if the transmit FIFO
+    ///          filled.
+      std::size_t write(std::uint8_t const * ptx, std::size_t count);
+
+    /// @brief Returns number of received bytes waiting to be read.
+      std::size_t rx_fifo_level() const;
+
+    /// @brief Returns number of written bytes waiting for the master to read.
+      std::size_t tx_fifo_level() const;
+
+    /// @brief Return the overrun and underrun errors seen since the last
+    /// clear().
+    /// @returns goodbit or a combination of overrunbit and underrunbit.
+      int errors() const;
+
+    /// @brief Clear the overrun and underrun errors.
+      void clear();
+
+    /// @brief Discard bytes in both FIFOs.
+      void clear_fifos();
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_I2C_SLAVE_PINS_H
@@ -0,0 +1,108 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file i2c_slave_service.h
+/// @brief Thread servicing the BSC slave FIFOs : class definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_I2C_SLAVE_SERVICE_H
+# define DIBASE_RPI_PERIPHERALS_I2C_SLAVE_SERVICE_H
+
+# include "i2c_slave_pins.h"
+# include "spsc_ring.h"
+# include "wait_policy.h"
+# include <atomic>
+# include <exception>
+# include <thread>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Services an i2c_slave_pins object's FIFOs from a dedicated
+  /// thread.
+  ///
+  /// The service thread moves bytes received from the bus master into a
+  /// receive ring and keeps the transmit FIFO topped up from a transmit
+  /// ring, so bursts longer than the 16 byte FIFOs do not overrun or
+  /// underrun as long as the rings are serviced. If the receive ring is full
+  /// received bytes are discarded and counted as overruns. When the FIFOs are
+  /// idle the thread waits according to a wait_policy.
+  ///
+  /// One consumer thread may call read() and one producer thread may call
+  /// write(). The i2c_slave_pins object must outlive the i2c_slave_service
+  /// and must not be read or written by other code while the service exists.
+    class i2c_slave_service
+    {
+      i2c_slave_pins &            pins;
+      spsc_ring<std::uint8_t>     rx_ring;
+      spsc_ring<std::uint8_t>     tx_ring;
+      wait_policy const           waiting;
+      std::atomic<std::uint64_t>  overrun_count;
+      std::atomic<int>            error_state;
+      std::atomic<bool>           stopping;
+      std::atomic<bool>           service_failed;
+      std::exception_ptr          service_error;
+      std::thread                 service;
+
+      void run();
+
+    public:
+    /// @brief Construct and start the service thread.
+    /// @param[in] sp       Open i2c_slave_pins object.
+    /// @param[in] capacity Number of bytes each ring can hold. Must be a
+    ///                     power of two.
+    /// @param[in] policy   How the service thread waits when idle.
+    /// @throws std::invalid_argument if capacity is not a power of two.
+    /// @throws std::system_error if the service thread cannot be created.
+      i2c_slave_service
+      ( i2c_slave_pins & sp
+      , std::size_t capacity
+      , wait_policy const & policy = wait_policy{}
+      );
+
+    /// @brief Destroy, stopping and joining the service thread.
+      ~i2c_slave_service();
+
+      i2c_slave_service(i2c_slave_service const &) = delete;
+      i2c_slave_service& operator=(i2c_slave_service const &) = delete;
+      i2c_slave_service(i2c_slave_service &&) = delete;
+      i2c_slave_service& operator=(i2c_slave_service &&) = delete;
+
+    /// @brief Read bytes received from the bus master. Does not wait.
+    /// @param[out] prx     Buffer of at least max_count bytes.
+    /// @param[in] max_count Maximum number of bytes to read.
+    /// @returns Number of bytes read into prx.
+    /// @throws Exception thrown by the service thread, once all bytes it
+    ///         received before failing have been read.
+      std::size_t read(std::uint8_t * prx, std::size_t max_count);
+
+    /// @brief Queue bytes for the bus master to read. Does not wait.
+    /// @param[in] ptx    Bytes to queue.
+    /// @param[in] count  Number of bytes to queue.
+    /// @returns Number of bytes queued, less than count if the transmit ring
+    ///          filled.
+      std::size_t write(std::uint8_t const * ptx, std::size_t count);
+
+    /// @brief Returns number of received bytes discarded because the receive
+    /// ring was full.
+      std::uint64_t overruns() const
+      {
+        return overrun_count.load(std::memory_order_relaxed);
+      }
+
+    /// @brief Returns i2c_slave_pins::state errors seen by the service
+    /// thread.
+      int errors() const
+      {
+        return error_state.load(std::memory_order_relaxed);
+      }
+
+    /// @brief Returns each ring's capacity.
+      std::size_t capacity() const
+      {
+        return rx_ring.capacity();
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_I2C_SLAVE_SERVICE_H
@@ -0,0 +1,129 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file i2c_transaction_scheduler.h
+/// @brief I2C transactions run concurrently on each BSC master by per-bus
+/// worker threads : class definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_I2C_TRANSACTION_SCHEDULER_H
+# define DIBASE_RPI_PERIPHERALS_I2C_TRANSACTION_SCHEDULER_H
+
+# include "i2c_pins.h"
+# include <condition_variable>
+# include <deque>
+# include <future>
+# include <initializer_list>
+# include <memory>
+# include <mutex>
+# include <thread>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Outcome of an I2C transaction run by an i2c_transaction_scheduler.
+    struct i2c_transaction_result
+    {
+      int                       state;  ///< i2c_pins state bits, see
+                                        ///  i2c_pins::write_then_read
+      std::vector<std::uint8_t> rx;     ///< Bytes received
+    };
+
+  /// @brief I2C transactions from many threads run in order per bus, with
+  /// the buses run concurrently.
+  ///
+  /// A scheduler is constructed from one i2c_pins object per BSC master to
+  /// use. Each bus has a worker thread and queue of transactions so
+  /// transactions on different buses overlap while those on the same bus run
+  /// one at a time in submission order. Each transaction is a slave address,
+  /// bytes to write and a number of bytes to read:
+  ///
+  /// - bytes to write and none to read: a write transaction
+  /// - no bytes to write and some to read: a read transaction
+  /// - both: a write then read repeated start combined transaction, as for
+  ///   i2c_pins::write_then_read, with at most 16 bytes written.
+  ///
+  /// Completion is reported per transaction through a future. Error states
+  /// of a transaction are cleared before the next is run.
+  ///
+  /// The i2c_pins objects must outlive the scheduler and must not be used by
+  /// other code while the scheduler exists.
+    class i2c_transaction_scheduler
+    {
+    /// @brief Queued transaction.
+      struct job
+      {
+        std::uint32_t                         addrs;    ///< Slave address
+        std::vector<std::uint8_t>             tx;       ///< Bytes to write
+        std::size_t                           rx_count; ///< Bytes to read
+        std::promise<i2c_transaction_result>  result;   ///< Outcome
+      };
+
+    /// @brief Transaction queue and worker thread of one bus.
+      struct bus_worker
+      {
+        explicit bus_worker(i2c_pins & p)
+        : pins(p)
+        , stopping{false}
+        {}
+
+        i2c_pins &                pins;
+        std::mutex                guard;
+        std::condition_variable   job_available;
+        std::deque<job>           jobs;
+        bool                      stopping;
+        std::thread               worker;
+      };
+
+      std::vector<std::unique_ptr<bus_worker>>  workers;
+
+      void stop_workers();
+      static void run_jobs(bus_worker & w);
+      static i2c_transaction_result run_job(i2c_pins & pins, job & j);
+
+    public:
+    /// @brief Construct and start a worker thread for each bus.
+    /// @param[in] buses  i2c_pins objects to use, each for a different BSC
+    ///                   master.
+    /// @throws std::invalid_argument if buses is empty, has a nullptr or has
+    ///         more than one object for a BSC master.
+    /// @throws std::system_error if a worker thread cannot be created.
+      explicit i2c_transaction_scheduler
+      (std::initializer_list<i2c_pins *> buses);
+
+    /// @brief Destroy: run any queued transactions then stop and join the
+    /// worker threads.
+      ~i2c_transaction_scheduler();
+
+      i2c_transaction_scheduler(i2c_transaction_scheduler const &) = delete;
+      i2c_transaction_scheduler& operator=
+                                  (i2c_transaction_scheduler const &) = delete;
+      i2c_transaction_scheduler(i2c_transaction_scheduler &&) = delete;
+      i2c_transaction_scheduler& operator=
+                                  (i2c_transaction_scheduler &&) = delete;
+
+    /// @brief Queue a transaction. May be called from any thread.
+    /// @param[in] bus      BSC master to use: the i2c_pins::bus() value of
+    ///                     one of the objects the scheduler was constructed
+    ///                     from.
+    /// @param[in] addrs    Slave address [0,127].
+    /// @param[in] tx       Bytes to write. May be empty for a read.
+    /// @param[in] rx_count Number of bytes to read [0,65535]. May be zero for
+    ///                     a write.
+    /// @returns Future for the transaction's outcome.
+    /// @throws std::invalid_argument if bus is not one of the scheduler's,
+    ///         tx is empty and rx_count is zero, or more than 16 bytes are
+    ///         written in a combined transaction.
+    /// @throws std::out_of_range if addrs, the size of tx or rx_count are out
+    ///         of range.
+      std::future<i2c_transaction_result> submit
+      ( unsigned bus
+      , std::uint32_t addrs
+      , std::vector<std::uint8_t> tx
+      , std::size_t rx_count
+      );
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_I2C_TRANSACTION_SCHEDULER_H
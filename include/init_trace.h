@@ -0,0 +1,106 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file init_trace.h
+/// @brief Timings of the library's slow initialisation and allocation
+/// operations : type and function definitions.
+///
+/// Starting a program that uses the library can spend noticeable time
+/// opening and mapping /dev/mem, reading /proc/cpuinfo and the device tree,
+/// exporting and unexporting pins in the sys filesystem and in the GPIO pull
+/// up/down sequence's waits. Each call of these operations is timed and
+/// recorded so the time spent in each can be reported, for example at the
+/// end of a service's start up, and the slow parts targeted.
+///
+/// Timing is always on: each timed call already makes at least one system
+/// call, so two clock reads and an uncontended lock add little. The first
+/// init_trace_capacity calls are recorded individually; later calls are
+/// only added to the per-phase totals.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INIT_TRACE_H
+# define DIBASE_RPI_PERIPHERALS_INIT_TRACE_H
+
+# include <chrono>
+# include <cstddef>
+# include <cstdint>
+# include <iosfwd>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Timed initialisation and allocation operations.
+    enum class init_phase : unsigned
+    { dev_mem_open      ///< Open of /dev/mem or another memory device
+    , phymem_map        ///< mmap of a memory device area
+    , cpuinfo_read      ///< Read of the board revision from /proc/cpuinfo
+    , device_tree_read  ///< Read of the device tree soc/ranges property
+    , sysfs_export      ///< Check and export of pins in the sys filesystem
+    , sysfs_unexport    ///< Check and unexport of pins in the sys filesystem
+    , pull_sequence     ///< GPPUD / GPPUDCLK pull up/down sequence and waits
+    , number_of_phases
+    };
+
+  /// @brief Number of calls recorded individually.
+    constexpr std::size_t init_trace_capacity{256U};
+
+  /// @brief Returns a phase's name as used in reports.
+    char const * init_phase_name(init_phase phase);
+
+  /// @brief One timed call.
+    struct init_trace_record
+    {
+      init_phase                            phase;
+      std::chrono::steady_clock::time_point start;    ///< When call started
+      std::chrono::nanoseconds              duration; ///< How long it took
+    };
+
+  /// @brief Totals of all timed calls of a phase.
+    struct init_phase_totals
+    {
+      std::uint64_t             calls;  ///< Number of calls
+      std::chrono::nanoseconds  total;  ///< Total time of all calls
+      std::chrono::nanoseconds  max;    ///< Longest call
+    };
+
+  /// @brief Returns the individually recorded calls in the order they
+  /// ended.
+    std::vector<init_trace_record> init_trace_records();
+
+  /// @brief Returns the totals of all calls of a phase since the start of
+  /// the process or the last init_trace_reset.
+    init_phase_totals init_trace_totals(init_phase phase);
+
+  /// @brief Write a report of per-phase totals followed by each recorded
+  /// call, with start times relative to the first recorded call.
+  /// @param[in] os Stream to write the report to.
+    void init_trace_report(std::ostream & os);
+
+  /// @brief Discard recorded calls and zero the totals.
+    void init_trace_reset();
+
+    namespace internal
+    {
+    /// @brief Time a scope as a call of an init_phase.
+      class init_trace_scope
+      {
+        init_phase                            phase;
+        std::chrono::steady_clock::time_point start;
+
+      public:
+        explicit init_trace_scope(init_phase p)
+        : phase{p}
+        , start{std::chrono::steady_clock::now()}
+        {}
+
+      /// @brief Record the call.
+        ~init_trace_scope();
+
+        init_trace_scope(init_trace_scope const &) = delete;
+        init_trace_scope & operator=(init_trace_scope const &) = delete;
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INIT_TRACE_H
@@ -0,0 +1,115 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file initialise.h
+/// @brief Eager initialisation of the library's peripheral access :
+/// type and function definitions.
+///
+/// The library initialises lazily: the first use of a peripheral reads
+/// /proc/cpuinfo and the device tree, opens /dev/mem and maps the
+/// peripheral registers, and builds the pin alternate function tables. That
+/// first use can take milliseconds, too long for the first cycle of a real
+/// time control loop. Calling initialise before entering time critical
+/// code does all of this up front so later peripheral use does not.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INITIALISE_H
+# define DIBASE_RPI_PERIPHERALS_INITIALISE_H
+
+# include <initializer_list>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Peripherals that may be initialised by initialise.
+    enum class peripheral : unsigned
+    { gpio          ///< GPIO, sys filesystem export files, alt fn tables
+    , clock         ///< Clock manager
+    , pwm           ///< PWM
+    , spi0          ///< SPI0 and, on a BCM2711, SPI3 to SPI6
+    , i2c           ///< BSC masters: BSC0, BSC1 and those the SoC has
+    , aux           ///< Auxiliary mini UART and SPI1, SPI2
+    , uart0         ///< PL011 UART0
+    , pcm           ///< PCM / I2S
+    , smi           ///< Secondary memory interface
+    , dma           ///< DMA controller
+    , system_timer  ///< System timer
+    , bsc_slave     ///< BSC / SPI slave
+    , number_of_peripherals
+    };
+
+  /// @brief A set of peripherals.
+    class peripheral_set
+    {
+      unsigned bits;
+
+      constexpr static unsigned bit(peripheral p)
+      {
+        return 1U<<static_cast<unsigned>(p);
+      }
+
+    public:
+    /// @brief Construct an empty set.
+      constexpr peripheral_set() : bits{0U} {}
+
+    /// @brief Construct a set of the peripherals listed.
+      peripheral_set(std::initializer_list<peripheral> ps)
+      : bits{0U}
+      {
+        for (peripheral p : ps)
+          {
+            bits |= bit(p);
+          }
+      }
+
+    /// @brief Returns a set of all peripherals.
+      static peripheral_set all()
+      {
+        peripheral_set s;
+        s.bits = bit(peripheral::number_of_peripherals)-1U;
+        return s;
+      }
+
+    /// @brief Returns true if p is in the set.
+      bool contains(peripheral p) const
+      {
+        return (bits&bit(p))!=0U;
+      }
+
+    /// @brief Returns true if the set is empty.
+      bool empty() const
+      {
+        return bits==0U;
+      }
+    };
+
+  /// @brief Initialise access to a set of peripherals now rather than on
+  /// first use.
+  ///
+  /// Reads the board revision and peripheral address range, maps the
+  /// peripheral registers and constructs the internal control objects of
+  /// each peripheral in set. If gpio is in set the pin alternate function
+  /// tables are built and the sys filesystem export and unexport files
+  /// opened; if only gpio is in set and /dev/mem cannot be mapped the GPIO
+  /// registers are mapped from /dev/gpiomem, as on first use.
+  ///
+  /// The kernel fills in all page table entries of a /dev/mem or
+  /// /dev/gpiomem mapping when it is mapped, so mapped register pages never
+  /// page fault. Locking them is only useful if the process otherwise locks
+  /// its memory, or for simulated peripherals whose memory is ordinary
+  /// pageable memory. To keep code, data and stacks resident too use
+  /// rt_config's lock_memory option.
+  ///
+  /// May be called more than once, for example with further peripherals.
+  /// @param[in] set        Peripherals to initialise. Defaults to all.
+  /// @param[in] lock_pages If true lock each initialised peripheral's
+  ///                       register pages into memory with mlock.
+  /// @throws std::system_error if registers cannot be mapped or, if
+  ///         lock_pages is true, locked.
+    void initialise
+    ( peripheral_set const & set = peripheral_set::all()
+    , bool lock_pages = false
+    );
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INITIALISE_H
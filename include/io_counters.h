@@ -0,0 +1,188 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file io_counters.h
+/// @brief Optional peripheral performance counters : type definitions.
+///
+/// spi0_pins, i2c_pins, pwm_pin and pin_edge_event keep counts of the data
+/// they move and the stalls, waits and errors they meet, to help tell why a
+/// link is slow: whether FIFOs are running dry or full, time is going in
+/// busy-waits, or transfers are timing out.
+///
+/// Counting is enabled by defining DIBASE_RPI_PERIPHERALS_COUNTERS when
+/// building the library and the code using it, for example by passing
+/// COMPILE_OPTS=-DDIBASE_RPI_PERIPHERALS_COUNTERS to make. It must be defined
+/// the same way for both as it changes the layout of the counting classes.
+/// When not defined the counters hold no data and counting compiles to
+/// nothing, and all counts read as zero.
+///
+/// Each object's counters are updated only by the thread using the object,
+/// without atomic read-modify-write operations, so counting is cheap. Any
+/// thread may take a snapshot of them at any time.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_IO_COUNTERS_H
+# define DIBASE_RPI_PERIPHERALS_IO_COUNTERS_H
+
+# include <atomic>
+# include <cstddef>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief True if DIBASE_RPI_PERIPHERALS_COUNTERS is defined.
+# ifdef DIBASE_RPI_PERIPHERALS_COUNTERS
+    constexpr bool io_counters_enabled{true};
+# else
+    constexpr bool io_counters_enabled{false};
+# endif
+
+  /// @brief Events counted by peripheral performance counters.
+    enum class io_event : unsigned
+    { bytes_written   ///< Bytes written to a peripheral
+    , bytes_read      ///< Bytes read from a peripheral
+    , tx_fifo_full    ///< Writes stalled by a full transmit FIFO
+    , rx_fifo_empty   ///< Reads stalled by an empty receive FIFO
+    , wait_polls      ///< Busy-wait polls that found no progress
+    , timeouts        ///< Timed out transfers or waits
+    , nacks           ///< Transfers not acknowledged by a slave
+    , wakeups         ///< Waits that ended with an event
+    , updates         ///< Output setting updates, such as PWM ratios
+    , number_of_events
+    };
+
+  /// @brief Snapshot of peripheral performance counters.
+  ///
+  /// Counts are those since construction or the last reset. Events that do
+  /// not apply to a peripheral are always zero.
+    struct io_counters
+    {
+      io_counters()
+      : bytes_written{0U}
+      , bytes_read{0U}
+      , tx_fifo_full{0U}
+      , rx_fifo_empty{0U}
+      , wait_polls{0U}
+      , timeouts{0U}
+      , nacks{0U}
+      , wakeups{0U}
+      , updates{0U}
+      {}
+
+      std::uint64_t bytes_written;  ///< Bytes written to the peripheral
+      std::uint64_t bytes_read;     ///< Bytes read from the peripheral
+      std::uint64_t tx_fifo_full;   ///< Writes stalled by a full TX FIFO
+      std::uint64_t rx_fifo_empty;  ///< Reads stalled by an empty RX FIFO
+      std::uint64_t wait_polls;     ///< Busy-wait polls with no progress
+      std::uint64_t timeouts;       ///< Timed out transfers or waits
+      std::uint64_t nacks;          ///< Transfers not acknowledged
+      std::uint64_t wakeups;        ///< Waits ended by an event
+      std::uint64_t updates;        ///< Output setting updates
+    };
+
+  /// @brief Live performance counters of one peripheral object.
+  /// @tparam Enabled true to count, false to hold nothing and count nothing.
+    template <bool Enabled>
+    class basic_io_counter_set;
+
+  /// @brief Counting performance counters.
+    template <>
+    class basic_io_counter_set<true>
+    {
+      constexpr static std::size_t size
+                      {static_cast<std::size_t>(io_event::number_of_events)};
+
+      std::atomic<std::uint64_t> counts[size];
+
+      std::uint64_t get(io_event e) const
+      {
+        return counts[static_cast<std::size_t>(e)]
+                                          .load(std::memory_order_relaxed);
+      }
+
+    public:
+    /// @brief Construct with all counts zero.
+      basic_io_counter_set()
+      {
+        reset();
+      }
+
+    /// @brief Copy construct, copying counts. For moving counting objects.
+      basic_io_counter_set(basic_io_counter_set const & other)
+      {
+        *this = other;
+      }
+
+    /// @brief Copy assign, copying counts. For moving counting objects.
+      basic_io_counter_set & operator=(basic_io_counter_set const & other)
+      {
+        for (std::size_t idx=0U; idx!=size; ++idx)
+          {
+            counts[idx].store( other.counts[idx].load(std::memory_order_relaxed)
+                             , std::memory_order_relaxed
+                             );
+          }
+        return *this;
+      }
+
+    /// @brief Add to the count of an event. Only the owning thread may count.
+    /// @param[in] e  Event to count.
+    /// @param[in] n  Number of events, defaults to 1.
+      void count(io_event e, std::uint64_t n=1U)
+      {
+        std::atomic<std::uint64_t> & c(counts[static_cast<std::size_t>(e)]);
+        c.store(c.load(std::memory_order_relaxed)+n, std::memory_order_relaxed);
+      }
+
+    /// @brief Returns a snapshot of all counts.
+      io_counters snapshot() const
+      {
+        io_counters s;
+        s.bytes_written = get(io_event::bytes_written);
+        s.bytes_read = get(io_event::bytes_read);
+        s.tx_fifo_full = get(io_event::tx_fifo_full);
+        s.rx_fifo_empty = get(io_event::rx_fifo_empty);
+        s.wait_polls = get(io_event::wait_polls);
+        s.timeouts = get(io_event::timeouts);
+        s.nacks = get(io_event::nacks);
+        s.wakeups = get(io_event::wakeups);
+        s.updates = get(io_event::updates);
+        return s;
+      }
+
+    /// @brief Reset all counts to zero.
+      void reset()
+      {
+        for (auto & c : counts)
+          {
+            c.store(0U, std::memory_order_relaxed);
+          }
+      }
+    };
+
+  /// @brief Disabled performance counters: hold and count nothing.
+    template <>
+    class basic_io_counter_set<false>
+    {
+    public:
+    /// @brief Does nothing.
+      void count(io_event, std::uint64_t=1U)
+      {}
+
+    /// @brief Returns all zero counts.
+      io_counters snapshot() const
+      {
+        return io_counters{};
+      }
+
+    /// @brief Does nothing.
+      void reset()
+      {}
+    };
+
+  /// @brief Performance counters type used by peripheral objects.
+    typedef basic_io_counter_set<io_counters_enabled>  io_counter_set;
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_IO_COUNTERS_H
@@ -0,0 +1,156 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file io_service.h
+/// @brief Peripheral objects owned by one service thread that runs commands
+/// from other threads : class definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_IO_SERVICE_H
+# define DIBASE_RPI_PERIPHERALS_IO_SERVICE_H
+
+# include "mpsc_ring.h"
+# include "wait_policy.h"
+# include <atomic>
+# include <cstdint>
+# include <functional>
+# include <future>
+# include <memory>
+# include <thread>
+# include <type_traits>
+# include <utility>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Run all use of a set of peripheral objects on one service thread.
+  ///
+  /// Peripheral objects such as spi0_pins, i2c_pins and opin are moved into
+  /// the service by adopt, which returns a reference to the service's object.
+  /// Other threads then use them only through commands: callables passed to
+  /// submit, which returns a future for the callable's result, or to post,
+  /// for callables that report their own results, for example by invoking a
+  /// callback. Commands are passed through a lock-free multiple producer ring
+  /// and run one at a time in the order they were queued, on the service
+  /// thread, which may be restricted to one (ideally isolated) CPU. Hardware
+  /// polling by the peripheral objects is so concentrated on that CPU and
+  /// the submitting threads do not contend on locks for the buses.
+  ///
+  /// While there are no commands the service thread waits following a
+  /// wait_policy: passing one that never sleeps gives the lowest command
+  /// latency at the cost of the service thread's CPU.
+  ///
+  /// On destruction queued commands are run then the adopted objects are
+  /// destroyed on the service thread, most recently adopted first.
+    class io_service
+    {
+    /// @brief Type erased owner of an adopted object.
+      struct holder_base
+      {
+        virtual ~holder_base() {}
+      };
+
+      template <typename P>
+      struct holder : holder_base
+      {
+        explicit holder(P && p) : object(std::move(p)) {}
+        P object;
+      };
+
+      typedef std::function<void()> command;
+
+      mpsc_ring<command>                          commands;
+      wait_policy                                 idling;
+      std::atomic<bool>                           stopping;
+      std::atomic<std::uint64_t>                  failures;
+      std::vector<std::shared_ptr<holder_base>>   owned;
+      std::thread                                 worker;
+
+      void run_commands();
+      void enqueue(command c);
+      void hand_over(std::shared_ptr<holder_base> h);
+
+    public:
+    /// @brief Value for cpu parameter meaning do not set service thread's CPU
+    /// affinity.
+      static int const any_cpu = -1;
+
+    /// @brief Construct and start the service thread.
+    /// @param[in] capacity Maximum number of queued commands. Must be a power
+    ///                     of two. Defaults to 256.
+    /// @param[in] cpu      CPU the service thread is restricted to run on or
+    ///                     any_cpu, the default.
+    /// @param[in] idle     How the service thread waits for commands.
+    /// @throws std::invalid_argument if capacity is not a power of two.
+    /// @throws std::system_error if the service thread cannot be created or
+    ///         its CPU affinity set.
+      explicit io_service
+      ( std::size_t capacity = 256U
+      , int cpu = any_cpu
+      , wait_policy idle = wait_policy{}
+      );
+
+    /// @brief Destroy: run queued commands, destroy adopted objects then stop
+    /// and join the service thread. No commands may be queued concurrently.
+      ~io_service();
+
+      io_service(io_service const &) = delete;
+      io_service& operator=(io_service const &) = delete;
+      io_service(io_service &&) = delete;
+      io_service& operator=(io_service &&) = delete;
+
+    /// @brief Move a peripheral object into the service.
+    ///
+    /// @tparam P     Move constructible type of object.
+    /// @param[in] p  Object to move into the service.
+    /// @returns Reference to the service's object. Only to be used by
+    ///          commands queued after the call returns; valid for the
+    ///          lifetime of the service.
+      template <typename P>
+      P & adopt(P p)
+      {
+        std::shared_ptr<holder<P>> h{std::make_shared<holder<P>>(std::move(p))};
+        P & object(h->object);
+        hand_over(std::move(h));
+        return object;
+      }
+
+    /// @brief Queue a command and return a future for its result.
+    ///
+    /// May be called from any thread. Blocks, yielding, while the command
+    /// queue is full.
+    /// @tparam F     Callable type taking no arguments.
+    /// @param[in] f  Command to run on the service thread.
+    /// @returns Future for the result of f, or the exception it throws.
+      template <typename F>
+      std::future<typename std::result_of<F()>::type> submit(F f)
+      {
+        typedef typename std::result_of<F()>::type result_type;
+        std::shared_ptr<std::packaged_task<result_type()>> task
+                    {std::make_shared<std::packaged_task<result_type()>>(f)};
+        std::future<result_type> result{task->get_future()};
+        enqueue([task]{ (*task)(); });
+        return result;
+      }
+
+    /// @brief Queue a command with no result.
+    ///
+    /// May be called from any thread. Blocks, yielding, while the command
+    /// queue is full. Exceptions thrown by the command are counted by
+    /// failed_commands and otherwise ignored.
+    /// @param[in] f  Command to run on the service thread.
+      void post(std::function<void()> f)
+      {
+        enqueue(std::move(f));
+      }
+
+    /// @brief Returns the number of posted commands that threw exceptions.
+      std::uint64_t failed_commands() const
+      {
+        return failures.load(std::memory_order_relaxed);
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_IO_SERVICE_H
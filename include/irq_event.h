@@ -0,0 +1,76 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file irq_event.h
+/// @brief Block waiting for a peripheral interrupt delivered through a
+/// Linux UIO device : class definition
+///
+/// Polling a peripheral's status while a long transfer runs occupies a CPU
+/// for the whole transfer. If the peripheral's interrupt is handed to user
+/// space by a Linux userspace I/O (UIO) driver - for example uio_pdrv_genirq
+/// bound to the peripheral's device tree node in place of its kernel driver -
+/// an irq_event lets a thread sleep in poll until the interrupt fires.
+///
+/// UIO generic IRQ drivers disable the interrupt each time it fires; it is
+/// re-enabled by writing a 32-bit 1 to the device and each interrupt is
+/// acknowledged by reading a 32-bit interrupt count. irq_event::wait does
+/// both, so a level interrupt whose condition is already true when the wait
+/// starts fires at once and no wake up is lost.
+///
+/// An irq_event is normally used through a wait_policy: see
+/// wait_policy::interrupt.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_IRQ_EVENT_H
+# define DIBASE_RPI_PERIPHERALS_IRQ_EVENT_H
+
+# include <chrono>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Interrupt notification file descriptor with UIO semantics.
+    class irq_event
+    {
+      int           irq_fd;     ///< UIO device (or similar) file descriptor
+      std::uint64_t irq_count;  ///< Interrupts seen by wait so far
+
+    public:
+    /// @brief Open a UIO device.
+    /// @param[in] path Path of UIO device, e.g. "/dev/uio0".
+    /// @throws std::system_error if the device cannot be opened.
+      explicit irq_event(char const * path);
+
+    /// @brief Take ownership of an open file descriptor with UIO semantics,
+    /// such as one from a kernel module or a test double.
+    /// @param[in] fd Open file descriptor. Closed on destruction.
+    /// @throws std::invalid_argument if fd is negative.
+      explicit irq_event(int fd);
+
+    /// @brief Destroy, closing the file descriptor.
+      ~irq_event();
+
+      irq_event(irq_event const &) = delete;
+      irq_event& operator=(irq_event const &) = delete;
+      irq_event(irq_event &&) = delete;
+      irq_event& operator=(irq_event &&) = delete;
+
+    /// @brief Enable the interrupt then wait for it to fire.
+    /// @param[in] timeout  Longest time to wait. Waits are in whole
+    ///                     milliseconds, rounded up.
+    /// @returns true if the interrupt fired, false if the call timed out or
+    ///          was interrupted by a signal.
+    /// @throws std::system_error if enabling, waiting for or acknowledging
+    ///         the interrupt fails.
+      bool wait(std::chrono::nanoseconds timeout);
+
+    /// @brief Returns the number of waits that ended with an interrupt.
+      std::uint64_t interrupts() const
+      {
+        return irq_count;
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_IRQ_EVENT_H
@@ -0,0 +1,130 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file latency_histogram.h
+/// @brief Fixed size log-linear histogram of latencies : class definition.
+///
+/// A latency_histogram records nanosecond durations in buckets in the style
+/// of an HDR histogram: values below 64ns each have their own bucket and
+/// each power of two range above that is split into 32 equal buckets, so
+/// any recorded value is known to within about 3% across the whole range
+/// from nanoseconds to minutes in a fixed 9KB or so of counts. Recording a
+/// value is a few arithmetic operations and an increment, with no
+/// allocation or system calls, so it is cheap enough to do on each wake up
+/// of a thread waiting for I/O.
+///
+/// A pin_line_event can record the latency of each edge event it reads,
+/// from the kernel's time stamp of the edge to the wait returning, into a
+/// latency_histogram - see pin_line_event::record_latencies.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_LATENCY_HISTOGRAM_H
+# define DIBASE_RPI_PERIPHERALS_LATENCY_HISTOGRAM_H
+
+# include <chrono>
+# include <cstddef>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Log-linear histogram of latencies in nanoseconds.
+  ///
+  /// Values greater than max_trackable are counted in the highest bucket,
+  /// although the maximum recorded value is kept exactly. Negative values,
+  /// such as from time stamps of differing clocks, are recorded as zero.
+  ///
+  /// Not thread safe: a histogram should be recorded to and read by one
+  /// thread at a time.
+    class latency_histogram
+    {
+    public:
+    /// @brief Log2 of number of buckets each power of two range is split into
+      constexpr static unsigned sub_bucket_bits = 5U;
+
+    /// @brief Log2 of one more than max_trackable
+      constexpr static unsigned max_magnitude = 40U;
+
+    /// @brief Largest value counted in its true bucket, about 18 minutes
+      constexpr static std::uint64_t max_trackable
+                                      = (std::uint64_t{1}<<max_magnitude)-1U;
+
+    /// @brief Number of buckets
+      constexpr static std::size_t number_of_buckets
+                  = (max_magnitude-sub_bucket_bits+1U)<<sub_bucket_bits;
+
+    /// @brief Construct with no values recorded.
+      latency_histogram();
+
+    /// @brief Record a latency.
+    /// @param[in] latency  Latency to record.
+      void record(std::chrono::nanoseconds latency);
+
+    /// @brief Returns the number of latencies recorded.
+      std::uint64_t count() const
+      {
+        return total;
+      }
+
+    /// @brief Returns the smallest latency recorded, 0 if none recorded.
+      std::chrono::nanoseconds min() const;
+
+    /// @brief Returns the largest latency recorded, 0 if none recorded.
+      std::chrono::nanoseconds max() const
+      {
+        return std::chrono::nanoseconds(max_value);
+      }
+
+    /// @brief Returns the mean of the latencies recorded, 0 if none recorded.
+      std::chrono::nanoseconds mean() const;
+
+    /// @brief Returns a latency that a given percentage of those recorded
+    /// are less than or equal to.
+    ///
+    /// The value returned is the largest value of the bucket holding the
+    /// percentile - or the maximum recorded value if less - so is at most
+    /// about 3% greater than the true percentile.
+    /// @param[in] percent  Percentile, 0 to 100. Values outside that range
+    ///                     are taken to be the nearest of 0 and 100.
+    /// @returns Latency at the percentile, 0 if none recorded.
+      std::chrono::nanoseconds percentile(double percent) const;
+
+    /// @brief Returns the count of one bucket.
+    /// @param[in] idx  Bucket index, less than number_of_buckets.
+      std::uint64_t bucket_count(std::size_t idx) const
+      {
+        return counts[idx];
+      }
+
+    /// @brief Returns the index of the bucket a value is recorded in.
+    /// @param[in] value  Latency value in nanoseconds.
+      static std::size_t bucket_index(std::uint64_t value);
+
+    /// @brief Returns the smallest value recorded in a bucket.
+    /// @param[in] idx  Bucket index, less than number_of_buckets.
+      static std::uint64_t bucket_lowest(std::size_t idx);
+
+    /// @brief Returns the largest value recorded in a bucket.
+    ///
+    /// For the highest bucket this is max_trackable, although larger values
+    /// are counted in it.
+    /// @param[in] idx  Bucket index, less than number_of_buckets.
+      static std::uint64_t bucket_highest(std::size_t idx);
+
+    /// @brief Add the values recorded in another histogram to this one.
+    /// @param[in] other  Histogram to add.
+      void add(latency_histogram const & other);
+
+    /// @brief Forget all recorded values.
+      void reset();
+
+    private:
+      std::uint64_t counts[number_of_buckets];
+      std::uint64_t total;
+      std::uint64_t min_value;
+      std::uint64_t max_value;
+      std::uint64_t sum;
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_LATENCY_HISTOGRAM_H
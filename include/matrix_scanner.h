@@ -0,0 +1,256 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file matrix_scanner.h
+/// @brief Periodic scanning of a key or switch matrix on one thread : class
+/// definitions.
+///
+/// Scanning an 8x8 key matrix by driving each row with an opin and reading
+/// each column with an ipin costs 8 puts and 64 gets per scan plus a settle
+/// sleep per row. A matrix_scanner drives the rows as an opin_group and
+/// reads the columns as an ipin_group: moving to the next row is one
+/// opin_group::put and reading a row is one ipin_group::get. The row is
+/// changed at the end of each tick and read at the start of the next so the
+/// tick itself is the settle time and the polling thread never sleeps mid
+/// scan. Each complete scan is ghost suppressed and debounced, and key
+/// presses and releases are reported through a lock-free ring in the same
+/// way as \ref debouncer.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_MATRIX_SCANNER_H
+# define DIBASE_RPI_PERIPHERALS_MATRIX_SCANNER_H
+
+# include "debouncer.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Record of one debounced key press or release.
+    struct key_event
+    {
+    /// @brief Row of the key: position of its row pin in the row group.
+      unsigned                  row{0U};
+
+    /// @brief Column of the key: position of its column pin in the column
+    /// group.
+      unsigned                  column{0U};
+
+    /// @brief True if the key was pressed, false if it was released.
+      bool                      pressed{false};
+
+    /// @brief CLOCK_MONOTONIC time of the scan that decided the change.
+      std::chrono::nanoseconds  timestamp{0};
+    };
+
+  /// @brief Ghost suppressing debounce filter for a key matrix of up to 64
+  /// keys.
+  ///
+  /// Key (r, c) of a matrix with C columns is bit r*C+c of a matrix value.
+  ///
+  /// Without a diode per key, pressing three keys at the corners of a
+  /// rectangle in the matrix connects the fourth corner's row and column so
+  /// it reads as pressed too: a ghost. Which of the four keys is the ghost
+  /// cannot be told, so while all four corners of any rectangle read as
+  /// pressed, all four keep their previous debounced state. Scans are
+  /// otherwise debounced by a debounce_filter.
+    class key_matrix_filter
+    {
+      unsigned          row_count;
+      unsigned          column_count;
+      debounce_filter   filter;
+      std::uint64_t     ghosted_count;
+
+    public:
+    /// @brief Construct for a matrix with no keys pressed.
+    /// @param[in] rows     Number of rows.
+    /// @param[in] columns  Number of columns.
+    /// @param[in] updates  Threshold number of scans a key must
+    ///                     predominantly be in a new state for before the
+    ///                     change is reported, [1,
+    ///                     debounce_filter::max_threshold].
+    /// @throws std::invalid_argument if rows or columns is zero, rows times
+    ///         columns exceeds 64 or updates is out of range.
+      key_matrix_filter(unsigned rows, unsigned columns, unsigned updates);
+
+    /// @brief Returns the keys of a matrix value that are corners of a
+    /// rectangle of pressed keys.
+    /// @param[in] keys Matrix value: bit r*columns()+c set if key (r, c)
+    ///                 reads as pressed.
+      pin_group_value_t ghosts(pin_group_value_t keys) const;
+
+    /// @brief Filter a new scan of all keys.
+    /// @param[in] keys Matrix value: bit r*columns()+c set if key (r, c)
+    ///                 read as pressed.
+    /// @returns Mask of keys whose debounced state changed.
+      pin_group_value_t update(pin_group_value_t keys);
+
+    /// @brief Returns debounced key states: bit r*columns()+c set if key
+    /// (r, c) is pressed.
+      pin_group_value_t state() const
+      {
+        return filter.state();
+      }
+
+    /// @brief Returns number of scans in which some keys' states were held
+    /// because they formed a rectangle.
+      std::uint64_t ghosted_scans() const
+      {
+        return ghosted_count;
+      }
+
+    /// @brief Returns number of rows.
+      unsigned rows() const
+      {
+        return row_count;
+      }
+
+    /// @brief Returns number of columns.
+      unsigned columns() const
+      {
+        return column_count;
+      }
+    };
+
+  /// @brief Scan a key matrix on a periodic thread.
+  ///
+  /// A polling thread, paced by an \ref rt_period, drives one row active per
+  /// tick and reads the column pins, so a complete scan takes one tick per
+  /// row. Each complete scan is passed through a key_matrix_filter. Each
+  /// debounced change of a key is pushed into a fixed capacity lock-free
+  /// single producer single consumer ring as a key_event. One consumer
+  /// thread pops events in batches. If the ring is full an event is
+  /// discarded and counted as an overrun.
+  ///
+  /// Rows not being scanned are driven to their inactive level. Pressing
+  /// two keys in one column connects two driven rows, so the rows or
+  /// columns should have series resistors or diodes.
+    class matrix_scanner
+    {
+      opin_group &                  row_pins;
+      ipin_group &                  column_pins;
+      bool                          low_active;
+      std::chrono::nanoseconds      tick_period;
+      key_matrix_filter             filter;
+      spsc_ring<key_event>          ring;
+      std::atomic<pin_group_value_t> pressed;
+      std::atomic<std::uint64_t>    overrun_count;
+      std::atomic<std::uint64_t>    missed_count;
+      std::atomic<std::uint64_t>    ghosted_count;
+      std::atomic<bool>             stopping;
+      std::atomic<bool>             poller_failed;
+      std::exception_ptr            poller_error;
+      rt_thread                     poller;
+
+      void drive_row(unsigned previous, unsigned row);
+      void scan_keys();
+
+    public:
+    /// @brief Start scanning with no keys pressed.
+    /// @param[in] rows     Row pins, pin n drives row n. Must outlive the
+    ///                     scanner and must not be written by other threads
+    ///                     while it exists.
+    /// @param[in] columns  Column pins, pin n reads column n, normally
+    ///                     pulled to the inactive level. Must outlive the
+    ///                     scanner and must not be read by other threads
+    ///                     while it exists.
+    /// @param[in] row_tick Time each row is driven before the columns are
+    ///                     read. Must be greater than zero. A scan takes
+    ///                     row_tick times the number of rows.
+    /// @param[in] stable_scans Scans a key must predominantly be in a new
+    ///                     state for before it is reported,
+    ///                     [1, debounce_filter::max_threshold].
+    /// @param[in] capacity Number of events the ring can hold. Must be a
+    ///                     power of two.
+    /// @param[in] active_low True if rows are driven low when scanned and
+    ///                     columns read low for a pressed key, as with
+    ///                     pulled up columns.
+    /// @param[in] config   Real-time configuration of the polling thread.
+    /// @throws std::invalid_argument if row_tick is not greater than zero,
+    ///         the matrix has more than 64 keys, stable_scans is out of
+    ///         range or capacity is not a power of two.
+    /// @throws As for rt_thread construction if the polling thread cannot be
+    ///         created or config cannot be applied to it.
+      matrix_scanner
+      ( opin_group & rows
+      , ipin_group & columns
+      , std::chrono::microseconds row_tick
+      , unsigned stable_scans
+      , std::size_t capacity
+      , bool active_low = true
+      , rt_config const & config = rt_config{}
+      );
+
+    /// @brief Destroy, stopping and joining the polling thread and driving
+    /// all rows inactive.
+      ~matrix_scanner();
+
+      matrix_scanner(matrix_scanner const &) = delete;
+      matrix_scanner& operator=(matrix_scanner const &) = delete;
+      matrix_scanner(matrix_scanner &&) = delete;
+      matrix_scanner& operator=(matrix_scanner &&) = delete;
+
+    /// @brief Pop available key events. Does not wait. Must only be called
+    /// by one thread at a time.
+    /// @param[out] events  Array of at least max_events records to fill.
+    /// @param[in] max_events  Maximum number of records to pop.
+    /// @returns Number of records popped into events.
+    /// @throws Exception thrown by the polling thread, once all events it
+    ///         pushed before failing have been popped.
+      std::size_t pop(key_event * events, std::size_t max_events);
+
+    /// @brief Returns the latest debounced key states: bit r*columns()+c set
+    /// if key (r, c) is pressed.
+      pin_group_value_t state() const
+      {
+        return pressed.load(std::memory_order_acquire);
+      }
+
+    /// @brief Returns true if a key is pressed, as of the latest scan.
+    /// @param[in] row    Row of key. Not range checked.
+    /// @param[in] column Column of key. Not range checked.
+      bool is_pressed(unsigned row, unsigned column) const
+      {
+        return (state()>>(row*filter.columns()+column))&1U;
+      }
+
+    /// @brief Returns number of rows.
+      unsigned rows() const
+      {
+        return filter.rows();
+      }
+
+    /// @brief Returns number of columns.
+      unsigned columns() const
+      {
+        return filter.columns();
+      }
+
+    /// @brief Returns number of events discarded because the ring was full.
+      std::uint64_t overruns() const
+      {
+        return overrun_count.load(std::memory_order_relaxed);
+      }
+
+    /// @brief Returns number of ticks whose deadline had passed before the
+    /// polling thread waited for it.
+      std::uint64_t missed_ticks() const
+      {
+        return missed_count.load(std::memory_order_relaxed);
+      }
+
+    /// @brief Returns number of scans in which ghost suppression held some
+    /// keys' states.
+      std::uint64_t ghosted_scans() const
+      {
+        return ghosted_count.load(std::memory_order_relaxed);
+      }
+
+    /// @brief Returns the ring capacity.
+      std::size_t capacity() const
+      {
+        return ring.capacity();
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_MATRIX_SCANNER_H
@@ -0,0 +1,144 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file mpsc_ring.h
+/// @brief Fixed capacity lock-free multiple producer, single consumer ring
+/// buffer : class template definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_MPSC_RING_H
+# define DIBASE_RPI_PERIPHERALS_MPSC_RING_H
+
+# include <atomic>
+# include <memory>
+# include <cstddef>
+# include <stdexcept>
+# include <utility>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Fixed capacity lock-free multiple producer, single consumer ring.
+  ///
+  /// Any number of threads may push while one other thread pops, without
+  /// locking. Each element slot has a sequence number saying whether it is
+  /// free for the push of a given lap of the ring or holds an element for
+  /// the pop of that lap. Producers claim a slot by advancing the shared tail
+  /// index with a compare and exchange, fill it and then publish it by
+  /// storing its sequence number with release ordering. The consumer reads
+  /// the sequence number with acquire ordering before taking the element
+  /// and then frees the slot for the next lap.
+  ///
+  /// @tparam T Element type. Must be default constructible and move
+  ///           assignable.
+    template <typename T>
+    class mpsc_ring
+    {
+      static std::size_t const cache_line_size = 64U;
+
+    /// @brief Element storage with the sequence number of its next use.
+      struct slot
+      {
+        std::atomic<std::size_t>  sequence;
+        T                         element;
+      };
+
+      std::size_t const         mask;     ///< Capacity - 1 (capacity is 2^N)
+      std::unique_ptr<slot[]>   slots;    ///< Ring element storage
+      alignas(cache_line_size) std::atomic<std::size_t> head; ///< Next pop
+      alignas(cache_line_size) std::atomic<std::size_t> tail; ///< Next push
+
+      static std::size_t check_capacity(std::size_t capacity)
+      {
+        if (capacity==0U || (capacity&(capacity-1U))!=0U)
+          {
+            throw std::invalid_argument{"mpsc_ring: capacity must be a "
+                                        "non-zero power of two."};
+          }
+        return capacity;
+      }
+
+    public:
+    /// @brief Construct an empty ring.
+    /// @param[in] capacity Maximum number of elements held. Must be a power
+    ///                     of two.
+    /// @throws std::invalid_argument if capacity is zero or not a power of
+    ///         two.
+      explicit mpsc_ring(std::size_t capacity)
+      : mask{check_capacity(capacity)-1U}
+      , slots{new slot[capacity]}
+      , head{0U}
+      , tail{0U}
+      {
+        for (std::size_t idx=0; idx!=capacity; ++idx)
+          {
+            slots[idx].sequence.store(idx, std::memory_order_relaxed);
+          }
+      }
+
+      mpsc_ring(mpsc_ring const &) = delete;
+      mpsc_ring& operator=(mpsc_ring const &) = delete;
+
+    /// @brief Returns the maximum number of elements the ring can hold.
+      std::size_t capacity() const
+      {
+        return mask+1U;
+      }
+
+    /// @brief Push an element. May be called by any number of threads.
+    /// @param[in] v  Value to push. Moved from only if pushed.
+    /// @returns true if v was pushed, false if the ring was full.
+      bool try_push(T && v)
+      {
+        std::size_t t{tail.load(std::memory_order_relaxed)};
+        for (;;)
+          {
+            slot & s(slots[t&mask]);
+            std::ptrdiff_t const lag
+                    { static_cast<std::ptrdiff_t>
+                      (s.sequence.load(std::memory_order_acquire)-t)
+                    };
+            if (lag==0)
+              {
+                if (tail.compare_exchange_weak( t, t+1U
+                                              , std::memory_order_relaxed
+                                              ))
+                  {
+                    s.element = std::move(v);
+                    s.sequence.store(t+1U, std::memory_order_release);
+                    return true;
+                  }
+              }
+            else if (lag<0)
+              { // Slot still holds the element pushed on the previous lap
+                return false;
+              }
+            else
+              {
+                t = tail.load(std::memory_order_relaxed);
+              }
+          }
+      }
+
+    /// @brief Pop an element. Must only be called by the consumer thread.
+    /// @param[out] out Assigned the popped element.
+    /// @returns true if an element was popped, false if the ring was empty
+    ///          or the next element's push had not completed.
+      bool try_pop(T & out)
+      {
+        std::size_t const h{head.load(std::memory_order_relaxed)};
+        slot & s(slots[h&mask]);
+        if (s.sequence.load(std::memory_order_acquire)!=h+1U)
+          {
+            return false;
+          }
+        out = std::move(s.element);
+        s.element = T{};
+        s.sequence.store(h+mask+1U, std::memory_order_release);
+        head.store(h+1U, std::memory_order_relaxed);
+        return true;
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_MPSC_RING_H
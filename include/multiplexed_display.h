@@ -0,0 +1,149 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file multiplexed_display.h
+/// @brief DMA refreshed multiplexed LED display : class definition
+///
+/// Multiplexed LED displays - multi-digit 7-segment displays and LED
+/// matrices for example - share one set of segment (or column) lines between
+/// all digits (or rows) and light one digit at a time, selected by its own
+/// line, switching between digits fast enough that all appear lit. Done by
+/// a thread setting pins and sleeping, refreshing flickers whenever the
+/// thread is not scheduled on time. A multiplexed_display instead has a DMA
+/// channel run a cyclic chain of control blocks that write precomputed
+/// GPSET and GPCLR masks for each digit in turn, timed by the PWM
+/// controller's DMA request signal as for \ref soft_pwm_engine, so once
+/// started refreshing continues without using the CPU, free from scheduling
+/// jitter.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_MULTIPLEXED_DISPLAY_H
+# define DIBASE_RPI_PERIPHERALS_MULTIPLEXED_DISPLAY_H
+
+# include "pin_group.h"
+# include <memory>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      class dma_arena;
+    }
+
+  /// @brief Multiplexed LED display refreshed by DMA.
+  ///
+  /// The segment pins are an \ref opin_group whose nth pin drives segment n
+  /// of every digit. The digit select pins are another opin_group whose nth
+  /// pin selects digit n. Each digit is shown for a fixed number of
+  /// microseconds in turn. Between digits all digits are deselected before
+  /// the segment pins change, so segments of one digit do not ghost onto the
+  /// next.
+  ///
+  /// The displayed patterns are double buffered: show writes new segment
+  /// masks to the frame not being played then switches the DMA to it at the
+  /// end of the current refresh cycle by updating one control block's next
+  /// address. The DMA is never stopped and there is no lock to contend for,
+  /// but show may wait up to one refresh cycle for the DMA to leave the
+  /// frame it is to write if called twice within a cycle. show must be
+  /// called by one thread at a time.
+  ///
+  /// Running a display requires the PWM controller, whose clock is set to
+  /// time the digits, and a DMA channel, so while a display exists no PWM
+  /// pins, waveform or other user of the PWM FIFO may be used.
+    class multiplexed_display
+    {
+      opin_group const &                    segments;   ///< Segment pins
+      opin_group const &                    selects;    ///< Digit select pins
+      bool                                  segments_low;///< Segment on if low
+      bool                                  selects_low;///< Selected if low
+      std::vector<pin_group_value_t>        patterns;   ///< Shown patterns
+      std::uint32_t                         digit_time; ///< Microseconds
+      std::unique_ptr<internal::dma_arena>  code;       ///< Program memory
+      std::uint32_t                         frame_bus[2];///< Frame CB bus addrs
+      std::uint32_t volatile *              loop_next[2];///< Frame loop links
+      std::uint32_t volatile *              frame_masks[2];///< Segment masks
+      std::size_t                           frame;      ///< Frame shown
+      std::size_t                           dma_channel;///< Running channel
+
+      bool is_playing_frame(std::size_t f) const;
+      void write_frame
+      ( std::size_t f
+      , std::vector<pin_group_value_t> const & digit_segments
+      );
+      void blank() const;
+
+    public:
+    /// @brief Compile the refresh program, with all segments off, and
+    /// reserve the resources to run it.
+    /// @param[in] segment_pins   Segment pins, pin n drives segment n. Must
+    ///                           outlive the display.
+    /// @param[in] digit_pins     Digit select pins, pin n selects digit n.
+    ///                           Must outlive the display.
+    /// @param[in] digit_us       Microseconds each digit is shown per refresh.
+    /// @param[in] segments_active_low  True if segments are lit by a low
+    ///                           level on their pins.
+    /// @param[in] digits_active_low    True if digits are selected by a low
+    ///                           level on their pins.
+    /// @throws std::invalid_argument if digit_us is zero or exceeds 268
+    ///         seconds or the groups have pins in common.
+    /// @throws peripheral_in_use if any PWM channel is in use.
+    /// @throws bad_peripheral_alloc if the PWM FIFO or a DMA channel are not
+    ///         available.
+    /// @throws std::system_error or std::bad_alloc if DMA memory cannot be
+    ///         obtained.
+      multiplexed_display
+      ( opin_group const & segment_pins
+      , opin_group const & digit_pins
+      , std::uint32_t digit_us
+      , bool segments_active_low = false
+      , bool digits_active_low = false
+      );
+
+    /// @brief Stop, deselect all digits and release resources.
+      ~multiplexed_display();
+
+      multiplexed_display(multiplexed_display const &) = delete;
+      multiplexed_display & operator=(multiplexed_display const &) = delete;
+
+    /// @brief Returns number of digits.
+      std::size_t digits() const
+      {
+        return patterns.size();
+      }
+
+    /// @brief Returns microseconds per refresh cycle of all digits.
+      std::uint32_t refresh_us() const
+      {
+        return digit_time*static_cast<std::uint32_t>(patterns.size());
+      }
+
+    /// @brief Start refreshing from the first digit.
+      void start();
+
+    /// @brief Stop refreshing and deselect all digits.
+      void stop();
+
+    /// @brief Returns true if refreshing.
+      bool is_running() const;
+
+    /// @brief Set the segments shown on each digit.
+    ///
+    /// The new patterns are shown from the start of the next refresh cycle.
+    /// @param[in] digit_segments Segment pattern of each digit: bit n set if
+    ///                           segment n of the digit is lit.
+    /// @throws std::invalid_argument if the number of patterns is not
+    ///         digits() or a pattern has bits set for segments not in the
+    ///         segment pin group.
+      void show(std::vector<pin_group_value_t> const & digit_segments);
+
+    /// @brief Returns the segment patterns last shown.
+      std::vector<pin_group_value_t> const & shown() const
+      {
+        return patterns;
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_MULTIPLEXED_DISPLAY_H
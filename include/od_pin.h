@@ -0,0 +1,151 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file od_pin.h
+/// @brief Use GPIO pins as open drain outputs by switching their direction :
+/// class definitions.
+///
+/// The BCM2835 GPIO pins have no open drain output mode. It is emulated by
+/// setting a pin's output level low once and then switching the pin between
+/// output, driving the line low, and input, releasing it to be pulled high
+/// by the internal or an external pull-up. The open-collector example does
+/// this with separate opin and ipin objects; od_pin and od_pin_group do it
+/// with one write to the pin's GPFSELn function select word per change,
+/// using the register word, field mask and output value worked out when the
+/// pin is opened. An od_pin_group changes all its lines sharing a GPFSELn
+/// word, pins 0..9, 10..19 and so on, in one write.
+///
+/// Writes go through the GPIO configuration, so the GPFSELn word is read
+/// back from the shadow rather than the register if shadowing is enabled.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_OD_PIN_H
+# define DIBASE_RPI_PERIPHERALS_OD_PIN_H
+
+# include "pin.h"
+# include "pin_group.h"
+# include <cstddef>
+# include <cstdint>
+# include <initializer_list>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      class gpio_config;
+    }
+
+  /// @brief Use a single GPIO pin as an open drain output.
+  ///
+  /// The line level is read as for ipin::get. od_pin objects may be moved,
+  /// so can be held by value in containers.
+    class od_pin : public ipin
+    {
+      internal::gpio_config * config;
+      std::size_t             fsel_idx;   ///< Pin's GPFSELn index
+      std::uint32_t           fsel_mask;  ///< Pin's GPFSELn field
+      std::uint32_t           fsel_output;///< Field value for output
+
+      void set_output(bool output);
+
+    public:
+    /// @brief Open a GPIO pin as a released open drain line.
+    /// @param[in] p        Id of GPIO pin to open.
+    /// @param[in] pull_up  If true, the default, enable the pin's internal
+    ///                     pull-up resistor.
+    /// @exception  bad_pin_alloc if the GPIO pin is in use by this process
+    ///             or elsewhere.
+      explicit od_pin(pin_id p, bool pull_up=true);
+
+    /// @brief Release the line, leaving the pin an input, and close it.
+      ~od_pin();
+
+      od_pin(od_pin const &) = delete;
+      od_pin& operator=(od_pin const &) = delete;
+
+    /// @brief Move construct, taking over other's open pin.
+      od_pin(od_pin &&) = default;
+
+    /// @brief Drive the line low.
+      void drive_low()
+      {
+        set_output(true);
+      }
+
+    /// @brief Stop driving the line, letting it be pulled high.
+      void release()
+      {
+        set_output(false);
+      }
+
+    /// @brief Drive the line low or release it.
+    /// @param[in] v  false to drive the line low, true to release it.
+      void put(bool v)
+      {
+        set_output(!v);
+      }
+    };
+
+  /// @brief Use a group of GPIO pins as open drain outputs.
+  ///
+  /// Line levels are read as for ipin_group::get.
+    class od_pin_group : public ipin_group
+    {
+      internal::gpio_config * config;
+      std::uint32_t           output_bits[pin_id::number_of_pins];
+
+      void set_outputs(pin_group_value_t mask, pin_group_value_t outputs);
+
+    public:
+    /// @brief Open GPIO pins as released open drain lines.
+    /// @param[in] pins     Ids of GPIO pins to open. Each may only appear once.
+    /// @param[in] pull_up  If true, the default, enable the pins' internal
+    ///                     pull-up resistors.
+    /// @throws bad_peripheral_alloc if any GPIO pin is in use by this process
+    ///         or elsewhere, in which case no pins are left allocated.
+    /// @throws std::invalid_argument if the list of pins is empty.
+      explicit od_pin_group
+      ( std::initializer_list<pin_id> pins
+      , bool pull_up=true
+      );
+
+    /// @brief Release all lines, leaving the pins inputs, and close them.
+      ~od_pin_group();
+
+    /// @brief Drive some of the group's lines low and release others.
+    ///
+    /// Makes one GPFSELn write per function select word with selected pins.
+    /// @param[in] mask   Bit n set to change the nth pin of the group.
+    /// @param[in] values Bit n clear to drive the nth line low, set to
+    ///                   release it. Only bits set in mask are used.
+      void put(pin_group_value_t mask, pin_group_value_t values)
+      {
+        set_outputs(mask, ~values);
+      }
+
+    /// @brief Drive or release all the group's lines.
+    /// @param[in] values Bit n clear to drive the nth line low, set to
+    ///                   release it.
+      void put(pin_group_value_t values)
+      {
+        set_outputs(all_pins(), ~values);
+      }
+
+    /// @brief Drive lines low.
+    /// @param[in] mask   Bit n set to drive the nth line low.
+      void drive_low(pin_group_value_t mask)
+      {
+        set_outputs(mask, mask);
+      }
+
+    /// @brief Release lines to be pulled high.
+    /// @param[in] mask   Bit n set to release the nth line.
+      void release(pin_group_value_t mask)
+      {
+        set_outputs(mask, 0U);
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_OD_PIN_H
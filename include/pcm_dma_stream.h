@@ -0,0 +1,131 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pcm_dma_stream.h
+/// @brief Double-buffered DMA streaming for the PCM / I2S interface : class
+/// definition.
+///
+/// At audio rates a 64 word PCM FIFO holds little more than half a
+/// millisecond of stereo samples, much less than a scheduler time slice. A
+/// pcm_dma_stream object has DMA channels, paced by the PCM transmit and
+/// receive DREQs, move samples between the FIFOs and pairs of buffers in
+/// DMA coherent memory. While the DMA channel transfers one buffer of a pair
+/// the other is filled or emptied by the user, in place with no copying.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_PCM_DMA_STREAM_H
+# define DIBASE_RPI_PERIPHERALS_PCM_DMA_STREAM_H
+
+# include "pcm_pins.h"
+# include <memory>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      class dma_arena;
+    }
+
+  /// @brief Stream PCM samples by DMA through double buffers.
+  ///
+  /// For each direction the pcm_pins object supports, two DMA control blocks,
+  /// linked to each other, each transfer one buffer of samples so the DMA
+  /// channel alternates between the buffers forever. The buffer the channel
+  /// is working on is found from the channel's current control block address.
+  ///
+  /// The transmit buffer returned by try_tx_buffer() or wait_tx_buffer() must
+  /// be filled before the channel finishes the other buffer - within one
+  /// buffer's worth of frames - or old samples are sent again. Likewise
+  /// a receive buffer must be read before it is filled again.
+  ///
+  /// Transfers are started on construction and stopped on destruction. Both
+  /// transmit buffers initially hold zero samples.
+    class pcm_dma_stream
+    {
+      struct direction
+      {
+        std::uint32_t volatile *  buffer[2];  ///< Sample buffer pair
+        std::uint32_t             cb_bus[2];  ///< Control block bus addresses
+        std::size_t               channel;    ///< DMA channel number
+        unsigned                  next;       ///< Next buffer to hand out
+        bool                      used;       ///< Direction in use
+      };
+
+      pcm_pins &                            pcm;    ///< PCM pins in use
+      std::unique_ptr<internal::dma_arena>  memory; ///< Buffer and CB memory
+      std::size_t                           samples;///< Samples per buffer
+      direction                             tx;     ///< Transmit DMA state
+      direction                             rx;     ///< Receive DMA state
+      wait_policy                           waiting;///< Buffer wait policy
+      wait_stats                            wait_counts;///< Wait stage counts
+
+      static unsigned active_buffer(direction const & d);
+      static std::uint32_t volatile * try_buffer(direction & d);
+
+    public:
+    /// @brief Allocate DMA memory and channels and start streaming.
+    ///
+    /// @param[in] pins             PCM pins object to stream through. Must
+    ///                             outlive this object. Should be stopped
+    ///                             with empty FIFOs.
+    /// @param[in] frames_per_buffer Frames of samples in each buffer.
+    /// @throws std::invalid_argument if frames_per_buffer is zero.
+    /// @throws bad_peripheral_alloc if DMA channels are not available.
+    /// @throws std::system_error or std::bad_alloc if DMA memory cannot be
+    ///         obtained.
+      pcm_dma_stream(pcm_pins & pins, std::size_t frames_per_buffer);
+
+    /// @brief Stop the PCM interface and release the DMA channels.
+      ~pcm_dma_stream();
+
+      pcm_dma_stream(pcm_dma_stream const &) = delete;
+      pcm_dma_stream& operator=(pcm_dma_stream const &) = delete;
+
+    /// @brief Returns the number of samples in each buffer: frames per buffer
+    /// times the frame format's channels.
+      std::size_t buffer_samples() const
+      {
+        return samples;
+      }
+
+    /// @brief Return the next transmit buffer to fill if the DMA channel has
+    /// finished with it.
+    /// @returns Pointer to buffer_samples() samples, or \c nullptr if the
+    ///          buffer is still being transmitted or the pcm_pins object
+    ///          cannot transmit.
+      std::uint32_t volatile * try_tx_buffer();
+
+    /// @brief Wait for and return the next transmit buffer to fill.
+    /// @throws std::logic_error if the pcm_pins object cannot transmit.
+      std::uint32_t volatile * wait_tx_buffer();
+
+    /// @brief Return the next filled receive buffer if the DMA channel has
+    /// finished with it.
+    /// @returns Pointer to buffer_samples() samples, or \c nullptr if the
+    ///          buffer is still being received or the pcm_pins object
+    ///          cannot receive.
+      std::uint32_t volatile const * try_rx_buffer();
+
+    /// @brief Wait for and return the next filled receive buffer.
+    /// @throws std::logic_error if the pcm_pins object cannot receive.
+      std::uint32_t volatile const * wait_rx_buffer();
+
+    /// @brief Set the wait policy used while waiting for buffers.
+    ///
+    /// Defaults to a default constructed wait_policy.
+    /// @param[in] p  Policy to use.
+      void set_wait_policy(wait_policy const & p)
+      {
+        waiting = p;
+      }
+
+    /// @brief Returns counts of waits by the stage they finished in.
+      wait_stats const & wait_statistics() const
+      {
+        return wait_counts;
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_PCM_DMA_STREAM_H
@@ -0,0 +1,391 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pcm_pins.h
+/// @brief Use a set of GPIO pins for use with the PCM / I2S audio interface:
+/// type definitions.
+///
+/// The BCM2835 PCM / I2S interface is a synchronous serial interface with
+/// separate 64 word transmit and receive FIFOs. Each frame carries up to two
+/// channels in each direction at bit positions and widths, up to 32 bits,
+/// set by a frame format, so I2S stereo audio, TDM-like multi-channel PCM
+/// and general high rate synchronous serial capture can all be handled. The
+/// bit clock and frame sync may each be generated (master) or taken from an
+/// external device (slave).
+///
+/// Up to 4 GPIO pins are required: PCM_CLK and PCM_FS, plus PCM_DIN to
+/// receive and PCM_DOUT to transmit.
+///
+/// For more details see the
+/// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+/// Broadcom BCM2835 ARM Peripherals Datasheet</a> Chapter 8 PCM / I2S Audio.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_PCM_PINS_H
+# define DIBASE_RPI_PERIPHERALS_PCM_PINS_H
+# include "pin_id.h"
+# include "clockdefs.h"
+# include "wait_policy.h"
+# include "io_counters.h"
+# include <array>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief GPIO pin id used to indicate unused or not required pin
+  ///
+  /// Note that GPIO pin 53 has no useful alternative special functions
+    constexpr pin_id_int_t pcm_pin_not_used{53U};
+
+  /// @brief Simple constexpr type template to hold PCM pin sets
+  /// @tparam CLK   PCM_CLK (bit clock) GPIO pin number
+  /// @tparam FS    PCM_FS (frame sync) GPIO pin number
+  /// @tparam DIN   PCM_DIN (data in) GPIO pin number. Optional, defaults to
+  ///               pcm_pin_not_used indicating transmit only.
+  /// @tparam DOUT  PCM_DOUT (data out) GPIO pin number. Optional, defaults to
+  ///               pcm_pin_not_used indicating receive only.
+    template  < pin_id_int_t CLK
+              , pin_id_int_t FS
+              , pin_id_int_t DIN=pcm_pin_not_used
+              , pin_id_int_t DOUT=pcm_pin_not_used
+              >
+    struct pcm_pin_set
+    {
+    /// @returns Specialisation type's CLK parameter value
+      constexpr pin_id_int_t clk() { return CLK; }
+
+    /// @returns Specialisation type's FS parameter value
+      constexpr pin_id_int_t fs() { return FS; }
+
+    /// @returns Specialisation type's DIN parameter value
+      constexpr pin_id_int_t din() { return DIN; }
+
+    /// @returns Specialisation type's DOUT parameter value
+      constexpr pin_id_int_t dout() { return DOUT; }
+    };
+
+  /// @brief Full 4-pin PCM pin set provided by Raspberry Pi revision 2 P5
+  /// connector (GPIO28-31, alt function 2).
+    constexpr pcm_pin_set<28U, 29U, 30U, 31U>  rpi_p5_pcm_pin_set;
+
+  /// @brief Full 4-pin PCM pin set on GPIO18-21 (alt function 0). Only
+  /// GPIO18 is on the Raspberry Pi P1 connector for all board revisions.
+    constexpr pcm_pin_set<18U, 19U, 20U, 21U>  gpio18_pcm_pin_set;
+
+  /// @brief Enumeration of PCM clock and frame sync roles
+    enum class pcm_role
+    { master  ///< Signal generated by the PCM interface
+    , slave   ///< Signal input from an external device
+    };
+
+  /// @brief Position and width of one channel within a PCM frame
+    struct pcm_channel
+    {
+      unsigned width;     ///< Sample bits [8,32], 0 if channel not used
+      unsigned position;  ///< Bit clocks from frame start to first bit
+    };
+
+  /// @brief PCM frame format: frame and frame sync length, channel positions
+  /// and signal polarities.
+  ///
+  /// The same channel layout is used for transmit and receive. Each FIFO
+  /// word holds one channel's sample in its least significant bits, channel
+  /// 1 then channel 2 for each frame.
+  ///
+  /// Holds the PCM MODE_A and TXC_A / RXC_A register values for the format.
+  /// As all of these are value types pcm_frame_format objects can be copied
+  /// and assigned.
+    class pcm_frame_format
+    {
+    friend class pcm_pins;
+    friend class pcm_dma_stream;
+
+      std::uint32_t mode_reg;
+      std::uint32_t channel_reg;
+      unsigned      frame_bits;
+      unsigned      channel_count;
+
+    public:
+    /// @brief Construct from frame format parameters
+    ///
+    /// @param[in] frame_length   Bit clocks per frame [1,1024].
+    /// @param[in] fs_length      Bit clocks frame sync is asserted for at the
+    ///                           start of each frame [1,1023].
+    /// @param[in] ch1            Channel 1 position and width. Must be used.
+    /// @param[in] ch2            Channel 2 position and width. Defaults to
+    ///                           not used.
+    /// @param[in] clock_invert   If \c true data is output on the bit clock
+    ///                           falling edge and sampled on the rising edge,
+    ///                           if \c false the reverse. Defaults to \c false.
+    /// @param[in] fs_invert      If \c true frame sync is active low.
+    ///                           Defaults to \c false.
+    ///
+    /// @throws std::invalid_argument if a length, width or position is out of
+    ///         range or a channel does not fit in the frame.
+      pcm_frame_format
+      ( unsigned frame_length
+      , unsigned fs_length
+      , pcm_channel ch1
+      , pcm_channel ch2 = pcm_channel{0U, 0U}
+      , bool clock_invert = false
+      , bool fs_invert = false
+      );
+
+    /// @brief Returns an I2S stereo frame format.
+    ///
+    /// Frames are 2*slot_bits bit clocks long with the left channel
+    /// (channel 1) while frame sync (word select) is low and data starting
+    /// one bit clock after each frame sync change.
+    ///
+    /// @param[in] sample_bits  Bits per sample [8,32].
+    /// @param[in] slot_bits    Bit clocks per channel slot [sample_bits+1,
+    ///                         512]. Defaults to 32.
+    /// @throws std::invalid_argument if a parameter is out of range.
+      static pcm_frame_format i2s
+      ( unsigned sample_bits
+      , unsigned slot_bits = 32U
+      );
+
+    /// @brief Returns the number of bit clocks per frame
+      unsigned frame_length() const
+      {
+        return frame_bits;
+      }
+
+    /// @brief Returns the number of channels used, 1 or 2, which is the
+    /// number of FIFO words per frame.
+      unsigned channels() const
+      {
+        return channel_count;
+      }
+    };
+
+  /// @brief Counts of PCM FIFO errors
+    struct pcm_fifo_errors
+    {
+      pcm_fifo_errors()
+      : underruns{0U}
+      , overruns{0U}
+      {}
+
+      std::uint64_t underruns;  ///< Frames transmitted from an empty FIFO
+      std::uint64_t overruns;   ///< Frames received into a full FIFO
+    };
+
+  /// @brief Use a set of 2 to 4 GPIO pins with the PCM / I2S peripheral.
+  ///
+  /// The lines of the PCM interface may be output to a set of GPIO pins as
+  /// special functions PCM_CLK, PCM_FS, PCM_DIN and PCM_DOUT when set to the
+  /// appropriate alternate pin functions. Refer to the
+  /// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+  /// BCM2835 ARM Peripherals data sheet</a>, table 6-31 to see which pin/alt
+  /// function combinations support the required special functions.
+  ///
+  /// If all the pins in the pin set support the requisite PCM function and
+  /// the PCM peripheral, and the PCM clock if the bit clock is generated, are
+  /// not already in use locally within the same process then the PCM
+  /// peripheral is set-up with the requested frame format and the pins
+  /// allocated and set to the relevant alt-fns. Note that no attempt is made
+  /// to see if the PCM peripheral is in use externally by other processes -
+  /// such as a Linux ALSA I2S driver, which should not be loaded.
+  ///
+  /// Transfers are stopped on construction: write the first samples to the
+  /// transmit FIFO then call start().
+    class pcm_pins
+    {
+      constexpr static unsigned number_of_pins = 4U;
+
+      std::array<pin_id_int_t, number_of_pins>  pins;
+      pcm_frame_format                          format;
+      bool                                      clock_master;
+      pcm_fifo_errors                           errors;
+      wait_policy                               waiting;
+      wait_stats                                wait_counts;
+      io_counter_set                            counters;
+
+      void construct
+      ( pin_id clk
+      , pin_id fs
+      , pin_id din
+      , pin_id dout
+      , hertz bit_clock
+      , pcm_role clock_role
+      , pcm_role fs_role
+      );
+
+      void check_errors();
+
+    public:
+    /// @brief Construct a pcm_pins object from a pcm_pin_set specialisation,
+    /// frame format and clock settings.
+    ///
+    /// @post The PCM peripheral is marked as in use.
+    /// @post The pins in the pcm_pin_set are marked as in use (note: does
+    ///       not include DIN or DOUT pins with a value of
+    ///       \ref pcm_pin_not_used).
+    /// @post If clock_role is pcm_role::master the PCM clock is marked as in
+    ///       use and running at bit_clock.
+    /// @post The PCM interface is enabled with empty FIFOs and transfers
+    ///       stopped (is_running() == \c false).
+    ///
+    /// @tparam CLK   pcm_pin_set CLK template parameter.
+    /// @tparam FS    pcm_pin_set FS template parameter.
+    /// @tparam DIN   pcm_pin_set DIN template parameter.
+    /// @tparam DOUT  pcm_pin_set DOUT template parameter.
+    ///
+    /// @param[in] ps         pcm_pin_set specialisation specifying the set of
+    ///                       GPIO pins to use for the various PCM functions.
+    /// @param[in] ff         Frame format.
+    /// @param[in] bit_clock  Bit clock frequency: the frame rate times the
+    ///                       frame length. Only used if clock_role is
+    ///                       pcm_role::master.
+    /// @param[in] clock_role Whether the bit clock is generated or input.
+    ///                       Defaults to pcm_role::master.
+    /// @param[in] fs_role    Whether the frame sync is generated or input.
+    ///                       Defaults to pcm_role::master.
+    ///
+    /// @throws std::invalid_argument if any requested pin does not support the
+    ///         required special function or neither DIN nor DOUT are used.
+    /// @throws std::range_error if any pin supports the same PCM function
+    ///         by more than one alternative function (should not be possible).
+    /// @throws bad_peripheral_alloc if any of the pins, the PCM peripheral
+    ///         or the PCM clock are already in use.
+      template  < pin_id_int_t CLK
+                , pin_id_int_t FS
+                , pin_id_int_t DIN
+                , pin_id_int_t DOUT
+                >
+      pcm_pins
+      ( pcm_pin_set<CLK,FS,DIN,DOUT> ps
+      , pcm_frame_format const & ff
+      , hertz bit_clock
+      , pcm_role clock_role = pcm_role::master
+      , pcm_role fs_role = pcm_role::master
+      )
+      : format(ff)
+      {
+        construct ( pin_id(ps.clk()), pin_id(ps.fs())
+                  , pin_id(ps.din()), pin_id(ps.dout())
+                  , bit_clock, clock_role, fs_role
+                  );
+      }
+
+    /// @brief Destroy: stop transfers, disable the PCM interface and clock
+    /// and de-allocate GPIO pins.
+      ~pcm_pins();
+
+      pcm_pins(pcm_pins const &) = delete;
+      pcm_pins& operator=(pcm_pins const &) = delete;
+
+    /// @brief Returns the frame format in use.
+      pcm_frame_format const & frame_format() const
+      {
+        return format;
+      }
+
+    /// @brief Query whether samples can be transmitted (DOUT pin used)
+      bool can_transmit() const;
+
+    /// @brief Query whether samples can be received (DIN pin used)
+      bool can_receive() const;
+
+    /// @brief Start transmitting and/or receiving frames.
+      void start();
+
+    /// @brief Stop transmitting and receiving frames. Samples remaining in
+    /// the FIFOs are kept.
+      void stop();
+
+    /// @brief Query whether frames are being transferred.
+      bool is_running() const;
+
+    /// @brief Empty both FIFOs.
+    ///
+    /// Waits two PCM clock periods for the clear to take effect, so requires
+    /// the bit clock to be running.
+      void clear_fifos();
+
+    /// @brief Write samples to the transmit FIFO
+    ///
+    /// If the FIFO is empty a whole FIFO's worth of words is written without
+    /// checking status, otherwise the FIFO space flag is checked before each
+    /// word.
+    ///
+    /// @param[in] psamples Pointer to samples: channel 1 then channel 2 (if
+    ///                     used) of each frame.
+    /// @param[in] count    Maximum number of samples to write.
+    /// @returns Number of samples actually written. Less than \c count if
+    ///          FIFO fills.
+      std::size_t write(std::uint32_t const * psamples, std::size_t count);
+
+    /// @brief Read samples from the receive FIFO
+    ///
+    /// While the FIFO is full a whole FIFO's worth of words is read without
+    /// checking status, otherwise the FIFO data flag is checked before each
+    /// word.
+    ///
+    /// @param[out] psamples  Pointer to buffer for samples.
+    /// @param[in] count      Maximum number of samples to read.
+    /// @returns Number of samples actually read. Less than \c count if FIFO
+    ///          empties.
+      std::size_t read(std::uint32_t * psamples, std::size_t count);
+
+    /// @brief Write all samples, waiting for transmit FIFO space.
+    /// @param[in] psamples Pointer to samples.
+    /// @param[in] count    Number of samples to write.
+    /// @returns \c count.
+      std::size_t write_all(std::uint32_t const * psamples, std::size_t count);
+
+    /// @brief Read samples, waiting for them to be received.
+    /// @param[out] psamples  Pointer to buffer for samples.
+    /// @param[in] count      Number of samples to read.
+    /// @returns \c count.
+      std::size_t read_all(std::uint32_t * psamples, std::size_t count);
+
+    /// @brief Returns counts of FIFO errors seen by reads and writes.
+      pcm_fifo_errors const & fifo_errors() const
+      {
+        return errors;
+      }
+
+    /// @brief Set the wait policy used while write_all and read_all wait.
+    ///
+    /// Defaults to a default constructed wait_policy.
+    /// @param[in] p  Policy to use.
+      void set_wait_policy(wait_policy const & p)
+      {
+        waiting = p;
+      }
+
+    /// @brief Returns the wait policy in use.
+      wait_policy const & get_wait_policy() const
+      {
+        return waiting;
+      }
+
+    /// @brief Returns counts of waits by the stage they finished in.
+      wait_stats const & wait_statistics() const
+      {
+        return wait_counts;
+      }
+
+    /// @brief Returns a snapshot of the performance counters.
+    ///
+    /// Counts bytes written and read - 4 per sample, writes and reads stopped
+    /// by a full transmit or empty receive FIFO and polls made while waiting.
+    /// All counts are zero unless counting is enabled - see io_counters.h.
+      io_counters counter_snapshot() const
+      {
+        return counters.snapshot();
+      }
+
+    /// @brief Reset the performance counters to zero.
+      void reset_counters()
+      {
+        counters.reset();
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_PCM_PINS_H
@@ -0,0 +1,108 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file periodic_timer.h
+/// @brief Periodic timer on absolute deadlines using a timerfd : class
+/// definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_PERIODIC_TIMER_H
+# define DIBASE_RPI_PERIPHERALS_PERIODIC_TIMER_H
+
+# include <chrono>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Periodic timer whose deadlines are whole numbers of periods
+  /// after its first deadline.
+  ///
+  /// Uses a CLOCK_MONOTONIC timerfd armed with an absolute first deadline
+  /// and an interval, so deadlines do not drift however late the timer's
+  /// user is to wait for them. Each wait or acknowledge returns the number
+  /// of deadlines passed since the previous one; deadlines beyond the first
+  /// are counted as overruns.
+  ///
+  /// Unlike \ref rt_period a periodic_timer is a file descriptor, so it can
+  /// be added to a \ref pin_edge_event_set and one thread can wait for edge
+  /// events and any number of periodic timers together.
+    class periodic_timer
+    {
+    friend class pin_edge_event_set;///< Can wait on many periodic_timers
+    friend class event_executor;///< Can wait asynchronously
+
+      int                       timer_fd;       ///< timerfd file descriptor
+      std::chrono::nanoseconds  interval;       ///< Time between deadlines
+      std::uint64_t             expiry_count;   ///< Deadlines passed so far
+      std::uint64_t             overrun_count;  ///< Deadlines not waited for
+
+      void start(std::chrono::nanoseconds first);
+      std::uint64_t account(std::uint64_t expirations);
+
+    public:
+    /// @brief Start the timer, the first deadline being one period from now.
+    /// @param[in] period Time between deadlines. Must be greater than zero.
+    /// @throws std::invalid_argument if period is not greater than zero.
+    /// @throws std::system_error if the timerfd cannot be created or armed.
+      explicit periodic_timer(std::chrono::nanoseconds period);
+
+    /// @brief Start the timer with a given first deadline.
+    ///
+    /// Timers given the same first deadline and multiples of the same period
+    /// expire together.
+    ///
+    /// @param[in] period Time between deadlines. Must be greater than zero.
+    /// @param[in] first  CLOCK_MONOTONIC time of first deadline. If already
+    ///                   passed the deadlines since are passed immediately.
+    /// @throws std::invalid_argument if period is not greater than zero.
+    /// @throws std::system_error if the timerfd cannot be created or armed.
+      periodic_timer
+      ( std::chrono::nanoseconds period
+      , std::chrono::nanoseconds first
+      );
+
+    /// @brief Destroy, closing the timerfd.
+      ~periodic_timer();
+
+      periodic_timer(periodic_timer const &) = delete;
+      periodic_timer& operator=(periodic_timer const &) = delete;
+      periodic_timer(periodic_timer &&) = delete;
+      periodic_timer& operator=(periodic_timer &&) = delete;
+
+    /// @brief Wait for the next deadline unless one has already passed.
+    /// @returns Number of deadlines passed since the previous wait or
+    ///          acknowledge, at least 1.
+    /// @throws std::system_error if any system function call returns failure.
+      std::uint64_t wait();
+
+    /// @brief Acknowledge passed deadlines without waiting. Call after a
+    /// pin_edge_event_set wait reports the timer.
+    /// @returns Number of deadlines passed since the previous wait or
+    ///          acknowledge, 0 if none.
+    /// @throws std::system_error if the timerfd read fails.
+      std::uint64_t acknowledge();
+
+    /// @brief Returns the time between deadlines.
+      std::chrono::nanoseconds period() const
+      {
+        return interval;
+      }
+
+    /// @brief Returns number of deadlines passed and waited for or
+    /// acknowledged so far.
+      std::uint64_t expirations() const
+      {
+        return expiry_count;
+      }
+
+    /// @brief Returns number of deadlines passed beyond the first between
+    /// successive waits or acknowledges.
+      std::uint64_t overruns() const
+      {
+        return overrun_count;
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_PERIODIC_TIMER_H
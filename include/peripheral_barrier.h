@@ -0,0 +1,73 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file peripheral_barrier.h
+/// @brief Memory barriers ordering accesses to different peripherals.
+///
+/// The
+/// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+/// Broadcom BCM2835 ARM Peripherals Datasheet</a> section 1.3 warns that the
+/// AXI bus does not keep reads of different peripherals in order: data from
+/// one peripheral may be returned as the result of a read of another. A
+/// memory barrier is required before the first write to a peripheral and
+/// after the last read of a peripheral. Accesses to the same peripheral are
+/// always in order and need no barrier.
+///
+/// The library's peripheral classes place a peripheral_barrier() at each
+/// point they switch from accessing one peripheral to another - typically
+/// during construction, destruction and reconfiguration. Their data transfer
+/// paths, which access a single peripheral, are barrier free. Code that
+/// accesses another peripheral directly between calls into the library, or
+/// mixes several library objects' peripherals, should call
+/// peripheral_barrier() when switching rather than rely on dummy reads.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_PERIPHERAL_BARRIER_H
+# define DIBASE_RPI_PERIPHERALS_PERIPHERAL_BARRIER_H
+
+# if !defined(__arm__) && !defined(__aarch64__)
+#   include <atomic>
+# endif
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Data memory barrier (DMB) for switching between peripherals.
+  ///
+  /// All memory accesses before the barrier complete, as observed by other
+  /// bus masters, before any after it. Use between the last access to one
+  /// peripheral and the first access to another.
+  ///
+  /// On ARMv6 (BCM2835) this is the CP15 DMB operation, on later ARM
+  /// architectures the DMB SY instruction. On other, non-Raspberry Pi, hosts
+  /// it is a sequentially consistent thread fence.
+    inline void peripheral_barrier()
+    {
+# if defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH>=7)
+      __asm__ __volatile__ ("dmb sy" ::: "memory");
+# elif defined(__arm__)
+      __asm__ __volatile__ ("mcr p15, 0, %0, c7, c10, 5" :: "r" (0) : "memory");
+# else
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+# endif
+    }
+
+  /// @brief Data synchronisation barrier (DSB).
+  ///
+  /// As peripheral_barrier() but in addition no instruction after the
+  /// barrier executes until all memory accesses before it complete. Use
+  /// when a peripheral write must have taken effect before continuing - for
+  /// example before timing a delay from a clock or pin function change.
+    inline void peripheral_sync_barrier()
+    {
+# if defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH>=7)
+      __asm__ __volatile__ ("dsb sy" ::: "memory");
+# elif defined(__arm__)
+      __asm__ __volatile__ ("mcr p15, 0, %0, c7, c10, 4" :: "r" (0) : "memory");
+# else
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+# endif
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_PERIPHERAL_BARRIER_H
@@ -9,17 +9,90 @@
 # define DIBASE_RPI_PERIPHERALS_PIN_H
 
 # include "pin_id.h"
+# include <cassert>
+# include <cstddef>
+# include <cstdint>
+# include <vector>
 
 namespace dibase { namespace rpi {
   namespace peripherals
   {
+    namespace internal
+    {
+    /// @brief \b Internal : 32-bit word offset of GPSET0 from GPIO base
+      constexpr std::size_t gpset0_word_offset{7};
+
+    /// @brief \b Internal : 32-bit word offset of GPCLR0 from GPIO base
+      constexpr std::size_t gpclr0_word_offset{10};
+
+    /// @brief \b Internal : 32-bit word offset of GPLEV0 from GPIO base
+      constexpr std::size_t gplev0_word_offset{13};
+
+    /// @brief \b Internal : Return start of mapped GPIO registers as words.
+    /// @returns Pointer to the first 32-bit word of the memory mapped BCM2835
+    ///          GPIO control registers.
+      std::uint32_t volatile * gpio_register_words();
+
+    /// @brief \b Internal : Output pin writes collected by a gpio_transaction
+    ///
+    /// Set and clear masks for each bank of GPIO pins. A pin is in at most
+    /// one of its bank's masks: the last value put to it.
+      struct gpio_put_batch
+      {
+        std::uint32_t set_masks[2];   ///< Pins to set high, per bank
+        std::uint32_t clear_masks[2]; ///< Pins to clear low, per bank
+
+      /// @brief Record an output pin write to be made later.
+      /// @param[in]  bank  Bank of pin: 0 for GPIO pins 0..31, 1 for 32..53.
+      /// @param[in]  mask  Pin's bit in its bank.
+      /// @param[in]  v     Value put to pin.
+        void add(std::size_t bank, std::uint32_t mask, bool v)
+        {
+          if (v)
+            {
+              set_masks[bank] |= mask;
+              clear_masks[bank] &= ~mask;
+            }
+          else
+            {
+              clear_masks[bank] |= mask;
+              set_masks[bank] &= ~mask;
+            }
+        }
+
+      /// @brief Record all writes of a later batch, replacing any earlier
+      /// writes to the same pins.
+      /// @param[in]  later Batch of writes made after those of this batch.
+        void add(gpio_put_batch const & later)
+        {
+          for (std::size_t bank=0U; bank!=2U; ++bank)
+            {
+              set_masks[bank] = (set_masks[bank]&~later.clear_masks[bank])
+                              | later.set_masks[bank];
+              clear_masks[bank] = (clear_masks[bank]&~later.set_masks[bank])
+                                | later.clear_masks[bank];
+            }
+        }
+      };
+
+    /// @brief \b Internal : Tag selecting pin constructors that take over a
+    /// pin already allocated and set to the required function.
+      struct adopt_pin_t {};
+
+    /// @brief \b Internal : Batch of the calling thread's innermost active
+    /// gpio_transaction, or nullptr if it has none.
+      extern thread_local gpio_put_batch * active_gpio_put_batch;
+    } // namespace internal closed
+
   /// @brief Base class for I/O direction specific GPIO classes
   /// \ref opin and \ref ipin.
   ///
   /// Specifies public and protected member functions providing common
   /// functionality to the sub-types. Also stores, and provides read only
   /// access to sub classes, to the pin_id associated with an open single
-  /// GPIO pin I/O object.
+  /// GPIO pin I/O object, together with the location of the pin's bank of
+  /// mapped GPIO registers and the pin's bit mask within that bank so the
+  /// sub-types' I/O operations can be defined inline.
     class pin_base
     {
     protected:
@@ -32,13 +105,31 @@ namespace dibase { namespace rpi {
     /// @brief Initialise pin to being closed.
       pin_base(pin_id pin, direction_mode dir);
 
+    /// @brief Take over a pin already allocated and set to the required
+    /// function, as done in bulk by \ref pin_bank.
+      pin_base(pin_id pin, internal::adopt_pin_t);
+
     /// @brief Destroy pin object - deallocates pin
       ~pin_base();
 
       pin_base(pin_base const &) = delete;
       pin_base& operator=(pin_base const &) = delete;
-      pin_base(pin_base &&) = delete;
-      pin_base& operator=(pin_base &&) = delete;
+
+    /// @brief Move construct, taking over other's open pin.
+    ///
+    /// other is left not open: it may only be destroyed or assigned to.
+      pin_base(pin_base && other) noexcept;
+
+    /// @brief Move assign: deallocate any pin open on this object then take
+    /// over other's open pin, leaving other not open.
+      pin_base& operator=(pin_base && other);
+
+    /// @brief Returns true if a pin is open on the object, false if it has
+    /// been moved from.
+      bool is_open() const
+      {
+        return bank_regs!=nullptr;
+      }
 
     /// @brief Returns the pin id of the GPIO pin open on this object.
       pin_id get_pin() const
@@ -46,8 +137,23 @@ namespace dibase { namespace rpi {
         return pin;
       }
 
+    /// @brief Returns pointer to the pin's bank's GPIO register word at offset
+    /// @param[in]  offset  Word offset of the bank 0 register (e.g. GPSET0).
+      std::uint32_t volatile * bank_register(std::size_t offset) const
+      {
+        return bank_regs + offset;
+      }
+
+    /// @brief Returns the pin's bit mask within its GPIO register bank.
+      std::uint32_t bank_mask() const
+      {
+        return mask;
+      }
+
     private:
       pin_id pin;     ///< Open GPIO pin's id.
+      std::uint32_t volatile * bank_regs; ///< GPIO registers offset by bank
+      std::uint32_t mask;                 ///< Pin's bit in its bank registers
     };
 
   /// @brief Use a single GPIO pin for output.
@@ -55,9 +161,16 @@ namespace dibase { namespace rpi {
   /// Provides explicit open member function to open a single GPIO pin for
   /// output of Boolean values via a put member function. In addition provides
   /// a default constructor and a constructor that opens a pin for output and
-  /// will also close an open pin on destruction.
+  /// will also close an open pin on destruction. opin objects may be moved,
+  /// so can be held by value in containers and returned from functions.
     class opin : public pin_base
     {
+    friend class pin_bank;///< pin_banks open opins in bulk
+
+      opin(pin_id pin, internal::adopt_pin_t tag)
+      : pin_base(pin, tag)
+      {}
+
     public:
     /// @brief Create and open a GPIO pin for output
     /// @param[in]  pin   Id of GPIO pin to open for output.
@@ -68,10 +181,28 @@ namespace dibase { namespace rpi {
       {}
  
     /// @brief Set an open output pin to the specified state
+    ///
+    /// The pin must be open: put must not be called on an opin that has
+    /// been moved from.
     /// @param[in]  v Value to output:  true to set pin state high,
     ///                                 false set pin state low
-    ///               Note: outputs nothing if pin is not open.
-      void put( bool v );
+    ///               If the calling thread has an active gpio_transaction
+    ///               the value is only output when it is committed.
+      void put( bool v )
+      {
+        assert(is_open());
+        if ( internal::active_gpio_put_batch )
+          {
+            internal::active_gpio_put_batch->add( get_pin()/32U
+                                                , bank_mask()
+                                                , v
+                                                );
+            return;
+          }
+        *bank_register( v ? internal::gpset0_word_offset
+                          : internal::gpclr0_word_offset
+                      ) = bank_mask();
+      }
     };
 
   /// @brief Use a single GPIO pin for input.
@@ -79,10 +210,19 @@ namespace dibase { namespace rpi {
   /// Provides explicit open member function to open a single GPIO pin for
   /// input as a Boolean value via a get member function. In addition provides
   /// a default constructor and a constructor that opens a pin for input and
-  /// will also close an open pin on destruction.
+  /// will also close an open pin on destruction. ipin objects may be moved,
+  /// so can be held by value in containers and returned from functions.
     class ipin : public pin_base
     {
     friend class pin_edge_event;///< ipin objects can be associated with events
+    friend class pin_bank;///< pin_banks open ipins in bulk
+
+      ipin(pin_id pin, unsigned mode, internal::adopt_pin_t tag)
+      : pin_base(pin, tag)
+      , pull_mode{mode}
+      {}
+
+      unsigned pull_mode; ///< Pull mode applied to the pin when opened
 
     public:
     /// @brief Input open mode flag enumerations
@@ -101,13 +241,39 @@ namespace dibase { namespace rpi {
       explicit ipin( pin_id pin, unsigned mode=0 );
 
     /// @brief Destroy pin object, closing it.
+    ///
+    /// Pull up or pull down applied to the pin on opening is disabled. Pins
+    /// opened with pull_disable are closed without a pull sequence.
       ~ipin();
 
+    /// @brief Move construct, taking over other's open pin.
+      ipin(ipin &&) = default;
+
+    /// @brief Move assign: close any pin open on this object then take over
+    /// other's open pin.
+      ipin& operator=(ipin && other);
+
+    /// @brief Close all pins in a vector, disabling pull up and pull down on
+    /// them together.
+    ///
+    /// Destroying ipins one at a time performs a pull disable sequence, with
+    /// its waits, for each pin opened with pull up or pull down. close_all
+    /// performs one sequence for all such pins in pins then destroys them,
+    /// leaving pins empty.
+    /// @param[inout] pins  ipins to close. Pins not open are ignored.
+      static void close_all(std::vector<ipin> & pins);
+
     /// @brief Return the current state of open input pin
+    ///
+    /// The pin must be open: get must not be called on an ipin that has
+    /// been moved from.
     /// @return true if pin is in a high state
     ///         false if pin is in a low state
-    ///         Always returns false if pin is not open.
-      bool get();
+      bool get()
+      {
+        assert(is_open());
+        return (*bank_register(internal::gplev0_word_offset) & bank_mask())!=0U;
+      }
     };
   } // namespace peripherals closed
 }} // namespaces rpi and dibase closed
@@ -0,0 +1,85 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pin_bank.h
+/// @brief Open many GPIO pins for input or output in one pass : class
+/// definition.
+///
+/// Opening each \ref opin or \ref ipin separately checks and exports the
+/// pin in the sys file-system, read-modify-writes its GPFSELn register and,
+/// for an ipin, runs a GPPUD pull sequence with its waits. A pin_bank opens
+/// a whole list of pins together:
+///   - one read of the sys file-system GPIO directory checks none of the
+///     pins are exported, and they are exported through the already open
+///     export file
+///   - each GPFSELn register is updated once
+///   - one pull sequence is run for each pull mode used by the input pins.
+///
+/// The opened pins are ordinary opin and ipin objects, which may be used in
+/// place or moved out of the pin_bank.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_PIN_BANK_H
+# define DIBASE_RPI_PERIPHERALS_PIN_BANK_H
+
+# include "pin.h"
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Input pin to open with a pin_bank and its pull mode.
+    struct pin_bank_input
+    {
+      pin_id    pin;  ///< Id of GPIO pin to open for input
+      unsigned  mode; ///< ipin::open_mode pull mode for the pin
+    };
+
+  /// @brief Open a list of GPIO pins for output and input together.
+    class pin_bank
+    {
+      std::vector<opin> out_pins;
+      std::vector<ipin> in_pins;
+
+    public:
+    /// @brief Open GPIO pins for output and input.
+    ///
+    /// Either all pins are opened or, if an exception is thrown, none are.
+    ///
+    /// @param[in]  outputs Ids of GPIO pins to open for output.
+    /// @param[in]  inputs  GPIO pins to open for input with their pull
+    ///                     modes. Defaults to none.
+    /// @throws bad_peripheral_alloc if any GPIO pin is in use by this
+    ///         process or elsewhere or is in the lists more than once.
+    /// @throws std::invalid_argument if an input pull mode requests both
+    ///         pull up and down.
+      explicit pin_bank
+      ( std::vector<pin_id> const & outputs
+      , std::vector<pin_bank_input> const & inputs = {}
+      );
+
+    /// @brief Close the pins still held, disabling pull up and pull down on
+    /// the input pins with one pull sequence. Pins moved out are not
+    /// affected.
+      ~pin_bank();
+
+      pin_bank(pin_bank const &) = delete;
+      pin_bank& operator=(pin_bank const &) = delete;
+
+    /// @brief Returns the output pins, in the order their ids were passed
+    /// on construction. Pins may be moved out of the vector.
+      std::vector<opin> & outputs()
+      {
+        return out_pins;
+      }
+
+    /// @brief Returns the input pins, in the order they were passed on
+    /// construction. Pins may be moved out of the vector.
+      std::vector<ipin> & inputs()
+      {
+        return in_pins;
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_PIN_BANK_H
@@ -9,7 +9,10 @@
 # define DIBASE_RPI_PERIPHERALS_PIN_EDGE_EVENT_H
 
 # include "pin.h"
+# include "system_timer.h"
+# include "io_counters.h"
 # include <chrono>
+# include <system_error>
 
 namespace dibase { namespace rpi {
   namespace peripherals
@@ -25,10 +28,24 @@ namespace dibase { namespace rpi {
   /// if using the provided pin allocator.
     class pin_edge_event
     {
+    friend class pin_edge_event_set;///< Can wait on many pin_edge_events
+    friend class event_executor;///< Can wait asynchronously
+
       int     pin_event_fd;
       pin_id  id;
+      mutable io_counter_set  counters;
 
-      bool     wait_(long t_rel_secs, long t_rel_ns) const;
+      bool     wait_
+               ( long t_rel_secs
+               , long t_rel_ns
+               , system_timer::time_point * when = nullptr
+               ) const;
+      bool     wait_
+               ( long t_rel_secs
+               , long t_rel_ns
+               , std::error_code & ec
+               ) const noexcept;
+      void     release() noexcept;
 
     public:
     /// @brief Monitored edge transition type options
@@ -56,8 +73,16 @@ namespace dibase { namespace rpi {
  
       pin_edge_event(pin_edge_event const &) = delete;
       pin_edge_event& operator=(pin_edge_event const &) = delete;
-      pin_edge_event(pin_edge_event &&) = delete;
-      pin_edge_event& operator=(pin_edge_event &&) = delete;
+
+    /// @brief Move construct, taking over other's watchable file descriptor.
+    ///
+    /// other is left with no associated pin: it may only be destroyed or
+    /// assigned to.
+      pin_edge_event(pin_edge_event && other) noexcept;
+
+    /// @brief Move assign: release any pin associated with this object then
+    /// take over other's, leaving other with no associated pin.
+      pin_edge_event& operator=(pin_edge_event && other) noexcept;
     
     /// @brief Destroy, closing watchable file descriptor.
       ~pin_edge_event();
@@ -67,14 +92,47 @@ namespace dibase { namespace rpi {
     /// @throws std::system_error if any system function call returns failure.
       bool signalled() const;
 
+    /// @brief Check if a monitored edge event occurred on the associated pin,
+    /// reporting failure without throwing.
+    /// @param[out] ec  Set to the error of a failing system function call,
+    ///                 cleared otherwise.
+    /// @returns true if an event has been signalled, false if not or on
+    ///          failure.
+      bool signalled(std::error_code & ec) const noexcept;
+
     /// @brief Clear signalled event. Events remain signalled until cleared.
     /// @throws std::system_error if any system function call returns failure.
       void clear() const;
 
+    /// @brief Clear signalled event, reporting failure without throwing.
+    /// @param[out] ec  Set to the error of a failing system function call,
+    ///                 cleared otherwise.
+      void clear(std::error_code & ec) const noexcept;
+
     /// @brief Wait for a monitored edge event to occur on the associated pin.
     /// @throws std::system_error if any system function call returns failure.
       void wait() const;
 
+    /// @brief Wait for a monitored edge event to occur on the associated pin,
+    /// reporting failure without throwing.
+    /// @param[out] ec  Set to the error of a failing system function call,
+    ///                 cleared otherwise. A wait interrupted by a signal
+    ///                 fails with std::errc::interrupted.
+      void wait(std::error_code & ec) const noexcept;
+
+    /// @brief Wait for a monitored edge event and timestamp its detection.
+    ///
+    /// The timestamp is read from the system timer as soon as the wait
+    /// returns, so it includes the latency of the kernel's interrupt handling
+    /// and of waking the calling thread - typically tens of microseconds and
+    /// more if the thread is not scheduled promptly. Where more accuracy is
+    /// needed use \ref pin_line_event, whose events are timestamped by the
+    /// kernel's interrupt handler, or \ref pin_event_detector::poll.
+    ///
+    /// @param[out] when  System timer time the event was seen.
+    /// @throws std::system_error if any system function call returns failure.
+      void wait(system_timer::time_point & when) const;
+
     /// @brief Wait for edge event for a given amount of time.
     /// @tparam Rep       template parameter for std::chrono::duration -
     ///                   see C++11 standard section 20.11.5.
@@ -96,6 +154,62 @@ namespace dibase { namespace rpi {
         return wait_(t_secs, t_ns-t_secs_ns);
       }
 
+    /// @brief Wait for edge event for a given amount of time and timestamp
+    /// its detection.
+    ///
+    /// The timestamp is read as for \ref wait(system_timer::time_point&).
+    ///
+    /// @tparam Rep       template parameter for std::chrono::duration -
+    ///                   see C++11 standard section 20.11.5.
+    /// @tparam Period    template parameter for std::chrono::duration -
+    ///                   see C++11 standard section 20.11.5.
+    /// @param[in] rel_time   Amount of time to wait for a monitored edge event
+    ///                   to occur on the associated pin.
+    /// @param[out] when  System timer time the event was seen. Unchanged if
+    ///                   the call timed out.
+    /// @returns true if an event occurred or false if no event occurred and
+    ///          the call timed out.
+    /// @throws std::system_error if any system function call returns failure.
+      template <class Rep, class Period>
+      bool wait_for
+      ( const std::chrono::duration<Rep, Period>& rel_time
+      , system_timer::time_point & when
+      ) const
+      {
+        using std::chrono::duration_cast;
+        auto t_ns(duration_cast<std::chrono::nanoseconds>(rel_time).count());
+        auto dur_secs(duration_cast<std::chrono::seconds>(rel_time));
+        auto t_secs(dur_secs.count());
+        auto t_secs_ns(duration_cast<std::chrono::nanoseconds>(dur_secs).count());
+        return wait_(t_secs, t_ns-t_secs_ns, &when);
+      }
+
+    /// @brief Wait for edge event for a given amount of time, reporting
+    /// failure without throwing.
+    /// @tparam Rep       template parameter for std::chrono::duration -
+    ///                   see C++11 standard section 20.11.5.
+    /// @tparam Period    template parameter for std::chrono::duration -
+    ///                   see C++11 standard section 20.11.5.
+    /// @param[in] rel_time   Amount of time to wait for a monitored edge event
+    ///                   to occur on the associated pin.
+    /// @param[out] ec    Set to the error of a failing system function call,
+    ///                   cleared otherwise.
+    /// @returns true if an event occurred or false if no event occurred and
+    ///          the call timed out or failed.
+      template <class Rep, class Period>
+      bool wait_for
+      ( const std::chrono::duration<Rep, Period>& rel_time
+      , std::error_code & ec
+      ) const noexcept
+      {
+        using std::chrono::duration_cast;
+        auto t_ns(duration_cast<std::chrono::nanoseconds>(rel_time).count());
+        auto dur_secs(duration_cast<std::chrono::seconds>(rel_time));
+        auto t_secs(dur_secs.count());
+        auto t_secs_ns(duration_cast<std::chrono::nanoseconds>(dur_secs).count());
+        return wait_(t_secs, t_ns-t_secs_ns, ec);
+      }
+
     /// @brief Wait for edge event until a given point in time.
     /// @tparam Clock     template parameter for std::chrono::time_point -
     ///                   see C++1 standard section 20.11.6.
@@ -112,6 +226,23 @@ namespace dibase { namespace rpi {
       {
         return wait_for(abs_time - std::chrono::system_clock::now());
       }
+
+    /// @brief Returns a snapshot of the performance counters.
+    ///
+    /// Counts waits by this object's wait, wait_for and wait_until functions
+    /// that ended with an event (wakeups) or timed out. Waits by a
+    /// pin_edge_event_set are not counted. All counts are zero unless
+    /// counting is enabled - see io_counters.h.
+      io_counters counter_snapshot() const
+      {
+        return counters.snapshot();
+      }
+
+    /// @brief Reset the performance counters to zero.
+      void reset_counters()
+      {
+        counters.reset();
+      }
     };
   } // namespace peripherals closed
 }} // namespaces rpi and dibase closed
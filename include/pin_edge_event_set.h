@@ -0,0 +1,204 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pin_edge_event_set.h
+/// @brief Wait for edge events on many GPIO input pins : class definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_PIN_EDGE_EVENT_SET_H
+# define DIBASE_RPI_PERIPHERALS_PIN_EDGE_EVENT_SET_H
+
+# include "pin_edge_event.h"
+# include "pin_line_event.h"
+# include "periodic_timer.h"
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Set of pin_edge_event objects that can be waited on together.
+  ///
+  /// Uses a single epoll instance to wait on all the pin_edge_events added to
+  /// the set, so one thread - and one system call per wake up - can service
+  /// many GPIO input pins. Each wait reports all the set's pins that are
+  /// signalled at the time it wakes.
+  ///
+  /// Waiting threads can be woken without waiting for a time out by
+  /// cancelling the set, which puts it into a cancelled state in which all
+  /// waits return immediately with no pins signalled until it is reset.
+  ///
+  /// As with pin_edge_event, events remain signalled until cleared using
+  /// pin_edge_event::clear.
+  ///
+  /// periodic_timers may also be added so that one thread can serve edge
+  /// events and timed work together. A set with timers must be waited on
+  /// using the wait and wait_for overloads that report timers. Timers remain
+  /// signalled until acknowledged using periodic_timer::acknowledge.
+    class pin_edge_event_set
+    {
+      int epoll_fd;     ///< epoll instance file descriptor
+      int cancel_fd;    ///< eventfd file descriptor used for cancellation
+
+      std::size_t wait_
+      ( std::vector<pin_id> & pins
+      , std::vector<periodic_timer *> * timers
+      , int timeout_ms
+      ) const;
+
+      template <class Rep, class Period>
+      static int timeout_ms(std::chrono::duration<Rep, Period> const & t)
+      {
+        using std::chrono::duration_cast;
+        using std::chrono::milliseconds;
+        auto t_ms(duration_cast<milliseconds>(t));
+        if ( t_ms<t )
+          {
+            t_ms += milliseconds{1};
+          }
+        return t_ms.count()<0 ? 0 : static_cast<int>(t_ms.count());
+      }
+
+    public:
+    /// @brief Construct an empty set.
+    /// @throws std::system_error if the epoll instance or cancellation
+    ///         eventfd cannot be created.
+      pin_edge_event_set();
+
+    /// @brief Destroy, closing epoll and cancellation file descriptors.
+      ~pin_edge_event_set();
+
+      pin_edge_event_set(pin_edge_event_set const &) = delete;
+      pin_edge_event_set& operator=(pin_edge_event_set const &) = delete;
+      pin_edge_event_set(pin_edge_event_set &&) = delete;
+      pin_edge_event_set& operator=(pin_edge_event_set &&) = delete;
+
+    /// @brief Add a pin_edge_event to the set.
+    ///
+    /// The pin_edge_event must be removed from the set, or the set destroyed,
+    /// before the pin_edge_event is destroyed.
+    /// @param[in] e  pin_edge_event to add.
+    /// @throws std::system_error if e cannot be added, for example because it
+    ///         is already in the set.
+      void add(pin_edge_event const & e);
+
+    /// @brief Remove a pin_edge_event from the set.
+    /// @param[in] e  pin_edge_event to remove.
+    /// @throws std::system_error if e cannot be removed, for example because
+    ///         it is not in the set.
+      void remove(pin_edge_event const & e);
+
+    /// @brief Add a pin_line_event to the set.
+    ///
+    /// The pin_line_event's pin is reported as signalled while it has queued
+    /// events. The pin_line_event must be removed from the set, or the set
+    /// destroyed, before the pin_line_event is destroyed.
+    /// @param[in] e  pin_line_event to add.
+    /// @throws std::system_error if e cannot be added, for example because it
+    ///         is already in the set.
+      void add(pin_line_event const & e);
+
+    /// @brief Remove a pin_line_event from the set.
+    /// @param[in] e  pin_line_event to remove.
+    /// @throws std::system_error if e cannot be removed, for example because
+    ///         it is not in the set.
+      void remove(pin_line_event const & e);
+
+    /// @brief Add a periodic_timer to the set.
+    ///
+    /// The timer is reported as signalled while it has unacknowledged passed
+    /// deadlines. The periodic_timer must be removed from the set, or the set
+    /// destroyed, before the periodic_timer is destroyed.
+    /// @param[in] t  periodic_timer to add.
+    /// @throws std::system_error if t cannot be added, for example because it
+    ///         is already in the set.
+      void add(periodic_timer & t);
+
+    /// @brief Remove a periodic_timer from the set.
+    /// @param[in] t  periodic_timer to remove.
+    /// @throws std::system_error if t cannot be removed, for example because
+    ///         it is not in the set.
+      void remove(periodic_timer const & t);
+
+    /// @brief Wait for a monitored edge event on any of the set's pins.
+    /// @param[out] pins  Replaced by the pin ids of the signalled pins.
+    /// @returns Number of signalled pins: 0 only if the set is cancelled.
+    /// @throws std::system_error if any system function call returns failure.
+      std::size_t wait(std::vector<pin_id> & pins) const
+      {
+        return wait_(pins, nullptr, -1);
+      }
+
+    /// @brief Wait for a monitored edge event on any of the set's pins or a
+    /// deadline of any of its timers.
+    /// @param[out] pins    Replaced by the pin ids of the signalled pins.
+    /// @param[out] timers  Replaced by the signalled timers.
+    /// @returns Number of signalled pins and timers: 0 only if the set is
+    ///          cancelled.
+    /// @throws std::system_error if any system function call returns failure.
+      std::size_t wait
+      ( std::vector<pin_id> & pins
+      , std::vector<periodic_timer *> & timers
+      ) const
+      {
+        return wait_(pins, &timers, -1);
+      }
+
+    /// @brief Wait for edge events for a given amount of time.
+    /// @tparam Rep       template parameter for std::chrono::duration -
+    ///                   see C++11 standard section 20.11.5.
+    /// @tparam Period    template parameter for std::chrono::duration -
+    ///                   see C++11 standard section 20.11.5.
+    /// @param[out] pins  Replaced by the pin ids of the signalled pins.
+    /// @param[in] rel_time   Amount of time to wait for a monitored edge event
+    ///                   to occur on any of the set's pins. Waits are in whole
+    ///                   milliseconds, rounded up.
+    /// @returns Number of signalled pins: 0 if the call timed out or the set
+    ///          is cancelled.
+    /// @throws std::system_error if any system function call returns failure.
+      template <class Rep, class Period>
+      std::size_t wait_for
+      ( std::vector<pin_id> & pins
+      , const std::chrono::duration<Rep, Period>& rel_time
+      ) const
+      {
+        return wait_(pins, nullptr, timeout_ms(rel_time));
+      }
+
+    /// @brief Wait for edge events or timer deadlines for a given amount of
+    /// time.
+    /// @tparam Rep       template parameter for std::chrono::duration -
+    ///                   see C++11 standard section 20.11.5.
+    /// @tparam Period    template parameter for std::chrono::duration -
+    ///                   see C++11 standard section 20.11.5.
+    /// @param[out] pins  Replaced by the pin ids of the signalled pins.
+    /// @param[out] timers  Replaced by the signalled timers.
+    /// @param[in] rel_time   Amount of time to wait. Waits are in whole
+    ///                   milliseconds, rounded up.
+    /// @returns Number of signalled pins and timers: 0 if the call timed out
+    ///          or the set is cancelled.
+    /// @throws std::system_error if any system function call returns failure.
+      template <class Rep, class Period>
+      std::size_t wait_for
+      ( std::vector<pin_id> & pins
+      , std::vector<periodic_timer *> & timers
+      , const std::chrono::duration<Rep, Period>& rel_time
+      ) const
+      {
+        return wait_(pins, &timers, timeout_ms(rel_time));
+      }
+
+    /// @brief Cancel the set, waking all threads waiting on it.
+    /// @throws std::system_error if the cancellation eventfd write fails.
+      void cancel();
+
+    /// @brief Returns true if the set is cancelled, false otherwise.
+    /// @throws std::system_error if any system function call returns failure.
+      bool is_cancelled() const;
+
+    /// @brief Reset the set to the not cancelled state.
+    /// @throws std::system_error if the cancellation eventfd read fails.
+      void reset();
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_PIN_EDGE_EVENT_SET_H
@@ -0,0 +1,196 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pin_event_detector.h
+/// @brief Register level GPIO pin edge and level event detection : class
+/// definition.
+///
+/// \ref pin_edge_event detects edges on a single pin via the Linux sys file
+/// system and requires a system call for every check. pin_event_detector
+/// instead enables the BCM2835 GPIO event detect hardware (GPRENn, GPFENn,
+/// GPHENn, GPLENn, GPARENn, GPAFENn registers) for the pins of an
+/// \ref ipin_group so that events are latched in the event detect status
+/// registers (GPEDSn), and polls or clears them for all the group's pins with
+/// one register access per bank.
+///
+/// As events stay latched until cleared, a pin_event_detector polled at a
+/// low rate still reports whether each pin changed state - or for high and
+/// low detection was ever at a level - at any time since the previous poll,
+/// including glitches far shorter than the poll interval, which polling GPLEV
+/// would miss. fetch_and_count also counts in how many polls each pin had an
+/// event.
+///
+/// Note that the edge detect status latches may also be used by the Linux
+/// kernel's GPIO interrupt handling, which clears them. Pins used with a
+/// pin_event_detector should not also be used with \ref pin_edge_event or
+/// otherwise have interrupts enabled in the sys file system.
+///
+/// Events may be timestamped from the system timer as they are fetched.
+/// Busy polling with \ref pin_event_detector::poll timestamps edges to
+/// within about a microsecond of their latching, at the cost of a CPU.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_PIN_EVENT_DETECTOR_H
+# define DIBASE_RPI_PERIPHERALS_PIN_EVENT_DETECTOR_H
+
+# include "pin_group.h"
+# include "system_timer.h"
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Detect edges on a group of input pins using GPIO event registers.
+  ///
+  /// Event values returned and mask values passed are group values: bit n
+  /// refers to the nth pin of the associated ipin_group.
+    class pin_event_detector
+    {
+    public:
+    /// @brief Edge detection mode flags, may be combined using bitwise or.
+      enum detect_mode
+      { rising = 1          ///< Synchronous (filtered) rising edge detect
+      , falling = 2         ///< Synchronous (filtered) falling edge detect
+      , both = 3            ///< Synchronous rising and falling edge detect
+      , async_rising = 4    ///< Asynchronous (unfiltered) rising edge detect
+      , async_falling = 8   ///< Asynchronous (unfiltered) falling edge detect
+      , async_both = 12     ///< Asynchronous rising and falling edge detect
+      , high = 16           ///< High level detect
+      , low = 32            ///< Low level detect
+      };
+
+    /// @brief Enable event detection for all pins of a group.
+    ///
+    /// All the group's pins are armed, see arm(). Any events already latched
+    /// for the group's pins are cleared before detection is enabled.
+    ///
+    /// Level detection latches an event continually while a pin is at the
+    /// level, so clearing the event only has effect once the pin has left
+    /// the level.
+    ///
+    /// @param[in]  pins  Group of input pins to detect edges on. Must outlive
+    ///                   the pin_event_detector object.
+    /// @param[in]  modes Combination of detect_mode flags.
+    /// @throws std::invalid_argument if modes is zero or has bits set that
+    ///         are not detect_mode flags.
+      pin_event_detector(ipin_group const & pins, unsigned modes);
+
+    /// @brief Disable edge detection for the group's armed pins and clear
+    /// events.
+      ~pin_event_detector();
+
+      pin_event_detector(pin_event_detector const &) = delete;
+      pin_event_detector& operator=(pin_event_detector const &) = delete;
+      pin_event_detector(pin_event_detector &&) = delete;
+      pin_event_detector& operator=(pin_event_detector &&) = delete;
+
+    /// @brief Enable edge detection for selected pins of the group.
+    ///
+    /// Pins are armed in bulk: each enabled detect enable register is
+    /// updated once per bank however many pins are armed, rather than once
+    /// per pin. Pins already armed are unaffected. Events latched for the
+    /// pins before they are armed are not cleared.
+    ///
+    /// @param[in]  mask  Group value: bit n set to arm the nth pin.
+      void arm(pin_group_value_t mask);
+
+    /// @brief Enable edge detection for all pins of the group.
+      void arm()
+      {
+        arm(group.all_pins());
+      }
+
+    /// @brief Disable edge detection for selected pins of the group.
+    ///
+    /// As for arm(), each detect enable register is updated once per bank.
+    /// Events already latched for the pins are not cleared.
+    ///
+    /// @param[in]  mask  Group value: bit n set to disarm the nth pin.
+      void disarm(pin_group_value_t mask);
+
+    /// @brief Disable edge detection for all pins of the group.
+      void disarm()
+      {
+        disarm(group.all_pins());
+      }
+
+    /// @brief Return which of the group's pins have edge detection enabled.
+    /// @returns Group value with bit n set if the nth pin is armed.
+      pin_group_value_t armed() const
+      {
+        return group.from_bank_values(armed_masks);
+      }
+
+    /// @brief Return which of the group's pins have a latched event.
+    /// @returns Group value with bit n set if the nth pin has an event.
+      pin_group_value_t signalled() const;
+
+    /// @brief Clear latched events of selected pins of the group.
+    /// @param[in]  mask  Group value: bit n set to clear the nth pin's event.
+      void clear(pin_group_value_t mask);
+
+    /// @brief Clear latched events of all pins of the group.
+      void clear()
+      {
+        clear(group.all_pins());
+      }
+
+    /// @brief Return and clear the group's pins' latched events.
+    ///
+    /// Only those events read are cleared, so an event latched between the
+    /// read and the clear is not lost - it will be returned next time.
+    ///
+    /// @returns Group value with bit n set if the nth pin had an event.
+      pin_group_value_t fetch_and_clear();
+
+    /// @brief Return and clear the group's pins' latched events, counting
+    /// them.
+    ///
+    /// As fetch_and_clear() except that counts[n] is incremented if the nth
+    /// pin had an event, so over a series of polls counts records how many
+    /// polling intervals each pin had an event in.
+    ///
+    /// @param[inout] counts  Per pin event counts. Resized to the group size
+    ///                       if it has fewer elements.
+    /// @returns Group value with bit n set if the nth pin had an event.
+      pin_group_value_t fetch_and_count(std::vector<std::uint64_t> & counts);
+
+    /// @brief Return and clear the group's pins' latched events, timestamping
+    /// their detection.
+    ///
+    /// As fetch_and_clear() except that if any events are returned when is
+    /// set to the system timer time read immediately after the event status
+    /// registers. The events were latched at some time since they were last
+    /// fetched or cleared and no later than when.
+    ///
+    /// @param[out] when  System timer time events were seen. Unchanged if no
+    ///                   events are returned.
+    /// @returns Group value with bit n set if the nth pin had an event.
+      pin_group_value_t fetch_and_clear(system_timer::time_point & when);
+
+    /// @brief Busy poll for events on any of the group's pins, then return
+    /// and clear them, timestamping their detection.
+    ///
+    /// Does not yield the CPU, so the timestamp of an event latched while
+    /// polling is within a poll loop iteration - about a microsecond - of the
+    /// edge unless the calling thread is pre-empted. Best used from a thread
+    /// running with a real-time configuration (see \ref rt_thread).
+    ///
+    /// @param[in]  timeout Longest time to poll for.
+    /// @param[out] when    System timer time events were seen. Unchanged if
+    ///                     the call timed out.
+    /// @returns Group value with bit n set if the nth pin had an event, zero
+    ///          if the call timed out.
+      pin_group_value_t poll
+      ( system_timer::duration timeout
+      , system_timer::time_point & when
+      );
+
+    private:
+      ipin_group const &  group;  ///< Group of pins edges detected on
+      unsigned            modes;  ///< detect_mode flags enabled
+      std::uint32_t       armed_masks[2]; ///< Armed pins' GPIO bank masks
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_PIN_EVENT_DETECTOR_H
@@ -0,0 +1,209 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pin_group.h
+/// @brief Use a group of GPIO pins for input or output : class definitions.
+///
+/// Whereas \ref opin and \ref ipin each operate on a single GPIO pin, the
+/// types defined here operate on a group of GPIO pins together. Each pin of a
+/// group is identified by its position in the group, which is the position of
+/// its pin_id in the list of pin ids passed when constructing the group. Hence
+/// bit 0 of a value or mask refers to the first pin in the group, bit 1 the
+/// second and so on.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_PIN_GROUP_H
+# define DIBASE_RPI_PERIPHERALS_PIN_GROUP_H
+
+# include "pin_id.h"
+# include "pin.h"
+# include <initializer_list>
+# include <bitset>
+# include <vector>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Type used for values and masks having one bit per pin in a group.
+  ///
+  /// Bit n refers to the nth pin in the group. There are at most
+  /// pin_id::number_of_pins pins in a group so all fit in 64 bits.
+    typedef std::uint64_t pin_group_value_t;
+
+  /// @brief Base class for I/O direction specific GPIO pin group classes
+  /// \ref opin_group and \ref ipin_group.
+  ///
+  /// Allocates all pins of the group on construction - either all pins are
+  /// allocated or none are - and frees them on destruction. Provides read only
+  /// access to the pin_ids of the group's pins.
+    class pin_group_base
+    {
+    public:
+    /// @brief Returns the number of GPIO pins in the group.
+      std::size_t size() const
+      {
+        return pins.size();
+      }
+
+    /// @brief Returns the pin id of the GPIO pin at position idx in the group
+    /// @param[in]  idx Position of pin in group (0..size()-1).
+    /// @returns The pin id of the idx-th pin in the group.
+    /// @throws std::out_of_range if idx is not less than size().
+      pin_id get_pin(std::size_t idx) const
+      {
+        return pins.at(idx);
+      }
+
+    /// @brief Returns value with one bit set for every pin in the group.
+    /// @returns Value with bits 0..size()-1 set and all other bits clear.
+      pin_group_value_t all_pins() const
+      {
+        return (pin_group_value_t(1)<<size())-1;
+      }
+
+    protected:
+    /// @brief open data direction mode flag enumerations
+      enum direction_mode
+      { in=1      ///< Direction mode value for data input
+      , out=2     ///< Direction mode value for data output
+      };
+
+    /// @brief Allocate all pins in group and set their direction.
+    /// @param[in]  pins  Ids of GPIO pins to open. Each may only appear once.
+    /// @param[in]  dir   Direction to open GPIO pins for.
+    /// @throws bad_peripheral_alloc if any GPIO pin is in use by this process
+    ///         or elsewhere, in which case no pins are left allocated.
+    /// @throws std::invalid_argument if the list of pins is empty.
+      pin_group_base(std::initializer_list<pin_id> pins, direction_mode dir);
+
+    /// @brief Destroy pin group object - deallocates all pins in the group
+      ~pin_group_base();
+
+      pin_group_base(pin_group_base const &) = delete;
+      pin_group_base& operator=(pin_group_base const &) = delete;
+      pin_group_base(pin_group_base &&) = delete;
+      pin_group_base& operator=(pin_group_base &&) = delete;
+
+    /// @brief Convert a group value to per GPIO register bank bit masks.
+    /// @param[in]  value Value with bit n set to select the nth group pin.
+    /// @param[out] banks Set to masks of selected pins in GPIO register banks
+    ///                   0 (pins 0..31) and 1 (pins 32..53).
+      void to_bank_masks( pin_group_value_t value
+                        , std::uint32_t (&banks)[2]
+                        ) const;
+
+    /// @brief Convert per GPIO register bank bit values to a group value.
+    /// @param[in]  banks Values of GPIO register banks 0 (pins 0..31) and 1
+    ///                   (pins 32..53), one bit per pin, such as GPLEV0/1.
+    /// @returns Value with bit n set if the nth group pin's bit is set in its
+    ///          bank's value. Bits for pins not in the group are ignored.
+      pin_group_value_t from_bank_values
+                        (std::uint32_t const (&banks)[2]) const;
+
+    /// @brief Ids of group's pins, in group position order.
+      std::vector<pin_id> pins;
+
+    /// @brief A run of consecutive group positions mapping to consecutive
+    /// pins of one GPIO register bank, moved between group values and bank
+    /// values with one shift and mask.
+      struct bit_run
+      {
+        std::uint32_t     mask;       ///< Run bits, shifted to bit 0
+        unsigned char     bank;       ///< GPIO register bank of the run
+        unsigned char     bank_shift; ///< Bit of first run pin in its bank
+        unsigned char     group_shift;///< Group position of first run pin
+      };
+
+    /// @brief Runs covering the group's pins, in group position order.
+      std::vector<bit_run> runs;
+
+    /// @brief Masks of group's pins in each GPIO register bank (0..31, 32..53)
+      std::uint32_t bank_masks[2];
+    };
+
+  /// @brief Use a group of GPIO pins for output
+  ///
+  /// Changes the state of any subset of the group's pins with at most two
+  /// register writes per 32-pin GPIO register bank - one to set pins high and
+  /// one to clear pins low - so that pins in the same bank change together.
+    class opin_group : public pin_group_base
+    {
+    friend class waveform;///< waveforms are played on opin_groups
+    friend class soft_pwm_engine;///< soft PWM is driven on opin_groups
+    friend class multiplexed_display;///< displays are driven on opin_groups
+    friend class gpio_sequence;///< sequences are played on opin_groups
+
+    public:
+    /// @brief Create and open a group of GPIO pins for output
+    /// @param[in]  pins  Ids of GPIO pins to open for output.
+    /// @throws bad_peripheral_alloc if any GPIO pin is in use by this process
+    ///         or elsewhere.
+    /// @throws std::invalid_argument if the list of pins is empty.
+      explicit opin_group( std::initializer_list<pin_id> pins )
+      : pin_group_base(pins, direction_mode::out)
+      {}
+
+    /// @brief Set state of the group's pins selected by mask.
+    /// @param[in]  mask    Bit n set if nth pin of group is to be updated.
+    /// @param[in]  values  Bit n is the value to output to the nth pin of
+    ///                     the group: 1 to set high, 0 to set low. Ignored
+    ///                     for pins not selected by mask.
+      void put( pin_group_value_t mask, pin_group_value_t values );
+
+    /// @brief Set state of all of the group's pins.
+    /// @param[in]  values  Bit n is the value to output to the nth pin of
+    ///                     the group: 1 to set high, 0 to set low.
+      void put( pin_group_value_t values )
+      {
+        put(all_pins(), values);
+      }
+    };
+
+  /// @brief Use a group of GPIO pins for input
+  ///
+  /// Reads the state of all of the group's pins with at most one register
+  /// read per 32-pin GPIO register bank.
+    class ipin_group : public pin_group_base
+    {
+    friend class pin_event_detector;///< ipin_groups can have events detected
+
+      unsigned pull_mode; ///< Pull mode applied to the pins when opened
+
+    public:
+    /// @brief Create and open a group of GPIO pins for input
+    /// @param[in]  pins  Ids of GPIO pins to open for input.
+    /// @param[in]  mode  Open mode for all input pins. Specifies pull up/down
+    ///                   mode using ipin::open_mode values, default is
+    ///                   ipin::pull_disable (no pull).
+    /// @throws bad_peripheral_alloc if any GPIO pin is in use by this process
+    ///         or elsewhere.
+    /// @throws std::invalid_argument if the list of pins is empty or mode
+    ///         requests both pull up and pull down.
+      explicit ipin_group( std::initializer_list<pin_id> pins, unsigned mode=0 );
+
+    /// @brief Destroy pin group object, removing any pull up/down.
+    ///
+    /// Groups opened with ipin::pull_disable are closed without a pull
+    /// sequence.
+      ~ipin_group();
+
+    /// @brief Return the current state of all the group's pins
+    /// @returns Value in which bit n is set if the nth pin of the group is in
+    ///          a high state and clear if it is in a low state.
+      pin_group_value_t get();
+    };
+
+  /// @brief Type of a snapshot of all GPIO pins' levels, indexed by pin id.
+    typedef std::bitset<pin_id::number_of_pins> gpio_snapshot_t;
+
+  /// @brief Read the levels of all GPIO pins in one go.
+  ///
+  /// Reads both GPIO pin level registers once each. Pins need not be open for
+  /// input, the levels of all pins are returned whatever their function.
+  ///
+  /// @returns Snapshot in which bit n is set if GPIO pin n is high.
+    gpio_snapshot_t gpio_snapshot();
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_PIN_GROUP_H
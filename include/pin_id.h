@@ -139,7 +139,35 @@ namespace dibase { namespace rpi {
   /// pin numbers to BCM2835 GPIO pin numbers (that is, pin_id values). One
   /// extra slot is required for the non-existent pin 0, which resolves to an
   /// invalid GPIO pin id value.
-    extern pin_id_int_t const p1_gpio_pin_map[pinout_versions][p1_map_size];
+    constexpr pin_id_int_t p1_gpio_pin_map[pinout_versions][p1_map_size] =
+      { {~0U,~0U,~0U,0,~0U,1,~0U,4,14,~0U,15,17,18,21,~0U,22,23,~0U,24,10,~0U,9,25,11,8,~0U,7
+        ,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U}
+      , {~0U,~0U,~0U,2,~0U,3,~0U,4,14,~0U,15,17,18,27,~0U,22,23,~0U,24,10,~0U,9,25,11,8,~0U,7
+        ,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U}
+      , {~0U,~0U,~0U,2,~0U,3,~0U,4,14,~0U,15,17,18,27,~0U,22,23,~0U,24,10,~0U,9,25,11,8,~0U,7
+        ,~0U,~0U,5,~0U,6,12,13,~0U,19,16,26,20,~0U,21}
+      };
+
+  /// @brief Compile time P1 / J8 connector pin to BCM2835 GPIO pin lookup
+  ///
+  /// For use when the board version is fixed at build time, for example to
+  /// provide a static_opin or static_ipin pin argument: the result for a
+  /// non-GPIO connector pin or unsupported version is an invalid pin id
+  /// value, rejected at compile time by those templates.
+  ///
+  /// @param[in] version    1 based board major version, as returned by
+  ///                       rpi_info::major_version.
+  /// @param[in] pin_number P1 / J8 connector pin number.
+  /// @return GPIO pin id value for pin_number on the board version.
+    constexpr pin_id_int_t p1_gpio_pin
+    ( std::size_t version
+    , pin_id_int_t pin_number
+    )
+    {
+      return version==0U || version>pinout_versions || pin_number>=p1_map_size
+              ? ~0U
+              : p1_gpio_pin_map[version-1U][pin_number];
+    }
 
   /// @brief Raspberry Pi P1 connector pin representation
   /// 
@@ -187,7 +215,29 @@ namespace dibase { namespace rpi {
   /// extra slot is required for the non-existent pin 0, which resolves to an
   /// invalid GPIO pin id value. All P5 pins for version 1 boards map to
   /// invalid pins as there is no P5 on version 1 boards.
-    extern pin_id_int_t const p5_gpio_pin_map[pinout_versions][p5_map_size];
+    constexpr pin_id_int_t p5_gpio_pin_map[pinout_versions][p5_map_size] =
+      { {~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U}
+      , {~0U,~0U,~0U, 28, 29, 30, 31,~0U,~0U}
+      , {~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U,~0U}
+      };
+
+  /// @brief Compile time P5 connector pin to BCM2835 GPIO pin lookup
+  ///
+  /// As \ref p1_gpio_pin but for the P5 connector.
+  ///
+  /// @param[in] version    1 based board major version, as returned by
+  ///                       rpi_info::major_version.
+  /// @param[in] pin_number P5 connector pin number.
+  /// @return GPIO pin id value for pin_number on the board version.
+    constexpr pin_id_int_t p5_gpio_pin
+    ( std::size_t version
+    , pin_id_int_t pin_number
+    )
+    {
+      return version==0U || version>pinout_versions || pin_number>=p5_map_size
+              ? ~0U
+              : p5_gpio_pin_map[version-1U][pin_number];
+    }
 
   /// @brief Raspberry Pi P5 connector pin representation
   /// 
@@ -0,0 +1,173 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pin_line_event.h
+/// @brief Timestamped, queued GPIO input pin edge events using the GPIO
+/// character device : class definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_PIN_LINE_EVENT_H
+# define DIBASE_RPI_PERIPHERALS_PIN_LINE_EVENT_H
+
+# include "pin_edge_event.h"
+# include "latency_histogram.h"
+# include <cstddef>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Record of a single edge event read from a pin_line_event.
+    struct edge_event_record
+    {
+    /// @brief Pin the edge occurred on.
+      pin_id                    pin{0U};
+
+    /// @brief Type of edge: pin_edge_event::rising or pin_edge_event::falling.
+      pin_edge_event::edge_mode edge{pin_edge_event::rising};
+
+    /// @brief Kernel time stamp of the edge, from CLOCK_MONOTONIC.
+      std::chrono::nanoseconds  timestamp{0};
+    };
+
+  /// @brief GPIO pin edge events via the GPIO character device.
+  ///
+  /// Alternative to \ref pin_edge_event using /dev/gpiochip0 line event
+  /// requests rather than the sys file system. The kernel time stamps each
+  /// edge as it occurs and queues it, so edges that occur while user space is
+  /// busy are not merged and each can be read with its edge type and time.
+  /// Queued events are read in batches with one system call.
+  ///
+  /// The GPIO line is requested as an input from the kernel for the lifetime
+  /// of the pin_line_event so it must not be open as an \ref ipin or other
+  /// sys file system exported pin, and vice versa.
+  ///
+  /// If the kernel queue overflows the oldest events are discarded. The
+  /// number of such discarded events observed from event sequence numbers is
+  /// available from lost().
+    class pin_line_event
+    {
+    friend class pin_edge_event_set;///< Can wait on many pin_line_events
+    friend class event_executor;///< Can wait asynchronously
+
+      int                   line_fd;  ///< Line request file descriptor
+      pin_id                id;       ///< Requested pin (GPIO line)
+      mutable std::uint32_t last_seqno;   ///< Last read line sequence number
+      mutable std::uint64_t lost_count;   ///< Sequence number gaps observed
+      latency_histogram *   latencies;    ///< Event latencies, may be null
+
+      std::size_t wait_
+      ( edge_event_record * events
+      , std::size_t max_events
+      , int timeout_ms
+      ) const;
+
+    public:
+    /// @brief Request a GPIO pin as an input with edge event reporting.
+    /// @param[in] pin  Pin to monitor for edge transitions.
+    /// @param[in] mode Which edge transition types raise events.
+    /// @param[in] queue_size Number of events the kernel queue can hold. 0
+    ///                 to use the kernel default.
+    /// @throws std::invalid_argument if \b mode is invalid.
+    /// @throws bad_peripheral_alloc if the pin's GPIO line is already in use
+    ///         (including being exported in the sys file system).
+    /// @throws std::system_error if the GPIO character device cannot be
+    ///         opened or the line request fails in some other way.
+      pin_line_event
+      ( pin_id pin
+      , pin_edge_event::edge_mode mode
+      , std::uint32_t queue_size = 0U
+      );
+
+      pin_line_event(pin_line_event const &) = delete;
+      pin_line_event& operator=(pin_line_event const &) = delete;
+      pin_line_event(pin_line_event &&) = delete;
+      pin_line_event& operator=(pin_line_event &&) = delete;
+
+    /// @brief Destroy, releasing the GPIO line.
+      ~pin_line_event();
+
+    /// @brief Returns the pin id of the monitored GPIO pin.
+      pin_id get_pin() const
+      {
+        return id;
+      }
+
+    /// @brief Check if any edge events are queued.
+    /// @returns true if one or more events are queued, false if not.
+    /// @throws std::system_error if any system function call returns failure.
+      bool signalled() const;
+
+    /// @brief Read queued edge events without waiting.
+    /// @param[out] events  Array of at least max_events records to fill.
+    /// @param[in] max_events  Maximum number of events to read.
+    /// @returns Number of events read into events, 0 if none were queued.
+    /// @throws std::system_error if any system function call returns failure.
+      std::size_t read(edge_event_record * events, std::size_t max_events) const;
+
+    /// @brief Wait for edge events then read those queued.
+    /// @param[out] events  Array of at least max_events records to fill.
+    /// @param[in] max_events  Maximum number of events to read.
+    /// @returns Number of events read into events.
+    /// @throws std::system_error if any system function call returns failure.
+      std::size_t wait(edge_event_record * events, std::size_t max_events) const
+      {
+        return wait_(events, max_events, -1);
+      }
+
+    /// @brief Wait for edge events for a given amount of time then read those
+    /// queued.
+    /// @tparam Rep       template parameter for std::chrono::duration -
+    ///                   see C++11 standard section 20.11.5.
+    /// @tparam Period    template parameter for std::chrono::duration -
+    ///                   see C++11 standard section 20.11.5.
+    /// @param[out] events  Array of at least max_events records to fill.
+    /// @param[in] max_events  Maximum number of events to read.
+    /// @param[in] rel_time   Amount of time to wait for edge events. Waits
+    ///                   are in whole milliseconds, rounded up.
+    /// @returns Number of events read into events, 0 if the call timed out.
+    /// @throws std::system_error if any system function call returns failure.
+      template <class Rep, class Period>
+      std::size_t wait_for
+      ( edge_event_record * events
+      , std::size_t max_events
+      , const std::chrono::duration<Rep, Period>& rel_time
+      ) const
+      {
+        using std::chrono::duration_cast;
+        using std::chrono::milliseconds;
+        auto t_ms(duration_cast<milliseconds>(rel_time));
+        if ( t_ms<rel_time )
+          {
+            t_ms += milliseconds{1};
+          }
+        return wait_( events, max_events
+                    , t_ms.count()<0 ? 0 : static_cast<int>(t_ms.count())
+                    );
+      }
+
+    /// @brief Returns number of events the kernel discarded due to queue
+    /// overflow, as detected from gaps in the events read so far.
+      std::uint64_t lost() const
+      {
+        return lost_count;
+      }
+
+    /// @brief Record the latency of each edge event read.
+    ///
+    /// Each event's latency, from the kernel's time stamp of the edge to
+    /// the event being read by read, wait or wait_for, is recorded in the
+    /// given histogram. This includes the time taken for the kernel to
+    /// handle the interrupt and wake the waiting thread and for that thread
+    /// to be scheduled, and for events queued while the thread was busy the
+    /// time they were queued.
+    /// @param[in] histogram  Histogram to record latencies in, or nullptr to
+    ///                       stop recording. Must remain valid while set.
+      void record_latencies(latency_histogram * histogram)
+      {
+        latencies = histogram;
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_PIN_LINE_EVENT_H
@@ -0,0 +1,170 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pulse_counter.h
+/// @brief DMA sampled high rate pulse counting on many GPIO pins : class
+/// definition
+///
+/// Waking a thread for each edge, as with \ref pin_edge_event, limits pulse
+/// counting to a few kilohertz. A pulse_counter instead has a DMA channel
+/// copy the GPIO pin level registers (GPLEV0, GPLEV1) into a ring buffer at a
+/// fixed rate paced by the PWM controller's DMA request signal, as for
+/// \ref waveform. A counting thread wakes a few times per buffer to count the
+/// edges in all new samples for all pins at once, so pulses at hundreds of
+/// kilohertz can be counted on many pins together.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_PULSE_COUNTER_H
+# define DIBASE_RPI_PERIPHERALS_PULSE_COUNTER_H
+
+# include "pin_group.h"
+# include "clockdefs.h"
+# include "spsc_ring.h"
+# include <array>
+# include <atomic>
+# include <exception>
+# include <memory>
+# include <thread>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      class gplev_sampler;
+    }
+
+  /// @brief Edge counts of one pulse_counter window.
+    struct pulse_count_window
+    {
+      std::uint64_t first_sample; ///< Number of window's first sample since
+                                  ///< the counter started, from 0
+      std::uint64_t start_us;     ///< Approximate system timer time of the
+                                  ///< window's first sample
+      std::array<std::uint32_t, pin_id::number_of_pins> counts;///< Edges
+                                  ///< counted on the nth pin of the group
+    };
+
+  /// @brief Counts edges on the pins of an ipin_group in fixed windows of
+  /// DMA taken samples.
+  ///
+  /// Pins are sampled at the sample rate and an edge is counted whenever a
+  /// pin's level differs from its previous sample, so pulses whose high and
+  /// low times are both longer than a sample period are counted exactly. A
+  /// sample rate of 1MHz counts 50% duty pulse trains of up to about 400kHz.
+  /// Windows are a whole number of samples, so window boundaries and lengths
+  /// are timed by the DMA rather than by the counting thread.
+  ///
+  /// Completed windows are pushed into a fixed capacity lock-free single
+  /// producer single consumer ring. One consumer thread pops windows in
+  /// batches. Two counts are kept: overruns are windows discarded because the
+  /// ring was full, and lost windows are windows discarded because the
+  /// counting thread was not scheduled before the DMA overwrote samples it
+  /// had not counted, after which counting resumes from the next new sample.
+  ///
+  /// Sampling requires the PWM controller, whose clock is set to pace the
+  /// samples, and a DMA channel, so while a pulse_counter exists no PWM pins,
+  /// waveform or other user of the PWM FIFO may be used.
+    class pulse_counter
+    {
+      ipin_group const &                      group;
+      unsigned                                edges;
+      std::size_t                             window_length;
+      std::unique_ptr<internal::gplev_sampler> sampler;
+      spsc_ring<pulse_count_window>           ring;
+      std::atomic<std::uint64_t>              overrun_count;
+      std::atomic<std::uint64_t>              lost_count;
+      std::atomic<bool>                       stopping;
+      std::atomic<bool>                       counter_failed;
+      std::exception_ptr                      counter_error;
+      std::thread                             counter;
+
+      void count_samples();
+
+    public:
+    /// @brief Counted edge type options.
+      enum edge_mode
+      { rising = 1  ///< Count low to high transitions
+      , falling = 2 ///< Count high to low transitions
+      , both = 3    ///< Count all transitions
+      };
+
+    /// @brief Value for cpu parameter meaning do not set counting thread's
+    /// CPU affinity.
+      static int const any_cpu = -1;
+
+    /// @brief Number of samples in the DMA ring buffer.
+      static std::size_t const buffer_samples = 16384U;
+
+    /// @brief Start sampling and counting.
+    /// @param[in] pins     Group of input pins to count edges on. Must outlive
+    ///                     the pulse_counter.
+    /// @param[in] edges    Which edge transition types are counted.
+    /// @param[in] rate     Requested sample rate, (0Hz, 1MHz]. The achieved
+    ///                     rate, see sample_rate(), is 10MHz divided by a
+    ///                     whole number.
+    /// @param[in] window_samples Samples per counting window. At least 1.
+    /// @param[in] capacity Number of windows the ring can hold. Must be a
+    ///                     power of two.
+    /// @param[in] cpu      CPU the counting thread is restricted to run on or
+    ///                     any_cpu.
+    /// @throws std::invalid_argument if edges is invalid, rate is out of
+    ///         range, window_samples is zero or capacity is not a power of
+    ///         two.
+    /// @throws peripheral_in_use if any PWM channel is in use.
+    /// @throws bad_peripheral_alloc if the PWM FIFO or a DMA channel are not
+    ///         available.
+    /// @throws std::system_error or std::bad_alloc if DMA memory cannot be
+    ///         obtained, or std::system_error if the counting thread cannot
+    ///         be created or its CPU affinity cannot be set.
+      pulse_counter
+      ( ipin_group const & pins
+      , edge_mode edges
+      , hertz rate
+      , std::size_t window_samples
+      , std::size_t capacity
+      , int cpu = any_cpu
+      );
+
+    /// @brief Stop sampling and counting and release resources.
+      ~pulse_counter();
+
+      pulse_counter(pulse_counter const &) = delete;
+      pulse_counter& operator=(pulse_counter const &) = delete;
+      pulse_counter(pulse_counter &&) = delete;
+      pulse_counter& operator=(pulse_counter &&) = delete;
+
+    /// @brief Pop available windows. Does not wait. Must only be called by
+    /// one thread at a time.
+    /// @param[out] windows Array of at least max_windows windows to fill.
+    /// @param[in] max_windows  Maximum number of windows to pop.
+    /// @returns Number of windows popped into windows.
+    /// @throws Exception thrown by the counting thread, once all windows it
+    ///         counted before failing have been popped.
+      std::size_t pop(pulse_count_window * windows, std::size_t max_windows);
+
+    /// @brief Returns achieved sample rate.
+      f_hertz sample_rate() const;
+
+    /// @brief Returns number of windows discarded because the ring was full.
+      std::uint64_t overruns() const
+      {
+        return overrun_count.load(std::memory_order_relaxed);
+      }
+
+    /// @brief Returns number of windows discarded because samples were
+    /// overwritten before being counted.
+      std::uint64_t lost_windows() const
+      {
+        return lost_count.load(std::memory_order_relaxed);
+      }
+
+    /// @brief Returns the ring capacity.
+      std::size_t capacity() const
+      {
+        return ring.capacity();
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_PULSE_COUNTER_H
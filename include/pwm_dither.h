@@ -0,0 +1,111 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_dither.h
+/// @brief Higher resolution PWM output by dithering between adjacent data
+/// values : class definition
+///
+/// A PWM channel's resolution is its range, so raising the PWM frequency
+/// to ease filtering costs resolution. A pwm_dither recovers it by playing
+/// a cycle of 2^fraction_bits data values through the PWM FIFO, each the
+/// whole part of the requested level or one more, so the filtered average
+/// has fraction_bits more bits of resolution. The cycle is played by a
+/// pwm_dma_stream whose halves each hold the whole cycle and are left to
+/// loop, so once started no CPU time is used until the level changes.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_PWM_DITHER_H
+# define DIBASE_RPI_PERIPHERALS_PWM_DITHER_H
+
+# include "pwm_dma_stream.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Dithered PWM output with sub-count resolution.
+  ///
+  /// The dither cycle repeats every 2^fraction_bits PWM range periods, which
+  /// sets the lowest ripple frequency the output filter must remove. A level
+  /// change rewrites the cycle in place, so the range periods of one cycle
+  /// may mix the old and new levels. As the halves are deliberately
+  /// replayed, the underlying stream's underrun count is not meaningful.
+  ///
+  /// The PWM FIFO is shared by both channels so only one pwm_dither,
+  /// pwm_stream, pwm_dma_stream or waveform may use it at a time. The pwm_pin
+  /// must outlive the pwm_dither.
+    class pwm_dither
+    {
+      pwm_dma_stream  stream;
+      unsigned        bits;
+      std::uint64_t   fine_level;
+      std::uint64_t   scale;
+
+    public:
+      constexpr static unsigned fraction_bits_default = 8U;
+      constexpr static unsigned fraction_bits_max = 12U;
+
+    /// @brief Switch the pin's channel to dithered FIFO output at level 0.
+    ///
+    /// The channel is stopped.
+    /// @param[in] p              pwm_pin whose channel is to be dithered.
+    ///                           Its range and output mode are used.
+    /// @param[in] fraction_bits  Extra bits of resolution [1,12].
+    /// @throws std::out_of_range if fraction_bits is not in range.
+    /// @throws As for pwm_dma_stream::pwm_dma_stream.
+      explicit pwm_dither
+      ( pwm_pin & p
+      , unsigned fraction_bits = fraction_bits_default
+      );
+
+    /// @brief Set the output level in fractional counts.
+    /// @param[in] level  Mean PWM clock cycles per range the output is high,
+    ///                   times 2^fraction_bits, in the range
+    ///                   [0, full_scale()].
+    /// @throws std::out_of_range if level is greater than full_scale().
+      void set_level(std::uint64_t level);
+
+    /// @brief Set the output level as a ratio of high to low output.
+    /// @param[in] r  Ratio value in the range [0.0,1.0]
+    /// @throws std::out_of_range if r is greater than one or less than zero
+      void set_ratio(double r);
+
+    /// @brief Returns the output level in fractional counts.
+      std::uint64_t get_level() const
+      {
+        return fine_level;
+      }
+
+    /// @brief Returns the level for always high output: the pwm_pin's range
+    /// times 2^fraction_bits.
+      std::uint64_t full_scale() const
+      {
+        return scale;
+      }
+
+    /// @brief Returns the number of extra bits of resolution.
+      unsigned fraction_bits() const
+      {
+        return bits;
+      }
+
+    /// @brief Start output, enabling the PWM channel.
+      void start()
+      {
+        stream.start();
+      }
+
+    /// @brief Stop output and disable the PWM channel.
+      void stop()
+      {
+        stream.stop();
+      }
+
+    /// @brief Query whether output is running.
+      bool is_running() const
+      {
+        return stream.is_running();
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_PWM_DITHER_H
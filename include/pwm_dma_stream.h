@@ -0,0 +1,132 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_dma_stream.h
+/// @brief Continuous DMA fed PWM output from a ping-pong sample buffer :
+/// class definition
+///
+/// A pwm_dma_stream plays a sample buffer split into two halves to a PWM
+/// channel through the PWM FIFO using a DMA channel paced by the PWM DREQ.
+/// The DMA control blocks loop, so once started output runs continuously
+/// without CPU involvement while software refills whichever half has just
+/// been played. This suits audio rate waveforms that are too fast to feed
+/// reliably by polling the FIFO.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_PWM_DMA_STREAM_H
+# define DIBASE_RPI_PERIPHERALS_PWM_DMA_STREAM_H
+
+# include "pwm_stream.h"
+# include <memory>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      class dma_arena;
+    }
+
+  /// @brief Stream a ping-pong sample buffer to a pwm_pin's channel by DMA.
+  ///
+  /// Samples are 32-bit words used as by \ref pwm_stream. The buffer halves
+  /// are in memory obtained from the VideoCore, so writes to them are seen
+  /// by the DMA controller without cache maintenance. Fill both halves
+  /// before start(), then repeatedly obtain the idle half with
+  /// poll_idle_half() or wait_idle_half() and refill it before the other
+  /// half finishes playing. If both halves have played since a half was last
+  /// obtained, stale samples were replayed and an underrun is counted.
+  ///
+  /// The PWM FIFO is shared by both channels so only one pwm_stream,
+  /// pwm_dma_stream or waveform may use it at a time. The pwm_pin must
+  /// outlive the pwm_dma_stream.
+    class pwm_dma_stream
+    {
+      pwm_pin &                             pin;
+      std::size_t                           half_words;
+      std::unique_ptr<internal::dma_arena>  memory;
+      std::uint32_t                         first_bus;
+      std::uint32_t *                       halves[2];
+      std::uint32_t volatile *              done;
+      std::size_t                           dma_channel;
+      unsigned                              next_half;
+      std::uint64_t                         underrun_count;
+      wait_policy const                     waiting;
+      wait_stats                            wait_counts;
+
+    public:
+    /// @brief Switch the pin's channel to FIFO use, reserve a DMA channel
+    /// and compile the sample ring.
+    ///
+    /// @param[in] p          pwm_pin whose channel is to be streamed to.
+    /// @param[in] mode       PWM or serialiser output.
+    /// @param[in] half_size  Number of samples in each buffer half.
+    /// @param[in] policy     How wait_idle_half waits.
+    /// @throws std::invalid_argument if half_size is zero or too large.
+    /// @throws bad_peripheral_alloc if the PWM FIFO is in use or no DMA
+    ///         channel is available.
+    /// @throws std::system_error or std::bad_alloc if DMA memory cannot be
+    ///         obtained.
+      pwm_dma_stream
+      ( pwm_pin & p
+      , pwm_stream_mode mode
+      , std::size_t half_size
+      , wait_policy const & policy = wait_policy{}
+      );
+
+    /// @brief Destroy: stop output, release DMA resources and return the
+    /// channel to non-FIFO PWM operation.
+      ~pwm_dma_stream();
+
+      pwm_dma_stream(pwm_dma_stream const &) = delete;
+      pwm_dma_stream& operator=(pwm_dma_stream const &) = delete;
+      pwm_dma_stream(pwm_dma_stream &&) = delete;
+      pwm_dma_stream& operator=(pwm_dma_stream &&) = delete;
+
+    /// @brief Returns the number of samples in each buffer half.
+      std::size_t half_size() const
+      {
+        return half_words;
+      }
+
+    /// @brief Returns a buffer half, for filling before start().
+    /// @param[in] idx  Half index, 0 (played first) or 1.
+    /// @throws std::out_of_range if idx is not 0 or 1.
+      std::uint32_t * half(unsigned idx);
+
+    /// @brief Start continuous output from the start of half 0, enabling the
+    /// PWM channel.
+      void start();
+
+    /// @brief Stop output and disable the PWM channel.
+      void stop();
+
+    /// @brief Query whether output is running.
+      bool is_running() const;
+
+    /// @brief Obtain the next half to refill if it has been played. Does not
+    /// wait.
+    /// @returns The half to refill, or \c nullptr if it is still playing.
+      std::uint32_t * poll_idle_half();
+
+    /// @brief Wait for the next half to refill to be played.
+    /// @returns The half to refill.
+    /// @throws std::logic_error if output is not running.
+      std::uint32_t * wait_idle_half();
+
+    /// @brief Returns number of times a half was replayed before being
+    /// refilled.
+      std::uint64_t underruns() const
+      {
+        return underrun_count;
+      }
+
+    /// @brief Returns counts of how wait_idle_half waits were satisfied.
+      wait_stats const & wait_statistics() const
+      {
+        return wait_counts;
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_PWM_DMA_STREAM_H
@@ -0,0 +1,57 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_pair.h
+/// @brief Update both PWM channels together : class definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_PWM_PAIR_H
+# define DIBASE_RPI_PERIPHERALS_PWM_PAIR_H
+
+# include "pwm_pin.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Control the two PWM channels' pwm_pins as a pair.
+  ///
+  /// Both channels are started and stopped with a single control register
+  /// write so their PWM cycles stay in step, and both channels' data
+  /// registers are written back to back so an update applies to both within
+  /// the same PWM cycle, barring the update straddling a cycle boundary.
+  ///
+  /// The pwm_pins must outlive the pwm_pair.
+    class pwm_pair
+    {
+      pwm_pin &   first_pin;
+      pwm_pin &   second_pin;
+
+    public:
+    /// @brief Construct from pwm_pins for each PWM channel.
+    /// @param[in] first  pwm_pin for one PWM channel.
+    /// @param[in] second pwm_pin for the other PWM channel.
+    /// @throws std::invalid_argument if first and second use the same PWM
+    ///         channel.
+      pwm_pair(pwm_pin & first, pwm_pin & second);
+
+      pwm_pair(pwm_pair const &) = delete;
+      pwm_pair& operator=(pwm_pair const &) = delete;
+
+    /// @brief Start both PWM channels running together.
+      void start() const;
+
+    /// @brief Stop both PWM channels running together.
+      void stop() const;
+
+    /// @brief Set both pins' PWM output high counts.
+    /// @param[in] first_counts   High count for the first pin, in the range
+    ///                           [0, first.get_range()].
+    /// @param[in] second_counts  High count for the second pin, in the range
+    ///                           [0, second.get_range()].
+    /// @throws std::out_of_range if either count is greater than its pin's
+    ///         range. Neither channel is updated.
+      void set_data_counts(unsigned first_counts, unsigned second_counts);
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_PWM_PAIR_H
@@ -9,6 +9,8 @@
 # define DIBASE_RPI_PERIPHERALS_PWM_PIN_H
 # include "pin_id.h"
 # include "clockdefs.h"
+# include "static_clock_parameters.h"
+# include "io_counters.h"
 
 namespace dibase { namespace rpi {
   namespace peripherals
@@ -48,6 +50,14 @@ namespace dibase { namespace rpi {
     typedef pwm_ratio<unsigned, std::milli> pwm_thousandths;///< Quantities in 1/1000ths
     typedef pwm_ratio<unsigned, std::micro> pwm_millionths; ///< Quantities in 1/1000000ths
 
+  /// @brief How a PWM channel distributes its high output over a range.
+    enum class pwm_output_mode
+    { balanced    ///< PWM algorithm: high clock cycles spread evenly over
+                  ///< the range, giving the highest output frequency
+    , mark_space  ///< M/S: one high pulse of data cycles then low for the
+                  ///< remainder of the range
+    };
+
   /// @brief Use a GPIO pin for pulse width modulation
   ///
   /// The output from PWM channels 1 and 2 may be output to GPIO pins as
@@ -66,14 +76,28 @@ namespace dibase { namespace rpi {
   /// channel is in use externally by other processes.
   ///
   /// Once constructed the PWM channel can be started and stopped and the 
-  /// high-to-low output ratio modified.
+  /// high-to-low output ratio modified. The output may be balanced, which
+  /// is easiest to filter to an analogue level, or mark-space, which gives
+  /// one pulse per range as needed to drive servos and motor controllers,
+  /// and may be inverted.
   ///
   /// All (well, both) PWM channels share a common clock, which may be set to
   /// a specific clock source and output frequency when _no_ PWM channels are
   /// allocated (e. g. before any pwm_pin objects are created).
+  ///
+  /// Construction and setting the clock access the GPIO or clock manager
+  /// peripherals as well as the PWM peripheral and use peripheral_barrier()
+  /// around those accesses. Starting, stopping and updating the output only
+  /// access the PWM peripheral and are barrier free.
   ///
     class pwm_pin
     {
+    friend class pwm_stream;
+    friend class pwm_dma_stream;
+    friend class ws2812_strip;
+    friend class pwm_pair;
+    friend class start_group;
+
       static void do_set_clock
       ( hertz src_freq
       , clock_source src_type
@@ -85,9 +109,14 @@ namespace dibase { namespace rpi {
       static hertz    freq_min;
       static hertz    freq_avg;
       static hertz    freq_max;
+      constexpr static unsigned no_channel = ~0U; ///< pwm value if moved from
+
       unsigned        pwm;
-      pin_id const    pin;
-      unsigned const  range;
+      pin_id          pin;
+      unsigned        range;
+      io_counter_set  counters;
+
+      void release();
 
     public:
       constexpr static unsigned range_default = 2400U;///< Default range
@@ -117,6 +146,17 @@ namespace dibase { namespace rpi {
         do_set_clock(src.frequency(), src.source(), freq);
       }
 
+    /// @brief Static class-operation: set common PWM clock from compile time
+    /// clock parameters
+    ///
+    /// As for the clock source and frequency overload except that the clock
+    /// parameters were calculated and checked at compile time, so setting
+    /// the clock consists only of the clock register writes.
+    /// @param[in] s      Value of a static_clock_parameters instantiation.
+    /// @throws peripheral_in_use if any PWM channel is in use (that is any
+    ///         pwm_pin objects exist) at the time of the call.
+      static void set_clock(static_clock_settings const & s);
+
     /// @brief Return current calculated PWM clock minimum frequency
     /// @returns Calculated clock minimum frequency in Hertz
       static hertz clock_frequency_min() { return freq_min; }
@@ -142,6 +182,7 @@ namespace dibase { namespace rpi {
     /// with a high-to-low ratio of 0 (i.e. output is always low).
     /// @param[in] p      Id of GPIO pin to use for PWM
     /// @param[in] range  PWM range value: at least pwm_pin::range_minimum.
+    /// @param[in] mode   Output mode. Defaults to pwm_output_mode::balanced.
     /// @throws std::invalid_argument if the requested pin has no PWM function
     /// @throws std::out_of_range if \b range is less than pwm_pin::range_minimum.
     /// @throws std::range_error if the pin supports more than one PWM function
@@ -149,15 +190,26 @@ namespace dibase { namespace rpi {
     ///         which should be possible).
     /// @throws bad_peripheral_alloc if either the pin or the PWM channel
     ///         related to the pin are already in use.
-      explicit pwm_pin(pin_id p, unsigned range=range_default);
+      explicit pwm_pin
+      ( pin_id p
+      , unsigned range=range_default
+      , pwm_output_mode mode=pwm_output_mode::balanced
+      );
 
     /// @brief Destroy: stop the PWM channel and de-allocate channel & GPIO pin.
       ~pwm_pin();
 
       pwm_pin(pwm_pin const &) = delete;
       pwm_pin& operator=(pwm_pin const &) = delete;
-      pwm_pin(pwm_pin &&) = delete;
-      pwm_pin& operator=(pwm_pin &&) = delete;
+
+    /// @brief Move construct, taking over other's PWM channel and GPIO pin.
+    ///
+    /// other is left owning nothing: it may only be destroyed or assigned to.
+      pwm_pin(pwm_pin && other) noexcept;
+
+    /// @brief Move assign: stop and release any channel and pin owned by this
+    /// object then take over other's.
+      pwm_pin& operator=(pwm_pin && other);
 
     /// @brief Start PWM channel running (enable channel)
       void start() const;
@@ -169,6 +221,22 @@ namespace dibase { namespace rpi {
     /// @returns true if PWM channel is running (enabled), false if not.
       bool is_running() const;
 
+    /// @brief Set the output mode: balanced or mark-space.
+    ///
+    /// Takes effect from the next range cycle; the ratio is unchanged.
+    /// @param[in] mode   Output mode.
+      void set_output_mode(pwm_output_mode mode);
+
+    /// @brief Returns the output mode.
+      pwm_output_mode output_mode() const;
+
+    /// @brief Set whether output is inverted: low for data cycles per range.
+    /// @param[in] inverted true to invert the output, false for normal.
+      void set_polarity_inverted(bool inverted);
+
+    /// @brief Returns true if output is inverted.
+      bool is_polarity_inverted() const;
+
     /// @brief Set the PWM ratio of high to low output.
     /// @param[in] r  Ratio value in the range [0.0,1.0]
     /// @throws std::out_of_range if r is greater than one or less than zero
@@ -186,6 +254,46 @@ namespace dibase { namespace rpi {
     /// @throws std::out_of_range if r is greater than one or less than zero
       template<typename C, typename R>
       void set_ratio(pwm_ratio<C,R> r);
+
+    /// @brief Set the PWM output high count directly.
+    ///
+    /// Avoids the floating point or ratio arithmetic of set_ratio for fast
+    /// control loops that work in counts of the range.
+    /// @param[in] counts PWM clock cycles per range the output is high, in
+    ///                   the range [0, get_range()].
+    /// @throws std::out_of_range if counts is greater than get_range().
+      void set_data_counts(unsigned counts)
+      {
+        if (counts>range)
+          {
+            throw std::out_of_range{"pwm_pin::set_data_counts: counts "
+                                    "parameter value is greater than range."
+                                   };
+          }
+        set_data(counts);
+      }
+
+    /// @brief Returns the PWM range: clock cycles per PWM output cycle.
+      unsigned get_range() const
+      {
+        return range;
+      }
+
+    /// @brief Returns a snapshot of the performance counters.
+    ///
+    /// Counts updates of the output high count made by set_ratio and
+    /// set_data_counts. All counts are zero unless counting is enabled - see
+    /// io_counters.h.
+      io_counters counter_snapshot() const
+      {
+        return counters.snapshot();
+      }
+
+    /// @brief Reset the performance counters to zero.
+      void reset_counters()
+      {
+        counters.reset();
+      }
     };
     
     template<typename C, typename R>
@@ -0,0 +1,156 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_profile.h
+/// @brief Precomputed PWM duty sequences for smooth motor control : class
+/// definition
+///
+/// Ramping a motor's speed by calling pwm_pin::set_ratio then sleeping
+/// between steps gives coarse steps with scheduling jitter, and floating
+/// point work on each step. A pwm_profile calculates a whole sequence of PWM
+/// high counts up front, built from trapezoidal (constant acceleration) or
+/// S-curve (jerk limited) ramps and constant holds, so playing it is one
+/// register or FIFO write per step at a fixed update rate:
+///   - play() writes each step to a pwm_pin's data register on the deadlines
+///     of a periodic_timer, suiting update rates of a few kHz.
+///   - expand() writes the steps, each repeated for a number of PWM cycles,
+///     as FIFO words for a pwm_stream or a pwm_dma_stream buffer half, so
+///     the PWM hardware paces the updates with no CPU timing at all.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_PWM_PROFILE_H
+# define DIBASE_RPI_PERIPHERALS_PWM_PROFILE_H
+
+# include "pwm_pin.h"
+# include <chrono>
+# include <cstdint>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Shape of a pwm_profile ramp.
+    enum class pwm_profile_shape
+    { trapezoidal ///< Linear ramp: constant acceleration
+    , s_curve     ///< Raised cosine ramp: acceleration rises and falls
+                  ///< smoothly from and to zero
+    };
+
+  /// @brief Sequence of PWM high counts for a given PWM range.
+    class pwm_profile
+    {
+      unsigned                    pwm_range;
+      std::vector<std::uint32_t>  steps;
+
+      std::uint32_t to_counts(double ratio) const;
+
+    public:
+    /// @brief Construct an empty profile.
+    /// @param[in] range  PWM range of the pwm_pin the profile is for.
+    /// @throws std::invalid_argument if range is less than
+    ///         pwm_pin::range_minimum.
+      explicit pwm_profile(unsigned range);
+
+    /// @brief Construct a profile that ramps up from 0, holds then ramps
+    /// down to 0.
+    /// @param[in] range      PWM range of the pwm_pin the profile is for.
+    /// @param[in] peak       High to low ratio to ramp to [0.0,1.0].
+    /// @param[in] ramp_steps Number of steps in each ramp.
+    /// @param[in] hold_steps Number of steps to hold the peak ratio for.
+    /// @param[in] shape      Shape of the ramps.
+    /// @throws std::invalid_argument if range is less than
+    ///         pwm_pin::range_minimum.
+    /// @throws std::out_of_range if peak is outside [0.0,1.0].
+      pwm_profile
+      ( unsigned range
+      , double peak
+      , std::size_t ramp_steps
+      , std::size_t hold_steps
+      , pwm_profile_shape shape = pwm_profile_shape::s_curve
+      );
+
+    /// @brief Append a ramp between two high to low ratios.
+    ///
+    /// The ramp's first step is one step on from \c from, its last step is
+    /// \c to, so ramps and holds can be chained without repeated steps.
+    /// @param[in] from   Ratio the ramp starts from [0.0,1.0].
+    /// @param[in] to     Ratio the ramp ends at [0.0,1.0].
+    /// @param[in] count  Number of steps in the ramp.
+    /// @param[in] shape  Shape of the ramp.
+    /// @returns *this.
+    /// @throws std::out_of_range if from or to are outside [0.0,1.0].
+      pwm_profile & ramp
+      ( double from
+      , double to
+      , std::size_t count
+      , pwm_profile_shape shape = pwm_profile_shape::s_curve
+      );
+
+    /// @brief Append steps of a constant high to low ratio.
+    /// @param[in] ratio  Ratio to hold [0.0,1.0].
+    /// @param[in] count  Number of steps.
+    /// @returns *this.
+    /// @throws std::out_of_range if ratio is outside [0.0,1.0].
+      pwm_profile & hold(double ratio, std::size_t count);
+
+    /// @brief Returns the PWM range the profile is for.
+      unsigned range() const
+      {
+        return pwm_range;
+      }
+
+    /// @brief Returns the number of steps.
+      std::size_t size() const
+      {
+        return steps.size();
+      }
+
+    /// @brief Returns the high counts of the steps.
+      std::vector<std::uint32_t> const & counts() const
+      {
+        return steps;
+      }
+
+    /// @brief Write the profile's steps to a pwm_pin, one per period.
+    ///
+    /// Each step is written on a deadline of a periodic_timer, the first one
+    /// period after the call, so steps are evenly spaced whatever the delay
+    /// in waking for each. Steps whose deadlines have passed before they are
+    /// written are skipped to stay on time, but the last step is always
+    /// written.
+    /// @param[in] pin    pwm_pin to write to. Should be running.
+    /// @param[in] period Time between steps. Must be greater than zero.
+    /// @returns Number of steps skipped.
+    /// @throws std::invalid_argument if the pin's range is not the profile's
+    ///         range or period is not greater than zero.
+    /// @throws std::system_error if the timer cannot be created or waited on.
+      std::size_t play(pwm_pin & pin, std::chrono::nanoseconds period) const;
+
+    /// @brief Write the profile's steps as PWM FIFO words.
+    ///
+    /// Each step becomes cycles_per_step words, one per PWM output cycle,
+    /// for a pwm_stream or pwm_dma_stream in pwm_stream_mode::pwm. Once the
+    /// profile is exhausted the remaining words are set to the last step's
+    /// count, so a DMA buffer half can always be filled completely.
+    /// @param[out]   words           Buffer for count FIFO words.
+    /// @param[in]    count           Number of words to write.
+    /// @param[inout] position        Position in the profile in words, 0 to
+    ///                               start from the beginning. Advanced by
+    ///                               the number of words taken from the
+    ///                               profile.
+    /// @param[in]    cycles_per_step PWM cycles each step lasts for:
+    ///                               PWM frequency / update rate.
+    /// @returns The number of words taken from the profile: less than count
+    ///          if the profile was exhausted.
+    /// @throws std::invalid_argument if cycles_per_step is 0 or the profile
+    ///         is empty.
+      std::size_t expand
+      ( std::uint32_t * words
+      , std::size_t count
+      , std::size_t & position
+      , unsigned cycles_per_step
+      ) const;
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_PWM_PROFILE_H
@@ -0,0 +1,122 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_stream.h
+/// @brief Stream words through the PWM FIFO from a feeder thread :
+/// class definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_PWM_STREAM_H
+# define DIBASE_RPI_PERIPHERALS_PWM_STREAM_H
+
+# include "pwm_pin.h"
+# include "spsc_ring.h"
+# include "wait_policy.h"
+# include <atomic>
+# include <exception>
+# include <thread>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief How words streamed to a PWM channel are output.
+    enum class pwm_stream_mode
+    { pwm         ///< Each word is a PWM data value in the range [0, range]
+    , serialiser  ///< Each word's bits are shifted out, most significant
+                  ///< first, range bits per word
+    };
+
+  /// @brief Stream 32-bit words to a pwm_pin's channel through the PWM FIFO.
+  ///
+  /// A pwm_stream switches its pwm_pin's channel to use the PWM FIFO in PWM
+  /// or serialiser mode and owns a feeder thread that keeps the FIFO topped
+  /// up from a fixed capacity lock-free ring. One producer thread writes
+  /// words to the ring in batches. Each word is used for one period of range
+  /// PWM clock cycles, so the word rate is the PWM clock frequency divided by
+  /// the pwm_pin's range.
+  ///
+  /// If the FIFO runs empty while the channel is running the channel outputs
+  /// silence, or repeats the last word if so requested, and the event is
+  /// counted as an underrun.
+  ///
+  /// The FIFO is shared by both PWM channels so only one pwm_stream may
+  /// exist at a time. The pwm_pin must outlive the pwm_stream and should only
+  /// be started, stopped and queried while the stream exists.
+    class pwm_stream
+    {
+      pwm_pin &                   pin;
+      spsc_ring<std::uint32_t>    ring;
+      wait_policy const           waiting;
+      std::atomic<std::uint64_t>  underrun_count;
+      std::atomic<bool>           stopping;
+      std::atomic<bool>           feeder_failed;
+      std::exception_ptr          feeder_error;
+      std::thread                 feeder;
+
+      void feed();
+
+    public:
+    /// @brief Switch the pin's channel to FIFO use and start the feeder
+    /// thread.
+    ///
+    /// The channel is stopped. Start it with pwm_pin::start once enough words
+    /// have been written to avoid initial underruns.
+    ///
+    /// @param[in] p        pwm_pin whose channel is to be streamed to.
+    /// @param[in] mode     PWM or serialiser output.
+    /// @param[in] capacity Number of words the ring can hold. Must be a power
+    ///                     of two.
+    /// @param[in] repeat_last  Repeat the last word if the FIFO runs empty
+    ///                     rather than output silence.
+    /// @param[in] policy   How the feeder thread waits for FIFO space.
+    /// @throws std::invalid_argument if capacity is not a power of two.
+    /// @throws bad_peripheral_alloc if another pwm_stream is using the FIFO.
+    /// @throws std::system_error if the feeder thread cannot be created.
+      pwm_stream
+      ( pwm_pin & p
+      , pwm_stream_mode mode
+      , std::size_t capacity
+      , bool repeat_last = false
+      , wait_policy const & policy = wait_policy{}
+      );
+
+    /// @brief Destroy: stop the channel and the feeder thread and return the
+    /// channel to non-FIFO PWM operation.
+      ~pwm_stream();
+
+      pwm_stream(pwm_stream const &) = delete;
+      pwm_stream& operator=(pwm_stream const &) = delete;
+      pwm_stream(pwm_stream &&) = delete;
+      pwm_stream& operator=(pwm_stream &&) = delete;
+
+    /// @brief Queue words for output. Does not wait. Must only be called by
+    /// one thread at a time.
+    /// @param[in] words  Words to queue.
+    /// @param[in] count  Number of words to queue.
+    /// @returns Number of words queued, less than count if the ring filled.
+    /// @throws Exception thrown by the feeder thread if it failed.
+      std::size_t write(std::uint32_t const * words, std::size_t count);
+
+    /// @brief Returns approximate number of words queued in the ring and not
+    /// yet moved to the FIFO.
+      std::size_t pending() const
+      {
+        return ring.size();
+      }
+
+    /// @brief Returns number of times the FIFO was found to have been read
+    /// while empty.
+      std::uint64_t underruns() const
+      {
+        return underrun_count.load(std::memory_order_relaxed);
+      }
+
+    /// @brief Returns the ring capacity.
+      std::size_t capacity() const
+      {
+        return ring.capacity();
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_PWM_STREAM_H
@@ -0,0 +1,141 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file quadrature_decoder.h
+/// @brief Decode many quadrature (rotary) encoders from GPIO level snapshots
+/// or edge events : class definition
+///
+/// Decoding an encoder by polling ipin::get for each channel, or waiting on
+/// a pin_edge_event per channel, costs a register read or a thread wake up
+/// per channel per step and misses counts at speed. A quadrature_decoder
+/// decodes any number of encoders from one GPLEV0, GPLEV1 snapshot per tick
+/// - either read by sample() or taken by DMA, as by a pulse_counter - or
+/// from batches of edge events popped from an edge_event_stream.
+///
+/// Each encoder's A and B channel levels form a 2-bit state. A 16 entry
+/// table indexed by the previous and new states gives the step: +1, -1, 0
+/// for no change or illegal for a transition changing both channels, which
+/// means a step was missed. Every edge on either channel is counted (x4
+/// decoding), position increasing when channel A leads channel B.
+///
+/// One thread decodes while any number of other threads read positions,
+/// velocities and illegal transition counts without locking.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_QUADRATURE_DECODER_H
+# define DIBASE_RPI_PERIPHERALS_QUADRATURE_DECODER_H
+
+# include "pin_line_event.h"
+# include <atomic>
+# include <cstdint>
+# include <memory>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief GPIO pins of one quadrature encoder's channels.
+    struct quadrature_channels
+    {
+      pin_id  a;  ///< Channel A pin
+      pin_id  b;  ///< Channel B pin
+    };
+
+  /// @brief Table driven decoder of several quadrature encoders.
+    class quadrature_decoder
+    {
+      struct encoder
+      {
+        unsigned                    a_bank;   ///< GPLEVn of channel A
+        unsigned                    a_shift;  ///< Bit of channel A in a_bank
+        unsigned                    b_bank;   ///< GPLEVn of channel B
+        unsigned                    b_shift;  ///< Bit of channel B in b_bank
+        unsigned                    state;    ///< Last (A<<1)|B levels
+        std::int64_t                latched;  ///< Position at last latch
+        std::atomic<std::int64_t>   position; ///< Steps counted
+        std::atomic<std::int64_t>   velocity; ///< Steps in last interval
+        std::atomic<std::uint64_t>  illegal;  ///< Illegal transitions
+      };
+
+      std::unique_ptr<encoder[]>  encoders;
+      std::size_t                 encoder_count;
+      std::int16_t                pin_map[pin_id::number_of_pins];
+      std::uint32_t               bank_masks[2];
+
+      void step(encoder & e, unsigned state);
+
+    public:
+    /// @brief Construct for a set of encoders.
+    ///
+    /// Encoders start in state A=0, B=0 at position 0. Use start to set
+    /// their initial levels.
+    /// @param[in] channels Pins of each encoder. Encoder n is channels[n].
+    ///                     The pins must be opened for input elsewhere, for
+    ///                     example as an ipin_group or pin_line_events.
+    /// @throws std::invalid_argument if channels is empty or any pin is used
+    ///         more than once.
+      explicit quadrature_decoder
+      ( std::vector<quadrature_channels> const & channels
+      );
+
+      quadrature_decoder(quadrature_decoder const &) = delete;
+      quadrature_decoder& operator=(quadrature_decoder const &) = delete;
+
+    /// @brief Set all encoders' levels from a snapshot without counting.
+    /// @param[in] levels GPLEV0, GPLEV1 values.
+      void start(std::uint32_t const volatile * levels);
+
+    /// @brief Decode one snapshot of all encoders' levels.
+    /// @param[in] levels GPLEV0, GPLEV1 values, as in gplev_sampler samples.
+      void add(std::uint32_t const volatile * levels);
+
+    /// @brief Read the GPIO level registers used by the encoders and decode
+    /// them: one tick.
+      void sample();
+
+    /// @brief Decode a batch of edge events.
+    ///
+    /// Each event sets the level of its pin as of the edge. Events on pins
+    /// of no encoder are ignored.
+    /// @param[in] events Events, in the order they occurred.
+    /// @param[in] count  Number of events.
+      void add(edge_event_record const * events, std::size_t count);
+
+    /// @brief Latch each encoder's steps since the previous call as its
+    /// velocity. Call at a fixed interval to measure steps per interval.
+      void latch_velocities();
+
+    /// @brief Returns the number of encoders.
+      std::size_t size() const
+      {
+        return encoder_count;
+      }
+
+    /// @brief Returns an encoder's position, in steps from its start.
+    /// May be called from any thread.
+    /// @param[in] n  Encoder index. Not range checked.
+      std::int64_t position(std::size_t n) const
+      {
+        return encoders[n].position.load(std::memory_order_relaxed);
+      }
+
+    /// @brief Returns an encoder's steps in the last latch_velocities
+    /// interval. May be called from any thread.
+    /// @param[in] n  Encoder index. Not range checked.
+      std::int64_t velocity(std::size_t n) const
+      {
+        return encoders[n].velocity.load(std::memory_order_relaxed);
+      }
+
+    /// @brief Returns an encoder's count of illegal transitions, in which
+    /// both channels changed so a step was missed. May be called from any
+    /// thread.
+    /// @param[in] n  Encoder index. Not range checked.
+      std::uint64_t illegal_transitions(std::size_t n) const
+      {
+        return encoders[n].illegal.load(std::memory_order_relaxed);
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_QUADRATURE_DECODER_H
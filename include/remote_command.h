@@ -0,0 +1,321 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file remote_command.h
+/// @brief Batched binary command frames for remote GPIO pin group, SPI0 and
+/// I2C access over TCP : type, class and function definitions.
+///
+/// Driving pins from another machine with one network round trip per
+/// operation limits throughput to the round trip rate. Instead a
+/// remote_batch collects a script of operations - pin group puts and gets,
+/// SPI0 transfers, I2C transactions and delays - into one command frame. A
+/// remote_client sends the frame to a remote_server running on the Pi
+/// which performs the whole script and returns all the results in one
+/// response frame.
+///
+/// Frames are little endian regardless of host byte order:
+///
+///   frame   : magic "DBRC", u16 version (1), u16 item count,
+///             u32 number of item bytes, then the items
+///   command : u8 remote_op, u8 target, u16 tx_count, u16 rx_count,
+///             u16 zero, u32 argument, then tx_count bytes
+///   result  : u8 remote_outcome, u8 zero, u16 count, i32 status,
+///             then count bytes
+///
+/// The server performs commands in order. If a command fails, e.g. an
+/// operation throws, the remaining commands are not performed. If the
+/// results of all the commands might not fit in one response frame none are
+/// performed: every command is rejected.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_REMOTE_COMMAND_H
+# define DIBASE_RPI_PERIPHERALS_REMOTE_COMMAND_H
+
+# include "pin_group.h"
+# include "spi0_pins.h"
+# include "i2c_pins.h"
+# include <atomic>
+# include <chrono>
+# include <cstddef>
+# include <cstdint>
+# include <thread>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Operation of a remote command.
+    enum class remote_op : std::uint8_t
+    { group_put = 1       ///< Put values to an output group: tx mask, values
+    , group_get         ///< Get an input group's value: 8 result bytes
+    , spi0_transfer     ///< Full-duplex SPI0 transfer to a slave context
+    , i2c_write         ///< I2C write to address argument
+    , i2c_read          ///< I2C read from address argument
+    , i2c_write_then_read ///< I2C combined write then read
+    , delay             ///< Wait argument microseconds
+    };
+
+  /// @brief Outcome of a remote command.
+    enum class remote_outcome : std::uint8_t
+    { done          ///< Performed; the status and bytes are its results
+    , rejected      ///< Not performed: bad target or byte counts
+    , failed        ///< Operation threw: bytes are the exception message
+    , skipped       ///< Not performed as an earlier command failed
+    };
+
+  /// @brief Sizes and limits of the remote command frame format.
+    struct remote_frame
+    {
+      constexpr static std::size_t header_size = 12U;
+      constexpr static std::size_t command_header_size = 12U;
+      constexpr static std::size_t result_header_size = 8U;
+
+    /// @brief Maximum number of item bytes in a frame.
+      constexpr static std::size_t max_payload = 65536U;
+
+    /// @brief Maximum number of commands in a batch.
+      constexpr static std::size_t max_commands = 1024U;
+
+    /// @brief Longest delay command, in microseconds. Longer waits need
+    /// several delay commands.
+      constexpr static std::uint32_t max_delay_us = 1000000U;
+
+      constexpr static std::uint16_t version = 1U;
+    };
+
+  /// @brief Builds a command frame of a script of operations.
+  ///
+  /// Functions adding commands return *this so calls may be chained. A
+  /// command is only added if the frame, and the largest response frame
+  /// its commands could produce, stay within remote_frame::max_payload
+  /// item bytes.
+    class remote_batch
+    {
+      std::vector<std::uint8_t> frame;
+      std::size_t               commands;
+      std::size_t               reply_bytes; ///< Most response item bytes
+
+      void add
+      ( remote_op op
+      , unsigned target
+      , std::uint8_t const * ptx
+      , std::size_t tx_count
+      , std::size_t rx_count
+      , std::uint32_t arg
+      );
+
+    public:
+    /// @brief Construct an empty batch.
+      remote_batch();
+
+    /// @brief Put values to the pins of an output pin group selected by
+    /// mask, as opin_group::put.
+    /// @param[in] group  Index of output group registered with the server.
+    /// @throws std::length_error if the batch is full.
+      remote_batch & group_put
+      ( unsigned group
+      , pin_group_value_t mask
+      , pin_group_value_t values
+      );
+
+    /// @brief Get the value of an input pin group, as ipin_group::get.
+    /// @param[in] group  Index of input group registered with the server.
+    /// @throws std::length_error if the batch is full.
+      remote_batch & group_get(unsigned group);
+
+    /// @brief Full-duplex SPI0 transfer; as many bytes are read as written.
+    /// @param[in] slave  Index of slave context registered with the server.
+    /// @param[in] ptx    Bytes to write.
+    /// @param[in] count  Number of bytes to write, greater than 0.
+    /// @throws std::invalid_argument if count is 0.
+    /// @throws std::length_error if the batch is full.
+      remote_batch & spi0_transfer
+      ( unsigned slave
+      , std::uint8_t const * ptx
+      , std::size_t count
+      );
+
+    /// @brief I2C write, as i2c_pins::write_all.
+    /// @param[in] bus    Index of I2C pins registered with the server.
+    /// @param[in] addrs  Slave address [0,127].
+    /// @throws std::length_error if the batch is full.
+      remote_batch & i2c_write
+      ( unsigned bus
+      , std::uint32_t addrs
+      , std::uint8_t const * ptx
+      , std::size_t count
+      );
+
+    /// @brief I2C read of count bytes, as i2c_pins::read_all.
+    /// @throws As for i2c_write.
+      remote_batch & i2c_read
+      ( unsigned bus
+      , std::uint32_t addrs
+      , std::size_t count
+      );
+
+    /// @brief I2C combined write then read, as i2c_pins::write_then_read.
+    /// @throws As for i2c_write.
+      remote_batch & i2c_write_then_read
+      ( unsigned bus
+      , std::uint32_t addrs
+      , std::uint8_t const * ptx
+      , std::size_t tx_count
+      , std::size_t rx_count
+      );
+
+    /// @brief Wait before performing the following commands.
+    /// @param[in] us Time to wait, at most remote_frame::max_delay_us.
+    /// @throws std::invalid_argument if us is negative or too long.
+    /// @throws std::length_error if the batch is full.
+      remote_batch & delay(std::chrono::microseconds us);
+
+    /// @brief Returns the number of commands in the batch.
+      std::size_t size() const
+      {
+        return commands;
+      }
+
+    /// @brief Returns the command frame.
+      std::vector<std::uint8_t> const & bytes() const
+      {
+        return frame;
+      }
+
+    /// @brief Remove all commands.
+      void clear();
+    };
+
+  /// @brief Result of one remote command.
+    struct remote_result
+    {
+      remote_outcome            outcome;
+      std::int32_t              status; ///< I2C return value, else 0
+      std::vector<std::uint8_t> data;   ///< Bytes read or failure message
+
+    /// @brief Returns the value of a group_get result.
+    /// @throws std::logic_error if the result is not 8 bytes.
+      pin_group_value_t value() const;
+    };
+
+  /// @brief Decode a response frame.
+  /// @param[in] frame  Response frame bytes.
+  /// @param[in] length Number of bytes in frame.
+  /// @returns Results in command order.
+  /// @throws std::runtime_error if the frame is malformed.
+    std::vector<remote_result> decode_remote_response
+    ( std::uint8_t const * frame
+    , std::size_t length
+    );
+
+  /// @brief Objects on which remote commands are performed, referred to by
+  /// their index in each vector. Not owned.
+    struct remote_targets
+    {
+      std::vector<opin_group *>         outputs;
+      std::vector<ipin_group *>         inputs;
+      spi0_pins *                       spi0{nullptr};
+      std::vector<spi0_slave_context>   spi0_slaves;
+      std::vector<i2c_pins *>           i2c;
+    };
+
+  /// @brief Perform the commands of a command frame.
+  ///
+  /// Used by remote_server; exposed so a frame may be performed from other
+  /// transports.
+  /// @param[in] targets  Objects commands are performed on. If targets has
+  ///                     SPI0 pins a conversation with the slave context of
+  ///                     each transfer is started as needed.
+  /// @param[in] frame    Command frame bytes.
+  /// @param[in] length   Number of bytes in frame.
+  /// @returns Response frame. If the results of the commands might exceed
+  ///          remote_frame::max_payload bytes every command is rejected.
+  /// @throws std::invalid_argument if the frame is malformed, in which case
+  ///         no commands are performed.
+    std::vector<std::uint8_t> perform_remote_batch
+    ( remote_targets & targets
+    , std::uint8_t const * frame
+    , std::size_t length
+    );
+
+  /// @brief Serve remote command frames on a TCP port.
+  ///
+  /// A service thread accepts one connection at a time and performs each
+  /// command frame received on it, replying with a response frame. A
+  /// malformed frame closes the connection. Destroying the server ends any
+  /// delay in progress, failing it, and drops the connection even if the
+  /// client is part way through sending a frame. There is no
+  /// authentication: by default only the loopback address is listened on;
+  /// listen on other addresses only on trusted networks.
+    class remote_server
+    {
+      remote_targets    targets;
+      int               listen_fd;
+      int               stop_fds[2];
+      std::uint16_t     bound_port;
+      std::thread       worker;
+
+      void serve();
+      void serve_connection(int fd);
+
+    public:
+    /// @brief Construct, listen and start the service thread.
+    /// @param[in] t        Objects commands are performed on. If t has SPI0
+    ///                     pins the slave contexts must be for standard mode.
+    /// @param[in] port     TCP port to listen on, 0 for any free port.
+    /// @param[in] address  IPv4 address to listen on. Defaults to the
+    ///                     loopback address so only local clients may
+    ///                     connect. "0.0.0.0" listens on all interfaces.
+    /// @throws std::invalid_argument if the SPI0 pins or slave contexts do
+    ///         not support standard mode or address is not valid.
+    /// @throws std::system_error if the socket cannot be created, bound or
+    ///         listened on or the service thread started.
+      remote_server
+      ( remote_targets t
+      , std::uint16_t port
+      , char const * address = "127.0.0.1"
+      );
+
+    /// @brief Destroy: close any connection, stop and join the service
+    /// thread. The SPI0 conversation is stopped.
+      ~remote_server();
+
+      remote_server(remote_server const &) = delete;
+      remote_server & operator=(remote_server const &) = delete;
+
+    /// @brief Returns the TCP port listened on.
+      std::uint16_t port() const
+      {
+        return bound_port;
+      }
+    };
+
+  /// @brief Send batches of commands to a remote_server.
+    class remote_client
+    {
+      int fd;
+
+    public:
+    /// @brief Construct, connecting to a server.
+    /// @param[in] host Host name or address of the server.
+    /// @param[in] port TCP port of the server.
+    /// @throws std::runtime_error if host cannot be resolved.
+    /// @throws std::system_error if the connection fails.
+      remote_client(char const * host, std::uint16_t port);
+
+      ~remote_client();
+
+      remote_client(remote_client const &) = delete;
+      remote_client & operator=(remote_client const &) = delete;
+
+    /// @brief Perform a batch of commands in one round trip.
+    /// @param[in] batch  Commands to perform.
+    /// @returns Results in command order.
+    /// @throws std::system_error if sending or receiving fails.
+    /// @throws std::runtime_error if the server closes the connection or
+    ///         replies with a malformed frame.
+      std::vector<remote_result> run(remote_batch const & batch);
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_REMOTE_COMMAND_H
@@ -0,0 +1,234 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file rt_thread.h
+/// @brief Real-time execution of bit-bang and polling threads : type
+/// definitions.
+///
+/// Loops that poll or toggle GPIO pins at fixed intervals suffer jitter when
+/// their thread is preempted by other threads, migrated between CPUs or
+/// stalled on page faults. An rt_config describes how to avoid these: a
+/// SCHED_FIFO priority, a CPU to restrict the thread to, locking the process'
+/// memory and pre-faulting the thread's stack. An rt_scope applies a
+/// configuration to the calling thread for its lifetime and an rt_thread
+/// runs a function on a new thread with a configuration applied. An
+/// rt_period paces a periodic loop, counting missed deadlines.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_RT_THREAD_H
+# define DIBASE_RPI_PERIPHERALS_RT_THREAD_H
+
+# include <chrono>
+# include <cstddef>
+# include <cstdint>
+# include <exception>
+# include <future>
+# include <memory>
+# include <thread>
+# include <utility>
+# include <sched.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Real-time configuration of a thread.
+    struct rt_config
+    {
+    /// @brief Value for cpu meaning do not set the thread's CPU affinity.
+      constexpr static int any_cpu = -1;
+
+    /// @brief Value for priority meaning do not change the thread's
+    /// scheduling policy.
+      constexpr static int no_priority = 0;
+
+      int         priority;     ///< SCHED_FIFO priority [1,99] or no_priority
+      int         cpu;          ///< CPU to restrict thread to or any_cpu
+      bool        lock_memory;  ///< Lock all process memory (mlockall)
+      std::size_t stack_prefault_size;///< Bytes of stack to pre-fault
+
+    /// @brief Construct from configuration parameters.
+    /// @param[in] prio   SCHED_FIFO priority [1,99], or no_priority (the
+    ///                   default) to leave the scheduling policy unchanged.
+    /// @param[in] on_cpu CPU the thread is restricted to, or any_cpu (the
+    ///                   default).
+    /// @param[in] lock   If true lock current and future process memory into
+    ///                   RAM. Defaults to false.
+    /// @param[in] stack  Bytes of the thread's stack to touch so its pages
+    ///                   are present before time critical work. Defaults to
+    ///                   0, none. Should be less than the thread's stack
+    ///                   size.
+      explicit rt_config
+      ( int prio = no_priority
+      , int on_cpu = any_cpu
+      , bool lock = false
+      , std::size_t stack = 0U
+      )
+      : priority{prio}
+      , cpu{on_cpu}
+      , lock_memory{lock}
+      , stack_prefault_size{stack}
+      {}
+    };
+
+  /// @brief Apply an rt_config to the calling thread for the object's
+  /// lifetime.
+  ///
+  /// On destruction the thread's previous scheduling policy, priority and
+  /// CPU affinity are restored. Locked memory is left locked as the lock
+  /// applies to the whole process.
+    class rt_scope
+    {
+      int         old_policy;
+      ::sched_param old_param;
+      ::cpu_set_t old_cpus;
+      bool        policy_set;
+      bool        affinity_set;
+
+      void restore();
+
+    public:
+    /// @brief Apply a configuration to the calling thread.
+    /// @param[in] c  Configuration to apply.
+    /// @throws std::invalid_argument if c.priority is not no_priority or in
+    ///         the SCHED_FIFO priority range or c.cpu is not any_cpu or a
+    ///         valid CPU number.
+    /// @throws std::system_error if any part of the configuration cannot be
+    ///         applied, for example because the process lacks the privilege
+    ///         to use SCHED_FIFO or lock memory. Any parts already applied
+    ///         are undone.
+      explicit rt_scope(rt_config const & c);
+
+    /// @brief Restore the calling thread's scheduling and CPU affinity.
+    /// Must be destroyed by the thread that constructed it.
+      ~rt_scope();
+
+      rt_scope(rt_scope const &) = delete;
+      rt_scope& operator=(rt_scope const &) = delete;
+    };
+
+  /// @brief A thread running a function with an rt_config applied.
+  ///
+  /// Like std::thread except that the configuration is applied by the new
+  /// thread before calling the function, and construction waits for it to
+  /// be applied so that failures are reported to the creating thread.
+  /// Must be joined or detached before destruction.
+    class rt_thread
+    {
+      std::thread thread;
+
+    public:
+    /// @brief Construct not representing a thread.
+      rt_thread() = default;
+
+    /// @brief Start a thread running f with c applied.
+    /// @tparam F     Callable type taking no arguments.
+    /// @param[in] c  Configuration to apply to the thread.
+    /// @param[in] f  Function to run on the thread.
+    /// @throws As for rt_scope construction, in which case the thread has
+    ///         exited without calling f.
+    /// @throws std::system_error if the thread cannot be created.
+      template <typename F>
+      rt_thread(rt_config const & c, F f)
+      {
+        std::promise<void> applied;
+        std::future<void> applied_result{applied.get_future()};
+        thread = std::thread
+                 { [c](std::promise<void> done, F fn)
+                   {
+                     std::unique_ptr<rt_scope> scope;
+                     try
+                       {
+                         scope.reset(new rt_scope{c});
+                       }
+                     catch (...)
+                       {
+                         done.set_exception(std::current_exception());
+                         return;
+                       }
+                     done.set_value();
+                     fn();
+                   }
+                 , std::move(applied)
+                 , std::move(f)
+                 };
+        try
+          {
+            applied_result.get();
+          }
+        catch (...)
+          {
+            thread.join();
+            throw;
+          }
+      }
+
+      rt_thread(rt_thread &&) = default;
+      rt_thread& operator=(rt_thread &&) = default;
+
+    /// @brief Returns true if the object represents a thread not yet joined
+    /// or detached.
+      bool joinable() const
+      {
+        return thread.joinable();
+      }
+
+    /// @brief Wait for the thread to exit.
+      void join()
+      {
+        thread.join();
+      }
+
+    /// @brief Let the thread run on independently.
+      void detach()
+      {
+        thread.detach();
+      }
+    };
+
+  /// @brief Counts and timings of an rt_period's deadlines.
+    struct rt_period_stats
+    {
+      rt_period_stats()
+      : periods{0U}
+      , missed{0U}
+      , max_lateness{0}
+      {}
+
+      std::uint64_t             periods;      ///< Deadlines waited for
+      std::uint64_t             missed;       ///< Deadlines already passed
+      std::chrono::nanoseconds  max_lateness; ///< Latest wake up or miss
+    };
+
+  /// @brief Pace a periodic loop on absolute deadlines.
+  ///
+  /// Deadlines are whole numbers of periods after the start time so waking
+  /// late does not delay later deadlines. Call wait at the end of each
+  /// iteration. If the next deadline has already passed, the iteration
+  /// overran: the deadline is counted as missed and skipped deadlines are
+  /// dropped so the loop resynchronises instead of running a burst of
+  /// iterations to catch up.
+    class rt_period
+    {
+      std::chrono::nanoseconds  period;
+      std::chrono::nanoseconds  next;
+      rt_period_stats           counts;
+
+    public:
+    /// @brief Start pacing, the first deadline being one period from now.
+    /// @param[in] p  Period. Must be greater than zero.
+    /// @throws std::invalid_argument if p is not greater than zero.
+      explicit rt_period(std::chrono::nanoseconds p);
+
+    /// @brief Sleep until the next deadline.
+    /// @returns true if the deadline was met, false if it had already passed.
+      bool wait();
+
+    /// @brief Returns deadline statistics so far.
+      rt_period_stats const & stats() const
+      {
+        return counts;
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_RT_THREAD_H
@@ -0,0 +1,101 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file smi_dma.h
+/// @brief DMA bulk transfers for the SMI parallel bus : class definition.
+///
+/// Feeding or draining the SMI FIFO from the CPU limits block transfers to
+/// the rate the CPU can poll the FIFO flags and move words. A smi_dma object
+/// has a DMA channel, paced by the SMI DREQ, move blocks between the SMI
+/// FIFO and a buffer in DMA coherent memory, so the bus runs at the rate its
+/// timing settings allow.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_SMI_DMA_H
+# define DIBASE_RPI_PERIPHERALS_SMI_DMA_H
+
+# include "smi_pins.h"
+# include <memory>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      class dma_arena;
+      struct dma_control_block;
+    }
+
+  /// @brief Transfer blocks over the SMI bus by DMA.
+  ///
+  /// Data is written from, and read into, a buffer in DMA coherent memory
+  /// obtained from the VideoCore on construction. The buffer is filled or
+  /// read in place, so no copies are made. As for smi_pins block transfers,
+  /// block sizes are a multiple of 4 bytes.
+  ///
+  /// While a DMA transfer is in progress the smi_pins object must not be
+  /// used for other transfers.
+    class smi_dma
+    {
+      smi_pins &                            smi;        ///< SMI pins in use
+      std::unique_ptr<internal::dma_arena>  memory;     ///< Buffer & CB memory
+      internal::dma_control_block *         cb;         ///< Transfer CB
+      std::uint32_t volatile *              buf;        ///< Transfer buffer
+      std::uint32_t                         buf_bus;    ///< Buffer bus address
+      std::size_t                           max_bytes;  ///< Buffer size
+      std::size_t                           dma_channel;///< DMA channel
+
+      void transfer(unsigned address, std::size_t bytes, bool write);
+
+    public:
+    /// @brief Allocate DMA memory and a DMA channel for SMI transfers.
+    /// @param[in] pins       SMI pins object to transfer through. Must
+    ///                       outlive this object.
+    /// @param[in] max_block  Maximum bytes per block: rounded up to a
+    ///                       multiple of 4.
+    /// @throws std::invalid_argument if max_block is zero.
+    /// @throws bad_peripheral_alloc if a DMA channel is not available.
+    /// @throws std::system_error or std::bad_alloc if DMA memory cannot be
+    ///         obtained.
+      smi_dma(smi_pins & pins, std::size_t max_block);
+
+    /// @brief Disable SMI DMA requests and release the DMA channel.
+      ~smi_dma();
+
+      smi_dma(smi_dma const &) = delete;
+      smi_dma& operator=(smi_dma const &) = delete;
+
+    /// @brief Returns the DMA buffer: max_block_size() bytes as 32-bit FIFO
+    /// words.
+      std::uint32_t volatile * buffer()
+      {
+        return buf;
+      }
+
+    /// @brief Returns the maximum number of bytes in a block.
+      std::size_t max_block_size() const
+      {
+        return max_bytes;
+      }
+
+    /// @brief Write the start of the buffer to the bus, waiting for the
+    /// transfer to complete.
+    /// @param[in] address  Address bus value for all transfers [0,63].
+    /// @param[in] bytes    Number of bytes to write: a multiple of 4, at most
+    ///                     max_block_size().
+    /// @throws std::invalid_argument if address or bytes is out of range.
+    /// @throws std::runtime_error if the DMA transfer fails.
+      void write(unsigned address, std::size_t bytes);
+
+    /// @brief Read from the bus into the start of the buffer, waiting for
+    /// the transfer to complete.
+    /// @param[in] address  Address bus value for all transfers [0,63].
+    /// @param[in] bytes    Number of bytes to read: a multiple of 4, at most
+    ///                     max_block_size().
+    /// @throws std::invalid_argument if address or bytes is out of range.
+    /// @throws std::runtime_error if the DMA transfer fails.
+      void read(unsigned address, std::size_t bytes);
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_SMI_DMA_H
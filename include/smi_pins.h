@@ -0,0 +1,203 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file smi_pins.h
+/// @brief Use a set of GPIO pins for use with the SMI (secondary memory
+/// interface) parallel bus: type definitions.
+///
+/// The BCM2835 SMI peripheral drives an 8 to 18 bit parallel data bus with
+/// up to 6 address lines and separate read (SOE) and write (SWE) strobes,
+/// with setup, strobe, hold and pace times counted in SMI clock cycles. It
+/// is suited to parallel TFT display controllers, FPGAs and similar devices
+/// needing rates far beyond those reached by toggling GPIO pins.
+///
+/// The SMI pins are fixed: SA5..SA0 on GPIO0..GPIO5, SOE on GPIO6, SWE on
+/// GPIO7 and SD0..SD15 on GPIO8..GPIO23, all alternative function 1. Only the
+/// address and data lines needed are allocated.
+///
+/// The SMI peripheral is not described in the BCM2835 ARM Peripherals
+/// Datasheet; see smi_registers.h for the source of its register details.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_SMI_PINS_H
+# define DIBASE_RPI_PERIPHERALS_SMI_PINS_H
+# include "pin_id.h"
+# include "clockdefs.h"
+# include "wait_policy.h"
+# include "io_counters.h"
+# include <array>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Default SMI clock frequency: PLLD / 4, so 8ns per cycle
+    constexpr hertz smi_default_clock_frequency(megahertz(125));
+
+  /// @brief SMI data bus widths supported
+    enum class smi_width
+    { bits8   ///< 8 bit bus on SD0..SD7 (GPIO8..GPIO15)
+    , bits16  ///< 16 bit bus on SD0..SD15 (GPIO8..GPIO23)
+    };
+
+  /// @brief SMI transfer timing in SMI clock cycles
+    struct smi_timing
+    {
+      unsigned setup;   ///< Address valid to strobe asserted [1,63]
+      unsigned strobe;  ///< Strobe asserted for [1,127]
+      unsigned hold;    ///< Strobe de-asserted to address change [0,63]
+      unsigned pace;    ///< Extra cycles between transfers [0,127]
+    };
+
+    class smi_dma;
+
+  /// @brief Use GPIO pins with the SMI parallel bus peripheral.
+  ///
+  /// If the SMI peripheral, SMI clock and required pins are not already in
+  /// use locally within the same process then the SMI peripheral is set-up
+  /// with the requested bus width and timings and the pins allocated and
+  /// set to their SMI alt-fns. Note that no attempt is made to see if SMI is
+  /// in use externally by other processes.
+  ///
+  /// Single transfers are made with write_direct() and read_direct(). Blocks
+  /// are transferred through the SMI FIFO by write() and read(), or by DMA
+  /// using a \ref smi_dma object. Block transfers pack 4 8-bit or 2 16-bit
+  /// transfers into each 32-bit FIFO word, so block sizes are a multiple of 4
+  /// bytes, with the first transfer in the least significant bits.
+    class smi_pins
+    {
+    friend class smi_dma;
+
+      constexpr static unsigned max_pins = 24U;
+
+      std::array<pin_id_int_t, max_pins>  pins;
+      unsigned                            pin_count;
+      smi_width                           bus_width;
+      unsigned                            address_count;
+      wait_policy                         waiting;
+      wait_stats                          wait_counts;
+      io_counter_set                      counters;
+
+      void check_block(unsigned address, std::size_t bytes) const;
+      void start_block(unsigned address, std::size_t bytes, bool write);
+      void wait_done();
+
+    public:
+    /// @brief Construct a smi_pins object for a bus width, number of address
+    /// lines and read and write timings.
+    ///
+    /// @post The SMI peripheral and SMI clock are marked as in use and the
+    ///       SMI clock is running at smi_clock.
+    /// @post The SOE, SWE, requested address and data bus pins are marked as
+    ///       in use and set to their SMI alt-fns.
+    ///
+    /// @param[in] width          Data bus width.
+    /// @param[in] address_lines  Number of address lines SA0 upwards to use
+    ///                           [0,6].
+    /// @param[in] read_timing    Timing of read transfers.
+    /// @param[in] write_timing   Timing of write transfers.
+    /// @param[in] smi_clock      SMI clock frequency timings are counted in.
+    ///                           Defaults to smi_default_clock_frequency.
+    ///
+    /// @throws std::invalid_argument if address_lines or a timing value is
+    ///         out of range.
+    /// @throws bad_peripheral_alloc if any of the pins, the SMI peripheral or
+    ///         the SMI clock are already in use.
+      smi_pins
+      ( smi_width width
+      , unsigned address_lines
+      , smi_timing const & read_timing
+      , smi_timing const & write_timing
+      , hertz smi_clock = smi_default_clock_frequency
+      );
+
+    /// @brief Destroy: disable SMI and its clock and de-allocate GPIO pins.
+      ~smi_pins();
+
+      smi_pins(smi_pins const &) = delete;
+      smi_pins& operator=(smi_pins const &) = delete;
+
+    /// @brief Returns the data bus width.
+      smi_width width() const
+      {
+        return bus_width;
+      }
+
+    /// @brief Returns the number of address lines in use.
+      unsigned address_lines() const
+      {
+        return address_count;
+      }
+
+    /// @brief Write a single value to the bus.
+    /// @param[in] address  Address bus value [0,63].
+    /// @param[in] value    Value to write: only the bus width's least
+    ///                     significant bits are used.
+    /// @throws std::invalid_argument if address is out of range.
+      void write_direct(unsigned address, std::uint32_t value);
+
+    /// @brief Read a single value from the bus.
+    /// @param[in] address  Address bus value [0,63].
+    /// @returns Value read in the bus width's least significant bits.
+    /// @throws std::invalid_argument if address is out of range.
+      std::uint32_t read_direct(unsigned address);
+
+    /// @brief Write a block of data through the SMI FIFO, waiting for it all
+    /// to be written.
+    /// @param[in] address  Address bus value for all transfers [0,63].
+    /// @param[in] pdata    Pointer to data: 32-bit FIFO words.
+    /// @param[in] bytes    Number of bytes to write: a multiple of 4.
+    /// @throws std::invalid_argument if address or bytes is out of range.
+      void write
+      ( unsigned address
+      , std::uint32_t const * pdata
+      , std::size_t bytes
+      );
+
+    /// @brief Read a block of data through the SMI FIFO, waiting for it all
+    /// to be read.
+    /// @param[in] address  Address bus value for all transfers [0,63].
+    /// @param[out] pdata   Pointer to buffer for 32-bit FIFO words.
+    /// @param[in] bytes    Number of bytes to read: a multiple of 4.
+    /// @throws std::invalid_argument if address or bytes is out of range.
+      void read(unsigned address, std::uint32_t * pdata, std::size_t bytes);
+
+    /// @brief Set the wait policy used while block transfers wait.
+    ///
+    /// Defaults to a default constructed wait_policy.
+    /// @param[in] p  Policy to use.
+      void set_wait_policy(wait_policy const & p)
+      {
+        waiting = p;
+      }
+
+    /// @brief Returns the wait policy in use.
+      wait_policy const & get_wait_policy() const
+      {
+        return waiting;
+      }
+
+    /// @brief Returns counts of waits by the stage they finished in.
+      wait_stats const & wait_statistics() const
+      {
+        return wait_counts;
+      }
+
+    /// @brief Returns a snapshot of the performance counters.
+    ///
+    /// Counts bytes written and read, and polls made while waiting. All
+    /// counts are zero unless counting is enabled - see io_counters.h.
+      io_counters counter_snapshot() const
+      {
+        return counters.snapshot();
+      }
+
+    /// @brief Reset the performance counters to zero.
+      void reset_counters()
+      {
+        counters.reset();
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_SMI_PINS_H
@@ -0,0 +1,531 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file soft_bus.h
+/// @brief Bit-banged SPI, I2C and 1-Wire masters on compile time specified
+/// GPIO pins : class template definitions.
+///
+/// Devices outnumbering the hardware SPI and BSC masters can be driven by
+/// toggling GPIO pins in software. Doing so bit by bit through \ref opin and
+/// \ref ipin costs a pin_id to bank and mask calculation per access. The
+/// class templates here take their GPIO pin numbers as template arguments,
+/// as \ref static_opin and \ref static_ipin do, so each bit is a few stores
+/// of constant masks to constant GPSETn / GPCLRn words and loads of a GPLEVn
+/// word. Bit timing uses the system timer calibrated busy-wait delays of
+/// \ref system_timer.
+///
+/// I2C and 1-Wire lines are open drain: a line is driven low by making its
+/// pin an output, its output level having been set low, and released to be
+/// pulled high by making it an input with the internal pull-up enabled.
+/// External pull-up resistors should be fitted for anything but the slowest
+/// or shortest buses.
+///
+/// Bit-banged timing is only as good as the thread's scheduling: run time
+/// critical transfers, 1-Wire ones in particular, on an \ref rt_thread.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_SOFT_BUS_H
+# define DIBASE_RPI_PERIPHERALS_SOFT_BUS_H
+
+# include "static_pin.h"
+# include "system_timer.h"
+# include "waveform.h"
+# include "clockdefs.h"
+# include <cstddef>
+# include <cstdint>
+# include <stdexcept>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+    /// @brief \b Internal : 32-bit word offset of GPFSEL0 from GPIO base
+      constexpr std::size_t gpfsel0_word_offset{0};
+
+    /// @brief \b Internal : Make a GPIO pin an input or an output.
+    ///
+    /// Updates the pin's GPFSELn field through gpio_ctrl::config, so is a
+    /// single store if GPIO configuration shadowing is enabled.
+    /// @param[in] fsel_word  Pin's mapped GPFSELn register word.
+    /// @param[in] shift      Bit position of pin's field in fsel_word.
+    /// @param[in] output     true to make the pin an output, false an input.
+      void set_pin_output
+      ( std::uint32_t volatile * fsel_word
+      , unsigned shift
+      , bool output
+      );
+
+    /// @brief \b Internal : Open drain line on a compile time GPIO pin.
+    /// @tparam Pin BCM2835 GPIO pin number (0..53).
+      template <pin_id_int_t Pin>
+      class open_drain_pin
+      {
+        typedef static_pin_traits<Pin> traits;
+
+        ipin pin;                                     ///< Opened GPIO pin
+        std::uint32_t volatile * const fsel_reg;      ///< Pin's GPFSELn
+        std::uint32_t volatile const * const level_reg;///< Pin's GPLEVn
+
+      public:
+      /// @brief Open Pin as a released (pulled up) open drain line
+      /// @exception  bad_pin_alloc if the GPIO pin is in use by this process
+      ///             or elsewhere.
+        open_drain_pin()
+        : pin{pin_id{Pin}, ipin::pull_up}
+        , fsel_reg{gpio_register_words() + gpfsel0_word_offset + Pin/10U}
+        , level_reg{ gpio_register_words()
+                   + gplev0_word_offset + traits::bank
+                   }
+        {
+        // Output level only takes effect while the pin is an output
+          gpio_register_words()[gpclr0_word_offset+traits::bank]
+                                                              = traits::mask;
+        }
+
+      /// @brief Release the line, leaving Pin an input
+        ~open_drain_pin()
+        {
+          release();
+        }
+
+        open_drain_pin(open_drain_pin const &) = delete;
+        open_drain_pin& operator=(open_drain_pin const &) = delete;
+
+      /// @brief Drive the line low
+        void drive_low()
+        {
+          set_pin_output(fsel_reg, (Pin%10U)*3U, true);
+        }
+
+      /// @brief Stop driving the line, letting it be pulled high
+        void release()
+        {
+          set_pin_output(fsel_reg, (Pin%10U)*3U, false);
+        }
+
+      /// @brief Returns true if the line is high
+        bool get() const
+        {
+          return (*level_reg & traits::mask)!=0U;
+        }
+      };
+    } // namespace internal closed
+
+  /// @brief Bit-banged SPI mode 0 master on compile time specified pins.
+  ///
+  /// The clock rests low, MOSI is changed while the clock is low and MISO is
+  /// sampled on the rising clock edge. Bytes are sent most significant bit
+  /// first. Chip selects are not managed: use an \ref opin or \ref static_opin
+  /// for each slave's chip select.
+  ///
+  /// @tparam Sclk  GPIO pin number of the SCLK output.
+  /// @tparam Mosi  GPIO pin number of the MOSI output.
+  /// @tparam Miso  GPIO pin number of the MISO input.
+    template <pin_id_int_t Sclk, pin_id_int_t Mosi, pin_id_int_t Miso>
+    class soft_spi
+    {
+      typedef static_pin_traits<Sclk> sclk;
+      typedef static_pin_traits<Mosi> mosi;
+      typedef static_pin_traits<Miso> miso;
+
+      opin                      sclk_pin;
+      opin                      mosi_pin;
+      ipin                      miso_pin;
+      std::uint32_t volatile *  words;
+      std::uint32_t             half_period_ns;
+
+      void half_period() const
+      {
+        if (half_period_ns!=0U)
+          {
+            system_timer::delay_ns(half_period_ns);
+          }
+      }
+
+    public:
+    /// @brief Open the pins, SCLK and MOSI low.
+    /// @param[in] f  Maximum SCLK frequency, or zero (the default) for as
+    ///               fast as the pins can be toggled.
+    /// @exception  bad_pin_alloc if any GPIO pin is in use by this process
+    ///             or elsewhere.
+      explicit soft_spi(hertz f = hertz{0U})
+      : sclk_pin{pin_id{Sclk}}
+      , mosi_pin{pin_id{Mosi}}
+      , miso_pin{pin_id{Miso}}
+      , words{internal::gpio_register_words()}
+      , half_period_ns{f.count()==0U ? 0U : 500000000U/f.count()}
+      {
+        sclk_pin.put(false);
+        mosi_pin.put(false);
+      }
+
+    /// @brief Full-duplex transfer of one byte.
+    /// @param[in] tx Byte to write.
+    /// @returns Byte read.
+      std::uint8_t transfer(std::uint8_t tx)
+      {
+        std::uint8_t rx{0U};
+        for (unsigned bit=0U; bit!=8U; ++bit, tx<<=1)
+          {
+            words[ ((tx&0x80U) ? internal::gpset0_word_offset
+                               : internal::gpclr0_word_offset
+                   ) + mosi::bank
+                 ] = mosi::mask;
+            half_period();
+            words[internal::gpset0_word_offset+sclk::bank] = sclk::mask;
+            rx = static_cast<std::uint8_t>
+                  ( (rx<<1)
+                  | ((words[internal::gplev0_word_offset+miso::bank]
+                     &miso::mask)!=0U)
+                  );
+            half_period();
+            words[internal::gpclr0_word_offset+sclk::bank] = sclk::mask;
+          }
+        return rx;
+      }
+
+    /// @brief Full-duplex transfer of a sequence of bytes.
+    /// @param[in] ptx    Pointer to bytes to write, or nullptr to write zeros.
+    /// @param[out] prx   Pointer to buffer for bytes read, or nullptr to
+    ///                   discard them. May equal ptx.
+    /// @param[in] count  Number of bytes to transfer.
+      void transfer
+      ( std::uint8_t const * ptx
+      , std::uint8_t * prx
+      , std::size_t count
+      )
+      {
+        for (std::size_t idx=0U; idx!=count; ++idx)
+          {
+            std::uint8_t const rx{transfer(ptx ? ptx[idx] : std::uint8_t{0U})};
+            if (prx)
+              {
+                prx[idx] = rx;
+              }
+          }
+      }
+    };
+
+  /// @brief Bit-banged I2C master on compile time specified pins.
+  ///
+  /// Supports 7-bit addressing and slaves stretching the clock. A single
+  /// master is assumed: arbitration is not detected.
+  ///
+  /// @tparam Scl GPIO pin number of the SCL line.
+  /// @tparam Sda GPIO pin number of the SDA line.
+    template <pin_id_int_t Scl, pin_id_int_t Sda>
+    class soft_i2c
+    {
+      internal::open_drain_pin<Scl> scl;
+      internal::open_drain_pin<Sda> sda;
+      std::uint32_t                 half_period_ns;
+      std::uint32_t                 stretch_limit_us;
+
+      void half_period() const
+      {
+        system_timer::delay_ns(half_period_ns);
+      }
+
+      bool release_scl()
+      {
+        scl.release();
+        if (scl.get())
+          {
+            return true;
+          }
+        std::uint64_t const start{system_timer::now_us()};
+        while (!scl.get())
+          {
+            if (system_timer::now_us()-start>stretch_limit_us)
+              {
+                return false;
+              }
+          }
+        return true;
+      }
+
+      bool start()
+      {
+        sda.release();
+        if (!release_scl())
+          {
+            return false;
+          }
+        half_period();
+        sda.drive_low();
+        half_period();
+        scl.drive_low();
+        return true;
+      }
+
+      void stop()
+      {
+        sda.drive_low();
+        half_period();
+        release_scl();
+        half_period();
+        sda.release();
+        half_period();
+      }
+
+      bool clock_bit(bool out, bool & in)
+      {
+        if (out)
+          {
+            sda.release();
+          }
+        else
+          {
+            sda.drive_low();
+          }
+        half_period();
+        if (!release_scl())
+          {
+            return false;
+          }
+        in = sda.get();
+        half_period();
+        scl.drive_low();
+        return true;
+      }
+
+    // Returns true if the byte was acknowledged
+      bool write_byte(std::uint8_t b)
+      {
+        bool in;
+        for (unsigned bit=0U; bit!=8U; ++bit, b<<=1)
+          {
+            if (!clock_bit((b&0x80U)!=0U, in))
+              {
+                return false;
+              }
+          }
+        return clock_bit(true, in) && !in;
+      }
+
+      bool read_byte(std::uint8_t & b, bool ack)
+      {
+        b = 0U;
+        bool in;
+        for (unsigned bit=0U; bit!=8U; ++bit)
+          {
+            if (!clock_bit(true, in))
+              {
+                return false;
+              }
+            b = static_cast<std::uint8_t>((b<<1)|in);
+          }
+        return clock_bit(!ack, in);
+      }
+
+      bool read_bytes(std::uint8_t * prx, std::size_t count)
+      {
+        for (std::size_t idx=0U; idx!=count; ++idx)
+          {
+            if (!read_byte(prx[idx], idx+1U!=count))
+              {
+                return false;
+              }
+          }
+        return true;
+      }
+
+    public:
+    /// @brief Default maximum time a slave may stretch the clock for
+      constexpr static std::uint32_t default_stretch_limit_us = 10000U;
+
+    /// @brief Open the lines, both released.
+    /// @param[in] f          SCL frequency. Defaults to 100KHz.
+    /// @param[in] stretch_us Maximum time a slave may hold SCL low, in
+    ///                       microseconds. Defaults to
+    ///                       default_stretch_limit_us.
+    /// @exception  bad_pin_alloc if either GPIO pin is in use by this process
+    ///             or elsewhere.
+    /// @throws std::invalid_argument if f is zero.
+      explicit soft_i2c
+      ( hertz f = hertz{100000U}
+      , std::uint32_t stretch_us = default_stretch_limit_us
+      )
+      : half_period_ns{f.count()==0U ? 0U : 500000000U/f.count()}
+      , stretch_limit_us{stretch_us}
+      {
+        if (f.count()==0U)
+          {
+            throw std::invalid_argument{"soft_i2c::soft_i2c: SCL frequency "
+                                        "must not be zero."};
+          }
+      }
+
+    /// @brief Write bytes to a slave.
+    /// @param[in] addrs  Slave address [0,127].
+    /// @param[in] ptx    Pointer to bytes to write.
+    /// @param[in] count  Number of bytes to write.
+    /// @returns true if the slave acknowledged its address and all bytes,
+    ///          false if not or a slave stretched the clock for too long.
+      bool write
+      ( std::uint32_t addrs
+      , std::uint8_t const * ptx
+      , std::size_t count
+      )
+      {
+        bool ok{start() && write_byte(static_cast<std::uint8_t>(addrs<<1))};
+        for (std::size_t idx=0U; ok && idx!=count; ++idx)
+          {
+            ok = write_byte(ptx[idx]);
+          }
+        stop();
+        return ok;
+      }
+
+    /// @brief Read bytes from a slave.
+    /// @param[in] addrs  Slave address [0,127].
+    /// @param[out] prx   Pointer to buffer for bytes read.
+    /// @param[in] count  Number of bytes to read.
+    /// @returns true if the slave acknowledged its address and all bytes
+    ///          were read, false if not or a slave stretched the clock for
+    ///          too long.
+      bool read
+      ( std::uint32_t addrs
+      , std::uint8_t * prx
+      , std::size_t count
+      )
+      {
+        bool const ok
+                { start()
+               && write_byte(static_cast<std::uint8_t>((addrs<<1)|1U))
+               && read_bytes(prx, count)
+                };
+        stop();
+        return ok;
+      }
+
+    /// @brief Write bytes then, after a repeated start, read bytes from a
+    /// slave.
+    /// @param[in] addrs    Slave address [0,127].
+    /// @param[in] ptx      Pointer to bytes to write.
+    /// @param[in] tx_count Number of bytes to write.
+    /// @param[out] prx     Pointer to buffer for bytes read.
+    /// @param[in] rx_count Number of bytes to read.
+    /// @returns As for read.
+      bool write_then_read
+      ( std::uint32_t addrs
+      , std::uint8_t const * ptx
+      , std::size_t tx_count
+      , std::uint8_t * prx
+      , std::size_t rx_count
+      )
+      {
+        bool ok{start() && write_byte(static_cast<std::uint8_t>(addrs<<1))};
+        for (std::size_t idx=0U; ok && idx!=tx_count; ++idx)
+          {
+            ok = write_byte(ptx[idx]);
+          }
+        ok = ok
+          && start()
+          && write_byte(static_cast<std::uint8_t>((addrs<<1)|1U))
+          && read_bytes(prx, rx_count);
+        stop();
+        return ok;
+      }
+    };
+
+    template <pin_id_int_t Scl, pin_id_int_t Sda>
+    constexpr std::uint32_t soft_i2c<Scl,Sda>::default_stretch_limit_us;
+
+  /// @brief Returns the Dallas / Maxim 1-Wire CRC-8 of a sequence of bytes.
+  ///
+  /// The last byte of a ROM code or scratchpad is the CRC-8 of the bytes
+  /// before it, so the CRC-8 of the whole sequence is zero if it is valid.
+  /// @param[in] p      Pointer to bytes.
+  /// @param[in] count  Number of bytes.
+    std::uint8_t one_wire_crc8(std::uint8_t const * p, std::size_t count);
+
+  /// @brief Bit-banged 1-Wire master on a compile time specified pin.
+  ///
+  /// Uses standard speed time slots.
+  /// @tparam Pin GPIO pin number of the 1-Wire data line.
+    template <pin_id_int_t Pin>
+    class one_wire
+    {
+      internal::open_drain_pin<Pin> line;
+
+    public:
+    /// @brief Open the line, released.
+    /// @exception  bad_pin_alloc if the GPIO pin is in use by this process
+    ///             or elsewhere.
+      one_wire() = default;
+
+    /// @brief Send a reset pulse and detect presence pulses.
+    /// @returns true if any slave responded with a presence pulse.
+      bool reset()
+      {
+        line.drive_low();
+        system_timer::delay_us(480U);
+        line.release();
+        system_timer::delay_us(70U);
+        bool const present{!line.get()};
+        system_timer::delay_us(410U);
+        return present;
+      }
+
+    /// @brief Write one bit in a write time slot.
+      void write_bit(bool b)
+      {
+        line.drive_low();
+        system_timer::delay_us(b ? 6U : 60U);
+        line.release();
+        system_timer::delay_us(b ? 64U : 10U);
+      }
+
+    /// @brief Read one bit in a read time slot.
+      bool read_bit()
+      {
+        line.drive_low();
+        system_timer::delay_us(6U);
+        line.release();
+        system_timer::delay_us(9U);
+        bool const b{line.get()};
+        system_timer::delay_us(55U);
+        return b;
+      }
+
+    /// @brief Write one byte, least significant bit first.
+      void write_byte(std::uint8_t b)
+      {
+        for (unsigned bit=0U; bit!=8U; ++bit, b>>=1)
+          {
+            write_bit((b&1U)!=0U);
+          }
+      }
+
+    /// @brief Read one byte, least significant bit first.
+      std::uint8_t read_byte()
+      {
+        std::uint8_t b{0U};
+        for (unsigned bit=0U; bit!=8U; ++bit)
+          {
+            b = static_cast<std::uint8_t>((b>>1)|(read_bit() ? 0x80U : 0U));
+          }
+        return b;
+      }
+    };
+
+  /// @brief Returns waveform steps playing a transmit-only SPI mode 0 stream.
+  ///
+  /// For slaves that are only written to, such as shift register chains, a
+  /// \ref waveform can play a stream without using the CPU. The steps are for
+  /// an \ref opin_group whose first pin is SCLK and second is MOSI.
+  /// @param[in] ptx          Pointer to bytes to write.
+  /// @param[in] count        Number of bytes to write.
+  /// @param[in] half_period  SCLK half period in microseconds. At least 1.
+  /// @throws std::invalid_argument if half_period is zero.
+    std::vector<waveform_step> soft_spi_waveform_steps
+    ( std::uint8_t const * ptx
+    , std::size_t count
+    , std::uint32_t half_period
+    );
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_SOFT_BUS_H
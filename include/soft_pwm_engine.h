@@ -0,0 +1,115 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file soft_pwm_engine.h
+/// @brief DMA timed software PWM on many GPIO pins : class definition
+///
+/// The BCM2835 has only two hardware PWM channels. A soft_pwm_engine produces
+/// PWM on any number of the pins of an \ref opin_group by having a DMA channel
+/// repeatedly run a cyclic chain of control blocks that set and clear pins
+/// through the GPIO GPSET and GPCLR registers, timed by the PWM controller's
+/// DMA request signal as for \ref waveform. Once started the outputs run
+/// without using the CPU, free from scheduling jitter, so the engine is
+/// suited to driving hobby servos and dimming LEDs.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_SOFT_PWM_ENGINE_H
+# define DIBASE_RPI_PERIPHERALS_SOFT_PWM_ENGINE_H
+
+# include "pin_group.h"
+# include <memory>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      class dma_arena;
+    }
+
+  /// @brief Software PWM on the pins of an opin_group, timed by DMA.
+  ///
+  /// Each PWM cycle is divided into a number of slots of a whole number of
+  /// microseconds. A pin's duty is the number of slots at the start of each
+  /// cycle for which it is high, from 0 (always low) to slots() (always
+  /// high). For example 2000 slots of 10us give the 20ms cycle used by hobby
+  /// servos with 10us pulse width resolution.
+  ///
+  /// Duty updates change only the words of the program's set and clear masks
+  /// for the affected pin and take effect from the next slot that reads them,
+  /// without stopping the DMA or locking. Duty updates must be made by one
+  /// thread at a time.
+  ///
+  /// Running the engine requires the PWM controller, whose clock is set to
+  /// time the slots, and a DMA channel, so while an engine exists no PWM pins,
+  /// waveform or other user of the PWM FIFO may be used.
+    class soft_pwm_engine
+    {
+      opin_group const &                    group;      ///< Output pins
+      std::vector<std::size_t>              duties;     ///< Pin duties
+      std::size_t                           slot_count; ///< Slots per cycle
+      std::unique_ptr<internal::dma_arena>  code;       ///< Program memory
+      std::uint32_t                         code_bus;   ///< First CB bus addr.
+      std::uint32_t volatile *              set_masks;  ///< GPSET0/1 values
+      std::uint32_t volatile *              clear_masks;///< Per slot GPCLR0/1
+      std::size_t                           dma_channel;///< Running channel
+
+    public:
+    /// @brief Compile the PWM program, with all pins' duties zero, and
+    /// reserve the resources to run it.
+    /// @param[in] pins     Group of output pins to drive. Must outlive the
+    ///                     engine.
+    /// @param[in] slots    Number of slots per PWM cycle.
+    /// @param[in] slot_us  Microseconds per slot.
+    /// @throws std::invalid_argument if slots or slot_us is zero or slot_us
+    ///         exceeds 268 seconds.
+    /// @throws peripheral_in_use if any PWM channel is in use.
+    /// @throws bad_peripheral_alloc if the PWM FIFO or a DMA channel are not
+    ///         available.
+    /// @throws std::system_error or std::bad_alloc if DMA memory cannot be
+    ///         obtained.
+      soft_pwm_engine
+      ( opin_group const & pins
+      , std::size_t slots
+      , std::uint32_t slot_us
+      );
+
+    /// @brief Stop and release resources.
+      ~soft_pwm_engine();
+
+      soft_pwm_engine(soft_pwm_engine const &) = delete;
+      soft_pwm_engine & operator=(soft_pwm_engine const &) = delete;
+
+    /// @brief Returns number of slots per PWM cycle.
+      std::size_t slots() const
+      {
+        return slot_count;
+      }
+
+    /// @brief Start running PWM cycles from the start of slot 0.
+      void start();
+
+    /// @brief Stop running, leaving pins in their current state.
+      void stop();
+
+    /// @brief Returns true if running.
+      bool is_running() const;
+
+    /// @brief Set a pin's duty.
+    /// @param[in] idx    Position of pin in group (0..size()-1).
+    /// @param[in] duty   Slots per cycle the pin is high, [0, slots()].
+    /// @throws std::out_of_range if idx or duty are out of range.
+      void set_duty(std::size_t idx, std::size_t duty);
+
+    /// @brief Returns a pin's duty.
+    /// @param[in] idx    Position of pin in group (0..size()-1).
+    /// @throws std::out_of_range if idx is out of range.
+      std::size_t get_duty(std::size_t idx) const
+      {
+        return duties.at(idx);
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_SOFT_PWM_ENGINE_H
@@ -0,0 +1,219 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file spi0_dma.h
+/// @brief DMA driven SPI0 standard mode transfers : type definitions.
+///
+/// A spi0_dma object takes over an open \ref spi0_pins object's SPI0
+/// peripheral and transfers whole frames using two DMA channels, one feeding
+/// the transmit FIFO and one draining the receive FIFO, so that large
+/// buffers can be streamed at full SPI clock rate without CPU involvement.
+/// Submitting a frame returns a \ref spi0_dma_transfer completion handle. A
+/// second frame may be submitted while the first is in flight; it is chained
+/// on to the first and starts as soon as the first completes.
+///
+/// A frame may also be a sequence of segments for different slave contexts,
+/// such as reading an ADC on chip 0 then writing a DAC on chip 1. The DMA
+/// chain writes each segment's precomputed CS and CLK register values before
+/// transferring it, so a whole multi-device cycle runs from one submit with
+/// no CPU involvement between devices.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_SPI0_DMA_H
+# define DIBASE_RPI_PERIPHERALS_SPI0_DMA_H
+
+# include "spi0_pins.h"
+# include <memory>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      class dma_arena;
+      struct dma_control_block;
+      struct spi0_dma_segment_spec;
+    }
+
+    class spi0_dma;
+
+  /// @brief One segment of a spi0_dma frame sequence.
+    struct spi0_dma_segment
+    {
+      spi0_slave_context const *  context;///< Slave context for the segment.
+                                          ///< Must be for spi0_mode::standard
+      std::uint8_t const *        tx;     ///< Bytes to transmit, or nullptr
+                                          ///< to transmit zeros
+      std::uint8_t *              rx;     ///< Buffer for received bytes, or
+                                          ///< nullptr to discard them
+      std::size_t                 count;  ///< Number of bytes to transfer
+    };
+
+  /// @brief Completion handle for a frame submitted to a spi0_dma object.
+  ///
+  /// Handles are cheap to copy. A handle must not be used after the spi0_dma
+  /// object it came from is destroyed.
+    class spi0_dma_transfer
+    {
+    friend class spi0_dma;
+
+      spi0_dma *    owner;  ///< Object transferring the frame
+      std::uint32_t seq;    ///< Frame sequence number
+
+      spi0_dma_transfer(spi0_dma * o, std::uint32_t s)
+      : owner{o}
+      , seq{s}
+      {}
+
+    public:
+    /// @brief Query whether the frame has been transferred.
+    /// @returns \c true if all the frame's bytes have been transferred,
+    ///          \c false if the frame is queued or in flight.
+      bool is_done() const;
+
+    /// @brief Wait for the frame to be transferred.
+    ///
+    /// On return any received bytes have been copied to the rx buffers passed
+    /// to spi0_dma::submit or spi0_dma::submit_sequence. Returns immediately
+    /// if the frame was already waited for, explicitly or by a later submit.
+    /// @throws std::runtime_error if the DMA transfer stopped before the frame
+    ///         completed.
+      void wait();
+    };
+
+  /// @brief Use SPI0 in standard (3-wire) mode with DMA transfers.
+  ///
+  /// While a spi0_dma object exists the spi0_pins object it was created from
+  /// must not be used to converse. Two DMA channels are allocated and memory
+  /// for two frames of up to the maximum frame size is obtained from the
+  /// VideoCore on construction.
+    class spi0_dma
+    {
+    friend class spi0_dma_transfer;
+
+    /// @brief Received bytes of one frame segment to copy on completion.
+      struct rx_copy
+      {
+        std::uint8_t const *  rx_data;        ///< Received bytes in region
+        std::uint8_t *        rx;             ///< Caller's receive buffer
+        std::size_t           count;          ///< Segment size in bytes
+      };
+
+    /// @brief Compiled frame memory and state of one in-flight frame.
+      struct frame_slot
+      {
+        void *                base;           ///< Frame memory
+        std::uint32_t         base_bus;       ///< Frame memory bus address
+        internal::dma_control_block * last;   ///< Last CB of receive chain
+        std::vector<rx_copy>  copies;         ///< Segments' received bytes
+        std::uint32_t         seq;            ///< Frame sequence number
+        bool                  pending;        ///< Not yet waited for
+      };
+
+      spi0_pins &                           pins;       ///< Pins using SPI0
+      std::size_t                           max_frame;  ///< Maximum frame size
+      std::size_t                           max_segs;   ///< Maximum segments
+      std::size_t                           slot_size;  ///< Frame memory size
+      std::unique_ptr<internal::dma_arena>  memory;     ///< DMA memory
+      std::uint32_t volatile *              status;     ///< Last completed seq
+      std::uint32_t                         status_bus; ///< Status bus address
+      frame_slot                            slots[2];   ///< Frame slots
+      std::uint32_t                         next_seq;   ///< Next frame's seq
+      std::unique_ptr<internal::spi0_dma_segment_spec[]> specs;///< Segments
+      std::vector<std::uint8_t const *>     rx_data;    ///< Segments' rx data
+      std::size_t                           tx_channel; ///< TX DMA channel
+      std::size_t                           rx_channel; ///< RX DMA channel
+
+      bool is_done(std::uint32_t seq) const;
+      void finish(frame_slot & slot);
+      void wait(std::uint32_t seq);
+
+    public:
+    /// @brief Take over SPI0 from a spi0_pins object for DMA transfers.
+    /// @param[in] sp             Open spi0_pins object. Must outlive this
+    ///                           object. Any conversation is stopped.
+    /// @param[in] max_frame_size Maximum number of bytes in a frame.
+    /// @param[in] max_segments   Maximum number of segments in a frame
+    ///                           passed to submit_sequence. Defaults to 1.
+    /// @throws std::invalid_argument if max_frame_size or max_segments is
+    ///         zero, sp does not support standard 3-wire mode or sp does not
+    ///         use SPI0.
+    /// @throws bad_peripheral_alloc if two DMA channels are not available.
+    /// @throws std::system_error or std::bad_alloc if DMA memory cannot be
+    ///         obtained.
+      spi0_dma
+      ( spi0_pins & sp
+      , std::size_t max_frame_size
+      , std::size_t max_segments = 1U
+      );
+
+    /// @brief Abort any transfers, release DMA resources and return SPI0 to
+    /// non-DMA operation.
+      ~spi0_dma();
+
+      spi0_dma(spi0_dma const &) = delete;
+      spi0_dma & operator=(spi0_dma const &) = delete;
+      spi0_dma(spi0_dma &&) = delete;
+      spi0_dma & operator=(spi0_dma &&) = delete;
+
+    /// @brief Submit a frame for transfer.
+    ///
+    /// The transmit bytes are copied so tx may be reused on return. If a frame
+    /// is in flight the new frame is chained to start when it completes. If
+    /// two frames are already submitted and not waited for, waits for the
+    /// older one first.
+    ///
+    /// @param[in] c      Slave context for the frame. Must be for
+    ///                   spi0_mode::standard.
+    /// @param[in] tx     Bytes to transmit, or \c nullptr to transmit zeros.
+    /// @param[out] rx    Buffer for received bytes, or \c nullptr to discard
+    ///                   them. Must remain valid until the frame is waited
+    ///                   for.
+    /// @param[in] count  Number of bytes to transfer, [1, max_frame_size].
+    /// @returns Completion handle for the frame.
+    /// @throws std::invalid_argument if c is not for standard mode or count is
+    ///         out of range.
+      spi0_dma_transfer submit
+      ( spi0_slave_context const & c
+      , std::uint8_t const * tx
+      , std::uint8_t * rx
+      , std::size_t count
+      );
+
+    /// @brief Submit a sequence of segments, for any standard mode slave
+    /// contexts, for transfer as one frame.
+    ///
+    /// As submit, except that the frame is made up of the segments in turn,
+    /// each transferred with its own slave context's chip select, clock
+    /// polarity and phase and clock rate, with no CPU involvement between
+    /// segments.
+    ///
+    /// @param[in] segments Segments to transfer. Transmit bytes are copied;
+    ///                     receive buffers must remain valid until the frame
+    ///                     is waited for.
+    /// @param[in] count    Number of segments, [1, max_segments].
+    /// @returns Completion handle for the frame.
+    /// @throws std::invalid_argument if count is out of range, any segment's
+    ///         context is not for standard mode or has zero bytes, or the
+    ///         segments' total bytes exceed max_frame_size.
+      spi0_dma_transfer submit_sequence
+      ( spi0_dma_segment const * segments
+      , std::size_t count
+      );
+
+    /// @brief Returns the maximum number of segments in a frame.
+      std::size_t max_segments() const
+      {
+        return max_segs;
+      }
+
+    /// @brief Returns the maximum number of bytes in a frame.
+      std::size_t max_frame_size() const
+      {
+        return max_frame;
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_SPI0_DMA_H
@@ -25,6 +25,10 @@
 /// Broadcom BCM2835 ARM Peripherals Datasheet</a> Chapter 10 SPI for details
 /// along with additional information on SPI found in the Gertboard source code.
 ///
+/// The BCM2711 has four more controllers of the same design, SPI3 to SPI6,
+/// each with its own GPIO pins. A spi0_pins object may use any of them in
+/// place of SPI0 so up to five SPI buses can be driven in parallel.
+///
 /// @copyright Copyright (c) Dibase Limited 2013
 /// @author Ralph E. McArdell
 
@@ -32,6 +36,9 @@
 # define DIBASE_RPI_PERIPHERALS_SPI0_PINS_H
 # include "pin_id.h"
 # include "clockdefs.h"
+# include "wait_policy.h"
+# include "io_counters.h"
+# include "system_timer.h"
 # include <array>
 # include <cstdint>
 
@@ -51,11 +58,14 @@ namespace dibase { namespace rpi {
   /// @tparam MISO  SPIO MISO (SPI master in slave out) GPIO pin number
   ///               Optional, defaults to spi0_pin_not_used indicating no
   ///               MISO pin in the pin set. MISO is not used by 2-wire modes.
+  /// @tparam SPI   SPI controller number. Optional, defaults to 0 for SPI0.
+  ///               3 to 6 select the BCM2711 only SPI3 to SPI6.
     template  < pin_id_int_t CE0
               , pin_id_int_t CE1
               , pin_id_int_t SCLK
               , pin_id_int_t MOSI
               , pin_id_int_t MISO=spi0_pin_not_used
+              , unsigned SPI=0U
               >
     struct spi0_pin_set
     {
@@ -73,6 +83,9 @@ namespace dibase { namespace rpi {
 
     /// @returns Specialisation type's MISO parameter value
       constexpr pin_id_int_t miso() { return MISO; }
+
+    /// @returns Specialisation type's SPI parameter value
+      constexpr unsigned spi() { return SPI; }
     };
 
   /// @brief Full 5-pin SPI0 pin set provided by Raspberry Pi's P1 connector
@@ -82,6 +95,68 @@ namespace dibase { namespace rpi {
   /// connector
     constexpr spi0_pin_set<8U, 7U, 11U, 10U>    rpi_p1_spi0_2_wire_only_pin_set;
 
+  /// @brief Enumeration of the SPI0 functions of a spi0_pin_set's pins
+    enum class spi0_pin_fn : unsigned
+    { ce0   ///< Chip enable line 0
+    , ce1   ///< Chip enable line 1
+    , sclk  ///< SPI clock
+    , mosi  ///< Master out slave in
+    , miso  ///< Master in slave out
+    };
+
+  /// @brief GPIO pins supporting each SPI0 function, indexed by spi0_pin_fn
+  ///
+  /// From table 6-31 of the BCM2835 ARM Peripherals datasheet. On each of
+  /// these pins the SPI0 function is alternative function 0.
+    constexpr pin_id_int_t spi0_fn_pins[5][2]
+    { {8U, 36U}, {7U, 35U}, {11U, 39U}, {10U, 38U}, {9U, 37U} };
+
+  /// @brief Returns \c true if a GPIO pin supports a SPI0 function.
+  /// @param[in] pin  GPIO pin number
+  /// @param[in] fn   SPI0 function
+    constexpr bool spi0_pin_supports(pin_id_int_t pin, spi0_pin_fn fn)
+    {
+      return spi0_fn_pins[static_cast<unsigned>(fn)][0]==pin
+          || spi0_fn_pins[static_cast<unsigned>(fn)][1]==pin;
+    }
+
+  /// @brief GPIO pins supporting each function of the BCM2711 only SPI3 to
+  /// SPI6 controllers, indexed by controller number less 3 then spi0_pin_fn
+  ///
+  /// From section 5.3 of the BCM2711 ARM Peripherals datasheet. The CE1
+  /// functions are alternative function 5, the others alternative
+  /// function 3.
+    constexpr pin_id_int_t bcm2711_spi_fn_pins[4][5]
+    { { 0U, 24U,  3U,  2U,  1U}
+    , { 4U, 25U,  7U,  6U,  5U}
+    , {12U, 26U, 15U, 14U, 13U}
+    , {18U, 27U, 21U, 20U, 19U}
+    };
+
+  /// @brief Returns \c true if a SPI controller number is one of the BCM2711
+  /// only SPI3 to SPI6.
+  /// @param[in] spi  SPI controller number
+    constexpr bool is_bcm2711_spi(unsigned spi)
+    {
+      return spi>=3U && spi<=6U;
+    }
+
+  /// @brief Returns \c true if a GPIO pin supports a function of a SPI
+  /// controller of the SPI0 design.
+  /// @param[in] pin  GPIO pin number
+  /// @param[in] spi  SPI controller number: 0, or 3 to 6
+  /// @param[in] fn   SPI function
+    constexpr bool spi_pin_supports
+    ( pin_id_int_t pin
+    , unsigned spi
+    , spi0_pin_fn fn
+    )
+    {
+      return spi==0U ? spi0_pin_supports(pin, fn)
+           : is_bcm2711_spi(spi)
+          && bcm2711_spi_fn_pins[spi-3U][static_cast<unsigned>(fn)]==pin;
+    }
+
   /// @brief Enumeration of SPI0 chip select polarity options
     enum class spi0_cs_polarity
     { low   ///< Active (asserted) low
@@ -102,6 +177,30 @@ namespace dibase { namespace rpi {
     , command   ///< Writing LoSSI command to slave device
     };
 
+  /// @brief Describes one buffer of a scatter/gather SPI0 transfer
+    struct spi0_iovec
+    {
+      std::uint8_t const *  tx;     ///< Bytes to write, nullptr to write zeros
+      std::uint8_t *        rx;     ///< Buffer for read bytes, nullptr discards
+      std::size_t           count;  ///< Number of bytes
+    };
+
+  /// @brief Outcome of a spi0_pins write_all or read_all call
+    enum class spi0_io_status
+    { complete      ///< All bytes were transferred
+    , timed_out     ///< The time out expired before all bytes were transferred
+    , not_supported ///< Not conversing, or the call is not possible in the
+                    ///< conversation's mode - nothing was transferred
+    };
+
+  /// @brief Number of bytes transferred and outcome of a spi0_pins write_all
+  /// or read_all call
+    struct spi0_io_result
+    {
+      std::size_t     bytes;  ///< Number of bytes transferred
+      spi0_io_status  status; ///< Outcome of the call
+    };
+
   /// @brief Enumeration of valid SPI0 slave devices chip numbers
   /// 
   /// Note that only 2 devices are directly supported. Although the field is
@@ -149,6 +248,11 @@ namespace dibase { namespace rpi {
     class spi0_slave_context
     {
     friend class spi0_pins;
+    friend class spi0_dma;
+    friend class spi0_transaction_queue;
+    friend class spi0_sampler;
+    friend class bus_broker;
+    friend class remote_server;
 
       std::uint32_t cs_reg;
       std::uint32_t clk_reg;
@@ -222,12 +326,27 @@ namespace dibase { namespace rpi {
   ///
   /// Once constructed spi0_slave_context objects may be used with the
   /// spi0_pins object to allow communicating with slave devices.
+  ///
+  /// Construction switches between the SPI0 and GPIO peripherals and so is
+  /// fenced with peripheral_barrier() calls. All other operations access only
+  /// SPI0 registers - and, while waiting, the system timer for write_all and
+  /// read_all deadlines - and contain no barriers: callers touching other
+  /// peripherals between them should use peripheral_barrier() themselves.
     class spi0_pins
     {
       constexpr static unsigned number_of_pins = 5U;
 
       std::array<pin_id_int_t, number_of_pins>  pins;
+      unsigned                                  spi_num; // 0 or 3..6
       spi0_mode                                 mode;
+      bool                                      lossi_long_words;
+      std::uint32_t                             cs_polarity_bits;
+      wait_policy                               waiting;
+      wait_stats                                wait_counts;
+      io_counter_set                            counters;
+
+      void release();
+      std::uint32_t interrupt_bits() const;
 
       void construct
       ( pin_id ce0
@@ -235,6 +354,7 @@ namespace dibase { namespace rpi {
       , pin_id sclk
       , pin_id mosi
       , pin_id miso
+      , unsigned spi
       , spi0_cs_polarity  cspol0
       , spi0_cs_polarity  cspol1
       );
@@ -257,6 +377,7 @@ namespace dibase { namespace rpi {
     /// @tparam SCLK  spi0_pin_set SCLK template parameter.
     /// @tparam MOSI  spi0_pin_set MOSI template parameter.
     /// @tparam MISO  spi0_pin_set MISO template parameter.
+    /// @tparam SPI   spi0_pin_set SPI template parameter.
     ///
     /// @param[in] ps     spi0_pin_set specialisation specifying the set of
     ///                   GPIO pins to use for the various SPI0 functions.
@@ -265,27 +386,49 @@ namespace dibase { namespace rpi {
     /// @param[in] cspol1 Chip 1 select polarity. Defaults to chip select
     ///                   line asserted when low (CE1 is low).
     ///
-    /// @throws std::invalid_argument if any requested pin does not support the
-    ///         required special function.
-    /// @throws std::range_error if any pin supports the same SPI0 function
-    ///         by more than one alternative function (should not be possible).
-    /// @throws bad_peripheral_alloc if either any of the pins or the SPI0
+    /// Each pin's support for its SPI function is checked at compile time:
+    /// a pin set with a pin that does not support its function fails to
+    /// compile.
+    ///
+    /// @throws std::invalid_argument if the pin set is for one of SPI3 to
+    ///         SPI6 and the running SoC is not a BCM2711.
+    /// @throws bad_peripheral_alloc if either any of the pins or the SPI
     ///         peripheral are already in use.
       template  < pin_id_int_t CE0
                 , pin_id_int_t CE1
                 , pin_id_int_t SCLK
                 , pin_id_int_t MOSI
                 , pin_id_int_t MISO
+                , unsigned SPI
                 >
       explicit spi0_pins
-      ( spi0_pin_set<CE0,CE1,SCLK,MOSI,MISO> ps
+      ( spi0_pin_set<CE0,CE1,SCLK,MOSI,MISO,SPI> ps
       , spi0_cs_polarity  cspol0 = spi0_cs_polarity::low
       , spi0_cs_polarity  cspol1 = spi0_cs_polarity::low
       )
       {
+        static_assert( SPI==0U || is_bcm2711_spi(SPI)
+                     , "spi0_pins: SPI controller is not 0 or 3 to 6"
+                     );
+        static_assert( spi_pin_supports(CE0, SPI, spi0_pin_fn::ce0)
+                     , "spi0_pins: CE0 pin does not support SPI CE0"
+                     );
+        static_assert( spi_pin_supports(CE1, SPI, spi0_pin_fn::ce1)
+                     , "spi0_pins: CE1 pin does not support SPI CE1"
+                     );
+        static_assert( spi_pin_supports(SCLK, SPI, spi0_pin_fn::sclk)
+                     , "spi0_pins: SCLK pin does not support SPI SCLK"
+                     );
+        static_assert( spi_pin_supports(MOSI, SPI, spi0_pin_fn::mosi)
+                     , "spi0_pins: MOSI pin does not support SPI MOSI"
+                     );
+        static_assert( MISO==spi0_pin_not_used
+                    || spi_pin_supports(MISO, SPI, spi0_pin_fn::miso)
+                     , "spi0_pins: MISO pin does not support SPI MISO"
+                     );
         construct ( pin_id(ps.ce0()), pin_id(ps.ce1())
                   , pin_id(ps.sclk()), pin_id(ps.mosi()), pin_id(ps.miso())
-                  , cspol0, cspol1
+                  , ps.spi(), cspol0, cspol1
                   );
       }
 
@@ -297,8 +440,16 @@ namespace dibase { namespace rpi {
 
       spi0_pins(spi0_pins const &) = delete;
       spi0_pins& operator=(spi0_pins const &) = delete;
-      spi0_pins(spi0_pins &&) = delete;
-      spi0_pins& operator=(spi0_pins &&) = delete;
+
+    /// @brief Move construct, taking over other's pins and the SPI0
+    /// peripheral.
+    ///
+    /// other is left owning nothing: it may only be destroyed or assigned to.
+      spi0_pins(spi0_pins && other) noexcept;
+
+    /// @brief Move assign: release anything owned by this object as for
+    /// destruction then take over other's pins and the SPI0 peripheral.
+      spi0_pins& operator=(spi0_pins && other);
 
     /// @brief Applies a spi0_slave_context, replacing any existing context and
     /// starts data transfers (CS register TA field == 1).
@@ -318,6 +469,30 @@ namespace dibase { namespace rpi {
     ///         (i.e. \c c.mode==spi0_mode::standard && ! has_std_mode_support()).
       void  start_conversing(spi0_slave_context const & c);
 
+    /// @brief Switch conversation to a slave context with the fewest SPI0
+    /// register accesses.
+    ///
+    /// Has the same effect as start_conversing but is intended for switching
+    /// rapidly between slave devices. The slave context's precomputed
+    /// register values are written directly, with no reads of SPI0 registers
+    /// and no field by field read-modify-writes: one CS register write stops
+    /// transfers and clears both FIFOs, the CLK and, for LoSSI mode, LTOH
+    /// registers are written, then a second CS register write starts
+    /// transfers. The chip select line polarities passed on construction are
+    /// retained.
+    ///
+    /// As for start_conversing any data in the FIFOs is discarded, so wait
+    /// for the previous conversation's transfers to complete before
+    /// switching.
+    ///
+    /// @post The SPI0 data transfer context will be that represented by the
+    ///       object passed for the \c c parameter.
+    ///
+    /// @param  c   Conversation object specifying context for conversation.
+    /// @throws std::invalid_argument if slave context is for 3-wire
+    ///         standard mode and only 2-wire mode pins have been allocated.
+      void  switch_conversation(spi0_slave_context const & c);
+
     /// @brief Stop data transfers.
     /// @post Transfer Active field is \c false, stopping further data transfer
     ///       Communication mode is set to spi0_mode::none for the purposes of
@@ -336,7 +511,7 @@ namespace dibase { namespace rpi {
       bool write
       ( std::uint8_t data
       , spi0_lossi_write lossi_write_type=spi0_lossi_write::data
-      );
+      ) noexcept;
 
     /// @brief Write bytes from buffer to the transmit FIFO
     ///
@@ -345,6 +520,12 @@ namespace dibase { namespace rpi {
     /// Write command  bytes using the single-byte overload of write with
     /// lossi_write_type==spi0_lossi_write::command.
     ///
+    /// @note
+    /// In LoSSI mode with long word writes enabled (see 
+    /// set_lossi_long_word_writes) bytes are packed four to a FIFO
+    /// write so only whole multiples of 4 bytes are written. Write any
+    /// remaining bytes after disabling long word writes.
+    ///
     /// @param[in] pdata  Pointer to data bytes to be written.
     /// @param[in] count  Maximum number of bytes to write.
     /// @returns  Number of bytes actually written. Less than \c count if FIFO
@@ -353,7 +534,7 @@ namespace dibase { namespace rpi {
       std::size_t write
       ( std::uint8_t const * pdata
       , std::size_t count
-      );
+      ) noexcept;
 
     /// @brief Read a single byte from the receive FIFO
     ///
@@ -401,6 +582,189 @@ namespace dibase { namespace rpi {
       , std::size_t * ppending_count=nullptr
       );
 
+    /// @brief Full-duplex transfer: write bytes and read the bytes clocked in
+    ///
+    /// Blocks until count bytes have been written to and count bytes read
+    /// from the slave device. The transmit FIFO is kept topped up while the
+    /// receive FIFO is drained in the same loop so the bus does not idle
+    /// between bytes. No more than a FIFO's worth of bytes are ever in flight,
+    /// so the receive FIFO cannot overflow.
+    ///
+    /// @note
+    /// Only supported for spi0_mode::standard conversations.
+    ///
+    /// @param[in] ptx    Pointer to data bytes to be written. May be
+    ///                   \c nullptr in which case zero bytes are written.
+    /// @param[out] prx   Pointer to data buffer to receive read values. May be
+    ///                   \c nullptr in which case read values are discarded.
+    /// @param[in] count  Number of bytes to write and read.
+    /// @returns  Number of bytes transferred: \c count, or zero if the
+    ///           communication mode is not spi0_mode::standard.
+      std::size_t transfer
+      ( std::uint8_t const * ptx
+      , std::uint8_t * prx
+      , std::size_t count
+      );
+
+    /// @brief Full-duplex scatter/gather transfer of a sequence of buffers
+    ///
+    /// As \ref transfer but the bytes are written from and read into the
+    /// buffers described by iov, in order and back to back, so the buffers are
+    /// transferred as one continuous stream without being copied together
+    /// first.
+    ///
+    /// @param[in] iov        Pointer to array of buffer descriptors.
+    /// @param[in] iov_count  Number of buffer descriptors in iov.
+    /// @returns  Number of bytes transferred: the sum of the descriptors'
+    ///           counts, or zero if the communication mode is not
+    ///           spi0_mode::standard.
+      std::size_t transfer_iov
+      ( spi0_iovec const * iov
+      , std::size_t iov_count
+      );
+
+    /// @brief Write a sequence of buffers back to back, discarding read bytes
+    ///
+    /// Equivalent to transfer_iov with all the descriptors' rx members
+    /// \c nullptr; the rx members of iov are not used. Blocks until all bytes
+    /// have been sent.
+    ///
+    /// @param[in] iov        Pointer to array of buffer descriptors.
+    /// @param[in] iov_count  Number of buffer descriptors in iov.
+    /// @returns  Number of bytes written, or zero if the communication mode
+    ///           is not spi0_mode::standard.
+      std::size_t write_gather
+      ( spi0_iovec const * iov
+      , std::size_t iov_count
+      );
+
+    /// @brief Write a whole buffer, waiting for FIFO space, with a time out
+    ///
+    /// Unlike \ref write, which writes only as many bytes as the transmit
+    /// FIFO has space for, write_all refills the FIFO using the wait policy
+    /// while waiting for space, until all bytes are written and the DONE flag
+    /// shows they have been sent, or the time out expires. In standard mode
+    /// the bytes clocked in are discarded so the receive FIFO cannot fill and
+    /// stall the transfer.
+    ///
+    /// LoSSI writes are of parameter data, packed 4 bytes per FIFO write if
+    /// long word writes are enabled, in which case count must be a multiple
+    /// of 4.
+    ///
+    /// @param[in] pdata    Pointer to data bytes to be written.
+    /// @param[in] count    Number of bytes to write.
+    /// @param[in] timeout  Longest time to wait for FIFO space or DONE in
+    ///                     total. The deadline is only checked while waiting.
+    /// @returns  Bytes written and spi0_io_status::complete,
+    ///           spi0_io_status::timed_out if the time out expired or
+    ///           spi0_io_status::not_supported if not conversing or count is
+    ///           not a multiple of 4 for LoSSI long word writes. Bytes
+    ///           written to the FIFO before a time out may still be sent.
+      spi0_io_result write_all
+      ( std::uint8_t const * pdata
+      , std::size_t count
+      , system_timer::duration timeout
+      );
+
+    /// @brief Read a whole buffer, waiting for received data, with a time out
+    ///
+    /// Unlike \ref read, which returns only bytes already in the receive
+    /// FIFO, read_all waits for data using the wait policy until count bytes
+    /// have been read or the time out expires. In standard mode zero bytes
+    /// are written to clock in the data, and in bidirectional mode count
+    /// reads are initiated, never more than a FIFO's worth ahead. In LoSSI
+    /// mode read_all waits for the data following a read command previously
+    /// written to the slave device.
+    ///
+    /// @param[out] pdata   Pointer to data buffer to receive read values.
+    /// @param[in] count    Number of bytes to read.
+    /// @param[in] timeout  Longest time to wait for received data in total.
+    ///                     The deadline is only checked while waiting.
+    /// @returns  Bytes read and spi0_io_status::complete,
+    ///           spi0_io_status::timed_out if the time out expired or
+    ///           spi0_io_status::not_supported if not conversing.
+      spi0_io_result read_all
+      ( std::uint8_t * pdata
+      , std::size_t count
+      , system_timer::duration timeout
+      );
+
+    /// @brief Enable or disable LoSSI long word writes for the current
+    /// conversation.
+    ///
+    /// When enabled, buffer writes pack four parameter data bytes into each
+    /// 32-bit FIFO write, sent in buffer order, cutting FIFO accesses and
+    /// FIFO status checks by a factor of 4. Single byte writes fail while
+    /// enabled as each FIFO write would send four bytes.
+    ///
+    /// @note
+    /// Setting takes effect after any data already in the transmit FIFO has
+    /// been sent so wait for write_fifo_is_empty() before changing it. It is
+    /// disabled by start_conversing and stop_conversing.
+    ///
+    /// @param[in] enable \c true to pack 4 bytes per FIFO write,
+    ///                   \c false to write a byte per FIFO write.
+    /// @returns  \c true if the setting was changed, \c false if the
+    ///           communication mode is not spi0_mode::lossi.
+      bool set_lossi_long_word_writes(bool enable);
+
+    /// @brief Query whether LoSSI long word writes are enabled.
+    /// @returns \c true if buffer writes pack 4 bytes per FIFO write.
+      bool lossi_long_word_writes() const
+      {
+        return lossi_long_words;
+      }
+
+    /// @brief Set the wait policy used while transfer, transfer_iov,
+    /// write_gather, write_all and read_all wait for FIFO space or received
+    /// data.
+    ///
+    /// Defaults to a default constructed wait_policy.
+    ///
+    /// Supports interrupt waits: if p has an interrupt, which should be the
+    /// SPI0 interrupt, the SPI0 peripheral's interrupt on done and on RXR
+    /// are enabled so long transfers block on the interrupt once the
+    /// policy's spin stage ends. They are disabled again when a policy
+    /// without an interrupt is set.
+    /// @param[in] p  Policy to use.
+      void set_wait_policy(wait_policy const & p);
+
+    /// @brief Returns the wait policy in use.
+      wait_policy const & get_wait_policy() const
+      {
+        return waiting;
+      }
+
+    /// @brief Returns counts of waits by the stage they finished in.
+      wait_stats const & wait_statistics() const
+      {
+        return wait_counts;
+      }
+
+    /// @brief Reset wait counts to zero.
+      void reset_wait_statistics()
+      {
+        wait_counts = wait_stats{};
+      }
+
+    /// @brief Returns a snapshot of the performance counters.
+    ///
+    /// Counts bytes written and read, single byte and buffer writes and
+    /// reads stopped by a full transmit or empty receive FIFO, and polls made
+    /// while transfer, transfer_iov, write_gather, write_all and read_all
+    /// wait, and write_all and read_all time outs. All counts are zero
+    /// unless counting is enabled - see io_counters.h.
+      io_counters counter_snapshot() const
+      {
+        return counters.snapshot();
+      }
+
+    /// @brief Reset the performance counters to zero.
+      void reset_counters()
+      {
+        counters.reset();
+      }
+
     /// @brief Query whether there is an on going conversation.
     ///
     /// An ongoing conversation is one in which the communication
@@ -421,6 +785,14 @@ namespace dibase { namespace rpi {
     ///           \c false if only 2-wire protocols supported.
       bool has_std_mode_support() const;
 
+    /// @brief Query which SPI controller is used.
+    ///
+    /// @returns  0 for SPI0, or 3 to 6 for the BCM2711 only SPI3 to SPI6.
+      unsigned spi() const
+      {
+        return spi_num;
+      }
+
     /// @brief Query whether there is no data to write from the transmit FIFO.
     ///
     /// @returns \c true if there is no data to write from the transmit FIFO,
@@ -0,0 +1,137 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file spi0_sampler.h
+/// @brief Fixed rate sampling of a SPI0 slave device by a dedicated thread :
+/// class definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_SPI0_SAMPLER_H
+# define DIBASE_RPI_PERIPHERALS_SPI0_SAMPLER_H
+
+# include "spi0_pins.h"
+# include "spsc_ring.h"
+# include <array>
+# include <atomic>
+# include <exception>
+# include <initializer_list>
+# include <thread>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief One sample read by a spi0_sampler.
+    struct spi0_sample
+    {
+      std::uint64_t timestamp_us; ///< System timer time the sample was taken
+      std::uint32_t value;        ///< Received bytes, first most significant
+    };
+
+  /// @brief Samples a SPI0 slave device, such as an ADC, at a fixed rate.
+  ///
+  /// A spi0_sampler owns a sampling thread which, once per sample period,
+  /// performs a full-duplex spi0_pins::transfer of a fixed command with the
+  /// slave's chip select asserted for that transfer, timestamps the response
+  /// from the \ref system_timer and pushes it into a fixed capacity lock-free
+  /// single producer single consumer ring. One consumer thread pops samples
+  /// from the ring in batches.
+  ///
+  /// Sample times are scheduled from the system timer so the rate does not
+  /// drift. Short waits are busy-waits which keeps jitter low at high rates
+  /// (tens of kilohertz) at the cost of the sampling thread occupying a CPU;
+  /// restricting the thread to one CPU reduces pre-emption by other threads.
+  ///
+  /// Two counts are kept: overruns are samples discarded because the ring
+  /// was full, and late samples are sample periods missed entirely because
+  /// the thread was not scheduled in time, after which sampling resumes from
+  /// the current time.
+  ///
+  /// The spi0_pins object must outlive the sampler and must not be used by
+  /// other code while the sampler exists.
+    class spi0_sampler
+    {
+      spi0_pins &                   pins;
+      spi0_slave_context            context;
+      std::array<std::uint8_t, 4U>  command;
+      std::size_t                   command_size;
+      std::uint64_t                 period_ns;
+      spsc_ring<spi0_sample>        ring;
+      std::atomic<std::uint64_t>    overrun_count;
+      std::atomic<std::uint64_t>    late_count;
+      std::atomic<bool>             stopping;
+      std::atomic<bool>             sampler_failed;
+      std::exception_ptr            sampler_error;
+      std::thread                   sampler;
+
+      void take_samples();
+
+    public:
+    /// @brief Value for cpu parameter meaning do not set sampling thread's
+    /// CPU affinity.
+      static int const any_cpu = -1;
+
+    /// @brief Construct and start the sampling thread.
+    /// @param[in] sp       Open spi0_pins object with standard mode support.
+    ///                     Any conversation is stopped.
+    /// @param[in] c        Slave context of the device to sample. Must be for
+    ///                     spi0_mode::standard.
+    /// @param[in] cmd      Command bytes written for each sample. As many
+    ///                     bytes are received. From 1 to 4 bytes.
+    /// @param[in] rate     Sample rate, [1Hz, 1GHz].
+    /// @param[in] capacity Number of samples the ring can hold. Must be a
+    ///                     power of two.
+    /// @param[in] cpu      CPU the sampling thread is restricted to run on or
+    ///                     any_cpu.
+    /// @throws std::invalid_argument if sp does not support standard mode, c
+    ///         is not for standard mode, cmd has the wrong number of bytes,
+    ///         rate is out of range or capacity is not a power of two.
+    /// @throws std::system_error if the sampling thread cannot be created or
+    ///         its CPU affinity cannot be set.
+      spi0_sampler
+      ( spi0_pins & sp
+      , spi0_slave_context const & c
+      , std::initializer_list<std::uint8_t> cmd
+      , hertz rate
+      , std::size_t capacity
+      , int cpu = any_cpu
+      );
+
+    /// @brief Destroy, stopping and joining the sampling thread. The
+    /// conversation is stopped.
+      ~spi0_sampler();
+
+      spi0_sampler(spi0_sampler const &) = delete;
+      spi0_sampler& operator=(spi0_sampler const &) = delete;
+      spi0_sampler(spi0_sampler &&) = delete;
+      spi0_sampler& operator=(spi0_sampler &&) = delete;
+
+    /// @brief Pop available samples. Does not wait. Must only be called by
+    /// one thread at a time.
+    /// @param[out] samples  Array of at least max_samples samples to fill.
+    /// @param[in] max_samples  Maximum number of samples to pop.
+    /// @returns Number of samples popped into samples.
+    /// @throws Exception thrown by the sampling thread, once all samples it
+    ///         took before failing have been popped.
+      std::size_t pop(spi0_sample * samples, std::size_t max_samples);
+
+    /// @brief Returns number of samples discarded because the ring was full.
+      std::uint64_t overruns() const
+      {
+        return overrun_count.load(std::memory_order_relaxed);
+      }
+
+    /// @brief Returns number of sample periods missed.
+      std::uint64_t late_samples() const
+      {
+        return late_count.load(std::memory_order_relaxed);
+      }
+
+    /// @brief Returns the ring capacity.
+      std::size_t capacity() const
+      {
+        return ring.capacity();
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_SPI0_SAMPLER_H
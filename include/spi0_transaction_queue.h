@@ -0,0 +1,90 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file spi0_transaction_queue.h
+/// @brief Queue of SPI0 transactions run by a dedicated thread : class
+/// definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_SPI0_TRANSACTION_QUEUE_H
+# define DIBASE_RPI_PERIPHERALS_SPI0_TRANSACTION_QUEUE_H
+
+# include "spi0_pins.h"
+# include <condition_variable>
+# include <deque>
+# include <future>
+# include <mutex>
+# include <thread>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief SPI0 standard mode transactions from many threads run in order
+  /// by one worker thread.
+  ///
+  /// Each transaction is a slave context and bytes to transmit. The worker
+  /// performs a full-duplex spi0_pins::transfer for each transaction with the
+  /// slave's chip select asserted for the transaction's duration and delivers
+  /// the received bytes through a future.
+  ///
+  /// Applying a slave context rewrites the SPI0 CS, CLK and LTOH registers. If
+  /// consecutive transactions use the same spi0_slave_context object the
+  /// worker skips re-applying it and only toggles the CS register TA field to
+  /// deassert and reassert the chip select between them.
+  ///
+  /// The spi0_pins object and the slave contexts of queued transactions must
+  /// outlive the queue, and the spi0_pins object must not be used by other
+  /// code while the queue exists.
+    class spi0_transaction_queue
+    {
+    /// @brief Queued transaction.
+      struct job
+      {
+        spi0_slave_context const *              context;///< Slave context
+        std::vector<std::uint8_t>               tx;     ///< Bytes to transmit
+        std::promise<std::vector<std::uint8_t>> result; ///< Received bytes
+      };
+
+      spi0_pins &                 pins;
+      std::mutex                  guard;
+      std::condition_variable     job_available;
+      std::deque<job>             jobs;
+      bool                        stopping;
+      std::thread                 worker;
+
+      void run_jobs();
+
+    public:
+    /// @brief Construct and start the worker thread.
+    /// @param[in] sp Open spi0_pins object with standard mode support. Any
+    ///               conversation is stopped.
+    /// @throws std::invalid_argument if sp does not support standard 3-wire
+    ///         mode.
+    /// @throws std::system_error if the worker thread cannot be created.
+      explicit spi0_transaction_queue(spi0_pins & sp);
+
+    /// @brief Destroy: run any queued transactions then stop and join the
+    /// worker thread. The conversation is stopped.
+      ~spi0_transaction_queue();
+
+      spi0_transaction_queue(spi0_transaction_queue const &) = delete;
+      spi0_transaction_queue& operator=(spi0_transaction_queue const &) = delete;
+      spi0_transaction_queue(spi0_transaction_queue &&) = delete;
+      spi0_transaction_queue& operator=(spi0_transaction_queue &&) = delete;
+
+    /// @brief Queue a transaction. May be called from any thread.
+    /// @param[in] c  Slave context for the transaction. Must be for
+    ///               spi0_mode::standard and outlive the transaction.
+    /// @param[in] tx Bytes to transmit. As many bytes are received.
+    /// @returns Future for the received bytes.
+    /// @throws std::invalid_argument if c is not for standard mode or tx is
+    ///         empty.
+      std::future<std::vector<std::uint8_t>> submit
+      ( spi0_slave_context const & c
+      , std::vector<std::uint8_t> tx
+      );
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_SPI0_TRANSACTION_QUEUE_H
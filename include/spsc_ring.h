@@ -0,0 +1,124 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file spsc_ring.h
+/// @brief Fixed capacity lock-free single producer, single consumer ring
+/// buffer : class template definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_SPSC_RING_H
+# define DIBASE_RPI_PERIPHERALS_SPSC_RING_H
+
+# include <atomic>
+# include <memory>
+# include <cstddef>
+# include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Fixed capacity lock-free single producer, single consumer ring.
+  ///
+  /// One thread may push and one other thread may pop concurrently without
+  /// locking. The producer only writes the tail index and the consumer only
+  /// writes the head index, each published with release ordering and read
+  /// by the other with acquire ordering. The indexes are kept on separate
+  /// cache lines so the two threads do not contend for the same line.
+  ///
+  /// @tparam T Element type. Must be default constructible and copy
+  ///           assignable.
+    template <typename T>
+    class spsc_ring
+    {
+      static std::size_t const cache_line_size = 64U;
+
+      std::size_t const         mask;     ///< Capacity - 1 (capacity is 2^N)
+      std::unique_ptr<T[]>      elements; ///< Ring element storage
+      alignas(cache_line_size) std::atomic<std::size_t> head; ///< Next pop
+      alignas(cache_line_size) std::atomic<std::size_t> tail; ///< Next push
+
+      static std::size_t check_capacity(std::size_t capacity)
+      {
+        if (capacity==0U || (capacity&(capacity-1U))!=0U)
+          {
+            throw std::invalid_argument{"spsc_ring: capacity must be a "
+                                        "non-zero power of two."};
+          }
+        return capacity;
+      }
+
+    public:
+    /// @brief Construct an empty ring.
+    /// @param[in] capacity Maximum number of elements held. Must be a power
+    ///                     of two.
+    /// @throws std::invalid_argument if capacity is zero or not a power of
+    ///         two.
+      explicit spsc_ring(std::size_t capacity)
+      : mask{check_capacity(capacity)-1U}
+      , elements{new T[capacity]}
+      , head{0U}
+      , tail{0U}
+      {}
+
+      spsc_ring(spsc_ring const &) = delete;
+      spsc_ring& operator=(spsc_ring const &) = delete;
+
+    /// @brief Returns the maximum number of elements the ring can hold.
+      std::size_t capacity() const
+      {
+        return mask+1U;
+      }
+
+    /// @brief Returns the number of elements in the ring. Only exact if
+    /// neither producer nor consumer are active.
+      std::size_t size() const
+      {
+        return tail.load(std::memory_order_acquire)
+             - head.load(std::memory_order_acquire);
+      }
+
+    /// @brief Returns true if the ring holds no elements.
+      bool empty() const
+      {
+        return size()==0U;
+      }
+
+    /// @brief Push an element. Must only be called by the producer thread.
+    /// @param[in] v  Value to push.
+    /// @returns true if v was pushed, false if the ring was full.
+      bool try_push(T const & v)
+      {
+        std::size_t const t{tail.load(std::memory_order_relaxed)};
+        if (t-head.load(std::memory_order_acquire)>mask)
+          {
+            return false;
+          }
+        elements[t&mask] = v;
+        tail.store(t+1U, std::memory_order_release);
+        return true;
+      }
+
+    /// @brief Pop up to max_elements elements. Must only be called by the
+    /// consumer thread.
+    /// @param[out] out  Array of at least max_elements elements to fill.
+    /// @param[in]  max_elements  Maximum number of elements to pop.
+    /// @returns Number of elements popped into out.
+      std::size_t pop(T * out, std::size_t max_elements)
+      {
+        std::size_t const h{head.load(std::memory_order_relaxed)};
+        std::size_t available{tail.load(std::memory_order_acquire)-h};
+        if (available>max_elements)
+          {
+            available = max_elements;
+          }
+        for (std::size_t idx=0; idx!=available; ++idx)
+          {
+            out[idx] = elements[(h+idx)&mask];
+          }
+        head.store(h+available, std::memory_order_release);
+        return available;
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_SPSC_RING_H
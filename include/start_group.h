@@ -0,0 +1,93 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file start_group.h
+/// @brief Start PWM channels and GPCLK clocks together : class definition
+///
+/// pwm_pin::start and clock_pin::start each enable one output, reading the
+/// control register before writing it, so outputs started one after another
+/// are skewed by the calls between them. A start_group enables both PWM
+/// channels with a single PWM control register write and enables its clocks
+/// with back to back clock manager control register writes whose values are
+/// calculated beforehand.
+///
+/// Each start measures the time from just before the first enable write to
+/// just after the last one, which bounds the skew between the outputs'
+/// enables, and can record it into a latency_histogram.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_START_GROUP_H
+# define DIBASE_RPI_PERIPHERALS_START_GROUP_H
+
+# include "pwm_pin.h"
+# include "clock_pin.h"
+# include "latency_histogram.h"
+# include <array>
+# include <chrono>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Start and stop a group of PWM channels and clocks together.
+  ///
+  /// The pwm_pins and clock_pins added must outlive the start_group.
+  ///
+  /// The group accesses the PWM and clock manager peripherals so places a
+  /// peripheral_barrier() between them. The skew measured includes this
+  /// barrier.
+    class start_group
+    {
+      constexpr static std::size_t max_clocks = 3U; // GPCLK0..GPCLK2
+
+      std::uint32_t                       pwm_enables;
+      std::array<unsigned, max_clocks>    clocks;
+      std::size_t                         clock_count;
+      latency_histogram *                 skews;
+
+    public:
+    /// @brief Construct an empty group.
+      start_group();
+
+      start_group(start_group const &) = delete;
+      start_group& operator=(start_group const &) = delete;
+
+    /// @brief Add a PWM channel to the group.
+    /// @param[in] p  pwm_pin for the PWM channel to add.
+    /// @throws std::invalid_argument if p's PWM channel is already in the
+    ///         group.
+      void add(pwm_pin const & p);
+
+    /// @brief Add a clock to the group.
+    /// @param[in] c  clock_pin for the clock to add.
+    /// @throws std::invalid_argument if c's clock is already in the group.
+      void add(clock_pin const & c);
+
+    /// @brief Record the skew of each start into a histogram.
+    /// @param[in] h  Histogram to record to, \c nullptr (the default state)
+    ///               to stop recording. Must outlive the start_group or
+    ///               have recording stopped first.
+      void record_skews(latency_histogram * h)
+      {
+        skews = h;
+      }
+
+    /// @brief Start all the group's PWM channels and clocks together.
+    ///
+    /// Outputs already running are unaffected.
+    ///
+    /// @returns Time from just before the first enable write to just after
+    ///          the last.
+    /// @throws std::logic_error if a clock is busy, as it is for a short
+    ///         time after being stopped. Nothing is started.
+      std::chrono::nanoseconds start();
+
+    /// @brief Stop all the group's PWM channels and clocks.
+    ///
+    /// The PWM channels are stopped with a single write. Each clock stops
+    /// at the end of its current cycle.
+      void stop();
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_START_GROUP_H
@@ -0,0 +1,341 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file static_clock_parameters.h
+/// @brief Clock divisor and MASH filter parameters determined at compile
+/// time : type definitions.
+///
+/// A clock configuration fixed at build time can be given to clock_pin and
+/// pwm_pin::set_clock as a \ref static_clock_parameters instantiation's
+/// value. The divisor, MASH filtering mode and resultant frequencies are then
+/// calculated and checked by the compiler, using the same rules as for
+/// run-time clock set-up, so invalid frequencies fail to compile and set-up
+/// consists only of clock register writes.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_STATIC_CLOCK_PARAMETERS_H
+# define DIBASE_RPI_PERIPHERALS_STATIC_CLOCK_PARAMETERS_H
+
+# include "clockdefs.h"
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+    /// @brief Compile time clock parameter calculations.
+    ///
+    /// These mirror the calculations made by the run-time clock_parameters
+    /// constructor. MASH stages are numbered as clock_filter values.
+      namespace static_clock
+      {
+        constexpr std::uint32_t max_filter_hz{25000000U};
+        constexpr std::uint32_t max_hz{125000000U};
+        constexpr std::uint64_t divf_divisor{1024U};
+        constexpr std::uint32_t divi_max{0xfffU};
+
+      /// @brief Integer part of source/requested frequency ratio, zero if
+      /// requested frequency is zero.
+        constexpr std::uint32_t ratio_divi(std::uint32_t src, std::uint32_t f)
+        {
+          return f==0U ? 0U : src/f;
+        }
+
+      /// @brief Unfiltered DIVI, never zero so it is safe to divide by.
+        constexpr std::uint32_t base_divi(std::uint32_t src, std::uint32_t f)
+        {
+          return ratio_divi(src, f)==0U ? 1U : ratio_divi(src, f);
+        }
+
+      /// @brief Rounded fractional part of source/requested frequency ratio
+      /// in 1/1024ths.
+        constexpr std::uint32_t base_divf(std::uint32_t src, std::uint32_t f)
+        {
+          return f==0U ? 0U
+               : static_cast<std::uint32_t>
+                  ( ( (src-base_divi(src,f)*f)*divf_divisor + f/2U ) / f );
+        }
+
+      /// @brief DIVI decrement giving the maximum frequency of a MASH stage.
+        constexpr std::uint32_t max_offset(unsigned stage)
+        {
+          return stage==3U ? 3U : stage==2U ? 1U : 0U;
+        }
+
+      /// @brief DIVI increment giving the minimum frequency of a MASH stage.
+        constexpr std::uint32_t min_offset(unsigned stage)
+        {
+          return stage==3U ? 4U : stage==2U ? 2U : 1U;
+        }
+
+      /// @brief Returns true if a MASH stage can be used for a DIVI value
+      /// without exceeding the maximum filtered frequency.
+        constexpr bool stage_fits
+        ( std::uint32_t src
+        , std::uint32_t divi
+        , unsigned stage
+        )
+        {
+          return divi>max_offset(stage)
+              && src/(divi-max_offset(stage))<=max_filter_hz;
+        }
+
+      /// @brief Select the most filtering MASH stage, no more than requested,
+      /// that fits, 0 for none.
+        constexpr unsigned select_stage
+        ( std::uint32_t src
+        , std::uint32_t divi
+        , unsigned stage
+        )
+        {
+          return stage==0U ? 0U
+               : stage_fits(src, divi, stage) ? stage
+               : select_stage(src, divi, stage-1U);
+        }
+
+      /// @brief DIVI for the selected stage: rounded for integer division.
+        constexpr std::uint32_t divi
+        ( std::uint32_t src
+        , std::uint32_t f
+        , unsigned stage
+        )
+        {
+          return stage==0U
+              && base_divf(src, f)>=divf_divisor/2U
+              && base_divi(src, f)<divi_max
+               ? base_divi(src, f)+1U : base_divi(src, f);
+        }
+
+      /// @brief DIVF for the selected stage: zero for integer division.
+        constexpr std::uint32_t divf
+        ( std::uint32_t src
+        , std::uint32_t f
+        , unsigned stage
+        )
+        {
+          return stage==0U ? 0U : base_divf(src, f);
+        }
+
+      /// @brief Average frequency for a DIVI and DIVF.
+        constexpr std::uint32_t avg_hz
+        ( std::uint32_t src
+        , std::uint32_t divi
+        , std::uint32_t divf
+        )
+        {
+          return static_cast<std::uint32_t>
+                  (src*divf_divisor/(divi*divf_divisor+divf));
+        }
+
+      /// @brief Maximum frequency for a DIVI and stage.
+        constexpr std::uint32_t max_hz_for
+        ( std::uint32_t src
+        , std::uint32_t divi
+        , unsigned stage
+        )
+        {
+          return divi>max_offset(stage) ? src/(divi-max_offset(stage)) : max_hz;
+        }
+
+      /// @brief Minimum DIVI value allowed for a stage.
+        constexpr std::uint32_t divi_min(unsigned stage)
+        {
+          return stage==3U ? 5U : stage==2U ? 3U : stage==1U ? 2U : 1U;
+        }
+
+      /// @brief Returns true if the average frequency is within a tolerance,
+      /// in parts per million, of the requested frequency.
+        constexpr bool within_tolerance
+        ( std::uint32_t avg
+        , std::uint32_t f
+        , std::uint32_t ppm
+        )
+        {
+          return (avg>f ? avg-f : f-avg)*std::uint64_t{1000000U}
+                                                  <= std::uint64_t{ppm}*f;
+        }
+      } // namespace static_clock closed
+    } // namespace internal closed
+
+    template < clock_source Src, std::uint32_t SrcHz, std::uint32_t FreqHz
+             , clock_filter Filter, std::uint32_t TolerancePpm
+             >
+    struct static_clock_parameters;
+
+  /// @brief Clock source, divisor and MASH filtering values and resultant
+  /// frequencies determined at compile time.
+  ///
+  /// Only created by \ref static_clock_parameters, whose checks ensure that
+  /// the values are valid.
+    class static_clock_settings
+    {
+      template < clock_source Src, std::uint32_t SrcHz, std::uint32_t FreqHz
+               , clock_filter Filter, std::uint32_t TolerancePpm
+               >
+      friend struct static_clock_parameters;
+
+      clock_source  src_type;   ///< Clock source
+      hertz         src_freq;   ///< Clock source frequency
+      clock_filter  filter;     ///< MASH filtering mode
+      std::uint32_t divi_value; ///< Clock divisor DIVI field value
+      std::uint32_t divf_value; ///< Clock divisor DIVF field value
+      hertz         freq_min;   ///< Clock minimum frequency
+      hertz         freq_avg;   ///< Clock average frequency
+      hertz         freq_max;   ///< Clock maximum frequency
+
+      constexpr static_clock_settings
+      ( clock_source src
+      , hertz src_f
+      , clock_filter mash
+      , std::uint32_t divi
+      , std::uint32_t divf
+      , hertz min_f
+      , hertz avg_f
+      , hertz max_f
+      )
+      : src_type{src}
+      , src_freq{src_f}
+      , filter{mash}
+      , divi_value{divi}
+      , divf_value{divf}
+      , freq_min{min_f}
+      , freq_avg{avg_f}
+      , freq_max{max_f}
+      {}
+
+    public:
+    /// @brief Return clock source type
+      constexpr clock_source source() const { return src_type; }
+
+    /// @brief Return clock source frequency
+      constexpr hertz source_frequency() const { return src_freq; }
+
+    /// @brief Return MASH filtering mode, clock_filter::none for integer
+    /// division
+      constexpr clock_filter mash() const { return filter; }
+
+    /// @brief Return clock divisor DIVI field value
+      constexpr std::uint32_t divi() const { return divi_value; }
+
+    /// @brief Return clock divisor DIVF field value
+      constexpr std::uint32_t divf() const { return divf_value; }
+
+    /// @brief Return calculated clock minimum frequency
+      constexpr hertz frequency_min() const { return freq_min; }
+
+    /// @brief Return calculated clock average frequency
+      constexpr hertz frequency_avg() const { return freq_avg; }
+
+    /// @brief Return calculated clock maximum frequency
+      constexpr hertz frequency_max() const { return freq_max; }
+    };
+
+  /// @brief Tolerance value for static_clock_parameters accepting any
+  /// average frequency the divisor produces.
+    constexpr std::uint32_t static_clock_any_tolerance{1000000U};
+
+  /// @brief Calculate and check clock parameters at compile time.
+  ///
+  /// Follows the same rules as for clocks set-up at run time: the filter is
+  /// used as the most MASH filtering to apply, reduced if the maximum
+  /// frequency would exceed 25MHz. Parameters that would cause a run-time
+  /// set-up to throw cause a static assertion failure instead.
+  ///
+  /// Example: a 600KHz clock from the Raspberry Pi oscillator:
+  /// @code
+  /// clock_pin clk{ pin_id{4}
+  ///              , static_clock_parameters< clock_source::oscillator
+  ///                                       , 19200000U, 600000U
+  ///                                       >::value
+  ///              };
+  /// @endcode
+  /// @tparam Src           Clock source type.
+  /// @tparam SrcHz         Clock source frequency in Hertz.
+  /// @tparam FreqHz        Requested average frequency in Hertz.
+  /// @tparam Filter        Requested MASH filtering. Defaults to
+  ///                       clock_filter::none.
+  /// @tparam TolerancePpm  Allowed difference between requested and
+  ///                       resultant average frequency in parts per million.
+  ///                       Defaults to static_clock_any_tolerance.
+    template < clock_source Src, std::uint32_t SrcHz, std::uint32_t FreqHz
+             , clock_filter Filter = clock_filter::none
+             , std::uint32_t TolerancePpm = static_clock_any_tolerance
+             >
+    struct static_clock_parameters
+    {
+    private:
+      constexpr static unsigned stage
+        { internal::static_clock::select_stage
+            ( SrcHz
+            , internal::static_clock::base_divi(SrcHz, FreqHz)
+            , static_cast<unsigned>(Filter)
+            )
+        };
+      constexpr static std::uint32_t divi
+                      {internal::static_clock::divi(SrcHz, FreqHz, stage)};
+      constexpr static std::uint32_t divf
+                      {internal::static_clock::divf(SrcHz, FreqHz, stage)};
+      constexpr static std::uint32_t avg_hz
+                      {internal::static_clock::avg_hz(SrcHz, divi, divf)};
+      constexpr static std::uint32_t max_hz
+                      {stage==0U ? avg_hz
+                                 : internal::static_clock::max_hz_for
+                                                        (SrcHz, divi, stage)};
+      constexpr static std::uint32_t min_hz
+                      {stage==0U ? avg_hz
+                                 : SrcHz/( divi
+                                         + internal::static_clock::min_offset
+                                                                      (stage)
+                                         )};
+
+      static_assert( FreqHz!=0U
+                   , "static_clock_parameters: average frequency of zero is "
+                     "invalid."
+                   );
+      static_assert( FreqHz<=internal::static_clock::max_hz
+                  && ( Filter==clock_filter::none
+                    || FreqHz<=internal::static_clock::max_filter_hz
+                     )
+                   , "static_clock_parameters: average frequency too high, "
+                     "should be 25MHz or less."
+                   );
+      static_assert( internal::static_clock::ratio_divi(SrcHz, FreqHz)!=0U
+                   , "static_clock_parameters: source frequency lower than "
+                     "requested average frequency."
+                   );
+      static_assert( internal::static_clock::ratio_divi(SrcHz, FreqHz)
+                                        <=internal::static_clock::divi_max
+                   , "static_clock_parameters: source frequency too high for "
+                     "requested average frequency."
+                   );
+      static_assert( max_hz<=internal::static_clock::max_hz
+                   , "static_clock_parameters: clock frequency exceeds 125MHz "
+                     "absolute maximum."
+                   );
+      static_assert( divi>=internal::static_clock::divi_min(stage)
+                   , "static_clock_parameters: DIVI value too low for "
+                     "selected MASH mode."
+                   );
+      static_assert( internal::static_clock::within_tolerance
+                                              (avg_hz, FreqHz, TolerancePpm)
+                   , "static_clock_parameters: average frequency not within "
+                     "tolerance of requested frequency."
+                   );
+
+    public:
+    /// @brief The calculated clock parameters.
+      constexpr static static_clock_settings value
+                      { Src, hertz{SrcHz}, static_cast<clock_filter>(stage)
+                      , divi, divf, hertz{min_hz}, hertz{avg_hz}, hertz{max_hz}
+                      };
+    };
+
+    template < clock_source Src, std::uint32_t SrcHz, std::uint32_t FreqHz
+             , clock_filter Filter, std::uint32_t TolerancePpm
+             >
+    constexpr static_clock_settings
+      static_clock_parameters<Src, SrcHz, FreqHz, Filter, TolerancePpm>::value;
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_STATIC_CLOCK_PARAMETERS_H
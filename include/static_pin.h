@@ -0,0 +1,129 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file static_pin.h
+/// @brief Use a compile time specified GPIO pin for input or output : class
+/// template definitions.
+///
+/// \ref opin and \ref ipin determine which GPIO register bank and bit to
+/// access from a run time pin_id value. The static_opin and static_ipin class
+/// templates take the GPIO pin number as a template argument so the register
+/// bank and bit mask are compile time constants. A pointer to the relevant
+/// mapped register word is obtained once on construction, so put and get are
+/// inline and reduce to a single store or load of a constant.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_STATIC_PIN_H
+# define DIBASE_RPI_PERIPHERALS_STATIC_PIN_H
+
+# include "pin.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Register bank and mask constants for a compile time GPIO pin.
+  /// @tparam Pin BCM2835 GPIO pin number (0..53).
+    template <pin_id_int_t Pin>
+    struct static_pin_traits
+    {
+      static_assert( Pin<=pin_id::max_id
+                   , "static_pin_traits Pin argument is out of range"
+                   );
+
+    /// @brief Index of register in pair (GPxxx0 or GPxxx1) holding Pin's bit
+      constexpr static std::size_t bank = Pin/32U;
+
+    /// @brief Mask of Pin's bit in the bank's register word
+      constexpr static std::uint32_t mask = 1U<<(Pin%32U);
+    };
+
+    template <pin_id_int_t Pin>
+    constexpr std::size_t static_pin_traits<Pin>::bank;
+
+    template <pin_id_int_t Pin>
+    constexpr std::uint32_t static_pin_traits<Pin>::mask;
+
+  /// @brief Use a single compile time specified GPIO pin for output.
+  ///
+  /// Similar to \ref opin but with put an inline single register write.
+  /// @tparam Pin BCM2835 GPIO pin number (0..53).
+    template <pin_id_int_t Pin>
+    class static_opin
+    {
+      typedef static_pin_traits<Pin> traits;
+
+      opin pin;                                   ///< Opened GPIO pin
+      std::uint32_t volatile * const set_reg;     ///< Pin's GPSETn register
+      std::uint32_t volatile * const clear_reg;   ///< Pin's GPCLRn register
+
+    public:
+    /// @brief Create and open Pin for output
+    /// @exception  bad_pin_alloc if the GPIO pin is in use by this process
+    ///             or elsewhere.
+      static_opin()
+      : pin{pin_id{Pin}}
+      , set_reg{ internal::gpio_register_words()
+               + internal::gpset0_word_offset + traits::bank
+               }
+      , clear_reg{ internal::gpio_register_words()
+                 + internal::gpclr0_word_offset + traits::bank
+                 }
+      {}
+
+    /// @brief Set the output pin to the specified state
+    /// @param[in]  v Value to output:  true to set pin state high,
+    ///                                 false set pin state low
+      void put( bool v )
+      {
+        *(v ? set_reg : clear_reg) = traits::mask;
+      }
+
+    /// @brief Returns the pin id of the GPIO pin open on this object.
+      pin_id get_pin() const
+      {
+        return pin_id{Pin};
+      }
+    };
+
+  /// @brief Use a single compile time specified GPIO pin for input.
+  ///
+  /// Similar to \ref ipin but with get an inline single register read.
+  /// @tparam Pin BCM2835 GPIO pin number (0..53).
+    template <pin_id_int_t Pin>
+    class static_ipin
+    {
+      typedef static_pin_traits<Pin> traits;
+
+      ipin pin;                                   ///< Opened GPIO pin
+      std::uint32_t volatile const * const level_reg; ///< Pin's GPLEVn register
+
+    public:
+    /// @brief Create and open Pin for input
+    /// @param[in]  mode  Open mode for input pin. Specifies pull up/down
+    ///                   mode, default is ipin::pull_disable (no pull).
+    /// @exception  bad_pin_alloc if the GPIO pin is in use by this process
+    ///             or elsewhere.
+      explicit static_ipin( unsigned mode=ipin::pull_disable )
+      : pin{pin_id{Pin}, mode}
+      , level_reg{ internal::gpio_register_words()
+                 + internal::gplev0_word_offset + traits::bank
+                 }
+      {}
+
+    /// @brief Return the current state of the input pin
+    /// @return true if pin is in a high state
+    ///         false if pin is in a low state
+      bool get() const
+      {
+        return (*level_reg & traits::mask)!=0U;
+      }
+
+    /// @brief Returns the pin id of the GPIO pin open on this object.
+      pin_id get_pin() const
+      {
+        return pin_id{Pin};
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_STATIC_PIN_H
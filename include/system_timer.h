@@ -0,0 +1,70 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file system_timer.h
+/// @brief Microsecond timestamps and short delays using the BCM2835 system
+/// timer : type definitions.
+///
+/// The BCM2835 system timer is a free running 64-bit counter incremented at
+/// 1MHz. Reading it is a pair of memory mapped register reads rather than a
+/// system call, so it is a cheap source of timestamps and allows short busy
+/// wait delays without the scheduler latency of std::this_thread::sleep_for.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_SYSTEM_TIMER_H
+# define DIBASE_RPI_PERIPHERALS_SYSTEM_TIMER_H
+
+# include <chrono>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief Clock type reading the BCM2835 system timer.
+  ///
+  /// Meets the requirements of a std::chrono clock type so may be used with
+  /// std::chrono facilities, and provides busy-wait delay functions. The
+  /// epoch is the time the system timer counter was last reset, usually at
+  /// boot.
+    struct system_timer
+    {
+      typedef std::chrono::microseconds           duration;   ///< Tick type
+      typedef duration::rep                       rep;        ///< Count type
+      typedef duration::period                    period;     ///< Tick ratio
+      typedef std::chrono::time_point<system_timer> time_point;///< Timestamp
+
+    /// @brief Counter never goes backwards
+      constexpr static bool is_steady = true;
+
+    /// @brief Returns the current system timer time
+    /// @returns time_point constructed from the 64-bit system timer counter.
+      static time_point now()
+      {
+        return time_point{duration{static_cast<rep>(now_us())}};
+      }
+
+    /// @brief Returns the current system timer raw count
+    /// @returns 64-bit system timer counter value in microseconds.
+      static std::uint64_t now_us();
+
+    /// @brief Busy-wait for at least the specified number of microseconds.
+    ///
+    /// Polls the system timer and so will not return early. It may return up
+    /// to a microsecond late, later if the calling thread is pre-empted.
+    ///
+    /// @param[in]  us  Number of microseconds to wait for.
+      static void delay_us(std::uint32_t us);
+
+    /// @brief Busy-wait for approximately the specified number of nanoseconds.
+    ///
+    /// Whole microseconds are waited for as for \ref delay_us. The sub
+    /// microsecond remainder is waited for by spinning a loop whose iteration
+    /// rate is calibrated against the system timer on first use (which takes
+    /// about a millisecond) so is only as accurate as that calibration.
+    ///
+    /// @param[in]  ns  Number of nanoseconds to wait for.
+      static void delay_ns(std::uint32_t ns);
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_SYSTEM_TIMER_H
@@ -0,0 +1,109 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file uart0_dma_rx.h
+/// @brief DMA receive ring buffer for UART0 : class definition.
+///
+/// At high baud rates the 16 entry UART0 receive FIFO fills in little more
+/// than a hundred microseconds, less than a scheduler time slice. A
+/// uart0_dma_rx object has a DMA channel copy each received FIFO entry, paced
+/// by the UART0 receive DREQ, into a ring buffer, so bytes are not lost while
+/// the reading thread is not running. The ring is read from user space by
+/// comparing the DMA channel's current destination address with the last
+/// position read.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_UART0_DMA_RX_H
+# define DIBASE_RPI_PERIPHERALS_UART0_DMA_RX_H
+
+# include "uart0_pins.h"
+# include <memory>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      class dma_arena;
+    }
+
+  /// @brief Receive UART0 data by DMA into a ring buffer.
+  ///
+  /// One self-linked DMA control block copies UART0 data register words to
+  /// successive ring entries, restarting at the first when the last is
+  /// written. Each entry is the full 32-bit data register value, so the
+  /// line error flags of each byte are kept and counted on reading. Bytes
+  /// must be read before the ring wraps around onto them: within ring size
+  /// character times.
+  ///
+  /// Only receiving is by DMA: writes are made through the uart0_pins object
+  /// as usual.
+    class uart0_dma_rx
+    {
+      uart0_pins &                        uart;       ///< UART0 pins in use
+      std::unique_ptr<internal::dma_arena> memory;    ///< Ring and CB memory
+      std::uint32_t const volatile *      ring;       ///< Ring entries
+      std::size_t                         ring_size;  ///< Entries in ring
+      std::uint32_t                       ring_bus;   ///< Ring bus address
+      std::size_t                         dma_channel;///< Running channel
+      std::size_t                         tail;       ///< Next entry to read
+      uart0_line_errors                   errors;     ///< Line error counts
+
+      std::size_t head() const;
+
+    public:
+    /// @brief Default number of ring buffer entries
+      constexpr static std::size_t default_ring_size = 4096U;
+
+    /// @brief Reserve a DMA channel and start receiving into the ring.
+    ///
+    /// Any bytes already in the UART0 receive FIFO are received into the
+    /// ring.
+    ///
+    /// @param[in] pins   UART0 pins object to receive data from. Must
+    ///                   outlive this object.
+    /// @param[in] size   Number of ring buffer entries - bytes. Defaults to
+    ///                   default_ring_size.
+    /// @throws std::invalid_argument if size is zero.
+    /// @throws bad_peripheral_alloc if a DMA channel is not available.
+    /// @throws std::system_error or std::bad_alloc if DMA memory cannot be
+    ///         obtained.
+      explicit uart0_dma_rx
+      ( uart0_pins & pins
+      , std::size_t size = default_ring_size
+      );
+
+    /// @brief Stop receiving by DMA and release the DMA channel.
+      ~uart0_dma_rx();
+
+      uart0_dma_rx(uart0_dma_rx const &) = delete;
+      uart0_dma_rx& operator=(uart0_dma_rx const &) = delete;
+
+    /// @brief Returns number of received entries not yet read.
+      std::size_t available() const;
+
+    /// @brief Read received bytes from the ring.
+    ///
+    /// Break entries are counted and not returned. Framing, parity and
+    /// overrun errors are counted - see line_errors().
+    ///
+    /// @param[out] pdata Pointer to data buffer to receive read values.
+    /// @param[in] count  Maximum number of entries to read.
+    /// @returns  Number of bytes read.
+      std::size_t read(std::uint8_t * pdata, std::size_t count);
+
+    /// @brief Returns counts of receive line errors of entries read.
+      uart0_line_errors const & line_errors() const
+      {
+        return errors;
+      }
+
+    /// @brief Returns number of ring buffer entries.
+      std::size_t size() const
+      {
+        return ring_size;
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_UART0_DMA_RX_H
@@ -0,0 +1,429 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file uart0_pins.h
+/// @brief Use a set of GPIO pins for use with the UART0 (PL011) serial
+/// interface: type definitions.
+///
+/// The BCM2835 has two UARTs: the ARM PrimeCell PL011 designated UART0 and
+/// the auxiliary mini UART (UART1). Only UART0 is supported here. It has 16
+/// entry transmit and receive FIFOs, a fractional baud rate divisor and
+/// hardware RTS/CTS flow control, and can be serviced by DMA.
+///
+/// A group of 2 GPIO pins, TXD and RXD, is required, plus optionally CTS and
+/// RTS for hardware flow control.
+///
+/// Reads and writes move FIFO-level bursts of bytes without checking status
+/// flags for each byte where the FIFO status allows, and the receive timeout
+/// status - set after 32 bit periods with no new data while the receive FIFO
+/// holds data - is used to find the end of message frames, so protocols such
+/// as Modbus RTU, that delimit frames by line idle time, and DMX512, that
+/// delimits them with breaks, can be handled from user space at rates up to
+/// the UART clock frequency divided by 16.
+///
+/// For more details see the
+/// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+/// Broadcom BCM2835 ARM Peripherals Datasheet</a> Chapter 13 UART along with
+/// the ARM PrimeCell UART (PL011) Technical Reference Manual.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_UART0_PINS_H
+# define DIBASE_RPI_PERIPHERALS_UART0_PINS_H
+# include "pin_id.h"
+# include "clockdefs.h"
+# include "system_timer.h"
+# include "wait_policy.h"
+# include "io_counters.h"
+# include <array>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+  /// @brief GPIO pin id used to indicate unused or not required pin
+  ///
+  /// Note that GPIO pin 53 has no useful alternative special functions
+    constexpr pin_id_int_t uart0_pin_not_used{53U};
+
+  /// @brief Simple constexpr type template to hold UART0 pin sets
+  /// @tparam TXD   UART0 TXD (transmit data) GPIO pin number
+  /// @tparam RXD   UART0 RXD (receive data) GPIO pin number
+  /// @tparam CTS   UART0 CTS (clear to send) GPIO pin number. Optional,
+  ///               defaults to uart0_pin_not_used indicating no CTS flow
+  ///               control.
+  /// @tparam RTS   UART0 RTS (request to send) GPIO pin number. Optional,
+  ///               defaults to uart0_pin_not_used indicating no RTS flow
+  ///               control.
+    template  < pin_id_int_t TXD
+              , pin_id_int_t RXD
+              , pin_id_int_t CTS=uart0_pin_not_used
+              , pin_id_int_t RTS=uart0_pin_not_used
+              >
+    struct uart0_pin_set
+    {
+    /// @returns Specialisation type's TXD parameter value
+      constexpr pin_id_int_t txd() { return TXD; }
+
+    /// @returns Specialisation type's RXD parameter value
+      constexpr pin_id_int_t rxd() { return RXD; }
+
+    /// @returns Specialisation type's CTS parameter value
+      constexpr pin_id_int_t cts() { return CTS; }
+
+    /// @returns Specialisation type's RTS parameter value
+      constexpr pin_id_int_t rts() { return RTS; }
+    };
+
+  /// @brief 2-pin UART0 pin set provided by Raspberry Pi's P1 connector
+    constexpr uart0_pin_set<14U, 15U>  rpi_p1_uart0_pin_set;
+
+  /// @brief Enumeration of UART0 parity options
+    enum class uart0_parity
+    { none  ///< No parity bit
+    , odd   ///< Odd parity
+    , even  ///< Even parity
+    , mark  ///< Parity bit always 1
+    , space ///< Parity bit always 0
+    };
+
+  /// @brief Enumeration of UART0 stop bit options
+    enum class uart0_stop_bits
+    { one   ///< One stop bit
+    , two   ///< Two stop bits
+    };
+
+  /// @brief Counts of receive line errors
+    struct uart0_line_errors
+    {
+      uart0_line_errors()
+      : framing{0U}
+      , parity{0U}
+      , breaks{0U}
+      , overruns{0U}
+      {}
+
+      std::uint64_t framing;  ///< Bytes received without a valid stop bit
+      std::uint64_t parity;   ///< Bytes received with a parity error
+      std::uint64_t breaks;   ///< Break conditions received
+      std::uint64_t overruns; ///< Receive FIFO overflows
+    };
+
+  /// @brief UART0 line settings: baud rate, data bits, parity and stop bits.
+  ///
+  /// Holds the UART0 IBRD, FBRD and LCRH register values for the settings.
+  /// The baud rate divisor is the UART clock frequency divided by 16 times
+  /// the baud rate, to the nearest 64th, so the achieved baud rate may
+  /// differ slightly from that requested - see actual_baud().
+  ///
+  /// As all of these are value types uart0_line_settings objects can be
+  /// copied and assigned.
+    class uart0_line_settings
+    {
+    friend class uart0_pins;
+
+      std::uint32_t ibrd_reg;
+      std::uint32_t fbrd_reg;
+      std::uint32_t lcrh_reg;
+      hertz         clock;
+
+    public:
+    /// @brief Construct from line setting parameters
+    ///
+    /// @param[in] baud       Required baud rate, [\c fc/(16*65535), \c fc/16].
+    /// @param[in] data_bits  Data bits per character [5,8]. Defaults to 8.
+    /// @param[in] parity     Parity. Defaults to uart0_parity::none.
+    /// @param[in] stop       Stop bits. Defaults to uart0_stop_bits::one.
+    /// @param[in] fc         UART clock frequency. Should be fixed for a given
+    ///                       board boot configuration. Defaults to
+    ///                       \ref rpi_uart_clock_frequency.
+    ///
+    /// @throws std::invalid_argument if data_bits is not in range.
+    /// @throws std::out_of_range if baud cannot be obtained from fc.
+      explicit uart0_line_settings
+      ( hertz           baud
+      , unsigned        data_bits = 8U
+      , uart0_parity    parity    = uart0_parity::none
+      , uart0_stop_bits stop      = uart0_stop_bits::one
+      , hertz           fc        = rpi_uart_clock_frequency
+      );
+
+    /// @brief Returns the integer part of the baud rate divisor
+      std::uint32_t integer_divisor() const
+      {
+        return ibrd_reg;
+      }
+
+    /// @brief Returns the fractional part of the baud rate divisor in 64ths
+      std::uint32_t fractional_divisor() const
+      {
+        return fbrd_reg;
+      }
+
+    /// @brief Returns the baud rate achieved by the divisor
+      f_hertz actual_baud() const;
+
+    /// @brief Returns the number of bit periods per character, including the
+    /// start, parity and stop bits.
+      unsigned character_bits() const;
+    };
+
+  /// @brief Use a set of 2 or 4 GPIO pins with the UART0 peripheral.
+  ///
+  /// The lines of the UART0 serial interface peripheral may be output to a
+  /// set of GPIO pins as special functions TXD0, RXD0, CTS0 and RTS0 when set
+  /// to the appropriate alternate pin functions. Refer to the
+  /// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+  /// BCM2835 ARM Peripherals data sheet</a>, table 6-31 to see which pin/alt
+  /// function combinations support the required special functions.
+  ///
+  /// If all the pins in the pin set support the requisite UART0 function
+  /// and the UART0 peripheral is not already in use locally within the same
+  /// process then the UART0 peripheral is set-up with the requested line
+  /// settings, FIFOs enabled, and the pins allocated and set to the relevant
+  /// alt-fns. Note that no attempt is made to see if the UART0 peripheral is
+  /// in use externally by other processes - such as a Linux serial console
+  /// on /dev/ttyAMA0, which should be disabled.
+  ///
+  /// Received bytes with framing or parity errors are returned, but counted
+  /// in line_errors(). Break conditions are counted and not returned.
+    class uart0_pins
+    {
+      constexpr static unsigned number_of_pins = 4U;
+
+      std::array<pin_id_int_t, number_of_pins>  pins;
+      uart0_line_settings                       settings;
+      uart0_line_errors                         errors;
+      wait_policy                               waiting;
+      wait_stats                                wait_counts;
+      io_counter_set                            counters;
+
+      void construct
+      ( pin_id txd
+      , pin_id rxd
+      , pin_id cts
+      , pin_id rts
+      );
+
+      bool receive_entry(std::uint32_t entry);
+
+    public:
+    /// @brief Construct a uart0_pins object from a uart0_pin_set
+    /// specialisation and line settings.
+    ///
+    /// @post The UART0 peripheral is marked as in use.
+    /// @post The pins in the uart0_pin_set are marked as in use (note: does
+    ///       not include CTS or RTS pins with a value of
+    ///       \ref uart0_pin_not_used).
+    /// @post UART0 is enabled with FIFOs enabled, the receive FIFO level set
+    ///       to half full and flow control enabled for each of CTS and RTS
+    ///       if used.
+    ///
+    /// @tparam TXD   uart0_pin_set TXD template parameter.
+    /// @tparam RXD   uart0_pin_set RXD template parameter.
+    /// @tparam CTS   uart0_pin_set CTS template parameter.
+    /// @tparam RTS   uart0_pin_set RTS template parameter.
+    ///
+    /// @param[in] ps uart0_pin_set specialisation specifying the set of GPIO
+    ///               pins to use for the various UART0 functions.
+    /// @param[in] ls Line settings to use.
+    ///
+    /// @throws std::invalid_argument if any requested pin does not support the
+    ///         required special function.
+    /// @throws std::range_error if any pin supports the same UART0 function
+    ///         by more than one alternative function (should not be possible).
+    /// @throws bad_peripheral_alloc if either any of the pins or the UART0
+    ///         peripheral are already in use.
+      template  < pin_id_int_t TXD
+                , pin_id_int_t RXD
+                , pin_id_int_t CTS
+                , pin_id_int_t RTS
+                >
+      uart0_pins
+      ( uart0_pin_set<TXD,RXD,CTS,RTS> ps
+      , uart0_line_settings const & ls
+      )
+      : settings(ls)
+      {
+        construct ( pin_id(ps.txd()), pin_id(ps.rxd())
+                  , pin_id(ps.cts()), pin_id(ps.rts())
+                  );
+      }
+
+    /// @brief Destroy: disable UART0 and de-allocate GPIO pins.
+    /// @post UART0 is disabled.
+    /// @post The pins allocated during construction are marked as free.
+    /// @post The UART0 peripheral is marked as free.
+      ~uart0_pins();
+
+      uart0_pins(uart0_pins const &) = delete;
+      uart0_pins& operator=(uart0_pins const &) = delete;
+
+    /// @brief Change line settings.
+    ///
+    /// Waits for any data in the transmit FIFO to be sent, disables UART0,
+    /// applies the settings then re-enables UART0. The receive FIFO is
+    /// flushed.
+    ///
+    /// @param[in] ls Line settings to use.
+      void set_line_settings(uart0_line_settings const & ls);
+
+    /// @brief Returns the line settings in use.
+      uart0_line_settings const & line_settings() const
+      {
+        return settings;
+      }
+
+    /// @brief Write a single byte to the transmit FIFO
+    /// @param[in] data Data byte to be written.
+    /// @returns  \c true if byte written to transmit FIFO,
+    ///           \c false if it could not as the FIFO is full.
+      bool write(std::uint8_t data);
+
+    /// @brief Write bytes from buffer to the transmit FIFO
+    ///
+    /// If the transmit FIFO is empty a whole FIFO's worth of bytes is written
+    /// without checking status, otherwise the FIFO full flag is checked
+    /// before each byte.
+    ///
+    /// @param[in] pdata  Pointer to data bytes to be written.
+    /// @param[in] count  Maximum number of bytes to write.
+    /// @returns  Number of bytes actually written. Less than \c count if FIFO
+    ///           fills.
+      std::size_t write(std::uint8_t const * pdata, std::size_t count);
+
+    /// @brief Write all bytes from buffer, waiting for transmit FIFO space.
+    ///
+    /// Returns once the last byte is in the transmit FIFO, which may be
+    /// before it has been sent - see drain().
+    ///
+    /// @param[in] pdata  Pointer to data bytes to be written.
+    /// @param[in] count  Number of bytes to write.
+    /// @returns  \c count.
+      std::size_t write_all(std::uint8_t const * pdata, std::size_t count);
+
+    /// @brief Read a single byte from the receive FIFO
+    /// @param[out] data Data byte to receive read value.
+    /// @returns  \c true if byte read from receive FIFO,
+    ///           \c false if it could not as FIFO empty or the entry read
+    ///           was a break.
+      bool read(std::uint8_t & data);
+
+    /// @brief Read bytes from the receive FIFO into a buffer
+    ///
+    /// While the receive FIFO is at least half full bytes are read in half
+    /// FIFO bursts without checking status, otherwise the FIFO empty flag is
+    /// checked before each byte.
+    ///
+    /// @param[out] pdata Pointer to data buffer to receive read values.
+    /// @param[in] count  Maximum number of bytes to read.
+    /// @returns  Number of bytes actually read. Less than \c count if FIFO
+    ///           empties.
+      std::size_t read(std::uint8_t * pdata, std::size_t count);
+
+    /// @brief Read one message frame delimited by line idle time.
+    ///
+    /// Waits for the first byte then reads bytes until the receive line has
+    /// been idle for 32 bit periods - about 3 characters, close to the 3.5
+    /// character Modbus RTU inter-frame gap - as signalled by the UART0
+    /// receive timeout status, a break is received, or the buffer is full.
+    /// Bytes are only read from the receive FIFO in half FIFO bursts until
+    /// the frame ends so the receive timeout is not lost by emptying the
+    /// FIFO mid-frame.
+    ///
+    /// @param[out] pdata Pointer to data buffer to receive the frame.
+    /// @param[in] count  Maximum number of bytes to read.
+    /// @param[in] timeout Longest time to wait for the first byte.
+    /// @returns  Number of bytes in the frame, zero if timed out.
+      std::size_t read_frame
+      ( std::uint8_t * pdata
+      , std::size_t count
+      , system_timer::duration timeout
+      );
+
+    /// @brief Wait until all written data, including the stop bits of the
+    /// last byte, has been sent.
+    ///
+    /// Used before turning an RS-485 transceiver around from transmit to
+    /// receive.
+      void drain();
+
+    /// @brief Send a break: hold TXD low for a time.
+    ///
+    /// Waits for written data to be sent first. For DMX512 the break should
+    /// be at least 92us and be followed by a mark after break of at least
+    /// 12us before the first slot is written.
+    ///
+    /// @param[in] length Time to hold TXD low for.
+      void send_break(system_timer::duration length);
+
+    /// @brief Query whether UART0 is sending data.
+    /// @returns \c true if the transmit FIFO is not empty or a byte's bits
+    ///          are being sent.
+      bool is_busy() const;
+
+    /// @brief Query whether there is room for more data in the transmit FIFO.
+      bool write_fifo_has_space() const;
+
+    /// @brief Query whether there is data in the receive FIFO.
+      bool read_fifo_has_data() const;
+
+    /// @brief Returns counts of receive line errors.
+      uart0_line_errors const & line_errors() const
+      {
+        return errors;
+      }
+
+    /// @brief Reset receive line error counts to zero.
+      void reset_line_errors()
+      {
+        errors = uart0_line_errors{};
+      }
+
+    /// @brief Set the wait policy used while write_all, read_frame and drain
+    /// wait.
+    ///
+    /// Defaults to a default constructed wait_policy.
+    /// @param[in] p  Policy to use.
+      void set_wait_policy(wait_policy const & p)
+      {
+        waiting = p;
+      }
+
+    /// @brief Returns the wait policy in use.
+      wait_policy const & get_wait_policy() const
+      {
+        return waiting;
+      }
+
+    /// @brief Returns counts of waits by the stage they finished in.
+      wait_stats const & wait_statistics() const
+      {
+        return wait_counts;
+      }
+
+    /// @brief Reset wait counts to zero.
+      void reset_wait_statistics()
+      {
+        wait_counts = wait_stats{};
+      }
+
+    /// @brief Returns a snapshot of the performance counters.
+    ///
+    /// Counts bytes written and read, writes and reads stopped by a full
+    /// transmit or empty receive FIFO, polls made while waiting and timed
+    /// out frame reads. All counts are zero unless counting is enabled - see
+    /// io_counters.h.
+      io_counters counter_snapshot() const
+      {
+        return counters.snapshot();
+      }
+
+    /// @brief Reset the performance counters to zero.
+      void reset_counters()
+      {
+        counters.reset();
+      }
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_UART0_PINS_H
@@ -0,0 +1,135 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file wait_policy.h
+/// @brief Adaptive spin, yield then sleep waiting for peripheral status
+/// changes : type definitions.
+///
+/// Waiting for a peripheral FIFO or transfer state to change by continuously
+/// polling gives the lowest latency for short waits but occupies a CPU for
+/// the whole wait. A wait_policy bounds that: a waiter first spins polling
+/// the state, then yields the CPU to other ready threads between polls, and
+/// finally sleeps between polls. Counts of how many waits finished in each
+/// stage are kept to help tune a policy.
+///
+/// Where a peripheral's interrupt is available through an \ref irq_event a
+/// policy may instead block on the interrupt once spinning is done, so short
+/// waits keep the low latency spin path and long ones use almost no CPU.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_WAIT_POLICY_H
+# define DIBASE_RPI_PERIPHERALS_WAIT_POLICY_H
+
+# include <chrono>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    class irq_event;
+
+  /// @brief Parameters of an adaptive wait.
+    struct wait_policy
+    {
+    /// @brief Default number of polls spun before yielding
+      constexpr static unsigned default_spin_count = 2000U;
+
+    /// @brief Default number of polls each followed by sched_yield before
+    /// sleeping
+      constexpr static unsigned default_yield_count = 50U;
+
+    /// @brief Default sleep time between polls in nanoseconds
+      constexpr static unsigned default_sleep_ns = 50000U;
+
+      unsigned                  spin_count;   ///< Polls spun before yielding
+      unsigned                  yield_count;  ///< Yielding polls before sleeping
+      std::chrono::nanoseconds  sleep_time;   ///< Sleep between later polls
+
+    /// @brief Interrupt to block on after spinning, or nullptr.
+    ///
+    /// If set the yield and sleep stages are replaced by waiting on the
+    /// interrupt for at most sleep_time before each further poll, so a wait
+    /// still ends, a poll interval late, if the interrupt does not fire.
+    /// Only peripheral objects documented as supporting interrupt waits
+    /// enable their peripheral's interrupts.
+      irq_event *               interrupt;
+
+    /// @brief Construct from wait stage parameters.
+    /// @param[in] spins  Number of polls spun before yielding. Defaults to
+    ///                   default_spin_count.
+    /// @param[in] yields Number of polls followed by a sched_yield call
+    ///                   before sleeping. Defaults to default_yield_count.
+    /// @param[in] sleep  Time to sleep between polls after the spin and yield
+    ///                   stages. Defaults to default_sleep_ns.
+    /// @param[in] irq    Interrupt to wait on after the spin stage, in place
+    ///                   of yielding and sleeping. Must outlive all uses of
+    ///                   the policy. Defaults to nullptr: no interrupt.
+      explicit wait_policy
+      ( unsigned spins = default_spin_count
+      , unsigned yields = default_yield_count
+      , std::chrono::nanoseconds sleep
+                            = std::chrono::nanoseconds(default_sleep_ns)
+      , irq_event * irq = nullptr
+      )
+      : spin_count{spins}
+      , yield_count{yields}
+      , sleep_time{sleep}
+      , interrupt{irq}
+      {}
+    };
+
+  /// @brief Counts of waits that finished in each stage of a wait_policy.
+    struct wait_stats
+    {
+      wait_stats()
+      : spin_waits{0U}
+      , yield_waits{0U}
+      , sleep_waits{0U}
+      , interrupt_waits{0U}
+      {}
+
+      std::uint64_t spin_waits;   ///< Waits finished while spinning
+      std::uint64_t yield_waits;  ///< Waits finished while yielding
+      std::uint64_t sleep_waits;  ///< Waits finished while sleeping
+      std::uint64_t interrupt_waits;///< Waits finished waiting on interrupts
+    };
+
+  /// @brief One adaptive wait following a wait_policy.
+  ///
+  /// Call pause() after each poll that finds the waited for state has not
+  /// been reached. On destruction the stage the wait finished in is counted
+  /// in the wait_stats object passed on construction. Waits that needed no
+  /// pause are not counted.
+    class adaptive_wait
+    {
+      wait_policy const & policy;
+      wait_stats &        stats;
+      unsigned            polls;
+
+    public:
+    /// @brief Start a wait.
+    /// @param[in] p  Wait policy to follow. Must outlive the object.
+    /// @param[in] s  Wait statistics to update. Must outlive the object.
+      adaptive_wait(wait_policy const & p, wait_stats & s)
+      : policy(p)
+      , stats(s)
+      , polls{0U}
+      {}
+
+    /// @brief End the wait, counting the stage it finished in.
+      ~adaptive_wait();
+
+      adaptive_wait(adaptive_wait const &) = delete;
+      adaptive_wait& operator=(adaptive_wait const &) = delete;
+
+    /// @brief Pause before the next poll: returns immediately while spinning,
+    /// otherwise yields the CPU, sleeps or waits for the policy's interrupt.
+      void pause();
+
+    /// @brief End the current wait, counting it as for destruction, and start
+    /// another. For loops waiting for a sequence of state changes.
+      void restart();
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_WAIT_POLICY_H
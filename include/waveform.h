@@ -0,0 +1,93 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file waveform.h
+/// @brief DMA paced GPIO output waveforms : type definitions.
+///
+/// A waveform is a sequence of steps, each setting and clearing some pins of
+/// an \ref opin_group then waiting a number of microseconds. Waveforms are
+/// compiled into a chain of DMA control blocks that write the GPIO set and
+/// clear registers directly. Delays are timed by DMA transfers to the PWM
+/// FIFO paced by the PWM controller's DMA request signal, so once started a
+/// waveform plays without using the CPU, free from scheduling jitter.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_WAVEFORM_H
+# define DIBASE_RPI_PERIPHERALS_WAVEFORM_H
+
+# include "pin_group.h"
+# include <memory>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      class dma_arena;
+    }
+
+  /// @brief One step of a waveform.
+    struct waveform_step
+    {
+      pin_group_value_t set;      ///< Group pins to set high
+      pin_group_value_t clear;    ///< Group pins to set low
+      std::uint32_t     delay_us; ///< Microseconds to wait after setting pins
+    };
+
+  /// @brief GPIO output waveform played by DMA.
+  ///
+  /// Playing a waveform requires the PWM controller, whose clock is set to
+  /// time the delays, and a DMA channel. Hence while a waveform exists no PWM
+  /// pins may be used, and only one waveform may exist at a time.
+  ///
+  /// The PWM FIFO allows the DMA controller to run up to 8 microseconds ahead
+  /// of the PWM controller, so there is a corresponding small skew between
+  /// start() and the first step; intervals between steps are unaffected.
+    class waveform
+    {
+      std::unique_ptr<internal::dma_arena> code;  ///< Compiled waveform memory
+      std::uint32_t code_bus;                     ///< Bus address of first CB
+      std::size_t dma_channel;                    ///< Playing DMA channel
+
+    public:
+    /// @brief Compile a waveform and reserve the resources to play it.
+    /// @param[in] pins   Group of output pins the waveform drives. Must
+    ///                   outlive the waveform.
+    /// @param[in] steps  Waveform steps. Step set and clear masks are relative
+    ///                   to pins: bit n refers to the nth pin of the group.
+    /// @param[in] repeat If true the waveform plays repeatedly until stopped,
+    ///                   otherwise it plays once.
+    /// @throws std::invalid_argument if steps is empty, all steps are empty,
+    ///         a delay exceeds 268 seconds or a mask has bits set for pins not
+    ///         in the group.
+    /// @throws peripheral_in_use if any PWM channel is in use, including by
+    ///         another waveform.
+    /// @throws bad_peripheral_alloc if no DMA channel is available.
+    /// @throws std::system_error or std::bad_alloc if DMA memory cannot be
+    ///         obtained.
+      waveform
+      ( opin_group const & pins
+      , std::vector<waveform_step> const & steps
+      , bool repeat = false
+      );
+
+    /// @brief Stop playing and release resources.
+      ~waveform();
+
+      waveform(waveform const &) = delete;
+      waveform & operator=(waveform const &) = delete;
+
+    /// @brief Start playing the waveform from its first step.
+      void start();
+
+    /// @brief Stop playing the waveform, leaving pins in their current state.
+      void stop();
+
+    /// @brief Returns true if the waveform is playing, false if it has
+    /// finished or was stopped.
+      bool is_playing() const;
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_WAVEFORM_H
@@ -0,0 +1,105 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file ws2812_strip.h
+/// @brief Drive WS2812 (NeoPixel) addressable LED strips using the PWM
+/// serialiser and DMA : class definition
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_WS2812_STRIP_H
+# define DIBASE_RPI_PERIPHERALS_WS2812_STRIP_H
+
+# include "pwm_pin.h"
+# include <cstdint>
+# include <memory>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      class dma_arena;
+    }
+
+  /// @brief A strip of WS2812 LEDs driven from a PWM pin.
+  ///
+  /// The strip's frame is kept encoded as PWM serialiser bit patterns in
+  /// memory obtained from the VideoCore and is sent by DMA paced by the PWM,
+  /// so the 800kHz data timing is met without CPU involvement. Pixels are
+  /// set in a local copy; show() re-encodes only the pixels that changed
+  /// since the previous show() and starts sending the frame.
+  ///
+  /// The PWM clock is set to 2.4MHz, so no other PWM pins may be in use when
+  /// a ws2812_strip is created, and the PWM FIFO is used so no pwm_stream,
+  /// pwm_dma_stream or waveform may exist at the same time.
+    class ws2812_strip
+    {
+      std::vector<std::uint32_t>            colours;  ///< Pixel colours
+      std::vector<bool>                     changed;  ///< Not yet encoded
+      std::unique_ptr<pwm_pin>              pin;      ///< PWM output pin
+      std::unique_ptr<internal::dma_arena>  memory;   ///< Frame and CB memory
+      std::uint32_t *                       frame;    ///< Encoded frame
+      std::uint32_t                         cb_bus;   ///< Bus address of CB
+      std::size_t                           dma_channel;
+
+    public:
+    /// @brief Construct for a strip connected to a PWM capable pin.
+    ///
+    /// All pixels are initially off. Nothing is sent until show() is called.
+    /// @param[in] p      Pin with a PWM function the strip's data input is
+    ///                   connected to.
+    /// @param[in] pixels Number of LEDs in the strip.
+    /// @throws std::invalid_argument if pixels is 0 or p has no PWM
+    ///         function.
+    /// @throws peripheral_in_use if a PWM channel is in use.
+    /// @throws bad_peripheral_alloc if the pin, PWM FIFO or a DMA channel are
+    ///         not available.
+    /// @throws std::system_error or std::bad_alloc if DMA memory cannot be
+    ///         obtained.
+      ws2812_strip(pin_id p, std::size_t pixels);
+
+    /// @brief Destroy: stop any frame being sent and release resources.
+      ~ws2812_strip();
+
+      ws2812_strip(ws2812_strip const &) = delete;
+      ws2812_strip& operator=(ws2812_strip const &) = delete;
+      ws2812_strip(ws2812_strip &&) = delete;
+      ws2812_strip& operator=(ws2812_strip &&) = delete;
+
+    /// @brief Returns number of pixels in the strip.
+      std::size_t size() const
+      {
+        return colours.size();
+      }
+
+    /// @brief Set a pixel's colour for the next show().
+    /// @param[in] idx  Pixel index, 0 is the pixel nearest the Pi.
+    /// @param[in] rgb  Colour as 0xRRGGBB.
+    /// @throws std::out_of_range if idx is not a pixel index.
+      void set(std::size_t idx, std::uint32_t rgb);
+
+    /// @brief Returns a pixel's colour as 0xRRGGBB.
+    /// @param[in] idx  Pixel index.
+    /// @throws std::out_of_range if idx is not a pixel index.
+      std::uint32_t get(std::size_t idx) const;
+
+    /// @brief Set all pixels' colour for the next show().
+    /// @param[in] rgb  Colour as 0xRRGGBB.
+      void fill(std::uint32_t rgb);
+
+    /// @brief Send the current pixel colours to the strip.
+    ///
+    /// Waits for any frame being sent to finish, re-encodes changed pixels
+    /// then starts sending the frame and returns.
+      void show();
+
+    /// @brief Query whether a frame is being sent.
+      bool is_busy() const;
+
+    /// @brief Wait for any frame being sent to finish.
+      void wait() const;
+    };
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_WS2812_STRIP_H
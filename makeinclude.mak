@@ -59,7 +59,7 @@ RM = rm
 # Tool flags:
 # -----------
 # Preprocessor flags
-CPP_FLAGS = -I. -I$(INC_DIR)
+CPP_FLAGS = -I. -I$(INC_DIR) -D_FILE_OFFSET_BITS=64
 
 # C++ compiler flags
 CXX_FLAGS_COMMON = -std=c++0x -Wall -Wextra -pedantic -c
@@ -85,7 +85,7 @@ LD_FLAGS_COMMON = -L $(LIB_DIR)
 LD_DEBUG_FLAGS =
 LD_RELEASE_FLAGS =
 
-LD_LIBS = -l$(LIB_NAME) -lpthread
+LD_LIBS = -l$(LIB_NAME) -lpthread -lrt
 
 # Full link flags
 ifeq ($(BUILD_CONFIG),release)
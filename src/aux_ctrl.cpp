@@ -0,0 +1,29 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file aux_ctrl.cpp
+/// @brief Internal auxiliary peripherals control type implementation and
+/// definition.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "aux_ctrl.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      aux_ctrl::aux_ctrl()
+      : regs( peripheral_window::instance()
+            , aux_registers::physical_address
+            , register_block_size
+            )
+      {}
+
+      aux_ctrl & aux_ctrl::instance()
+      {
+        static aux_ctrl aux_control_area;
+        return aux_control_area;
+      }
+    }
+  }
+}}
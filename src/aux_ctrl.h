@@ -0,0 +1,50 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file aux_ctrl.h
+/// @brief \b Internal : auxiliary peripherals control type & supporting
+/// definitions.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_AUX_CTRL_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_AUX_CTRL_H
+
+# include "phymem_ptr.h"
+# include "aux_registers.h"
+# include "simple_allocator.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Auxiliary peripherals control type. There is only ONE (yes it
+    /// is a singleton!)
+    ///
+    /// Maps BCM2708 / 2835 auxiliary peripheral registers into the requisite
+    /// physical memory mapped area and provides an allocator for in-process
+    /// SPI1 and SPI2 master use tracking.
+      struct aux_ctrl
+      {
+      /// @brief Pointer to BCM2708 / BCM2835 auxiliary registers instance
+        phymem_ptr<volatile aux_registers>            regs;
+
+      /// @brief Auxiliary SPI master allocator: 0 for SPI1, 1 for SPI2
+        simple_allocator<number_of_aux_spi_masters>   alloc;
+
+      /// @brief Singleton instance getter
+      /// @returns THE instance of the auxiliary peripherals control object.
+        static aux_ctrl & instance();
+
+      private:
+      /// @brief Construct: intialise regs with correct physical address & size
+        aux_ctrl();
+
+        aux_ctrl(aux_ctrl const &) = delete;
+        aux_ctrl(aux_ctrl &&) = delete;
+        aux_ctrl & operator=(aux_ctrl const &) = delete;
+        aux_ctrl & operator=(aux_ctrl &&) = delete;
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_AUX_CTRL_H
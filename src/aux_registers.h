@@ -0,0 +1,194 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file aux_registers.h
+/// @brief \b Internal : low-level (register) auxiliary peripherals (AUX)
+/// support types and definitions, covering the SPI1 and SPI2 masters.
+///
+/// Refer to the
+/// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+/// Broadcom BCM2835 ARM Peripherals Datasheet</a> Chapter 2 Auxiliaries for
+/// details along with the published errata: the SPI register offsets and
+/// status bits used here are the corrected ones, also used by the Linux
+/// spi-bcm2835aux driver.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_AUX_REGISTERS_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_AUX_REGISTERS_H
+
+# include "peridef.h"
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Number of auxiliary SPI masters, SPI1 and SPI2.
+      constexpr std::size_t number_of_aux_spi_masters{2};
+
+    /// @brief Represents layout of one auxiliary SPI master's registers with
+    /// operations.
+    ///
+    /// The auxiliary SPI masters have a 4 entry FIFO of shift register loads
+    /// of up to 32 bits. Here they are used in variable width mode where each
+    /// entry written to the FIFO specifies its own bit count (up to 24).
+      struct aux_spi_registers
+      {
+        enum : register_t
+        { cntl0_shift_length_mask = 0x3FU ///< Fixed shift length field mask
+        , cntl0_msb_first_out = 1U<<6     ///< Shift data out MSB first
+        , cntl0_invert_clk    = 1U<<7     ///< Clock idle state is high
+        , cntl0_out_rising    = 1U<<8     ///< Data out on rising clock edge
+        , cntl0_clear_fifos   = 1U<<9     ///< Clear FIFOs while set
+        , cntl0_in_rising     = 1U<<10    ///< Data in on rising clock edge
+        , cntl0_enable        = 1U<<11    ///< Enable the SPI master
+        , cntl0_variable_width= 1U<<14    ///< Shift length in FIFO entries
+        , cntl0_cs_bit        = 17U       ///< Chip select lines field shift
+        , cntl0_cs_mask       = 7U<<17    ///< Chip select lines field mask
+        , cntl0_speed_bit     = 20U       ///< Clock speed field shift
+        , cntl0_speed_mask    = 0xFFFU<<20///< Clock speed field mask
+        , cntl1_keep_input    = 1U<<0     ///< Do not clear receive shift reg.
+        , cntl1_msb_first_in  = 1U<<1     ///< Shift data in MSB first
+        , stat_bit_count_mask = 0x3FU     ///< Bits left to shift
+        , stat_busy           = 1U<<6     ///< Transfer in progress
+        , stat_rx_empty       = 1U<<7     ///< Receive FIFO is empty
+        , stat_rx_full        = 1U<<8     ///< Receive FIFO is full
+        , stat_tx_empty       = 1U<<9     ///< Transmit FIFO is empty
+        , stat_tx_full        = 1U<<10    ///< Transmit FIFO is full
+        , fifo_depth          = 4U        ///< FIFO entries
+        , speed_max           = 0xFFFU    ///< Maximum clock speed field value
+        , variable_width_max  = 24U       ///< Maximum bits per FIFO entry
+        , entry_width_bit     = 24U       ///< Variable width entry bits shift
+        };
+
+        register_t control0;                  ///< AUXSPIx_CNTL0
+        register_t control1;                  ///< AUXSPIx_CNTL1
+        register_t status;                    ///< AUXSPIx_STAT
+        register_t peek;                      ///< AUXSPIx_PEEK
+        register_t reserved_do_not_use[4];    ///< Reserved, currently unused
+        register_t io[4];       ///< AUXSPIx_IO: FIFO, chip select ends after
+        register_t tx_hold[4];  ///< AUXSPIx_TXHOLD: FIFO, chip select held
+
+      /// @brief Returns the CNTL0 SPEED field value for a clock frequency.
+      ///
+      /// The clock frequency is fc/(2*(SPEED+1)).
+      /// @param fc_over_f  Ratio of core clock frequency to required SPI clock
+      ///                   frequency.
+      /// @returns SPEED field value, or a value greater than speed_max if the
+      ///          ratio cannot be produced.
+        constexpr static register_t speed_for(register_t fc_over_f)
+        {
+          return fc_over_f<2U ? speed_max+1U : fc_over_f/2U-1U;
+        }
+
+      /// @brief Returns CNTL0 chip select lines field with one line asserted.
+      ///
+      /// The field holds the levels of the 3 chip select lines while a
+      /// transfer is active: the selected line is low, the others high.
+      /// @param chip Chip select line, 0, 1 or 2.
+        constexpr static register_t chip_select_field(register_t chip)
+        {
+          return (~(1U<<(chip+cntl0_cs_bit)))&cntl0_cs_mask;
+        }
+
+      /// @brief Returns a variable width mode FIFO entry.
+      /// @param data Bits to shift out, right justified.
+      /// @param bits Number of bits to shift, 1 to variable_width_max.
+        constexpr static register_t fifo_entry(register_t data, register_t bits)
+        {
+          return (bits<<entry_width_bit)
+               | ((data<<(variable_width_max-bits))
+                  & ((1U<<variable_width_max)-1U)
+                 );
+        }
+
+      /// @brief Returns true if the SPI master is shifting data.
+        bool get_busy() volatile const
+        {
+          return status & stat_busy;
+        }
+
+      /// @brief Returns true if the receive FIFO has no entries.
+        bool get_rx_fifo_empty() volatile const
+        {
+          return status & stat_rx_empty;
+        }
+
+      /// @brief Returns true if the transmit FIFO has no entries.
+        bool get_tx_fifo_empty() volatile const
+        {
+          return status & stat_tx_empty;
+        }
+
+      /// @brief Returns true if the transmit FIFO is full.
+        bool get_tx_fifo_full() volatile const
+        {
+          return status & stat_tx_full;
+        }
+
+      /// @brief Write a FIFO entry.
+      /// @param entry    Entry value, see fifo_entry.
+      /// @param hold_cs  Keep chip select asserted after the entry is shifted
+      ///                 if \c true, deassert it if \c false.
+        void transmit_fifo_write(register_t entry, bool hold_cs) volatile
+        {
+          if (hold_cs)
+            {
+              tx_hold[0] = entry;
+            }
+          else
+            {
+              io[0] = entry;
+            }
+        }
+
+      /// @brief Read a FIFO entry. Bits received are right justified.
+        register_t receive_fifo_read() volatile
+        {
+          return io[0];
+        }
+      };
+
+    /// @brief Represents layout of auxiliary peripherals registers with
+    /// operations.
+    ///
+    /// Only the shared IRQ and enables registers and the SPI1 and SPI2 master
+    /// registers are described. The mini UART registers are reserved here.
+      struct aux_registers
+      {
+      /// @brief Physical address of start of BCM2835 auxiliary registers
+        constexpr static physical_address_t
+                            physical_address = peripheral_base_address+0x215000;
+
+        enum : register_t
+        { enable_mini_uart  = 1U<<0   ///< AUXENB mini UART enable bit
+        , enable_spi1       = 1U<<1   ///< AUXENB SPI1 enable bit
+        , enable_spi2       = 1U<<2   ///< AUXENB SPI2 enable bit
+        };
+
+        register_t irq;                       ///< AUX_IRQ
+        register_t enables;                   ///< AUX_ENABLES
+        register_t reserved_do_not_use[30];   ///< Reserved and mini UART
+        aux_spi_registers spi[number_of_aux_spi_masters]; ///< SPI1, SPI2
+
+      /// @brief Enable or disable an auxiliary SPI master's register access
+      /// leaving the other auxiliary peripherals unchanged.
+      /// @param idx    Master index: 0 for SPI1, 1 for SPI2.
+      /// @param enable Pass \c true to enable, \c false to disable.
+        void set_spi_enable(std::size_t idx, bool enable) volatile
+        {
+          register_t const bit{enable_spi1<<idx};
+          enables = enable ? (enables|bit) : (enables&~bit);
+        }
+
+      /// @brief Returns true if an auxiliary SPI master is enabled.
+      /// @param idx    Master index: 0 for SPI1, 1 for SPI2.
+        bool get_spi_enable(std::size_t idx) volatile const
+        {
+          return enables & (enable_spi1<<idx);
+        }
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_AUX_REGISTERS_H
@@ -0,0 +1,267 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file aux_spi_pins.cpp
+/// @brief Use GPIO pins with the auxiliary SPI masters: implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "aux_spi_pins.h"
+#include "aux_ctrl.h"
+#include "gpio_alt_fn.h"
+#include "gpio_ctrl.h"
+#include "periexcept.h"
+#include <algorithm>
+#include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using internal::aux_ctrl;
+    using internal::aux_spi_registers;
+    using internal::gpio_ctrl;
+    using internal::pin_alt_fn::descriptor;
+    using internal::pin_alt_fn::gpio_special_fn;
+
+    namespace
+    {
+      constexpr unsigned sclk_idx{0U};
+      constexpr unsigned ce0_idx{3U};
+
+    // Bytes per FIFO entry in byte transfers
+      constexpr std::size_t entry_bytes{3U};
+
+    // Special functions for each pin index for SPI1 then SPI2
+      gpio_special_fn const special_fns[internal::number_of_aux_spi_masters][6]
+        { { gpio_special_fn::spi1_sclk, gpio_special_fn::spi1_mosi
+          , gpio_special_fn::spi1_miso, gpio_special_fn::spi1_ce0_n
+          , gpio_special_fn::spi1_ce1_n, gpio_special_fn::spi1_ce2_n
+          }
+        , { gpio_special_fn::spi2_sclk, gpio_special_fn::spi2_mosi
+          , gpio_special_fn::spi2_miso, gpio_special_fn::spi2_ce0_n
+          , gpio_special_fn::spi2_ce1_n, gpio_special_fn::spi2_ce2_n
+          }
+        };
+
+      descriptor get_alt_fn_descriptor(pin_id pin, unsigned idx)
+      {
+        using internal::pin_alt_fn::select;
+        auto pin_fn_info( select( pin
+                                , { special_fns[0][idx]
+                                  , special_fns[1][idx]
+                                  }
+                                )
+                        );
+        if (pin_fn_info.empty())
+          {
+            throw std::invalid_argument
+                  { "aux_spi_pins::aux_spi_pins: Pin does not support "
+                    "requested auxiliary SPI special function."
+                  };
+          }
+        if (pin_fn_info.size()!=1)
+          {
+            throw std::range_error
+                  {"aux_spi_pins::aux_spi_pins: More than one pin alt "
+                   "function selected that supports the requested auxiliary "
+                   "SPI special function."
+                  };
+          }
+        return pin_fn_info[0];
+      }
+    }
+
+    aux_spi_pins::aux_spi_pins
+    ( pin_id sclk
+    , pin_id mosi
+    , pin_id miso
+    , pin_id ce0
+    , hertz f
+    , aux_spi_clk_polarity cpol
+    , pin_id_int_t ce1
+    , pin_id_int_t ce2
+    , hertz fc
+    )
+    {
+      pins = {{ sclk, mosi, miso, ce0, ce1, ce2 }};
+    // Get each pin's alt function for its special function.
+    // Note: any of these can throw - but nothing allocated yet so OK
+      std::vector<internal::gpio_pin_fn_setting> pin_fns;
+      spi_idx = get_alt_fn_descriptor(sclk, sclk_idx).special_fn()
+                                                  ==gpio_special_fn::spi1_sclk
+              ? 0U : 1U;
+      for (unsigned idx=0; idx!=number_of_pins; ++idx)
+        {
+          if (pins[idx]==aux_spi_pin_not_used)
+            {
+              continue;
+            }
+          descriptor const info
+                        {get_alt_fn_descriptor(pin_id(pins[idx]), idx)};
+          if (info.special_fn()!=special_fns[spi_idx][idx])
+            {
+              throw std::invalid_argument
+                    { "aux_spi_pins::aux_spi_pins: Pins are for different "
+                      "auxiliary SPI masters."
+                    };
+            }
+          pin_fns.push_back({pin_id(pins[idx]), info.alt_fn()});
+        }
+      register_t const
+        speed{aux_spi_registers::speed_for(fc.count()/f.count())};
+      if (speed>aux_spi_registers::speed_max)
+        {
+          throw std::out_of_range( "aux_spi_pins::aux_spi_pins: f parameter "
+                                   "not in the range [fc/8192,fc/2]."
+                                 );
+        }
+      control0 = aux_spi_registers::cntl0_enable
+               | aux_spi_registers::cntl0_variable_width
+               | aux_spi_registers::cntl0_msb_first_out
+               | (speed<<aux_spi_registers::cntl0_speed_bit)
+               | ( cpol==aux_spi_clk_polarity::high
+                 ? ( aux_spi_registers::cntl0_invert_clk
+                   | aux_spi_registers::cntl0_out_rising
+                   )
+                 : aux_spi_registers::cntl0_in_rising
+                 );
+      if (aux_ctrl::instance().alloc.is_in_use(spi_idx))
+        {
+          throw bad_peripheral_alloc( "aux_spi_pins::aux_spi_pins: auxiliary "
+                                      "SPI master is already being used "
+                                      "locally."
+                                    );
+        }
+      aux_ctrl::instance().alloc.allocate(spi_idx);
+      std::size_t pin_alloc_count{0U};
+      try
+        {
+          for (; pin_alloc_count!=pin_fns.size(); ++pin_alloc_count)
+            {
+              gpio_ctrl::instance().alloc.allocate   // CAN THROW
+                                            (pin_fns[pin_alloc_count].pin);
+            }
+        }
+      catch (...)
+        { // Release resources allocated so far and re-throw
+          while (pin_alloc_count--)
+            {
+              gpio_ctrl::instance().alloc.deallocate
+                                            (pin_fns[pin_alloc_count].pin);
+            }
+          aux_ctrl::instance().alloc.deallocate(spi_idx);
+          throw;
+        }
+      gpio_ctrl::instance().config.set_pin_functions
+                                            (pin_fns.begin(), pin_fns.end());
+      auto & aux(aux_ctrl::instance().regs);
+      aux->set_spi_enable(spi_idx, true);
+      aux->spi[spi_idx].control0 = aux_spi_registers::cntl0_clear_fifos;
+      aux->spi[spi_idx].control1 = aux_spi_registers::cntl1_msb_first_in;
+      aux->spi[spi_idx].control0 = control0;
+    }
+
+    aux_spi_pins::~aux_spi_pins()
+    {
+      auto & aux(aux_ctrl::instance().regs);
+      aux->spi[spi_idx].control0 = aux_spi_registers::cntl0_clear_fifos;
+      aux->spi[spi_idx].control0 = 0U;
+      aux->set_spi_enable(spi_idx, false);
+      for (auto pin : pins)
+        {
+          if (pin!=aux_spi_pin_not_used)
+            {
+              gpio_ctrl::instance().alloc.deallocate(pin_id(pin));
+            }
+        }
+      aux_ctrl::instance().alloc.deallocate(spi_idx);
+    }
+
+    void aux_spi_pins::select(unsigned chip)
+    {
+      if (chip>2U || pins[ce0_idx+chip]==aux_spi_pin_not_used)
+        {
+          throw std::invalid_argument{ "aux_spi_pins: chip select line is not "
+                                       "in use."
+                                     };
+        }
+      aux_ctrl::instance().regs->spi[spi_idx].control0
+                      = control0 | aux_spi_registers::chip_select_field(chip);
+    }
+
+    std::size_t aux_spi_pins::transfer
+    ( unsigned chip
+    , std::uint8_t const * ptx
+    , std::uint8_t * prx
+    , std::size_t count
+    )
+    {
+      select(chip);
+      volatile aux_spi_registers & regs
+                                    (aux_ctrl::instance().regs->spi[spi_idx]);
+      std::size_t const entries{(count+entry_bytes-1U)/entry_bytes};
+      std::size_t entries_written{0U};
+      std::size_t entries_read{0U};
+      while (entries_read!=entries)
+        {
+          while ( entries_written!=entries
+               && entries_written-entries_read<aux_spi_registers::fifo_depth
+               && !regs.get_tx_fifo_full()
+                )
+            {
+              std::size_t const offset{entries_written*entry_bytes};
+              std::size_t const n{std::min(entry_bytes, count-offset)};
+              register_t value{0U};
+              for (std::size_t idx=0; idx!=n; ++idx)
+                {
+                  value = (value<<8) | (ptx ? ptx[offset+idx] : 0U);
+                }
+              ++entries_written;
+              regs.transmit_fifo_write
+                            ( aux_spi_registers::fifo_entry(value, 8U*n)
+                            , entries_written!=entries
+                            );
+            }
+          while (entries_read!=entries_written && !regs.get_rx_fifo_empty())
+            {
+              register_t const value{regs.receive_fifo_read()};
+              std::size_t const offset{entries_read*entry_bytes};
+              std::size_t const n{std::min(entry_bytes, count-offset)};
+              if (prx)
+                {
+                  for (std::size_t idx=0; idx!=n; ++idx)
+                    {
+                      prx[offset+idx]
+                          = static_cast<std::uint8_t>(value>>(8U*(n-1U-idx)));
+                    }
+                }
+              ++entries_read;
+            }
+        }
+      return count;
+    }
+
+    std::uint32_t aux_spi_pins::transfer_bits
+    ( unsigned chip
+    , std::uint32_t data
+    , unsigned bits
+    )
+    {
+      if (bits==0U || bits>aux_spi_registers::variable_width_max)
+        {
+          throw std::invalid_argument{ "aux_spi_pins::transfer_bits: bits "
+                                       "parameter not in the range [1,24]."
+                                     };
+        }
+      select(chip);
+      volatile aux_spi_registers & regs
+                                    (aux_ctrl::instance().regs->spi[spi_idx]);
+      regs.transmit_fifo_write( aux_spi_registers::fifo_entry(data, bits)
+                              , false
+                              );
+      while (regs.get_rx_fifo_empty())
+        {
+        }
+      return regs.receive_fifo_read() & ((1U<<bits)-1U);
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,147 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file bench.h
+/// @brief Micro-benchmark timing and result reporting : type definitions.
+///
+/// Each benchmark times a number of samples, each of a fixed number of
+/// operations, and reports one JSON object per line giving the operation
+/// rate and the per operation latency distribution so that results may be
+/// collected and compared across releases and boards.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_BENCH_BENCH_H
+# define DIBASE_RPI_PERIPHERALS_BENCH_BENCH_H
+
+# include "pin_id.h"
+# include <chrono>
+# include <cstdint>
+# include <ostream>
+# include <string>
+# include <vector>
+
+namespace bench
+{
+  typedef std::chrono::steady_clock             bench_clock;
+  typedef std::chrono::nanoseconds              nanoseconds;
+
+/// @brief Options shared by all benchmarks, set from the command line.
+  struct bench_options
+  {
+    bench_options();
+
+    std::size_t   samples;    ///< Samples taken by each benchmark
+    dibase::rpi::peripherals::pin_id  out_pin;  ///< GPIO output pin
+    dibase::rpi::peripherals::pin_id  in_pin;   ///< GPIO input pin
+    bool          loopback;   ///< True if out_pin is wired to in_pin
+    int           i2c_address;///< I2C slave address or -1 for none
+    dibase::rpi::peripherals::pin_id  i2c_sda;  ///< I2C data pin
+    dibase::rpi::peripherals::pin_id  i2c_scl;  ///< I2C clock pin
+    std::string   filter;     ///< Only run benchmarks with names containing
+  };
+
+/// @brief Timing of one benchmark run.
+  struct bench_result
+  {
+    std::string               name;       ///< Benchmark name
+    std::string               params;     ///< Parameters, "key=value,..."
+    std::string               unit;       ///< What an operation is
+    std::uint64_t             operations; ///< Total operations timed
+    nanoseconds               elapsed;    ///< Total time of all samples
+    std::vector<nanoseconds>  latencies;  ///< Per operation time of samples
+  };
+
+/// @brief Writes benchmark results as JSON lines.
+  class bench_reporter
+  {
+    std::ostream &  out;
+    std::string     board;
+    std::string     filter;
+
+  public:
+  /// @brief Construct writing to a stream.
+  /// @param[in] os       Stream to write to. Must outlive the reporter.
+  /// @param[in] options  Benchmark options: only benchmarks whose names
+  ///                     contain options.filter are run.
+    bench_reporter(std::ostream & os, bench_options const & options);
+
+  /// @brief Returns true if the named benchmark is to be run.
+    bool selected(std::string const & name) const;
+
+  /// @brief Write a result's operation rate and latency percentiles.
+    void report(bench_result & result);
+
+  /// @brief Write a record of a benchmark not run and why.
+    void skip(std::string const & name, std::string const & reason);
+  };
+
+/// @brief Time samples of a number of operations, each after an untimed
+/// preparation.
+/// @param[in] name       Benchmark name.
+/// @param[in] params     Benchmark parameters.
+/// @param[in] unit       What an operation is, for example "op" or "byte".
+/// @param[in] samples    Number of samples to time.
+/// @param[in] ops_per_sample Operations performed by each call of f.
+/// @param[in] prepare    Function called before each sample, not timed.
+/// @param[in] f          Function performing one sample's operations.
+/// @returns The result with a latency for each sample.
+  template <typename P, typename F>
+  bench_result time_samples
+  ( std::string const & name
+  , std::string const & params
+  , std::string const & unit
+  , std::size_t samples
+  , std::uint64_t ops_per_sample
+  , P prepare
+  , F f
+  )
+  {
+    bench_result result{name, params, unit, 0U, nanoseconds{0}, {}};
+    result.latencies.reserve(samples);
+    for (std::size_t s=0; s!=samples; ++s)
+      {
+        prepare();
+        bench_clock::time_point const start{bench_clock::now()};
+        f();
+        nanoseconds const t{std::chrono::duration_cast<nanoseconds>
+                                              (bench_clock::now()-start)};
+        result.elapsed += t;
+        result.operations += ops_per_sample;
+        result.latencies.push_back(t/ops_per_sample);
+      }
+    return result;
+  }
+
+/// @brief Time samples of a number of operations.
+/// @param[in] name       Benchmark name.
+/// @param[in] params     Benchmark parameters.
+/// @param[in] unit       What an operation is, for example "op" or "byte".
+/// @param[in] samples    Number of samples to time.
+/// @param[in] ops_per_sample Operations performed by each call of f.
+/// @param[in] f          Function performing one sample's operations.
+/// @returns The result with a latency for each sample.
+  template <typename F>
+  bench_result time_samples
+  ( std::string const & name
+  , std::string const & params
+  , std::string const & unit
+  , std::size_t samples
+  , std::uint64_t ops_per_sample
+  , F f
+  )
+  {
+    return time_samples( name, params, unit, samples, ops_per_sample
+                       , [](){}, f
+                       );
+  }
+
+/// @brief Run the GPIO pin benchmarks.
+  void run_gpio_benchmarks(bench_reporter & r, bench_options const & o);
+
+/// @brief Run the SPI0 benchmarks.
+  void run_spi0_benchmarks(bench_reporter & r, bench_options const & o);
+
+/// @brief Run the I2C benchmarks.
+  void run_i2c_benchmarks(bench_reporter & r, bench_options const & o);
+}
+#endif // DIBASE_RPI_PERIPHERALS_BENCH_BENCH_H
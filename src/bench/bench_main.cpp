@@ -0,0 +1,245 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file bench_main.cpp
+/// @brief Micro-benchmark reporting and main program.
+///
+/// Usage:
+///
+///   benchmarks-rpi-peripherals [--samples N] [--out PIN] [--in PIN]
+///                              [--loopback] [--i2c-address ADDR]
+///                              [--i2c-pins SDA,SCL] [--filter TEXT]
+///
+/// Results are written to standard output, one JSON object per line.
+///
+/// Setting the DIBASE_RPI_SIMULATED_PERIPHERALS environment variable to 1
+/// runs the GPIO and SPI0 benchmarks against in-memory simulated peripherals
+/// (see peripheral_simulator.h) so the drivers' own overheads can be timed
+/// and profiled off-target. The board is then reported as "simulated".
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "bench.h"
+#include "board_descriptor.h"
+#include "peripheral_simulator.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <sstream>
+
+namespace bench
+{
+  namespace
+  {
+    std::string json_string(std::string const & s)
+    {
+      std::string quoted{"\""};
+      for (char c : s)
+        {
+          if (c=='"' || c=='\\')
+            {
+              quoted += '\\';
+              quoted += c;
+            }
+          else if (static_cast<unsigned char>(c)<0x20U)
+            {
+              char escaped[8];
+              std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+              quoted += escaped;
+            }
+          else
+            {
+              quoted += c;
+            }
+        }
+      return quoted += '"';
+    }
+
+    std::string board_revision()
+    {
+      if (dibase::rpi::peripherals::internal::simulated_peripherals_selected())
+        {
+          return "simulated";
+        }
+      try
+        {
+          using dibase::rpi::peripherals::internal::running_board;
+          std::ostringstream rev;
+          rev << "0x" << std::hex << running_board().revision_code;
+          return rev.str();
+        }
+      catch (std::exception &)
+        {
+          return "unknown";
+        }
+    }
+
+  // Nearest rank percentile of sorted latencies.
+    nanoseconds percentile(std::vector<nanoseconds> const & sorted, unsigned p)
+    {
+      std::size_t rank{(sorted.size()*p+99U)/100U};
+      return sorted[rank==0U ? 0U : rank-1U];
+    }
+  }
+
+  bench_options::bench_options()
+  : samples{1000U}
+  , out_pin{17U}  // P1 pin GPIO_GEN0
+  , in_pin{22U}   // P1 pin GPIO_GEN3
+  , loopback{false}
+  , i2c_address{-1}
+  , i2c_sda{2U}   // P1 pin SDA1
+  , i2c_scl{3U}   // P1 pin SCL1
+  , filter{}
+  {}
+
+  bench_reporter::bench_reporter
+  ( std::ostream & os
+  , bench_options const & options
+  )
+  : out(os)
+  , board{board_revision()}
+  , filter{options.filter}
+  {}
+
+  bool bench_reporter::selected(std::string const & name) const
+  {
+    return name.find(filter)!=std::string::npos;
+  }
+
+  void bench_reporter::report(bench_result & result)
+  {
+    if (result.latencies.empty())
+      {
+        skip(result.name, "no samples");
+        return;
+      }
+    std::sort(result.latencies.begin(), result.latencies.end());
+    double const seconds{result.elapsed.count()/1.0e9};
+    out << "{\"benchmark\":" << json_string(result.name)
+        << ",\"params\":" << json_string(result.params)
+        << ",\"board\":" << json_string(board)
+        << ",\"unit\":" << json_string(result.unit)
+        << ",\"samples\":" << result.latencies.size()
+        << ",\"operations\":" << result.operations
+        << ",\"elapsed_ns\":" << result.elapsed.count()
+        << ",\"ops_per_sec\":"
+        << (seconds>0.0 ? result.operations/seconds : 0.0)
+        << ",\"min_ns\":" << result.latencies.front().count()
+        << ",\"p50_ns\":" << percentile(result.latencies, 50U).count()
+        << ",\"p90_ns\":" << percentile(result.latencies, 90U).count()
+        << ",\"p99_ns\":" << percentile(result.latencies, 99U).count()
+        << ",\"max_ns\":" << result.latencies.back().count()
+        << "}" << std::endl;
+  }
+
+  void bench_reporter::skip(std::string const & name, std::string const & why)
+  {
+    out << "{\"benchmark\":" << json_string(name)
+        << ",\"board\":" << json_string(board)
+        << ",\"skipped\":" << json_string(why)
+        << "}" << std::endl;
+  }
+}
+
+namespace
+{
+  void usage(char const * program)
+  {
+    std::cerr << "Usage: " << program
+              << " [--samples N] [--out PIN] [--in PIN] [--loopback]\n"
+                 "       [--i2c-address ADDR] [--i2c-pins SDA,SCL]"
+                 " [--filter TEXT]\n"
+                 "  --loopback     PIN given by --out is wired to PIN given"
+                 " by --in\n"
+                 "  --i2c-address  Slave to time transactions with, e.g."
+                 " 0x48\n"
+                 "Set DIBASE_RPI_SIMULATED_PERIPHERALS=1 to run against"
+                 " simulated peripherals.\n";
+  }
+
+  unsigned long number(char const * text)
+  {
+    char * end{nullptr};
+    unsigned long const value{std::strtoul(text, &end, 0)};
+    if (end==text || *end!='\0')
+      {
+        throw std::invalid_argument{std::string{"bad number: "}+text};
+      }
+    return value;
+  }
+
+  dibase::rpi::peripherals::pin_id pin(char const * text)
+  {
+    return dibase::rpi::peripherals::pin_id
+            (static_cast<dibase::rpi::peripherals::pin_id_int_t>(number(text)));
+  }
+}
+
+int main(int argc, char * argv[])
+{
+  bench::bench_options options;
+  try
+    {
+      for (int a=1; a<argc; ++a)
+        {
+          bool const has_value{a+1<argc};
+          if (std::strcmp(argv[a], "--loopback")==0)
+            {
+              options.loopback = true;
+            }
+          else if (std::strcmp(argv[a], "--samples")==0 && has_value)
+            {
+              options.samples = number(argv[++a]);
+            }
+          else if (std::strcmp(argv[a], "--out")==0 && has_value)
+            {
+              options.out_pin = pin(argv[++a]);
+            }
+          else if (std::strcmp(argv[a], "--in")==0 && has_value)
+            {
+              options.in_pin = pin(argv[++a]);
+            }
+          else if (std::strcmp(argv[a], "--i2c-address")==0 && has_value)
+            {
+              options.i2c_address = static_cast<int>(number(argv[++a]));
+            }
+          else if (std::strcmp(argv[a], "--i2c-pins")==0 && has_value)
+            {
+              std::string const pins{argv[++a]};
+              std::size_t const comma{pins.find(',')};
+              if (comma==std::string::npos)
+                {
+                  throw std::invalid_argument{"--i2c-pins needs SDA,SCL"};
+                }
+              options.i2c_sda = pin(pins.substr(0U, comma).c_str());
+              options.i2c_scl = pin(pins.substr(comma+1U).c_str());
+            }
+          else if (std::strcmp(argv[a], "--filter")==0 && has_value)
+            {
+              options.filter = argv[++a];
+            }
+          else
+            {
+              usage(argv[0]);
+              return EXIT_FAILURE;
+            }
+        }
+      if (options.samples==0U)
+        {
+          throw std::invalid_argument{"--samples must be at least 1"};
+        }
+    }
+  catch (std::exception & e)
+    {
+      std::cerr << e.what() << "\n";
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  bench::bench_reporter reporter{std::cout, options};
+  bench::run_gpio_benchmarks(reporter, options);
+  bench::run_spi0_benchmarks(reporter, options);
+  bench::run_i2c_benchmarks(reporter, options);
+}
@@ -0,0 +1,145 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_bench.cpp
+/// @brief GPIO pin micro-benchmarks.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "bench.h"
+#include "pin.h"
+#include "pin_edge_event.h"
+#include <exception>
+#include <string>
+
+using namespace dibase::rpi::peripherals;
+
+namespace bench
+{
+  namespace
+  {
+  // Operations timed together per sample for operations too quick to time
+  // individually.
+    std::uint64_t const batch_size{1000U};
+
+    std::string pin_param(char const * key, pin_id p)
+    {
+      return std::string{key} + "=" + std::to_string(static_cast<unsigned>(p));
+    }
+
+    void bench_opin_put(bench_reporter & r, bench_options const & o)
+    {
+      opin out{o.out_pin};
+      bool state{false};
+      bench_result result{time_samples
+                            ( "opin_put_toggle", pin_param("pin", o.out_pin)
+                            , "op", o.samples, batch_size
+                            , [&]()
+                              {
+                                for (std::uint64_t i=0; i!=batch_size; ++i)
+                                  {
+                                    state = !state;
+                                    out.put(state);
+                                  }
+                              }
+                            )};
+      out.put(false);
+      r.report(result);
+    }
+
+    void bench_ipin_get(bench_reporter & r, bench_options const & o)
+    {
+      ipin in{o.in_pin};
+      unsigned volatile highs{0U};
+      bench_result result{time_samples
+                            ( "ipin_get", pin_param("pin", o.in_pin)
+                            , "op", o.samples, batch_size
+                            , [&]()
+                              {
+                                for (std::uint64_t i=0; i!=batch_size; ++i)
+                                  {
+                                    highs = highs + in.get();
+                                  }
+                              }
+                            )};
+      r.report(result);
+    }
+
+    void bench_pin_lifetime(bench_reporter & r, bench_options const & o)
+    {
+      bench_result result{time_samples
+                            ( "pin_construct_destroy"
+                            , pin_param("pin", o.out_pin)
+                            , "op", o.samples, 1U
+                            , [&]()
+                              {
+                                opin out{o.out_pin};
+                              }
+                            )};
+      r.report(result);
+    }
+
+    void bench_edge_wakeup(bench_reporter & r, bench_options const & o)
+    {
+      opin out{o.out_pin};
+      out.put(false);
+      ipin in{o.in_pin};
+      pin_edge_event rising{in, pin_edge_event::rising};
+      bench_result result{time_samples
+                            ( "pin_edge_event_wakeup"
+                            , pin_param("out", o.out_pin) + ","
+                              + pin_param("in", o.in_pin)
+                            , "op", o.samples, 1U
+                            , [&]()
+                              {
+                                out.put(false);
+                                while (in.get())
+                                  {
+                                  }
+                                rising.clear();
+                              }
+                            , [&]()
+                              {
+                                out.put(true);
+                                rising.wait();
+                              }
+                            )};
+      out.put(false);
+      r.report(result);
+    }
+  }
+
+  void run_gpio_benchmarks(bench_reporter & r, bench_options const & o)
+  {
+    struct entry
+    {
+      char const * name;
+      void (*run)(bench_reporter &, bench_options const &);
+    };
+    entry const benchmarks[]
+                { {"opin_put_toggle", bench_opin_put}
+                , {"ipin_get", bench_ipin_get}
+                , {"pin_construct_destroy", bench_pin_lifetime}
+                , {"pin_edge_event_wakeup", bench_edge_wakeup}
+                };
+    for (auto const & b : benchmarks)
+      {
+        if (!r.selected(b.name))
+          {
+            continue;
+          }
+        if (b.run==bench_edge_wakeup && !o.loopback)
+          {
+            r.skip(b.name, "needs --loopback with out pin wired to in pin");
+            continue;
+          }
+        try
+          {
+            b.run(r, o);
+          }
+        catch (std::exception & e)
+          {
+            r.skip(b.name, e.what());
+          }
+      }
+  }
+}
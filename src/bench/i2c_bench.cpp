@@ -0,0 +1,71 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file i2c_bench.cpp
+/// @brief I2C micro-benchmarks.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "bench.h"
+#include "i2c_pins.h"
+#include "peripheral_simulator.h"
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+using namespace dibase::rpi::peripherals;
+
+namespace bench
+{
+  void run_i2c_benchmarks(bench_reporter & r, bench_options const & o)
+  {
+    char const * const name{"i2c_transaction_latency"};
+    if (!r.selected(name))
+      {
+        return;
+      }
+    if (o.i2c_address<0)
+      {
+        r.skip(name, "needs --i2c-address of a slave on the bus");
+        return;
+      }
+    if (internal::simulated_peripherals_selected())
+      {
+        r.skip(name, "I2C is not simulated");
+        return;
+      }
+    try
+      {
+        i2c_pins iic{o.i2c_sda, o.i2c_scl};
+        std::uint32_t const address{static_cast<std::uint32_t>(o.i2c_address)};
+      // A typical register read: write the register number, read its value.
+        std::uint8_t const reg{0U};
+        std::uint8_t value{0U};
+        bench_result result{time_samples
+                              ( name
+                              , "address=" + std::to_string(address)
+                                + ",hz="
+                                + std::to_string
+                                      (i2c_pins_default_frequency.count())
+                                + ",write=1,read=1"
+                              , "transaction", o.samples, 1U
+                              , [&]()
+                                {
+                                  if ( iic.write_all(address, &reg, 1U)
+                                                            !=i2c_pins::goodbit
+                                    || iic.read_all(address, &value, 1U)
+                                                            !=i2c_pins::goodbit
+                                     )
+                                    {
+                                      throw std::runtime_error
+                                              {"I2C transaction failed"};
+                                    }
+                                }
+                              )};
+        r.report(result);
+      }
+    catch (std::exception & e)
+      {
+        r.skip(name, e.what());
+      }
+  }
+}
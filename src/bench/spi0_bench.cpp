@@ -0,0 +1,74 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file spi0_bench.cpp
+/// @brief SPI0 micro-benchmarks.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "bench.h"
+#include "spi0_pins.h"
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <vector>
+
+using namespace dibase::rpi::peripherals;
+
+namespace bench
+{
+  namespace
+  {
+  // Samples per clock divider: slow clocks take a long time per transfer.
+    std::size_t const max_spi0_samples{20U};
+
+  // Bytes transferred per sample, aiming for about 10ms per sample.
+    std::size_t transfer_size(hertz f)
+    {
+      return std::min<std::size_t>
+                  ( std::max<std::size_t>(f.count()/8U/100U, 16U)
+                  , 4096U
+                  );
+    }
+  }
+
+  void run_spi0_benchmarks(bench_reporter & r, bench_options const & o)
+  {
+    char const * const name{"spi0_transfer_throughput"};
+    if (!r.selected(name))
+      {
+        return;
+      }
+    try
+      {
+        spi0_pins sp{rpi_p1_spi0_full_pin_set};
+        std::size_t const samples{std::min(o.samples, max_spi0_samples)};
+      // SPI0 clock dividers are even, from 2 to 65536: time powers of two.
+        for (std::uint32_t divider=2U; divider<=65536U; divider*=2U)
+          {
+            hertz const f{rpi_apb_core_frequency.count()/divider};
+            std::size_t const count{transfer_size(f)};
+            std::vector<std::uint8_t> tx(count, 0xA5U);
+            std::vector<std::uint8_t> rx(count);
+            spi0_slave_context const context{spi0_slave::chip0, f};
+            bench_result result{time_samples
+                                  ( name
+                                  , "divider=" + std::to_string(divider)
+                                    + ",hz=" + std::to_string(f.count())
+                                    + ",bytes=" + std::to_string(count)
+                                  , "byte", samples, count
+                                  , [&]()
+                                    {
+                                      sp.start_conversing(context);
+                                      sp.transfer(tx.data(), rx.data(), count);
+                                      sp.stop_conversing();
+                                    }
+                                  )};
+            r.report(result);
+          }
+      }
+    catch (std::exception & e)
+      {
+        r.skip(name, e.what());
+      }
+  }
+}
@@ -0,0 +1,92 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file board_descriptor.cpp
+/// @brief Raspberry Pi board description deduction implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "board_descriptor.h"
+#include "rpi_init.h"
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      namespace
+      {
+        constexpr std::size_t new_scheme_bit{1U<<23};
+        constexpr std::size_t old_scheme_warranty_bit{1U<<24};
+        constexpr std::size_t compute_module_major_version{4U};
+
+        std::size_t major_version_for(rpi_revision & revision)
+        {
+          switch (revision.model())
+          {
+          case rpi_model::a:
+          case rpi_model::b:
+            return revision.version()==1U ? 1U : 2U;
+          case rpi_model::compute_module:
+          case rpi_model::compute_module_3:
+          case rpi_model::compute_module_3_plus:
+          case rpi_model::compute_module_4:
+            return compute_module_major_version;
+          default:
+            return 3U;
+          };
+        }
+
+        physical_address_t peripheral_base_for(rpi_processor processor)
+        {
+          switch (processor)
+          {
+          case rpi_processor::bcm2835: return 0x20000000;
+          case rpi_processor::bcm2836:
+          case rpi_processor::bcm2837: return 0x3F000000;
+          case rpi_processor::bcm2711: return 0xFE000000;
+          default:
+            throw std::runtime_error( "make_board_descriptor: Unknown "
+                                      "processor in board revision value."
+                                    );
+          };
+        }
+      }
+
+      board_descriptor make_board_descriptor(std::size_t revision_code)
+      {
+      // Old scheme values with the warranty bit set are otherwise as usual
+        std::size_t const code
+                      { revision_code&new_scheme_bit
+                      ? revision_code
+                      : revision_code&~old_scheme_warranty_bit
+                      };
+        if (code==0U)
+          {
+            throw std::runtime_error( "rpi_init::init_major_version: Unable to "
+                                      "deduce board version from /proc/cpuinfo."
+                                    );
+          }
+        rpi_revision revision{code};
+        std::size_t const major_version{major_version_for(revision)};
+        bool const mapped{major_version<=pinout_versions};
+        return board_descriptor
+                { revision_code
+                , revision.model()
+                , revision.processor()
+                , major_version
+                , peripheral_base_for(revision.processor())
+                , mapped ? p1_gpio_pin_map[major_version-1U] : nullptr
+                , mapped ? p5_gpio_pin_map[major_version-1U] : nullptr
+                };
+      }
+
+      board_descriptor const & running_board()
+      {
+        using rpi::internal::read_cpuinfo_revision_code;
+        static board_descriptor const
+                      board{make_board_descriptor(read_cpuinfo_revision_code())};
+        return board;
+      }
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,61 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file board_descriptor.h
+/// @brief \b Internal : Raspberry Pi board description deduced from its
+/// revision code : type and function declarations.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_BOARD_DESCRIPTOR_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_BOARD_DESCRIPTOR_H
+
+# include "peridef.h"
+# include "pin_id.h"
+# include "rpi_revision.h"
+# include <cstddef>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Immutable description of a Raspberry Pi board.
+    ///
+    /// Deduced from a /proc/cpuinfo Revision value in either the old or the
+    /// new (bit 23 set) revision code scheme.
+      struct board_descriptor
+      {
+        std::size_t         revision_code;  ///< Revision value described
+        rpi_model           model;          ///< Board model
+        rpi_processor       processor;      ///< SoC on the board
+
+      /// @brief 1 based connector pin out version, as rpi_info::major_version
+        std::size_t         major_version;
+
+      /// @brief Physical address of the SoC's peripherals
+        physical_address_t  peripheral_base;
+
+      /// @brief P1 / J8 connector row of p1_gpio_pin_map, p1_map_size
+      /// entries, or nullptr if the board's pin out has no map.
+        pin_id_int_t const * p1_map;
+
+      /// @brief P5 connector row of p5_gpio_pin_map, p5_map_size entries, or
+      /// nullptr if the board's pin out has no map.
+        pin_id_int_t const * p5_map;
+      };
+
+    /// @brief Deduce a board descriptor from a revision code.
+    /// @param[in] revision_code  /proc/cpuinfo Revision value.
+    /// @return Description of the board with that revision code.
+    /// @throws std::runtime_error if revision_code is not a known value.
+      board_descriptor make_board_descriptor(std::size_t revision_code);
+
+    /// @brief Returns the process wide descriptor of the running board.
+    ///
+    /// Made from the /proc/cpuinfo Revision value on first call and cached.
+    /// @throws std::runtime_error if the revision value cannot be read or is
+    ///         not a known value.
+      board_descriptor const & running_board();
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_BOARD_DESCRIPTOR_H
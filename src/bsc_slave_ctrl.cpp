@@ -0,0 +1,29 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file bsc_slave_ctrl.cpp
+/// @brief Internal BSC slave peripheral control type implementation and
+/// definition.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "bsc_slave_ctrl.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      bsc_slave_ctrl::bsc_slave_ctrl()
+      : regs( peripheral_window::instance()
+            , bsc_slave_registers::physical_address
+            , register_block_size
+            )
+      {}
+
+      bsc_slave_ctrl & bsc_slave_ctrl::instance()
+      {
+        static bsc_slave_ctrl bsc_slave_control_area;
+        return bsc_slave_control_area;
+      }
+    }
+  }
+}}
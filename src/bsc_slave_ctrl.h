@@ -0,0 +1,50 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file bsc_slave_ctrl.h
+/// @brief \b Internal : BSC slave peripheral control type & supporting
+/// definitions.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_BSC_SLAVE_CTRL_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_BSC_SLAVE_CTRL_H
+
+# include "phymem_ptr.h"
+# include "bsc_slave_registers.h"
+# include "simple_allocator.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief BSC slave peripheral control type. There is only ONE (yes it
+    /// is a singleton!)
+    ///
+    /// Maps BCM2708 / 2835 BSC slave peripheral registers into the requisite
+    /// physical memory mapped area and provides an allocator for in-process
+    /// slave peripheral use tracking.
+      struct bsc_slave_ctrl
+      {
+      /// @brief Pointer to BCM2708 / BCM2835 BSC slave registers instance
+        phymem_ptr<volatile bsc_slave_registers>  regs;
+
+      /// @brief Slave peripheral allocator: there is only slave 0
+        simple_allocator<1>                       alloc;
+
+      /// @brief Singleton instance getter
+      /// @returns THE instance of the BSC slave control object.
+        static bsc_slave_ctrl & instance();
+
+      private:
+      /// @brief Construct: intialise regs with correct physical address & size
+        bsc_slave_ctrl();
+
+        bsc_slave_ctrl(bsc_slave_ctrl const &) = delete;
+        bsc_slave_ctrl(bsc_slave_ctrl &&) = delete;
+        bsc_slave_ctrl & operator=(bsc_slave_ctrl const &) = delete;
+        bsc_slave_ctrl & operator=(bsc_slave_ctrl &&) = delete;
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_BSC_SLAVE_CTRL_H
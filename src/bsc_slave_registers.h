@@ -0,0 +1,138 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file bsc_slave_registers.h
+/// @brief \b Internal : low-level (register) BSC / SPI slave peripheral
+/// support types and definitions.
+///
+/// The BCM2835 has one slave peripheral that can be used as either an I2C
+/// (BSC) slave or an SPI slave. Only its I2C use is supported here. Refer to
+/// the
+/// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+/// Broadcom BCM2835 ARM Peripherals Datasheet</a> Chapter 11 SPI/BSC SLAVE
+/// for details.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_BSC_SLAVE_REGISTERS_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_BSC_SLAVE_REGISTERS_H
+
+# include "peridef.h"
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Represents layout of the BSC / SPI slave registers with
+    /// operations.
+    ///
+    /// The slave has separate 16 byte transmit and receive FIFOs. Bytes
+    /// written by an I2C master addressing the slave are placed in the
+    /// receive FIFO, bytes read by the master are taken from the transmit
+    /// FIFO.
+      struct bsc_slave_registers
+      {
+      /// @brief Physical address of start of BCM2835 BSC slave registers
+        constexpr static physical_address_t
+                            physical_address = peripheral_base_address+0x214000;
+
+        enum : register_t
+        { dr_data_mask      = 0xFFU     ///< DR register DATA field mask
+        , rsr_overrun       = 1U<<0     ///< RSR register OE: rx FIFO overrun
+        , rsr_underrun      = 1U<<1     ///< RSR register UE: tx FIFO underrun
+        , slv_addr_mask     = 0x7FU     ///< SLV register ADDR field mask
+        , cr_enable         = 1U<<0     ///< CR register EN field
+        , cr_spi            = 1U<<1     ///< CR register SPI mode field
+        , cr_i2c            = 1U<<2     ///< CR register I2C mode field
+        , cr_break          = 1U<<7     ///< CR register BRK: stop and clear
+        , cr_tx_enable      = 1U<<8     ///< CR register TXE field
+        , cr_rx_enable      = 1U<<9     ///< CR register RXE field
+        , fr_tx_busy        = 1U<<0     ///< FR register TXBUSY field
+        , fr_rx_empty       = 1U<<1     ///< FR register RXFE field
+        , fr_tx_full        = 1U<<2     ///< FR register TXFF field
+        , fr_rx_full        = 1U<<3     ///< FR register RXFF field
+        , fr_tx_empty       = 1U<<4     ///< FR register TXFE field
+        , fr_rx_busy        = 1U<<5     ///< FR register RXBUSY field
+        , fr_tx_level_bit   = 6U        ///< FR register TXFLEVEL field shift
+        , fr_rx_level_bit   = 11U       ///< FR register RXFLEVEL field shift
+        , fr_level_mask     = 0x1FU     ///< FR register FLEVEL fields' mask
+        , fifo_depth        = 16U       ///< Bytes each FIFO holds
+        , i2c_enable = cr_enable|cr_i2c|cr_tx_enable|cr_rx_enable
+                                        ///< CR value for I2C slave operation
+        };
+
+        register_t  data;           ///< DR: Data register
+        register_t  errors;         ///< RSR: Operation status & error clear
+        register_t  slave_addrs;    ///< SLV: I2C slave address
+        register_t  control;        ///< CR: Control
+        register_t  flags;          ///< FR: Flags
+        register_t  fifo_levels;    ///< IFLS: Interrupt FIFO level select
+        register_t  int_mask;       ///< IMSC: Interrupt mask set clear
+        register_t  raw_int;        ///< RIS: Raw interrupt status
+        register_t  masked_int;     ///< MIS: Masked interrupt status
+        register_t  int_clear;      ///< ICR: Interrupt clear
+        register_t  dma_control;    ///< DMACR: DMA control
+        register_t  test_data;      ///< TDR: FIFO test data
+        register_t  gpu_status;     ///< GPUSTAT: GPU status
+        register_t  host_control;   ///< HCTRL: Host control
+        register_t  debug1;         ///< DEBUG1: I2C debug
+        register_t  debug2;         ///< DEBUG2: SPI debug
+
+      /// @brief Returns true if the receive FIFO has no bytes.
+        bool get_rx_fifo_empty() volatile const
+        {
+          return flags & fr_rx_empty;
+        }
+
+      /// @brief Returns true if the transmit FIFO cannot accept a byte.
+        bool get_tx_fifo_full() volatile const
+        {
+          return flags & fr_tx_full;
+        }
+
+      /// @brief Returns true if the transmit FIFO has no bytes.
+        bool get_tx_fifo_empty() volatile const
+        {
+          return flags & fr_tx_empty;
+        }
+
+      /// @brief Returns number of bytes in the receive FIFO.
+        register_t get_rx_fifo_level() volatile const
+        {
+          return (flags>>fr_rx_level_bit) & fr_level_mask;
+        }
+
+      /// @brief Returns number of bytes in the transmit FIFO.
+        register_t get_tx_fifo_level() volatile const
+        {
+          return (flags>>fr_tx_level_bit) & fr_level_mask;
+        }
+
+      /// @brief Returns the RSR overrun and underrun error bits.
+        register_t get_errors() volatile const
+        {
+          return errors & (rsr_overrun|rsr_underrun);
+        }
+
+      /// @brief Clear the RSR overrun and underrun errors.
+        void clear_errors() volatile
+        {
+          errors = 0U;
+        }
+
+      /// @brief Read a byte from the receive FIFO.
+        std::uint8_t receive_fifo_read() volatile
+        {
+          return static_cast<std::uint8_t>(data & dr_data_mask);
+        }
+
+      /// @brief Write a byte to the transmit FIFO.
+        void transmit_fifo_write(std::uint8_t byte) volatile
+        {
+          data = byte;
+        }
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_BSC_SLAVE_REGISTERS_H
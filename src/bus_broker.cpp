@@ -0,0 +1,360 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file bus_broker.cpp
+/// @brief Bus broker and bus broker client implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "bus_broker.h"
+#include "bus_broker_channel.h"
+#include "spi0_ctrl.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using internal::bus_broker_channel;
+    using internal::bus_broker_request;
+    using internal::bus_broker_op;
+    using internal::bus_broker_outcome;
+
+    namespace
+    {
+      std::size_t const i2c_fifo_size{16U};
+
+    /// @brief Submit a filled in request, wait for it and check its outcome.
+      bus_broker_request & perform
+      ( bus_broker_channel & c
+      , std::uint32_t idx
+      , char const * rejected_message
+      )
+      {
+        c.submit(idx);
+        c.wait_completed(idx);
+        bus_broker_request & r(c.slot(idx));
+        if (r.outcome==bus_broker_outcome::rejected)
+          {
+            throw std::invalid_argument{rejected_message};
+          }
+        if (r.outcome==bus_broker_outcome::failed)
+          {
+            throw std::runtime_error{reinterpret_cast<char const *>(r.data)};
+          }
+        return r;
+      }
+    }
+
+    constexpr char const * bus_broker::default_name;
+    std::size_t const bus_broker::buffer_size{bus_broker_request::buffer_size};
+
+    bus_broker::bus_broker
+    ( spi0_pins * sp
+    , std::vector<spi0_slave_context> slaves
+    , i2c_pins * ip
+    , char const * name
+    )
+    : spi0{sp}
+    , spi0_slaves(std::move(slaves))
+    , i2c{ip}
+    , stopping{false}
+    {
+      if (spi0 && !spi0->has_std_mode_support())
+        {
+          throw std::invalid_argument{"bus_broker::bus_broker: 3-wire SPI "
+                                      "standard mode not supported as the MISO "
+                                      "line has not been allocated to a GPIO "
+                                      "pin."};
+        }
+      for (auto const & c : spi0_slaves)
+        {
+          if (c.mode!=spi0_mode::standard)
+            {
+              throw std::invalid_argument{"bus_broker::bus_broker: slave "
+                                          "context is not for standard mode."};
+            }
+        }
+      channel.reset(new bus_broker_channel
+                          {name, bus_broker_channel::role::server});
+      if (spi0)
+        {
+          spi0->stop_conversing();
+        }
+      worker = std::thread{&bus_broker::run_requests, this};
+    }
+
+    bus_broker::~bus_broker()
+    {
+      stopping.store(true);
+      channel->interrupt();
+      worker.join();
+      channel.reset();
+      if (spi0)
+        {
+          spi0->stop_conversing();
+        }
+    }
+
+    void bus_broker::run_requests()
+    {
+      spi0_slave_context const * current{nullptr};
+      while (!stopping.load())
+        {
+          std::uint32_t idx;
+          if (!channel->take(idx))
+            {
+              channel->wait_submitted(stopping);
+              continue;
+            }
+          bus_broker_request & r(channel->slot(idx));
+          r.outcome = bus_broker_outcome::done;
+          r.status = 0;
+          r.count = 0U;
+          try
+            {
+              if ( r.tx_count>bus_broker_request::buffer_size
+                || r.rx_count>bus_broker_request::buffer_size
+                 )
+                {
+                  throw std::out_of_range{"bus_broker: request byte count "
+                                          "larger than the buffer."};
+                }
+              switch (r.op)
+                {
+                case bus_broker_op::spi0_transfer:
+                  if (!spi0 || r.target>=spi0_slaves.size())
+                    {
+                      r.outcome = bus_broker_outcome::rejected;
+                      break;
+                    }
+                  if (&spi0_slaves[r.target]!=current)
+                    {
+                      current = nullptr;
+                      spi0->start_conversing(spi0_slaves[r.target]);
+                      current = &spi0_slaves[r.target];
+                    }
+                  else
+                    {
+                      internal::spi0_ctrl::instance()
+                                            .regs_of(spi0->spi())
+                                            ->set_transfer_active(true);
+                    }
+                // In place: each byte is read after it has been written
+                  r.count = spi0->transfer(r.data, r.data, r.tx_count);
+                  internal::spi0_ctrl::instance().regs_of(spi0->spi())
+                                            ->set_transfer_active(false);
+                  break;
+                case bus_broker_op::i2c_write:
+                  if (!i2c)
+                    {
+                      r.outcome = bus_broker_outcome::rejected;
+                      break;
+                    }
+                  {
+                    std::size_t written{0U};
+                    r.status = i2c->write_all( r.target, r.data, r.tx_count
+                                             , &written
+                                             );
+                    r.count = written;
+                  }
+                  break;
+                case bus_broker_op::i2c_read:
+                  if (!i2c)
+                    {
+                      r.outcome = bus_broker_outcome::rejected;
+                      break;
+                    }
+                  {
+                    std::size_t read{0U};
+                    r.status = i2c->read_all( r.target, r.data, r.rx_count
+                                            , &read
+                                            );
+                    r.count = read;
+                  }
+                  break;
+                case bus_broker_op::i2c_write_then_read:
+                  if (!i2c)
+                    {
+                      r.outcome = bus_broker_outcome::rejected;
+                      break;
+                    }
+                  {
+                    if (r.tx_count>i2c_fifo_size)
+                      {
+                        throw std::out_of_range{"bus_broker: I2C write then "
+                                                "read has more bytes to write "
+                                                "than fit in the FIFO."};
+                      }
+                  // Bytes written are copied so reads may overwrite the buffer
+                    std::uint8_t tx[i2c_fifo_size];
+                    std::memcpy(tx, r.data, r.tx_count);
+                    std::size_t read{0U};
+                    r.status = i2c->write_then_read
+                                      ( r.target, tx, r.tx_count
+                                      , r.data, r.rx_count, &read
+                                      );
+                    r.count = read;
+                  }
+                  break;
+                default:
+                  r.outcome = bus_broker_outcome::rejected;
+                  break;
+                }
+            }
+          catch (std::exception & e)
+            {
+              current = nullptr;
+              r.outcome = bus_broker_outcome::failed;
+              std::strncpy( reinterpret_cast<char *>(r.data), e.what()
+                          , bus_broker_request::buffer_size-1U
+                          );
+              r.data[bus_broker_request::buffer_size-1U] = 0U;
+            }
+          channel->complete(idx);
+        }
+    }
+
+    bus_broker_client::buffer::buffer
+    ( bus_broker_channel & c
+    , std::uint32_t idx
+    )
+    : channel{&c}
+    , index{idx}
+    , bytes{c.slot(idx).data}
+    {}
+
+    bus_broker_client::buffer::~buffer()
+    {
+      if (channel)
+        {
+          channel->release(index);
+        }
+    }
+
+    bus_broker_client::buffer::buffer(buffer && other) noexcept
+    : channel{other.channel}
+    , index{other.index}
+    , bytes{other.bytes}
+    {
+      other.channel = nullptr;
+      other.bytes = nullptr;
+    }
+
+    bus_broker_client::bus_broker_client(char const * name)
+    : channel{new bus_broker_channel{name, bus_broker_channel::role::client}}
+    {}
+
+    bus_broker_client::~bus_broker_client()
+    {}
+
+    bus_broker_client::buffer bus_broker_client::acquire()
+    {
+      return buffer{*channel, channel->claim()};
+    }
+
+    std::size_t bus_broker_client::spi0_transfer
+    ( buffer & b
+    , std::size_t slave
+    , std::size_t count
+    )
+    {
+      if (b.channel!=channel.get() || count==0U || count>b.size())
+        {
+          throw std::invalid_argument{"bus_broker_client::spi0_transfer: "
+                                      "buffer not from this client or count "
+                                      "out of range."};
+        }
+      bus_broker_request & r(channel->slot(b.index));
+      r.op = bus_broker_op::spi0_transfer;
+      r.target = static_cast<std::uint32_t>(slave);
+      r.tx_count = static_cast<std::uint32_t>(count);
+      r.rx_count = static_cast<std::uint32_t>(count);
+      return perform( *channel, b.index
+                    , "bus_broker_client::spi0_transfer: SPI0 not brokered or "
+                      "slave index not valid."
+                    ).count;
+    }
+
+    int bus_broker_client::i2c_write
+    ( buffer & b
+    , std::uint32_t addrs
+    , std::size_t count
+    , std::size_t * pwritten
+    )
+    {
+      if (b.channel!=channel.get() || count>b.size())
+        {
+          throw std::invalid_argument{"bus_broker_client::i2c_write: buffer "
+                                      "not from this client or count out of "
+                                      "range."};
+        }
+      bus_broker_request & r(channel->slot(b.index));
+      r.op = bus_broker_op::i2c_write;
+      r.target = addrs;
+      r.tx_count = static_cast<std::uint32_t>(count);
+      r.rx_count = 0U;
+      perform(*channel, b.index, "bus_broker_client::i2c_write: I2C not "
+                                 "brokered.");
+      if (pwritten)
+        {
+          *pwritten = r.count;
+        }
+      return r.status;
+    }
+
+    int bus_broker_client::i2c_read
+    ( buffer & b
+    , std::uint32_t addrs
+    , std::size_t count
+    , std::size_t * pread
+    )
+    {
+      if (b.channel!=channel.get() || count>b.size())
+        {
+          throw std::invalid_argument{"bus_broker_client::i2c_read: buffer "
+                                      "not from this client or count out of "
+                                      "range."};
+        }
+      bus_broker_request & r(channel->slot(b.index));
+      r.op = bus_broker_op::i2c_read;
+      r.target = addrs;
+      r.tx_count = 0U;
+      r.rx_count = static_cast<std::uint32_t>(count);
+      perform(*channel, b.index, "bus_broker_client::i2c_read: I2C not "
+                                 "brokered.");
+      if (pread)
+        {
+          *pread = r.count;
+        }
+      return r.status;
+    }
+
+    int bus_broker_client::i2c_write_then_read
+    ( buffer & b
+    , std::uint32_t addrs
+    , std::size_t tx_count
+    , std::size_t rx_count
+    , std::size_t * pread
+    )
+    {
+      if (b.channel!=channel.get() || tx_count>b.size() || rx_count>b.size())
+        {
+          throw std::invalid_argument{"bus_broker_client::i2c_write_then_read:"
+                                      " buffer not from this client or count "
+                                      "out of range."};
+        }
+      bus_broker_request & r(channel->slot(b.index));
+      r.op = bus_broker_op::i2c_write_then_read;
+      r.target = addrs;
+      r.tx_count = static_cast<std::uint32_t>(tx_count);
+      r.rx_count = static_cast<std::uint32_t>(rx_count);
+      perform(*channel, b.index, "bus_broker_client::i2c_write_then_read: I2C "
+                                 "not brokered.");
+      if (pread)
+        {
+          *pread = r.count;
+        }
+      return r.status;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
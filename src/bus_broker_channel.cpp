@@ -0,0 +1,343 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file bus_broker_channel.cpp
+/// @brief Implementation of the bus broker shared memory request channel.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "bus_broker_channel.h"
+#include "periexcept.h"
+#include <cerrno>
+#include <climits>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      struct bus_broker_channel::region
+      {
+        std::atomic<std::uint32_t>  magic;    ///< initialised_magic when ready
+        std::atomic<std::int32_t>   server;   ///< Serving process id or 0
+        std::atomic<std::uint32_t>  doorbell; ///< Futex bumped on submission
+        std::atomic<std::uint32_t>  server_sleeping;///< Server in futex wait
+        std::atomic<std::uint32_t>  head;     ///< Next ring pop
+        std::atomic<std::uint32_t>  tail;     ///< Next ring push
+        std::atomic<std::uint32_t>  sequence[slot_count];///< Ring slot laps
+        std::uint32_t               queued[slot_count];  ///< Ring slot indexes
+        bus_broker_request          slots[slot_count];
+      };
+
+      namespace
+      {
+        static_assert( ATOMIC_INT_LOCK_FREE==2
+                     , "Bus broker shared memory channel requires lock free "
+                       "atomic int operations"
+                     );
+        static_assert( sizeof(std::atomic<std::uint32_t>)==sizeof(std::uint32_t)
+                     , "Bus broker futex words must be plain 32-bit words"
+                     );
+        static_assert( (bus_broker_channel::slot_count
+                       &(bus_broker_channel::slot_count-1U))==0U
+                     , "Bus broker slot count must be a power of two"
+                     );
+
+        std::uint32_t const initialised_magic{0x62726B31U};
+
+        enum slot_state : std::uint32_t
+        { free_slot
+        , claimed_slot
+        , submitted_slot
+        , completed_slot
+        };
+
+        unsigned const completion_spin_count{2000U};
+        long const server_check_interval_ns{100000000L};
+
+        bool is_live(std::int32_t pid)
+        {
+          return pid!=0 && (::kill(pid, 0)==0 || errno!=ESRCH);
+        }
+
+        long futex
+        ( std::atomic<std::uint32_t> & word
+        , int op
+        , std::uint32_t value
+        , ::timespec const * timeout = nullptr
+        )
+        {
+          return ::syscall( SYS_futex, reinterpret_cast<std::uint32_t *>(&word)
+                          , op, value, timeout, nullptr, 0
+                          );
+        }
+      }
+
+      constexpr std::size_t bus_broker_request::buffer_size;
+      constexpr std::uint32_t bus_broker_channel::slot_count;
+
+      bus_broker_channel::bus_broker_channel(char const * name, role r)
+      : shared{nullptr}
+      , object_name{name}
+      , serving{r==role::server}
+      {
+      // A newly created object is zero filled by ftruncate: not served
+        int fd{serving ? ::shm_open(name, O_RDWR|O_CREAT, 0666)
+                       : ::shm_open(name, O_RDWR, 0)
+              };
+        if (fd==-1)
+          {
+            throw std::system_error
+                  { errno, std::system_category()
+                  , "bus_broker_channel: shm_open failed"
+                  };
+          }
+        struct stat info;
+        if (serving ? ::ftruncate(fd, sizeof(region))==-1
+                    : ::fstat(fd, &info)==-1)
+          {
+            int const error{errno};
+            ::close(fd);
+            throw std::system_error
+                  { error, std::system_category()
+                  , "bus_broker_channel: sizing shared object failed"
+                  };
+          }
+        if (!serving && static_cast<std::size_t>(info.st_size)<sizeof(region))
+          {
+            ::close(fd);
+            throw std::runtime_error{"bus_broker_channel: shared object is "
+                                     "not a bus broker channel"};
+          }
+        void * mapped{::mmap( nullptr, sizeof(region)
+                            , PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0
+                            )};
+        int const error{errno};
+        ::close(fd);
+        if (mapped==MAP_FAILED)
+          {
+            throw std::system_error
+                  { error, std::system_category()
+                  , "bus_broker_channel: mmap failed"
+                  };
+          }
+        shared = static_cast<region *>(mapped);
+        if (serving)
+          {
+            std::int32_t const self{static_cast<std::int32_t>(::getpid())};
+            std::int32_t current{shared->server.load()};
+            do
+              {
+                if (current==self || is_live(current))
+                  {
+                    ::munmap(shared, sizeof(region));
+                    throw bad_peripheral_alloc{"bus_broker_channel: channel "
+                                               "is already being served"};
+                  }
+              }
+            while (!shared->server.compare_exchange_weak(current, self));
+            shared->magic.store(0U);
+            shared->doorbell.store(0U);
+            shared->server_sleeping.store(0U);
+            shared->head.store(0U);
+            shared->tail.store(0U);
+            for (std::uint32_t idx=0U; idx!=slot_count; ++idx)
+              {
+                shared->sequence[idx].store(idx);
+                shared->slots[idx].owner.store(0);
+                shared->slots[idx].state.store(free_slot);
+              }
+            shared->magic.store(initialised_magic, std::memory_order_release);
+          }
+        else if ( shared->magic.load(std::memory_order_acquire)
+                                                        !=initialised_magic
+               || !is_live(shared->server.load())
+                )
+          {
+            ::munmap(shared, sizeof(region));
+            throw std::runtime_error{"bus_broker_channel: channel has no "
+                                     "running server"};
+          }
+      }
+
+      bus_broker_channel::~bus_broker_channel()
+      {
+        if (serving)
+          {
+            shared->server.store(0);
+          // Wake clients waiting for completions so they see the server gone
+            for (std::uint32_t idx=0U; idx!=slot_count; ++idx)
+              {
+                futex(shared->slots[idx].state, FUTEX_WAKE, INT_MAX);
+              }
+            ::shm_unlink(object_name.c_str());
+          }
+        ::munmap(shared, sizeof(region));
+      }
+
+      bus_broker_request & bus_broker_channel::slot(std::uint32_t idx)
+      {
+        return shared->slots[idx];
+      }
+
+      std::uint32_t bus_broker_channel::claim()
+      {
+        std::int32_t const self{static_cast<std::int32_t>(::getpid())};
+        for (;;)
+          {
+            for (std::uint32_t idx=0U; idx!=slot_count; ++idx)
+              {
+                bus_broker_request & s(shared->slots[idx]);
+                std::uint32_t expected{free_slot};
+                if (s.state.compare_exchange_strong(expected, claimed_slot))
+                  {
+                    s.owner.store(self);
+                    return idx;
+                  }
+              }
+          // Released slots have no owner so only abandoned ones are taken
+            for (std::uint32_t idx=0U; idx!=slot_count; ++idx)
+              {
+                bus_broker_request & s(shared->slots[idx]);
+                std::uint32_t const state{s.state.load()};
+                std::int32_t owner{s.owner.load()};
+                if ( (state==claimed_slot || state==completed_slot)
+                  && owner!=0 && !is_live(owner)
+                  && s.owner.compare_exchange_strong(owner, self)
+                   )
+                  {
+                    s.state.store(claimed_slot);
+                    return idx;
+                  }
+              }
+            std::this_thread::yield();
+          }
+      }
+
+      void bus_broker_channel::submit(std::uint32_t idx)
+      {
+        shared->slots[idx].state.store( submitted_slot
+                                      , std::memory_order_release
+                                      );
+      // Never full: each of the slot_count slots is queued at most once
+        std::uint32_t pos{shared->tail.load(std::memory_order_relaxed)};
+        for (;;)
+          {
+            std::uint32_t const at{pos&(slot_count-1U)};
+            std::int32_t const lag
+                      { static_cast<std::int32_t>
+                        ( shared->sequence[at].load(std::memory_order_acquire)
+                        - pos
+                        )
+                      };
+            if (lag==0)
+              {
+                if (shared->tail.compare_exchange_weak
+                                    (pos, pos+1U, std::memory_order_relaxed))
+                  {
+                    shared->queued[at] = idx;
+                    shared->sequence[at].store( pos+1U
+                                              , std::memory_order_release
+                                              );
+                    break;
+                  }
+              }
+            else
+              {
+                pos = shared->tail.load(std::memory_order_relaxed);
+              }
+          }
+        shared->doorbell.fetch_add(1U);
+        if (shared->server_sleeping.load())
+          {
+            futex(shared->doorbell, FUTEX_WAKE, 1U);
+          }
+      }
+
+      void bus_broker_channel::wait_completed(std::uint32_t idx)
+      {
+        std::atomic<std::uint32_t> & state(shared->slots[idx].state);
+        for (unsigned spin=0U; spin!=completion_spin_count; ++spin)
+          {
+            if (state.load(std::memory_order_acquire)!=submitted_slot)
+              {
+                return;
+              }
+          }
+        ::timespec const interval{0, server_check_interval_ns};
+        while (state.load(std::memory_order_acquire)==submitted_slot)
+          {
+            futex(state, FUTEX_WAIT, submitted_slot, &interval);
+            if ( state.load(std::memory_order_acquire)==submitted_slot
+              && !is_live(shared->server.load())
+               )
+              {
+                throw std::runtime_error{"bus_broker_channel: server exited "
+                                         "before completing request"};
+              }
+          }
+      }
+
+      void bus_broker_channel::release(std::uint32_t idx)
+      {
+        shared->slots[idx].owner.store(0);
+        shared->slots[idx].state.store(free_slot, std::memory_order_release);
+      }
+
+      bool bus_broker_channel::take(std::uint32_t & idx)
+      {
+        std::uint32_t const pos{shared->head.load(std::memory_order_relaxed)};
+        std::uint32_t const at{pos&(slot_count-1U)};
+        if (shared->sequence[at].load(std::memory_order_acquire)!=pos+1U)
+          {
+            return false;
+          }
+        idx = shared->queued[at];
+        shared->sequence[at].store(pos+slot_count, std::memory_order_release);
+        shared->head.store(pos+1U, std::memory_order_relaxed);
+        return true;
+      }
+
+      void bus_broker_channel::wait_submitted
+      ( std::atomic<bool> const & stopping
+      )
+      {
+        std::uint32_t const bell{shared->doorbell.load()};
+        shared->server_sleeping.store(1U);
+      // Either a submitter sees server_sleeping set and wakes us or we see
+      // its queued slot here: both sides use sequentially consistent order.
+        std::uint32_t const pos{shared->head.load(std::memory_order_relaxed)};
+        if ( shared->sequence[pos&(slot_count-1U)].load()!=pos+1U
+          && !stopping.load()
+           )
+          {
+            futex(shared->doorbell, FUTEX_WAIT, bell);
+          }
+        shared->server_sleeping.store(0U);
+      }
+
+      void bus_broker_channel::interrupt()
+      {
+        shared->doorbell.fetch_add(1U);
+        futex(shared->doorbell, FUTEX_WAKE, INT_MAX);
+      }
+
+      void bus_broker_channel::complete(std::uint32_t idx)
+      {
+        shared->slots[idx].state.store( completed_slot
+                                      , std::memory_order_release
+                                      );
+        futex(shared->slots[idx].state, FUTEX_WAKE, INT_MAX);
+      }
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
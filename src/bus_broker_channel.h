@@ -0,0 +1,158 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file bus_broker_channel.h
+/// @brief \b Internal : POSIX shared memory request channel between a bus
+/// broker process and its client processes.
+///
+/// The shared object holds a fixed number of request slots, each with a
+/// buffer for the bytes of one transaction, and a lock-free multiple
+/// producer, single consumer ring of the indexes of submitted slots. A
+/// client claims a free slot, fills in the request and its bytes in place,
+/// then submits the slot's index. The server takes indexes from the ring,
+/// performs the requests, writing results back into the slots, and marks
+/// them completed. Sleeping waits on either side use futexes on words in
+/// the shared object so a waiting process is woken directly by the process
+/// it is waiting on.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_BUS_BROKER_CHANNEL_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_BUS_BROKER_CHANNEL_H
+
+# include <atomic>
+# include <cstddef>
+# include <cstdint>
+# include <string>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Enumeration of bus broker request operations
+      enum class bus_broker_op : std::uint32_t
+      { spi0_transfer       ///< Full-duplex SPI0 transfer of tx_count bytes
+      , i2c_write           ///< I2C write of tx_count bytes
+      , i2c_read            ///< I2C read of rx_count bytes
+      , i2c_write_then_read ///< I2C combined write then read
+      };
+
+    /// @brief Enumeration of bus broker request outcomes
+      enum class bus_broker_outcome : std::uint32_t
+      { done      ///< Performed: status and count hold results
+      , rejected  ///< Not performed: the bus or target is not brokered
+      , failed    ///< Failed: buffer holds the exception's message
+      };
+
+    /// @brief One request slot in the shared object.
+      struct bus_broker_request
+      {
+      /// @brief Size of each slot's transaction buffer in bytes
+        static constexpr std::size_t buffer_size = 4096U;
+
+        std::atomic<std::uint32_t>  state;    ///< Slot state futex word
+        std::atomic<std::int32_t>   owner;    ///< Claiming client process id
+        bus_broker_op               op;       ///< Requested operation
+        std::uint32_t               target;   ///< SPI0 slave index or I2C address
+        std::uint32_t               tx_count; ///< Bytes to write
+        std::uint32_t               rx_count; ///< Bytes to read
+        bus_broker_outcome          outcome;  ///< Result: outcome
+        std::int32_t                status;   ///< Result: operation status
+        std::uint32_t               count;    ///< Result: bytes transferred
+        std::uint8_t                data[buffer_size];///< Transaction bytes
+      };
+
+    /// @brief Shared memory channel between a bus broker and its clients.
+      class bus_broker_channel
+      {
+      public:
+      /// @brief Number of request slots in the shared object
+        static constexpr std::uint32_t slot_count = 16U;
+
+      /// @brief Enumeration of the side of the channel an object is for
+        enum class role
+        { server  ///< Creates the shared object and performs requests
+        , client  ///< Opens an existing shared object and submits requests
+        };
+
+      /// @brief Create or open the channel's shared object.
+      ///
+      /// A server creates the shared object if it does not exist, or takes
+      /// over one left by a server process that has exited, initialising it.
+      /// A client opens an existing object that has a running server.
+      ///
+      /// @param[in] name POSIX shared memory object name, e.g. "/my-broker".
+      /// @param[in] r    Role: server or client.
+      /// @throws bad_peripheral_alloc if role::server and another live process
+      ///         is serving the channel.
+      /// @throws std::runtime_error if role::client and the channel has no
+      ///         live server.
+      /// @throws std::system_error if the shared object cannot be created,
+      ///         opened or mapped.
+        bus_broker_channel(char const * name, role r);
+
+      /// @brief Unmap the shared object. A server marks the channel as not
+      /// served and removes the object's name.
+        ~bus_broker_channel();
+
+        bus_broker_channel(bus_broker_channel const &) = delete;
+        bus_broker_channel& operator=(bus_broker_channel const &) = delete;
+
+      /// @brief Returns a request slot.
+      /// @param[in] idx  Slot index [0, slot_count).
+        bus_broker_request & slot(std::uint32_t idx);
+
+      /// @brief Client: claim a free slot, yielding while there are none.
+      ///
+      /// Slots left claimed or completed by client processes that have exited
+      /// are reclaimed.
+      /// @returns Index of the claimed slot.
+        std::uint32_t claim();
+
+      /// @brief Client: submit a claimed slot's request to the server.
+      /// @param[in] idx  Index of claimed slot with its request filled in.
+        void submit(std::uint32_t idx);
+
+      /// @brief Client: wait until the server completes a submitted slot's
+      /// request.
+      ///
+      /// Spins briefly then sleeps on the slot's state futex, periodically
+      /// checking that the server process is still live.
+      /// @param[in] idx  Index of submitted slot.
+      /// @throws std::runtime_error if the server exits before completing
+      ///         the request.
+        void wait_completed(std::uint32_t idx);
+
+      /// @brief Client: release a claimed or completed slot for reuse.
+      /// @param[in] idx  Index of slot to release.
+        void release(std::uint32_t idx);
+
+      /// @brief Server: take the next submitted slot, if any.
+      /// @param[out] idx Assigned the index of the taken slot.
+      /// @returns true if a slot was taken, false if none were submitted.
+        bool take(std::uint32_t & idx);
+
+      /// @brief Server: sleep until a slot may have been submitted or
+      /// interrupt is called.
+      /// @param[in] stopping Flag set before calling interrupt to stop the
+      ///                     server: not slept on once set.
+        void wait_submitted(std::atomic<bool> const & stopping);
+
+      /// @brief Server: wake a server thread sleeping in wait_submitted.
+        void interrupt();
+
+      /// @brief Server: mark a taken slot's request completed and wake its
+      /// client.
+      /// @param[in] idx  Index of taken slot with its results filled in.
+        void complete(std::uint32_t idx);
+
+      private:
+        struct region;
+
+        region *      shared;
+        std::string   object_name;
+        bool          serving;
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_BUS_BROKER_CHANNEL_H
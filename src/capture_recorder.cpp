@@ -0,0 +1,269 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file capture_recorder.cpp
+/// @brief Memory mapped capture file recorder and reader implementations.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "capture_recorder.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+      char const capture_magic[8]{'D','B','R','P','I','C','A','P'};
+      std::uint32_t const capture_version{1U};
+
+      static_assert( sizeof(capture_record)==16U
+                   , "capture_record must be 16 bytes with no padding"
+                   );
+      static_assert( sizeof(capture_file_header)%sizeof(capture_record)==0U
+                   , "capture_file_header must keep records aligned"
+                   );
+
+      void * map_file(int fd, std::size_t size, int prot, char const * what)
+      {
+        void * mapped{::mmap(nullptr, size, prot, MAP_SHARED, fd, 0)};
+        int const error{errno};
+        ::close(fd);
+        if (mapped==MAP_FAILED)
+          {
+            throw std::system_error{error, std::system_category(), what};
+          }
+        return mapped;
+      }
+    }
+
+    constexpr std::uint32_t capture_record::levels_bank0;
+    constexpr std::uint32_t capture_record::levels_bank1;
+
+    capture_recorder::capture_recorder
+    ( char const * path
+    , std::size_t capacity
+    , std::size_t sync_records
+    )
+    : header{nullptr}
+    , records{nullptr}
+    , mapped_size{sizeof(capture_file_header)+capacity*sizeof(capture_record)}
+    , sync_interval{sync_records}
+    , unsynced{0U}
+    , synced_count{0U}
+    , dropped_count{0U}
+    {
+      if (capacity==0U)
+        {
+          throw std::invalid_argument{"capture_recorder: capacity must be "
+                                      "greater than zero."};
+        }
+      int const fd{::open(path, O_RDWR|O_CREAT|O_TRUNC|O_CLOEXEC, 0644)};
+      if (fd==-1)
+        {
+          throw std::system_error
+                { errno, std::system_category()
+                , "capture_recorder: creating file failed with error from "
+                  "call to open."
+                };
+        }
+      int const error{::posix_fallocate(fd, 0, mapped_size)};
+      if (error!=0)
+        {
+          ::close(fd);
+          throw std::system_error
+                { error, std::system_category()
+                , "capture_recorder: allocating file failed with error from "
+                  "call to posix_fallocate."
+                };
+        }
+      void * mapped{map_file( fd, mapped_size, PROT_READ|PROT_WRITE
+                            , "capture_recorder: mmap failed"
+                            )};
+      header = static_cast<capture_file_header *>(mapped);
+      records = reinterpret_cast<capture_record *>(header+1);
+      std::memcpy(header->magic, capture_magic, sizeof(capture_magic));
+      header->version = capture_version;
+      header->record_size = sizeof(capture_record);
+      header->capacity = capacity;
+      header->count = 0U;
+    }
+
+    capture_recorder::~capture_recorder()
+    {
+      sync(MS_SYNC);
+      ::munmap(header, mapped_size);
+    }
+
+    bool capture_recorder::sync(int flags) noexcept
+    {
+      std::size_t const page{static_cast<std::size_t>(::sysconf(_SC_PAGESIZE))};
+      std::size_t const begin{ (sizeof(capture_file_header)
+                               +synced_count*sizeof(capture_record))/page*page
+                             };
+      std::size_t const end{ sizeof(capture_file_header)
+                           + size()*sizeof(capture_record)
+                           };
+      char * const base{reinterpret_cast<char *>(header)};
+      bool const synced
+                  { (end<=begin || ::msync(base+begin, end-begin, flags)==0)
+                  && ::msync(base, std::min(page, mapped_size), flags)==0
+                  };
+      synced_count = size();
+      unsynced = 0U;
+      return synced;
+    }
+
+    bool capture_recorder::append(capture_record const & r) noexcept
+    {
+      std::uint64_t const count{header->count};
+      if (count==header->capacity)
+        {
+          ++dropped_count;
+          return false;
+        }
+      records[count] = r;
+      header->count = count+1U;
+      if (sync_interval!=0U && ++unsynced==sync_interval)
+        {
+          sync(MS_ASYNC);
+        }
+      return true;
+    }
+
+    bool capture_recorder::record(edge_event_record const & event) noexcept
+    {
+      capture_record const r{ event.timestamp.count()
+                            , event.pin
+                            , event.edge==pin_edge_event::rising ? 1U : 0U
+                            };
+      return append(r);
+    }
+
+    std::size_t capture_recorder::record
+    ( edge_event_record const * events
+    , std::size_t count
+    ) noexcept
+    {
+      std::size_t recorded{0U};
+      while (recorded!=count && record(events[recorded]))
+        {
+          ++recorded;
+        }
+      if (recorded!=count)
+        { // record counted the first dropped
+          dropped_count += count-recorded-1U;
+        }
+      return recorded;
+    }
+
+    bool capture_recorder::record_levels
+    ( std::chrono::nanoseconds timestamp
+    , std::uint32_t const volatile * levels
+    ) noexcept
+    {
+      if (header->capacity-header->count<2U)
+        {
+          dropped_count += 2U;
+          return false;
+        }
+      append({timestamp.count(), capture_record::levels_bank0, levels[0]});
+      append({timestamp.count(), capture_record::levels_bank1, levels[1]});
+      return true;
+    }
+
+    void capture_recorder::flush()
+    {
+      if (!sync(MS_SYNC))
+        {
+          throw std::system_error
+                { errno, std::system_category()
+                , "capture_recorder: flush failed with error from call to "
+                  "msync."
+                };
+        }
+    }
+
+    capture_reader::capture_reader(char const * path)
+    : header{nullptr}
+    , records{nullptr}
+    , mapped_size{0U}
+    {
+      int const fd{::open(path, O_RDONLY|O_CLOEXEC)};
+      if (fd==-1)
+        {
+          throw std::system_error
+                { errno, std::system_category()
+                , "capture_reader: opening file failed with error from call "
+                  "to open."
+                };
+        }
+      struct stat info;
+      if (::fstat(fd, &info)==-1)
+        {
+          int const error{errno};
+          ::close(fd);
+          throw std::system_error
+                { error, std::system_category()
+                , "capture_reader: sizing file failed with error from call "
+                  "to fstat."
+                };
+        }
+      if (static_cast<std::size_t>(info.st_size)<sizeof(capture_file_header))
+        {
+          ::close(fd);
+          throw std::runtime_error{"capture_reader: file is not a capture "
+                                   "file."};
+        }
+      mapped_size = static_cast<std::size_t>(info.st_size);
+      void * mapped{map_file( fd, mapped_size, PROT_READ
+                            , "capture_reader: mmap failed"
+                            )};
+      header = static_cast<capture_file_header const *>(mapped);
+      records = reinterpret_cast<capture_record const *>(header+1);
+      char const * problem{nullptr};
+      if (std::memcmp(header->magic, capture_magic, sizeof(capture_magic))!=0)
+        {
+          problem = "capture_reader: file is not a capture file.";
+        }
+      else if ( header->version!=capture_version
+             || header->record_size!=sizeof(capture_record)
+              )
+        {
+          problem = "capture_reader: unsupported capture file version.";
+        }
+      else if ( (mapped_size-sizeof(capture_file_header))
+                /sizeof(capture_record)<header->capacity
+              )
+        {
+          problem = "capture_reader: capture file is truncated.";
+        }
+      if (problem)
+        {
+          ::munmap(const_cast<capture_file_header *>(header), mapped_size);
+          throw std::runtime_error{problem};
+        }
+    }
+
+    capture_reader::~capture_reader()
+    {
+      ::munmap(const_cast<capture_file_header *>(header), mapped_size);
+    }
+
+    std::size_t capture_reader::size() const
+    {
+      std::uint64_t const count
+                { *static_cast<std::uint64_t const volatile *>(&header->count)
+                };
+      return static_cast<std::size_t>
+                (count<header->capacity ? count : header->capacity);
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -14,7 +14,10 @@ namespace dibase { namespace rpi {
   { namespace internal
     {
       clock_ctrl::clock_ctrl()
-      : regs(clock_registers::physical_address, register_block_size)
+      : regs( peripheral_window::instance()
+            , clock_registers::physical_address
+            , register_block_size
+            )
       {}
 
       clock_ctrl & clock_ctrl::instance()
@@ -44,7 +47,8 @@ namespace dibase { namespace rpi {
       clock_id index_to_clock_id(unsigned i)
       {
         static clock_id clocks[] = { gp0_clk_id, gp1_clk_id
-                                   , gp2_clk_id, pwm_clk_id
+                                   , gp2_clk_id, pwm_clk_id, pcm_clk_id
+                                   , smi_clk_id
                                    };
         return clocks[i];
       }     
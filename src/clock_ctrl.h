@@ -22,10 +22,13 @@ namespace dibase { namespace rpi {
       constexpr unsigned gpclk1{1U}; ///< GPCLK1 internal index value
       constexpr unsigned gpclk2{2U}; ///< GPCLK2 internal index value
       constexpr unsigned pwmclk{3U}; ///< PWMCLK internal index value
-      constexpr std::size_t number_of_clocks{4U};///< Number of supported clocks
+      constexpr unsigned pcmclk{4U}; ///< PCMCLK internal index value
+      constexpr unsigned smiclk{5U}; ///< SMICLK internal index value
+      constexpr std::size_t number_of_clocks{6U};///< Number of supported clocks
 
     /// @brief Convert an internal clock index value to a #clock_id enum value
-    /// @param i  Internal clock index value: gpclk0, gpclk1, gpclk2 or pwmclk.
+    /// @param i  Internal clock index value: gpclk0, gpclk1, gpclk2, pwmclk,
+    ///           pcmclk or smiclk.
     ///           NOT range checked.
     /// @returns #clock_id enumeration value used with clock register operations
       clock_id index_to_clock_id(unsigned i);
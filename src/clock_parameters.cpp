@@ -156,6 +156,20 @@ namespace dibase { namespace rpi {
                     };
           }
       }
+
+      clock_parameters::clock_parameters(static_clock_settings const & settings)
+      : freq_min(settings.frequency_min())
+      , freq_avg(settings.frequency_avg())
+      , freq_max(settings.frequency_max())
+      , source{clock_source_to_clock_src(settings.source())}
+      , mash{static_cast<clock_mash_mode> // MASH n field value is n*stage 1's
+              ( static_cast<register_t>(settings.mash())
+              * static_cast<register_t>(clock_mash_mode::mash_1_stage)
+              )}
+      , divi{settings.divi()}
+      , divf{settings.divf()}
+      {
+      }
     } // namespace internal closed
   } // namespace peripherals closed
 }} // namespaces rpi and dibase closed
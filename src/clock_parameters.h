@@ -9,6 +9,7 @@
 # define DIBASE_RPI_PERIPHERALS_CLOCK_PARAMETERS_H
 # include "clockdefs.h"
 # include "clock_registers.h"
+# include "static_clock_parameters.h"
 
 namespace dibase { namespace rpi {
   namespace peripherals
@@ -75,6 +76,13 @@ namespace dibase { namespace rpi {
         , clock_frequency freq
         );
 
+      /// @brief Create from values already calculated and checked at compile
+      /// time by static_clock_parameters.
+      ///
+      /// No calculations or checks are performed.
+      /// @param settings Compile time calculated clock parameters
+        explicit clock_parameters(static_clock_settings const & settings);
+
       /// @brief Return calculated clock minimum frequency
       /// @returns Calculated clock minimum frequency
         hertz           frequency_min() const { return freq_min; }
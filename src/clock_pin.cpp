@@ -10,6 +10,8 @@
 #include "clock_ctrl.h"
 #include "gpio_ctrl.h"
 #include "gpio_alt_fn.h"
+#include "peripheral_barrier.h"
+#include <stdexcept>
 
 namespace dibase { namespace rpi {
   namespace peripherals
@@ -50,12 +52,31 @@ namespace dibase { namespace rpi {
       clock_ctrl::instance().alloc.deallocate(clk);
     }
 
+    clock_pin::clock_pin(pin_id p, static_clock_settings const & s)
+    : src_freq{s.source_frequency()}
+    , src_type{s.source()}
+    , clk{construct(p, internal::clock_parameters{s})}
+    , pin{p}
+    {}
+
     unsigned clock_pin::construct
     ( pin_id pin
     , hertz src_freq
     , clock_source src_type
     , clock_frequency const & freq
     )
+    {
+      using internal::clock_parameters;
+      clock_parameters cp(src_type, src_freq, freq); // CAN THROW!!!
+      this->src_freq = src_freq;
+      this->src_type = src_type;
+      return construct(pin, cp);
+    }
+
+    unsigned clock_pin::construct
+    ( pin_id pin
+    , internal::clock_parameters const & cp
+    )
     { // Select alt function descriptors for pin for GPCLKn special functions
       using internal::pin_alt_fn::result_set;
       using internal::pin_alt_fn::select;
@@ -95,9 +116,8 @@ namespace dibase { namespace rpi {
                                                       gpclk2 
                   );
       try
-      {
-        using internal::clock_parameters;
-        clock_parameters cp(src_type, src_freq, freq); // CAN THROW!!!
+      { // Clock manager then GPIO: barriers at peripheral switches
+        peripheral_barrier();
         clock_ctrl::instance().allocate_and_initialise_clock(clk_idx, cp); // CAN THROW!!!
         freq_min = cp.frequency_min();
         freq_avg = cp.frequency_avg();
@@ -108,8 +128,48 @@ namespace dibase { namespace rpi {
         gpio_ctrl::instance().alloc.deallocate(pin);
         throw; 
       }
-      gpio_ctrl::instance().regs->set_pin_function(pin,clk_fn_info[0].alt_fn());
+      peripheral_barrier();
+      gpio_ctrl::instance().config.set_pin_function
+                                                (pin,clk_fn_info[0].alt_fn());
+      peripheral_barrier();
       return clk_idx;
     }
+
+    void clock_pin::set_tuning_table(std::vector<clock_frequency> const & freqs)
+    {
+      using internal::clock_parameters;
+      auto const mash(clock_ctrl::instance().regs->get_mash
+                                                    (index_to_clock_id(clk)));
+      std::vector<tuning> new_tunings;
+      new_tunings.reserve(freqs.size());
+      for (auto const & freq : freqs)
+        {
+          clock_parameters cp(src_type, src_freq, freq); // CAN THROW!!!
+          if (cp.clk_mash()!=mash)
+            {
+              throw std::invalid_argument
+                    {"clock_pin::set_tuning_table: Frequency requires a MASH "
+                     "filtering mode different from the clock's."
+                    };
+            }
+          new_tunings.push_back( { cp.clk_divi(), cp.clk_divf()
+                                 , cp.frequency_min(), cp.frequency_avg()
+                                 , cp.frequency_max()
+                                 }
+                               );
+        }
+      tunings.swap(new_tunings);
+    }
+
+    void clock_pin::retune(std::size_t idx)
+    {
+      tuning const & t(tunings.at(idx));
+      clock_ctrl::instance().regs->set_divisor( index_to_clock_id(clk)
+                                              , t.divi, t.divf
+                                              );
+      freq_min = t.freq_min;
+      freq_avg = t.freq_avg;
+      freq_max = t.freq_max;
+    }
   } // namespace peripherals closed
 }} // namespaces rpi and dibase closed
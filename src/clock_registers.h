@@ -118,6 +118,16 @@ namespace dibase { namespace rpi {
       /// @returns true if ENAB control bit set or false if it is not.
         bool get_enable() volatile const { return control&ctrl_enab_mask; }
 
+      /// @brief Returns the control register value that sets ENAB
+      ///
+      /// The current control register value with ENAB set and the password
+      /// applied, so it can be calculated ahead of writing it. Unlike
+      /// set_enable no check is made for the clock being busy.
+        register_t enable_value() volatile const
+        {
+          return password|control|ctrl_enab_mask;
+        }
+
       /// @brief Returns value of KILL control register bit
       /// @returns true if KILL control bit set or false if it is not.
         bool get_kill() volatile const { return control&ctrl_kill_mask; }
@@ -311,6 +321,29 @@ namespace dibase { namespace rpi {
                     | divf;               // new DIVF bits on
           return true;
         }
+
+      /// @brief Set the values of both DIVI and DIVF divisor register fields
+      /// in a single password protected write.
+      ///
+      /// Unlike set_divi and set_divf this is intended to be used while the
+      /// clock is running so that its frequency can be changed without
+      /// stopping it: the divisor register is written once, so the clock never
+      /// runs with a mixture of old and new DIVI and DIVF values. The MASH
+      /// setting is not changed or checked, so divi should be valid for the
+      /// current MASH mode (see set_divi).
+      /// @param divi  Value to set divi field to in range [1,0xfff].
+      /// @param divf  Value to set divf field to in range [0,0xfff].
+      /// @returns  true if operation performed, false if it was not performed
+      ///           because divi or divf values are out of range.
+        bool set_divisor(register_t divi, register_t divf) volatile
+        {
+          if (divi<div_divi_min || divi>div_divi_max || divf>div_divf_max)
+            {
+              return false;
+            }
+          divisor = password|(divi<<div_divi_shift)|divf;
+          return true;
+        }
       };
 
       struct clock_registers;
@@ -338,12 +371,17 @@ namespace dibase { namespace rpi {
       private:
         enum
         { gp_offset   = 28
+        , pcm_offset  = 38
         , pwm_offset  = 40
+        , smi_offset  = 44
         , regs_per_clk= 2 
         , num_gp_clks = 3 
         
-      /// @brief 32-bit register gap between GP clocks end & PWM clocks start
-        , gp_pwm_gap=pwm_offset-gp_offset-(num_gp_clks*regs_per_clk)
+      /// @brief 32-bit register gap between GP clocks end & PCM clock start
+        , gp_pcm_gap=pcm_offset-gp_offset-(num_gp_clks*regs_per_clk)
+
+      /// @brief 32-bit register gap between PWM clock end & SMI clock start
+        , pwm_smi_gap=smi_offset-pwm_offset-regs_per_clk
         };
       public:
       /// @brief Physical address of start of BCM2835 clock control registers
@@ -355,9 +393,13 @@ namespace dibase { namespace rpi {
         clock_record gp1_clk; ///< General purpose clock 1
         clock_record gp2_clk; ///< General purpose clock 2
 
-        register_t reserved_do_not_use_1[gp_pwm_gap];///< Reserved, currently unused
+        register_t reserved_do_not_use_1[gp_pcm_gap];///< Reserved, currently unused
+        clock_record pcm_clk; ///< PCM / I2S clock
         clock_record pwm_clk; ///< PWM clock
 
+        register_t reserved_do_not_use_2[pwm_smi_gap];///< Reserved, unused
+        clock_record smi_clk; ///< SMI (secondary memory interface) clock
+
       /// @brief Return status of control register BUSY flag for specified clock.
       /// @param clk  Clock id of clock to return busy status of
       /// @returns true if control register BUSY bit set, false if not.
@@ -542,6 +584,24 @@ namespace dibase { namespace rpi {
         { 
           return (this->*clk).set_divf(divf, force);
         }
+
+      /// @brief Set the values of clock DIVI and DIVF divisor register fields
+      /// in a single write, whether or not the clock is busy.
+      ///
+      /// See clock_record::set_divisor.
+      /// @param clk   Clock id of clock to modify divisor register of
+      /// @param divi  Value to set divi field to in range [1,0xfff].
+      /// @param divf  Value to set divf field to in range [0,0xfff].
+      /// @returns  true if operation performed, false if it was not performed
+      ///           because divi or divf values are out of range.
+        bool set_divisor
+        ( clock_id clk
+        , register_t divi
+        , register_t divf
+        ) volatile
+        {
+          return (this->*clk).set_divisor(divi, divf);
+        }
       };
 
     /// @brief clock_registers id value for general purpose clock 0
@@ -553,8 +613,14 @@ namespace dibase { namespace rpi {
     /// @brief clock_registers id value for general purpose clock 2
       constexpr clock_id gp2_clk_id{&clock_registers::gp2_clk};
 
+    /// @brief clock_registers id value for the PCM / I2S clock
+      constexpr clock_id pcm_clk_id{&clock_registers::pcm_clk};
+
     /// @brief clock_registers id value for the PWM clock
       constexpr clock_id pwm_clk_id{&clock_registers::pwm_clk};
+
+    /// @brief clock_registers id value for the SMI clock
+      constexpr clock_id smi_clk_id{&clock_registers::smi_clk};
     } // namespace internal closed
   } // namespace peripherals closed
 }} // namespaces rpi and dibase closed
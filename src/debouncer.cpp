@@ -0,0 +1,174 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file debouncer.cpp
+/// @brief Debounce filter and debouncer class implementations.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "debouncer.h"
+#include <stdexcept>
+#include <time.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+      std::chrono::nanoseconds monotonic_now()
+      {
+        ::timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        return std::chrono::seconds{now.tv_sec}
+             + std::chrono::nanoseconds{now.tv_nsec};
+      }
+    }
+
+    unsigned const debounce_filter::max_threshold;
+
+    debounce_filter::debounce_filter
+    ( pin_group_value_t inputs
+    , pin_group_value_t initial
+    , unsigned updates
+    )
+    : mask{inputs}
+    , debounced{initial&inputs}
+    , moving{0U}
+    , threshold{static_cast<std::uint16_t>(updates)}
+    {
+      if (updates==0U || updates>max_threshold)
+        {
+          throw std::invalid_argument{"debounce_filter::debounce_filter: "
+                                      "threshold out of range."};
+        }
+      for (std::size_t idx=0; idx!=counters.size(); ++idx)
+        {
+          counters[idx] = (debounced>>idx)&1U ? threshold : 0U;
+        }
+    }
+
+    pin_group_value_t debounce_filter::update(pin_group_value_t sample)
+    {
+      sample &= mask;
+      pin_group_value_t pending{(sample^debounced)|moving};
+      pin_group_value_t changes{0U};
+      while (pending!=0U)
+        {
+          unsigned const idx{static_cast<unsigned>(__builtin_ctzll(pending))};
+          pin_group_value_t const bit{pin_group_value_t(1)<<idx};
+          pending &= pending-1U;
+          std::uint16_t & count(counters[idx]);
+          if ((sample&bit)!=0U)
+            {
+              if (count<threshold)
+                {
+                  ++count;
+                }
+            }
+          else if (count!=0U)
+            {
+              --count;
+            }
+          if (count==threshold && (debounced&bit)==0U)
+            {
+              debounced |= bit;
+              changes |= bit;
+            }
+          else if (count==0U && (debounced&bit)!=0U)
+            {
+              debounced &= ~bit;
+              changes |= bit;
+            }
+          bool const at_rest{count==((debounced&bit)!=0U ? threshold : 0U)};
+          moving = at_rest ? moving&~bit : moving|bit;
+        }
+      return changes;
+    }
+
+    debouncer::debouncer
+    ( ipin_group & pins
+    , std::chrono::microseconds tick
+    , unsigned stable_ticks
+    , std::size_t capacity
+    , rt_config const & config
+    )
+    : group(pins)
+    , tick_period{tick}
+    , filter{pins.all_pins(), pins.get(), stable_ticks}
+    , ring{capacity}
+    , debounced{filter.state()}
+    , overrun_count{0U}
+    , missed_count{0U}
+    , stopping{false}
+    , poller_failed{false}
+    {
+      if (tick.count()<=0)
+        {
+          throw std::invalid_argument{"debouncer::debouncer: tick must be "
+                                      "greater than zero."};
+        }
+      poller = rt_thread{config, [this](){ poll_pins(); }};
+    }
+
+    debouncer::~debouncer()
+    {
+      stopping.store(true, std::memory_order_release);
+      poller.join();
+    }
+
+    void debouncer::poll_pins()
+    {
+      try
+        {
+          rt_period period{tick_period};
+          while (!stopping.load(std::memory_order_acquire))
+            {
+              if (!period.wait())
+                {
+                  missed_count.fetch_add(1U, std::memory_order_relaxed);
+                }
+              pin_group_value_t changes{filter.update(group.get())};
+              if (changes==0U)
+                {
+                  continue;
+                }
+              pin_group_value_t const levels{filter.state()};
+              debounced.store(levels, std::memory_order_release);
+              edge_event_record event;
+              event.timestamp = monotonic_now();
+              while (changes!=0U)
+                {
+                  unsigned const idx
+                            {static_cast<unsigned>(__builtin_ctzll(changes))};
+                  changes &= changes-1U;
+                  event.pin = group.get_pin(idx);
+                  event.edge = (levels>>idx)&1U ? pin_edge_event::rising
+                                                : pin_edge_event::falling;
+                  if (!ring.try_push(event))
+                    {
+                      overrun_count.fetch_add(1U, std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+      catch (...)
+        {
+          poller_error = std::current_exception();
+          poller_failed.store(true, std::memory_order_release);
+        }
+    }
+
+    std::size_t debouncer::pop
+    ( edge_event_record * events
+    , std::size_t max_events
+    )
+    {
+      std::size_t const count{ring.pop(events, max_events)};
+      if (count==0U && max_events!=0U
+       && poller_failed.load(std::memory_order_acquire) && ring.empty())
+        {
+          std::rethrow_exception(poller_error);
+        }
+      return count;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
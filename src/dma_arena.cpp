@@ -0,0 +1,38 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file dma_arena.cpp
+/// @brief \b Internal : sub-allocation of DMA accessible memory implementation
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "dma_arena.h"
+#include <new>
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      dma_buffer dma_region::allocate(std::size_t bytes, std::size_t alignment)
+      {
+        if (alignment==0U || (alignment&(alignment-1U))!=0U)
+          {
+            throw std::invalid_argument{"dma_region::allocate: alignment must "
+                                        "be a power of two."};
+          }
+      // Align the bus address: region may not start on alignment boundary
+        std::size_t const misalign{(base_bus+used)&(alignment-1U)};
+        std::size_t const start{used + (misalign ? alignment-misalign : 0U)};
+        if (start>length || bytes>length-start)
+          {
+            throw std::bad_alloc{};
+          }
+        used = start+bytes;
+        return dma_buffer{ base+start
+                         , base_bus+static_cast<register_t>(start)
+                         , bytes
+                         };
+      }
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
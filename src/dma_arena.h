@@ -0,0 +1,157 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file dma_arena.h
+/// @brief \b Internal : sub-allocation of DMA accessible memory type
+/// definitions.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_DMA_ARENA_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_DMA_ARENA_H
+
+# include "vc_mailbox.h"
+# include "dma_registers.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Piece of DMA accessible memory with its process and bus
+    /// addresses.
+      struct dma_buffer
+      {
+        void *      address;      ///< Process (virtual) address
+        register_t  bus_address;  ///< VideoCore bus address for DMA
+        std::size_t size;         ///< Size in bytes
+      };
+
+    /// @brief Bump allocator over a contiguous region of DMA accessible
+    /// memory.
+    ///
+    /// Allocations are carved from the region in order and are only freed
+    /// together by reset. The region memory is not owned and must outlive the
+    /// dma_region.
+      class dma_region
+      {
+        unsigned char * base;     ///< Process address of region start
+        register_t      base_bus; ///< Bus address of region start
+        std::size_t     length;   ///< Region size in bytes
+        std::size_t     used;     ///< Bytes allocated, including padding
+
+      public:
+      /// @brief Construct over a region of memory.
+      /// @param region     Process address of region.
+      /// @param region_bus Bus address of region.
+      /// @param bytes      Size of region in bytes.
+        dma_region(void * region, register_t region_bus, std::size_t bytes)
+        : base{static_cast<unsigned char *>(region)}
+        , base_bus{region_bus}
+        , length{bytes}
+        , used{0U}
+        {}
+
+      /// @brief Allocate bytes from the region.
+      /// @param bytes      Size of allocation.
+      /// @param alignment  Required bus address alignment. Must be a power of
+      ///                   two.
+      /// @returns Allocated buffer.
+      /// @throws std::invalid_argument if alignment is not a power of two.
+      /// @throws std::bad_alloc if the region has insufficient space.
+        dma_buffer allocate(std::size_t bytes, std::size_t alignment=4U);
+
+      /// @brief Allocate a contiguous array of 32 byte aligned control blocks
+      /// @param count  Number of control blocks.
+      /// @returns Pointer to first control block.
+      /// @throws std::bad_alloc if the region has insufficient space.
+        dma_control_block * allocate_control_blocks(std::size_t count)
+        {
+          return static_cast<dma_control_block *>
+                  (allocate(count*sizeof(dma_control_block)
+                           , alignof(dma_control_block)
+                           ).address
+                  );
+        }
+
+      /// @brief Returns bus address of a location in the region.
+      /// @param p  Process address inside the region.
+        register_t bus_address(void const * p) const
+        {
+          return base_bus + static_cast<register_t>
+                              (static_cast<unsigned char const *>(p) - base);
+        }
+
+      /// @brief Returns number of bytes not yet allocated.
+        std::size_t available() const
+        {
+          return length-used;
+        }
+
+      /// @brief Free all allocations.
+        void reset()
+        {
+          used = 0U;
+        }
+      };
+
+    /// @brief Locked, physically contiguous VideoCore memory sub-allocated
+    /// for control blocks and data buffers.
+    ///
+    /// A single mailbox allocation is made on construction so many small
+    /// DMA buffers can be obtained without further mailbox calls.
+      class dma_arena
+      {
+        vc_mem_block  memory; ///< VideoCore memory of the whole arena
+        dma_region    region; ///< Sub-allocator over memory
+
+      public:
+      /// @brief Allocate arena memory.
+      /// @param bytes  Minimum arena size. Rounded up to a page multiple.
+      /// @throws std::system_error if /dev/vcio or /dev/mem cannot be opened
+      ///         or a mailbox call fails.
+      /// @throws std::bad_alloc if the VideoCore cannot supply the memory.
+        explicit dma_arena(std::size_t bytes)
+        : memory{bytes}
+        , region{memory.get(), memory.bus_address(), memory.size()}
+        {}
+
+      /// @brief Allocate a data buffer. See dma_region::allocate.
+        dma_buffer allocate(std::size_t bytes, std::size_t alignment=4U)
+        {
+          return region.allocate(bytes, alignment);
+        }
+
+      /// @brief Allocate control blocks. See
+      /// dma_region::allocate_control_blocks.
+        dma_control_block * allocate_control_blocks(std::size_t count)
+        {
+          return region.allocate_control_blocks(count);
+        }
+
+      /// @brief Returns bus address of a location in the arena.
+        register_t bus_address(void const * p) const
+        {
+          return region.bus_address(p);
+        }
+
+      /// @brief Returns number of bytes not yet allocated.
+        std::size_t available() const
+        {
+          return region.available();
+        }
+
+      /// @brief Returns arena size in bytes.
+        std::size_t size() const
+        {
+          return memory.size();
+        }
+
+      /// @brief Free all allocations.
+        void reset()
+        {
+          region.reset();
+        }
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_DMA_ARENA_H
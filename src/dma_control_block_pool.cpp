@@ -0,0 +1,62 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file dma_control_block_pool.cpp
+/// @brief \b Internal : pool of DMA control blocks implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "dma_control_block_pool.h"
+#include <new>
+#include <stdexcept>
+#include <cstring>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      dma_control_block_pool::dma_control_block_pool
+      ( dma_control_block * cbs
+      , register_t cbs_bus
+      , std::size_t count
+      )
+      : blocks{cbs}
+      , blocks_bus{cbs_bus}
+      {
+        free_list.reserve(count);
+        for (std::size_t idx=count; idx!=0U; --idx)
+          { // lowest index allocated first
+            free_list.push_back(idx-1U);
+          }
+      }
+
+      std::size_t dma_control_block_pool::index_of
+      ( dma_control_block const * cb
+      ) const
+      {
+        if (cb<blocks || cb>=blocks+capacity())
+          {
+            throw std::invalid_argument{"dma_control_block_pool: control "
+                                        "block is not from this pool."};
+          }
+        return static_cast<std::size_t>(cb-blocks);
+      }
+
+      dma_control_block * dma_control_block_pool::allocate()
+      {
+        if (free_list.empty())
+          {
+            throw std::bad_alloc{};
+          }
+        dma_control_block * cb{blocks+free_list.back()};
+        free_list.pop_back();
+        std::memset(cb, 0, sizeof(*cb));
+        return cb;
+      }
+
+      void dma_control_block_pool::deallocate(dma_control_block * cb)
+      {
+        free_list.push_back(index_of(cb));
+      }
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
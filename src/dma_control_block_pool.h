@@ -0,0 +1,86 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file dma_control_block_pool.h
+/// @brief \b Internal : pool of DMA control blocks type definition.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_DMA_CONTROL_BLOCK_POOL_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_DMA_CONTROL_BLOCK_POOL_H
+
+# include "dma_registers.h"
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Fixed size pool of DMA control blocks in DMA accessible memory.
+    ///
+    /// Allocation and deallocation are constant time, taking and returning
+    /// block indexes from a free list. The pool does not own the memory it
+    /// manages, which must outlive the pool.
+      class dma_control_block_pool
+      {
+        dma_control_block *       blocks;     ///< First block in pool memory
+        register_t                blocks_bus; ///< Bus address of blocks
+        std::vector<std::size_t>  free_list;  ///< Indexes of free blocks
+
+        std::size_t index_of(dma_control_block const * cb) const;
+
+      public:
+      /// @brief Construct pool over count control blocks.
+      /// @param cbs    Process address of first of count contiguous blocks.
+      /// @param cbs_bus  Bus address of cbs.
+      /// @param count  Number of control blocks in pool.
+        dma_control_block_pool
+        ( dma_control_block * cbs
+        , register_t cbs_bus
+        , std::size_t count
+        );
+
+      /// @brief Returns total number of control blocks in the pool.
+        std::size_t capacity() const
+        {
+          return free_list.capacity();
+        }
+
+      /// @brief Returns number of control blocks available for allocation.
+        std::size_t available() const
+        {
+          return free_list.size();
+        }
+
+      /// @brief Allocate a zeroed control block.
+      /// @returns Pointer to allocated control block.
+      /// @throws std::bad_alloc if no control blocks are available.
+        dma_control_block * allocate();
+
+      /// @brief Return a control block to the pool.
+      /// @param cb Control block previously obtained from allocate.
+      /// @throws std::invalid_argument if cb is not a block of this pool.
+        void deallocate(dma_control_block * cb);
+
+      /// @brief Returns bus address of a control block of the pool.
+      /// @param cb Control block of this pool.
+      /// @throws std::invalid_argument if cb is not a block of this pool.
+        register_t bus_address(dma_control_block const * cb) const
+        {
+          return blocks_bus
+               + static_cast<register_t>(index_of(cb)*sizeof(*cb));
+        }
+
+      /// @brief Chain one control block to another.
+      /// @param from Control block of this pool to chain from.
+      /// @param to   Control block of this pool to chain to, or nullptr to end
+      ///             the chain at from.
+      /// @throws std::invalid_argument if to is not a block of this pool.
+        void link(dma_control_block & from, dma_control_block const * to) const
+        {
+          from.next_control_block = to ? bus_address(to) : 0U;
+        }
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_DMA_CONTROL_BLOCK_POOL_H
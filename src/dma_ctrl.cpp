@@ -0,0 +1,74 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file dma_ctrl.cpp
+/// @brief Internal DMA control type implementation and definition.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "dma_ctrl.h"
+#include "dma_arena.h"
+#include "periexcept.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      dma_ctrl::dma_ctrl()
+      : regs( peripheral_window::instance()
+            , dma_registers::physical_address
+            , register_block_size
+            )
+      {}
+
+      dma_ctrl::~dma_ctrl() = default;
+
+      dma_ctrl & dma_ctrl::instance()
+      {
+        static dma_ctrl dma_control_area;
+        return dma_control_area;
+      }
+
+      std::size_t dma_ctrl::allocate_channel()
+      {
+        for (unsigned ch=0U; ch!=number_of_dma_channels; ++ch)
+          {
+            if ((dma_user_channel_mask&(1U<<ch)) && alloc.allocate(ch))
+              {
+                regs->enable_channel(ch);
+                regs->channel[ch].reset();
+                return ch;
+              }
+          }
+        throw bad_peripheral_alloc{"dma_ctrl::allocate_channel: no DMA "
+                                   "channel available."};
+      }
+
+      void dma_ctrl::deallocate_channel(std::size_t ch)
+      {
+        if (alloc.is_in_use(ch))
+          {
+            regs->channel[ch].reset();
+            alloc.deallocate(ch);
+          }
+      }
+
+      dma_control_block_pool & dma_ctrl::control_blocks()
+      {
+        if (!cb_pool)
+          {
+            std::unique_ptr<dma_arena> arena
+              {new dma_arena{dma_pool_control_blocks*sizeof(dma_control_block)}};
+            dma_control_block * cbs
+              {arena->allocate_control_blocks(dma_pool_control_blocks)};
+            cb_pool.reset(new dma_control_block_pool
+                                { cbs
+                                , arena->bus_address(cbs)
+                                , dma_pool_control_blocks
+                                });
+            cb_arena = std::move(arena);
+          }
+        return *cb_pool;
+      }
+    }
+  }
+}}
@@ -0,0 +1,80 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file dma_ctrl.h
+/// @brief \b Internal : DMA control type & supporting definitions.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_DMA_CTRL_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_DMA_CTRL_H
+
+# include "phymem_ptr.h"
+# include "dma_registers.h"
+# include "dma_control_block_pool.h"
+# include "simple_allocator.h"
+# include <memory>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      class dma_arena;
+
+    /// @brief Mask of DMA channels allocate_channel picks from: 6, 7 and
+    /// lite channels 12, 13 and 14. Other channels may be used by the Linux
+    /// kernel or VideoCore firmware.
+      constexpr register_t dma_user_channel_mask{0x70C0U};
+
+    /// @brief Number of control blocks in the shared control block pool.
+      constexpr std::size_t dma_pool_control_blocks{1024U};
+
+    /// @brief DMA control type. There is only ONE (yes it is a singleton!)
+    ///
+    /// Groups BCM2708/2835 DMA controller registers physical memory mapped
+    /// area with a DMA channel allocator and a pool of control blocks in DMA
+    /// accessible memory shared by all users of DMA.
+      struct dma_ctrl
+      {
+      /// @brief Pointer to BCM2708 / BCM2835 DMA controller registers instance
+        phymem_ptr<volatile dma_registers>        regs;
+
+      /// @brief DMA channel allocator
+        simple_allocator<number_of_dma_channels>  alloc;
+
+      /// @brief Singleton instance getter
+      /// @returns THE instance of the DMA control object.
+        static dma_ctrl & instance();
+
+      /// @brief Allocate, enable and reset the lowest numbered free channel
+      /// in dma_user_channel_mask.
+      /// @returns Allocated DMA channel number.
+      /// @throws bad_peripheral_alloc if no channel is free.
+        std::size_t allocate_channel();
+
+      /// @brief Reset and deallocate an allocated channel.
+      /// @param ch DMA channel number returned by allocate_channel.
+        void deallocate_channel(std::size_t ch);
+
+      /// @brief Returns the shared control block pool, allocating the memory
+      /// for it on first use.
+      /// @throws std::system_error or std::bad_alloc if DMA accessible memory
+      ///         cannot be obtained.
+        dma_control_block_pool & control_blocks();
+
+      private:
+        std::unique_ptr<dma_arena>              cb_arena;
+        std::unique_ptr<dma_control_block_pool> cb_pool;
+
+      /// @brief Construct: intialise regs with correct physical address & size
+        dma_ctrl();
+        ~dma_ctrl();
+
+        dma_ctrl(dma_ctrl const &) = delete;
+        dma_ctrl(dma_ctrl &&) = delete;
+        dma_ctrl & operator=(dma_ctrl const &) = delete;
+        dma_ctrl & operator=(dma_ctrl &&) = delete;
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_DMA_CTRL_H
@@ -0,0 +1,193 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file dma_registers.h
+/// @brief \b Internal : low-level DMA controller registers and control block
+/// type definitions.
+///
+/// Refer to the
+/// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+/// Broadcom BCM2835 ARM Peripherals Datasheet</a> Chapter 4 DMA Controller for
+/// details.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_DMA_REGISTERS_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_DMA_REGISTERS_H
+
+# include "peridef.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Number of DMA channels at the DMA controller base address.
+    ///
+    /// Channel 15 is at a separate address and is not supported.
+      constexpr std::size_t number_of_dma_channels{15};
+
+    /// @brief Peripheral DREQ signal numbers used in the PERMAP field of
+    /// dma_control_block::transfer_info.
+      enum class dma_dreq : register_t
+      { none      = 0   ///< No DREQ, transfer at full speed
+      , pcm_tx    = 2   ///< PCM / I2S transmit FIFO
+      , pcm_rx    = 3   ///< PCM / I2S receive FIFO
+      , smi       = 4   ///< SMI (secondary memory interface) FIFO
+      , pwm       = 5   ///< PWM controller FIFO
+      , spi_tx    = 6   ///< SPI0 transmit FIFO
+      , spi_rx    = 7   ///< SPI0 receive FIFO
+      , uart_tx   = 12  ///< UART0 (PL011) transmit FIFO
+      , uart_rx   = 14  ///< UART0 (PL011) receive FIFO
+      };
+
+    /// @brief DMA control block, read by a DMA channel from memory.
+    ///
+    /// Control blocks must be 32 byte aligned and are chained by bus address
+    /// through next_control_block, with 0 ending a chain.
+      struct alignas(32) dma_control_block
+      {
+      /// @brief Flags for \ref transfer_info, TI.
+        enum : register_t
+        { ti_inten          = 1U<<0   ///< Interrupt on completion
+        , ti_tdmode         = 1U<<1   ///< 2D mode transfer
+        , ti_wait_resp      = 1U<<3   ///< Wait for write response
+        , ti_dest_inc       = 1U<<4   ///< Increment destination address
+        , ti_dest_width     = 1U<<5   ///< 128 bit destination writes
+        , ti_dest_dreq      = 1U<<6   ///< Pace writes with PERMAP DREQ
+        , ti_dest_ignore    = 1U<<7   ///< Do not perform destination writes
+        , ti_src_inc        = 1U<<8   ///< Increment source address
+        , ti_src_width      = 1U<<9   ///< 128 bit source reads
+        , ti_src_dreq       = 1U<<10  ///< Pace reads with PERMAP DREQ
+        , ti_src_ignore     = 1U<<11  ///< Do not perform source reads
+        , ti_permap_shift   = 16U     ///< PERMAP DREQ field shift
+        , ti_no_wide_bursts = 1U<<26  ///< Do not do wide writes as bursts
+        };
+
+      /// @brief Returns TI PERMAP field value for a peripheral DREQ
+      /// @param dreq Peripheral whose DREQ signal paces the transfer.
+        constexpr static register_t ti_permap(dma_dreq dreq)
+        {
+          return static_cast<register_t>(dreq)<<ti_permap_shift;
+        }
+
+        register_t transfer_info;     ///< Transfer information, TI
+        register_t source_address;    ///< Source bus address, SOURCE_AD
+        register_t dest_address;      ///< Destination bus address, DEST_AD
+        register_t transfer_length;   ///< Transfer length in bytes, TXFR_LEN
+        register_t stride;            ///< 2D mode stride, STRIDE
+        register_t next_control_block;///< Next control block bus address
+        register_t reserved_do_not_use[2]; ///< Reserved, set to zero
+      };
+
+    /// @brief Represents layout of one DMA channel's registers.
+      struct dma_channel_registers
+      {
+      /// @brief Flags for \ref control_and_status, CS.
+        enum : register_t
+        { cs_active         = 1U<<0   ///< Channel active (R/W)
+        , cs_end            = 1U<<1   ///< Transfer complete (W1C)
+        , cs_int            = 1U<<2   ///< Interrupt status (W1C)
+        , cs_dreq           = 1U<<3   ///< DREQ state (RO)
+        , cs_paused         = 1U<<4   ///< Channel paused (RO)
+        , cs_error          = 1U<<8   ///< Channel has an error (RO)
+        , cs_priority_shift = 16U     ///< AXI priority field shift
+        , cs_panic_priority_shift = 20U ///< AXI panic priority field shift
+        , cs_wait_for_outstanding_writes = 1U<<28 ///< Wait for writes
+        , cs_disdebug       = 1U<<29  ///< Do not stop when debug pause set
+        , cs_abort          = 1U<<30  ///< Abort current control block (W)
+        , cs_reset          = 1U<<31  ///< Reset channel (W)
+        };
+
+        register_t control_and_status;///< Control and status, CS
+        register_t control_block_address; ///< Control block bus address
+        register_t transfer_info;     ///< Current control block TI (RO)
+        register_t source_address;    ///< Current source address (RO)
+        register_t dest_address;      ///< Current destination address (RO)
+        register_t transfer_length;   ///< Current transfer length (RO)
+        register_t stride;            ///< Current 2D stride (RO)
+        register_t next_control_block;///< Next control block address (RO)
+        register_t debug;             ///< Debug, DEBUG
+        register_t reserved_do_not_use[55]; ///< Pad to 0x100 byte channel size
+
+      /// @brief Returns true if the channel is active.
+        bool is_active() volatile const
+        {
+          return control_and_status & cs_active;
+        }
+
+      /// @brief Returns true if the channel has an error.
+        bool has_error() volatile const
+        {
+          return control_and_status & cs_error;
+        }
+
+      /// @brief Returns the CS value written to start a channel.
+      ///
+      /// Also used by control blocks that start one channel from another.
+      /// @param priority AXI priority (0-15) for normal operation.
+      /// @param panic_priority AXI priority (0-15) when a peripheral panics.
+        constexpr static register_t start_value
+        ( register_t priority = 8U
+        , register_t panic_priority = 8U
+        )
+        {
+          return cs_wait_for_outstanding_writes
+               | ((panic_priority&0xFU)<<cs_panic_priority_shift)
+               | ((priority&0xFU)<<cs_priority_shift)
+               | cs_end | cs_int | cs_active;
+        }
+
+      /// @brief Start the channel on a control block chain.
+      /// @param cb_bus_address Bus address of first control block in chain.
+      /// @param priority AXI priority (0-15) for normal operation.
+      /// @param panic_priority AXI priority (0-15) when a peripheral panics.
+        void start
+        ( register_t cb_bus_address
+        , register_t priority = 8U
+        , register_t panic_priority = 8U
+        ) volatile
+        {
+          control_block_address = cb_bus_address;
+          control_and_status = start_value(priority, panic_priority);
+        }
+
+      /// @brief Abort any transfer and reset the channel.
+        void reset() volatile
+        {
+          control_and_status = cs_abort;
+          control_and_status = cs_reset;
+          control_block_address = 0U;
+        }
+      };
+
+    /// @brief Represents layout of DMA controller registers with operations.
+    ///
+    /// Permits access to BCM2835 DMA controller channel 0..14 registers and
+    /// global interrupt status and enable registers when an instance is mapped
+    /// to the correct physical memory location.
+    ///
+    /// See the
+    /// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+    /// Broadcom BCM2835 ARM Peripherals Datasheet</a> chapter 4 for details
+      struct dma_registers
+      {
+      /// @brief Physical address of start of BCM2835 DMA controller registers
+        constexpr static physical_address_t
+                              physical_address = peripheral_base_address+0x7000;
+
+        dma_channel_registers channel[number_of_dma_channels];///< Channels 0..14
+        register_t reserved_do_not_use[56]; ///< Reserved, currently unused
+        register_t int_status;        ///< Channel interrupt status, INT_STATUS
+        register_t reserved_do_not_use_a[3]; ///< Reserved, currently unused
+        register_t enable;            ///< Channel enable bits, ENABLE
+
+      /// @brief Enable a channel in the global ENABLE register.
+      /// @param ch   Channel to enable (0..14)
+        void enable_channel(std::size_t ch) volatile
+        {
+          enable |= 1U<<ch;
+        }
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_DMA_REGISTERS_H
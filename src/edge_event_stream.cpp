@@ -0,0 +1,129 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file edge_event_stream.cpp
+/// @brief Edge event stream class implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "edge_event_stream.h"
+#include <system_error>
+#include <pthread.h>
+#include <sched.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+    // Maximum events read from a source per read call by the reader thread.
+      std::size_t const read_batch_size{32U};
+    }
+
+    int const edge_event_stream::any_cpu;
+
+    edge_event_stream::edge_event_stream
+    ( std::initializer_list<pin_line_event const *> lines
+    , std::size_t capacity
+    , int cpu
+    )
+    : sources(lines)
+    , ring{capacity}
+    , overrun_count{0U}
+    , reader_failed{false}
+    {
+      if (sources.empty())
+        {
+          throw std::invalid_argument{"edge_event_stream: must have at least "
+                                      "one pin_line_event."};
+        }
+      for (auto line : sources)
+        {
+          event_set.add(*line);
+        }
+      reader = std::thread{&edge_event_stream::read_events, this};
+      if (cpu!=any_cpu)
+        {
+          cpu_set_t cpus;
+          CPU_ZERO(&cpus);
+          CPU_SET(cpu, &cpus);
+          int const rv{::pthread_setaffinity_np( reader.native_handle()
+                                               , sizeof(cpus), &cpus
+                                               )};
+          if (rv!=0)
+            {
+              event_set.cancel();
+              reader.join();
+              throw std::system_error
+                    ( rv
+                    , std::system_category()
+                    , "edge_event_stream: setting reader thread CPU affinity "
+                      "failed with error from call to pthread_setaffinity_np."
+                    );
+            }
+        }
+    }
+
+    edge_event_stream::~edge_event_stream()
+    {
+      try
+        {
+          event_set.cancel();
+        }
+      catch (...) {}
+      reader.join();
+    }
+
+    void edge_event_stream::read_events()
+    {
+      try
+        {
+          std::vector<pin_id> signalled;
+          signalled.reserve(sources.size());
+          edge_event_record events[read_batch_size];
+          while (event_set.wait(signalled)!=0U)
+            {
+              for (auto pin : signalled)
+                {
+                  for (auto line : sources)
+                    {
+                      if (line->get_pin()!=pin)
+                        {
+                          continue;
+                        }
+                      std::size_t const count{line->read(events
+                                                        , read_batch_size
+                                                        )};
+                      for (std::size_t idx=0; idx!=count; ++idx)
+                        {
+                          if (!ring.try_push(events[idx]))
+                            {
+                              overrun_count.fetch_add
+                                            (1U, std::memory_order_relaxed);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+      catch (...)
+        {
+          reader_error = std::current_exception();
+          reader_failed.store(true, std::memory_order_release);
+        }
+    }
+
+    std::size_t edge_event_stream::pop
+    ( edge_event_record * events
+    , std::size_t max_events
+    )
+    {
+      std::size_t const count{ring.pop(events, max_events)};
+      if (count==0U && max_events!=0U
+       && reader_failed.load(std::memory_order_acquire) && ring.empty())
+        {
+          std::rethrow_exception(reader_error);
+        }
+      return count;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,62 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file edge_tally.cpp
+/// @brief GPIO pin level sample edge counting implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "edge_tally.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      edge_tally::edge_tally
+      ( std::vector<unsigned> const & pins
+      , bool rising
+      , bool falling
+      )
+      : rising_masks{0U, 0U}
+      , falling_masks{0U, 0U}
+      , positions{}
+      , previous{0U, 0U}
+      {
+        for (std::size_t idx=0; idx!=pins.size(); ++idx)
+          {
+            std::size_t const bank{pins[idx]/32U};
+            std::uint32_t const mask{1U<<(pins[idx]%32U)};
+            if (rising)
+              {
+                rising_masks[bank] |= mask;
+              }
+            if (falling)
+              {
+                falling_masks[bank] |= mask;
+              }
+            positions[bank][pins[idx]%32U] = static_cast<std::uint8_t>(idx);
+          }
+      }
+
+      void edge_tally::add
+      ( register_t const volatile * sample
+      , std::uint32_t * counts
+      )
+      {
+        for (std::size_t bank=0; bank!=2; ++bank)
+          {
+            register_t const level{sample[bank]};
+            register_t const changed{level^previous[bank]};
+            register_t edges{ (changed&level&rising_masks[bank])
+                            | (changed&~level&falling_masks[bank])
+                            };
+            while (edges!=0U)
+              {
+                ++counts[positions[bank][__builtin_ctz(edges)]];
+                edges &= edges-1U;
+              }
+            previous[bank] = level;
+          }
+      }
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
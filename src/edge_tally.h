@@ -0,0 +1,59 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file edge_tally.h
+/// @brief \b Internal : count edges in GPIO pin level samples : class
+/// definition.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_EDGE_TALLY_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_EDGE_TALLY_H
+
+# include "dma_registers.h"
+# include <cstdint>
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Count edges on selected GPIO pins in GPLEV0, GPLEV1 samples.
+    ///
+    /// Edges are counted between consecutive samples so an edge is missed if
+    /// a pin changes back before the next sample is taken.
+      class edge_tally
+      {
+        std::uint32_t rising_masks[2];    ///< Banks' pins counting rising edges
+        std::uint32_t falling_masks[2];   ///< Banks' pins counting falling
+        std::uint8_t  positions[2][32];   ///< Count index of each bank pin
+        register_t    previous[2];        ///< Last sample added
+
+      public:
+      /// @brief Construct for a set of pins.
+      /// @param pins     GPIO pin numbers. Edges on pins[n] are counted in
+      ///                 counts[n] by add. Each must be less than 54.
+      /// @param rising   Count rising (low to high) edges.
+      /// @param falling  Count falling (high to low) edges.
+        edge_tally
+        ( std::vector<unsigned> const & pins
+        , bool rising
+        , bool falling
+        );
+
+      /// @brief Set the sample edges in the next sample added are relative to.
+      /// @param sample   GPLEV0, GPLEV1 values.
+        void start(register_t const volatile * sample)
+        {
+          previous[0] = sample[0];
+          previous[1] = sample[1];
+        }
+
+      /// @brief Count edges since the previous sample.
+      /// @param sample       GPLEV0, GPLEV1 values.
+      /// @param[in,out] counts Incremented for each edge on pins[n].
+        void add(register_t const volatile * sample, std::uint32_t * counts);
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_EDGE_TALLY_H
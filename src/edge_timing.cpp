@@ -0,0 +1,96 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file edge_timing.cpp
+/// @brief Sliding window edge interval and frequency implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "edge_timing.h"
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    edge_timing::edge_timing(std::size_t window)
+    : stamps(window)
+    , first{0U}
+    , count{0U}
+    {
+      if ( window<2U )
+        {
+          throw std::invalid_argument
+                ( "edge_timing::edge_timing: window must hold at least two "
+                  "timestamps"
+                );
+        }
+    }
+
+    void edge_timing::record(std::chrono::nanoseconds t)
+    {
+      if ( count==stamps.size() )
+        {
+          stamps[first] = t;
+          first = (first+1U)%stamps.size();
+        }
+      else
+        {
+          stamps[(first+count)%stamps.size()] = t;
+          ++count;
+        }
+    }
+
+    std::chrono::nanoseconds edge_timing::last_interval() const
+    {
+      return count<2U ? std::chrono::nanoseconds::zero()
+                      : at(count-1U)-at(count-2U);
+    }
+
+    std::chrono::nanoseconds edge_timing::min_interval() const
+    {
+      if ( count<2U )
+        {
+          return std::chrono::nanoseconds::zero();
+        }
+      std::chrono::nanoseconds shortest{at(1U)-at(0U)};
+      for (std::size_t i=2U; i<count; ++i)
+        {
+          std::chrono::nanoseconds interval{at(i)-at(i-1U)};
+          if ( interval<shortest )
+            {
+              shortest = interval;
+            }
+        }
+      return shortest;
+    }
+
+    std::chrono::nanoseconds edge_timing::max_interval() const
+    {
+      std::chrono::nanoseconds longest{std::chrono::nanoseconds::zero()};
+      for (std::size_t i=1U; i<count; ++i)
+        {
+          std::chrono::nanoseconds interval{at(i)-at(i-1U)};
+          if ( longest<interval )
+            {
+              longest = interval;
+            }
+        }
+      return longest;
+    }
+
+    std::chrono::nanoseconds edge_timing::span() const
+    {
+      return count<2U ? std::chrono::nanoseconds::zero()
+                      : at(count-1U)-at(0U);
+    }
+
+    f_hertz edge_timing::frequency() const
+    {
+      std::chrono::nanoseconds const t{span()};
+      if ( t.count()<=0 )
+        {
+          return f_hertz{};
+        }
+      return f_hertz{(count-1U)*1.0e9/t.count()};
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,255 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file event_executor.cpp
+/// @brief Asynchronous wait executor implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "event_executor.h"
+#include <stdexcept>
+#include <system_error>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+    // epoll event data value used for the wake eventfd, which cannot be
+    // mistaken for a file descriptor.
+      std::uint64_t const wake_token{~std::uint64_t{0U}};
+
+    // Most events returned by one epoll_wait call. Signalled file descriptors
+    // not returned by one call remain signalled for the next.
+      int const max_wait_events{32};
+
+      void throw_system_error(char const * what)
+      {
+        throw std::system_error(errno, std::system_category(), what);
+      }
+    }
+
+    event_executor::event_executor()
+    : epoll_fd{::epoll_create1(EPOLL_CLOEXEC)}
+    , wake_fd{-1}
+    , stopping{false}
+    , failures{0U}
+    {
+      if (epoll_fd==-1)
+        {
+          throw_system_error( "event_executor: creating executor failed with "
+                              "error from call to epoll_create1."
+                            );
+        }
+      wake_fd = ::eventfd(0U, EFD_CLOEXEC|EFD_NONBLOCK);
+      epoll_event ev;
+      ev.events = EPOLLIN;
+      ev.data.u64 = wake_token;
+      if (wake_fd==-1 || ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev)==-1)
+        {
+          int const error{errno};
+          if (wake_fd!=-1)
+            {
+              ::close(wake_fd);
+            }
+          ::close(epoll_fd);
+          errno = error;
+          throw_system_error( "event_executor: creating executor failed with "
+                              "error from call to eventfd or epoll_ctl."
+                            );
+        }
+    }
+
+    event_executor::~event_executor()
+    {
+      ::close(wake_fd);
+      ::close(epoll_fd);
+    }
+
+    void event_executor::run()
+    {
+      epoll_event events[max_wait_events];
+      while (!is_stopped())
+        {
+          int const count{::epoll_wait(epoll_fd, events, max_wait_events, -1)};
+          if (count==-1)
+            {
+              if (errno==EINTR)
+                {
+                  continue;
+                }
+              throw_system_error( "event_executor: waiting for events failed "
+                                  "with error from call to epoll_wait."
+                                );
+            }
+          for (int idx=0; idx!=count; ++idx)
+            {
+              if (events[idx].data.u64==wake_token)
+                {
+                // Leave the wake eventfd signalled once stopped so every
+                // thread in run wakes and returns
+                  if (!run_posted())
+                    {
+                      return;
+                    }
+                  continue;
+                }
+              handler h;
+              {
+                std::lock_guard<std::mutex> lock{guard};
+                auto w(waits.find(static_cast<int>(events[idx].data.u64)));
+                if (w==waits.end())
+                  {
+                    continue; // cancelled after epoll_wait returned
+                  }
+                h = std::move(w->second);
+                waits.erase(w);
+              }
+              invoke(h);
+            }
+        }
+    }
+
+    bool event_executor::run_posted()
+    {
+      if (is_stopped())
+        {
+          return false;
+        }
+      std::uint64_t value;
+      if (::read(wake_fd, &value, sizeof(value))==-1 && errno!=EAGAIN)
+        {
+          throw_system_error( "event_executor: reading wake eventfd failed "
+                              "with error from call to read."
+                            );
+        }
+      for (;;)
+        {
+          handler h;
+          {
+            std::lock_guard<std::mutex> lock{guard};
+            if (posted.empty())
+              {
+                return true;
+              }
+            h = std::move(posted.front());
+            posted.pop_front();
+          }
+          invoke(h);
+        }
+    }
+
+    void event_executor::invoke(handler & h)
+    {
+      try
+        {
+          h();
+        }
+      catch (...)
+        {
+          failures.fetch_add(1U, std::memory_order_relaxed);
+        }
+    }
+
+    void event_executor::stop()
+    {
+      stopping.store(true, std::memory_order_release);
+      std::uint64_t const one{1U};
+      if (::write(wake_fd, &one, sizeof(one))==-1 && errno!=EAGAIN)
+        {
+          throw_system_error( "event_executor: stopping failed with error "
+                              "from call to write."
+                            );
+        }
+    }
+
+    void event_executor::post(std::function<void()> h)
+    {
+      {
+        std::lock_guard<std::mutex> lock{guard};
+        posted.push_back(std::move(h));
+      }
+      std::uint64_t const one{1U};
+      if (::write(wake_fd, &one, sizeof(one))==-1 && errno!=EAGAIN)
+        {
+          throw_system_error( "event_executor: posting handler failed with "
+                              "error from call to write."
+                            );
+        }
+    }
+
+    void event_executor::wait_on(int fd, std::uint32_t events, handler h)
+    {
+      std::lock_guard<std::mutex> lock{guard};
+      if (!waits.insert(std::make_pair(fd, std::move(h))).second)
+        {
+          throw std::logic_error{"event_executor::async_wait: a wait is "
+                                 "already outstanding."};
+        }
+    // One shot: a file descriptor stays in the epoll instance but disarmed
+    // after reporting an event, and is re-armed by the next wait
+      epoll_event ev;
+      ev.events = events|EPOLLONESHOT;
+      ev.data.u64 = static_cast<std::uint64_t>(fd);
+      if ( ::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev)==-1
+        && (errno!=ENOENT || ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev)==-1)
+         )
+        {
+          waits.erase(fd);
+          throw_system_error( "event_executor: starting wait failed with "
+                              "error from call to epoll_ctl."
+                            );
+        }
+    }
+
+    void event_executor::cancel(int fd)
+    {
+      std::lock_guard<std::mutex> lock{guard};
+      epoll_event ev{}; // non-null event pointer required before Linux 2.6.9
+      ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, &ev); // may never have waited
+      waits.erase(fd);
+    }
+
+    void event_executor::async_wait
+    ( pin_edge_event const & e
+    , std::function<void()> h
+    )
+    {
+      wait_on(e.pin_event_fd, EPOLLPRI|EPOLLERR, std::move(h));
+    }
+
+    void event_executor::async_wait
+    ( pin_line_event const & e
+    , std::function<void()> h
+    )
+    {
+      wait_on(e.line_fd, EPOLLIN|EPOLLERR, std::move(h));
+    }
+
+    void event_executor::async_wait
+    ( periodic_timer const & t
+    , std::function<void()> h
+    )
+    {
+      wait_on(t.timer_fd, EPOLLIN, std::move(h));
+    }
+
+    void event_executor::cancel(pin_edge_event const & e)
+    {
+      cancel(e.pin_event_fd);
+    }
+
+    void event_executor::cancel(pin_line_event const & e)
+    {
+      cancel(e.line_fd);
+    }
+
+    void event_executor::cancel(periodic_timer const & t)
+    {
+      cancel(t.timer_fd);
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,66 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file examples/capture-dump.cpp
+/// @brief Print the records of a capture file written by a capture_recorder
+///
+/// Usage: capture-dump file [first [count]]
+///
+/// Prints one line per record: its index, time stamp in nanoseconds, then
+/// either the pin id and edge of an edge event or the GPIO level register
+/// bank and its value in hexadecimal for a level sample.
+//
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+//
+
+#include "capture_recorder.h"
+
+#include <exception>    // for std::exception
+#include <iostream>     // for std IO stream objects
+#include <iomanip>      // for std::setw
+#include <cstdlib>      // for std::strtoull
+
+using namespace dibase::rpi::peripherals;
+
+int main(int argc, char * argv[])
+{
+  if (argc<2 || argc>4)
+    {
+      std::cerr << "Usage: " << argv[0] << " file [first [count]]\n";
+      return EXIT_FAILURE;
+    }
+  try
+    {
+      capture_reader reader{argv[1]};
+      std::size_t const size{reader.size()};
+      std::size_t first{argc>2 ? std::strtoull(argv[2], nullptr, 0) : 0U};
+      std::size_t count{argc>3 ? std::strtoull(argv[3], nullptr, 0) : size};
+      first = first<size ? first : size;
+      count = count<size-first ? count : size-first;
+      std::cerr << size << " of " << reader.capacity() << " records\n";
+      for (std::size_t idx=first; idx!=first+count; ++idx)
+        {
+          capture_record const & r(reader[idx]);
+          std::cout << std::setw(10) << idx << ' ' << std::setw(20)
+                    << r.timestamp << ' ';
+          if ( r.pin==capture_record::levels_bank0
+            || r.pin==capture_record::levels_bank1
+             )
+            {
+              std::cout << "GPLEV" << (r.pin-capture_record::levels_bank0)
+                        << " 0x" << std::hex << std::setw(8)
+                        << std::setfill('0') << r.value << std::dec
+                        << std::setfill(' ') << '\n';
+            }
+          else
+            {
+              std::cout << "pin " << std::setw(2) << r.pin
+                        << (r.value ? " rising\n" : " falling\n");
+            }
+        }
+    }
+  catch ( std::exception & e )
+    {
+      std::cerr << "A problem occurred. Description: " << e.what() << "\n";
+      return EXIT_FAILURE;
+    }
+}
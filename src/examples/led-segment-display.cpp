@@ -6,9 +6,11 @@
 /// @author Ralph E. McArdell
 
 #include "pin.h"
+#include "rt_thread.h"
 
 #include <exception>    // for std::exception
 #include <iostream>     // for std IO stream objects
+#include <system_error> // for std::system_error
 #include <thread>
 #include <chrono>
 
@@ -115,9 +117,13 @@ class multiplexed_dual_7_segment
 {
   typedef dibase::rpi::peripherals::opin    opin;
   typedef dibase::rpi::peripherals::pin_id  pin_id;
+  typedef dibase::rpi::peripherals::rt_period rt_period;
+
+  static unsigned const digit_display_ms{15};
 
   seven_segment digit_display;
   opin          digit_select;
+  rt_period     digit_period;
 
 public:
 /// @brief construct from digit select & 7 segments pin ids & on if low flag
@@ -150,6 +156,7 @@ public:
   )
   : digit_display{segA, segB, segC, segD, segE, segF, segG, is_on_when_low}
   , digit_select{digit_sel}
+  , digit_period{std::chrono::milliseconds(digit_display_ms)}
   {
       digit_display.clear();
   }
@@ -171,12 +178,20 @@ public:
 /// @param max_time_ms  Maximum time to take displaying values before returning
 ///                     in milliseconds.
   void show(unsigned int value, unsigned int max_time_ms=0);
+
+/// @brief Return counts of digit display periods and of those overrun
+  dibase::rpi::peripherals::rt_period_stats const & timing() const
+  {
+    return digit_period.stats();
+  }
 };
 
 using namespace dibase::rpi::peripherals;
 
 bool g_running{ true };  ///< Global flag used to communicate quit request
 
+unsigned const multiplexed_dual_7_segment::digit_display_ms;
+
 void seven_segment::show(unsigned digit)
 {
   typedef unsigned int display_type; 
@@ -219,15 +234,14 @@ void seven_segment::clear()
 
 void multiplexed_dual_7_segment::show(unsigned value, unsigned max_time_ms)
 {
-  static unsigned const digit_display_ms{15};
   for (unsigned int i=0; i<max_time_ms; i+=2*digit_display_ms)
     {
       digit_select.put(false);
       digit_display.show(value);
-      std::this_thread::sleep_for(std::chrono::milliseconds(digit_display_ms));
+      digit_period.wait();
       digit_select.put(true);
       digit_display.show(value/10);
-      std::this_thread::sleep_for(std::chrono::milliseconds(digit_display_ms));
+      digit_period.wait();
     }
 }
 
@@ -283,6 +297,11 @@ void count_switch_presses()
               std::cout << "Count: " << count << std::endl;
             }
         }
+      rt_period_stats const & timing(two_digit_display.timing());
+      std::cout << "Digit display periods: " << timing.periods
+                << ", overran: " << timing.missed
+                << ", worst lateness: " << timing.max_lateness.count()
+                << "ns\n";
     }
   catch ( std::exception & e )
     {
@@ -296,10 +315,25 @@ void count_switch_presses()
 /// input from user, whereupon no quit running request signalled by setting
 /// global g_running flag to false, and the worker thread is joined to wait
 /// for it to exit before returning.
+///
+/// The worker thread multiplexes the display digits so runs with SCHED_FIFO
+/// priority and locked memory if the process is privileged to use them.
 int main()
 {
   std::cout << "Press enter to quit....\n";
-  std::thread counter{ count_switch_presses };
+  rt_thread counter;
+  try
+    {
+      counter = rt_thread{ rt_config{50, rt_config::any_cpu, true, 64*1024}
+                         , count_switch_presses
+                         };
+    }
+  catch ( std::system_error & e )
+    {
+      std::cerr << "Real-time scheduling not available, running without. "
+                   "Description: " << e.what() << "\n";
+      counter = rt_thread{ rt_config{}, count_switch_presses };
+    }
   std::string dummy;
   std::getline(std::cin, dummy);
   g_running = false;
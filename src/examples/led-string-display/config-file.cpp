@@ -8,6 +8,12 @@
 #include "config-file.h"
 #include <istream>
 #include <limits>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstddef>
+#include <set>
 
 namespace config_file
 {
@@ -95,6 +101,15 @@ namespace config_file
     return token;
   }
 
+  void field_parser::parse_events
+  ( std::istream & in
+  , std::string const & name
+  , field_handler & handler
+  )
+  {
+    handler.field(name, this->parse_field(in));
+  }
+
   class simple_field_parser : public field_parser
   {
   public:
@@ -103,6 +118,8 @@ namespace config_file
     {}
 
     field_value parse_field( std::istream & in ); //override;
+
+    field_view parse_view( view_parse_context & ctx ); //override;
   };
 
   field_value simple_field_parser::parse_field( std::istream & in )
@@ -118,11 +135,12 @@ namespace config_file
     {}
 
     field_value parse_field( std::istream & in ); //override;
+
+    field_view parse_view( view_parse_context & ctx ); //override;
   };
 
-  field_value boolean_field_parser::parse_field( std::istream & in )
+  static bool boolean_from_text(text_view raw_value)
   {
-    auto raw_value = simple_field_parser::parse_field(in).text();
     bool value{false};
     if (  raw_value=="true" || raw_value=="TRUE"
        || raw_value=="yes" || raw_value=="YES"
@@ -145,6 +163,11 @@ namespace config_file
     return value;
   }
 
+  field_value boolean_field_parser::parse_field( std::istream & in )
+  {
+    return boolean_from_text(simple_field_parser::parse_field(in).text());
+  }
+
   class integer_field_parser : public simple_field_parser
   {
   public:
@@ -153,6 +176,8 @@ namespace config_file
     {}
 
     field_value parse_field( std::istream & in ); //override;
+
+    field_view parse_view( view_parse_context & ctx ); //override;
   };
 
   field_value integer_field_parser::parse_field( std::istream & in )
@@ -270,4 +295,341 @@ namespace config_file
       }
     return value;
   }
+
+  void composite_field_parser::parse_events
+  ( std::istream & in
+  , std::string const & name
+  , field_handler & handler
+  )
+  {
+    std::string token(get_token(in));
+    if (token!="{")
+      {
+        std::string
+              what("Configuration file composite field: expected '{', found '");
+        what += token;
+        what += "'.";
+        throw std::runtime_error(what);
+      }
+    handler.begin_composite(name);
+    std::set<field_parser *> present;
+    while ( (token=get_token(in))!="}" )
+      {
+        auto fld_parser_ptr(this->get_field(token));
+        if ( !present.insert(fld_parser_ptr).second
+          && fld_parser_ptr->get_multiplicity()==field_multiplicity::single
+           )
+          {
+            std::string what("Configuration file composite field:"
+                                " more than one entry for field '");
+            what += token;
+            what += "'.";
+            throw std::runtime_error(what);
+          }
+        fld_parser_ptr->parse_events(in, token, handler);
+      }
+    for ( auto const & entry : this->fields )
+      {
+        if (entry.second.get()->get_presence()==field_presence::required)
+          {
+            if ( present.find(entry.second.get())==present.end() )
+              {
+                std::string
+                  what("Configuration file composite field: required field '");
+                what += entry.first;
+                what += "' is missing.";
+                throw std::runtime_error(what);
+              }
+          }
+      }
+    handler.end_composite(name);
+  }
+
+  composite_view::named_field const *
+  composite_view::find(text_view name) const
+  {
+    named_field const * last(this->fields+this->field_count);
+    named_field const * pos
+      ( std::lower_bound( this->fields, last, name
+                        , [](named_field const & f, text_view n)
+                          { return f.name<n; }
+                        )
+      );
+    return (pos!=last && pos->name==name) ? pos : nullptr;
+  }
+
+  composite_view::field_range composite_view::at(text_view field_name) const
+  {
+    named_field const * pos(this->find(field_name));
+    if (pos==nullptr)
+      {
+        std::string 
+                what("Configuration file composite field has no field named '");
+        what += field_name.str();
+        what += "'.";
+        throw std::runtime_error(what);
+      }
+    return pos->values;
+  }
+
+  /// @brief State of a config_document view mode parse
+  ///
+  /// Holds the position in the configuration text, a name buffer reused for
+  /// field parser look ups and a stack of the fields of the composite fields
+  /// being parsed, reused for all composites so that it only grows to the
+  /// size needed by the largest, rather than allocating for each.
+  class view_parse_context
+  {
+    struct parsed_field
+    {
+      text_view   name;
+      field_view  value;
+      std::size_t order;
+    };
+
+    config_document &         doc;
+    char const *              pos;
+    char const *              end;
+    std::vector<parsed_field> pending;
+
+    template <class T>
+    T * allocate(std::size_t count)
+    {
+      return static_cast<T*>(doc.allocate(count*sizeof(T), alignof(T)));
+    }
+
+  public:
+    std::string               name;   ///< Field name buffer for look ups
+
+    explicit view_parse_context(config_document & d)
+    : doc(d)
+    , pos(d.text.c_str())
+    , end(d.text.c_str()+d.text.size())
+    {}
+
+    /// @brief Get the next token from the configuration text
+    /// As field_parser::get_token but returning a view of the token in the
+    /// configuration text.
+    text_view get_token();
+
+    /// @brief Return number of pending fields, marking start of a composite
+    std::size_t mark() const { return this->pending.size(); }
+
+    /// @brief Add a parsed field to the composite being parsed
+    void add_field(text_view field_name, field_view value)
+    {
+      this->pending.push_back
+              (parsed_field{field_name, value, this->pending.size()});
+    }
+
+    /// @brief Make composite_view of fields added since mark, removing them.
+    composite_view const & make_composite(std::size_t mark);
+  };
+
+  text_view view_parse_context::get_token()
+  {
+    for (;;)
+      {
+        while (this->pos!=this->end && std::isspace((unsigned char)*this->pos))
+          {
+            ++this->pos;
+          }
+        if (this->pos==this->end)
+          {
+            return text_view();
+          }
+        char const * first(this->pos);
+        while (this->pos!=this->end && !std::isspace((unsigned char)*this->pos))
+          {
+            ++this->pos;
+          }
+        text_view token(first, this->pos-first);
+        // check for comment:
+        char const * comment(std::find(token.begin(), token.end(), '#'));
+        if (comment!=token.end())
+          { // have comment, remove from token and eat line as rest is comment
+            token = text_view(first, comment-first);
+            this->pos = std::find(this->pos, this->end, '\n');
+          }
+        if (token.size()!=0)
+          {
+            return token;
+          }
+      }
+  }
+
+  composite_view const & view_parse_context::make_composite(std::size_t mark)
+  {
+    auto first(this->pending.begin()+mark);
+    auto last(this->pending.end());
+    std::sort( first, last
+             , [](parsed_field const & a, parsed_field const & b)
+               {
+                 int order(a.name.compare(b.name));
+                 return order<0 || (order==0 && a.order<b.order);
+               }
+             );
+    std::size_t name_count(0);
+    for (auto it(first); it!=last; ++it)
+      {
+        if (it==first || it->name!=(it-1)->name)
+          {
+            ++name_count;
+          }
+      }
+    field_view * values(this->allocate<field_view>(last-first));
+    composite_view::named_field * fields
+                      (this->allocate<composite_view::named_field>(name_count));
+    composite_view::named_field * field(fields);
+    field_view * value(values);
+    for (auto it(first); it!=last; ++field)
+      {
+        field_view * field_first(value);
+        text_view field_name(it->name);
+        for (; it!=last && it->name==field_name; ++it, ++value)
+          {
+            new (value) field_view(it->value);
+          }
+        new (field) composite_view::named_field
+              {field_name, composite_view::field_range(field_first, value)};
+      }
+    this->pending.erase(first, last);
+    return *new (this->allocate<composite_view>(1))
+                                        composite_view(fields, name_count);
+  }
+
+  field_view simple_field_parser::parse_view( view_parse_context & ctx )
+  {
+    return field_view(ctx.get_token());
+  }
+
+  field_view boolean_field_parser::parse_view( view_parse_context & ctx )
+  {
+    return field_view(boolean_from_text(ctx.get_token()));
+  }
+
+  field_view integer_field_parser::parse_view( view_parse_context & ctx )
+  {
+  // Tokens are followed by white space, a comment or the end of the text so
+  // strtol stops at the end of the token, as std::stol would.
+    char const * digits(ctx.get_token().data());
+    char * digits_end(nullptr);
+    errno = 0;
+    long value(std::strtol(digits, &digits_end, 10));
+    if (digits_end==digits)
+      {
+        throw std::invalid_argument("Bad integer value in configuration file.");
+      }
+    if (errno==ERANGE)
+      {
+        throw std::out_of_range("Integer value in configuration file is out "
+                                "of range.");
+      }
+    return field_view(value);
+  }
+
+  field_view composite_field_parser::parse_view( view_parse_context & ctx )
+  {
+    text_view token(ctx.get_token());
+    if (token!="{")
+      {
+        std::string
+              what("Configuration file composite field: expected '{', found '");
+        what += token.str();
+        what += "'.";
+        throw std::runtime_error(what);
+      }
+    std::size_t const mark(ctx.mark());
+    while ( (token=ctx.get_token())!="}" )
+      {
+        ctx.name.assign(token.data(), token.size());
+        auto fld_parser_ptr(this->get_field(ctx.name));
+        ctx.add_field(token, fld_parser_ptr->parse_view(ctx));
+      }
+    composite_view const & value(ctx.make_composite(mark));
+    for ( auto const & entry : this->fields )
+      {
+        if (!value.has_field(entry.first))
+          {
+            if (entry.second.get()->get_presence()==field_presence::required)
+              {
+                std::string
+                  what("Configuration file composite field: required field '");
+                what += entry.first;
+                what += "' is missing.";
+                throw std::runtime_error(what);
+              }
+          }
+        else if ( entry.second.get()->get_multiplicity()
+                                                  ==field_multiplicity::single
+               && value[entry.first].size()>1
+                )
+          {
+            std::string what("Configuration file composite field:"
+                                " more than one entry for field '");
+            what += entry.first;
+            what += "'.";
+            throw std::runtime_error(what);
+          }
+      }
+    return field_view(value);
+  }
+
+  config_document::config_document
+  ( composite_field_parser & parser
+  , std::istream & in
+  )
+  : block(nullptr)
+  , block_used(0)
+  , root_view(nullptr)
+  {
+    char chunk[4096];
+    while (in.read(chunk, sizeof(chunk)) || in.gcount()!=0)
+      {
+        this->text.append(chunk, in.gcount());
+      }
+    if (in.bad() || !in.eof())
+      {
+        throw std::runtime_error("Problem reading configuration file.");
+      }
+    this->parse(parser);
+  }
+
+  config_document::config_document
+  ( composite_field_parser & parser
+  , std::string config
+  )
+  : text(std::move(config))
+  , block(nullptr)
+  , block_used(0)
+  , root_view(nullptr)
+  {
+    this->parse(parser);
+  }
+
+  void config_document::parse(composite_field_parser & parser)
+  {
+    view_parse_context ctx(*this);
+    this->root_view = &parser.parse_view(ctx).composite();
+  }
+
+  void * config_document::allocate(std::size_t size, std::size_t alignment)
+  {
+    constexpr std::size_t block_size{64*1024};
+    if (size>block_size/4)
+      { // large allocations get a block of their own so the current block's
+        // remaining space is not wasted
+        this->blocks.emplace_back(new char[size]);
+        return this->blocks.back().get();
+      }
+    std::size_t offset((this->block_used+alignment-1)/alignment*alignment);
+    if (this->block==nullptr || offset+size>block_size)
+      {
+        this->blocks.emplace_back(new char[block_size]);
+        this->block = this->blocks.back().get();
+        offset = 0;
+      }
+    this->block_used = offset+size;
+    return this->block+offset;
+  }
 }
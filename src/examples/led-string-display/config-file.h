@@ -12,6 +12,8 @@
 # include <map>
 # include <memory>
 # include <string>
+# include <cstring>
+# include <iosfwd>
 # include <stdexcept>
 
 namespace config_file
@@ -229,6 +231,319 @@ namespace config_file
     }
   };
 
+
+  /// @brief Non-owning view of a run of characters
+  ///
+  /// Used by the view parse mode (see config_document) to refer to field
+  /// names and text field values where they lie in the configuration text,
+  /// so no string is copied or allocated for them.
+  class text_view
+  {
+    char const *  first;
+    std::size_t   length;
+
+  public:
+    /// @brief Default construct: creates empty text_view
+    text_view()
+    : first("")
+    , length(0)
+    {}
+
+    /// @brief Construct from pointer to characters and character count
+    /// @param chars  Pointer to first character viewed
+    /// @param count  Number of characters viewed
+    text_view(char const * chars, std::size_t count)
+    : first(chars)
+    , length(count)
+    {}
+
+    /// @brief Construct viewing zero terminated string (less terminator)
+    /// @param str  Zero terminated string to view. Must outlive the view.
+    text_view(char const * str)
+    : first(str)
+    , length(std::strlen(str))
+    {}
+
+    /// @brief Construct viewing std::string characters
+    /// @param str  String to view. Must outlive the view and not be modified
+    ///             while viewed.
+    text_view(std::string const & str)
+    : first(str.data())
+    , length(str.size())
+    {}
+
+    /// @brief Return pointer to first character viewed (not zero terminated)
+    char const * data() const { return this->first; }
+
+    /// @brief Return number of characters viewed
+    std::size_t size() const { return this->length; }
+
+    /// @brief Return begin iterator for characters viewed
+    char const * begin() const { return this->first; }
+
+    /// @brief Return end iterator for characters viewed
+    char const * end() const { return this->first+this->length; }
+
+    /// @brief Return copy of characters viewed as std::string
+    std::string str() const { return std::string(this->first, this->length); }
+
+    /// @brief Lexicographically compare with another text_view
+    /// @param other  text_view to compare with
+    /// @returns negative, zero or positive value if this is ordered before,
+    ///          equal to or after other.
+    int compare(text_view other) const
+    {
+      std::size_t common(this->length<other.length?this->length:other.length);
+      int result(std::memcmp(this->first, other.first, common));
+      if (result==0 && this->length!=other.length)
+        {
+          result = this->length<other.length ? -1 : 1;
+        }
+      return result;
+    }
+  };
+
+  /// @brief Return true if two text_views view equal characters
+  inline bool operator==(text_view lhs, text_view rhs)
+  {
+    return lhs.size()==rhs.size() && lhs.compare(rhs)==0;
+  }
+
+  /// @brief Return true if two text_views view different characters
+  inline bool operator!=(text_view lhs, text_view rhs)
+  {
+    return !(lhs==rhs);
+  }
+
+  /// @brief Return true if lhs characters are ordered before rhs characters
+  inline bool operator<(text_view lhs, text_view rhs)
+  {
+    return lhs.compare(rhs)<0;
+  }
+
+  class composite_view;
+
+  /// @brief Field value produced by the view parse mode
+  ///
+  /// Like field_value but trivially copyable: text values are text_views of
+  /// the configuration text and composite values refer to composite_views
+  /// held by the owning config_document, so neither are ever copied.
+  class field_view
+  {
+    field_type    type;
+    std::size_t   length;
+    union
+    {
+      composite_view const *  c;
+      char const *            s;
+      long                    i;
+      bool                    b;
+    };
+
+  public:
+    /// @brief Construct text field_view from text_view
+    /// @param str  View of text value, which must outlive the field_view
+    explicit field_view( text_view str )
+    : type(field_type::text)
+    , length(str.size())
+    , s(str.data())
+    {
+    }
+
+    /// @brief Construct boolean field_view from bool
+    /// @param b  Boolean value to initialise field_view with
+    explicit field_view( bool b )
+    : type(field_type::boolean)
+    , length(0)
+    , b(b)
+    {
+    }
+
+    /// @brief Construct integer field_view from long
+    /// @param l  Long integer value to initialise field_view with
+    explicit field_view( long l )
+    : type(field_type::integer)
+    , length(0)
+    , i(l)
+    {
+    }
+
+    /// @brief Construct composite field_view referring to composite_view
+    /// @param c  composite_view value, which must outlive the field_view
+    explicit field_view( composite_view const & c )
+    : type(field_type::composite)
+    , length(0)
+    , c(&c)
+    {
+    }
+
+    /// @brief Return type of field value
+    field_type get_type() const { return this->type; }
+
+    /// @brief Return view of text field_view's string
+    /// @returns View of text field's string value
+    /// @throws std::logic_error if field_view does not contain a string
+    text_view text() const
+    {
+      if (type==field_type::text)
+      {
+        return text_view(s, length);
+      }
+      throw std::logic_error
+            ("Text field value requested for non-text field_view.");
+    }
+
+    /// @brief Return value of integer field_view's long integer value
+    /// @returns integer field_view's long integer value
+    /// @throws std::logic_error if field_view does not contain an integer
+    long integer() const
+    {
+      if (type==field_type::integer)
+      {
+        return i;
+      }
+      throw std::logic_error
+            ("Integer field value requested for non-integer field_view.");
+    }
+
+    /// @brief Return value of boolean field_view's bool value
+    /// @returns boolean field_view's bool value
+    /// @throws std::logic_error if field_view does not contain a bool
+    bool boolean() const
+    {
+      if (type==field_type::boolean)
+      {
+        return b;
+      }
+      throw std::logic_error
+            ("Boolean field value requested for non-boolean field_view.");
+    }
+
+    /// @brief Return reference to composite field_view's composite_view
+    /// @returns Reference to composite field's composite_view value
+    /// @throws std::logic_error if field_view does not contain a
+    ///         composite_view
+    composite_view const & composite() const
+    {
+      if (type==field_type::composite)
+      {
+        return *c;
+      }
+      throw std::logic_error
+            ("Composite field value requested for non-composite field_view.");
+    }
+  };
+
+  class view_parse_context;
+
+  /// @brief A composite field produced by the view parse mode
+  ///
+  /// The view parse mode equivalent of composite_field. Each named field's
+  /// values are held contiguously, in the order they appeared, in memory
+  /// owned by the config_document, and are accessed through field_ranges
+  /// referring to them rather than copies.
+  class composite_view
+  {
+    friend class view_parse_context;
+
+  public:
+    /// @brief Range of a composite_view field's values
+    class field_range
+    {
+      field_view const *  first;
+      field_view const *  last;
+
+    public:
+      /// @brief Construct from pointers to first and one past last values
+      field_range(field_view const * b, field_view const * e)
+      : first(b)
+      , last(e)
+      {}
+
+      /// @brief Return pointer to first value
+      field_view const * begin() const { return this->first; }
+
+      /// @brief Return pointer to one past last value
+      field_view const * end() const { return this->last; }
+
+      /// @brief Return number of values
+      std::size_t size() const { return this->last-this->first; }
+
+      /// @brief Return reference to value at given position
+      /// @param idx  Position of value, must be less than size()
+      field_view const & operator[](std::size_t idx) const
+      {
+        return this->first[idx];
+      }
+    };
+
+  private:
+    struct named_field
+    {
+      text_view   name;
+      field_range values;
+    };
+
+    named_field const * fields;
+    std::size_t         field_count;
+
+    composite_view(named_field const * named_fields, std::size_t count)
+    : fields(named_fields)
+    , field_count(count)
+    {}
+
+    named_field const * find(text_view name) const;
+
+  public:
+    /// @brief Check if composite_view contains a specific field
+    /// @param name   Name of field to check existence of
+    /// @returns true if instance has field with the passed name, false if not.
+    bool has_field( text_view name ) const
+    {
+      return this->find(name)!=nullptr;
+    }
+
+    /// @brief Return range of field values for given field name
+    /// @param field_name   Name of field to return values for
+    /// @returns field_range of field_views for field, referring to those
+    ///          held for the composite_view.
+    /// @throws std::runtime_error if object does not contain a field
+    ///         named field_name.
+    field_range at(text_view field_name) const;
+
+    /// @brief Synonym for composite_view::at.
+    field_range operator[](text_view field_name) const
+    {
+      return this->at(field_name);
+    }
+  };
+
+  /// @brief Receiver of fields parsed in streaming parse mode
+  ///
+  /// composite_field_parser::parse_stream calls a field_handler's member
+  /// functions for each field as it is parsed rather than building a
+  /// composite_field, so the memory used does not grow with the size of the
+  /// configuration and values can be used before parsing completes.
+  class field_handler
+  {
+  public:
+    virtual ~field_handler() {}
+
+    /// @brief Called on reading the opening '{' of a composite field
+    /// @param name Name of the composite field, empty for the outermost field
+    virtual void begin_composite(std::string const & name) = 0;
+
+    /// @brief Called after a composite field's closing '}' is read and the
+    ///        presence of its required fields checked
+    /// @param name Name of the composite field, empty for the outermost field
+    virtual void end_composite(std::string const & name) = 0;
+
+    /// @brief Called for each text, integer or boolean field parsed
+    /// @param name   Name of the field
+    /// @param value  Value of the field
+    virtual void field(std::string const & name, field_value const & value) = 0;
+  };
+
   /// @brief Base type for parsing configuration fields
   /// Declares/defines operations and state common for all field parsers.
   /// All field have multiplicity (single, repeated) and presence
@@ -266,6 +581,22 @@ namespace config_file
     /// @param in Stream to read tokens from to parse field.
     virtual field_value parse_field(std::istream & in) = 0;
 
+    /// @brief Field view parsing operation
+    /// @param ctx  View parsing state, including configuration text position.
+    virtual field_view parse_view(view_parse_context & ctx) = 0;
+
+    /// @brief Streaming field parsing operation
+    /// By default parses the field using parse_field and passes the value to
+    /// handler.field.
+    /// @param in       Stream to read tokens from to parse field.
+    /// @param name     Name of the field being parsed.
+    /// @param handler  Receiver of the parsed field(s).
+    virtual void parse_events
+    ( std::istream & in
+    , std::string const & name
+    , field_handler & handler
+    );
+
     /// @brief Get multiplicity value field_parser constructed with
     /// @returns Instance's field multiplicity value
     field_multiplicity get_multiplicity() { return this->multiplicity; }
@@ -342,6 +673,89 @@ namespace config_file
     ///         or opening '{' or closing '}' are missing (note: missing too
     ///         many tokens might combine fields).
     field_value parse_field(std::istream & in); //override;
+
+    /// @brief Parses a composite field in view parse mode.
+    /// Grammar and checks are as for parse_field. Field values are held in
+    /// memory owned by the config_document being parsed, grouped by name.
+    /// @param ctx  View parsing state, including configuration text position.
+    /// @returns composite type of field_view.
+    /// @throws std::runtime_error for the same reasons as parse_field.
+    field_view parse_view(view_parse_context & ctx); //override;
+
+    /// @brief Parses a composite field in streaming mode.
+    /// Grammar and checks are as for parse_field. Calls
+    /// handler.begin_composite, then parse_events of each field's parser as
+    /// the field is read, then handler.end_composite. Fields are checked as
+    /// they are read so the handler may have been passed fields of a
+    /// composite field before an error in it is detected.
+    /// @param in       Stream to parse composite field from.
+    /// @param name     Name of the composite field being parsed.
+    /// @param handler  Receiver of the parsed fields.
+    /// @throws std::runtime_error for the same reasons as parse_field.
+    void parse_events
+    ( std::istream & in
+    , std::string const & name
+    , field_handler & handler
+    ); //override;
+
+    /// @brief Parses a configuration in streaming mode.
+    /// Parses a composite field as parse_events with an empty name: the
+    /// configuration is read from in no faster than handler is passed its
+    /// fields.
+    /// @param in       Stream to parse composite field from.
+    /// @param handler  Receiver of the parsed fields.
+    /// @throws std::runtime_error for the same reasons as parse_field.
+    void parse_stream(std::istream & in, field_handler & handler)
+    {
+      this->parse_events(in, std::string(), handler);
+    }
+  };
+
+  /// @brief Configuration parsed in view parse mode
+  ///
+  /// Parses configuration text using a composite_field_parser in a single
+  /// pass with no per-field copying: the text is held in one buffer, text
+  /// values and field names are text_views into it, and all field_views and
+  /// composite_views are placed in large blocks of arena memory owned by the
+  /// document that are released together when it is destroyed. Suited to
+  /// loading large configuration files quickly.
+  ///
+  /// Views obtained from a config_document refer into it so must not be used
+  /// after it is destroyed. For this reason config_documents cannot be copied
+  /// or moved.
+  class config_document
+  {
+    friend class view_parse_context;
+
+    std::string                           text;
+    std::vector<std::unique_ptr<char[]>>  blocks;
+    char *                                block;
+    std::size_t                           block_used;
+    composite_view const *                root_view;
+
+    void * allocate(std::size_t size, std::size_t alignment);
+    void parse(composite_field_parser & parser);
+
+  public:
+    /// @brief Read all of a stream and parse it as a composite field
+    /// @param parser Parser describing the configuration's fields
+    /// @param in     Stream to read configuration text from
+    /// @throws std::runtime_error if the stream cannot be read or for the
+    ///         same reasons as composite_field_parser::parse_field.
+    config_document(composite_field_parser & parser, std::istream & in);
+
+    /// @brief Parse configuration text as a composite field
+    /// @param parser Parser describing the configuration's fields
+    /// @param config Configuration text, moved into the document
+    /// @throws std::runtime_error for the same reasons as
+    ///         composite_field_parser::parse_field.
+    config_document(composite_field_parser & parser, std::string config);
+
+    config_document(config_document const &) = delete;
+    config_document & operator=(config_document const &) = delete;
+
+    /// @brief Return the parsed configuration's outer composite field
+    composite_view const & root() const { return *this->root_view; }
   };
 }
 #endif // LED_STRING_DISPLAY_CONFIG_FILE_H
@@ -6,12 +6,15 @@
 /// @author Ralph E. McArdell
 
 #include "config-file.h"
-#include "pin.h"
+#include "pin_group.h"
+#include "gpio_sequence.h"
 
 #include <exception>    // for std::exception
 #include <iostream>     // for std IO stream objects
 #include <fstream>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <chrono>
 #include <vector>
 #include <utility>
@@ -37,6 +40,111 @@ struct led_sequence
 /// @brief  Collection of LED lighting effect sequences
 typedef std::vector<led_sequence> led_sequences;
 
+/// @brief LED sequences passed from the configuration reading thread to the
+/// light show thread as each is read.
+class sequence_feed
+{
+  std::mutex              guard;
+  std::condition_variable added;
+  led_sequences           pending;
+  bool                    complete{false};
+
+public:
+  /// @brief Add a sequence read from the configuration
+  /// @param seq  Sequence to add, moved from
+  void push(led_sequence && seq)
+  {
+    std::lock_guard<std::mutex> lock(guard);
+    pending.push_back(std::move(seq));
+    added.notify_one();
+  }
+
+  /// @brief Indicate no more sequences will be added
+  void finish()
+  {
+    std::lock_guard<std::mutex> lock(guard);
+    complete = true;
+    added.notify_one();
+  }
+
+  /// @brief Take sequences added since the last take
+  /// @param wait_for If non-zero and no sequences are pending and more may be
+  ///                 added, time to wait for some to be added.
+  /// @returns Sequences added since the last take, possibly none.
+  led_sequences take(std::chrono::milliseconds wait_for)
+  {
+    std::unique_lock<std::mutex> lock(guard);
+    if (pending.empty() && !complete && wait_for.count()!=0)
+      {
+        added.wait_for(lock, wait_for);
+      }
+    led_sequences seqs;
+    seqs.swap(pending);
+    return seqs;
+  }
+};
+
+/// @brief Builds led_sequences from streamed configuration fields
+///
+/// Receives the fields of the configuration format described for
+/// stream_sequences_from_config_stream as they are parsed, pushing each
+/// sequence to a sequence_feed as soon as its closing '}' has been read.
+class sequence_builder : public config_file::field_handler
+{
+  sequence_feed &   feed;
+  led_sequence      seq;
+  led_string_delta  delta;
+
+public:
+  /// @brief Construct to push sequences to a feed
+  /// @param f  Feed to push sequences to
+  explicit sequence_builder(sequence_feed & f)
+  : feed(f)
+  {}
+
+  void begin_composite(std::string const & name) //override
+  {
+    if (name=="sequence")
+      {
+        seq.deltas.clear();
+      }
+    else if (name=="initial_state" || name=="delta")
+      {
+        delta.clear();
+      }
+  }
+
+  void end_composite(std::string const & name) //override
+  {
+    if (name=="sequence")
+      {
+        feed.push(std::move(seq));
+        seq = led_sequence();
+      }
+    else if (name=="initial_state")
+      { // the initial state is always the first step, wherever it appears
+        seq.deltas.insert(seq.deltas.begin(), delta);
+      }
+    else if (name=="delta")
+      {
+        seq.deltas.push_back(delta);
+      }
+  }
+
+  void field(std::string const & name, config_file::field_value const & value)
+  //override
+  {
+    if (name=="rate_ms")
+      {
+        seq.delay = std::chrono::milliseconds(value.integer());
+      }
+    else
+      { // only initial_state and delta fields remain: LEDs "0" to "7"
+        delta.emplace_back(name[0]-'0', value.boolean());
+      }
+  }
+};
+
 /// @brief Read LED string sequences configuration from input stream
 ///
 /// Defines a configuration file / stream format as a
@@ -71,15 +179,19 @@ typedef std::vector<led_sequence> led_sequences;
 ///     }
 ///   }
 ///
-/// Attempts to read sequences configuration from passed input stream and uses
-/// returned fields to create and return a collection of led sequences that
-/// can be passed to do_light_show.
+/// Reads sequences configuration from passed input stream in streaming mode,
+/// pushing each led sequence to the passed feed, from which do_light_show
+/// takes them, as soon as it has been read. The show can thus start as soon
+/// as the first sequence is read and the configuration is never held in
+/// memory as a whole.
 ///
-/// @param [in] in  Input stream to read LED sequences configuration from.
-/// @returns led_sequences collection of LED sequences.
+/// @param [in] in    Input stream to read LED sequences configuration from.
+/// @param [in] feed  Feed to push led sequences to. Finished once the whole
+///                   configuration has been read.
 /// @throws std::runtime_error if in stream does not represent a valid
-///         configuration.
-led_sequences get_sequences_from_config_stream(std::istream & in)
+///         configuration. Sequences pushed before the error was found remain
+///         in the feed, which is not finished.
+void stream_sequences_from_config_stream(std::istream & in, sequence_feed & feed)
 {
   using namespace config_file;
   composite_field_parser config_parser(field_multiplicity::single, field_presence::required);
@@ -110,124 +222,99 @@ led_sequences get_sequences_from_config_stream(std::istream & in)
   delta_leds_parser.add_field( "6", field_type::boolean, field_multiplicity::single, field_presence::optional);
   delta_leds_parser.add_field( "7", field_type::boolean, field_multiplicity::single, field_presence::optional);
 
-  composite_field seqs_value(config_parser.parse_field(in).composite());
-
-  led_sequences seqs;
-  for ( auto const & upsv : seqs_value["sequence"] )
-    {
-      led_sequence seq;
-      seq.delay = std::chrono::milliseconds(upsv->composite()["rate_ms"][0]->integer());
-      led_string_delta d;
-      d.emplace_back(0, upsv->composite()["initial_state"][0]->composite()["0"][0]->boolean());
-      d.emplace_back(1, upsv->composite()["initial_state"][0]->composite()["1"][0]->boolean());
-      d.emplace_back(2, upsv->composite()["initial_state"][0]->composite()["2"][0]->boolean());
-      d.emplace_back(3, upsv->composite()["initial_state"][0]->composite()["3"][0]->boolean());
-      d.emplace_back(4, upsv->composite()["initial_state"][0]->composite()["4"][0]->boolean());
-      d.emplace_back(5, upsv->composite()["initial_state"][0]->composite()["5"][0]->boolean());
-      d.emplace_back(6, upsv->composite()["initial_state"][0]->composite()["6"][0]->boolean());
-      d.emplace_back(7, upsv->composite()["initial_state"][0]->composite()["7"][0]->boolean());
-      seq.deltas.push_back(d);
-      if ( upsv->composite().has_field("delta"))
-        {
-          for ( auto const & updv : upsv->composite()["delta"] )
-            {
-              d.clear();
-              if (updv->composite().has_field("0"))
-                { d.emplace_back(0, updv->composite()["0"][0]->boolean());}
-              if (updv->composite().has_field("1"))
-                { d.emplace_back(1, updv->composite()["1"][0]->boolean());}
-              if (updv->composite().has_field("2"))
-                { d.emplace_back(2, updv->composite()["2"][0]->boolean());}
-              if (updv->composite().has_field("3"))
-                { d.emplace_back(3, updv->composite()["3"][0]->boolean());}
-              if (updv->composite().has_field("4"))
-                { d.emplace_back(4, updv->composite()["4"][0]->boolean());}
-              if (updv->composite().has_field("5"))
-                { d.emplace_back(5, updv->composite()["5"][0]->boolean());}
-              if (updv->composite().has_field("6"))
-                { d.emplace_back(6, updv->composite()["6"][0]->boolean());}
-              if (updv->composite().has_field("7"))
-                { d.emplace_back(7, updv->composite()["7"][0]->boolean());}
-              seq.deltas.push_back(d);
-            }
-        }
-      seqs.push_back(seq);
-    }
-
-  return seqs;
+  sequence_builder builder(feed);
+  config_parser.parse_stream(in, builder);
+  feed.finish();
 }
 
-/// @brief Apply a single set of LED state changes
-/// @param delta  Set of changes to apply to state of LEDs
-/// @param leds   Pointer to array of pointers to LED opin objects.
-void apply(led_string_delta const & delta, opin ** leds)
+/// @brief Compile LED sequences into GPIO sequences played on a group of pins
+/// @param seqs     Collection of LED string sequence descriptions.
+/// @param leds     Group of LED output pins, LED n is the nth pin of the group.
+/// @param compiled Collection of GPIO sequences to append to, one per LED
+///                 sequence, with one step per LED string delta.
+void compile_sequences
+( led_sequences const & seqs
+, opin_group const & leds
+, std::vector<gpio_sequence> & compiled
+)
 {
-  for (auto & desc : delta)
+  for (auto & seq : seqs)
     {
-      leds[desc.first]->put(desc.second);
+      compiled.emplace_back(leds, seq.delay);
+      for (auto & delta : seq.deltas)
+        {
+          compiled.back().append(delta);
+        }
     }
 }
 
 /// @brief  Core program logic
 ///
-/// - create the 8 GPIO opin, out pins that drive the LEDs
-/// - set initial state
+/// - create the group of 8 GPIO output pins that drive the LEDs
+/// - wait for the first sequence to be read
 /// - while running:
-///    - apply sequences a number of times each
+///    - play sequences a number of times each
 ///      - switch sequence after each one completes a set number of times
+///        - compile sequences read since the last switch into set / clear
+///          masks for the pins
 ///        - wrap from last to first sequence
 ///
-/// @param seqs Collection of LED string sequence descriptions.
-void do_light_show( led_sequences const & seqs )
+/// Each change is due a sequence's delay after the one before, timed from the
+/// start of the show by the system timer, so changes do not drift late.
+///
+/// @param feed Feed of LED string sequence descriptions as they are read.
+void do_light_show( sequence_feed & feed )
 {
   try
     {
-      opin led0{gpio_gen6}; // Gertboard J2 GP25
-      opin led1{gpio_gen5}; // Gertboard J2 GP24
-      opin led2{gpio_gen4}; // Gertboard J2 GP23
-      opin led3{gpio_gen3}; // Gertboard J2 GP22
-      opin led4{rxd};       // Gertboard J2 GP15
-      opin led5{gpio_gen2}; // Gertboard J2 GP21 (GPIO27 on rev.2 boards)
-      opin led6{gpio_gen1}; // Gertboard J2 GP18 
-      opin led7{gpio_gen0}; // Gertboard J2 GP17 
-      opin * leds[] = {&led0, &led1, &led2, &led3, &led4, &led5, &led6, &led7};
-
-      auto t_wake(std::chrono::system_clock::now());
-      constexpr auto t_snooze(std::chrono::milliseconds{50});
-      auto t_do_change(std::chrono::system_clock::now());
+      opin_group leds
+                { gpio_gen6 // Gertboard J2 GP25
+                , gpio_gen5 // Gertboard J2 GP24
+                , gpio_gen4 // Gertboard J2 GP23
+                , gpio_gen3 // Gertboard J2 GP22
+                , rxd       // Gertboard J2 GP15
+                , gpio_gen2 // Gertboard J2 GP21 (GPIO27 on rev.2 boards)
+                , gpio_gen1 // Gertboard J2 GP18
+                , gpio_gen0 // Gertboard J2 GP17
+                };
+      std::vector<gpio_sequence> compiled;
+      constexpr auto t_wait_first(std::chrono::milliseconds{50});
+      while (g_running && compiled.empty())
+        {
+          compile_sequences(feed.take(t_wait_first), leds, compiled);
+        }
       constexpr int iterations_per_sequence{10};
       std::size_t seq_idx{0};
-      auto seq(seqs[seq_idx]);
-      auto pos = seq.deltas.begin();
+      std::size_t step{0};
       int count{0};
-      while (g_running) 
+      auto t_do_change(system_timer::now());
+      while (g_running)
         {
-          std::this_thread::sleep_until(t_wake);
-          if ( t_do_change < std::chrono::system_clock::now() )
+          gpio_sequence const & seq(compiled[seq_idx]);
+          if (seq.size()!=0)
             {
-              apply(*pos,leds);
-              t_do_change += seq.delay;
-              ++pos;
-              if ( pos==seq.deltas.end())
+              seq.play_step(step, t_do_change);
+              t_do_change += seq.step_interval();
+            }
+          if (++step>=seq.size())
+            {
+              step = 0;
+              if (++count>=iterations_per_sequence)
                 {
-                  if (++count>=iterations_per_sequence)
-                   {
-                      count = 0;
-                      ++seq_idx;
-                      if (seq_idx >= seqs.size())
-                        {
-                          seq_idx = 0;
-                        }
-                     seq = seqs[seq_idx];
-                   }
-                  pos = seq.deltas.begin();
+                  count = 0;
+                  ++seq_idx;
+                  compile_sequences( feed.take(std::chrono::milliseconds{0})
+                                   , leds, compiled
+                                   );
+                  if (seq_idx >= compiled.size())
+                    {
+                      seq_idx = 0;
+                    }
                 }
             }
-          t_wake += t_snooze;
         }
 
-      for (int i = 0; i != 8; ++i)
-        leds[i]->put(false);
+      leds.put(0U);
     }
   catch ( std::exception & e )
     {
@@ -243,10 +330,11 @@ char const * default_config_file = "led-string-display.cfg";
 /// @brief Handle command line arguments, read configuration, do work
 ///
 /// Processes command-line arguments and either prints help and quits or
-/// reads LED string sequences from a configuration file, runs main work on
-/// separate thread doing the LED sequence 'show' while main thread waits for
-/// console input from user, whereupon quit running request signalled and the 
-/// worker thread is joined to wait for it to exit before returning.
+/// runs main work on separate thread doing the LED sequence 'show' while main
+/// thread reads LED string sequences from a configuration file, passing each
+/// to the show as it is read, then waits for console input from user,
+/// whereupon quit running request signalled and the worker thread is joined
+/// to wait for it to exit before returning.
 int main(int argc, char* argv[])
 {
   std::string config_pathname(default_config_file);
@@ -282,9 +370,21 @@ int main(int argc, char* argv[])
                 << config_pathname << "'.\n";
       return 1;
     }
-  led_sequences seqs(get_sequences_from_config_stream(cfg_in));
+  sequence_feed feed;
   std::cout << "Press enter to quit....\n";
-  std::thread counter{ do_light_show, std::ref(seqs) };
+  std::thread counter{ do_light_show, std::ref(feed) };
+  try
+    {
+      stream_sequences_from_config_stream(cfg_in, feed);
+    }
+  catch ( std::exception & e )
+    {
+      std::cerr << "ERROR: Bad configuration file '" << config_pathname
+                << "'. Description: " << e.what() << "\n";
+      g_running = false;
+      counter.join();
+      return 1;
+    }
   std::string dummy;
   std::getline(std::cin, dummy);
   g_running = false;
@@ -9,6 +9,7 @@
 #include "config-file.h"
 #include <string>
 #include <sstream>
+#include <vector>
 #include <iostream>
 
 using namespace config_file;
@@ -536,3 +537,178 @@ TEST_CASE( "Unit-tests/examples/led-string-display/zzz_parse-complex-configurati
         }
     }
 }
+
+TEST_CASE( "Unit-tests/examples/led-string-display/view-parse-simple-fields"
+         , "Parsing text, integer and boolean fields in view mode should work"
+         )
+{
+  composite_field_parser parser(field_multiplicity::single, field_presence::required);
+  parser.add_field( "text", field_type::text, field_multiplicity::single, field_presence::required);
+  parser.add_field( "integer", field_type::integer, field_multiplicity::single, field_presence::required);
+  parser.add_field( "boolean", field_type::boolean, field_multiplicity::single, field_presence::required);
+  parser.add_field( "optional", field_type::text, field_multiplicity::single, field_presence::optional);
+  std::istringstream istrm("{\n text abc\n integer -123\n boolean on\n}");
+  config_document config(parser, istrm);
+  CHECK(config.root().has_field("text"));
+  CHECK_FALSE(config.root().has_field("optional"));
+  CHECK(config.root()["text"][0].text()=="abc");
+  CHECK(config.root()["text"][0].text().str()==std::string("abc"));
+  CHECK(config.root()["integer"][0].integer()==-123);
+  CHECK(config.root()["boolean"][0].boolean());
+  REQUIRE_THROWS_AS(config.root()["integer"][0].boolean(), std::logic_error);
+  REQUIRE_THROWS_AS(config.root()["text"][0].composite(), std::logic_error);
+  REQUIRE_THROWS_AS(config.root()["boolean"][0].integer(), std::logic_error);
+  REQUIRE_THROWS_AS(config.root()["integer"][0].text(), std::logic_error);
+  REQUIRE_THROWS_AS(config.root().at("optional"), std::runtime_error);
+}
+
+TEST_CASE( "Unit-tests/examples/led-string-display/view-parse-repeated-nested-fields"
+         , "Repeated fields parsed in view mode keep their order and nested "
+           "composites and comments are handled"
+         )
+{
+  composite_field_parser parser(field_multiplicity::single, field_presence::required);
+  parser.add_field( "point", field_type::composite, field_multiplicity::repeated, field_presence::required);
+  parser.add_field( "name", field_type::text, field_multiplicity::repeated, field_presence::optional);
+  composite_field_parser & point_parser(parser.get_composite_field("point"));
+  point_parser.add_field("y", field_type::integer, field_multiplicity::single, field_presence::required);
+  point_parser.add_field("x", field_type::integer, field_multiplicity::single, field_presence::required);
+  std::string const config_text
+  ( "{ # points\n"
+    "  name first#comment\n"
+    "  point { y 2 x 1 }\n"
+    "  name second\n"
+    "  point { x 3 y 4 } # another comment\n"
+    "  point { x 5 y 6 }\n"
+    "}"
+  );
+  config_document config(parser, config_text);
+  REQUIRE(config.root()["name"].size()==2);
+  CHECK(config.root()["name"][0].text()=="first");
+  CHECK(config.root()["name"][1].text()=="second");
+  REQUIRE(config.root()["point"].size()==3);
+  long expected{1};
+  for (auto const & point : config.root()["point"])
+    {
+      CHECK(point.composite()["x"][0].integer()==expected++);
+      CHECK(point.composite()["y"][0].integer()==expected++);
+    }
+}
+
+TEST_CASE( "Unit-tests/examples/led-string-display/view-parse-bad-configurations"
+         , "Bad configurations throw in view mode as when parsing fields"
+         )
+{
+  composite_field_parser parser(field_multiplicity::single, field_presence::required);
+  parser.add_field( "single", field_type::integer, field_multiplicity::single, field_presence::required);
+  REQUIRE_THROWS_AS( config_document(parser, std::string("{\n}"))
+                   , std::runtime_error
+                   );
+  REQUIRE_THROWS_AS( config_document(parser, std::string("{ single 1 single 2 }"))
+                   , std::runtime_error
+                   );
+  REQUIRE_THROWS_AS( config_document(parser, std::string("{ single 1 other 2 }"))
+                   , std::runtime_error
+                   );
+  REQUIRE_THROWS_AS( config_document(parser, std::string("single 1 }"))
+                   , std::runtime_error
+                   );
+  REQUIRE_THROWS_AS( config_document(parser, std::string("{ single 1"))
+                   , std::runtime_error
+                   );
+  REQUIRE_THROWS_AS( config_document(parser, std::string("{ single x }"))
+                   , std::invalid_argument
+                   );
+  std::istringstream istrm("{ single 1 }");
+  istrm.setstate(std::ios::failbit);
+  REQUIRE_THROWS_AS(config_document(parser, istrm), std::runtime_error);
+}
+
+namespace
+{
+  class recording_handler : public field_handler
+  {
+  public:
+    std::vector<std::string> events;
+
+    void begin_composite(std::string const & name)
+    {
+      events.push_back("begin " + name);
+    }
+
+    void end_composite(std::string const & name)
+    {
+      events.push_back("end " + name);
+    }
+
+    void field(std::string const & name, field_value const & value)
+    {
+      events.push_back(name + " " + value.text());
+    }
+  };
+}
+
+TEST_CASE( "Unit-tests/examples/led-string-display/stream-parse-fields"
+         , "Parsing in streaming mode passes fields to the handler in the "
+           "order they are read"
+         )
+{
+  composite_field_parser parser(field_multiplicity::single, field_presence::required);
+  parser.add_field( "item", field_type::composite, field_multiplicity::repeated, field_presence::required);
+  parser.add_field( "title", field_type::text, field_multiplicity::single, field_presence::optional);
+  composite_field_parser & item_parser(parser.get_composite_field("item"));
+  item_parser.add_field("name", field_type::text, field_multiplicity::single, field_presence::required);
+  item_parser.add_field("alias", field_type::text, field_multiplicity::repeated, field_presence::optional);
+  std::istringstream istrm
+  ( "{\n"
+    "  item { name one alias uno alias ein } # first\n"
+    "  title list\n"
+    "  item { name two }\n"
+    "}"
+  );
+  recording_handler handler;
+  parser.parse_stream(istrm, handler);
+  std::vector<std::string> const expected
+  { "begin ", "begin item", "name one", "alias uno", "alias ein", "end item"
+  , "title list", "begin item", "name two", "end item", "end "
+  };
+  CHECK(handler.events==expected);
+}
+
+TEST_CASE( "Unit-tests/examples/led-string-display/stream-parse-bad-configurations"
+         , "Bad configurations throw in streaming mode after passing the "
+           "fields read before the problem to the handler"
+         )
+{
+  composite_field_parser parser(field_multiplicity::single, field_presence::required);
+  parser.add_field( "item", field_type::composite, field_multiplicity::repeated, field_presence::required);
+  composite_field_parser & item_parser(parser.get_composite_field("item"));
+  item_parser.add_field("name", field_type::text, field_multiplicity::single, field_presence::required);
+  {
+    std::istringstream istrm("{ item { name one } item { name two name three } }");
+    recording_handler handler;
+    REQUIRE_THROWS_AS(parser.parse_stream(istrm, handler), std::runtime_error);
+    CHECK(handler.events.size()==6);
+  }
+  {
+    std::istringstream istrm("{ item { name one } item { } }");
+    recording_handler handler;
+    REQUIRE_THROWS_AS(parser.parse_stream(istrm, handler), std::runtime_error);
+    CHECK(handler.events.size()==5);
+  }
+  {
+    std::istringstream istrm("{ }");
+    recording_handler handler;
+    REQUIRE_THROWS_AS(parser.parse_stream(istrm, handler), std::runtime_error);
+  }
+  {
+    std::istringstream istrm("{ item { name one } other 1 }");
+    recording_handler handler;
+    REQUIRE_THROWS_AS(parser.parse_stream(istrm, handler), std::runtime_error);
+  }
+  {
+    std::istringstream istrm("{ item { name one }");
+    recording_handler handler;
+    REQUIRE_THROWS_AS(parser.parse_stream(istrm, handler), std::runtime_error);
+  }
+}
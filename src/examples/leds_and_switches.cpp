@@ -7,11 +7,14 @@
 //
 
 #include "pin.h"
+#include "debouncer.h"
 
 #include <exception>    // for std::exception
 #include <iostream>     // for std IO stream objects
-#include <unistd.h>     // for usleep
-#include <thread>
+#include <string>       // for std::string, std::getline
+#include <system_error> // for std::system_error
+#include <thread>       // for std::thread, std::this_thread
+#include <chrono>
 
 using namespace dibase::rpi::peripherals;
 
@@ -26,20 +29,36 @@ void count_switch_presses()
       opin led2{gpio_gen4};
       opin led3{gpio_gen3};
 
-      ipin switch0{gpio_gen2};
+      ipin_group switches{gpio_gen2};
+
+    // Switch must be stable for 14 x 5ms = 70ms for a change to count
+      std::chrono::microseconds const tick{5000};
+      unsigned const stable_ticks{14};
+    // Check real-time scheduling is available before asking for it
+      rt_config config{50, rt_config::any_cpu, true, 64*1024};
+      try
+        {
+          rt_thread{config, [](){}}.join();
+        }
+      catch ( std::system_error & e )
+        {
+          std::cerr << "Real-time scheduling not available, running without. "
+                       "Description: " << e.what() << "\n";
+          config = rt_config{};
+        }
+      debouncer switch0{switches, tick, stable_ticks, 16U, config};
 
-      unsigned const switch_delay_ms{70};
-      unsigned const switch_delay_us{switch_delay_ms*1000};
-      
       unsigned count{0};
-      while (g_running) 
+      edge_event_record events[16];
+      while (g_running)
         {
-          while (!switch0.get() && g_running)
-            usleep(switch_delay_us);
-          while (switch0.get() && g_running)
-            usleep(switch_delay_us);
-          if (g_running)
+          std::this_thread::sleep_for(std::chrono::milliseconds(20));
+          std::size_t const n{switch0.pop(events, 16U)};
+          for (std::size_t i=0; i!=n; ++i)
             {
+            // A press is counted when the switch is released
+              if (events[i].edge!=pin_edge_event::falling)
+                continue;
               ++count;
               led0.put((count&1));
               led1.put((count&2));
@@ -62,7 +81,7 @@ void count_switch_presses()
 int main()
 {
   std::cout << "Press enter to quit....\n";
-  std::thread counter{ count_switch_presses };
+  std::thread counter{count_switch_presses};
   std::string dummy;
   std::getline(std::cin, dummy);
   g_running = false;
@@ -7,9 +7,11 @@
 //
 
 #include "pin.h"
+#include "rt_thread.h"
 
 #include <exception>    // for std::exception
 #include <iostream>     // for std IO stream objects
+#include <system_error> // for std::system_error
 #include <chrono>
 #include <thread>
 
@@ -28,11 +30,11 @@ void switch_oc_output_on_input()
       bool in_value{in.get()};
       gpio_clk_out.put(in_value);
       unsigned const input_change_wait_ms{50};
+      rt_period input_poll{std::chrono::milliseconds(input_change_wait_ms)};
       while (g_running)
         {
           while (in.get()==in_value && g_running)
-            std::this_thread::sleep_for
-                              (std::chrono::milliseconds(input_change_wait_ms));
+            input_poll.wait();
           if (g_running)
             {
               in_value = ! in_value;
@@ -49,7 +51,19 @@ void switch_oc_output_on_input()
 int main()
 {
   std::cout << "Press enter to quit....\n";
-  std::thread worker{ switch_oc_output_on_input };
+  rt_thread worker;
+  try
+    {
+      worker = rt_thread{ rt_config{50, rt_config::any_cpu, true, 64*1024}
+                        , switch_oc_output_on_input
+                        };
+    }
+  catch ( std::system_error & e )
+    {
+      std::cerr << "Real-time scheduling not available, running without. "
+                   "Description: " << e.what() << "\n";
+      worker = rt_thread{ rt_config{}, switch_oc_output_on_input };
+    }
   std::string dummy;
   std::getline(std::cin, dummy);
   g_running = false;
@@ -1,40 +1,50 @@
 // Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
-/// @file examples/pulse_counter.cpp 
-/// @brief Use ipin_edge_event to count pluses on a GPIO input pin
+/// @file examples/pulse_counter.cpp
+/// @brief Use pin_event_detector to time pulses on a GPIO input pin
+///
+/// Rising edges are busy polled for and timestamped from the system timer so
+/// pulse periods are measured to within a few microseconds, rather than
+/// including the wake up latency of waiting on a pin_edge_event.
 //
 /// @copyright Copyright (c) Dibase Limited 2012
 /// @author Ralph E. McArdell
 //
 
-#include "pin_edge_event.h"
+#include "pin_event_detector.h"
+#include "edge_timing.h"
+#include "rt_thread.h"
 
 #include <exception>    // for std::exception
 #include <iostream>     // for std IO stream objects
 #include <iomanip>      // for std::setw
+#include <system_error>
 #include <chrono>
 #include <thread>
 #include <atomic>
+#include <mutex>
 
 using namespace dibase::rpi::peripherals;
-bool g_running{ true };  ///< Global flag used to communicate quit request
+std::atomic<bool> g_running{ true };///< Flag used to communicate quit request
 
-std::atomic<unsigned> g_count{0U};
+std::mutex    g_timing_mutex;       ///< Guards g_timing
+edge_timing   g_timing{64U};        ///< Timestamps of the latest pulses
 
-void count_pulses()
+void time_pulses()
 {
   try
     {
-      ipin in{gpio_gclk};           // Gertboard J2 GP4 -- connect to i/p device
+      ipin_group in{gpio_gclk};     // Gertboard J2 GP4 -- connect to i/p device
 
-      pin_edge_event pin_evt(in, pin_edge_event::rising);
+      pin_event_detector detector(in, pin_event_detector::rising);
       constexpr auto timeout(std::chrono::milliseconds{65});
 
       while (g_running)
         {
-          if (pin_evt.wait_for(timeout))
+          system_timer::time_point when;
+          if (detector.poll(timeout, when))
             {
-              ++g_count;
-              pin_evt.clear();
+              std::lock_guard<std::mutex> lock{g_timing_mutex};
+              g_timing.record(when);
             }
         }
     }
@@ -46,28 +56,31 @@ void count_pulses()
 
 void display_frequency()
 {
-  constexpr auto sample_duration(std::chrono::milliseconds{50});
-  auto t_sample(std::chrono::system_clock::now());
-  auto sample_t0(std::chrono::system_clock::now());
+  rt_period sample_period{std::chrono::milliseconds{50}};
   while (g_running)
     {
-      do
-        { // Set next sample time point
-          t_sample += sample_duration;
-        }
-      while ( t_sample < std::chrono::system_clock::now() );
-      std::this_thread::sleep_until( t_sample );
-      unsigned cnt{g_count.exchange(0U)};
-      auto sample_t1(std::chrono::system_clock::now());
-      auto sample_t(sample_t1-sample_t0);
-      sample_t0 = sample_t1;
-      unsigned freq((float(cnt)*std::chrono::system_clock::period::den)
-                    /(sample_t.count()*std::chrono::system_clock::period::num));
-      std::cout << "Frequency: " << std::setw(5) << freq << "Hz (count=" 
-                << std::setw(4) << cnt << ", sample_t = " << sample_t.count()
-                << "*[" << std::chrono::system_clock::period::num << '/'
-                << std::chrono::system_clock::period::den << "])"
-                <<"\r";
+      sample_period.wait();
+      f_hertz freq;
+      std::chrono::nanoseconds last;
+      std::chrono::nanoseconds shortest;
+      std::chrono::nanoseconds longest;
+      {
+        std::lock_guard<std::mutex> lock{g_timing_mutex};
+        freq = g_timing.frequency();
+        last = g_timing.last_interval();
+        shortest = g_timing.min_interval();
+        longest = g_timing.max_interval();
+      }
+      using std::chrono::duration_cast;
+      using std::chrono::microseconds;
+      std::cout << "Frequency: " << std::setw(9) << std::fixed
+                << std::setprecision(2) << freq.count() << "Hz (period="
+                << std::setw(7) << duration_cast<microseconds>(last).count()
+                << "us, min=" << std::setw(7)
+                << duration_cast<microseconds>(shortest).count()
+                << "us, max=" << std::setw(7)
+                << duration_cast<microseconds>(longest).count() << "us)"
+                << "\r";
       std::cout.flush();
     }
   std::cout << std::endl;
@@ -77,10 +90,19 @@ int main()
 {
   std::cout << "Press enter to quit....\n";
   std::thread outputter{ display_frequency };
-  std::thread counter{ count_pulses };
+// Poll at real-time priority if allowed, else as an ordinary thread
+  rt_thread timer;
+  try
+    {
+      timer = rt_thread{rt_config{50, rt_config::any_cpu, true}, time_pulses};
+    }
+  catch ( std::system_error & )
+    {
+      timer = rt_thread{rt_config{}, time_pulses};
+    }
   std::string dummy;
   std::getline(std::cin, dummy);
   g_running = false;
-  counter.join();
+  timer.join();
   outputter.join();
 }
@@ -8,13 +8,12 @@
 
 #include "pin.h"
 #include "pwm_pin.h"
+#include "pwm_profile.h"
 
 #include <exception>    // for std::exception
 #include <iostream>     // for std IO stream objects
-#include <iomanip>
 #include <chrono>
 #include <thread>
-#include <cstdlib>
 
 using namespace dibase::rpi::peripherals;
 bool g_running{ true };  ///< Global flag used to communicate quit request
@@ -25,8 +24,8 @@ class motor
     opin      direction_pin;
 
 public:
-    motor(pin_id pwr_pin, pin_id dir_pin)
-    : power_pin{pwr_pin}
+    motor(pin_id pwr_pin, pin_id dir_pin, unsigned range)
+    : power_pin{pwr_pin, range}
     , direction_pin{dir_pin}
     {
       power_pin.start();
@@ -41,6 +40,14 @@ public:
     // -1.0 (full reverse) - 0 (stop) - 1.0 (full forward)
     void set_speed(double speed);
 
+    // Play a drive profile forwards or in reverse, one step per period.
+    // Note: in reverse a ratio of 1.0 is stopped and 0.0 full speed.
+    std::size_t run_profile
+    ( pwm_profile const & profile
+    , bool reverse
+    , std::chrono::nanoseconds period
+    );
+
     ~motor()
     {
       set_speed(0.0);  
@@ -63,6 +70,17 @@ void motor::set_speed(double speed)
     }
 }
 
+std::size_t motor::run_profile
+( pwm_profile const & profile
+, bool reverse
+, std::chrono::nanoseconds period
+)
+{
+  direction_pin.put(reverse);
+  power_pin.set_ratio(reverse ? 1.0 : 0.0); // stopped
+  return profile.play(power_pin, period);
+}
+
 void vary_motor_speed_and_direction()
 {
   try
@@ -70,24 +88,31 @@ void vary_motor_speed_and_direction()
       pwm_pin::set_clock( rpi_oscillator
                         , clock_frequency{kilohertz{600}, clock_filter::none}
                         );
-      int speed_value{0}; // range [-100,100]; negative values reverse direction
-      int speed_change{1};// Start by incrementing speed forwards
-      unsigned const change_wait_ms{200U}; // Delay between changes
-      motor m(gpio_gen1, gpio_gen0);
-    // Repeatedly ramp speed forward from 0 to 100%, then decrease to 0, ramp
-    // speed to 100% in reverse, then to 0...etc. until user bored & quits!
+      unsigned const range{600U}; // 600KHz / 600 => 1KHz PWM frequency
+      std::chrono::milliseconds const update_period{1}; // 1KHz update rate
+    // Smoothly accelerate to full speed over 4s, hold for 2s then
+    // decelerate to a stop over 4s - in reverse the PWM ratio is inverted
+      pwm_profile const forward{range, 1.0, 4000U, 2000U};
+      pwm_profile reverse{range};
+      reverse.ramp(1.0, 0.0, 4000U).hold(0.0, 2000U).ramp(0.0, 1.0, 4000U);
+      motor m(gpio_gen1, gpio_gen0, range);
+    // Repeatedly run the profile forwards then in reverse until user bored
+    // & quits!
+      bool backwards{false};
       while (g_running)
         {
-          m.set_speed(speed_value/100.0);
-          std::cout << (speed_value<0.0?"<<<":">>>")
-                    << std::setw(3) << std::abs(speed_value) << "%\r";
+          std::cout << (backwards?"<<<":">>>") << "\r";
           std::cout.flush();
-          std::this_thread::sleep_for(std::chrono::milliseconds(change_wait_ms));
-          if ( std::abs(speed_value)==100 )
-            {  // at range ends switch between increase<->decrease
-              speed_change *= -1;
+          std::size_t const skipped
+            {m.run_profile( backwards ? reverse : forward
+                          , backwards
+                          , update_period
+                          )};
+          if (skipped)
+            {
+              std::cout << "\nSkipped " << skipped << " late updates\n";
             }
-          speed_value += speed_change;
+          backwards = !backwards;
         }
     }
   catch ( std::exception & e )
@@ -9,6 +9,7 @@
 /// @author Ralph E. McArdell
 
 #include "spi0_pins.h"
+#include "periodic_timer.h"
 
 #include <exception>    // for std::exception
 #include <iostream>     // for std IO stream objects
@@ -60,16 +61,6 @@ class mcp3002
 // Shift of lower bits down to least significant bits (8==bits in a byte)
   constexpr static int   lower_right_shift = 8-number_of_lower_bits;
   
-  std::uint8_t read(spi0_pins & sp)
-  {
-    std::uint8_t byte{0U};
-    while (!sp.read(byte))
-      {
-        std::this_thread::sleep_for(short_delay);
-      }
-    return byte;
-  }
-
 public:
 /// @brief Construct from ADC mode and required SPI0 parameters
 /// @param[in]  am    ADC mode required for object
@@ -90,19 +81,20 @@ public:
 /// @brief Receive a sample value from the device.
 /// @param[in]  sp    Valid spi0_pins object used to open an spi0_slave_context.
 /// @returns Positive value in the range [0,1023] or -1 if unable to
-///           send request to the device due to the SPI0 transmit FIFO being
-///           full (unlikely).
+///           exchange request and response with the device as the SPI0
+///           conversation is not in standard mode (unlikely).
   int get(spi0_pins & sp)
   {
     sp.start_conversing(context);
     int result{-1};
   // Need to write 2 bytes to receive 2 bytes
-    if (sp.write(mode)&&sp.write(mode))
+    std::uint8_t const tx[2]{mode, mode};
+    std::uint8_t rx[2]{0U, 0U};
+    if (sp.transfer(tx, rx, 2)==2)
       {
-        result = read(sp);
+        result = rx[0];
         result <<= upper_left_shift;
-        std::uint8_t lower{read(sp)};
-        result |= (lower>>lower_right_shift);
+        result |= (rx[1]>>lower_right_shift);
         result &= ten_bit_mask;
       }
     return result;
@@ -213,7 +205,7 @@ void output_inverse_of_input(bool const & running)
                                       , spi0_slave::chip1, dac_spi_frequency
                                       );
 
-      auto t_sample(std::chrono::system_clock::now());
+      periodic_timer sample_timer{sample_duration};
       while (running)
         {
           int in{adc0.get(sp)};
@@ -223,12 +215,7 @@ void output_inverse_of_input(bool const & running)
                     << "   DAC0: "<< std::setw(4) << out
                     << '\r';
           std::cout.flush();
-          do
-            { // Set next sample time point
-              t_sample += sample_duration;
-            }
-          while ( t_sample < std::chrono::system_clock::now() );
-          std::this_thread::sleep_until( t_sample );
+          sample_timer.wait();
         }
     }
   catch ( std::exception & e )
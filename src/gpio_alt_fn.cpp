@@ -11,7 +11,11 @@
 /// @author Ralph E. McArdell
 
 #include "gpio_alt_fn.h"
+#include "peripheral_range.h"
 #include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <cstdint>
 
 namespace dibase { namespace rpi {
   namespace peripherals
@@ -21,7 +25,6 @@ namespace dibase { namespace rpi {
       {
         namespace
         {
-          constexpr std::size_t number_of_alt_fns_per_pin{6};
           constexpr std::size_t number_of_gpio_pins{pin_id::max_id-pin_id::min_id+1};
 
         // gpio_alt_fn_table entries are taken from table 6-31, pp 102,103 of the 
@@ -144,15 +147,173 @@ namespace dibase { namespace rpi {
                                     , gpio_pin_fn::alt4, gpio_pin_fn::alt5
                                     };
 
+        // BCM2711 pin alternative functions differing from gpio_alt_fn_table
+        // for the BSC and SPI peripherals, from section 5.3 of the BCM2711
+        // ARM Peripherals datasheet. The BCM2835 slots replaced have no special
+        // function, a BSC slave function or an ARM JTAG function.
+          struct alt_fn_override
+          {
+            pin_id_int_t    pin;
+            std::size_t     alt_idx;
+            gpio_special_fn special_fn;
+          };
+
+          static alt_fn_override const bcm2711_alt_fn_overrides[] =
+          { { 0U, 3U, gpio_special_fn::spi3_ce0_n}
+          , { 0U, 5U, gpio_special_fn::sda6}
+          , { 1U, 3U, gpio_special_fn::spi3_miso}
+          , { 1U, 5U, gpio_special_fn::scl6}
+          , { 2U, 3U, gpio_special_fn::spi3_mosi}
+          , { 2U, 5U, gpio_special_fn::sda3}
+          , { 3U, 3U, gpio_special_fn::spi3_sclk}
+          , { 3U, 5U, gpio_special_fn::scl3}
+          , { 4U, 3U, gpio_special_fn::spi4_ce0_n}
+          , { 4U, 5U, gpio_special_fn::sda3}
+          , { 5U, 3U, gpio_special_fn::spi4_miso}
+          , { 5U, 5U, gpio_special_fn::scl3}
+          , { 6U, 3U, gpio_special_fn::spi4_mosi}
+          , { 6U, 5U, gpio_special_fn::sda4}
+          , { 7U, 3U, gpio_special_fn::spi4_sclk}
+          , { 7U, 5U, gpio_special_fn::scl4}
+          , { 8U, 3U, gpio_special_fn::bscsl_ce_n}
+          , { 8U, 5U, gpio_special_fn::sda4}
+          , { 9U, 3U, gpio_special_fn::bscsl_miso}
+          , { 9U, 5U, gpio_special_fn::scl4}
+          , {10U, 3U, gpio_special_fn::bscsl_sda_mosi}
+          , {10U, 5U, gpio_special_fn::sda5}
+          , {11U, 3U, gpio_special_fn::bscsl_scl_sclk}
+          , {11U, 5U, gpio_special_fn::scl5}
+          , {12U, 3U, gpio_special_fn::spi5_ce0_n}
+          , {12U, 5U, gpio_special_fn::sda5}
+          , {13U, 3U, gpio_special_fn::spi5_miso}
+          , {13U, 5U, gpio_special_fn::scl5}
+          , {14U, 3U, gpio_special_fn::spi5_mosi}
+          , {15U, 3U, gpio_special_fn::spi5_sclk}
+          , {18U, 3U, gpio_special_fn::spi6_ce0_n}
+          , {19U, 3U, gpio_special_fn::spi6_miso}
+          , {20U, 3U, gpio_special_fn::spi6_mosi}
+          , {21U, 3U, gpio_special_fn::spi6_sclk}
+          , {22U, 5U, gpio_special_fn::sda6}
+          , {23U, 5U, gpio_special_fn::scl6}
+          , {24U, 5U, gpio_special_fn::spi3_ce1_n}
+          , {25U, 5U, gpio_special_fn::spi4_ce1_n}
+          , {26U, 5U, gpio_special_fn::spi5_ce1_n}
+          , {27U, 5U, gpio_special_fn::spi6_ce1_n}
+          };
+
+          gpio_special_fn soc_special_fn
+          ( std::size_t pin
+          , std::size_t alt_idx
+          , rpi_processor soc
+          )
+          {
+            if (soc==rpi_processor::bcm2711)
+              {
+                for (auto const & o : bcm2711_alt_fn_overrides)
+                  {
+                    if (o.pin==pin && o.alt_idx==alt_idx)
+                      {
+                        return o.special_fn;
+                      }
+                  }
+              }
+            return gpio_alt_fn_table[pin][alt_idx];
+          }
+
+          constexpr std::size_t number_of_special_fns
+                    {static_cast<std::size_t>(gpio_special_fn::spi6_sclk)+1U};
+
+          constexpr std::size_t number_of_slots
+                            {number_of_gpio_pins*number_of_alt_fns_per_pin};
+
+        // Table slot numbers are pin*number_of_alt_fns_per_pin+alt fn index
+        // so ordering slot numbers orders by pin then alt function.
+        // The running SoC's alternative functions are copied into slots when
+        // the indexes are built so lookups do not depend on the SoC.
+          class slot_indexes
+          {
+            gpio_special_fn slots[number_of_slots];
+            std::uint16_t all[number_of_slots];
+            std::size_t   first[number_of_special_fns+1U];
+            std::uint16_t by_special_fn[number_of_slots];
+
+          public:
+            explicit slot_indexes(rpi_processor soc)
+            {
+              std::fill(std::begin(first), std::end(first), 0U);
+              for (std::size_t slot{0U}; slot!=number_of_slots; ++slot)
+                {
+                  slots[slot] = soc_special_fn
+                                  ( slot/number_of_alt_fns_per_pin
+                                  , slot%number_of_alt_fns_per_pin
+                                  , soc
+                                  );
+                  all[slot] = static_cast<std::uint16_t>(slot);
+                  ++first[static_cast<std::size_t>(specl_fn_of(slot))+1U];
+                }
+              std::partial_sum(std::begin(first), std::end(first), first);
+              std::size_t next[number_of_special_fns];
+              std::copy(first, first+number_of_special_fns, next);
+              for (std::size_t slot{0U}; slot!=number_of_slots; ++slot)
+                {
+                  by_special_fn[next[static_cast<std::size_t>
+                                                    (specl_fn_of(slot))]++]
+                    = static_cast<std::uint16_t>(slot);
+                }
+            }
+
+            gpio_special_fn specl_fn_of(std::size_t slot) const
+            {
+              return slots[slot];
+            }
+
+          // Slot numbers of a pin's alt functions
+            table_view pin_view(pin_id p) const
+            {
+              return table_view{ all+p*number_of_alt_fns_per_pin
+                               , all+(p+1U)*number_of_alt_fns_per_pin
+                               };
+            }
+
+          // Slot numbers, in order, of the alt functions having a special
+          // function
+            std::uint16_t const * special_fn_begin(gpio_special_fn s) const
+            {
+              return by_special_fn+first[static_cast<std::size_t>(s)];
+            }
+
+            std::uint16_t const * special_fn_end(gpio_special_fn s) const
+            {
+              return by_special_fn+first[static_cast<std::size_t>(s)+1U];
+            }
+
+            table_view special_fn_view(gpio_special_fn s) const
+            {
+              return table_view{special_fn_begin(s), special_fn_end(s)};
+            }
+          };
+
+        // Built once, on first use
+          slot_indexes const & the_slot_indexes()
+          {
+            static slot_indexes const indexes
+                    { has_bcm2711_peripherals() ? rpi_processor::bcm2711
+                                                : rpi_processor::bcm2835
+                    };
+            return indexes;
+          }
+
           template <class PinSeqT, class Predicate>
           result_set make_results(PinSeqT pin_seq, Predicate add_pred)
           {
+            slot_indexes const & indexes(the_slot_indexes());
             result_set_builder results;
             for (auto p : pin_seq)
               {
                 for (std::size_t fn_idx{0U};fn_idx!=number_of_alt_fns_per_pin;++fn_idx)
                   {
-                    gpio_special_fn specl_fn{gpio_alt_fn_table[p][fn_idx]};
+                    gpio_special_fn specl_fn
+                      {indexes.specl_fn_of(p*number_of_alt_fns_per_pin+fn_idx)};
                     if ( add_pred(specl_fn) )
                       {
                         results.emplace_add(p, idx_to_alt_fn[fn_idx], specl_fn);
@@ -162,6 +323,36 @@ namespace dibase { namespace rpi {
             return result_set{results};
           }
 
+        // Results for a sequence of special functions using the reverse index
+        // rather than searching the whole table. Results are in the same pin
+        // then alt function order as for make_results.
+          template <class SpecialFnSeqT>
+          result_set make_special_fn_results(SpecialFnSeqT fn_seq)
+          {
+            slot_indexes const & indexes(the_slot_indexes());
+            std::uint16_t found[number_of_slots];
+            std::size_t count{0U};
+            auto const fn_begin(std::begin(fn_seq));
+            for (auto fn_it(fn_begin); fn_it!=std::end(fn_seq); ++fn_it)
+              {
+                if (std::find(fn_begin, fn_it, *fn_it)!=fn_it)
+                  { // Duplicate special function: already found
+                    continue;
+                  }
+                count = std::copy( indexes.special_fn_begin(*fn_it)
+                                 , indexes.special_fn_end(*fn_it)
+                                 , found+count
+                                 ) - found;
+              }
+            std::sort(found, found+count);
+            result_set_builder results;
+            for (std::size_t idx{0U}; idx!=count; ++idx)
+              {
+                results.add(slot_descriptor(found[idx]));
+              }
+            return result_set{results};
+          }
+
           class pin_id_range_iterator
           {
             pin_id        value;
@@ -233,6 +424,44 @@ namespace dibase { namespace rpi {
             }
         }
 
+        descriptor slot_descriptor(std::uint16_t slot)
+        {
+          return descriptor
+                  { pin_id{static_cast<pin_id_int_t>
+                                            (slot/number_of_alt_fns_per_pin)}
+                  , idx_to_alt_fn[slot%number_of_alt_fns_per_pin]
+                  , the_slot_indexes().specl_fn_of(slot)
+                  };
+        }
+
+        gpio_special_fn special_fn_of
+        ( pin_id p
+        , gpio_pin_fn a
+        , rpi_processor soc
+        )
+        {
+          auto const alt(std::find( std::begin(idx_to_alt_fn)
+                                  , std::end(idx_to_alt_fn), a
+                                  ));
+          return alt==std::end(idx_to_alt_fn)
+                  ? gpio_special_fn::no_fn
+                  : soc_special_fn( p
+                                  , static_cast<std::size_t>
+                                        (alt-std::begin(idx_to_alt_fn))
+                                  , soc
+                                  );
+        }
+
+        table_view view(pin_id p)
+        {
+          return the_slot_indexes().pin_view(p);
+        }
+
+        table_view view(gpio_special_fn s)
+        {
+          return the_slot_indexes().special_fn_view(s);
+        }
+
         result_set select(select_options opt)
         { return  make_results( pin_id_range{}
                               , [opt](gpio_special_fn spl_fn)
@@ -252,9 +481,9 @@ namespace dibase { namespace rpi {
         } 
 
         result_set select(gpio_special_fn s)
-        { return  make_results( pin_id_range{}
-                              , [s](gpio_special_fn spl_fn){return spl_fn==s;}
-                              );
+        {
+          return make_special_fn_results(std::initializer_list<gpio_special_fn>
+                                                                          {s});
         } 
 
         result_set select(pin_id p, gpio_special_fn s)
@@ -273,12 +502,8 @@ namespace dibase { namespace rpi {
         } 
 
         result_set select(std::initializer_list<gpio_special_fn> ss)
-        { return  make_results
-                  ( pin_id_range{}
-                  , [ss](gpio_special_fn spl_fn)
-                    { return std::find(ss.begin(),ss.end(),spl_fn)!=ss.end();
-                    }
-                  );
+        {
+          return make_special_fn_results(ss);
         } 
 
         result_set select(pin_id p, std::initializer_list<gpio_special_fn> ss)
@@ -16,7 +16,12 @@
 
 # include "gpio_registers.h"
 # include "pin_id.h"
+# include "rpi_revision.h"
 
+# include <algorithm>
+# include <cstdint>
+# include <iterator>
+# include <stdexcept>
 # include <vector>
 # include <initializer_list>
 
@@ -123,6 +128,36 @@ namespace dibase { namespace rpi {
         , arm_tck         ///< ARM JTAG Clock
         , arm_tdi         ///< ARM JTAG Data in
         , arm_tms         ///< ARM JTAG Mode select     
+        // BCM2711 only special functions, from section 5.3 of the BCM2711
+        // ARM Peripherals datasheet.
+        , sda3            ///< BSC master 3 data line
+        , scl3            ///< BSC master 3 clock line
+        , sda4            ///< BSC master 4 data line
+        , scl4            ///< BSC master 4 clock line
+        , sda5            ///< BSC master 5 data line
+        , scl5            ///< BSC master 5 clock line
+        , sda6            ///< BSC master 6 data line
+        , scl6            ///< BSC master 6 clock line
+        , spi3_ce0_n      ///< SPI3 Chip select 0
+        , spi3_ce1_n      ///< SPI3 Chip select 1
+        , spi3_miso       ///< SPI3 MISO
+        , spi3_mosi       ///< SPI3 MOSI
+        , spi3_sclk       ///< SPI3 Serial clock
+        , spi4_ce0_n      ///< SPI4 Chip select 0
+        , spi4_ce1_n      ///< SPI4 Chip select 1
+        , spi4_miso       ///< SPI4 MISO
+        , spi4_mosi       ///< SPI4 MOSI
+        , spi4_sclk       ///< SPI4 Serial clock
+        , spi5_ce0_n      ///< SPI5 Chip select 0
+        , spi5_ce1_n      ///< SPI5 Chip select 1
+        , spi5_miso       ///< SPI5 MISO
+        , spi5_mosi       ///< SPI5 MOSI
+        , spi5_sclk       ///< SPI5 Serial clock
+        , spi6_ce0_n      ///< SPI6 Chip select 0
+        , spi6_ce1_n      ///< SPI6 Chip select 1
+        , spi6_miso       ///< SPI6 MISO
+        , spi6_mosi       ///< SPI6 MOSI
+        , spi6_sclk       ///< SPI6 Serial clock
         };
 
       /// @brief Immutable type for values describing a pin's alternative
@@ -167,28 +202,57 @@ namespace dibase { namespace rpi {
           gpio_special_fn special_fn() const { return special_fn_; }
         };
 
+      /// @brief Number of alternative functions each GPIO pin has
+        constexpr std::size_t number_of_alt_fns_per_pin{6U};
+
+      /// @brief Maximum number of results of any query: one for each
+      /// alternative function of every GPIO pin.
+        constexpr std::size_t max_results
+                            {pin_id::number_of_pins*number_of_alt_fns_per_pin};
+
+        class result_set;
+
       /// @brief Mutable type used to build up results of pin alternative
       /// function queries
+      ///
+      /// Results are held in fixed capacity inline storage large enough
+      /// for the results of any query so building results does not allocate.
         class result_set_builder
         {
-          typedef std::vector<descriptor>   descriptor_container_type;
-          descriptor_container_type     items;
+        friend class result_set;
+
+          descriptor    items[max_results];
+          std::size_t   count;
 
         public:
         /// @brief Unsigned integral type for result_set_builder size values
-          typedef descriptor_container_type::size_type    size_type;
+          typedef std::size_t   size_type;
+
+        /// @brief Create empty
+          result_set_builder() : count{0U} {}
 
         /// @brief Number of result items held
         /// @returns Number of result items added to builder object
-          size_type size() const noexcept { return items.size(); }
+          size_type size() const noexcept { return count; }
 
         /// @brief True if no result items currently held
         /// @returns true if builder contains no results, false if it does.
-          bool empty() const noexcept { return items.empty(); }
+          bool empty() const noexcept { return count==0U; }
 
         /// @brief Add copy of descriptor object to builder 
         /// @param d  Result object to add  copy of to builder object
-          void add(descriptor const & d) { items.push_back(d); }
+        /// @throws std::length_error if max_results items are already held.
+          void add(descriptor const & d)
+          {
+            if (count==max_results)
+              {
+                throw std::length_error
+                        { "pin_alt_fn::result_set_builder::add: builder "
+                          "is full."
+                        };
+              }
+            items[count++] = d;
+          }
 
         /// @brief Add descriptor object constructed in place to builder
         /// @param p  Pin id of GPIO pin alt function of the descriptor
@@ -196,39 +260,46 @@ namespace dibase { namespace rpi {
         /// @param s  Special function value of the descriptor.
         /// @throws std::invalid_argument if #gpio_pin_fn argument is 
         ///         gpio_pin_fn::input or gpio_pin_fn::output.
+        /// @throws std::length_error if max_results items are already held.
           void emplace_add(pin_id p, gpio_pin_fn a, gpio_special_fn s)
           {
-            items.emplace_back(p,a,s);
+            add(descriptor{p,a,s});
           }
 
         /// @brief Drain builder contents into a \b std::vector
+        ///
+        /// Unlike constructing a result_set this allocates storage for the
+        /// drained items.
         /// @post empty()==true.
         /// @returns  \b std::vector\< \ref descriptor \b \> containing builder
         ///           object's contained items.
-          descriptor_container_type drain()
+          std::vector<descriptor> drain()
           {
-            descriptor_container_type vessel;
-            items.swap(vessel);
+            std::vector<descriptor> vessel(items, items+count);
+            count = 0U;
             return vessel;
           }
         };
 
       /// @brief Immutable type used to present results of pin alternative
       /// function queries
+      ///
+      /// As for result_set_builder, results are held in fixed capacity inline
+      /// storage so queries do not allocate.
         class result_set
         {
-          typedef std::vector<descriptor>   descriptor_container_type;
-          descriptor_container_type     items;
+          descriptor    items[max_results];
+          std::size_t   count;
 
         public:
         /// @brief Unsigned integral type for result_set size values
-          typedef descriptor_container_type::size_type        size_type;
+          typedef std::size_t         size_type;
 
         /// @brief Type of references to constant result_set elements
-          typedef descriptor_container_type::const_reference  const_reference;
+          typedef descriptor const &  const_reference;
 
         /// @brief Type of constant iterators into the result_set
-          typedef descriptor_container_type::const_iterator   const_iterator;
+          typedef descriptor const *  const_iterator;
 
         /// @brief Create from result_set_builder.
         ///
@@ -236,16 +307,19 @@ namespace dibase { namespace rpi {
         /// @post b.empty()==true
         /// @param  b   Builder object containing the descriptor results
           explicit result_set( result_set_builder & b )
-          : items{b.drain()}
-          {}
+          : count{b.count}
+          {
+            std::copy(b.items, b.items+b.count, items);
+            b.count = 0U;
+          }
 
         /// @brief Number of result items held
         /// @returns Number of descriptor items in result set
-          size_type size() const noexcept { return items.size(); }
+          size_type size() const noexcept { return count; }
 
         /// @brief True if no result items currently held
         /// @returns true if result set contains no items, false if it does.
-          bool empty() const noexcept { return items.empty(); }
+          bool empty() const noexcept { return count==0U; }
 
         /// @brief Element access, not bounds checked
         ///
@@ -258,27 +332,155 @@ namespace dibase { namespace rpi {
         /// @param n  Zero-based index of item in result set.
         /// @returns Reference to item at index \b n. 
         /// @throws std::out_of_range if \b n >= size().
-          const_reference at(size_type n) const { return items.at(n); }
+          const_reference at(size_type n) const
+          {
+            if (n>=count)
+              {
+                throw std::out_of_range
+                        { "pin_alt_fn::result_set::at: index out of range."
+                        };
+              }
+            return items[n];
+          }
 
         /// @brief Iterator for constant access to first result
         /// @returns Iterator to first result item in result set or end()
         ///          if empty()==true.
-          const_iterator begin() const noexcept { return items.begin(); }
+          const_iterator begin() const noexcept { return items; }
 
         /// @brief Constant iterator to one past the last result
         /// @returns Iterator to one past the last item in result set
-          const_iterator end() const noexcept { return items.end(); }
+          const_iterator end() const noexcept { return items+count; }
 
         /// @brief Iterator for constant access to first result
         /// @returns Iterator to first result item in result set or end()
         ///          if empty()==true.
-          const_iterator cbegin() const noexcept { return items.cbegin(); }
+          const_iterator cbegin() const noexcept { return begin(); }
 
         /// @brief Constant iterator to one past the last result
         /// @returns Iterator to one past the last item in result set
-          const_iterator cend() const noexcept { return items.cend(); }
+          const_iterator cend() const noexcept { return end(); }
+        };
+
+      /// @brief Return the special function of a GPIO pin alternative function
+      /// on a given SoC.
+      ///
+      /// The BCM2836 and BCM2837 have the same alternative functions as the
+      /// BCM2835. The BCM2711 adds the BSC3 to BSC6 and SPI3 to SPI6 functions
+      /// and moves the BSC slave functions from pins 18 to 21 to pins 8 to 11.
+      /// Other BCM2711 differences are not described.
+      ///
+      /// The select and view functions describe the running SoC's
+      /// alternative functions, as determined on first use.
+      /// @param p    GPIO pin
+      /// @param a    Alt function of GPIO pin, gpio_pin_fn::alt0...alt5
+      /// @param soc  Processor to return the special function for
+      /// @returns Special function, gpio_special_fn::no_fn if none or if a is
+      ///          not an alt function value.
+        gpio_special_fn special_fn_of
+        ( pin_id p
+        , gpio_pin_fn a
+        , rpi_processor soc
+        );
+
+      /// @brief Return the descriptor for a slot of the alternative function
+      /// table.
+      /// @param slot Slot number: pin id * number_of_alt_fns_per_pin + alt
+      ///             function index (0 for alt0 ... 5 for alt5). NOT range
+      ///             checked.
+      /// @returns Descriptor for slot, which may have gpio_special_fn::no_fn.
+        descriptor slot_descriptor(std::uint16_t slot);
+
+      /// @brief Immutable view of a sequence of alternative function table
+      /// slots.
+      ///
+      /// Views refer directly to static data so are cheap to copy and never
+      /// allocate. Iterators yield descriptor values.
+        class table_view
+        {
+          std::uint16_t const * first;
+          std::uint16_t const * last;
+
+        public:
+        /// @brief Forward iterator over the view's descriptors
+          class const_iterator
+          : public std::iterator< std::forward_iterator_tag
+                                , descriptor, std::ptrdiff_t
+                                , descriptor const *, descriptor
+                                >
+          {
+            std::uint16_t const * slot;
+
+          public:
+          /// @brief Create referring to a slot number
+          /// @param s  Pointer to slot number
+            explicit const_iterator(std::uint16_t const * s=nullptr)
+            : slot{s}
+            {}
+
+          /// @brief Return descriptor of slot referred to
+            descriptor operator*() const { return slot_descriptor(*slot); }
+
+          /// @brief Move to next slot
+            const_iterator & operator++() { ++slot; return *this; }
+
+          /// @brief Move to next slot
+            const_iterator operator++(int)
+            {
+              const_iterator tmp(*this);
+              ++slot;
+              return tmp;
+            }
+
+          /// @brief Iterators are equal if they refer to the same slot
+            bool operator==(const_iterator const & rhs) const
+            {
+              return slot==rhs.slot;
+            }
+
+          /// @brief Iterators are not equal if they refer to different slots
+            bool operator!=(const_iterator const & rhs) const
+            {
+              return slot!=rhs.slot;
+            }
+          };
+
+        /// @brief Create from a range of slot numbers
+        /// @param f  First slot number of view.
+        /// @param l  One past the last slot number of view.
+          table_view(std::uint16_t const * f, std::uint16_t const * l)
+          : first{f}
+          , last{l}
+          {}
+
+        /// @brief Number of descriptors in view
+          std::size_t size() const noexcept
+          {
+            return static_cast<std::size_t>(last-first);
+          }
+
+        /// @brief True if view has no descriptors
+          bool empty() const noexcept { return first==last; }
+
+        /// @brief Iterator to first descriptor
+          const_iterator begin() const noexcept {return const_iterator{first};}
+
+        /// @brief Iterator to one past the last descriptor
+          const_iterator end() const noexcept { return const_iterator{last}; }
         };
 
+      /// @brief View all of a pin's alternative functions
+      /// @param p  GPIO pin to view alternative functions of.
+      /// @returns  View of number_of_alt_fns_per_pin descriptors for
+      ///           alt0...alt5, including any having gpio_special_fn::no_fn.
+        table_view view(pin_id p);
+
+      /// @brief View the pin alternative functions having a special function
+      /// @param s  Special function to view pin alternative functions of.
+      /// @returns  View of descriptors, in pin then alternative function order,
+      ///           of pin alternative functions having special function s.
+        table_view view(gpio_special_fn s);
+
       /// @brief Options used with select function overloads
         enum class select_options
         { exclude_no_fn  ///< Exclude pin/alt fn that have no special function
@@ -0,0 +1,317 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_capture.cpp
+/// @brief DMA sampled GPIO level capture and run-length encoding
+/// implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "gpio_capture.h"
+#include "gplev_sampler.h"
+#include "system_timer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ios>
+#include <stdexcept>
+#include <thread>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+      char const rle_magic[8]{'D','B','G','P','C','A','P','1'};
+
+    // Most bytes an unsigned LEB128 encoding of a 64-bit value takes
+      std::size_t const max_leb128_bytes{10U};
+
+    // Samples a capture allows for DMA and system timer skew when deciding
+    // if unread samples were overwritten.
+      std::size_t const overwrite_margin{gpio_capture::buffer_samples/8U};
+
+    // Longest time a capture sleeps between reading samples.
+      std::chrono::milliseconds const max_sleep{10};
+
+      void write_checked(std::ostream & out, char const * data, std::size_t n)
+      {
+        out.write(data, static_cast<std::streamsize>(n));
+        if (!out)
+          {
+            throw std::ios_base::failure{"gpio_rle_writer: writing capture "
+                                         "stream failed."};
+          }
+      }
+
+      void write_u64(std::ostream & out, std::uint64_t value)
+      {
+        char bytes[8];
+        for (std::size_t idx=0; idx!=sizeof(bytes); ++idx)
+          {
+            bytes[idx] = static_cast<char>((value>>(8U*idx))&0xFFU);
+          }
+        write_checked(out, bytes, sizeof(bytes));
+      }
+
+      bool read_u64(std::istream & in, std::uint64_t & value)
+      {
+        unsigned char bytes[8];
+        if (!in.read(reinterpret_cast<char *>(bytes), sizeof(bytes)))
+          {
+            return false;
+          }
+        value = 0U;
+        for (std::size_t idx=0; idx!=sizeof(bytes); ++idx)
+          {
+            value |= std::uint64_t(bytes[idx])<<(8U*idx);
+          }
+        return true;
+      }
+
+      void write_leb128(std::ostream & out, std::uint64_t value)
+      {
+        char bytes[max_leb128_bytes];
+        std::size_t count{0U};
+        do
+          {
+            unsigned char byte{static_cast<unsigned char>(value&0x7FU)};
+            value >>= 7U;
+            if (value!=0U)
+              {
+                byte |= 0x80U;
+              }
+            bytes[count++] = static_cast<char>(byte);
+          }
+        while (value!=0U);
+        write_checked(out, bytes, count);
+      }
+
+    // Returns false if the stream is at its end before the first byte.
+      bool read_leb128(std::istream & in, std::uint64_t & value)
+      {
+        value = 0U;
+        for (std::size_t idx=0; idx!=max_leb128_bytes; ++idx)
+          {
+            std::istream::int_type const c{in.get()};
+            if (c==std::istream::traits_type::eof())
+              {
+                if (idx==0U)
+                  {
+                    return false;
+                  }
+                throw std::runtime_error{"gpio_rle_reader: capture stream "
+                                         "ends part way through a value."};
+              }
+            value |= std::uint64_t(c&0x7F)<<(7U*idx);
+            if ((c&0x80)==0)
+              {
+                return true;
+              }
+          }
+        throw std::runtime_error{"gpio_rle_reader: capture stream value is "
+                                 "too long."};
+      }
+    }
+
+    bool gpio_run_encoder::add(std::uint64_t sample, gpio_level_run & completed)
+    {
+      std::uint64_t const sample_levels{sample&mask};
+      if (length!=0U && sample_levels==levels)
+        {
+          ++length;
+          return false;
+        }
+      bool const have_run{flush(completed)};
+      levels = sample_levels;
+      length = 1U;
+      return have_run;
+    }
+
+    bool gpio_run_encoder::flush(gpio_level_run & completed)
+    {
+      if (length==0U)
+        {
+          return false;
+        }
+      completed.levels = levels;
+      completed.length = length;
+      length = 0U;
+      return true;
+    }
+
+    gpio_rle_writer::gpio_rle_writer
+    ( std::ostream & os
+    , gpio_capture_header const & header
+    )
+    : out(os)
+    , previous{0U}
+    {
+      write_checked(out, rle_magic, sizeof(rle_magic));
+      write_u64(out, header.sample_period_ps);
+      write_u64(out, header.pin_mask);
+      write_u64(out, header.start_us);
+    }
+
+    void gpio_rle_writer::write(gpio_level_run const & run)
+    {
+      write_leb128(out, run.levels^previous);
+      write_leb128(out, run.length);
+      previous = run.levels;
+    }
+
+    gpio_rle_reader::gpio_rle_reader(std::istream & is)
+    : in(is)
+    , hdr{0U, 0U, 0U}
+    , previous{0U}
+    {
+      char magic[sizeof(rle_magic)];
+      if ( !in.read(magic, sizeof(magic))
+        || std::memcmp(magic, rle_magic, sizeof(magic))!=0
+        || !read_u64(in, hdr.sample_period_ps)
+        || !read_u64(in, hdr.pin_mask)
+        || !read_u64(in, hdr.start_us)
+         )
+        {
+          throw std::runtime_error{"gpio_rle_reader: stream does not start "
+                                   "with a capture header."};
+        }
+    }
+
+    bool gpio_rle_reader::read(gpio_level_run & run)
+    {
+      std::uint64_t changes;
+      if (!read_leb128(in, changes))
+        {
+          return false;
+        }
+      std::uint64_t length;
+      if (!read_leb128(in, length))
+        {
+          throw std::runtime_error{"gpio_rle_reader: capture stream ends part "
+                                   "way through a run."};
+        }
+      if (length==0U)
+        {
+          throw std::runtime_error{"gpio_rle_reader: capture stream has a run "
+                                   "of no samples."};
+        }
+      previous ^= changes;
+      run.levels = previous;
+      run.length = length;
+      return true;
+    }
+
+    std::size_t const gpio_capture::buffer_samples;
+
+    gpio_capture::gpio_capture(hertz rate, std::uint64_t pin_mask)
+    : mask{pin_mask&all_gpio_pins}
+    {
+      if (mask==0U)
+        {
+          throw std::invalid_argument{"gpio_capture::gpio_capture: pin mask "
+                                      "selects no GPIO pins."};
+        }
+      sampler.reset(new internal::gplev_sampler
+                                      {rate, buffer_samples, "gpio_capture"});
+    }
+
+    gpio_capture::~gpio_capture()
+    {
+    }
+
+    f_hertz gpio_capture::sample_rate() const
+    {
+      return sampler->rate();
+    }
+
+    gpio_capture_header gpio_capture::capture
+    ( std::uint64_t samples
+    , run_sink const & sink
+    )
+    {
+      return capture_(samples, [](gpio_capture_header const &){}, sink);
+    }
+
+    gpio_capture_header gpio_capture::capture
+    ( std::uint64_t samples
+    , std::ostream & os
+    )
+    {
+      std::unique_ptr<gpio_rle_writer> writer;
+      return capture_( samples
+                     , [&writer, &os](gpio_capture_header const & header)
+                       {
+                         writer.reset(new gpio_rle_writer{os, header});
+                       }
+                     , [&writer](gpio_level_run const & run)
+                       {
+                         writer->write(run);
+                       }
+                     );
+    }
+
+    gpio_capture_header gpio_capture::capture_
+    ( std::uint64_t samples
+    , std::function<void(gpio_capture_header const &)> const & started
+    , std::function<void(gpio_level_run const &)> const & sink
+    )
+    {
+      std::chrono::microseconds const sleep_time
+        {std::min<std::chrono::microseconds>
+          ( std::chrono::microseconds{sampler->time_of(buffer_samples/4U)}
+          , max_sleep
+          )
+        };
+      std::uint64_t last_us{system_timer::now_us()};
+      std::size_t next{sampler->position()};
+      gpio_capture_header const header
+        { static_cast<std::uint64_t>(std::llround(1.0e12
+                                                  /sampler->rate().count()))
+        , mask
+        , sampler->start_us()
+          + sampler->time_of(internal::gplev_sample_number
+                              ( next
+                              , sampler->samples_in
+                                          (last_us-sampler->start_us())
+                              , buffer_samples
+                              ))
+        };
+      started(header);
+      gpio_run_encoder encoder{mask};
+      gpio_level_run run;
+      std::uint64_t remaining{samples};
+      while (remaining!=0U)
+        {
+          std::this_thread::sleep_for(sleep_time);
+          std::uint64_t const now_us{system_timer::now_us()};
+          std::size_t const pos{sampler->position()};
+          if (sampler->samples_in(now_us-last_us)+overwrite_margin
+                                                            >=buffer_samples)
+            {
+              throw std::runtime_error{"gpio_capture::capture: samples were "
+                                       "overwritten before being read."};
+            }
+          last_us = now_us;
+          while (next!=pos && remaining!=0U)
+            {
+              internal::register_t const volatile *
+                                          sample{sampler->sample(next)};
+              std::uint64_t const levels
+                          {sample[0]|(std::uint64_t(sample[1])<<32U)};
+              if (encoder.add(levels, run))
+                {
+                  sink(run);
+                }
+              next = (next+1U)%buffer_samples;
+              --remaining;
+            }
+        }
+      if (encoder.flush(run))
+        {
+          sink(run);
+        }
+      return header;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
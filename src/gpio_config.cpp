@@ -0,0 +1,294 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_config.cpp
+/// @brief Internal GPIO configuration register update type implementation and
+/// public GPIO configuration shadow control functions.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "gpio_config.h"
+#include "gpio_config_shadow.h"
+#include "gpio_ctrl.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      namespace
+      {
+        register_t const fsel_bits_per_pin{3U};
+        register_t const fsel_pins_per_reg{register_width/fsel_bits_per_pin};
+        register_t const fsel_field_mask{(1U<<fsel_bits_per_pin)-1U};
+      }
+
+      gpio_config::gpio_config(volatile gpio_registers * r)
+      : regs{r}
+      , shadowing{false}
+      {
+        for (auto & word : fsel)
+          {
+            word.store(0U, std::memory_order_relaxed);
+          }
+        for (auto & pair : detect)
+          {
+            pair[0].store(0U, std::memory_order_relaxed);
+            pair[1].store(0U, std::memory_order_relaxed);
+          }
+        for (auto & pair : pulls)
+          {
+            pair[0].store(0U, std::memory_order_relaxed);
+            pair[1].store(0U, std::memory_order_relaxed);
+          }
+      }
+
+      register_t volatile & gpio_config::detect_register
+      ( gpio_detect_enable which
+      , std::size_t bank
+      ) const
+      {
+        volatile one_bit_field_register * const pairs[]
+          { &regs->gpren, &regs->gpfen, &regs->gphen
+          , &regs->gplen, &regs->gparen, &regs->gpafen
+          };
+        return (*pairs[static_cast<unsigned>(which)])[bank];
+      }
+
+      void gpio_config::update
+      ( register_t volatile & reg
+      , std::atomic<register_t> & copy
+      , register_t mask
+      , register_t value
+      )
+      {
+        register_word_lock lock{&reg};
+        register_t const current{ is_shadowed()
+                                ? copy.load(std::memory_order_relaxed)
+                                : register_t(reg)
+                                };
+        register_t const updated{(current&~mask)|value};
+        reg = updated;
+        copy.store(updated, std::memory_order_relaxed);
+      }
+
+      void gpio_config::enable_shadow()
+      {
+        resync();
+        shadowing.store(true, std::memory_order_release);
+      }
+
+      void gpio_config::disable_shadow()
+      {
+        shadowing.store(false, std::memory_order_release);
+      }
+
+      void gpio_config::resync()
+      {
+        for (std::size_t idx=0U; idx!=fsel_words; ++idx)
+          {
+            register_word_lock lock{&regs->gpfsel[idx]};
+            fsel[idx].store(regs->gpfsel[idx], std::memory_order_relaxed);
+          }
+        for (unsigned which=0U; which!=number_of_gpio_detect_enables; ++which)
+          {
+            for (std::size_t bank=0U; bank!=2U; ++bank)
+              {
+                register_t volatile & reg
+                  (detect_register(gpio_detect_enable(which), bank));
+                register_word_lock lock{&reg};
+                detect[which][bank].store(reg, std::memory_order_relaxed);
+              }
+          }
+      }
+
+      void gpio_config::update_fsel
+      ( std::size_t idx
+      , register_t mask
+      , register_t value
+      )
+      {
+        update(regs->gpfsel[idx], fsel[idx], mask, value);
+      }
+
+      void gpio_config::set_pin_function(pin_id pinid, gpio_pin_fn fn)
+      {
+        register_t const shift{(pinid%fsel_pins_per_reg)*fsel_bits_per_pin};
+        update_fsel( pinid/fsel_pins_per_reg
+                   , fsel_field_mask<<shift
+                   , static_cast<register_t>(fn)<<shift
+                   );
+      }
+
+      gpio_pin_fn gpio_config::pin_function(pin_id pinid) const
+      {
+        std::size_t const idx{pinid/fsel_pins_per_reg};
+        register_t const word{ is_shadowed()
+                             ? fsel[idx].load(std::memory_order_relaxed)
+                             : register_t(regs->gpfsel[idx])
+                             };
+        return static_cast<gpio_pin_fn>
+                ( (word>>((pinid%fsel_pins_per_reg)*fsel_bits_per_pin))
+                & fsel_field_mask
+                );
+      }
+
+      void gpio_config::set_detect_enables
+      ( gpio_detect_enable which
+      , std::size_t bank
+      , register_t mask
+      , bool enable
+      )
+      {
+        update( detect_register(which, bank)
+              , detect[static_cast<unsigned>(which)][bank]
+              , mask
+              , enable ? mask : 0U
+              );
+      }
+
+      register_t gpio_config::detect_enables
+      ( gpio_detect_enable which
+      , std::size_t bank
+      ) const
+      {
+        return is_shadowed()
+                ? detect[static_cast<unsigned>(which)][bank].load
+                                                    (std::memory_order_relaxed)
+                : register_t(detect_register(which, bank));
+      }
+
+      void gpio_config::record_pulls
+      ( register_t bank0_mask
+      , register_t bank1_mask
+      , unsigned pull
+      )
+      {
+        register_t const masks[]{bank0_mask, bank1_mask};
+        for (std::size_t bank=0U; bank!=2U; ++bank)
+          {
+            for (unsigned state=0U; state!=number_of_gpio_pulls; ++state)
+              {
+                if (state==pull)
+                  {
+                    pulls[state][bank].fetch_or( masks[bank]
+                                               , std::memory_order_relaxed
+                                               );
+                  }
+                else
+                  {
+                    pulls[state][bank].fetch_and( ~masks[bank]
+                                                , std::memory_order_relaxed
+                                                );
+                  }
+              }
+          }
+      }
+
+      register_t gpio_config::fsel_mask
+      ( register_t const (&pins)[2]
+      , std::size_t idx
+      )
+      {
+        register_t mask{0U};
+        for (register_t field=0U; field!=fsel_pins_per_reg; ++field)
+          {
+            std::size_t const pin{idx*fsel_pins_per_reg+field};
+            if ( pin<pin_id::number_of_pins
+              && pins[pin/register_width]&(1U<<(pin%register_width))
+               )
+              {
+                mask |= fsel_field_mask<<(field*fsel_bits_per_pin);
+              }
+          }
+        return mask;
+      }
+
+      void gpio_config::capture
+      ( register_t const (&pins)[2]
+      , register_t (&fsels)[fsel_words]
+      , register_t (&detects)[number_of_gpio_detect_enables][2]
+      ) const
+      {
+        bool const shadowed{is_shadowed()};
+        for (std::size_t idx=0U; idx!=fsel_words; ++idx)
+          {
+            register_t const mask{fsel_mask(pins, idx)};
+            fsels[idx] = 0U;
+            if (mask)
+              {
+                fsels[idx] = mask & ( shadowed
+                                    ? fsel[idx].load(std::memory_order_relaxed)
+                                    : register_t(regs->gpfsel[idx])
+                                    );
+              }
+          }
+        for (unsigned which=0U; which!=number_of_gpio_detect_enables; ++which)
+          {
+            for (std::size_t bank=0U; bank!=2U; ++bank)
+              {
+                detects[which][bank] = pins[bank]
+                              ? pins[bank]&detect_enables
+                                            (gpio_detect_enable(which), bank)
+                              : 0U;
+              }
+          }
+      }
+
+      std::size_t gpio_config::restore
+      ( register_t const (&pins)[2]
+      , register_t const (&fsels)[fsel_words]
+      , register_t const (&detects)[number_of_gpio_detect_enables][2]
+      )
+      {
+        register_t current_fsels[fsel_words];
+        register_t current_detects[number_of_gpio_detect_enables][2];
+        capture(pins, current_fsels, current_detects);
+        std::size_t writes{0U};
+        for (std::size_t idx=0U; idx!=fsel_words; ++idx)
+          {
+            if (current_fsels[idx]!=fsels[idx])
+              {
+                update_fsel(idx, fsel_mask(pins, idx), fsels[idx]);
+                ++writes;
+              }
+          }
+        for (unsigned which=0U; which!=number_of_gpio_detect_enables; ++which)
+          {
+            for (std::size_t bank=0U; bank!=2U; ++bank)
+              {
+                if (current_detects[which][bank]!=detects[which][bank])
+                  {
+                    update( detect_register(gpio_detect_enable(which), bank)
+                          , detect[which][bank]
+                          , pins[bank]
+                          , detects[which][bank]
+                          );
+                    ++writes;
+                  }
+              }
+          }
+        return writes;
+      }
+    } // namespace internal closed
+
+    void enable_gpio_config_shadow()
+    {
+      internal::gpio_ctrl::instance().config.enable_shadow();
+    }
+
+    void disable_gpio_config_shadow()
+    {
+      internal::gpio_ctrl::instance().config.disable_shadow();
+    }
+
+    bool gpio_config_shadowed()
+    {
+      return internal::gpio_ctrl::instance().config.is_shadowed();
+    }
+
+    void resync_gpio_config_shadow()
+    {
+      internal::gpio_ctrl::instance().config.resync();
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,257 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_config.h
+/// @brief \b Internal : GPIO configuration register updates with an optional
+/// process local shadow copy.
+///
+/// Setting a pin's function or enabling edge detection read-modify-writes a
+/// GPFSELn or detect enable register word. Reads of uncached peripheral
+/// registers stall the CPU far longer than writes, which are posted. With
+/// shadowing enabled the last value this process wrote to each word is kept
+/// in ordinary memory, so an update is a store only and queries such as a
+/// pin's function need no register read at all.
+///
+/// The shadow is only kept consistent with changes made through a
+/// gpio_config object. If other processes, the kernel or the VideoCore may
+/// change the registers then resync() must be called before relying on it.
+///
+/// Pin pull up / down state cannot be read back from a BCM2835, so a
+/// gpio_config also records the pull last applied to each pin by this
+/// process: its logical pull state.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_GPIO_CONFIG_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_GPIO_CONFIG_H
+
+# include "gpio_registers.h"
+# include <atomic>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Enumeration of GPIO detect enable register pairs
+      enum class gpio_detect_enable : unsigned
+      { rising          ///< GPREN0,1
+      , falling         ///< GPFEN0,1
+      , high            ///< GPHEN0,1
+      , low             ///< GPLEN0,1
+      , async_rising    ///< GPAREN0,1
+      , async_falling   ///< GPAFEN0,1
+      };
+
+    /// @brief Number of GPIO detect enable register pairs
+      constexpr std::size_t number_of_gpio_detect_enables{6U};
+
+    /// @brief Number of GPIO pin pull states: none, up and down, indexed by
+    /// ipin::open_mode pull value.
+      constexpr std::size_t number_of_gpio_pulls{3U};
+
+    /// @brief Update GPIO configuration registers, optionally shadowed.
+    ///
+    /// Each update holds the register word's register_word_lock and always
+    /// writes both the register and the shadow word, whether or not shadowing
+    /// is enabled, so enabling shadowing never misses an update made by
+    /// another thread. When shadowing is enabled the current value is taken
+    /// from the shadow word rather than read from the register.
+      class gpio_config
+      {
+      public:
+      /// @brief Number of GPFSELn function select register words.
+        constexpr static std::size_t fsel_words = 6U;
+
+      private:
+
+        volatile gpio_registers *   regs;
+        std::atomic<bool>           shadowing;
+        std::atomic<register_t>     fsel[fsel_words];
+        std::atomic<register_t>     detect[number_of_gpio_detect_enables][2];
+        std::atomic<register_t>     pulls[number_of_gpio_pulls][2];
+
+        register_t volatile & detect_register
+        ( gpio_detect_enable which
+        , std::size_t bank
+        ) const;
+
+        void update
+        ( register_t volatile & reg
+        , std::atomic<register_t> & copy
+        , register_t mask
+        , register_t value
+        );
+
+      public:
+      /// @brief Construct for a mapped GPIO registers instance.
+      ///
+      /// Shadowing is initially disabled.
+      /// @param[in] r  GPIO registers to update. Must outlive this object.
+        explicit gpio_config(volatile gpio_registers * r);
+
+        gpio_config(gpio_config const &) = delete;
+        gpio_config & operator=(gpio_config const &) = delete;
+
+      /// @brief Copy the registers to the shadow and enable shadowing.
+        void enable_shadow();
+
+      /// @brief Disable shadowing: updates read-modify-write the registers.
+        void disable_shadow();
+
+      /// @brief Returns \c true if shadowing is enabled.
+        bool is_shadowed() const
+        {
+          return shadowing.load(std::memory_order_acquire);
+        }
+
+      /// @brief Re-read the shadowed registers into the shadow.
+      ///
+      /// Call after the registers may have been changed other than through
+      /// this object.
+        void resync();
+
+      /// @brief Update bits of a GPFSELn register word.
+      /// @param[in] idx    GPFSELn register index [0,5] (not range checked).
+      /// @param[in] mask   Bits to change.
+      /// @param[in] value  New values of bits in mask; bits outside mask
+      ///                   must be 0.
+        void update_fsel(std::size_t idx, register_t mask, register_t value);
+
+      /// @brief Set a GPIO pin's function.
+      /// @param[in] pinid  Id number of the GPIO pin.
+      /// @param[in] fn     Function to set the pin to.
+        void set_pin_function(pin_id pinid, gpio_pin_fn fn);
+
+      /// @brief Set the functions of several GPIO pins.
+      ///
+      /// As for gpio_registers::set_pin_functions each GPFSELn register
+      /// affected is updated once.
+      ///
+      /// @tparam InputIterator Iterator whose value_type is
+      ///                       gpio_pin_fn_setting.
+      /// @param[in]  first   Start of range of pin function settings.
+      /// @param[in]  last    One past end of range of pin function settings.
+        template <class InputIterator>
+        void set_pin_functions(InputIterator first, InputIterator last)
+        {
+          register_t const BitsPerPin{3};  // number of bits used for each pin
+          register_t const PinsPerReg{register_width/BitsPerPin};
+          register_t const MaxFnValue{(1U<<BitsPerPin)-1};
+
+          register_t fn_masks[fsel_words]{};
+          register_t fn_values[fsel_words]{};
+          for (; first!=last; ++first)
+            {
+              gpio_pin_fn_setting const & setting(*first);
+              std::size_t const reg_idx{setting.pin/PinsPerReg};
+              register_t const shift{(setting.pin%PinsPerReg)*BitsPerPin};
+              fn_masks[reg_idx] |= MaxFnValue<<shift;
+              fn_values[reg_idx] &= ~(MaxFnValue<<shift);
+              fn_values[reg_idx] |= static_cast<register_t>(setting.fn)<<shift;
+            }
+          for (std::size_t reg_idx=0; reg_idx!=fsel_words; ++reg_idx)
+            {
+              if ( fn_masks[reg_idx] )
+                {
+                  update_fsel(reg_idx, fn_masks[reg_idx], fn_values[reg_idx]);
+                }
+            }
+        }
+
+      /// @brief Returns a GPIO pin's function.
+      ///
+      /// Read from the shadow if shadowing is enabled, otherwise from the
+      /// GPFSELn register.
+      /// @param[in] pinid  Id number of the GPIO pin.
+        gpio_pin_fn pin_function(pin_id pinid) const;
+
+      /// @brief Set or clear bits of one word of a detect enable register
+      /// pair.
+      /// @param[in] which  Detect enable register pair.
+      /// @param[in] bank   0 for GPIO pins 0..31, 1 for GPIO pins 32..53.
+      /// @param[in] mask   Bits of pins to change.
+      /// @param[in] enable \c true to set the bits, \c false to clear them.
+        void set_detect_enables
+        ( gpio_detect_enable which
+        , std::size_t bank
+        , register_t mask
+        , bool enable
+        );
+
+      /// @brief Returns one word of a detect enable register pair.
+      ///
+      /// Read from the shadow if shadowing is enabled, otherwise from the
+      /// register.
+      /// @param[in] which  Detect enable register pair.
+      /// @param[in] bank   0 for GPIO pins 0..31, 1 for GPIO pins 32..53.
+        register_t detect_enables
+        ( gpio_detect_enable which
+        , std::size_t bank
+        ) const;
+
+      /// @brief Record the pull applied to several pins.
+      ///
+      /// Only updates the logical pull state: the pull sequence itself is
+      /// performed by the caller.
+      /// @param[in] bank0_mask Bit mask of GPIO pins 0..31 pulled.
+      /// @param[in] bank1_mask Bit mask of GPIO pins 32..53 pulled.
+      /// @param[in] pull       ipin::open_mode pull value applied: 0 for no
+      ///                       pull, 1 for pull up, 2 for pull down.
+        void record_pulls
+        ( register_t bank0_mask
+        , register_t bank1_mask
+        , unsigned pull
+        );
+
+      /// @brief Returns the pins of one bank recorded as having a pull.
+      ///
+      /// Pins never pulled by this process are in none of the masks.
+      /// @param[in] pull   ipin::open_mode pull value: 0 for no pull, 1 for
+      ///                   pull up, 2 for pull down.
+      /// @param[in] bank   0 for GPIO pins 0..31, 1 for GPIO pins 32..53.
+        register_t pulled_pins(unsigned pull, std::size_t bank) const
+        {
+          return pulls[pull][bank].load(std::memory_order_relaxed);
+        }
+
+      /// @brief Copy the function select and detect enable fields of some
+      /// pins.
+      ///
+      /// Read from the shadow if shadowing is enabled, otherwise from the
+      /// registers. Bits of fields for pins not in pins are zero.
+      /// @param[in]  pins    Bit masks of GPIO pins 0..31 and 32..53 to copy.
+      /// @param[out] fsels   GPFSEL0..5 fields of the pins.
+      /// @param[out] detects Detect enable bits of the pins, indexed by
+      ///                     gpio_detect_enable value then bank.
+        void capture
+        ( register_t const (&pins)[2]
+        , register_t (&fsels)[fsel_words]
+        , register_t (&detects)[number_of_gpio_detect_enables][2]
+        ) const;
+
+      /// @brief Set the function select and detect enable fields of some
+      /// pins to values returned by capture.
+      ///
+      /// Only register words in which a field of one of the pins differs are
+      /// written, each at most once.
+      /// @param[in] pins     Bit masks of GPIO pins 0..31 and 32..53 to set.
+      /// @param[in] fsels    GPFSEL0..5 fields of the pins.
+      /// @param[in] detects  Detect enable bits of the pins.
+      /// @returns Number of register words written.
+        std::size_t restore
+        ( register_t const (&pins)[2]
+        , register_t const (&fsels)[fsel_words]
+        , register_t const (&detects)[number_of_gpio_detect_enables][2]
+        );
+
+      /// @brief Returns the bit mask of the GPFSELn fields of some pins.
+      /// @param[in] pins Bit masks of GPIO pins 0..31 and 32..53.
+      /// @param[in] idx  GPFSELn register index [0,5] (not range checked).
+        static register_t fsel_mask
+        ( register_t const (&pins)[2]
+        , std::size_t idx
+        );
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_GPIO_CONFIG_H
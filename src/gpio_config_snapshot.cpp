@@ -0,0 +1,91 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_config_snapshot.cpp
+/// @brief GPIO pin configuration save and restore implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "gpio_config_snapshot.h"
+#include "gpio_ctrl.h"
+#include "gpio_pull.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using internal::register_width;
+
+    gpio_config_snapshot::gpio_config_snapshot
+    ( std::vector<pin_id> const & pins
+    )
+    : pin_masks{0U, 0U}
+    {
+      for (auto pin : pins)
+        {
+          pin_masks[pin/register_width] |= 1U<<(pin%register_width);
+        }
+      capture();
+    }
+
+    std::vector<pin_id> gpio_config_snapshot::pins() const
+    {
+      std::vector<pin_id> ids;
+      for (pin_id_int_t pin=0U; pin!=pin_id::number_of_pins; ++pin)
+        {
+          if (pin_masks[pin/register_width]&(1U<<(pin%register_width)))
+            {
+              ids.push_back(pin_id(pin));
+            }
+        }
+      return ids;
+    }
+
+    void gpio_config_snapshot::capture()
+    {
+      internal::gpio_config & config(internal::gpio_ctrl::instance().config);
+      config.capture(pin_masks, fsels, detects);
+      for (unsigned pull=0U; pull!=internal::number_of_gpio_pulls; ++pull)
+        {
+          for (std::size_t bank=0U; bank!=2U; ++bank)
+            {
+              pulls[pull][bank] = pin_masks[bank]
+                                & config.pulled_pins(pull, bank);
+            }
+        }
+    }
+
+    void gpio_config_snapshot::restore() const
+    {
+      internal::gpio_config & config(internal::gpio_ctrl::instance().config);
+      config.restore(pin_masks, fsels, detects);
+      for (unsigned pull=0U; pull!=internal::number_of_gpio_pulls; ++pull)
+        {
+          internal::apply_pull
+                    ( pulls[pull][0]&~config.pulled_pins(pull, 0U)
+                    , pulls[pull][1]&~config.pulled_pins(pull, 1U)
+                    , pull
+                    );
+        }
+    }
+
+    bool gpio_config_snapshot::covers(pin_id pin) const
+    {
+      return pin_masks[pin/register_width]&(1U<<(pin%register_width));
+    }
+
+    void gpio_config_snapshot::allocate_pins() const
+    {
+      std::vector<pin_id> const ids(pins());
+      internal::gpio_ctrl::instance().alloc.allocate_all( ids.data()
+                                                        , ids.size()
+                                                        );
+    }
+
+    void gpio_config_snapshot::deallocate_pins() const
+    {
+      std::vector<pin_id> const ids(pins());
+      internal::gpio_ctrl::instance().alloc.deallocate_all( ids.data()
+                                                          , ids.size()
+                                                          );
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -6,13 +6,48 @@
 /// @author Ralph E. McArdell
 
 #include "gpio_ctrl.h"
+#include "static_pin.h"
+#include <cstddef>
+#include <system_error>
+#include <unistd.h>
 
 namespace dibase { namespace rpi {
   namespace peripherals
   { namespace internal
     {
+      namespace
+      {
+        char const * gpiomem_pathname{"/dev/gpiomem"};
+
+      // Prefer the shared peripheral window. If that cannot be mapped, as
+      // when not running as root, fall back to the GPIO only /dev/gpiomem
+      // device, which maps the GPIO registers at offset 0. If neither can be
+      // used report the original /dev/mem failure.
+        phymem_ptr<volatile gpio_registers> map_gpio_registers()
+        {
+          try
+            {
+              return phymem_ptr<volatile gpio_registers>
+                      ( peripheral_window::instance()
+                      , gpio_registers::physical_address
+                      , register_block_size
+                      );
+            }
+          catch (std::system_error const &)
+            {
+              if (::access(gpiomem_pathname, R_OK|W_OK)!=0)
+                {
+                  throw;
+                }
+            }
+          return phymem_ptr<volatile gpio_registers>
+                  (gpiomem_pathname, 0, register_block_size);
+        }
+      }
+
       gpio_ctrl::gpio_ctrl()
-      : regs(gpio_registers::physical_address, register_block_size)
+      : regs(map_gpio_registers())
+      , config(regs.get())
       {}
 
       gpio_ctrl & gpio_ctrl::instance()
@@ -20,6 +55,25 @@ namespace dibase { namespace rpi {
         static gpio_ctrl gpio_control_area;
         return gpio_control_area;
       }
+
+      static_assert( offsetof(gpio_registers, gpset)
+                                  ==gpset0_word_offset*sizeof(register_t)
+                   , "gpset0_word_offset does not match gpio_registers layout"
+                   );
+      static_assert( offsetof(gpio_registers, gpclr)
+                                  ==gpclr0_word_offset*sizeof(register_t)
+                   , "gpclr0_word_offset does not match gpio_registers layout"
+                   );
+      static_assert( offsetof(gpio_registers, gplev)
+                                  ==gplev0_word_offset*sizeof(register_t)
+                   , "gplev0_word_offset does not match gpio_registers layout"
+                   );
+
+      std::uint32_t volatile * gpio_register_words()
+      {
+        return reinterpret_cast<std::uint32_t volatile *>
+                                        (gpio_ctrl::instance().regs.get());
+      }
     }
   }
 }}
@@ -11,6 +11,7 @@
 #include "phymem_ptr.h"
 #include "gpio_registers.h"
 #include "pin_alloc.h"
+#include "gpio_config.h"
 
 namespace dibase { namespace rpi {
   namespace peripherals
@@ -19,6 +20,11 @@ namespace dibase { namespace rpi {
     /// @brief GPIO control type. There is only ONE (yes it is a singleton!)
     /// Groups BCM2708/2835 GPIO control registers physical memory mapped area
     /// with a(GPIO) pin allocator - with one slot for each GPIO pin.
+    ///
+    /// The registers are viewed through the peripheral_window if /dev/mem
+    /// can be mapped, otherwise mapped from /dev/gpiomem if it is accessible
+    /// so processes without root privileges can still use GPIO pins. Other
+    /// peripherals still require /dev/mem.
       struct gpio_ctrl
       {
       /// @brief Pointer to BCM2708 / BCM2835 GPIO control registers instance
@@ -27,6 +33,11 @@ namespace dibase { namespace rpi {
       /// @brief (GPIO) pin allocator
         pin_allocator alloc;
 
+      /// @brief GPIO function select and detect enable register updates,
+      /// through the optional shadow copy. All such updates should be made
+      /// through config rather than regs to keep the shadow consistent.
+        gpio_config   config;
+
       /// @brief Singleton instance getter
       /// @returns THE instance of the GPIO pin control object.
         static gpio_ctrl & instance();
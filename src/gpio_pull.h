@@ -0,0 +1,49 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_pull.h
+/// @brief \b Internal : GPIO pin pull up/down sequencing function declarations
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_GPIO_PULL_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_GPIO_PULL_H
+
+# include "pin_id.h"
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Apply pull up, pull down or no pull to a single GPIO pin
+    ///
+    /// Performs the GPPUD / GPPUDCLK sequence described in section 6.1 of the
+    /// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+    /// Broadcom BCM2835 ARM Peripherals Datasheet</a>, or on a BCM2711 sets
+    /// the pin's field in the pull control registers with no waits.
+    ///
+    /// @param[in]  pin   Id of GPIO pin to apply pull mode to.
+    /// @param[in]  mode  ipin::open_mode value specifying pull mode.
+    /// @throws std::invalid_argument if mode requests both pull up and down.
+      void apply_pull(pin_id pin, unsigned mode);
+
+    /// @brief Apply the same pull up, pull down or no pull to several pins
+    ///
+    /// Performs a single GPPUD / GPPUDCLK sequence for all the pins specified
+    /// by the bank masks, so the sequence's waits are only incurred once no
+    /// matter how many pins are specified. On a BCM2711 the pull control
+    /// registers are written directly instead. Does nothing if no pins
+    /// specified.
+    ///
+    /// @param[in]  bank0_mask  Bit mask of GPIO pins 0..31 to apply mode to.
+    /// @param[in]  bank1_mask  Bit mask of GPIO pins 32..53 to apply mode to.
+    /// @param[in]  mode        ipin::open_mode value specifying pull mode.
+    /// @throws std::invalid_argument if mode requests both pull up and down.
+      void apply_pull( std::uint32_t bank0_mask
+                     , std::uint32_t bank1_mask
+                     , unsigned mode
+                     );
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_GPIO_PULL_H
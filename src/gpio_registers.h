@@ -15,6 +15,7 @@
 
 # include "peridef.h"
 # include "pin_id.h"
+# include "register_lock.h"
 
 namespace dibase { namespace rpi {
   namespace peripherals
@@ -52,6 +53,27 @@ namespace dibase { namespace rpi {
       , enable_pull_up_control    = 2   ///< Enable pull up control signal
       };
 
+    /// @brief Strongly typed enumeration of BCM2711 GPIO pull up/down
+    /// control register field values.
+    ///
+    /// The BCM2711 replaces the GPPUD / GPPUDCLKn sequence with registers
+    /// having a 2 bit field per pin that sets the pin's pull directly.
+      enum class gpio_pull_control : register_t
+      { none      = 0   ///< No pull up or pull down
+      , pull_up   = 1   ///< Pull up enabled
+      , pull_down = 2   ///< Pull down enabled
+      };
+
+    /// @brief A GPIO pin and the function it is to be set to.
+    ///
+    /// Used to specify the pins and functions for batch pin function setting.
+    /// See \ref gpio_registers::set_pin_functions.
+      struct gpio_pin_fn_setting
+      {
+        pin_id      pin;  ///< Id of GPIO pin whose function is to be set
+        gpio_pin_fn fn;   ///< Function to set GPIO pin to
+      };
+
     /// @brief Type representing register pairs for 1 bit per pin field groups
     ///
     /// There are 54 GPIO pins and many control registers have 1 bit per GPIO
@@ -60,7 +82,9 @@ namespace dibase { namespace rpi {
     /// pins 32..53 in the lower bits of GPxxx1. The one_bit_field_register
     /// type presents a united interface for such register pairs and provides
     /// commonly used functions that are required to perform various control
-    /// functions of the various registers.
+    /// functions of the various registers. The read-modify-write functions
+    /// set_bit, clear_bit, set_bits and clear_bits hold the register word's
+    /// register_word_lock so may be called by several threads at once.
       class one_bit_field_register
       {
         register_t reg[2];
@@ -76,6 +100,16 @@ namespace dibase { namespace rpi {
           return reg[index];
         }
 
+      /// @brief Subscript operator. Allows direct read of register pair array
+      ///
+      /// @param[in]  index Index of register in pair (0..1, not range checked).
+      /// @return value of the 32-bit register indicated by index. Undefined
+      ///         if index not 0 or 1.
+        register_t operator[](std::size_t index) volatile const
+        {
+          return reg[index];
+        }
+
       /// @brief Set a single bit to 1, leaving other bits as they were.
       ///
       /// Bits are in the range 0...63, but for GPIO pins only 0...53 should be
@@ -85,7 +119,9 @@ namespace dibase { namespace rpi {
       ///                       single value (0..63, not range checked).
         void set_bit( unsigned int bitnumber ) volatile
         {
-          reg[bitnumber/register_width] |= 1U<<(bitnumber%register_width);
+          register_t volatile & word(reg[bitnumber/register_width]);
+          register_word_lock lock{&word};
+          word |= 1U<<(bitnumber%register_width);
         }
 
       /// @brief Clear a single bit to 0, leaving other bits as they were.
@@ -97,7 +133,33 @@ namespace dibase { namespace rpi {
       ///                       single value (0..63, not range checked).
         void clear_bit( unsigned int bitnumber ) volatile
         {
-          reg[bitnumber/register_width] &= ~(1U<<(bitnumber%register_width));
+          register_t volatile & word(reg[bitnumber/register_width]);
+          register_word_lock lock{&word};
+          word &= ~(1U<<(bitnumber%register_width));
+        }
+
+      /// @brief Set all bits in mask to 1 in one word of the pair.
+      ///
+      /// Bits not set in mask are left as they were.
+      ///
+      /// @param[in]  index Index of register in pair (0..1, not range checked).
+      /// @param[in]  mask  Bits to set in the indexed register.
+        void set_bits( std::size_t index, register_t mask ) volatile
+        {
+          register_word_lock lock{&reg[index]};
+          reg[index] |= mask;
+        }
+
+      /// @brief Clear all bits in mask to 0 in one word of the pair.
+      ///
+      /// Bits not set in mask are left as they were.
+      ///
+      /// @param[in]  index Index of register in pair (0..1, not range checked).
+      /// @param[in]  mask  Bits to clear in the indexed register.
+        void clear_bits( std::size_t index, register_t mask ) volatile
+        {
+          register_word_lock lock{&reg[index]};
+          reg[index] &= ~mask;
         }
 
       /// @brief Set a single bit to 1; other bits in the same word set to 0
@@ -186,6 +248,8 @@ namespace dibase { namespace rpi {
         one_bit_field_register gppudclk; ///< GPIO pins pull-up/down enable clock (R/W)
         register_t reserved_do_not_use_b[4];  ///< Reserved, currently unused
         register_t test;              ///< Test Note: Only 4 bits wide (R/W)
+        register_t reserved_do_not_use_c[12]; ///< Reserved, currently unused
+        register_t gpio_pup_pdn_cntrl[4]; ///< BCM2711 only: pins pull control (R/W)
 
       /// @brief Set a GPIO pin's function.
       ///
@@ -195,6 +259,9 @@ namespace dibase { namespace rpi {
       /// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
       /// Broadcom BCM2835 ARM Peripherals Datasheet</a>, section 6.2.
       ///
+      /// The GPFSELn register is updated holding its register_word_lock so
+      /// several threads may set functions of pins at once.
+      ///
       /// @param[in]  pinid   Id number of the GPIO pin whose function is to be
       ///                     set.
       /// @param[in]  fn      Scoped enumeration of the required function.
@@ -205,8 +272,51 @@ namespace dibase { namespace rpi {
           register_t const MaxFnValue{(1U<<BitsPerPin)-1};
           
           register_t fn_value{ static_cast<register_t>(fn) };
-          gpfsel[pinid/PinsPerReg] &= ~(MaxFnValue<<((pinid%PinsPerReg)*BitsPerPin));
-          gpfsel[pinid/PinsPerReg] |=  fn_value<<((pinid%PinsPerReg)*BitsPerPin);
+          register_t const shift{(pinid%PinsPerReg)*BitsPerPin};
+          register_t volatile & word(gpfsel[pinid/PinsPerReg]);
+          register_word_lock lock{&word};
+          word = (word&~(MaxFnValue<<shift)) | (fn_value<<shift);
+        }
+
+      /// @brief Set the functions of several GPIO pins.
+      ///
+      /// Equivalent to calling \ref set_pin_function for each setting in the
+      /// range [first, last) but the settings are combined so that each
+      /// GPFSELn register affected is read once and written once. Should a pin
+      /// appear more than once in the range the last setting for it is used.
+      ///
+      /// @tparam InputIterator Iterator whose value_type is
+      ///                       gpio_pin_fn_setting.
+      /// @param[in]  first   Start of range of pin function settings.
+      /// @param[in]  last    One past end of range of pin function settings.
+        template <class InputIterator>
+        void set_pin_functions( InputIterator first, InputIterator last ) volatile
+        {
+          std::size_t const NumRegs{sizeof(gpfsel)/sizeof(gpfsel[0])};
+          register_t const BitsPerPin{3};  // number of bits used for each pin
+          register_t const PinsPerReg{register_width/BitsPerPin};
+          register_t const MaxFnValue{(1U<<BitsPerPin)-1};
+
+          register_t fn_masks[NumRegs]{};
+          register_t fn_values[NumRegs]{};
+          for (; first!=last; ++first)
+            {
+              gpio_pin_fn_setting const & setting(*first);
+              std::size_t const reg_idx{setting.pin/PinsPerReg};
+              register_t const shift{(setting.pin%PinsPerReg)*BitsPerPin};
+              fn_masks[reg_idx] |= MaxFnValue<<shift;
+              fn_values[reg_idx] &= ~(MaxFnValue<<shift);
+              fn_values[reg_idx] |= static_cast<register_t>(setting.fn)<<shift;
+            }
+          for (std::size_t reg_idx=0; reg_idx!=NumRegs; ++reg_idx)
+            {
+              if ( fn_masks[reg_idx] )
+                {
+                  register_word_lock lock{&gpfsel[reg_idx]};
+                  gpfsel[reg_idx] = (gpfsel[reg_idx]&~fn_masks[reg_idx])
+                                  | fn_values[reg_idx];
+                }
+            }
         }
 
       /// @brief Sets the single specified pin to a high (1, true, on) value.
@@ -225,6 +335,32 @@ namespace dibase { namespace rpi {
           gpclr.set_just_bit( pinid );
         }
 
+      /// @brief Sets all pins in one bank having a 1 bit in mask to high.
+      ///
+      /// Performs a single write of mask to GPSET0 or GPSET1. Pins with a 0
+      /// bit in mask are unaffected.
+      ///
+      /// @param[in]  bank  Index of register in pair: 0 for GPIO pins 0..31,
+      ///                   1 for GPIO pins 32..53 (not range checked).
+      /// @param[in]  mask  Bit mask of pins in bank to set high.
+        void set_pins( std::size_t bank, register_t mask ) volatile
+        {
+          gpset[bank] = mask;
+        }
+
+      /// @brief Clears all pins in one bank having a 1 bit in mask to low.
+      ///
+      /// Performs a single write of mask to GPCLR0 or GPCLR1. Pins with a 0
+      /// bit in mask are unaffected.
+      ///
+      /// @param[in]  bank  Index of register in pair: 0 for GPIO pins 0..31,
+      ///                   1 for GPIO pins 32..53 (not range checked).
+      /// @param[in]  mask  Bit mask of pins in bank to clear low.
+        void clear_pins( std::size_t bank, register_t mask ) volatile
+        {
+          gpclr[bank] = mask;
+        }
+
       /// @brief Return the low/high level of the single specified pin.
       ///
       /// @param[in]  pinid   Id number of the GPIO pin to get level of.
@@ -234,6 +370,18 @@ namespace dibase { namespace rpi {
           return gplev.get_bit(pinid);
         }
 
+      /// @brief Return the low/high levels of all pins in one bank.
+      ///
+      /// Performs a single read of GPLEV0 or GPLEV1.
+      ///
+      /// @param[in]  bank  Index of register in pair: 0 for GPIO pins 0..31,
+      ///                   1 for GPIO pins 32..53 (not range checked).
+      /// @return Value with bit n set if pin n of bank is high.
+        register_t pin_levels( std::size_t bank ) volatile const
+        {
+          return gplev[bank];
+        }
+
       /// @brief Return the event detection status of the single specified pin.
       ///
       /// @param[in]  pinid   Id number of the GPIO pin to get event status of.
@@ -252,6 +400,32 @@ namespace dibase { namespace rpi {
           gpeds.set_just_bit( pinid );
         }
 
+      /// @brief Return the event detection status of all pins in one bank.
+      ///
+      /// Performs a single read of GPEDS0 or GPEDS1.
+      ///
+      /// @param[in]  bank  Index of register in pair: 0 for GPIO pins 0..31,
+      ///                   1 for GPIO pins 32..53 (not range checked).
+      /// @return Value with bit n set if an event was detected for pin n of
+      ///         bank.
+        register_t pin_events( std::size_t bank ) volatile const
+        {
+          return gpeds[bank];
+        }
+
+      /// @brief Clear the event notifications of all pins in mask in one bank.
+      ///
+      /// Performs a single write of mask to GPEDS0 or GPEDS1. Event
+      /// notifications of pins with a 0 bit in mask are unaffected.
+      ///
+      /// @param[in]  bank  Index of register in pair: 0 for GPIO pins 0..31,
+      ///                   1 for GPIO pins 32..53 (not range checked).
+      /// @param[in]  mask  Bit mask of pins in bank to clear events for.
+        void clear_pin_events( std::size_t bank, register_t mask ) volatile
+        {
+          gpeds[bank] = mask;
+        }
+
       /// @brief Enable rising edge events for a single specified pin.
       ///
       /// @param[in]  pinid   Id number of the GPIO pin for which rising edge
@@ -360,6 +534,85 @@ namespace dibase { namespace rpi {
           gpafen.clear_bit( pinid );
         }
 
+      /// @brief Set the rising edge detect enables of all pins.
+      ///
+      /// Performs a single write to each of GPREN0 and GPREN1 - no
+      /// read-modify-write - so pins with a 0 bit in a mask are disabled.
+      ///
+      /// @param[in]  bank0 Bit mask of GPIO pins 0..31 to enable.
+      /// @param[in]  bank1 Bit mask of GPIO pins 32..53 to enable.
+        void set_rising_edge_detect( register_t bank0, register_t bank1 )
+        volatile
+        {
+          gpren[0] = bank0;
+          gpren[1] = bank1;
+        }
+
+      /// @brief Set the falling edge detect enables of all pins.
+      ///
+      /// Performs a single write to each of GPFEN0 and GPFEN1.
+      ///
+      /// @param[in]  bank0 Bit mask of GPIO pins 0..31 to enable.
+      /// @param[in]  bank1 Bit mask of GPIO pins 32..53 to enable.
+        void set_falling_edge_detect( register_t bank0, register_t bank1 )
+        volatile
+        {
+          gpfen[0] = bank0;
+          gpfen[1] = bank1;
+        }
+
+      /// @brief Set the high detect enables of all pins.
+      ///
+      /// Performs a single write to each of GPHEN0 and GPHEN1.
+      ///
+      /// @param[in]  bank0 Bit mask of GPIO pins 0..31 to enable.
+      /// @param[in]  bank1 Bit mask of GPIO pins 32..53 to enable.
+        void set_high_detect( register_t bank0, register_t bank1 ) volatile
+        {
+          gphen[0] = bank0;
+          gphen[1] = bank1;
+        }
+
+      /// @brief Set the low detect enables of all pins.
+      ///
+      /// Performs a single write to each of GPLEN0 and GPLEN1.
+      ///
+      /// @param[in]  bank0 Bit mask of GPIO pins 0..31 to enable.
+      /// @param[in]  bank1 Bit mask of GPIO pins 32..53 to enable.
+        void set_low_detect( register_t bank0, register_t bank1 ) volatile
+        {
+          gplen[0] = bank0;
+          gplen[1] = bank1;
+        }
+
+      /// @brief Set the async rising edge detect enables of all pins.
+      ///
+      /// Performs a single write to each of GPAREN0 and GPAREN1.
+      ///
+      /// @param[in]  bank0 Bit mask of GPIO pins 0..31 to enable.
+      /// @param[in]  bank1 Bit mask of GPIO pins 32..53 to enable.
+        void set_async_rising_edge_detect( register_t bank0, register_t bank1 )
+        volatile
+        {
+          gparen[0] = bank0;
+          gparen[1] = bank1;
+        }
+
+      /// @brief Set the async falling edge detect enables of all pins.
+      ///
+      /// Performs a single write to each of GPAFEN0 and GPAFEN1.
+      ///
+      /// @param[in]  bank0 Bit mask of GPIO pins 0..31 to enable.
+      /// @param[in]  bank1 Bit mask of GPIO pins 32..53 to enable.
+        void set_async_falling_edge_detect
+        ( register_t bank0
+        , register_t bank1
+        ) volatile
+        {
+          gpafen[0] = bank0;
+          gpafen[1] = bank1;
+        }
+
       /// @brief Set the pull up/down actualisation control mode.
       ///
       /// set_pull_up_down_mode has to be used in conjunction with
@@ -393,6 +646,24 @@ namespace dibase { namespace rpi {
           gppudclk.set_just_bit( pinid );
         }
 
+      /// @brief Assert the pull up/down clocks of several pins together.
+      ///
+      /// As \ref assert_pin_pull_up_down_clock but writes whole bit masks to
+      /// both GPPUDCLK0 and GPPUDCLK1 so that all pins with a 1 bit have their
+      /// pull up/down clock asserted at the same time. Must be used in the
+      /// same sequence as assert_pin_pull_up_down_clock.
+      ///
+      /// @param[in]  bank0_mask  Bit mask of GPIO pins 0..31 to assert clock.
+      /// @param[in]  bank1_mask  Bit mask of GPIO pins 32..53 to assert clock.
+        void assert_pins_pull_up_down_clock
+        ( register_t bank0_mask
+        , register_t bank1_mask
+        ) volatile
+        {
+          gppudclk[0] = bank0_mask;
+          gppudclk[1] = bank1_mask;
+        }
+
       /// @brief Remove all pin's pull up/down clock assertions.
       ///
       /// remove_all_pin_pull_up_down_clocks has to be used in conjunction with
@@ -406,6 +677,47 @@ namespace dibase { namespace rpi {
         {
           gppudclk.clear_all_bits();
         }
+
+      /// @brief Set the pull of several pins using the BCM2711 pull control
+      /// registers.
+      ///
+      /// Only for use on a BCM2711, which has no GPPUD / GPPUDCLKn sequence.
+      /// Each GPIO_PUP_PDN_CNTRL_REGn register has a 2 bit field for each of
+      /// 16 pins. The fields of pins with a 0 bit are left unchanged. Each
+      /// register is updated holding its register_word_lock.
+      ///
+      /// @param[in]  bank0_mask  Bit mask of GPIO pins 0..31 to set pull of.
+      /// @param[in]  bank1_mask  Bit mask of GPIO pins 32..53 to set pull of.
+      /// @param[in]  pull        Pull to set the pins to.
+        void set_pins_pull_control
+        ( register_t bank0_mask
+        , register_t bank1_mask
+        , gpio_pull_control pull
+        ) volatile
+        {
+          register_t const masks[]{bank0_mask, bank1_mask};
+          for (unsigned idx=0U; idx!=4U; ++idx)
+            {
+              register_t const pins{(masks[idx/2U]>>(16U*(idx%2U)))&0xFFFFU};
+              if (pins==0U)
+                {
+                  continue;
+                }
+              register_t field_mask{0U};
+              register_t fields{0U};
+              for (unsigned pin=0U; pin!=16U; ++pin)
+                {
+                  if (pins&(1U<<pin))
+                    {
+                      field_mask |= 3U<<(2U*pin);
+                      fields |= static_cast<register_t>(pull)<<(2U*pin);
+                    }
+                }
+              register_word_lock lock{&gpio_pup_pdn_cntrl[idx]};
+              gpio_pup_pdn_cntrl[idx]
+                            = (gpio_pup_pdn_cntrl[idx]&~field_mask)|fields;
+            }
+        }
       };
     } // namespace internal closed
   } // namespace peripherals closed
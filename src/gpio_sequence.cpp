@@ -0,0 +1,106 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_sequence.cpp
+/// @brief Precompiled GPIO output sequence implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "gpio_sequence.h"
+#include "gpio_ctrl.h"
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    constexpr std::uint32_t gpio_sequence::spin_us;
+
+    gpio_sequence::gpio_sequence
+    ( opin_group const & pins
+    , system_timer::duration step_interval
+    )
+    : group(pins)
+    , interval{step_interval}
+    {
+      if (step_interval.count()<0)
+        {
+          throw std::invalid_argument{"gpio_sequence: step interval is "
+                                      "negative."};
+        }
+    }
+
+    void gpio_sequence::append(pin_group_value_t mask, pin_group_value_t values)
+    {
+      if (mask&~group.all_pins())
+        {
+          throw std::invalid_argument{"gpio_sequence::append: mask has bits "
+                                      "set for pins not in the group."};
+        }
+      std::uint32_t set_banks[2];
+      std::uint32_t clear_banks[2];
+      group.to_bank_masks(mask&values, set_banks);
+      group.to_bank_masks(mask&~values, clear_banks);
+      masks.insert( masks.end()
+                  , {set_banks[0], set_banks[1], clear_banks[0], clear_banks[1]}
+                  );
+    }
+
+    void gpio_sequence::apply(std::size_t step) const
+    {
+      if (step>=size())
+        {
+          throw std::out_of_range{"gpio_sequence::apply: step is not a "
+                                  "sequence step index."};
+        }
+      std::uint32_t const * const step_masks{&masks[4U*step]};
+      auto & regs(internal::gpio_ctrl::instance().regs);
+      for (std::size_t bank=0; bank!=2; ++bank)
+        {
+          if (step_masks[bank])
+            {
+              regs->set_pins(bank, step_masks[bank]);
+            }
+          if (step_masks[2U+bank])
+            {
+              regs->clear_pins(bank, step_masks[2U+bank]);
+            }
+        }
+    }
+
+    void gpio_sequence::play_step
+    ( std::size_t step
+    , system_timer::time_point due
+    ) const
+    {
+      if (step>=size())
+        {
+          throw std::out_of_range{"gpio_sequence::play_step: step is not a "
+                                  "sequence step index."};
+        }
+      std::int64_t const due_us{due.time_since_epoch().count()};
+      std::int64_t const remaining_us
+                  {due_us-static_cast<std::int64_t>(system_timer::now_us())};
+      if (remaining_us>static_cast<std::int64_t>(spin_us))
+        {
+          std::this_thread::sleep_for
+                          (std::chrono::microseconds{remaining_us-spin_us});
+        }
+      while (static_cast<std::int64_t>(system_timer::now_us())<due_us)
+        {
+        }
+      apply(step);
+    }
+
+    system_timer::time_point gpio_sequence::play
+    (system_timer::time_point start) const
+    {
+      system_timer::time_point due{start};
+      for (std::size_t step=0; step!=size(); ++step, due += interval)
+        {
+          play_step(step, due);
+        }
+      return due;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
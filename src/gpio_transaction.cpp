@@ -0,0 +1,59 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_transaction.cpp
+/// @brief Coalesce GPIO output pin writes until committed : implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "gpio_transaction.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    gpio_transaction::gpio_transaction()
+    : batch{{0U, 0U}, {0U, 0U}}
+    , outer{internal::active_gpio_put_batch}
+    {
+      internal::active_gpio_put_batch = &batch;
+    }
+
+    gpio_transaction::~gpio_transaction()
+    {
+      internal::active_gpio_put_batch = outer;
+      commit();
+    }
+
+    void gpio_transaction::commit()
+    {
+      if (!pending())
+        {
+          return;
+        }
+      if (outer)
+        {
+          outer->add(batch);
+          discard();
+          return;
+        }
+      std::uint32_t volatile * words(internal::gpio_register_words());
+      for (std::size_t bank=0U; bank!=2U; ++bank)
+        {
+          if (batch.set_masks[bank])
+            {
+              words[internal::gpset0_word_offset+bank] = batch.set_masks[bank];
+            }
+          if (batch.clear_masks[bank])
+            {
+              words[internal::gpclr0_word_offset+bank]
+                                                    = batch.clear_masks[bank];
+            }
+        }
+      discard();
+    }
+
+    void gpio_transaction::discard()
+    {
+      batch = internal::gpio_put_batch{{0U, 0U}, {0U, 0U}};
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
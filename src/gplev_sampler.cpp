@@ -0,0 +1,269 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gplev_sampler.cpp
+/// @brief DMA sampling of GPIO pin levels implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "gplev_sampler.h"
+#include "dma_ctrl.h"
+#include "gpio_registers.h"
+#include "pwm_ctrl.h"
+#include "clock_parameters.h"
+#include "system_timer.h"
+#include "periexcept.h"
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      namespace
+      {
+        register_t const gplev0_bus_address
+                  { peripheral_bus_address(gpio_registers::physical_address)
+                  + static_cast<register_t>(offsetof(gpio_registers, gplev))
+                  };
+        register_t const pwm_fifo_bus_address
+                  { peripheral_bus_address(pwm_registers::physical_address)
+                  + static_cast<register_t>(offsetof(pwm_registers, fifo_in))
+                  };
+
+      // Delay control block lengths are limited to the 30 bit TXFR_LEN field
+        std::uint32_t const max_sample_ticks{0x3FFFFFFFU/sizeof(register_t)};
+
+      // Control blocks: each sample's copy and delay
+        std::size_t count_control_blocks(std::size_t samples)
+        {
+          return 2U*samples;
+        }
+
+      // Data words: GPLEV0, GPLEV1 per sample and the PWM FIFO word
+        std::size_t data_words(std::size_t samples)
+        {
+          return 2U*samples+1U;
+        }
+      }
+
+      std::size_t gplev_sampler_program_size(std::size_t samples)
+      {
+        return count_control_blocks(samples)*sizeof(dma_control_block)
+             + data_words(samples)*sizeof(register_t);
+      }
+
+      gplev_sampler_program compile_gplev_sampler
+      ( dma_region & region
+      , std::size_t samples
+      , std::uint32_t sample_ticks
+      )
+      {
+        if (samples==0U || sample_ticks==0U || sample_ticks>max_sample_ticks)
+          {
+            throw std::invalid_argument{"compile_gplev_sampler: samples or "
+                                        "sample_ticks is zero or sample_ticks "
+                                        "is too large."};
+          }
+        std::size_t const cb_count{count_control_blocks(samples)};
+        dma_control_block * cbs{region.allocate_control_blocks(cb_count)};
+        register_t * data{static_cast<register_t *>
+                            (region.allocate( data_words(samples)
+                                             *sizeof(register_t)
+                                            ).address
+                            )};
+        for (std::size_t idx=0; idx!=data_words(samples); ++idx)
+          {
+            data[idx] = 0U;
+          }
+        register_t * const fifo_word{data+2U*samples};
+        register_t const copy_ti{ dma_control_block::ti_no_wide_bursts
+                                | dma_control_block::ti_wait_resp
+                                | dma_control_block::ti_src_inc
+                                | dma_control_block::ti_dest_inc
+                                };
+        register_t const delay_ti{ dma_control_block::ti_no_wide_bursts
+                                 | dma_control_block::ti_wait_resp
+                                 | dma_control_block::ti_dest_dreq
+                                 | dma_control_block::ti_permap(dma_dreq::pwm)
+                                 };
+        std::size_t cb_idx{0U};
+        auto add_cb = [&]( register_t ti, register_t src, register_t dest
+                         , register_t length
+                         )
+                      {
+                        dma_control_block & cb(cbs[cb_idx]);
+                        cb.transfer_info = ti;
+                        cb.source_address = src;
+                        cb.dest_address = dest;
+                        cb.transfer_length = length;
+                        cb.stride = 0U;
+                        ++cb_idx;
+                        cb.next_control_block
+                            = region.bus_address(cbs+(cb_idx%cb_count));
+                        cb.reserved_do_not_use[0] = 0U;
+                        cb.reserved_do_not_use[1] = 0U;
+                      };
+        for (std::size_t sample=0; sample!=samples; ++sample)
+          {
+            add_cb( copy_ti, gplev0_bus_address
+                  , region.bus_address(data+2U*sample)
+                  , 2U*sizeof(register_t)
+                  );
+            add_cb( delay_ti, region.bus_address(fifo_word)
+                  , pwm_fifo_bus_address
+                  , static_cast<register_t>(sample_ticks*sizeof(register_t))
+                  );
+          }
+        return gplev_sampler_program{region.bus_address(cbs), data};
+      }
+
+      std::size_t gplev_sampler_position
+      ( register_t cb_bus
+      , register_t first_bus
+      , std::size_t samples
+      )
+      {
+        if (cb_bus<first_bus)
+          {
+            return 0U;
+          }
+        std::size_t const cb_idx{(cb_bus-first_bus)/sizeof(dma_control_block)};
+        if (cb_idx>=count_control_blocks(samples))
+          {
+            return 0U;
+          }
+      // While a sample's copy is current it may not have been written, while
+      // its delay is current it has.
+        return ((cb_idx+1U)/2U)%samples;
+      }
+
+      std::uint64_t gplev_sample_number
+      ( std::size_t pos
+      , std::uint64_t expected
+      , std::size_t size
+      )
+      {
+        std::uint64_t number{expected-expected%size+pos};
+        if (number>expected+size/2U && number>=size)
+          {
+            number -= size;
+          }
+        else if (number+size/2U<expected)
+          {
+            number += size;
+          }
+        return number;
+      }
+
+      namespace
+      {
+      // PWM clock: sample period is the PWM range in tenths of a microsecond
+        hertz const pwm_clock_source_frequency{megahertz{500U}};
+        hertz const pwm_clock_frequency{megahertz{10U}};
+      }
+
+      hertz const gplev_sampler::max_rate{megahertz{1U}};
+      std::uint64_t const gplev_sampler::ticks_per_us;
+
+      gplev_sampler::gplev_sampler
+      ( hertz rate
+      , std::size_t samples
+      , char const * owner
+      )
+      : program{0U, nullptr}
+      , ring_size{samples}
+      , pwm_range{0U}
+      , dma_channel{0U}
+      , start_time_us{0U}
+      {
+        if (rate.count()==0U || max_rate<rate)
+          {
+            throw std::invalid_argument{std::string{owner}+": sample rate not "
+                                        "in the range (0Hz, 1MHz]."};
+          }
+        if (samples==0U)
+          {
+            throw std::invalid_argument{std::string{owner}+": no samples."};
+          }
+        pwm_range = (pwm_clock_frequency.count()+rate.count()/2U)/rate.count();
+        std::size_t const code_size{gplev_sampler_program_size(samples)};
+        code.reset(new dma_arena{code_size});
+        dma_buffer const code_buffer
+                          {code->allocate(code_size, alignof(dma_control_block))};
+        dma_region region{ code_buffer.address, code_buffer.bus_address
+                         , code_buffer.size
+                         };
+        program = compile_gplev_sampler(region, samples, 1U);
+        pwm_ctrl & pwm(pwm_ctrl::instance());
+        pwm.set_clock(clock_parameters{ clock_source::plld
+                                      , pwm_clock_source_frequency
+                                      , clock_frequency{pwm_clock_frequency}
+                                      });
+        if (!pwm.alloc.allocate(0U))
+          {
+            throw bad_peripheral_alloc{std::string{owner}+": PWM channel 1 is "
+                                       "in use."};
+          }
+        if (!pwm.fifo_alloc.allocate(0U))
+          {
+            pwm.alloc.deallocate(0U);
+            throw bad_peripheral_alloc{std::string{owner}+": PWM FIFO is in "
+                                       "use."};
+          }
+        try
+          {
+            dma_channel = dma_ctrl::instance().allocate_channel();
+          }
+        catch (...)
+          {
+            pwm.fifo_alloc.deallocate(0U);
+            pwm.alloc.deallocate(0U);
+            throw;
+          }
+        pwm_channel const ch{pwm_channel::pwm_ch1};
+        pwm.regs->set_enable(ch, false);
+        pwm.regs->set_dma_enable(false);
+        pwm.regs->set_mode(ch, pwm_mode::serialiser);
+        pwm.regs->set_use_fifo(ch, true);
+        pwm.regs->set_range(ch, pwm_range);
+        pwm.regs->clear_fifo();
+        pwm.regs->set_dma_data_req_threshold(15U);
+        pwm.regs->set_dma_panic_threshold(15U);
+        pwm.regs->set_dma_enable(true);
+        pwm.regs->set_enable(ch, true);
+        volatile dma_channel_registers &
+                          dma(dma_ctrl::instance().regs->channel[dma_channel]);
+        dma.reset();
+        dma.start(program.first_bus);
+        start_time_us = system_timer::now_us();
+      }
+
+      gplev_sampler::~gplev_sampler()
+      {
+        dma_ctrl::instance().regs->channel[dma_channel].reset();
+        dma_ctrl::instance().deallocate_channel(dma_channel);
+        pwm_ctrl & pwm(pwm_ctrl::instance());
+        pwm.regs->set_enable(pwm_channel::pwm_ch1, false);
+        pwm.regs->set_dma_enable(false);
+        pwm.fifo_alloc.deallocate(0U);
+        pwm.alloc.deallocate(0U);
+      }
+
+      std::size_t gplev_sampler::position() const
+      {
+        return gplev_sampler_position
+                ( dma_ctrl::instance().regs->channel[dma_channel]
+                                                      .control_block_address
+                , program.first_bus
+                , ring_size
+                );
+      }
+
+      f_hertz gplev_sampler::rate() const
+      {
+        return f_hertz{double(pwm_clock_frequency.count())/pwm_range};
+      }
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
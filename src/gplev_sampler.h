@@ -0,0 +1,165 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gplev_sampler.h
+/// @brief \b Internal : DMA sampling of the GPIO pin level registers into a
+/// ring buffer at a fixed rate : type and function declarations.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_GPLEV_SAMPLER_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_GPLEV_SAMPLER_H
+
+# include "dma_arena.h"
+# include "clockdefs.h"
+# include <cstdint>
+# include <memory>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Locations within a compiled GPIO level sampling program.
+    ///
+    /// Each sample is the pair of GPLEV0, GPLEV1 register values, so sample n
+    /// occupies samples[2n] and samples[2n+1].
+      struct gplev_sampler_program
+      {
+        register_t                    first_bus;  ///< Bus address of first CB
+        register_t const volatile *   samples;    ///< Sample ring buffer
+      };
+
+    /// @brief Returns region bytes needed to compile a GPIO level sampling
+    /// program.
+    /// @param samples  Number of samples in the program's ring buffer.
+      std::size_t gplev_sampler_program_size(std::size_t samples);
+
+    /// @brief Compile a looping GPIO level sampling program.
+    ///
+    /// Each sample has a control block copying GPLEV0 and GPLEV1 to the
+    /// sample's place in the ring buffer followed by a delay control block
+    /// writing to the PWM FIFO paced by the PWM DREQ. The last delay links
+    /// back to the first control block.
+    ///
+    /// @param region       Region to allocate program memory from.
+    /// @param samples      Number of samples in the ring buffer.
+    /// @param sample_ticks PWM FIFO words, pacing ticks, per sample.
+    /// @returns Locations within the compiled program.
+    /// @throws std::invalid_argument if samples or sample_ticks is zero or
+    ///         sample_ticks is too large for one control block transfer.
+    /// @throws std::bad_alloc if region does not have enough space.
+      gplev_sampler_program compile_gplev_sampler
+      ( dma_region & region
+      , std::size_t samples
+      , std::uint32_t sample_ticks
+      );
+
+    /// @brief Returns the position in the ring buffer of the next sample a
+    /// running sampling program will write.
+    ///
+    /// Samples before the position, back to the last position returned, have
+    /// been written.
+    ///
+    /// @param cb_bus     DMA channel's current control block bus address.
+    /// @param first_bus  Bus address of the program's first control block.
+    /// @param samples    Number of samples in the ring buffer.
+      std::size_t gplev_sampler_position
+      ( register_t cb_bus
+      , register_t first_bus
+      , std::size_t samples
+      );
+
+    /// @brief Returns the sample number nearest expected that is at ring
+    /// position pos of a ring of size samples.
+    ///
+    /// Used to recover the number of a sample from its ring position and an
+    /// estimate based on elapsed time.
+      std::uint64_t gplev_sample_number
+      ( std::size_t pos
+      , std::uint64_t expected
+      , std::size_t size
+      );
+
+    /// @brief Runs a GPIO level sampling program from construction to
+    /// destruction.
+    ///
+    /// Samples are paced by the PWM controller, whose clock is set to 10MHz
+    /// so the sample period is a whole number of tenths of a microsecond, and
+    /// copied by one DMA channel. Both are reserved while the object exists.
+      class gplev_sampler
+      {
+        std::unique_ptr<dma_arena>  code;         ///< Program memory
+        gplev_sampler_program       program;      ///< Compiled program
+        std::size_t                 ring_size;    ///< Samples in ring buffer
+        std::uint32_t               pwm_range;    ///< PWM clocks per sample
+        std::size_t                 dma_channel;  ///< Running channel
+        std::uint64_t               start_time_us;///< System timer start time
+
+      public:
+      /// @brief Highest supported sample rate.
+        static hertz const max_rate;
+
+      /// @brief Compile the sampling program, reserve resources and start
+      /// sampling.
+      /// @param rate     Requested sample rate, (0Hz, max_rate]. The achieved
+      ///                 rate is 10MHz divided by a whole number.
+      /// @param samples  Number of samples in the ring buffer.
+      /// @param owner    Name of the using type for exception messages.
+      /// @throws std::invalid_argument if rate is out of range or samples is
+      ///         zero.
+      /// @throws peripheral_in_use if any PWM channel is in use.
+      /// @throws bad_peripheral_alloc if the PWM FIFO or a DMA channel are
+      ///         not available.
+      /// @throws std::system_error or std::bad_alloc if DMA memory cannot be
+      ///         obtained.
+        gplev_sampler(hertz rate, std::size_t samples, char const * owner);
+
+      /// @brief Stop sampling and release resources.
+        ~gplev_sampler();
+
+        gplev_sampler(gplev_sampler const &) = delete;
+        gplev_sampler& operator=(gplev_sampler const &) = delete;
+
+      /// @brief Returns the position of the next sample to be written.
+        std::size_t position() const;
+
+      /// @brief Returns GPLEV0, GPLEV1 values of the sample at a position.
+        register_t const volatile * sample(std::size_t pos) const
+        {
+          return program.samples+2U*pos;
+        }
+
+      /// @brief Returns number of samples in the ring buffer.
+        std::size_t size() const
+        {
+          return ring_size;
+        }
+
+      /// @brief Returns achieved sample rate.
+        f_hertz rate() const;
+
+      /// @brief Returns approximate number of samples taken in a time.
+        std::uint64_t samples_in(std::uint64_t us) const
+        {
+          return us*ticks_per_us/pwm_range;
+        }
+
+      /// @brief Returns approximate time in microseconds to take a number of
+      /// samples.
+        std::uint64_t time_of(std::uint64_t samples) const
+        {
+          return samples*pwm_range/ticks_per_us;
+        }
+
+      /// @brief Returns system timer time sampling started.
+        std::uint64_t start_us() const
+        {
+          return start_time_us;
+        }
+
+      /// @brief PWM clock ticks per microsecond.
+        static std::uint64_t const ticks_per_us = 10U;
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_GPLEV_SAMPLER_H
@@ -6,6 +6,7 @@
 /// @author Ralph E. McArdell
 
 #include "i2c_ctrl.h"
+#include "peripheral_range.h"
 
 namespace dibase { namespace rpi {
   namespace peripherals
@@ -17,6 +18,10 @@ namespace dibase { namespace rpi {
                 { i2c_registers::bsc0_physical_address
                 , i2c_registers::bsc1_physical_address
                 , i2c_registers::bsc2_physical_address
+                , i2c_registers::bsc3_physical_address
+                , i2c_registers::bsc4_physical_address
+                , i2c_registers::bsc5_physical_address
+                , i2c_registers::bsc6_physical_address
                 };
       }
 
@@ -24,12 +29,19 @@ namespace dibase { namespace rpi {
       {
         if (register_blocks[idx].get()==nullptr)
           {
-            register_blocks[idx] = reg_ptr( physical_addresses[idx]
+            register_blocks[idx] = reg_ptr( peripheral_window::instance()
+                                          , physical_addresses[idx]
                                           , register_block_size
                                           );
           }
         return register_blocks[idx];
       }
+
+      std::size_t i2c_ctrl::masters()
+      {
+        return has_bcm2711_peripherals() ? number_of_bsc_masters
+                                         : number_of_bcm2835_bsc_masters;
+      }
       
       i2c_ctrl & i2c_ctrl::instance()
       {
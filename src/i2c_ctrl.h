@@ -23,7 +23,12 @@ namespace dibase { namespace rpi {
     {
     /// @brief Number of BSC (I2C) master peripherals supported by the BCM2835
     ///  Note though that BSC2 is reserved for use with the HDMI device.
-      constexpr std::size_t number_of_bsc_masters{3};
+      constexpr std::size_t number_of_bcm2835_bsc_masters{3};
+
+    /// @brief Number of BSC (I2C) master peripherals supported by the BCM2711,
+    /// the most of any supported SoC: BSC0 to BSC2 as for the BCM2835 plus
+    /// BSC3 to BSC6.
+      constexpr std::size_t number_of_bsc_masters{7};
 
     /// @brief I2C control type. There is only 1 (yes it's a singleton!)
     ///
@@ -38,16 +43,23 @@ namespace dibase { namespace rpi {
       /// @brief Function returning (smart) pointer to BSC control registers
       ///
       /// @note
-      /// Register memory is only mapped into a process' memory on the
-      /// first access request for a specific BSC master's registers.
+      /// The view of a specific BSC master's registers in the shared
+      /// peripheral_window is only created on the first access request for
+      /// them.
       ///
       /// @param[in] idx    Index of the BSC master peripheral to return 
-      ///                   pointer to control register block to: 0, 1 or 2.<br>
+      ///                   pointer to control register block to: 0, 1 or 2,
+      ///                   or 3 to 6 on a BCM2711.<br>
       ///                   N.B. The value is \e not range checked.
       /// @returns Smart pointer to mapped block of physical memory of
       ///          BSC (I2C) master control memory mapped registers.
         reg_ptr & regs(std::size_t idx);
 
+      /// @brief Returns the number of BSC master peripherals the running SoC
+      /// has: number_of_bsc_masters on a BCM2711, otherwise
+      /// number_of_bcm2835_bsc_masters.
+        static std::size_t masters();
+
       /// @brief I2C BSC master peripheral allocator instance
         simple_allocator<number_of_bsc_masters>  alloc;
 
@@ -0,0 +1,131 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file i2c_device.cpp
+/// @brief I2C slave device with shadow register cache implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "i2c_device.h"
+#include <stdexcept>
+#include <string>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    constexpr std::size_t i2c_device::number_of_registers;
+
+    i2c_device::i2c_device
+    ( i2c_pins & p
+    , std::uint32_t addrs
+    , std::initializer_list<std::uint8_t> cached
+    )
+    : pins(p)
+    , address{addrs}
+    {
+      if (addrs>127U)
+        {
+          throw std::out_of_range{"i2c_device::i2c_device: Slave address "
+                                  "not in the range [0,127]."};
+        }
+      shadow.fill(0U);
+      for (auto reg : cached)
+        {
+          cacheable.set(reg);
+        }
+    }
+
+    void i2c_device::check(int state, char const * what)
+    {
+      if (state!=i2c_pins::goodbit)
+        {
+          pins.clear();
+          throw std::runtime_error
+                { std::string{"i2c_device::"}+what+": transaction failed"
+                  +((state&i2c_pins::noackowledgebit) ? ", no acknowledge"
+                                                      : "")
+                  +((state&i2c_pins::timeoutbit) ? ", clock stretch time out"
+                                                 : "")
+                  +"."
+                };
+        }
+    }
+
+    std::uint8_t i2c_device::read(std::uint8_t reg)
+    {
+      if (valid.test(reg))
+        {
+          return shadow[reg];
+        }
+      std::uint8_t value{0U};
+      check(pins.read_register(address, reg, &value, 1U), "read");
+      if (cacheable.test(reg))
+        {
+          shadow[reg] = value;
+          valid.set(reg);
+        }
+      return value;
+    }
+
+    void i2c_device::write(std::uint8_t reg, std::uint8_t value)
+    {
+      std::uint8_t const data[2]{reg, value};
+      check(pins.write_all(address, data, sizeof(data)), "write");
+      if (cacheable.test(reg))
+        {
+          shadow[reg] = value;
+          valid.set(reg);
+          dirty.reset(reg);
+        }
+    }
+
+    void i2c_device::modify
+    ( std::uint8_t reg
+    , std::uint8_t mask
+    , std::uint8_t bits
+    )
+    {
+      if (!cacheable.test(reg))
+        {
+          throw std::invalid_argument{"i2c_device::modify: register is not "
+                                      "cacheable."};
+        }
+      std::uint8_t const old_value{read(reg)};
+      std::uint8_t const new_value
+                    (static_cast<std::uint8_t>((old_value&~mask)|(bits&mask)));
+      if (new_value!=old_value)
+        {
+          shadow[reg] = new_value;
+          dirty.set(reg);
+        }
+    }
+
+    std::size_t i2c_device::flush()
+    {
+      std::size_t writes{0U};
+    // Register number followed by values of a run of registers
+      std::uint8_t data[number_of_registers+1U];
+      std::size_t reg{0U};
+      while (dirty.any())
+        {
+          while (!dirty.test(reg))
+            {
+              ++reg;
+            }
+          std::size_t const first{reg};
+          data[0] = static_cast<std::uint8_t>(first);
+          std::size_t count{1U};
+          while (reg!=number_of_registers && dirty.test(reg))
+            {
+              data[count++] = shadow[reg++];
+            }
+          check(pins.write_all(address, data, count), "flush");
+          for (std::size_t r=first; r!=reg; ++r)
+            {
+              dirty.reset(r);
+            }
+          ++writes;
+        }
+      return writes;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
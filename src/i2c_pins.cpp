@@ -10,7 +10,11 @@
 #include "gpio_ctrl.h"
 #include "i2c_ctrl.h"
 #include "periexcept.h"
+#include "peripheral_barrier.h"
+#include "trace_marker.h"
+#include <algorithm>
 #include <chrono>
+#include <iterator>
 #include <thread>
 
 namespace dibase { namespace rpi {
@@ -32,6 +36,9 @@ namespace dibase { namespace rpi {
     // range, with a 10kHz SCLK it may be up to around 150.
       std::uint32_t repeat_start_write_wait_count_max{10000U};
 
+    // Number of bytes the BSC FIFO holds
+      std::size_t const fifo_depth{16U};
+
       descriptor get_alt_fn_descriptor
       ( pin_id pin
       , std::initializer_list<gpio_special_fn> special_fns
@@ -58,6 +65,16 @@ namespace dibase { namespace rpi {
         return pin_fn_info[0];
       }
 
+      void check_bsc_available(int bsc_num)
+      {
+        if (bsc_num>=static_cast<int>(i2c_ctrl::masters()))
+          {
+            throw std::invalid_argument( "i2c_pins::i2c_pins: BSC3 to BSC6 "
+                                         "are only available on a BCM2711."
+                                       );
+          }
+      }
+
       void construct_common
       ( pin_id        sda_pin
       , pin_id        scl_pin
@@ -102,6 +119,7 @@ namespace dibase { namespace rpi {
         ctx_builder.set_clock_stretch_timeout(tout);
         ctx_builder.set_enable(true);
         ctx_builder.clear_fifo();
+        check_bsc_available(bsc_num);
         if (i2c_ctrl::instance().alloc.is_in_use(bsc_num))
           {
             throw bad_peripheral_alloc( "i2c_pins::i2c_pins: BSC peripheral is "
@@ -109,27 +127,27 @@ namespace dibase { namespace rpi {
                                       );
           }
         i2c_ctrl::instance().alloc.allocate(bsc_num);
-        int pin_alloc_count{0};
+        pin_id const pin_ids[]{sda_pin, scl_pin};
         try
         {
-          gpio_ctrl::instance().alloc.allocate(sda_pin); // CAN THROW
-          ++pin_alloc_count;
-          gpio_ctrl::instance().alloc.allocate(scl_pin); // CAN THROW
-          ++pin_alloc_count;
+          gpio_ctrl::instance().alloc.allocate_all(pin_ids, 2U); // CAN THROW
         }
         catch (...)
         { // Oops - failed to complete resource acquisition and initialisation;
         // Release resources allocated so far and re-throw
-          if (pin_alloc_count==1)
-            {
-              gpio_ctrl::instance().alloc.deallocate(sda_pin);
-            }
           i2c_ctrl::instance().alloc.deallocate(bsc_num);
           throw;
         }
         
-        gpio_ctrl::instance().regs->set_pin_function(sda_pin, sda_alt_fn);
-        gpio_ctrl::instance().regs->set_pin_function(scl_pin, scl_alt_fn);
+        internal::gpio_pin_fn_setting const pin_fns[]
+        { {sda_pin, sda_alt_fn}
+        , {scl_pin, scl_alt_fn}
+        };
+      // GPIO then BSC register accesses: barriers at each peripheral switch
+        peripheral_barrier();
+        gpio_ctrl::instance().config.set_pin_functions
+                                    (std::begin(pin_fns), std::end(pin_fns));
+        peripheral_barrier();
 
         i2c_ctrl::instance().regs(bsc_num)->clk_div = ctx_builder.clk_div;
         i2c_ctrl::instance().regs(bsc_num)->data_delay = ctx_builder.data_delay;
@@ -137,6 +155,7 @@ namespace dibase { namespace rpi {
         i2c_ctrl::instance().regs(bsc_num)->control = ctx_builder.control;
         i2c_ctrl::instance().regs(bsc_num)->clear_clock_timeout();
         i2c_ctrl::instance().regs(bsc_num)->clear_slave_ack_error();
+        peripheral_barrier();
       }
     }
 
@@ -189,6 +208,18 @@ namespace dibase { namespace rpi {
       return state;
     }
 
+    void i2c_pins::count_errors(int state)
+    {
+      if (state&timeoutbit)
+        {
+          counters.count(io_event::timeouts);
+        }
+      if (state&noackowledgebit)
+        {
+          counters.count(io_event::nacks);
+        }
+    }
+
     void i2c_pins::clear()
     {
       i2c_ctrl::instance().regs(bsc_idx)->clear_clock_timeout();
@@ -218,12 +249,48 @@ namespace dibase { namespace rpi {
 
     i2c_pins::~i2c_pins()
     {
+      release();
+    }
+
+    i2c_pins::i2c_pins(i2c_pins && other) noexcept
+    : pins(other.pins)
+    , bsc_idx(other.bsc_idx)
+    , waiting(other.waiting)
+    , wait_counts(other.wait_counts)
+    , counters(other.counters)
+    {
+      other.pins.fill(pin_not_used);
+    }
+
+    i2c_pins& i2c_pins::operator=(i2c_pins && other)
+    {
+      if (this!=&other)
+        {
+          release();
+          pins = other.pins;
+          bsc_idx = other.bsc_idx;
+          waiting = other.waiting;
+          wait_counts = other.wait_counts;
+          counters = other.counters;
+          other.pins.fill(pin_not_used);
+        }
+      return *this;
+    }
+
+    void i2c_pins::release()
+    {
+      if (pins[sda_idx]==pin_not_used)
+        { // Moved from: owns nothing
+          return;
+        }
       clear(); // Clear any error conditions
       i2c_ctrl::instance().regs(bsc_idx)->clear_fifo(); // also aborts transfer
       i2c_ctrl::instance().regs(bsc_idx)->set_enable(false);
+      enable_interrupts(false);
       i2c_ctrl::instance().alloc.deallocate(bsc_idx);
       gpio_ctrl::instance().alloc.deallocate(pin_id(pins[sda_idx]));
       gpio_ctrl::instance().alloc.deallocate(pin_id(pins[scl_idx]));
+      pins.fill(pin_not_used);
     }
 
     i2c_pins::i2c_pins
@@ -237,6 +304,19 @@ namespace dibase { namespace rpi {
     )
     {
       pins.fill(pin_id(pin_not_used)); 
+
+    // Pins supporting neither BSC0 nor BSC1 may support one of the BCM2711
+    // only BSC peripherals, each of which has its own pin pairs.
+      int const bcm2711_bsc{i2c_pin_pair_bsc(sda_pin, scl_pin)};
+      if (is_bcm2711_bsc(bcm2711_bsc))
+        {
+          construct( sda_pin, scl_pin, bcm2711_bsc
+                   , i2c_pin_alt_fn(sda_pin, bcm2711_bsc, i2c_line::sda)
+                   , i2c_pin_alt_fn(scl_pin, bcm2711_bsc, i2c_line::scl)
+                   , f, tout, fedl, redl, fc
+                   );
+          return;
+        }
     
     // Get each pin's alt function for its BSC/I2C special function.
     // Note: any of these can throw - but nothing allocated yet so OK
@@ -289,16 +369,28 @@ namespace dibase { namespace rpi {
     {
       pins.fill(pin_id(pin_not_used)); 
     
-      if (bsc_num!=0 && bsc_num!=1)
+      if (bsc_num!=0 && bsc_num!=1 && !is_bcm2711_bsc(bsc_num))
         {
           throw std::out_of_range
-                { "i2c_pins::i2c_pins: bsc_num parameter is not 0 or 1." };
+                { "i2c_pins::i2c_pins: bsc_num parameter is not 0, 1 or in "
+                  "the range [3,6]."
+                };
         }
- 
-      gpio_special_fn sda_fn
-                      {bsc_num==0?gpio_special_fn::sda0:gpio_special_fn::sda1};
-      gpio_special_fn scl_fn
-                      {bsc_num==0?gpio_special_fn::scl0:gpio_special_fn::scl1};
+      check_bsc_available(bsc_num);
+
+    // Indexed by bsc_num: BSC2 is not available for GPIO pins
+      gpio_special_fn const sda_fns[]
+      { gpio_special_fn::sda0, gpio_special_fn::sda1, gpio_special_fn::no_fn
+      , gpio_special_fn::sda3, gpio_special_fn::sda4, gpio_special_fn::sda5
+      , gpio_special_fn::sda6
+      };
+      gpio_special_fn const scl_fns[]
+      { gpio_special_fn::scl0, gpio_special_fn::scl1, gpio_special_fn::no_fn
+      , gpio_special_fn::scl3, gpio_special_fn::scl4, gpio_special_fn::scl5
+      , gpio_special_fn::scl6
+      };
+      gpio_special_fn sda_fn{sda_fns[bsc_num]};
+      gpio_special_fn scl_fn{scl_fns[bsc_num]};
 
     // Get each pin's alt function for its BSC/I2C special function.
     // Note: any of these can throw - but nothing allocated yet so OK
@@ -316,6 +408,32 @@ namespace dibase { namespace rpi {
       pins[scl_idx] = scl_pin;
     }
 
+    void i2c_pins::construct
+    ( pin_id        sda_pin
+    , pin_id        scl_pin
+    , int           bsc_num
+    , int           sda_alt
+    , int           scl_alt
+    , hertz         f
+    , std::uint16_t tout
+    , std::uint16_t fedl
+    , std::uint16_t redl
+    , hertz         fc
+    )
+    {
+      gpio_pin_fn const alt_fns[]
+      { gpio_pin_fn::alt0, gpio_pin_fn::alt1, gpio_pin_fn::alt2
+      , gpio_pin_fn::alt3, gpio_pin_fn::alt4, gpio_pin_fn::alt5
+      };
+      pins.fill(pin_id(pin_not_used));
+      construct_common( sda_pin, scl_pin, bsc_num, f, tout, fedl, redl, fc
+                      , alt_fns[sda_alt], alt_fns[scl_alt]
+                      );
+      bsc_idx = bsc_num;
+      pins[sda_idx] = sda_pin;
+      pins[scl_idx] = scl_pin;
+    }
+
     using internal::i2c_transfer_type;
 
     std::size_t i2c_pins::start_write
@@ -325,27 +443,53 @@ namespace dibase { namespace rpi {
     , std::size_t count
     )
     {
-      if (is_busy())
+      std::error_code ec;
+      std::size_t const bytes_written{start_write(addrs,dlen,pdata,count,ec)};
+      if (ec==std::errc::device_or_resource_busy)
         {
           throw std::logic_error
                   { "i2c_pins::start_write: Unable to start write transaction,"
                     " BSC/I2C peripheral is busy with an ongoing transaction." 
                   };
         }
-      if (!i2c_ctrl::instance().regs(bsc_idx)->set_slave_address(addrs))
+      if (ec && addrs>127U)
         {
             throw std::out_of_range
                     { "i2c_pins::start_write: "
                       "Slave address not in the range [0,127]." 
                     };
         }
-      if (!i2c_ctrl::instance().regs(bsc_idx)->set_data_length(dlen))
+      if (ec)
         {
             throw std::out_of_range
                     { "i2c_pins::start_write: Transaction "
                       "data length not in the range [0,65535]." 
                     };
         }
+      return bytes_written;
+    }
+
+    std::size_t i2c_pins::start_write
+    ( std::uint32_t addrs
+    , std::uint32_t dlen
+    , std::uint8_t const * pdata
+    , std::size_t count
+    , std::error_code & ec
+    ) noexcept
+    {
+      if (is_busy())
+        {
+          ec = std::make_error_code(std::errc::device_or_resource_busy);
+          return 0U;
+        }
+      if ( !i2c_ctrl::instance().regs(bsc_idx)->set_slave_address(addrs)
+        || !i2c_ctrl::instance().regs(bsc_idx)->set_data_length(dlen)
+         )
+        {
+          ec = std::make_error_code(std::errc::invalid_argument);
+          return 0U;
+        }
+      ec.clear();
       std::size_t bytes_written{0U};
       i2c_ctrl::instance().regs(bsc_idx)->set_transfer_type
                                           (i2c_transfer_type::write);
@@ -359,6 +503,7 @@ namespace dibase { namespace rpi {
             }
         }
       i2c_ctrl::instance().regs(bsc_idx)->start_transfer();
+      counters.count(io_event::bytes_written, bytes_written);
       return bytes_written;
     }
 
@@ -376,6 +521,7 @@ namespace dibase { namespace rpi {
               ++bytes_written;
             }
         }
+      counters.count(io_event::bytes_written, bytes_written);
       return bytes_written;
     }
 
@@ -446,12 +592,14 @@ namespace dibase { namespace rpi {
       i2c_ctrl::instance().regs(bsc_idx)->clear_transfer_done();
       i2c_ctrl::instance().regs(bsc_idx)->transmit_fifo_write(desc);
       i2c_ctrl::instance().regs(bsc_idx)->start_transfer();
+      counters.count(io_event::bytes_written);
       
       uint32_t count{0U};
       while (!is_busy())
         {
           if (++count>repeat_start_write_wait_count_max)
             {
+              counters.count(io_event::timeouts);
               return false;
             }
         }
@@ -469,6 +617,572 @@ namespace dibase { namespace rpi {
       return true;
     }
 
+    namespace
+    {
+      std::uint64_t deadline_after(system_timer::duration timeout)
+      {
+        return system_timer::now_us()
+             + static_cast<std::uint64_t>
+                        (std::max<system_timer::rep>(timeout.count(), 0));
+      }
+    }
+
+    int i2c_pins::write_all
+    ( std::uint32_t addrs
+    , std::uint8_t const * ptx
+    , std::size_t count
+    , system_timer::duration timeout
+    , std::size_t * pwritten
+    )
+    {
+      std::uint64_t const deadline_us{deadline_after(timeout)};
+      return write_all_until(addrs, ptx, count, pwritten, &deadline_us);
+    }
+
+    int i2c_pins::read_all
+    ( std::uint32_t addrs
+    , std::uint8_t * prx
+    , std::size_t count
+    , system_timer::duration timeout
+    , std::size_t * pread
+    )
+    {
+      std::uint64_t const deadline_us{deadline_after(timeout)};
+      return read_all_until(addrs, prx, count, pread, &deadline_us);
+    }
+
+    int i2c_pins::write_all_until
+    ( std::uint32_t addrs
+    , std::uint8_t const * ptx
+    , std::size_t count
+    , std::size_t * pwritten
+    , std::uint64_t const * pdeadline_us
+    )
+    {
+      internal::trace_scope trace{"i2c_pins write_all"};
+      if (pwritten)
+        {
+          *pwritten = 0U;
+        }
+      clear();
+      std::size_t written{start_write(addrs, count, ptx, count)};
+      auto & regs(i2c_ctrl::instance().regs(bsc_idx));
+      adaptive_wait waiter(waiting, wait_counts);
+      bool expired{false};
+      while (!regs->get_transfer_done())
+        { // When the FIFO is empty fill it without checking TXD each byte
+          std::size_t burst{0U};
+          if (written!=count)
+            {
+              burst = regs->get_tx_fifo_empty()
+                    ? std::min(count-written, fifo_depth)
+                    : regs->get_tx_fifo_not_full() ? 1U : 0U;
+            }
+          for (std::size_t idx=0; idx!=burst; ++idx)
+            {
+              regs->transmit_fifo_write(ptx[written++]);
+            }
+          if (burst==0U)
+            {
+              if (pdeadline_us && system_timer::now_us()>=*pdeadline_us)
+                {
+                  counters.count(io_event::timeouts);
+                  expired = true;
+                  break;
+                }
+              if (written!=count)
+                {
+                  counters.count(io_event::tx_fifo_full);
+                }
+              counters.count(io_event::wait_polls);
+              waiter.pause();
+            }
+          else
+            {
+              counters.count(io_event::bytes_written, burst);
+              waiter.restart();
+            }
+        }
+      if (pwritten)
+        {
+          *pwritten = written;
+        }
+      int const state{error_state()};
+      count_errors(state);
+      if (state!=goodbit || written!=count || expired)
+        {
+          abort();
+        }
+      regs->clear_transfer_done();
+      return ((state==goodbit && written!=count) ? incompletebit : state)
+           | (expired ? expiredbit : goodbit);
+    }
+
+    int i2c_pins::read_all_until
+    ( std::uint32_t addrs
+    , std::uint8_t * prx
+    , std::size_t count
+    , std::size_t * pread
+    , std::uint64_t const * pdeadline_us
+    )
+    {
+      internal::trace_scope trace{"i2c_pins read_all"};
+      if (pread)
+        {
+          *pread = 0U;
+        }
+      clear();
+      start_read(addrs, count);
+      auto & regs(i2c_ctrl::instance().regs(bsc_idx));
+      adaptive_wait waiter(waiting, wait_counts);
+      std::size_t received{0U};
+      bool expired{false};
+      while (received!=count)
+        { // When the FIFO is full empty it without checking RXD each byte
+          bool const done{regs->get_transfer_done()};
+          std::size_t const burst{ regs->get_rx_fifo_full()
+                                 ? std::min(count-received, fifo_depth)
+                                 : regs->get_rx_fifo_not_empty() ? 1U : 0U
+                                 };
+          for (std::size_t idx=0; idx!=burst; ++idx)
+            {
+              prx[received++] = regs->receive_fifo_read();
+            }
+          if (burst==0U)
+            {
+              if (done)
+                {
+                  break;
+                }
+              if (pdeadline_us && system_timer::now_us()>=*pdeadline_us)
+                {
+                  counters.count(io_event::timeouts);
+                  expired = true;
+                  break;
+                }
+              counters.count(io_event::rx_fifo_empty);
+              counters.count(io_event::wait_polls);
+              waiter.pause();
+            }
+          else
+            {
+              counters.count(io_event::bytes_read, burst);
+              waiter.restart();
+            }
+        }
+      if (pread)
+        {
+          *pread = received;
+        }
+      int const state{error_state()};
+      count_errors(state);
+      if (state!=goodbit || received!=count)
+        {
+          abort();
+        }
+      regs->clear_transfer_done();
+      return ((state==goodbit && received!=count) ? incompletebit : state)
+           | (expired ? expiredbit : goodbit);
+    }
+
+    int i2c_pins::write_then_read
+    ( std::uint32_t addrs
+    , std::uint8_t const * ptx
+    , std::size_t tx_count
+    , std::uint8_t * prx
+    , std::size_t rx_count
+    , std::size_t * pread
+    )
+    {
+      using internal::i2c_registers;
+
+      internal::trace_scope trace{"i2c_pins write_then_read"};
+      if (is_busy())
+        {
+          throw std::logic_error
+                  { "i2c_pins::write_then_read: Unable to start transaction,"
+                    " BSC/I2C peripheral is busy with an ongoing transaction."
+                  };
+        }
+      if (tx_count==0U || tx_count>fifo_depth)
+        {
+            throw std::out_of_range
+                    { "i2c_pins::write_then_read: Write "
+                      "data length not in the range [1,16]."
+                    };
+        }
+      if (rx_count>i2c_registers::dlen_mask)
+        {
+            throw std::out_of_range
+                    { "i2c_pins::write_then_read: Read "
+                      "data length not in the range [0,65535]."
+                    };
+        }
+      auto & regs(i2c_ctrl::instance().regs(bsc_idx));
+      if (!regs->set_slave_address(addrs))
+        {
+            throw std::out_of_range
+                    { "i2c_pins::write_then_read: "
+                      "Slave address not in the range [0,127]."
+                    };
+        }
+      if (pread)
+        {
+          *pread = 0U;
+        }
+      return combined_transfer(ptx, tx_count, prx, rx_count, pread, true);
+    }
+
+    int i2c_pins::combined_transfer
+    ( std::uint8_t const * ptx
+    , std::size_t tx_count
+    , std::uint8_t * prx
+    , std::size_t rx_count
+    , std::size_t * pread
+    , bool clean
+    )
+    {
+      auto & regs(i2c_ctrl::instance().regs(bsc_idx));
+      if (clean)
+        {
+          clear();
+          regs->clear_fifo();
+        }
+      regs->set_data_length(tx_count);
+      regs->set_transfer_type(i2c_transfer_type::write);
+      regs->clear_transfer_done();
+      for (std::size_t idx=0; idx!=tx_count; ++idx)
+        {
+          regs->transmit_fifo_write(ptx[idx]);
+        }
+      regs->start_transfer();
+      counters.count(io_event::bytes_written, tx_count);
+
+      std::uint32_t count{0U};
+      while (!is_busy())
+        {
+          if (++count>repeat_start_write_wait_count_max)
+            {
+              counters.count(io_event::timeouts);
+              abort();
+              int const state{error_state()};
+              return state==goodbit ? incompletebit : state;
+            }
+        }
+      regs->set_data_length(rx_count);
+      regs->set_transfer_type(i2c_transfer_type::read);
+      regs->start_transfer();
+    // Written bytes share the FIFO so must have been sent before reading
+    // received bytes, which only start to arrive after the repeated start.
+      adaptive_wait waiter(waiting, wait_counts);
+      while (!regs->get_tx_fifo_empty() && !regs->get_transfer_done())
+        {
+          counters.count(io_event::wait_polls);
+          waiter.pause();
+        }
+      waiter.restart();
+    // Finish once DONE is seen with the read no longer active (or all bytes
+    // received), so a DONE left over from the write phase does not end the
+    // read early. Bytes still in the FIFO are drained after DONE is seen.
+      std::size_t received{0U};
+      for (;;)
+        {
+          std::size_t const received_before{received};
+          bool const done{ regs->get_transfer_done()
+                        && (received==rx_count || !is_busy())
+                         };
+          while (received!=rx_count && regs->get_rx_fifo_not_empty())
+            {
+              prx[received++] = regs->receive_fifo_read();
+            }
+          counters.count(io_event::bytes_read, received-received_before);
+          if (done)
+            {
+              break;
+            }
+          if (received==received_before)
+            {
+              counters.count(io_event::rx_fifo_empty);
+              counters.count(io_event::wait_polls);
+              waiter.pause();
+            }
+          else
+            {
+              waiter.restart();
+            }
+        }
+      if (pread)
+        {
+          *pread = received;
+        }
+      int const state{error_state()};
+      count_errors(state);
+      if (state!=goodbit || received!=rx_count)
+        {
+          abort();
+        }
+      regs->clear_transfer_done();
+      return (state==goodbit && received!=rx_count) ? incompletebit : state;
+    }
+
+    int i2c_pins::poll_register
+    ( std::uint32_t const * paddrs
+    , std::size_t count
+    , std::uint8_t reg
+    , std::uint8_t * pvalues
+    , int * pstates
+    )
+    {
+      using internal::i2c_registers;
+
+      internal::trace_scope trace{"i2c_pins poll_register"};
+      if (is_busy())
+        {
+          throw std::logic_error
+                  { "i2c_pins::poll_register: Unable to start transaction,"
+                    " BSC/I2C peripheral is busy with an ongoing transaction."
+                  };
+        }
+      for (std::size_t idx=0; idx!=count; ++idx)
+        {
+          if (paddrs[idx]>i2c_registers::a_mask)
+            {
+              throw std::out_of_range
+                      { "i2c_pins::poll_register: "
+                        "Slave address not in the range [0,127]."
+                      };
+            }
+        }
+      auto & regs(i2c_ctrl::instance().regs(bsc_idx));
+      int result{goodbit};
+      bool clean{true};
+      for (std::size_t idx=0; idx!=count; ++idx)
+        {
+          regs->set_slave_address(paddrs[idx]);
+          pvalues[idx] = 0U;
+          int const state{combined_transfer(&reg, 1U, &pvalues[idx], 1U
+                                           , nullptr, clean
+                                           )};
+          if (pstates)
+            {
+              pstates[idx] = state;
+            }
+          result |= state;
+        // Only clean up ahead of the next transaction if this one failed
+          clean = state!=goodbit;
+        }
+      return result;
+    }
+
+    std::vector<std::uint32_t> i2c_pins::scan
+    ( std::uint32_t first
+    , std::uint32_t last
+    , i2c_probe probe
+    , std::uint16_t tout
+    )
+    {
+      using internal::i2c_registers;
+
+      internal::trace_scope trace{"i2c_pins scan"};
+      if (is_busy())
+        {
+          throw std::logic_error
+                  { "i2c_pins::scan: Unable to start transaction,"
+                    " BSC/I2C peripheral is busy with an ongoing transaction."
+                  };
+        }
+      if (last>i2c_registers::a_mask || first>last)
+        {
+            throw std::out_of_range
+                    { "i2c_pins::scan: Slave address range "
+                      "not in the range [0,127] or empty."
+                    };
+        }
+      auto & regs(i2c_ctrl::instance().regs(bsc_idx));
+      register_t const saved_tout{regs->get_clock_stretch_timeout()};
+      regs->set_clock_stretch_timeout(tout);
+      std::vector<std::uint32_t> found;
+      clear();
+      regs->clear_fifo();
+      for (std::uint32_t addrs{first};; ++addrs)
+        {
+          bool const read_probe
+                      { probe==i2c_probe::read_byte
+                     || ( probe==i2c_probe::automatic
+                       && ( (addrs>=0x30U && addrs<=0x37U)
+                         || (addrs>=0x50U && addrs<=0x5fU)
+                          )
+                        )
+                      };
+          regs->set_slave_address(addrs);
+          regs->set_data_length(read_probe ? 1U : 0U);
+          regs->set_transfer_type( read_probe ? i2c_transfer_type::read
+                                              : i2c_transfer_type::write
+                                 );
+          regs->clear_transfer_done();
+          regs->start_transfer();
+          adaptive_wait waiter(waiting, wait_counts);
+          while (!regs->get_transfer_done())
+            {
+              counters.count(io_event::wait_polls);
+              waiter.pause();
+            }
+          if (error_state()==goodbit)
+            {
+              found.push_back(addrs);
+            }
+          else
+            { // No device is the expected result so not counted as an error
+              clear();
+            }
+          regs->clear_fifo(); // discard any byte read by the probe
+          regs->clear_transfer_done();
+          if (addrs==last)
+            {
+              break;
+            }
+        }
+      regs->set_clock_stretch_timeout(saved_tout);
+      return found;
+    }
+
+    void i2c_pins::enable_interrupts(bool enable)
+    {
+      auto & regs(i2c_ctrl::instance().regs(bsc_idx));
+      regs->set_interrupt_on_done(enable);
+      regs->set_interrupt_on_txw(enable);
+      regs->set_interrupt_on_rxr(enable);
+    }
+
+    void i2c_pins::set_wait_policy(wait_policy const & p)
+    {
+      enable_interrupts(p.interrupt!=nullptr);
+      waiting = p;
+    }
+
+    void i2c_pins::set_clock_stretch_timeout(std::uint16_t tout)
+    {
+      i2c_ctrl::instance().regs(bsc_idx)->set_clock_stretch_timeout(tout);
+    }
+
+    std::uint16_t i2c_pins::clock_stretch_timeout() const
+    {
+      return static_cast<std::uint16_t>
+              (i2c_ctrl::instance().regs(bsc_idx)->get_clock_stretch_timeout());
+    }
+
+    i2c_timing i2c_pins::timing(hertz fc) const
+    {
+      auto & regs(i2c_ctrl::instance().regs(bsc_idx));
+      return i2c_timing
+              { hertz{fc.count()/regs->get_clock_divider()}
+              , static_cast<std::uint16_t>(regs->get_clock_stretch_timeout())
+              , static_cast<std::uint16_t>(regs->get_write_delay())
+              , static_cast<std::uint16_t>(regs->get_read_delay())
+              };
+    }
+
+    void i2c_pins::set_timing(i2c_timing const & t, hertz fc)
+    {
+      using internal::i2c_registers;
+
+      if (is_busy())
+        {
+          throw std::logic_error
+                  { "i2c_pins::set_timing: Unable to change timing,"
+                    " BSC/I2C peripheral is busy with an ongoing transaction."
+                  };
+        }
+      register_t const cdiv
+        {t.frequency.count() ? fc.count()/t.frequency.count() : 0U};
+      if (cdiv<i2c_registers::clk_divisor_min
+       || cdiv>i2c_registers::clk_divisor_max
+         )
+        {
+          throw std::out_of_range( "i2c_pins::set_timing: frequency "
+                                   "not in the range [fc/32768,fc/2]."
+                                 );
+        }
+      if (t.redl>(cdiv/2) || t.fedl>(cdiv/2))
+        {
+          throw std::out_of_range( "i2c_pins::set_timing: redl or fedl "
+                                   "exceeds (fc/f)/2 (CDIV/2)."
+                                 );
+        }
+      auto & regs(i2c_ctrl::instance().regs(bsc_idx));
+      regs->set_clock_divider(cdiv);
+      regs->set_read_delay(t.redl);
+      regs->set_write_delay(t.fedl);
+      regs->set_clock_stretch_timeout(t.tout);
+    }
+
+    i2c_timing i2c_pins::tune_timing
+    ( std::uint32_t addrs
+    , std::uint8_t reg
+    , hertz max_f
+    , unsigned trials
+    , hertz fc
+    )
+    {
+      using internal::i2c_registers;
+
+      internal::trace_scope trace{"i2c_pins tune_timing"};
+      if (max_f.count()==0U || trials==0U)
+        {
+          throw std::out_of_range
+                  {"i2c_pins::tune_timing: max_f or trials parameter is 0."};
+        }
+      i2c_timing const original{timing(fc)};
+      std::uint8_t reference{0U};
+      if (read_register(addrs, reg, &reference, 1U)!=goodbit) // CAN THROW
+        {
+          clear();
+          throw std::runtime_error{ "i2c_pins::tune_timing: Reference read "
+                                    "failed using the current timing."
+                                  };
+        }
+      auto & regs(i2c_ctrl::instance().regs(bsc_idx));
+      register_t const slowest{regs->get_clock_divider()};
+    // The BSC clock divisor is even: round up so max_f is not exceeded
+      register_t cdiv{(fc.count()+max_f.count()-1U)/max_f.count()};
+      cdiv = std::max<register_t>( (cdiv+1U)&~1U
+                                 , i2c_registers::clk_divisor_min
+                                 );
+      for (; cdiv<slowest; cdiv+=std::max<register_t>(2U, (cdiv/8U)&~1U))
+        {
+          register_t const half_period{cdiv/2U};
+          register_t const delays[][2] // fedl, redl pairs
+            { { std::min<register_t>(original.fedl, half_period)
+              , std::min<register_t>(original.redl, half_period)
+              }
+            , {half_period/2U, half_period/2U}
+            , {half_period/4U, half_period/4U}
+            };
+          regs->set_clock_divider(cdiv);
+          for (auto const & delay : delays)
+            {
+              regs->set_write_delay(delay[0]);
+              regs->set_read_delay(delay[1]);
+              bool pass{true};
+              for (unsigned trial=0U; pass && trial!=trials; ++trial)
+                {
+                  std::uint8_t value{static_cast<std::uint8_t>(~reference)};
+                  pass = read_register(addrs, reg, &value, 1U)==goodbit
+                      && value==reference;
+                }
+              if (pass)
+                {
+                  return timing(fc);
+                }
+              clear();
+            }
+        }
+      regs->set_clock_divider(slowest);
+      regs->set_write_delay(original.fedl);
+      regs->set_read_delay(original.redl);
+      return original;
+    }
+
     std::size_t i2c_pins::read
     ( std::uint8_t * pdata
     , std::size_t count
@@ -483,6 +1197,7 @@ namespace dibase { namespace rpi {
               ++bytes_read;
             }
         }
+      counters.count(io_event::bytes_read, bytes_read);
       return bytes_read;
     }
   } // namespace peripherals closed
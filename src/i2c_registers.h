@@ -100,6 +100,26 @@ namespace dibase { namespace rpi {
         constexpr static physical_address_t 
                       bsc2_physical_address = peripheral_base_address+0x805000;
 
+      /// @brief Physical address of start of BCM2711 only BSC3 control
+      /// registers, relative to the BCM2835 peripheral base address
+        constexpr static physical_address_t
+                      bsc3_physical_address = peripheral_base_address+0x205600;
+
+      /// @brief Physical address of start of BCM2711 only BSC4 control
+      /// registers, relative to the BCM2835 peripheral base address
+        constexpr static physical_address_t
+                      bsc4_physical_address = peripheral_base_address+0x205800;
+
+      /// @brief Physical address of start of BCM2711 only BSC5 control
+      /// registers, relative to the BCM2835 peripheral base address
+        constexpr static physical_address_t
+                      bsc5_physical_address = peripheral_base_address+0x205A00;
+
+      /// @brief Physical address of start of BCM2711 only BSC6 control
+      /// registers, relative to the BCM2835 peripheral base address
+        constexpr static physical_address_t
+                      bsc6_physical_address = peripheral_base_address+0x205C00;
+
         register_t  control;      ///< BSC Master Control, C
         register_t  status;       ///< BSC Master Status, S
         register_t  data_length;  ///< BSC Master Data Length, DLEN
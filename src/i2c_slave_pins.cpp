@@ -0,0 +1,164 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file i2c_slave_pins.cpp
+/// @brief Use a pair of GPIO pins with the BSC slave: implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "i2c_slave_pins.h"
+#include "bsc_slave_ctrl.h"
+#include "gpio_alt_fn.h"
+#include "gpio_ctrl.h"
+#include "periexcept.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using internal::bsc_slave_ctrl;
+    using internal::bsc_slave_registers;
+    using internal::gpio_ctrl;
+    using internal::pin_alt_fn::descriptor;
+    using internal::pin_alt_fn::gpio_special_fn;
+
+    namespace
+    {
+      descriptor get_alt_fn_descriptor(pin_id pin, gpio_special_fn special_fn)
+      {
+        using internal::pin_alt_fn::select;
+        auto pin_fn_info( select(pin, {special_fn}) );
+        if (pin_fn_info.empty())
+          {
+            throw std::invalid_argument
+                  { "i2c_slave_pins::i2c_slave_pins: Pin does not support "
+                    "requested BSC slave special function."
+                  };
+          }
+        return pin_fn_info[0];
+      }
+    }
+
+    i2c_slave_pins::i2c_slave_pins
+    ( pin_id sda_pin
+    , pin_id scl_pin
+    , std::uint32_t addrs
+    )
+    : pins{{sda_pin, scl_pin}}
+    , address{addrs}
+    {
+    // Note: any of these can throw - but nothing allocated yet so OK
+      descriptor const sda_info
+          {get_alt_fn_descriptor(sda_pin, gpio_special_fn::bscsl_sda_mosi)};
+      descriptor const scl_info
+          {get_alt_fn_descriptor(scl_pin, gpio_special_fn::bscsl_scl_sclk)};
+      if (addrs>bsc_slave_registers::slv_addr_mask)
+        {
+          throw std::out_of_range{"i2c_slave_pins::i2c_slave_pins: Slave "
+                                  "address not in the range [0,127]."};
+        }
+      if (bsc_slave_ctrl::instance().alloc.is_in_use(0))
+        {
+          throw bad_peripheral_alloc( "i2c_slave_pins::i2c_slave_pins: BSC "
+                                      "slave peripheral is already being used "
+                                      "locally."
+                                    );
+        }
+      bsc_slave_ctrl::instance().alloc.allocate(0);
+      try
+        {
+          gpio_ctrl::instance().alloc.allocate(sda_pin);  // CAN THROW
+        }
+      catch (...)
+        {
+          bsc_slave_ctrl::instance().alloc.deallocate(0);
+          throw;
+        }
+      try
+        {
+          gpio_ctrl::instance().alloc.allocate(scl_pin);  // CAN THROW
+        }
+      catch (...)
+        {
+          gpio_ctrl::instance().alloc.deallocate(sda_pin);
+          bsc_slave_ctrl::instance().alloc.deallocate(0);
+          throw;
+        }
+      internal::gpio_config & config(gpio_ctrl::instance().config);
+      config.set_pin_function(sda_pin, sda_info.alt_fn());
+      config.set_pin_function(scl_pin, scl_info.alt_fn());
+      auto & regs(bsc_slave_ctrl::instance().regs);
+      regs->control = bsc_slave_registers::cr_break;
+      regs->control = 0U;
+      regs->clear_errors();
+      regs->slave_addrs = addrs;
+      regs->control = bsc_slave_registers::i2c_enable;
+    }
+
+    i2c_slave_pins::~i2c_slave_pins()
+    {
+      auto & regs(bsc_slave_ctrl::instance().regs);
+      regs->control = bsc_slave_registers::cr_break;
+      regs->control = 0U;
+      regs->clear_errors();
+      for (auto pin : pins)
+        {
+          gpio_ctrl::instance().alloc.deallocate(pin_id(pin));
+        }
+      bsc_slave_ctrl::instance().alloc.deallocate(0);
+    }
+
+    std::size_t i2c_slave_pins::read(std::uint8_t * prx, std::size_t max_count)
+    {
+      auto & regs(bsc_slave_ctrl::instance().regs);
+      std::size_t count{0U};
+      while (count!=max_count && !regs->get_rx_fifo_empty())
+        {
+          prx[count++] = regs->receive_fifo_read();
+        }
+      return count;
+    }
+
+    std::size_t i2c_slave_pins::write
+    ( std::uint8_t const * ptx
+    , std::size_t count
+    )
+    {
+      auto & regs(bsc_slave_ctrl::instance().regs);
+      std::size_t written{0U};
+      while (written!=count && !regs->get_tx_fifo_full())
+        {
+          regs->transmit_fifo_write(ptx[written++]);
+        }
+      return written;
+    }
+
+    std::size_t i2c_slave_pins::rx_fifo_level() const
+    {
+      return bsc_slave_ctrl::instance().regs->get_rx_fifo_level();
+    }
+
+    std::size_t i2c_slave_pins::tx_fifo_level() const
+    {
+      return bsc_slave_ctrl::instance().regs->get_tx_fifo_level();
+    }
+
+    int i2c_slave_pins::errors() const
+    {
+      register_t const rsr{bsc_slave_ctrl::instance().regs->get_errors()};
+      return ((rsr&bsc_slave_registers::rsr_overrun) ? overrunbit : goodbit)
+           | ((rsr&bsc_slave_registers::rsr_underrun) ? underrunbit : goodbit);
+    }
+
+    void i2c_slave_pins::clear()
+    {
+      bsc_slave_ctrl::instance().regs->clear_errors();
+    }
+
+    void i2c_slave_pins::clear_fifos()
+    {
+      auto & regs(bsc_slave_ctrl::instance().regs);
+      regs->control = bsc_slave_registers::i2c_enable
+                    | bsc_slave_registers::cr_break;
+      regs->control = bsc_slave_registers::i2c_enable;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
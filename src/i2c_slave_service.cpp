@@ -0,0 +1,126 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file i2c_slave_service.cpp
+/// @brief BSC slave FIFO service thread class implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "i2c_slave_service.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+    // Bytes each BSC slave FIFO holds, so most moved per FIFO access burst.
+      std::size_t const fifo_depth{16U};
+    }
+
+    i2c_slave_service::i2c_slave_service
+    ( i2c_slave_pins & sp
+    , std::size_t capacity
+    , wait_policy const & policy
+    )
+    : pins(sp)
+    , rx_ring{capacity}
+    , tx_ring{capacity}
+    , waiting(policy)
+    , overrun_count{0U}
+    , error_state{i2c_slave_pins::goodbit}
+    , stopping{false}
+    , service_failed{false}
+    {
+      service = std::thread{&i2c_slave_service::run, this};
+    }
+
+    i2c_slave_service::~i2c_slave_service()
+    {
+      stopping.store(true, std::memory_order_release);
+      service.join();
+    }
+
+    void i2c_slave_service::run()
+    {
+      try
+        {
+          wait_stats stats;
+          adaptive_wait waiter{waiting, stats};
+          std::uint8_t rx[fifo_depth];
+          std::uint8_t tx[fifo_depth];
+          std::size_t tx_count{0U};
+          std::size_t tx_pos{0U};
+          while (!stopping.load(std::memory_order_acquire))
+            {
+              bool moved{false};
+              std::size_t const count{pins.read(rx, fifo_depth)};
+              for (std::size_t idx=0; idx!=count; ++idx)
+                {
+                  if (!rx_ring.try_push(rx[idx]))
+                    {
+                      overrun_count.fetch_add(1U, std::memory_order_relaxed);
+                    }
+                }
+              if (tx_pos==tx_count)
+                {
+                  tx_count = tx_ring.pop(tx, fifo_depth);
+                  tx_pos = 0U;
+                }
+              if (tx_pos!=tx_count)
+                {
+                  std::size_t const written{pins.write(tx+tx_pos
+                                                      , tx_count-tx_pos
+                                                      )};
+                  tx_pos += written;
+                  moved = written!=0U;
+                }
+              int const status{pins.errors()};
+              if (status!=i2c_slave_pins::goodbit)
+                {
+                  error_state.fetch_or(status, std::memory_order_relaxed);
+                  pins.clear();
+                }
+              if (moved || count!=0U)
+                {
+                  waiter.restart();
+                }
+              else
+                {
+                  waiter.pause();
+                }
+            }
+        }
+      catch (...)
+        {
+          service_error = std::current_exception();
+          service_failed.store(true, std::memory_order_release);
+        }
+    }
+
+    std::size_t i2c_slave_service::read
+    ( std::uint8_t * prx
+    , std::size_t max_count
+    )
+    {
+      std::size_t const count{rx_ring.pop(prx, max_count)};
+      if (count==0U && max_count!=0U
+       && service_failed.load(std::memory_order_acquire) && rx_ring.empty())
+        {
+          std::rethrow_exception(service_error);
+        }
+      return count;
+    }
+
+    std::size_t i2c_slave_service::write
+    ( std::uint8_t const * ptx
+    , std::size_t count
+    )
+    {
+      std::size_t queued{0U};
+      while (queued!=count && tx_ring.try_push(ptx[queued]))
+        {
+          ++queued;
+        }
+      return queued;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,202 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file i2c_transaction_scheduler.cpp
+/// @brief I2C transaction scheduler implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "i2c_transaction_scheduler.h"
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+    // Most bytes that can be written in a combined transaction
+      std::size_t const max_combined_write{16U};
+
+    // Most bytes that can be transferred in one direction
+      std::size_t const max_data_length{0xFFFFU};
+    }
+
+    i2c_transaction_scheduler::i2c_transaction_scheduler
+    (std::initializer_list<i2c_pins *> buses)
+    {
+      if (buses.size()==0U)
+        {
+          throw std::invalid_argument{"i2c_transaction_scheduler::"
+                                      "i2c_transaction_scheduler: must have at "
+                                      "least one i2c_pins object."};
+        }
+      for (auto p : buses)
+        {
+          if (!p)
+            {
+              throw std::invalid_argument{"i2c_transaction_scheduler::"
+                                          "i2c_transaction_scheduler: "
+                                          "i2c_pins object pointer is null."};
+            }
+          for (auto const & w : workers)
+            {
+              if (w->pins.bus()==p->bus())
+                {
+                  throw std::invalid_argument{"i2c_transaction_scheduler::"
+                                              "i2c_transaction_scheduler: "
+                                              "more than one i2c_pins object "
+                                              "for a BSC master."};
+                }
+            }
+          workers.emplace_back(new bus_worker{*p});
+        }
+      try
+        {
+          for (auto & w : workers)
+            {
+              w->worker = std::thread{&i2c_transaction_scheduler::run_jobs
+                                     , std::ref(*w)
+                                     };
+            }
+        }
+      catch (...)
+        {
+          stop_workers();
+          throw;
+        }
+    }
+
+    i2c_transaction_scheduler::~i2c_transaction_scheduler()
+    {
+      stop_workers();
+    }
+
+    void i2c_transaction_scheduler::stop_workers()
+    {
+      for (auto & w : workers)
+        {
+          if (w->worker.joinable())
+            {
+              {
+                std::lock_guard<std::mutex> lock{w->guard};
+                w->stopping = true;
+              }
+              w->job_available.notify_one();
+              w->worker.join();
+            }
+        }
+    }
+
+    std::future<i2c_transaction_result> i2c_transaction_scheduler::submit
+    ( unsigned bus
+    , std::uint32_t addrs
+    , std::vector<std::uint8_t> tx
+    , std::size_t rx_count
+    )
+    {
+      bus_worker * target{nullptr};
+      for (auto & w : workers)
+        {
+          if (w->pins.bus()==bus)
+            {
+              target = w.get();
+            }
+        }
+      if (!target)
+        {
+          throw std::invalid_argument{"i2c_transaction_scheduler::submit: no "
+                                      "i2c_pins object for the bus."};
+        }
+      if (tx.empty() && rx_count==0U)
+        {
+          throw std::invalid_argument{"i2c_transaction_scheduler::submit: no "
+                                      "bytes to write or read."};
+        }
+      if (!tx.empty() && rx_count!=0U && tx.size()>max_combined_write)
+        {
+          throw std::invalid_argument{"i2c_transaction_scheduler::submit: "
+                                      "more than 16 bytes to write in a "
+                                      "combined transaction."};
+        }
+      if (addrs>127U)
+        {
+          throw std::out_of_range{"i2c_transaction_scheduler::submit: "
+                                  "Slave address not in the range [0,127]."};
+        }
+      if (tx.size()>max_data_length || rx_count>max_data_length)
+        {
+          throw std::out_of_range{"i2c_transaction_scheduler::submit: "
+                                  "Transaction data length not in the range "
+                                  "[0,65535]."};
+        }
+      job j{addrs, std::move(tx), rx_count
+           , std::promise<i2c_transaction_result>{}
+           };
+      std::future<i2c_transaction_result> result{j.result.get_future()};
+      {
+        std::lock_guard<std::mutex> lock{target->guard};
+        target->jobs.push_back(std::move(j));
+      }
+      target->job_available.notify_one();
+      return result;
+    }
+
+    void i2c_transaction_scheduler::run_jobs(bus_worker & w)
+    {
+      for (;;)
+        {
+          job j;
+          {
+            std::unique_lock<std::mutex> lock{w.guard};
+            w.job_available.wait( lock
+                                , [&w]{return w.stopping||!w.jobs.empty();}
+                                );
+            if (w.jobs.empty())
+              {
+                return;
+              }
+            j = std::move(w.jobs.front());
+            w.jobs.pop_front();
+          }
+          try
+            {
+              j.result.set_value(run_job(w.pins, j));
+            }
+          catch (...)
+            {
+              w.pins.abort();
+              j.result.set_exception(std::current_exception());
+            }
+          w.pins.clear();
+        }
+    }
+
+    i2c_transaction_result i2c_transaction_scheduler::run_job
+    ( i2c_pins & pins
+    , job & j
+    )
+    {
+      i2c_transaction_result r{i2c_pins::goodbit
+                              , std::vector<std::uint8_t>(j.rx_count)
+                              };
+      std::size_t const tx_count{j.tx.size()};
+      std::size_t count{0U};
+      if (tx_count!=0U && j.rx_count!=0U)
+        {
+          r.state = pins.write_then_read( j.addrs, j.tx.data(), tx_count
+                                        , r.rx.data(), j.rx_count, &count
+                                        );
+          r.rx.resize(count);
+        }
+      else if (tx_count!=0U)
+        {
+          r.state = pins.write_all(j.addrs, j.tx.data(), tx_count);
+        }
+      else
+        {
+          r.state = pins.read_all(j.addrs, r.rx.data(), j.rx_count, &count);
+          r.rx.resize(count);
+        }
+      return r;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,168 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file init_trace.cpp
+/// @brief Initialisation timing records and report implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "init_trace.h"
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+      std::size_t const number_of_phases
+                    {static_cast<std::size_t>(init_phase::number_of_phases)};
+
+      char const * const phase_names[number_of_phases]
+                    { "dev_mem_open"
+                    , "phymem_map"
+                    , "cpuinfo_read"
+                    , "device_tree_read"
+                    , "sysfs_export"
+                    , "sysfs_unexport"
+                    , "pull_sequence"
+                    };
+
+    // Function local static so calls timed during static initialisation of
+    // other translation units are recorded.
+      struct init_trace_store
+      {
+        std::mutex          guard;
+        init_trace_record   records[init_trace_capacity];
+        std::size_t         count{0U};
+        init_phase_totals   totals[number_of_phases];
+
+        init_trace_store()
+        {
+          reset();
+        }
+
+        void reset()
+        {
+          count = 0U;
+          for (auto & t : totals)
+            {
+              t = init_phase_totals{ 0U, std::chrono::nanoseconds::zero()
+                                   , std::chrono::nanoseconds::zero()
+                                   };
+            }
+        }
+
+        static init_trace_store & instance()
+        {
+          static init_trace_store store;
+          return store;
+        }
+      };
+
+      double as_us(std::chrono::nanoseconds ns)
+      {
+        return ns.count()/1000.0;
+      }
+    }
+
+    char const * init_phase_name(init_phase phase)
+    {
+      std::size_t const idx{static_cast<std::size_t>(phase)};
+      if (idx>=number_of_phases)
+        {
+          throw std::out_of_range{"init_phase_name: phase is not a timed "
+                                  "phase."};
+        }
+      return phase_names[idx];
+    }
+
+    std::vector<init_trace_record> init_trace_records()
+    {
+      init_trace_store & store(init_trace_store::instance());
+      std::lock_guard<std::mutex> lock{store.guard};
+      return std::vector<init_trace_record>
+                          (store.records, store.records+store.count);
+    }
+
+    init_phase_totals init_trace_totals(init_phase phase)
+    {
+      std::size_t const idx{static_cast<std::size_t>(phase)};
+      if (idx>=number_of_phases)
+        {
+          throw std::out_of_range{"init_trace_totals: phase is not a timed "
+                                  "phase."};
+        }
+      init_trace_store & store(init_trace_store::instance());
+      std::lock_guard<std::mutex> lock{store.guard};
+      return store.totals[idx];
+    }
+
+    void init_trace_report(std::ostream & os)
+    {
+      std::vector<init_trace_record> const records{init_trace_records()};
+      os << "phase             calls    total us      max us\n";
+      for (std::size_t idx=0U; idx!=number_of_phases; ++idx)
+        {
+          init_phase const phase{static_cast<init_phase>(idx)};
+          init_phase_totals const t{init_trace_totals(phase)};
+          if (t.calls==0U)
+            {
+              continue;
+            }
+          os.width(16);
+          os << std::left << init_phase_name(phase) << std::right;
+          os.width(7);
+          os << t.calls << ' ';
+          os.width(11);
+          os << as_us(t.total) << ' ';
+          os.width(11);
+          os << as_us(t.max) << '\n';
+        }
+      if (records.empty())
+        {
+          return;
+        }
+      auto const origin(records.front().start);
+      os << "\n  start us     duration us  phase\n";
+      for (init_trace_record const & r : records)
+        {
+          os.width(10);
+          os << as_us(r.start-origin) << "  ";
+          os.width(14);
+          os << as_us(r.duration) << "  " << init_phase_name(r.phase) << '\n';
+        }
+    }
+
+    void init_trace_reset()
+    {
+      init_trace_store & store(init_trace_store::instance());
+      std::lock_guard<std::mutex> lock{store.guard};
+      store.reset();
+    }
+
+    namespace internal
+    {
+      init_trace_scope::~init_trace_scope()
+      {
+        auto const end(std::chrono::steady_clock::now());
+        std::chrono::nanoseconds const duration
+                  {std::chrono::duration_cast<std::chrono::nanoseconds>
+                                                              (end-start)};
+        init_trace_store & store(init_trace_store::instance());
+        std::lock_guard<std::mutex> lock{store.guard};
+        init_phase_totals & t(store.totals[static_cast<std::size_t>(phase)]);
+        ++t.calls;
+        t.total += duration;
+        if (duration>t.max)
+          {
+            t.max = duration;
+          }
+        if (store.count!=init_trace_capacity)
+          {
+            store.records[store.count++] = {phase, start, duration};
+          }
+      }
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
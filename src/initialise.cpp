@@ -0,0 +1,132 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file initialise.cpp
+/// @brief Eager initialisation of peripheral access implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "initialise.h"
+#include "rpi_info.h"
+#include "board_descriptor.h"
+#include "peripheral_range.h"
+#include "peripheral_simulator.h"
+#include "phymem_ptr.h"
+#include "gpio_alt_fn.h"
+#include "sysfs.h"
+#include "gpio_ctrl.h"
+#include "clock_ctrl.h"
+#include "pwm_ctrl.h"
+#include "spi0_ctrl.h"
+#include "i2c_ctrl.h"
+#include "aux_ctrl.h"
+#include "uart0_ctrl.h"
+#include "pcm_ctrl.h"
+#include "smi_ctrl.h"
+#include "dma_ctrl.h"
+#include "system_timer_ctrl.h"
+#include "bsc_slave_ctrl.h"
+#include <cerrno>
+#include <system_error>
+#include <sys/mman.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using namespace internal;
+
+    namespace
+    {
+      template <class T>
+      void lock_registers(phymem_ptr<T> & regs, bool lock_pages)
+      {
+        if (lock_pages && ::mlock( const_cast<void *>
+                                      (static_cast<void const volatile *>
+                                                              (regs.get()))
+                                 , sizeof(T)
+                                 )!=0)
+          {
+            throw std::system_error
+                  { errno, std::system_category()
+                  , "initialise: locking register pages failed with error "
+                    "from call to mlock."
+                  };
+          }
+      }
+    }
+
+    void initialise(peripheral_set const & set, bool lock_pages)
+    {
+      rpi_info{}.major_version();
+      running_board();
+      detected_peripheral_range();
+      if (set.empty())
+        {
+          return;
+        }
+      if (set.contains(peripheral::gpio))
+        {
+          lock_registers(gpio_ctrl::instance().regs, lock_pages);
+          pin_alt_fn::view(pin_id{0});
+          if (!simulated_peripherals_selected())
+            {
+              open_gpio_control_files();
+            }
+        }
+      if (set.contains(peripheral::clock))
+        {
+          lock_registers(clock_ctrl::instance().regs, lock_pages);
+        }
+      if (set.contains(peripheral::pwm))
+        {
+          lock_registers(pwm_ctrl::instance().regs, lock_pages);
+        }
+      if (set.contains(peripheral::spi0))
+        {
+          for (unsigned spi=0U; spi!=7U; ++spi)
+            {
+              if (spi0_ctrl::has_controller(spi))
+                {
+                  lock_registers( spi0_ctrl::instance().regs_of(spi)
+                                , lock_pages
+                                );
+                }
+            }
+        }
+      if (set.contains(peripheral::i2c))
+        {
+          for (std::size_t idx=0U; idx!=i2c_ctrl::masters(); ++idx)
+            {
+              lock_registers(i2c_ctrl::instance().regs(idx), lock_pages);
+            }
+        }
+      if (set.contains(peripheral::aux))
+        {
+          lock_registers(aux_ctrl::instance().regs, lock_pages);
+        }
+      if (set.contains(peripheral::uart0))
+        {
+          lock_registers(uart0_ctrl::instance().regs, lock_pages);
+        }
+      if (set.contains(peripheral::pcm))
+        {
+          lock_registers(pcm_ctrl::instance().regs, lock_pages);
+        }
+      if (set.contains(peripheral::smi))
+        {
+          lock_registers(smi_ctrl::instance().regs, lock_pages);
+        }
+      if (set.contains(peripheral::dma))
+        {
+          lock_registers(dma_ctrl::instance().regs, lock_pages);
+        }
+      if (set.contains(peripheral::system_timer))
+        {
+          lock_registers(system_timer_ctrl::instance().regs, lock_pages);
+        }
+      if (set.contains(peripheral::bsc_slave))
+        {
+          lock_registers(bsc_slave_ctrl::instance().regs, lock_pages);
+        }
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,106 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file io_service.cpp
+/// @brief Peripheral I/O service thread implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "io_service.h"
+#include <system_error>
+#include <pthread.h>
+#include <sched.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    io_service::io_service
+    ( std::size_t capacity
+    , int cpu
+    , wait_policy idle
+    )
+    : commands{capacity}
+    , idling(idle)
+    , stopping{false}
+    , failures{0U}
+    {
+      worker = std::thread{&io_service::run_commands, this};
+      if (cpu!=any_cpu)
+        {
+          cpu_set_t cpus;
+          CPU_ZERO(&cpus);
+          CPU_SET(cpu, &cpus);
+          int const rv{::pthread_setaffinity_np( worker.native_handle()
+                                               , sizeof(cpus), &cpus
+                                               )};
+          if (rv!=0)
+            {
+              stopping.store(true, std::memory_order_release);
+              worker.join();
+              throw std::system_error
+                    ( rv
+                    , std::system_category()
+                    , "io_service: setting service thread CPU affinity "
+                      "failed with error from call to pthread_setaffinity_np."
+                    );
+            }
+        }
+    }
+
+    io_service::~io_service()
+    {
+      stopping.store(true, std::memory_order_release);
+      worker.join();
+    }
+
+    void io_service::enqueue(command c)
+    {
+      while (!commands.try_push(std::move(c)))
+        {
+          std::this_thread::yield();
+        }
+    }
+
+    void io_service::hand_over(std::shared_ptr<holder_base> h)
+    {
+      enqueue([this, h]{ owned.push_back(h); });
+    }
+
+    void io_service::run_commands()
+    {
+      wait_stats idle_counts;
+      adaptive_wait waiting{idling, idle_counts};
+      command c;
+      for (;;)
+        {
+        // Read before popping: once set no more commands are queued, so an
+        // empty queue then means all commands have been run.
+          bool const stop{stopping.load(std::memory_order_acquire)};
+          if (commands.try_pop(c))
+            {
+              try
+                {
+                  c();
+                }
+              catch (...)
+                {
+                  failures.fetch_add(1U, std::memory_order_relaxed);
+                }
+              c = nullptr;
+              waiting.restart();
+            }
+          else if (stop)
+            {
+              break;
+            }
+          else
+            {
+              waiting.pause();
+            }
+        }
+      while (!owned.empty())
+        {
+          owned.pop_back();
+        }
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,95 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file irq_event.cpp
+/// @brief UIO interrupt wait implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "irq_event.h"
+#include <stdexcept>
+#include <system_error>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+      void throw_system_error(char const * what)
+      {
+        throw std::system_error(errno, std::system_category(), what);
+      }
+    }
+
+    irq_event::irq_event(char const * path)
+    : irq_fd{::open(path, O_RDWR|O_CLOEXEC)}
+    , irq_count{0U}
+    {
+      if (irq_fd==-1)
+        {
+          throw_system_error( "irq_event: opening interrupt device failed "
+                              "with error from call to open."
+                            );
+        }
+    }
+
+    irq_event::irq_event(int fd)
+    : irq_fd{fd}
+    , irq_count{0U}
+    {
+      if (fd<0)
+        {
+          throw std::invalid_argument{"irq_event: fd parameter value is "
+                                      "negative."};
+        }
+    }
+
+    irq_event::~irq_event()
+    {
+      ::close(irq_fd);
+    }
+
+    bool irq_event::wait(std::chrono::nanoseconds timeout)
+    {
+      std::uint32_t const enable{1U};
+      if (::write(irq_fd, &enable, sizeof(enable))==-1)
+        {
+          throw_system_error( "irq_event: enabling interrupt failed with "
+                              "error from call to write."
+                            );
+        }
+      std::chrono::nanoseconds::rep const ns_per_ms{1000000};
+      long long const timeout_ms{timeout.count()<=0 ? 0
+                                : (timeout.count()+ns_per_ms-1)/ns_per_ms
+                                };
+      pollfd pfd{irq_fd, POLLIN, 0};
+      int const rv{::poll(&pfd, 1U, static_cast<int>(timeout_ms))};
+      if (rv==-1)
+        {
+          if (errno==EINTR)
+            {
+              return false;
+            }
+          throw_system_error( "irq_event: waiting for interrupt failed with "
+                              "error from call to poll."
+                            );
+        }
+      if (rv==0)
+        {
+          return false;
+        }
+      std::uint32_t count;
+      if (::read(irq_fd, &count, sizeof(count))==-1)
+        {
+          throw_system_error( "irq_event: acknowledging interrupt failed "
+                              "with error from call to read."
+                            );
+        }
+      ++irq_count;
+      return true;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,146 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file latency_histogram.cpp
+/// @brief Log-linear latency histogram implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    constexpr unsigned latency_histogram::sub_bucket_bits;
+    constexpr unsigned latency_histogram::max_magnitude;
+    constexpr std::uint64_t latency_histogram::max_trackable;
+    constexpr std::size_t latency_histogram::number_of_buckets;
+
+    namespace
+    {
+      constexpr std::uint64_t no_min{~std::uint64_t{0}};
+    }
+
+    latency_histogram::latency_histogram()
+    {
+      reset();
+    }
+
+  // Values below 2^(sub_bucket_bits+1) index their own bucket. Each higher
+  // power of two range [2^m, 2^(m+1)) is shifted right by m-sub_bucket_bits
+  // to give a top value in [2^sub_bucket_bits, 2^(sub_bucket_bits+1)) that
+  // is offset by the shift times the number of sub buckets.
+    std::size_t latency_histogram::bucket_index(std::uint64_t value)
+    {
+      if (value>max_trackable)
+        {
+          value = max_trackable;
+        }
+      unsigned shift{0U};
+      if (value>>(sub_bucket_bits+1U))
+        {
+          unsigned const magnitude
+                    {63U-static_cast<unsigned>(__builtin_clzll(value))};
+          shift = magnitude-sub_bucket_bits;
+        }
+      return (static_cast<std::size_t>(shift)<<sub_bucket_bits)
+            + static_cast<std::size_t>(value>>shift);
+    }
+
+    std::uint64_t latency_histogram::bucket_lowest(std::size_t idx)
+    {
+      std::size_t const first_shared{std::size_t{2U}<<sub_bucket_bits};
+      if (idx<first_shared)
+        {
+          return idx;
+        }
+      unsigned const shift
+                  {static_cast<unsigned>((idx>>sub_bucket_bits)-1U)};
+      std::uint64_t const top{idx-(std::size_t{shift}<<sub_bucket_bits)};
+      return top<<shift;
+    }
+
+    std::uint64_t latency_histogram::bucket_highest(std::size_t idx)
+    {
+      if (idx+1U>=number_of_buckets)
+        {
+          return max_trackable;
+        }
+      return bucket_lowest(idx+1U)-1U;
+    }
+
+    void latency_histogram::record(std::chrono::nanoseconds latency)
+    {
+      std::uint64_t const value
+                    { latency.count()<0
+                    ? 0U : static_cast<std::uint64_t>(latency.count())
+                    };
+      ++counts[bucket_index(value)];
+      ++total;
+      sum += value;
+      min_value = std::min(min_value, value);
+      max_value = std::max(max_value, value);
+    }
+
+    std::chrono::nanoseconds latency_histogram::min() const
+    {
+      return std::chrono::nanoseconds(total ? min_value : 0U);
+    }
+
+    std::chrono::nanoseconds latency_histogram::mean() const
+    {
+      return std::chrono::nanoseconds(total ? sum/total : 0U);
+    }
+
+    std::chrono::nanoseconds latency_histogram::percentile
+    (double percent) const
+    {
+      if (total==0U)
+        {
+          return std::chrono::nanoseconds(0);
+        }
+      percent = std::min(std::max(percent, 0.0), 100.0);
+      std::uint64_t target
+                  {static_cast<std::uint64_t>
+                                      (std::ceil(percent/100.0*total))};
+      if (target==0U)
+        {
+          target = 1U;
+        }
+      std::uint64_t seen{0U};
+      for (std::size_t idx=0U; idx!=number_of_buckets; ++idx)
+        {
+          seen += counts[idx];
+          if (seen>=target && idx+1U!=number_of_buckets)
+            {
+              return std::chrono::nanoseconds
+                                  (std::min(bucket_highest(idx), max_value));
+            }
+        }
+      return std::chrono::nanoseconds(max_value);
+    }
+
+    void latency_histogram::add(latency_histogram const & other)
+    {
+      for (std::size_t idx=0U; idx!=number_of_buckets; ++idx)
+        {
+          counts[idx] += other.counts[idx];
+        }
+      total += other.total;
+      sum += other.sum;
+      min_value = std::min(min_value, other.min_value);
+      max_value = std::max(max_value, other.max_value);
+    }
+
+    void latency_histogram::reset()
+    {
+      std::fill(std::begin(counts), std::end(counts), 0U);
+      total = 0U;
+      min_value = no_min;
+      max_value = 0U;
+      sum = 0U;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
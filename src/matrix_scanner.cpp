@@ -0,0 +1,214 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file matrix_scanner.cpp
+/// @brief Key matrix filter and matrix scanner class implementations.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "matrix_scanner.h"
+#include <stdexcept>
+#include <time.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+      std::chrono::nanoseconds monotonic_now()
+      {
+        ::timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        return std::chrono::seconds{now.tv_sec}
+             + std::chrono::nanoseconds{now.tv_nsec};
+      }
+
+      pin_group_value_t all_keys(unsigned rows, unsigned columns)
+      {
+        if (rows==0U || columns==0U || rows*columns>64U)
+          {
+            throw std::invalid_argument{"key_matrix_filter: matrix must have "
+                                        "1 to 64 keys."};
+          }
+        unsigned const keys{rows*columns};
+        return keys==64U ? ~pin_group_value_t(0)
+                         : (pin_group_value_t(1)<<keys)-1U;
+      }
+    }
+
+    key_matrix_filter::key_matrix_filter
+    ( unsigned rows
+    , unsigned columns
+    , unsigned updates
+    )
+    : row_count{rows}
+    , column_count{columns}
+    , filter{all_keys(rows, columns), 0U, updates}
+    , ghosted_count{0U}
+    {}
+
+    pin_group_value_t key_matrix_filter::ghosts(pin_group_value_t keys) const
+    {
+      pin_group_value_t const row_mask{(pin_group_value_t(1)<<column_count)
+                                      -1U
+                                      };
+      pin_group_value_t rectangles{0U};
+      for (unsigned r1=0U; r1+1U<row_count; ++r1)
+        {
+          pin_group_value_t const row1{(keys>>(r1*column_count))&row_mask};
+          if ((row1&(row1-1U))==0U) // fewer than two keys
+            {
+              continue;
+            }
+          for (unsigned r2=r1+1U; r2!=row_count; ++r2)
+            {
+              pin_group_value_t const common
+                                    {row1&(keys>>(r2*column_count))};
+              if ((common&(common-1U))!=0U)
+                {
+                  rectangles |= (common<<(r1*column_count))
+                              | (common<<(r2*column_count));
+                }
+            }
+        }
+      return rectangles;
+    }
+
+    pin_group_value_t key_matrix_filter::update(pin_group_value_t keys)
+    {
+      pin_group_value_t const held{ghosts(keys)};
+      if (held!=0U)
+        {
+          ++ghosted_count;
+          keys = (keys&~held)|(filter.state()&held);
+        }
+      return filter.update(keys);
+    }
+
+    matrix_scanner::matrix_scanner
+    ( opin_group & rows
+    , ipin_group & columns
+    , std::chrono::microseconds row_tick
+    , unsigned stable_scans
+    , std::size_t capacity
+    , bool active_low
+    , rt_config const & config
+    )
+    : row_pins(rows)
+    , column_pins(columns)
+    , low_active{active_low}
+    , tick_period{row_tick}
+    , filter{ static_cast<unsigned>(rows.size())
+            , static_cast<unsigned>(columns.size())
+            , stable_scans
+            }
+    , ring{capacity}
+    , pressed{0U}
+    , overrun_count{0U}
+    , missed_count{0U}
+    , ghosted_count{0U}
+    , stopping{false}
+    , poller_failed{false}
+    {
+      if (row_tick.count()<=0)
+        {
+          throw std::invalid_argument{"matrix_scanner::matrix_scanner: tick "
+                                      "must be greater than zero."};
+        }
+      row_pins.put(low_active ? row_pins.all_pins() : 0U);
+      poller = rt_thread{config, [this](){ scan_keys(); }};
+    }
+
+    matrix_scanner::~matrix_scanner()
+    {
+      stopping.store(true, std::memory_order_release);
+      poller.join();
+      row_pins.put(low_active ? row_pins.all_pins() : 0U);
+    }
+
+    void matrix_scanner::drive_row(unsigned previous, unsigned row)
+    {
+      pin_group_value_t const bit{pin_group_value_t(1)<<row};
+      row_pins.put( (pin_group_value_t(1)<<previous)|bit
+                  , low_active ? ~bit : bit
+                  );
+    }
+
+    void matrix_scanner::scan_keys()
+    {
+      try
+        {
+          unsigned const row_count{filter.rows()};
+          unsigned const column_count{filter.columns()};
+          pin_group_value_t const column_mask{column_pins.all_pins()};
+          pin_group_value_t keys{0U};
+          unsigned row{0U};
+          drive_row(0U, 0U);
+          rt_period period{tick_period};
+          while (!stopping.load(std::memory_order_acquire))
+            {
+              if (!period.wait())
+                {
+                  missed_count.fetch_add(1U, std::memory_order_relaxed);
+                }
+              pin_group_value_t const levels{column_pins.get()};
+              keys |= ((low_active ? ~levels : levels)&column_mask)
+                                                      <<(row*column_count);
+              unsigned const next_row{row+1U==row_count ? 0U : row+1U};
+              drive_row(row, next_row);
+              row = next_row;
+              if (row!=0U)
+                {
+                  continue;
+                }
+              std::uint64_t const ghosted{filter.ghosted_scans()};
+              pin_group_value_t changes{filter.update(keys)};
+              keys = 0U;
+              if (filter.ghosted_scans()!=ghosted)
+                {
+                  ghosted_count.fetch_add(1U, std::memory_order_relaxed);
+                }
+              if (changes==0U)
+                {
+                  continue;
+                }
+              pin_group_value_t const states{filter.state()};
+              pressed.store(states, std::memory_order_release);
+              key_event event;
+              event.timestamp = monotonic_now();
+              while (changes!=0U)
+                {
+                  unsigned const idx
+                            {static_cast<unsigned>(__builtin_ctzll(changes))};
+                  changes &= changes-1U;
+                  event.row = idx/column_count;
+                  event.column = idx%column_count;
+                  event.pressed = (states>>idx)&1U;
+                  if (!ring.try_push(event))
+                    {
+                      overrun_count.fetch_add(1U, std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+      catch (...)
+        {
+          poller_error = std::current_exception();
+          poller_failed.store(true, std::memory_order_release);
+        }
+    }
+
+    std::size_t matrix_scanner::pop
+    ( key_event * events
+    , std::size_t max_events
+    )
+    {
+      std::size_t const count{ring.pop(events, max_events)};
+      if (count==0U && max_events!=0U
+       && poller_failed.load(std::memory_order_acquire) && ring.empty())
+        {
+          std::rethrow_exception(poller_error);
+        }
+      return count;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,390 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file multiplexed_display.cpp
+/// @brief DMA refreshed multiplexed LED display implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "multiplexed_display.h"
+#include "multiplexed_display_compiler.h"
+#include "dma_arena.h"
+#include "dma_ctrl.h"
+#include "gpio_ctrl.h"
+#include "gpio_registers.h"
+#include "pwm_ctrl.h"
+#include "clock_parameters.h"
+#include "periexcept.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      namespace
+      {
+        register_t const gpset0_bus_address
+                  { peripheral_bus_address(gpio_registers::physical_address)
+                  + static_cast<register_t>(offsetof(gpio_registers, gpset))
+                  };
+        register_t const gpclr0_bus_address
+                  { peripheral_bus_address(gpio_registers::physical_address)
+                  + static_cast<register_t>(offsetof(gpio_registers, gpclr))
+                  };
+        register_t const pwm_fifo_bus_address
+                  { peripheral_bus_address(pwm_registers::physical_address)
+                  + static_cast<register_t>(offsetof(pwm_registers, fifo_in))
+                  };
+
+      // Delay control block lengths are limited to the 30 bit TXFR_LEN field
+        std::uint32_t const max_digit_ticks{0x3FFFFFFFU/sizeof(register_t)};
+
+      // Control blocks: per frame, blank, set, clear, select and delay for
+      // each digit
+        std::size_t count_control_blocks(std::size_t digits)
+        {
+          return 2U*multiplexed_display_cbs_per_digit*digits;
+        }
+
+      // Data words: blank masks, select masks per digit, set and clear
+      // masks per digit per frame and the PWM FIFO word
+        std::size_t data_words(std::size_t digits)
+        {
+          return 2U+2U*digits+2U*4U*digits+1U;
+        }
+      }
+
+      std::size_t multiplexed_display_program_size(std::size_t digits)
+      {
+        return count_control_blocks(digits)*sizeof(dma_control_block)
+             + data_words(digits)*sizeof(register_t);
+      }
+
+      multiplexed_display_program compile_multiplexed_display
+      ( dma_region & region
+      , std::size_t digits
+      , std::uint32_t digit_ticks
+      , bool selects_low
+      )
+      {
+        if (digits==0U || digit_ticks==0U || digit_ticks>max_digit_ticks)
+          {
+            throw std::invalid_argument{"compile_multiplexed_display: digits "
+                                        "or digit_ticks is zero or "
+                                        "digit_ticks is too large."};
+          }
+        std::size_t const cb_count{count_control_blocks(digits)};
+        std::size_t const frame_cb_count{cb_count/2U};
+        dma_control_block * cbs{region.allocate_control_blocks(cb_count)};
+        register_t * data{static_cast<register_t *>
+                            (region.allocate( data_words(digits)
+                                             *sizeof(register_t)
+                                            ).address
+                            )};
+        for (std::size_t idx=0; idx!=data_words(digits); ++idx)
+          {
+            data[idx] = 0U;
+          }
+        register_t * const blank_masks{data};
+        register_t * const select_masks{data+2U};
+        register_t * const frame_masks[2]{ data+2U+2U*digits
+                                         , data+2U+6U*digits
+                                         };
+        register_t * const fifo_word{data+2U+10U*digits};
+        register_t const blank_bus
+                      {selects_low ? gpset0_bus_address : gpclr0_bus_address};
+        register_t const select_bus
+                      {selects_low ? gpclr0_bus_address : gpset0_bus_address};
+        register_t const write_ti{ dma_control_block::ti_no_wide_bursts
+                                 | dma_control_block::ti_wait_resp
+                                 | dma_control_block::ti_src_inc
+                                 | dma_control_block::ti_dest_inc
+                                 };
+        register_t const delay_ti{ dma_control_block::ti_no_wide_bursts
+                                 | dma_control_block::ti_wait_resp
+                                 | dma_control_block::ti_dest_dreq
+                                 | dma_control_block::ti_permap(dma_dreq::pwm)
+                                 };
+        multiplexed_display_program program;
+        for (std::size_t f=0; f!=2U; ++f)
+          {
+            dma_control_block * const frame_cbs{cbs+f*frame_cb_count};
+            std::size_t cb_idx{0U};
+            auto add_cb = [&]( register_t ti, register_t src, register_t dest
+                             , register_t length
+                             )
+                          {
+                            dma_control_block & cb(frame_cbs[cb_idx]);
+                            cb.transfer_info = ti;
+                            cb.source_address = src;
+                            cb.dest_address = dest;
+                            cb.transfer_length = length;
+                            cb.stride = 0U;
+                            ++cb_idx;
+                            cb.next_control_block
+                              = region.bus_address
+                                        (frame_cbs+(cb_idx%frame_cb_count));
+                            cb.reserved_do_not_use[0] = 0U;
+                            cb.reserved_do_not_use[1] = 0U;
+                          };
+            register_t const mask_length{2U*sizeof(register_t)};
+            for (std::size_t digit=0; digit!=digits; ++digit)
+              {
+                register_t * const masks{frame_masks[f]+4U*digit};
+                add_cb( write_ti, region.bus_address(blank_masks), blank_bus
+                      , mask_length
+                      );
+                add_cb( write_ti, region.bus_address(masks)
+                      , gpset0_bus_address, mask_length
+                      );
+                add_cb( write_ti, region.bus_address(masks+2U)
+                      , gpclr0_bus_address, mask_length
+                      );
+                add_cb( write_ti, region.bus_address(select_masks+2U*digit)
+                      , select_bus, mask_length
+                      );
+                add_cb( delay_ti, region.bus_address(fifo_word)
+                      , pwm_fifo_bus_address
+                      , static_cast<register_t>
+                                          (digit_ticks*sizeof(register_t))
+                      );
+              }
+            program.first_bus[f] = region.bus_address(frame_cbs);
+            program.loop_next[f]
+                      = &frame_cbs[frame_cb_count-1U].next_control_block;
+            program.frame_masks[f] = frame_masks[f];
+          }
+        program.blank_masks = blank_masks;
+        program.select_masks = select_masks;
+        return program;
+      }
+
+      namespace
+      {
+      // PWM clock and range giving one PWM FIFO word consumed per microsecond
+        hertz const pwm_clock_source_frequency{megahertz{500U}};
+        hertz const pwm_clock_frequency{megahertz{10U}};
+        register_t const pwm_words_per_tick_range{10U};
+      }
+    } // namespace internal closed
+
+    using namespace internal;
+
+    multiplexed_display::multiplexed_display
+    ( opin_group const & segment_pins
+    , opin_group const & digit_pins
+    , std::uint32_t digit_us
+    , bool segments_active_low
+    , bool digits_active_low
+    )
+    : segments(segment_pins)
+    , selects(digit_pins)
+    , segments_low{segments_active_low}
+    , selects_low{digits_active_low}
+    , patterns(digit_pins.size(), 0U)
+    , digit_time{digit_us}
+    , frame{0U}
+    {
+      if ( (segments.bank_masks[0]&selects.bank_masks[0])!=0U
+        || (segments.bank_masks[1]&selects.bank_masks[1])!=0U
+         )
+        {
+          throw std::invalid_argument{"multiplexed_display: segment and digit "
+                                      "pin groups have pins in common."};
+        }
+      std::size_t const code_size
+                          {multiplexed_display_program_size(patterns.size())};
+      code.reset(new dma_arena{code_size});
+      dma_buffer const code_buffer
+                          {code->allocate(code_size, alignof(dma_control_block))};
+      dma_region region{ code_buffer.address, code_buffer.bus_address
+                       , code_buffer.size
+                       };
+      multiplexed_display_program const program
+                  {compile_multiplexed_display( region, patterns.size()
+                                              , digit_us, digits_active_low
+                                              )};
+      std::uint32_t banks[2];
+      selects.to_bank_masks(selects.all_pins(), banks);
+      program.blank_masks[0] = banks[0];
+      program.blank_masks[1] = banks[1];
+      for (std::size_t digit=0; digit!=patterns.size(); ++digit)
+        {
+          selects.to_bank_masks(pin_group_value_t(1)<<digit, banks);
+          program.select_masks[2U*digit] = banks[0];
+          program.select_masks[2U*digit+1U] = banks[1];
+        }
+      for (std::size_t f=0; f!=2U; ++f)
+        {
+          frame_bus[f] = program.first_bus[f];
+          loop_next[f] = program.loop_next[f];
+          frame_masks[f] = program.frame_masks[f];
+        }
+    // All segments start off in both frames
+      write_frame(0U, patterns);
+      write_frame(1U, patterns);
+      pwm_ctrl & pwm(pwm_ctrl::instance());
+      pwm.set_clock(clock_parameters{ clock_source::plld
+                                    , pwm_clock_source_frequency
+                                    , clock_frequency{pwm_clock_frequency}
+                                    });
+      if (!pwm.alloc.allocate(0U))
+        {
+          throw bad_peripheral_alloc{"multiplexed_display: PWM channel 1 is "
+                                     "in use."};
+        }
+      if (!pwm.fifo_alloc.allocate(0U))
+        {
+          pwm.alloc.deallocate(0U);
+          throw bad_peripheral_alloc{"multiplexed_display: PWM FIFO is in "
+                                     "use."};
+        }
+      try
+        {
+          dma_channel = dma_ctrl::instance().allocate_channel();
+        }
+      catch (...)
+        {
+          pwm.fifo_alloc.deallocate(0U);
+          pwm.alloc.deallocate(0U);
+          throw;
+        }
+      pwm_channel const ch{pwm_channel::pwm_ch1};
+      pwm.regs->set_enable(ch, false);
+      pwm.regs->set_dma_enable(false);
+      pwm.regs->set_mode(ch, pwm_mode::serialiser);
+      pwm.regs->set_use_fifo(ch, true);
+      pwm.regs->set_range(ch, pwm_words_per_tick_range);
+      pwm.regs->clear_fifo();
+      pwm.regs->set_dma_data_req_threshold(15U);
+      pwm.regs->set_dma_panic_threshold(15U);
+      pwm.regs->set_dma_enable(true);
+      pwm.regs->set_enable(ch, true);
+    }
+
+    multiplexed_display::~multiplexed_display()
+    {
+      stop();
+      dma_ctrl::instance().deallocate_channel(dma_channel);
+      pwm_ctrl & pwm(pwm_ctrl::instance());
+      pwm.regs->set_enable(pwm_channel::pwm_ch1, false);
+      pwm.regs->set_dma_enable(false);
+      pwm.fifo_alloc.deallocate(0U);
+      pwm.alloc.deallocate(0U);
+    }
+
+    bool multiplexed_display::is_playing_frame(std::size_t f) const
+    {
+      std::uint32_t const cb_bus
+            {dma_ctrl::instance().regs->channel[dma_channel]
+                                                      .control_block_address};
+      std::uint32_t const frame_size
+            {static_cast<std::uint32_t>( multiplexed_display_cbs_per_digit
+                                        *patterns.size()
+                                        *sizeof(dma_control_block)
+                                       )};
+      return cb_bus>=frame_bus[f] && cb_bus-frame_bus[f]<frame_size;
+    }
+
+    void multiplexed_display::write_frame
+    ( std::size_t f
+    , std::vector<pin_group_value_t> const & digit_segments
+    )
+    {
+      for (std::size_t digit=0; digit!=digit_segments.size(); ++digit)
+        {
+          pin_group_value_t const lit{digit_segments[digit]};
+          pin_group_value_t const unlit{segments.all_pins()&~lit};
+          std::uint32_t set_banks[2];
+          std::uint32_t clear_banks[2];
+          segments.to_bank_masks(segments_low ? unlit : lit, set_banks);
+          segments.to_bank_masks(segments_low ? lit : unlit, clear_banks);
+          std::uint32_t volatile * const masks{frame_masks[f]+4U*digit};
+          masks[0] = set_banks[0];
+          masks[1] = set_banks[1];
+          masks[2] = clear_banks[0];
+          masks[3] = clear_banks[1];
+        }
+    }
+
+    void multiplexed_display::blank() const
+    {
+      std::uint32_t banks[2];
+      selects.to_bank_masks(selects.all_pins(), banks);
+      auto & regs(gpio_ctrl::instance().regs);
+      for (std::size_t bank=0; bank!=2; ++bank)
+        {
+          if (banks[bank]==0U)
+            {
+              continue;
+            }
+          if (selects_low)
+            {
+              regs->set_pins(bank, banks[bank]);
+            }
+          else
+            {
+              regs->clear_pins(bank, banks[bank]);
+            }
+        }
+    }
+
+    void multiplexed_display::start()
+    {
+      volatile dma_channel_registers &
+                              ch(dma_ctrl::instance().regs->channel[dma_channel]);
+      ch.reset();
+      pwm_ctrl::instance().regs->clear_fifo();
+      ch.start(frame_bus[frame]);
+    }
+
+    void multiplexed_display::stop()
+    {
+      dma_ctrl::instance().regs->channel[dma_channel].reset();
+      blank();
+    }
+
+    bool multiplexed_display::is_running() const
+    {
+      return dma_ctrl::instance().regs->channel[dma_channel].is_active();
+    }
+
+    void multiplexed_display::show
+    ( std::vector<pin_group_value_t> const & digit_segments
+    )
+    {
+      if (digit_segments.size()!=patterns.size())
+        {
+          throw std::invalid_argument{"multiplexed_display::show: number of "
+                                      "patterns is not the number of digits."};
+        }
+      for (pin_group_value_t pattern : digit_segments)
+        {
+          if (pattern&~segments.all_pins())
+            {
+              throw std::invalid_argument{"multiplexed_display::show: pattern "
+                                          "has bits set for segments not in "
+                                          "the segment pin group."};
+            }
+        }
+      std::size_t const next{1U-frame};
+    // The frame not shown may still be playing to the end of a refresh if
+    // it was switched away from less than a refresh cycle ago.
+      while (is_running() && is_playing_frame(next))
+        {
+          std::this_thread::sleep_for(std::chrono::microseconds{digit_time});
+        }
+      write_frame(next, digit_segments);
+      *loop_next[next] = frame_bus[next];
+    // Masks must be in memory before the DMA can be pointed at them
+      std::atomic_thread_fence(std::memory_order_release);
+      *loop_next[frame] = frame_bus[next];
+      frame = next;
+      patterns = digit_segments;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,75 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file multiplexed_display_compiler.h
+/// @brief \b Internal : compile a multiplexed display refresh program into
+/// DMA control blocks : type and function declarations.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_MULTIPLEXED_DISPLAY_COMPILER_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_MULTIPLEXED_DISPLAY_COMPILER_H
+
+# include "dma_arena.h"
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Locations within a compiled multiplexed display program.
+    ///
+    /// The program has two frames, each refreshing every digit once then
+    /// looping back to its own start. Each digit of a frame is shown by
+    /// writing the blank masks to deselect all digits, the digit's segment
+    /// set then clear masks, then the digit's select masks, followed by a
+    /// delay. Pointing the last control block of the frame being played at
+    /// the other frame switches frames at the end of the current refresh.
+      struct multiplexed_display_program
+      {
+        register_t            first_bus[2];   ///< Bus address of each
+                                              ///< frame's first CB
+        register_t volatile * loop_next[2];   ///< Next CB field of each
+                                              ///< frame's last CB
+        register_t volatile * blank_masks;    ///< Deselect all digits: 2
+                                              ///< words for GPxxx0/1
+        register_t volatile * select_masks;   ///< Select each digit: 2 words
+                                              ///< per digit
+        register_t volatile * frame_masks[2]; ///< Each frame's segment masks:
+                                              ///< GPSET0/1 then GPCLR0/1, 4
+                                              ///< words per digit
+      };
+
+    /// @brief Number of control blocks per digit of each frame.
+      constexpr std::size_t multiplexed_display_cbs_per_digit{5U};
+
+    /// @brief Returns region bytes needed to compile a multiplexed display
+    /// program.
+    /// @param digits Number of digits.
+      std::size_t multiplexed_display_program_size(std::size_t digits);
+
+    /// @brief Compile a two frame multiplexed display program with all masks
+    /// zero.
+    ///
+    /// Frame 0's control blocks are followed by frame 1's, then the data.
+    /// The blank control blocks write to GPSET0/1 and select control blocks
+    /// to GPCLR0/1 if selects_low, otherwise the reverse. Delays write to the
+    /// PWM FIFO paced by the PWM DREQ.
+    ///
+    /// @param region       Region to allocate program memory from.
+    /// @param digits       Number of digits.
+    /// @param digit_ticks  PWM FIFO words, pacing ticks, each digit is shown.
+    /// @param selects_low  True if a digit is selected by a low level.
+    /// @returns Locations within the compiled program.
+    /// @throws std::invalid_argument if digits or digit_ticks is zero or
+    ///         digit_ticks is too large for one control block transfer.
+    /// @throws std::bad_alloc if region does not have enough space.
+      multiplexed_display_program compile_multiplexed_display
+      ( dma_region & region
+      , std::size_t digits
+      , std::uint32_t digit_ticks
+      , bool selects_low
+      );
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_MULTIPLEXED_DISPLAY_COMPILER_H
@@ -0,0 +1,108 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file od_pin.cpp
+/// @brief Open drain output pin and pin group implementations.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "od_pin.h"
+#include "gpio_ctrl.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+      std::size_t const pins_per_fsel_word{10U};
+      unsigned const bits_per_fsel_field{3U};
+      std::uint32_t const fsel_field_mask{7U};
+
+    // Output is 001 and input 000 so output value bits double as the pins'
+    // field positions.
+      std::uint32_t fsel_output_bit(pin_id p)
+      {
+        return 1U<<((p%pins_per_fsel_word)*bits_per_fsel_field);
+      }
+    }
+
+    od_pin::od_pin(pin_id p, bool pull_up)
+    : ipin{p, pull_up ? ipin::pull_up : ipin::pull_disable}
+    , config{&internal::gpio_ctrl::instance().config}
+    , fsel_idx{p/pins_per_fsel_word}
+    , fsel_mask{fsel_output_bit(p)*fsel_field_mask}
+    , fsel_output{fsel_output_bit(p)}
+    {
+    // Output level only takes effect while the pin is an output
+      *bank_register(internal::gpclr0_word_offset) = bank_mask();
+    }
+
+    od_pin::~od_pin()
+    {
+      if (is_open())
+        {
+          release();
+        }
+    }
+
+    void od_pin::set_output(bool output)
+    {
+      config->update_fsel(fsel_idx, fsel_mask, output ? fsel_output : 0U);
+    }
+
+    od_pin_group::od_pin_group
+    ( std::initializer_list<pin_id> pins
+    , bool pull_up
+    )
+    : ipin_group(pins, pull_up ? ipin::pull_up : ipin::pull_disable)
+    , config{&internal::gpio_ctrl::instance().config}
+    {
+      for (std::size_t i=0U; i!=size(); ++i)
+        {
+          output_bits[i] = fsel_output_bit(get_pin(i));
+        }
+      std::uint32_t volatile * words{internal::gpio_register_words()};
+      for (std::size_t bank=0U; bank!=2U; ++bank)
+        {
+          if (bank_masks[bank]!=0U)
+            {
+              words[internal::gpclr0_word_offset+bank] = bank_masks[bank];
+            }
+        }
+    }
+
+    od_pin_group::~od_pin_group()
+    {
+      release(all_pins());
+    }
+
+    void od_pin_group::set_outputs
+    ( pin_group_value_t mask
+    , pin_group_value_t outputs
+    )
+    {
+      std::size_t const fsel_words{internal::gpio_config::fsel_words};
+      std::uint32_t masks[fsel_words]{};
+      std::uint32_t values[fsel_words]{};
+      mask &= all_pins();
+      for (std::size_t i=0U; mask!=0U; ++i, mask>>=1, outputs>>=1)
+        {
+          if (mask&1U)
+            {
+              std::size_t const idx{pins[i]/pins_per_fsel_word};
+              masks[idx] |= output_bits[i]*fsel_field_mask;
+              if (outputs&1U)
+                {
+                  values[idx] |= output_bits[i];
+                }
+            }
+        }
+      for (std::size_t idx=0U; idx!=fsel_words; ++idx)
+        {
+          if (masks[idx]!=0U)
+            {
+              config->update_fsel(idx, masks[idx], values[idx]);
+            }
+        }
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
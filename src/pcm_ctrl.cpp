@@ -0,0 +1,29 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pcm_ctrl.cpp
+/// @brief Internal PCM control type implantation and definition.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "pcm_ctrl.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      pcm_ctrl::pcm_ctrl()
+      : regs( peripheral_window::instance()
+            , pcm_registers::physical_address
+            , register_block_size
+            )
+      , allocated(false)
+      {}
+
+      pcm_ctrl & pcm_ctrl::instance()
+      {
+        static pcm_ctrl pcm_control_area;
+        return pcm_control_area;
+      }
+    }
+  }
+}}
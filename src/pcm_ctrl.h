@@ -0,0 +1,49 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pcm_ctrl.h
+/// @brief \b Internal : PCM control type & supporting definitions.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_PCM_CTRL_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_PCM_CTRL_H
+
+# include "phymem_ptr.h"
+# include "pcm_registers.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief PCM control type. There is only 1 (yes it's a singleton!)
+    ///
+    /// Maps BCM2708 / 2835 PCM registers into the requisite physical memory
+    /// mapped area and provides a simple allocated flag for in-process PCM
+    /// use tracking.
+    ///
+    /// Note that the PCM clock is allocated and controlled separately through
+    /// clock_ctrl.
+      struct pcm_ctrl
+      {
+      /// @brief Pointer to BCM2708 / BCM2835 PCM control registers instance
+        phymem_ptr<volatile pcm_registers>        regs;
+
+      /// @brief PCM interface allocation flag
+        bool  allocated;
+
+      /// @brief Singleton instance getter
+      /// @returns \e The instance of the PCM control object.
+        static pcm_ctrl & instance();
+
+      private:
+        pcm_ctrl();
+
+        pcm_ctrl(pcm_ctrl const &) = delete;
+        pcm_ctrl(pcm_ctrl &&) = delete;
+        pcm_ctrl & operator=(pcm_ctrl const &) = delete;
+        pcm_ctrl & operator=(pcm_ctrl &&) = delete;
+      };
+   } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_PCM_CTRL_H
@@ -0,0 +1,224 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pcm_dma_stream.cpp
+/// @brief Double-buffered DMA streaming for the PCM / I2S interface
+/// implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "pcm_dma_stream.h"
+#include "pcm_ctrl.h"
+#include "dma_ctrl.h"
+#include "dma_arena.h"
+#include <cstddef>
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using namespace internal;
+
+    namespace
+    {
+      register_t const pcm_fifo_bus_address
+                { peripheral_bus_address(pcm_registers::physical_address)
+                + static_cast<register_t>(offsetof(pcm_registers, fifo))
+                };
+
+    // DREQ levels: request when the RX FIFO holds 32 words or the TX FIFO
+    // has fewer than 48, panic (AXI priority) at 48 and 16 words.
+      register_t const rx_dreq_level{0x20U};
+      register_t const tx_dreq_level{0x30U};
+      register_t const rx_panic_level{0x30U};
+      register_t const tx_panic_level{0x10U};
+
+      void start_channel(std::size_t channel, register_t cb_bus)
+      {
+        volatile dma_channel_registers &
+                              dma(dma_ctrl::instance().regs->channel[channel]);
+        dma.reset();
+        dma.start(cb_bus);
+      }
+    }
+
+    pcm_dma_stream::pcm_dma_stream
+    ( pcm_pins & pins
+    , std::size_t frames_per_buffer
+    )
+    : pcm(pins)
+    , samples{frames_per_buffer*pins.frame_format().channels()}
+    , tx{{nullptr,nullptr}, {0U,0U}, 0U, 1U, pins.can_transmit()}
+    , rx{{nullptr,nullptr}, {0U,0U}, 0U, 0U, pins.can_receive()}
+    {
+      if (frames_per_buffer==0U)
+        {
+          throw std::invalid_argument{"pcm_dma_stream::pcm_dma_stream: "
+                                      "buffers have no frames."};
+        }
+      std::size_t const buffer_bytes{samples*sizeof(register_t)};
+      unsigned const directions{(tx.used ? 1U : 0U) + (rx.used ? 1U : 0U)};
+      memory.reset(new dma_arena{ directions*2U*( buffer_bytes
+                                                + sizeof(dma_control_block)
+                                                )
+                                });
+      struct setup
+      {
+        direction &   d;
+        register_t    ti;
+        bool          to_fifo;
+      };
+      setup const setups[2]
+      { { tx
+        , dma_control_block::ti_src_inc | dma_control_block::ti_dest_dreq
+          | dma_control_block::ti_permap(dma_dreq::pcm_tx)
+        , true
+        }
+      , { rx
+        , dma_control_block::ti_dest_inc | dma_control_block::ti_src_dreq
+          | dma_control_block::ti_permap(dma_dreq::pcm_rx)
+        , false
+        }
+      };
+      for (auto const & s : setups)
+        {
+          if (!s.d.used)
+            {
+              continue;
+            }
+          dma_control_block * cbs{memory->allocate_control_blocks(2U)};
+          for (unsigned idx=0U; idx!=2U; ++idx)
+            {
+              dma_buffer const buffer{memory->allocate(buffer_bytes)};
+              register_t * entries{static_cast<register_t *>(buffer.address)};
+              for (std::size_t n=0U; n!=samples; ++n)
+                {
+                  entries[n] = 0U;
+                }
+              s.d.buffer[idx] = entries;
+              s.d.cb_bus[idx] = memory->bus_address(cbs+idx);
+              cbs[idx].transfer_info = s.ti
+                                     | dma_control_block::ti_no_wide_bursts
+                                     | dma_control_block::ti_wait_resp;
+              cbs[idx].source_address = s.to_fifo ? buffer.bus_address
+                                                  : pcm_fifo_bus_address;
+              cbs[idx].dest_address = s.to_fifo ? pcm_fifo_bus_address
+                                                : buffer.bus_address;
+              cbs[idx].transfer_length = static_cast<register_t>(buffer_bytes);
+              cbs[idx].stride = 0U;
+              cbs[idx].reserved_do_not_use[0] = 0U;
+              cbs[idx].reserved_do_not_use[1] = 0U;
+            }
+        // Link the pair's control blocks to each other
+          cbs[0].next_control_block = s.d.cb_bus[1];
+          cbs[1].next_control_block = s.d.cb_bus[0];
+        }
+      if (tx.used)
+        {
+          tx.channel = dma_ctrl::instance().allocate_channel();
+        }
+      if (rx.used)
+        {
+          try
+          {
+            rx.channel = dma_ctrl::instance().allocate_channel();
+          }
+          catch (...)
+          {
+            if (tx.used)
+              {
+                dma_ctrl::instance().deallocate_channel(tx.channel);
+              }
+            throw;
+          }
+        }
+      auto & regs(pcm_ctrl::instance().regs);
+      regs->set_dma_request_levels( rx_dreq_level, tx_dreq_level
+                                  , rx_panic_level, tx_panic_level
+                                  );
+      regs->set_control(pcm_registers::cs_dma_enable, true);
+      if (tx.used)
+        {
+          start_channel(tx.channel, tx.cb_bus[0]);
+        }
+      if (rx.used)
+        {
+          start_channel(rx.channel, rx.cb_bus[0]);
+        }
+      pcm.start();
+    }
+
+    pcm_dma_stream::~pcm_dma_stream()
+    {
+      pcm.stop();
+      if (tx.used)
+        {
+          dma_ctrl::instance().deallocate_channel(tx.channel);
+        }
+      if (rx.used)
+        {
+          dma_ctrl::instance().deallocate_channel(rx.channel);
+        }
+      pcm_ctrl::instance().regs->set_control
+                                          (pcm_registers::cs_dma_enable, false);
+    }
+
+    unsigned pcm_dma_stream::active_buffer(direction const & d)
+    {
+      return dma_ctrl::instance().regs->channel[d.channel].control_block_address
+                == d.cb_bus[1] ? 1U : 0U;
+    }
+
+    std::uint32_t volatile * pcm_dma_stream::try_buffer(direction & d)
+    {
+      if (!d.used || active_buffer(d)==d.next)
+        {
+          return nullptr;
+        }
+      std::uint32_t volatile * buffer{d.buffer[d.next]};
+      d.next ^= 1U;
+      return buffer;
+    }
+
+    std::uint32_t volatile * pcm_dma_stream::try_tx_buffer()
+    {
+      return try_buffer(tx);
+    }
+
+    std::uint32_t volatile * pcm_dma_stream::wait_tx_buffer()
+    {
+      if (!tx.used)
+        {
+          throw std::logic_error{"pcm_dma_stream::wait_tx_buffer: PCM pins "
+                                 "cannot transmit."};
+        }
+      adaptive_wait waiter(waiting, wait_counts);
+      std::uint32_t volatile * buffer{nullptr};
+      while ((buffer=try_buffer(tx))==nullptr)
+        {
+          waiter.pause();
+        }
+      return buffer;
+    }
+
+    std::uint32_t volatile const * pcm_dma_stream::try_rx_buffer()
+    {
+      return try_buffer(rx);
+    }
+
+    std::uint32_t volatile const * pcm_dma_stream::wait_rx_buffer()
+    {
+      if (!rx.used)
+        {
+          throw std::logic_error{"pcm_dma_stream::wait_rx_buffer: PCM pins "
+                                 "cannot receive."};
+        }
+      adaptive_wait waiter(waiting, wait_counts);
+      std::uint32_t volatile * buffer{nullptr};
+      while ((buffer=try_buffer(rx))==nullptr)
+        {
+          waiter.pause();
+        }
+      return buffer;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
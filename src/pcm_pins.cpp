@@ -0,0 +1,448 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pcm_pins.cpp
+/// @brief Use a set of GPIO pins for use with PCM / I2S: implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "pcm_pins.h"
+#include "gpio_alt_fn.h"
+#include "gpio_ctrl.h"
+#include "pcm_ctrl.h"
+#include "clock_ctrl.h"
+#include "clock_parameters.h"
+#include "system_timer.h"
+#include "periexcept.h"
+#include "trace_marker.h"
+#include <algorithm>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using internal::pcm_ctrl;
+    using internal::pcm_registers;
+    using internal::clock_ctrl;
+    using internal::gpio_ctrl;
+    using internal::pin_alt_fn::gpio_special_fn;
+    using internal::gpio_pin_fn;
+
+    namespace
+    {
+    // PCM bit clock source: PLLD, with MASH filtering for fractional division
+      hertz const pcm_clock_source_frequency{megahertz{500U}};
+
+    // Longest time to wait for the PCM SYNC bit to echo a write: 2 PCM clocks
+    // of even a slow external clock.
+      std::uint64_t const sync_timeout_us{10000U};
+
+      gpio_pin_fn get_alt_fn(pin_id pin, gpio_special_fn special_fn)
+      {
+        using internal::pin_alt_fn::result_set;
+        using internal::pin_alt_fn::select;
+        auto pin_fn_info( select(pin,special_fn) );
+        if (pin_fn_info.empty())
+          {
+            throw std::invalid_argument
+                  { "pcm_pins::pcm_pins: Pin does not support "
+                    "requested PCM special function."
+                  };
+          }
+        if (pin_fn_info.size()!=1)
+          {
+            throw std::range_error // NO pin has >1 PCM function
+                  {"pcm_pins::pcm_pins: Internal data error: more than one "
+                   "pin alt function selected that supports the requested "
+                   "PCM special function."
+                  };
+          }
+        return pin_fn_info[0].alt_fn();
+      }
+
+      std::uint32_t channel_field
+      ( pcm_channel const & ch
+      , unsigned frame_length
+      )
+      {
+        std::uint32_t const field
+                      {pcm_registers::channel_config(ch.width, ch.position)};
+        if (field==0U || ch.position+ch.width>frame_length)
+          {
+            throw std::invalid_argument{"pcm_frame_format: channel width or "
+                                        "position out of range or channel "
+                                        "does not fit in the frame."};
+          }
+        return field;
+      }
+
+    // Wait for two PCM clocks by toggling SYNC and waiting for the echo
+      void wait_pcm_clocks()
+      {
+        auto & regs(pcm_ctrl::instance().regs);
+        bool const sync(!regs->get_flag(pcm_registers::cs_sync));
+        regs->set_control(pcm_registers::cs_sync, sync);
+        std::uint64_t const start_us{system_timer::now_us()};
+        while ( regs->get_flag(pcm_registers::cs_sync)!=sync
+             && system_timer::now_us()-start_us<sync_timeout_us
+              )
+          {
+          }
+      }
+    }
+
+    constexpr auto clk_idx(0U);
+    constexpr auto fs_idx(1U);
+    constexpr auto din_idx(2U);
+    constexpr auto dout_idx(3U);
+
+    pcm_frame_format::pcm_frame_format
+    ( unsigned frame_length
+    , unsigned fs_length
+    , pcm_channel ch1
+    , pcm_channel ch2
+    , bool clock_invert
+    , bool fs_invert
+    )
+    : mode_reg{0U}
+    , channel_reg{0U}
+    , frame_bits{frame_length}
+    , channel_count{ch2.width==0U ? 1U : 2U}
+    {
+      if ( frame_length==0U || frame_length>pcm_registers::max_frame_bits
+        || fs_length==0U || fs_length>pcm_registers::mode_fs_length_mask
+         )
+        {
+          throw std::invalid_argument{"pcm_frame_format: frame length or "
+                                      "frame sync length out of range."};
+        }
+      mode_reg = ((frame_length-1U)<<pcm_registers::mode_frame_length_bit)
+               | fs_length
+               | (clock_invert ? register_t(pcm_registers::mode_clock_invert)
+                               : 0U)
+               | (fs_invert ? register_t(pcm_registers::mode_fs_invert) : 0U);
+      channel_reg = channel_field(ch1, frame_length)
+                                                <<pcm_registers::xc_ch1_shift;
+      if (channel_count==2U)
+        {
+          channel_reg |= channel_field(ch2, frame_length);
+        }
+    }
+
+    pcm_frame_format pcm_frame_format::i2s
+    ( unsigned sample_bits
+    , unsigned slot_bits
+    )
+    {
+      if ( sample_bits<8U || sample_bits>32U || slot_bits<=sample_bits
+        || slot_bits>pcm_registers::max_frame_bits/2U
+         )
+        {
+          throw std::invalid_argument{"pcm_frame_format::i2s: sample or slot "
+                                      "bits out of range."};
+        }
+      return pcm_frame_format{ 2U*slot_bits, slot_bits
+                             , pcm_channel{sample_bits, 1U}
+                             , pcm_channel{sample_bits, slot_bits+1U}
+                             , true, true
+                             };
+    }
+
+    pcm_pins::~pcm_pins()
+    {
+      auto & regs(pcm_ctrl::instance().regs);
+      regs->control_and_status = 0U;
+      if (clock_master)
+        {
+          clock_ctrl & clk_ctrl(clock_ctrl::instance());
+          clk_ctrl.regs->set_enable(internal::pcm_clk_id, false);
+          clk_ctrl.alloc.deallocate(internal::pcmclk);
+        }
+      for (auto pin : pins)
+        {
+          if (pin!=pcm_pin_not_used)
+            {
+              gpio_ctrl::instance().alloc.deallocate(pin_id(pin));
+            }
+        }
+      pcm_ctrl::instance().allocated = false;
+    }
+
+    void pcm_pins::construct
+    ( pin_id clk
+    , pin_id fs
+    , pin_id din
+    , pin_id dout
+    , hertz bit_clock
+    , pcm_role clock_role
+    , pcm_role fs_role
+    )
+    {
+      pins.fill(pcm_pin_not_used);
+      clock_master = clock_role==pcm_role::master;
+      bool const receive(din!=pcm_pin_not_used);
+      bool const transmit(dout!=pcm_pin_not_used);
+      if (!receive && !transmit)
+        {
+          throw std::invalid_argument{"pcm_pins::pcm_pins: Neither DIN nor "
+                                      "DOUT pins are used."};
+        }
+    // Get each pin's alt function for its PCM special function.
+    // Note: any of these can throw - but nothing allocated yet so OK
+      gpio_pin_fn alt_fn[number_of_pins]{};
+      alt_fn[clk_idx] = get_alt_fn(clk, gpio_special_fn::pcm_clk);
+      alt_fn[fs_idx] = get_alt_fn(fs, gpio_special_fn::pcm_fs);
+      if (receive)
+        {
+          alt_fn[din_idx] = get_alt_fn(din, gpio_special_fn::pcm_din);
+        }
+      if (transmit)
+        {
+          alt_fn[dout_idx] = get_alt_fn(dout, gpio_special_fn::pcm_dout);
+        }
+    // Calculate clock divisors before allocating - can throw
+      internal::clock_parameters const cp
+        { clock_source::plld
+        , pcm_clock_source_frequency
+        , clock_frequency{bit_clock, clock_filter::minimum}
+        };
+    // Only one PCM peripheral so can check whether it is in use before
+    // starting on pin allocations
+      if ( pcm_ctrl::instance().allocated )
+        {
+          throw bad_peripheral_alloc( "pcm_pins::pcm_pins: PCM is "
+                                      "already being used locally."
+                                    );
+        }
+
+    // Speculatively allocate PCM peripheral
+      pcm_ctrl::instance().allocated = true;
+
+      pin_id const requested[number_of_pins]{clk, fs, din, dout};
+      try
+      {
+        for (unsigned idx=0U; idx!=number_of_pins; ++idx)
+          {
+            if (requested[idx]!=pcm_pin_not_used)
+              {
+                gpio_ctrl::instance().alloc.allocate(requested[idx]);//CAN THROW
+                pins[idx] = requested[idx];
+              }
+          }
+        if (clock_master)
+          {
+            clock_ctrl::allocate_and_initialise_clock(internal::pcmclk, cp);
+          }
+      }
+      catch (...)
+      { // Oops - failed to complete resource acquisition and initialisation;
+      // Release resources allocated so far and re-throw
+        for (auto pin : pins)
+          {
+            if (pin!=pcm_pin_not_used)
+              {
+                gpio_ctrl::instance().alloc.deallocate(pin_id(pin));
+              }
+          }
+        pcm_ctrl::instance().allocated = false;
+        throw;
+      }
+      if (clock_master)
+        {
+          clock_ctrl::instance().regs->set_enable(internal::pcm_clk_id, true);
+        }
+
+      auto & regs(pcm_ctrl::instance().regs);
+      regs->control_and_status = 0U;
+      regs->mode = format.mode_reg
+                 | (clock_master ? 0U
+                                 : register_t(pcm_registers::mode_clock_slave))
+                 | (fs_role==pcm_role::master
+                              ? 0U : register_t(pcm_registers::mode_fs_slave));
+      regs->transmit_config = transmit ? format.channel_reg : 0U;
+      regs->receive_config = receive ? format.channel_reg : 0U;
+      regs->interrupt_enables = 0U;
+      regs->control_and_status = pcm_registers::cs_enable
+                               | pcm_registers::cs_standby;
+
+      internal::gpio_pin_fn_setting pin_fns[number_of_pins]
+      { {clk, alt_fn[clk_idx]}
+      , {fs, alt_fn[fs_idx]}
+      , {din, alt_fn[din_idx]}
+      , {dout, alt_fn[dout_idx]}
+      };
+      auto const pin_fns_end
+        (std::remove_if( pin_fns, pin_fns+number_of_pins
+                       , [](internal::gpio_pin_fn_setting const & setting)
+                         { return setting.pin==pcm_pin_not_used; }
+                       ));
+      gpio_ctrl::instance().config.set_pin_functions
+                                                        (pin_fns, pin_fns_end);
+      clear_fifos();
+    }
+
+    bool pcm_pins::can_transmit() const
+    {
+      return pins[dout_idx]!=pcm_pin_not_used;
+    }
+
+    bool pcm_pins::can_receive() const
+    {
+      return pins[din_idx]!=pcm_pin_not_used;
+    }
+
+    void pcm_pins::start()
+    {
+      pcm_ctrl::instance().regs->set_control
+        ( (can_transmit() ? register_t(pcm_registers::cs_tx_on) : 0U)
+        | (can_receive() ? register_t(pcm_registers::cs_rx_on) : 0U)
+        , true
+        );
+    }
+
+    void pcm_pins::stop()
+    {
+      pcm_ctrl::instance().regs->set_control
+        (pcm_registers::cs_tx_on|pcm_registers::cs_rx_on, false);
+    }
+
+    bool pcm_pins::is_running() const
+    {
+      return pcm_ctrl::instance().regs->get_flag
+                            (pcm_registers::cs_tx_on|pcm_registers::cs_rx_on);
+    }
+
+    void pcm_pins::clear_fifos()
+    {
+      pcm_ctrl::instance().regs->set_control
+        (pcm_registers::cs_tx_clear|pcm_registers::cs_rx_clear, true);
+      wait_pcm_clocks();
+    }
+
+    void pcm_pins::check_errors()
+    {
+      auto & regs(pcm_ctrl::instance().regs);
+      register_t const cs{regs->control_and_status};
+      if (cs&(pcm_registers::cs_tx_error|pcm_registers::cs_rx_error))
+        {
+          if (cs&pcm_registers::cs_tx_error)
+            {
+              ++errors.underruns;
+            }
+          if (cs&pcm_registers::cs_rx_error)
+            {
+              ++errors.overruns;
+            }
+          regs->clear_errors();
+        }
+    }
+
+    std::size_t pcm_pins::write
+    ( std::uint32_t const * psamples
+    , std::size_t count
+    )
+    {
+      auto & regs(pcm_ctrl::instance().regs);
+      check_errors();
+      std::size_t n{0U};
+      if (regs->get_flag(pcm_registers::cs_tx_empty))
+        {
+          std::size_t const burst{std::min<std::size_t>
+                                          (count, pcm_registers::fifo_depth)};
+          for (; n!=burst; ++n)
+            {
+              regs->fifo = psamples[n];
+            }
+        }
+      while (n!=count && regs->get_flag(pcm_registers::cs_tx_can_accept))
+        {
+          regs->fifo = psamples[n];
+          ++n;
+        }
+      if (n!=count)
+        {
+          counters.count(io_event::tx_fifo_full);
+        }
+      counters.count(io_event::bytes_written, n*sizeof(std::uint32_t));
+      return n;
+    }
+
+    std::size_t pcm_pins::read(std::uint32_t * psamples, std::size_t count)
+    {
+      auto & regs(pcm_ctrl::instance().regs);
+      check_errors();
+      std::size_t n{0U};
+      while (n!=count)
+        {
+          if ( count-n>=pcm_registers::fifo_depth
+            && regs->get_flag(pcm_registers::cs_rx_full)
+             )
+            {
+              for ( std::size_t const end{n+pcm_registers::fifo_depth}
+                  ; n!=end; ++n
+                  )
+                {
+                  psamples[n] = regs->fifo;
+                }
+            }
+          else if (regs->get_flag(pcm_registers::cs_rx_has_data))
+            {
+              psamples[n] = regs->fifo;
+              ++n;
+            }
+          else
+            {
+              counters.count(io_event::rx_fifo_empty);
+              break;
+            }
+        }
+      counters.count(io_event::bytes_read, n*sizeof(std::uint32_t));
+      return n;
+    }
+
+    std::size_t pcm_pins::write_all
+    ( std::uint32_t const * psamples
+    , std::size_t count
+    )
+    {
+      internal::trace_scope trace{"pcm_pins write_all"};
+      std::size_t n{0U};
+      adaptive_wait waiter(waiting, wait_counts);
+      while (n!=count)
+        {
+          std::size_t const written{write(psamples+n, count-n)};
+          if (written==0U)
+            {
+              counters.count(io_event::wait_polls);
+              waiter.pause();
+            }
+          else
+            {
+              n += written;
+              waiter.restart();
+            }
+        }
+      return n;
+    }
+
+    std::size_t pcm_pins::read_all(std::uint32_t * psamples, std::size_t count)
+    {
+      internal::trace_scope trace{"pcm_pins read_all"};
+      std::size_t n{0U};
+      adaptive_wait waiter(waiting, wait_counts);
+      while (n!=count)
+        {
+          std::size_t const got{read(psamples+n, count-n)};
+          if (got==0U)
+            {
+              counters.count(io_event::wait_polls);
+              waiter.pause();
+            }
+          else
+            {
+              n += got;
+              waiter.restart();
+            }
+        }
+      return n;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,192 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pcm_registers.h
+/// @brief \b Internal : low-level PCM / I2S audio interface control
+/// registers type definition.
+///
+/// Refer to the
+/// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+/// Broadcom BCM2835 ARM Peripherals Datasheet</a> Chapter 8 PCM / I2S Audio
+/// for details.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_PCM_REGISTERS_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_PCM_REGISTERS_H
+
+# include "peridef.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Represents layout of PCM / I2S control registers with operations.
+    ///
+    /// Permits access to BCM2835 PCM / I2S audio interface registers when an
+    /// instance is mapped to the correct physical memory location.
+    ///
+    /// See the
+    /// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+    /// Broadcom BCM2835 ARM Peripherals Datasheet</a> chapter 8 for published
+    /// details. Note that the PDM input and gray code registers are not used.
+    ///
+    /// The transmit and receive channel configuration registers, TXC_A and
+    /// RXC_A, share a layout: channel 1 settings in the upper 16 bits and
+    /// channel 2 settings in the lower 16 bits.
+      struct pcm_registers
+      {
+        enum : register_t
+        { cs_enable             = 1U<<0   ///< CS_A PCM enable EN bit
+        , cs_rx_on              = 1U<<1   ///< CS_A receive enable RXON bit
+        , cs_tx_on              = 1U<<2   ///< CS_A transmit enable TXON bit
+        , cs_tx_clear           = 1U<<3   ///< CS_A clear TX FIFO TXCLR bit
+        , cs_rx_clear           = 1U<<4   ///< CS_A clear RX FIFO RXCLR bit
+        , cs_tx_threshold_bit   = 5U      ///< CS_A TXTHR field bit number
+        , cs_tx_threshold_mask  = 3U<<5   ///< CS_A TXTHR field bit-mask
+        , cs_rx_threshold_bit   = 7U      ///< CS_A RXTHR field bit number
+        , cs_rx_threshold_mask  = 3U<<7   ///< CS_A RXTHR field bit-mask
+        , cs_dma_enable         = 1U<<9   ///< CS_A DMA DREQ enable DMAEN bit
+        , cs_tx_sync            = 1U<<13  ///< CS_A TX FIFO in sync TXSYNC bit
+        , cs_rx_sync            = 1U<<14  ///< CS_A RX FIFO in sync RXSYNC bit
+        , cs_tx_error           = 1U<<15  ///< CS_A TX FIFO underrun TXERR bit
+        , cs_rx_error           = 1U<<16  ///< CS_A RX FIFO overrun RXERR bit
+        , cs_tx_needs_writing   = 1U<<17  ///< CS_A TX FIFO below TXTHR TXW bit
+        , cs_rx_needs_reading   = 1U<<18  ///< CS_A RX FIFO above RXTHR RXR bit
+        , cs_tx_can_accept      = 1U<<19  ///< CS_A TX FIFO has space TXD bit
+        , cs_rx_has_data        = 1U<<20  ///< CS_A RX FIFO has data RXD bit
+        , cs_tx_empty           = 1U<<21  ///< CS_A TX FIFO empty TXE bit
+        , cs_rx_full            = 1U<<22  ///< CS_A RX FIFO full RXF bit
+        , cs_rx_sign_extend     = 1U<<23  ///< CS_A RX sign extend RXSEX bit
+        , cs_sync               = 1U<<24  ///< CS_A PCM clock sync SYNC bit
+        , cs_standby            = 1U<<25  ///< CS_A RAM standby STBY bit
+        , mode_fs_length_mask   = 0x3ffU  ///< MODE_A FSLEN field bit-mask
+        , mode_frame_length_bit = 10U     ///< MODE_A FLEN field bit number
+        , mode_frame_length_mask= 0x3ffU<<10 ///< MODE_A FLEN field bit-mask
+        , mode_fs_invert        = 1U<<20  ///< MODE_A invert frame sync FSI bit
+        , mode_fs_slave         = 1U<<21  ///< MODE_A frame sync input FSM bit
+        , mode_clock_invert     = 1U<<22  ///< MODE_A invert clock CLKI bit
+        , mode_clock_slave      = 1U<<23  ///< MODE_A clock input CLKM bit
+        , mode_tx_packed        = 1U<<24  ///< MODE_A TX frame packing FTXP bit
+        , mode_rx_packed        = 1U<<25  ///< MODE_A RX frame packing FRXP bit
+        , mode_clock_disable    = 1U<<28  ///< MODE_A disable clock CLK_DIS bit
+        , xc_ch1_shift          = 16U     ///< xXC_A channel 1 field shift
+        , xc_width_extend       = 1U<<15  ///< xXC_A CHxWEX width extension bit
+        , xc_enable             = 1U<<14  ///< xXC_A CHxEN channel enable bit
+        , xc_position_bit       = 4U      ///< xXC_A CHxPOS field bit number
+        , xc_position_mask      = 0x3ffU<<4 ///< xXC_A CHxPOS field bit-mask
+        , xc_width_mask         = 0xfU    ///< xXC_A CHxWID field bit-mask
+        , dreq_rx_bit           = 0U      ///< DREQ_A RX field bit number
+        , dreq_tx_bit           = 8U      ///< DREQ_A TX field bit number
+        , dreq_rx_panic_bit     = 16U     ///< DREQ_A RX_PANIC field bit number
+        , dreq_tx_panic_bit     = 24U     ///< DREQ_A TX_PANIC field bit number
+        , dreq_level_mask       = 0x7fU   ///< DREQ_A field value bit-mask
+        , fifo_depth            = 64U     ///< Words in each FIFO
+        , max_frame_bits        = 1024U   ///< Most bit clocks per frame
+        };
+
+      /// @brief Physical address of start of BCM2835 PCM control registers
+        constexpr static physical_address_t
+                            physical_address = peripheral_base_address+0x203000;
+
+        register_t  control_and_status; ///< Control and status, CS_A
+        register_t  fifo;               ///< FIFO data, FIFO_A
+        register_t  mode;               ///< Mode, MODE_A
+        register_t  receive_config;     ///< Receive configuration, RXC_A
+        register_t  transmit_config;    ///< Transmit configuration, TXC_A
+        register_t  dma_request_level;  ///< DMA request level, DREQ_A
+        register_t  interrupt_enables;  ///< Interrupt enables, INTEN_A
+        register_t  interrupt_status;   ///< Interrupt status, INTSTC_A
+        register_t  gray_mode;          ///< Gray mode control, GRAY
+
+      /// @brief Return a CS_A flag value
+      /// @param[in] flag CS_A bit to test (cs_tx_can_accept, cs_rx_has_data...)
+      /// @returns \c true if the bit is set.
+        bool get_flag(register_t flag) volatile const
+        {
+          return control_and_status & flag;
+        }
+
+      /// @brief Set or clear CS_A control bits
+      ///
+      /// The TXERR and RXERR flags are not cleared.
+      ///
+      /// @param[in] bits   CS_A bits to change.
+      /// @param[in] value  \c true to set the bits, \c false to clear them.
+        void set_control(register_t bits, bool value) volatile
+        {
+          register_t const cs{control_and_status&~(cs_tx_error|cs_rx_error)};
+          control_and_status = value ? (cs|bits) : (cs&~bits);
+        }
+
+      /// @brief Clear the FIFO error flags TXERR and RXERR
+      ///
+      /// The error flags are cleared by writing 1 to them.
+        void clear_errors() volatile
+        {
+          control_and_status = control_and_status|cs_tx_error|cs_rx_error;
+        }
+
+      /// @brief Set the MODE_A frame length and frame sync length fields
+      /// @param[in] frame_bits Bit clocks per frame [1,1024].
+      /// @param[in] fs_bits    Bit clocks frame sync is asserted for [0,1023].
+      /// @returns \c true if values were in range and set, \c false if not.
+        bool set_frame(register_t frame_bits, register_t fs_bits) volatile
+        {
+          if (frame_bits==0U || frame_bits>max_frame_bits
+            || fs_bits>mode_fs_length_mask
+             )
+            {
+              return false;
+            }
+          mode = (mode&~(mode_frame_length_mask|mode_fs_length_mask))
+               | ((frame_bits-1U)<<mode_frame_length_bit) | fs_bits;
+          return true;
+        }
+
+      /// @brief Return the MODE_A frame length in bit clocks
+        register_t get_frame_length() volatile const
+        {
+          return ((mode&mode_frame_length_mask)>>mode_frame_length_bit)+1U;
+        }
+
+      /// @brief Return a 16 bit channel configuration field value
+      /// @param[in] width    Channel sample width in bits [8,32].
+      /// @param[in] position Bit clocks from frame start to channel's first
+      ///                     bit [0,1023].
+      /// @returns Field value: enabled, width and position bits set, or 0 if
+      ///          width or position is out of range.
+        constexpr static register_t channel_config
+        ( register_t width
+        , register_t position
+        )
+        {
+          return (width<8U || width>32U || position>0x3ffU)
+                  ? 0U
+                  : xc_enable
+                    | ((width-8U)>15U ? register_t(xc_width_extend) : 0U)
+                    | (position<<xc_position_bit)
+                    | ((width-8U)&xc_width_mask);
+        }
+
+      /// @brief Set the DREQ_A DMA request and panic levels
+      /// @param[in] rx       RX FIFO words before an RX DREQ [0,127].
+      /// @param[in] tx       TX FIFO words below which a TX DREQ [0,127].
+      /// @param[in] rx_panic RX FIFO words before an RX panic [0,127].
+      /// @param[in] tx_panic TX FIFO words below which a TX panic [0,127].
+        void set_dma_request_levels
+        ( register_t rx
+        , register_t tx
+        , register_t rx_panic
+        , register_t tx_panic
+        ) volatile
+        {
+          dma_request_level = ((rx&dreq_level_mask)<<dreq_rx_bit)
+                            | ((tx&dreq_level_mask)<<dreq_tx_bit)
+                            | ((rx_panic&dreq_level_mask)<<dreq_rx_panic_bit)
+                            | ((tx_panic&dreq_level_mask)<<dreq_tx_panic_bit);
+        }
+      };
+   } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_PCM_REGISTERS_H
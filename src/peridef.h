@@ -40,6 +40,23 @@ namespace rpi
 
     /// @brief Physical address of BCM2835 peripheral control blocks.
       physical_address_t const peripheral_base_address{0x20000000};
+
+    /// @brief Byte size of BCM2835 peripheral control blocks physical address
+    /// range, starting at peripheral_base_address.
+      std::size_t const peripheral_range_size{0x01000000};
+
+    /// @brief VideoCore bus address of BCM2835 peripheral control blocks.
+    /// Bus addresses are used by DMA controllers to access peripherals.
+      register_t const peripheral_bus_base_address{0x7E000000};
+
+    /// @brief Convert physical address of peripheral register to bus address
+    /// @param phy_addr Physical address of peripheral register.
+    /// @returns VideoCore bus address of the register.
+      constexpr register_t peripheral_bus_address(physical_address_t phy_addr)
+      {
+        return static_cast<register_t>(phy_addr-peripheral_base_address)
+                                                  + peripheral_bus_base_address;
+      }
    } // namespace internal closed
   } // namespace peripherals closed
 }} // namespaces rpi and dibase closed
@@ -0,0 +1,153 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file periodic_timer.cpp
+/// @brief Periodic timer class implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "periodic_timer.h"
+#include <stdexcept>
+#include <system_error>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/timerfd.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+      void throw_system_error(char const * what)
+      {
+        throw std::system_error(errno, std::system_category(), what);
+      }
+
+      std::chrono::nanoseconds monotonic_now()
+      {
+        ::timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        return std::chrono::seconds{now.tv_sec}
+             + std::chrono::nanoseconds{now.tv_nsec};
+      }
+
+      ::timespec to_timespec(std::chrono::nanoseconds t)
+      {
+        std::chrono::seconds const secs
+                    {std::chrono::duration_cast<std::chrono::seconds>(t)};
+        ::timespec ts;
+        ts.tv_sec = static_cast<::time_t>(secs.count());
+        ts.tv_nsec = static_cast<long>((t-secs).count());
+        return ts;
+      }
+    }
+
+    periodic_timer::periodic_timer(std::chrono::nanoseconds period)
+    : timer_fd{-1}
+    , interval{period}
+    , expiry_count{0U}
+    , overrun_count{0U}
+    {
+      start(monotonic_now()+period);
+    }
+
+    periodic_timer::periodic_timer
+    ( std::chrono::nanoseconds period
+    , std::chrono::nanoseconds first
+    )
+    : timer_fd{-1}
+    , interval{period}
+    , expiry_count{0U}
+    , overrun_count{0U}
+    {
+      start(first);
+    }
+
+    periodic_timer::~periodic_timer()
+    {
+      ::close(timer_fd);
+    }
+
+    void periodic_timer::start(std::chrono::nanoseconds first)
+    {
+      if (interval.count()<=0)
+        {
+          throw std::invalid_argument{"periodic_timer::periodic_timer: period "
+                                      "must be greater than zero."};
+        }
+    // A zero it_value disarms a timerfd so the first deadline cannot be 0
+      if (first.count()<=0)
+        {
+          first = std::chrono::nanoseconds{1};
+        }
+      timer_fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC|TFD_NONBLOCK);
+      if (timer_fd==-1)
+        {
+          throw_system_error( "periodic_timer: creating timer failed with "
+                              "error from call to timerfd_create."
+                            );
+        }
+      ::itimerspec spec;
+      spec.it_interval = to_timespec(interval);
+      spec.it_value = to_timespec(first);
+      if (::timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr)==-1)
+        {
+          int const error{errno};
+          ::close(timer_fd);
+          errno = error;
+          throw_system_error( "periodic_timer: starting timer failed with "
+                              "error from call to timerfd_settime."
+                            );
+        }
+    }
+
+    std::uint64_t periodic_timer::account(std::uint64_t expirations)
+    {
+      if (expirations!=0U)
+        {
+          expiry_count += expirations;
+          overrun_count += expirations-1U;
+        }
+      return expirations;
+    }
+
+    std::uint64_t periodic_timer::acknowledge()
+    {
+      std::uint64_t expirations{0U};
+      if (::read(timer_fd, &expirations, sizeof(expirations))==-1)
+        {
+          if (errno!=EAGAIN)
+            {
+              throw_system_error( "periodic_timer: reading timer failed with "
+                                  "error from call to read."
+                                );
+            }
+          expirations = 0U;
+        }
+      return account(expirations);
+    }
+
+    std::uint64_t periodic_timer::wait()
+    {
+      for (;;)
+        {
+          std::uint64_t const expirations{acknowledge()};
+          if (expirations!=0U)
+            {
+              return expirations;
+            }
+          pollfd pfd;
+          pfd.fd = timer_fd;
+          pfd.events = POLLIN;
+          pfd.revents = 0;
+          if (::poll(&pfd, 1, -1)==-1 && errno!=EINTR)
+            {
+              throw_system_error( "periodic_timer: waiting for timer failed "
+                                  "with error from call to poll."
+                                );
+            }
+        }
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,130 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file peripheral_range.cpp
+/// @brief Detection of the SoC peripheral physical address range.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "peripheral_range.h"
+#include "board_descriptor.h"
+#include "init_trace.h"
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      namespace
+      {
+        char const * soc_ranges_pathname{"/proc/device-tree/soc/ranges"};
+
+        constexpr std::size_t cell_size{4U};
+
+        constexpr std::size_t bcm2711_peripheral_range_size{0x01800000};
+
+      // Enough for the longest, BCM2711, form of the first entry
+        constexpr std::size_t max_entry_length{4U*cell_size};
+
+        std::uint32_t read_cell(std::uint8_t const * data, std::size_t idx)
+        {
+          data += idx*cell_size;
+          return (std::uint32_t{data[0]}<<24) | (std::uint32_t{data[1]}<<16)
+               | (std::uint32_t{data[2]}<<8)  |  std::uint32_t{data[3]};
+        }
+
+      // Used if the device tree is not available: the range for the board's
+      // processor, or failing that the BCM2835 range.
+        peripheral_range board_peripheral_range()
+        {
+          try
+            {
+              board_descriptor const & board(running_board());
+              return peripheral_range
+                      { board.peripheral_base
+                      , board.processor==rpi_processor::bcm2711
+                          ? bcm2711_peripheral_range_size
+                          : peripheral_range_size
+                      , board.processor==rpi_processor::bcm2711
+                      };
+            }
+          catch (std::runtime_error const &)
+            {
+              return bcm2835_peripheral_range;
+            }
+        }
+
+        peripheral_range read_soc_ranges()
+        {
+          init_trace_scope timing{init_phase::device_tree_read};
+          int fd{::open(soc_ranges_pathname, O_RDONLY|O_CLOEXEC)};
+          if (fd==-1)
+            {
+              return board_peripheral_range();
+            }
+          std::uint8_t data[max_entry_length];
+          ssize_t const length{::read(fd, data, sizeof(data))};
+          ::close(fd);
+          try
+            {
+              return length<0
+                      ? board_peripheral_range()
+                      : parse_soc_ranges( data
+                                        , static_cast<std::size_t>(length)
+                                        );
+            }
+          catch (std::invalid_argument const &)
+            {
+              return board_peripheral_range();
+            }
+        }
+      }
+
+      peripheral_range parse_soc_ranges
+      ( std::uint8_t const * data
+      , std::size_t length
+      )
+      {
+        if (length<3U*cell_size)
+          {
+            throw std::invalid_argument{ "parse_soc_ranges: ranges property "
+                                         "too short."
+                                       };
+          }
+        peripheral_range range{0, 0U, false};
+        std::uint32_t const address{read_cell(data, 1U)};
+        if (address!=0U)
+          {
+            range.base = address;
+            range.size = read_cell(data, 2U);
+          }
+        else
+          {
+            if (length<4U*cell_size)
+              {
+                throw std::invalid_argument{ "parse_soc_ranges: ranges "
+                                             "property too short."
+                                           };
+              }
+            range.base = read_cell(data, 2U);
+            range.size = read_cell(data, 3U);
+            range.gpio_pull_control_registers = true;
+          }
+        if (range.base==0 || range.size==0U)
+          {
+            throw std::invalid_argument{ "parse_soc_ranges: ranges property "
+                                         "describes an empty range."
+                                       };
+          }
+        return range;
+      }
+
+      peripheral_range const & detected_peripheral_range()
+      {
+        static peripheral_range const range{read_soc_ranges()};
+        return range;
+      }
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
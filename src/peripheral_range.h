@@ -0,0 +1,81 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file peripheral_range.h
+/// @brief \b Internal : detection of the SoC peripheral physical address
+/// range from the device tree : type and function declarations.
+///
+/// The peripheral register blocks of the BCM2835, BCM2836, BCM2837 and
+/// BCM2711 have the same layout relative to the start of the peripheral
+/// range but the range starts at a different physical address on each. The
+/// library's physical_address values are BCM2835 addresses, that is
+/// peripheral_base_address plus a block offset. They are translated to the
+/// running SoC's addresses by peripheral_window using the detected range.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_PERIPHERAL_RANGE_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_PERIPHERAL_RANGE_H
+
+# include "peridef.h"
+# include <cstddef>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Location of the SoC peripherals in physical memory
+      struct peripheral_range
+      {
+        physical_address_t  base; ///< Physical address of start of range
+        std::size_t         size; ///< Size of range in bytes
+
+      /// @brief true if the GPIO block has the BCM2711 pull up/down control
+      /// registers rather than the GPPUD / GPPUDCLK sequence registers.
+        bool                gpio_pull_control_registers;
+      };
+
+    /// @brief Peripheral range of a BCM2835, used if detection fails.
+      constexpr peripheral_range bcm2835_peripheral_range
+                        { peripheral_base_address, peripheral_range_size, false };
+
+    /// @brief Parse the first entry of a device tree soc/ranges property
+    ///
+    /// The property is a sequence of big endian 32 bit cells. The first entry
+    /// maps the peripherals' bus address to their physical address and is
+    /// either (bus address, physical address, size) or, for the BCM2711,
+    /// (bus address, physical address high, physical address low, size) with
+    /// a zero high cell. The BCM2711 form indicates the GPIO pull up/down
+    /// control registers are present.
+    ///
+    /// @param[in]  data    Bytes of the soc/ranges property.
+    /// @param[in]  length  Number of bytes in data.
+    /// @returns Peripheral range described by data.
+    /// @throws std::invalid_argument if data is too short or describes an
+    ///         empty range.
+      peripheral_range parse_soc_ranges
+      ( std::uint8_t const * data
+      , std::size_t length
+      );
+
+    /// @brief Returns the running SoC's peripheral range.
+    ///
+    /// Read from /proc/device-tree/soc/ranges on first call and cached. If
+    /// the device tree cannot be read or parsed the range is deduced from the
+    /// running_board processor, or if that is not known either
+    /// bcm2835_peripheral_range is returned.
+      peripheral_range const & detected_peripheral_range();
+
+    /// @brief Returns true if the running SoC is a BCM2711.
+    ///
+    /// As well as the GPIO pull up/down control registers the BCM2711 has
+    /// BSC masters BSC3 to BSC6 and SPI controllers SPI3 to SPI6 that the
+    /// earlier SoCs do not.
+      inline bool has_bcm2711_peripherals()
+      {
+        return detected_peripheral_range().gpio_pull_control_registers;
+      }
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_PERIPHERAL_RANGE_H
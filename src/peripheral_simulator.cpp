@@ -0,0 +1,163 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file peripheral_simulator.cpp
+/// @brief \b Internal : in-memory simulated peripherals : implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "peripheral_simulator.h"
+#include "gpio_registers.h"
+#include "spi0_registers.h"
+#include "system_timer_registers.h"
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      namespace
+      {
+        std::uint64_t monotonic_now_us()
+        {
+          ::timespec now;
+          ::clock_gettime(CLOCK_MONOTONIC, &now);
+          return static_cast<std::uint64_t>(now.tv_sec)*1000000U
+               + static_cast<std::uint64_t>(now.tv_nsec)/1000U;
+        }
+
+        constexpr std::size_t gpio_pins{54U};
+        constexpr std::size_t gpio_fsel_pins_per_reg{10U};
+        constexpr std::size_t gpio_fsel_bits_per_pin{3U};
+        constexpr register_t  gpio_fsel_mask{7U};
+      }
+
+      bool simulation_requested(char const * value)
+      {
+        return value!=nullptr && *value!='\0' && std::strcmp(value, "0")!=0;
+      }
+
+      bool simulated_peripherals_selected()
+      {
+        static bool const selected
+                    {simulation_requested(std::getenv
+                                            (simulated_peripherals_variable))};
+        return selected;
+      }
+
+      void gpio_model::step(gpio_registers volatile & regs)
+      {
+        register_t outputs[2]{0U, 0U};
+        for (std::size_t pin=0U; pin!=gpio_pins; ++pin)
+          {
+            register_t const fn
+                    { ( regs.gpfsel[pin/gpio_fsel_pins_per_reg]
+                      >> (pin%gpio_fsel_pins_per_reg)*gpio_fsel_bits_per_pin
+                      ) & gpio_fsel_mask
+                    };
+            if (fn==static_cast<register_t>(gpio_pin_fn::output))
+              {
+                outputs[pin/32U] |= 1U<<(pin%32U);
+              }
+          }
+        for (std::size_t idx=0U; idx!=2U; ++idx)
+          { // Exchange so bits set by a driver between read and clear are
+          // not lost
+            register_t const set
+                  {__atomic_exchange_n(&regs.gpset[idx], 0U, __ATOMIC_ACQ_REL)};
+            register_t const clr
+                  {__atomic_exchange_n(&regs.gpclr[idx], 0U, __ATOMIC_ACQ_REL)};
+            latch[idx] = (latch[idx]|set) & ~clr;
+            regs.gplev[idx] = (regs.gplev[idx] & ~outputs[idx])
+                            | (latch[idx] & outputs[idx]);
+          }
+      }
+
+      void step_spi0_model(spi0_registers volatile & regs)
+      {
+        register_t const status_mask
+                        { spi0_registers::cs_xfer_done_mask
+                        | spi0_registers::cs_rxd_mask
+                        | spi0_registers::cs_txd_mask
+                        | spi0_registers::cs_rxr_mask
+                        | spi0_registers::cs_rxf_mask
+                        | static_cast<register_t>
+                                          (spi0_fifo_clear_action::clear_tx_rx)
+                        };
+        register_t cs{regs.control_and_status};
+        for (;;)
+          {
+            register_t model{(cs & ~status_mask) | spi0_registers::cs_txd_mask};
+            if (cs & spi0_registers::cs_xfer_active_mask)
+              {
+                model |= spi0_registers::cs_xfer_done_mask
+                       | spi0_registers::cs_rxd_mask;
+              }
+          // Compare and exchange so a driver's concurrent change to control
+          // bits is not overwritten. On failure cs is updated to the latest.
+            if ( model==cs
+              || __atomic_compare_exchange_n( &regs.control_and_status
+                                            , &cs, model, false
+                                            , __ATOMIC_ACQ_REL
+                                            , __ATOMIC_ACQUIRE
+                                            )
+               )
+              {
+                return;
+              }
+          }
+      }
+
+      void step_system_timer_model
+      ( system_timer_registers volatile & regs
+      , std::uint64_t now_us
+      )
+      {
+        regs.counter_low = static_cast<register_t>(now_us);
+        regs.counter_high = static_cast<register_t>(now_us>>32);
+      }
+
+      peripheral_simulator::peripheral_simulator(void * window_mem)
+      : window{static_cast<char *>(window_mem)}
+      , gpio{}
+      , stopping{false}
+      , thread{}
+      {
+        step();
+        thread = std::thread{&peripheral_simulator::run, this};
+      }
+
+      peripheral_simulator::~peripheral_simulator()
+      {
+        stopping = true;
+        thread.join();
+      }
+
+      void peripheral_simulator::step()
+      {
+        gpio.step(*reinterpret_cast<gpio_registers volatile *>
+                  (window+(gpio_registers::physical_address
+                          -peripheral_base_address)));
+        step_spi0_model(*reinterpret_cast<spi0_registers volatile *>
+                        (window+(spi0_registers::physical_address
+                                -peripheral_base_address)));
+        step_system_timer_model
+          ( *reinterpret_cast<system_timer_registers volatile *>
+              (window+(system_timer_registers::physical_address
+                      -peripheral_base_address))
+          , monotonic_now_us()
+          );
+      }
+
+      void peripheral_simulator::run()
+      {
+        while (!stopping)
+          {
+            step();
+            std::this_thread::yield();
+          }
+      }
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,126 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file peripheral_simulator.h
+/// @brief \b Internal : in-memory simulated peripherals : type and function
+/// declarations.
+///
+/// If the DIBASE_RPI_SIMULATED_PERIPHERALS environment variable is set to a
+/// non-empty value other than 0 the peripheral_window is ordinary zeroed
+/// memory rather than a mapping of /dev/mem, and GPIO pins are allocated
+/// within the process only, so the library's drivers - pin, spi0_pins and
+/// so on - run unchanged off-target, for example to profile them on a
+/// development or CI machine with perf or valgrind.
+///
+/// The register blocks are plain memory so a driver sees nothing but the
+/// values it wrote unless something else updates them. A peripheral_simulator
+/// thread runs models of a few peripherals that repeatedly bring their
+/// status registers up to date with their control registers:
+///
+///   - GPIO: GPSETn and GPCLRn writes update an output latch, which GPLEVn
+///     reflects for pins set to the output function.
+///   - SPI0: an ideal FIFO that never fills and transfers instantly, so TXD
+///     is always set and while TA is set so are DONE and RXD. The FIFO
+///     register reads back the last value written, a loop back of sorts.
+///     CLEAR bits are cleared.
+///   - System timer: CLO and CHI count microseconds of CLOCK_MONOTONIC so
+///     timed delays work.
+///
+/// Other peripherals are not modelled. In particular BSC (I2C) status bits
+/// are cleared by writing 1 to them, which leaves the written bits set in
+/// memory until a model notices, so i2c_pins cannot be simulated this way.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_PERIPHERAL_SIMULATOR_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_PERIPHERAL_SIMULATOR_H
+
+# include "peridef.h"
+# include <atomic>
+# include <cstdint>
+# include <thread>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      struct gpio_registers;
+      struct spi0_registers;
+      struct system_timer_registers;
+
+    /// @brief Name of environment variable selecting simulated peripherals
+      constexpr char const * simulated_peripherals_variable
+                                          {"DIBASE_RPI_SIMULATED_PERIPHERALS"};
+
+    /// @brief Returns whether a simulated peripherals environment variable
+    /// value selects simulated peripherals.
+    /// @param[in]  value   Variable value, nullptr if not set.
+    /// @returns true if value is set, not empty and not "0".
+      bool simulation_requested(char const * value);
+
+    /// @brief Returns whether simulated peripherals are in use.
+    ///
+    /// The simulated_peripherals_variable environment variable is read on
+    /// first call and the result cached, so setting it once the process is
+    /// using the peripherals has no effect.
+      bool simulated_peripherals_selected();
+
+    /// @brief GPIO model: output latch reflected by GPLEVn for output pins.
+      struct gpio_model
+      {
+        register_t  latch[2]; ///< Output latch state, pins 0..31, 32..53
+
+      /// @brief Construct with all outputs low.
+        gpio_model()
+        : latch{0U, 0U}
+        {}
+
+      /// @brief Bring GPIO registers up to date.
+      ///
+      /// Moves GPSETn and GPCLRn bits into the latch, clearing the
+      /// registers, then sets GPLEVn bits of output function pins to the
+      /// latch state. GPLEVn bits of other pins are left as they are.
+      /// @param[in,out] regs GPIO register block.
+        void step(gpio_registers volatile & regs);
+      };
+
+    /// @brief Bring SPI0 status bits up to date with an ideal FIFO model.
+    /// @param[in,out] regs SPI0 register block.
+      void step_spi0_model(spi0_registers volatile & regs);
+
+    /// @brief Set the system timer counter.
+    /// @param[in,out] regs   System timer register block.
+    /// @param[in]     now_us Counter value in microseconds.
+      void step_system_timer_model
+      ( system_timer_registers volatile & regs
+      , std::uint64_t now_us
+      );
+
+    /// @brief Thread running the peripheral models over a simulated
+    /// peripheral window until destroyed.
+      class peripheral_simulator
+      {
+        char *            window;   ///< Start of simulated peripheral range
+        gpio_model        gpio;     ///< GPIO output latch
+        std::atomic<bool> stopping; ///< Set to end the thread
+        std::thread       thread;   ///< Thread running the models
+
+        void step();
+        void run();
+
+      public:
+      /// @brief Start running the models.
+      /// @param[in]  window_mem  Start of memory simulating the peripheral
+      ///                         range starting at peripheral_base_address.
+      ///                         Must outlive the simulator.
+        explicit peripheral_simulator(void * window_mem);
+
+      /// @brief Stop running the models, waiting for the thread to end.
+        ~peripheral_simulator();
+
+        peripheral_simulator(peripheral_simulator const &) = delete;
+        peripheral_simulator & operator=(peripheral_simulator const &) = delete;
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_PERIPHERAL_SIMULATOR_H
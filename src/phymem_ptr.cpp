@@ -6,8 +6,12 @@
 /// @author Ralph E. McArdell
 
 #include "phymem_ptr.h"
+#include "peripheral_simulator.h"
+#include "init_trace.h"
 #include <sys/mman.h>
 #include <fcntl.h>
+#include <unistd.h>
+#include <stdexcept>
 #include <system_error>
 
 namespace dibase { namespace rpi {
@@ -16,16 +20,15 @@ namespace dibase { namespace rpi {
     {
       static int mem_fd{-1};
 
-      raw_phymem_ptr::raw_phymem_ptr
+      static void * map_dev_mem
       ( physical_address_t phy_addr
       , std::size_t mapped_length
       )
-      : mem(nullptr)
-      , length(0)
       {
         char const * DevMemPath{"/dev/mem"};
         if ( mem_fd<0 )
           { // Attempt to open mem device once and save fd in mem_fd static global
+            init_trace_scope timing{init_phase::dev_mem_open};
             if ( (mem_fd = open(DevMemPath, O_RDWR|O_SYNC))<0 ) 
               {
                 throw std::system_error
@@ -36,44 +39,186 @@ namespace dibase { namespace rpi {
               }
           }
 
-        mem = mmap( NULL
-                  , mapped_length
-                  , PROT_READ|PROT_WRITE
-                  , MAP_SHARED
-                  , mem_fd
-                  , phy_addr
-                  );
+        init_trace_scope timing{init_phase::phymem_map};
+        void * mem = mmap( NULL
+                         , mapped_length
+                         , PROT_READ|PROT_WRITE
+                         , MAP_SHARED
+                         , mem_fd
+                         , phy_addr
+                         );
         if ( MAP_FAILED == mem )
           {
-            mem = nullptr;
             throw std::system_error( errno
                                    , std::system_category()
                                    , "mmap failed mapping physical memory area."
                                    );
           }
+        return mem;
+      }
+
+      static void * map_simulated_mem(std::size_t mapped_length)
+      {
+        void * mem = mmap( NULL
+                         , mapped_length
+                         , PROT_READ|PROT_WRITE
+                         , MAP_PRIVATE|MAP_ANONYMOUS
+                         , -1
+                         , 0
+                         );
+        if ( MAP_FAILED == mem )
+          {
+            throw std::system_error( errno
+                                   , std::system_category()
+                                   , "mmap failed allocating simulated "
+                                     "peripheral memory."
+                                   );
+          }
+        return mem;
+      }
+
+      peripheral_window::peripheral_window()
+      : mem(nullptr)
+      , range( simulated_peripherals_selected() ? bcm2835_peripheral_range
+                                                : detected_peripheral_range()
+             )
+      , simulator()
+      {
+        if ( simulated_peripherals_selected() )
+          {
+            mem = map_simulated_mem(range.size);
+            try
+              {
+                simulator.reset(new peripheral_simulator{mem});
+              }
+            catch (...)
+              {
+                munmap( mem, range.size );
+                throw;
+              }
+          }
+        else
+          {
+            mem = map_dev_mem(range.base, range.size);
+          }
+      }
+
+      peripheral_window & peripheral_window::instance()
+      {
+        static peripheral_window window;
+        return window;
+      }
+
+      peripheral_window::~peripheral_window()
+      {
+        simulator.reset(); // stop simulation before its memory is unmapped
+        munmap( mem, range.size );
+      }
+
+      void * peripheral_window::at
+      ( physical_address_t phy_addr
+      , std::size_t length
+      )
+      {
+        if ( !contains(phy_addr, length) )
+          {
+            throw std::out_of_range( "peripheral_window::at: region not within "
+                                     "peripheral physical address range."
+                                   );
+          }
+        return static_cast<char *>(mem) + (phy_addr-peripheral_base_address);
+      }
+
+      raw_phymem_ptr::raw_phymem_ptr
+      ( physical_address_t phy_addr
+      , std::size_t mapped_length
+      )
+      : mem(map_dev_mem(phy_addr, mapped_length))
+      , length(mapped_length)
+      , owned(true)
+      {
+      }
+
+      raw_phymem_ptr::raw_phymem_ptr
+      ( char const * device
+      , physical_address_t offset
+      , std::size_t mapped_length
+      )
+      : mem(nullptr)
+      , length(0)
+      , owned(false)
+      {
+        int fd{-1};
+        {
+          init_trace_scope timing{init_phase::dev_mem_open};
+          fd = open(device, O_RDWR|O_SYNC|O_CLOEXEC);
+        }
+        if ( fd<0 )
+          {
+            throw std::system_error( errno
+                                   , std::system_category()
+                                   , "open failed for memory device."
+                                   );
+          }
+        {
+          init_trace_scope timing{init_phase::phymem_map};
+          mem = mmap( NULL
+                    , mapped_length
+                    , PROT_READ|PROT_WRITE
+                    , MAP_SHARED
+                    , fd
+                    , offset
+                    );
+        }
+        int const error{errno};
+        close(fd);
+        if ( MAP_FAILED == mem )
+          {
+            mem = nullptr;
+            throw std::system_error( error
+                                   , std::system_category()
+                                   , "mmap failed mapping memory device area."
+                                   );
+          }
         length = mapped_length;
+        owned = true;
+      }
+
+      raw_phymem_ptr::raw_phymem_ptr
+      ( peripheral_window & window
+      , physical_address_t phy_addr
+      , std::size_t view_length
+      )
+      : mem(window.at(phy_addr, view_length))
+      , length(view_length)
+      , owned(false)
+      {
       }
 
       raw_phymem_ptr::raw_phymem_ptr(raw_phymem_ptr && tmp)
       : mem{tmp.mem}
       , length{tmp.length}
+      , owned{tmp.owned}
       {
         tmp.mem = nullptr;
         tmp.length = 0;
+        tmp.owned = false;
       }
 
       raw_phymem_ptr & raw_phymem_ptr::operator=(raw_phymem_ptr && tmp)
       {
         mem = tmp.mem;
         length = tmp.length;
+        owned = tmp.owned;
         tmp.mem = nullptr;
         tmp.length = 0;
+        tmp.owned = false;
         return *this;
       }
 
       raw_phymem_ptr::~raw_phymem_ptr()
       {
-        if ( mem != nullptr )
+        if ( owned && mem != nullptr )
           {
             munmap( mem, length );
           }
@@ -9,11 +9,84 @@
  #define DIBASE_RPI_PERIPHERALS_INTERNAL_PHYMEM_PTR_H
 
  #include "peridef.h"
+ #include "peripheral_range.h"
+ #include <memory>
 
 namespace dibase { namespace rpi {
   namespace peripherals
   { namespace internal
     {
+      class peripheral_simulator;
+
+    /// @brief Single mapping of the whole SoC peripheral physical address
+    /// range. There is only 1 (yes it's a singleton!)
+    ///
+    /// The range, as given by detected_peripheral_range, is mapped from
+    /// /dev/mem on first use of instance and unmapped at program exit, so
+    /// peripheral register blocks viewed through it by phymem_ptr objects
+    /// share one mapping rather than each having their own.
+    ///
+    /// Regions are specified by BCM2835 physical addresses, as used for the
+    /// library's register block physical_address values, and are translated
+    /// to the same offset within the running SoC's peripheral range.
+    ///
+    /// If simulated_peripherals_selected then the window is instead zeroed
+    /// memory the size of a BCM2835 peripheral range updated by a
+    /// peripheral_simulator - see peripheral_simulator.h.
+      class peripheral_window
+      {
+        void *            mem;    ///< pointer to mapped peripheral range
+        peripheral_range  range;  ///< mapped peripheral range
+        std::unique_ptr<peripheral_simulator> simulator; ///< or nullptr
+
+        peripheral_window();
+
+      public:
+      /// @brief Singleton instance getter
+      /// @return The peripheral_window object, mapping the range first if
+      ///         this is the first call.
+      /// @exception  std::system_error if /dev/mem cannot be opened or the
+      ///             range cannot be mapped.
+        static peripheral_window & instance();
+
+      /// @brief Destructor: unmaps the peripheral range.
+        ~peripheral_window();
+
+        peripheral_window(peripheral_window const &) = delete;
+        peripheral_window & operator=(peripheral_window const &) = delete;
+
+      /// @brief Returns true if the window is simulated peripherals memory.
+        bool is_simulated() const
+        {
+          return simulator!=nullptr;
+        }
+
+      /// @brief Returns the mapped peripheral range.
+        peripheral_range const & mapped_range() const
+        {
+          return range;
+        }
+
+      /// @brief Check a physical address region is within the window
+      /// @param[in]  phy_addr  BCM2835 physical address of start of region.
+      /// @param[in]  length    Length of region.
+      /// @return true if the whole region lies within the peripheral range.
+        bool contains(physical_address_t phy_addr, std::size_t length) const
+        {
+          return phy_addr>=peripheral_base_address
+              && length<=range.size
+              && static_cast<std::size_t>(phy_addr-peripheral_base_address)
+                                                            <=range.size-length;
+        }
+
+      /// @brief Accessor. Untyped access to a region within the window.
+      /// @param[in]  phy_addr  BCM2835 physical address of start of region.
+      /// @param[in]  length    Length of region.
+      /// @return Pointer to the process mapping of phy_addr.
+      /// @exception std::out_of_range if the region is not within the window.
+        void * at(physical_address_t phy_addr, std::size_t length);
+      };
+
     /// @brief Physical memory smart pointer base class 
     ///
     /// Intended as base class use only. All operations protected.
@@ -29,6 +102,7 @@ namespace dibase { namespace rpi {
       {
         void * mem;         ///< pointer to mapped region
         std::size_t length; ///< length of mapped region
+        bool owned;         ///< true if region was mapped by this object
 
       protected:
       /// @brief Construct from physical address and region
@@ -48,11 +122,46 @@ namespace dibase { namespace rpi {
       ///             region cannot be mapped.
         raw_phymem_ptr(physical_address_t phy_addr, std::size_t length);
 
+      /// @brief Construct from memory device and region
+      ///
+      /// As for construction from a physical address but mapping a region of
+      /// a device other than /dev/mem, such as /dev/gpiomem which maps the
+      /// GPIO registers from offset 0 and does not require root privileges.
+      /// The device is closed once the region is mapped.
+      ///
+      /// @param[in]  device    Pathname of memory device to map.
+      /// @param[in]  offset    Offset into device to map, page size multiple.
+      /// @param[in]  length    Length of mapped address region. Page size
+      ///                       multiple.
+      /// @exception  std::system_error if the device cannot be opened or the
+      ///             region cannot be mapped.
+        raw_phymem_ptr
+        ( char const * device
+        , physical_address_t offset
+        , std::size_t length
+        );
+
+      /// @brief Construct as view of region in the peripheral window
+      ///
+      /// No mapping is made or unmapped on destruction: the region is
+      /// accessed through the window's mapping.
+      ///
+      /// @param[in]  window    Peripheral window containing the region.
+      /// @param[in]  phy_addr  Physical address of region to view.
+      /// @param[in]  length    Length of region.
+      /// @exception  std::out_of_range if the region is not within window.
+        raw_phymem_ptr
+        ( peripheral_window & window
+        , physical_address_t phy_addr
+        , std::size_t length
+        );
+
       /// Default construction: Construct with null pointer (no mapped memory) 
       /// and zero length.
         raw_phymem_ptr()
         : mem(nullptr)
         , length(0)
+        , owned(false)
         {}
 
 
@@ -118,6 +227,44 @@ namespace dibase { namespace rpi {
         : raw_phymem_ptr(phy_addr, length)
         {}
 
+      /// @brief Construct from memory device and region
+      ///
+      /// Simply passes parameters to the base 
+      /// \ref raw_phymem_ptr::raw_phymem_ptr(char const * device, physical_address_t offset, std::size_t length)
+      /// constructor.
+      ///
+      /// @param[in]  device    Pathname of memory device to map.
+      /// @param[in]  offset    Offset into device to map, page size multiple.
+      /// @param[in]  length    Length of mapped address region. Page size
+      ///                       multiple.
+      /// @exception  std::system_error if the device cannot be opened or the
+      ///             region cannot be mapped.
+        phymem_ptr
+        ( char const * device
+        , physical_address_t offset
+        , std::size_t length
+        )
+        : raw_phymem_ptr(device, offset, length)
+        {}
+
+      /// @brief Construct as view of region in the peripheral window
+      ///
+      /// Simply passes parameters to the base 
+      /// \ref raw_phymem_ptr::raw_phymem_ptr(peripheral_window & window, physical_address_t phy_addr, std::size_t length)
+      /// constructor.
+      ///
+      /// @param[in]  window    Peripheral window containing the region.
+      /// @param[in]  phy_addr  Physical address of region to view.
+      /// @param[in]  length    Length of region.
+      /// @exception  std::out_of_range if the region is not within window.
+        phymem_ptr
+        ( peripheral_window & window
+        , physical_address_t phy_addr
+        , std::size_t length
+        )
+        : raw_phymem_ptr(window, phy_addr, length)
+        {}
+
       /// Default construction: Construct with null pointer (no mapped memory) 
       /// and zero length.
         phymem_ptr() = default;
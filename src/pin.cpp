@@ -7,24 +7,95 @@
 
 #include "pin.h"
 #include "gpio_ctrl.h"
+#include "gpio_pull.h"
+#include "init_trace.h"
+#include "peripheral_range.h"
+#include "register_lock.h"
+#include "system_timer.h"
+#include "system_timer_ctrl.h"
 #include <chrono>
+#include <system_error>
 #include <thread>
+#include <utility>
 
 namespace dibase { namespace rpi {
   namespace peripherals
   {
     namespace internal
     {
-      auto pud_wait_us(std::chrono::microseconds(10U));
+      thread_local gpio_put_batch * active_gpio_put_batch{nullptr};
 
-      static void apply_pull(pin_id pin, unsigned mode)
+      std::uint32_t const pud_wait_us{10U};
+
+      namespace
+      {
+        bool system_timer_mappable()
+        {
+          try
+            {
+              system_timer_ctrl::instance();
+              return true;
+            }
+          catch (std::system_error const &)
+            {
+              return false;
+            }
+        }
+
+      // Wait between GPPUD sequence steps. The system timer can only be
+      // mapped through /dev/mem; when GPIO is used through /dev/gpiomem
+      // without root sleep instead - the waits are minimums so a late
+      // return only slows the sequence down.
+        void pud_wait()
+        {
+          static bool const use_system_timer{system_timer_mappable()};
+          if ( use_system_timer )
+            {
+              system_timer::delay_us(pud_wait_us);
+            }
+          else
+            {
+              std::this_thread::sleep_for
+                                  (std::chrono::microseconds{pud_wait_us});
+            }
+        }
+      }
+
+      void apply_pull( std::uint32_t bank0_mask
+                     , std::uint32_t bank1_mask
+                     , unsigned mode
+                     )
       {
         if ( mode&ipin::pull_up && mode&ipin::pull_down )
           {
             throw std::invalid_argument
                   ("Cannot open ipin with both pull up and down enabled!");
           }
+        if ( bank0_mask==0U && bank1_mask==0U )
+          {
+            return;
+          }
+        gpio_ctrl::instance().config.record_pulls
+                                    ( bank0_mask, bank1_mask
+                                    , mode&(ipin::pull_up|ipin::pull_down)
+                                    );
+        if ( detected_peripheral_range().gpio_pull_control_registers )
+          {
+            gpio_ctrl::instance().regs->set_pins_pull_control
+                                    ( bank0_mask, bank1_mask
+                                    , mode&ipin::pull_up 
+                                        ? gpio_pull_control::pull_up
+                                    : mode&ipin::pull_down 
+                                        ? gpio_pull_control::pull_down
+                                        : gpio_pull_control::none
+                                    );
+            return;
+          }
 
+      // GPPUD and GPPUDCLKn are shared by all pins: hold GPPUD's lock for
+      // the whole sequence so sequences from different threads do not mix.
+        init_trace_scope timing{init_phase::pull_sequence};
+        register_word_lock lock{&gpio_ctrl::instance().regs->gppud};
         gpio_ctrl::instance().regs->set_pull_up_down_mode
                                     ( mode&ipin::pull_up 
                                         ? gpio_pud_mode::enable_pull_up_control
@@ -32,20 +103,32 @@ namespace dibase { namespace rpi {
                                         ? gpio_pud_mode::enable_pull_down_control
                                         : gpio_pud_mode::off
                                     );
-        std::this_thread::sleep_for(pud_wait_us);
-        gpio_ctrl::instance().regs->assert_pin_pull_up_down_clock( pin );
-        std::this_thread::sleep_for(pud_wait_us);
+        pud_wait();
+        gpio_ctrl::instance().regs->assert_pins_pull_up_down_clock
+                                    ( bank0_mask, bank1_mask );
+        pud_wait();
         gpio_ctrl::instance().regs->set_pull_up_down_mode(gpio_pud_mode::off);
         gpio_ctrl::instance().regs->remove_all_pin_pull_up_down_clocks();
       }
+
+      void apply_pull(pin_id pin, unsigned mode)
+      {
+        std::uint32_t const mask{1U<<(pin%register_width)};
+        apply_pull( pin/register_width==0U ? mask : 0U
+                  , pin/register_width==1U ? mask : 0U
+                  , mode
+                  );
+      }
     }
 
     pin_base::pin_base(pin_id pin, direction_mode dir)
     : pin(pin)
+    , bank_regs{internal::gpio_register_words() + pin/32U}
+    , mask{1U<<(pin%32U)}
     {
       using internal::gpio_pin_fn;
       internal::gpio_ctrl::instance().alloc.allocate(pin);
-      internal::gpio_ctrl::instance().regs->set_pin_function
+      internal::gpio_ctrl::instance().config.set_pin_function
                                             ( pin
                                             , (dir==out) ? gpio_pin_fn::output
                                                          : gpio_pin_fn::input
@@ -53,37 +136,87 @@ namespace dibase { namespace rpi {
                                             );
     }
 
+    pin_base::pin_base(pin_id pin, internal::adopt_pin_t)
+    : pin(pin)
+    , bank_regs{internal::gpio_register_words() + pin/32U}
+    , mask{1U<<(pin%32U)}
+    {}
+
     pin_base::~pin_base()
     {
-      internal::gpio_ctrl::instance().alloc.deallocate(pin);
+      if (is_open())
+        {
+          internal::gpio_ctrl::instance().alloc.deallocate(pin);
+        }
+    }
+
+    pin_base::pin_base(pin_base && other) noexcept
+    : pin(other.pin)
+    , bank_regs{other.bank_regs}
+    , mask{other.mask}
+    {
+      other.bank_regs = nullptr;
     }
 
-    void opin::put( bool v )
+    pin_base& pin_base::operator=(pin_base && other)
     {
-      if ( v )
+      if (this!=&other)
         {
-          internal::gpio_ctrl::instance().regs->set_pin(get_pin());
+          if (is_open())
+            {
+              internal::gpio_ctrl::instance().alloc.deallocate(pin);
+            }
+          pin = other.pin;
+          bank_regs = other.bank_regs;
+          mask = other.mask;
+          other.bank_regs = nullptr;
         }
-      else
+      return *this;
+    }
+
+    ipin::~ipin()
+    {
+      if (is_open() && pull_mode!=pull_disable)
         {
-          internal::gpio_ctrl::instance().regs->clear_pin(get_pin());
+          internal::apply_pull(get_pin(), pull_disable);
         }
     }
 
-    ipin::~ipin()
+    ipin& ipin::operator=(ipin && other)
     {
-      internal::apply_pull(get_pin(), pull_disable);
+      if (this!=&other)
+        {
+          if (is_open() && pull_mode!=pull_disable)
+            {
+              internal::apply_pull(get_pin(), pull_disable);
+            }
+          pin_base::operator=(std::move(other));
+          pull_mode = other.pull_mode;
+        }
+      return *this;
     }
 
-    ipin::ipin(pin_id pin, unsigned mode)
-    : pin_base(pin, in)
+    void ipin::close_all(std::vector<ipin> & pins)
     {
-      internal::apply_pull(pin, mode);
+      using internal::register_width;
+      std::uint32_t bank_masks[2]{0U, 0U};
+      for (auto & p : pins)
+        {
+          if (p.is_open() && p.pull_mode!=pull_disable)
+            {
+              bank_masks[p.get_pin()/register_width] |= p.bank_mask();
+              p.pull_mode = pull_disable;
+            }
+        }
+      internal::apply_pull(bank_masks[0], bank_masks[1], pull_disable);
+      pins.clear();
     }
 
-    bool ipin::get()
+    ipin::ipin(pin_id pin, unsigned mode)
+    : pin_base(pin, in)
+    , pull_mode{mode}
     {
-        return internal::gpio_ctrl::instance().regs->pin_level(get_pin());
+      internal::apply_pull(pin, mode);
     }
   }
 }}
@@ -6,6 +6,8 @@
 /// @author Ralph E. McArdell
 
 #include "pin_alloc.h"
+#include "peripheral_simulator.h"
+#include "init_trace.h"
 #include "sysfs.h"
 #include <stdexcept>
 
@@ -13,13 +15,20 @@ namespace dibase { namespace rpi {
   namespace peripherals
   { namespace internal
     {
+    // Simulated peripherals have no sys filesystem GPIO support so pins are
+    // only allocated within the process by pin_cache_allocator.
       bool pin_export_allocator::is_in_use( pin_id pin )
       {
-        return internal::is_exported(pin);
+        return !simulated_peripherals_selected() && internal::is_exported(pin);
       }
 
       void pin_export_allocator::allocate( pin_id pin )
       {
+        if (simulated_peripherals_selected())
+          {
+            return;
+          }
+        init_trace_scope timing{init_phase::sysfs_export};
         if (internal::is_exported(pin))
           {
             throw bad_peripheral_alloc{"GPIO pin allocate: "
@@ -35,8 +44,42 @@ namespace dibase { namespace rpi {
           }
       }
 
+      void pin_export_allocator::allocate_all
+      ( pin_id const * pins
+      , std::size_t count
+      )
+      {
+        if (simulated_peripherals_selected())
+          {
+            return;
+          }
+        init_trace_scope timing{init_phase::sysfs_export};
+        std::uint64_t const exported{internal::exported_pins()};
+        for (std::size_t idx=0U; idx!=count; ++idx)
+          {
+            if (exported&(std::uint64_t{1}<<pins[idx]))
+              {
+                throw bad_peripheral_alloc{"GPIO pin allocate: "
+                                           "pin is in use by another process"
+                                          };
+              }
+          }
+        std::size_t const done{internal::export_pins(pins, count)};
+        if (done!=count)
+          {
+            internal::unexport_pins(pins, done);
+            throw std::runtime_error
+                  {"GPIO pin allocate: Unable to export GPIO pins for use."};
+          }
+      }
+
       void pin_export_allocator::deallocate( pin_id pin )
       {
+        if (simulated_peripherals_selected())
+          {
+            return;
+          }
+        init_trace_scope timing{init_phase::sysfs_unexport};
         if (!internal::is_exported(pin))
           {
             throw std::runtime_error( "GPIO pin deallocate: pin is NOT in use! "
@@ -51,6 +94,36 @@ namespace dibase { namespace rpi {
                   };
           }
       }
+
+      void pin_export_allocator::deallocate_all
+      ( pin_id const * pins
+      , std::size_t count
+      )
+      {
+        if (simulated_peripherals_selected())
+          {
+            return;
+          }
+        init_trace_scope timing{init_phase::sysfs_unexport};
+        std::uint64_t const exported{internal::exported_pins()};
+        for (std::size_t idx=0U; idx!=count; ++idx)
+          {
+            if (!(exported&(std::uint64_t{1}<<pins[idx])))
+              {
+                throw std::runtime_error( "GPIO pin deallocate: pin is NOT in "
+                                          "use! Was it unexported by another "
+                                          "process?"
+                                        );
+              }
+          }
+        if (internal::unexport_pins(pins, count)!=count)
+          {
+            throw std::runtime_error
+                  {"GPIO pin deallocate: Unable to unexport GPIO pins from "
+                   "use."
+                  };
+          }
+      }
     }
   }
 }} 
@@ -63,6 +63,7 @@
 # include "pin_id.h"
 # include "periexcept.h"
 # include "simple_allocator.h"
+# include <cstddef>
 
 namespace dibase { namespace rpi {
   namespace peripherals
@@ -83,6 +84,14 @@ namespace dibase { namespace rpi {
     /// the local cache and, if _not_ locally in use, passes the query onto the
     /// contained allocator.
     ///
+    /// The cache is an atomic simple_allocator bitmap. A pin is atomically
+    /// marked in use before an allocation request is passed on, and marked
+    /// free before a deallocation request is passed on, so when several
+    /// threads allocate or deallocate the same pin only one passes its request
+    /// on to the contained allocator and the others fail, without locking.
+    /// The contained allocator must itself be safe to call concurrently for
+    /// different pins.
+    ///
     /// @tparam PinAllocT Type of pin allocator to pass requests onto if 
     ///                   cached results indicate so. Dictates inter-process
     ///                   pin allocation policy.
@@ -103,8 +112,9 @@ namespace dibase { namespace rpi {
       /// If a pin has already been allocated using this allocator then throws
       /// a bad_peripheral_alloc exception, otherwise passes the pin_id to the
       /// allocate member function of the contained allocator, which is assumed
-      /// to also throw on allocation failure. If the call returns then the pin
-      /// is marked as in use in the per-instance Pin Allocation Table.
+      /// to also throw on allocation failure. The pin is marked as in use in
+      /// the per-instance Pin Allocation Table before the call and marked free
+      /// again if the call throws.
       ///
       /// @param[in]  pin   GPIO pin id for the GPIO pin to allocate for use.
       /// @exception  bad_peripheral_alloc is raised if the requested pin is
@@ -113,13 +123,31 @@ namespace dibase { namespace rpi {
       ///             a passed on allocation request should fail.
       void allocate(pin_id pin);
 
+      /// @brief Allocate several GPIO pins for use together
+      ///
+      /// All pins are first marked as in use in the per-instance Pin
+      /// Allocation Table, then the whole sequence is passed to the
+      /// allocate_all member function of the contained allocator, so it can
+      /// check and claim them in one pass. Either all the pins are allocated
+      /// or, if an exception is thrown, none are.
+      ///
+      /// @param[in]  pins  GPIO pin ids of the pins to allocate. Each may
+      ///                   only appear once.
+      /// @param[in]  count Number of pin ids in pins.
+      /// @exception  bad_peripheral_alloc is raised if any requested pin is
+      ///             already in use or appears more than once.
+      /// @exception  std::runtime_error (or other exception) is raised if
+      ///             the passed on allocation request should fail.
+        void allocate_all(pin_id const * pins, std::size_t count);
+
       /// @brief Deallocate a GPIO pin from use
       ///
       /// If a pin has not been allocated using this allocator then throws a
       /// std::logic_error exception, otherwise passes the pin_id to the
       /// deallocate member function of the contained allocator, which is also
-      /// assumed to throw on deallocation failure. If the call returns then
-      /// the pin is marked as free in the per-instance Pin Allocation Table.
+      /// assumed to throw on deallocation failure. The pin is marked as free in
+      /// the per-instance Pin Allocation Table before the call and marked in
+      /// use again if the call throws.
       ///
       /// @param[in]  pin   GPIO pin id for the GPIO pin to deallocate from use.
       /// @exception  std::logic_error is raised if the requested pin is not in
@@ -131,6 +159,22 @@ namespace dibase { namespace rpi {
       ///             current process' program.
         void deallocate(pin_id pin);
 
+      /// @brief Deallocate several GPIO pins from use together
+      ///
+      /// All pins are first checked to be in use locally, then marked as
+      /// free in the per-instance Pin Allocation Table and the whole sequence
+      /// passed to the deallocate_all member function of the contained
+      /// allocator. If that call throws the pins are marked in use again.
+      ///
+      /// @param[in]  pins  GPIO pin ids of the pins to deallocate. Each may
+      ///                   only appear once.
+      /// @param[in]  count Number of pin ids in pins.
+      /// @exception  std::logic_error is raised, and no pin deallocated, if
+      ///             any requested pin is not in use locally by this process.
+      /// @exception  std::runtime_error (or other exception) is raised if
+      ///             the passed on deallocation request should fail.
+        void deallocate_all(pin_id const * pins, std::size_t count);
+
       /// @brief Returns whether a GPIO pin is available _now_ for use
       ///
       /// If the pin is marked in use in the per-instance Pin Allocation Table
@@ -150,27 +194,106 @@ namespace dibase { namespace rpi {
       template <class PinAllocT>
       void pin_cache_allocator<PinAllocT>::allocate(pin_id pin)
       {
-        if (cache_alloc.is_in_use(pin))
+      // Claim pin locally first so only one thread passes the request on
+        if (!cache_alloc.allocate(pin))
           {
             throw bad_peripheral_alloc( "GPIO pin allocate: pin is already "
                                         "being used locally."
                                       );
           }
-        allocator.allocate(pin);
-        cache_alloc.allocate(pin);
+        try
+          {
+            allocator.allocate(pin);
+          }
+        catch (...)
+          {
+            cache_alloc.deallocate(pin);
+            throw;
+          }
+      }
+
+      template <class PinAllocT>
+      void pin_cache_allocator<PinAllocT>::allocate_all
+      ( pin_id const * pins
+      , std::size_t count
+      )
+      {
+        std::size_t claimed{0U};
+        try
+          {
+            for (; claimed!=count; ++claimed)
+              {
+                if (!cache_alloc.allocate(pins[claimed]))
+                  {
+                    throw bad_peripheral_alloc( "GPIO pin allocate: pin is "
+                                                "already being used locally."
+                                              );
+                  }
+              }
+            allocator.allocate_all(pins, count);
+          }
+        catch (...)
+          {
+            for (std::size_t idx=0U; idx!=claimed; ++idx)
+              {
+                cache_alloc.deallocate(pins[idx]);
+              }
+            throw;
+          }
       }
 
       template <class PinAllocT>
       void pin_cache_allocator<PinAllocT>::deallocate(pin_id pin)
       {
-        if (!cache_alloc.is_in_use(pin))
+      // Release pin locally first so only one thread passes the request on
+        if (!cache_alloc.deallocate(pin))
           {
             throw std::logic_error( "GPIO pin deallocate: pin is not in use "
                                     "locally."
                                   );
           }
-        allocator.deallocate(pin);
-        cache_alloc.deallocate(pin);
+        try
+          {
+            allocator.deallocate(pin);
+          }
+        catch (...)
+          { // Pin remains in use as far as the contained allocator knows
+            cache_alloc.allocate(pin);
+            throw;
+          }
+      }
+
+      template <class PinAllocT>
+      void pin_cache_allocator<PinAllocT>::deallocate_all
+      ( pin_id const * pins
+      , std::size_t count
+      )
+      {
+        for (std::size_t idx=0U; idx!=count; ++idx)
+          {
+            if (!cache_alloc.is_in_use(pins[idx]))
+              {
+                throw std::logic_error( "GPIO pin deallocate: pin is not in "
+                                        "use locally."
+                                      );
+              }
+          }
+        for (std::size_t idx=0U; idx!=count; ++idx)
+          {
+            cache_alloc.deallocate(pins[idx]);
+          }
+        try
+          {
+            allocator.deallocate_all(pins, count);
+          }
+        catch (...)
+          { // Pins remain in use as far as the contained allocator knows
+            for (std::size_t idx=0U; idx!=count; ++idx)
+              {
+                cache_alloc.allocate(pins[idx]);
+              }
+            throw;
+          }
       }
 
     /// @brief Allocator using sys filesystem gpio export/unexport for allocation
@@ -203,12 +326,120 @@ namespace dibase { namespace rpi {
       ///             be opened.
         void allocate(pin_id pin);
 
+      /// @brief Allocates several GPIO pins by exporting them in the sys
+      /// filesystem
+      ///
+      /// Whether any pin is already exported is determined by one read of
+      /// the sys filesystem GPIO directory and the pins are then exported
+      /// through the already open export file. Either all the pins are
+      /// exported or, if an exception is thrown, none are.
+      ///
+      /// @param[in]  pins  GPIO pin ids of the pins to allocate.
+      /// @param[in]  count Number of pin ids in pins.
+      /// @exception  bad_peripheral_alloc is raised if any requested pin is
+      ///             already exported.
+      /// @exception  std::runtime_error is raised if a pin cannot be
+      ///             exported.
+        void allocate_all(pin_id const * pins, std::size_t count);
+
       /// @brief Deallocates a GPIO pin by unexporting it in the sys filesystem
       ///
       /// @param[in]  pin   GPIO pin id for the GPIO pin to deallocate from use.
       /// @exception  std::runtime_error is raised if the requested pin is not
       ///             exported or the unexport file could not be opened.
         void deallocate(pin_id pin);
+
+      /// @brief Deallocates several GPIO pins by unexporting them in the sys
+      /// filesystem
+      ///
+      /// Whether every pin is exported is determined by one read of the sys
+      /// filesystem GPIO directory, before any pin is unexported.
+      ///
+      /// @param[in]  pins  GPIO pin ids of the pins to deallocate.
+      /// @param[in]  count Number of pin ids in pins.
+      /// @exception  std::runtime_error is raised if any requested pin is not
+      ///             exported, in which case none are unexported, or if a pin
+      ///             cannot be unexported.
+        void deallocate_all(pin_id const * pins, std::size_t count);
+      };
+
+    /// @brief Allocator using a POSIX shared memory registry for allocation
+    ///
+    /// An alternative to pin_export_allocator for use as a
+    /// pin_cache_allocator PinAllocT. The registry is a small named POSIX
+    /// shared memory object holding an atomic owner process id per GPIO pin,
+    /// zero for a free pin, so allocating, deallocating and querying a pin is
+    /// an atomic operation on mapped memory rather than sys filesystem file
+    /// operations.
+    ///
+    /// A pin whose owner process no longer exists, for example because it
+    /// exited without releasing its pins, is treated as free and is taken
+    /// over by the next allocation. Owners are checked using kill with signal
+    /// 0 so an owner process id reused by an unrelated process will be seen
+    /// as a live owner until that process exits.
+    ///
+    /// Only processes using the same registry cooperate: processes that use
+    /// sys filesystem export to claim pins are not seen.
+      class pin_shm_allocator
+      {
+        struct registry;
+
+        registry *  owners;
+
+      public:
+      /// @brief Default shared memory object name for the registry
+        constexpr static char const * default_name
+                                          {"/dibase-rpi-peripherals-pins"};
+
+      /// @brief Open, creating if necessary, and map the registry.
+      /// @param[in]  name  Name of the POSIX shared memory object holding the
+      ///                   registry. Defaults to default_name.
+      /// @exception  std::system_error is raised if the shared memory object
+      ///             cannot be opened, sized or mapped.
+        explicit pin_shm_allocator(char const * name=default_name);
+
+      /// @brief Unmap the registry. Pins owned by the process remain owned.
+        ~pin_shm_allocator();
+
+        pin_shm_allocator(pin_shm_allocator const &) = delete;
+        pin_shm_allocator & operator=(pin_shm_allocator const &) = delete;
+
+      /// @brief Determines if a GPIO pin is owned by a live process
+      /// @param[in]  pin     GPIO pin id of GPIO pin to see if it is in use.
+      /// @return true if the pin is in use at this moment or false otherwise
+        bool is_in_use(pin_id pin);
+
+      /// @brief Allocates a GPIO pin by recording the process as its owner
+      ///
+      /// @param[in]  pin   GPIO pin id for the GPIO pin to allocate for use.
+      /// @exception  bad_peripheral_alloc is raised if the requested pin is
+      ///             owned by a live process.
+        void allocate(pin_id pin);
+
+      /// @brief Allocates several GPIO pins, all or none
+      ///
+      /// @param[in]  pins  GPIO pin ids of the pins to allocate.
+      /// @param[in]  count Number of pin ids in pins.
+      /// @exception  bad_peripheral_alloc is raised if any requested pin is
+      ///             owned by a live process, in which case no pins are
+      ///             allocated.
+        void allocate_all(pin_id const * pins, std::size_t count);
+
+      /// @brief Deallocates a GPIO pin owned by the process
+      ///
+      /// @param[in]  pin   GPIO pin id for the GPIO pin to deallocate from use.
+      /// @exception  std::runtime_error is raised if the requested pin is not
+      ///             owned by the process.
+        void deallocate(pin_id pin);
+
+      /// @brief Deallocates several GPIO pins owned by the process
+      ///
+      /// An attempt is made to deallocate every pin even if some fail.
+      /// @param[in]  pins  GPIO pin ids of the pins to deallocate.
+      /// @param[in]  count Number of pin ids in pins.
+      /// @exception  std::runtime_error is raised if any requested pin is not
+      ///             owned by the process.
+        void deallocate_all(pin_id const * pins, std::size_t count);
       };
 
     /// @brief Standard GPIO pin allocator type alias
@@ -224,6 +455,13 @@ namespace dibase { namespace rpi {
     /// - deallocate if the pin is currently in use locally then it should
     ///   also be in use globally and so needs to be globally freed.
       typedef pin_cache_allocator<pin_export_allocator> pin_allocator;
+
+    /// @brief GPIO pin allocator type alias using the shared memory registry
+    ///
+    /// As pin_allocator but with pin_shm_allocator as the contained allocator
+    /// type, so allocations visible to other processes are made without any
+    /// sys filesystem operations.
+      typedef pin_cache_allocator<pin_shm_allocator> shm_pin_allocator;
     } // namespace internal closed
   } // namespace peripherals closed
 }} // namespaces rpi and dibase closed
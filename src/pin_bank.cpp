@@ -0,0 +1,82 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pin_bank.cpp
+/// @brief Bulk GPIO pin opening implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "pin_bank.h"
+#include "gpio_ctrl.h"
+#include "gpio_pull.h"
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    pin_bank::pin_bank
+    ( std::vector<pin_id> const & outputs
+    , std::vector<pin_bank_input> const & inputs
+    )
+    {
+      using internal::gpio_ctrl;
+      using internal::gpio_pin_fn;
+      using internal::register_width;
+
+    // Pull masks per mode: no pull, pull up, pull down
+      constexpr unsigned pull_modes{3U};
+      std::uint32_t pull_masks[pull_modes][2]{};
+      std::vector<pin_id> pins(outputs);
+      pins.reserve(outputs.size()+inputs.size());
+      for (auto const & input : inputs)
+        {
+          if (input.mode&ipin::pull_up && input.mode&ipin::pull_down)
+            {
+              throw std::invalid_argument
+                    ("Cannot open ipin with both pull up and down enabled!");
+            }
+          pull_masks[input.mode&(ipin::pull_up|ipin::pull_down)]
+                    [input.pin/register_width]
+                                      |= 1U<<(input.pin%register_width);
+          pins.push_back(input.pin);
+        }
+      out_pins.reserve(outputs.size());
+      in_pins.reserve(inputs.size());
+      std::vector<internal::gpio_pin_fn_setting> pin_fns;
+      pin_fns.reserve(pins.size());
+
+    // Nothing below throws once the pins are allocated
+      gpio_ctrl::instance().alloc.allocate_all(pins.data(), pins.size());
+      for (auto pin : outputs)
+        {
+          pin_fns.push_back({pin, gpio_pin_fn::output});
+        }
+      for (auto const & input : inputs)
+        {
+          pin_fns.push_back({input.pin, gpio_pin_fn::input});
+        }
+      gpio_ctrl::instance().config.set_pin_functions( pin_fns.begin()
+                                                    , pin_fns.end()
+                                                    );
+      for (unsigned mode=0U; mode!=pull_modes; ++mode)
+        {
+          internal::apply_pull(pull_masks[mode][0], pull_masks[mode][1], mode);
+        }
+      for (auto pin : outputs)
+        {
+          out_pins.push_back(opin{pin, internal::adopt_pin_t{}});
+        }
+      for (auto const & input : inputs)
+        {
+          in_pins.push_back(ipin{ input.pin
+                                , input.mode&(ipin::pull_up|ipin::pull_down)
+                                , internal::adopt_pin_t{}
+                                });
+        }
+    }
+
+    pin_bank::~pin_bank()
+    {
+      ipin::close_all(in_pins);
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
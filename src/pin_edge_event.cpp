@@ -8,6 +8,7 @@
 #include "pin_edge_event.h"
 #include "sysfs.h"
 #include "pin_alloc.h"
+#include "trace_marker.h"
 #include <system_error>
 #include <unistd.h>
 
@@ -67,12 +68,17 @@ namespace dibase { namespace rpi {
           }
       }
 
-      static int wait_for_event(int fd, timespec * pts)
+      static int poll_for_event(int fd, timespec * pts) noexcept
       {
         fd_set xfds;
         FD_ZERO(&xfds);
         FD_SET(fd, &xfds);
-        int rv{::pselect(fd+1, nullptr, nullptr, &xfds, pts, nullptr)};
+        return ::pselect(fd+1, nullptr, nullptr, &xfds, pts, nullptr);
+      }
+
+      static int wait_for_event(int fd, timespec * pts)
+      {
+        int rv{poll_for_event(fd, pts)};
         if (rv==-1)
           {
             throw std::system_error
@@ -84,6 +90,22 @@ namespace dibase { namespace rpi {
           }
         return rv;
       }
+
+      static int wait_for_event
+      ( int fd
+      , timespec * pts
+      , std::error_code & ec
+      ) noexcept
+      {
+        int rv{poll_for_event(fd, pts)};
+        if (rv==-1)
+          {
+            ec.assign(errno, std::system_category());
+            return 0;
+          }
+        ec.clear();
+        return rv;
+      }
     }
 
     pin_edge_event::pin_edge_event(ipin const & in, edge_mode mode)
@@ -91,14 +113,45 @@ namespace dibase { namespace rpi {
     , id{in.get_pin()}
     {}
     
-    pin_edge_event::~pin_edge_event()
+    void pin_edge_event::release() noexcept
     { // Allow no exceptions to escape.
+      if (pin_event_fd==-1)
+        {
+          return;
+        }
       try
       {
         internal::close_ipin_for_edge_events(pin_event_fd); // should not throw
         allocator().deallocate(id);  // should only throw if id not allocated!
       } 
       catch (...) {}
+      pin_event_fd = -1;
+    }
+
+    pin_edge_event::~pin_edge_event()
+    {
+      release();
+    }
+
+    pin_edge_event::pin_edge_event(pin_edge_event && other) noexcept
+    : pin_event_fd{other.pin_event_fd}
+    , id{other.id}
+    , counters(other.counters)
+    {
+      other.pin_event_fd = -1;
+    }
+
+    pin_edge_event& pin_edge_event::operator=(pin_edge_event && other) noexcept
+    {
+      if (this!=&other)
+        {
+          release();
+          pin_event_fd = other.pin_event_fd;
+          id = other.id;
+          counters = other.counters;
+          other.pin_event_fd = -1;
+        }
+      return *this;
     }
 
     bool pin_edge_event::signalled() const
@@ -109,6 +162,14 @@ namespace dibase { namespace rpi {
       return wait_for_event(pin_event_fd, &ts)==1;
     }
 
+    bool pin_edge_event::signalled(std::error_code & ec) const noexcept
+    {
+      timespec ts;
+      ts.tv_sec = 0L;
+      ts.tv_nsec = 0L;
+      return wait_for_event(pin_event_fd, &ts, ec)==1;
+    }
+
     void pin_edge_event::clear() const
     {
       if (::lseek(pin_event_fd,0,SEEK_SET)==-1)
@@ -132,17 +193,76 @@ namespace dibase { namespace rpi {
         }
      }
 
+    void pin_edge_event::clear(std::error_code & ec) const noexcept
+    {
+      char v{'\0'};
+      if (::lseek(pin_event_fd,0,SEEK_SET)==-1 || ::read(pin_event_fd,&v,1)==-1)
+        {
+          ec.assign(errno, std::system_category());
+          return;
+        }
+      ec.clear();
+    }
+
     void pin_edge_event::wait() const
     {
+      internal::trace_scope trace{"pin_edge_event wait"};
       wait_for_event(pin_event_fd, nullptr);
+      counters.count(io_event::wakeups);
     }
 
-    bool pin_edge_event::wait_(long t_rel_secs, long t_rel_ns) const
+    void pin_edge_event::wait(std::error_code & ec) const noexcept
     {
+      internal::trace_scope trace{"pin_edge_event wait"};
+      if (wait_for_event(pin_event_fd, nullptr, ec)==1)
+        {
+          counters.count(io_event::wakeups);
+        }
+    }
+
+    void pin_edge_event::wait(system_timer::time_point & when) const
+    {
+      internal::trace_scope trace{"pin_edge_event wait"};
+      wait_for_event(pin_event_fd, nullptr);
+      when = system_timer::now();
+      counters.count(io_event::wakeups);
+    }
+
+    bool pin_edge_event::wait_
+    ( long t_rel_secs
+    , long t_rel_ns
+    , system_timer::time_point * when
+    ) const
+    {
+      internal::trace_scope trace{"pin_edge_event wait"};
       timespec ts;
       ts.tv_sec = t_rel_secs;
       ts.tv_nsec = t_rel_ns;
-      return wait_for_event(pin_event_fd, &ts)==1;
+      bool const occurred{wait_for_event(pin_event_fd, &ts)==1};
+      if ( occurred && when )
+        {
+          *when = system_timer::now();
+        }
+      counters.count(occurred ? io_event::wakeups : io_event::timeouts);
+      return occurred;
+    }
+
+    bool pin_edge_event::wait_
+    ( long t_rel_secs
+    , long t_rel_ns
+    , std::error_code & ec
+    ) const noexcept
+    {
+      internal::trace_scope trace{"pin_edge_event wait"};
+      timespec ts;
+      ts.tv_sec = t_rel_secs;
+      ts.tv_nsec = t_rel_ns;
+      bool const occurred{wait_for_event(pin_event_fd, &ts, ec)==1};
+      if (!ec)
+        {
+          counters.count(occurred ? io_event::wakeups : io_event::timeouts);
+        }
+      return occurred;
     }
   }
 }}
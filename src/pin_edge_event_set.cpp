@@ -0,0 +1,230 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pin_edge_event_set.cpp
+/// @brief Multiple GPIO pin edge event waiting class implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "pin_edge_event_set.h"
+#include <system_error>
+#include <cerrno>
+#include <cstdint>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+    // epoll event data value used for the cancellation eventfd, which cannot
+    // be mistaken for a pin id.
+      std::uint32_t const cancel_token{~std::uint32_t{0U}};
+
+    // Flag set in the epoll event data value of periodic_timers, the rest of
+    // the value being the timer's address. Pin ids and the cancellation
+    // token never have it set.
+      std::uint64_t const timer_flag{std::uint64_t{1U}<<63};
+
+    // Most events returned by one epoll_wait call. Signalled file descriptors
+    // not returned by one call remain signalled for the next.
+      std::size_t const max_wait_events{pin_id::number_of_pins+1U+32U};
+
+      void throw_system_error(char const * what)
+      {
+        throw std::system_error(errno, std::system_category(), what);
+      }
+
+      void add_to_epoll(int epoll_fd, int fd, std::uint32_t events, std::uint32_t data)
+      {
+        epoll_event ev;
+        ev.events = events;
+        ev.data.u64 = 0U;
+        ev.data.u32 = data;
+        if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev)==-1)
+          {
+            throw_system_error( "pin_edge_event_set: adding file descriptor "
+                                "failed with error from call to epoll_ctl."
+                              );
+          }
+      }
+
+      void remove_from_epoll(int epoll_fd, int fd)
+      {
+        epoll_event ev{}; // non-null event pointer required before Linux 2.6.9
+        if (::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, &ev)==-1)
+          {
+            throw_system_error( "pin_edge_event_set: removing file descriptor "
+                                "failed with error from call to epoll_ctl."
+                              );
+          }
+      }
+    }
+
+    pin_edge_event_set::pin_edge_event_set()
+    : epoll_fd{::epoll_create1(EPOLL_CLOEXEC)}
+    , cancel_fd{-1}
+    {
+      if (epoll_fd==-1)
+        {
+          throw_system_error( "pin_edge_event_set: creating set failed with "
+                              "error from call to epoll_create1."
+                            );
+        }
+      cancel_fd = ::eventfd(0U, EFD_CLOEXEC|EFD_NONBLOCK);
+      if (cancel_fd==-1)
+        {
+          int const error{errno};
+          ::close(epoll_fd);
+          errno = error;
+          throw_system_error( "pin_edge_event_set: creating set failed with "
+                              "error from call to eventfd."
+                            );
+        }
+      try
+        {
+          add_to_epoll(epoll_fd, cancel_fd, EPOLLIN, cancel_token);
+        }
+      catch (...)
+        {
+          ::close(cancel_fd);
+          ::close(epoll_fd);
+          throw;
+        }
+    }
+
+    pin_edge_event_set::~pin_edge_event_set()
+    {
+      ::close(cancel_fd);
+      ::close(epoll_fd);
+    }
+
+    void pin_edge_event_set::add(pin_edge_event const & e)
+    {
+      add_to_epoll(epoll_fd, e.pin_event_fd, EPOLLPRI|EPOLLERR, e.id);
+    }
+
+    void pin_edge_event_set::remove(pin_edge_event const & e)
+    {
+      remove_from_epoll(epoll_fd, e.pin_event_fd);
+    }
+
+    void pin_edge_event_set::add(pin_line_event const & e)
+    {
+      add_to_epoll(epoll_fd, e.line_fd, EPOLLIN|EPOLLERR, e.id);
+    }
+
+    void pin_edge_event_set::remove(pin_line_event const & e)
+    {
+      remove_from_epoll(epoll_fd, e.line_fd);
+    }
+
+    void pin_edge_event_set::add(periodic_timer & t)
+    {
+      epoll_event ev;
+      ev.events = EPOLLIN;
+      ev.data.u64 = timer_flag|reinterpret_cast<std::uintptr_t>(&t);
+      if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, t.timer_fd, &ev)==-1)
+        {
+          throw_system_error( "pin_edge_event_set: adding file descriptor "
+                              "failed with error from call to epoll_ctl."
+                            );
+        }
+    }
+
+    void pin_edge_event_set::remove(periodic_timer const & t)
+    {
+      remove_from_epoll(epoll_fd, t.timer_fd);
+    }
+
+    std::size_t pin_edge_event_set::wait_
+    ( std::vector<pin_id> & pins
+    , std::vector<periodic_timer *> * timers
+    , int timeout_ms
+    ) const
+    {
+      epoll_event events[max_wait_events];
+      int const count{::epoll_wait( epoll_fd, events
+                                  , sizeof(events)/sizeof(events[0])
+                                  , timeout_ms
+                                  )};
+      if (count==-1)
+        {
+          throw_system_error( "pin_edge_event_set: waiting for pin edge "
+                              "events failed with error from call to "
+                              "epoll_wait."
+                            );
+        }
+      pins.clear();
+      if (timers)
+        {
+          timers->clear();
+        }
+      for (int idx=0; idx!=count; ++idx)
+        {
+          std::uint64_t const data{events[idx].data.u64};
+          if ((data&timer_flag)!=0U)
+            {
+              if (timers)
+                {
+                  timers->push_back(reinterpret_cast<periodic_timer *>
+                                      (static_cast<std::uintptr_t>
+                                                        (data&~timer_flag)));
+                }
+              continue;
+            }
+          if (events[idx].data.u32==cancel_token)
+            {
+              pins.clear();
+              if (timers)
+                {
+                  timers->clear();
+                }
+              break;
+            }
+          pins.push_back(pin_id{events[idx].data.u32});
+        }
+      return pins.size() + (timers ? timers->size() : 0U);
+    }
+
+    void pin_edge_event_set::cancel()
+    {
+      std::uint64_t const one{1U};
+      if (::write(cancel_fd, &one, sizeof(one))==-1 && errno!=EAGAIN)
+        {
+          throw_system_error( "pin_edge_event_set: cancelling set failed "
+                              "with error from call to write."
+                            );
+        }
+    }
+
+    bool pin_edge_event_set::is_cancelled() const
+    {
+      pollfd pfd;
+      pfd.fd = cancel_fd;
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+      int const rv{::poll(&pfd, 1, 0)};
+      if (rv==-1)
+        {
+          throw_system_error( "pin_edge_event_set: checking cancelled state "
+                              "failed with error from call to poll."
+                            );
+        }
+      return rv==1;
+    }
+
+    void pin_edge_event_set::reset()
+    {
+      std::uint64_t count{0U};
+      if (::read(cancel_fd, &count, sizeof(count))==-1 && errno!=EAGAIN)
+        {
+          throw_system_error( "pin_edge_event_set: resetting set failed "
+                              "with error from call to read."
+                            );
+        }
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,206 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pin_event_detector.cpp
+/// @brief Register level GPIO pin event detection implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "pin_event_detector.h"
+#include "gpio_ctrl.h"
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using internal::gpio_ctrl;
+
+    namespace
+    {
+      void set_detect_enables
+      ( std::uint32_t const (&bank_masks)[2]
+      , unsigned modes
+      , bool enable
+      )
+      {
+        using internal::gpio_detect_enable;
+        internal::gpio_config & config(gpio_ctrl::instance().config);
+        struct { unsigned mode; gpio_detect_enable reg; }
+          const detect_regs[]
+          { {pin_event_detector::rising, gpio_detect_enable::rising}
+          , {pin_event_detector::falling, gpio_detect_enable::falling}
+          , {pin_event_detector::high, gpio_detect_enable::high}
+          , {pin_event_detector::low, gpio_detect_enable::low}
+          , {pin_event_detector::async_rising, gpio_detect_enable::async_rising}
+          , { pin_event_detector::async_falling
+            , gpio_detect_enable::async_falling
+            }
+          };
+        for (auto const & detect_reg : detect_regs)
+          {
+            if ( modes&detect_reg.mode )
+              {
+                for (std::size_t bank=0; bank!=2; ++bank)
+                  {
+                    if ( bank_masks[bank] )
+                      {
+                        config.set_detect_enables
+                              (detect_reg.reg, bank, bank_masks[bank], enable);
+                      }
+                  }
+              }
+          }
+      }
+    }
+
+    pin_event_detector::pin_event_detector
+    ( ipin_group const & pins
+    , unsigned modes
+    )
+    : group(pins)
+    , modes(modes)
+    , armed_masks{pins.bank_masks[0], pins.bank_masks[1]}
+    {
+      if ( modes==0U || (modes&~unsigned(both|async_both|high|low))!=0U )
+        {
+          throw std::invalid_argument
+                ( "pin_event_detector::pin_event_detector: Invalid event "
+                  "detect modes"
+                );
+        }
+      clear();
+      set_detect_enables(group.bank_masks, modes, true);
+    }
+
+    pin_event_detector::~pin_event_detector()
+    {
+      set_detect_enables(armed_masks, modes, false);
+      clear();
+    }
+
+    void pin_event_detector::arm(pin_group_value_t mask)
+    {
+      std::uint32_t arm_masks[2];
+      group.to_bank_masks(mask, arm_masks);
+      arm_masks[0] &= ~armed_masks[0];
+      arm_masks[1] &= ~armed_masks[1];
+      set_detect_enables(arm_masks, modes, true);
+      armed_masks[0] |= arm_masks[0];
+      armed_masks[1] |= arm_masks[1];
+    }
+
+    void pin_event_detector::disarm(pin_group_value_t mask)
+    {
+      std::uint32_t disarm_masks[2];
+      group.to_bank_masks(mask, disarm_masks);
+      disarm_masks[0] &= armed_masks[0];
+      disarm_masks[1] &= armed_masks[1];
+      set_detect_enables(disarm_masks, modes, false);
+      armed_masks[0] &= ~disarm_masks[0];
+      armed_masks[1] &= ~disarm_masks[1];
+    }
+
+    pin_group_value_t pin_event_detector::signalled() const
+    {
+      auto & regs(gpio_ctrl::instance().regs);
+      std::uint32_t const events[2]
+                        { group.bank_masks[0] ? regs->pin_events(0) : 0U
+                        , group.bank_masks[1] ? regs->pin_events(1) : 0U
+                        };
+      return group.from_bank_values(events);
+    }
+
+    void pin_event_detector::clear(pin_group_value_t mask)
+    {
+      std::uint32_t clear_masks[2];
+      group.to_bank_masks(mask, clear_masks);
+      auto & regs(gpio_ctrl::instance().regs);
+      for (std::size_t bank=0; bank!=2; ++bank)
+        {
+          if ( clear_masks[bank] )
+            {
+              regs->clear_pin_events(bank, clear_masks[bank]);
+            }
+        }
+    }
+
+    pin_group_value_t pin_event_detector::fetch_and_clear()
+    {
+      auto & regs(gpio_ctrl::instance().regs);
+      std::uint32_t events[2]{0U, 0U};
+      for (std::size_t bank=0; bank!=2; ++bank)
+        {
+          if ( group.bank_masks[bank] )
+            {
+              events[bank] = regs->pin_events(bank)&group.bank_masks[bank];
+              if ( events[bank] )
+                {
+                  regs->clear_pin_events(bank, events[bank]);
+                }
+            }
+        }
+      return group.from_bank_values(events);
+    }
+
+    pin_group_value_t pin_event_detector::fetch_and_count
+    ( std::vector<std::uint64_t> & counts
+    )
+    {
+      if ( counts.size()<group.size() )
+        {
+          counts.resize(group.size());
+        }
+      pin_group_value_t const events{fetch_and_clear()};
+      for (pin_group_value_t e{events}, n{0U}; e!=0U; e>>=1, ++n)
+        {
+          counts[n] += e&1U;
+        }
+      return events;
+    }
+
+    pin_group_value_t pin_event_detector::fetch_and_clear
+    ( system_timer::time_point & when
+    )
+    {
+      auto & regs(gpio_ctrl::instance().regs);
+      std::uint32_t events[2]{0U, 0U};
+      for (std::size_t bank=0; bank!=2; ++bank)
+        {
+          if ( group.bank_masks[bank] )
+            {
+              events[bank] = regs->pin_events(bank)&group.bank_masks[bank];
+            }
+        }
+      if ( events[0]==0U && events[1]==0U )
+        {
+          return 0U;
+        }
+      when = system_timer::now();
+      for (std::size_t bank=0; bank!=2; ++bank)
+        {
+          if ( events[bank] )
+            {
+              regs->clear_pin_events(bank, events[bank]);
+            }
+        }
+      return group.from_bank_values(events);
+    }
+
+    pin_group_value_t pin_event_detector::poll
+    ( system_timer::duration timeout
+    , system_timer::time_point & when
+    )
+    {
+      std::uint64_t const t_end{system_timer::now_us()+timeout.count()};
+      do
+        {
+          pin_group_value_t events{fetch_and_clear(when)};
+          if ( events )
+            {
+              return events;
+            }
+        }
+      while ( system_timer::now_us()<t_end );
+      return 0U;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,172 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pin_group.cpp
+/// @brief GPIO pin group I/O class implementations.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "pin_group.h"
+#include "gpio_ctrl.h"
+#include "gpio_pull.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    pin_group_base::pin_group_base
+    ( std::initializer_list<pin_id> pins
+    , direction_mode dir
+    )
+    : bank_masks{0U, 0U}
+    {
+      using internal::gpio_ctrl;
+      using internal::gpio_pin_fn;
+      if ( pins.size()==0 )
+        {
+          throw std::invalid_argument("pin group must have at least one pin");
+        }
+      this->pins.reserve(pins.size());
+      std::vector<internal::gpio_pin_fn_setting> pin_fns;
+      pin_fns.reserve(pins.size());
+      try
+        {
+          for (auto pin : pins)
+            {
+              gpio_ctrl::instance().alloc.allocate(pin);
+              this->pins.push_back(pin);
+            }
+        }
+      catch (...)
+        {
+          for (auto pin : this->pins)
+            {
+              gpio_ctrl::instance().alloc.deallocate(pin);
+            }
+          throw;
+        }
+      using internal::register_width;
+      for (std::size_t idx=0; idx!=this->pins.size(); ++idx)
+        {
+          pin_id const pin{this->pins[idx]};
+          unsigned const bank(pin/register_width);
+          unsigned const bit(pin%register_width);
+          bank_masks[bank] |= 1U<<bit;
+          if ( idx!=0 && bit!=0 && this->pins[idx-1]+1U==pin )
+            { // extends run of previous pin, which is in the same bank
+              runs.back().mask = (runs.back().mask<<1)|1U;
+            }
+          else
+            {
+              runs.push_back
+                ( bit_run{ 1U
+                         , static_cast<unsigned char>(bank)
+                         , static_cast<unsigned char>(bit)
+                         , static_cast<unsigned char>(idx)
+                         }
+                );
+            }
+          pin_fns.push_back({ pin
+                            , (dir==out) ? gpio_pin_fn::output
+                                         : gpio_pin_fn::input
+                            });
+        }
+      gpio_ctrl::instance().config.set_pin_functions( pin_fns.begin()
+                                                    , pin_fns.end()
+                                                    );
+    }
+
+    pin_group_base::~pin_group_base()
+    {
+      for (auto pin : pins)
+        {
+          internal::gpio_ctrl::instance().alloc.deallocate(pin);
+        }
+    }
+
+    void pin_group_base::to_bank_masks
+    ( pin_group_value_t value
+    , std::uint32_t (&banks)[2]
+    ) const
+    {
+      banks[0] = 0U;
+      banks[1] = 0U;
+      for (auto const & run : runs)
+        {
+          banks[run.bank] |= (static_cast<std::uint32_t>(value>>run.group_shift)
+                             & run.mask
+                             ) << run.bank_shift;
+        }
+    }
+
+    pin_group_value_t pin_group_base::from_bank_values
+    ( std::uint32_t const (&banks)[2]
+    ) const
+    {
+      pin_group_value_t value{0U};
+      for (auto const & run : runs)
+        {
+          value |= pin_group_value_t((banks[run.bank]>>run.bank_shift)
+                                    & run.mask
+                                    ) << run.group_shift;
+        }
+      return value;
+    }
+
+    void opin_group::put( pin_group_value_t mask, pin_group_value_t values )
+    {
+      std::uint32_t set_masks[2];
+      std::uint32_t clear_masks[2];
+      to_bank_masks(mask&values, set_masks);
+      to_bank_masks(mask&~values, clear_masks);
+      auto & regs(internal::gpio_ctrl::instance().regs);
+      for (std::size_t bank=0; bank!=2; ++bank)
+        {
+          if ( set_masks[bank] )
+            {
+              regs->set_pins(bank, set_masks[bank]);
+            }
+          if ( clear_masks[bank] )
+            {
+              regs->clear_pins(bank, clear_masks[bank]);
+            }
+        }
+    }
+
+    ipin_group::ipin_group( std::initializer_list<pin_id> pins, unsigned mode )
+    : pin_group_base(pins, in)
+    , pull_mode{mode}
+    {
+      internal::apply_pull(bank_masks[0], bank_masks[1], mode);
+    }
+
+    ipin_group::~ipin_group()
+    {
+      if (pull_mode!=ipin::pull_disable)
+        {
+          internal::apply_pull( bank_masks[0], bank_masks[1]
+                              , ipin::pull_disable
+                              );
+        }
+    }
+
+    pin_group_value_t ipin_group::get()
+    {
+      auto & regs(internal::gpio_ctrl::instance().regs);
+      std::uint32_t const levels[2]
+                        { bank_masks[0] ? regs->pin_levels(0) : 0U
+                        , bank_masks[1] ? regs->pin_levels(1) : 0U
+                        };
+      return from_bank_values(levels);
+    }
+
+    gpio_snapshot_t gpio_snapshot()
+    {
+      auto & regs(internal::gpio_ctrl::instance().regs);
+      unsigned long long const levels{regs->pin_levels(0)};
+      return gpio_snapshot_t
+              { levels
+              | static_cast<unsigned long long>(regs->pin_levels(1))
+                                                <<internal::register_width
+              };
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
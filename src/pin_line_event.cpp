@@ -0,0 +1,212 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pin_line_event.cpp
+/// @brief GPIO character device pin edge event class implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "pin_line_event.h"
+#include "periexcept.h"
+#include "trace_marker.h"
+#include <system_error>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+      char const * const gpio_chip_path{"/dev/gpiochip0"};
+      char const * const consumer_label{"dibase-rpi-peripherals"};
+
+    // Number of kernel event records read per read system call.
+      std::size_t const read_batch_size{16U};
+
+      void throw_system_error(char const * what)
+      {
+        throw std::system_error(errno, std::system_category(), what);
+      }
+
+      int request_line
+      ( pin_id pin
+      , pin_edge_event::edge_mode mode
+      , std::uint32_t queue_size
+      )
+      {
+        std::uint64_t const rising_flag{GPIO_V2_LINE_FLAG_EDGE_RISING};
+        std::uint64_t const falling_flag{GPIO_V2_LINE_FLAG_EDGE_FALLING};
+        std::uint64_t const edge_flags
+                    { mode==pin_edge_event::rising  ? rising_flag
+                    : mode==pin_edge_event::falling ? falling_flag
+                    : mode==pin_edge_event::both    ? rising_flag|falling_flag
+                    : 0U
+                    };
+        if (edge_flags==0U)
+          {
+            throw std::invalid_argument{"pin_line_event: invalid edge mode."};
+          }
+        gpio_v2_line_request req;
+        std::memset(&req, 0, sizeof(req));
+        req.offsets[0] = pin;
+        req.num_lines = 1U;
+        req.event_buffer_size = queue_size;
+        req.config.flags = GPIO_V2_LINE_FLAG_INPUT | edge_flags;
+        std::strncpy(req.consumer, consumer_label, sizeof(req.consumer)-1);
+        int chip_fd{::open(gpio_chip_path, O_RDWR|O_CLOEXEC)};
+        if (chip_fd==-1)
+          {
+            throw_system_error( "pin_line_event: opening GPIO character "
+                                "device failed with error from call to open."
+                              );
+          }
+        int const rv{::ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req)};
+        int const error{errno};
+        ::close(chip_fd);
+        if (rv==-1)
+          {
+            if (error==EBUSY)
+              {
+                throw bad_peripheral_alloc{"pin_line_event: GPIO line is "
+                                           "already in use."};
+              }
+            errno = error;
+            throw_system_error( "pin_line_event: requesting GPIO line failed "
+                                "with error from call to ioctl."
+                              );
+          }
+        if (::fcntl(req.fd, F_SETFL, O_NONBLOCK)==-1)
+          {
+            int const error{errno};
+            ::close(req.fd);
+            errno = error;
+            throw_system_error( "pin_line_event: setting line non-blocking "
+                                "failed with error from call to fcntl."
+                              );
+          }
+        return req.fd;
+      }
+
+      int wait_for_event(int fd, int timeout_ms)
+      {
+        pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int const rv{::poll(&pfd, 1, timeout_ms)};
+        if (rv==-1)
+          {
+            throw_system_error( "pin_line_event: waiting/checking for pin edge "
+                                "event failed with error from call to poll."
+                              );
+          }
+        return rv;
+      }
+
+      std::chrono::nanoseconds monotonic_now()
+      {
+        ::timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        return std::chrono::seconds(now.tv_sec)
+             + std::chrono::nanoseconds(now.tv_nsec);
+      }
+    }
+
+    pin_line_event::pin_line_event
+    ( pin_id pin
+    , pin_edge_event::edge_mode mode
+    , std::uint32_t queue_size
+    )
+    : line_fd{request_line(pin, mode, queue_size)}
+    , id{pin}
+    , last_seqno{0U}
+    , lost_count{0U}
+    , latencies{nullptr}
+    {}
+
+    pin_line_event::~pin_line_event()
+    {
+      ::close(line_fd);
+    }
+
+    bool pin_line_event::signalled() const
+    {
+      return wait_for_event(line_fd, 0)==1;
+    }
+
+    std::size_t pin_line_event::read
+    ( edge_event_record * events
+    , std::size_t max_events
+    ) const
+    {
+      gpio_v2_line_event buffer[read_batch_size];
+      std::size_t count{0U};
+      while (count!=max_events)
+        {
+          std::size_t const batch{ max_events-count<read_batch_size
+                                 ? max_events-count : read_batch_size
+                                 };
+          ssize_t const rv{::read(line_fd, buffer, batch*sizeof(buffer[0]))};
+          if (rv==-1)
+            {
+              if (errno==EAGAIN)
+                {
+                  break;
+                }
+              throw_system_error( "pin_line_event: reading pin edge events "
+                                  "failed with error from call to read."
+                                );
+            }
+          std::size_t const n_read{static_cast<std::size_t>(rv)/sizeof(buffer[0])};
+          for (std::size_t idx=0; idx!=n_read; ++idx, ++count)
+            {
+              gpio_v2_line_event const & kevt(buffer[idx]);
+              if (last_seqno!=0U && kevt.line_seqno!=last_seqno+1U)
+                {
+                  lost_count += kevt.line_seqno-last_seqno-1U;
+                }
+              last_seqno = kevt.line_seqno;
+              events[count].pin = id;
+              events[count].edge = kevt.id==GPIO_V2_LINE_EVENT_RISING_EDGE
+                                 ? pin_edge_event::rising
+                                 : pin_edge_event::falling;
+              events[count].timestamp
+                                = std::chrono::nanoseconds(kevt.timestamp_ns);
+            }
+          if (n_read<batch)
+            {
+              break;
+            }
+        }
+      if (latencies && count!=0U)
+        { // Kernel line event time stamps are from CLOCK_MONOTONIC
+          std::chrono::nanoseconds const now{monotonic_now()};
+          for (std::size_t idx=0U; idx!=count; ++idx)
+            {
+              latencies->record(now-events[idx].timestamp);
+            }
+        }
+      return count;
+    }
+
+    std::size_t pin_line_event::wait_
+    ( edge_event_record * events
+    , std::size_t max_events
+    , int timeout_ms
+    ) const
+    {
+      internal::trace_scope trace{"pin_line_event wait"};
+      if (wait_for_event(line_fd, timeout_ms)==0)
+        {
+          return 0U;
+        }
+      return read(events, max_events);
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
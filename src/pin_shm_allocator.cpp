@@ -0,0 +1,166 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pin_shm_allocator.cpp
+/// @brief Implementation of POSIX shared memory GPIO pin allocator type.
+///
+/// Kept separate from the other pin allocation types so that programs not
+/// using it do not need to link with POSIX shared memory support.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "pin_alloc.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      struct pin_shm_allocator::registry
+      {
+        std::atomic<std::int32_t> owner[pin_id::number_of_pins];
+      };
+
+      namespace
+      {
+        static_assert( ATOMIC_INT_LOCK_FREE==2
+                     , "Shared memory pin registry requires lock free atomic "
+                       "int operations"
+                     );
+
+        bool is_live(std::int32_t pid)
+        {
+          return pid!=0 && (::kill(pid, 0)==0 || errno!=ESRCH);
+        }
+      }
+
+      constexpr char const * pin_shm_allocator::default_name;
+
+      pin_shm_allocator::pin_shm_allocator(char const * name)
+      {
+      // A newly created object is zero filled by ftruncate: all pins free
+        int fd{::shm_open(name, O_RDWR|O_CREAT, 0666)};
+        if (fd==-1)
+          {
+            throw std::system_error
+                  { errno, std::system_category()
+                  , "pin_shm_allocator: shm_open failed"
+                  };
+          }
+        if (::ftruncate(fd, sizeof(registry))==-1)
+          {
+            int const error{errno};
+            ::close(fd);
+            throw std::system_error
+                  { error, std::system_category()
+                  , "pin_shm_allocator: ftruncate failed"
+                  };
+          }
+        void * mapped{::mmap( nullptr, sizeof(registry)
+                            , PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0
+                            )};
+        int const error{errno};
+        ::close(fd);
+        if (mapped==MAP_FAILED)
+          {
+            throw std::system_error
+                  { error, std::system_category()
+                  , "pin_shm_allocator: mmap failed"
+                  };
+          }
+        owners = static_cast<registry *>(mapped);
+      }
+
+      pin_shm_allocator::~pin_shm_allocator()
+      {
+        ::munmap(owners, sizeof(registry));
+      }
+
+      bool pin_shm_allocator::is_in_use(pin_id pin)
+      {
+        return is_live(owners->owner[pin].load());
+      }
+
+      void pin_shm_allocator::allocate(pin_id pin)
+      {
+        std::int32_t const self{static_cast<std::int32_t>(::getpid())};
+        std::atomic<std::int32_t> & owner(owners->owner[pin]);
+        std::int32_t current{owner.load()};
+        do
+          {
+            if (current==self || is_live(current))
+              {
+                throw bad_peripheral_alloc{"GPIO pin allocate: "
+                                           "pin is in use by another process"
+                                          };
+              }
+          }
+        while (!owner.compare_exchange_weak(current, self));
+      }
+
+      void pin_shm_allocator::allocate_all
+      ( pin_id const * pins
+      , std::size_t count
+      )
+      {
+        std::size_t done{0U};
+        try
+          {
+            for (; done!=count; ++done)
+              {
+                allocate(pins[done]);
+              }
+          }
+        catch (...)
+          {
+            for (std::size_t idx=0U; idx!=done; ++idx)
+              {
+                deallocate(pins[idx]);
+              }
+            throw;
+          }
+      }
+
+      void pin_shm_allocator::deallocate(pin_id pin)
+      {
+        std::int32_t expected{static_cast<std::int32_t>(::getpid())};
+        if (!owners->owner[pin].compare_exchange_strong(expected, 0))
+          {
+            throw std::runtime_error( "GPIO pin deallocate: pin is NOT "
+                                      "owned by this process!"
+                                    );
+          }
+      }
+
+      void pin_shm_allocator::deallocate_all
+      ( pin_id const * pins
+      , std::size_t count
+      )
+      {
+        bool all_owned{true};
+        for (std::size_t idx=0U; idx!=count; ++idx)
+          {
+            std::int32_t expected{static_cast<std::int32_t>(::getpid())};
+            if (!owners->owner[pins[idx]].compare_exchange_strong(expected, 0))
+              {
+                all_owned = false;
+              }
+          }
+        if (!all_owned)
+          {
+            throw std::runtime_error( "GPIO pin deallocate: pin is NOT "
+                                      "owned by this process!"
+                                    );
+          }
+      }
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
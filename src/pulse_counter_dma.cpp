@@ -0,0 +1,208 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pulse_counter_dma.cpp
+/// @brief DMA sampled pulse counter implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "pulse_counter.h"
+#include "edge_tally.h"
+#include "gplev_sampler.h"
+#include "system_timer.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <system_error>
+#include <pthread.h>
+#include <sched.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+    // Samples the counting thread allows for DMA and system timer skew when
+    // deciding if uncounted samples were overwritten.
+      std::size_t const overwrite_margin{pulse_counter::buffer_samples/8U};
+
+    // Longest time the counting thread sleeps, bounding the time taken to
+    // stop at low sample rates.
+      std::chrono::milliseconds const max_sleep{10};
+    }
+
+    using namespace internal;
+
+    int const pulse_counter::any_cpu;
+    std::size_t const pulse_counter::buffer_samples;
+
+    pulse_counter::pulse_counter
+    ( ipin_group const & pins
+    , edge_mode edges
+    , hertz rate
+    , std::size_t window_samples
+    , std::size_t capacity
+    , int cpu
+    )
+    : group(pins)
+    , edges{edges}
+    , window_length{window_samples}
+    , ring{capacity}
+    , overrun_count{0U}
+    , lost_count{0U}
+    , stopping{false}
+    , counter_failed{false}
+    {
+      if (edges!=rising && edges!=falling && edges!=both)
+        {
+          throw std::invalid_argument{"pulse_counter::pulse_counter: invalid "
+                                      "edge mode."};
+        }
+      if (window_samples==0U)
+        {
+          throw std::invalid_argument{"pulse_counter::pulse_counter: window "
+                                      "has no samples."};
+        }
+      sampler.reset(new gplev_sampler{rate, buffer_samples, "pulse_counter"});
+      counter = std::thread{&pulse_counter::count_samples, this};
+      if (cpu!=any_cpu)
+        {
+          cpu_set_t cpus;
+          CPU_ZERO(&cpus);
+          CPU_SET(cpu, &cpus);
+          int const rv{::pthread_setaffinity_np( counter.native_handle()
+                                               , sizeof(cpus), &cpus
+                                               )};
+          if (rv!=0)
+            {
+              stopping.store(true, std::memory_order_release);
+              counter.join();
+              throw std::system_error
+                    ( rv
+                    , std::system_category()
+                    , "pulse_counter: setting counting thread CPU affinity "
+                      "failed with error from call to pthread_setaffinity_np."
+                    );
+            }
+        }
+    }
+
+    pulse_counter::~pulse_counter()
+    {
+      stopping.store(true, std::memory_order_release);
+      counter.join();
+    }
+
+    f_hertz pulse_counter::sample_rate() const
+    {
+      return sampler->rate();
+    }
+
+    void pulse_counter::count_samples()
+    {
+      try
+        {
+          std::vector<unsigned> pin_numbers;
+          for (std::size_t idx=0; idx!=group.size(); ++idx)
+            {
+              pin_numbers.push_back(group.get_pin(idx));
+            }
+          edge_tally tally{ pin_numbers, (edges&rising)!=0U
+                          , (edges&falling)!=0U
+                          };
+          std::uint64_t const start_us{sampler->start_us()};
+          std::chrono::microseconds const sleep_time
+            {std::min<std::chrono::microseconds>
+              ( std::chrono::microseconds{sampler->time_of(buffer_samples/4U)}
+              , max_sleep
+              )
+            };
+          pulse_count_window window;
+          std::size_t window_count{0U};
+          std::size_t next{0U};
+          bool started{false};
+          std::uint64_t last_us{start_us};
+        // Count from the sample at pos, relative to the sample before it
+          auto restart = [&](std::size_t pos, std::uint64_t now_us)
+                         {
+                           std::size_t const prev
+                                  {(pos+buffer_samples-1U)%buffer_samples};
+                           tally.start(sampler->sample(prev));
+                           next = pos;
+                           window.first_sample = gplev_sample_number
+                                      ( pos
+                                      , sampler->samples_in(now_us-start_us)
+                                      , buffer_samples
+                                      );
+                           window.counts.fill(0U);
+                           window_count = 0U;
+                         };
+          while (!stopping.load(std::memory_order_acquire))
+            {
+              std::this_thread::sleep_for(sleep_time);
+              std::uint64_t const now_us{system_timer::now_us()};
+              std::size_t const pos{sampler->position()};
+              if (!started)
+                {
+                  if (pos!=0U)
+                    {
+                      restart(pos, now_us);
+                      started = true;
+                      last_us = now_us;
+                    }
+                  continue;
+                }
+              std::uint64_t const elapsed{sampler->samples_in(now_us-last_us)};
+              last_us = now_us;
+              if (elapsed+overwrite_margin>=buffer_samples)
+                {
+                  std::uint64_t const first{window.first_sample};
+                  restart(pos, now_us);
+                  std::uint64_t const skipped
+                          {(window.first_sample-first)/window_length};
+                  lost_count.fetch_add( skipped==0U ? 1U : skipped
+                                      , std::memory_order_relaxed
+                                      );
+                  continue;
+                }
+              while (next!=pos)
+                {
+                  tally.add(sampler->sample(next), window.counts.data());
+                  next = (next+1U)%buffer_samples;
+                  if (++window_count==window_length)
+                    {
+                      window.start_us = start_us
+                                      + sampler->time_of(window.first_sample);
+                      if (!ring.try_push(window))
+                        {
+                          overrun_count.fetch_add
+                                          (1U, std::memory_order_relaxed);
+                        }
+                      window.first_sample += window_length;
+                      window.counts.fill(0U);
+                      window_count = 0U;
+                    }
+                }
+            }
+        }
+      catch (...)
+        {
+          counter_error = std::current_exception();
+          counter_failed.store(true, std::memory_order_release);
+        }
+    }
+
+    std::size_t pulse_counter::pop
+    ( pulse_count_window * windows
+    , std::size_t max_windows
+    )
+    {
+      std::size_t const count{ring.pop(windows, max_windows)};
+      if (count==0U && max_windows!=0U
+       && counter_failed.load(std::memory_order_acquire) && ring.empty())
+        {
+          std::rethrow_exception(counter_error);
+        }
+      return count;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -15,7 +15,10 @@ namespace dibase { namespace rpi {
   { namespace internal
     {
       pwm_ctrl::pwm_ctrl()
-      : regs(pwm_registers::physical_address, register_block_size)
+      : regs( peripheral_window::instance()
+            , pwm_registers::physical_address
+            , register_block_size
+            )
       {}
 
       pwm_ctrl & pwm_ctrl::instance()
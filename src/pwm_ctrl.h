@@ -35,6 +35,10 @@ namespace dibase { namespace rpi {
       /// @brief PWM channel allocator instance
         simple_allocator<number_of_pwm_channels>  alloc;
 
+      /// @brief PWM FIFO allocator: the FIFO is shared by both channels so
+      /// only one channel may stream from it at once
+        simple_allocator<1>                       fifo_alloc;
+
       /// @brief Singleton instance getter
       /// @returns THE instance of the PWM control object.
         static pwm_ctrl & instance();
@@ -0,0 +1,86 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_dither.cpp
+/// @brief Dithered PWM output implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "pwm_dither.h"
+#include "pwm_dither_pattern.h"
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      void fill_pwm_dither_pattern
+      ( std::uint32_t * words
+      , unsigned fraction_bits
+      , std::uint64_t level
+      )
+      {
+        std::uint64_t const cycle{std::uint64_t(1U)<<fraction_bits};
+        std::uint32_t const whole{static_cast<std::uint32_t>
+                                                    (level>>fraction_bits)};
+        std::uint64_t const fraction{level&(cycle-1U)};
+      // Word i is one more if the running total of the fraction crosses a
+      // whole count during it: a first order error diffusion
+        for (std::uint64_t i{0U}; i!=cycle; ++i)
+          {
+            words[i] = whole + static_cast<std::uint32_t>
+                                ( ((i+1U)*fraction>>fraction_bits)
+                                - (i*fraction>>fraction_bits)
+                                );
+          }
+      }
+    } // namespace internal closed
+
+    constexpr unsigned pwm_dither::fraction_bits_default;
+    constexpr unsigned pwm_dither::fraction_bits_max;
+
+    namespace
+    {
+      std::size_t checked_cycle_size(unsigned fraction_bits)
+      {
+        if (fraction_bits==0U || fraction_bits>pwm_dither::fraction_bits_max)
+          {
+            throw std::out_of_range{"pwm_dither::pwm_dither: fraction_bits "
+                                    "is not in the range [1,12]."};
+          }
+        return std::size_t(1U)<<fraction_bits;
+      }
+    }
+
+    pwm_dither::pwm_dither(pwm_pin & p, unsigned fraction_bits)
+    : stream(p, pwm_stream_mode::pwm, checked_cycle_size(fraction_bits))
+    , bits{fraction_bits}
+    , fine_level{0U}
+    , scale{std::uint64_t(p.get_range())<<fraction_bits}
+    {
+      set_level(0U);
+    }
+
+    void pwm_dither::set_level(std::uint64_t level)
+    {
+      if (level>scale)
+        {
+          throw std::out_of_range{"pwm_dither::set_level: level parameter "
+                                  "value is greater than full_scale()."};
+        }
+      internal::fill_pwm_dither_pattern(stream.half(0U), bits, level);
+      internal::fill_pwm_dither_pattern(stream.half(1U), bits, level);
+      fine_level = level;
+    }
+
+    void pwm_dither::set_ratio(double r)
+    {
+      if (r<0.0 || r>1.0)
+        {
+          throw std::out_of_range{"pwm_dither::set_ratio: r parameter value "
+                                  "is outside the range [0.0, 1.0]."};
+        }
+      set_level(static_cast<std::uint64_t>(scale*r+0.5));
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
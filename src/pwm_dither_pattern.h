@@ -0,0 +1,36 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_dither_pattern.h
+/// @brief \b Internal : spread a fractional PWM data value over a cycle of
+/// whole data values : function declaration.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_PWM_DITHER_PATTERN_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_PWM_DITHER_PATTERN_H
+
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Fill a cycle of PWM data values whose mean is a value with
+    /// fraction_bits bits below the binary point.
+    ///
+    /// Each word is the whole part of level, or one more. The words that are
+    /// one more are spread as evenly as possible over the cycle so the
+    /// filtered output ripple is as small as possible.
+    ///
+    /// @param[out] words         1<<fraction_bits words to fill.
+    /// @param[in]  fraction_bits Number of fractional bits of level.
+    /// @param[in]  level         Fixed point PWM data value.
+      void fill_pwm_dither_pattern
+      ( std::uint32_t * words
+      , unsigned fraction_bits
+      , std::uint64_t level
+      );
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_PWM_DITHER_PATTERN_H
@@ -0,0 +1,54 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_dma_compiler.h
+/// @brief \b Internal : compile a ping-pong PWM FIFO sample ring into DMA
+/// control blocks : type and function declarations.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_PWM_DMA_COMPILER_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_PWM_DMA_COMPILER_H
+
+# include "dma_arena.h"
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Locations within a compiled PWM DMA ring.
+      struct pwm_dma_ring
+      {
+        register_t            first_bus;  ///< Bus address of first CB
+        std::uint32_t *       halves[2];  ///< Sample buffer halves
+        register_t volatile * done;       ///< Half played flags, one per half
+      };
+
+    /// @brief Returns region bytes needed to compile a PWM DMA ring.
+    /// @param half_words Number of samples in each buffer half.
+      std::size_t pwm_dma_ring_size(std::size_t half_words);
+
+    /// @brief Compile a circular chain of DMA control blocks playing two
+    /// sample buffer halves to the PWM FIFO in turn.
+    ///
+    /// Each half is written to the FIFO paced by the PWM DREQ and is followed
+    /// by a control block setting the half's done flag to 1, so software can
+    /// tell the half is idle and may be refilled. The chain loops until the
+    /// DMA channel is stopped. Done flags and sample halves are zeroed.
+    ///
+    /// @param region     Region to allocate ring memory from.
+    /// @param half_words Number of samples in each buffer half.
+    /// @param fifo_bus   Bus address of the PWM FIFO input register.
+    /// @returns Locations within the compiled ring.
+    /// @throws std::invalid_argument if half_words is zero or too large for
+    ///         one control block transfer.
+    /// @throws std::bad_alloc if region does not have enough space.
+      pwm_dma_ring compile_pwm_dma_ring
+      ( dma_region & region
+      , std::size_t half_words
+      , register_t fifo_bus
+      );
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_PWM_DMA_COMPILER_H
@@ -0,0 +1,267 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_dma_stream.cpp
+/// @brief DMA fed PWM output implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "pwm_dma_stream.h"
+#include "pwm_dma_compiler.h"
+#include "dma_arena.h"
+#include "dma_ctrl.h"
+#include "pwm_ctrl.h"
+#include "periexcept.h"
+#include "trace_marker.h"
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      namespace
+      {
+        register_t const pwm_fifo_bus_address
+                  { peripheral_bus_address(pwm_registers::physical_address)
+                  + static_cast<register_t>(offsetof(pwm_registers, fifo_in))
+                  };
+
+      // Control blocks: play half 0, flag half 0, play half 1, flag half 1
+        std::size_t const ring_control_blocks{4U};
+
+      // Sample halves DMA transfer lengths are limited by the TXFR_LEN field
+        std::size_t const max_half_words{0x3FFFFFFFU/sizeof(register_t)};
+
+        std::size_t flags_size()
+        {
+          std::size_t const cb_size{sizeof(dma_control_block)};
+          return (3U*sizeof(register_t)+cb_size-1U)/cb_size*cb_size;
+        }
+      }
+
+      std::size_t pwm_dma_ring_size(std::size_t half_words)
+      {
+        return ring_control_blocks*sizeof(dma_control_block)
+             + flags_size()
+             + 2U*half_words*sizeof(register_t);
+      }
+
+      pwm_dma_ring compile_pwm_dma_ring
+      ( dma_region & region
+      , std::size_t half_words
+      , register_t fifo_bus
+      )
+      {
+        if (half_words==0U || half_words>max_half_words)
+          {
+            throw std::invalid_argument{"compile_pwm_dma_ring: half_words is "
+                                        "zero or too large."};
+          }
+        dma_control_block * cbs
+                        {region.allocate_control_blocks(ring_control_blocks)};
+        register_t * flags{static_cast<register_t *>
+                              (region.allocate(flags_size()).address)};
+        register_t * samples{static_cast<register_t *>
+                              (region.allocate(2U*half_words
+                                                  *sizeof(register_t)
+                                              ).address
+                              )};
+        flags[0] = 0U;  // Half 0 done flag
+        flags[1] = 0U;  // Half 1 done flag
+        flags[2] = 1U;  // Value written to set a done flag
+        std::memset(samples, 0, 2U*half_words*sizeof(register_t));
+        register_t const play_ti{ dma_control_block::ti_no_wide_bursts
+                                | dma_control_block::ti_wait_resp
+                                | dma_control_block::ti_src_inc
+                                | dma_control_block::ti_dest_dreq
+                                | dma_control_block::ti_permap(dma_dreq::pwm)
+                                };
+        register_t const flag_ti{ dma_control_block::ti_no_wide_bursts
+                                | dma_control_block::ti_wait_resp
+                                };
+        for (std::size_t half=0; half!=2U; ++half)
+          {
+            dma_control_block & play(cbs[2U*half]);
+            dma_control_block & flag(cbs[2U*half+1U]);
+            play.transfer_info = play_ti;
+            play.source_address
+                  = region.bus_address(samples+half*half_words);
+            play.dest_address = fifo_bus;
+            play.transfer_length
+                  = static_cast<register_t>(half_words*sizeof(register_t));
+            play.stride = 0U;
+            play.next_control_block = region.bus_address(&flag);
+            flag.transfer_info = flag_ti;
+            flag.source_address = region.bus_address(flags+2U);
+            flag.dest_address = region.bus_address(flags+half);
+            flag.transfer_length = sizeof(register_t);
+            flag.stride = 0U;
+            flag.next_control_block
+                  = region.bus_address(cbs+(2U*half+2U)%ring_control_blocks);
+            for (auto cb : {&play, &flag})
+              {
+                cb->reserved_do_not_use[0] = 0U;
+                cb->reserved_do_not_use[1] = 0U;
+              }
+          }
+        return pwm_dma_ring{ region.bus_address(cbs)
+                           , {samples, samples+half_words}
+                           , flags
+                           };
+      }
+    } // namespace internal closed
+
+    using namespace internal;
+
+    pwm_dma_stream::pwm_dma_stream
+    ( pwm_pin & p
+    , pwm_stream_mode mode
+    , std::size_t half_size
+    , wait_policy const & policy
+    )
+    : pin(p)
+    , half_words{half_size}
+    , next_half{0U}
+    , underrun_count{0U}
+    , waiting(policy)
+    {
+      if (half_size==0U)
+        {
+          throw std::invalid_argument{"pwm_dma_stream::pwm_dma_stream: "
+                                      "half_size is zero."};
+        }
+      std::size_t const size{pwm_dma_ring_size(half_words)};
+      memory.reset(new dma_arena{size});
+      dma_buffer const buffer
+                          {memory->allocate(size, alignof(dma_control_block))};
+      dma_region region{buffer.address, buffer.bus_address, buffer.size};
+      pwm_dma_ring const ring{ compile_pwm_dma_ring( region, half_words
+                                                   , pwm_fifo_bus_address
+                                                   )
+                             };
+      first_bus = ring.first_bus;
+      halves[0] = ring.halves[0];
+      halves[1] = ring.halves[1];
+      done = ring.done;
+      pwm_ctrl & pwm(pwm_ctrl::instance());
+      if (!pwm.fifo_alloc.allocate(0))
+        {
+          throw bad_peripheral_alloc( "pwm_dma_stream::pwm_dma_stream: PWM "
+                                      "FIFO is already being used locally."
+                                    );
+        }
+      try
+        {
+          dma_channel = dma_ctrl::instance().allocate_channel();
+        }
+      catch (...)
+        {
+          pwm.fifo_alloc.deallocate(0);
+          throw;
+        }
+      pwm_channel const ch{static_cast<pwm_channel>(pin.pwm)};
+      pwm.regs->set_enable(ch, false);
+      pwm.regs->set_dma_enable(false);
+      pwm.regs->set_mode(ch, mode==pwm_stream_mode::serialiser
+                               ? pwm_mode::serialiser : pwm_mode::pwm
+                        );
+      pwm.regs->set_repeat_last_data(ch, false);
+      pwm.regs->set_use_fifo(ch, true);
+      pwm.regs->clear_fifo();
+      pwm.regs->set_dma_data_req_threshold(7U);
+      pwm.regs->set_dma_panic_threshold(7U);
+    }
+
+    pwm_dma_stream::~pwm_dma_stream()
+    {
+      stop();
+      dma_ctrl::instance().deallocate_channel(dma_channel);
+      pwm_channel const ch{static_cast<pwm_channel>(pin.pwm)};
+      pwm_ctrl & pwm(pwm_ctrl::instance());
+      pwm.regs->set_dma_enable(false);
+      pwm.regs->set_use_fifo(ch, false);
+      pwm.regs->set_mode(ch, pwm_mode::pwm);
+      pwm.regs->clear_fifo();
+      pwm.fifo_alloc.deallocate(0);
+    }
+
+    std::uint32_t * pwm_dma_stream::half(unsigned idx)
+    {
+      if (idx>1U)
+        {
+          throw std::out_of_range{"pwm_dma_stream::half: idx parameter is not "
+                                  "0 or 1."};
+        }
+      return halves[idx];
+    }
+
+    void pwm_dma_stream::start()
+    {
+      volatile dma_channel_registers &
+                              ch(dma_ctrl::instance().regs->channel[dma_channel]);
+      ch.reset();
+      pwm_ctrl & pwm(pwm_ctrl::instance());
+      pwm.regs->set_enable(static_cast<pwm_channel>(pin.pwm), false);
+      pwm.regs->clear_fifo();
+      done[0] = 0U;
+      done[1] = 0U;
+      next_half = 0U;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      pwm.regs->set_dma_enable(true);
+      ch.start(first_bus);
+      pwm.regs->set_enable(static_cast<pwm_channel>(pin.pwm), true);
+    }
+
+    void pwm_dma_stream::stop()
+    {
+      dma_ctrl::instance().regs->channel[dma_channel].reset();
+      pwm_ctrl::instance().regs->set_enable
+                                (static_cast<pwm_channel>(pin.pwm), false);
+    }
+
+    bool pwm_dma_stream::is_running() const
+    {
+      return dma_ctrl::instance().regs->channel[dma_channel].is_active();
+    }
+
+    std::uint32_t * pwm_dma_stream::poll_idle_half()
+    {
+      if (done[next_half]==0U)
+        {
+          return nullptr;
+        }
+      done[next_half] = 0U;
+      if (done[next_half^1U]!=0U)
+        {
+          ++underrun_count;
+        }
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      std::uint32_t * idle{halves[next_half]};
+      next_half ^= 1U;
+      return idle;
+    }
+
+    std::uint32_t * pwm_dma_stream::wait_idle_half()
+    {
+      internal::trace_scope trace{"pwm_dma_stream wait"};
+      adaptive_wait waiter{waiting, wait_counts};
+      for (;;)
+        {
+          std::uint32_t * idle{poll_idle_half()};
+          if (idle)
+            {
+              return idle;
+            }
+          if (!is_running())
+            {
+              throw std::logic_error{"pwm_dma_stream::wait_idle_half: output "
+                                     "is not running."};
+            }
+          waiter.pause();
+        }
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,53 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_pair.cpp
+/// @brief PWM channel pair control implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "pwm_pair.h"
+#include "pwm_ctrl.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using namespace internal;
+
+    pwm_pair::pwm_pair(pwm_pin & first, pwm_pin & second)
+    : first_pin(first)
+    , second_pin(second)
+    {
+      if (first.pwm==second.pwm)
+        {
+          throw std::invalid_argument{"pwm_pair::pwm_pair: pins use the same "
+                                      "PWM channel."};
+        }
+    }
+
+    void pwm_pair::start() const
+    {
+      pwm_ctrl::instance().regs->set_enable_both(true);
+    }
+
+    void pwm_pair::stop() const
+    {
+      pwm_ctrl::instance().regs->set_enable_both(false);
+    }
+
+    void pwm_pair::set_data_counts
+    ( unsigned first_counts
+    , unsigned second_counts
+    )
+    {
+      if (first_counts>first_pin.range || second_counts>second_pin.range)
+        {
+          throw std::out_of_range{"pwm_pair::set_data_counts: counts parameter "
+                                  "value is greater than range."
+                                 };
+        }
+      auto & regs(pwm_ctrl::instance().regs);
+      regs->set_data(static_cast<pwm_channel>(first_pin.pwm), first_counts);
+      regs->set_data(static_cast<pwm_channel>(second_pin.pwm), second_counts);
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -10,6 +10,7 @@
 #include "gpio_ctrl.h"
 #include "gpio_alt_fn.h"
 #include "clock_parameters.h"
+#include "peripheral_barrier.h"
 
 namespace dibase { namespace rpi {
   namespace peripherals
@@ -32,7 +33,20 @@ namespace dibase { namespace rpi {
     )
     {
       clock_parameters cp(src_type, src_freq, freq); // CAN THROW!!!
+      peripheral_barrier(); // Clock manager access only
       pwm_ctrl::instance().set_clock(cp); // CAN THROW!!!
+      peripheral_barrier();
+      freq_min = cp.frequency_min();
+      freq_avg = cp.frequency_avg();
+      freq_max = cp.frequency_max();
+    }
+
+    void pwm_pin::set_clock(static_clock_settings const & s)
+    {
+      clock_parameters cp(s);
+      peripheral_barrier(); // Clock manager access only
+      pwm_ctrl::instance().set_clock(cp); // CAN THROW!!!
+      peripheral_barrier();
       freq_min = cp.frequency_min();
       freq_avg = cp.frequency_avg();
       freq_max = cp.frequency_max();
@@ -56,6 +70,33 @@ namespace dibase { namespace rpi {
       return pwm_ctrl::instance().regs->get_enable(pwm_ch);
     }
 
+    void pwm_pin::set_output_mode(pwm_output_mode mode)
+    {
+      pwm_channel pwm_ch{static_cast<pwm_channel>(pwm)};
+      pwm_ctrl::instance().regs->set_ms_enabled
+                                (pwm_ch, mode==pwm_output_mode::mark_space);
+    }
+
+    pwm_output_mode pwm_pin::output_mode() const
+    {
+      pwm_channel pwm_ch{static_cast<pwm_channel>(pwm)};
+      return pwm_ctrl::instance().regs->get_ms_enabled(pwm_ch)
+                                        ? pwm_output_mode::mark_space
+                                        : pwm_output_mode::balanced;
+    }
+
+    void pwm_pin::set_polarity_inverted(bool inverted)
+    {
+      pwm_channel pwm_ch{static_cast<pwm_channel>(pwm)};
+      pwm_ctrl::instance().regs->set_polarity_inverted(pwm_ch, inverted);
+    }
+
+    bool pwm_pin::is_polarity_inverted() const
+    {
+      pwm_channel pwm_ch{static_cast<pwm_channel>(pwm)};
+      return pwm_ctrl::instance().regs->get_polarity_inverted(pwm_ch);
+    }
+
     void pwm_pin::set_ratio(double r)
     {
       if (r<0.0 || r>1.0)
@@ -71,16 +112,50 @@ namespace dibase { namespace rpi {
     {
       pwm_channel pwm_ch{static_cast<pwm_channel>(pwm)};
       pwm_ctrl::instance().regs->set_data(pwm_ch, data);  
+      counters.count(io_event::updates);
     }
 
     pwm_pin::~pwm_pin()
     {
+      release();
+    }
+
+    pwm_pin::pwm_pin(pwm_pin && other) noexcept
+    : pwm(other.pwm)
+    , pin(other.pin)
+    , range(other.range)
+    , counters(other.counters)
+    {
+      other.pwm = no_channel;
+    }
+
+    pwm_pin& pwm_pin::operator=(pwm_pin && other)
+    {
+      if (this!=&other)
+        {
+          release();
+          pwm = other.pwm;
+          pin = other.pin;
+          range = other.range;
+          counters = other.counters;
+          other.pwm = no_channel;
+        }
+      return *this;
+    }
+
+    void pwm_pin::release()
+    {
+      if (pwm==no_channel)
+        { // Moved from: owns nothing
+          return;
+        }
       stop();
       pwm_ctrl::instance().alloc.deallocate(pwm);
       gpio_ctrl::instance().alloc.deallocate(pin);
+      pwm = no_channel;
     }
 
-    pwm_pin::pwm_pin(pin_id p, unsigned range)
+    pwm_pin::pwm_pin(pin_id p, unsigned range, pwm_output_mode mode)
     : pin(p)
     , range(range)
     {
@@ -118,6 +193,7 @@ namespace dibase { namespace rpi {
                                                   pwm_channel::gpio_pwm1
                  );
       this->pwm = static_cast<unsigned>(pwm_ch);
+      peripheral_barrier(); // PWM then GPIO: barriers at peripheral switches
       try
       {
         if ( !pwm_ctrl::instance().alloc.allocate(pwm) )
@@ -128,7 +204,8 @@ namespace dibase { namespace rpi {
           }
         pwm_ctrl::instance().regs->set_enable(pwm_ch, false);
         pwm_ctrl::instance().regs->set_mode(pwm_ch, pwm_mode::pwm);
-        pwm_ctrl::instance().regs->set_ms_enabled(pwm_ch, false);
+        pwm_ctrl::instance().regs->set_ms_enabled
+                                (pwm_ch, mode==pwm_output_mode::mark_space);
         pwm_ctrl::instance().regs->set_repeat_last_data(pwm_ch, false);
         pwm_ctrl::instance().regs->set_silence(pwm_ch, false);
         pwm_ctrl::instance().regs->set_polarity_inverted(pwm_ch, false);
@@ -141,7 +218,10 @@ namespace dibase { namespace rpi {
         gpio_ctrl::instance().alloc.deallocate(pin);
         throw; 
       }
-      gpio_ctrl::instance().regs->set_pin_function(pin,pwm_fn_info[0].alt_fn());
+      peripheral_barrier();
+      gpio_ctrl::instance().config.set_pin_function
+                                                (pin,pwm_fn_info[0].alt_fn());
+      peripheral_barrier();
     }
   }
 }}
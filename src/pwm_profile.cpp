@@ -0,0 +1,154 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_profile.cpp
+/// @brief Precomputed PWM duty sequence implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "pwm_profile.h"
+#include "periodic_timer.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+      double const pi{3.14159265358979323846};
+
+      void check_ratio(double r, char const * what)
+      {
+        if (r<0.0 || r>1.0)
+          {
+            throw std::out_of_range{what};
+          }
+      }
+    }
+
+    pwm_profile::pwm_profile(unsigned range)
+    : pwm_range{range}
+    {
+      if (range<pwm_pin::range_minimum)
+        {
+          throw std::invalid_argument{"pwm_profile::pwm_profile: range "
+                                      "parameter value is too small."
+                                     };
+        }
+    }
+
+    pwm_profile::pwm_profile
+    ( unsigned range
+    , double peak
+    , std::size_t ramp_steps
+    , std::size_t hold_steps
+    , pwm_profile_shape shape
+    )
+    : pwm_profile{range}
+    {
+      steps.reserve(2U*ramp_steps+hold_steps);
+      ramp(0.0, peak, ramp_steps, shape);
+      hold(peak, hold_steps);
+      ramp(peak, 0.0, ramp_steps, shape);
+    }
+
+    std::uint32_t pwm_profile::to_counts(double ratio) const
+    {
+      return static_cast<std::uint32_t>(pwm_range*ratio+0.5);
+    }
+
+    pwm_profile & pwm_profile::ramp
+    ( double from
+    , double to
+    , std::size_t count
+    , pwm_profile_shape shape
+    )
+    {
+      check_ratio(from, "pwm_profile::ramp: from parameter value is outside "
+                        "the range [0.0, 1.0].");
+      check_ratio(to, "pwm_profile::ramp: to parameter value is outside the "
+                      "range [0.0, 1.0].");
+      steps.reserve(steps.size()+count);
+      for (std::size_t n=1U; n<=count; ++n)
+        {
+          double const t{static_cast<double>(n)/count};
+          double const fraction{ shape==pwm_profile_shape::trapezoidal
+                               ? t
+                               : (1.0-std::cos(pi*t))/2.0
+                               };
+          steps.push_back(to_counts(from+(to-from)*fraction));
+        }
+      return *this;
+    }
+
+    pwm_profile & pwm_profile::hold(double ratio, std::size_t count)
+    {
+      check_ratio(ratio, "pwm_profile::hold: ratio parameter value is "
+                         "outside the range [0.0, 1.0].");
+      steps.insert(steps.end(), count, to_counts(ratio));
+      return *this;
+    }
+
+    std::size_t pwm_profile::play
+    ( pwm_pin & pin
+    , std::chrono::nanoseconds period
+    ) const
+    {
+      if (pin.get_range()!=pwm_range)
+        {
+          throw std::invalid_argument{"pwm_profile::play: pin range is not "
+                                      "the profile range."
+                                     };
+        }
+      std::size_t skipped{0U};
+      if (steps.empty())
+        {
+          return skipped;
+        }
+      periodic_timer timer{period};
+      std::size_t const last{steps.size()-1U};
+      for (std::size_t n=0U; n<=last; ++n)
+        {
+        // Deadlines passed beyond the first are steps already late
+          std::uint64_t const late{timer.wait()-1U};
+          if (late!=0U)
+            {
+              std::size_t const skip{ static_cast<std::size_t>
+                                        (std::min<std::uint64_t>(late,last-n))
+                                    };
+              skipped += skip;
+              n += skip;
+            }
+          pin.set_data_counts(steps[n]);
+        }
+      return skipped;
+    }
+
+    std::size_t pwm_profile::expand
+    ( std::uint32_t * words
+    , std::size_t count
+    , std::size_t & position
+    , unsigned cycles_per_step
+    ) const
+    {
+      if (cycles_per_step==0U || steps.empty())
+        {
+          throw std::invalid_argument{"pwm_profile::expand: cycles_per_step "
+                                      "is 0 or the profile is empty."
+                                     };
+        }
+      std::size_t const end{steps.size()*cycles_per_step};
+      std::size_t const taken{ position<end ? std::min(count, end-position)
+                                            : 0U
+                             };
+      for (std::size_t n=0U; n!=taken; ++n)
+        {
+          words[n] = steps[(position+n)/cycles_per_step];
+        }
+      std::fill(words+taken, words+count, steps.back());
+      position += taken;
+      return taken;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -112,6 +112,16 @@ namespace dibase { namespace rpi {
         register_t range2;      ///< PWM1 (channel 2) range register, RNG2
         register_t data2;       ///< PWM1 (channel 2) data register, DAT2
 
+      /// @brief Return the \ref control register PWENi bit for a channel.
+      ///
+      /// For combining with other channels' bits to enable several channels
+      /// with one write.
+      /// @param ch  PWM channel id to return enable bit for
+        constexpr static register_t enable_mask(pwm_channel ch)
+        {
+          return ctl_ch_shift(ch,ctl_enable);
+        }
+
       /// @brief Return value of \ref control register PWENi bit for specified
       /// channel.
       /// @param ch  PWM channel id to return enable state for
@@ -194,6 +204,17 @@ namespace dibase { namespace rpi {
                           : control & ~ctl_ch_shift(ch,ctl_enable);
         }
 
+      /// @brief Set value of \ref control register PWENi bits for both
+      /// channels with one register write, so they start in step.
+      /// @param state  Enable state to set: true : enabled; false : disabled
+        void set_enable_both(bool state) volatile
+        {
+          register_t const both{ ctl_enable
+                               | ctl_ch_shift(pwm_channel::pwm_ch2,ctl_enable)
+                               };
+          control = state ? control | both : control & ~both;
+        }
+
       /// @brief Set value of \ref control register PWENi bit for specified
       /// channel.
       /// @param ch     PWM channel id to set mode for
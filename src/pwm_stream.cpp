@@ -0,0 +1,133 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_stream.cpp
+/// @brief PWM FIFO stream class implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "pwm_stream.h"
+#include "pwm_ctrl.h"
+#include "periexcept.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using internal::pwm_ctrl;
+    using internal::pwm_channel;
+    using internal::pwm_mode;
+
+    pwm_stream::pwm_stream
+    ( pwm_pin & p
+    , pwm_stream_mode mode
+    , std::size_t capacity
+    , bool repeat_last
+    , wait_policy const & policy
+    )
+    : pin(p)
+    , ring{capacity}
+    , waiting(policy)
+    , underrun_count{0U}
+    , stopping{false}
+    , feeder_failed{false}
+    {
+      if (!pwm_ctrl::instance().fifo_alloc.allocate(0))
+        {
+          throw bad_peripheral_alloc( "pwm_stream::pwm_stream: PWM FIFO is "
+                                      "already being used locally."
+                                    );
+        }
+      pwm_channel const ch{static_cast<pwm_channel>(pin.pwm)};
+      auto & regs(pwm_ctrl::instance().regs);
+      regs->set_enable(ch, false);
+      regs->clear_fifo();
+      regs->clear_fifo_read_error();
+      regs->clear_fifo_write_error();
+      regs->set_mode(ch, mode==pwm_stream_mode::serialiser
+                           ? pwm_mode::serialiser : pwm_mode::pwm
+                    );
+      regs->set_repeat_last_data(ch, repeat_last);
+      regs->set_use_fifo(ch, true);
+      try
+        {
+          feeder = std::thread{&pwm_stream::feed, this};
+        }
+      catch (...)
+        {
+          regs->set_use_fifo(ch, false);
+          regs->set_repeat_last_data(ch, false);
+          regs->set_mode(ch, pwm_mode::pwm);
+          pwm_ctrl::instance().fifo_alloc.deallocate(0);
+          throw;
+        }
+    }
+
+    pwm_stream::~pwm_stream()
+    {
+      stopping.store(true, std::memory_order_release);
+      feeder.join();
+      pwm_channel const ch{static_cast<pwm_channel>(pin.pwm)};
+      auto & regs(pwm_ctrl::instance().regs);
+      regs->set_enable(ch, false);
+      regs->set_use_fifo(ch, false);
+      regs->set_repeat_last_data(ch, false);
+      regs->set_mode(ch, pwm_mode::pwm);
+      regs->clear_fifo();
+      pwm_ctrl::instance().fifo_alloc.deallocate(0);
+    }
+
+    void pwm_stream::feed()
+    {
+      try
+        {
+          wait_stats stats;
+          adaptive_wait waiter{waiting, stats};
+          auto & regs(pwm_ctrl::instance().regs);
+          while (!stopping.load(std::memory_order_acquire))
+            {
+              bool moved{false};
+              std::uint32_t word;
+              while (!regs->get_fifo_full() && ring.pop(&word, 1U)==1U)
+                {
+                  regs->set_fifo_input(word);
+                  moved = true;
+                }
+              if (regs->get_fifo_read_error())
+                {
+                  regs->clear_fifo_read_error();
+                  underrun_count.fetch_add(1U, std::memory_order_relaxed);
+                }
+              if (moved)
+                {
+                  waiter.restart();
+                }
+              else
+                {
+                  waiter.pause();
+                }
+            }
+        }
+      catch (...)
+        {
+          feeder_error = std::current_exception();
+          feeder_failed.store(true, std::memory_order_release);
+        }
+    }
+
+    std::size_t pwm_stream::write
+    ( std::uint32_t const * words
+    , std::size_t count
+    )
+    {
+      if (feeder_failed.load(std::memory_order_acquire))
+        {
+          std::rethrow_exception(feeder_error);
+        }
+      std::size_t queued{0U};
+      while (queued!=count && ring.try_push(words[queued]))
+        {
+          ++queued;
+        }
+      return queued;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,161 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file quadrature_decoder.cpp
+/// @brief Quadrature encoder decoder implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "quadrature_decoder.h"
+#include "gpio_ctrl.h"
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+      using internal::register_width;
+
+      // Marks an illegal transition in the step table
+      constexpr std::int8_t illegal_step{2};
+
+      // Step for each transition, indexed by (previous state<<2)|new state
+      // where a state is (A<<1)|B. Channel A leading B cycles the states
+      // 00, 10, 11, 01 which counts up.
+      constexpr std::int8_t step_table[16]
+      { 0, -1, +1, illegal_step   // from 00
+      , +1, 0, illegal_step, -1   // from 01
+      , -1, illegal_step, 0, +1   // from 10
+      , illegal_step, +1, -1, 0   // from 11
+      };
+
+      std::int16_t const no_encoder{-1};
+    }
+
+    quadrature_decoder::quadrature_decoder
+    ( std::vector<quadrature_channels> const & channels
+    )
+    : encoders{new encoder[channels.size()]}
+    , encoder_count{channels.size()}
+    , bank_masks{0U, 0U}
+    {
+      if (channels.empty())
+        {
+          throw std::invalid_argument{"quadrature_decoder: no encoders."};
+        }
+      for (auto & entry : pin_map)
+        {
+          entry = no_encoder;
+        }
+      for (std::size_t n=0U; n!=encoder_count; ++n)
+        {
+          pin_id const pins[]{channels[n].a, channels[n].b};
+          for (unsigned ch=0U; ch!=2U; ++ch)
+            {
+              if (pin_map[pins[ch]]!=no_encoder)
+                {
+                  throw std::invalid_argument{"quadrature_decoder: pin used "
+                                              "more than once."};
+                }
+              pin_map[pins[ch]] = static_cast<std::int16_t>(2U*n+ch);
+              bank_masks[pins[ch]/register_width]
+                                      |= 1U<<(pins[ch]%register_width);
+            }
+          encoder & e(encoders[n]);
+          e.a_bank = channels[n].a/register_width;
+          e.a_shift = channels[n].a%register_width;
+          e.b_bank = channels[n].b/register_width;
+          e.b_shift = channels[n].b%register_width;
+          e.state = 0U;
+          e.latched = 0;
+          e.position.store(0, std::memory_order_relaxed);
+          e.velocity.store(0, std::memory_order_relaxed);
+          e.illegal.store(0U, std::memory_order_relaxed);
+        }
+    }
+
+    void quadrature_decoder::step(encoder & e, unsigned state)
+    {
+      std::int8_t const delta{step_table[(e.state<<2)|state]};
+      e.state = state;
+      if (delta==illegal_step)
+        {
+          e.illegal.store( e.illegal.load(std::memory_order_relaxed)+1U
+                         , std::memory_order_relaxed
+                         );
+        }
+      else if (delta!=0)
+        {
+          e.position.store( e.position.load(std::memory_order_relaxed)+delta
+                          , std::memory_order_relaxed
+                          );
+        }
+    }
+
+    void quadrature_decoder::start(std::uint32_t const volatile * levels)
+    {
+      std::uint32_t const banks[]{levels[0], levels[1]};
+      for (std::size_t n=0U; n!=encoder_count; ++n)
+        {
+          encoder & e(encoders[n]);
+          e.state = ((banks[e.a_bank]>>e.a_shift)&1U)<<1
+                  | ((banks[e.b_bank]>>e.b_shift)&1U);
+        }
+    }
+
+    void quadrature_decoder::add(std::uint32_t const volatile * levels)
+    {
+      std::uint32_t const banks[]{levels[0], levels[1]};
+      for (std::size_t n=0U; n!=encoder_count; ++n)
+        {
+          encoder & e(encoders[n]);
+          step( e
+              , ((banks[e.a_bank]>>e.a_shift)&1U)<<1
+              | ((banks[e.b_bank]>>e.b_shift)&1U)
+              );
+        }
+    }
+
+    void quadrature_decoder::sample()
+    {
+      auto & regs(internal::gpio_ctrl::instance().regs);
+      std::uint32_t const levels[]
+                        { bank_masks[0] ? regs->pin_levels(0) : 0U
+                        , bank_masks[1] ? regs->pin_levels(1) : 0U
+                        };
+      add(levels);
+    }
+
+    void quadrature_decoder::add
+    ( edge_event_record const * events
+    , std::size_t count
+    )
+    {
+      for (std::size_t idx=0U; idx!=count; ++idx)
+        {
+          std::int16_t const entry{pin_map[events[idx].pin]};
+          if (entry==no_encoder)
+            {
+              continue;
+            }
+          encoder & e(encoders[entry/2]);
+          unsigned const bit{entry%2==0 ? 2U : 1U}; // A or B state bit
+          step( e
+              , events[idx].edge==pin_edge_event::rising ? e.state|bit
+                                                         : e.state&~bit
+              );
+        }
+    }
+
+    void quadrature_decoder::latch_velocities()
+    {
+      for (std::size_t n=0U; n!=encoder_count; ++n)
+        {
+          encoder & e(encoders[n]);
+          std::int64_t const now{e.position.load(std::memory_order_relaxed)};
+          e.velocity.store(now-e.latched, std::memory_order_relaxed);
+          e.latched = now;
+        }
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,51 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file register_lock.cpp
+/// @brief \b Internal : serialise read-modify-write updates of mapped
+/// peripheral register words between threads : implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "register_lock.h"
+#include "peridef.h"
+#include <cstdint>
+#include <thread>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      namespace
+      {
+        std::atomic<bool> locks[register_lock_stripes];
+
+        unsigned const spins_before_yield{64U};
+      }
+
+      std::size_t register_lock_stripe(void const volatile * word)
+      {
+        return ( reinterpret_cast<std::uintptr_t>(word)/sizeof(register_t) )
+               % register_lock_stripes;
+      }
+
+      register_word_lock::register_word_lock(void const volatile * word)
+      : flag(locks[register_lock_stripe(word)])
+      {
+        unsigned spins{0U};
+        while (flag.exchange(true, std::memory_order_acquire))
+          {
+            if (++spins==spins_before_yield)
+              {
+                spins = 0U;
+                std::this_thread::yield();
+              }
+          }
+      }
+
+      register_word_lock::~register_word_lock()
+      {
+        flag.store(false, std::memory_order_release);
+      }
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,63 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file register_lock.h
+/// @brief \b Internal : serialise read-modify-write updates of mapped
+/// peripheral register words between threads.
+///
+/// Registers such as GPFSELn hold fields for several pins, so changing one
+/// pin's field means reading the word, modifying it and writing it back.
+/// Two threads doing so at once to the same word can lose each other's
+/// changes. Holding a register_word_lock for the word around the update
+/// prevents this while leaving updates to other words free to proceed.
+///
+/// Exclusive load / store (LDREX / STREX) on the mapped words is not used as
+/// the peripheral mapping is device memory, for which the exclusive monitors
+/// are not guaranteed to work. Locks are process local: updates made by
+/// other processes are not serialised.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_REGISTER_LOCK_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_REGISTER_LOCK_H
+
+# include <atomic>
+# include <cstddef>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Number of locks register words are shared over.
+      constexpr std::size_t register_lock_stripes{64U};
+
+    /// @brief Returns the index of the lock used for a register word.
+    ///
+    /// Consecutive words use consecutive locks so words in the same register
+    /// block, such as GPFSEL0..5, never share a lock.
+    /// @param[in] word Address of register word.
+      std::size_t register_lock_stripe(void const volatile * word);
+
+    /// @brief Scoped spin lock for read-modify-write of a register word.
+    ///
+    /// Locks the word passed on construction until destruction. Updates are
+    /// a few register accesses so waiters spin rather than sleep. Locks are
+    /// not recursive: a thread must not lock a word it already has locked.
+      class register_word_lock
+      {
+        std::atomic<bool> & flag;
+
+      public:
+      /// @brief Construct, waiting until the word's lock is acquired.
+      /// @param[in] word Address of register word to be updated.
+        explicit register_word_lock(void const volatile * word);
+
+      /// @brief Destroy, releasing the word's lock.
+        ~register_word_lock();
+
+        register_word_lock(register_word_lock const &) = delete;
+        register_word_lock& operator=(register_word_lock const &) = delete;
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_REGISTER_LOCK_H
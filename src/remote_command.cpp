@@ -0,0 +1,935 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file remote_command.cpp
+/// @brief Remote command frame, server and client implementations.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "remote_command.h"
+#include "spi0_ctrl.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    constexpr std::size_t remote_frame::header_size;
+    constexpr std::size_t remote_frame::command_header_size;
+    constexpr std::size_t remote_frame::result_header_size;
+    constexpr std::size_t remote_frame::max_payload;
+    constexpr std::size_t remote_frame::max_commands;
+    constexpr std::uint32_t remote_frame::max_delay_us;
+    constexpr std::uint16_t remote_frame::version;
+
+    namespace
+    {
+      std::uint8_t const frame_magic[4]{'D','B','R','C'};
+      std::size_t const i2c_fifo_size{16U};
+
+      void put_le(std::uint8_t * p, std::uint64_t v, std::size_t n)
+      {
+        for (std::size_t i{0U}; i!=n; ++i, v>>=8)
+          {
+            p[i] = static_cast<std::uint8_t>(v);
+          }
+      }
+
+      std::uint64_t get_le(std::uint8_t const * p, std::size_t n)
+      {
+        std::uint64_t v{0U};
+        while (n!=0U)
+          {
+            v = (v<<8) | p[--n];
+          }
+        return v;
+      }
+
+      void append_le
+      ( std::vector<std::uint8_t> & f
+      , std::uint64_t v
+      , std::size_t n
+      )
+      {
+        f.resize(f.size()+n);
+        put_le(&f[f.size()-n], v, n);
+      }
+
+      std::vector<std::uint8_t> empty_frame()
+      {
+        std::vector<std::uint8_t> f(frame_magic, frame_magic+4);
+        append_le(f, remote_frame::version, 2U);
+        append_le(f, 0U, 2U);
+        append_le(f, 0U, 4U);
+        return f;
+      }
+
+    /// @brief Set a frame's item count and item byte count from its size.
+      void finish_frame(std::vector<std::uint8_t> & f, std::size_t items)
+      {
+        put_le(&f[6], items, 2U);
+        put_le(&f[8], f.size()-remote_frame::header_size, 4U);
+      }
+
+    /// @brief Check a frame header, returning its item count.
+      bool valid_header
+      ( std::uint8_t const * frame
+      , std::size_t length
+      , std::size_t & items
+      )
+      {
+        if ( length<remote_frame::header_size
+          || std::memcmp(frame, frame_magic, 4U)!=0
+          || get_le(frame+4, 2U)!=remote_frame::version
+          || get_le(frame+8, 4U)!=length-remote_frame::header_size
+          || length-remote_frame::header_size>remote_frame::max_payload
+           )
+          {
+            return false;
+          }
+        items = get_le(frame+6, 2U);
+        return true;
+      }
+
+      struct command
+      {
+        remote_op             op;
+        unsigned              target;
+        std::size_t           tx_count;
+        std::size_t           rx_count;
+        std::uint32_t         arg;
+        std::uint8_t const *  tx;
+      };
+
+      void append_result
+      ( std::vector<std::uint8_t> & f
+      , remote_outcome outcome
+      , std::int32_t status
+      , std::uint8_t const * data
+      , std::size_t count
+      )
+      {
+        append_le(f, static_cast<std::uint8_t>(outcome), 1U);
+        append_le(f, 0U, 1U);
+        append_le(f, count, 2U);
+        append_le(f, static_cast<std::uint32_t>(status), 4U);
+        f.insert(f.end(), data, data+count);
+      }
+
+    /// @brief Wait for a delay command's period, or until stop_fd becomes
+    /// readable.
+    /// @throws std::runtime_error if stop_fd became readable.
+      void wait(std::uint32_t us, int stop_fd)
+      {
+        using std::chrono::steady_clock;
+        steady_clock::time_point const until
+                        {steady_clock::now()+std::chrono::microseconds{us}};
+        for (;;)
+          {
+            auto const left( std::chrono::duration_cast
+                                      <std::chrono::nanoseconds>
+                                        (until-steady_clock::now()).count()
+                           );
+            if (left<=0)
+              {
+                return;
+              }
+            timespec const period{ static_cast<time_t>(left/1000000000)
+                                 , static_cast<long>(left%1000000000)
+                                 };
+            pollfd fds{stop_fd, POLLIN, 0}; // Ignored if stop_fd is -1
+            if (::ppoll(&fds, 1, &period, nullptr)>0)
+              {
+                throw std::runtime_error{"remote_command: delay interrupted "
+                                         "as the server is stopping."};
+              }
+          }
+      }
+
+      class targets_performer
+      {
+        remote_targets &              t;
+        int                           stop_fd;
+        spi0_slave_context const *    current;
+        std::vector<std::uint8_t>     rx;
+
+        void spi0_transfer(command const & c)
+        {
+          if (&t.spi0_slaves[c.target]!=current)
+            {
+              current = nullptr;
+              t.spi0->start_conversing(t.spi0_slaves[c.target]);
+              current = &t.spi0_slaves[c.target];
+            }
+          else
+            {
+              internal::spi0_ctrl::instance().regs_of(t.spi0->spi())
+                                            ->set_transfer_active(true);
+            }
+          rx.resize(t.spi0->transfer(c.tx, rx.data(), c.tx_count));
+          internal::spi0_ctrl::instance().regs_of(t.spi0->spi())
+                                            ->set_transfer_active(false);
+        }
+
+      public:
+        targets_performer(remote_targets & targets, int stop)
+        : t(targets)
+        , stop_fd{stop}
+        , current{nullptr}
+        {}
+
+        ~targets_performer()
+        {
+          if (current)
+            {
+              t.spi0->stop_conversing();
+            }
+        }
+
+      /// @brief Returns true if the command's target and counts are valid.
+        bool acceptable(command const & c) const
+        {
+          switch (c.op)
+            {
+            case remote_op::group_put:
+              return c.target<t.outputs.size() && c.tx_count==16U
+                  && c.rx_count==0U;
+            case remote_op::group_get:
+              return c.target<t.inputs.size() && c.tx_count==0U
+                  && c.rx_count==8U;
+            case remote_op::spi0_transfer:
+              return t.spi0 && c.target<t.spi0_slaves.size()
+                  && c.tx_count!=0U && c.rx_count==c.tx_count;
+            case remote_op::i2c_write:
+              return c.target<t.i2c.size() && c.rx_count==0U;
+            case remote_op::i2c_read:
+              return c.target<t.i2c.size() && c.tx_count==0U;
+            case remote_op::i2c_write_then_read:
+              return c.target<t.i2c.size() && c.tx_count!=0U
+                  && c.tx_count<=i2c_fifo_size;
+            case remote_op::delay:
+              return c.tx_count==0U && c.rx_count==0U
+                  && c.arg<=remote_frame::max_delay_us;
+            default:
+              return false;
+            }
+        }
+
+      /// @brief Perform an acceptable command, appending its result.
+        void perform(command const & c, std::vector<std::uint8_t> & response)
+        {
+          std::int32_t status{0};
+          rx.assign(c.rx_count, 0U);
+          std::size_t count{0U};
+          switch (c.op)
+            {
+            case remote_op::group_put:
+              t.outputs[c.target]->put(get_le(c.tx, 8U), get_le(c.tx+8, 8U));
+              rx.clear();
+              break;
+            case remote_op::group_get:
+              put_le(rx.data(), t.inputs[c.target]->get(), 8U);
+              break;
+            case remote_op::spi0_transfer:
+              spi0_transfer(c);
+              break;
+            case remote_op::i2c_write:
+              status = t.i2c[c.target]->write_all(c.arg, c.tx, c.tx_count);
+              rx.clear();
+              break;
+            case remote_op::i2c_read:
+              status = t.i2c[c.target]->read_all( c.arg, rx.data(), c.rx_count
+                                                , &count
+                                                );
+              rx.resize(count);
+              break;
+            case remote_op::i2c_write_then_read:
+              status = t.i2c[c.target]->write_then_read
+                                          ( c.arg, c.tx, c.tx_count
+                                          , rx.data(), c.rx_count, &count
+                                          );
+              rx.resize(count);
+              break;
+            case remote_op::delay:
+              wait(c.arg, stop_fd);
+              break;
+            }
+          append_result(response, remote_outcome::done, status, rx.data()
+                       , rx.size()
+                       );
+        }
+      };
+
+    /// @brief Wait until a socket is ready for events or stopping is asked.
+    /// @param[in] fd       Socket to wait on.
+    /// @param[in] events   POLLIN or POLLOUT.
+    /// @param[in] stop_fd  Becomes readable when waiting should end. -1 if
+    ///                     waiting is never ended early.
+    /// @returns false if stop_fd became readable.
+      bool wait_ready(int fd, short events, int stop_fd)
+      {
+        for (;;)
+          {
+            pollfd fds[2]{ {stop_fd, POLLIN, 0}, {fd, events, 0} };
+            if (::poll(fds, 2, -1)==-1)
+              {
+                if (errno==EINTR)
+                  {
+                    continue;
+                  }
+                throw std::system_error
+                      { errno, std::system_category()
+                      , "remote_command: waiting for socket failed with error "
+                        "from call to poll."
+                      };
+              }
+            if (fds[0].revents!=0)
+              {
+                return false;
+              }
+            if (fds[1].revents!=0)
+              {
+                return true;
+              }
+          }
+      }
+
+    /// @brief Write all of count bytes to a socket.
+    /// @returns false if stop_fd became readable first.
+      bool send_all
+      (int fd, std::uint8_t const * p, std::size_t count, int stop_fd)
+      {
+        while (count!=0U)
+          {
+            if (!wait_ready(fd, POLLOUT, stop_fd))
+              {
+                return false;
+              }
+            ssize_t const sent{::send(fd, p, count, MSG_NOSIGNAL)};
+            if (sent==-1)
+              {
+                if (errno==EINTR)
+                  {
+                    continue;
+                  }
+                throw std::system_error
+                      { errno, std::system_category()
+                      , "remote_command: sending frame failed with error "
+                        "from call to send."
+                      };
+              }
+            p += sent;
+            count -= static_cast<std::size_t>(sent);
+          }
+        return true;
+      }
+
+    /// @brief Read all of count bytes from a socket.
+    /// @returns false if the connection closed or stop_fd became readable
+    ///          first.
+      bool receive_all(int fd, std::uint8_t * p, std::size_t count, int stop_fd)
+      {
+        while (count!=0U)
+          {
+            if (!wait_ready(fd, POLLIN, stop_fd))
+              {
+                return false;
+              }
+            ssize_t const got{::recv(fd, p, count, 0)};
+            if (got==0)
+              {
+                return false;
+              }
+            if (got==-1)
+              {
+                if (errno==EINTR)
+                  {
+                    continue;
+                  }
+                throw std::system_error
+                      { errno, std::system_category()
+                      , "remote_command: receiving frame failed with error "
+                        "from call to recv."
+                      };
+              }
+            p += got;
+            count -= static_cast<std::size_t>(got);
+          }
+        return true;
+      }
+
+    /// @brief Read one frame from a socket.
+    /// @returns false if the connection closed, the header is malformed or
+    ///          stop_fd became readable first.
+      bool receive_frame
+      (int fd, std::vector<std::uint8_t> & frame, int stop_fd)
+      {
+        frame.resize(remote_frame::header_size);
+        if (!receive_all(fd, frame.data(), frame.size(), stop_fd))
+          {
+            return false;
+          }
+        std::size_t const length{get_le(&frame[8], 4U)};
+        if (length>remote_frame::max_payload)
+          {
+            return false;
+          }
+        frame.resize(remote_frame::header_size+length);
+        return receive_all( fd, frame.data()+remote_frame::header_size
+                          , length, stop_fd
+                          );
+      }
+
+    /// @brief Time to wait before accepting again after accept4 fails for
+    /// lack of resources such as file descriptors.
+      int const accept_backoff_ms{100};
+    }
+
+    remote_batch::remote_batch()
+    : frame(empty_frame())
+    , commands{0U}
+    , reply_bytes{0U}
+    {}
+
+    void remote_batch::add
+    ( remote_op op
+    , unsigned target
+    , std::uint8_t const * ptx
+    , std::size_t tx_count
+    , std::size_t rx_count
+    , std::uint32_t arg
+    )
+    {
+      if ( commands==remote_frame::max_commands || target>0xFFU
+        || tx_count>0xFFFFU || rx_count>0xFFFFU
+        || frame.size()-remote_frame::header_size
+           +remote_frame::command_header_size+tx_count
+           > remote_frame::max_payload
+        || reply_bytes+remote_frame::result_header_size+rx_count
+           > remote_frame::max_payload
+         )
+        {
+          throw std::length_error{"remote_batch::add: command does not fit "
+                                  "in the batch."};
+        }
+      append_le(frame, static_cast<std::uint8_t>(op), 1U);
+      append_le(frame, target, 1U);
+      append_le(frame, tx_count, 2U);
+      append_le(frame, rx_count, 2U);
+      append_le(frame, 0U, 2U);
+      append_le(frame, arg, 4U);
+      frame.insert(frame.end(), ptx, ptx+tx_count);
+      reply_bytes += remote_frame::result_header_size+rx_count;
+      finish_frame(frame, ++commands);
+    }
+
+    remote_batch & remote_batch::group_put
+    ( unsigned group
+    , pin_group_value_t mask
+    , pin_group_value_t values
+    )
+    {
+      std::uint8_t tx[16];
+      put_le(tx, mask, 8U);
+      put_le(tx+8, values, 8U);
+      add(remote_op::group_put, group, tx, sizeof(tx), 0U, 0U);
+      return *this;
+    }
+
+    remote_batch & remote_batch::group_get(unsigned group)
+    {
+      add(remote_op::group_get, group, nullptr, 0U, 8U, 0U);
+      return *this;
+    }
+
+    remote_batch & remote_batch::spi0_transfer
+    ( unsigned slave
+    , std::uint8_t const * ptx
+    , std::size_t count
+    )
+    {
+      if (count==0U)
+        {
+          throw std::invalid_argument{"remote_batch::spi0_transfer: count "
+                                      "must be greater than zero."};
+        }
+      add(remote_op::spi0_transfer, slave, ptx, count, count, 0U);
+      return *this;
+    }
+
+    remote_batch & remote_batch::i2c_write
+    ( unsigned bus
+    , std::uint32_t addrs
+    , std::uint8_t const * ptx
+    , std::size_t count
+    )
+    {
+      add(remote_op::i2c_write, bus, ptx, count, 0U, addrs);
+      return *this;
+    }
+
+    remote_batch & remote_batch::i2c_read
+    ( unsigned bus
+    , std::uint32_t addrs
+    , std::size_t count
+    )
+    {
+      add(remote_op::i2c_read, bus, nullptr, 0U, count, addrs);
+      return *this;
+    }
+
+    remote_batch & remote_batch::i2c_write_then_read
+    ( unsigned bus
+    , std::uint32_t addrs
+    , std::uint8_t const * ptx
+    , std::size_t tx_count
+    , std::size_t rx_count
+    )
+    {
+      add(remote_op::i2c_write_then_read, bus, ptx, tx_count, rx_count, addrs);
+      return *this;
+    }
+
+    remote_batch & remote_batch::delay(std::chrono::microseconds us)
+    {
+      if (us.count()<0 || us.count()>remote_frame::max_delay_us)
+        {
+          throw std::invalid_argument{"remote_batch::delay: delay must be in "
+                                      "the range [0, max_delay_us]."};
+        }
+      add( remote_op::delay, 0U, nullptr, 0U, 0U
+         , static_cast<std::uint32_t>(us.count())
+         );
+      return *this;
+    }
+
+    void remote_batch::clear()
+    {
+      frame = empty_frame();
+      commands = 0U;
+      reply_bytes = 0U;
+    }
+
+    pin_group_value_t remote_result::value() const
+    {
+      if (data.size()!=8U)
+        {
+          throw std::logic_error{"remote_result::value: result is not a "
+                                 "group value."};
+        }
+      return get_le(data.data(), 8U);
+    }
+
+    std::vector<remote_result> decode_remote_response
+    ( std::uint8_t const * frame
+    , std::size_t length
+    )
+    {
+      std::size_t items{0U};
+      if (!valid_header(frame, length, items))
+        {
+          throw std::runtime_error{"decode_remote_response: malformed "
+                                   "response frame header."};
+        }
+      std::vector<remote_result> results;
+      std::uint8_t const * p{frame+remote_frame::header_size};
+      std::uint8_t const * const end{frame+length};
+      while (items--!=0U)
+        {
+          if (end-p<static_cast<std::ptrdiff_t>
+                                  (remote_frame::result_header_size))
+            {
+              throw std::runtime_error{"decode_remote_response: response "
+                                       "frame truncated."};
+            }
+          std::size_t const count{get_le(p+2, 2U)};
+          remote_result r{ static_cast<remote_outcome>(p[0])
+                         , static_cast<std::int32_t>
+                              (static_cast<std::uint32_t>(get_le(p+4, 4U)))
+                         , {}
+                         };
+          p += remote_frame::result_header_size;
+          if (static_cast<std::size_t>(end-p)<count)
+            {
+              throw std::runtime_error{"decode_remote_response: response "
+                                       "frame truncated."};
+            }
+          r.data.assign(p, p+count);
+          p += count;
+          results.push_back(std::move(r));
+        }
+      if (p!=end)
+        {
+          throw std::runtime_error{"decode_remote_response: response frame "
+                                   "has trailing bytes."};
+        }
+      return results;
+    }
+
+    namespace
+    {
+    /// @brief Perform the commands of a command frame as for
+    /// perform_remote_batch, except that if stop_fd becomes readable during
+    /// a delay the delay fails and the remaining commands are skipped.
+      std::vector<std::uint8_t> perform_batch
+      ( remote_targets & targets
+      , std::uint8_t const * frame
+      , std::size_t length
+      , int stop_fd
+      )
+      {
+        std::size_t items{0U};
+        if ( !valid_header(frame, length, items)
+          || items>remote_frame::max_commands
+           )
+          {
+            throw std::invalid_argument{"perform_remote_batch: malformed "
+                                        "command frame header."};
+          }
+      // Parse every command before performing any
+        std::vector<command> commands;
+        commands.reserve(items);
+        std::size_t reply_bytes{0U};
+        std::uint8_t const * p{frame+remote_frame::header_size};
+        std::uint8_t const * const end{frame+length};
+        for (std::size_t i{0U}; i!=items; ++i)
+          {
+            if (end-p<static_cast<std::ptrdiff_t>
+                                    (remote_frame::command_header_size))
+              {
+                throw std::invalid_argument{"perform_remote_batch: command "
+                                            "frame truncated."};
+              }
+            command c{ static_cast<remote_op>(p[0]), p[1]
+                     , get_le(p+2, 2U), get_le(p+4, 2U)
+                     , static_cast<std::uint32_t>(get_le(p+8, 4U))
+                     , p+remote_frame::command_header_size
+                     };
+            p += remote_frame::command_header_size;
+            if (static_cast<std::size_t>(end-p)<c.tx_count)
+              {
+                throw std::invalid_argument{"perform_remote_batch: command "
+                                            "frame truncated."};
+              }
+            p += c.tx_count;
+            reply_bytes += remote_frame::result_header_size+c.rx_count;
+            commands.push_back(c);
+          }
+        if (p!=end)
+          {
+            throw std::invalid_argument{"perform_remote_batch: command frame "
+                                        "has trailing bytes."};
+          }
+        std::vector<std::uint8_t> response{empty_frame()};
+        if (reply_bytes>remote_frame::max_payload)
+          { // Results would not fit in a response frame: perform nothing
+            for (std::size_t i{0U}; i!=commands.size(); ++i)
+              {
+                append_result( response, remote_outcome::rejected, 0
+                             , nullptr, 0U
+                             );
+              }
+            finish_frame(response, commands.size());
+            return response;
+          }
+        targets_performer performer{targets, stop_fd};
+        bool failed{false};
+        for (std::size_t i{0U}; i!=commands.size(); ++i)
+          {
+            command const & c(commands[i]);
+            if (failed)
+              {
+                append_result( response, remote_outcome::skipped, 0
+                             , nullptr, 0U
+                             );
+              }
+            else if (!performer.acceptable(c))
+              {
+                append_result( response, remote_outcome::rejected, 0
+                             , nullptr, 0U
+                             );
+              }
+            else
+              {
+                try
+                  {
+                    performer.perform(c, response);
+                  }
+                catch (std::exception & e)
+                  { // Truncate the message to leave room for the remaining
+                    // commands' skipped results.
+                    failed = true;
+                    std::size_t const room
+                          { remote_frame::max_payload
+                          - (response.size()-remote_frame::header_size)
+                          - (commands.size()-i)
+                            *remote_frame::result_header_size
+                          };
+                    std::size_t const n
+                          {std::min<std::size_t>( {std::strlen(e.what())
+                                                  , room, 0xFFFFU
+                                                  }
+                                                )};
+                    append_result
+                      ( response, remote_outcome::failed, 0
+                      , reinterpret_cast<std::uint8_t const *>(e.what()), n
+                      );
+                  }
+              }
+          }
+        finish_frame(response, commands.size());
+        return response;
+      }
+    }
+
+    std::vector<std::uint8_t> perform_remote_batch
+    ( remote_targets & targets
+    , std::uint8_t const * frame
+    , std::size_t length
+    )
+    {
+      return perform_batch(targets, frame, length, -1);
+    }
+
+    remote_server::remote_server
+    ( remote_targets t
+    , std::uint16_t port
+    , char const * address
+    )
+    : targets(std::move(t))
+    , listen_fd{-1}
+    , stop_fds{-1, -1}
+    , bound_port{0U}
+    {
+      if (targets.spi0 && !targets.spi0->has_std_mode_support())
+        {
+          throw std::invalid_argument{"remote_server::remote_server: 3-wire "
+                                      "SPI standard mode not supported as the "
+                                      "MISO line has not been allocated to a "
+                                      "GPIO pin."};
+        }
+      for (auto const & c : targets.spi0_slaves)
+        {
+          if (c.mode!=spi0_mode::standard)
+            {
+              throw std::invalid_argument{"remote_server::remote_server: "
+                                          "slave context is not for standard "
+                                          "mode."};
+            }
+        }
+      sockaddr_in addr;
+      std::memset(&addr, 0, sizeof(addr));
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(port);
+      if (::inet_pton(AF_INET, address, &addr.sin_addr)!=1)
+        {
+          throw std::invalid_argument{"remote_server::remote_server: address "
+                                      "is not a valid IPv4 address."};
+        }
+      if (::pipe2(stop_fds, O_CLOEXEC)==-1)
+        {
+          throw std::system_error
+                { errno, std::system_category()
+                , "remote_server: creating stop pipe failed with error from "
+                  "call to pipe2."
+                };
+        }
+      listen_fd = ::socket(AF_INET, SOCK_STREAM|SOCK_CLOEXEC, 0);
+      int const on{1};
+      socklen_t addr_size{sizeof(addr)};
+      char const * failed_call{nullptr};
+      if (listen_fd==-1)
+        {
+          failed_call = "remote_server: creating socket failed with error "
+                        "from call to socket.";
+        }
+      else if ( ::setsockopt( listen_fd, SOL_SOCKET, SO_REUSEADDR
+                            , &on, sizeof(on)
+                            )==-1
+             || ::bind( listen_fd, reinterpret_cast<sockaddr *>(&addr)
+                      , sizeof(addr)
+                      )==-1
+              )
+        {
+          failed_call = "remote_server: binding socket failed with error "
+                        "from call to bind.";
+        }
+      else if ( ::listen(listen_fd, 1)==-1
+             || ::getsockname( listen_fd, reinterpret_cast<sockaddr *>(&addr)
+                             , &addr_size
+                             )==-1
+              )
+        {
+          failed_call = "remote_server: listening on socket failed with "
+                        "error from call to listen.";
+        }
+      if (failed_call)
+        {
+          int const error{errno};
+          if (listen_fd!=-1)
+            {
+              ::close(listen_fd);
+            }
+          ::close(stop_fds[0]);
+          ::close(stop_fds[1]);
+          throw std::system_error{error, std::system_category(), failed_call};
+        }
+      bound_port = ntohs(addr.sin_port);
+      if (targets.spi0)
+        {
+          targets.spi0->stop_conversing();
+        }
+      worker = std::thread{&remote_server::serve, this};
+    }
+
+    remote_server::~remote_server()
+    {
+      char const stop{0};
+      while (::write(stop_fds[1], &stop, 1)==-1 && errno==EINTR)
+        {
+        }
+      worker.join();
+      ::close(listen_fd);
+      ::close(stop_fds[0]);
+      ::close(stop_fds[1]);
+      if (targets.spi0)
+        {
+          targets.spi0->stop_conversing();
+        }
+    }
+
+    void remote_server::serve()
+    {
+      for (;;)
+        {
+          pollfd fds[2]{ {stop_fds[0], POLLIN, 0}, {listen_fd, POLLIN, 0} };
+          if (::poll(fds, 2, -1)==-1)
+            {
+              if (errno==EINTR)
+                {
+                  continue;
+                }
+              return; // Cannot wait for connections: stop serving
+            }
+          if (fds[0].revents!=0)
+            {
+              return;
+            }
+          int const fd{::accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC)};
+          if (fd==-1)
+            {
+              if (errno==EINTR || errno==ECONNABORTED || errno==EAGAIN)
+                {
+                  continue;
+                }
+            // E.g. EMFILE: accepting again at once would fail again, so back
+            // off for a while, ending early if the server is stopping.
+              pollfd stop{stop_fds[0], POLLIN, 0};
+              if (::poll(&stop, 1, accept_backoff_ms)!=0)
+                {
+                  return;
+                }
+              continue;
+            }
+          int const on{1};
+          ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+          try
+            {
+              serve_connection(fd);
+            }
+          catch (std::exception &)
+            { // Connection failed or frame malformed: drop the connection
+            }
+          ::close(fd);
+        }
+    }
+
+    void remote_server::serve_connection(int fd)
+    {
+      std::vector<std::uint8_t> frame;
+      while (receive_frame(fd, frame, stop_fds[0]))
+        {
+          std::vector<std::uint8_t> const response
+                    {perform_batch( targets, frame.data(), frame.size()
+                                  , stop_fds[0]
+                                  )};
+          if (!send_all(fd, response.data(), response.size(), stop_fds[0]))
+            {
+              return;
+            }
+        }
+    }
+
+    remote_client::remote_client(char const * host, std::uint16_t port)
+    : fd{-1}
+    {
+      addrinfo hints;
+      std::memset(&hints, 0, sizeof(hints));
+      hints.ai_family = AF_UNSPEC;
+      hints.ai_socktype = SOCK_STREAM;
+      addrinfo * found{nullptr};
+      std::string const service{std::to_string(port)};
+      if (::getaddrinfo(host, service.c_str(), &hints, &found)!=0)
+        {
+          throw std::runtime_error{"remote_client::remote_client: host could "
+                                   "not be resolved."};
+        }
+      int error{0};
+      for (addrinfo * a{found}; a && fd==-1; a=a->ai_next)
+        {
+          fd = ::socket(a->ai_family, a->ai_socktype|SOCK_CLOEXEC
+                       , a->ai_protocol
+                       );
+          if (fd!=-1 && ::connect(fd, a->ai_addr, a->ai_addrlen)==-1)
+            {
+              error = errno;
+              ::close(fd);
+              fd = -1;
+            }
+          else if (fd==-1)
+            {
+              error = errno;
+            }
+        }
+      ::freeaddrinfo(found);
+      if (fd==-1)
+        {
+          throw std::system_error
+                { error, std::system_category()
+                , "remote_client: connecting failed with error from call to "
+                  "connect."
+                };
+        }
+      int const on{1};
+      ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+
+    remote_client::~remote_client()
+    {
+      ::close(fd);
+    }
+
+    std::vector<remote_result> remote_client::run(remote_batch const & batch)
+    {
+      send_all(fd, batch.bytes().data(), batch.bytes().size(), -1);
+      std::vector<std::uint8_t> response;
+      if (!receive_frame(fd, response, -1))
+        {
+          throw std::runtime_error{"remote_client::run: server closed the "
+                                   "connection."};
+        }
+      return decode_remote_response(response.data(), response.size());
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
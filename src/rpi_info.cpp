@@ -7,6 +7,8 @@
 
 #include "rpi_info.h"
 #include "rpi_init.h"
+#include "board_descriptor.h"
+#include "init_trace.h"
 #include <stdexcept>
 #include <cstdio>
 #include <cstring>
@@ -94,8 +96,10 @@
         return version;
       }
 
-      static std::size_t one_time_init_major_version()
+      std::size_t read_cpuinfo_revision_code()
       {
+        peripherals::internal::init_trace_scope timing
+                                    {peripherals::init_phase::cpuinfo_read};
         std::size_t version{0};
         char const * cpu_info_path{"/proc/cpuinfo"};
         char const board_version_label[]{"Revision"};
@@ -128,22 +132,12 @@
           {
             fclose( info_file );
           }
-        if (version>0&&version<=3) return 1;
-        else if (version>3&&version<=0xf) return 2;
-        else if (version==0x10 || version==0x12) return 3; // 0x10:B+, 0x12:A+
-        else if (version==0x11) return 4; // Compute module
-        else
-          {
-            throw std::runtime_error( "rpi_init::init_major_version: Unable to "
-                                      "deduce board version from /proc/cpuinfo."
-                                    );
-          }
+        return version;
       }
 
       std::size_t rpi_init::init_major_version()
       {
-        static std::size_t major_version{one_time_init_major_version()};
-        return major_version;
+        return peripherals::internal::running_board().major_version;
       }
     } // Closing namespace internal
 
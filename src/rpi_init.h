@@ -32,8 +32,15 @@
     /// board. Rev. 1 for hardware revisions <= 3, revision 2 for hardware
     /// revisions > 3 (4,5,6, ...) as indicated by /proc/cpuinfo Revision.
     /// @return 1 for hardware revisions <=3, 2 otherwise.
+    ///
+    /// The default implementation returns the major version of the process
+    /// wide board descriptor, see peripherals::internal::running_board.
       virtual std::size_t init_major_version();
      };
+
+ /// @brief Read the raw Revision value from /proc/cpuinfo
+ /// @return Revision value, or 0 if it could not be read.
+    std::size_t read_cpuinfo_revision_code();
   }
 }}
 #endif // DIBASE_RPI_RPI_INTERNAL_INIT_H
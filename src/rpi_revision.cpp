@@ -232,6 +232,9 @@
         case rpi_ram::mb256: return 256;
         case rpi_ram::mb512: return 512;
         case rpi_ram::mb1024: return 1024;
+        case rpi_ram::mb2048: return 2048;
+        case rpi_ram::mb4096: return 4096;
+        case rpi_ram::mb8192: return 8192;
         default: return 0;
       };
     }
@@ -257,4 +260,4 @@
     }
   }
 }
- 
\ No newline at end of file
+ 
\ No newline at end of file
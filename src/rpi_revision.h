@@ -9,6 +9,7 @@
  #define DIBASE_RPI_RPI_REVISION_H
 
  #include <cstdlib>
+ #include <cstdint>
 
  namespace dibase {
   namespace rpi
@@ -21,6 +22,17 @@
     , pi_2_b
     , alpha
     , compute_module
+    , pi_3_b = 8
+    , pi_zero
+    , compute_module_3
+    , pi_zero_w = 0xc
+    , pi_3_b_plus
+    , pi_3_a_plus
+    , compute_module_3_plus = 0x10
+    , pi_4_b
+    , pi_zero_2_w
+    , pi_400
+    , compute_module_4
     };
 
     enum class rpi_maker
@@ -35,12 +47,17 @@
     enum class rpi_processor
     { bcm2835
     , bcm2836
+    , bcm2837
+    , bcm2711
     };
 
     enum class rpi_ram
     { mb256
     , mb512
     , mb1024
+    , mb2048
+    , mb4096
+    , mb8192
     };
 
     class rpi_revision
@@ -63,7 +80,7 @@
       rpi_processor processor();
       rpi_ram ram();
       unsigned int ram_MB();
-      unsigned int ram_B() { return ram_MB()*1024*1024; }
+      std::uint64_t ram_B() { return std::uint64_t{ram_MB()}*1024*1024; }
       rpi_maker maker();
       unsigned int version();
       bool turbo();
@@ -73,4 +90,4 @@
   }
  }
  #endif // DIBASE_RPI_RPI_REVISION_H
- 
\ No newline at end of file
+ 
\ No newline at end of file
@@ -0,0 +1,198 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file rt_thread.cpp
+/// @brief Real-time thread configuration and periodic loop pacing
+/// implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "rt_thread.h"
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <alloca.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+    /// @brief Touch each page of size bytes of stack below the caller's frame.
+    ///
+    /// Not inlined so the alloca'd block is released on return, leaving the
+    /// touched pages present for the caller's later use.
+      __attribute__((noinline)) void prefault_stack(std::size_t size)
+      {
+        std::size_t const page
+                            {static_cast<std::size_t>(::sysconf(_SC_PAGESIZE))};
+        volatile unsigned char * stack
+                  {static_cast<volatile unsigned char *>(::alloca(size))};
+        for (std::size_t offset=0U; offset<size; offset+=page)
+          {
+            stack[offset] = 0U;
+          }
+      }
+
+      std::chrono::nanoseconds monotonic_now()
+      {
+        ::timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        return std::chrono::seconds{now.tv_sec}
+             + std::chrono::nanoseconds{now.tv_nsec};
+      }
+    }
+
+    constexpr int rt_config::any_cpu;
+    constexpr int rt_config::no_priority;
+
+    rt_scope::rt_scope(rt_config const & c)
+    : old_policy{SCHED_OTHER}
+    , old_param{}
+    , policy_set{false}
+    , affinity_set{false}
+    {
+      if ( c.priority!=rt_config::no_priority
+        && ( c.priority<::sched_get_priority_min(SCHED_FIFO)
+          || c.priority>::sched_get_priority_max(SCHED_FIFO)
+           )
+         )
+        {
+          throw std::invalid_argument{"rt_scope::rt_scope: priority not in "
+                                      "SCHED_FIFO priority range."};
+        }
+      if (c.cpu!=rt_config::any_cpu && (c.cpu<0 || c.cpu>=CPU_SETSIZE))
+        {
+          throw std::invalid_argument{"rt_scope::rt_scope: cpu not a valid "
+                                      "CPU number."};
+        }
+      ::pthread_t const self{::pthread_self()};
+      if (c.cpu!=rt_config::any_cpu)
+        {
+          int rv{::pthread_getaffinity_np(self, sizeof(old_cpus), &old_cpus)};
+          if (rv==0)
+            {
+              ::cpu_set_t cpus;
+              CPU_ZERO(&cpus);
+              CPU_SET(c.cpu, &cpus);
+              rv = ::pthread_setaffinity_np(self, sizeof(cpus), &cpus);
+            }
+          if (rv!=0)
+            {
+              throw std::system_error
+                    ( rv
+                    , std::system_category()
+                    , "rt_scope: setting thread CPU affinity failed with error "
+                      "from call to pthread_setaffinity_np."
+                    );
+            }
+          affinity_set = true;
+        }
+      if (c.priority!=rt_config::no_priority)
+        {
+          int rv{::pthread_getschedparam(self, &old_policy, &old_param)};
+          if (rv==0)
+            {
+              ::sched_param param{};
+              param.sched_priority = c.priority;
+              rv = ::pthread_setschedparam(self, SCHED_FIFO, &param);
+            }
+          if (rv!=0)
+            {
+              restore();
+              throw std::system_error
+                    ( rv
+                    , std::system_category()
+                    , "rt_scope: setting SCHED_FIFO priority failed with error "
+                      "from call to pthread_setschedparam."
+                    );
+            }
+          policy_set = true;
+        }
+      if (c.lock_memory && ::mlockall(MCL_CURRENT|MCL_FUTURE)!=0)
+        {
+          int const error{errno};
+          restore();
+          throw std::system_error
+                ( error
+                , std::system_category()
+                , "rt_scope: locking process memory failed with error from "
+                  "call to mlockall."
+                );
+        }
+      if (c.stack_prefault_size!=0U)
+        {
+          prefault_stack(c.stack_prefault_size);
+        }
+    }
+
+    rt_scope::~rt_scope()
+    {
+      restore();
+    }
+
+    void rt_scope::restore()
+    {
+      ::pthread_t const self{::pthread_self()};
+      if (policy_set)
+        {
+          ::pthread_setschedparam(self, old_policy, &old_param);
+          policy_set = false;
+        }
+      if (affinity_set)
+        {
+          ::pthread_setaffinity_np(self, sizeof(old_cpus), &old_cpus);
+          affinity_set = false;
+        }
+    }
+
+    rt_period::rt_period(std::chrono::nanoseconds p)
+    : period{p}
+    , next{monotonic_now()+p}
+    {
+      if (p<=std::chrono::nanoseconds::zero())
+        {
+          throw std::invalid_argument{"rt_period::rt_period: period must be "
+                                      "greater than zero."};
+        }
+    }
+
+    bool rt_period::wait()
+    {
+      ++counts.periods;
+      std::chrono::nanoseconds now{monotonic_now()};
+      bool const met{now<next};
+      if (met)
+        {
+          std::chrono::seconds const secs
+                    {std::chrono::duration_cast<std::chrono::seconds>(next)};
+          ::timespec deadline;
+          deadline.tv_sec = static_cast<::time_t>(secs.count());
+          deadline.tv_nsec = static_cast<long>((next-secs).count());
+          while (::clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME
+                                  , &deadline, nullptr
+                                  )==EINTR)
+            {
+            }
+          now = monotonic_now();
+        }
+      else
+        {
+          ++counts.missed;
+        }
+      if (now-next>counts.max_lateness)
+        {
+          counts.max_lateness = now-next;
+        }
+      next += period;
+      if (next<=now)
+        { // Drop deadlines already passed rather than running to catch up
+          next += ((now-next)/period+1)*period;
+        }
+      return met;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
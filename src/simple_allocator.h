@@ -8,7 +8,8 @@
 #ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_SIMPLE_ALLOCATOR_H
 # define DIBASE_RPI_PERIPHERALS_INTERNAL_SIMPLE_ALLOCATOR_H
 
-# include <bitset>
+# include <atomic>
+# include <cstdint>
 
 namespace dibase { namespace rpi {
   namespace peripherals
@@ -19,15 +20,39 @@ namespace dibase { namespace rpi {
       /// Supports allocate, de-allocate and usage query operations for
       /// resources specified using resource index values
       ///
+      /// Allocation state is held in an atomic bitmap of one word per 32
+      /// resources and allocate and de-allocate atomically set and clear a
+      /// resource's bit, so an allocator may be used from several threads
+      /// without locking: at most one caller can allocate or de-allocate a
+      /// given resource.
+      ///
       /// @tparam NumRes  Number of resources supported 
         template <unsigned NumRes>
         class simple_allocator
         {
-          std::bitset<NumRes> allocated;
+          constexpr static unsigned bits_per_word = 32U;
+          constexpr static unsigned number_of_words
+                                    = (NumRes+bits_per_word-1U)/bits_per_word;
+
+          std::atomic<std::uint32_t> allocated[number_of_words];
+
+          static std::uint32_t bit(unsigned res_idx)
+          {
+            return std::uint32_t{1U}<<(res_idx%bits_per_word);
+          }
 
         public:
         /// @brief Construct with all resources available for allocation
-          simple_allocator() = default;
+          simple_allocator()
+          {
+            for (auto & word : allocated)
+              {
+                word.store(0U, std::memory_order_relaxed);
+              }
+          }
+
+          simple_allocator(simple_allocator const &) = delete;
+          simple_allocator & operator=(simple_allocator const &) = delete;
 
         /// @brief Return whether a resource is marked as in use or not
         /// @param res_idx    0 based resource index value of resource to check
@@ -36,14 +61,22 @@ namespace dibase { namespace rpi {
         ///               OR res_idx is out of range.
           bool is_in_use(unsigned res_idx)
           {
-            return (res_idx<NumRes) && allocated.test(res_idx);
+            return (res_idx<NumRes)
+                && (allocated[res_idx/bits_per_word].load()&bit(res_idx));
           }
 
         /// @brief Return whether any resource is marked as in use
         /// @returns true if any resource marked as allocated; false if none are
           bool any_in_use()
           {
-            return allocated.any();
+            for (auto const & word : allocated)
+              {
+                if (word.load()!=0U)
+                  {
+                    return true;
+                  }
+              }
+            return false;
           }
 
         /// @brief Allocate a resource marking it as in use
@@ -53,12 +86,10 @@ namespace dibase { namespace rpi {
         ///               not as already allocated or res_idx out of range.
           bool allocate(unsigned res_idx)
           {
-            if ( (res_idx<NumRes) && !allocated.test(res_idx) )
-              {
-                allocated.set(res_idx);
-                return true;
-              }
-            return false;
+            return (res_idx<NumRes)
+                && !(allocated[res_idx/bits_per_word].fetch_or(bit(res_idx))
+                    & bit(res_idx)
+                    );
           }
 
         /// @brief De-allocate a resource marking it as free for use
@@ -68,12 +99,10 @@ namespace dibase { namespace rpi {
         ///               was not as already free or res_idx out of range.
           bool deallocate(unsigned res_idx)
           {
-            if ( is_in_use(res_idx) )
-              {
-                allocated.reset(res_idx);
-                return true;
-              }
-            return false;
+            return (res_idx<NumRes)
+                && (allocated[res_idx/bits_per_word].fetch_and(~bit(res_idx))
+                    & bit(res_idx)
+                   );
           }
         };
    } // namespace internal closed
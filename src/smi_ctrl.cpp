@@ -0,0 +1,29 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file smi_ctrl.cpp
+/// @brief Internal SMI control type implantation and definition.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "smi_ctrl.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      smi_ctrl::smi_ctrl()
+      : regs( peripheral_window::instance()
+            , smi_registers::physical_address
+            , register_block_size
+            )
+      , allocated(false)
+      {}
+
+      smi_ctrl & smi_ctrl::instance()
+      {
+        static smi_ctrl smi_control_area;
+        return smi_control_area;
+      }
+    }
+  }
+}}
@@ -0,0 +1,49 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file smi_ctrl.h
+/// @brief \b Internal : SMI control type & supporting definitions.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_SMI_CTRL_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_SMI_CTRL_H
+
+# include "phymem_ptr.h"
+# include "smi_registers.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief SMI control type. There is only 1 (yes it's a singleton!)
+    ///
+    /// Maps BCM2708 / 2835 SMI registers into the requisite physical memory
+    /// mapped area and provides a simple allocated flag for in-process SMI
+    /// use tracking.
+    ///
+    /// Note that the SMI clock is allocated and controlled separately through
+    /// clock_ctrl.
+      struct smi_ctrl
+      {
+      /// @brief Pointer to BCM2708 / BCM2835 SMI control registers instance
+        phymem_ptr<volatile smi_registers>        regs;
+
+      /// @brief SMI allocation flag
+        bool  allocated;
+
+      /// @brief Singleton instance getter
+      /// @returns \e The instance of the SMI control object.
+        static smi_ctrl & instance();
+
+      private:
+        smi_ctrl();
+
+        smi_ctrl(smi_ctrl const &) = delete;
+        smi_ctrl(smi_ctrl &&) = delete;
+        smi_ctrl & operator=(smi_ctrl const &) = delete;
+        smi_ctrl & operator=(smi_ctrl &&) = delete;
+      };
+   } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_SMI_CTRL_H
@@ -0,0 +1,124 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file smi_dma.cpp
+/// @brief DMA bulk transfers for the SMI parallel bus implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "smi_dma.h"
+#include "smi_ctrl.h"
+#include "dma_ctrl.h"
+#include "dma_arena.h"
+#include "trace_marker.h"
+#include <cstddef>
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using namespace internal;
+
+    namespace
+    {
+      register_t const smi_data_bus_address
+                { peripheral_bus_address(smi_registers::physical_address)
+                + static_cast<register_t>(offsetof(smi_registers, data))
+                };
+
+    // DREQ levels: request at 2 FIFO words, panic (AXI priority) at 8
+      register_t const dreq_level{2U};
+      register_t const panic_level{8U};
+    }
+
+    smi_dma::smi_dma(smi_pins & pins, std::size_t max_block)
+    : smi(pins)
+    , cb{nullptr}
+    , buf{nullptr}
+    , buf_bus{0U}
+    , max_bytes{(max_block+3U)&~std::size_t{3U}}
+    , dma_channel{0U}
+    {
+      if (max_block==0U)
+        {
+          throw std::invalid_argument{"smi_dma::smi_dma: maximum block size "
+                                      "is zero."};
+        }
+      memory.reset(new dma_arena{max_bytes+sizeof(dma_control_block)});
+      cb = memory->allocate_control_blocks(1U);
+      dma_buffer const buffer{memory->allocate(max_bytes)};
+      buf = static_cast<std::uint32_t *>(buffer.address);
+      buf_bus = buffer.bus_address;
+      for (std::size_t n=0U; n!=max_bytes/4U; ++n)
+        {
+          buf[n] = 0U;
+        }
+      dma_channel = dma_ctrl::instance().allocate_channel();
+      smi_ctrl::instance().regs->set_dma_request_levels
+                            (dreq_level, dreq_level, panic_level, panic_level);
+    }
+
+    smi_dma::~smi_dma()
+    {
+      smi_ctrl::instance().regs->dma_control = 0U;
+      dma_ctrl::instance().deallocate_channel(dma_channel);
+    }
+
+    void smi_dma::transfer(unsigned address, std::size_t bytes, bool write)
+    {
+      internal::trace_scope trace{"smi_dma transfer"};
+      smi.check_block(address, bytes);
+      if (bytes>max_bytes)
+        {
+          throw std::invalid_argument{"smi_dma: block larger than maximum "
+                                      "block size."};
+        }
+      cb->transfer_info = dma_control_block::ti_no_wide_bursts
+                        | dma_control_block::ti_wait_resp
+                        | dma_control_block::ti_permap(dma_dreq::smi)
+                        | ( write ? ( dma_control_block::ti_src_inc
+                                    | dma_control_block::ti_dest_dreq
+                                    )
+                                  : ( dma_control_block::ti_dest_inc
+                                    | dma_control_block::ti_src_dreq
+                                    )
+                          );
+      cb->source_address = write ? buf_bus : smi_data_bus_address;
+      cb->dest_address = write ? smi_data_bus_address : buf_bus;
+      cb->transfer_length = static_cast<register_t>(bytes);
+      cb->stride = 0U;
+      cb->next_control_block = 0U;
+      cb->reserved_do_not_use[0] = 0U;
+      cb->reserved_do_not_use[1] = 0U;
+      volatile dma_channel_registers &
+                          dma(dma_ctrl::instance().regs->channel[dma_channel]);
+      dma.reset();
+      dma.start(memory->bus_address(cb));
+      smi.start_block(address, bytes, write);
+      adaptive_wait waiter(smi.waiting, smi.wait_counts);
+      while (dma.is_active() && !dma.has_error())
+        {
+          smi.counters.count(io_event::wait_polls);
+          waiter.pause();
+        }
+      if (dma.has_error())
+        {
+          dma.reset();
+          throw std::runtime_error{"smi_dma: DMA transfer failed."};
+        }
+      smi.wait_done();
+      smi.counters.count( write ? io_event::bytes_written : io_event::bytes_read
+                        , bytes
+                        );
+    }
+
+    void smi_dma::write(unsigned address, std::size_t bytes)
+    {
+      transfer(address, bytes, true);
+    }
+
+    void smi_dma::read(unsigned address, std::size_t bytes)
+    {
+      transfer(address, bytes, false);
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,341 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file smi_pins.cpp
+/// @brief Use a set of GPIO pins for use with SMI: implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "smi_pins.h"
+#include "gpio_alt_fn.h"
+#include "gpio_ctrl.h"
+#include "smi_ctrl.h"
+#include "clock_ctrl.h"
+#include "clock_parameters.h"
+#include "periexcept.h"
+#include "trace_marker.h"
+#include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using internal::smi_ctrl;
+    using internal::smi_registers;
+    using internal::clock_ctrl;
+    using internal::gpio_ctrl;
+    using internal::pin_alt_fn::gpio_special_fn;
+    using internal::gpio_pin_fn;
+
+    namespace
+    {
+    // SMI clock source: PLLD, integer division only so cycles do not jitter
+      hertz const smi_clock_source_frequency{megahertz{500U}};
+
+      constexpr unsigned max_address_lines{6U};
+      constexpr unsigned max_address{smi_registers::a_address_mask};
+      constexpr pin_id_int_t soe_pin{6U};
+      constexpr pin_id_int_t swe_pin{7U};
+      constexpr pin_id_int_t sa0_pin{5U};   // SAn is on GPIO5-n
+      constexpr pin_id_int_t sd0_pin{8U};   // SDn is on GPIO8+n
+
+    // All SMI device transfers use device settings 0
+      constexpr register_t smi_device{0U};
+
+      gpio_pin_fn get_alt_fn(pin_id pin, gpio_special_fn special_fn)
+      {
+        using internal::pin_alt_fn::result_set;
+        using internal::pin_alt_fn::select;
+        auto pin_fn_info( select(pin,special_fn) );
+        if (pin_fn_info.size()!=1)
+          {
+            throw std::range_error // SMI pins have exactly 1 SMI function
+                  {"smi_pins::smi_pins: Internal data error: pin does not "
+                   "have exactly one alt function supporting the requested "
+                   "SMI special function."
+                  };
+          }
+        return pin_fn_info[0].alt_fn();
+      }
+
+      gpio_special_fn offset_fn(gpio_special_fn first, unsigned n)
+      {
+        return static_cast<gpio_special_fn>(static_cast<unsigned>(first)+n);
+      }
+
+      register_t timing_setting
+      ( smi_timing const & t
+      , smi_width width
+      )
+      {
+        register_t const setting
+          {smi_registers::device_setting( t.setup, t.strobe, t.hold, t.pace
+                                        , width==smi_width::bits8 ? 0U : 1U
+                                        )};
+        if (setting==0U)
+          {
+            throw std::invalid_argument{"smi_pins::smi_pins: timing value "
+                                        "out of range."};
+          }
+        return setting;
+      }
+    }
+
+    smi_pins::smi_pins
+    ( smi_width width
+    , unsigned address_lines
+    , smi_timing const & read_timing
+    , smi_timing const & write_timing
+    , hertz smi_clock
+    )
+    : pin_count{0U}
+    , bus_width{width}
+    , address_count{address_lines}
+    {
+      if (address_lines>max_address_lines)
+        {
+          throw std::invalid_argument{"smi_pins::smi_pins: more than 6 "
+                                      "address lines requested."};
+        }
+      register_t const read_setting{timing_setting(read_timing, width)};
+      register_t const write_setting{timing_setting(write_timing, width)};
+      unsigned const data_lines{width==smi_width::bits8 ? 8U : 16U};
+
+    // Get each pin's alt function for its SMI special function.
+    // Note: any of these can throw - but nothing allocated yet so OK
+      std::vector<internal::gpio_pin_fn_setting> pin_fns;
+      pin_fns.reserve(max_pins);
+      pin_id const soe(soe_pin);
+      pin_id const swe(swe_pin);
+      pin_fns.push_back({soe, get_alt_fn(soe, gpio_special_fn::soe_n_se)});
+      pin_fns.push_back({swe, get_alt_fn(swe, gpio_special_fn::swe_n_srw_n)});
+      for (unsigned n=0U; n!=address_lines; ++n)
+        {
+          pin_id const pin(sa0_pin-n);
+          pin_fns.push_back
+            ({pin, get_alt_fn(pin, offset_fn(gpio_special_fn::sa0, n))});
+        }
+      for (unsigned n=0U; n!=data_lines; ++n)
+        {
+          pin_id const pin(sd0_pin+n);
+          pin_fns.push_back
+            ({pin, get_alt_fn(pin, offset_fn(gpio_special_fn::sd0, n))});
+        }
+
+    // Calculate clock divisors before allocating - can throw
+      internal::clock_parameters const cp
+        { clock_source::plld
+        , smi_clock_source_frequency
+        , clock_frequency{smi_clock}
+        };
+
+    // Only one SMI peripheral so can check whether it is in use before
+    // starting on pin allocations
+      if ( smi_ctrl::instance().allocated )
+        {
+          throw bad_peripheral_alloc( "smi_pins::smi_pins: SMI is "
+                                      "already being used locally."
+                                    );
+        }
+
+    // Speculatively allocate SMI peripheral
+      smi_ctrl::instance().allocated = true;
+      try
+      {
+        for (; pin_count!=pin_fns.size(); ++pin_count)
+          {
+            gpio_ctrl::instance().alloc.allocate(pin_fns[pin_count].pin);
+            pins[pin_count] = pin_fns[pin_count].pin;
+          }
+        clock_ctrl::allocate_and_initialise_clock(internal::smiclk, cp);
+      }
+      catch (...)
+      { // Oops - failed to complete resource acquisition and initialisation;
+      // Release resources allocated so far and re-throw
+        for (unsigned n=0U; n!=pin_count; ++n)
+          {
+            gpio_ctrl::instance().alloc.deallocate(pin_id(pins[n]));
+          }
+        smi_ctrl::instance().allocated = false;
+        throw;
+      }
+      clock_ctrl::instance().regs->set_enable(internal::smi_clk_id, true);
+
+      auto & regs(smi_ctrl::instance().regs);
+      regs->control_and_status = 0U;
+      regs->dma_control = 0U;
+      regs->device[smi_device].read = read_setting;
+      regs->device[smi_device].write = write_setting;
+      regs->control_and_status = smi_registers::cs_enable
+                               | smi_registers::cs_pixel_data
+                               | smi_registers::cs_clear;
+      regs->direct_control = smi_registers::dcs_enable
+                           | smi_registers::dcs_done;
+      gpio_ctrl::instance().config.set_pin_functions
+                                              (pin_fns.begin(), pin_fns.end());
+    }
+
+    smi_pins::~smi_pins()
+    {
+      auto & regs(smi_ctrl::instance().regs);
+      regs->control_and_status = 0U;
+      regs->direct_control = 0U;
+      regs->dma_control = 0U;
+      clock_ctrl & clk_ctrl(clock_ctrl::instance());
+      clk_ctrl.regs->set_enable(internal::smi_clk_id, false);
+      clk_ctrl.alloc.deallocate(internal::smiclk);
+      for (unsigned n=0U; n!=pin_count; ++n)
+        {
+          gpio_ctrl::instance().alloc.deallocate(pin_id(pins[n]));
+        }
+      smi_ctrl::instance().allocated = false;
+    }
+
+    void smi_pins::write_direct(unsigned address, std::uint32_t value)
+    {
+      if (address>max_address)
+        {
+          throw std::invalid_argument{"smi_pins::write_direct: address out "
+                                      "of range."};
+        }
+      auto & regs(smi_ctrl::instance().regs);
+      regs->direct_control = smi_registers::dcs_enable
+                           | smi_registers::dcs_done;
+      regs->direct_address = smi_registers::device_address(smi_device,address);
+      regs->direct_data = value;
+      regs->direct_control = smi_registers::dcs_enable
+                           | smi_registers::dcs_write
+                           | smi_registers::dcs_start;
+      while (!(regs->direct_control&smi_registers::dcs_done))
+        {
+        }
+      counters.count(io_event::bytes_written
+                    , bus_width==smi_width::bits8 ? 1U : 2U
+                    );
+    }
+
+    std::uint32_t smi_pins::read_direct(unsigned address)
+    {
+      if (address>max_address)
+        {
+          throw std::invalid_argument{"smi_pins::read_direct: address out "
+                                      "of range."};
+        }
+      auto & regs(smi_ctrl::instance().regs);
+      regs->direct_control = smi_registers::dcs_enable
+                           | smi_registers::dcs_done;
+      regs->direct_address = smi_registers::device_address(smi_device,address);
+      regs->direct_control = smi_registers::dcs_enable
+                           | smi_registers::dcs_start;
+      while (!(regs->direct_control&smi_registers::dcs_done))
+        {
+        }
+      counters.count(io_event::bytes_read
+                    , bus_width==smi_width::bits8 ? 1U : 2U
+                    );
+      return regs->direct_data;
+    }
+
+    void smi_pins::check_block(unsigned address, std::size_t bytes) const
+    {
+      if (address>max_address || bytes==0U || bytes%4U!=0U)
+        {
+          throw std::invalid_argument{"smi_pins: block address out of range "
+                                      "or size not a non-zero multiple of 4."};
+        }
+    }
+
+    void smi_pins::start_block
+    ( unsigned address
+    , std::size_t bytes
+    , bool write
+    )
+    {
+      auto & regs(smi_ctrl::instance().regs);
+    // Disable while the transfer is set up, as the Linux driver does
+      regs->control_and_status = smi_registers::cs_pixel_data;
+      while (regs->get_flag(smi_registers::cs_enable))
+        {
+        }
+      regs->length = static_cast<register_t>
+                          (bus_width==smi_width::bits8 ? bytes : bytes/2U);
+      regs->address = smi_registers::device_address(smi_device, address);
+      register_t const cs{ smi_registers::cs_enable
+                         | smi_registers::cs_pixel_data
+                         | (write ? register_t(smi_registers::cs_write) : 0U)
+                         };
+      regs->control_and_status = cs|smi_registers::cs_clear;
+      regs->control_and_status = cs | smi_registers::cs_done
+                                    | smi_registers::cs_start;
+    }
+
+    void smi_pins::wait_done()
+    {
+      auto & regs(smi_ctrl::instance().regs);
+      adaptive_wait waiter(waiting, wait_counts);
+      while (!regs->get_flag(smi_registers::cs_done))
+        {
+          counters.count(io_event::wait_polls);
+          waiter.pause();
+        }
+    }
+
+    void smi_pins::write
+    ( unsigned address
+    , std::uint32_t const * pdata
+    , std::size_t bytes
+    )
+    {
+      internal::trace_scope trace{"smi_pins write"};
+      check_block(address, bytes);
+      start_block(address, bytes, true);
+      auto & regs(smi_ctrl::instance().regs);
+      std::size_t const words{bytes/4U};
+      adaptive_wait waiter(waiting, wait_counts);
+      for (std::size_t n=0U; n!=words;)
+        {
+          if (regs->get_flag(smi_registers::cs_tx_can_accept))
+            {
+              regs->data = pdata[n];
+              ++n;
+              waiter.restart();
+            }
+          else
+            {
+              counters.count(io_event::wait_polls);
+              waiter.pause();
+            }
+        }
+      wait_done();
+      counters.count(io_event::bytes_written, bytes);
+    }
+
+    void smi_pins::read
+    ( unsigned address
+    , std::uint32_t * pdata
+    , std::size_t bytes
+    )
+    {
+      internal::trace_scope trace{"smi_pins read"};
+      check_block(address, bytes);
+      start_block(address, bytes, false);
+      auto & regs(smi_ctrl::instance().regs);
+      std::size_t const words{bytes/4U};
+      adaptive_wait waiter(waiting, wait_counts);
+      for (std::size_t n=0U; n!=words;)
+        {
+          if (regs->get_flag(smi_registers::cs_rx_has_data))
+            {
+              pdata[n] = regs->data;
+              ++n;
+              waiter.restart();
+            }
+          else
+            {
+              counters.count(io_event::wait_polls);
+              waiter.pause();
+            }
+        }
+      wait_done();
+      counters.count(io_event::bytes_read, bytes);
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
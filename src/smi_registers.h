@@ -0,0 +1,164 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file smi_registers.h
+/// @brief \b Internal : low-level SMI (secondary memory interface) control
+/// registers type definition.
+///
+/// The SMI peripheral is not described in the
+/// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+/// Broadcom BCM2835 ARM Peripherals Datasheet</a> other than by its GPIO
+/// alternative functions. The register layout used here is that of the
+/// Linux bcm2835_smi driver's broadcom/bcm2835_smi.h header.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_SMI_REGISTERS_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_SMI_REGISTERS_H
+
+# include "peridef.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Read or write timing and width settings of one SMI device
+    ///
+    /// The SMIDSRn and SMIDSWn registers share a layout: setup, hold, pace
+    /// and strobe times in SMI clock cycles, and the bus width.
+      struct smi_device_settings
+      {
+        register_t  read;   ///< Read settings, SMIDSRn
+        register_t  write;  ///< Write settings, SMIDSWn
+      };
+
+    /// @brief Represents layout of SMI control registers with operations.
+    ///
+    /// Permits access to BCM2835 SMI registers when an instance is mapped to
+    /// the correct physical memory location.
+    ///
+    /// Transfers are either programmed, of a count of transfers through the
+    /// FIFO - which may be fed or drained by DMA - or direct, of a single
+    /// transfer through the direct data register. Both use the timings of one
+    /// of four device settings register pairs.
+      struct smi_registers
+      {
+        enum : register_t
+        { cs_enable           = 1U<<0   ///< SMICS enable ENABLE bit
+        , cs_done             = 1U<<1   ///< SMICS transfer done DONE bit
+        , cs_active           = 1U<<2   ///< SMICS transfer active ACTIVE bit
+        , cs_start            = 1U<<3   ///< SMICS start transfer START bit
+        , cs_clear            = 1U<<4   ///< SMICS clear FIFO CLEAR bit
+        , cs_write            = 1U<<5   ///< SMICS write transfer WRITE bit
+        , cs_pixel_data       = 1U<<14  ///< SMICS pack FIFO words PXLDAT bit
+        , cs_tx_can_accept    = 1U<<28  ///< SMICS FIFO has space TXD bit
+        , cs_rx_has_data      = 1U<<29  ///< SMICS FIFO has data RXD bit
+        , cs_tx_empty         = 1U<<30  ///< SMICS FIFO empty TXE bit
+        , cs_rx_full          = 1U<<31  ///< SMICS FIFO full RXF bit
+        , a_device_bit        = 8U      ///< SMIA / SMIDA DEVICE field bit
+        , a_address_mask      = 0x3fU   ///< SMIA / SMIDA ADDR field bit-mask
+        , ds_strobe_bit       = 0U      ///< SMIDSx STROBE field bit number
+        , ds_pace_bit         = 8U      ///< SMIDSx PACE field bit number
+        , ds_hold_bit         = 16U     ///< SMIDSx HOLD field bit number
+        , ds_setup_bit        = 24U     ///< SMIDSx SETUP field bit number
+        , ds_width_bit        = 30U     ///< SMIDSx WIDTH field bit number
+        , ds_strobe_max       = 0x7fU   ///< SMIDSx STROBE field maximum
+        , ds_pace_max         = 0x7fU   ///< SMIDSx PACE field maximum
+        , ds_hold_max         = 0x3fU   ///< SMIDSx HOLD field maximum
+        , ds_setup_max        = 0x3fU   ///< SMIDSx SETUP field maximum
+        , dc_req_write_bit    = 0U      ///< SMIDC REQW field bit number
+        , dc_req_read_bit     = 6U      ///< SMIDC REQR field bit number
+        , dc_panic_write_bit  = 12U     ///< SMIDC PANICW field bit number
+        , dc_panic_read_bit   = 18U     ///< SMIDC PANICR field bit number
+        , dc_level_mask       = 0x3fU   ///< SMIDC field value bit-mask
+        , dc_dma_enable       = 1U<<28  ///< SMIDC DMA DREQ enable DMAEN bit
+        , dcs_enable          = 1U<<0   ///< SMIDCS enable ENABLE bit
+        , dcs_start           = 1U<<1   ///< SMIDCS start transfer START bit
+        , dcs_done            = 1U<<2   ///< SMIDCS transfer done DONE bit
+        , dcs_write           = 1U<<3   ///< SMIDCS write transfer WRITE bit
+        , number_of_devices   = 4U      ///< Device settings register pairs
+        };
+
+      /// @brief Physical address of start of BCM2835 SMI control registers
+        constexpr static physical_address_t
+                            physical_address = peripheral_base_address+0x600000;
+
+        register_t  control_and_status; ///< Control and status, SMICS
+        register_t  length;             ///< Programmed transfer count, SMIL
+        register_t  address;            ///< Programmed address, SMIA
+        register_t  data;               ///< FIFO data, SMID
+        smi_device_settings device[number_of_devices]; ///< SMIDSR/W0-3
+        register_t  dma_control;        ///< DMA control, SMIDC
+        register_t  direct_control;     ///< Direct control and status, SMIDCS
+        register_t  direct_address;     ///< Direct address, SMIDA
+        register_t  direct_data;        ///< Direct data, SMIDD
+        register_t  fifo_debug;         ///< FIFO debug, SMIFD
+
+      /// @brief Return a SMICS flag value
+      /// @param[in] flag SMICS bit to test (cs_done, cs_rx_has_data...)
+      /// @returns \c true if the bit is set.
+        bool get_flag(register_t flag) volatile const
+        {
+          return control_and_status & flag;
+        }
+
+      /// @brief Return a device settings register value
+      /// @param[in] setup  Cycles from address valid to strobe [1,63].
+      /// @param[in] strobe Cycles the strobe is asserted for [1,127].
+      /// @param[in] hold   Cycles from strobe end to address change [0,63].
+      /// @param[in] pace   Cycles between transfers [0,127].
+      /// @param[in] width  Bus width field value: 0 8 bits, 1 16 bits, 2 18
+      ///                   bits, 3 9 bits.
+      /// @returns Register value, or 0 if a value is out of range.
+        constexpr static register_t device_setting
+        ( register_t setup
+        , register_t strobe
+        , register_t hold
+        , register_t pace
+        , register_t width
+        )
+        {
+          return ( setup==0U || setup>ds_setup_max || strobe==0U
+                || strobe>ds_strobe_max || hold>ds_hold_max
+                || pace>ds_pace_max || width>3U
+                 )
+                  ? 0U
+                  : (setup<<ds_setup_bit) | (strobe<<ds_strobe_bit)
+                    | (hold<<ds_hold_bit) | (pace<<ds_pace_bit)
+                    | (width<<ds_width_bit);
+        }
+
+      /// @brief Return a SMIA / SMIDA address register value
+      /// @param[in] dev    Device settings number [0,3].
+      /// @param[in] addr   Address bus value [0,63].
+        constexpr static register_t device_address
+        ( register_t dev
+        , register_t addr
+        )
+        {
+          return ((dev&(number_of_devices-1U))<<a_device_bit)
+                | (addr&a_address_mask);
+        }
+
+      /// @brief Set the SMIDC DMA request and panic levels, enabling DREQs
+      /// @param[in] write        FIFO words below which a write DREQ [0,63].
+      /// @param[in] read         FIFO words above which a read DREQ [0,63].
+      /// @param[in] write_panic  FIFO words below which a write panic [0,63].
+      /// @param[in] read_panic   FIFO words above which a read panic [0,63].
+        void set_dma_request_levels
+        ( register_t write
+        , register_t read
+        , register_t write_panic
+        , register_t read_panic
+        ) volatile
+        {
+          dma_control = dc_dma_enable
+                      | ((write&dc_level_mask)<<dc_req_write_bit)
+                      | ((read&dc_level_mask)<<dc_req_read_bit)
+                      | ((write_panic&dc_level_mask)<<dc_panic_write_bit)
+                      | ((read_panic&dc_level_mask)<<dc_panic_read_bit);
+        }
+      };
+   } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_SMI_REGISTERS_H
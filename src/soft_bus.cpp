@@ -0,0 +1,81 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file soft_bus.cpp
+/// @brief Bit-banged bus support function implementations.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "soft_bus.h"
+#include "gpio_ctrl.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      void set_pin_output
+      ( std::uint32_t volatile * fsel_word
+      , unsigned shift
+      , bool output
+      )
+      {
+        std::size_t const idx
+                    (fsel_word-gpio_register_words()-gpfsel0_word_offset);
+        gpio_ctrl::instance().config.update_fsel
+                                  (idx, 7U<<shift, output ? 1U<<shift : 0U);
+      }
+    } // namespace internal closed
+
+    std::uint8_t one_wire_crc8(std::uint8_t const * p, std::size_t count)
+    {
+    // Polynomial x^8 + x^5 + x^4 + 1, processed least significant bit first
+      std::uint8_t crc{0U};
+      for (std::size_t idx=0U; idx!=count; ++idx)
+        {
+          std::uint8_t b{p[idx]};
+          for (unsigned bit=0U; bit!=8U; ++bit, b>>=1)
+            {
+              bool const mix{((crc^b)&1U)!=0U};
+              crc = static_cast<std::uint8_t>(crc>>1);
+              if (mix)
+                {
+                  crc ^= 0x8CU;
+                }
+            }
+        }
+      return crc;
+    }
+
+    std::vector<waveform_step> soft_spi_waveform_steps
+    ( std::uint8_t const * ptx
+    , std::size_t count
+    , std::uint32_t half_period
+    )
+    {
+      if (half_period==0U)
+        {
+          throw std::invalid_argument{"soft_spi_waveform_steps: half period "
+                                      "must be at least 1 microsecond."};
+        }
+      pin_group_value_t const sclk{1U};
+      pin_group_value_t const mosi{2U};
+      std::vector<waveform_step> steps;
+      steps.reserve(count*8U*2U+1U);
+      for (std::size_t idx=0U; idx!=count; ++idx)
+        {
+          std::uint8_t b{ptx[idx]};
+          for (unsigned bit=0U; bit!=8U; ++bit, b<<=1)
+            {
+              bool const high{(b&0x80U)!=0U};
+              steps.push_back(waveform_step{ high ? mosi : 0U
+                                           , high ? sclk : sclk|mosi
+                                           , half_period
+                                           });
+              steps.push_back(waveform_step{sclk, 0U, half_period});
+            }
+        }
+      steps.push_back(waveform_step{0U, sclk|mosi, 0U});
+      return steps;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
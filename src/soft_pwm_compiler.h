@@ -0,0 +1,61 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file soft_pwm_compiler.h
+/// @brief \b Internal : compile a cyclic software PWM program into DMA
+/// control blocks : type and function declarations.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_SOFT_PWM_COMPILER_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_SOFT_PWM_COMPILER_H
+
+# include "dma_arena.h"
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Locations within a compiled software PWM program.
+    ///
+    /// The program divides each PWM cycle into slots. At the start of slot 0
+    /// the pins in the set masks are set high, then at the start of every
+    /// slot n the pins in slot n's clear masks are set low. Updating the
+    /// masks changes the next cycles' output without touching the control
+    /// blocks.
+      struct soft_pwm_program
+      {
+        register_t            first_bus;    ///< Bus address of first CB
+        register_t volatile * set_masks;    ///< GPSET0, GPSET1 values
+        register_t volatile * clear_masks;  ///< GPCLR0, GPCLR1 values for
+                                            ///< each slot: 2 words per slot
+      };
+
+    /// @brief Returns region bytes needed to compile a software PWM program.
+    /// @param slots  Number of slots per PWM cycle.
+      std::size_t soft_pwm_program_size(std::size_t slots);
+
+    /// @brief Compile a looping software PWM program with all masks zero.
+    ///
+    /// Slot 0 has control blocks writing the set masks to GPSET0/1 and its
+    /// clear masks to GPCLR0/1, every other slot a control block writing its
+    /// clear masks to GPCLR0/1. Each slot ends with a delay control block
+    /// writing to the PWM FIFO paced by the PWM DREQ. The last delay links
+    /// back to the first control block.
+    ///
+    /// @param region     Region to allocate program memory from.
+    /// @param slots      Number of slots per PWM cycle.
+    /// @param slot_ticks PWM FIFO words, pacing ticks, per slot.
+    /// @returns Locations within the compiled program.
+    /// @throws std::invalid_argument if slots or slot_ticks is zero or
+    ///         slot_ticks is too large for one control block transfer.
+    /// @throws std::bad_alloc if region does not have enough space.
+      soft_pwm_program compile_soft_pwm
+      ( dma_region & region
+      , std::size_t slots
+      , std::uint32_t slot_ticks
+      );
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_SOFT_PWM_COMPILER_H
@@ -0,0 +1,280 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file soft_pwm_engine.cpp
+/// @brief DMA timed software PWM implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "soft_pwm_engine.h"
+#include "soft_pwm_compiler.h"
+#include "dma_arena.h"
+#include "dma_ctrl.h"
+#include "gpio_registers.h"
+#include "pwm_ctrl.h"
+#include "clock_parameters.h"
+#include "periexcept.h"
+#include <cstddef>
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      namespace
+      {
+        register_t const gpset0_bus_address
+                  { peripheral_bus_address(gpio_registers::physical_address)
+                  + static_cast<register_t>(offsetof(gpio_registers, gpset))
+                  };
+        register_t const gpclr0_bus_address
+                  { peripheral_bus_address(gpio_registers::physical_address)
+                  + static_cast<register_t>(offsetof(gpio_registers, gpclr))
+                  };
+        register_t const pwm_fifo_bus_address
+                  { peripheral_bus_address(pwm_registers::physical_address)
+                  + static_cast<register_t>(offsetof(pwm_registers, fifo_in))
+                  };
+
+      // Delay control block lengths are limited to the 30 bit TXFR_LEN field
+        std::uint32_t const max_slot_ticks{0x3FFFFFFFU/sizeof(register_t)};
+
+      // Control blocks: slot 0 set, then each slot's clear and delay
+        std::size_t count_control_blocks(std::size_t slots)
+        {
+          return 2U*slots+1U;
+        }
+
+      // Data words: set masks, clear masks per slot and the PWM FIFO word
+        std::size_t data_words(std::size_t slots)
+        {
+          return 2U+2U*slots+1U;
+        }
+      }
+
+      std::size_t soft_pwm_program_size(std::size_t slots)
+      {
+        return count_control_blocks(slots)*sizeof(dma_control_block)
+             + data_words(slots)*sizeof(register_t);
+      }
+
+      soft_pwm_program compile_soft_pwm
+      ( dma_region & region
+      , std::size_t slots
+      , std::uint32_t slot_ticks
+      )
+      {
+        if (slots==0U || slot_ticks==0U || slot_ticks>max_slot_ticks)
+          {
+            throw std::invalid_argument{"compile_soft_pwm: slots or slot_ticks "
+                                        "is zero or slot_ticks is too large."};
+          }
+        std::size_t const cb_count{count_control_blocks(slots)};
+        dma_control_block * cbs{region.allocate_control_blocks(cb_count)};
+        register_t * data{static_cast<register_t *>
+                            (region.allocate( data_words(slots)
+                                             *sizeof(register_t)
+                                            ).address
+                            )};
+        for (std::size_t idx=0; idx!=data_words(slots); ++idx)
+          {
+            data[idx] = 0U;
+          }
+        register_t * const set_masks{data};
+        register_t * const clear_masks{data+2U};
+        register_t * const fifo_word{data+2U+2U*slots};
+        register_t const write_ti{ dma_control_block::ti_no_wide_bursts
+                                 | dma_control_block::ti_wait_resp
+                                 | dma_control_block::ti_src_inc
+                                 | dma_control_block::ti_dest_inc
+                                 };
+        register_t const delay_ti{ dma_control_block::ti_no_wide_bursts
+                                 | dma_control_block::ti_wait_resp
+                                 | dma_control_block::ti_dest_dreq
+                                 | dma_control_block::ti_permap(dma_dreq::pwm)
+                                 };
+        std::size_t cb_idx{0U};
+        auto add_cb = [&]( register_t ti, register_t src, register_t dest
+                         , register_t length
+                         )
+                      {
+                        dma_control_block & cb(cbs[cb_idx]);
+                        cb.transfer_info = ti;
+                        cb.source_address = src;
+                        cb.dest_address = dest;
+                        cb.transfer_length = length;
+                        cb.stride = 0U;
+                        ++cb_idx;
+                        cb.next_control_block
+                            = region.bus_address(cbs+(cb_idx%cb_count));
+                        cb.reserved_do_not_use[0] = 0U;
+                        cb.reserved_do_not_use[1] = 0U;
+                      };
+        add_cb( write_ti, region.bus_address(set_masks), gpset0_bus_address
+              , 2U*sizeof(register_t)
+              );
+        for (std::size_t slot=0; slot!=slots; ++slot)
+          {
+            add_cb( write_ti, region.bus_address(clear_masks+2U*slot)
+                  , gpclr0_bus_address, 2U*sizeof(register_t)
+                  );
+            add_cb( delay_ti, region.bus_address(fifo_word)
+                  , pwm_fifo_bus_address
+                  , static_cast<register_t>(slot_ticks*sizeof(register_t))
+                  );
+          }
+        return soft_pwm_program{ region.bus_address(cbs)
+                               , set_masks
+                               , clear_masks
+                               };
+      }
+
+      namespace
+      {
+      // PWM clock and range giving one PWM FIFO word consumed per microsecond
+        hertz const pwm_clock_source_frequency{megahertz{500U}};
+        hertz const pwm_clock_frequency{megahertz{10U}};
+        register_t const pwm_words_per_tick_range{10U};
+      }
+    } // namespace internal closed
+
+    using namespace internal;
+
+    soft_pwm_engine::soft_pwm_engine
+    ( opin_group const & pins
+    , std::size_t slots
+    , std::uint32_t slot_us
+    )
+    : group(pins)
+    , duties(pins.size(), 0U)
+    , slot_count{slots}
+    {
+      std::size_t const code_size{soft_pwm_program_size(slots)};
+      code.reset(new dma_arena{code_size});
+      dma_buffer const code_buffer
+                          {code->allocate(code_size, alignof(dma_control_block))};
+      dma_region region{ code_buffer.address, code_buffer.bus_address
+                       , code_buffer.size
+                       };
+      soft_pwm_program const program{compile_soft_pwm(region, slots, slot_us)};
+      code_bus = program.first_bus;
+      set_masks = program.set_masks;
+      clear_masks = program.clear_masks;
+    // All pins start with duty 0: never set, cleared in slot 0
+      std::uint32_t all_banks[2];
+      group.to_bank_masks(group.all_pins(), all_banks);
+      clear_masks[0] = all_banks[0];
+      clear_masks[1] = all_banks[1];
+      pwm_ctrl & pwm(pwm_ctrl::instance());
+      pwm.set_clock(clock_parameters{ clock_source::plld
+                                    , pwm_clock_source_frequency
+                                    , clock_frequency{pwm_clock_frequency}
+                                    });
+      if (!pwm.alloc.allocate(0U))
+        {
+          throw bad_peripheral_alloc{"soft_pwm_engine: PWM channel 1 is in "
+                                     "use."};
+        }
+      if (!pwm.fifo_alloc.allocate(0U))
+        {
+          pwm.alloc.deallocate(0U);
+          throw bad_peripheral_alloc{"soft_pwm_engine: PWM FIFO is in use."};
+        }
+      try
+        {
+          dma_channel = dma_ctrl::instance().allocate_channel();
+        }
+      catch (...)
+        {
+          pwm.fifo_alloc.deallocate(0U);
+          pwm.alloc.deallocate(0U);
+          throw;
+        }
+      pwm_channel const ch{pwm_channel::pwm_ch1};
+      pwm.regs->set_enable(ch, false);
+      pwm.regs->set_dma_enable(false);
+      pwm.regs->set_mode(ch, pwm_mode::serialiser);
+      pwm.regs->set_use_fifo(ch, true);
+      pwm.regs->set_range(ch, pwm_words_per_tick_range);
+      pwm.regs->clear_fifo();
+      pwm.regs->set_dma_data_req_threshold(15U);
+      pwm.regs->set_dma_panic_threshold(15U);
+      pwm.regs->set_dma_enable(true);
+      pwm.regs->set_enable(ch, true);
+    }
+
+    soft_pwm_engine::~soft_pwm_engine()
+    {
+      dma_ctrl::instance().regs->channel[dma_channel].reset();
+      dma_ctrl::instance().deallocate_channel(dma_channel);
+      pwm_ctrl & pwm(pwm_ctrl::instance());
+      pwm.regs->set_enable(pwm_channel::pwm_ch1, false);
+      pwm.regs->set_dma_enable(false);
+      pwm.fifo_alloc.deallocate(0U);
+      pwm.alloc.deallocate(0U);
+    }
+
+    void soft_pwm_engine::start()
+    {
+      volatile dma_channel_registers &
+                              ch(dma_ctrl::instance().regs->channel[dma_channel]);
+      ch.reset();
+      pwm_ctrl::instance().regs->clear_fifo();
+      ch.start(code_bus);
+    }
+
+    void soft_pwm_engine::stop()
+    {
+      dma_ctrl::instance().regs->channel[dma_channel].reset();
+    }
+
+    bool soft_pwm_engine::is_running() const
+    {
+      return dma_ctrl::instance().regs->channel[dma_channel].is_active();
+    }
+
+    void soft_pwm_engine::set_duty(std::size_t idx, std::size_t duty)
+    {
+      if (idx>=duties.size())
+        {
+          throw std::out_of_range{"soft_pwm_engine::set_duty: idx is not a "
+                                  "group pin position."};
+        }
+      if (duty>slot_count)
+        {
+          throw std::out_of_range{"soft_pwm_engine::set_duty: duty is greater "
+                                  "than the number of slots."};
+        }
+      std::size_t const old_duty{duties[idx]};
+      if (duty==old_duty)
+        {
+          return;
+        }
+      std::uint32_t banks[2];
+      group.to_bank_masks(pin_group_value_t(1)<<idx, banks);
+      std::size_t const bank{banks[0]!=0U ? 0U : 1U};
+      std::uint32_t const mask{banks[bank]};
+    // Add the new clear point before removing the old so that for one cycle
+    // at most the pin is cleared at the earlier of the two.
+      if (duty==0U)
+        {
+          set_masks[bank] &= ~mask;
+          clear_masks[bank] |= mask;
+        }
+      else if (duty!=slot_count)
+        {
+          clear_masks[2U*duty+bank] |= mask;
+        }
+      if (old_duty==0U)
+        {
+          clear_masks[bank] &= ~mask;
+          set_masks[bank] |= mask;
+        }
+      else if (old_duty!=slot_count)
+        {
+          clear_masks[2U*old_duty+bank] &= ~mask;
+        }
+      duties[idx] = duty;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -6,16 +6,55 @@
 /// @author Ralph E. McArdell
 
 #include "spi0_ctrl.h"
+#include "peripheral_range.h"
 
 namespace dibase { namespace rpi {
   namespace peripherals
   { namespace internal
     {
       spi0_ctrl::spi0_ctrl()
-      : regs(spi0_registers::physical_address, register_block_size)
+      : regs( peripheral_window::instance()
+            , spi0_registers::physical_address
+            , register_block_size
+            )
       , allocated(false)
+      , bcm2711_allocated{false, false, false, false}
       {}
 
+      bool spi0_ctrl::has_controller(unsigned spi)
+      {
+        return spi==0U
+            || ( spi>=first_bcm2711_spi
+              && spi<first_bcm2711_spi+number_of_bcm2711_spis
+              && has_bcm2711_peripherals()
+               );
+      }
+
+      spi0_ctrl::reg_ptr & spi0_ctrl::regs_of(unsigned spi)
+      {
+        if (spi==0U)
+          {
+            return regs;
+          }
+        reg_ptr & block(bcm2711_register_blocks[spi-first_bcm2711_spi]);
+        if (block.get()==nullptr)
+          {
+            block = reg_ptr( peripheral_window::instance()
+                           , spi0_registers::spi3_physical_address
+                             + (spi-first_bcm2711_spi)
+                               *spi0_registers::bcm2711_spi_block_stride
+                           , register_block_size
+                           );
+          }
+        return block;
+      }
+
+      bool & spi0_ctrl::allocated_of(unsigned spi)
+      {
+        return spi==0U ? allocated
+                       : bcm2711_allocated[spi-first_bcm2711_spi];
+      }
+
       spi0_ctrl & spi0_ctrl::instance()
       {
         static spi0_ctrl spi0_control_area;
@@ -23,19 +23,50 @@ namespace dibase { namespace rpi {
     ///
     /// Note that not only is there only one control area, the area controls
     /// only one SPI channel.
+    ///
+    /// The BCM2711 has four more controllers of the same design, SPI3 to
+    /// SPI6. Their registers are mapped, on first access, and allocation
+    /// flags kept alongside SPI0's.
       struct spi0_ctrl
       {
+      /// @brief Type alias for (smart) pointers to SPI control blocks
+        typedef phymem_ptr<volatile spi0_registers>  reg_ptr;
+
       /// @brief Pointer to BCM2708 / BCM2835 SPI0 control registers instance
-        phymem_ptr<volatile spi0_registers>        regs;
+        reg_ptr regs;
 
       /// @brief SPI0 channel allocation flag
         bool  allocated;
 
+      /// @brief Returns true if the running SoC has a SPI controller of the
+      /// SPI0 design: SPI0 on all SoCs, SPI3 to SPI6 on a BCM2711.
+      /// @param[in] spi  SPI controller number.
+        static bool has_controller(unsigned spi);
+
+      /// @brief Function returning (smart) pointer to a SPI controller's
+      /// registers
+      /// @param[in] spi  SPI controller number: 0, or 3 to 6 on a BCM2711.
+      ///                 N.B. The value is \e not range checked.
+      /// @returns regs for SPI0, otherwise the mapped registers of SPI3 to
+      ///          SPI6.
+        reg_ptr & regs_of(unsigned spi);
+
+      /// @brief Returns a SPI controller's allocation flag
+      /// @param[in] spi  SPI controller number: 0, or 3 to 6 on a BCM2711.
+      ///                 N.B. The value is \e not range checked.
+        bool & allocated_of(unsigned spi);
+
       /// @brief Singleton instance getter
       /// @returns \e The instance of the SPI0 control object.
         static spi0_ctrl & instance();
 
       private:
+        constexpr static unsigned first_bcm2711_spi = 3U;
+        constexpr static unsigned number_of_bcm2711_spis = 4U;
+
+        reg_ptr bcm2711_register_blocks[number_of_bcm2711_spis];
+        bool    bcm2711_allocated[number_of_bcm2711_spis];
+
         spi0_ctrl();
 
         spi0_ctrl(spi0_ctrl const &) = delete;
@@ -0,0 +1,569 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file spi0_dma.cpp
+/// @brief DMA driven SPI0 standard mode transfer implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "spi0_dma.h"
+#include "spi0_dma_compiler.h"
+#include "spi0_ctrl.h"
+#include "dma_ctrl.h"
+#include "dma_arena.h"
+#include "trace_marker.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      namespace
+      {
+        register_t const spi0_bus_address
+                    {peripheral_bus_address(spi0_registers::physical_address)};
+        register_t const spi0_cs_bus_address
+                  { spi0_bus_address
+                  + static_cast<register_t>
+                                (offsetof(spi0_registers, control_and_status))
+                  };
+        register_t const spi0_fifo_bus_address
+                  { spi0_bus_address
+                  + static_cast<register_t>(offsetof(spi0_registers, fifo))
+                  };
+        register_t const spi0_clk_bus_address
+                  { spi0_bus_address
+                  + static_cast<register_t>(offsetof(spi0_registers, clock))
+                  };
+
+      // Data words: CLK, idle CS and TX channel start CS values, followed by
+      // the status value for a frame's last segment
+        std::size_t const segment_data_words{3U};
+
+        std::size_t number_of_chunks(std::size_t count)
+        {
+          return (count+spi0_dma_max_chunk-1U)/spi0_dma_max_chunk;
+        }
+
+        std::size_t round_to_words(std::size_t bytes)
+        {
+          return (bytes+sizeof(register_t)-1U)&~(sizeof(register_t)-1U);
+        }
+
+      // Receive chain: CLK write, 4 per chunk & for a last segment a status
+      // write. Transmit chain: 1 per chunk
+        std::size_t number_of_control_blocks(std::size_t chunks, bool last)
+        {
+          return 5U*chunks + 1U + (last ? 1U : 0U);
+        }
+
+        std::size_t segment_size(std::size_t count, bool last)
+        {
+          std::size_t const chunks{number_of_chunks(count)};
+          return number_of_control_blocks(chunks, last)
+                                                    *sizeof(dma_control_block)
+               + (segment_data_words+(last ? 1U : 0U)+2U*chunks)
+                                                    *sizeof(register_t)
+               + 2U*round_to_words(count);
+        }
+
+      // Compile one segment, ending with a status write if seq is non-null.
+      // The returned last control block's next_control_block is zero.
+        spi0_dma_frame compile_segment
+        ( dma_region & region
+        , spi0_dma_segment_spec const & segment
+        , std::uint32_t const * seq
+        )
+        {
+          spi0_dma_frame_settings const & settings(segment.settings);
+          std::size_t const count{segment.count};
+          bool const receive{segment.receive};
+          if (count==0U)
+            {
+              throw std::invalid_argument{"compile_spi0_dma_frame: frame has "
+                                          "no bytes to transfer."};
+            }
+          std::size_t const chunks{number_of_chunks(count)};
+          std::size_t const cb_count
+                              {number_of_control_blocks(chunks, seq!=nullptr)};
+          dma_control_block * cbs{region.allocate_control_blocks(cb_count)};
+          dma_control_block * rx_cbs{cbs};
+          dma_control_block * tx_cbs{cbs+cb_count-chunks};
+          std::size_t const word_count{segment_data_words+(seq ? 1U : 0U)};
+          register_t * words{static_cast<register_t *>
+                        (region.allocate(word_count*sizeof(register_t))
+                                                                      .address)
+                            };
+          register_t * kick_words{static_cast<register_t *>
+                                    (region.allocate(chunks*sizeof(register_t))
+                                                                      .address)
+                                 };
+          dma_buffer const tx_data
+                    {region.allocate(chunks*sizeof(register_t)
+                                                        +round_to_words(count))
+                    };
+          dma_buffer const rx_data
+            {receive ? region.allocate(round_to_words(count))
+                     : dma_buffer{nullptr, 0U, 0U}
+            };
+          words[0] = settings.clk;
+          words[1] = settings.cs_idle;
+          words[2] = dma_channel_registers::start_value();
+          if (seq)
+            {
+              words[3] = *seq;
+            }
+
+          register_t const write_ti{ dma_control_block::ti_no_wide_bursts
+                                   | dma_control_block::ti_wait_resp
+                                   | dma_control_block::ti_src_inc
+                                   | dma_control_block::ti_dest_inc
+                                   };
+          register_t const tx_ti
+                        { dma_control_block::ti_no_wide_bursts
+                        | dma_control_block::ti_wait_resp
+                        | dma_control_block::ti_src_inc
+                        | dma_control_block::ti_dest_dreq
+                        | dma_control_block::ti_permap(dma_dreq::spi_tx)
+                        };
+          register_t const rx_ti
+                        { dma_control_block::ti_no_wide_bursts
+                        | dma_control_block::ti_src_dreq
+                        | dma_control_block::ti_permap(dma_dreq::spi_rx)
+                        | ( receive ? dma_control_block::ti_dest_inc
+                                    : dma_control_block::ti_dest_ignore
+                          )
+                        };
+          auto set_cb = [&]( dma_control_block & cb, register_t ti
+                           , register_t src, register_t dest
+                           , register_t length
+                           , dma_control_block const * next
+                           )
+                        {
+                          cb.transfer_info = ti;
+                          cb.source_address = src;
+                          cb.dest_address = dest;
+                          cb.transfer_length = length;
+                          cb.stride = 0U;
+                          cb.next_control_block
+                                      = next ? region.bus_address(next) : 0U;
+                          cb.reserved_do_not_use[0] = 0U;
+                          cb.reserved_do_not_use[1] = 0U;
+                        };
+          register_t const word_size{sizeof(register_t)};
+          set_cb( rx_cbs[0], write_ti, region.bus_address(words)
+                , spi0_clk_bus_address, word_size, rx_cbs+1
+                );
+          unsigned char * tx_pos{static_cast<unsigned char *>
+                                                          (tx_data.address)};
+          dma_control_block * last{rx_cbs+cb_count-chunks-1U};
+          std::size_t offset{0U};
+          for (std::size_t chunk=0; chunk!=chunks; ++chunk)
+            {
+              std::size_t const length
+                            {std::min(count-offset, spi0_dma_max_chunk)};
+              register_t const header
+                            { static_cast<register_t>(length)<<16
+                            | (settings.cs_header&0xFFU)
+                            };
+              std::memcpy(tx_pos, &header, sizeof(header));
+              std::memset(tx_pos+sizeof(header), 0, round_to_words(length));
+              if (segment.tx)
+                {
+                  std::memcpy( tx_pos+sizeof(header), segment.tx+offset
+                             , length
+                             );
+                }
+              set_cb( tx_cbs[chunk], tx_ti, region.bus_address(tx_pos)
+                    , spi0_fifo_bus_address
+                    , static_cast<register_t>
+                                  (sizeof(header)+round_to_words(length))
+                    , nullptr
+                    );
+              kick_words[chunk] = region.bus_address(tx_cbs+chunk);
+              dma_control_block * chunk_cbs{rx_cbs+1U+4U*chunk};
+              set_cb( chunk_cbs[0], write_ti, region.bus_address(words+1)
+                    , spi0_cs_bus_address, word_size, chunk_cbs+1
+                    );
+              set_cb( chunk_cbs[1], write_ti
+                    , region.bus_address(kick_words+chunk)
+                    , settings.tx_channel_bus
+                      + static_cast<register_t>
+                        (offsetof(dma_channel_registers, control_block_address))
+                    , word_size, chunk_cbs+2
+                    );
+              set_cb( chunk_cbs[2], write_ti, region.bus_address(words+2)
+                    , settings.tx_channel_bus
+                      + static_cast<register_t>
+                        (offsetof(dma_channel_registers, control_and_status))
+                    , word_size, chunk_cbs+3
+                    );
+              set_cb( chunk_cbs[3], rx_ti, spi0_fifo_bus_address
+                    , receive ? rx_data.bus_address
+                                + static_cast<register_t>(offset)
+                              : 0U
+                    , static_cast<register_t>(length)
+                    , chunk_cbs+3==last ? nullptr : chunk_cbs+4
+                    );
+              tx_pos += sizeof(header)+round_to_words(length);
+              offset += length;
+            }
+          if (seq)
+            {
+              set_cb( *last, write_ti, region.bus_address(words+3)
+                    , settings.status_bus, word_size, nullptr
+                    );
+            }
+          return spi0_dma_frame
+                  { last
+                  , region.bus_address(rx_cbs)
+                  , static_cast<std::uint8_t const *>(rx_data.address)
+                  };
+        }
+      }
+
+      std::size_t spi0_dma_frame_size(std::size_t count)
+      {
+        return segment_size(count, true);
+      }
+
+      std::size_t spi0_dma_sequence_size
+      ( spi0_dma_segment_spec const * segments
+      , std::size_t count
+      )
+      {
+      // Each segment after the first starts with control blocks, which are
+      // 32 byte aligned, so allow for padding before them
+        std::size_t const cb_size{sizeof(dma_control_block)};
+        std::size_t size{0U};
+        for (std::size_t idx=0U; idx!=count; ++idx)
+          {
+            size = (size+cb_size-1U)/cb_size*cb_size
+                 + segment_size(segments[idx].count, idx+1U==count);
+          }
+        return size;
+      }
+
+      spi0_dma_frame compile_spi0_dma_frame
+      ( dma_region & region
+      , spi0_dma_frame_settings const & settings
+      , std::uint8_t const * tx
+      , bool receive
+      , std::size_t count
+      , std::uint32_t seq
+      )
+      {
+        spi0_dma_segment_spec const segment{settings, tx, receive, count};
+        return compile_segment(region, segment, &seq);
+      }
+
+      spi0_dma_frame compile_spi0_dma_sequence
+      ( dma_region & region
+      , spi0_dma_segment_spec const * segments
+      , std::size_t count
+      , std::uint32_t seq
+      , std::uint8_t const ** rx_data
+      )
+      {
+        if (count==0U)
+          {
+            throw std::invalid_argument{"compile_spi0_dma_sequence: sequence "
+                                        "has no segments."};
+          }
+        spi0_dma_frame frame{nullptr, 0U, nullptr};
+        for (std::size_t idx=0U; idx!=count; ++idx)
+          {
+            spi0_dma_frame const segment
+              {compile_segment( region, segments[idx]
+                              , idx+1U==count ? &seq : nullptr
+                              )};
+            if (frame.last)
+              {
+                frame.last->next_control_block = segment.first_bus;
+              }
+            else
+              {
+                frame = segment;
+              }
+            frame.last = segment.last;
+            rx_data[idx] = segment.rx_data;
+          }
+        return frame;
+      }
+    } // namespace internal closed
+
+    using namespace internal;
+
+    namespace
+    {
+    // DMA DREQ and panic thresholds as used by the Linux spi-bcm2835 driver
+      register_t const spi0_dma_tx_dreq{0x20U};
+      register_t const spi0_dma_tx_panic{0x10U};
+      register_t const spi0_dma_rx_dreq{0x20U};
+      register_t const spi0_dma_rx_panic{0x30U};
+
+    // SPI0 CS bits kept from the spi0_pins set up: CSPOL0, CSPOL1, CSPOL2
+      register_t const spi0_cs_line_polarity_mask
+                          {spi0_registers::cs_csline_polarity_base_mask*7U};
+
+    // SPI0 CS bits taken from a slave context
+      register_t const spi0_cs_context_mask
+                          { spi0_registers::cs_chip_select_mask
+                          | spi0_registers::cs_clock_phase_mask
+                          | spi0_registers::cs_clock_polarity_mask
+                          };
+    }
+
+    bool spi0_dma_transfer::is_done() const
+    {
+      return owner->is_done(seq);
+    }
+
+    void spi0_dma_transfer::wait()
+    {
+      owner->wait(seq);
+    }
+
+    spi0_dma::spi0_dma
+    ( spi0_pins & sp
+    , std::size_t max_frame_size
+    , std::size_t max_segments
+    )
+    : pins(sp)
+    , max_frame{max_frame_size}
+    , max_segs{max_segments}
+    , slot_size{0U}
+    , status{nullptr}
+    , status_bus{0U}
+    , slots{}
+    , next_seq{1U}
+    , specs{new spi0_dma_segment_spec[max_segments]}
+    , rx_data(max_segments)
+    {
+      if (max_frame==0U || max_segs==0U)
+        {
+          throw std::invalid_argument{"spi0_dma::spi0_dma: maximum frame size "
+                                      "and segments must be non-zero."};
+        }
+      if (pins.spi()!=0U)
+        {
+          throw std::invalid_argument{"spi0_dma::spi0_dma: DMA is only "
+                                      "supported for SPI0."};
+        }
+      if (!pins.has_std_mode_support())
+        {
+          throw std::invalid_argument{"spi0_dma::spi0_dma: 3-wire SPI standard "
+                                      "mode not supported as the MISO line has "
+                                      "not been allocated to a GPIO pin."};
+        }
+      std::size_t const cb_size{sizeof(dma_control_block)};
+    // Each segment after the first needs at most as much more space as a
+    // one byte frame - its CLK write, a partial chunk and data word rounding
+    // - plus alignment padding before its control blocks
+      slot_size = ( spi0_dma_frame_size(max_frame)
+                  + (max_segs-1U)*(spi0_dma_frame_size(1U)+cb_size)
+                  + cb_size-1U
+                  )/cb_size*cb_size;
+      memory.reset(new dma_arena{cb_size+2U*slot_size});
+      dma_buffer const status_buffer{memory->allocate(sizeof(register_t))};
+      status = static_cast<std::uint32_t volatile *>(status_buffer.address);
+      status_bus = status_buffer.bus_address;
+      *status = 0U;
+      for (auto & slot : slots)
+        {
+          dma_buffer const slot_buffer{memory->allocate(slot_size, cb_size)};
+          slot.base = slot_buffer.address;
+          slot.base_bus = slot_buffer.bus_address;
+          slot.copies.reserve(max_segs);
+          slot.pending = false;
+        }
+      dma_ctrl & dma(dma_ctrl::instance());
+      tx_channel = dma.allocate_channel();
+      try
+        {
+          rx_channel = dma.allocate_channel();
+        }
+      catch (...)
+        {
+          dma.deallocate_channel(tx_channel);
+          throw;
+        }
+      pins.stop_conversing();
+      auto & regs(spi0_ctrl::instance().regs);
+      regs->set_dma_write_request_threshold(spi0_dma_tx_dreq);
+      regs->set_dma_write_panic_threshold(spi0_dma_tx_panic);
+      regs->set_dma_read_request_threshold(spi0_dma_rx_dreq);
+      regs->set_dma_read_panic_threshold(spi0_dma_rx_panic);
+    }
+
+    spi0_dma::~spi0_dma()
+    {
+      dma_ctrl & dma(dma_ctrl::instance());
+      dma.deallocate_channel(rx_channel);
+      dma.deallocate_channel(tx_channel);
+      auto & regs(spi0_ctrl::instance().regs);
+      regs->set_transfer_active(false);
+      regs->set_dma_enable(false);
+      regs->set_auto_deassert_chip_select(false);
+      regs->clear_fifo(spi0_fifo_clear_action::clear_tx_rx);
+    }
+
+    bool spi0_dma::is_done(std::uint32_t seq) const
+    {
+      return static_cast<std::int32_t>(*status-seq)>=0;
+    }
+
+    void spi0_dma::finish(frame_slot & slot)
+    {
+      internal::trace_scope trace{"spi0_dma wait"};
+      while (!is_done(slot.seq))
+        {
+          if (!dma_ctrl::instance().regs->channel[rx_channel].is_active()
+           && !is_done(slot.seq)
+             )
+            {
+              slot.pending = false;
+              throw std::runtime_error{"spi0_dma: DMA transfer stopped before "
+                                       "frame completed."};
+            }
+          std::this_thread::yield();
+        }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      for (auto const & copy : slot.copies)
+        {
+          if (copy.rx)
+            {
+              std::memcpy(copy.rx, copy.rx_data, copy.count);
+            }
+        }
+      slot.pending = false;
+    }
+
+    void spi0_dma::wait(std::uint32_t seq)
+    {
+      frame_slot & slot(slots[seq%2U]);
+      if (slot.pending && slot.seq==seq)
+        {
+          finish(slot);
+        }
+    }
+
+    spi0_dma_transfer spi0_dma::submit
+    ( spi0_slave_context const & c
+    , std::uint8_t const * tx
+    , std::uint8_t * rx
+    , std::size_t count
+    )
+    {
+      spi0_dma_segment const segment{&c, tx, rx, count};
+      return submit_sequence(&segment, 1U);
+    }
+
+    spi0_dma_transfer spi0_dma::submit_sequence
+    ( spi0_dma_segment const * segments
+    , std::size_t count
+    )
+    {
+      if (count==0U || count>max_segs)
+        {
+          throw std::invalid_argument{"spi0_dma::submit_sequence: number of "
+                                      "segments is zero or greater than the "
+                                      "maximum."};
+        }
+      std::size_t total{0U};
+      register_t const cs_polarity
+                        { spi0_ctrl::instance().regs->control_and_status
+                        & spi0_cs_line_polarity_mask
+                        };
+      register_t const tx_channel_bus
+                { peripheral_bus_address(dma_registers::physical_address)
+                + static_cast<register_t>
+                                    (tx_channel*sizeof(dma_channel_registers))
+                };
+      for (std::size_t idx=0U; idx!=count; ++idx)
+        {
+          spi0_dma_segment const & segment(segments[idx]);
+          if (segment.context->mode!=spi0_mode::standard)
+            {
+              throw std::invalid_argument{"spi0_dma::submit: slave context is "
+                                          "not for standard mode."};
+            }
+          if (segment.count==0U)
+            {
+              throw std::invalid_argument{"spi0_dma::submit: count is zero."};
+            }
+          total += segment.count;
+          register_t const context_cs
+                              {segment.context->cs_reg&spi0_cs_context_mask};
+          specs[idx] = spi0_dma_segment_spec
+            { spi0_dma_frame_settings
+                { cs_polarity
+                  | context_cs
+                  | spi0_registers::cs_dma_enable_mask
+                  | spi0_registers::cs_auto_deassert_cs_mask
+                  | static_cast<register_t>
+                                        (spi0_fifo_clear_action::clear_tx_rx)
+                , context_cs | spi0_registers::cs_xfer_active_mask
+                , segment.context->clk_reg
+                , tx_channel_bus
+                , status_bus
+                }
+            , segment.tx
+            , segment.rx!=nullptr
+            , segment.count
+            };
+        }
+      std::size_t const size{spi0_dma_sequence_size(specs.get(), count)};
+      if (total>max_frame || size>slot_size)
+        {
+          throw std::invalid_argument{"spi0_dma::submit: count is greater "
+                                      "than the maximum frame size."};
+        }
+      std::uint32_t const seq{next_seq};
+      frame_slot & slot(slots[seq%2U]);
+      frame_slot & previous(slots[(seq+1U)%2U]);
+      if (slot.pending)
+        {
+          finish(slot);
+        }
+      dma_region region{slot.base, slot.base_bus, size};
+      spi0_dma_frame const frame
+            {compile_spi0_dma_sequence( region, specs.get(), count, seq
+                                      , rx_data.data()
+                                      )};
+      slot.last = frame.last;
+      slot.copies.clear();
+      for (std::size_t idx=0U; idx!=count; ++idx)
+        {
+          slot.copies.push_back
+                (rx_copy{rx_data[idx], segments[idx].rx, segments[idx].count});
+        }
+      slot.seq = seq;
+      slot.pending = true;
+      ++next_seq;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      volatile dma_channel_registers &
+                            ch(dma_ctrl::instance().regs->channel[rx_channel]);
+      if (previous.pending && !is_done(previous.seq))
+        { // Chain on to the in-flight frame. If the channel stopped before
+          // reading the new link start it, unless the new frame is done too.
+          previous.last->next_control_block = frame.first_bus;
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+          if (!ch.is_active() && !is_done(seq))
+            {
+              ch.start(frame.first_bus);
+            }
+        }
+      else
+        {
+          ch.start(frame.first_bus);
+        }
+      return spi0_dma_transfer{this, seq};
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
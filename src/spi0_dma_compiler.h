@@ -0,0 +1,135 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file spi0_dma_compiler.h
+/// @brief \b Internal : compile SPI0 DMA frames into DMA control blocks :
+/// type and function declarations.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_SPI0_DMA_COMPILER_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_SPI0_DMA_COMPILER_H
+
+# include "dma_arena.h"
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Maximum bytes in one SPI0 DMA chunk.
+    ///
+    /// The DLEN field of a chunk header word is 16 bits. Keeping chunks a
+    /// multiple of 4 bytes means only a frame's last chunk has a partially
+    /// used final FIFO word.
+      constexpr std::size_t spi0_dma_max_chunk{65532U};
+
+    /// @brief Register values and addresses used by a compiled SPI0 DMA frame
+      struct spi0_dma_frame_settings
+      {
+        register_t cs_idle;       ///< SPI0 CS value written before each chunk
+        register_t cs_header;     ///< SPI0 CS value in chunk header words
+        register_t clk;           ///< SPI0 CLK value for the frame
+        register_t tx_channel_bus;///< Bus address of TX DMA channel registers
+        register_t status_bus;    ///< Bus address of completion status word
+      };
+
+    /// @brief One segment of a SPI0 DMA sequence: a transfer with a slave
+    /// context's register values.
+      struct spi0_dma_segment_spec
+      {
+        spi0_dma_frame_settings settings; ///< Register values and addresses
+        std::uint8_t const *    tx;       ///< Bytes to transmit or nullptr
+        bool                    receive;  ///< Keep received bytes if true
+        std::size_t             count;    ///< Number of bytes to transfer
+      };
+
+    /// @brief Locations within a compiled SPI0 DMA frame.
+      struct spi0_dma_frame
+      {
+        dma_control_block *   last;     ///< Last (status writing) control block
+        register_t            first_bus;///< Bus address of first control block
+        std::uint8_t const *  rx_data;  ///< Received data, nullptr if ignored
+      };
+
+    /// @brief Returns bytes needed for the compiled form of a frame,
+    /// including space for received data.
+    /// @param count  Number of bytes to transfer.
+      std::size_t spi0_dma_frame_size(std::size_t count);
+
+    /// @brief Compile a SPI0 DMA frame into two control block chains.
+    ///
+    /// The frame is split into chunks of at most spi0_dma_max_chunk bytes.
+    /// Transmit data for each chunk is copied into region after a header word
+    /// holding the chunk length and CS settings, as described in the
+    /// datasheet's SPI DMA section, and is written to the SPI0 FIFO by a
+    /// single transmit control block paced by the SPI TX DREQ.
+    ///
+    /// The receive chain, run on a second channel, drives the frame: it
+    /// writes the SPI0 CLK register and then for each chunk writes the idle
+    /// CS value, starts the transmit channel on that chunk's control block and
+    /// reads the chunk's bytes from the SPI0 FIFO paced by the SPI RX DREQ.
+    /// Finally it writes seq to the status word. Chains end with a zero next
+    /// control block address, so frames may be linked by setting the last
+    /// control block's next_control_block.
+    ///
+    /// @param region   DMA region with at least spi0_dma_frame_size(count)
+    ///                 bytes available, allocated from 32 byte aligned.
+    /// @param settings Register values and addresses to use.
+    /// @param tx       Bytes to transmit, or nullptr to transmit zeros.
+    /// @param receive  If true keep received bytes in region, otherwise
+    ///                 discard them.
+    /// @param count    Number of bytes to transfer.
+    /// @param seq      Value written to the status word on completion.
+    /// @returns Locations of the compiled frame.
+    /// @throws std::invalid_argument if count is zero.
+    /// @throws std::bad_alloc if region has insufficient space.
+      spi0_dma_frame compile_spi0_dma_frame
+      ( dma_region & region
+      , spi0_dma_frame_settings const & settings
+      , std::uint8_t const * tx
+      , bool receive
+      , std::size_t count
+      , std::uint32_t seq
+      );
+
+    /// @brief Returns bytes needed for the compiled form of a sequence,
+    /// including space for received data.
+    /// @param segments Segments of the sequence.
+    /// @param count    Number of segments.
+      std::size_t spi0_dma_sequence_size
+      ( spi0_dma_segment_spec const * segments
+      , std::size_t count
+      );
+
+    /// @brief Compile a sequence of SPI0 DMA segments, each with its own
+    /// slave context register values, into one frame.
+    ///
+    /// Each segment is compiled as for compile_spi0_dma_frame except that
+    /// only the last writes seq to the status word; the receive chain of
+    /// each other segment is linked to the next segment's, whose first
+    /// control blocks write its CLK and idle CS values. So a sequence
+    /// addressing several slaves, e.g. reading an ADC on chip 0 then writing
+    /// a DAC on chip 1, runs from one DMA channel start.
+    ///
+    /// @param region   DMA region with at least spi0_dma_sequence_size bytes
+    ///                 available, allocated from 32 byte aligned.
+    /// @param segments Segments of the sequence.
+    /// @param count    Number of segments.
+    /// @param seq      Value written to the status word on completion.
+    /// @param rx_data  Array of count elements set to the received data
+    ///                 location of each segment, nullptr if ignored.
+    /// @returns Locations of the compiled frame. rx_data is that of the first
+    ///          segment.
+    /// @throws std::invalid_argument if count or any segment's count is zero.
+    /// @throws std::bad_alloc if region has insufficient space.
+      spi0_dma_frame compile_spi0_dma_sequence
+      ( dma_region & region
+      , spi0_dma_segment_spec const * segments
+      , std::size_t count
+      , std::uint32_t seq
+      , std::uint8_t const ** rx_data
+      );
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_SPI0_DMA_COMPILER_H
@@ -6,42 +6,32 @@
 /// @author Ralph E. McArdell
 
 #include "spi0_pins.h"
-#include "gpio_alt_fn.h"
 #include "gpio_ctrl.h"
 #include "spi0_ctrl.h"
 #include "periexcept.h"
+#include "peripheral_barrier.h"
+#include "trace_marker.h"
+#include <algorithm>
 
 namespace dibase { namespace rpi {
   namespace peripherals
   {
     using internal::spi0_ctrl;
     using internal::gpio_ctrl;
-    using internal::pin_alt_fn::gpio_special_fn;
     using internal::gpio_pin_fn;
 
     namespace
     {
-      gpio_pin_fn get_alt_fn(pin_id pin, gpio_special_fn special_fn)
+    // SPI0 FIFO depth in bytes and the minimum number of bytes in the receive
+    // FIFO when its needs reading (RXR) flag is set. Knowing these allows
+    // bursts of FIFO accesses without checking status flags for each byte.
+      constexpr std::size_t fifo_depth{16U};
+      constexpr std::size_t rx_fifo_needs_reading_count{12U};
+
+    // Registers of the SPI0 or BCM2711 SPI3 to SPI6 controller in use
+      spi0_ctrl::reg_ptr & spi_regs(unsigned spi)
       {
-        using internal::pin_alt_fn::result_set;
-        using internal::pin_alt_fn::select;
-        auto pin_fn_info( select(pin,special_fn) );
-        if (pin_fn_info.empty())
-          {
-            throw std::invalid_argument
-                  { "spi0_pins::spi0_pins: Pin does not support "
-                    "requested SPI0 special function."
-                  };
-          } 
-        if (pin_fn_info.size()!=1)
-          {
-            throw std::range_error // NO pin has >1 SPI0 function
-                  {"spi0_pins::spi0_pins: Internal data error: more than one "
-                   "pin alt function selected that supports the requested "
-                   "SPI0 special function."
-                  };
-          }
-        return pin_fn_info[0].alt_fn();
+        return spi0_ctrl::instance().regs_of(spi);
       }
     }
 
@@ -63,42 +53,85 @@ namespace dibase { namespace rpi {
 
     bool spi0_pins::write_fifo_is_empty() const
     {
-      return spi0_ctrl::instance().regs->get_transfer_done();
+      return spi_regs(spi_num)->get_transfer_done();
     }
 
     bool spi0_pins::write_fifo_has_space() const
     {
-      return spi0_ctrl::instance().regs->get_tx_fifo_not_full();
+      return spi_regs(spi_num)->get_tx_fifo_not_full();
     }
     
     bool spi0_pins::read_fifo_is_full() const
     {
-      return spi0_ctrl::instance().regs->get_rx_fifo_full();
+      return spi_regs(spi_num)->get_rx_fifo_full();
     }
 
     bool spi0_pins::read_fifo_has_data() const
     {
-      return spi0_ctrl::instance().regs->get_rx_fifo_not_empty();
+      return spi_regs(spi_num)->get_rx_fifo_not_empty();
     }
 
     bool spi0_pins::read_fifo_needs_reading() const
     {
-      return spi0_ctrl::instance().regs->get_rx_fifo_needs_reading();
+      return spi_regs(spi_num)->get_rx_fifo_needs_reading();
     }
 
     spi0_pins::~spi0_pins()
     {
+      release();
+    }
+
+    spi0_pins::spi0_pins(spi0_pins && other) noexcept
+    : pins(other.pins)
+    , spi_num(other.spi_num)
+    , mode(other.mode)
+    , lossi_long_words(other.lossi_long_words)
+    , cs_polarity_bits(other.cs_polarity_bits)
+    , waiting(other.waiting)
+    , wait_counts(other.wait_counts)
+    , counters(other.counters)
+    {
+      other.pins.fill(spi0_pin_not_used);
+    }
+
+    spi0_pins& spi0_pins::operator=(spi0_pins && other)
+    {
+      if (this!=&other)
+        {
+          release();
+          pins = other.pins;
+          spi_num = other.spi_num;
+          mode = other.mode;
+          lossi_long_words = other.lossi_long_words;
+          cs_polarity_bits = other.cs_polarity_bits;
+          waiting = other.waiting;
+          wait_counts = other.wait_counts;
+          counters = other.counters;
+          other.pins.fill(spi0_pin_not_used);
+        }
+      return *this;
+    }
+
+    void spi0_pins::release()
+    {
+      if (pins[0]==spi0_pin_not_used)
+        { // Moved from: owns nothing
+          return;
+        }
       unsigned idx{0U};
       while (idx!=number_of_pins && pins[idx]!=spi0_pin_not_used)
         {
           gpio_ctrl::instance().alloc.deallocate(pin_id(pins[idx]));
           ++idx;
         }
-      spi0_ctrl::instance().allocated = false;
+      spi0_ctrl::instance().allocated_of(spi_num) = false;
       if ( is_conversing() )
         {
           stop_conversing();
         }
+      spi_regs(spi_num)->set_interrupt_on_done(false);
+      spi_regs(spi_num)->set_interrupt_on_rxr(false);
+      pins.fill(spi0_pin_not_used);
     }
 
     void spi0_pins::construct
@@ -107,83 +140,101 @@ namespace dibase { namespace rpi {
     , pin_id sclk
     , pin_id mosi
     , pin_id miso
+    , unsigned spi
     , spi0_cs_polarity  cspol0
     , spi0_cs_polarity  cspol1
     )
     {
       pins.fill(pin_id(spi0_pin_not_used)); 
       bool all_protocols(miso!=spi0_pin_not_used);
-    // Get each pin's alt function for its SPI0 special function.
-    // Note: any of these can throw - but nothing allocated yet so OK
-      gpio_pin_fn alt_fn[number_of_pins];
-      alt_fn[ce0_idx] = get_alt_fn(ce0, gpio_special_fn::spi0_ce0_n);
-      alt_fn[ce1_idx] = get_alt_fn(ce1, gpio_special_fn::spi0_ce1_n);
-      alt_fn[sclk_idx] = get_alt_fn(sclk, gpio_special_fn::spi0_sclk);
-      alt_fn[mosi_idx] = get_alt_fn(mosi, gpio_special_fn::spi0_mosi);
-      if (all_protocols)
+      if ( !spi0_ctrl::has_controller(spi) )
         {
-          alt_fn[miso_idx] = get_alt_fn(miso, gpio_special_fn::spi0_miso);
+          throw std::invalid_argument( "spi0_pins::spi0_pins: SPI3 to SPI6 "
+                                       "are only available on a BCM2711."
+                                     );
         }
-    // Only one SPI0 peripheral so can check whether it is in use before
-    // starting on pin allocations
-      if ( spi0_ctrl::instance().allocated )
+      spi_num = spi;
+    // Only one of each SPI peripheral so can check whether it is in use
+    // before starting on pin allocations
+      if ( spi0_ctrl::instance().allocated_of(spi_num) )
         {
-          throw bad_peripheral_alloc( "spi0_pins::spi0_pins: SPI0 is "
-                                      "already being used locally."
+          throw bad_peripheral_alloc( "spi0_pins::spi0_pins: SPI peripheral "
+                                      "is already being used locally."
                                     );
         }
 
-    // Speculatively allocate SPI0 peripheral
-      spi0_ctrl::instance().allocated = true;
-
+    // Speculatively allocate SPI peripheral then all pins together: pins'
+    // support for their SPI functions was checked at compile time.
+      spi0_ctrl::instance().allocated_of(spi_num) = true;
+      pin_id const pin_ids[number_of_pins]{ce0, ce1, sclk, mosi, miso};
+      std::size_t const pin_count{all_protocols ? number_of_pins : miso_idx};
       try
       {
-        gpio_ctrl::instance().alloc.allocate(ce0); // CAN THROW
-        pins[ce0_idx] = ce0;
-        gpio_ctrl::instance().alloc.allocate(ce1); // CAN THROW
-        pins[ce1_idx] = ce1;
-        gpio_ctrl::instance().alloc.allocate(sclk); // CAN THROW
-        pins[sclk_idx] = sclk;
-        gpio_ctrl::instance().alloc.allocate(mosi); // CAN THROW
-        pins[mosi_idx] = mosi;
-        if (all_protocols)
-          {
-            gpio_ctrl::instance().alloc.allocate(miso); // CAN THROW
-            pins[miso_idx] = miso;
-          }
+        gpio_ctrl::instance().alloc.allocate_all(pin_ids, pin_count);
       }
       catch (...)
-      { // Oops - failed to complete resource acquisition and initialisation;
-      // Release resources allocated so far and re-throw
-        unsigned idx{0U};
-        while (idx!=number_of_pins && pins[idx]!=spi0_pin_not_used)
-          {
-            gpio_ctrl::instance().alloc.deallocate(pin_id(pins[idx]));
-            ++idx;
-          }
-        spi0_ctrl::instance().allocated = false;
+      {
+        spi0_ctrl::instance().allocated_of(spi_num) = false;
         throw;
       }
-      unsigned idx{0U};
-      spi0_ctrl::instance().regs->set_chip_select_polarity
+      std::copy(pin_ids, pin_ids+pin_count, pins.begin());
+      using internal::spi0_registers;
+      cs_polarity_bits
+        = (cspol0==spi0_cs_polarity::high
+            ? register_t(spi0_registers::cs_csline_polarity_base_mask) : 0U)
+        | (cspol1==spi0_cs_polarity::high
+            ? register_t(spi0_registers::cs_csline_polarity_base_mask<<1) : 0U);
+
+    // SPI, GPIO then SPI again: barriers at each peripheral switch
+      peripheral_barrier();
+      spi_regs(spi_num)->set_chip_select_polarity
                                   (0U, cspol0==spi0_cs_polarity::high);
-      spi0_ctrl::instance().regs->set_chip_select_polarity
+      spi_regs(spi_num)->set_chip_select_polarity
                                   (1U, cspol1==spi0_cs_polarity::high);
-      
-      while (idx!=number_of_pins && pins[idx]!=spi0_pin_not_used)
-        {
-          gpio_ctrl::instance().regs->set_pin_function( pin_id(pins[idx])
-                                                      , alt_fn[idx]
-                                                      );
-          ++idx;
-        }
+
+    // All SPI0 functions are alternative function 0: see spi0_fn_pins. SPI3
+    // to SPI6 CE1 functions are alternative function 5, their others
+    // alternative function 3: see bcm2711_spi_fn_pins.
+      gpio_pin_fn const fn{spi==0U ? gpio_pin_fn::alt0 : gpio_pin_fn::alt3};
+      gpio_pin_fn const ce1_fn{spi==0U ? gpio_pin_fn::alt0
+                                       : gpio_pin_fn::alt5};
+      internal::gpio_pin_fn_setting const pin_fns[number_of_pins]
+      { {ce0, fn}
+      , {ce1, ce1_fn}
+      , {sclk, fn}
+      , {mosi, fn}
+      , {miso, fn}
+      };
+      peripheral_barrier();
+      gpio_ctrl::instance().config.set_pin_functions( pin_fns
+                                                    , pin_fns+pin_count
+                                                    );
+      peripheral_barrier();
       stop_conversing();
+      peripheral_barrier();
     }
 
     void spi0_pins::stop_conversing()
     {
-      spi0_ctrl::instance().regs->set_transfer_active(false);
+      spi_regs(spi_num)->set_transfer_active(false);
       mode = spi0_mode::none;
+      lossi_long_words = false;
+    }
+
+    std::uint32_t spi0_pins::interrupt_bits() const
+    {
+      using internal::spi0_registers;
+      return waiting.interrupt ? ( spi0_registers::cs_int_on_done_mask
+                                 | spi0_registers::cs_int_on_rxr_mask
+                                 )
+                               : 0U;
+    }
+
+    void spi0_pins::set_wait_policy(wait_policy const & p)
+    {
+      spi_regs(spi_num)->set_interrupt_on_done(p.interrupt!=nullptr);
+      spi_regs(spi_num)->set_interrupt_on_rxr(p.interrupt!=nullptr);
+      waiting = p;
     }
 
     void spi0_pins::start_conversing(spi0_slave_context const & c)
@@ -211,79 +262,185 @@ namespace dibase { namespace rpi {
                 };
       if (c.mode==spi0_mode::lossi)
         {
-          spi0_ctrl::instance().regs->lossi_mode_toh = c.ltoh_reg;
+          spi_regs(spi_num)->lossi_mode_toh = c.ltoh_reg;
         }
-      spi0_ctrl::instance().regs->clock = c.clk_reg;
-      spi0_ctrl::instance().regs->control_and_status 
-                              = ( spi0_ctrl::instance().regs->control_and_status
+      spi_regs(spi_num)->clock = c.clk_reg;
+      spi_regs(spi_num)->control_and_status 
+                              = ( spi_regs(spi_num)->control_and_status
                                 & cs_reg_mask
                                 )
                               | (c.cs_reg & (~cs_reg_mask))
+                              | interrupt_bits()
                               ;
-      spi0_ctrl::instance().regs->clear_fifo(spi0_fifo_clear_action::clear_tx_rx);
+      spi_regs(spi_num)->clear_fifo(spi0_fifo_clear_action::clear_tx_rx);
       mode = c.mode;
-      spi0_ctrl::instance().regs->set_transfer_active(true);
+      spi_regs(spi_num)->set_transfer_active(true);
+    }
+
+    void spi0_pins::switch_conversation(spi0_slave_context const & c)
+    {
+      if (c.mode==spi0_mode::none)
+        {
+          stop_conversing();
+          return;
+        }
+      if ( c.mode==spi0_mode::standard && !has_std_mode_support() )
+        {
+          throw std::invalid_argument{ "spi0_pins::switch_conversation: "
+                                       "3-wire SPI standard mode not "
+                                       "supported as the MISO lines has not "
+                                       "been allocated to a GPIO pin"
+                                     };
+        }
+      using internal::spi0_registers;
+      using internal::spi0_fifo_clear_action;
+      constexpr register_t cspol_mask
+                { spi0_registers::cs_csline_polarity_base_mask      // CSPOL0
+                | (spi0_registers::cs_csline_polarity_base_mask<<1) // CSPOL1
+                };
+      register_t const cs{ (c.cs_reg&~cspol_mask)
+                         | cs_polarity_bits
+                         | interrupt_bits()
+                         };
+      auto & regs(spi_regs(spi_num));
+    // TA is clear in the context's CS value: stop transfers, clear FIFOs
+      regs->control_and_status
+                    = cs
+                    | static_cast<register_t>
+                                      (spi0_fifo_clear_action::clear_tx_rx);
+      if (c.mode==spi0_mode::lossi)
+        {
+          regs->lossi_mode_toh = c.ltoh_reg;
+        }
+      regs->clock = c.clk_reg;
+      regs->control_and_status = cs | spi0_registers::cs_xfer_active_mask;
+      mode = c.mode;
+      lossi_long_words = false;
+    }
+
+    bool spi0_pins::set_lossi_long_word_writes(bool enable)
+    {
+      if (mode!=spi0_mode::lossi)
+        {
+          return false;
+        }
+      auto & regs(spi_regs(spi_num));
+      regs->set_lossi_dma_enable(enable);
+      regs->set_lossi_long_word(enable);
+      lossi_long_words = enable;
+      return true;
     }
 
     bool spi0_pins::write
     ( std::uint8_t data
     , spi0_lossi_write lossi_write_type
-    )
+    ) noexcept
     {
-      if (spi0_ctrl::instance().regs->get_tx_fifo_not_full())
+      if (lossi_long_words)
+        {
+          return false;
+        }
+      if (spi_regs(spi_num)->get_tx_fifo_not_full())
         {
           switch (mode)
             {
             case spi0_mode::standard:
-              spi0_ctrl::instance().regs->transmit_fifo_write(data);
+              spi_regs(spi_num)->transmit_fifo_write(data);
+              counters.count(io_event::bytes_written);
               return true;
 
             case spi0_mode::bidirectional:
-              spi0_ctrl::instance().regs->set_read_enable(false);
-              spi0_ctrl::instance().regs->transmit_fifo_write(data);
+              spi_regs(spi_num)->set_read_enable(false);
+              spi_regs(spi_num)->transmit_fifo_write(data);
+              counters.count(io_event::bytes_written);
               return true;
 
             case spi0_mode::lossi:
               if (lossi_write_type==spi0_lossi_write::data)
                 {
-                  spi0_ctrl::instance().regs->transmit_fifo_lossi_write(data);
+                  spi_regs(spi_num)->transmit_fifo_lossi_write(data);
                 }
               else
                 {
-                  spi0_ctrl::instance().regs->transmit_fifo_write(data);
+                  spi_regs(spi_num)->transmit_fifo_write(data);
                 }
+              counters.count(io_event::bytes_written);
               return true;
 
             default: // spi0_mode::none and any weird values...
               break;
             };
         }
+      else
+        {
+          counters.count(io_event::tx_fifo_full);
+        }
       return false;
     }
 
     std::size_t  spi0_pins::write
     ( std::uint8_t const * pdata
     , std::size_t count
-    )
+    ) noexcept
     {
       std::size_t bytes_written{0U};
       switch (mode)
         {
         case spi0_mode::bidirectional:
-          spi0_ctrl::instance().regs->set_read_enable(false);
-         /* Intentional drop-through */
-        case spi0_mode::standard:
+          spi_regs(spi_num)->set_read_enable(false);
+         /* Intentional fall through */
         case spi0_mode::lossi:
-          while (count-- && spi0_ctrl::instance().regs->get_tx_fifo_not_full())
+          if (lossi_long_words)
             {
-              spi0_ctrl::instance().regs->transmit_fifo_write(*pdata++);
-              ++bytes_written;
+              auto & regs(spi_regs(spi_num));
+              while (count>=4U && regs->get_tx_fifo_not_full())
+                {
+                  regs->transmit_fifo_long_write
+                          ( static_cast<std::uint32_t>(pdata[0])
+                          | static_cast<std::uint32_t>(pdata[1])<<8
+                          | static_cast<std::uint32_t>(pdata[2])<<16
+                          | static_cast<std::uint32_t>(pdata[3])<<24
+                          );
+                  pdata += 4;
+                  count -= 4U;
+                  bytes_written += 4U;
+                }
+              if (count>=4U)
+                {
+                  counters.count(io_event::tx_fifo_full);
+                }
+              break;
             }
+         /* Intentional fall through */
+        case spi0_mode::standard:
+          {
+            auto & regs(spi_regs(spi_num));
+            while (count)
+              { // DONE is only set once the transmit FIFO has emptied so a
+              // whole FIFO's worth can be written without checking TXD
+                std::size_t burst{ regs->get_transfer_done()
+                                 ? std::min(count, fifo_depth)
+                                 : regs->get_tx_fifo_not_full() ? 1U : 0U
+                                 };
+                if (!burst)
+                  {
+                    counters.count(io_event::tx_fifo_full);
+                    break;
+                  }
+                count -= burst;
+                bytes_written += burst;
+                while (burst--)
+                  {
+                    regs->transmit_fifo_write(*pdata++);
+                  }
+              }
+          }
           break;
 
         default: // spi0_mode::none and any weird values...
           break;
         };
+      counters.count(io_event::bytes_written, bytes_written);
       return bytes_written;
     }
 
@@ -294,20 +451,23 @@ namespace dibase { namespace rpi {
           return false;
         }
       
-      if (spi0_ctrl::instance().regs->get_rx_fifo_not_empty())
+      if (spi_regs(spi_num)->get_rx_fifo_not_empty())
         {
-          data = spi0_ctrl::instance().regs->receive_fifo_read();
+          data = spi_regs(spi_num)->receive_fifo_read();
+          counters.count(io_event::bytes_read);
           return true;
         }
       else
-        {// When in bi-directional mode start a read if there is no data in
+        {
+          counters.count(io_event::rx_fifo_empty);
+        // When in bi-directional mode start a read if there is no data in
         // the receive buffer by setting Read Enable true and writing junk
         // to the FIFO register. The data should appear in the receive FIFO
         // some time later.
           if (mode==spi0_mode::bidirectional)
             {
-              spi0_ctrl::instance().regs->set_read_enable(true);
-              spi0_ctrl::instance().regs->transmit_fifo_write(data);
+              spi_regs(spi_num)->set_read_enable(true);
+              spi_regs(spi_num)->transmit_fifo_write(data);
             }
           return false;
         }
@@ -325,11 +485,28 @@ namespace dibase { namespace rpi {
           return bytes_read;
         }
       
-      while (count-- && spi0_ctrl::instance().regs->get_rx_fifo_not_empty())
-        {
-          *pdata++ = spi0_ctrl::instance().regs->receive_fifo_read();
-          ++bytes_read;
+      auto & regs(spi_regs(spi_num));
+      while (count)
+        { // RXR is only set while the receive FIFO holds at least
+        // rx_fifo_needs_reading_count bytes so they can be read without
+        // checking RXD
+          std::size_t burst{ regs->get_rx_fifo_needs_reading()
+                           ? std::min(count, rx_fifo_needs_reading_count)
+                           : regs->get_rx_fifo_not_empty() ? 1U : 0U
+                           };
+          if (!burst)
+            {
+              counters.count(io_event::rx_fifo_empty);
+              break;
+            }
+          count -= burst;
+          bytes_read += burst;
+          while (burst--)
+            {
+              *pdata++ = regs->receive_fifo_read();
+            }
         }
+      counters.count(io_event::bytes_read, bytes_read);
 
     // When in bi-directional mode if not all requested bytes could be read
     // queue up to remaining count reads by setting Read Enable true and
@@ -337,12 +514,11 @@ namespace dibase { namespace rpi {
     // FIFO some time later.
       if (mode==spi0_mode::bidirectional)
         {
-          ++count; // undo last read-loop iteration post decrement
           std::size_t pending_count{0U};
-          spi0_ctrl::instance().regs->set_read_enable(true);
-          while (count-- && spi0_ctrl::instance().regs->get_tx_fifo_not_full())
+          spi_regs(spi_num)->set_read_enable(true);
+          while (count-- && spi_regs(spi_num)->get_tx_fifo_not_full())
             {
-              spi0_ctrl::instance().regs->transmit_fifo_write(*pdata);
+              spi_regs(spi_num)->transmit_fifo_write(*pdata);
               ++pending_count;
             }
           if (ppending_count)
@@ -353,6 +529,243 @@ namespace dibase { namespace rpi {
       return bytes_read;
     }
 
+    std::size_t spi0_pins::transfer
+    ( std::uint8_t const * ptx
+    , std::uint8_t * prx
+    , std::size_t count
+    )
+    {
+      spi0_iovec const iov{ptx, prx, count};
+      return transfer_iov(&iov, 1U);
+    }
+
+    namespace
+    {
+    // Transfer bytes to and from a sequence of buffers, optionally ignoring
+    // the buffers' rx members. Limits bytes in flight to the FIFO depth so
+    // received bytes always have space in the receive FIFO. If pdeadline_us
+    // is not null gives up once the system timer passes it while waiting,
+    // returning fewer bytes than the buffers' total.
+      std::size_t transfer_buffers
+      ( spi0_ctrl::reg_ptr & regs
+      , spi0_iovec const * iov
+      , std::size_t iov_count
+      , bool receive
+      , wait_policy const & waiting
+      , wait_stats & wait_counts
+      , io_counter_set & counters
+      , std::uint64_t const * pdeadline_us = nullptr
+      )
+      {
+        internal::trace_scope trace{"spi0_pins transfer"};
+        std::size_t total{0U};
+        for (std::size_t idx=0; idx!=iov_count; ++idx)
+          {
+            total += iov[idx].count;
+          }
+        spi0_iovec const * tx_iov{iov};
+        spi0_iovec const * rx_iov{iov};
+        std::size_t tx_offset{0U};
+        std::size_t rx_offset{0U};
+        std::size_t bytes_written{0U};
+        std::size_t bytes_read{0U};
+        adaptive_wait waiter(waiting, wait_counts);
+        while (bytes_read!=total)
+          {
+            std::size_t const progress{bytes_written+bytes_read};
+            while ( bytes_written!=total
+                 && bytes_written-bytes_read<fifo_depth
+                 && regs->get_tx_fifo_not_full()
+                  )
+              {
+                while (tx_offset==tx_iov->count)
+                  {
+                    ++tx_iov;
+                    tx_offset = 0U;
+                  }
+                regs->transmit_fifo_write(tx_iov->tx ? tx_iov->tx[tx_offset]
+                                                     : 0U
+                                         );
+                ++tx_offset;
+                ++bytes_written;
+              }
+            while (bytes_read!=bytes_written && regs->get_rx_fifo_not_empty())
+              {
+                std::uint8_t const data(regs->receive_fifo_read());
+                while (rx_offset==rx_iov->count)
+                  {
+                    ++rx_iov;
+                    rx_offset = 0U;
+                  }
+                if (receive && rx_iov->rx)
+                  {
+                    rx_iov->rx[rx_offset] = data;
+                  }
+                ++rx_offset;
+                ++bytes_read;
+              }
+          // Wait while neither FIFO can make progress
+            if (bytes_written+bytes_read==progress)
+              {
+                if (pdeadline_us && system_timer::now_us()>=*pdeadline_us)
+                  {
+                    counters.count(io_event::timeouts);
+                    break;
+                  }
+                counters.count(io_event::wait_polls);
+                waiter.pause();
+              }
+            else
+              {
+                waiter.restart();
+              }
+          }
+        counters.count(io_event::bytes_written, bytes_written);
+        counters.count(io_event::bytes_read, bytes_read);
+        return bytes_read;
+      }
+    }
+
+    std::size_t spi0_pins::transfer_iov
+    ( spi0_iovec const * iov
+    , std::size_t iov_count
+    )
+    {
+      return mode==spi0_mode::standard
+           ? transfer_buffers( spi_regs(spi_num)
+                             , iov, iov_count, true
+                             , waiting, wait_counts, counters
+                             )
+           : 0U;
+    }
+
+    std::size_t spi0_pins::write_gather
+    ( spi0_iovec const * iov
+    , std::size_t iov_count
+    )
+    {
+      return mode==spi0_mode::standard
+           ? transfer_buffers( spi_regs(spi_num)
+                             , iov, iov_count, false
+                             , waiting, wait_counts, counters
+                             )
+           : 0U;
+    }
+
+    namespace
+    {
+      std::uint64_t deadline_after(system_timer::duration timeout)
+      {
+        return system_timer::now_us()
+             + static_cast<std::uint64_t>
+                        (std::max<system_timer::rep>(timeout.count(), 0));
+      }
+    }
+
+    spi0_io_result spi0_pins::write_all
+    ( std::uint8_t const * pdata
+    , std::size_t count
+    , system_timer::duration timeout
+    )
+    {
+      if ( mode==spi0_mode::none || (lossi_long_words && count%4U!=0U) )
+        {
+          return {0U, spi0_io_status::not_supported};
+        }
+      std::uint64_t const deadline_us{deadline_after(timeout)};
+      if (mode==spi0_mode::standard)
+        {
+          spi0_iovec const iov{pdata, nullptr, count};
+          std::size_t const sent{transfer_buffers( spi_regs(spi_num)
+                                                 , &iov, 1U, false
+                                                 , waiting, wait_counts
+                                                 , counters, &deadline_us
+                                                 )};
+          return {sent, sent==count ? spi0_io_status::complete
+                                    : spi0_io_status::timed_out};
+        }
+      internal::trace_scope trace{"spi0_pins write_all"};
+      auto & regs(spi_regs(spi_num));
+      std::size_t written{0U};
+      adaptive_wait waiter(waiting, wait_counts);
+      for (;;)
+        {
+          std::size_t const burst{ written==count ? 0U
+                                 : write(pdata+written, count-written)
+                                 };
+          written += burst;
+          if (written==count && regs->get_transfer_done())
+            {
+              return {written, spi0_io_status::complete};
+            }
+          if (burst==0U)
+            {
+              if (system_timer::now_us()>=deadline_us)
+                {
+                  counters.count(io_event::timeouts);
+                  return {written, spi0_io_status::timed_out};
+                }
+              counters.count(io_event::wait_polls);
+              waiter.pause();
+            }
+          else
+            {
+              waiter.restart();
+            }
+        }
+    }
+
+    spi0_io_result spi0_pins::read_all
+    ( std::uint8_t * pdata
+    , std::size_t count
+    , system_timer::duration timeout
+    )
+    {
+      if (mode==spi0_mode::none)
+        {
+          return {0U, spi0_io_status::not_supported};
+        }
+      std::uint64_t const deadline_us{deadline_after(timeout)};
+      if (mode!=spi0_mode::lossi)
+        { // Standard and bidirectional reads are clocked in by writes
+          if (mode==spi0_mode::bidirectional)
+            {
+              spi_regs(spi_num)->set_read_enable(true);
+            }
+          spi0_iovec const iov{nullptr, pdata, count};
+          std::size_t const received{transfer_buffers( spi_regs(spi_num)
+                                                     , &iov, 1U, true
+                                                     , waiting, wait_counts
+                                                     , counters, &deadline_us
+                                                     )};
+          return {received, received==count ? spi0_io_status::complete
+                                            : spi0_io_status::timed_out};
+        }
+      internal::trace_scope trace{"spi0_pins read_all"};
+      std::size_t received{0U};
+      adaptive_wait waiter(waiting, wait_counts);
+      while (received!=count)
+        {
+          std::size_t const burst{read(pdata+received, count-received)};
+          received += burst;
+          if (burst==0U)
+            {
+              if (system_timer::now_us()>=deadline_us)
+                {
+                  counters.count(io_event::timeouts);
+                  return {received, spi0_io_status::timed_out};
+                }
+              counters.count(io_event::wait_polls);
+              waiter.pause();
+            }
+          else
+            {
+              waiter.restart();
+            }
+        }
+      return {received, spi0_io_status::complete};
+    }
+
     spi0_slave_context::spi0_slave_context
     ( spi0_slave cs
     , hertz f
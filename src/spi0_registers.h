@@ -140,6 +140,17 @@ namespace dibase { namespace rpi {
         constexpr static physical_address_t 
                             physical_address = peripheral_base_address+0x204000;
 
+      /// @brief Physical address of start of BCM2711 only SPI3 control
+      /// registers, relative to the BCM2835 peripheral base address.
+      ///
+      /// SPI3 to SPI6 have the same register layout as SPI0 and follow it at
+      /// 0x200 byte intervals from this address.
+        constexpr static physical_address_t
+                      spi3_physical_address = peripheral_base_address+0x204600;
+
+      /// @brief Offset between the register blocks of SPI3 to SPI6
+        constexpr static physical_address_t bcm2711_spi_block_stride = 0x200;
+
         register_t  control_and_status; ///< SPI Master Control and Status, CS
         register_t  fifo;               ///< SPI Master TX and RX FIFOs, FIFO
         register_t  clock;              ///< SPI Master Clock Divider, CLK
@@ -582,6 +593,20 @@ namespace dibase { namespace rpi {
           fifo = fifo_lossi_data_bit | data;
         }
 
+      /// @brief Write 32-bit word of four LoSSI data bytes to transmit FIFO
+      ///
+      /// @note
+      /// Only for LoSSI mode with DMA mode in LoSSI mode and long data words
+      /// enabled (get_lossi_dma_enable()==\c true and
+      /// get_lossi_long_word()==\c true). The four bytes are sent least
+      /// significant byte first, as for DMA writes of 32-bit words.
+      ///
+      /// @param[in] data   Four LoSSI data bytes to write to transmit FIFO.
+        void transmit_fifo_long_write(std::uint32_t data) volatile
+        {
+          fifo = data;
+        }
+
       /// @brief Read 8-bit byte from receive FIFO
       ///
       /// @note
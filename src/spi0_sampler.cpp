@@ -0,0 +1,182 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file spi0_sampler.cpp
+/// @brief SPI0 fixed rate sampler implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "spi0_sampler.h"
+#include "spi0_ctrl.h"
+#include "system_timer.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <system_error>
+#include <pthread.h>
+#include <sched.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace
+    {
+    // Waits for the next sample time longer than this sleep for all but this
+    // long then busy-wait the remainder, so the thread only occupies a CPU
+    // continuously at higher sample rates.
+      std::uint64_t const busy_wait_us{200U};
+
+      std::uint64_t const ns_per_us{1000U};
+      std::uint64_t const ns_per_s{1000000000U};
+    }
+
+    int const spi0_sampler::any_cpu;
+
+    spi0_sampler::spi0_sampler
+    ( spi0_pins & sp
+    , spi0_slave_context const & c
+    , std::initializer_list<std::uint8_t> cmd
+    , hertz rate
+    , std::size_t capacity
+    , int cpu
+    )
+    : pins(sp)
+    , context(c)
+    , command_size{cmd.size()}
+    , period_ns{rate.count()==0U ? 0U : ns_per_s/rate.count()}
+    , ring{capacity}
+    , overrun_count{0U}
+    , late_count{0U}
+    , stopping{false}
+    , sampler_failed{false}
+    {
+      if (!pins.has_std_mode_support())
+        {
+          throw std::invalid_argument{"spi0_sampler::spi0_sampler: 3-wire SPI "
+                                      "standard mode not supported as the MISO "
+                                      "line has not been allocated to a GPIO "
+                                      "pin."};
+        }
+      if (context.mode!=spi0_mode::standard)
+        {
+          throw std::invalid_argument{"spi0_sampler::spi0_sampler: slave "
+                                      "context is not for standard mode."};
+        }
+      if (command_size==0U || command_size>command.size())
+        {
+          throw std::invalid_argument{"spi0_sampler::spi0_sampler: command "
+                                      "must have from 1 to 4 bytes."};
+        }
+      if (period_ns==0U)
+        {
+          throw std::invalid_argument{"spi0_sampler::spi0_sampler: sample "
+                                      "rate not in the range [1Hz, 1GHz]."};
+        }
+      std::copy(cmd.begin(), cmd.end(), command.begin());
+      pins.stop_conversing();
+      sampler = std::thread{&spi0_sampler::take_samples, this};
+      if (cpu!=any_cpu)
+        {
+          cpu_set_t cpus;
+          CPU_ZERO(&cpus);
+          CPU_SET(cpu, &cpus);
+          int const rv{::pthread_setaffinity_np( sampler.native_handle()
+                                               , sizeof(cpus), &cpus
+                                               )};
+          if (rv!=0)
+            {
+              stopping.store(true, std::memory_order_release);
+              sampler.join();
+              pins.stop_conversing();
+              throw std::system_error
+                    ( rv
+                    , std::system_category()
+                    , "spi0_sampler: setting sampling thread CPU affinity "
+                      "failed with error from call to pthread_setaffinity_np."
+                    );
+            }
+        }
+    }
+
+    spi0_sampler::~spi0_sampler()
+    {
+      stopping.store(true, std::memory_order_release);
+      sampler.join();
+      pins.stop_conversing();
+    }
+
+    void spi0_sampler::take_samples()
+    {
+      try
+        {
+          auto & regs(internal::spi0_ctrl::instance()
+                                              .regs_of(pins.spi()));
+          pins.start_conversing(context);
+        // Only assert chip select during each sample's transfer
+          regs->set_transfer_active(false);
+          std::array<std::uint8_t, 4U> response;
+          std::uint64_t next_ns{system_timer::now_us()*ns_per_us};
+          while (!stopping.load(std::memory_order_acquire))
+            {
+              std::uint64_t const now_us{system_timer::now_us()};
+              std::uint64_t const now_ns{now_us*ns_per_us};
+              if (now_ns<next_ns)
+                {
+                  std::uint64_t const wait_us{(next_ns-now_ns)/ns_per_us};
+                  if (wait_us>busy_wait_us)
+                    {
+                      std::this_thread::sleep_for
+                              (std::chrono::microseconds(wait_us-busy_wait_us));
+                    }
+                  continue;
+                }
+              std::uint64_t const missed{(now_ns-next_ns)/period_ns};
+              if (missed!=0U)
+                {
+                  late_count.fetch_add(missed, std::memory_order_relaxed);
+                  next_ns += missed*period_ns;
+                }
+              next_ns += period_ns;
+              regs->set_transfer_active(true);
+              std::size_t const count{pins.transfer( command.data()
+                                                   , response.data()
+                                                   , command_size
+                                                   )};
+              regs->set_transfer_active(false);
+              if (count!=command_size)
+                {
+                  throw std::runtime_error{"spi0_sampler: transfer did not "
+                                           "complete."};
+                }
+              spi0_sample sample{now_us, 0U};
+              for (std::size_t idx=0; idx!=command_size; ++idx)
+                {
+                  sample.value = (sample.value<<8) | response[idx];
+                }
+              if (!ring.try_push(sample))
+                {
+                  overrun_count.fetch_add(1U, std::memory_order_relaxed);
+                }
+            }
+        }
+      catch (...)
+        {
+          sampler_error = std::current_exception();
+          sampler_failed.store(true, std::memory_order_release);
+        }
+    }
+
+    std::size_t spi0_sampler::pop
+    ( spi0_sample * samples
+    , std::size_t max_samples
+    )
+    {
+      std::size_t const count{ring.pop(samples, max_samples)};
+      if (count==0U && max_samples!=0U
+       && sampler_failed.load(std::memory_order_acquire) && ring.empty())
+        {
+          std::rethrow_exception(sampler_error);
+        }
+      return count;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
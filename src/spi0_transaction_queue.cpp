@@ -0,0 +1,115 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file spi0_transaction_queue.cpp
+/// @brief SPI0 transaction queue implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "spi0_transaction_queue.h"
+#include "spi0_ctrl.h"
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    spi0_transaction_queue::spi0_transaction_queue(spi0_pins & sp)
+    : pins(sp)
+    , stopping{false}
+    {
+      if (!pins.has_std_mode_support())
+        {
+          throw std::invalid_argument{"spi0_transaction_queue::"
+                                      "spi0_transaction_queue: 3-wire SPI "
+                                      "standard mode not supported as the MISO "
+                                      "line has not been allocated to a GPIO "
+                                      "pin."};
+        }
+      pins.stop_conversing();
+      worker = std::thread{&spi0_transaction_queue::run_jobs, this};
+    }
+
+    spi0_transaction_queue::~spi0_transaction_queue()
+    {
+      {
+        std::lock_guard<std::mutex> lock{guard};
+        stopping = true;
+      }
+      job_available.notify_one();
+      worker.join();
+      pins.stop_conversing();
+    }
+
+    std::future<std::vector<std::uint8_t>> spi0_transaction_queue::submit
+    ( spi0_slave_context const & c
+    , std::vector<std::uint8_t> tx
+    )
+    {
+      if (c.mode!=spi0_mode::standard)
+        {
+          throw std::invalid_argument{"spi0_transaction_queue::submit: slave "
+                                      "context is not for standard mode."};
+        }
+      if (tx.empty())
+        {
+          throw std::invalid_argument{"spi0_transaction_queue::submit: no "
+                                      "bytes to transmit."};
+        }
+      job j{&c, std::move(tx), std::promise<std::vector<std::uint8_t>>{}};
+      std::future<std::vector<std::uint8_t>> result{j.result.get_future()};
+      {
+        std::lock_guard<std::mutex> lock{guard};
+        jobs.push_back(std::move(j));
+      }
+      job_available.notify_one();
+      return result;
+    }
+
+    void spi0_transaction_queue::run_jobs()
+    {
+      auto & regs(internal::spi0_ctrl::instance().regs_of(pins.spi()));
+      spi0_slave_context const * current{nullptr};
+      for (;;)
+        {
+          job j;
+          {
+            std::unique_lock<std::mutex> lock{guard};
+            job_available.wait(lock, [this]{return stopping||!jobs.empty();});
+            if (jobs.empty())
+              {
+                return;
+              }
+            j = std::move(jobs.front());
+            jobs.pop_front();
+          }
+          try
+            {
+              if (j.context!=current)
+                {
+                  pins.start_conversing(*j.context);
+                  current = j.context;
+                }
+              else
+                {
+                  regs->set_transfer_active(true);
+                }
+              std::vector<std::uint8_t> rx(j.tx.size());
+              std::size_t const count
+                            {pins.transfer(j.tx.data(), rx.data(), rx.size())};
+            // End transaction, deasserting chip select, keeping the context
+              regs->set_transfer_active(false);
+              if (count!=rx.size())
+                {
+                  throw std::runtime_error{"spi0_transaction_queue: transfer "
+                                           "did not complete."};
+                }
+              j.result.set_value(std::move(rx));
+            }
+          catch (...)
+            {
+              current = nullptr;
+              j.result.set_exception(std::current_exception());
+            }
+        }
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,111 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file start_group.cpp
+/// @brief PWM channel and clock group start implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "start_group.h"
+#include "pwm_ctrl.h"
+#include "clock_ctrl.h"
+#include "peripheral_barrier.h"
+#include <algorithm>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using namespace internal;
+
+    start_group::start_group()
+    : pwm_enables{0U}
+    , clocks{}
+    , clock_count{0U}
+    , skews{nullptr}
+    {}
+
+    void start_group::add(pwm_pin const & p)
+    {
+      register_t const enable
+        {pwm_registers::enable_mask(static_cast<pwm_channel>(p.pwm))};
+      if (pwm_enables&enable)
+        {
+          throw std::invalid_argument{"start_group::add: PWM channel is "
+                                      "already in the group."};
+        }
+      pwm_enables |= enable;
+    }
+
+    void start_group::add(clock_pin const & c)
+    {
+      auto const end(clocks.begin()+clock_count);
+      if (std::find(clocks.begin(), end, c.clk)!=end)
+        {
+          throw std::invalid_argument{"start_group::add: clock is already in "
+                                      "the group."};
+        }
+      clocks[clock_count++] = c.clk; // only GPCLK0..2 have clock_pins
+    }
+
+    std::chrono::nanoseconds start_group::start()
+    {
+      using std::chrono::steady_clock;
+
+    // Calculate every control register value before the first write so the
+    // enable writes follow each other with no reads in between
+      auto & clk_regs(clock_ctrl::instance().regs);
+      register_t volatile * clk_controls[max_clocks];
+      register_t clk_values[max_clocks];
+      for (std::size_t n=0U; n!=clock_count; ++n)
+        {
+          clock_record volatile & clk(clk_regs.get()->*index_to_clock_id
+                                                                 (clocks[n]));
+          if (clk.is_busy() && !clk.get_enable())
+            {
+              throw std::logic_error{"start_group::start: clock is busy."};
+            }
+          clk_controls[n] = &clk.control;
+          clk_values[n] = clk.enable_value();
+        }
+      peripheral_barrier();
+      auto & pwm_regs(pwm_ctrl::instance().regs);
+      register_t const pwm_control{pwm_regs->control|pwm_enables};
+
+      auto const begin(steady_clock::now());
+      if (pwm_enables)
+        {
+          pwm_regs->control = pwm_control;
+        }
+      peripheral_barrier();
+      for (std::size_t n=0U; n!=clock_count; ++n)
+        {
+          *clk_controls[n] = clk_values[n];
+        }
+      auto const end(steady_clock::now());
+      peripheral_barrier();
+
+      std::chrono::nanoseconds const skew
+        {std::chrono::duration_cast<std::chrono::nanoseconds>(end-begin)};
+      if (skews)
+        {
+          skews->record(skew);
+        }
+      return skew;
+    }
+
+    void start_group::stop()
+    {
+      if (pwm_enables)
+        {
+          auto & pwm_regs(pwm_ctrl::instance().regs);
+          pwm_regs->control = pwm_regs->control & ~pwm_enables;
+        }
+      peripheral_barrier();
+      auto & clk_regs(clock_ctrl::instance().regs);
+      for (std::size_t n=0U; n!=clock_count; ++n)
+        {
+          clk_regs->set_enable(index_to_clock_id(clocks[n]), false);
+        }
+      peripheral_barrier();
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -2,17 +2,23 @@
 /// @file sysfs.cpp 
 /// @brief Linux sys filesystem utilities.
 ///
+/// Paths and values are formatted into fixed size buffers on the stack and
+/// written with write so no dynamic memory is used. The GPIO export and
+/// unexport files are opened on first use and kept open for the lifetime of
+/// the process.
 ///
 /// @copyright Copyright (c) Dibase Limited 2013
 /// @author Ralph E. McArdell
 
 #include "sysfs.h"
-#include <string>
-#include <fstream>
+#include <cerrno>
+#include <cstring>
+#include <ios>
 #include <stdexcept>
 #include <system_error>
 #include <unistd.h>
 #include <fcntl.h>
+#include <dirent.h>
 
 namespace dibase { namespace rpi {
   namespace peripherals
@@ -23,43 +29,134 @@ namespace dibase { namespace rpi {
       {
         char const * gpio_export_pathname{"/sys/class/gpio/export"};
         char const * gpio_unexport_pathname{"/sys/class/gpio/unexport"};
+        char const * gpio_dirname{"/sys/class/gpio"};
         char const * gpio_pin_dir_basename{"/sys/class/gpio/gpio"};
-        char const * gpio_pin_edgemode_filename{"edge"};
-        char const * gpio_pin_value_filename{"value"};
-        
-        static std::string make_gpio_pin_dir_pathname(pin_id pin)
+        char const * gpio_pin_dir_prefix{"gpio"};
+        char const * gpio_pin_edgemode_filename{"/edge"};
+        char const * gpio_pin_value_filename{"/value"};
+
+      // Large enough for the pin directory path plus "/value" or "/edge"
+        constexpr std::size_t max_pathname_length{48U};
+
+      // Large enough for any pin id value in decimal
+        constexpr std::size_t max_pin_id_length{4U};
+
+      // Write pin's decimal value to buffer without terminating it.
+      // Returns number of characters written.
+        std::size_t format_pin_id(pin_id pin, char * buffer)
         {
-          std::string path{gpio_pin_dir_basename};
-          path += std::to_string(pin);
-          return path;
+          pin_id_int_t value{pin};
+          char digits[max_pin_id_length];
+          std::size_t count{0U};
+          do
+            {
+              digits[count++] = static_cast<char>('0'+value%10U);
+              value /= 10U;
+            }
+          while (value!=0U);
+          for (std::size_t idx=0U; idx!=count; ++idx)
+            {
+              buffer[idx] = digits[count-1U-idx];
+            }
+          return count;
         }
 
-        static bool write_pin_id_to_file( pin_id pin, char const * path)
+      // Write null terminated pathname of pin directory or, if filename is
+      // not null, a file in it.
+        void format_gpio_pin_pathname
+        ( pin_id pin
+        , char const * filename
+        , char (&pathname)[max_pathname_length]
+        )
+        {
+          std::size_t length{std::strlen(gpio_pin_dir_basename)};
+          std::memcpy(pathname, gpio_pin_dir_basename, length);
+          length += format_pin_id(pin, pathname+length);
+          pathname[length] = '\0';
+          if (filename)
+            {
+              std::strcat(pathname, filename);
+            }
+        }
+
+      // Lazily opened process lifetime file descriptors for the export and
+      // unexport files. Function local static so initialisation is thread
+      // safe and happens only when first needed.
+        struct gpio_control_files
+        {
+          int const export_fd;
+          int const unexport_fd;
+
+          gpio_control_files()
+          : export_fd{::open(gpio_export_pathname, O_WRONLY|O_CLOEXEC)}
+          , unexport_fd{::open(gpio_unexport_pathname, O_WRONLY|O_CLOEXEC)}
+          {}
+
+          ~gpio_control_files()
+          {
+            if (export_fd!=-1)
+              {
+                ::close(export_fd);
+              }
+            if (unexport_fd!=-1)
+              {
+                ::close(unexport_fd);
+              }
+          }
+
+          gpio_control_files(gpio_control_files const &) = delete;
+          gpio_control_files & operator=(gpio_control_files const &) = delete;
+
+          static gpio_control_files const & instance()
+          {
+            static gpio_control_files files;
+            return files;
+          }
+        };
+
+      // Write pin value to a sys filesystem GPIO control file. A write that
+      // fails with ignore_errno is treated as success: the kernel reports
+      // exporting an exported pin and unexporting an unexported pin as
+      // errors but the requested state is in effect.
+        bool write_pin_id_to_fd(pin_id pin, int fd, int ignore_errno)
         {
-          std::ofstream pin_id_stream(path);
-          if (pin_id_stream.is_open())
+          if (fd==-1)
+            {
+              return false;
+            }
+          char value[max_pin_id_length];
+          std::size_t const length{format_pin_id(pin, value)};
+          ssize_t const written{::write(fd, value, length)};
+          if (written==-1)
             {
-              pin_id_stream << pin;
-              return  pin_id_stream.good();
+              return errno==ignore_errno;
             }
-          return false;
+          return static_cast<std::size_t>(written)==length;
         }
 
-        std::string event_mode_to_edge_file_string(edge_event_mode mode)
+        char const * event_mode_to_edge_file_string(edge_event_mode mode)
         {
           switch (mode)
           {
           case edge_event_mode::rising:   return "rising";
           case edge_event_mode::falling:  return "falling";
           case edge_event_mode::both:     return "both";
-          default: return "";
+          default: return nullptr;
           };
         }
       }
 
+      bool open_gpio_control_files()
+      {
+        gpio_control_files const & files(gpio_control_files::instance());
+        return files.export_fd!=-1 && files.unexport_fd!=-1;
+      }
+
       bool is_exported(pin_id pin)
       {
-        bool in_use{access(make_gpio_pin_dir_pathname(pin).c_str(), F_OK)==0};
+        char pathname[max_pathname_length];
+        format_gpio_pin_pathname(pin, nullptr, pathname);
+        bool in_use{access(pathname, F_OK)==0};
         if (!in_use&&errno!=ENOENT)
           {
             throw std::system_error
@@ -72,39 +169,113 @@ namespace dibase { namespace rpi {
         return in_use;
       }
 
+      std::uint64_t exported_pins()
+      {
+        DIR * dir{::opendir(gpio_dirname)};
+        if (!dir)
+          {
+            if (errno==ENOENT)
+              {
+                return 0U;
+              }
+            throw std::system_error
+                  ( errno
+                  , std::system_category()
+                  , "Open of sys filesystem GPIO directory failed: unexpected "
+                    "error from call to opendir."
+                  );
+          }
+        std::size_t const prefix_length{std::strlen(gpio_pin_dir_prefix)};
+        std::uint64_t exported{0U};
+        while (dirent const * entry{::readdir(dir)})
+          {
+          // Pin directories are gpioN; skip gpiochipN and other entries
+            char const * name{entry->d_name};
+            if (std::strncmp(name, gpio_pin_dir_prefix, prefix_length)!=0)
+              {
+                continue;
+              }
+            name += prefix_length;
+            pin_id_int_t value{0U};
+            std::size_t digits{0U};
+            for (; name[digits]>='0' && name[digits]<='9'; ++digits)
+              {
+                value = value*10U + static_cast<pin_id_int_t>(name[digits]-'0');
+              }
+            if ( digits!=0U && digits<=max_pin_id_length
+              && name[digits]=='\0' && value<pin_id::number_of_pins
+               )
+              {
+                exported |= std::uint64_t{1}<<value;
+              }
+          }
+        ::closedir(dir);
+        return exported;
+      }
+
       bool export_pin(pin_id pin)
       {
-        return write_pin_id_to_file(pin, gpio_export_pathname);
+        return write_pin_id_to_fd
+                ( pin, gpio_control_files::instance().export_fd, EBUSY );
       }
 
       bool unexport_pin(pin_id pin)
       {
-        return write_pin_id_to_file(pin, gpio_unexport_pathname);
+        return write_pin_id_to_fd
+                ( pin, gpio_control_files::instance().unexport_fd, EINVAL );
+      }
+
+      std::size_t export_pins(pin_id const * pins, std::size_t count)
+      {
+        int const fd{gpio_control_files::instance().export_fd};
+        std::size_t exported{0U};
+        while (exported!=count && write_pin_id_to_fd(pins[exported], fd, EBUSY))
+          {
+            ++exported;
+          }
+        return exported;
+      }
+
+      std::size_t unexport_pins(pin_id const * pins, std::size_t count)
+      {
+        int const fd{gpio_control_files::instance().unexport_fd};
+        std::size_t unexported{0U};
+        for (std::size_t idx=0U; idx!=count; ++idx)
+          {
+            if (write_pin_id_to_fd(pins[idx], fd, EINVAL))
+              {
+                ++unexported;
+              }
+          }
+        return unexported;
       }
 
       int open_ipin_for_edge_events(pin_id pin, edge_event_mode mode)
       {
-        std::string pin_path{make_gpio_pin_dir_pathname(pin)};
-        pin_path += '/';
+        char const * edge_file_value{event_mode_to_edge_file_string(mode)};
+        if (!edge_file_value)
+          {
+            throw std::invalid_argument{"Bad edge_event_mode value."};
+          }
+        char pathname[max_pathname_length];
+        format_gpio_pin_pathname(pin, gpio_pin_edgemode_filename, pathname);
         {
-          std::fstream edgestream
-                        {pin_path+gpio_pin_edgemode_filename, std::ios::out};
-          if (edgestream.is_open())
+          int edge_fd{::open(pathname, O_WRONLY|O_CLOEXEC)};
+          if (edge_fd==-1)
             {
-              edgestream.exceptions(std::ios::badbit|std::ios::failbit);
-              auto edge_file_value(event_mode_to_edge_file_string(mode));
-              if (edge_file_value.empty())
-                {
-                  throw std::invalid_argument{"Bad edge_event_mode value."};
-                }
-              edgestream << edge_file_value;
+              throw std::runtime_error{"Open failed for pin sys fs edge file."};
             }
-          else
+          std::size_t const length{std::strlen(edge_file_value)};
+          ssize_t const written{::write(edge_fd, edge_file_value, length)};
+          ::close(edge_fd);
+          if (written==-1 || static_cast<std::size_t>(written)!=length)
             {
-              throw std::runtime_error{"Open failed for pin sys fs edge file."};
+              throw std::ios_base::failure
+                    {"Write failed for pin sys fs edge file."};
             }
         }
-        int fd{::open((pin_path+gpio_pin_value_filename).c_str(), O_RDONLY)};
+        format_gpio_pin_pathname(pin, gpio_pin_value_filename, pathname);
+        int fd{::open(pathname, O_RDONLY)};
         if (fd==-1) 
           {
              throw std::system_error
@@ -123,4 +294,4 @@ namespace dibase { namespace rpi {
       }
     }
   }
-}} 
+}}
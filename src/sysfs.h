@@ -11,6 +11,8 @@
  #define DIBASE_RPI_PERIPHERALS_INTERNAL_SYSFS_H
 
  #include "pin_id.h"
+ #include <cstddef>
+ #include <cstdint>
 
 namespace dibase { namespace rpi {
   namespace peripherals
@@ -23,15 +25,50 @@ namespace dibase { namespace rpi {
     /// @throws std::system_error if unexpected errors from system calls.
       bool is_exported(pin_id pin);
 
+    /// @brief Find all GPIO pins exported in the sys file-system
+    ///
+    /// Reads the sys file-system GPIO directory once, rather than checking
+    /// each pin's directory in turn as is_exported does.
+    /// @returns Value with bit n set if GPIO pin n is exported.
+    /// @throws std::system_error if unexpected errors from system calls.
+      std::uint64_t exported_pins();
+
     /// @brief Export a GPIO pin in the sys file-system
+    ///
+    /// Exporting a pin that is already exported succeeds.
     /// @param pin  Id of GPIO pin export
     /// @returns true on success, false on failure.
       bool export_pin(pin_id pin);
 
     /// @brief Unexport a GPIO pin from the sys file-system
+    ///
+    /// Unexporting a pin that is not exported succeeds.
     /// @param pin  Id of GPIO pin unexport
     /// @returns true on success, false on failure.
       bool unexport_pin(pin_id pin);
+
+    /// @brief Export a sequence of GPIO pins in the sys file-system
+    ///
+    /// Pins are exported in order, stopping at the first failure.
+    /// @param pins   Ids of GPIO pins to export
+    /// @param count  Number of pin ids in pins
+    /// @returns Number of pins exported: pins[0] to pins[returned value-1].
+      std::size_t export_pins(pin_id const * pins, std::size_t count);
+
+    /// @brief Unexport a sequence of GPIO pins from the sys file-system
+    ///
+    /// An attempt is made to unexport every pin even if some fail.
+    /// @param pins   Ids of GPIO pins to unexport
+    /// @param count  Number of pin ids in pins
+    /// @returns Number of pins successfully unexported.
+      std::size_t unexport_pins(pin_id const * pins, std::size_t count);
+
+    /// @brief Open the sys file-system GPIO export and unexport files
+    ///
+    /// The files are otherwise opened on the first export or unexport and
+    /// kept open for the life of the process.
+    /// @returns true if both files are open, false otherwise.
+      bool open_gpio_control_files();
     
     /// @brief Input pin edge event mode values used with sys file-system 
     /// utilities
@@ -0,0 +1,91 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file system_timer.cpp
+/// @brief System timer clock type implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "system_timer.h"
+#include "system_timer_ctrl.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using internal::system_timer_ctrl;
+
+    namespace
+    {
+      void spin(std::uint32_t loops)
+      {
+        for (std::uint32_t volatile count{loops}; count!=0U; count = count-1U)
+          {
+          }
+      }
+
+      std::uint32_t const ns_per_us{1000U};
+      std::uint32_t const ns_per_ms{1000000U};
+      std::uint32_t const us_per_ms{1000U};
+
+      std::uint64_t calibrate_spin_loops_per_ms()
+      { // Spin in small chunks until a millisecond has passed, so that
+        // calibration takes about as long on slow as on fast processors.
+        std::uint32_t const chunk_loops{1000U};
+        volatile internal::system_timer_registers const & regs
+                                    (*system_timer_ctrl::instance().regs);
+        std::uint64_t loops{0U};
+        std::uint32_t const start{regs.get_counter_low()};
+        std::uint32_t elapsed_us{0U};
+        do
+          {
+            spin(chunk_loops);
+            loops += chunk_loops;
+            elapsed_us = regs.get_counter_low()-start;
+          }
+        while ( elapsed_us<us_per_ms );
+        return (loops*us_per_ms)/elapsed_us;
+      }
+
+      std::uint64_t spin_loops_per_ms()
+      {
+        static std::uint64_t const loops_per_ms{calibrate_spin_loops_per_ms()};
+        return loops_per_ms;
+      }
+    }
+
+    constexpr bool system_timer::is_steady;
+
+    std::uint64_t system_timer::now_us()
+    {
+      return system_timer_ctrl::instance().regs->get_counter();
+    }
+
+    void system_timer::delay_us(std::uint32_t us)
+    {
+      if ( us==0U )
+        {
+          return;
+        }
+      volatile internal::system_timer_registers const & regs
+                                  (*system_timer_ctrl::instance().regs);
+      std::uint32_t const start{regs.get_counter_low()};
+      while ( regs.get_counter_low()-start <= us )
+        {
+        }
+    }
+
+    void system_timer::delay_ns(std::uint32_t ns)
+    {
+      if ( ns>=ns_per_us )
+        {
+          delay_us(ns/ns_per_us);
+        }
+      std::uint32_t const remainder_ns{ns%ns_per_us};
+      if ( remainder_ns!=0U )
+        {
+          spin( static_cast<std::uint32_t>
+                ((spin_loops_per_ms()*remainder_ns)/ns_per_ms)
+              );
+        }
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,28 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file system_timer_ctrl.cpp
+/// @brief Internal system timer control type implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "system_timer_ctrl.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      system_timer_ctrl::system_timer_ctrl()
+      : regs( peripheral_window::instance()
+            , system_timer_registers::physical_address
+            , register_block_size
+            )
+      {}
+
+      system_timer_ctrl & system_timer_ctrl::instance()
+      {
+        static system_timer_ctrl system_timer_control_area;
+        return system_timer_control_area;
+      }
+    }
+  }
+}}
@@ -0,0 +1,45 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file system_timer_ctrl.h
+/// @brief \b Internal : system timer control type definition.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_SYSTEM_TIMER_CTRL_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_SYSTEM_TIMER_CTRL_H
+
+# include "phymem_ptr.h"
+# include "system_timer_registers.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief System timer control type. There is only 1 (yes it's a
+    /// singleton!)
+    ///
+    /// Maps BCM2708/2835 system timer registers into the requisite physical
+    /// memory mapped area. The free running counter is read only and may be
+    /// shared by all users so no allocator is provided.
+      struct system_timer_ctrl
+      {
+      /// @brief Pointer to BCM2708 / BCM2835 system timer registers instance
+        phymem_ptr<volatile system_timer_registers>  regs;
+
+      /// @brief Singleton instance getter
+      /// @returns THE instance of the system timer control object.
+        static system_timer_ctrl & instance();
+
+      private:
+      /// @brief Construct: initialise regs with correct physical address & size 
+        system_timer_ctrl();
+
+        system_timer_ctrl(system_timer_ctrl const &) = delete;
+        system_timer_ctrl(system_timer_ctrl &&) = delete;
+        system_timer_ctrl & operator=(system_timer_ctrl const &) = delete;
+        system_timer_ctrl & operator=(system_timer_ctrl &&) = delete;
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_SYSTEM_TIMER_CTRL_H
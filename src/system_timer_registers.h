@@ -0,0 +1,77 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file system_timer_registers.h
+/// @brief \b Internal : low-level system timer registers type definition.
+///
+/// Refer to the
+/// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+/// Broadcom BCM2835 ARM Peripherals Datasheet</a> Chapter 12 System Timer for
+/// details.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_SYSTEM_TIMER_REGISTERS_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_SYSTEM_TIMER_REGISTERS_H
+
+# include "peridef.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Number of system timer compare registers
+      constexpr std::size_t number_of_system_timer_compares{4};
+
+    /// @brief Represents layout of system timer registers with operations.
+    ///
+    /// The system timer provides a free running 64-bit counter incremented
+    /// at 1MHz, split into two 32-bit registers, CLO and CHI, together with
+    /// four 32-bit compare registers, C0..C3, and a control/status register,
+    /// CS. Note that C0 and C2 are used by the GPU.
+    ///
+    /// See the
+    /// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+    /// Broadcom BCM2835 ARM Peripherals Datasheet</a> chapter 12 for details
+      struct system_timer_registers
+      {
+      /// @brief Physical address of start of BCM2835 system timer registers
+        constexpr static physical_address_t 
+                              physical_address = peripheral_base_address+0x3000;
+
+        register_t control_and_status;  ///< System timer control/status, CS
+        register_t counter_low;         ///< Counter lower 32 bits, CLO (RO)
+        register_t counter_high;        ///< Counter upper 32 bits, CHI (RO)
+        register_t compare[number_of_system_timer_compares];///< C0..C3 compares
+
+      /// @brief Returns the lower 32 bits of the counter
+      /// @returns Value of CLO, lower 32 bits of the 1MHz free running counter.
+        register_t get_counter_low() volatile const
+        {
+          return counter_low;
+        }
+
+      /// @brief Returns the full 64 bit counter value
+      ///
+      /// The two halves of the counter cannot be read atomically so the
+      /// upper half is read before and after the lower half and the lower half
+      /// re-read if the upper half changed in-between - in which case the
+      /// lower half was read around the time it wrapped.
+      ///
+      /// @returns 64-bit value of the 1MHz free running counter, CHI:CLO.
+        std::uint64_t get_counter() volatile const
+        {
+          register_t high{counter_high};
+          register_t low{counter_low};
+          register_t const high_again{counter_high};
+          if ( high!=high_again )
+            {
+              high = high_again;
+              low = counter_low;
+            }
+          return (static_cast<std::uint64_t>(high)<<register_width) | low;
+        }
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_SYSTEM_TIMER_REGISTERS_H
@@ -0,0 +1,135 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file aux_registers_unittests.cpp
+/// @brief Unit tests for low-level auxiliary peripherals registers types.
+///
+/// Refer to the Broadcom BCM2835 Peripherals Datasheet PDF file for details:
+///
+/// http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf
+///
+/// Chapter 2 Auxiliaries
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "aux_registers.h"
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef std::uint32_t RegisterType;
+
+// Register byte offsets within one SPI master's registers, corrected as per
+// the datasheet errata
+enum RegisterOffsets
+{ CNTL0_OFFSET=0x00, CNTL1_OFFSET=0x04, STAT_OFFSET=0x08, PEEK_OFFSET=0x0c
+, IO_OFFSET=0x20, TXHOLD_OFFSET=0x30
+};
+
+static_assert( aux_registers::physical_address==0x20215000
+             , "Unexpected auxiliary registers physical address"
+             );
+static_assert( aux_spi_registers::speed_for(2U)==0U
+            && aux_spi_registers::speed_for(250U)==124U
+            && aux_spi_registers::speed_for(8192U)==aux_spi_registers::speed_max
+             , "Unexpected speed_for value for in-range ratio"
+             );
+static_assert( aux_spi_registers::speed_for(1U)>aux_spi_registers::speed_max
+            && aux_spi_registers::speed_for(8194U)>aux_spi_registers::speed_max
+             , "Expected speed_for value for out-of-range ratio > speed_max"
+             );
+static_assert( aux_spi_registers::chip_select_field(0U)==(6U<<17)
+            && aux_spi_registers::chip_select_field(1U)==(5U<<17)
+            && aux_spi_registers::chip_select_field(2U)==(3U<<17)
+             , "Unexpected chip_select_field value"
+             );
+static_assert( aux_spi_registers::fifo_entry(0xA5U, 8U)==0x08A50000U
+            && aux_spi_registers::fifo_entry(0x123456U, 24U)==0x18123456U
+            && aux_spi_registers::fifo_entry(0x1FFU, 9U)==0x09FF8000U
+            && aux_spi_registers::fifo_entry(0x3U, 1U)==0x01800000U
+             , "Unexpected fifo_entry value"
+             );
+
+TEST_CASE( "Unit-tests/aux_registers/0000/field offsets"
+         , "Auxiliary registers should have the expected sizes and offsets"
+         )
+{
+  CHECK( sizeof(aux_spi_registers)==0x40U );
+  CHECK( offsetof(aux_registers, enables)==0x04U );
+  CHECK( offsetof(aux_registers, spi)==0x80U );
+  CHECK( sizeof(aux_registers)==0x100U );
+  aux_spi_registers spi_regs;
+  std::memset(&spi_regs, 0xFF, sizeof(spi_regs));
+  unsigned char * base(reinterpret_cast<unsigned char *>(&spi_regs));
+  spi_regs.control0 = CNTL0_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(base[CNTL0_OFFSET])==CNTL0_OFFSET );
+  spi_regs.control1 = CNTL1_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(base[CNTL1_OFFSET])==CNTL1_OFFSET );
+  spi_regs.status = STAT_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(base[STAT_OFFSET])==STAT_OFFSET );
+  spi_regs.peek = PEEK_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(base[PEEK_OFFSET])==PEEK_OFFSET );
+  spi_regs.io[0] = IO_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(base[IO_OFFSET])==IO_OFFSET );
+  spi_regs.tx_hold[0] = TXHOLD_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(base[TXHOLD_OFFSET])==TXHOLD_OFFSET );
+}
+
+TEST_CASE( "Unit-tests/aux_registers/0010/set_spi_enable & get_spi_enable"
+         , "Enabling and disabling a SPI master changes only its enable bit"
+         )
+{
+  aux_registers regs;
+  std::memset(&regs, 0, sizeof(regs));
+  regs.enables = aux_registers::enable_mini_uart;
+  regs.set_spi_enable(0U, true);
+  CHECK( regs.enables==0x3U );
+  CHECK( regs.get_spi_enable(0U) );
+  CHECK_FALSE( regs.get_spi_enable(1U) );
+  regs.set_spi_enable(1U, true);
+  CHECK( regs.enables==0x7U );
+  CHECK( regs.get_spi_enable(1U) );
+  regs.set_spi_enable(0U, false);
+  CHECK( regs.enables==0x5U );
+  CHECK_FALSE( regs.get_spi_enable(0U) );
+  regs.set_spi_enable(1U, false);
+  CHECK( regs.enables==0x1U );
+}
+
+TEST_CASE( "Unit-tests/aux_spi_registers/0020/transmit_fifo_write"
+         , "Writes go to TXHOLD if chip select is to be held, IO if not"
+         )
+{
+  aux_spi_registers regs;
+  std::memset(&regs, 0, sizeof(regs));
+  regs.transmit_fifo_write(0x08110000U, true);
+  CHECK( regs.tx_hold[0]==0x08110000U );
+  CHECK( regs.io[0]==0U );
+  regs.transmit_fifo_write(0x08220000U, false);
+  CHECK( regs.io[0]==0x08220000U );
+  CHECK( regs.tx_hold[0]==0x08110000U );
+  CHECK( regs.receive_fifo_read()==0x08220000U );
+}
+
+TEST_CASE( "Unit-tests/aux_spi_registers/0030/status queries"
+         , "Status query members reflect the STAT register bits"
+         )
+{
+  aux_spi_registers regs;
+  std::memset(&regs, 0, sizeof(regs));
+  CHECK_FALSE( regs.get_busy() );
+  CHECK_FALSE( regs.get_rx_fifo_empty() );
+  CHECK_FALSE( regs.get_tx_fifo_empty() );
+  CHECK_FALSE( regs.get_tx_fifo_full() );
+  regs.status = aux_spi_registers::stat_busy;
+  CHECK( regs.get_busy() );
+  regs.status = aux_spi_registers::stat_rx_empty;
+  CHECK( regs.get_rx_fifo_empty() );
+  regs.status = aux_spi_registers::stat_tx_empty;
+  CHECK( regs.get_tx_fifo_empty() );
+  regs.status = aux_spi_registers::stat_tx_full;
+  CHECK( regs.get_tx_fifo_full() );
+}
@@ -0,0 +1,98 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file aux_spi_pins_platformtests.cpp
+/// @brief Platform tests for aux_spi_pins.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "aux_spi_pins.h"
+#include "aux_ctrl.h"
+#include "gpio_ctrl.h"
+#include "periexcept.h"
+
+using namespace dibase::rpi::peripherals;
+using namespace dibase::rpi::peripherals::internal;
+
+TEST_CASE( "Platform-tests/aux_spi_pins/0000/create & destroy good SPI1"
+         , "Creating aux_spi_pins from good SPI1 pins leaves object in the "
+           "expected state"
+         )
+{
+  {
+    aux_spi_pins sp(pin_id(21), pin_id(20), pin_id(19), pin_id(18)
+                   , megahertz(1)
+                   );
+    CHECK( sp.bus()==1U );
+    CHECK( gpio_ctrl::instance().alloc.is_in_use(pin_id(21)) );
+    CHECK( gpio_ctrl::instance().alloc.is_in_use(pin_id(20)) );
+    CHECK( gpio_ctrl::instance().alloc.is_in_use(pin_id(19)) );
+    CHECK( gpio_ctrl::instance().alloc.is_in_use(pin_id(18)) );
+    CHECK( aux_ctrl::instance().alloc.is_in_use(0) );
+    CHECK( aux_ctrl::instance().regs->get_spi_enable(0) );
+    CHECK( ( aux_ctrl::instance().regs->spi[0].control0
+           & aux_spi_registers::cntl0_enable
+           )
+         );
+  }
+  CHECK_FALSE( gpio_ctrl::instance().alloc.is_in_use(pin_id(21)) );
+  CHECK_FALSE( gpio_ctrl::instance().alloc.is_in_use(pin_id(18)) );
+  CHECK_FALSE( aux_ctrl::instance().alloc.is_in_use(0) );
+  CHECK_FALSE( aux_ctrl::instance().regs->get_spi_enable(0) );
+}
+
+TEST_CASE( "Platform-tests/aux_spi_pins/0010/create bad pins"
+         , "Creating aux_spi_pins from bad pins throws"
+         )
+{
+  CHECK_THROWS_AS( aux_spi_pins(pin_id(4), pin_id(20), pin_id(19)
+                               , pin_id(18), megahertz(1)
+                               )
+                 , std::invalid_argument
+                 );
+  CHECK_THROWS_AS( aux_spi_pins(pin_id(21), pin_id(41), pin_id(19)
+                               , pin_id(18), megahertz(1)
+                               )
+                 , std::invalid_argument
+                 );
+  CHECK_THROWS_AS( aux_spi_pins(pin_id(21), pin_id(20), pin_id(19)
+                               , pin_id(18), hertz(1)
+                               )
+                 , std::out_of_range
+                 );
+  CHECK_FALSE( aux_ctrl::instance().alloc.is_in_use(0) );
+  CHECK_FALSE( gpio_ctrl::instance().alloc.is_in_use(pin_id(21)) );
+}
+
+TEST_CASE( "Platform-tests/aux_spi_pins/0020/create in use"
+         , "Creating aux_spi_pins for a master already in use throws"
+         )
+{
+  aux_spi_pins sp(pin_id(21), pin_id(20), pin_id(19), pin_id(18)
+                 , megahertz(1)
+                 );
+  CHECK_THROWS_AS( aux_spi_pins(pin_id(21), pin_id(20), pin_id(19)
+                               , pin_id(18), megahertz(1)
+                               )
+                 , bad_peripheral_alloc
+                 );
+}
+
+TEST_CASE( "Platform-tests/aux_spi_pins/0030/transfer"
+         , "Transfers to chip select lines in use complete; others throw"
+         )
+{
+  aux_spi_pins sp(pin_id(21), pin_id(20), pin_id(19), pin_id(18)
+                 , megahertz(1)
+                 );
+  std::uint8_t tx[7]{1, 2, 3, 4, 5, 6, 7};
+  std::uint8_t rx[7]{};
+  CHECK( sp.transfer(0, tx, rx, sizeof(tx))==sizeof(tx) );
+  CHECK( sp.transfer(0, nullptr, nullptr, sizeof(tx))==sizeof(tx) );
+  sp.transfer_bits(0, 0x1FFU, 9U);
+  CHECK_THROWS_AS( sp.transfer(1, tx, rx, sizeof(tx)), std::invalid_argument );
+  CHECK_THROWS_AS( sp.transfer(3, tx, rx, sizeof(tx)), std::invalid_argument );
+  CHECK_THROWS_AS( sp.transfer_bits(0, 0U, 25U), std::invalid_argument );
+  CHECK_THROWS_AS( sp.transfer_bits(0, 0U, 0U), std::invalid_argument );
+}
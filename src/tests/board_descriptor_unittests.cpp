@@ -0,0 +1,85 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file board_descriptor_unittests.cpp
+/// @brief Unit tests for board descriptors deduced from revision codes.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "board_descriptor.h"
+#include "static_pin.h"
+#include <stdexcept>
+
+using namespace dibase::rpi;
+using namespace dibase::rpi::peripherals;
+using namespace dibase::rpi::peripherals::internal;
+
+TEST_CASE( "Unit-tests/board_descriptor/0000/old scheme revisions"
+         , "Old scheme revision values give the original pin out versions"
+         )
+{
+  board_descriptor const v1{make_board_descriptor(0x3U)};
+  CHECK(v1.model==rpi_model::b);
+  CHECK(v1.processor==rpi_processor::bcm2835);
+  CHECK(v1.major_version==1U);
+  CHECK(v1.peripheral_base==0x20000000);
+  REQUIRE(v1.p1_map!=nullptr);
+  CHECK(v1.p1_map[3]==0U);
+  board_descriptor const v2{make_board_descriptor(0xeU)};
+  CHECK(v2.major_version==2U);
+  REQUIRE(v2.p5_map!=nullptr);
+  CHECK(v2.p5_map[3]==28U);
+  CHECK(make_board_descriptor(0x10U).major_version==3U);
+  CHECK(make_board_descriptor(0x11U).major_version==4U);
+  CHECK(make_board_descriptor(0x11U).p1_map==nullptr);
+// warranty bit set: revision 0002 board
+  board_descriptor const warranty{make_board_descriptor(0x1000002U)};
+  CHECK(warranty.major_version==1U);
+  CHECK(warranty.revision_code==0x1000002U);
+}
+
+TEST_CASE( "Unit-tests/board_descriptor/0010/new scheme revisions"
+         , "New scheme revision values give the 40 pin pin out and the "
+           "processor's peripheral base"
+         )
+{
+  board_descriptor const pi3b{make_board_descriptor(0xa02082U)};
+  CHECK(pi3b.model==rpi_model::pi_3_b);
+  CHECK(pi3b.processor==rpi_processor::bcm2837);
+  CHECK(pi3b.major_version==3U);
+  CHECK(pi3b.peripheral_base==0x3F000000);
+  REQUIRE(pi3b.p1_map!=nullptr);
+  CHECK(pi3b.p1_map[40]==21U);
+  board_descriptor const pi4b{make_board_descriptor(0xc03111U)};
+  CHECK(pi4b.model==rpi_model::pi_4_b);
+  CHECK(pi4b.processor==rpi_processor::bcm2711);
+  CHECK(pi4b.major_version==3U);
+  CHECK(pi4b.peripheral_base==0xFE000000);
+  board_descriptor const cm3{make_board_descriptor(0xa020a0U)};
+  CHECK(cm3.model==rpi_model::compute_module_3);
+  CHECK(cm3.major_version==4U);
+  CHECK(cm3.p1_map==nullptr);
+}
+
+TEST_CASE( "Unit-tests/board_descriptor/0020/bad revisions"
+         , "Unknown revision values are rejected"
+         )
+{
+  CHECK_THROWS_AS(make_board_descriptor(0U), std::runtime_error);
+  CHECK_THROWS_AS(make_board_descriptor(0xaU), std::runtime_error);
+  CHECK_THROWS_AS(make_board_descriptor(0x804000U), std::runtime_error);
+}
+
+TEST_CASE( "Unit-tests/board_descriptor/0030/compile time pin mapping"
+         , "p1_gpio_pin and p5_gpio_pin are usable as constant expressions"
+         )
+{
+  CHECK(static_pin_traits<p1_gpio_pin(3U, 11U)>::mask==(1U<<17));
+  CHECK(static_pin_traits<p1_gpio_pin(1U, 3U)>::bank==0U);
+  CHECK(static_pin_traits<p5_gpio_pin(2U, 6U)>::bank==0U);
+  CHECK(p1_gpio_pin(0U, 11U)==~0U);
+  CHECK(p1_gpio_pin(4U, 11U)==~0U);
+  CHECK(p1_gpio_pin(3U, 1U)==~0U);
+  CHECK(p5_gpio_pin(1U, 3U)==~0U);
+}
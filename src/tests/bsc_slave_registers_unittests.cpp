@@ -0,0 +1,86 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file bsc_slave_registers_unittests.cpp
+/// @brief Unit tests for low-level BSC slave peripheral registers type.
+///
+/// Refer to the Broadcom BCM2835 Peripherals Datasheet PDF file for details:
+///
+/// http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf
+///
+/// Chapter 11 SPI/BSC SLAVE
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "bsc_slave_registers.h"
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef std::uint32_t RegisterType;
+
+enum RegisterOffsets
+{ DR_OFFSET=0x00, RSR_OFFSET=0x04, SLV_OFFSET=0x08, CR_OFFSET=0x0c
+, FR_OFFSET=0x10, IFLS_OFFSET=0x14, DMACR_OFFSET=0x28, DEBUG2_OFFSET=0x3c
+};
+
+static_assert( bsc_slave_registers::physical_address==0x20214000
+             , "Unexpected BSC slave registers physical address"
+             );
+static_assert( bsc_slave_registers::i2c_enable==0x305U
+             , "Unexpected BSC slave I2C enable control value"
+             );
+
+TEST_CASE( "Unit-tests/bsc_slave_registers/0000/field offsets"
+         , "BSC slave registers should have the expected size and offsets"
+         )
+{
+  CHECK( sizeof(bsc_slave_registers)==0x40U );
+  CHECK( offsetof(bsc_slave_registers, data)==DR_OFFSET );
+  CHECK( offsetof(bsc_slave_registers, errors)==RSR_OFFSET );
+  CHECK( offsetof(bsc_slave_registers, slave_addrs)==SLV_OFFSET );
+  CHECK( offsetof(bsc_slave_registers, control)==CR_OFFSET );
+  CHECK( offsetof(bsc_slave_registers, flags)==FR_OFFSET );
+  CHECK( offsetof(bsc_slave_registers, fifo_levels)==IFLS_OFFSET );
+  CHECK( offsetof(bsc_slave_registers, dma_control)==DMACR_OFFSET );
+  CHECK( offsetof(bsc_slave_registers, debug2)==DEBUG2_OFFSET );
+}
+
+TEST_CASE( "Unit-tests/bsc_slave_registers/0010/flags"
+         , "FR register flags and FIFO levels are read as expected"
+         )
+{
+  bsc_slave_registers regs;
+  std::memset(&regs, 0, sizeof(regs));
+  regs.flags = 0x02U|0x10U;     // RXFE, TXFE
+  CHECK( regs.get_rx_fifo_empty() );
+  CHECK( regs.get_tx_fifo_empty() );
+  CHECK_FALSE( regs.get_tx_fifo_full() );
+  CHECK( regs.get_rx_fifo_level()==0U );
+  CHECK( regs.get_tx_fifo_level()==0U );
+  regs.flags = 0x04U|(16U<<6)|(5U<<11);   // TXFF, TXFLEVEL 16, RXFLEVEL 5
+  CHECK_FALSE( regs.get_rx_fifo_empty() );
+  CHECK_FALSE( regs.get_tx_fifo_empty() );
+  CHECK( regs.get_tx_fifo_full() );
+  CHECK( regs.get_tx_fifo_level()==16U );
+  CHECK( regs.get_rx_fifo_level()==5U );
+}
+
+TEST_CASE( "Unit-tests/bsc_slave_registers/0020/data and errors"
+         , "DR reads mask the data byte and RSR errors are read and cleared"
+         )
+{
+  bsc_slave_registers regs;
+  std::memset(&regs, 0, sizeof(regs));
+  regs.data = 0xF80003A5U;      // RXFLEVEL, OE, UE and data byte 0xA5
+  CHECK( regs.receive_fifo_read()==0xA5U );
+  regs.transmit_fifo_write(0x5AU);
+  CHECK( regs.data==0x5AU );
+  regs.errors = 0xFFFFFFFFU;
+  CHECK( regs.get_errors()==3U );
+  regs.clear_errors();
+  CHECK( regs.get_errors()==0U );
+}
@@ -0,0 +1,68 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file bus_broker_platformtests.cpp
+/// @brief Platform tests for bus_broker and bus_broker_client.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "bus_broker.h"
+#include "spi0_ctrl.h"
+#include <thread>
+
+using namespace dibase::rpi::peripherals;
+using namespace dibase::rpi::peripherals::internal;
+
+TEST_CASE( "Platform-tests/bus_broker/0000/create & destroy"
+         , "Creating and destroying a bus_broker for SPI0 leaves SPI0 not "
+           "conversing"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  {
+    bus_broker broker{&sp, {spi0_slave_context{spi0_slave::chip0, megahertz(1)}}
+                     , nullptr
+                     };
+  }
+  CHECK_FALSE(sp.is_conversing());
+  CHECK_FALSE(spi0_ctrl::instance().regs->get_transfer_active());
+}
+
+TEST_CASE( "Platform-tests/bus_broker/0010/spi0 transfers from many clients"
+         , "SPI0 transfers submitted by several client threads all complete, "
+           "each transferring as many bytes as requested"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  bus_broker broker
+              { &sp
+              , { spi0_slave_context{spi0_slave::chip0, megahertz(1)}
+                , spi0_slave_context{spi0_slave::chip1, megahertz(2)}
+                }
+              , nullptr
+              };
+// Catch assertions are not thread safe: clients count good results
+  auto client = [](std::size_t slave, std::size_t count, std::size_t & good)
+                {
+                  bus_broker_client bc;
+                  bus_broker_client::buffer b{bc.acquire()};
+                  for (std::size_t n=1; n<=count; ++n)
+                    {
+                      for (std::size_t i=0U; i!=n; ++i)
+                        {
+                          b.data()[i] = 0x3CU;
+                        }
+                      good += bc.spi0_transfer(b, slave, n)==n;
+                    }
+                };
+  std::size_t good0{0U};
+  std::size_t good1{0U};
+  std::thread t0{client, 0U, 20U, std::ref(good0)};
+  std::thread t1{client, 1U, 20U, std::ref(good1)};
+  t0.join();
+  t1.join();
+  CHECK(good0==20U);
+  CHECK(good1==20U);
+  CHECK_FALSE(spi0_ctrl::instance().regs->get_transfer_active());
+}
@@ -0,0 +1,146 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file bus_broker_unittests.cpp
+/// @brief Unit tests for the bus broker shared memory channel and the
+/// bus_broker and bus_broker_client types with no buses brokered.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "bus_broker.h"
+#include "bus_broker_channel.h"
+#include "periexcept.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace dibase::rpi::peripherals;
+using namespace dibase::rpi::peripherals::internal;
+
+namespace
+{
+  char const * test_channel_name{"/dibase-rpi-bus-broker-unittests"};
+}
+
+TEST_CASE( "Unit-tests/bus_broker_channel/0000/open"
+         , "Clients cannot open a channel with no server and a second server "
+           "cannot serve a channel already being served"
+         )
+{
+  REQUIRE_THROWS(bus_broker_channel( test_channel_name
+                                   , bus_broker_channel::role::client
+                                   ));
+  bus_broker_channel server{test_channel_name, bus_broker_channel::role::server};
+  REQUIRE_THROWS_AS(bus_broker_channel( test_channel_name
+                                      , bus_broker_channel::role::server
+                                      )
+                   , bad_peripheral_alloc
+                   );
+  bus_broker_channel client{test_channel_name, bus_broker_channel::role::client};
+  std::uint32_t idx{client.claim()};
+  CHECK(idx<bus_broker_channel::slot_count);
+  client.release(idx);
+}
+
+TEST_CASE( "Unit-tests/bus_broker_channel/0010/requests round trip"
+         , "Requests submitted by several client threads are all taken by "
+           "the server and their results seen by the clients"
+         )
+{
+  bus_broker_channel server{test_channel_name, bus_broker_channel::role::server};
+  std::atomic<bool> stopping{false};
+  std::thread serving
+                { [&server, &stopping]()
+                  {
+                    while (!stopping.load())
+                      {
+                        std::uint32_t idx;
+                        if (server.take(idx))
+                          {
+                            bus_broker_request & r(server.slot(idx));
+                            r.count = r.tx_count;
+                            r.data[0] = static_cast<std::uint8_t>(r.data[0]+1U);
+                            server.complete(idx);
+                          }
+                        else
+                          {
+                            server.wait_submitted(stopping);
+                          }
+                      }
+                  }
+                };
+  unsigned const clients{4U};
+  unsigned const per_client{500U};
+// Catch assertions are not thread safe: clients count good results
+  std::vector<unsigned> good(clients, 0U);
+  std::vector<std::thread> threads;
+  for (unsigned c=0U; c!=clients; ++c)
+    {
+      threads.emplace_back( [&good, c]()
+                            {
+                              bus_broker_channel ch
+                                        { test_channel_name
+                                        , bus_broker_channel::role::client
+                                        };
+                              for (unsigned i=0U; i!=per_client; ++i)
+                                {
+                                  std::uint32_t idx{ch.claim()};
+                                  bus_broker_request & r(ch.slot(idx));
+                                  r.tx_count = i;
+                                  r.data[0] = static_cast<std::uint8_t>(i);
+                                  ch.submit(idx);
+                                  ch.wait_completed(idx);
+                                  good[c] += r.count==i
+                                          && r.data[0]==
+                                              static_cast<std::uint8_t>(i+1U);
+                                  ch.release(idx);
+                                }
+                            }
+                          );
+    }
+  for (auto & t : threads)
+    {
+      t.join();
+    }
+  stopping.store(true);
+  server.interrupt();
+  serving.join();
+  for (unsigned c=0U; c!=clients; ++c)
+    {
+      CHECK(good[c]==per_client);
+    }
+}
+
+TEST_CASE( "Unit-tests/bus_broker/0000/unbrokered buses rejected"
+         , "Requests for buses a broker was not given fail with "
+           "std::invalid_argument and byte counts are checked by clients"
+         )
+{
+  bus_broker broker{nullptr, {}, nullptr, test_channel_name};
+  bus_broker_client client{test_channel_name};
+  bus_broker_client::buffer b{client.acquire()};
+  REQUIRE(b.data()!=nullptr);
+  CHECK(b.size()==bus_broker::buffer_size);
+  REQUIRE_THROWS_AS(client.spi0_transfer(b, 0U, 4U), std::invalid_argument);
+  REQUIRE_THROWS_AS(client.i2c_write(b, 0x48U, 2U), std::invalid_argument);
+  REQUIRE_THROWS_AS(client.i2c_read(b, 0x48U, 2U), std::invalid_argument);
+  REQUIRE_THROWS_AS(client.i2c_write_then_read(b, 0x48U, 1U, 2U)
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS(client.spi0_transfer(b, 0U, 0U), std::invalid_argument);
+  REQUIRE_THROWS_AS(client.i2c_read(b, 0x48U, b.size()+1U)
+                   , std::invalid_argument
+                   );
+}
+
+TEST_CASE( "Unit-tests/bus_broker/0010/broker exit"
+         , "Clients cannot connect once a broker has been destroyed"
+         )
+{
+  {
+    bus_broker broker{nullptr, {}, nullptr, test_channel_name};
+    bus_broker_client client{test_channel_name};
+  }
+  REQUIRE_THROWS(bus_broker_client{test_channel_name});
+}
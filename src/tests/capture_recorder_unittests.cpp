@@ -0,0 +1,102 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file capture_recorder_unittests.cpp
+/// @brief Unit tests for the memory mapped capture file recorder and reader.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "capture_recorder.h"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+using namespace dibase::rpi::peripherals;
+
+namespace
+{
+  std::string temp_path()
+  {
+    char path[]{"/tmp/capture_recorder_XXXXXX"};
+    int const fd{::mkstemp(path)};
+    REQUIRE(fd!=-1);
+    ::close(fd);
+    return path;
+  }
+
+  edge_event_record make_event(unsigned pin, bool rising, long long ns)
+  {
+    edge_event_record event;
+    event.pin = pin_id(pin);
+    event.edge = rising ? pin_edge_event::rising : pin_edge_event::falling;
+    event.timestamp = std::chrono::nanoseconds{ns};
+    return event;
+  }
+}
+
+TEST_CASE( "Unit-tests/capture_recorder/0000/record and read back"
+         , "Edge events and level samples recorded are read back in order; "
+           "records beyond capacity are dropped"
+         )
+{
+  std::string const path{temp_path()};
+  {
+    REQUIRE_THROWS_AS( (capture_recorder{path.c_str(), 0U})
+                     , std::invalid_argument
+                     );
+    capture_recorder recorder{path.c_str(), 6U, 2U};
+    CHECK(recorder.capacity()==6U);
+    CHECK(recorder.size()==0U);
+    CHECK(recorder.record(make_event(17U, true, 1000)));
+    std::uint32_t const levels[2]{0x00020000U, 0x00000004U};
+    CHECK(recorder.record_levels(std::chrono::nanoseconds{1500}, levels));
+    edge_event_record const events[]
+                        { make_event(22U, false, 2000)
+                        , make_event(17U, false, 3000)
+                        , make_event(22U, true, 4000)
+                        , make_event(4U, true, 5000)
+                        };
+    CHECK(recorder.record(events, 4U)==3U);
+    CHECK(recorder.size()==6U);
+    CHECK(recorder.dropped()==1U);
+    CHECK_FALSE(recorder.record_levels(std::chrono::nanoseconds{6000}, levels));
+    CHECK(recorder.dropped()==3U);
+    recorder.flush();
+    capture_reader live{path.c_str()};
+    CHECK(live.size()==6U);
+  }
+  capture_reader reader{path.c_str()};
+  REQUIRE(reader.size()==6U);
+  CHECK(reader.capacity()==6U);
+  CHECK(reader[0].timestamp==1000);
+  CHECK(reader[0].pin==17U);
+  CHECK(reader[0].value==1U);
+  CHECK(reader[1].timestamp==1500);
+  CHECK(reader[1].pin==0x100U);
+  CHECK(reader[1].value==0x00020000U);
+  CHECK(reader[2].pin==0x101U);
+  CHECK(reader[2].value==0x00000004U);
+  CHECK(reader[3].pin==22U);
+  CHECK(reader[3].value==0U);
+  CHECK(reader[5].timestamp==4000);
+  CHECK(reader.end()-reader.begin()==6);
+  std::remove(path.c_str());
+}
+
+TEST_CASE( "Unit-tests/capture_reader/0010/bad files"
+         , "Reading a missing, short or foreign file throws"
+         )
+{
+  std::string const path{temp_path()};
+  REQUIRE_THROWS_AS(capture_reader{path.c_str()}, std::runtime_error);
+  {
+    std::ofstream out{path.c_str()};
+    out << "This is not a capture file, nor is it a very long text file.";
+  }
+  REQUIRE_THROWS_AS(capture_reader{path.c_str()}, std::runtime_error);
+  std::remove(path.c_str());
+  REQUIRE_THROWS_AS(capture_reader{path.c_str()}, std::system_error);
+}
@@ -270,3 +270,80 @@ TEST_CASE( "Unit-tests/clock_parameters/0130/create zero clock freq. "
                    , std::invalid_argument
                    );
 }
+
+namespace
+{
+  template <class Static>
+  void check_static_matches_run_time(clock_frequency const & freq)
+  {
+    constexpr static_clock_settings const & s(Static::value);
+    clock_parameters run_time{s.source(), s.source_frequency(), freq};
+    clock_parameters compile_time{s};
+    CHECK(compile_time.frequency_min()==run_time.frequency_min());
+    CHECK(compile_time.frequency_avg()==run_time.frequency_avg());
+    CHECK(compile_time.frequency_max()==run_time.frequency_max());
+    CHECK(compile_time.clk_source()==run_time.clk_source());
+    CHECK(compile_time.clk_mash()==run_time.clk_mash());
+    CHECK(compile_time.clk_divi()==run_time.clk_divi());
+    CHECK(compile_time.clk_divf()==run_time.clk_divf());
+  }
+}
+
+TEST_CASE( "Unit-tests/clock_parameters/0200/static parameters no filter"
+         , "static_clock_parameters with no filtering are calculated at "
+           "compile time with the same values as clock_parameters"
+         )
+{
+  typedef static_clock_parameters< clock_source::oscillator, 650000000U
+                                 , 18320000U
+                                 > params;
+  static_assert(params::value.divi()==35U, "Unexpected DIVI");
+  static_assert(params::value.divf()==0U, "Unexpected DIVF");
+  static_assert( params::value.frequency_avg()==hertz{18571428U}
+               , "Unexpected average frequency"
+               );
+  static_assert(params::value.mash()==clock_filter::none, "Unexpected MASH");
+  check_static_matches_run_time<params>(clock_frequency{hertz{18320000U}});
+}
+
+TEST_CASE( "Unit-tests/clock_parameters/0210/static parameters with filters"
+         , "static_clock_parameters with filtering match clock_parameters, "
+           "including reducing the MASH mode for high maximum frequencies"
+         )
+{
+  check_static_matches_run_time
+    < static_clock_parameters< clock_source::plld, 500000000U, 1234567U
+                             , clock_filter::minimum
+                             >
+    >(clock_frequency{hertz{1234567U}, clock_filter::minimum});
+  check_static_matches_run_time
+    < static_clock_parameters< clock_source::oscillator, 19200000U, 600000U
+                             , clock_filter::medium
+                             >
+    >(clock_frequency{hertz{600000U}, clock_filter::medium});
+  typedef static_clock_parameters< clock_source::plld, 500000000U, 22000000U
+                                 , clock_filter::maximum
+                                 > reduced;
+  static_assert( reduced::value.mash()==clock_filter::medium
+               , "Expected MASH mode reduced to 2 stages"
+               );
+  check_static_matches_run_time<reduced>
+                  (clock_frequency{hertz{22000000U}, clock_filter::maximum});
+}
+
+TEST_CASE( "Unit-tests/clock_parameters/0220/static parameters tolerance"
+         , "static_clock_parameters within a tolerance can be instantiated"
+         )
+{
+  typedef static_clock_parameters< clock_source::oscillator, 19200000U
+                                 , 2400000U, clock_filter::none, 0U
+                                 > exact;
+  static_assert( exact::value.frequency_avg()==hertz{2400000U}
+               , "Expected exact average frequency"
+               );
+  typedef static_clock_parameters< clock_source::plld, 500000000U, 3000000U
+                                 , clock_filter::none, 2000U
+                                 > close;
+  static_assert(close::value.divi()==167U, "Unexpected DIVI");
+  CHECK(close::value.frequency_avg()==hertz{2994011U});
+}
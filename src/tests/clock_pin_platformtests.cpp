@@ -110,3 +110,50 @@ TEST_CASE( "Platform-tests/clock_pin/0050/create bad: invalid frequencies"
                  , std::range_error
                  );
 }
+
+TEST_CASE( "Platform-tests/clock_pin/0060/retune from tuning table"
+         , "Running clock_pin retuned to precomputed frequencies keeps running"
+         )
+{
+  clock_pin clk { pin_id{4}
+                , fixed_oscillator_clock_source{f_megahertz{19.2}}
+                , clock_frequency{kilohertz{600}, clock_filter::none}
+                };
+  CHECK(clk.tuning_table_size()==0U);
+  CHECK_THROWS_AS(clk.retune(0U), std::out_of_range);
+  CHECK_THROWS_AS(clk.set_tuning_table
+                    ({clock_frequency{kilohertz{700}, clock_filter::medium}})
+                 , std::invalid_argument
+                 );
+  clk.set_tuning_table( { clock_frequency{kilohertz{400}, clock_filter::none}
+                        , clock_frequency{kilohertz{800}, clock_filter::none}
+                        }
+                      );
+  CHECK(clk.tuning_table_size()==2U);
+  CHECK_THROWS_AS(clk.retune(2U), std::out_of_range);
+  clk.start();
+  CHECK(clk.is_running());
+  clk.retune(1U);
+  CHECK(clk.is_running());
+  CHECK(clk.frequency_avg()==hertz{800000U});
+  clk.retune(0U);
+  CHECK(clk.is_running());
+  CHECK(clk.frequency_avg()==hertz{400000U});
+  clk.stop();
+  CHECK_FALSE(clk.is_running());
+}
+
+TEST_CASE( "Platform-tests/clock_pin/0070/create from static parameters"
+         , "Creates clock_pin from compile time calculated clock parameters"
+         )
+{
+  clock_pin clk { pin_id{4}
+                , static_clock_parameters< clock_source::oscillator
+                                         , 19200000U, 600000U
+                                         >::value
+                };
+  CHECK(clk.frequency_min()==hertz{600000U});
+  CHECK(clk.frequency_avg()==hertz{600000U});
+  CHECK(clk.frequency_max()==hertz{600000U});
+  CHECK_FALSE(clk.is_running());
+}
@@ -442,6 +442,8 @@ TEST_CASE( "Unit-tests/clock_record/0450/set_divf for busy clocks"
 
 enum RegisterOffsets // Byte offsets
 { PWM_CTRL_OFFSET=40*4, PWM_DIV_OFFSET=41*4  // NB: NOT HEX values!!
+, PCM_CTRL_OFFSET=0x98, PCM_DIV_OFFSET=0x9c
+, SMI_CTRL_OFFSET=0xb0, SMI_DIV_OFFSET=0xb4
 , GP0_CTRL_OFFSET=0x70, GP0_DIV_OFFSET=0x74
 , GP1_CTRL_OFFSET=0x78, GP1_DIV_OFFSET=0x7c
 , GP2_CTRL_OFFSET=0x80, GP2_DIV_OFFSET=0x84
@@ -462,6 +464,16 @@ TEST_CASE( "Unit-tests/clock_registers/0000/field offsets"
   clk_regs.pwm_clk.divisor = PWM_DIV_OFFSET;
   CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[PWM_DIV_OFFSET])==PWM_DIV_OFFSET );
 
+  clk_regs.pcm_clk.control = PCM_CTRL_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[PCM_CTRL_OFFSET])==PCM_CTRL_OFFSET );
+  clk_regs.pcm_clk.divisor = PCM_DIV_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[PCM_DIV_OFFSET])==PCM_DIV_OFFSET );
+
+  clk_regs.smi_clk.control = SMI_CTRL_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[SMI_CTRL_OFFSET])==SMI_CTRL_OFFSET );
+  clk_regs.smi_clk.divisor = SMI_DIV_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[SMI_DIV_OFFSET])==SMI_DIV_OFFSET );
+
   clk_regs.gp0_clk.control = GP0_CTRL_OFFSET;
   CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[GP0_CTRL_OFFSET])==GP0_CTRL_OFFSET );
   clk_regs.gp0_clk.divisor = GP0_DIV_OFFSET;
@@ -493,6 +505,16 @@ TEST_CASE( "Unit-tests/clock_registers/0010/pre-defined clock_id constants corre
   (clk_regs.*pwm_clk_id).divisor = PWM_DIV_OFFSET;
   CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[PWM_DIV_OFFSET])==PWM_DIV_OFFSET );
 
+  (clk_regs.*pcm_clk_id).control = PCM_CTRL_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[PCM_CTRL_OFFSET])==PCM_CTRL_OFFSET );
+  (clk_regs.*pcm_clk_id).divisor = PCM_DIV_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[PCM_DIV_OFFSET])==PCM_DIV_OFFSET );
+
+  (clk_regs.*smi_clk_id).control = SMI_CTRL_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[SMI_CTRL_OFFSET])==SMI_CTRL_OFFSET );
+  (clk_regs.*smi_clk_id).divisor = SMI_DIV_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[SMI_DIV_OFFSET])==SMI_DIV_OFFSET );
+
   (clk_regs.*gp0_clk_id).control = GP0_CTRL_OFFSET;
   CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[GP0_CTRL_OFFSET])==GP0_CTRL_OFFSET );
   (clk_regs.*gp0_clk_id).divisor = GP0_DIV_OFFSET;
@@ -1125,3 +1147,26 @@ TEST_CASE( "Unit-tests/clock_registers/0450/set_divf for busy clocks"
   CHECK(clk_regs.get_divf(gp1_clk_id)==0xfffU);
   CHECK(clk_regs.gp1_clk.divisor==0x5a000fffU);
 }
+
+TEST_CASE( "Unit-tests/clock_registers/0460/set_divisor for busy clocks"
+         , "Check set_divisor writes both divisor fields in one go whether or "
+           "not clock is busy and rejects out of range values"
+         )
+{
+  clock_registers clk_regs;
+// initially start with all bytes of clk_regs set to 0x00:
+  std::memset(&clk_regs, 0x00, sizeof(clk_regs));
+  clk_regs.gp0_clk.control = 128U; // BUSY flag is bit 7
+  CHECK(clk_regs.set_divisor(gp0_clk_id, 0x123U, 0x456U));
+  CHECK(clk_regs.get_divi(gp0_clk_id)==0x123U);
+  CHECK(clk_regs.get_divf(gp0_clk_id)==0x456U);
+  CHECK(clk_regs.gp0_clk.divisor==0x5a123456U);
+  CHECK(clk_regs.gp0_clk.control==128U);
+  CHECK(clk_regs.set_divisor(gp0_clk_id, 0x2U, 0x0U));
+  CHECK(clk_regs.gp0_clk.divisor==0x5a002000U);
+
+  CHECK_FALSE(clk_regs.set_divisor(gp0_clk_id, 0U, 0x1U));
+  CHECK_FALSE(clk_regs.set_divisor(gp0_clk_id, 0x1000U, 0x1U));
+  CHECK_FALSE(clk_regs.set_divisor(gp0_clk_id, 0x1U, 0x1000U));
+  CHECK(clk_regs.gp0_clk.divisor==0x5a002000U);
+}
@@ -0,0 +1,51 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file debouncer_platformtests.cpp
+/// @brief System tests for the GPIO input pin debouncer type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "debouncer.h"
+#include <thread>
+
+using namespace dibase::rpi::peripherals;
+
+// Change if P1 GPIO_GEN0/GPIO_GEN3 in use on your system...
+static pin_id const in_pin_id_0{17}; // P1 pin GPIO_GEN0
+static pin_id const in_pin_id_1{22}; // P1 pin GPIO_GEN3
+
+TEST_CASE( "Platform_tests/debouncer/000/bad parameters fail"
+         , "Creating a debouncer with a bad tick, threshold or capacity throws"
+         )
+{
+  ipin_group pins{in_pin_id_0, in_pin_id_1};
+  REQUIRE_THROWS_AS((debouncer{pins, std::chrono::microseconds{0}, 5U, 16U})
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS((debouncer{pins, std::chrono::microseconds{1000}, 0U, 16U})
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS((debouncer{pins, std::chrono::microseconds{1000}, 5U, 15U})
+                   , std::invalid_argument
+                   );
+}
+
+TEST_CASE( "Platform_tests/debouncer/010/steady pins"
+         , "Debouncing pulled up and down pins reports their levels and no "
+           "edges"
+         )
+{
+  ipin_group pins{{in_pin_id_0}, ipin::pull_up};
+  ipin_group other_pins{{in_pin_id_1}, ipin::pull_down};
+  debouncer pulled_up{pins, std::chrono::microseconds{1000}, 5U, 16U};
+  debouncer pulled_down{other_pins, std::chrono::microseconds{1000}, 5U, 16U};
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  CHECK(pulled_up.state()==0x1U);
+  CHECK(pulled_down.state()==0x0U);
+  edge_event_record events[16];
+  CHECK(pulled_up.pop(events, 16U)==0U);
+  CHECK(pulled_down.pop(events, 16U)==0U);
+  CHECK(pulled_up.overruns()==0U);
+  CHECK(pulled_up.capacity()==16U);
+}
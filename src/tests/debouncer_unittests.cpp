@@ -0,0 +1,75 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file debouncer_unittests.cpp
+/// @brief Unit tests for the integrating debounce filter.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "debouncer.h"
+#include <stdexcept>
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/debounce_filter/0000/bad threshold"
+         , "Creating a debounce_filter with a zero or too large threshold "
+           "throws"
+         )
+{
+  REQUIRE_THROWS_AS((debounce_filter{0x1U, 0x0U, 0U}), std::invalid_argument);
+  REQUIRE_THROWS_AS((debounce_filter{ 0x1U, 0x0U
+                                    , debounce_filter::max_threshold+1U
+                                    })
+                   , std::invalid_argument
+                   );
+  REQUIRE_NOTHROW((debounce_filter{ 0x1U, 0x0U
+                                  , debounce_filter::max_threshold
+                                  }));
+}
+
+TEST_CASE( "Unit-tests/debounce_filter/0010/clean change"
+         , "A clean change is reported after threshold updates and only once"
+         )
+{
+  debounce_filter filter{0x3U, 0x2U, 3U};
+  CHECK(filter.state()==0x2U);
+  CHECK(filter.update(0x1U)==0U);
+  CHECK(filter.update(0x1U)==0U);
+  CHECK(filter.update(0x1U)==0x3U);
+  CHECK(filter.state()==0x1U);
+  CHECK(filter.update(0x1U)==0U);
+  CHECK(filter.state()==0x1U);
+}
+
+TEST_CASE( "Unit-tests/debounce_filter/0020/bounces filtered"
+         , "Changes shorter than the threshold are not reported and bouncing "
+           "delays a change; inputs not in the mask are ignored"
+         )
+{
+  debounce_filter filter{0x1U, 0x0U, 3U};
+  CHECK(filter.update(0x1U)==0U);
+  CHECK(filter.update(0x0U)==0U);
+  CHECK(filter.update(0x0U)==0U);
+  CHECK(filter.state()==0x0U);
+  CHECK(filter.update(0x1U)==0U); // count 1
+  CHECK(filter.update(0x1U)==0U); // count 2
+  CHECK(filter.update(0x0U)==0U); // count 1
+  CHECK(filter.update(0x1U)==0U); // count 2
+  CHECK(filter.update(0x1U)==0x1U);
+  CHECK(filter.state()==0x1U);
+  CHECK(filter.update(0x2U)==0U);
+  CHECK(filter.update(0x2U)==0U);
+  CHECK(filter.update(0x2U)==0x1U);
+  CHECK(filter.state()==0x0U);
+}
+
+TEST_CASE( "Unit-tests/debounce_filter/0030/threshold one"
+         , "A threshold of one reports every change on the update it is seen"
+         )
+{
+  debounce_filter filter{~pin_group_value_t(0), 0x0U, 1U};
+  CHECK(filter.update(0x8000000000000001ULL)==0x8000000000000001ULL);
+  CHECK(filter.update(0x8000000000000000ULL)==0x1U);
+  CHECK(filter.state()==0x8000000000000000ULL);
+}
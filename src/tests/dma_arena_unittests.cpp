@@ -0,0 +1,77 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file dma_arena_unittests.cpp
+/// @brief Unit tests for dma_region internal DMA memory sub-allocator type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "dma_arena.h"
+#include <cstdint>
+#include <new>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef std::uint32_t RegisterType;
+
+namespace
+{
+  RegisterType const region_bus{0xC0300000U};
+
+  struct alignas(32) region_type
+  {
+    unsigned char bytes[256];
+  };
+}
+
+TEST_CASE( "Unit-tests/dma_region/0000/allocate in order with addresses"
+         , "Allocations are carved in order with matching process and bus "
+           "addresses"
+         )
+{
+  region_type mem;
+  dma_region region{&mem, region_bus, sizeof(mem)};
+  CHECK(region.available()==256U);
+  dma_buffer a{region.allocate(10U)};
+  CHECK(a.address==mem.bytes);
+  CHECK(a.bus_address==region_bus);
+  CHECK(a.size==10U);
+  dma_buffer b{region.allocate(8U)};
+  CHECK(b.address==mem.bytes+12);
+  CHECK(b.bus_address==region_bus+12U);
+  CHECK(region.bus_address(b.address)==region_bus+12U);
+  CHECK(region.available()==256U-20U);
+}
+
+TEST_CASE( "Unit-tests/dma_region/0010/alignment"
+         , "Allocations respect alignment, including control blocks, and bad "
+           "alignments are rejected"
+         )
+{
+  region_type mem;
+  dma_region region{&mem, region_bus, sizeof(mem)};
+  region.allocate(1U, 1U);
+  dma_control_block * cbs{region.allocate_control_blocks(2U)};
+  CHECK(reinterpret_cast<unsigned char *>(cbs)==mem.bytes+32);
+  CHECK(region.bus_address(cbs)==region_bus+32U);
+  dma_buffer b{region.allocate(4U, 64U)};
+  CHECK(b.bus_address==region_bus+128U);
+  REQUIRE_THROWS_AS(region.allocate(4U, 0U), std::invalid_argument);
+  REQUIRE_THROWS_AS(region.allocate(4U, 24U), std::invalid_argument);
+}
+
+TEST_CASE( "Unit-tests/dma_region/0020/exhaust and reset"
+         , "Allocations beyond the region fail; reset frees all allocations"
+         )
+{
+  region_type mem;
+  dma_region region{&mem, region_bus, sizeof(mem)};
+  region.allocate(250U);
+  REQUIRE_THROWS_AS(region.allocate(8U), std::bad_alloc);
+  CHECK(region.available()==6U);
+  region.reset();
+  CHECK(region.available()==256U);
+  CHECK(region.allocate(256U).address==mem.bytes);
+  REQUIRE_THROWS_AS(region.allocate(1U), std::bad_alloc);
+}
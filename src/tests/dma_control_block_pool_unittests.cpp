@@ -0,0 +1,73 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file dma_control_block_pool_unittests.cpp
+/// @brief Unit tests for dma_control_block_pool internal type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "dma_control_block_pool.h"
+#include <cstring>
+#include <cstdint>
+#include <new>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef std::uint32_t RegisterType;
+
+namespace
+{
+  RegisterType const pool_bus{0xC0200000U};
+  std::size_t const pool_size{4U};
+}
+
+TEST_CASE( "Unit-tests/dma_control_block_pool/0000/allocate all then fail"
+         , "All blocks of a pool can be allocated zeroed, then allocation fails"
+         )
+{
+  dma_control_block cbs[pool_size];
+  std::memset(cbs, 0xFF, sizeof(cbs));
+  dma_control_block_pool pool{cbs, pool_bus, pool_size};
+  CHECK(pool.capacity()==pool_size);
+  CHECK(pool.available()==pool_size);
+  for (std::size_t idx=0; idx!=pool_size; ++idx)
+    {
+      dma_control_block * cb{pool.allocate()};
+      CHECK(cb==cbs+idx);
+      CHECK(cb->transfer_info==0U);
+      CHECK(cb->next_control_block==0U);
+      CHECK(pool.bus_address(cb)==pool_bus+idx*sizeof(dma_control_block));
+    }
+  CHECK(pool.available()==0U);
+  REQUIRE_THROWS_AS(pool.allocate(), std::bad_alloc);
+  pool.deallocate(cbs+2);
+  CHECK(pool.available()==1U);
+  CHECK(pool.allocate()==cbs+2);
+}
+
+TEST_CASE( "Unit-tests/dma_control_block_pool/0010/foreign blocks rejected"
+         , "Blocks not from a pool cannot be deallocated or linked to"
+         )
+{
+  dma_control_block cbs[pool_size];
+  dma_control_block other;
+  dma_control_block_pool pool{cbs, pool_bus, pool_size};
+  REQUIRE_THROWS_AS(pool.deallocate(&other), std::invalid_argument);
+  REQUIRE_THROWS_AS(pool.bus_address(&other), std::invalid_argument);
+  REQUIRE_THROWS_AS(pool.link(cbs[0], &other), std::invalid_argument);
+}
+
+TEST_CASE( "Unit-tests/dma_control_block_pool/0020/link blocks into chain"
+         , "Linking sets next control block bus address, nullptr ends a chain"
+         )
+{
+  dma_control_block cbs[pool_size];
+  dma_control_block_pool pool{cbs, pool_bus, pool_size};
+  dma_control_block * first{pool.allocate()};
+  dma_control_block * second{pool.allocate()};
+  pool.link(*first, second);
+  pool.link(*second, nullptr);
+  CHECK(first->next_control_block==pool_bus+sizeof(dma_control_block));
+  CHECK(second->next_control_block==0U);
+}
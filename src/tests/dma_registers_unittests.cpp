@@ -0,0 +1,99 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file dma_registers_unittests.cpp
+/// @brief Unit tests for low-level DMA controller registers and control block
+/// types.
+///
+/// Refer to the Broadcom BCM2835 Peripherals Datasheet PDF file for details:
+///
+/// http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf
+///
+/// Chapter 4 DMA Controller
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "dma_registers.h"
+#include <cstring>
+#include <cstdint>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef uint32_t RegisterType;
+typedef unsigned char Byte;
+
+// Register byte offsets, see BCM2835 peripherals manual section 4.2.1
+// DMA Channel Register Address Map
+enum RegisterOffsets
+{  CS_OFFSET=0x00, CONBLK_AD_OFFSET=0x04, TI_OFFSET=0x08
+,  SOURCE_AD_OFFSET=0x0C, DEST_AD_OFFSET=0x10, TXFR_LEN_OFFSET=0x14
+,  STRIDE_OFFSET=0x18, NEXTCONBK_OFFSET=0x1C, DEBUG_OFFSET=0x20
+,  CHANNEL_SIZE=0x100, INT_STATUS_OFFSET=0xFE0, ENABLE_OFFSET=0xFF0
+};
+
+TEST_CASE( "Unit-tests/dma_registers/0000/field offsets"
+         , "DMA registers and control blocks should have the expected offsets"
+         )
+{
+  CHECK(sizeof(dma_control_block)==32U);
+  CHECK(alignof(dma_control_block)==32U);
+  CHECK(offsetof(dma_control_block, transfer_info)==0x00);
+  CHECK(offsetof(dma_control_block, source_address)==0x04);
+  CHECK(offsetof(dma_control_block, dest_address)==0x08);
+  CHECK(offsetof(dma_control_block, transfer_length)==0x0C);
+  CHECK(offsetof(dma_control_block, stride)==0x10);
+  CHECK(offsetof(dma_control_block, next_control_block)==0x14);
+  CHECK(sizeof(dma_channel_registers)==CHANNEL_SIZE);
+  CHECK(offsetof(dma_channel_registers, control_and_status)==CS_OFFSET);
+  CHECK(offsetof(dma_channel_registers, control_block_address)==CONBLK_AD_OFFSET);
+  CHECK(offsetof(dma_channel_registers, transfer_info)==TI_OFFSET);
+  CHECK(offsetof(dma_channel_registers, source_address)==SOURCE_AD_OFFSET);
+  CHECK(offsetof(dma_channel_registers, dest_address)==DEST_AD_OFFSET);
+  CHECK(offsetof(dma_channel_registers, transfer_length)==TXFR_LEN_OFFSET);
+  CHECK(offsetof(dma_channel_registers, stride)==STRIDE_OFFSET);
+  CHECK(offsetof(dma_channel_registers, next_control_block)==NEXTCONBK_OFFSET);
+  CHECK(offsetof(dma_channel_registers, debug)==DEBUG_OFFSET);
+  CHECK(offsetof(dma_registers, channel[1])==CHANNEL_SIZE);
+  CHECK(offsetof(dma_registers, int_status)==INT_STATUS_OFFSET);
+  CHECK(offsetof(dma_registers, enable)==ENABLE_OFFSET);
+  static_assert( dma_registers::physical_address==0x20007000
+               , "Unexpected DMA controller physical address"
+               );
+}
+
+TEST_CASE( "Unit-tests/dma_registers/0010/transfer information flags"
+         , "Control block TI flag and PERMAP field values are as documented"
+         )
+{
+  CHECK(dma_control_block::ti_wait_resp==0x8U);
+  CHECK(dma_control_block::ti_dest_inc==0x10U);
+  CHECK(dma_control_block::ti_dest_dreq==0x40U);
+  CHECK(dma_control_block::ti_src_inc==0x100U);
+  CHECK(dma_control_block::ti_src_dreq==0x400U);
+  CHECK(dma_control_block::ti_no_wide_bursts==0x4000000U);
+  CHECK(dma_control_block::ti_permap(dma_dreq::pwm)==0x50000U);
+  CHECK(dma_control_block::ti_permap(dma_dreq::spi_tx)==0x60000U);
+  CHECK(dma_control_block::ti_permap(dma_dreq::spi_rx)==0x70000U);
+}
+
+TEST_CASE( "Unit-tests/dma_registers/0020/start, reset and enable channel"
+         , "Starting a channel sets CONBLK_AD and activates; reset writes "
+           "reset; enabling sets channel bit"
+         )
+{
+  dma_registers regs;
+  std::memset(&regs, 0, sizeof(regs));
+  regs.channel[3].start(0xC0001000U, 4U, 9U);
+  CHECK(regs.channel[3].control_block_address==0xC0001000U);
+  CHECK(regs.channel[3].control_and_status==0x10940007U);
+  CHECK(regs.channel[3].is_active());
+  CHECK_FALSE(regs.channel[3].has_error());
+  regs.channel[3].reset();
+  CHECK(regs.channel[3].control_and_status==0x80000000U);
+  CHECK(regs.channel[3].control_block_address==0U);
+  CHECK_FALSE(regs.channel[3].is_active());
+  regs.enable_channel(6U);
+  regs.enable_channel(0U);
+  CHECK(regs.enable==0x41U);
+}
@@ -0,0 +1,37 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file edge_event_stream_platformtests.cpp
+/// @brief System tests for the edge event stream type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "edge_event_stream.h"
+
+using namespace dibase::rpi::peripherals;
+
+static pin_id const stream_pin_id{21}; // P1 pin GPIO_GEN2
+
+TEST_CASE( "Platform_tests/edge_event_stream/000/bad construction fails"
+         , "Creating an edge_event_stream with no sources or a bad capacity "
+           "throws"
+         )
+{
+  pin_line_event evt{stream_pin_id, pin_edge_event::both};
+  REQUIRE_THROWS_AS((edge_event_stream{{}, 16U}), std::invalid_argument);
+  REQUIRE_THROWS_AS((edge_event_stream{{&evt}, 15U}), std::invalid_argument);
+}
+
+TEST_CASE( "Platform_tests/edge_event_stream/010/no edges pops nothing"
+         , "An edge_event_stream with no edges occurring pops no events and "
+           "stops cleanly on destruction"
+         )
+{
+  pin_line_event evt{stream_pin_id, pin_edge_event::both};
+  edge_event_stream stream{{&evt}, 16U, 0};
+  CHECK(stream.capacity()==16U);
+  edge_event_record events[4];
+  std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  CHECK(stream.pop(events, 4U)==0U);
+  CHECK(stream.overruns()==0U);
+}
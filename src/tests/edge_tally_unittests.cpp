@@ -0,0 +1,58 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file edge_tally_unittests.cpp
+/// @brief Unit tests for counting edges in GPIO pin level samples.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "edge_tally.h"
+#include <cstdint>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef std::uint32_t RegisterType;
+
+TEST_CASE( "Unit-tests/edge_tally/0000/count edges"
+         , "Rising, falling or both edges are counted for each pin in either "
+           "bank, other pins' changes being ignored"
+         )
+{
+  RegisterType const samples[][2]
+                        { {0x00000000U, 0x00000000U}
+                        , {0x00000011U, 0x00000002U}
+                        , {0x00000010U, 0x00000000U}
+                        , {0x00000001U, 0x00000002U}
+                        , {0x00000000U, 0x00000000U}
+                        };
+// Pins 4, 0 and 33 (bank 1 bit 1); pin 5 never changes
+  std::vector<unsigned> const pins{4U, 0U, 33U, 5U};
+  std::uint32_t rising_counts[4]{0U, 0U, 0U, 0U};
+  std::uint32_t falling_counts[4]{0U, 0U, 0U, 0U};
+  std::uint32_t both_counts[4]{0U, 0U, 0U, 0U};
+  edge_tally rising{pins, true, false};
+  edge_tally falling{pins, false, true};
+  edge_tally both{pins, true, true};
+  rising.start(samples[0]);
+  falling.start(samples[0]);
+  both.start(samples[0]);
+  for (unsigned idx=1; idx!=5U; ++idx)
+    {
+      rising.add(samples[idx], rising_counts);
+      falling.add(samples[idx], falling_counts);
+      both.add(samples[idx], both_counts);
+    }
+  CHECK(rising_counts[0]==1U);
+  CHECK(rising_counts[1]==2U);
+  CHECK(rising_counts[2]==2U);
+  CHECK(rising_counts[3]==0U);
+  CHECK(falling_counts[0]==1U);
+  CHECK(falling_counts[1]==2U);
+  CHECK(falling_counts[2]==2U);
+  CHECK(falling_counts[3]==0U);
+  CHECK(both_counts[0]==2U);
+  CHECK(both_counts[1]==4U);
+  CHECK(both_counts[2]==4U);
+  CHECK(both_counts[3]==0U);
+}
@@ -0,0 +1,87 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file edge_timing_unittests.cpp
+/// @brief Unit tests for the edge_timing sliding window type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "edge_timing.h"
+#include <stdexcept>
+
+using namespace dibase::rpi::peripherals;
+
+namespace
+{
+  system_timer::time_point at_us(system_timer::rep us)
+  {
+    return system_timer::time_point{system_timer::duration{us}};
+  }
+}
+
+TEST_CASE( "Unit-tests/edge_timing/0000/bad window"
+         , "Constructing an edge_timing with a window of fewer than two "
+           "timestamps throws std::invalid_argument"
+         )
+{
+  REQUIRE_THROWS_AS(edge_timing{0U}, std::invalid_argument);
+  REQUIRE_THROWS_AS(edge_timing{1U}, std::invalid_argument);
+  edge_timing et{2U};
+  CHECK(et.window()==2U);
+}
+
+TEST_CASE( "Unit-tests/edge_timing/0010/too few edges"
+         , "With fewer than two edges recorded intervals, span and frequency "
+           "are zero"
+         )
+{
+  edge_timing et{4U};
+  CHECK(et.size()==0U);
+  CHECK(et.last_interval()==std::chrono::nanoseconds::zero());
+  et.record(at_us(1000));
+  CHECK(et.size()==1U);
+  CHECK(et.min_interval()==std::chrono::nanoseconds::zero());
+  CHECK(et.max_interval()==std::chrono::nanoseconds::zero());
+  CHECK(et.span()==std::chrono::nanoseconds::zero());
+  CHECK(et.frequency().count()==0.0);
+}
+
+TEST_CASE( "Unit-tests/edge_timing/0020/intervals and frequency"
+         , "Intervals and frequency are computed from the recorded edges"
+         )
+{
+  edge_timing et{4U};
+  et.record(at_us(1000));
+  et.record(at_us(1100));
+  et.record(at_us(1190));
+  et.record(at_us(1300));
+  CHECK(et.size()==4U);
+  CHECK(et.last_interval()==std::chrono::microseconds{110});
+  CHECK(et.min_interval()==std::chrono::microseconds{90});
+  CHECK(et.max_interval()==std::chrono::microseconds{110});
+  CHECK(et.span()==std::chrono::microseconds{300});
+  CHECK(et.frequency().count()==Approx(10000.0));
+}
+
+TEST_CASE( "Unit-tests/edge_timing/0030/window slides"
+         , "Recording into a full window drops the oldest edge; reset empties "
+           "the window"
+         )
+{
+  edge_timing et{3U};
+  et.record(std::chrono::nanoseconds{0});
+  et.record(std::chrono::nanoseconds{1000});
+  et.record(std::chrono::nanoseconds{1500});
+  et.record(std::chrono::nanoseconds{2000});
+  et.record(std::chrono::nanoseconds{2500});
+  CHECK(et.size()==3U);
+  CHECK(et.max_interval()==std::chrono::nanoseconds{500});
+  CHECK(et.span()==std::chrono::nanoseconds{1000});
+  CHECK(et.frequency().count()==Approx(2.0e6));
+  et.reset();
+  CHECK(et.size()==0U);
+  et.record(std::chrono::nanoseconds{5000});
+  et.record(std::chrono::nanoseconds{5100});
+  CHECK(et.last_interval()==std::chrono::nanoseconds{100});
+}
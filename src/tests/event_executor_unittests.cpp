@@ -0,0 +1,133 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file event_executor_unittests.cpp
+/// @brief Unit tests for event_executor type.
+///
+/// Edge events need GPIO pins so these tests use periodic_timers, posted
+/// handlers and io_service calls, none of which need hardware.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "event_executor.h"
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/event_executor/0000/posted handlers run by run"
+         , "Handlers posted to an executor are run in order by a thread "
+           "calling run, which returns once stopped"
+         )
+{
+  event_executor ex;
+  std::vector<int> order;
+  ex.post([&order]{ order.push_back(1); });
+  ex.post([&order]{ order.push_back(2); });
+  ex.post([]{ throw std::runtime_error{"failed"}; });
+  ex.post([&ex]{ ex.stop(); });
+  ex.run();
+  REQUIRE(order.size()==2U);
+  CHECK(order[0]==1);
+  CHECK(order[1]==2);
+  CHECK(ex.failed_handlers()==1U);
+  CHECK(ex.is_stopped());
+}
+
+TEST_CASE( "Unit-tests/event_executor/0010/timer waits run handlers"
+         , "Waits on several periodic_timers run their handlers once each "
+           "deadline passes, and may be restarted by the handler"
+         )
+{
+  event_executor ex;
+  periodic_timer fast{std::chrono::milliseconds{2}};
+  periodic_timer slow{std::chrono::milliseconds{5}};
+  unsigned fast_count{0U};
+  unsigned slow_count{0U};
+  std::function<void()> on_fast;
+  on_fast = [&]()
+            {
+              fast.acknowledge();
+              if (++fast_count!=3U)
+                {
+                  ex.async_wait(fast, on_fast);
+                }
+            };
+  ex.async_wait(fast, on_fast);
+  ex.async_wait(slow, [&]()
+                      {
+                        slow.acknowledge();
+                        ++slow_count;
+                        ex.stop();
+                      }
+               );
+  REQUIRE_THROWS_AS(ex.async_wait(slow, []{}), std::logic_error);
+  ex.run();
+  CHECK(fast_count>=2U);
+  CHECK(slow_count==1U);
+  ex.cancel(fast);
+}
+
+TEST_CASE( "Unit-tests/event_executor/0020/cancelled wait handler not run"
+         , "A cancelled wait's handler is not run and the timer may be "
+           "waited on again"
+         )
+{
+  event_executor ex;
+  periodic_timer t{std::chrono::milliseconds{1}};
+  bool cancelled_run{false};
+  ex.async_wait(t, [&cancelled_run]{ cancelled_run = true; });
+  ex.cancel(t);
+  std::this_thread::sleep_for(std::chrono::milliseconds{3});
+  ex.async_wait(t, [&ex]{ ex.stop(); });
+  ex.run();
+  CHECK_FALSE(cancelled_run);
+}
+
+TEST_CASE( "Unit-tests/event_executor/0030/async_call passes result"
+         , "async_call runs a call on an io_service thread and passes its "
+           "result or exception to a handler run by the executor"
+         )
+{
+  io_service svc{8U};
+  event_executor ex;
+  std::thread::id call_thread;
+  std::thread::id handler_thread;
+  int result{0};
+  bool threw{false};
+  ex.async_call( svc
+               , [&call_thread]()
+                 {
+                   call_thread = std::this_thread::get_id();
+                   return 42;
+                 }
+               , [&](std::future<int> f)
+                 {
+                   handler_thread = std::this_thread::get_id();
+                   result = f.get();
+                 }
+               );
+  ex.async_call( svc
+               , []{ throw std::runtime_error{"failed"}; }
+               , [&](std::future<void> f)
+                 {
+                   try
+                     {
+                       f.get();
+                     }
+                   catch (std::runtime_error &)
+                     {
+                       threw = true;
+                     }
+                   ex.stop();
+                 }
+               );
+  ex.run();
+  CHECK(result==42);
+  CHECK(threw);
+  CHECK(call_thread!=std::this_thread::get_id());
+  CHECK(handler_thread==std::this_thread::get_id());
+}
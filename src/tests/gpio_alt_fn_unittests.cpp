@@ -501,3 +501,151 @@ TEST_CASE( "Unit-tests/pin_alt_fn::select/0110/select some specific special fn f
   CHECK(pafrs[1].alt_fn()==gpio_pin_fn::alt5);
   CHECK(pafrs[1].special_fn()==gpio_special_fn::gpclk1);
 }
+
+TEST_CASE( "Unit-tests/pin_alt_fn::select/0120/special fn selects match table"
+         , "Selecting by special function returns the same items, in the same "
+           "order, as searching all pins' alt functions for the special "
+           "function, including for duplicated special functions in a list."
+         )
+{
+  auto all=result_set(select(select_options::include_no_fn));
+  for ( auto s=static_cast<int>(gpio_special_fn::no_fn)
+      ; s<=static_cast<int>(gpio_special_fn::spi6_sclk)
+      ; ++s
+      )
+    {
+      gpio_special_fn const specl_fn{static_cast<gpio_special_fn>(s)};
+      auto pafrs=result_set(select(specl_fn));
+      std::size_t idx{0U};
+      for (auto const & d : all)
+        {
+          if (d.special_fn()==specl_fn)
+            {
+              REQUIRE(idx<pafrs.size());
+              CHECK(pafrs[idx].pin()==d.pin());
+              CHECK(pafrs[idx].alt_fn()==d.alt_fn());
+              ++idx;
+            }
+        }
+      CHECK(idx==pafrs.size());
+    }
+  auto pafrs=result_set(select({ gpio_special_fn::gpclk1
+                               , gpio_special_fn::gpclk0
+                               , gpio_special_fn::gpclk1
+                               }
+                              )
+                       );
+  REQUIRE(pafrs.size()==8U);
+  for (std::size_t idx{1U}; idx!=pafrs.size(); ++idx)
+    {
+      CHECK(pafrs[idx-1].pin()<pafrs[idx].pin());
+    }
+}
+
+TEST_CASE( "Unit-tests/pin_alt_fn::result_set_builder/0040/capacity"
+         , "A builder holds results for every pin alt function and no more"
+         )
+{
+  result_set_builder pafrsb;
+  for (std::size_t idx{0U}; idx!=max_results; ++idx)
+    {
+      pafrsb.emplace_add(pin_id{4}, gpio_pin_fn::alt0, gpio_special_fn::gpclk0);
+    }
+  CHECK(pafrsb.size()==max_results);
+  CHECK_THROWS_AS( pafrsb.emplace_add( pin_id{4}, gpio_pin_fn::alt0
+                                     , gpio_special_fn::gpclk0
+                                     )
+                 , std::length_error
+                 );
+  result_set pafrs{pafrsb};
+  CHECK(pafrs.size()==max_results);
+  CHECK(pafrsb.empty());
+}
+
+TEST_CASE( "Unit-tests/pin_alt_fn::view/0000/view pin alt functions"
+         , "Viewing a pin gives descriptors for all its alt functions in "
+           "alt0...alt5 order"
+         )
+{
+  auto v=view(pin_id{4});
+  REQUIRE(v.size()==number_of_alt_fns_per_pin);
+  CHECK_FALSE(v.empty());
+  auto const pafrs=result_set(select(pin_id{4}, select_options::include_no_fn));
+  REQUIRE(pafrs.size()==v.size());
+  std::size_t idx{0U};
+  for (auto d : v)
+    {
+      CHECK(d.pin()==4U);
+      CHECK(d.alt_fn()==pafrs[idx].alt_fn());
+      CHECK(d.special_fn()==pafrs[idx].special_fn());
+      ++idx;
+    }
+  CHECK((*v.begin()).alt_fn()==gpio_pin_fn::alt0);
+  CHECK((*v.begin()).special_fn()==gpio_special_fn::gpclk0);
+}
+
+TEST_CASE( "Unit-tests/pin_alt_fn::view/0010/view special function"
+         , "Viewing a special function gives descriptors for the pin alt "
+           "functions having it in pin order"
+         )
+{
+  auto v=view(gpio_special_fn::gpclk0);
+// GPCLK0 function instances read from datasheet table 6-31
+  REQUIRE(v.size()==4U);
+  unsigned const expected_pins[]{4U, 20U, 32U, 34U};
+  std::size_t idx{0U};
+  for (auto it=v.begin(); it!=v.end(); ++it, ++idx)
+    {
+      CHECK((*it).pin()==expected_pins[idx]);
+      CHECK((*it).special_fn()==gpio_special_fn::gpclk0);
+    }
+  CHECK(view(gpio_special_fn::no_fn).size()
+                            ==result_set(select(select_options::include_no_fn))
+                                .size()-result_set(select()).size()
+       );
+}
+
+TEST_CASE( "Unit-tests/pin_alt_fn::special_fn_of/0000/per SoC special fns"
+         , "The BCM2711 has the BCM2835 alternative functions plus BSC3..6 "
+           "and SPI3..6, and moves the BSC slave functions to pins 8..11"
+         )
+{
+  using dibase::rpi::rpi_processor;
+  CHECK(special_fn_of(pin_id{0}, gpio_pin_fn::alt0, rpi_processor::bcm2835)
+        ==gpio_special_fn::sda0);
+  CHECK(special_fn_of(pin_id{0}, gpio_pin_fn::alt0, rpi_processor::bcm2711)
+        ==gpio_special_fn::sda0);
+  CHECK(special_fn_of(pin_id{4}, gpio_pin_fn::alt5, rpi_processor::bcm2835)
+        ==gpio_special_fn::arm_tdi);
+  CHECK(special_fn_of(pin_id{4}, gpio_pin_fn::alt5, rpi_processor::bcm2711)
+        ==gpio_special_fn::sda3);
+  CHECK(special_fn_of(pin_id{2}, gpio_pin_fn::alt3, rpi_processor::bcm2837)
+        ==gpio_special_fn::no_fn);
+  CHECK(special_fn_of(pin_id{2}, gpio_pin_fn::alt3, rpi_processor::bcm2711)
+        ==gpio_special_fn::spi3_mosi);
+  CHECK(special_fn_of(pin_id{18}, gpio_pin_fn::alt3, rpi_processor::bcm2835)
+        ==gpio_special_fn::bscsl_sda_mosi);
+  CHECK(special_fn_of(pin_id{18}, gpio_pin_fn::alt3, rpi_processor::bcm2711)
+        ==gpio_special_fn::spi6_ce0_n);
+  CHECK(special_fn_of(pin_id{10}, gpio_pin_fn::alt3, rpi_processor::bcm2711)
+        ==gpio_special_fn::bscsl_sda_mosi);
+  CHECK(special_fn_of(pin_id{27}, gpio_pin_fn::alt5, rpi_processor::bcm2711)
+        ==gpio_special_fn::spi6_ce1_n);
+  CHECK(special_fn_of(pin_id{27}, gpio_pin_fn::output, rpi_processor::bcm2711)
+        ==gpio_special_fn::no_fn);
+}
+
+TEST_CASE( "Unit-tests/pin_alt_fn::special_fn_of/0010/running SoC selects"
+         , "The select functions describe the running SoC's alternative "
+           "functions as given by special_fn_of"
+         )
+{
+  bool const bcm2711{ select(pin_id{2}, gpio_special_fn::sda3).size()==1U };
+  auto const soc( bcm2711 ? dibase::rpi::rpi_processor::bcm2711
+                          : dibase::rpi::rpi_processor::bcm2835
+                );
+  for (auto const & d : result_set(select(select_options::include_no_fn)))
+    {
+      CHECK(d.special_fn()==special_fn_of(d.pin(), d.alt_fn(), soc));
+    }
+}
@@ -0,0 +1,65 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_capture_platformtests.cpp
+/// @brief System tests for the DMA sampled GPIO level capture type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "gpio_capture.h"
+#include "pin.h"
+#include "pwm_pin.h"
+#include "periexcept.h"
+#include <sstream>
+
+using namespace dibase::rpi::peripherals;
+
+// Change if P1 GPIO_GEN0/GPIO_GEN3 in use on your system...
+static pin_id const capture_pin_id_0{17}; // P1 pin GPIO_GEN0
+static pin_id const capture_pin_id_1{22}; // P1 pin GPIO_GEN3
+static pin_id const hw_pwm_pin_id{18};    // P1 pin GPIO_GEN1, PWM0
+
+TEST_CASE( "Platform_tests/gpio_capture/000/bad parameters fail"
+         , "Creating a gpio_capture with a bad sample rate or pin mask throws"
+         )
+{
+  REQUIRE_THROWS_AS(gpio_capture{hertz{0U}}, std::invalid_argument);
+  REQUIRE_THROWS_AS(gpio_capture{megahertz{2U}}, std::invalid_argument);
+  REQUIRE_THROWS_AS((gpio_capture{kilohertz{100U}, ~all_gpio_pins})
+                   , std::invalid_argument
+                   );
+}
+
+TEST_CASE( "Platform_tests/gpio_capture/010/PWM in use fails"
+         , "Creating a gpio_capture while PWM is in use throws"
+         )
+{
+  pwm_pin hw_pwm{hw_pwm_pin_id};
+  REQUIRE_THROWS_AS(gpio_capture{kilohertz{100U}}, peripheral_in_use);
+}
+
+TEST_CASE( "Platform_tests/gpio_capture/020/capture pulled pins"
+         , "Capturing pulled up and down pins gives one run of all samples "
+           "with the pulled levels, which reads back from a stream"
+         )
+{
+  ipin pulled_up{capture_pin_id_0, ipin::pull_up};
+  ipin pulled_down{capture_pin_id_1, ipin::pull_down};
+  std::uint64_t const mask{ (std::uint64_t(1)<<capture_pin_id_0)
+                          | (std::uint64_t(1)<<capture_pin_id_1)
+                          };
+  gpio_capture capture{kilohertz{500U}, mask};
+  CHECK(capture.sample_rate().count()==Approx(500000.0));
+  CHECK(capture.pin_mask()==mask);
+  std::stringstream stream;
+  gpio_capture_header const header{capture.capture(100000U, stream)};
+  CHECK(header.sample_period_ps==2000000U);
+  CHECK(header.pin_mask==mask);
+  gpio_rle_reader reader{stream};
+  CHECK(reader.header().start_us==header.start_us);
+  gpio_level_run run;
+  REQUIRE(reader.read(run));
+  CHECK(run.levels==(std::uint64_t(1)<<capture_pin_id_0));
+  CHECK(run.length==100000U);
+  CHECK_FALSE(reader.read(run));
+}
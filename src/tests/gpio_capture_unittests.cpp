@@ -0,0 +1,91 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_capture_unittests.cpp
+/// @brief Unit tests for GPIO level run encoding and the run-length encoded
+/// capture stream format.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "gpio_capture.h"
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/gpio_run_encoder/0000/runs"
+         , "Samples with the same masked levels are combined into runs"
+         )
+{
+  gpio_run_encoder encoder{0x3U};
+  gpio_level_run run{0U, 0U};
+  CHECK_FALSE(encoder.flush(run));
+  CHECK_FALSE(encoder.add(0x1U, run));
+  CHECK_FALSE(encoder.add(0x5U, run)); // pin 2 not in mask
+  CHECK_FALSE(encoder.add(0x1U, run));
+  REQUIRE(encoder.add(0x3U, run));
+  CHECK(run.levels==0x1U);
+  CHECK(run.length==3U);
+  CHECK_FALSE(encoder.add(0x3U, run));
+  REQUIRE(encoder.flush(run));
+  CHECK(run.levels==0x3U);
+  CHECK(run.length==2U);
+  CHECK_FALSE(encoder.flush(run));
+}
+
+TEST_CASE( "Unit-tests/gpio_rle_writer/0000/round trip"
+         , "Runs written by a gpio_rle_writer are read back by a "
+           "gpio_rle_reader"
+         )
+{
+  gpio_capture_header const header{100000U, all_gpio_pins, 0x123456789ULL};
+  std::vector<gpio_level_run> const runs
+                                  { {0x0U, 1U}
+                                  , {0x20000U, 300U}
+                                  , {0x20000U|(std::uint64_t(1)<<53), 7U}
+                                  , {0x0U, 1000000000000ULL}
+                                  };
+  std::stringstream stream;
+  gpio_rle_writer writer{stream, header};
+  for (auto const & run : runs)
+    {
+      writer.write(run);
+    }
+  CHECK(stream.str().size()==8U+24U+2U+5U+9U+14U);
+  gpio_rle_reader reader{stream};
+  CHECK(reader.header().sample_period_ps==header.sample_period_ps);
+  CHECK(reader.header().pin_mask==header.pin_mask);
+  CHECK(reader.header().start_us==header.start_us);
+  gpio_level_run run;
+  for (auto const & expected : runs)
+    {
+      REQUIRE(reader.read(run));
+      CHECK(run.levels==expected.levels);
+      CHECK(run.length==expected.length);
+    }
+  CHECK_FALSE(reader.read(run));
+}
+
+TEST_CASE( "Unit-tests/gpio_rle_reader/0010/bad streams"
+         , "Reading a stream with a bad header or truncated runs throws"
+         )
+{
+  std::stringstream bad_magic{"DBGPCAP2"+std::string(24U, '\0')};
+  REQUIRE_THROWS_AS(gpio_rle_reader{bad_magic}, std::runtime_error);
+  std::stringstream short_header{"DBGPCAP1"+std::string(23U, '\0')};
+  REQUIRE_THROWS_AS(gpio_rle_reader{short_header}, std::runtime_error);
+
+  std::stringstream stream;
+  gpio_rle_writer writer{stream, gpio_capture_header{1U, 1U, 0U}};
+  writer.write(gpio_level_run{1U, 200U});
+  std::string const complete{stream.str()};
+  gpio_level_run run;
+  std::stringstream truncated_run{complete.substr(0U, complete.size()-2U)};
+  gpio_rle_reader run_reader{truncated_run};
+  REQUIRE_THROWS_AS(run_reader.read(run), std::runtime_error);
+  std::stringstream truncated_value{complete.substr(0U, complete.size()-1U)};
+  gpio_rle_reader value_reader{truncated_value};
+  REQUIRE_THROWS_AS(value_reader.read(run), std::runtime_error);
+}
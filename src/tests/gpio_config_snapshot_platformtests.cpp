@@ -0,0 +1,58 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_config_snapshot_platformtests.cpp
+/// @brief System tests for GPIO pin configuration snapshots.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "gpio_config_snapshot.h"
+#include "pin.h"
+#include "periexcept.h"
+#include "gpio_ctrl.h"
+#include "gpio_pull.h"
+
+using namespace dibase::rpi::peripherals;
+
+namespace
+{
+// Change if P1 GPIO_GEN0/GPIO_GEN1 in use on your system...
+  pin_id const snapshot_pin_a{17};  // P1 pin GPIO_GEN0
+  pin_id const snapshot_pin_b{18};  // P1 pin GPIO_GEN1
+}
+
+TEST_CASE( "Platform-tests/gpio_config_snapshot/0000/restore configuration"
+         , "Restoring a snapshot returns its pins' functions and pulls to "
+           "those captured"
+         )
+{
+  using internal::gpio_ctrl;
+  using internal::gpio_pin_fn;
+  gpio_config_snapshot all{{snapshot_pin_a, snapshot_pin_b}};
+  CHECK(all.covers(snapshot_pin_a));
+  CHECK_FALSE(all.covers(pin_id(4)));
+  all.allocate_pins();
+  REQUIRE_THROWS_AS(opin{snapshot_pin_a}, bad_peripheral_alloc);
+  auto & config(gpio_ctrl::instance().config);
+  config.set_pin_function(snapshot_pin_a, gpio_pin_fn::output);
+  config.set_pin_function(snapshot_pin_b, gpio_pin_fn::input);
+  internal::apply_pull(snapshot_pin_b, ipin::pull_up);
+  gpio_config_snapshot personality_1{{snapshot_pin_a, snapshot_pin_b}};
+  config.set_pin_function(snapshot_pin_a, gpio_pin_fn::input);
+  config.set_pin_function(snapshot_pin_b, gpio_pin_fn::output);
+  internal::apply_pull(snapshot_pin_a, ipin::pull_down);
+  internal::apply_pull(snapshot_pin_b, ipin::pull_disable);
+  gpio_config_snapshot personality_2{{snapshot_pin_a, snapshot_pin_b}};
+  personality_1.restore();
+  CHECK(config.pin_function(snapshot_pin_a)==gpio_pin_fn::output);
+  CHECK(config.pin_function(snapshot_pin_b)==gpio_pin_fn::input);
+  CHECK(config.pulled_pins(ipin::pull_up, 0U)&(1U<<snapshot_pin_b));
+  personality_2.restore();
+  CHECK(config.pin_function(snapshot_pin_a)==gpio_pin_fn::input);
+  CHECK(config.pin_function(snapshot_pin_b)==gpio_pin_fn::output);
+  CHECK(config.pulled_pins(ipin::pull_down, 0U)&(1U<<snapshot_pin_a));
+  internal::apply_pull(snapshot_pin_a, ipin::pull_disable);
+  config.set_pin_function(snapshot_pin_b, gpio_pin_fn::input);
+  all.deallocate_pins();
+  opin o{snapshot_pin_a}; // should throw if pin still allocated
+}
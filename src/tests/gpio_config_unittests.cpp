@@ -0,0 +1,143 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_config_unittests.cpp
+/// @brief Unit tests for the internal gpio_config GPIO configuration register
+/// update type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "gpio_config.h"
+#include <cstring>
+#include <memory>
+
+using namespace dibase::rpi::peripherals;
+using namespace dibase::rpi::peripherals::internal;
+
+namespace
+{
+  std::unique_ptr<gpio_registers> make_registers()
+  {
+    std::unique_ptr<gpio_registers> regs{new gpio_registers};
+    std::memset(regs.get(), 0, sizeof(gpio_registers));
+    return regs;
+  }
+}
+
+TEST_CASE( "Unit-tests/gpio_config/0000/unshadowed updates"
+         , "Without shadowing updates read-modify-write the registers"
+         )
+{
+  auto regs(make_registers());
+  gpio_config config{regs.get()};
+  CHECK_FALSE(config.is_shadowed());
+  regs->gpfsel[1] = 0x3fffffffU;
+  config.set_pin_function(pin_id(12U), gpio_pin_fn::alt0);
+  CHECK(regs->gpfsel[1]==((0x3fffffffU&~(7U<<6))|(4U<<6)));
+  CHECK(config.pin_function(pin_id(12U))==gpio_pin_fn::alt0);
+  regs->gpfsel[1] = 0U;
+  CHECK(config.pin_function(pin_id(12U))==gpio_pin_fn::input);
+  regs->gpren[1] = 0x100U;
+  config.set_detect_enables(gpio_detect_enable::rising, 1U, 0x3U, true);
+  CHECK(regs->gpren[1]==0x103U);
+  config.set_detect_enables(gpio_detect_enable::async_falling,0U,0x10U,true);
+  CHECK(regs->gpafen[0]==0x10U);
+  CHECK(config.detect_enables(gpio_detect_enable::async_falling, 0U)==0x10U);
+}
+
+TEST_CASE( "Unit-tests/gpio_config/0010/shadowed updates"
+         , "With shadowing updates use and maintain the shadow copy"
+         )
+{
+  auto regs(make_registers());
+  gpio_config config{regs.get()};
+  regs->gpfsel[0] = 1U<<3;          // pin 1 output
+  regs->gpfen[0] = 0x80000000U;
+  config.enable_shadow();
+  CHECK(config.is_shadowed());
+  CHECK(config.pin_function(pin_id(1U))==gpio_pin_fn::output);
+  CHECK(config.detect_enables(gpio_detect_enable::falling, 0U)==0x80000000U);
+// Changes made behind the shadow's back are not seen...
+  regs->gpfsel[0] = 0U;
+  CHECK(config.pin_function(pin_id(1U))==gpio_pin_fn::output);
+// ...and are overwritten by updates made from the shadow
+  config.set_pin_function(pin_id(2U), gpio_pin_fn::alt5);
+  CHECK(regs->gpfsel[0]==((1U<<3)|(2U<<6)));
+  CHECK(config.pin_function(pin_id(2U))==gpio_pin_fn::alt5);
+  config.set_detect_enables(gpio_detect_enable::falling, 0U, 1U, true);
+  CHECK(regs->gpfen[0]==0x80000001U);
+  regs->gpfsel[0] = 0U;
+  config.resync();
+  CHECK(config.pin_function(pin_id(1U))==gpio_pin_fn::input);
+  config.disable_shadow();
+  CHECK_FALSE(config.is_shadowed());
+  regs->gpfsel[0] = 1U<<3;
+  CHECK(config.pin_function(pin_id(1U))==gpio_pin_fn::output);
+}
+
+TEST_CASE( "Unit-tests/gpio_config/0020/set_pin_functions"
+         , "Several pin functions set in one update per GPFSELn word"
+         )
+{
+  auto regs(make_registers());
+  gpio_config config{regs.get()};
+  config.enable_shadow();
+  gpio_pin_fn_setting const settings[]
+  { {pin_id(0U), gpio_pin_fn::output}
+  , {pin_id(9U), gpio_pin_fn::alt3}
+  , {pin_id(53U), gpio_pin_fn::alt1}
+  };
+  config.set_pin_functions(settings, settings+3);
+  CHECK(regs->gpfsel[0]==(1U|(7U<<27)));
+  CHECK(regs->gpfsel[5]==(5U<<9));
+  CHECK(config.pin_function(pin_id(9U))==gpio_pin_fn::alt3);
+  CHECK(config.pin_function(pin_id(53U))==gpio_pin_fn::alt1);
+}
+
+TEST_CASE( "Unit-tests/gpio_config/0030/capture and restore"
+         , "Only configuration fields of the pins given are captured and "
+           "only words in which they differ are written on restore"
+         )
+{
+  auto regs(make_registers());
+  gpio_config config{regs.get()};
+  std::uint32_t const pins[2]{(1U<<3)|(1U<<31), 1U<<(53U-32U)};
+  regs->gpfsel[0] = 0x3fffffffU;    // pins 0..9 all alt3
+  regs->gpfsel[3] = 1U<<3;          // pin 31 output
+  regs->gpren[0] = 0xffffffffU;
+  regs->gplen[1] = 1U<<(53U-32U);
+  std::uint32_t fsels[gpio_config::fsel_words];
+  std::uint32_t detects[number_of_gpio_detect_enables][2];
+  config.capture(pins, fsels, detects);
+  CHECK(fsels[0]==(7U<<9));
+  CHECK(fsels[3]==(1U<<3));
+  CHECK(fsels[5]==0U);
+  CHECK(detects[0][0]==((1U<<3)|(1U<<31)));
+  CHECK(detects[3][1]==(1U<<(53U-32U)));
+  CHECK(config.restore(pins, fsels, detects)==0U);
+  regs->gpfsel[0] = 0U;
+  regs->gpren[0] = 0U;
+  regs->gplen[1] = 0U;
+  CHECK(config.restore(pins, fsels, detects)==3U);
+  CHECK(regs->gpfsel[0]==(7U<<9));
+  CHECK(regs->gpfsel[3]==(1U<<3));
+  CHECK(regs->gpren[0]==((1U<<3)|(1U<<31)));
+  CHECK(regs->gplen[1]==(1U<<(53U-32U)));
+}
+
+TEST_CASE( "Unit-tests/gpio_config/0040/record pulls"
+         , "Recording pulls moves pins between the logical pull states"
+         )
+{
+  auto regs(make_registers());
+  gpio_config config{regs.get()};
+  CHECK(config.pulled_pins(0U, 0U)==0U);
+  config.record_pulls(0x3U, 0x1U, 1U);
+  CHECK(config.pulled_pins(1U, 0U)==0x3U);
+  CHECK(config.pulled_pins(1U, 1U)==0x1U);
+  config.record_pulls(0x2U, 0U, 0U);
+  CHECK(config.pulled_pins(1U, 0U)==0x1U);
+  CHECK(config.pulled_pins(0U, 0U)==0x2U);
+  CHECK(config.pulled_pins(2U, 0U)==0U);
+}
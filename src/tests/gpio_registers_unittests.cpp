@@ -16,6 +16,7 @@
 #include "gpio_registers.h"
 #include <cstring>
 #include <cstdint>
+#include <iterator>
 
 using namespace dibase::rpi::peripherals::internal;
 using namespace dibase::rpi::peripherals;
@@ -129,6 +130,39 @@ TEST_CASE( "Unit-tests/one_bit_field_register/clear_all_bits"
   CHECK( r[1] == 0 );
 }
 
+TEST_CASE( "Unit-tests/one_bit_field_register/set_bits"
+         , "Setting bits in one word sets only those bits in that word"
+         )
+{
+  one_bit_field_register r;
+  // initially start with all bytes of r set to 0:
+  std::memset(&r, 0, sizeof(r));
+  r.set_bits(0, 0x80000011U);
+  CHECK( r[0] == 0x80000011U );
+  CHECK( r[1] == 0U );
+  r.set_bits(0, 0x00000101U);
+  CHECK( r[0] == 0x80000111U );
+  r.set_bits(1, 0x00200003U);
+  CHECK( r[0] == 0x80000111U );
+  CHECK( r[1] == 0x00200003U );
+}
+
+TEST_CASE( "Unit-tests/one_bit_field_register/clear_bits"
+         , "Clearing bits in one word clears only those bits in that word"
+         )
+{
+  one_bit_field_register r;
+  // initially start with all bits of r set:
+  r.set_bits(0, ~((RegisterType)0));
+  r.set_bits(1, ~((RegisterType)0));
+  r.clear_bits(0, 0x80000011U);
+  CHECK( r[0] == 0x7FFFFFEEU );
+  CHECK( r[1] == ~((RegisterType)0) );
+  r.clear_bits(1, 0x00200003U);
+  CHECK( r[0] == 0x7FFFFFEEU );
+  CHECK( r[1] == 0xFFDFFFFCU );
+}
+
 TEST_CASE( "Unit-tests/gpio_registers/register-offsets"
          , "Register member offsets should match the documented layout"
          )
@@ -277,6 +311,30 @@ TEST_CASE( "Unit-tests/gpio_registers/set_pin_fn"
   CHECK(gpio_regs.gpfsel[4]==0);
 }
 
+TEST_CASE( "Unit-tests/gpio_registers/set_pin_functions"
+         , "Setting several pins' functions sets just their gpfsel bits"
+         )
+{
+  gpio_registers gpio_regs;
+// start with all bytes of gpio_regs set to 0xFF:
+  std::memset(&gpio_regs, 0xFF, sizeof(gpio_regs));
+  gpio_pin_fn_setting const settings[]
+  { {pin_id(0), gpio_pin_fn::output}  // GPFSEL0 bits 0..2
+  , {pin_id(9), gpio_pin_fn::alt0}    // GPFSEL0 bits 27..29
+  , {pin_id(11), gpio_pin_fn::input}  // GPFSEL1 bits 3..5
+  , {pin_id(53), gpio_pin_fn::alt5}   // GPFSEL5 bits 9..11
+  , {pin_id(52), gpio_pin_fn::alt1}   // GPFSEL5 bits 6..8
+  , {pin_id(52), gpio_pin_fn::alt3}   // GPFSEL5 bits 6..8, overrides alt1
+  };
+  gpio_regs.set_pin_functions(std::begin(settings), std::end(settings));
+  CHECK(gpio_regs.gpfsel[0]==((0xFFFFFFFFU&~0x38000007U)|0x20000001U));
+  CHECK(gpio_regs.gpfsel[1]==(0xFFFFFFFFU&~0x00000038U));
+  CHECK(gpio_regs.gpfsel[2]==0xFFFFFFFFU);
+  CHECK(gpio_regs.gpfsel[3]==0xFFFFFFFFU);
+  CHECK(gpio_regs.gpfsel[4]==0xFFFFFFFFU);
+  CHECK(gpio_regs.gpfsel[5]==((0xFFFFFFFFU&~0x00000FC0U)|0x000005C0U));
+}
+
 TEST_CASE( "Unit-tests/gpio_registers/set_pin"
          , "Setting pin sets associated gpset member bit high"
          )
@@ -313,6 +371,40 @@ TEST_CASE( "Unit-tests/gpio_registers/clear_pin"
     }
 }
 
+TEST_CASE( "Unit-tests/gpio_registers/set_pins"
+         , "Setting pins writes mask to just the requested gpset bank"
+         )
+{
+  gpio_registers gpio_regs;
+// start with all bytes of gpio_regs set to 0:
+  std::memset(&gpio_regs, 0, sizeof(gpio_regs));
+  gpio_regs.set_pins(0, 0x80000011U);
+  CHECK(gpio_regs.gpset[0]==0x80000011U);
+  CHECK(gpio_regs.gpset[1]==0U);
+  CHECK(gpio_regs.gpclr[0]==0U);
+  gpio_regs.set_pins(1, 0x00200003U);
+  CHECK(gpio_regs.gpset[0]==0x80000011U);
+  CHECK(gpio_regs.gpset[1]==0x00200003U);
+  CHECK(gpio_regs.gpclr[1]==0U);
+}
+
+TEST_CASE( "Unit-tests/gpio_registers/clear_pins"
+         , "Clearing pins writes mask to just the requested gpclr bank"
+         )
+{
+  gpio_registers gpio_regs;
+// start with all bytes of gpio_regs set to 0:
+  std::memset(&gpio_regs, 0, sizeof(gpio_regs));
+  gpio_regs.clear_pins(0, 0x80000011U);
+  CHECK(gpio_regs.gpclr[0]==0x80000011U);
+  CHECK(gpio_regs.gpclr[1]==0U);
+  CHECK(gpio_regs.gpset[0]==0U);
+  gpio_regs.clear_pins(1, 0x00200003U);
+  CHECK(gpio_regs.gpclr[0]==0x80000011U);
+  CHECK(gpio_regs.gpclr[1]==0x00200003U);
+  CHECK(gpio_regs.gpset[1]==0U);
+}
+
 TEST_CASE( "Unit-tests/gpio_registers/pin_level"
          , "Requesting a pin's level returns that pin's level"
          )
@@ -335,6 +427,21 @@ TEST_CASE( "Unit-tests/gpio_registers/pin_level"
     }
 }
 
+TEST_CASE( "Unit-tests/gpio_registers/pin_levels"
+         , "Requesting a bank's pin levels returns that bank's gplev value"
+         )
+{
+  gpio_registers gpio_regs;
+// start with all bytes of gpio_regs set to 0:
+  std::memset(&gpio_regs, 0, sizeof(gpio_regs));
+  CHECK(gpio_regs.pin_levels(0)==0U);
+  CHECK(gpio_regs.pin_levels(1)==0U);
+  gpio_regs.gplev[0] = 0x80000011U;
+  gpio_regs.gplev[1] = 0x00200003U;
+  CHECK(gpio_regs.pin_levels(0)==0x80000011U);
+  CHECK(gpio_regs.pin_levels(1)==0x00200003U);
+}
+
 TEST_CASE( "Unit-tests/gpio_registers/pin_event"
          , "Requesting a pin's event status returns that pin's event status"
          )
@@ -375,6 +482,69 @@ TEST_CASE( "Unit-tests/gpio_registers/clear_pin_event"
     }
 }
 
+TEST_CASE( "Unit-tests/gpio_registers/pin_events"
+         , "Requesting a bank's pin events returns that bank's gpeds value"
+         )
+{
+  gpio_registers gpio_regs;
+// start with all bytes of gpio_regs set to 0:
+  std::memset(&gpio_regs, 0, sizeof(gpio_regs));
+  CHECK(gpio_regs.pin_events(0)==0U);
+  CHECK(gpio_regs.pin_events(1)==0U);
+  gpio_regs.gpeds[0] = 0x80000011U;
+  gpio_regs.gpeds[1] = 0x00200003U;
+  CHECK(gpio_regs.pin_events(0)==0x80000011U);
+  CHECK(gpio_regs.pin_events(1)==0x00200003U);
+}
+
+TEST_CASE( "Unit-tests/gpio_registers/clear_pin_events"
+         , "Clearing pin events writes mask to just the requested gpeds bank"
+         )
+{
+  gpio_registers gpio_regs;
+// start with all bytes of gpio_regs set to 0:
+  std::memset(&gpio_regs, 0, sizeof(gpio_regs));
+  gpio_regs.clear_pin_events(1, 0x00200003U);
+  CHECK(gpio_regs.gpeds[0]==0U);
+  CHECK(gpio_regs.gpeds[1]==0x00200003U);
+  gpio_regs.clear_pin_events(0, 0x80000011U);
+  CHECK(gpio_regs.gpeds[0]==0x80000011U);
+  CHECK(gpio_regs.gpeds[1]==0x00200003U);
+}
+
+TEST_CASE( "Unit-tests/gpio_registers/set_edge_detect_banks"
+         , "Setting detect enables for all pins writes both banks of just the "
+           "requested register pair"
+         )
+{
+  gpio_registers gpio_regs;
+// start with all bytes of gpio_regs set to 0:
+  std::memset(&gpio_regs, 0, sizeof(gpio_regs));
+  gpio_regs.set_rising_edge_detect(0x80000001U, 0x00200000U);
+  CHECK(gpio_regs.gpren[0]==0x80000001U);
+  CHECK(gpio_regs.gpren[1]==0x00200000U);
+  CHECK(gpio_regs.gpfen[0]==0U);
+  gpio_regs.set_falling_edge_detect(0x2U, 0x3U);
+  CHECK(gpio_regs.gpfen[0]==0x2U);
+  CHECK(gpio_regs.gpfen[1]==0x3U);
+  gpio_regs.set_high_detect(0x4U, 0x5U);
+  CHECK(gpio_regs.gphen[0]==0x4U);
+  CHECK(gpio_regs.gphen[1]==0x5U);
+  gpio_regs.set_low_detect(0x6U, 0x7U);
+  CHECK(gpio_regs.gplen[0]==0x6U);
+  CHECK(gpio_regs.gplen[1]==0x7U);
+  gpio_regs.set_async_rising_edge_detect(0x8U, 0x9U);
+  CHECK(gpio_regs.gparen[0]==0x8U);
+  CHECK(gpio_regs.gparen[1]==0x9U);
+  gpio_regs.set_async_falling_edge_detect(0xaU, 0xbU);
+  CHECK(gpio_regs.gpafen[0]==0xaU);
+  CHECK(gpio_regs.gpafen[1]==0xbU);
+// Whole register writes, not read-modify-writes:
+  gpio_regs.set_rising_edge_detect(0x1U, 0U);
+  CHECK(gpio_regs.gpren[0]==0x1U);
+  CHECK(gpio_regs.gpren[1]==0U);
+}
+
 TEST_CASE( "Unit-tests/gpio_registers/pin_rising_edge_detect_enable"
          , "Enabling rising edge detect for pin sets appropriate bit in gpren"
          )
@@ -636,6 +806,22 @@ TEST_CASE( "Unit-tests/gpio_registers/assert_pin_pull_up_down_clock"
     }
 }
 
+TEST_CASE( "Unit-tests/gpio_registers/assert_pins_pull_up_down_clock"
+         , "Asserting several pins' pull up/down clocks writes both gppudclk "
+           "registers"
+         )
+{
+  gpio_registers gpio_regs;
+// start with all bytes of gpio_regs set to 0:
+  std::memset(&gpio_regs, 0, sizeof(gpio_regs));
+  gpio_regs.assert_pins_pull_up_down_clock(0x80000011U, 0x00200003U);
+  CHECK(gpio_regs.gppudclk[0]==0x80000011U);
+  CHECK(gpio_regs.gppudclk[1]==0x00200003U);
+  gpio_regs.assert_pins_pull_up_down_clock(0x00000100U, 0U);
+  CHECK(gpio_regs.gppudclk[0]==0x00000100U);
+  CHECK(gpio_regs.gppudclk[1]==0U);
+}
+
 TEST_CASE( "Unit-tests/gpio_registers/remove_all_pin_pull_up_down_clocks"
          , "Removing all pin's pull up/down clocks clears both gppudclk registers"
          )
@@ -647,3 +833,43 @@ TEST_CASE( "Unit-tests/gpio_registers/remove_all_pin_pull_up_down_clocks"
   CHECK(gpio_regs.gppudclk[0]==0);
   CHECK(gpio_regs.gppudclk[1]==0);
 }
+
+TEST_CASE( "Unit-tests/gpio_registers/pull-control-register-offsets"
+         , "BCM2711 pull control register offsets should match the documented "
+           "layout"
+         )
+{
+  enum RegisterOffsets
+    { GPIO_PUP_PDN_CNTRL_REG0=0xE4, GPIO_PUP_PDN_CNTRL_REG3=0xF0 };
+  gpio_registers gpio_regs;
+  std::memset(&gpio_regs, 0xFF, sizeof(gpio_regs));
+  Byte * reg_base_addr(reinterpret_cast<Byte *>(&gpio_regs));
+  gpio_regs.gpio_pup_pdn_cntrl[0] = GPIO_PUP_PDN_CNTRL_REG0;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[GPIO_PUP_PDN_CNTRL_REG0])
+        ==GPIO_PUP_PDN_CNTRL_REG0
+       );
+  gpio_regs.gpio_pup_pdn_cntrl[3] = GPIO_PUP_PDN_CNTRL_REG3;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[GPIO_PUP_PDN_CNTRL_REG3])
+        ==GPIO_PUP_PDN_CNTRL_REG3
+       );
+}
+
+TEST_CASE( "Unit-tests/gpio_registers/set_pins_pull_control"
+         , "Setting pins' pull control updates just those pins' 2 bit fields"
+         )
+{
+  gpio_registers gpio_regs;
+  std::memset(&gpio_regs, 0, sizeof(gpio_regs));
+  gpio_regs.gpio_pup_pdn_cntrl[0] = 0xAAAAAAAAU; // all pins 0..15 pulled down
+  gpio_regs.set_pins_pull_control( 0x80010001U, 0x00200000U
+                                 , gpio_pull_control::pull_up
+                                 );
+  CHECK(gpio_regs.gpio_pup_pdn_cntrl[0]==0xAAAAAAA9U);  // pin 0
+  CHECK(gpio_regs.gpio_pup_pdn_cntrl[1]==0x40000001U);  // pins 16 and 31
+  CHECK(gpio_regs.gpio_pup_pdn_cntrl[2]==0U);
+  CHECK(gpio_regs.gpio_pup_pdn_cntrl[3]==0x00000400U);  // pin 53
+  gpio_regs.set_pins_pull_control(0x80000000U, 0U, gpio_pull_control::none);
+  CHECK(gpio_regs.gpio_pup_pdn_cntrl[1]==0x00000001U);
+  CHECK(gpio_regs.gpset[0]==0U);
+  CHECK(gpio_regs.gppudclk[0]==0U);
+}
@@ -0,0 +1,95 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_sequence_platformtests.cpp
+/// @brief System tests for precompiled GPIO output sequence type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "gpio_sequence.h"
+#include "gpio_registers.h"
+#include "gpio_ctrl.h"
+#include <utility>
+#include <vector>
+
+using namespace dibase::rpi::peripherals;
+
+static pin_id const out_pin_id_0{17}; // P1 pin GPIO_GEN0
+static pin_id const out_pin_id_1{22}; // P1 pin GPIO_GEN3
+
+static bool pin_level(pin_id pin)
+{
+  return internal::gpio_ctrl::instance().regs->pin_level(pin);
+}
+
+TEST_CASE( "Platform_tests/gpio_sequence/000/bad parameters fail"
+         , "Creating a sequence with a negative interval or appending steps "
+           "for pins not in the group throws"
+         )
+{
+  opin_group pins{out_pin_id_0, out_pin_id_1};
+  REQUIRE_THROWS_AS( (gpio_sequence{pins, std::chrono::microseconds{-1}})
+                   , std::invalid_argument
+                   );
+  gpio_sequence sequence{pins, std::chrono::microseconds{100}};
+  REQUIRE_THROWS_AS(sequence.append(4U, 4U), std::invalid_argument);
+  REQUIRE_THROWS_AS( sequence.append(std::vector<std::pair<int,bool>>
+                                                              {{2,true}})
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS( sequence.append(std::vector<std::pair<int,bool>>
+                                                              {{-1,true}})
+                   , std::invalid_argument
+                   );
+  CHECK(sequence.size()==0U);
+  REQUIRE_THROWS_AS(sequence.apply(0U), std::out_of_range);
+}
+
+TEST_CASE( "Platform_tests/gpio_sequence/010/apply steps"
+         , "Applying steps changes only the pins each step changes"
+         )
+{
+  opin_group pins{out_pin_id_0, out_pin_id_1};
+  pins.put(0U);
+  gpio_sequence sequence{pins, std::chrono::microseconds{100}};
+  sequence.append(std::vector<std::pair<int,bool>>{{0,true}});
+  sequence.append(std::vector<std::pair<int,bool>>{{1,true},{0,false}});
+  sequence.append(std::vector<std::pair<int,bool>>{{1,false},{1,true}});
+  sequence.append(3U, 0U);
+  REQUIRE(sequence.size()==4U);
+  CHECK(sequence.duration()==std::chrono::microseconds{400});
+  sequence.apply(0U);
+  CHECK(pin_level(out_pin_id_0));
+  CHECK_FALSE(pin_level(out_pin_id_1));
+  sequence.apply(1U);
+  CHECK_FALSE(pin_level(out_pin_id_0));
+  CHECK(pin_level(out_pin_id_1));
+  sequence.apply(0U);
+  sequence.apply(2U);
+  CHECK(pin_level(out_pin_id_0));
+  CHECK(pin_level(out_pin_id_1));
+  sequence.apply(3U);
+  CHECK_FALSE(pin_level(out_pin_id_0));
+  CHECK_FALSE(pin_level(out_pin_id_1));
+}
+
+TEST_CASE( "Platform_tests/gpio_sequence/020/play on time"
+         , "Playing a sequence applies steps no earlier than due and returns "
+           "the time the next play is due"
+         )
+{
+  opin_group pins{out_pin_id_0, out_pin_id_1};
+  gpio_sequence sequence{pins, std::chrono::microseconds{1000}};
+  sequence.append(1U, 1U);
+  sequence.append(1U, 0U);
+  sequence.append(2U, 2U);
+  sequence.append(2U, 0U);
+  system_timer::time_point const start
+                        {system_timer::now()+std::chrono::microseconds{1000}};
+  system_timer::time_point const next{sequence.play(start)};
+  system_timer::time_point const end{system_timer::now()};
+  CHECK(next==start+sequence.duration());
+  CHECK(end>=start+std::chrono::microseconds{3000});
+  CHECK_FALSE(pin_level(out_pin_id_0));
+  CHECK_FALSE(pin_level(out_pin_id_1));
+}
@@ -0,0 +1,76 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_transaction_platformtests.cpp
+/// @brief System tests for coalescing GPIO output pin writes.
+///
+/// Levels are polled for a while before being checked so the tests also
+/// pass with simulated peripherals, whose GPIO model updates GPLEVn from
+/// GPSETn and GPCLRn writes a little later.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "gpio_transaction.h"
+#include "pin_group.h"
+#include <chrono>
+#include <thread>
+
+using namespace dibase::rpi::peripherals;
+
+namespace
+{
+// Change if P1 GPIO_GEN0/GPIO_GEN1 in use on your system...
+  pin_id const txn_pin_a{17};  // P1 pin GPIO_GEN0
+  pin_id const txn_pin_b{18};  // P1 pin GPIO_GEN1
+
+// Returns the level of pin once it is expected, or after 100ms if not.
+  bool level_once(pin_id pin, bool expected)
+  {
+    for (int tries{0}; tries!=100; ++tries)
+      {
+        if (gpio_snapshot().test(pin)==expected)
+          {
+            break;
+          }
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+      }
+    return gpio_snapshot().test(pin);
+  }
+}
+
+TEST_CASE( "Platform-tests/gpio_transaction/0000/opin::put deferred"
+         , "opin::put calls made while a gpio_transaction is active do not "
+           "write GPSETn or GPCLRn until the transaction is committed"
+         )
+{
+  opin a{txn_pin_a};
+  opin b{txn_pin_b};
+  a.put(false);
+  b.put(true);
+  REQUIRE_FALSE(level_once(txn_pin_a, false));
+  REQUIRE(level_once(txn_pin_b, true));
+  {
+    gpio_transaction txn;
+    a.put(true);
+    b.put(false);
+    CHECK(txn.pending());
+    CHECK_FALSE(level_once(txn_pin_a, true));
+    CHECK(level_once(txn_pin_b, false));
+    txn.commit();
+    CHECK_FALSE(txn.pending());
+    CHECK(level_once(txn_pin_a, true));
+    CHECK_FALSE(level_once(txn_pin_b, false));
+    a.put(false);
+    {
+      gpio_transaction inner;
+      b.put(true);
+      inner.commit();   // into txn, not the registers
+      CHECK_FALSE(level_once(txn_pin_b, true));
+    }
+    CHECK(level_once(txn_pin_a, true));
+  }
+  CHECK_FALSE(level_once(txn_pin_a, false));
+  CHECK(level_once(txn_pin_b, true));
+  a.put(true);
+  CHECK(level_once(txn_pin_a, true));
+}
@@ -0,0 +1,87 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gpio_transaction_unittests.cpp
+/// @brief Unit tests for coalescing GPIO output pin writes.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "gpio_transaction.h"
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/gpio_put_batch/0000/add sets masks"
+         , "Putting pins high or low adds them to their bank's set or clear "
+           "mask"
+         )
+{
+  internal::gpio_put_batch batch{{0U, 0U}, {0U, 0U}};
+  batch.add(0U, 1U<<17, true);
+  batch.add(0U, 1U<<18, false);
+  batch.add(1U, 1U<<3, true);
+  CHECK(batch.set_masks[0]==(1U<<17));
+  CHECK(batch.clear_masks[0]==(1U<<18));
+  CHECK(batch.set_masks[1]==(1U<<3));
+  CHECK(batch.clear_masks[1]==0U);
+}
+
+TEST_CASE( "Unit-tests/gpio_put_batch/0010/last put wins"
+         , "A later put to a pin moves it from one mask to the other"
+         )
+{
+  internal::gpio_put_batch batch{{0U, 0U}, {0U, 0U}};
+  batch.add(0U, 1U<<4, true);
+  batch.add(0U, 1U<<4, false);
+  CHECK(batch.set_masks[0]==0U);
+  CHECK(batch.clear_masks[0]==(1U<<4));
+  batch.add(0U, 1U<<4, true);
+  CHECK(batch.set_masks[0]==(1U<<4));
+  CHECK(batch.clear_masks[0]==0U);
+}
+
+TEST_CASE( "Unit-tests/gpio_put_batch/0020/add later batch"
+         , "Adding a later batch replaces earlier values of the same pins "
+           "and keeps those of other pins"
+         )
+{
+  internal::gpio_put_batch earlier{{(1U<<4)|(1U<<5), 1U<<2}, {1U<<6, 0U}};
+  internal::gpio_put_batch const later{{1U<<6, 0U}, {1U<<4, 1U<<2}};
+  earlier.add(later);
+  CHECK(earlier.set_masks[0]==((1U<<5)|(1U<<6)));
+  CHECK(earlier.clear_masks[0]==(1U<<4));
+  CHECK(earlier.set_masks[1]==0U);
+  CHECK(earlier.clear_masks[1]==(1U<<2));
+}
+
+TEST_CASE( "Unit-tests/gpio_transaction/0000/activation and nesting"
+         , "Transactions become the thread's active batch while alive and "
+           "restore the outer one when destroyed. An inner transaction "
+           "commits to the outer one"
+         )
+{
+  REQUIRE(internal::active_gpio_put_batch==nullptr);
+  {
+    gpio_transaction outer;
+    internal::gpio_put_batch * outer_batch{internal::active_gpio_put_batch};
+    REQUIRE(outer_batch!=nullptr);
+    {
+      gpio_transaction inner;
+      CHECK(internal::active_gpio_put_batch!=outer_batch);
+      CHECK_FALSE(inner.pending());
+      internal::active_gpio_put_batch->add(0U, 1U<<17, true);
+      CHECK(inner.pending());
+      CHECK_FALSE(outer.pending());
+      inner.discard();
+      CHECK_FALSE(inner.pending());
+      internal::active_gpio_put_batch->add(0U, 1U<<18, false);
+      inner.commit();
+      CHECK_FALSE(inner.pending());
+      CHECK(outer.pending());
+      CHECK(outer_batch->clear_masks[0]==(1U<<18));
+    }
+    CHECK(internal::active_gpio_put_batch==outer_batch);
+    outer.discard(); // no GPIO registers to commit to in unit tests
+  }
+  CHECK(internal::active_gpio_put_batch==nullptr);
+}
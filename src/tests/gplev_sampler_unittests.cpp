@@ -0,0 +1,127 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file gplev_sampler_unittests.cpp
+/// @brief Unit tests for compiling GPIO level sampling programs into DMA
+/// control blocks and locating samples in their ring buffers.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "gplev_sampler.h"
+#include <cstring>
+#include <cstdint>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef std::uint32_t RegisterType;
+
+namespace
+{
+  RegisterType const region_bus{0xC0200000U};
+  RegisterType const gplev0_bus{0x7E200034U};
+  RegisterType const pwm_fifo_bus{0x7E20C018U};
+
+  struct alignas(32) small_region_type
+  {
+    unsigned char bytes[1024];
+  };
+
+  dma_control_block const & cb_at
+  ( dma_region const & region
+  , void * base
+  , RegisterType bus
+  )
+  {
+    return *reinterpret_cast<dma_control_block const *>
+              (static_cast<unsigned char *>(base)+(bus-region.bus_address(base)));
+  }
+}
+
+TEST_CASE( "Unit-tests/gplev_sampler_compiler/0000/bad parameters fail"
+         , "Compiling with no samples, zero or too large sample ticks or into "
+           "too small a region throws"
+         )
+{
+  small_region_type memory;
+  dma_region region{&memory, region_bus, sizeof(memory)};
+  REQUIRE_THROWS_AS(compile_gplev_sampler(region, 0U, 1U)
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS(compile_gplev_sampler(region, 4U, 0U)
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS(compile_gplev_sampler(region, 4U, 0x10000000U)
+                   , std::invalid_argument
+                   );
+  dma_region small_region{ &memory, region_bus
+                         , gplev_sampler_program_size(4U)-4U
+                         };
+  REQUIRE_THROWS_AS( compile_gplev_sampler(small_region, 4U, 1U)
+                   , std::bad_alloc
+                   );
+}
+
+TEST_CASE( "Unit-tests/gplev_sampler_compiler/0010/compile program"
+         , "Program copies GPLEV0/1 into each sample then delays, and loops "
+           "back to the start"
+         )
+{
+  small_region_type memory;
+  std::memset(&memory, 0xFF, sizeof(memory));
+  std::size_t const size{gplev_sampler_program_size(3U)};
+// 6 CBs of 32 bytes + 3 * 2 sample words + 1 FIFO word
+  REQUIRE(size==6U*32U+7U*4U);
+  dma_region region{&memory, region_bus, size};
+  gplev_sampler_program const program{compile_gplev_sampler(region, 3U, 2U)};
+  CHECK(region.available()==0U);
+  CHECK(program.first_bus==region_bus);
+  for (unsigned idx=0; idx!=6U; ++idx)
+    {
+      CHECK(program.samples[idx]==0U);
+    }
+  dma_control_block const * cb{&cb_at(region, &memory, program.first_bus)};
+  for (unsigned sample=0; sample!=3U; ++sample)
+    {
+      CHECK(cb->source_address==gplev0_bus);
+      CHECK(cb->dest_address==program.first_bus+192U+8U*sample);
+      CHECK(cb->transfer_length==8U);
+      CHECK((cb->transfer_info&dma_control_block::ti_dest_dreq)==0U);
+      cb = &cb_at(region, &memory, cb->next_control_block);
+      CHECK(cb->source_address==program.first_bus+216U);
+      CHECK(cb->dest_address==pwm_fifo_bus);
+      CHECK(cb->transfer_length==8U);
+      CHECK((cb->transfer_info&dma_control_block::ti_dest_dreq)!=0U);
+      CHECK((cb->transfer_info&dma_control_block::ti_src_inc)==0U);
+      CHECK(((cb->transfer_info>>dma_control_block::ti_permap_shift)&0x1FU)
+                                                                        ==5U);
+      cb = &cb_at(region, &memory, cb->next_control_block);
+    }
+  CHECK(cb==&cb_at(region, &memory, program.first_bus));
+}
+
+TEST_CASE( "Unit-tests/gplev_sampler_compiler/0020/sampler position"
+         , "The position of the next sample to be written follows the current "
+           "control block, wrapping at the end of the ring"
+         )
+{
+  CHECK(gplev_sampler_position(0U, region_bus, 4U)==0U);
+  CHECK(gplev_sampler_position(region_bus, region_bus, 4U)==0U);
+  CHECK(gplev_sampler_position(region_bus+32U, region_bus, 4U)==1U);
+  CHECK(gplev_sampler_position(region_bus+64U, region_bus, 4U)==1U);
+  CHECK(gplev_sampler_position(region_bus+96U, region_bus, 4U)==2U);
+  CHECK(gplev_sampler_position(region_bus+7U*32U, region_bus, 4U)==0U);
+  CHECK(gplev_sampler_position(region_bus+8U*32U, region_bus, 4U)==0U);
+}
+
+TEST_CASE( "Unit-tests/gplev_sampler_compiler/0030/sample number"
+         , "The sample number at a ring position is the one nearest the "
+           "expected number"
+         )
+{
+  CHECK(gplev_sample_number(3U, 0U, 16U)==3U);
+  CHECK(gplev_sample_number(3U, 5U, 16U)==3U);
+  CHECK(gplev_sample_number(15U, 17U, 16U)==15U);
+  CHECK(gplev_sample_number(1U, 30U, 16U)==33U);
+  CHECK(gplev_sample_number(14U, 100U, 16U)==94U);
+}
@@ -0,0 +1,46 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file i2c_device_platformtests.cpp
+/// @brief Platform tests for i2c_device.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "i2c_device.h"
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Platform-tests/i2c_device/0000/create"
+         , "Creating an i2c_device gives the expected cacheable registers and "
+           "bad addresses throw"
+         )
+{
+  i2c_pins iic(pin_id(0),pin_id(1)); // SDA0, SCL0 => BSC0
+  i2c_device dev(iic, 111U, {0x01U, 0x02U, 0xFFU});
+  CHECK(dev.slave_address()==111U);
+  CHECK(dev.is_cacheable(0x01U));
+  CHECK(dev.is_cacheable(0x02U));
+  CHECK(dev.is_cacheable(0xFFU));
+  CHECK_FALSE(dev.is_cacheable(0x00U));
+  CHECK_FALSE(dev.is_dirty(0x01U));
+  CHECK(dev.flush()==0U);
+  CHECK_THROWS_AS(i2c_device(iic, 128U, {}), std::out_of_range);
+}
+
+TEST_CASE( "Platform-tests/i2c_device/0010/no slave"
+         , "Accessing a non-existent device throws, leaving the i2c_pins "
+           "object in a good state"
+         )
+{
+  i2c_pins iic(pin_id(0),pin_id(1)); // SDA0, SCL0 => BSC0
+  i2c_device dev(iic, 111U, {0x01U});
+  CHECK_THROWS_AS(dev.read(0x00U), std::runtime_error);
+  CHECK(iic.good());
+  CHECK_THROWS_AS(dev.read(0x01U), std::runtime_error);
+  CHECK_THROWS_AS(dev.write(0x01U, 0x55U), std::runtime_error);
+  CHECK_THROWS_AS(dev.modify(0x01U, 0x0FU, 0x05U), std::runtime_error);
+  CHECK_FALSE(dev.is_dirty(0x01U));
+  CHECK_THROWS_AS(dev.modify(0x00U, 0x0FU, 0x05U), std::invalid_argument);
+  CHECK(iic.good());
+}
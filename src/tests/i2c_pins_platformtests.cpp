@@ -111,6 +111,95 @@ TEST_CASE( "Platform-tests/i2c_pins/0010/create & destroy good, explicit BSC per
   CHECK_FALSE(i2c_ctrl::instance().regs(1)->get_enable());
 }
 
+TEST_CASE( "Platform-tests/i2c_pins/0015/create & destroy good, i2c_pin_set"
+         , "Creating i2c_pins from an i2c_pin_set resolved at compile time "
+           "allocates the pins and BSC peripheral of the set"
+         )
+{
+  static_assert( i2c_pin_pair_bsc(0U, 1U)==0 && i2c_pin_pair_bsc(2U, 3U)==1
+              && i2c_pin_pair_bsc(44U, 45U)==i2c_bsc_ambiguous
+              && i2c_pin_pair_bsc(0U, 3U)==-1
+               , "Unexpected BSC peripheral for pin pair"
+               );
+  static_assert( i2c_pin_alt_fn(44U, 1, i2c_line::sda)==2
+               , "Unexpected alternative function for BSC1 SDA on pin 44"
+               );
+  {
+    i2c_pins iic(rpi_p1_rev1_i2c_pin_set);
+    CHECK(gpio_ctrl::instance().alloc.is_in_use(pin_id(0)));
+    CHECK(gpio_ctrl::instance().alloc.is_in_use(pin_id(1)));
+    CHECK(i2c_ctrl::instance().alloc.is_in_use(0));
+    CHECK(gpio_ctrl::instance().config.pin_function(pin_id(0))
+          ==gpio_pin_fn::alt0);
+    CHECK(i2c_ctrl::instance().regs(0)->get_enable());
+  }
+  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(pin_id(0)));
+  CHECK_FALSE(i2c_ctrl::instance().alloc.is_in_use(0));
+  {
+    i2c_pins iic(i2c_pin_set<2U, 3U, 1>{});
+    CHECK(i2c_ctrl::instance().alloc.is_in_use(1));
+  }
+  CHECK_FALSE(i2c_ctrl::instance().alloc.is_in_use(1));
+}
+
+TEST_CASE( "Platform-tests/i2c_pins/0016/create & destroy BCM2711 BSC3..6"
+         , "Creating i2c_pins for BSC3 to BSC6 allocates the BSC peripheral "
+           "on a BCM2711 and fails on other SoCs"
+         )
+{
+  static_assert( i2c_pin_pair_bsc(4U, 5U)==3 && i2c_pin_pair_bsc(8U, 9U)==4
+              && i2c_pin_pair_bsc(10U, 11U)==5
+              && i2c_pin_pair_bsc(22U, 23U)==6
+              && i2c_pin_pair_supports(2U, 3U, 3)
+              && i2c_pin_pair_supports(0U, 1U, 6)
+               , "Unexpected BSC peripheral for BCM2711 pin pair"
+               );
+  if (i2c_ctrl::masters()==number_of_bsc_masters)
+    {
+      {
+        i2c_pins iic(i2c_pin_set<4U, 5U>{});
+        CHECK(i2c_ctrl::instance().alloc.is_in_use(3));
+        CHECK(gpio_ctrl::instance().config.pin_function(pin_id(4))
+              ==gpio_pin_fn::alt5);
+        CHECK(i2c_ctrl::instance().regs(3)->get_enable());
+        i2c_pins iic6(pin_id(22), pin_id(23));
+        CHECK(i2c_ctrl::instance().alloc.is_in_use(6));
+      }
+      CHECK_FALSE(i2c_ctrl::instance().alloc.is_in_use(3));
+      CHECK_FALSE(i2c_ctrl::instance().alloc.is_in_use(6));
+    }
+  else
+    {
+      REQUIRE_THROWS_AS( (i2c_pins(i2c_pin_set<4U, 5U>{}))
+                       , std::invalid_argument
+                       );
+      REQUIRE_THROWS_AS( (i2c_pins(pin_id(4),pin_id(5),3))
+                       , std::invalid_argument
+                       );
+      CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(pin_id(4)));
+      CHECK_FALSE(i2c_ctrl::instance().alloc.is_in_use(3));
+    }
+}
+
+TEST_CASE( "Platform-tests/i2c_pins/0017/create fails for bad i2c_pin_set"
+         , "Compile will fail if built with COMPILE_FAIL_TESTS #defined for "
+           "i2c_pins created from pin sets whose pins do not support one BSC "
+           "peripheral or support two without one being named"
+         )
+{
+  static_assert( i2c_pin_pair_supports(0U, 1U, 0)
+               , "Pins 0 and 1 expected to support BSC0"
+               ); // Compiles OK
+
+#ifdef COMPILE_FAIL_TESTS
+
+  i2c_pins bad_pair(i2c_pin_set<0U, 3U>{});     // Compile FAIL
+  i2c_pins bad_bsc(i2c_pin_set<0U, 1U, 1>{});   // Compile FAIL
+  i2c_pins ambiguous(i2c_pin_set<44U, 45U>{});  // Compile FAIL
+
+#endif
+}
+
 TEST_CASE( "Platform-tests/i2c_pins/0020/create good - fedl maximum value"
          , "Creating i2c_pins with a fedl parameter value that is exactly "
            "half the computed CDIV(fc/f) value is OK"
@@ -503,3 +592,181 @@ TEST_CASE( "Platform-tests/i2c_pins/0320/Errors cleared OK"
   iic.clear(i2c_pins::goodbit); // clear goodbit does nothing
   CHECK(iic.good());
 }
+
+TEST_CASE( "Platform-tests/i2c_pins/0400/write_then_read bad parameters"
+         , "write_then_read and read_register throw for out of range "
+           "parameters"
+         )
+{
+  i2c_pins iic(pin_id(0),pin_id(1)); // SDA0, SCL0 => BSC0
+  std::uint8_t tx[17]{};
+  std::uint8_t rx[4]{};
+  CHECK_THROWS_AS(iic.write_then_read(128, tx, 1, rx, 4), std::out_of_range);
+  CHECK_THROWS_AS(iic.write_then_read(111, tx, 0, rx, 4), std::out_of_range);
+  CHECK_THROWS_AS(iic.write_then_read(111, tx, 17, rx, 4), std::out_of_range);
+  CHECK_THROWS_AS(iic.write_then_read(111, tx, 1, rx, 65536), std::out_of_range);
+  CHECK_THROWS_AS(iic.read_register(128, 0, rx, 4), std::out_of_range);
+  CHECK_FALSE(iic.is_busy());
+}
+
+TEST_CASE( "Platform-tests/i2c_pins/0410/read_register with no slave"
+         , "A combined transaction with a non-existent slave completes with "
+           "a no_acknowledge error and nothing read"
+         )
+{
+  i2c_pins iic(pin_id(0),pin_id(1)); // SDA0, SCL0 => BSC0
+  REQUIRE(iic.good());
+  std::uint8_t rx[4]{};
+  std::size_t read_count{99U};
+  int const state{iic.read_register(111, 0, rx, sizeof(rx), &read_count)};
+  CHECK((state&i2c_pins::noackowledgebit));
+  CHECK(iic.no_acknowledge());
+  CHECK(read_count==0U);
+  CHECK_FALSE(iic.is_busy());
+  iic.clear();
+  CHECK(iic.good());
+}
+
+TEST_CASE( "Platform-tests/i2c_pins/0420/write_all & read_all with no slave"
+         , "Write and read transactions longer than the FIFO with a "
+           "non-existent slave complete with a no_acknowledge error"
+         )
+{
+  i2c_pins iic(pin_id(0),pin_id(1)); // SDA0, SCL0 => BSC0
+  std::uint8_t buffer[100]{};
+  CHECK_THROWS_AS(iic.write_all(128, buffer, sizeof(buffer)), std::out_of_range);
+  CHECK_THROWS_AS(iic.read_all(111, buffer, 65536), std::out_of_range);
+  std::size_t count{999U};
+  CHECK((iic.write_all(111, buffer, sizeof(buffer), &count)
+        &i2c_pins::noackowledgebit
+        ));
+  CHECK(count<=16U);
+  CHECK_FALSE(iic.is_busy());
+  count = 999U;
+  CHECK((iic.read_all(111, buffer, sizeof(buffer), &count)
+        &i2c_pins::noackowledgebit
+        ));
+  CHECK(count==0U);
+  CHECK_FALSE(iic.is_busy());
+  iic.clear();
+  CHECK(iic.good());
+}
+
+TEST_CASE( "Platform-tests/i2c_pins/0430/write_all & read_all time outs"
+         , "Write and read transactions with a non-existent slave end with a "
+           "no_acknowledge error before a generous time out expires"
+         )
+{
+  i2c_pins iic(pin_id(0),pin_id(1)); // SDA0, SCL0 => BSC0
+  std::uint8_t buffer[100]{};
+  std::chrono::milliseconds const timeout{500};
+  CHECK_THROWS_AS( iic.write_all(128, buffer, sizeof(buffer), timeout)
+                 , std::out_of_range
+                 );
+  std::size_t count{999U};
+  int state{iic.write_all(111, buffer, sizeof(buffer), timeout, &count)};
+  CHECK((state&i2c_pins::noackowledgebit));
+  CHECK_FALSE((state&i2c_pins::expiredbit));
+  CHECK(count<=16U);
+  CHECK_FALSE(iic.is_busy());
+  count = 999U;
+  state = iic.read_all(111, buffer, sizeof(buffer), timeout, &count);
+  CHECK((state&i2c_pins::noackowledgebit));
+  CHECK_FALSE((state&i2c_pins::expiredbit));
+  CHECK(count==0U);
+  CHECK_FALSE(iic.is_busy());
+  iic.clear();
+  CHECK(iic.good());
+}
+
+TEST_CASE( "Platform-tests/i2c_pins/0440/scan bad parameters and no slaves"
+         , "Scanning an empty bus finds no devices and restores the clock "
+           "stretch time out"
+         )
+{
+  i2c_pins iic(pin_id(0),pin_id(1)); // SDA0, SCL0 => BSC0
+  CHECK_THROWS_AS(iic.scan(0U, 128U), std::out_of_range);
+  CHECK_THROWS_AS(iic.scan(0x50U, 0x4fU), std::out_of_range);
+  iic.set_clock_stretch_timeout(0x123U);
+  CHECK(iic.clock_stretch_timeout()==0x123U);
+  CHECK(iic.scan().empty());
+  CHECK(iic.scan(0x08U, 0x77U, i2c_probe::quick_write).empty());
+  CHECK(iic.scan(0x08U, 0x77U, i2c_probe::read_byte).empty());
+  CHECK(iic.clock_stretch_timeout()==0x123U);
+  CHECK_FALSE(iic.is_busy());
+  CHECK(iic.good());
+}
+
+TEST_CASE( "Platform-tests/i2c_pins/0450/poll_register with no slaves"
+         , "Polling non-existent slaves reports no_acknowledge for each"
+         )
+{
+  i2c_pins iic(pin_id(0),pin_id(1)); // SDA0, SCL0 => BSC0
+  std::uint32_t const bad_addrs[]{0x10U, 0x80U};
+  std::uint32_t const addrs[]{0x10U, 0x11U, 0x6fU};
+  std::uint8_t values[3]{1U, 2U, 3U};
+  int states[3]{};
+  CHECK_THROWS_AS( iic.poll_register(bad_addrs, 2U, 0U, values)
+                 , std::out_of_range
+                 );
+  int const state{iic.poll_register(addrs, 3U, 0U, values, states)};
+  CHECK((state&i2c_pins::noackowledgebit));
+  for (std::size_t idx=0; idx!=3U; ++idx)
+    {
+      CHECK((states[idx]&i2c_pins::noackowledgebit));
+      CHECK(values[idx]==0U);
+    }
+  CHECK_FALSE(iic.is_busy());
+  iic.clear();
+  CHECK(iic.good());
+}
+
+TEST_CASE( "Platform-tests/i2c_pins/0460/timing, set_timing & tune_timing"
+         , "Timing settings round trip and tuning with no slave throws "
+           "leaving the timing unchanged"
+         )
+{
+  i2c_pins iic(pin_id(0),pin_id(1)); // SDA0, SCL0 => BSC0
+  i2c_timing t{iic.timing()};
+  CHECK(t.frequency==i2c_pins_default_frequency);
+  CHECK(t.tout==std::uint16_t{i2c_pins::default_tout});
+  CHECK(t.fedl==std::uint16_t{i2c_pins::default_fedl});
+  CHECK(t.redl==std::uint16_t{i2c_pins::default_redl});
+  i2c_timing const fast{hertz{400000}, 0x20U, 0x20U, 0x10U};
+  iic.set_timing(fast);
+  t = iic.timing();
+  CHECK(t.frequency==fast.frequency);
+  CHECK(t.tout==fast.tout);
+  CHECK(t.fedl==fast.fedl);
+  CHECK(t.redl==fast.redl);
+  CHECK_THROWS_AS( iic.set_timing({hertz{0U}, 0x40U, 0U, 0U})
+                 , std::out_of_range
+                 );
+  CHECK_THROWS_AS( iic.set_timing({hertz{400000}, 0x40U, 0x200U, 0U})
+                 , std::out_of_range
+                 );
+  CHECK_THROWS_AS(iic.tune_timing(128U, 0U), std::out_of_range);
+  CHECK_THROWS_AS(iic.tune_timing(0x50U, 0U, hertz{0U}), std::out_of_range);
+  CHECK_THROWS_AS(iic.tune_timing(0x50U, 0U), std::runtime_error);
+  CHECK(iic.timing().frequency==fast.frequency);
+  CHECK(iic.good());
+}
+
+TEST_CASE( "Platform-tests/i2c_pins/0470/start_write error_code overload"
+         , "start_write with an error_code reports bad parameters and a busy "
+           "peripheral without throwing"
+         )
+{
+  i2c_pins iic(pin_id(0),pin_id(1)); // SDA0, SCL0 => BSC0
+  std::uint8_t write_buffer[2] = {0, 111};
+  std::error_code ec;
+  CHECK(iic.start_write(128,2, write_buffer,2, ec)==0U);
+  CHECK(ec==std::errc::invalid_argument);
+  CHECK(iic.start_write(111,65536, write_buffer,2, ec)==0U);
+  CHECK(ec==std::errc::invalid_argument);
+  CHECK(iic.start_write(111,2, write_buffer,2, ec)==2U);
+  CHECK_FALSE(ec);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  CHECK(iic.no_acknowledge());
+  iic.clear();
+}
@@ -0,0 +1,74 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file i2c_slave_pins_platformtests.cpp
+/// @brief Platform tests for i2c_slave_pins and i2c_slave_service.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "i2c_slave_service.h"
+#include "periexcept.h"
+#include <chrono>
+#include <thread>
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Platform-tests/i2c_slave_pins/0000/create and destroy"
+         , "Creating i2c_slave_pins with valid pins and address succeeds and "
+           "invalid parameters throw"
+         )
+{
+  {
+    i2c_slave_pins slave(pin_id(18), pin_id(19), 0x2AU);
+    CHECK(slave.slave_address()==0x2AU);
+    CHECK_THROWS_AS( i2c_slave_pins(pin_id(18), pin_id(19), 0x2BU)
+                   , bad_peripheral_alloc
+                   );
+  }
+  CHECK_THROWS_AS( i2c_slave_pins(pin_id(19), pin_id(18), 0x2AU)
+                 , std::invalid_argument
+                 );
+  CHECK_THROWS_AS( i2c_slave_pins(pin_id(18), pin_id(19), 128U)
+                 , std::out_of_range
+                 );
+  i2c_slave_pins slave(pin_id(18), pin_id(19), 0x2AU);
+}
+
+TEST_CASE( "Platform-tests/i2c_slave_pins/0010/idle FIFOs"
+         , "With no bus master activity nothing is read, the transmit FIFO "
+           "fills to 16 bytes and clear_fifos empties it"
+         )
+{
+  i2c_slave_pins slave(pin_id(18), pin_id(19), 0x2AU);
+  std::uint8_t buffer[32]{};
+  CHECK(slave.read(buffer, sizeof(buffer))==0U);
+  CHECK(slave.rx_fifo_level()==0U);
+  CHECK(slave.write(buffer, sizeof(buffer))==16U);
+  CHECK(slave.tx_fifo_level()==16U);
+  slave.clear_fifos();
+  CHECK(slave.tx_fifo_level()==0U);
+  CHECK(slave.errors()==i2c_slave_pins::goodbit);
+}
+
+TEST_CASE( "Platform-tests/i2c_slave_service/0000/idle service"
+         , "An i2c_slave_service moves queued bytes to the transmit FIFO and "
+           "reads nothing with no bus master activity"
+         )
+{
+  i2c_slave_pins slave(pin_id(18), pin_id(19), 0x2AU);
+  CHECK_THROWS_AS(i2c_slave_service(slave, 12U), std::invalid_argument);
+  {
+    i2c_slave_service service(slave, 64U);
+    CHECK(service.capacity()==64U);
+    std::uint8_t buffer[64]{};
+    CHECK(service.write(buffer, sizeof(buffer))==64U);
+    CHECK(service.write(buffer, 1U)<=1U);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK(service.read(buffer, sizeof(buffer))==0U);
+    CHECK(service.overruns()==0U);
+    CHECK(service.errors()==i2c_slave_pins::goodbit);
+  }
+  CHECK(slave.tx_fifo_level()==16U);
+  slave.clear_fifos();
+}
@@ -0,0 +1,70 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file i2c_transaction_scheduler_platformtests.cpp
+/// @brief Platform tests for i2c_transaction_scheduler.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "i2c_transaction_scheduler.h"
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Platform-tests/i2c_transaction_scheduler/0000/create bad"
+         , "Creating a scheduler with no, null or duplicate bus objects fails"
+         )
+{
+  i2c_pins bsc0(pin_id(0),pin_id(1)); // SDA0, SCL0 => BSC0
+  REQUIRE_THROWS_AS( i2c_transaction_scheduler({})
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS( i2c_transaction_scheduler({&bsc0, nullptr})
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS( i2c_transaction_scheduler({&bsc0, &bsc0})
+                   , std::invalid_argument
+                   );
+}
+
+TEST_CASE( "Platform-tests/i2c_transaction_scheduler/0010/submit bad"
+         , "Submitting a transaction with bad parameters fails"
+         )
+{
+  i2c_pins bsc0(pin_id(0),pin_id(1)); // SDA0, SCL0 => BSC0
+  i2c_transaction_scheduler s({&bsc0});
+  REQUIRE_THROWS_AS(s.submit(1U, 111U, {1U}, 0U), std::invalid_argument);
+  REQUIRE_THROWS_AS(s.submit(0U, 111U, {}, 0U), std::invalid_argument);
+  REQUIRE_THROWS_AS( s.submit(0U, 111U, std::vector<std::uint8_t>(17U), 1U)
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS(s.submit(0U, 128U, {1U}, 0U), std::out_of_range);
+  REQUIRE_THROWS_AS(s.submit(0U, 111U, {}, 65536U), std::out_of_range);
+}
+
+TEST_CASE( "Platform-tests/i2c_transaction_scheduler/0020/no slaves two buses"
+         , "Transactions on both buses with no slave all complete with a "
+           "no acknowledge error and nothing read"
+         )
+{
+  i2c_pins bsc0(pin_id(0),pin_id(1)); // SDA0, SCL0 => BSC0
+  i2c_pins bsc1(pin_id(2),pin_id(3)); // SDA1, SCL1 => BSC1
+  std::vector<std::future<i2c_transaction_result>> results;
+  {
+    i2c_transaction_scheduler s({&bsc0, &bsc1});
+    for (unsigned bus=0U; bus!=2U; ++bus)
+      {
+        results.push_back(s.submit(bus, 111U, {0U, 1U}, 0U));
+        results.push_back(s.submit(bus, 111U, {}, 4U));
+        results.push_back(s.submit(bus, 111U, {0U}, 4U));
+      }
+  }
+  for (auto & f : results)
+    {
+      i2c_transaction_result r(f.get());
+      CHECK((r.state&i2c_pins::noackowledgebit));
+      CHECK(r.rx.empty());
+    }
+  CHECK(bsc0.good());
+  CHECK(bsc1.good());
+}
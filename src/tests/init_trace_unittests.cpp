@@ -0,0 +1,69 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file init_trace_unittests.cpp
+/// @brief Unit tests for initialisation timing records and report.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "init_trace.h"
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/init_trace/0000/record and total"
+         , "Timed scopes are recorded individually and totalled per phase"
+         )
+{
+  init_trace_reset();
+  {
+    internal::init_trace_scope timing{init_phase::sysfs_export};
+    std::this_thread::sleep_for(std::chrono::milliseconds{2});
+  }
+  {
+    internal::init_trace_scope timing{init_phase::sysfs_export};
+  }
+  {
+    internal::init_trace_scope timing{init_phase::pull_sequence};
+  }
+  std::vector<init_trace_record> const records{init_trace_records()};
+  REQUIRE(records.size()==3U);
+  CHECK(records[0].phase==init_phase::sysfs_export);
+  CHECK(records[0].duration>=std::chrono::milliseconds{2});
+  CHECK(records[2].phase==init_phase::pull_sequence);
+  CHECK(records[1].start>=records[0].start);
+  init_phase_totals const t{init_trace_totals(init_phase::sysfs_export)};
+  CHECK(t.calls==2U);
+  CHECK(t.max==records[0].duration);
+  CHECK(t.total==records[0].duration+records[1].duration);
+  CHECK(init_trace_totals(init_phase::dev_mem_open).calls==0U);
+  std::ostringstream report;
+  init_trace_report(report);
+  CHECK(report.str().find("sysfs_export")!=std::string::npos);
+  CHECK(report.str().find("dev_mem_open")==std::string::npos);
+  init_trace_reset();
+  CHECK(init_trace_records().empty());
+  CHECK(init_trace_totals(init_phase::sysfs_export).calls==0U);
+}
+
+TEST_CASE( "Unit-tests/init_trace/0010/capacity"
+         , "Calls beyond the capacity are totalled but not recorded"
+         )
+{
+  init_trace_reset();
+  for (std::size_t i=0U; i!=init_trace_capacity+10U; ++i)
+    {
+      internal::init_trace_scope timing{init_phase::phymem_map};
+    }
+  CHECK(init_trace_records().size()==init_trace_capacity);
+  CHECK(init_trace_totals(init_phase::phymem_map).calls
+        ==init_trace_capacity+10U);
+  REQUIRE_THROWS_AS( init_phase_name(init_phase::number_of_phases)
+                   , std::out_of_range
+                   );
+  init_trace_reset();
+}
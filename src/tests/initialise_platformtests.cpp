@@ -0,0 +1,40 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file initialise_platformtests.cpp
+/// @brief Platform tests for eager initialisation of peripheral access.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "initialise.h"
+#include "gpio_ctrl.h"
+#include "pwm_ctrl.h"
+
+using namespace dibase::rpi::peripherals;
+using namespace dibase::rpi::peripherals::internal;
+
+TEST_CASE( "Platform-tests/initialise/0000/peripheral sets"
+         , "A peripheral_set contains the peripherals it was constructed with"
+         )
+{
+  peripheral_set const none;
+  CHECK(none.empty());
+  peripheral_set const some{peripheral::gpio, peripheral::spi0};
+  CHECK_FALSE(some.empty());
+  CHECK(some.contains(peripheral::gpio));
+  CHECK(some.contains(peripheral::spi0));
+  CHECK_FALSE(some.contains(peripheral::pwm));
+  CHECK(peripheral_set::all().contains(peripheral::bsc_slave));
+}
+
+TEST_CASE( "Platform-tests/initialise/0010/initialise and lock"
+         , "Initialising maps the registers of the peripherals and locks "
+           "their pages if asked"
+         )
+{
+  initialise({peripheral::gpio, peripheral::pwm}, true);
+  CHECK(gpio_ctrl::instance().regs.get()!=nullptr);
+  CHECK(pwm_ctrl::instance().regs.get()!=nullptr);
+  initialise();
+}
@@ -0,0 +1,110 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file io_counters_unittests.cpp
+/// @brief Unit tests for optional peripheral performance counters.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "io_counters.h"
+#include <type_traits>
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/io_counters/0000/snapshot initially zero"
+         , "A new counting counter set's snapshot has all counts zero"
+         )
+{
+  basic_io_counter_set<true> counters;
+  io_counters const s{counters.snapshot()};
+  CHECK( s.bytes_written==0U );
+  CHECK( s.bytes_read==0U );
+  CHECK( s.tx_fifo_full==0U );
+  CHECK( s.rx_fifo_empty==0U );
+  CHECK( s.wait_polls==0U );
+  CHECK( s.timeouts==0U );
+  CHECK( s.nacks==0U );
+  CHECK( s.wakeups==0U );
+  CHECK( s.updates==0U );
+}
+
+TEST_CASE( "Unit-tests/io_counters/0010/counts"
+         , "Counted events appear in their snapshot fields"
+         )
+{
+  basic_io_counter_set<true> counters;
+  counters.count(io_event::bytes_written, 16U);
+  counters.count(io_event::bytes_written, 4U);
+  counters.count(io_event::bytes_read, 3U);
+  counters.count(io_event::tx_fifo_full);
+  counters.count(io_event::rx_fifo_empty);
+  counters.count(io_event::rx_fifo_empty);
+  counters.count(io_event::wait_polls, 100U);
+  counters.count(io_event::timeouts);
+  counters.count(io_event::nacks, 2U);
+  counters.count(io_event::wakeups, 5U);
+  counters.count(io_event::updates, 7U);
+  io_counters const s{counters.snapshot()};
+  CHECK( s.bytes_written==20U );
+  CHECK( s.bytes_read==3U );
+  CHECK( s.tx_fifo_full==1U );
+  CHECK( s.rx_fifo_empty==2U );
+  CHECK( s.wait_polls==100U );
+  CHECK( s.timeouts==1U );
+  CHECK( s.nacks==2U );
+  CHECK( s.wakeups==5U );
+  CHECK( s.updates==7U );
+}
+
+TEST_CASE( "Unit-tests/io_counters/0020/reset"
+         , "Reset sets all counts to zero"
+         )
+{
+  basic_io_counter_set<true> counters;
+  counters.count(io_event::bytes_read, 3U);
+  counters.count(io_event::nacks);
+  counters.reset();
+  io_counters const s{counters.snapshot()};
+  CHECK( s.bytes_read==0U );
+  CHECK( s.nacks==0U );
+}
+
+TEST_CASE( "Unit-tests/io_counters/0030/copy"
+         , "Copying a counter set copies its counts, as when moving the "
+           "object owning it"
+         )
+{
+  basic_io_counter_set<true> counters;
+  counters.count(io_event::bytes_written, 9U);
+  basic_io_counter_set<true> copy{counters};
+  CHECK( copy.snapshot().bytes_written==9U );
+  basic_io_counter_set<true> assigned;
+  assigned.count(io_event::wakeups);
+  assigned = counters;
+  CHECK( assigned.snapshot().bytes_written==9U );
+  CHECK( assigned.snapshot().wakeups==0U );
+}
+
+TEST_CASE( "Unit-tests/io_counters/0040/disabled counters"
+         , "Disabled counter sets hold nothing and always read zero"
+         )
+{
+  CHECK( std::is_empty<basic_io_counter_set<false>>::value );
+  basic_io_counter_set<false> counters;
+  counters.count(io_event::bytes_written, 9U);
+  counters.count(io_event::timeouts);
+  io_counters const s{counters.snapshot()};
+  CHECK( s.bytes_written==0U );
+  CHECK( s.timeouts==0U );
+}
+
+TEST_CASE( "Unit-tests/io_counters/0050/selected counter set"
+         , "io_counter_set counts only if DIBASE_RPI_PERIPHERALS_COUNTERS is "
+           "defined"
+         )
+{
+  io_counter_set counters;
+  counters.count(io_event::updates);
+  CHECK( counters.snapshot().updates==(io_counters_enabled ? 1U : 0U) );
+}
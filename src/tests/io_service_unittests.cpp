@@ -0,0 +1,122 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file io_service_unittests.cpp
+/// @brief Unit tests for io_service type.
+///
+/// The service runs any callables so these tests use plain objects in place
+/// of peripheral objects.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "io_service.h"
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dibase::rpi::peripherals;
+
+namespace
+{
+  struct destruction_recorder
+  {
+    std::vector<int> * record;
+    int id;
+    std::thread::id * thread;
+
+    destruction_recorder(std::vector<int> & r, int i, std::thread::id & t)
+    : record{&r}, id{i}, thread{&t}
+    {}
+    destruction_recorder(destruction_recorder && other)
+    : record{other.record}, id{other.id}, thread{other.thread}
+    {
+      other.record = nullptr;
+    }
+    ~destruction_recorder()
+    {
+      if (record)
+        {
+          record->push_back(id);
+          *thread = std::this_thread::get_id();
+        }
+    }
+  };
+}
+
+TEST_CASE( "Unit-tests/io_service/0000/submit returns results"
+         , "Commands submitted run on the service thread and their results "
+           "or exceptions are returned through futures"
+         )
+{
+  io_service svc{8U};
+  std::future<std::thread::id> id
+                  {svc.submit([]{ return std::this_thread::get_id(); })};
+  std::future<int> bad{svc.submit([]()->int
+                                  { throw std::runtime_error{"failed"}; }
+                                 )};
+  CHECK(id.get()!=std::this_thread::get_id());
+  REQUIRE_THROWS_AS(bad.get(), std::runtime_error);
+}
+
+TEST_CASE( "Unit-tests/io_service/0010/adopted objects used by commands"
+         , "An adopted object is used in order by commands from several "
+           "threads"
+         )
+{
+  io_service svc{16U};
+  std::vector<int> & values(svc.adopt(std::vector<int>{}));
+  unsigned const per_thread{1000U};
+  auto producer = [&svc, &values]()
+                  {
+                    for (unsigned i=0U; i!=per_thread; ++i)
+                      {
+                        svc.post([&values]{ values.push_back(1); });
+                      }
+                  };
+  std::thread t0{producer};
+  std::thread t1{producer};
+  t0.join();
+  t1.join();
+  std::future<std::size_t> size{svc.submit([&values]{return values.size();})};
+  CHECK(size.get()==2U*per_thread);
+}
+
+TEST_CASE( "Unit-tests/io_service/0020/destruction"
+         , "Destroying the service runs queued commands then destroys adopted "
+           "objects on the service thread, last adopted first"
+         )
+{
+  std::vector<int> destroyed;
+  std::thread::id destroyed_by;
+  std::thread::id service_thread;
+  unsigned count{0U};
+  {
+    io_service svc{4U};
+    svc.adopt(destruction_recorder{destroyed, 1, destroyed_by});
+    svc.adopt(destruction_recorder{destroyed, 2, destroyed_by});
+    service_thread = svc.submit([]{return std::this_thread::get_id();}).get();
+    for (unsigned i=0U; i!=10U; ++i)
+      {
+        svc.post([&count]{ ++count; });
+      }
+    svc.post([]{ throw std::runtime_error{"ignored"}; });
+  }
+  CHECK(count==10U);
+  REQUIRE(destroyed.size()==2U);
+  CHECK(destroyed[0]==2);
+  CHECK(destroyed[1]==1);
+  CHECK(destroyed_by==service_thread);
+}
+
+TEST_CASE( "Unit-tests/io_service/0030/failed posted commands counted"
+         , "Exceptions thrown by posted commands are counted"
+         )
+{
+  io_service svc{4U};
+  svc.post([]{ throw std::runtime_error{"failed"}; });
+  svc.post([]{});
+  svc.submit([]{ return 0; }).get();
+  CHECK(svc.failed_commands()==1U);
+}
@@ -0,0 +1,142 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file latency_histogram_unittests.cpp
+/// @brief Unit tests for the log-linear latency histogram.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "latency_histogram.h"
+#include <memory>
+
+using namespace dibase::rpi::peripherals;
+using std::chrono::nanoseconds;
+
+TEST_CASE( "Unit-tests/latency_histogram/0000/empty"
+         , "A new histogram has no values and reports zero"
+         )
+{
+  std::unique_ptr<latency_histogram> h{new latency_histogram};
+  CHECK( h->count()==0U );
+  CHECK( h->min()==nanoseconds(0) );
+  CHECK( h->max()==nanoseconds(0) );
+  CHECK( h->mean()==nanoseconds(0) );
+  CHECK( h->percentile(50.0)==nanoseconds(0) );
+}
+
+TEST_CASE( "Unit-tests/latency_histogram/0010/bucket boundaries"
+         , "Small values have their own buckets, larger values share "
+           "buckets 1/32 of their power of two range wide"
+         )
+{
+  for (std::uint64_t v=0U; v!=64U; ++v)
+    {
+      CHECK( latency_histogram::bucket_index(v)==v );
+      CHECK( latency_histogram::bucket_lowest(v)==v );
+      CHECK( latency_histogram::bucket_highest(v)==v );
+    }
+  CHECK( latency_histogram::bucket_index(64U)==64U );
+  CHECK( latency_histogram::bucket_index(65U)==64U );
+  CHECK( latency_histogram::bucket_index(66U)==65U );
+  CHECK( latency_histogram::bucket_lowest(64U)==64U );
+  CHECK( latency_histogram::bucket_highest(64U)==65U );
+  CHECK( latency_histogram::bucket_index(128U)==96U );
+  CHECK( latency_histogram::bucket_lowest(96U)==128U );
+  CHECK( latency_histogram::bucket_highest(96U)==131U );
+  std::size_t const last{latency_histogram::number_of_buckets-1U};
+  CHECK( latency_histogram::bucket_index(latency_histogram::max_trackable)
+        ==last
+       );
+  CHECK( latency_histogram::bucket_index(~std::uint64_t{0})==last );
+  CHECK( latency_histogram::bucket_highest(last)
+        ==latency_histogram::max_trackable
+       );
+  for (std::size_t idx=0U; idx!=last; ++idx)
+    {
+      REQUIRE( latency_histogram::bucket_highest(idx)+1U
+              ==latency_histogram::bucket_lowest(idx+1U)
+             );
+      REQUIRE( latency_histogram::bucket_index
+                                  (latency_histogram::bucket_lowest(idx))==idx
+             );
+    }
+}
+
+TEST_CASE( "Unit-tests/latency_histogram/0020/record"
+         , "Recorded values are counted in their buckets with exact min, max "
+           "and mean"
+         )
+{
+  std::unique_ptr<latency_histogram> h{new latency_histogram};
+  h->record(nanoseconds(10));
+  h->record(nanoseconds(10));
+  h->record(nanoseconds(1000));
+  h->record(nanoseconds(-5));
+  CHECK( h->count()==4U );
+  CHECK( h->bucket_count(10U)==2U );
+  CHECK( h->bucket_count(0U)==1U );
+  CHECK( h->bucket_count(latency_histogram::bucket_index(1000U))==1U );
+  CHECK( h->min()==nanoseconds(0) );
+  CHECK( h->max()==nanoseconds(1000) );
+  CHECK( h->mean()==nanoseconds(255) );
+}
+
+TEST_CASE( "Unit-tests/latency_histogram/0030/percentiles"
+         , "Percentiles are the highest value of the bucket reached, limited "
+           "to the maximum recorded"
+         )
+{
+  std::unique_ptr<latency_histogram> h{new latency_histogram};
+  for (int v=1; v<=100; ++v)
+    {
+      h->record(nanoseconds(v*1000));
+    }
+  nanoseconds const lowest{h->percentile(0.0)};
+  CHECK( lowest>=nanoseconds(1000) );
+  CHECK( lowest<=nanoseconds(1000+1000/32) );
+  CHECK( h->percentile(-1.0)==lowest );
+  nanoseconds const median{h->percentile(50.0)};
+  CHECK( median>=nanoseconds(50000) );
+  CHECK( median<=nanoseconds(50000+50000/32) );
+  nanoseconds const p99{h->percentile(99.0)};
+  CHECK( p99>=nanoseconds(99000) );
+  CHECK( p99<=nanoseconds(99000+99000/32) );
+  CHECK( h->percentile(100.0)==nanoseconds(100000) );
+  CHECK( h->percentile(200.0)==nanoseconds(100000) );
+}
+
+TEST_CASE( "Unit-tests/latency_histogram/0040/untrackable values"
+         , "Values greater than max_trackable are counted in the top bucket "
+           "and reported as the maximum"
+         )
+{
+  std::unique_ptr<latency_histogram> h{new latency_histogram};
+  nanoseconds const huge(latency_histogram::max_trackable*2U);
+  h->record(huge);
+  CHECK( h->bucket_count(latency_histogram::number_of_buckets-1U)==1U );
+  CHECK( h->max()==huge );
+  CHECK( h->percentile(50.0)==huge );
+}
+
+TEST_CASE( "Unit-tests/latency_histogram/0050/add and reset"
+         , "Adding histograms combines their values, reset forgets them"
+         )
+{
+  std::unique_ptr<latency_histogram> a{new latency_histogram};
+  std::unique_ptr<latency_histogram> b{new latency_histogram};
+  a->record(nanoseconds(20));
+  b->record(nanoseconds(5));
+  b->record(nanoseconds(300));
+  a->add(*b);
+  CHECK( a->count()==3U );
+  CHECK( a->min()==nanoseconds(5) );
+  CHECK( a->max()==nanoseconds(300) );
+  CHECK( a->bucket_count(5U)==1U );
+  CHECK( a->bucket_count(20U)==1U );
+  a->reset();
+  CHECK( a->count()==0U );
+  CHECK( a->bucket_count(5U)==0U );
+  CHECK( a->min()==nanoseconds(0) );
+  CHECK( a->max()==nanoseconds(0) );
+}
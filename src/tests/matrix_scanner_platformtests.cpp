@@ -0,0 +1,62 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file matrix_scanner_platformtests.cpp
+/// @brief System tests for the key matrix scanner type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "matrix_scanner.h"
+#include <thread>
+
+using namespace dibase::rpi::peripherals;
+
+// Change if P1 GPIO_GEN0/GPIO_GEN3 in use on your system...
+static pin_id const row_pin_id{17};     // P1 pin GPIO_GEN0
+static pin_id const column_pin_id{22};  // P1 pin GPIO_GEN3
+
+TEST_CASE( "Platform_tests/matrix_scanner/000/bad parameters fail"
+         , "Creating a matrix_scanner with a bad tick, threshold or capacity "
+           "throws"
+         )
+{
+  opin_group rows{row_pin_id};
+  ipin_group columns{{column_pin_id}, ipin::pull_up};
+  REQUIRE_THROWS_AS((matrix_scanner{ rows, columns
+                                   , std::chrono::microseconds{0}, 5U, 16U
+                                   })
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS((matrix_scanner{ rows, columns
+                                   , std::chrono::microseconds{125}, 0U, 16U
+                                   })
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS((matrix_scanner{ rows, columns
+                                   , std::chrono::microseconds{125}, 5U, 15U
+                                   })
+                   , std::invalid_argument
+                   );
+}
+
+TEST_CASE( "Platform_tests/matrix_scanner/010/no keys pressed"
+         , "Scanning a 1x1 matrix with a pulled up column and no key reports "
+           "no events"
+         )
+{
+  opin_group rows{row_pin_id};
+  ipin_group columns{{column_pin_id}, ipin::pull_up};
+  matrix_scanner scanner{ rows, columns
+                       , std::chrono::microseconds{125}, 5U, 16U
+                       };
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  CHECK(scanner.rows()==1U);
+  CHECK(scanner.columns()==1U);
+  CHECK(scanner.state()==0U);
+  CHECK_FALSE(scanner.is_pressed(0U, 0U));
+  key_event events[16];
+  CHECK(scanner.pop(events, 16U)==0U);
+  CHECK(scanner.overruns()==0U);
+  CHECK(scanner.ghosted_scans()==0U);
+  CHECK(scanner.capacity()==16U);
+}
@@ -0,0 +1,65 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file matrix_scanner_unittests.cpp
+/// @brief Unit tests for the ghost suppressing key matrix filter.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "matrix_scanner.h"
+#include <stdexcept>
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/key_matrix_filter/0000/bad sizes"
+         , "Creating a key_matrix_filter with no keys, more than 64 keys or "
+           "a bad threshold throws"
+         )
+{
+  REQUIRE_THROWS_AS((key_matrix_filter{0U, 4U, 1U}), std::invalid_argument);
+  REQUIRE_THROWS_AS((key_matrix_filter{4U, 0U, 1U}), std::invalid_argument);
+  REQUIRE_THROWS_AS((key_matrix_filter{5U, 13U, 1U}), std::invalid_argument);
+  REQUIRE_THROWS_AS((key_matrix_filter{4U, 4U, 0U}), std::invalid_argument);
+  key_matrix_filter const full{8U, 8U, 1U};
+  CHECK(full.rows()==8U);
+  CHECK(full.columns()==8U);
+  CHECK(full.state()==0U);
+}
+
+TEST_CASE( "Unit-tests/key_matrix_filter/0010/debounced keys"
+         , "Key changes are reported after the threshold number of scans at "
+           "bit row*columns+column"
+         )
+{
+  key_matrix_filter filter{3U, 4U, 2U};
+// Key (2, 1) is bit 9
+  CHECK(filter.update(0x200U)==0U);
+  CHECK(filter.update(0x200U)==0x200U);
+  CHECK(filter.state()==0x200U);
+  CHECK(filter.update(0x000U)==0U);
+  CHECK(filter.update(0x000U)==0x200U);
+  CHECK(filter.state()==0U);
+  CHECK(filter.ghosted_scans()==0U);
+}
+
+TEST_CASE( "Unit-tests/key_matrix_filter/0020/ghosts suppressed"
+         , "Keys at the corners of a rectangle of pressed keys keep their "
+           "state; other keys are unaffected"
+         )
+{
+  key_matrix_filter filter{4U, 4U, 1U};
+// Rows are nibbles: keys (0,0), (0,2), (3,0), (3,2) form a rectangle
+  CHECK(filter.ghosts(0x5005U)==0x5005U);
+  CHECK(filter.ghosts(0x1005U)==0U);
+  CHECK(filter.ghosts(0x0F10U)==0U);
+  CHECK(filter.update(0x0005U)==0x0005U);
+// Third corner and the ghost fourth appear with unrelated key (1,3)
+  CHECK(filter.update(0x5085U)==0x0080U);
+  CHECK(filter.state()==0x0085U);
+  CHECK(filter.ghosted_scans()==1U);
+// Rectangle broken: remaining keys now taken as read
+  CHECK(filter.update(0x1004U)==0x1081U);
+  CHECK(filter.state()==0x1004U);
+  CHECK(filter.ghosted_scans()==1U);
+}
@@ -0,0 +1,96 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file mpsc_ring_unittests.cpp
+/// @brief Unit tests for mpsc_ring type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "mpsc_ring.h"
+#include <thread>
+#include <vector>
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/mpsc_ring/0000/bad capacity fails"
+         , "Constructing a mpsc_ring with a capacity that is not a non-zero "
+           "power of two throws"
+         )
+{
+  REQUIRE_THROWS_AS(mpsc_ring<int>{0U}, std::invalid_argument);
+  REQUIRE_THROWS_AS(mpsc_ring<int>{6U}, std::invalid_argument);
+  mpsc_ring<int> r{8U};
+  CHECK(r.capacity()==8U);
+  int v{0};
+  CHECK_FALSE(r.try_pop(v));
+}
+
+TEST_CASE( "Unit-tests/mpsc_ring/0010/push until full then pop in order"
+         , "Pushes succeed until the ring is full, pops return elements in "
+           "order and free slots for more pushes"
+         )
+{
+  mpsc_ring<int> r{4U};
+  for (int v=0; v!=4; ++v)
+    {
+      CHECK(r.try_push(int{v}));
+    }
+  CHECK_FALSE(r.try_push(4));
+  int v{-1};
+  REQUIRE(r.try_pop(v));
+  CHECK(v==0);
+  CHECK(r.try_push(4));
+  for (int expected=1; expected!=5; ++expected)
+    {
+      REQUIRE(r.try_pop(v));
+      CHECK(v==expected);
+    }
+  CHECK_FALSE(r.try_pop(v));
+}
+
+TEST_CASE( "Unit-tests/mpsc_ring/0020/concurrent producers"
+         , "Elements pushed by several threads are all popped once, each "
+           "producer's elements in the order it pushed them"
+         )
+{
+  unsigned const producers{3U};
+  unsigned const per_producer{20000U};
+  mpsc_ring<unsigned> r{64U};
+  std::vector<std::thread> threads;
+  for (unsigned p=0U; p!=producers; ++p)
+    {
+      threads.emplace_back( [&r, p]()
+                            {
+                              for (unsigned i=0U; i!=per_producer; ++i)
+                                {
+                                  while (!r.try_push(p*per_producer+i))
+                                    {
+                                      std::this_thread::yield();
+                                    }
+                                }
+                            }
+                          );
+    }
+  std::vector<unsigned> next(producers, 0U);
+  bool in_order{true};
+  for (unsigned popped=0U; popped!=producers*per_producer;)
+    {
+      unsigned v;
+      if (r.try_pop(v))
+        {
+          in_order = in_order && v%per_producer==next[v/per_producer];
+          ++next[v/per_producer];
+          ++popped;
+        }
+    }
+  for (auto & t : threads)
+    {
+      t.join();
+    }
+  CHECK(in_order);
+  for (unsigned p=0U; p!=producers; ++p)
+    {
+      CHECK(next[p]==per_producer);
+    }
+}
@@ -0,0 +1,145 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file multiplexed_display_compiler_unittests.cpp
+/// @brief Unit tests for compiling multiplexed display refresh programs into
+/// DMA control blocks.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "multiplexed_display_compiler.h"
+#include <cstring>
+#include <cstdint>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef std::uint32_t RegisterType;
+
+namespace
+{
+  RegisterType const region_bus{0xC0200000U};
+  RegisterType const gpset0_bus{0x7E20001CU};
+  RegisterType const gpclr0_bus{0x7E200028U};
+  RegisterType const pwm_fifo_bus{0x7E20C018U};
+
+  struct alignas(32) small_region_type
+  {
+    unsigned char bytes[1024];
+  };
+
+  dma_control_block const & cb_at
+  ( dma_region const & region
+  , void * base
+  , RegisterType bus
+  )
+  {
+    return *reinterpret_cast<dma_control_block const *>
+              (static_cast<unsigned char *>(base)+(bus-region.bus_address(base)));
+  }
+}
+
+TEST_CASE( "Unit-tests/multiplexed_display_compiler/0000/bad parameters fail"
+         , "Compiling with no digits, zero or too large digit ticks or into "
+           "too small a region throws"
+         )
+{
+  small_region_type memory;
+  dma_region region{&memory, region_bus, sizeof(memory)};
+  REQUIRE_THROWS_AS( compile_multiplexed_display(region, 0U, 10U, false)
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS( compile_multiplexed_display(region, 2U, 0U, false)
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS( compile_multiplexed_display(region, 2U, 0x10000000U, false)
+                   , std::invalid_argument
+                   );
+  dma_region small_region
+              {&memory, region_bus, multiplexed_display_program_size(2U)-4U};
+  REQUIRE_THROWS_AS( compile_multiplexed_display(small_region, 2U, 10U, false)
+                   , std::bad_alloc
+                   );
+}
+
+TEST_CASE( "Unit-tests/multiplexed_display_compiler/0010/compile program"
+         , "Each frame blanks, sets, clears, selects and delays for each digit "
+           "and loops back to its own start"
+         )
+{
+  small_region_type memory;
+  std::memset(&memory, 0xFF, sizeof(memory));
+  std::size_t const size{multiplexed_display_program_size(2U)};
+// 2 frames * 2 digits * 5 CBs of 32 bytes + 2 blank words + 2 * 2 select
+// words + 2 frames * 2 digits * 4 mask words + 1 FIFO word
+  REQUIRE(size==20U*32U+23U*4U);
+  dma_region region{&memory, region_bus, size};
+  multiplexed_display_program const program
+                          {compile_multiplexed_display(region, 2U, 25U, false)};
+  CHECK(region.available()==0U);
+  CHECK(program.first_bus[0]==region_bus);
+  CHECK(program.first_bus[1]==region_bus+320U);
+  CHECK(program.select_masks==program.blank_masks+2);
+  CHECK(program.frame_masks[0]==program.blank_masks+6);
+  CHECK(program.frame_masks[1]==program.blank_masks+14);
+  for (unsigned idx=0; idx!=22U; ++idx)
+    {
+      CHECK(program.blank_masks[idx]==0U);
+    }
+  RegisterType const data_bus{region_bus+640U};
+  for (unsigned f=0; f!=2U; ++f)
+    {
+      dma_control_block const * cb
+                            {&cb_at(region, &memory, program.first_bus[f])};
+      for (unsigned digit=0; digit!=2U; ++digit)
+        {
+          RegisterType const masks_bus{data_bus+24U+32U*f+16U*digit};
+          CHECK(cb->source_address==data_bus);
+          CHECK(cb->dest_address==gpclr0_bus);
+          CHECK(cb->transfer_length==8U);
+          cb = &cb_at(region, &memory, cb->next_control_block);
+          CHECK(cb->source_address==masks_bus);
+          CHECK(cb->dest_address==gpset0_bus);
+          CHECK(cb->transfer_length==8U);
+          cb = &cb_at(region, &memory, cb->next_control_block);
+          CHECK(cb->source_address==masks_bus+8U);
+          CHECK(cb->dest_address==gpclr0_bus);
+          CHECK(cb->transfer_length==8U);
+          cb = &cb_at(region, &memory, cb->next_control_block);
+          CHECK(cb->source_address==data_bus+8U+8U*digit);
+          CHECK(cb->dest_address==gpset0_bus);
+          CHECK(cb->transfer_length==8U);
+          CHECK((cb->transfer_info&dma_control_block::ti_dest_dreq)==0U);
+          cb = &cb_at(region, &memory, cb->next_control_block);
+          CHECK(cb->source_address==data_bus+88U);
+          CHECK(cb->dest_address==pwm_fifo_bus);
+          CHECK(cb->transfer_length==100U);
+          CHECK((cb->transfer_info&dma_control_block::ti_dest_dreq)!=0U);
+          CHECK(((cb->transfer_info>>dma_control_block::ti_permap_shift)
+                &0x1FU)==5U);
+          if (digit==1U)
+            {
+              CHECK(&cb->next_control_block==program.loop_next[f]);
+            }
+          cb = &cb_at(region, &memory, cb->next_control_block);
+        }
+      CHECK(cb==&cb_at(region, &memory, program.first_bus[f]));
+    }
+}
+
+TEST_CASE( "Unit-tests/multiplexed_display_compiler/0020/low selects"
+         , "With low level digit selects blanking sets and selecting clears"
+         )
+{
+  small_region_type memory;
+  std::size_t const size{multiplexed_display_program_size(1U)};
+  dma_region region{&memory, region_bus, size};
+  multiplexed_display_program const program
+                          {compile_multiplexed_display(region, 1U, 25U, true)};
+  dma_control_block const * cb{&cb_at(region, &memory, program.first_bus[0])};
+  CHECK(cb->dest_address==gpset0_bus);
+  cb = &cb_at(region, &memory, cb->next_control_block);
+  cb = &cb_at(region, &memory, cb->next_control_block);
+  cb = &cb_at(region, &memory, cb->next_control_block);
+  CHECK(cb->dest_address==gpclr0_bus);
+}
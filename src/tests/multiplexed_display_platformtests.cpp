@@ -0,0 +1,82 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file multiplexed_display_platformtests.cpp
+/// @brief System tests for DMA refreshed multiplexed LED display type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "multiplexed_display.h"
+#include "pwm_pin.h"
+#include "periexcept.h"
+#include <thread>
+
+using namespace dibase::rpi::peripherals;
+
+static pin_id const segment_pin_id_0{17}; // P1 pin GPIO_GEN0
+static pin_id const segment_pin_id_1{22}; // P1 pin GPIO_GEN3
+static pin_id const digit_pin_id_0{23};   // P1 pin GPIO_GEN4
+static pin_id const digit_pin_id_1{24};   // P1 pin GPIO_GEN5
+static pin_id const hw_pwm_pin_id{18};    // P1 pin GPIO_GEN1, PWM0
+
+TEST_CASE( "Platform_tests/multiplexed_display/000/bad parameters fail"
+         , "Creating a display with zero digit time or shared pins or "
+           "showing bad patterns throws"
+         )
+{
+  opin_group segment_pins{segment_pin_id_0, segment_pin_id_1};
+  opin_group digit_pins{digit_pin_id_0, digit_pin_id_1};
+  REQUIRE_THROWS_AS( (multiplexed_display{segment_pins, digit_pins, 0U})
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS( (multiplexed_display{segment_pins, segment_pins, 10U})
+                   , std::invalid_argument
+                   );
+  multiplexed_display display{segment_pins, digit_pins, 2000U};
+  CHECK(display.digits()==2U);
+  CHECK(display.refresh_us()==4000U);
+  REQUIRE_THROWS_AS(display.show({1U}), std::invalid_argument);
+  REQUIRE_THROWS_AS(display.show({1U, 4U}), std::invalid_argument);
+  CHECK(display.shown()==(std::vector<pin_group_value_t>{0U, 0U}));
+}
+
+TEST_CASE( "Platform_tests/multiplexed_display/010/PWM in use fails"
+         , "Creating a display while PWM is in use throws"
+         )
+{
+  opin_group segment_pins{segment_pin_id_0, segment_pin_id_1};
+  opin_group digit_pins{digit_pin_id_0, digit_pin_id_1};
+  {
+    pwm_pin hw_pwm{hw_pwm_pin_id};
+    REQUIRE_THROWS_AS( (multiplexed_display{segment_pins, digit_pins, 2000U})
+                     , peripheral_in_use
+                     );
+  }
+  multiplexed_display display{segment_pins, digit_pins, 2000U};
+  REQUIRE_THROWS_AS( (multiplexed_display{segment_pins, digit_pins, 2000U})
+                   , peripheral_in_use
+                   );
+}
+
+TEST_CASE( "Platform_tests/multiplexed_display/020/refresh and show"
+         , "A started display refreshes until stopped while patterns are "
+           "shown, including several within one refresh cycle"
+         )
+{
+  opin_group segment_pins{segment_pin_id_0, segment_pin_id_1};
+  opin_group digit_pins{digit_pin_id_0, digit_pin_id_1};
+  multiplexed_display display{segment_pins, digit_pins, 2000U, true};
+  CHECK_FALSE(display.is_running());
+  display.start();
+  CHECK(display.is_running());
+  display.show({1U, 2U});
+  std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  display.show({3U, 0U});
+  display.show({2U, 1U});
+  display.show({0U, 3U});
+  CHECK(display.shown()==(std::vector<pin_group_value_t>{0U, 3U}));
+  std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  CHECK(display.is_running());
+  display.stop();
+  CHECK_FALSE(display.is_running());
+}
@@ -0,0 +1,76 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file od_pin_platformtests.cpp
+/// @brief System tests for open drain GPIO pin emulation types.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "od_pin.h"
+#include "periexcept.h"
+#include "gpio_ctrl.h"
+
+using namespace dibase::rpi::peripherals;
+
+namespace
+{
+// Change if P1 GPIO_GEN0/GPIO_GEN1/GPIO_GEN2 in use on your system...
+  pin_id const od_pin_a{17};  // P1 pin GPIO_GEN0, GPFSEL1
+  pin_id const od_pin_b{18};  // P1 pin GPIO_GEN1, GPFSEL1
+  pin_id const od_pin_c{27};  // P1 pin GPIO_GEN2 (rev 2), GPFSEL2
+}
+
+TEST_CASE( "Platform-tests/od_pin/0000/drive and release"
+         , "An od_pin is an input when released and an output driving the "
+           "line low when driven"
+         )
+{
+  using internal::gpio_ctrl;
+  using internal::gpio_pin_fn;
+  auto & config(gpio_ctrl::instance().config);
+  {
+    od_pin od{od_pin_a};
+    REQUIRE_THROWS_AS(opin{od_pin_a}, bad_peripheral_alloc);
+    CHECK(config.pin_function(od_pin_a)==gpio_pin_fn::input);
+    CHECK(od.get());  // pulled up
+    od.drive_low();
+    CHECK(config.pin_function(od_pin_a)==gpio_pin_fn::output);
+    CHECK_FALSE(od.get());
+    od.release();
+    CHECK(config.pin_function(od_pin_a)==gpio_pin_fn::input);
+    CHECK(od.get());
+    od.put(false);
+    CHECK(config.pin_function(od_pin_a)==gpio_pin_fn::output);
+  }
+  CHECK(config.pin_function(od_pin_a)==gpio_pin_fn::input);
+  opin o{od_pin_a}; // should throw if pin still open
+}
+
+TEST_CASE( "Platform-tests/od_pin_group/0000/drive and release"
+         , "An od_pin_group switches only the selected lines' directions"
+         )
+{
+  using internal::gpio_ctrl;
+  using internal::gpio_pin_fn;
+  auto & config(gpio_ctrl::instance().config);
+  {
+    od_pin_group odg{od_pin_a, od_pin_b, od_pin_c};
+    CHECK(odg.size()==3U);
+    CHECK(odg.get()==7U); // all pulled up
+    odg.drive_low(5U);
+    CHECK(config.pin_function(od_pin_a)==gpio_pin_fn::output);
+    CHECK(config.pin_function(od_pin_b)==gpio_pin_fn::input);
+    CHECK(config.pin_function(od_pin_c)==gpio_pin_fn::output);
+    CHECK(odg.get()==2U);
+    odg.put(3U, 1U); // release a, drive b, leave c
+    CHECK(config.pin_function(od_pin_a)==gpio_pin_fn::input);
+    CHECK(config.pin_function(od_pin_b)==gpio_pin_fn::output);
+    CHECK(config.pin_function(od_pin_c)==gpio_pin_fn::output);
+    odg.release(odg.all_pins());
+    CHECK(odg.get()==7U);
+    odg.put(0U);
+  }
+  CHECK(config.pin_function(od_pin_a)==gpio_pin_fn::input);
+  CHECK(config.pin_function(od_pin_b)==gpio_pin_fn::input);
+  CHECK(config.pin_function(od_pin_c)==gpio_pin_fn::input);
+}
@@ -0,0 +1,111 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pcm_pins_platformtests.cpp
+/// @brief Platform tests for pcm_pins and pcm_dma_stream.
+///
+/// The loop back tests require the Raspberry Pi revision 2 P5 PCM_DIN
+/// (GPIO30) and PCM_DOUT (GPIO31) pins to be connected together and no
+/// Linux I2S audio driver to be loaded.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "pcm_pins.h"
+#include "pcm_dma_stream.h"
+#include "periexcept.h"
+#include <algorithm>
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Platform-tests/pcm_pins/0000/create and destroy"
+         , "Creating a pcm_pins object allocates PCM which is freed on "
+           "destruction"
+         )
+{
+  {
+    pcm_pins pcm{ rpi_p5_pcm_pin_set, pcm_frame_format::i2s(16U)
+                , hertz{48000U*64U}
+                };
+    REQUIRE_THROWS_AS( (pcm_pins{ rpi_p5_pcm_pin_set
+                                , pcm_frame_format::i2s(16U)
+                                , hertz{48000U*64U}
+                                })
+                     , bad_peripheral_alloc
+                     );
+    CHECK(pcm.can_transmit());
+    CHECK(pcm.can_receive());
+    CHECK_FALSE(pcm.is_running());
+  }
+  pcm_pins pcm{ rpi_p5_pcm_pin_set, pcm_frame_format::i2s(16U)
+              , hertz{48000U*64U}
+              };
+}
+
+TEST_CASE( "Platform-tests/pcm_pins/0010/bad pins fail"
+         , "Pins not supporting the PCM functions throw"
+         )
+{
+  REQUIRE_THROWS_AS( (pcm_pins{ pcm_pin_set<4U,29U,30U,31U>{}
+                              , pcm_frame_format::i2s(16U)
+                              , hertz{48000U*64U}
+                              })
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS( (pcm_pins{ pcm_pin_set<28U,29U>{}
+                              , pcm_frame_format::i2s(16U)
+                              , hertz{48000U*64U}
+                              })
+                   , std::invalid_argument
+                   );
+}
+
+TEST_CASE( "Platform-tests/pcm_pins/0020/loop back FIFO write and read"
+         , "[.] Samples written are read back (needs PCM_DOUT connected to "
+           "PCM_DIN)"
+         )
+{
+  pcm_pins pcm{ rpi_p5_pcm_pin_set, pcm_frame_format::i2s(16U)
+              , hertz{48000U*64U}
+              };
+  std::uint32_t tx[128];
+  for (std::uint32_t n=0U; n!=128U; ++n)
+    {
+      tx[n] = n*0x101U;
+    }
+  CHECK(pcm.write(tx, 64U)==64U);
+  pcm.start();
+  CHECK(pcm.write_all(tx+64U, 64U)==64U);
+  std::uint32_t rx[128]{};
+  CHECK(pcm.read_all(rx, 128U)==128U);
+  pcm.stop();
+  CHECK(std::search(rx, rx+128U, tx+8U, tx+16U)!=rx+128U);
+}
+
+TEST_CASE( "Platform-tests/pcm_dma_stream/0000/loop back DMA stream"
+         , "[.] Samples streamed by DMA are received by DMA (needs PCM_DOUT "
+           "connected to PCM_DIN)"
+         )
+{
+  pcm_pins pcm{ rpi_p5_pcm_pin_set, pcm_frame_format::i2s(16U)
+              , hertz{48000U*64U}
+              };
+  pcm_dma_stream stream{pcm, 256U};
+  REQUIRE(stream.buffer_samples()==512U);
+  std::uint32_t volatile * tx_buffer{stream.wait_tx_buffer()};
+  for (std::uint32_t n=0U; n!=stream.buffer_samples(); ++n)
+    {
+      tx_buffer[n] = 0x1234U;
+    }
+  bool seen{false};
+  for (unsigned blocks=0U; blocks!=4U && !seen; ++blocks)
+    {
+      std::uint32_t volatile const * rx_buffer{stream.wait_rx_buffer()};
+      for (std::uint32_t n=0U; n!=stream.buffer_samples() && !seen; ++n)
+        {
+          seen = rx_buffer[n]==0x1234U;
+        }
+    }
+  CHECK(seen);
+  CHECK(pcm.fifo_errors().underruns==0U);
+}
@@ -0,0 +1,86 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pcm_pins_unittests.cpp
+/// @brief Unit tests for pcm_pins related types.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "pcm_pins.h"
+#include <stdexcept>
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/pcm_pin_set/0000/pins in set as expected"
+         , "Defined pcm_pin_set returns expected (pin) values"
+         )
+{
+  pcm_pin_set<1U, 2U, 3U, 4U> all_pins_set;
+  CHECK(all_pins_set.clk()==1U);
+  CHECK(all_pins_set.fs()==2U);
+  CHECK(all_pins_set.din()==3U);
+  CHECK(all_pins_set.dout()==4U);
+  pcm_pin_set<1U, 2U> receive_only_set;
+  CHECK(receive_only_set.din()==pcm_pin_not_used);
+  CHECK(receive_only_set.dout()==pcm_pin_not_used);
+  CHECK(rpi_p5_pcm_pin_set.clk()==28U);
+  CHECK(rpi_p5_pcm_pin_set.fs()==29U);
+  CHECK(rpi_p5_pcm_pin_set.din()==30U);
+  CHECK(rpi_p5_pcm_pin_set.dout()==31U);
+  CHECK(gpio18_pcm_pin_set.clk()==18U);
+  CHECK(gpio18_pcm_pin_set.dout()==21U);
+}
+
+TEST_CASE( "Unit-tests/pcm_frame_format/0000/valid formats"
+         , "Frame formats in range construct with expected channel counts"
+         )
+{
+  pcm_frame_format mono{16U, 1U, pcm_channel{16U, 0U}};
+  CHECK(mono.frame_length()==16U);
+  CHECK(mono.channels()==1U);
+  pcm_frame_format stereo{ 64U, 32U, pcm_channel{32U, 0U}
+                         , pcm_channel{32U, 32U}
+                         };
+  CHECK(stereo.frame_length()==64U);
+  CHECK(stereo.channels()==2U);
+  pcm_frame_format longest{1024U, 1023U, pcm_channel{8U, 1016U}};
+  CHECK(longest.frame_length()==1024U);
+  pcm_frame_format i2s_16{pcm_frame_format::i2s(16U)};
+  CHECK(i2s_16.frame_length()==64U);
+  CHECK(i2s_16.channels()==2U);
+  pcm_frame_format i2s_24_in_25{pcm_frame_format::i2s(24U, 25U)};
+  CHECK(i2s_24_in_25.frame_length()==50U);
+}
+
+TEST_CASE( "Unit-tests/pcm_frame_format/0010/bad formats fail"
+         , "Out of range lengths, widths or positions throw"
+         )
+{
+  CHECK_THROWS_AS( (pcm_frame_format{0U, 1U, pcm_channel{8U, 0U}})
+                 , std::invalid_argument
+                 );
+  CHECK_THROWS_AS( (pcm_frame_format{1025U, 1U, pcm_channel{8U, 0U}})
+                 , std::invalid_argument
+                 );
+  CHECK_THROWS_AS( (pcm_frame_format{16U, 0U, pcm_channel{8U, 0U}})
+                 , std::invalid_argument
+                 );
+  CHECK_THROWS_AS( (pcm_frame_format{16U, 1U, pcm_channel{0U, 0U}})
+                 , std::invalid_argument
+                 );
+  CHECK_THROWS_AS( (pcm_frame_format{64U, 1U, pcm_channel{33U, 0U}})
+                 , std::invalid_argument
+                 );
+  CHECK_THROWS_AS( (pcm_frame_format{16U, 1U, pcm_channel{16U, 1U}})
+                 , std::invalid_argument
+                 );
+  CHECK_THROWS_AS( (pcm_frame_format{ 32U, 1U, pcm_channel{16U, 0U}
+                                    , pcm_channel{7U, 16U}
+                                    })
+                 , std::invalid_argument
+                 );
+  CHECK_THROWS_AS( pcm_frame_format::i2s(7U), std::invalid_argument );
+  CHECK_THROWS_AS( pcm_frame_format::i2s(16U, 16U), std::invalid_argument );
+  CHECK_THROWS_AS( pcm_frame_format::i2s(16U, 513U), std::invalid_argument );
+}
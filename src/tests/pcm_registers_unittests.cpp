@@ -0,0 +1,144 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pcm_registers_unittests.cpp
+/// @brief Unit tests for low-level PCM / I2S control registers type.
+///
+/// Refer to the Broadcom BCM2835 Peripherals Datasheet PDF file for details:
+///
+/// http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf
+///
+/// Chapter 8 PCM / I2S Audio
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "pcm_registers.h"
+#include <cstring>
+#include <cstdint>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef uint32_t RegisterType;
+typedef unsigned char Byte;
+
+// Register byte offsets, see BCM2835 peripherals manual PCM Address Map
+// table in section 8.8 Register View
+enum RegisterOffsets
+{     CS_OFFSET=0x00,    FIFO_OFFSET=0x04,   MODE_OFFSET=0x08, RXC_OFFSET=0x0C
+,    TXC_OFFSET=0x10,    DREQ_OFFSET=0x14,  INTEN_OFFSET=0x18
+, INTSTC_OFFSET=0x1C,    GRAY_OFFSET=0x20
+};
+
+TEST_CASE( "Unit-tests/pcm_registers/0000/field offsets"
+         , "PCM registers should have the expected offsets"
+         )
+{
+  pcm_registers pcm_regs;
+  std::memset(&pcm_regs, 0xFF, sizeof(pcm_regs));
+  Byte * reg_base_addr(reinterpret_cast<Byte *>(&pcm_regs));
+
+  pcm_regs.control_and_status = CS_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[CS_OFFSET])==CS_OFFSET );
+  pcm_regs.fifo = FIFO_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[FIFO_OFFSET])
+                                                                ==FIFO_OFFSET );
+  pcm_regs.mode = MODE_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[MODE_OFFSET])
+                                                                ==MODE_OFFSET );
+  pcm_regs.receive_config = RXC_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[RXC_OFFSET])
+                                                                ==RXC_OFFSET );
+  pcm_regs.transmit_config = TXC_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[TXC_OFFSET])
+                                                                ==TXC_OFFSET );
+  pcm_regs.dma_request_level = DREQ_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[DREQ_OFFSET])
+                                                                ==DREQ_OFFSET );
+  pcm_regs.interrupt_enables = INTEN_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[INTEN_OFFSET])
+                                                               ==INTEN_OFFSET );
+  pcm_regs.interrupt_status = INTSTC_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[INTSTC_OFFSET])
+                                                              ==INTSTC_OFFSET );
+  pcm_regs.gray_mode = GRAY_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[GRAY_OFFSET])
+                                                                ==GRAY_OFFSET );
+}
+
+TEST_CASE( "Unit-tests/pcm_registers/0010/set_control keeps error flags"
+         , "Setting or clearing CS_A control bits does not clear TXERR or "
+           "RXERR by writing 1 back to them"
+         )
+{
+  pcm_registers pcm_regs;
+  std::memset(&pcm_regs, 0x00, sizeof(pcm_regs));
+  pcm_regs.control_and_status = pcm_registers::cs_tx_error
+                              | pcm_registers::cs_enable;
+  pcm_regs.set_control(pcm_registers::cs_tx_on, true);
+  CHECK(pcm_regs.control_and_status==( pcm_registers::cs_enable
+                                     | pcm_registers::cs_tx_on
+                                     ));
+  CHECK(pcm_regs.get_flag(pcm_registers::cs_tx_on));
+  pcm_regs.set_control(pcm_registers::cs_tx_on, false);
+  CHECK(pcm_regs.control_and_status==pcm_registers::cs_enable);
+  pcm_regs.clear_errors();
+  CHECK(pcm_regs.control_and_status==( pcm_registers::cs_enable
+                                     | pcm_registers::cs_tx_error
+                                     | pcm_registers::cs_rx_error
+                                     ));
+}
+
+TEST_CASE( "Unit-tests/pcm_registers/0020/set_frame"
+         , "Frame and frame sync lengths are set in MODE_A if in range"
+         )
+{
+  pcm_registers pcm_regs;
+  std::memset(&pcm_regs, 0x00, sizeof(pcm_regs));
+  pcm_regs.mode = pcm_registers::mode_clock_invert;
+  CHECK(pcm_regs.set_frame(64U, 32U));
+  CHECK(pcm_regs.mode==( pcm_registers::mode_clock_invert
+                       | (63U<<10) | 32U
+                       ));
+  CHECK(pcm_regs.get_frame_length()==64U);
+  CHECK(pcm_regs.set_frame(1024U, 1023U));
+  CHECK(pcm_regs.get_frame_length()==1024U);
+  CHECK_FALSE(pcm_regs.set_frame(0U, 1U));
+  CHECK_FALSE(pcm_regs.set_frame(1025U, 1U));
+  CHECK_FALSE(pcm_regs.set_frame(64U, 1024U));
+  CHECK(pcm_regs.get_frame_length()==1024U);
+}
+
+TEST_CASE( "Unit-tests/pcm_registers/0030/channel_config"
+         , "Channel configuration fields have enable, width and position"
+         )
+{
+  CHECK(pcm_registers::channel_config(8U, 0U)==pcm_registers::xc_enable);
+  CHECK(pcm_registers::channel_config(16U, 1U)
+                              ==(pcm_registers::xc_enable | (1U<<4) | 8U));
+  CHECK(pcm_registers::channel_config(24U, 33U)
+                              ==( pcm_registers::xc_enable
+                                | pcm_registers::xc_width_extend
+                                | (33U<<4)
+                                ));
+  CHECK(pcm_registers::channel_config(32U, 1023U)
+                              ==( pcm_registers::xc_enable
+                                | pcm_registers::xc_width_extend
+                                | (1023U<<4) | 8U
+                                ));
+  CHECK(pcm_registers::channel_config(7U, 0U)==0U);
+  CHECK(pcm_registers::channel_config(33U, 0U)==0U);
+  CHECK(pcm_registers::channel_config(16U, 1024U)==0U);
+}
+
+TEST_CASE( "Unit-tests/pcm_registers/0040/set_dma_request_levels"
+         , "DREQ_A fields are set to the requested levels"
+         )
+{
+  pcm_registers pcm_regs;
+  std::memset(&pcm_regs, 0x00, sizeof(pcm_regs));
+  pcm_regs.set_dma_request_levels(0x20U, 0x30U, 0x30U, 0x10U);
+  CHECK(pcm_regs.dma_request_level==0x10303020U);
+  pcm_regs.set_dma_request_levels(0xffU, 0U, 0U, 0U);
+  CHECK(pcm_regs.dma_request_level==0x7fU);
+}
@@ -0,0 +1,104 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file periodic_timer_unittests.cpp
+/// @brief Unit tests for periodic_timer and waiting on periodic_timers with
+/// a pin_edge_event_set.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "periodic_timer.h"
+#include "pin_edge_event_set.h"
+#include <stdexcept>
+#include <thread>
+#include <time.h>
+
+using namespace dibase::rpi::peripherals;
+
+namespace
+{
+  std::chrono::nanoseconds monotonic_now()
+  {
+    ::timespec now;
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+    return std::chrono::seconds{now.tv_sec}
+         + std::chrono::nanoseconds{now.tv_nsec};
+  }
+}
+
+TEST_CASE( "Unit-tests/periodic_timer/0000/bad period"
+         , "Creating a periodic_timer with a period that is not greater than "
+           "zero throws"
+         )
+{
+  REQUIRE_THROWS_AS(periodic_timer{std::chrono::nanoseconds{0}}
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS((periodic_timer{ std::chrono::nanoseconds{-1}
+                                   , monotonic_now()
+                                   })
+                   , std::invalid_argument
+                   );
+}
+
+TEST_CASE( "Unit-tests/periodic_timer/0010/wait"
+         , "wait returns at the next deadline, deadlines not drifting"
+         )
+{
+  std::chrono::milliseconds const period{5};
+  std::chrono::nanoseconds const start{monotonic_now()};
+  periodic_timer timer{period, start+period};
+  CHECK(timer.period()==period);
+  CHECK(timer.acknowledge()==0U);
+  for (unsigned i=0U; i!=4U; ++i)
+    {
+      CHECK(timer.wait()==1U);
+    }
+  CHECK_FALSE(monotonic_now()<start+4*period);
+  CHECK(timer.expirations()==4U);
+  CHECK(timer.overruns()==0U);
+}
+
+TEST_CASE( "Unit-tests/periodic_timer/0020/overruns"
+         , "Deadlines passed while not waiting are returned together and "
+           "counted as overruns"
+         )
+{
+  std::chrono::milliseconds const period{2};
+  periodic_timer timer{period, monotonic_now()+period};
+  std::this_thread::sleep_for(std::chrono::milliseconds{9});
+  std::uint64_t const passed{timer.acknowledge()};
+  CHECK_FALSE(passed<4U);
+  CHECK(timer.expirations()==passed);
+  CHECK(timer.overruns()==passed-1U);
+  CHECK(timer.acknowledge()==0U);
+}
+
+TEST_CASE( "Unit-tests/periodic_timer/0030/pin_edge_event_set"
+         , "A pin_edge_event_set reports signalled timers until they are "
+           "acknowledged and cancellation clears them"
+         )
+{
+  pin_edge_event_set set;
+  periodic_timer fast{std::chrono::milliseconds{2}};
+  periodic_timer slow{std::chrono::seconds{10}};
+  set.add(fast);
+  set.add(slow);
+  std::vector<pin_id> pins;
+  std::vector<periodic_timer *> timers;
+  REQUIRE(set.wait_for(pins, timers, std::chrono::seconds{1})==1U);
+  CHECK(pins.empty());
+  REQUIRE(timers.size()==1U);
+  CHECK(timers[0]==&fast);
+  CHECK(set.wait_for(pins, timers, std::chrono::milliseconds{0})==1U);
+  CHECK(timers[0]->acknowledge()!=0U);
+  CHECK(fast.expirations()!=0U);
+  set.remove(fast);
+  CHECK(set.wait_for(pins, timers, std::chrono::milliseconds{10})==0U);
+  CHECK(timers.empty());
+  set.cancel();
+  CHECK(set.wait(pins, timers)==0U);
+  set.reset();
+  set.remove(slow);
+}
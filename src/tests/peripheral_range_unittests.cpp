@@ -0,0 +1,66 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file peripheral_range_unittests.cpp
+/// @brief Unit tests for device tree peripheral range parsing.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "peripheral_range.h"
+#include <stdexcept>
+
+using namespace dibase::rpi::peripherals::internal;
+
+TEST_CASE( "Unit-tests/peripheral_range/0000/bcm2835 soc ranges"
+         , "BCM2835 3 cell soc/ranges first entry is parsed"
+         )
+{
+  std::uint8_t const ranges[]
+    { 0x7E, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00
+    , 0x40, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00
+    };
+  peripheral_range const range{parse_soc_ranges(ranges, sizeof(ranges))};
+  CHECK(range.base==0x20000000);
+  CHECK(range.size==0x01000000U);
+  CHECK_FALSE(range.gpio_pull_control_registers);
+}
+
+TEST_CASE( "Unit-tests/peripheral_range/0010/bcm2837 soc ranges"
+         , "BCM2836/7 3 cell soc/ranges first entry is parsed"
+         )
+{
+  std::uint8_t const ranges[]
+    { 0x7E, 0x00, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00 };
+  peripheral_range const range{parse_soc_ranges(ranges, sizeof(ranges))};
+  CHECK(range.base==0x3F000000);
+  CHECK(range.size==0x01000000U);
+  CHECK_FALSE(range.gpio_pull_control_registers);
+}
+
+TEST_CASE( "Unit-tests/peripheral_range/0020/bcm2711 soc ranges"
+         , "BCM2711 4 cell soc/ranges first entry is parsed"
+         )
+{
+  std::uint8_t const ranges[]
+    { 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    , 0xFE, 0x00, 0x00, 0x00, 0x01, 0x80, 0x00, 0x00
+    };
+  peripheral_range const range{parse_soc_ranges(ranges, sizeof(ranges))};
+  CHECK(range.base==0xFE000000);
+  CHECK(range.size==0x01800000U);
+  CHECK(range.gpio_pull_control_registers);
+}
+
+TEST_CASE( "Unit-tests/peripheral_range/0030/bad soc ranges"
+         , "Short or empty soc/ranges entries are rejected"
+         )
+{
+  std::uint8_t const ranges[]
+    { 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    , 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+  CHECK_THROWS_AS(parse_soc_ranges(ranges, 8U), std::invalid_argument);
+  CHECK_THROWS_AS(parse_soc_ranges(ranges, 12U), std::invalid_argument);
+  CHECK_THROWS_AS(parse_soc_ranges(ranges, sizeof(ranges)), std::invalid_argument);
+}
@@ -0,0 +1,158 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file peripheral_simulator_unittests.cpp
+/// @brief Unit tests for in-memory simulated peripheral models.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "peripheral_simulator.h"
+#include "gpio_registers.h"
+#include "spi0_registers.h"
+#include "system_timer_registers.h"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace dibase::rpi::peripherals::internal;
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/peripheral_simulator/0000/simulation requested"
+         , "Simulation is requested by any non-empty value other than 0"
+         )
+{
+  CHECK_FALSE( simulation_requested(nullptr) );
+  CHECK_FALSE( simulation_requested("") );
+  CHECK_FALSE( simulation_requested("0") );
+  CHECK( simulation_requested("1") );
+  CHECK( simulation_requested("yes") );
+  CHECK( simulation_requested("00") );
+}
+
+TEST_CASE( "Unit-tests/peripheral_simulator/0010/gpio output levels"
+         , "GPSET and GPCLR writes set GPLEV bits of output pins and are "
+           "cleared"
+         )
+{
+  gpio_registers regs;
+  std::memset(&regs, 0, sizeof(regs));
+  gpio_model model;
+  regs.set_pin_function(pin_id{17}, gpio_pin_fn::output);
+  regs.set_pin_function(pin_id{40}, gpio_pin_fn::output);
+  regs.gpset[0] = 1U<<17;
+  regs.gpset[1] = 1U<<(40-32);
+  model.step(regs);
+  CHECK( regs.gplev[0]==1U<<17 );
+  CHECK( regs.gplev[1]==1U<<(40-32) );
+  CHECK( regs.gpset[0]==0U );
+  CHECK( regs.gpset[1]==0U );
+  regs.gpclr[0] = 1U<<17;
+  model.step(regs);
+  CHECK( regs.gplev[0]==0U );
+  CHECK( regs.gplev[1]==1U<<(40-32) );
+  CHECK( regs.gpclr[0]==0U );
+}
+
+TEST_CASE( "Unit-tests/peripheral_simulator/0020/gpio input levels"
+         , "GPLEV bits of non-output pins are left alone and reflect the "
+           "latch once the pin is an output"
+         )
+{
+  gpio_registers regs;
+  std::memset(&regs, 0, sizeof(regs));
+  gpio_model model;
+  regs.gplev[0] = 1U<<4;
+  regs.gpset[0] = 1U<<22;
+  model.step(regs);
+  CHECK( regs.gplev[0]==1U<<4 );
+  regs.set_pin_function(pin_id{22}, gpio_pin_fn::output);
+  regs.set_pin_function(pin_id{4}, gpio_pin_fn::output);
+  model.step(regs);
+  CHECK( regs.gplev[0]==1U<<22 );
+}
+
+TEST_CASE( "Unit-tests/peripheral_simulator/0030/spi0 idle status"
+         , "With TA clear only TXD is set and control bits are kept"
+         )
+{
+  spi0_registers regs;
+  std::memset(&regs, 0, sizeof(regs));
+  regs.control_and_status = spi0_registers::cs_xfer_done_mask
+                          | spi0_registers::cs_rxd_mask
+                          | spi0_registers::cs_rxf_mask
+                          | spi0_registers::cs_read_enable_mask
+                          | 1U;
+  step_spi0_model(regs);
+  CHECK( regs.control_and_status==( spi0_registers::cs_txd_mask
+                                  | spi0_registers::cs_read_enable_mask
+                                  | 1U
+                                  )
+       );
+}
+
+TEST_CASE( "Unit-tests/peripheral_simulator/0040/spi0 active status"
+         , "With TA set TXD, RXD and DONE are set and CLEAR bits cleared"
+         )
+{
+  spi0_registers regs;
+  std::memset(&regs, 0, sizeof(regs));
+  regs.set_transfer_active(true);
+  regs.clear_fifo(spi0_fifo_clear_action::clear_tx_rx);
+  step_spi0_model(regs);
+  CHECK( regs.get_transfer_active() );
+  CHECK( regs.get_transfer_done() );
+  CHECK( regs.get_tx_fifo_not_full() );
+  CHECK( regs.get_rx_fifo_not_empty() );
+  CHECK_FALSE( regs.get_rx_fifo_needs_reading() );
+  CHECK_FALSE( regs.get_rx_fifo_full() );
+  std::uint32_t const clear_bits
+                  {static_cast<std::uint32_t>
+                                    (spi0_fifo_clear_action::clear_tx_rx)};
+  CHECK( (regs.control_and_status & clear_bits)==0U );
+  regs.transmit_fifo_write(0x5A);
+  CHECK( regs.receive_fifo_read()==0x5A );
+}
+
+TEST_CASE( "Unit-tests/peripheral_simulator/0050/system timer counter"
+         , "System timer counter is set to the given time"
+         )
+{
+  system_timer_registers regs;
+  std::memset(&regs, 0, sizeof(regs));
+  step_system_timer_model(regs, 0x123456789AULL);
+  CHECK( regs.get_counter()==0x123456789AULL );
+}
+
+TEST_CASE( "Unit-tests/peripheral_simulator/0100/simulator thread"
+         , "A peripheral_simulator updates simulated registers until "
+           "destroyed"
+         )
+{
+  std::vector<char> window(peripheral_range_size);
+  gpio_registers volatile & regs
+    (*reinterpret_cast<gpio_registers volatile *>
+      (&window[gpio_registers::physical_address-peripheral_base_address]));
+  system_timer_registers volatile & timer
+    (*reinterpret_cast<system_timer_registers volatile *>
+      (&window[system_timer_registers::physical_address
+              -peripheral_base_address]));
+  {
+    peripheral_simulator simulator{window.data()};
+    CHECK( timer.get_counter()!=0U );
+    regs.set_pin_function(pin_id{17}, gpio_pin_fn::output);
+    regs.gpset[0] = 1U<<17;
+    auto const give_up(std::chrono::steady_clock::now()
+                      +std::chrono::seconds{5});
+    while ( regs.gplev[0]==0U && std::chrono::steady_clock::now()<give_up )
+      {
+        std::this_thread::yield();
+      }
+    CHECK( regs.gplev[0]==1U<<17 );
+  }
+  regs.gpset[0] = 1U<<17;
+  std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  CHECK( regs.gpset[0]==1U<<17 );
+}
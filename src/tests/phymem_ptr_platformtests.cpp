@@ -25,6 +25,7 @@
 #include <array>
 #include <utility>
 #include <sys/mman.h>
+#include <unistd.h>
 
 size_t const PeripheralsBlockSize(4096);
 off_t  const PeripheralsBaseAddress(0x20000000);
@@ -414,3 +415,71 @@ TEST_CASE( "Platform_tests/phymem_ptr/std::array, move assign"
   REQUIRE( errno == ENOMEM );
 }
 
+
+TEST_CASE( "Platform_tests/phymem_ptr/peripheral window views"
+         , "Views of a block share the window mapping and do not unmap it"
+         )
+{
+  PeripheralAccessType * raw_peripheral_ptr(nullptr);
+  {
+    phymem_ptr<PeripheralAccessType>
+      view_1(peripheral_window::instance(), GpioBaseAddress, PeripheralsBlockSize);
+    phymem_ptr<PeripheralAccessType>
+      view_2(peripheral_window::instance(), GpioBaseAddress, PeripheralsBlockSize);
+    raw_peripheral_ptr = view_1.get();
+    REQUIRE( raw_peripheral_ptr != nullptr );
+    CHECK( view_2.get() == raw_peripheral_ptr );
+    phymem_ptr<PeripheralAccessType>
+      bsc1_view(peripheral_window::instance(), Bsc1BaseAddress, PeripheralsBlockSize);
+    CHECK( reinterpret_cast<char volatile *>(bsc1_view.get())
+          -reinterpret_cast<char volatile *>(raw_peripheral_ptr)
+           == Bsc1BaseAddress-GpioBaseAddress
+         );
+  }
+// Window mapping remains after views destroyed: mlock should succeed
+  REQUIRE( mlock((const void*)raw_peripheral_ptr, PeripheralsBlockSize) == 0 );
+  REQUIRE( munlock((const void*)raw_peripheral_ptr, PeripheralsBlockSize) == 0 );
+}
+
+TEST_CASE( "Platform_tests/phymem_ptr/peripheral window view out of range"
+         , "Creating a view of a region outside the window throws"
+         )
+{
+  typedef phymem_ptr<PeripheralAccessType> view_type;
+  REQUIRE_THROWS_AS( view_type( peripheral_window::instance()
+                              , PeripheralsBaseAddress-PeripheralsBlockSize
+                              , PeripheralsBlockSize
+                              )
+                   , std::out_of_range
+                   );
+  REQUIRE_THROWS_AS( view_type( peripheral_window::instance()
+                              , PeripheralsBaseAddress
+                                + peripheral_window::instance().mapped_range().size
+                              , PeripheralsBlockSize
+                              )
+                   , std::out_of_range
+                   );
+}
+
+TEST_CASE( "Platform_tests/phymem_ptr/dev gpiomem device mapping"
+         , "Mapping /dev/gpiomem from offset 0 accesses the GPIO registers"
+         )
+{
+  if (access("/dev/gpiomem", R_OK|W_OK)!=0)
+    {
+      WARN("/dev/gpiomem not accessible: test skipped.");
+      return;
+    }
+  PeripheralAccessType * raw_peripheral_ptr(nullptr);
+  {
+    phymem_ptr<PeripheralAccessType>
+      gpiomem_ptr("/dev/gpiomem", 0, PeripheralsBlockSize);
+    raw_peripheral_ptr = gpiomem_ptr.get();
+    REQUIRE( raw_peripheral_ptr != nullptr );
+    phymem_ptr<PeripheralAccessType>
+      view(peripheral_window::instance(), GpioBaseAddress, PeripheralsBlockSize);
+    CHECK( *gpiomem_ptr == *view );
+  }
+  REQUIRE( mlock((const void*)raw_peripheral_ptr, PeripheralsBlockSize) == -1 );
+  REQUIRE( errno == ENOMEM );
+}
@@ -94,3 +94,59 @@ TEST_CASE( "Unit_tests/103/pin_allocator/dealloc_free_pin_throws"
   REQUIRE(a.is_in_use(available_pin_id)==false);
   REQUIRE_THROWS_AS(a.deallocate(available_pin_id), std::logic_error);
 }
+
+// Registry separate from the default one in case other processes use it...
+char const * const test_registry_name{"/dibase-rpi-peripherals-pins-tests"};
+
+TEST_CASE( "Platform_tests/200/pin_shm_allocator/is_in_use_initially_reports_free"
+         , "The available_pin_id is initially not owned and assumed to be free"
+         )
+{
+  pin_shm_allocator a{test_registry_name};
+  REQUIRE(a.is_in_use(available_pin_id)==false);
+}
+
+TEST_CASE( "Platform_tests/201/pin_shm_allocator/alloc_pin_is_in_use_unalloc_is_free"
+         , "Allocate available_pin_id is in use, deallocate it is free"
+         )
+{
+  pin_shm_allocator a{test_registry_name};
+  a.allocate(available_pin_id);
+  CHECK(a.is_in_use(available_pin_id)==true);
+  a.deallocate(available_pin_id);
+  CHECK(a.is_in_use(available_pin_id)==false);
+}
+
+TEST_CASE( "Platform_tests/202/pin_shm_allocator/alloc_in_use_pin_throws"
+         , "Allocate available_pin_id twice should throw on 2nd allocation."
+         )
+{
+  pin_shm_allocator a{test_registry_name};
+  a.allocate(available_pin_id);
+  REQUIRE(a.is_in_use(available_pin_id)==true);
+  REQUIRE_THROWS_AS(a.allocate(available_pin_id), bad_peripheral_alloc);
+  a.deallocate(available_pin_id);
+  CHECK(a.is_in_use(available_pin_id)==false);
+}
+
+TEST_CASE( "Platform_tests/203/pin_shm_allocator/dealloc_free_pin_throws"
+         , "Deallocate available_pin_id when free should throw."
+         )
+{
+  pin_shm_allocator a{test_registry_name};
+  REQUIRE(a.is_in_use(available_pin_id)==false);
+  REQUIRE_THROWS_AS(a.deallocate(available_pin_id), std::runtime_error);
+}
+
+TEST_CASE( "Platform_tests/204/pin_shm_allocator/allocations_shared_by_mappings"
+         , "Allocation through one mapping is seen through another"
+         )
+{
+  pin_shm_allocator a{test_registry_name};
+  pin_shm_allocator b{test_registry_name};
+  a.allocate(available_pin_id);
+  CHECK(b.is_in_use(available_pin_id)==true);
+  CHECK_THROWS_AS(b.allocate(available_pin_id), bad_peripheral_alloc);
+  b.deallocate(available_pin_id);
+  CHECK(a.is_in_use(available_pin_id)==false);
+}
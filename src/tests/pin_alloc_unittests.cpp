@@ -19,12 +19,24 @@ struct mock_allocator
                         ("Oops - unexpected call to mock_allocator::allocate");
     in_use = true;
   }
+  void allocate_all( pin_id const * /*pins*/, std::size_t /*count*/ )
+  {
+    if (in_use) throw bad_peripheral_alloc
+                            ("Oops - in use in mock_allocator::allocate_all");
+    in_use = true;
+  }
   void deallocate( pin_id /*pin*/ )
   {
     if (!in_use) throw std::domain_error
                         ("Oops - unexpected call to mock_allocator::deallocate");
     in_use = false;
   }
+  void deallocate_all( pin_id const * /*pins*/, std::size_t /*count*/ )
+  {
+    if (!in_use) throw std::domain_error
+                ("Oops - unexpected call to mock_allocator::deallocate_all");
+    in_use = false;
+  }
   bool is_in_use( pin_id /*pin*/ )
   {
     return in_use;
@@ -196,3 +208,76 @@ TEST_CASE( "Unit_tests/pin_cache_allocator/is_in_use_only_passes_on_request_if_l
   mock_allocator::in_use = true;
   CHECK(a.is_in_use(pin_id(12))==true);
 }
+
+TEST_CASE( "Unit_tests/pin_cache_allocator/alloc_all_marks_all_in_use"
+         , "Allocating several pins together marks them all in use and passes "
+           "one request to the wrapped allocator"
+         )
+{
+  mock_allocator::in_use = false;
+  pin_cache_allocator<mock_allocator> a;
+  pin_id const pins[]{pin_id(13), pin_id(14), pin_id(15)};
+  a.allocate_all(pins, 3);
+  CHECK(mock_allocator::in_use==true);
+  CHECK(a.is_in_use(pin_id(13))==true);
+  CHECK(a.is_in_use(pin_id(14))==true);
+  CHECK(a.is_in_use(pin_id(15))==true);
+}
+
+TEST_CASE( "Unit_tests/pin_cache_allocator/alloc_all_duplicate_pin_throws"
+         , "Allocating several pins together with a pin repeated throws and "
+           "leaves no pins in use"
+         )
+{
+  mock_allocator::in_use = false;
+  pin_cache_allocator<mock_allocator> a;
+  pin_id const pins[]{pin_id(16), pin_id(17), pin_id(16)};
+  REQUIRE_THROWS_AS(a.allocate_all(pins, 3), bad_peripheral_alloc);
+  CHECK(mock_allocator::in_use==false);
+  CHECK(a.is_in_use(pin_id(16))==false);
+  CHECK(a.is_in_use(pin_id(17))==false);
+}
+
+TEST_CASE( "Unit_tests/pin_cache_allocator/alloc_all_used_elsewhere_throws"
+         , "Allocating several pins together throws and leaves no pins "
+           "locally in use if the wrapped allocator fails"
+         )
+{
+  pin_cache_allocator<mock_allocator> a;
+  mock_allocator::in_use = true;
+  pin_id const pins[]{pin_id(18), pin_id(19)};
+  REQUIRE_THROWS_AS(a.allocate_all(pins, 2), bad_peripheral_alloc);
+  mock_allocator::in_use = false;
+  CHECK(a.is_in_use(pin_id(18))==false);
+  CHECK(a.is_in_use(pin_id(19))==false);
+}
+
+TEST_CASE( "Unit_tests/pin_cache_allocator/dealloc_all_in_use_pins"
+         , "Deallocating several pins locally in use together passes one "
+           "request on and marks them free"
+         )
+{
+  mock_allocator::in_use = false;
+  pin_cache_allocator<mock_allocator> a;
+  pin_id const pins[]{pin_id(20), pin_id(21)};
+  a.allocate_all(pins, 2);
+  a.deallocate_all(pins, 2);
+  CHECK(mock_allocator::in_use==false);
+  CHECK(a.is_in_use(pin_id(20))==false);
+  CHECK(a.is_in_use(pin_id(21))==false);
+}
+
+TEST_CASE( "Unit_tests/pin_cache_allocator/dealloc_all_free_pin_throws"
+         , "Deallocating several pins together with one not locally in use "
+           "throws and leaves all the others in use"
+         )
+{
+  mock_allocator::in_use = false;
+  pin_cache_allocator<mock_allocator> a;
+  a.allocate(pin_id(22));
+  pin_id const pins[]{pin_id(22), pin_id(23)};
+  REQUIRE_THROWS_AS(a.deallocate_all(pins, 2), std::logic_error);
+  CHECK(mock_allocator::in_use==true);
+  CHECK(a.is_in_use(pin_id(22))==true);
+  a.deallocate(pin_id(22));
+}
@@ -95,3 +95,23 @@ TEST_CASE( "Platform_tests/pin_edge_event/050/not signalled after cleared"
   pin_evt.clear();
   CHECK_FALSE(pin_evt.signalled());
 }
+
+TEST_CASE( "Platform_tests/pin_edge_event/060/error_code overloads"
+         , "signalled, clear, wait and wait_for with an error_code behave as "
+           "the throwing overloads and clear the error_code on success"
+         )
+{
+  ipin in_pin{available_pin_id};
+  REQUIRE(is_exported(available_pin_id)==true);
+  pin_edge_event pin_evt(in_pin,pin_edge_event::rising);
+  std::error_code ec{std::make_error_code(std::errc::interrupted)};
+  CHECK(pin_evt.signalled(ec));
+  CHECK_FALSE(ec);
+  pin_evt.wait(ec);
+  CHECK_FALSE(ec);
+  pin_evt.clear(ec);
+  CHECK_FALSE(ec);
+  CHECK_FALSE(pin_evt.signalled(ec));
+  CHECK_FALSE(pin_evt.wait_for(std::chrono::milliseconds(1), ec));
+  CHECK_FALSE(ec);
+}
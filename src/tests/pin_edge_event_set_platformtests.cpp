@@ -0,0 +1,59 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pin_edge_event_set_platformtests.cpp
+/// @brief System tests for the pin edge event set type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "pin_edge_event_set.h"
+#include "pin.h"
+#include <system_error>
+
+using namespace dibase::rpi::peripherals;
+
+static pin_id const set_pin_id{21}; // P1 pin GPIO_GEN2
+
+TEST_CASE( "Platform_tests/pin_edge_event_set/000/wait_for with no events times out"
+         , "Waiting on a set with no signalled events returns 0 after time out"
+         )
+{
+  ipin in_pin{set_pin_id};
+  pin_edge_event evt{in_pin, pin_edge_event::rising};
+  evt.clear();
+  pin_edge_event_set evt_set;
+  evt_set.add(evt);
+  std::vector<pin_id> pins{set_pin_id};
+  CHECK(evt_set.wait_for(pins, std::chrono::milliseconds{10})==0U);
+  CHECK(pins.empty());
+  evt_set.remove(evt);
+}
+
+TEST_CASE( "Platform_tests/pin_edge_event_set/010/add twice or remove absent fails"
+         , "Adding a pin_edge_event twice or removing one not in a set throws"
+         )
+{
+  ipin in_pin{set_pin_id};
+  pin_edge_event evt{in_pin, pin_edge_event::rising};
+  pin_edge_event_set evt_set;
+  REQUIRE_THROWS_AS(evt_set.remove(evt), std::system_error);
+  evt_set.add(evt);
+  REQUIRE_THROWS_AS(evt_set.add(evt), std::system_error);
+  evt_set.remove(evt);
+}
+
+TEST_CASE( "Platform_tests/pin_edge_event_set/020/cancel and reset"
+         , "A cancelled set returns immediately from waits until reset"
+         )
+{
+  pin_edge_event_set evt_set;
+  CHECK_FALSE(evt_set.is_cancelled());
+  evt_set.cancel();
+  CHECK(evt_set.is_cancelled());
+  std::vector<pin_id> pins;
+  CHECK(evt_set.wait(pins)==0U);
+  CHECK(evt_set.wait_for(pins, std::chrono::hours{1})==0U);
+  evt_set.reset();
+  CHECK_FALSE(evt_set.is_cancelled());
+  CHECK(evt_set.wait_for(pins, std::chrono::milliseconds{1})==0U);
+}
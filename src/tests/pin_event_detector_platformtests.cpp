@@ -0,0 +1,91 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pin_event_detector_platformtests.cpp
+/// @brief System tests for register level GPIO pin event detection.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "pin_event_detector.h"
+#include <stdexcept>
+#include <vector>
+
+using namespace dibase::rpi::peripherals;
+
+// Change if P1 GPIO_GEN0/GPIO_GEN1 in use on your system...
+static pin_id available_pin_id_0{17}; // P1 pin GPIO_GEN0
+static pin_id available_pin_id_1{18}; // P1 pin GPIO_GEN1
+
+TEST_CASE( "Platform_tests/000/pin_event_detector/bad modes throw"
+         , "Creating a pin_event_detector with no or invalid modes throws"
+         )
+{
+  ipin_group ig{available_pin_id_0, available_pin_id_1};
+  REQUIRE_THROWS_AS((pin_event_detector{ig, 0U}), std::invalid_argument);
+  REQUIRE_THROWS_AS((pin_event_detector{ig, 64U}), std::invalid_argument);
+}
+
+TEST_CASE( "Platform_tests/010/pin_event_detector/no edges no events"
+         , "A pin_event_detector on pulled pins with no edges has no events"
+         )
+{
+  ipin_group ig{{available_pin_id_0, available_pin_id_1}, ipin::pull_down};
+  pin_event_detector ped{ig, pin_event_detector::both};
+  CHECK(ped.signalled()==0U);
+  CHECK(ped.fetch_and_clear()==0U);
+}
+
+TEST_CASE( "Platform_tests/020/pin_event_detector/poll times out"
+         , "Polling a pin_event_detector on pulled pins with no edges times "
+           "out after the given time without setting the timestamp"
+         )
+{
+  ipin_group ig{{available_pin_id_0, available_pin_id_1}, ipin::pull_down};
+  pin_event_detector ped{ig, pin_event_detector::both};
+  system_timer::time_point when{};
+  auto t0(system_timer::now());
+  CHECK(ped.poll(std::chrono::microseconds{2000}, when)==0U);
+  CHECK((system_timer::now()-t0)>=std::chrono::microseconds{2000});
+  CHECK(when==system_timer::time_point{});
+  CHECK(ped.fetch_and_clear(when)==0U);
+  CHECK(when==system_timer::time_point{});
+}
+
+TEST_CASE( "Platform_tests/030/pin_event_detector/arm and disarm"
+         , "Arming and disarming group pins updates which pins are armed"
+         )
+{
+  ipin_group ig{{available_pin_id_0, available_pin_id_1}, ipin::pull_down};
+  pin_event_detector ped{ig, pin_event_detector::both};
+  CHECK(ped.armed()==3U);
+  ped.disarm(1U);
+  CHECK(ped.armed()==2U);
+  ped.disarm();
+  CHECK(ped.armed()==0U);
+  ped.arm(2U);
+  CHECK(ped.armed()==2U);
+  ped.arm();
+  CHECK(ped.armed()==3U);
+  CHECK(ped.fetch_and_clear()==0U);
+}
+
+TEST_CASE( "Platform_tests/040/pin_event_detector/level latch counts"
+         , "High level detection on pulled down pins never latches; low level "
+           "detection latches in every poll while the pins stay low"
+         )
+{
+  ipin_group ig{{available_pin_id_0, available_pin_id_1}, ipin::pull_down};
+  std::vector<std::uint64_t> counts;
+  {
+    pin_event_detector ped{ig, pin_event_detector::high};
+    CHECK(ped.fetch_and_count(counts)==0U);
+    REQUIRE(counts.size()==2U);
+    CHECK(counts[0]==0U);
+    CHECK(counts[1]==0U);
+  }
+  pin_event_detector ped{ig, pin_event_detector::low};
+  CHECK(ped.fetch_and_count(counts)==3U);
+  CHECK(ped.fetch_and_count(counts)==3U);
+  CHECK(counts[0]==2U);
+  CHECK(counts[1]==2U);
+}
@@ -0,0 +1,111 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pin_group_platformtests.cpp
+/// @brief System tests for GPIO pin group IO types.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "pin_group.h"
+#include "pin.h"
+#include "periexcept.h"
+
+using namespace dibase::rpi::peripherals;
+
+// Change if P1 GPIO_GEN0/GPIO_GEN1 in use on your system...
+static pin_id available_pin_id_0{17}; // P1 pin GPIO_GEN0
+static pin_id available_pin_id_1{18}; // P1 pin GPIO_GEN1
+
+TEST_CASE( "Platform_tests/000/opin_group/RAII construct allocates all pins"
+         , "An opin_group allocates all its pins on construction and frees "
+           "them on destruction"
+         )
+{
+  {
+    opin_group og{available_pin_id_0, available_pin_id_1};
+    CHECK(og.size()==2);
+    CHECK(og.get_pin(0)==available_pin_id_0);
+    CHECK(og.get_pin(1)==available_pin_id_1);
+    CHECK(og.all_pins()==3U);
+    REQUIRE_THROWS_AS((opin(available_pin_id_0)), bad_peripheral_alloc);
+    REQUIRE_THROWS_AS((opin(available_pin_id_1)), bad_peripheral_alloc);
+  }
+  opin o0{available_pin_id_0}; // should throw if pin still open
+  opin o1{available_pin_id_1}; // should throw if pin still open
+}
+
+TEST_CASE( "Platform_tests/010/opin_group/failed construct allocates no pins"
+         , "An opin_group that fails to allocate one of its pins leaves none "
+           "of its pins allocated"
+         )
+{
+  {
+    opin o1{available_pin_id_1};
+    REQUIRE_THROWS_AS( (opin_group{available_pin_id_0, available_pin_id_1})
+                     , bad_peripheral_alloc
+                     );
+  }
+  opin o0{available_pin_id_0}; // should throw if pin still open
+  REQUIRE_THROWS_AS( (opin_group{available_pin_id_1, available_pin_id_1})
+                   , bad_peripheral_alloc
+                   );
+  opin o1{available_pin_id_1}; // should throw if pin still open
+}
+
+TEST_CASE( "Platform_tests/020/ipin_group/RAII construct allocates all pins"
+         , "An ipin_group allocates all its pins on construction and frees "
+           "them on destruction"
+         )
+{
+  {
+    ipin_group ig{available_pin_id_0, available_pin_id_1};
+    CHECK(ig.size()==2);
+    CHECK((ig.get()&~ig.all_pins())==0U);
+    REQUIRE_THROWS_AS((ipin(available_pin_id_0)), bad_peripheral_alloc);
+    REQUIRE_THROWS_AS((ipin(available_pin_id_1)), bad_peripheral_alloc);
+  }
+  ipin i0{available_pin_id_0}; // should throw if pin still open
+  ipin i1{available_pin_id_1}; // should throw if pin still open
+}
+
+TEST_CASE( "Platform_tests/030/ipin_group/pull modes reflected in levels"
+         , "An ipin_group opened with pull up reads all ones and with pull down "
+           "reads all zeros, matching a gpio_snapshot"
+         )
+{
+  {
+    ipin_group ig{{available_pin_id_0, available_pin_id_1}, ipin::pull_up};
+    CHECK(ig.get()==ig.all_pins());
+    gpio_snapshot_t snapshot(gpio_snapshot());
+    CHECK(snapshot.test(available_pin_id_0));
+    CHECK(snapshot.test(available_pin_id_1));
+  }
+  {
+    ipin_group ig{{available_pin_id_0, available_pin_id_1}, ipin::pull_down};
+    CHECK(ig.get()==0U);
+    gpio_snapshot_t snapshot(gpio_snapshot());
+    CHECK_FALSE(snapshot.test(available_pin_id_0));
+    CHECK_FALSE(snapshot.test(available_pin_id_1));
+  }
+}
+
+TEST_CASE( "Platform_tests/040/opin_group/put maps group bits to pins"
+         , "Values put to an opin_group whose pins are partly consecutive "
+           "and partly not drive each pin from its group bit"
+         )
+{
+  static pin_id const p22{22};  // P1 pin GPIO_GEN3
+  static pin_id const p23{23};  // P1 pin GPIO_GEN4
+  static pin_id const p27{27};  // P1 pin GPIO_GEN2 (rev 2)
+  opin_group og{available_pin_id_1, available_pin_id_0, p22, p23, p27};
+  for (pin_group_value_t v : {0x00U, 0x1FU, 0x0AU, 0x15U, 0x0CU, 0x13U})
+    {
+      og.put(v);
+      gpio_snapshot_t snapshot(gpio_snapshot());
+      CHECK(snapshot.test(available_pin_id_1)==((v&0x01U)!=0));
+      CHECK(snapshot.test(available_pin_id_0)==((v&0x02U)!=0));
+      CHECK(snapshot.test(p22)==((v&0x04U)!=0));
+      CHECK(snapshot.test(p23)==((v&0x08U)!=0));
+      CHECK(snapshot.test(p27)==((v&0x10U)!=0));
+    }
+}
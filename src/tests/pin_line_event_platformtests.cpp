@@ -0,0 +1,61 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pin_line_event_platformtests.cpp
+/// @brief System tests for the GPIO character device pin edge event type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "pin_line_event.h"
+#include "pin_edge_event_set.h"
+#include "periexcept.h"
+
+using namespace dibase::rpi::peripherals;
+
+static pin_id const line_pin_id{21}; // P1 pin GPIO_GEN2
+
+TEST_CASE( "Platform_tests/pin_line_event/000/create with bad edge mode fails"
+         , "Creating a pin_line_event with an bad edge event mode value throws"
+         )
+{
+  REQUIRE_THROWS_AS(pin_line_event(line_pin_id,pin_edge_event::edge_mode(1232))
+                   ,std::invalid_argument);
+}
+
+TEST_CASE( "Platform_tests/pin_line_event/010/line in use fails"
+         , "Creating a pin_line_event for a line already requested or open as "
+           "an ipin throws"
+         )
+{
+  {
+    pin_line_event evt{line_pin_id, pin_edge_event::both};
+    CHECK(evt.get_pin()==line_pin_id);
+    REQUIRE_THROWS_AS( pin_line_event(line_pin_id, pin_edge_event::rising)
+                     , bad_peripheral_alloc
+                     );
+  }
+  {
+    ipin in_pin{line_pin_id};
+    REQUIRE_THROWS_AS( pin_line_event(line_pin_id, pin_edge_event::rising)
+                     , bad_peripheral_alloc
+                     );
+  }
+  pin_line_event evt{line_pin_id, pin_edge_event::rising};
+}
+
+TEST_CASE( "Platform_tests/pin_line_event/020/no edges read and wait time out"
+         , "Reading or waiting with no edges occurring returns no events"
+         )
+{
+  pin_line_event evt{line_pin_id, pin_edge_event::rising};
+  edge_event_record events[4];
+  CHECK_FALSE(evt.signalled());
+  CHECK(evt.read(events, 4)==0U);
+  CHECK(evt.wait_for(events, 4, std::chrono::milliseconds{10})==0U);
+  CHECK(evt.lost()==0U);
+  pin_edge_event_set evt_set;
+  evt_set.add(evt);
+  std::vector<pin_id> pins;
+  CHECK(evt_set.wait_for(pins, std::chrono::milliseconds{10})==0U);
+  evt_set.remove(evt);
+}
@@ -7,7 +7,16 @@
 
 #include "catch.hpp"
 #include "pin.h"
+#include "static_pin.h"
+#include "pin_bank.h"
 #include "periexcept.h"
+#include <utility>
+#include <vector>
+#include <cstdlib>
+#include <grp.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 using namespace dibase::rpi::peripherals;
 
@@ -36,3 +45,181 @@ TEST_CASE( "Platform_tests/010/ipin/RAII construct allocates, destruct frees"
   }
   ipin i{available_in_pin_id}; // should throw if pin still open
 }
+
+TEST_CASE( "Platform_tests/020/static_opin/RAII construct allocates, destruct frees"
+         , "A static_opin is allocated on construction and is freed on "
+           "destruction"
+         )
+{
+  {
+    static_opin<4> o;
+    CHECK(o.get_pin()==available_out_pin_id);
+    REQUIRE_THROWS_AS((opin(available_out_pin_id)), bad_peripheral_alloc);
+    o.put(true);
+    o.put(false);
+  }
+  opin o{available_out_pin_id}; // should throw if pin still open
+}
+
+TEST_CASE( "Platform_tests/030/static_ipin/RAII construct allocates, destruct frees"
+         , "A static_ipin is allocated on construction and is freed on "
+           "destruction and reflects pull up/down state"
+         )
+{
+  {
+    static_ipin<17> i{ipin::pull_up};
+    CHECK(i.get_pin()==available_in_pin_id);
+    REQUIRE_THROWS_AS((ipin(available_in_pin_id)), bad_peripheral_alloc);
+    CHECK(i.get());
+  }
+  {
+    static_ipin<17> i{ipin::pull_down};
+    CHECK_FALSE(i.get());
+  }
+  ipin i{available_in_pin_id}; // should throw if pin still open
+}
+
+TEST_CASE( "Platform_tests/040/opin/move transfers ownership"
+         , "Moving an opin transfers the open pin, which is freed once when "
+           "the moved to object is destroyed"
+         )
+{
+  {
+    std::vector<opin> pins;
+    pins.push_back(opin{available_out_pin_id});
+    pins.emplace_back(available_in_pin_id);
+    REQUIRE_THROWS_AS((opin(available_out_pin_id)), bad_peripheral_alloc);
+    opin o{std::move(pins[0])};
+    pins.erase(pins.begin());  // destroys moved from object
+    REQUIRE_THROWS_AS((opin(available_out_pin_id)), bad_peripheral_alloc);
+    o.put(false);
+  }
+  opin o{available_out_pin_id}; // should throw if pin still open
+  opin i{available_in_pin_id};
+}
+
+TEST_CASE( "Platform_tests/050/ipin/move assign frees target's pin"
+         , "Move assigning an ipin frees the pin it had open and takes over "
+           "the source's pin"
+         )
+{
+  {
+    ipin i{available_in_pin_id};
+    ipin j{available_out_pin_id};
+    i = std::move(j);
+    ipin k{available_in_pin_id};   // should throw if pin still open
+    REQUIRE_THROWS_AS((ipin(available_out_pin_id)), bad_peripheral_alloc);
+  }
+  ipin i{available_out_pin_id}; // should throw if pin still open
+}
+
+TEST_CASE( "Platform_tests/060/pin_bank/opens all pins, pins freed when closed"
+         , "A pin_bank opens all its pins, which may be moved out, and they "
+           "are freed when the pins are destroyed"
+         )
+{
+  {
+    pin_bank bank{ {available_out_pin_id}
+                 , {{available_in_pin_id, ipin::pull_up}}
+                 };
+    REQUIRE(bank.outputs().size()==1U);
+    REQUIRE(bank.inputs().size()==1U);
+    REQUIRE_THROWS_AS((opin(available_out_pin_id)), bad_peripheral_alloc);
+    REQUIRE_THROWS_AS((ipin(available_in_pin_id)), bad_peripheral_alloc);
+    CHECK(bank.inputs()[0].get()==true);
+    opin o{std::move(bank.outputs()[0])};
+    o.put(true);
+    o.put(false);
+  }
+  opin o{available_out_pin_id}; // should throw if pin still open
+  ipin i{available_in_pin_id};
+}
+
+TEST_CASE( "Platform_tests/070/pin_bank/fails opening none if any pin in use"
+         , "A pin_bank opens no pins if any pin is already open or repeated"
+         )
+{
+  {
+    opin o{available_out_pin_id};
+    REQUIRE_THROWS_AS( (pin_bank{{available_in_pin_id, available_out_pin_id}})
+                     , bad_peripheral_alloc
+                     );
+  }
+  REQUIRE_THROWS_AS( (pin_bank{ {available_out_pin_id}
+                              , {{available_out_pin_id, ipin::pull_disable}}
+                              })
+                   , bad_peripheral_alloc
+                   );
+  opin o{available_out_pin_id}; // should throw if pin still open
+  opin i{available_in_pin_id};
+}
+
+TEST_CASE( "Platform_tests/080/ipin/close_all closes and frees all pins"
+         , "ipin::close_all closes all the pins in a vector, disabling pull "
+           "up and down, and leaves the vector empty"
+         )
+{
+  {
+    std::vector<ipin> pins;
+    pins.emplace_back(available_in_pin_id, ipin::pull_up);
+    pins.emplace_back(available_out_pin_id, ipin::pull_disable);
+    ipin::close_all(pins);
+    CHECK(pins.empty());
+  }
+  ipin i{available_in_pin_id}; // should throw if pin still open
+  ipin j{available_out_pin_id};
+}
+
+namespace
+{
+  char const * const gpiomem_child_variable{"DIBASE_RPI_GPIOMEM_TEST_CHILD"};
+  char const * const gpiomem_test_name
+                  {"Platform_tests/090/ipin/pull up through /dev/gpiomem"};
+  uid_t const nobody_uid{65534};
+}
+
+TEST_CASE( "Platform_tests/090/ipin/pull up through /dev/gpiomem"
+         , "A process that cannot open /dev/mem but can use /dev/gpiomem can "
+           "open an ipin with pull up. Run as root: the test re-runs itself "
+           "as user nobody in the groups owning /dev/gpiomem and GPIO sysfs"
+         )
+{
+  if ( std::getenv(gpiomem_child_variable)!=nullptr )
+    { // Unprivileged re-run
+      REQUIRE(access("/dev/mem", R_OK|W_OK)!=0);
+      ipin i{available_in_pin_id, ipin::pull_up};
+      CHECK(i.get());
+      return;
+    }
+  struct stat gpiomem_stat;
+  struct stat export_stat;
+  if ( geteuid()!=0
+    || stat("/dev/gpiomem", &gpiomem_stat)!=0
+    || stat("/sys/class/gpio/export", &export_stat)!=0
+     )
+    {
+      WARN("Not root or no /dev/gpiomem: test skipped.");
+      return;
+    }
+  pid_t const child{fork()};
+  REQUIRE(child!=-1);
+  if ( child==0 )
+    {
+      gid_t const groups[2]{gpiomem_stat.st_gid, export_stat.st_gid};
+      if ( setgroups(2, groups)==0
+        && setgid(gpiomem_stat.st_gid)==0
+        && setuid(nobody_uid)==0
+        && setenv(gpiomem_child_variable, "1", 1)==0
+         )
+        {
+          execl( "/proc/self/exe", "/proc/self/exe", gpiomem_test_name
+               , static_cast<char *>(nullptr)
+               );
+        }
+      _exit(127);
+    }
+  int status{0};
+  REQUIRE(waitpid(child, &status, 0)==child);
+  REQUIRE(WIFEXITED(status));
+  CHECK(WEXITSTATUS(status)==0);
+}
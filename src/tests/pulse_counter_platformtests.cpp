@@ -0,0 +1,92 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pulse_counter_platformtests.cpp
+/// @brief System tests for the DMA sampled pulse counter type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "pulse_counter.h"
+#include "pwm_pin.h"
+#include "periexcept.h"
+#include <thread>
+
+using namespace dibase::rpi::peripherals;
+
+// Change if P1 GPIO_GEN0/GPIO_GEN3 in use on your system...
+static pin_id const count_pin_id_0{17}; // P1 pin GPIO_GEN0
+static pin_id const count_pin_id_1{22}; // P1 pin GPIO_GEN3
+static pin_id const hw_pwm_pin_id{18};  // P1 pin GPIO_GEN1, PWM0
+
+TEST_CASE( "Platform_tests/pulse_counter/000/bad parameters fail"
+         , "Creating a pulse_counter with a bad edge mode, sample rate, window "
+           "or capacity throws"
+         )
+{
+  ipin_group pins{count_pin_id_0, count_pin_id_1};
+  REQUIRE_THROWS_AS((pulse_counter{ pins, pulse_counter::edge_mode(0)
+                                  , kilohertz{100U}, 100U, 16U
+                                  })
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS((pulse_counter{ pins, pulse_counter::rising, hertz{0U}
+                                  , 100U, 16U
+                                  })
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS((pulse_counter{ pins, pulse_counter::rising
+                                  , megahertz{2U}, 100U, 16U
+                                  })
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS((pulse_counter{ pins, pulse_counter::rising
+                                  , kilohertz{100U}, 0U, 16U
+                                  })
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS((pulse_counter{ pins, pulse_counter::rising
+                                  , kilohertz{100U}, 100U, 15U
+                                  })
+                   , std::invalid_argument
+                   );
+}
+
+TEST_CASE( "Platform_tests/pulse_counter/010/PWM in use fails"
+         , "Creating a pulse_counter while PWM is in use throws"
+         )
+{
+  ipin_group pins{count_pin_id_0, count_pin_id_1};
+  pwm_pin hw_pwm{hw_pwm_pin_id};
+  REQUIRE_THROWS_AS((pulse_counter{ pins, pulse_counter::rising
+                                  , kilohertz{100U}, 100U, 16U
+                                  })
+                   , peripheral_in_use
+                   );
+}
+
+TEST_CASE( "Platform_tests/pulse_counter/020/windows counted"
+         , "A pulse_counter on pulled pins with no edges produces consecutive "
+           "windows of zero counts at the achieved sample rate"
+         )
+{
+  ipin_group pins{{count_pin_id_0, count_pin_id_1}, ipin::pull_down};
+  pulse_counter counter{ pins, pulse_counter::both, kilohertz{100U}
+                       , 1000U, 64U
+                       };
+  CHECK(counter.sample_rate().count()==Approx(100000.0));
+  std::this_thread::sleep_for(std::chrono::milliseconds{200});
+  pulse_count_window windows[64];
+  std::size_t const count{counter.pop(windows, 64U)};
+  CHECK(count>=10U);
+  for (std::size_t idx=0; idx!=count; ++idx)
+    {
+      CHECK(windows[idx].counts[0]==0U);
+      CHECK(windows[idx].counts[1]==0U);
+      if (idx!=0U)
+        {
+          CHECK(windows[idx].first_sample==windows[idx-1].first_sample+1000U);
+        }
+    }
+  CHECK(counter.overruns()==0U);
+  CHECK(counter.lost_windows()==0U);
+}
@@ -0,0 +1,51 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_dither_unittests.cpp
+/// @brief Unit tests for PWM dither pattern generation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "pwm_dither_pattern.h"
+#include <cstdint>
+#include <vector>
+
+using namespace dibase::rpi::peripherals::internal;
+
+TEST_CASE( "Unit-tests/pwm_dither_pattern/0000/mean is level"
+         , "Pattern words are the whole part of the level or one more and "
+           "sum to the level"
+         )
+{
+  unsigned const bits{4U};
+  std::vector<std::uint32_t> words(1U<<bits);
+  for (std::uint64_t level : {0ULL, 1ULL, 7ULL, 8ULL, 15ULL, 16ULL, 1603ULL})
+    {
+      fill_pwm_dither_pattern(words.data(), bits, level);
+      std::uint64_t sum{0U};
+      for (std::uint32_t w : words)
+        {
+          CHECK((w==(level>>bits) || w==(level>>bits)+1U));
+          sum += w;
+        }
+      CHECK(sum==level);
+    }
+}
+
+TEST_CASE( "Unit-tests/pwm_dither_pattern/0010/spread evenly"
+         , "Words one more than the whole part are spread over the cycle"
+         )
+{
+  std::uint32_t words[8];
+  fill_pwm_dither_pattern(words, 3U, (100U<<3)+4U); // 100.5
+  for (unsigned i{0U}; i!=8U; i+=2U)
+    {
+      CHECK(words[i]+words[i+1U]==201U);
+    }
+  fill_pwm_dither_pattern(words, 3U, (100U<<3)+2U); // 100.25
+  for (unsigned i{0U}; i!=8U; i+=4U)
+    {
+      CHECK(words[i]+words[i+1U]+words[i+2U]+words[i+3U]==401U);
+    }
+}
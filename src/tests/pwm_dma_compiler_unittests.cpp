@@ -0,0 +1,102 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_dma_compiler_unittests.cpp
+/// @brief Unit tests for compiling PWM DMA sample rings into DMA control
+/// blocks.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "pwm_dma_compiler.h"
+#include <cstring>
+#include <cstdint>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef std::uint32_t RegisterType;
+
+namespace
+{
+  RegisterType const region_bus{0xC0100000U};
+  RegisterType const pwm_fifo_bus{0x7E20C018U};
+
+  struct alignas(32) small_region_type
+  {
+    unsigned char bytes[1024];
+  };
+
+  dma_control_block const & cb_at
+  ( dma_region const & region
+  , void * base
+  , RegisterType bus
+  )
+  {
+    return *reinterpret_cast<dma_control_block const *>
+              (static_cast<unsigned char *>(base)+(bus-region.bus_address(base)));
+  }
+}
+
+TEST_CASE( "Unit-tests/pwm_dma_compiler/0000/bad half sizes fail"
+         , "Compiling a ring with no samples or into too small a region throws"
+         )
+{
+  small_region_type memory;
+  dma_region region{&memory, region_bus, sizeof(memory)};
+  REQUIRE_THROWS_AS( compile_pwm_dma_ring(region, 0U, pwm_fifo_bus)
+                   , std::invalid_argument
+                   );
+  dma_region small_region{&memory, region_bus, pwm_dma_ring_size(8U)-4U};
+  REQUIRE_THROWS_AS( compile_pwm_dma_ring(small_region, 8U, pwm_fifo_bus)
+                   , std::bad_alloc
+                   );
+}
+
+TEST_CASE( "Unit-tests/pwm_dma_compiler/0010/compile ring"
+         , "Ring plays half 0, sets its done flag, plays half 1, sets its "
+           "done flag and loops back to the start"
+         )
+{
+  small_region_type memory;
+  std::memset(&memory, 0xFF, sizeof(memory));
+  std::size_t const size{pwm_dma_ring_size(8U)};
+// 4 CBs of 32 bytes + 32 bytes of flags + 2 * 8 sample words
+  REQUIRE(size==4U*32U+32U+16U*4U);
+  dma_region region{&memory, region_bus, size};
+  pwm_dma_ring const ring{compile_pwm_dma_ring(region, 8U, pwm_fifo_bus)};
+  CHECK(region.available()==0U);
+  CHECK(ring.first_bus==region_bus);
+  CHECK(ring.done[0]==0U);
+  CHECK(ring.done[1]==0U);
+  CHECK(ring.halves[1]==ring.halves[0]+8);
+  for (unsigned idx=0; idx!=16U; ++idx)
+    {
+      CHECK(ring.halves[0][idx]==0U);
+    }
+
+  dma_control_block const * cb{&cb_at(region, &memory, ring.first_bus)};
+  for (unsigned half=0; half!=2U; ++half)
+    {
+      CHECK(cb->source_address==region.bus_address(ring.halves[half]));
+      CHECK(cb->dest_address==pwm_fifo_bus);
+      CHECK(cb->transfer_length==32U);
+      CHECK((cb->transfer_info&dma_control_block::ti_dest_dreq)!=0U);
+      CHECK((cb->transfer_info&dma_control_block::ti_src_inc)!=0U);
+      CHECK((cb->transfer_info&dma_control_block::ti_dest_inc)==0U);
+      CHECK(((cb->transfer_info>>dma_control_block::ti_permap_shift)&0x1FU)
+                                                                        ==5U);
+      cb = &cb_at(region, &memory, cb->next_control_block);
+      CHECK(cb->dest_address==ring.first_bus+128U+4U*half);
+      CHECK(cb->transfer_length==4U);
+      CHECK((cb->transfer_info&dma_control_block::ti_dest_dreq)==0U);
+      RegisterType value;
+      std::memcpy( &value
+                 , reinterpret_cast<unsigned char *>(&memory)
+                   +(cb->source_address-region_bus)
+                 , sizeof(value)
+                 );
+      CHECK(value==1U);
+      cb = &cb_at(region, &memory, cb->next_control_block);
+    }
+  CHECK(cb==&cb_at(region, &memory, ring.first_bus));
+}
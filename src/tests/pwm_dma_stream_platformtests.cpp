@@ -0,0 +1,77 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_dma_stream_platformtests.cpp
+/// @brief Platform tests for pwm_dma_stream.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "pwm_dma_stream.h"
+#include "pwm_ctrl.h"
+#include "periexcept.h"
+#include <chrono>
+#include <thread>
+
+using namespace dibase::rpi::peripherals;
+using namespace dibase::rpi::peripherals::internal;
+
+TEST_CASE( "Platform-tests/pwm_dma_stream/0000/create & destroy"
+         , "Creating a pwm_dma_stream reserves the PWM FIFO and sets the "
+           "channel to FIFO use; destroying it releases them"
+         )
+{
+  pwm_pin p{pin_id{18}}; // GPIO18, PWM0, ALT5
+  {
+    pwm_dma_stream s{p, pwm_stream_mode::pwm, 256U};
+    CHECK(s.half_size()==256U);
+    CHECK(pwm_ctrl::instance().fifo_alloc.is_in_use(0));
+    CHECK(pwm_ctrl::instance().regs->get_use_fifo(pwm_channel::pwm_ch1));
+    CHECK_FALSE(s.is_running());
+    CHECK(s.half(1U)==s.half(0U)+256);
+    CHECK_THROWS_AS(s.half(2U), std::out_of_range);
+    CHECK(s.poll_idle_half()==nullptr);
+    CHECK_THROWS_AS(s.wait_idle_half(), std::logic_error);
+    CHECK_THROWS_AS( pwm_stream(p, pwm_stream_mode::pwm, 64U)
+                   , bad_peripheral_alloc
+                   );
+  }
+  CHECK_FALSE(pwm_ctrl::instance().fifo_alloc.is_in_use(0));
+  CHECK_FALSE(pwm_ctrl::instance().regs->get_use_fifo(pwm_channel::pwm_ch1));
+  CHECK_THROWS_AS( pwm_dma_stream(p, pwm_stream_mode::pwm, 0U)
+                 , std::invalid_argument
+                 );
+}
+
+TEST_CASE( "Platform-tests/pwm_dma_stream/0010/continuous output"
+         , "Refilling each idle half in time plays continuously with no "
+           "underruns; not refilling in time counts underruns"
+         )
+{
+  pwm_pin p{pin_id{18}, 100U}; // GPIO18, PWM0, ALT5
+  std::size_t const half_size{1000U};
+  pwm_dma_stream s{p, pwm_stream_mode::pwm, half_size};
+  for (unsigned half=0; half!=2U; ++half)
+    {
+      for (std::size_t idx=0; idx!=half_size; ++idx)
+        {
+          s.half(half)[idx] = idx%100U;
+        }
+    }
+  s.start();
+  CHECK(s.is_running());
+  for (unsigned refill=0; refill!=20U; ++refill)
+    {
+      std::uint32_t * idle{s.wait_idle_half()};
+      for (std::size_t idx=0; idx!=half_size; ++idx)
+        {
+          idle[idx] = (idx+refill)%100U;
+        }
+    }
+  CHECK(s.underruns()==0U);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  CHECK(s.poll_idle_half()!=nullptr);
+  CHECK(s.underruns()>=1U);
+  s.stop();
+  CHECK_FALSE(s.is_running());
+}
@@ -8,9 +8,12 @@
 #include "catch.hpp"
 
 #include "pwm_pin.h"
+#include "pwm_pair.h"
+#include "start_group.h"
 #include "pwm_ctrl.h"
 #include "pin.h"
 #include "periexcept.h"
+#include <utility>
 
 using namespace dibase::rpi::peripherals;
 using namespace dibase::rpi::peripherals::internal;
@@ -86,6 +89,22 @@ TEST_CASE( "Platform-tests/pwm_pin/0060/create bad: PWM channel in use"
   ipin(pin_id(12)); // pin should not be in use
 }
 
+TEST_CASE( "Platform-tests/pwm_pin/0070/move transfers channel and pin"
+         , "A moved pwm_pin keeps the channel and pin in use until the moved "
+           "to object is destroyed"
+         )
+{
+  {
+    pwm_pin p{pin_id{18}};
+    pwm_pin q{std::move(p)};
+    q.start();
+    CHECK(q.is_running());
+    CHECK(pwm_ctrl::instance().alloc.is_in_use(0));
+  }
+  CHECK_FALSE(pwm_ctrl::instance().alloc.is_in_use(0)); // PWM0 should be free
+  ipin(pin_id(18)); // pin should not be in use
+}
+
 TEST_CASE( "Platform-tests/pwm_pin/0100/newly created reported not running"
          , "A newly created pwm_pin object returns false from is_running"
          )
@@ -238,6 +257,92 @@ TEST_CASE( "Platform-tests/pwm_pin/0350/Ratios greater than unity fail (pwm_rati
 }
 
 
+TEST_CASE( "Platform-tests/pwm_pin/0400/set_data_counts"
+         , "Setting data counts writes them to data register; counts greater "
+           "than range fail"
+         )
+{
+  pwm_pin p{pin_id{18}, 1000U}; // GPIO18, PWM0, ALT5
+  CHECK(p.get_range()==1000U);
+  p.set_data_counts(1000U);
+  CHECK(pwm_ctrl::instance().regs->data1==1000U);
+  p.set_data_counts(123U);
+  CHECK(pwm_ctrl::instance().regs->data1==123U);
+  REQUIRE_THROWS_AS(p.set_data_counts(1001U), std::out_of_range);
+  CHECK(pwm_ctrl::instance().regs->data1==123U);
+}
+
+TEST_CASE( "Platform-tests/pwm_pin/0410/pwm_pair"
+         , "A pwm_pair starts, stops and updates both channels together"
+         )
+{
+  pwm_pin p0{pin_id{18}, 1000U}; // GPIO18, PWM0, ALT5
+  pwm_pin p1{pin_id{19}, 500U};  // GPIO19, PWM1, ALT5
+  REQUIRE_THROWS_AS(pwm_pair(p0, p0), std::invalid_argument);
+  pwm_pair pair{p1, p0};
+  pair.start();
+  CHECK(p0.is_running());
+  CHECK(p1.is_running());
+  pair.set_data_counts(250U, 750U);
+  CHECK(pwm_ctrl::instance().regs->data1==750U);
+  CHECK(pwm_ctrl::instance().regs->data2==250U);
+  REQUIRE_THROWS_AS(pair.set_data_counts(501U, 0U), std::out_of_range);
+  REQUIRE_THROWS_AS(pair.set_data_counts(0U, 1001U), std::out_of_range);
+  CHECK(pwm_ctrl::instance().regs->data1==750U);
+  CHECK(pwm_ctrl::instance().regs->data2==250U);
+  pair.stop();
+  CHECK_FALSE(p0.is_running());
+  CHECK_FALSE(p1.is_running());
+}
+
+TEST_CASE( "Platform-tests/pwm_pin/0420/start_group"
+         , "A start_group starts and stops PWM channels and a clock together "
+           "and records the start skew"
+         )
+{
+  pwm_pin p0{pin_id{18}}; // GPIO18, PWM0, ALT5
+  pwm_pin p1{pin_id{19}}; // GPIO19, PWM1, ALT5
+  clock_pin clk { pin_id{4}  // GPCLK0
+                , fixed_oscillator_clock_source{f_megahertz{19.2}}
+                , clock_frequency{kilohertz{600}, clock_filter::none}
+                };
+  start_group group;
+  group.add(p0);
+  group.add(p1);
+  group.add(clk);
+  REQUIRE_THROWS_AS(group.add(p1), std::invalid_argument);
+  REQUIRE_THROWS_AS(group.add(clk), std::invalid_argument);
+  latency_histogram skews;
+  group.record_skews(&skews);
+  std::chrono::nanoseconds const skew{group.start()};
+  CHECK(p0.is_running());
+  CHECK(p1.is_running());
+  CHECK(clk.is_running());
+  CHECK(skews.count()==1U);
+  CHECK(skews.max()==skew);
+  group.stop();
+  CHECK_FALSE(p0.is_running());
+  CHECK_FALSE(p1.is_running());
+  CHECK_FALSE(clk.is_running());
+}
+
+TEST_CASE( "Platform-tests/pwm_pin/0430/output mode and polarity"
+         , "Output mode selects M/S or balanced output and polarity may be "
+           "inverted"
+         )
+{
+  pwm_pin p{pin_id{18}, 1000U, pwm_output_mode::mark_space};
+  CHECK(p.output_mode()==pwm_output_mode::mark_space);
+  CHECK(pwm_ctrl::instance().regs->get_ms_enabled(pwm_channel::gpio_pwm0));
+  p.set_output_mode(pwm_output_mode::balanced);
+  CHECK(p.output_mode()==pwm_output_mode::balanced);
+  CHECK_FALSE(p.is_polarity_inverted());
+  p.set_polarity_inverted(true);
+  CHECK(p.is_polarity_inverted());
+  p.set_polarity_inverted(false);
+  CHECK_FALSE(p.is_polarity_inverted());
+}
+
 TEST_CASE( "Platform-tests/pwm_pin/1000/static default frequencies 100MHz"
          , "Check the default values for the PWM clock are all 100MHz"
          )
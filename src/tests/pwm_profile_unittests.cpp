@@ -0,0 +1,85 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_profile_unittests.cpp
+/// @brief Unit tests for precomputed PWM duty sequences.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "pwm_profile.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/pwm_profile/0000/bad parameters"
+         , "Too small a range or ratios outside [0,1] throw"
+         )
+{
+  CHECK_THROWS_AS(pwm_profile{1U}, std::invalid_argument);
+  pwm_profile p{100U};
+  CHECK_THROWS_AS(p.ramp(-0.1, 0.5, 10U), std::out_of_range);
+  CHECK_THROWS_AS(p.ramp(0.0, 1.1, 10U), std::out_of_range);
+  CHECK_THROWS_AS(p.hold(1.5, 10U), std::out_of_range);
+  CHECK_THROWS_AS(pwm_profile(100U, 2.0, 10U, 10U), std::out_of_range);
+  CHECK(p.size()==0U);
+}
+
+TEST_CASE( "Unit-tests/pwm_profile/0010/trapezoidal ramp and hold"
+         , "A linear ramp steps evenly from one step past from to to"
+         )
+{
+  pwm_profile p{100U};
+  p.ramp(0.0, 0.5, 5U, pwm_profile_shape::trapezoidal).hold(0.5, 2U)
+   .ramp(0.5, 0.0, 5U, pwm_profile_shape::trapezoidal);
+  std::vector<std::uint32_t> const expected
+    {10U, 20U, 30U, 40U, 50U, 50U, 50U, 40U, 30U, 20U, 10U, 0U};
+  CHECK(p.range()==100U);
+  CHECK(p.counts()==expected);
+}
+
+TEST_CASE( "Unit-tests/pwm_profile/0020/s-curve ramp"
+         , "An S-curve ramp starts and ends slowly, is fastest in the middle "
+           "and is symmetric"
+         )
+{
+  pwm_profile p{1000U, 1.0, 10U, 0U};
+  auto const & c(p.counts());
+  REQUIRE(c.size()==20U);
+  CHECK(c[9]==1000U);
+  CHECK(c[19]==0U);
+  CHECK(c[0]<c[1]);
+  CHECK((c[1]-c[0])<(c[5]-c[4]));
+  CHECK((c[9]-c[8])<(c[5]-c[4]));
+  CHECK(c[4]==500U);
+  for (std::size_t n=0U; n!=9U; ++n)
+    {
+      CHECK(c[n]==c[18U-n]);
+    }
+}
+
+TEST_CASE( "Unit-tests/pwm_profile/0030/expand"
+         , "Each step is repeated cycles_per_step times then the last step "
+           "pads the buffer"
+         )
+{
+  pwm_profile p{100U};
+  p.hold(0.1, 1U).hold(0.2, 1U).hold(0.3, 1U);
+  std::uint32_t words[5]{};
+  std::size_t position{0U};
+  CHECK_THROWS_AS(p.expand(words, 5U, position, 0U), std::invalid_argument);
+  CHECK(p.expand(words, 5U, position, 2U)==5U);
+  CHECK(position==5U);
+  std::uint32_t const first[]{10U, 10U, 20U, 20U, 30U};
+  CHECK(std::equal(words, words+5, first));
+  CHECK(p.expand(words, 5U, position, 2U)==1U);
+  CHECK(position==6U);
+  std::uint32_t const second[]{30U, 30U, 30U, 30U, 30U};
+  CHECK(std::equal(words, words+5, second));
+  CHECK(p.expand(words, 5U, position, 2U)==0U);
+  CHECK(position==6U);
+  CHECK_THROWS_AS( pwm_profile{100U}.expand(words, 5U, position, 2U)
+                 , std::invalid_argument
+                 );
+}
@@ -212,6 +212,21 @@ TEST_CASE( "Unit-tests/pwm_registers/0080/set_enable"
   CHECK(pwm_regs.control==0U);
 }
 
+TEST_CASE( "Unit-tests/pwm_registers/0085/set_enable_both"
+         , "set_enable_both sets both channels' states in control register"
+         )
+{
+  pwm_registers pwm_regs;
+  std::memset(&pwm_regs, 0x00U, sizeof(pwm_regs));
+  pwm_regs.set_enable_both(true);
+  CHECK(pwm_regs.control==0x101U);
+  CHECK(pwm_regs.get_enable(pwm_channel::pwm_ch1));
+  CHECK(pwm_regs.get_enable(pwm_channel::pwm_ch2));
+  pwm_regs.control = ~0U;
+  pwm_regs.set_enable_both(false);
+  CHECK(pwm_regs.control==0xfffffefeU);
+}
+
 TEST_CASE( "Unit-tests/pwm_registers/0090/set_mode"
          , "set_mode sets correct bits in control register"
          )
@@ -0,0 +1,71 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file pwm_stream_platformtests.cpp
+/// @brief Platform tests for pwm_stream.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "pwm_stream.h"
+#include "pwm_ctrl.h"
+#include "periexcept.h"
+#include <chrono>
+#include <thread>
+
+using namespace dibase::rpi::peripherals;
+using namespace dibase::rpi::peripherals::internal;
+
+TEST_CASE( "Platform-tests/pwm_stream/0000/create & destroy"
+         , "Creating a pwm_stream sets the channel to FIFO use in the "
+           "requested mode, only one stream may exist and destroying it "
+           "returns the channel to PWM mode"
+         )
+{
+  pwm_pin p0{pin_id{18}}; // GPIO18, PWM0, ALT5
+  pwm_pin p1{pin_id{19}}; // GPIO19, PWM1, ALT5
+  {
+    pwm_stream s{p0, pwm_stream_mode::serialiser, 64U};
+    CHECK(s.capacity()==64U);
+    CHECK(pwm_ctrl::instance().fifo_alloc.is_in_use(0));
+    CHECK(pwm_ctrl::instance().regs->get_use_fifo(pwm_channel::pwm_ch1));
+    CHECK(pwm_ctrl::instance().regs->get_mode(pwm_channel::pwm_ch1)
+                                                      ==pwm_mode::serialiser);
+    CHECK_FALSE(p0.is_running());
+    CHECK_THROWS_AS( pwm_stream(p1, pwm_stream_mode::pwm, 64U)
+                   , bad_peripheral_alloc
+                   );
+  }
+  CHECK_FALSE(pwm_ctrl::instance().fifo_alloc.is_in_use(0));
+  CHECK_FALSE(pwm_ctrl::instance().regs->get_use_fifo(pwm_channel::pwm_ch1));
+  CHECK(pwm_ctrl::instance().regs->get_mode(pwm_channel::pwm_ch1)
+                                                      ==pwm_mode::pwm);
+  CHECK_THROWS_AS( pwm_stream(p1, pwm_stream_mode::pwm, 60U)
+                 , std::invalid_argument
+                 );
+  CHECK_FALSE(pwm_ctrl::instance().fifo_alloc.is_in_use(0));
+  pwm_stream s{p1, pwm_stream_mode::pwm, 64U};
+  CHECK(pwm_ctrl::instance().regs->get_use_fifo(pwm_channel::pwm_ch2));
+  CHECK(pwm_ctrl::instance().regs->get_mode(pwm_channel::pwm_ch2)
+                                                      ==pwm_mode::pwm);
+}
+
+TEST_CASE( "Platform-tests/pwm_stream/0010/stream words"
+         , "Words written to a running pwm_stream are output and the FIFO "
+           "running empty afterwards is counted as an underrun"
+         )
+{
+  pwm_pin p{pin_id{18}, 32U}; // GPIO18, PWM0, ALT5
+  pwm_stream s{p, pwm_stream_mode::serialiser, 256U};
+  std::uint32_t words[256];
+  for (std::uint32_t idx=0; idx!=256U; ++idx)
+    {
+      words[idx] = idx*0x01010101U;
+    }
+  CHECK(s.write(words, 256U)==256U);
+  p.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  CHECK(s.pending()==0U);
+  CHECK(s.underruns()>=1U);
+  p.stop();
+}
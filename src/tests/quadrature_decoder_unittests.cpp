@@ -0,0 +1,126 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file quadrature_decoder_unittests.cpp
+/// @brief Unit tests for decoding quadrature encoders.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "quadrature_decoder.h"
+#include <stdexcept>
+
+using namespace dibase::rpi::peripherals;
+
+typedef std::uint32_t RegisterType;
+
+namespace
+{
+  edge_event_record make_event(unsigned pin, pin_edge_event::edge_mode edge)
+  {
+    edge_event_record event;
+    event.pin = pin_id(pin);
+    event.edge = edge;
+    return event;
+  }
+}
+
+TEST_CASE( "Unit-tests/quadrature_decoder/0000/construct bad channels"
+         , "Constructing a quadrature_decoder with no encoders or a pin used "
+           "more than once throws std::invalid_argument"
+         )
+{
+  REQUIRE_THROWS_AS( quadrature_decoder{std::vector<quadrature_channels>{}}
+                   , std::invalid_argument
+                   );
+  std::vector<quadrature_channels> const same_pin{{pin_id(4), pin_id(4)}};
+  REQUIRE_THROWS_AS( quadrature_decoder{same_pin}, std::invalid_argument );
+  std::vector<quadrature_channels> const shared_pin
+                                          { {pin_id(4), pin_id(5)}
+                                          , {pin_id(6), pin_id(4)}
+                                          };
+  REQUIRE_THROWS_AS( quadrature_decoder{shared_pin}, std::invalid_argument );
+}
+
+TEST_CASE( "Unit-tests/quadrature_decoder/0010/decode snapshots"
+         , "Each encoder counts up when A leads B, down when B leads A and "
+           "counts illegal transitions without stepping"
+         )
+{
+// Encoder 0 on pins 4 (A), 5 (B); encoder 1 on pins 33 (A), 2 (B)
+  quadrature_decoder decoder{ { {pin_id(4), pin_id(5)}
+                              , {pin_id(33), pin_id(2)}
+                              }
+                            };
+  REQUIRE(decoder.size()==2U);
+// Encoder 0 forward a full cycle, encoder 1 backward a full cycle
+  RegisterType const samples[][2]
+                        { {0x00000000U, 0x00000000U}  // 00, 00
+                        , {0x00000014U, 0x00000000U}  // 10, 01
+                        , {0x00000034U, 0x00000002U}  // 11, 11
+                        , {0x00000020U, 0x00000002U}  // 01, 10
+                        , {0x00000000U, 0x00000000U}  // 00, 00
+                        };
+  decoder.start(samples[0]);
+  for (auto const & sample : samples)
+    {
+      decoder.add(sample);
+    }
+  CHECK(decoder.position(0U)==4);
+  CHECK(decoder.position(1U)==-4);
+  CHECK(decoder.illegal_transitions(0U)==0U);
+  CHECK(decoder.illegal_transitions(1U)==0U);
+// Encoder 0 jumps 00 -> 11 : illegal; encoder 1 unchanged
+  RegisterType const jump[2]{0x00000030U, 0x00000000U};
+  decoder.add(jump);
+  CHECK(decoder.position(0U)==4);
+  CHECK(decoder.illegal_transitions(0U)==1U);
+  CHECK(decoder.illegal_transitions(1U)==0U);
+}
+
+TEST_CASE( "Unit-tests/quadrature_decoder/0020/decode edge events"
+         , "Edge events set their channel's level and step the encoder; "
+           "events on other pins are ignored"
+         )
+{
+  quadrature_decoder decoder{{{pin_id(17), pin_id(18)}}};
+  edge_event_record const events[]
+                        { make_event(17U, pin_edge_event::rising)
+                        , make_event(22U, pin_edge_event::rising)
+                        , make_event(18U, pin_edge_event::rising)
+                        , make_event(17U, pin_edge_event::falling)
+                        , make_event(18U, pin_edge_event::falling)
+                        , make_event(18U, pin_edge_event::rising)
+                        };
+  decoder.add(events, 5U);
+  CHECK(decoder.position(0U)==4);
+  decoder.add(events+5, 1U);
+  CHECK(decoder.position(0U)==3);
+  CHECK(decoder.illegal_transitions(0U)==0U);
+}
+
+TEST_CASE( "Unit-tests/quadrature_decoder/0030/latch velocities"
+         , "latch_velocities sets each encoder's velocity to its steps since "
+           "the previous latch"
+         )
+{
+  quadrature_decoder decoder{{{pin_id(0), pin_id(1)}}};
+  RegisterType const states[][2]
+                        { {0x00000000U, 0U}
+                        , {0x00000001U, 0U}
+                        , {0x00000003U, 0U}
+                        , {0x00000002U, 0U}
+                        };
+  CHECK(decoder.velocity(0U)==0);
+  decoder.add(states[1]);
+  decoder.add(states[2]);
+  decoder.add(states[3]);
+  decoder.latch_velocities();
+  CHECK(decoder.velocity(0U)==3);
+  decoder.add(states[2]);
+  decoder.latch_velocities();
+  CHECK(decoder.velocity(0U)==-1);
+  decoder.latch_velocities();
+  CHECK(decoder.velocity(0U)==0);
+  CHECK(decoder.position(0U)==2);
+}
@@ -0,0 +1,94 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file register_lock_unittests.cpp
+/// @brief Unit tests for serialising register word read-modify-writes.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "register_lock.h"
+#include "gpio_registers.h"
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+using namespace dibase::rpi::peripherals::internal;
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/register_lock/0000/adjacent words use different locks"
+         , "Consecutive register words map to consecutive lock stripes"
+         )
+{
+  std::uint32_t words[register_lock_stripes];
+  for (std::size_t idx=1U; idx!=register_lock_stripes; ++idx)
+    {
+      CHECK( register_lock_stripe(&words[idx])
+          == (register_lock_stripe(&words[idx-1U])+1U)%register_lock_stripes
+           );
+    }
+}
+
+TEST_CASE( "Unit-tests/register_lock/0010/lock released on destruction"
+         , "A word may be locked again once a previous lock is destroyed"
+         )
+{
+  std::uint32_t word{0U};
+  {
+    register_word_lock lock{&word};
+  }
+  register_word_lock lock{&word}; // would never return if still locked
+  SUCCEED("Word locked again");
+}
+
+TEST_CASE( "Unit-tests/register_lock/0100/concurrent set_pin_function"
+         , "Threads setting functions of different pins in the same GPFSEL "
+           "word do not lose each other's updates"
+         )
+{
+  gpio_registers regs;
+  std::memset(&regs, 0, sizeof(regs));
+  unsigned const iterations{20000U};
+  auto toggle = [&regs](pin_id pin, gpio_pin_fn fn)
+                {
+                  for (unsigned i=0U; i!=iterations; ++i)
+                    {
+                      regs.set_pin_function(pin, gpio_pin_fn::input);
+                      regs.set_pin_function(pin, fn);
+                    }
+                };
+  std::thread t0{toggle, pin_id(10), gpio_pin_fn::output};
+  std::thread t1{toggle, pin_id(11), gpio_pin_fn::alt0};
+  toggle(pin_id(12), gpio_pin_fn::alt5);
+  t0.join();
+  t1.join();
+  CHECK(regs.gpfsel[1]==( (static_cast<std::uint32_t>(gpio_pin_fn::output)<<0)
+                        | (static_cast<std::uint32_t>(gpio_pin_fn::alt0)<<3)
+                        | (static_cast<std::uint32_t>(gpio_pin_fn::alt5)<<6)
+                        )
+       );
+}
+
+TEST_CASE( "Unit-tests/register_lock/0110/concurrent set_bit and clear_bit"
+         , "Threads setting and clearing different bits of the same word do "
+           "not lose each other's updates"
+         )
+{
+  one_bit_field_register r;
+  r.clear_all_bits();
+  unsigned const iterations{20000U};
+  auto toggle = [&r](unsigned bit)
+                {
+                  for (unsigned i=0U; i!=iterations; ++i)
+                    {
+                      r.clear_bit(bit);
+                      r.set_bit(bit);
+                    }
+                };
+  std::thread t0{toggle, 3U};
+  std::thread t1{toggle, 17U};
+  toggle(30U);
+  t0.join();
+  t1.join();
+  CHECK(r[0]==((1U<<3)|(1U<<17)|(1U<<30)));
+}
@@ -0,0 +1,269 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file remote_command_unittests.cpp
+/// @brief Unit tests for remote command frames and the remote_server and
+/// remote_client types with no targets registered.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "remote_command.h"
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/remote_batch/0000/frame layout"
+         , "Commands are encoded little endian after the frame header"
+         )
+{
+  remote_batch batch;
+  CHECK(batch.size()==0U);
+  CHECK(batch.bytes().size()==remote_frame::header_size);
+  batch.group_put(2U, 0x0FU, 0x05U).delay(std::chrono::microseconds{300});
+  CHECK(batch.size()==2U);
+  std::vector<std::uint8_t> const & f(batch.bytes());
+  REQUIRE(f.size()==remote_frame::header_size
+                    +2U*remote_frame::command_header_size+16U);
+  CHECK(f[0]=='D');
+  CHECK(f[3]=='C');
+  CHECK(f[4]==1U);
+  CHECK(f[6]==2U);
+  CHECK(f[8]==f.size()-remote_frame::header_size);
+  std::uint8_t const * put{&f[remote_frame::header_size]};
+  CHECK(put[0]==static_cast<std::uint8_t>(remote_op::group_put));
+  CHECK(put[1]==2U);
+  CHECK(put[2]==16U);
+  CHECK(put[12]==0x0FU);
+  CHECK(put[20]==0x05U);
+  std::uint8_t const * delay{put+remote_frame::command_header_size+16U};
+  CHECK(delay[0]==static_cast<std::uint8_t>(remote_op::delay));
+  CHECK(delay[8]==(300U&0xFFU));
+  CHECK(delay[9]==(300U>>8));
+  batch.clear();
+  CHECK(batch.size()==0U);
+  CHECK(batch.bytes().size()==remote_frame::header_size);
+}
+
+TEST_CASE( "Unit-tests/remote_batch/0010/limits"
+         , "Commands that do not fit in a frame are not added"
+         )
+{
+  remote_batch batch;
+  REQUIRE_THROWS_AS(batch.spi0_transfer(0U, nullptr, 0U)
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS(batch.i2c_read(256U, 0x20U, 1U), std::length_error);
+  REQUIRE_THROWS_AS(batch.i2c_read(0U, 0x20U, 0x10000U), std::length_error);
+  CHECK(batch.size()==0U);
+  for (std::size_t i{0U}; i!=remote_frame::max_commands; ++i)
+    {
+      batch.group_get(0U);
+    }
+  REQUIRE_THROWS_AS(batch.group_get(0U), std::length_error);
+  CHECK(batch.size()==remote_frame::max_commands);
+}
+
+TEST_CASE( "Unit-tests/remote_batch/0020/response and delay limits"
+         , "Commands whose results might overflow a response frame and "
+           "over long delays are not added"
+         )
+{
+  remote_batch batch;
+  REQUIRE_THROWS_AS( batch.delay(std::chrono::microseconds
+                                        {remote_frame::max_delay_us+1U})
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS( batch.delay(std::chrono::microseconds{-1})
+                   , std::invalid_argument
+                   );
+  batch.delay(std::chrono::microseconds{remote_frame::max_delay_us});
+  std::size_t const big_read{0xFFFFU-remote_frame::result_header_size*2U};
+  batch.i2c_read(0U, 0x20U, big_read);
+  std::uint8_t const reg{0U};
+  REQUIRE_THROWS_AS( batch.i2c_write_then_read(0U, 0x20U, &reg, 1U, 1U)
+                   , std::length_error
+                   );
+  REQUIRE_THROWS_AS(batch.i2c_read(0U, 0x20U, 1U), std::length_error);
+  CHECK(batch.size()==2U);
+  batch.clear();
+  batch.i2c_read(0U, 0x20U, big_read);
+}
+
+TEST_CASE( "Unit-tests/perform_remote_batch/0000/no targets"
+         , "Commands with no registered target are rejected and delays done"
+         )
+{
+  remote_targets targets;
+  std::uint8_t const tx[2]{1U, 2U};
+  remote_batch batch;
+  batch.group_put(0U, 1U, 1U)
+       .group_get(0U)
+       .spi0_transfer(0U, tx, 2U)
+       .i2c_write(0U, 0x20U, tx, 2U)
+       .delay(std::chrono::microseconds{10});
+  std::vector<std::uint8_t> const response
+            {perform_remote_batch( targets, batch.bytes().data()
+                                 , batch.bytes().size()
+                                 )};
+  std::vector<remote_result> const results
+            {decode_remote_response(response.data(), response.size())};
+  REQUIRE(results.size()==5U);
+  for (std::size_t i{0U}; i!=4U; ++i)
+    {
+      CHECK(results[i].outcome==remote_outcome::rejected);
+      CHECK(results[i].data.empty());
+    }
+  CHECK(results[4].outcome==remote_outcome::done);
+  REQUIRE_THROWS_AS(results[4].value(), std::logic_error);
+}
+
+TEST_CASE( "Unit-tests/perform_remote_batch/0010/malformed frames"
+         , "Malformed command and response frames are refused"
+         )
+{
+  remote_targets targets;
+  remote_batch batch;
+  batch.delay(std::chrono::microseconds{1});
+  std::vector<std::uint8_t> f(batch.bytes());
+  f.pop_back();
+  REQUIRE_THROWS_AS(perform_remote_batch(targets, f.data(), f.size())
+                   , std::invalid_argument
+                   );
+  f = batch.bytes();
+  f[0] = 'X';
+  REQUIRE_THROWS_AS(perform_remote_batch(targets, f.data(), f.size())
+                   , std::invalid_argument
+                   );
+  f = batch.bytes();
+  f[6] = 2U; // Claims two commands, has one
+  REQUIRE_THROWS_AS(perform_remote_batch(targets, f.data(), f.size())
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS(decode_remote_response(f.data(), 4U), std::runtime_error);
+}
+
+TEST_CASE( "Unit-tests/perform_remote_batch/0020/oversized results"
+         , "A frame whose results might not fit in a response frame has all "
+           "its commands rejected, and over long delays are rejected"
+         )
+{
+  remote_targets targets;
+  remote_batch batch;
+  batch.delay(std::chrono::microseconds{1})
+       .i2c_read(0U, 0x20U, 100U)
+       .i2c_write_then_read(0U, 0x20U, batch.bytes().data(), 1U, 100U);
+  std::vector<std::uint8_t> f(batch.bytes());
+  std::size_t const read_cmd{ remote_frame::header_size
+                            + remote_frame::command_header_size
+                            };
+  std::size_t const wtr_cmd{read_cmd+remote_frame::command_header_size};
+  f[read_cmd+4] = f[read_cmd+5] = 0xFFU;  // rx_count 65535
+  f[wtr_cmd+4] = f[wtr_cmd+5] = 0xFFU;
+  std::vector<std::uint8_t> response
+            {perform_remote_batch(targets, f.data(), f.size())};
+  std::vector<remote_result> results
+            {decode_remote_response(response.data(), response.size())};
+  REQUIRE(results.size()==3U);
+  for (auto const & r : results)
+    {
+      CHECK(r.outcome==remote_outcome::rejected);
+    }
+  f = batch.bytes();
+  f[remote_frame::header_size+8] = 0x41U; // delay 1000001us: too long
+  f[remote_frame::header_size+9] = 0x42U;
+  f[remote_frame::header_size+10] = 0x0FU;
+  response = perform_remote_batch(targets, f.data(), f.size());
+  results = decode_remote_response(response.data(), response.size());
+  REQUIRE(results.size()==3U);
+  CHECK(results[0].outcome==remote_outcome::rejected);
+}
+
+TEST_CASE( "Unit-tests/remote_server/0000/round trip"
+         , "A client's batch is performed by a server in one round trip"
+         )
+{
+  remote_server server{remote_targets{}, 0U, "127.0.0.1"};
+  REQUIRE(server.port()!=0U);
+  remote_client client{"127.0.0.1", server.port()};
+  remote_batch batch;
+  batch.delay(std::chrono::microseconds{1}).group_get(3U);
+  for (int run{0}; run!=2; ++run)
+    {
+      std::vector<remote_result> const results{client.run(batch)};
+      REQUIRE(results.size()==2U);
+      CHECK(results[0].outcome==remote_outcome::done);
+      CHECK(results[1].outcome==remote_outcome::rejected);
+    }
+  REQUIRE_THROWS_AS( remote_server(remote_targets{}, 0U, "not an address")
+                   , std::invalid_argument
+                   );
+}
+
+TEST_CASE( "Unit-tests/remote_server/0010/stop ends delay"
+         , "Destroying a server ends a delay in progress rather than waiting "
+           "for it"
+         )
+{
+  std::unique_ptr<remote_server> server
+                            {new remote_server{remote_targets{}, 0U}};
+  remote_client client{"127.0.0.1", server->port()};
+  remote_batch batch;
+  for (int i{0}; i!=10; ++i)
+    {
+      batch.delay(std::chrono::microseconds{remote_frame::max_delay_us});
+    }
+  std::thread runner{ [&client, &batch]()
+                      {
+                        try
+                          {
+                            client.run(batch);
+                          }
+                        catch (std::exception &)
+                          {
+                          }
+                      }
+                    };
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  auto const start(std::chrono::steady_clock::now());
+  server.reset();
+  auto const stop_time(std::chrono::steady_clock::now()-start);
+  runner.join();
+  CHECK(stop_time<std::chrono::milliseconds{500});
+}
+
+TEST_CASE( "Unit-tests/remote_server/0020/stop drops stalled client"
+         , "Destroying a server does not wait for a client that has sent "
+           "part of a frame and then stalled"
+         )
+{
+  std::unique_ptr<remote_server> server
+                            {new remote_server{remote_targets{}, 0U}};
+  int const fd{::socket(AF_INET, SOCK_STREAM, 0)};
+  REQUIRE(fd!=-1);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(server->port());
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  REQUIRE(::connect(fd, reinterpret_cast<sockaddr *>(&address)
+                   , sizeof(address)
+                   )==0);
+  remote_batch batch;
+  batch.delay(std::chrono::microseconds{1});
+  std::size_t const half{batch.bytes().size()/2U};
+  CHECK(::send(fd, batch.bytes().data(), half, 0)==ssize_t(half));
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  auto const start(std::chrono::steady_clock::now());
+  server.reset();
+  auto const stop_time(std::chrono::steady_clock::now()-start);
+  ::close(fd);
+  CHECK(stop_time<std::chrono::milliseconds{500});
+}
@@ -79,3 +79,27 @@ TEST_CASE( "Unit_tests/rpi_revision/construct-from-old-scheme-revision-value"
      // ver   model  processor   maker      ram      scheme    turbo   warranty
        );
 }
+
+TEST_CASE( "Unit_tests/rpi_revision/bcm2837-and-bcm2711-processors"
+         , "New scheme values for later processors and larger RAM sizes"
+         )
+{
+  std::size_t 
+    rev{4 + (0x11<<4) + (3<<12) + (0<<16) + (5<<20) + (1<<23)};
+    // ver   model     processor   maker      ram      scheme
+  rpi_revision rpr(rev);
+  CHECK(rpr.processor()==rpi_processor::bcm2711);
+  CHECK(rpr.ram()==rpi_ram::mb8192);
+  CHECK(rpr.ram_MB()==8192);
+  CHECK(rpr.ram_B()==8589934592ULL);
+  CHECK(rpr.version()==4);
+
+  rpi_revision rpr3( rpi_model::b
+                   , rpi_processor::bcm2837
+                   , rpi_ram::mb1024
+                   , rpi_maker::sony
+                   , 2
+                   );
+  CHECK(rpr3.processor()==rpi_processor::bcm2837);
+  CHECK(rpr3.raw_value()==(2 + (1<<4) + (2<<12) + (0<<16) + (2<<20) + (1<<23)));
+}
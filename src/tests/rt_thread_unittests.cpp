@@ -0,0 +1,95 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file rt_thread_unittests.cpp
+/// @brief Unit tests for rt_scope, rt_thread and rt_period types.
+///
+/// Only configuration parts that need no privileges are applied: SCHED_FIFO
+/// priorities and memory locking are left to be tried on a target system.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "rt_thread.h"
+#include <stdexcept>
+#include <pthread.h>
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/rt_scope/0000/bad configuration"
+         , "Constructing an rt_scope with an out of range priority or CPU "
+           "throws std::invalid_argument"
+         )
+{
+  REQUIRE_THROWS_AS(rt_scope{rt_config{100}}, std::invalid_argument);
+  REQUIRE_THROWS_AS(rt_scope{rt_config{-1}}, std::invalid_argument);
+  REQUIRE_THROWS_AS((rt_scope{rt_config{rt_config::no_priority, -2}})
+                   , std::invalid_argument
+                   );
+}
+
+TEST_CASE( "Unit-tests/rt_scope/0010/affinity applied and restored"
+         , "An rt_scope restricts the thread to the CPU and restores the "
+           "previous affinity on destruction"
+         )
+{
+  cpu_set_t before;
+  REQUIRE(pthread_getaffinity_np(pthread_self(), sizeof(before), &before)==0);
+  int cpu{0};
+  while (!CPU_ISSET(cpu, &before))
+    {
+      ++cpu;
+    }
+  {
+    rt_scope scope{rt_config{rt_config::no_priority, cpu, false, 64U*1024U}};
+    cpu_set_t during;
+    REQUIRE(pthread_getaffinity_np(pthread_self(), sizeof(during), &during)==0);
+    CHECK(CPU_COUNT(&during)==1);
+    CHECK(CPU_ISSET(cpu, &during));
+  }
+  cpu_set_t after;
+  REQUIRE(pthread_getaffinity_np(pthread_self(), sizeof(after), &after)==0);
+  CHECK(CPU_EQUAL(&before, &after));
+}
+
+TEST_CASE( "Unit-tests/rt_thread/0000/run and fail"
+         , "An rt_thread runs its function with its configuration applied and "
+           "configuration failures are thrown by the constructor"
+         )
+{
+  bool ran{false};
+  rt_thread t{rt_config{}, [&ran]{ ran = true; }};
+  REQUIRE(t.joinable());
+  t.join();
+  CHECK(ran);
+  bool ran_bad{false};
+  REQUIRE_THROWS_AS((rt_thread{rt_config{100}, [&ran_bad]{ ran_bad = true; }})
+                   , std::invalid_argument
+                   );
+  CHECK_FALSE(ran_bad);
+}
+
+TEST_CASE( "Unit-tests/rt_period/0000/bad period"
+         , "Constructing an rt_period with a period that is not positive "
+           "throws std::invalid_argument"
+         )
+{
+  REQUIRE_THROWS_AS(rt_period{std::chrono::nanoseconds::zero()}
+                   , std::invalid_argument
+                   );
+}
+
+TEST_CASE( "Unit-tests/rt_period/0010/missed deadlines counted"
+         , "Deadlines met are not counted as missed; an overrunning iteration "
+           "misses its deadline and the loop resynchronises"
+         )
+{
+  rt_period p{std::chrono::milliseconds{20}};
+  CHECK(p.wait());
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  CHECK_FALSE(p.wait());
+  CHECK(p.wait());
+  CHECK(p.stats().periods==3U);
+  CHECK(p.stats().missed==1U);
+  CHECK(p.stats().max_lateness>=std::chrono::milliseconds{10});
+}
@@ -8,7 +8,10 @@
 #include "catch.hpp"
 
 #include "simple_allocator.h"
+#include <atomic>
 #include <limits>
+#include <thread>
+#include <vector>
 
 using namespace dibase::rpi::peripherals::internal;
 
@@ -103,3 +106,56 @@ TEST_CASE( "Unit-tests/simple_allocator/0050/de-allocate out of range pin fails"
   CHECK(simple_alloc.deallocate(0));
   CHECK_FALSE(simple_alloc.any_in_use());
 }
+
+TEST_CASE( "Unit-tests/simple_allocator/0060/resources over many words"
+         , "Resources in different bitmap words are allocated independently"
+         )
+{
+  simple_allocator<54> simple_alloc;
+  CHECK(simple_alloc.allocate(53));
+  CHECK(simple_alloc.is_in_use(53));
+  CHECK_FALSE(simple_alloc.is_in_use(21));
+  CHECK(simple_alloc.allocate(21));
+  CHECK_FALSE(simple_alloc.allocate(53));
+  CHECK_FALSE(simple_alloc.allocate(54));
+  CHECK(simple_alloc.deallocate(53));
+  CHECK(simple_alloc.any_in_use());
+  CHECK(simple_alloc.deallocate(21));
+  CHECK_FALSE(simple_alloc.any_in_use());
+}
+
+TEST_CASE( "Unit-tests/simple_allocator/0070/concurrent allocation"
+         , "When several threads allocate the same resources each resource is "
+           "allocated by exactly one thread"
+         )
+{
+  constexpr unsigned number_of_resources{54U};
+  constexpr unsigned number_of_threads{4U};
+  simple_allocator<number_of_resources> simple_alloc;
+  std::atomic<unsigned> allocations{0U};
+  std::vector<std::thread> threads;
+  for (unsigned t=0; t!=number_of_threads; ++t)
+    {
+      threads.emplace_back
+        ( [&]()
+          {
+            for (unsigned res=0; res!=number_of_resources; ++res)
+              {
+                if (simple_alloc.allocate(res))
+                  {
+                    ++allocations;
+                  }
+              }
+          }
+        );
+    }
+  for (auto & thread : threads)
+    {
+      thread.join();
+    }
+  CHECK(allocations==number_of_resources);
+  for (unsigned res=0; res!=number_of_resources; ++res)
+    {
+      CHECK(simple_alloc.is_in_use(res));
+    }
+}
@@ -0,0 +1,79 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file smi_pins_platformtests.cpp
+/// @brief Platform tests for smi_pins and smi_dma.
+///
+/// The tests use GPIO0..GPIO15, which must not be connected to anything
+/// that may be upset by being driven, and need no Linux SMI driver loaded.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "smi_pins.h"
+#include "smi_dma.h"
+#include "periexcept.h"
+
+using namespace dibase::rpi::peripherals;
+
+namespace
+{
+  smi_timing const test_timing{2U, 4U, 2U, 0U};
+}
+
+TEST_CASE( "Platform-tests/smi_pins/0000/create and destroy"
+         , "Creating a smi_pins object allocates SMI which is freed on "
+           "destruction"
+         )
+{
+  {
+    smi_pins smi{smi_width::bits8, 2U, test_timing, test_timing};
+    REQUIRE_THROWS_AS( (smi_pins{ smi_width::bits8, 2U
+                                , test_timing, test_timing
+                                })
+                     , bad_peripheral_alloc
+                     );
+    CHECK(smi.width()==smi_width::bits8);
+    CHECK(smi.address_lines()==2U);
+  }
+  smi_pins smi{smi_width::bits8, 2U, test_timing, test_timing};
+}
+
+TEST_CASE( "Platform-tests/smi_pins/0010/bad parameters fail"
+         , "Out of range address lines or timings throw"
+         )
+{
+  REQUIRE_THROWS_AS( (smi_pins{ smi_width::bits8, 7U
+                              , test_timing, test_timing
+                              })
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS( (smi_pins{ smi_width::bits8, 0U
+                              , smi_timing{0U, 4U, 2U, 0U}, test_timing
+                              })
+                   , std::invalid_argument
+                   );
+  smi_pins smi{smi_width::bits8, 0U, test_timing, test_timing};
+  std::uint32_t words[2]{};
+  CHECK_THROWS_AS(smi.write(0U, words, 6U), std::invalid_argument);
+  CHECK_THROWS_AS(smi.read(64U, words, 8U), std::invalid_argument);
+  CHECK_THROWS_AS(smi.write_direct(64U, 0U), std::invalid_argument);
+}
+
+TEST_CASE( "Platform-tests/smi_pins/0020/writes complete"
+         , "Direct, FIFO and DMA writes complete"
+         )
+{
+  smi_pins smi{smi_width::bits8, 0U, test_timing, test_timing};
+  smi.write_direct(0U, 0x5aU);
+  std::uint32_t const words[4]{0x01020304U, 0x05060708U, 0U, 0xffffffffU};
+  smi.write(0U, words, sizeof(words));
+  smi_dma dma{smi, 4096U};
+  CHECK(dma.max_block_size()==4096U);
+  for (std::size_t n=0U; n!=1024U; ++n)
+    {
+      dma.buffer()[n] = n;
+    }
+  dma.write(0U, 4096U);
+  dma.read(0U, 64U);
+}
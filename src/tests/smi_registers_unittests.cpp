@@ -0,0 +1,108 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file smi_registers_unittests.cpp
+/// @brief Unit tests for low-level SMI control registers type.
+///
+/// The SMI registers are not described in the Broadcom BCM2835 Peripherals
+/// Datasheet. Offsets are those of the Linux bcm2835_smi driver.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "smi_registers.h"
+#include <cstring>
+#include <cstdint>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef uint32_t RegisterType;
+typedef unsigned char Byte;
+
+// Register byte offsets
+enum RegisterOffsets
+{    CS_OFFSET=0x00,      L_OFFSET=0x04,      A_OFFSET=0x08,     D_OFFSET=0x0C
+,  DSR0_OFFSET=0x10,   DSW0_OFFSET=0x14,   DSR3_OFFSET=0x28,  DSW3_OFFSET=0x2C
+,    DC_OFFSET=0x30,    DCS_OFFSET=0x34,     DA_OFFSET=0x38,    DD_OFFSET=0x3C
+,    FD_OFFSET=0x40
+};
+
+TEST_CASE( "Unit-tests/smi_registers/0000/field offsets"
+         , "SMI registers should have the expected offsets"
+         )
+{
+  smi_registers smi_regs;
+  std::memset(&smi_regs, 0xFF, sizeof(smi_regs));
+  Byte * reg_base_addr(reinterpret_cast<Byte *>(&smi_regs));
+
+  smi_regs.control_and_status = CS_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[CS_OFFSET])==CS_OFFSET );
+  smi_regs.length = L_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[L_OFFSET])==L_OFFSET );
+  smi_regs.address = A_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[A_OFFSET])==A_OFFSET );
+  smi_regs.data = D_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[D_OFFSET])==D_OFFSET );
+  smi_regs.device[0].read = DSR0_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[DSR0_OFFSET])
+                                                                ==DSR0_OFFSET );
+  smi_regs.device[0].write = DSW0_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[DSW0_OFFSET])
+                                                                ==DSW0_OFFSET );
+  smi_regs.device[3].read = DSR3_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[DSR3_OFFSET])
+                                                                ==DSR3_OFFSET );
+  smi_regs.device[3].write = DSW3_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[DSW3_OFFSET])
+                                                                ==DSW3_OFFSET );
+  smi_regs.dma_control = DC_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[DC_OFFSET])==DC_OFFSET );
+  smi_regs.direct_control = DCS_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[DCS_OFFSET])
+                                                                 ==DCS_OFFSET );
+  smi_regs.direct_address = DA_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[DA_OFFSET])==DA_OFFSET );
+  smi_regs.direct_data = DD_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[DD_OFFSET])==DD_OFFSET );
+  smi_regs.fifo_debug = FD_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[FD_OFFSET])==FD_OFFSET );
+}
+
+TEST_CASE( "Unit-tests/smi_registers/0010/device_setting"
+         , "Device settings values have setup, strobe, hold, pace and width "
+           "fields, or are 0 if a value is out of range"
+         )
+{
+  CHECK(smi_registers::device_setting(1U, 1U, 0U, 0U, 0U)==0x01000001U);
+  CHECK(smi_registers::device_setting(2U, 5U, 3U, 4U, 1U)==0x42030405U);
+  CHECK(smi_registers::device_setting(63U, 127U, 63U, 127U, 3U)
+                                                              ==0xff3f7f7fU);
+  CHECK(smi_registers::device_setting(0U, 1U, 0U, 0U, 0U)==0U);
+  CHECK(smi_registers::device_setting(64U, 1U, 0U, 0U, 0U)==0U);
+  CHECK(smi_registers::device_setting(1U, 0U, 0U, 0U, 0U)==0U);
+  CHECK(smi_registers::device_setting(1U, 128U, 0U, 0U, 0U)==0U);
+  CHECK(smi_registers::device_setting(1U, 1U, 64U, 0U, 0U)==0U);
+  CHECK(smi_registers::device_setting(1U, 1U, 0U, 128U, 0U)==0U);
+  CHECK(smi_registers::device_setting(1U, 1U, 0U, 0U, 4U)==0U);
+}
+
+TEST_CASE( "Unit-tests/smi_registers/0020/device_address"
+         , "Address register values have device and address fields"
+         )
+{
+  CHECK(smi_registers::device_address(0U, 0U)==0U);
+  CHECK(smi_registers::device_address(0U, 63U)==63U);
+  CHECK(smi_registers::device_address(3U, 5U)==0x305U);
+}
+
+TEST_CASE( "Unit-tests/smi_registers/0030/set_dma_request_levels"
+         , "SMIDC fields are set to the requested levels with DMA enabled"
+         )
+{
+  smi_registers smi_regs;
+  std::memset(&smi_regs, 0x00, sizeof(smi_regs));
+  smi_regs.set_dma_request_levels(2U, 3U, 8U, 9U);
+  CHECK(smi_regs.dma_control==( smi_registers::dc_dma_enable
+                              | 2U | (3U<<6) | (8U<<12) | (9U<<18)
+                              ));
+}
@@ -0,0 +1,49 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file soft_bus_platformtests.cpp
+/// @brief Platform tests for bit-banged bus class templates.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "soft_bus.h"
+#include "gpio_ctrl.h"
+
+using namespace dibase::rpi::peripherals;
+using namespace dibase::rpi::peripherals::internal;
+
+TEST_CASE( "Platform-tests/soft_spi/0000/create & transfer"
+         , "A soft_spi transfers bytes leaving SCLK low and its pins are "
+           "released on destruction"
+         )
+{
+  {
+    soft_spi<22, 23, 24> spi{megahertz(1)};
+    CHECK( gpio_ctrl::instance().alloc.is_in_use(pin_id(22)) );
+    std::uint8_t buffer[]{0x55U, 0xAAU, 0x0FU};
+    spi.transfer(buffer, buffer, sizeof buffer);
+    CHECK_FALSE( gpio_ctrl::instance().regs->pin_level(pin_id(22)) );
+  }
+  CHECK_FALSE( gpio_ctrl::instance().alloc.is_in_use(pin_id(22)) );
+  CHECK_FALSE( gpio_ctrl::instance().alloc.is_in_use(pin_id(23)) );
+  CHECK_FALSE( gpio_ctrl::instance().alloc.is_in_use(pin_id(24)) );
+}
+
+TEST_CASE( "Platform-tests/soft_i2c/0000/no slave"
+         , "Writing to an address no slave responds to fails with the lines "
+           "left released"
+         )
+{
+  soft_i2c<22, 23> i2c;
+  std::uint8_t const byte{0U};
+  CHECK_FALSE(i2c.write(0x7FU, &byte, 1U));
+}
+
+TEST_CASE( "Platform-tests/one_wire/0000/reset"
+         , "Resetting a 1-Wire bus with no slaves detects no presence pulse"
+         )
+{
+  one_wire<22> bus;
+  CHECK_FALSE(bus.reset());
+}
@@ -0,0 +1,60 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file soft_bus_unittests.cpp
+/// @brief Unit tests for bit-banged bus support functions.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "soft_bus.h"
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/one_wire_crc8/0000/ROM code"
+         , "The CRC-8 of a ROM code's first 7 bytes is its last byte and the "
+           "CRC-8 of the whole ROM code is zero"
+         )
+{
+// Example ROM code from Maxim application note 27
+  std::uint8_t const rom[]{0x02U, 0x1CU, 0xB8U, 0x01U, 0x00U, 0x00U, 0x00U
+                          , 0xA2U
+                          };
+  CHECK(one_wire_crc8(rom, 7U)==0xA2U);
+  CHECK(one_wire_crc8(rom, 8U)==0U);
+  CHECK(one_wire_crc8(rom, 0U)==0U);
+}
+
+TEST_CASE( "Unit-tests/soft_spi_waveform_steps/0000/bad half period"
+         , "A zero half period throws std::invalid_argument"
+         )
+{
+  std::uint8_t const tx{0xA5U};
+  REQUIRE_THROWS_AS(soft_spi_waveform_steps(&tx, 1U, 0U)
+                   , std::invalid_argument
+                   );
+}
+
+TEST_CASE( "Unit-tests/soft_spi_waveform_steps/0010/bits"
+         , "Each bit is a step setting MOSI with SCLK low then a step raising "
+           "SCLK, most significant bit first, ending with both low"
+         )
+{
+  std::uint8_t const tx[]{0x80U, 0x01U};
+  std::vector<waveform_step> steps{soft_spi_waveform_steps(tx, 2U, 3U)};
+  REQUIRE(steps.size()==2U*8U*2U+1U);
+  for (std::size_t bit=0U; bit!=16U; ++bit)
+    {
+      bool const high{bit==0U || bit==15U};
+      waveform_step const & data(steps[bit*2U]);
+      waveform_step const & clock(steps[bit*2U+1U]);
+      CHECK(data.set==(high ? 2U : 0U));
+      CHECK(data.clear==(high ? 1U : 3U));
+      CHECK(data.delay_us==3U);
+      CHECK(clock.set==1U);
+      CHECK(clock.clear==0U);
+      CHECK(clock.delay_us==3U);
+    }
+  CHECK(steps.back().set==0U);
+  CHECK(steps.back().clear==3U);
+}
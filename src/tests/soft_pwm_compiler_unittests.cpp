@@ -0,0 +1,111 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file soft_pwm_compiler_unittests.cpp
+/// @brief Unit tests for compiling software PWM programs into DMA control
+/// blocks.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "soft_pwm_compiler.h"
+#include <cstring>
+#include <cstdint>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef std::uint32_t RegisterType;
+
+namespace
+{
+  RegisterType const region_bus{0xC0200000U};
+  RegisterType const gpset0_bus{0x7E20001CU};
+  RegisterType const gpclr0_bus{0x7E200028U};
+  RegisterType const pwm_fifo_bus{0x7E20C018U};
+
+  struct alignas(32) small_region_type
+  {
+    unsigned char bytes[1024];
+  };
+
+  dma_control_block const & cb_at
+  ( dma_region const & region
+  , void * base
+  , RegisterType bus
+  )
+  {
+    return *reinterpret_cast<dma_control_block const *>
+              (static_cast<unsigned char *>(base)+(bus-region.bus_address(base)));
+  }
+}
+
+TEST_CASE( "Unit-tests/soft_pwm_compiler/0000/bad parameters fail"
+         , "Compiling with no slots, zero or too large slot ticks or into too "
+           "small a region throws"
+         )
+{
+  small_region_type memory;
+  dma_region region{&memory, region_bus, sizeof(memory)};
+  REQUIRE_THROWS_AS(compile_soft_pwm(region, 0U, 10U), std::invalid_argument);
+  REQUIRE_THROWS_AS(compile_soft_pwm(region, 4U, 0U), std::invalid_argument);
+  REQUIRE_THROWS_AS( compile_soft_pwm(region, 4U, 0x10000000U)
+                   , std::invalid_argument
+                   );
+  dma_region small_region{&memory, region_bus, soft_pwm_program_size(4U)-4U};
+  REQUIRE_THROWS_AS(compile_soft_pwm(small_region, 4U, 10U), std::bad_alloc);
+}
+
+TEST_CASE( "Unit-tests/soft_pwm_compiler/0010/compile program"
+         , "Program sets pins, then clears and delays for each slot and loops "
+           "back to the start"
+         )
+{
+  small_region_type memory;
+  std::memset(&memory, 0xFF, sizeof(memory));
+  std::size_t const size{soft_pwm_program_size(3U)};
+// 7 CBs of 32 bytes + 2 set words + 3 * 2 clear words + 1 FIFO word
+  REQUIRE(size==7U*32U+9U*4U);
+  dma_region region{&memory, region_bus, size};
+  soft_pwm_program const program{compile_soft_pwm(region, 3U, 25U)};
+  CHECK(region.available()==0U);
+  CHECK(program.first_bus==region_bus);
+  CHECK(program.set_masks[0]==0U);
+  CHECK(program.set_masks[1]==0U);
+  CHECK(program.clear_masks==program.set_masks+2);
+  for (unsigned idx=0; idx!=6U; ++idx)
+    {
+      CHECK(program.clear_masks[idx]==0U);
+    }
+
+  dma_control_block const * cb{&cb_at(region, &memory, program.first_bus)};
+// Data words follow the 7 CBs: set masks, clear masks then FIFO word
+  CHECK(cb->source_address==program.first_bus+224U);
+  CHECK(cb->dest_address==gpset0_bus);
+  CHECK(cb->transfer_length==8U);
+  CHECK((cb->transfer_info&dma_control_block::ti_dest_dreq)==0U);
+  cb = &cb_at(region, &memory, cb->next_control_block);
+  RegisterType fifo_word_bus{0U};
+  for (unsigned slot=0; slot!=3U; ++slot)
+    {
+      CHECK(cb->source_address==program.first_bus+232U+8U*slot);
+      CHECK(cb->dest_address==gpclr0_bus);
+      CHECK(cb->transfer_length==8U);
+      CHECK((cb->transfer_info&dma_control_block::ti_dest_dreq)==0U);
+      cb = &cb_at(region, &memory, cb->next_control_block);
+      if (slot==0U)
+        {
+          fifo_word_bus = cb->source_address;
+        }
+      CHECK(cb->source_address==fifo_word_bus);
+      CHECK(cb->dest_address==pwm_fifo_bus);
+      CHECK(cb->transfer_length==100U);
+      CHECK((cb->transfer_info&dma_control_block::ti_dest_dreq)!=0U);
+      CHECK((cb->transfer_info&dma_control_block::ti_src_inc)==0U);
+      CHECK((cb->transfer_info&dma_control_block::ti_dest_inc)==0U);
+      CHECK(((cb->transfer_info>>dma_control_block::ti_permap_shift)&0x1FU)
+                                                                        ==5U);
+      cb = &cb_at(region, &memory, cb->next_control_block);
+    }
+  CHECK(fifo_word_bus==program.first_bus+256U);
+  CHECK(cb==&cb_at(region, &memory, program.first_bus));
+}
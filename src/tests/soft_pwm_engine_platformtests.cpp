@@ -0,0 +1,69 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file soft_pwm_engine_platformtests.cpp
+/// @brief System tests for DMA timed software PWM type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "soft_pwm_engine.h"
+#include "pwm_pin.h"
+#include "periexcept.h"
+#include <thread>
+
+using namespace dibase::rpi::peripherals;
+
+static pin_id const soft_pwm_pin_id_0{17}; // P1 pin GPIO_GEN0
+static pin_id const soft_pwm_pin_id_1{22}; // P1 pin GPIO_GEN3
+static pin_id const hw_pwm_pin_id{18};     // P1 pin GPIO_GEN1, PWM0
+
+TEST_CASE( "Platform_tests/soft_pwm_engine/000/bad parameters fail"
+         , "Creating an engine with no slots or updating with bad index or "
+           "duty throws"
+         )
+{
+  opin_group pins{soft_pwm_pin_id_0, soft_pwm_pin_id_1};
+  REQUIRE_THROWS_AS((soft_pwm_engine{pins, 0U, 10U}), std::invalid_argument);
+  REQUIRE_THROWS_AS((soft_pwm_engine{pins, 100U, 0U}), std::invalid_argument);
+  soft_pwm_engine engine{pins, 100U, 10U};
+  CHECK(engine.slots()==100U);
+  REQUIRE_THROWS_AS(engine.set_duty(2U, 10U), std::out_of_range);
+  REQUIRE_THROWS_AS(engine.set_duty(0U, 101U), std::out_of_range);
+  REQUIRE_THROWS_AS(engine.get_duty(2U), std::out_of_range);
+  CHECK(engine.get_duty(0U)==0U);
+}
+
+TEST_CASE( "Platform_tests/soft_pwm_engine/010/PWM in use fails"
+         , "Creating an engine while PWM is in use throws"
+         )
+{
+  opin_group pins{soft_pwm_pin_id_0, soft_pwm_pin_id_1};
+  {
+    pwm_pin hw_pwm{hw_pwm_pin_id};
+    REQUIRE_THROWS_AS((soft_pwm_engine{pins, 100U, 10U}), peripheral_in_use);
+  }
+  soft_pwm_engine engine{pins, 100U, 10U};
+  REQUIRE_THROWS_AS((soft_pwm_engine{pins, 100U, 10U}), peripheral_in_use);
+}
+
+TEST_CASE( "Platform_tests/soft_pwm_engine/020/run and update duties"
+         , "A started engine runs until stopped while duties are updated"
+         )
+{
+  opin_group pins{soft_pwm_pin_id_0, soft_pwm_pin_id_1};
+  soft_pwm_engine engine{pins, 100U, 10U};
+  CHECK_FALSE(engine.is_running());
+  engine.start();
+  CHECK(engine.is_running());
+  engine.set_duty(0U, 25U);
+  engine.set_duty(1U, 100U);
+  std::this_thread::sleep_for(std::chrono::milliseconds{5});
+  engine.set_duty(0U, 75U);
+  engine.set_duty(1U, 0U);
+  CHECK(engine.get_duty(0U)==75U);
+  CHECK(engine.get_duty(1U)==0U);
+  std::this_thread::sleep_for(std::chrono::milliseconds{5});
+  CHECK(engine.is_running());
+  engine.stop();
+  CHECK_FALSE(engine.is_running());
+}
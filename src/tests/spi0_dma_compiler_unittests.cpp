@@ -0,0 +1,269 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file spi0_dma_compiler_unittests.cpp
+/// @brief Unit tests for compiling SPI0 DMA frames into DMA control blocks.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "spi0_dma_compiler.h"
+#include <cstring>
+#include <cstdint>
+#include <vector>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef std::uint32_t RegisterType;
+
+namespace
+{
+  RegisterType const region_bus{0xC0100000U};
+  RegisterType const spi0_cs_bus{0x7E204000U};
+  RegisterType const spi0_fifo_bus{0x7E204004U};
+  RegisterType const spi0_clk_bus{0x7E204008U};
+  RegisterType const tx_channel_bus{0x7E007600U};
+  RegisterType const status_bus{0xC0200000U};
+
+  spi0_dma_frame_settings const settings
+                      {0x00000B31U, 0x00000081U, 250U, tx_channel_bus, status_bus};
+
+  struct alignas(32) small_region_type
+  {
+    unsigned char bytes[1024];
+  };
+
+  dma_control_block const & cb_at
+  ( dma_region const & region
+  , void * base
+  , RegisterType bus
+  )
+  {
+    return *reinterpret_cast<dma_control_block const *>
+              (static_cast<unsigned char *>(base)+(bus-region.bus_address(base)));
+  }
+
+  RegisterType word_at(void * base, RegisterType bus)
+  {
+    RegisterType value;
+    std::memcpy(&value, static_cast<unsigned char *>(base)+(bus-region_bus)
+               , sizeof(value)
+               );
+    return value;
+  }
+}
+
+TEST_CASE( "Unit-tests/spi0_dma_compiler/0000/empty frame fails"
+         , "Compiling a frame with no bytes throws"
+         )
+{
+  small_region_type memory;
+  dma_region region{&memory, region_bus, sizeof(memory)};
+  REQUIRE_THROWS_AS(compile_spi0_dma_frame(region, settings, nullptr, true, 0U, 1U)
+                   , std::invalid_argument);
+}
+
+TEST_CASE( "Unit-tests/spi0_dma_compiler/0010/too small region fails"
+         , "Compiling a frame into a region that is too small throws"
+         )
+{
+  small_region_type memory;
+  dma_region region{&memory, region_bus, spi0_dma_frame_size(6U)-4U};
+  std::uint8_t const tx[6]{1U, 2U, 3U, 4U, 5U, 6U};
+  REQUIRE_THROWS_AS(compile_spi0_dma_frame(region, settings, tx, true, 6U, 1U)
+                   , std::bad_alloc);
+}
+
+TEST_CASE( "Unit-tests/spi0_dma_compiler/0020/compile single chunk frame"
+         , "Receive chain writes CLK, idle CS, starts transmit channel, reads "
+           "data then writes status; transmit chain writes header and data"
+         )
+{
+  small_region_type memory;
+  std::memset(&memory, 0xFF, sizeof(memory));
+  std::size_t const size{spi0_dma_frame_size(6U)};
+// 7 CBs of 32 bytes + 6 words + 2 * 8 data bytes
+  REQUIRE(size==7U*32U+6U*4U+16U);
+  dma_region region{&memory, region_bus, size};
+  std::uint8_t const tx[6]{1U, 2U, 3U, 4U, 5U, 6U};
+  spi0_dma_frame frame
+                  {compile_spi0_dma_frame(region, settings, tx, true, 6U, 7U)};
+  CHECK(region.available()==0U);
+  CHECK(frame.first_bus==region_bus);
+  CHECK(frame.rx_data!=nullptr);
+
+  dma_control_block const * cb{&cb_at(region, &memory, frame.first_bus)};
+  CHECK(cb->dest_address==spi0_clk_bus);
+  CHECK(cb->transfer_length==4U);
+  CHECK(word_at(&memory, cb->source_address)==250U);
+
+  cb = &cb_at(region, &memory, cb->next_control_block);
+  CHECK(cb->dest_address==spi0_cs_bus);
+  CHECK(word_at(&memory, cb->source_address)==settings.cs_idle);
+
+  cb = &cb_at(region, &memory, cb->next_control_block);
+  CHECK(cb->dest_address==tx_channel_bus+4U);
+  RegisterType const tx_cb_bus{word_at(&memory, cb->source_address)};
+
+  cb = &cb_at(region, &memory, cb->next_control_block);
+  CHECK(cb->dest_address==tx_channel_bus);
+  CHECK(word_at(&memory, cb->source_address)
+                                        ==dma_channel_registers::start_value());
+
+  cb = &cb_at(region, &memory, cb->next_control_block);
+  CHECK(cb->source_address==spi0_fifo_bus);
+  CHECK(cb->transfer_length==6U);
+  CHECK(cb->dest_address==region.bus_address(frame.rx_data));
+  CHECK((cb->transfer_info&dma_control_block::ti_src_dreq)!=0U);
+  CHECK((cb->transfer_info&dma_control_block::ti_dest_inc)!=0U);
+  CHECK(((cb->transfer_info>>dma_control_block::ti_permap_shift)&0x1FU)==7U);
+
+  cb = &cb_at(region, &memory, cb->next_control_block);
+  CHECK(cb==frame.last);
+  CHECK(cb->dest_address==status_bus);
+  CHECK(word_at(&memory, cb->source_address)==7U);
+  CHECK(cb->next_control_block==0U);
+
+  dma_control_block const & tx_cb(cb_at(region, &memory, tx_cb_bus));
+  CHECK(tx_cb.dest_address==spi0_fifo_bus);
+  CHECK(tx_cb.transfer_length==12U);
+  CHECK(tx_cb.next_control_block==0U);
+  CHECK((tx_cb.transfer_info&dma_control_block::ti_dest_dreq)!=0U);
+  CHECK(((tx_cb.transfer_info>>dma_control_block::ti_permap_shift)&0x1FU)==6U);
+  CHECK(word_at(&memory, tx_cb.source_address)==((6U<<16)|0x81U));
+  std::uint8_t const expected[8]{1U, 2U, 3U, 4U, 5U, 6U, 0U, 0U};
+  CHECK(std::memcmp( reinterpret_cast<unsigned char *>(&memory)
+                     +(tx_cb.source_address+4U-region_bus)
+                   , expected, sizeof(expected)
+                   )==0);
+}
+
+TEST_CASE( "Unit-tests/spi0_dma_compiler/0030/compile frame ignoring rx"
+         , "Without receive, read control block ignores destination and no "
+           "receive data space is allocated"
+         )
+{
+  small_region_type memory;
+  dma_region region{&memory, region_bus, sizeof(memory)};
+  spi0_dma_frame frame
+          {compile_spi0_dma_frame(region, settings, nullptr, false, 3U, 1U)};
+  CHECK(frame.rx_data==nullptr);
+  CHECK(region.available()==sizeof(memory)-(spi0_dma_frame_size(3U)-4U));
+  dma_control_block const & rx_cb(cb_at(region, &memory, frame.first_bus+4U*32U));
+  CHECK(rx_cb.source_address==spi0_fifo_bus);
+  CHECK((rx_cb.transfer_info&dma_control_block::ti_dest_ignore)!=0U);
+  CHECK((rx_cb.transfer_info&dma_control_block::ti_dest_inc)==0U);
+  CHECK(rx_cb.dest_address==0U);
+}
+
+TEST_CASE( "Unit-tests/spi0_dma_compiler/0040/compile multi chunk frame"
+         , "Frames longer than the maximum chunk size are split into chunks "
+           "each started by the receive chain"
+         )
+{
+  std::size_t const count{spi0_dma_max_chunk+10U};
+  std::size_t const size{spi0_dma_frame_size(count)};
+  std::vector<small_region_type> memory((size+sizeof(small_region_type)-1U)
+                                        /sizeof(small_region_type)
+                                       );
+  dma_region region{memory.data(), region_bus, size};
+  std::vector<std::uint8_t> tx(count, 0xA5U);
+  spi0_dma_frame frame
+        {compile_spi0_dma_frame(region, settings, tx.data(), true, count, 2U)};
+  CHECK(region.available()==0U);
+  dma_control_block const * cb{&cb_at(region, memory.data(), frame.first_bus)};
+  std::vector<RegisterType> tx_cbs;
+  std::vector<RegisterType> rx_lengths;
+  while (cb!=frame.last)
+    {
+      if (cb->dest_address==tx_channel_bus+4U)
+        {
+          tx_cbs.push_back(word_at(memory.data(), cb->source_address));
+        }
+      if (cb->source_address==spi0_fifo_bus)
+        {
+          rx_lengths.push_back(cb->transfer_length);
+        }
+      cb = &cb_at(region, memory.data(), cb->next_control_block);
+    }
+  REQUIRE(tx_cbs.size()==2U);
+  REQUIRE(rx_lengths.size()==2U);
+  CHECK(rx_lengths[0]==spi0_dma_max_chunk);
+  CHECK(rx_lengths[1]==10U);
+  dma_control_block const & tx0(cb_at(region, memory.data(), tx_cbs[0]));
+  dma_control_block const & tx1(cb_at(region, memory.data(), tx_cbs[1]));
+  CHECK(tx0.transfer_length==4U+spi0_dma_max_chunk);
+  CHECK(tx1.transfer_length==16U);
+  CHECK(word_at(memory.data(), tx0.source_address)
+                                  ==((spi0_dma_max_chunk<<16)|0x81U));
+  CHECK(word_at(memory.data(), tx1.source_address)==((10U<<16)|0x81U));
+  CHECK(tx1.source_address==tx0.source_address+tx0.transfer_length);
+}
+
+TEST_CASE( "Unit-tests/spi0_dma_compiler/0050/compile sequence"
+         , "A sequence's segments each write their own CLK and idle CS values "
+           "and are linked in order; only the last writes the status"
+         )
+{
+  spi0_dma_frame_settings const settings1
+                  {0x00000B32U, 0x00000082U, 500U, tx_channel_bus, status_bus};
+  std::uint8_t const tx[3]{1U, 2U, 3U};
+  spi0_dma_segment_spec const segments[2]
+                        { {settings, tx, true, 3U}
+                        , {settings1, tx, false, 2U}
+                        };
+  std::size_t const size{spi0_dma_sequence_size(segments, 2U)};
+// First segment: 6 CBs, 5 words, 2 * 4 data bytes, padded to 224 bytes;
+// second: 7 CBs, 6 words, 2 * 4 data bytes though its receive space is not
+// used
+  REQUIRE(size==224U+7U*32U+6U*4U+8U);
+  std::vector<small_region_type> memory((size+sizeof(small_region_type)-1U)
+                                        /sizeof(small_region_type)
+                                       );
+  dma_region region{memory.data(), region_bus, size};
+  std::uint8_t const * rx_data[2];
+  spi0_dma_frame frame
+        {compile_spi0_dma_sequence(region, segments, 2U, 9U, rx_data)};
+  CHECK(region.available()==4U);
+  CHECK(frame.rx_data==rx_data[0]);
+  CHECK(rx_data[0]!=nullptr);
+  CHECK(rx_data[1]==nullptr);
+  std::vector<RegisterType> clks;
+  std::vector<RegisterType> idle_css;
+  std::vector<RegisterType> rx_lengths;
+  dma_control_block const * cb{&cb_at(region, memory.data(), frame.first_bus)};
+  while (cb!=frame.last)
+    {
+      if (cb->dest_address==spi0_clk_bus)
+        {
+          clks.push_back(word_at(memory.data(), cb->source_address));
+        }
+      if (cb->dest_address==spi0_cs_bus)
+        {
+          idle_css.push_back(word_at(memory.data(), cb->source_address));
+        }
+      if (cb->source_address==spi0_fifo_bus)
+        {
+          rx_lengths.push_back(cb->transfer_length);
+        }
+      REQUIRE(cb->next_control_block!=0U);
+      cb = &cb_at(region, memory.data(), cb->next_control_block);
+    }
+  REQUIRE(clks.size()==2U);
+  CHECK(clks[0]==250U);
+  CHECK(clks[1]==500U);
+  REQUIRE(idle_css.size()==2U);
+  CHECK(idle_css[0]==settings.cs_idle);
+  CHECK(idle_css[1]==settings1.cs_idle);
+  REQUIRE(rx_lengths.size()==2U);
+  CHECK(rx_lengths[0]==3U);
+  CHECK(rx_lengths[1]==2U);
+  CHECK(frame.last->dest_address==status_bus);
+  CHECK(word_at(memory.data(), frame.last->source_address)==9U);
+  CHECK(frame.last->next_control_block==0U);
+  REQUIRE_THROWS_AS( compile_spi0_dma_sequence( region, segments, 0U, 9U
+                                              , rx_data
+                                              )
+                   , std::invalid_argument
+                   );
+}
@@ -0,0 +1,124 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file spi0_dma_platformtests.cpp
+/// @brief Platform tests for spi0_dma and related types.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "spi0_dma.h"
+#include "spi0_ctrl.h"
+#include "periexcept.h"
+#include <vector>
+
+using namespace dibase::rpi::peripherals;
+using namespace dibase::rpi::peripherals::internal;
+
+TEST_CASE( "Platform-tests/spi0_dma/0000/create & destroy"
+         , "Creating a spi0_dma object from a spi0_pins object with standard "
+           "mode support succeeds and leaves SPI0 not in DMA mode when "
+           "destroyed"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  {
+    spi0_dma sd(sp, 4096U);
+    CHECK(sd.max_frame_size()==4096U);
+    CHECK_FALSE(sp.is_conversing());
+  }
+  CHECK_FALSE(spi0_ctrl::instance().regs->get_dma_enable());
+  CHECK_FALSE(spi0_ctrl::instance().regs->get_transfer_active());
+}
+
+TEST_CASE( "Platform-tests/spi0_dma/0010/create bad: zero max frame size"
+         , "Creating a spi0_dma object with a zero maximum frame size fails"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  REQUIRE_THROWS_AS(spi0_dma(sp, 0U), std::invalid_argument);
+}
+
+TEST_CASE( "Platform-tests/spi0_dma/0100/submit bad: bad mode or count"
+         , "Submitting a frame with a non-standard mode context or bad count "
+           "fails"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  spi0_dma sd(sp, 64U);
+  std::uint8_t tx[65]{};
+  spi0_slave_context bidir( spi0_slave::chip0, megahertz(1)
+                          , spi0_mode::bidirectional
+                          );
+  spi0_slave_context sc( spi0_slave::chip0, megahertz(1) );
+  REQUIRE_THROWS_AS(sd.submit(bidir, tx, nullptr, 1U), std::invalid_argument);
+  REQUIRE_THROWS_AS(sd.submit(sc, tx, nullptr, 0U), std::invalid_argument);
+  REQUIRE_THROWS_AS(sd.submit(sc, tx, nullptr, 65U), std::invalid_argument);
+}
+
+TEST_CASE( "Platform-tests/spi0_dma/0110/good: submit and wait"
+         , "Submitting a frame transfers it by DMA"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  spi0_dma sd(sp, 1000U);
+  std::vector<std::uint8_t> tx(1000U, 0x5AU);
+  std::vector<std::uint8_t> rx(1000U, 0U);
+  spi0_slave_context sc( spi0_slave::chip0, megahertz(8) );
+  spi0_dma_transfer t{sd.submit(sc, tx.data(), rx.data(), tx.size())};
+  t.wait();
+  CHECK(t.is_done());
+  t.wait();
+}
+
+TEST_CASE( "Platform-tests/spi0_dma/0120/good: queue frames"
+         , "Frames submitted while another is in flight are chained and all "
+           "complete in order"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  spi0_dma sd(sp, 100000U);
+  std::vector<std::uint8_t> tx(100000U, 0xC3U);
+  spi0_slave_context sc( spi0_slave::chip0, megahertz(32) );
+  spi0_dma_transfer t1{sd.submit(sc, tx.data(), nullptr, tx.size())};
+  spi0_dma_transfer t2{sd.submit(sc, tx.data(), nullptr, 10U)};
+  spi0_dma_transfer t3{sd.submit(sc, nullptr, nullptr, tx.size())};
+  CHECK(t1.is_done());
+  t3.wait();
+  CHECK(t2.is_done());
+  CHECK(t3.is_done());
+}
+
+TEST_CASE( "Platform-tests/spi0_dma/0130/good: submit sequence"
+         , "A sequence of segments for different slaves is transferred as one "
+           "frame; sequences with too many segments or bytes fail"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  spi0_dma sd(sp, 64U, 2U);
+  CHECK(sd.max_segments()==2U);
+  spi0_slave_context adc( spi0_slave::chip0, megahertz(1) );
+  spi0_slave_context dac( spi0_slave::chip1, megahertz(8) );
+  std::uint8_t const adc_tx[3]{0x01U, 0x80U, 0x00U};
+  std::uint8_t adc_rx[3]{};
+  std::uint8_t const dac_tx[2]{0x30U, 0x00U};
+  spi0_dma_segment const cycle[2]
+                          { {&adc, adc_tx, adc_rx, 3U}
+                          , {&dac, dac_tx, nullptr, 2U}
+                          };
+  spi0_dma_transfer t{sd.submit_sequence(cycle, 2U)};
+  t.wait();
+  CHECK(t.is_done());
+  spi0_dma_segment const too_many[3]
+                          { {&adc, adc_tx, nullptr, 1U}
+                          , {&adc, adc_tx, nullptr, 1U}
+                          , {&adc, adc_tx, nullptr, 1U}
+                          };
+  REQUIRE_THROWS_AS(sd.submit_sequence(too_many, 3U), std::invalid_argument);
+  REQUIRE_THROWS_AS(sd.submit_sequence(cycle, 0U), std::invalid_argument);
+  spi0_dma_segment const too_big[2]
+                          { {&adc, nullptr, nullptr, 60U}
+                          , {&dac, nullptr, nullptr, 5U}
+                          };
+  REQUIRE_THROWS_AS(sd.submit_sequence(too_big, 2U), std::invalid_argument);
+}
@@ -178,6 +178,89 @@ namespace
     return true;
   }
 
+  bool test_buffer_transfer(hertz f)
+  {
+    std::cout << "Buffer transfer at " << hertz_to_string(f)
+              << " for approximately 1 second...\n";
+    spi0_pins sp(rpi_p1_spi0_full_pin_set);
+    spi0_slave_context sc(spi0_slave::chip0, f);
+    sp.start_conversing(sc);
+    std::uint8_t wbuf[64];
+    std::uint8_t rbuf[64];
+    memset(wbuf, 0x5a, sizeof(wbuf));
+    std::uint64_t wcount{0ULL};
+    std::uint64_t rcount{0ULL};
+    auto const t_start(test_clock::now());
+    auto const t_end(t_start+std::chrono::seconds(1));
+    while (test_clock::now()<t_end)
+      {
+        if (wcount-rcount<sizeof(wbuf))
+          {
+            wcount += sp.write(wbuf, sizeof(wbuf)-(wcount-rcount));
+          }
+        rcount += sp.read(rbuf, sizeof(rbuf));
+      }
+    while (rcount!=wcount)
+      {
+        rcount += sp.read(rbuf, sizeof(rbuf));
+      }
+    auto const duration_ms(std::chrono::duration_cast
+                            <std::chrono::milliseconds>
+                              (test_clock::now()-t_start).count()
+                          );
+    double scale_to_per_sec(1000.0/duration_ms);
+    std::cout << "Wrote and read " << wcount << " bytes in " << duration_ms
+              << "ms: " << std::uint64_t(wcount*scale_to_per_sec+0.5)
+              << " Bps\n\n";
+    return true;
+  }
+
+  template <class SwitchFn>
+  std::uint64_t count_context_switches(SwitchFn switch_fn)
+  {
+    std::uint64_t count{0ULL};
+    auto const t_end(test_clock::now()+std::chrono::seconds(1));
+    while (test_clock::now()<t_end)
+      {
+        for (unsigned i=0U; i!=100U; ++i, ++count)
+          {
+            switch_fn();
+          }
+      }
+    return count;
+  }
+
+  bool test_context_switch_rate()
+  {
+    spi0_pins sp(rpi_p1_spi0_full_pin_set);
+    spi0_slave_context const sc0(spi0_slave::chip0, megahertz(1));
+    spi0_slave_context const sc1(spi0_slave::chip1, megahertz(8));
+    bool odd{false};
+    std::cout << "Switching between 2 slave contexts for approximately 1 "
+                 "second using start_conversing...\n";
+    std::uint64_t const start_count
+      {count_context_switches
+        ( [&]()
+          {
+            sp.start_conversing((odd=!odd) ? sc1 : sc0);
+          }
+        )
+      };
+    std::cout << "Switching between 2 slave contexts for approximately 1 "
+                 "second using switch_conversation...\n";
+    std::uint64_t const switch_count
+      {count_context_switches
+        ( [&]()
+          {
+            sp.switch_conversation((odd=!odd) ? sc1 : sc0);
+          }
+        )
+      };
+    std::cout << "start_conversing:    " << start_count << " switches/sec\n"
+              << "switch_conversation: " << switch_count << " switches/sec\n\n";
+    return switch_count!=0U;
+  }
+
   bool test_clock_frequency(hertz f)
   {
     std::ostringstream oss;
@@ -385,3 +468,28 @@ TEST_CASE( "Interactive_tests/spi0_pins/0040/clock frequency"
   CHECK(test_clock_frequency(megahertz(1)));
   CHECK(test_clock_frequency(megahertz(2)));
 }
+
+TEST_CASE( "Interactive_tests/spi0_pins/0050/buffer transfer throughput"
+         , "Observe throughput of buffer writes and reads which burst FIFO "
+           "accesses when the TX FIFO is empty or the RX FIFO needs reading; "
+           "compare with the single byte rates of test 0020"
+         )
+{
+  welcome();
+  std::cout << "\nSPI0 buffer transfer throughput tests\n\n";
+
+  CHECK(test_buffer_transfer(kilohertz(500)));
+  CHECK(test_buffer_transfer(megahertz(1)));
+  CHECK(test_buffer_transfer(megahertz(2)));
+  CHECK(test_buffer_transfer(megahertz(8)));
+  CHECK(test_buffer_transfer(megahertz(16)));
+}
+
+TEST_CASE( "Interactive_tests/spi0_pins/0060/slave context switch rate"
+         , "Compare the rates at which start_conversing and "
+           "switch_conversation switch between slave contexts"
+         )
+{
+  std::cout << "\nSPI0 slave context switch rate test\n\n";
+  CHECK(test_context_switch_rate());
+}
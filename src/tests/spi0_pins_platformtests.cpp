@@ -169,48 +169,35 @@ TEST_CASE( "Platform-tests/spi0_pins/0020/create good, non-default CSPOLn values
   }
 }
 
-TEST_CASE( "Platform-tests/spi0_pins/0030/create bad: no expected alt-fn"
-         , "Creating spi0_pins from an SPI0 pin set with a pin that does not "
-           "support the stated special function throws an exception"
+TEST_CASE( "Platform-tests/spi0_pins/0030/create & destroy BCM2711 SPI3..6"
+         , "Creating spi0_pins for SPI3 to SPI6 allocates the SPI peripheral "
+           "alongside SPI0 on a BCM2711 and fails on other SoCs"
          )
 {
-  spi0_pin_set<0U,7U,11U,10U,9U> full_bad_ce0;
-  spi0_pin_set<8U,0U,11U,10U,9U> full_bad_ce1;
-  spi0_pin_set<8U,7U,0U,10U,9U> full_bad_sclk;
-  spi0_pin_set<8U,7U,11U,0U,9U> full_bad_mosi;
-  spi0_pin_set<8U,7U,11U,10,0U> full_bad_miso;
-  REQUIRE_THROWS_AS((spi0_pins(full_bad_ce0 )), std::invalid_argument);
-  CHECK_FALSE(spi0_ctrl::instance().allocated);
-  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(spi_ce0_n));
-  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(spi_ce1_n));
-  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(spi_sclk));
-  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(spi_mosi));
-  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(spi_miso));
-  REQUIRE_THROWS_AS((spi0_pins(full_bad_ce1 )), std::invalid_argument);
-  REQUIRE_THROWS_AS((spi0_pins(full_bad_sclk)), std::invalid_argument);
-  REQUIRE_THROWS_AS((spi0_pins(full_bad_mosi)), std::invalid_argument);
-  REQUIRE_THROWS_AS((spi0_pins(full_bad_miso)), std::invalid_argument);
-
-  spi0_pin_set<0U,7U,11U,10U> two_wire_bad_ce0;
-  spi0_pin_set<8U,0U,11U,10U> two_wire_bad_ce1;
-  spi0_pin_set<8U,7U,0U,10U>  two_wire_bad_sclk;
-  spi0_pin_set<8U,7U,11U,0U>  two_wire_bad_mosi;
-  REQUIRE_THROWS_AS((spi0_pins(two_wire_bad_ce0 )), std::invalid_argument);
-  CHECK_FALSE(spi0_ctrl::instance().allocated);
-  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(spi_ce0_n));
-  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(spi_ce1_n));
-  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(spi_sclk));
-  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(spi_mosi));
-  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(spi_miso));
-  REQUIRE_THROWS_AS((spi0_pins(two_wire_bad_ce1 )), std::invalid_argument);
-  REQUIRE_THROWS_AS((spi0_pins(two_wire_bad_sclk)), std::invalid_argument);
-  REQUIRE_THROWS_AS((spi0_pins(two_wire_bad_mosi)), std::invalid_argument);
-  CHECK_FALSE(spi0_ctrl::instance().allocated);
-  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(spi_ce0_n));
-  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(spi_ce1_n));
-  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(spi_sclk));
-  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(spi_mosi));
-  CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(spi_miso));
+  if (spi0_ctrl::has_controller(3U))
+    {
+      {
+        spi0_pins sp0(rpi_p1_spi0_full_pin_set);
+        spi0_pins sp3(spi0_pin_set<0U, 24U, 3U, 2U, 1U, 3U>{});
+        CHECK(sp3.spi()==3U);
+        CHECK(spi0_ctrl::instance().allocated);
+        CHECK(spi0_ctrl::instance().allocated_of(3U));
+        CHECK(gpio_ctrl::instance().config.pin_function(pin_id(0))
+              ==gpio_pin_fn::alt3);
+        CHECK(gpio_ctrl::instance().config.pin_function(pin_id(24))
+              ==gpio_pin_fn::alt5);
+        CHECK_FALSE(sp3.is_conversing());
+      }
+      CHECK_FALSE(spi0_ctrl::instance().allocated_of(3U));
+      CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(pin_id(24)));
+    }
+  else
+    {
+      REQUIRE_THROWS_AS( (spi0_pins(spi0_pin_set<0U,24U,3U,2U,1U,3U>{}))
+                       , std::invalid_argument
+                       );
+      CHECK_FALSE(gpio_ctrl::instance().alloc.is_in_use(pin_id(0)));
+    }
 }
 
 TEST_CASE( "Platform-tests/spi0_pins/0040/create bad: SPI0 in use"
@@ -949,3 +936,217 @@ TEST_CASE( "Platform-tests/spi0_pins/1620/good: bidir: read byte from conversati
   CHECK(spi0_ctrl::instance().regs->get_read_enable());
   spi0_ctrl::instance().regs->clear_fifo(spi0_fifo_clear_action::clear_tx);
 }
+
+TEST_CASE( "Platform-tests/spi0_pins/1700/bad: transfer, not conversing"
+         , "Full-duplex transfer when not conversing transfers no bytes"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  std::uint8_t tx[4]{1U, 2U, 3U, 4U};
+  std::uint8_t rx[4]{};
+  REQUIRE_FALSE(sp.is_conversing());
+  CHECK(sp.transfer(tx, rx, 4)==0U);
+}
+
+TEST_CASE( "Platform-tests/spi0_pins/1710/bad: bidir: transfer fails"
+         , "Full-duplex transfer in a bidirectional mode conversation "
+           "transfers no bytes"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  spi0_slave_context sc( spi0_slave::chip0
+                      , kilohertz(25)
+                      , spi0_mode::bidirectional
+                      );
+  sp.start_conversing(sc);
+  std::uint8_t tx[4]{1U, 2U, 3U, 4U};
+  CHECK(sp.transfer(tx, nullptr, 4)==0U);
+  CHECK(spi0_ctrl::instance().regs->get_transfer_done());
+}
+
+TEST_CASE( "Platform-tests/spi0_pins/1720/good: std: transfer more than FIFO"
+         , "Full-duplex transfer of more bytes than the FIFOs hold in a "
+           "standard mode conversation transfers all bytes and leaves the "
+           "FIFOs empty"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  spi0_slave_context sc( spi0_slave::chip0, megahertz(1) );
+  sp.start_conversing(sc);
+  std::uint8_t tx[100];
+  for (std::size_t i=0; i!=sizeof(tx); ++i)
+    {
+      tx[i] = static_cast<std::uint8_t>(i);
+    }
+  std::uint8_t rx[100]{};
+  CHECK(sp.transfer(tx, rx, sizeof(tx))==sizeof(tx));
+  CHECK(sp.transfer(nullptr, nullptr, sizeof(tx))==sizeof(tx));
+  CHECK_FALSE(spi0_ctrl::instance().regs->get_rx_fifo_not_empty());
+  CHECK(spi0_ctrl::instance().regs->get_transfer_done());
+}
+
+TEST_CASE( "Platform-tests/spi0_pins/1730/bad: transfer_iov, not conversing"
+         , "Scatter/gather transfers when not conversing transfer no bytes"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  std::uint8_t tx[4]{1U, 2U, 3U, 4U};
+  spi0_iovec const iov[]{{tx, nullptr, 2U}, {tx+2, nullptr, 2U}};
+  REQUIRE_FALSE(sp.is_conversing());
+  CHECK(sp.transfer_iov(iov, 2U)==0U);
+  CHECK(sp.write_gather(iov, 2U)==0U);
+}
+
+TEST_CASE( "Platform-tests/spi0_pins/1740/good: std: transfer_iov & write_gather"
+         , "Scatter/gather transfers of several buffers, including an empty "
+           "one, in a standard mode conversation transfer all bytes"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  spi0_slave_context sc( spi0_slave::chip0, megahertz(1) );
+  sp.start_conversing(sc);
+  std::uint8_t header[3]{0x2AU, 0U, 0U};
+  std::uint8_t params[40]{};
+  std::uint8_t payload[50]{};
+  std::uint8_t rx[50]{};
+  spi0_iovec const iov[]
+    { {header, nullptr, sizeof(header)}
+    , {nullptr, nullptr, 0U}
+    , {params, nullptr, sizeof(params)}
+    , {payload, rx, sizeof(payload)}
+    };
+  std::size_t const total{sizeof(header)+sizeof(params)+sizeof(payload)};
+  CHECK(sp.transfer_iov(iov, 4U)==total);
+  CHECK(sp.write_gather(iov, 4U)==total);
+  CHECK_FALSE(spi0_ctrl::instance().regs->get_rx_fifo_not_empty());
+  CHECK(spi0_ctrl::instance().regs->get_transfer_done());
+}
+
+TEST_CASE( "Platform-tests/spi0_pins/1750/bad: std: lossi long word writes"
+         , "Enabling LoSSI long word writes fails if not in a LoSSI mode "
+           "conversation"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  CHECK_FALSE(sp.set_lossi_long_word_writes(true));
+  spi0_slave_context sc( spi0_slave::chip0, kilohertz(25) );
+  sp.start_conversing(sc);
+  CHECK_FALSE(sp.set_lossi_long_word_writes(true));
+  CHECK_FALSE(sp.lossi_long_word_writes());
+}
+
+TEST_CASE( "Platform-tests/spi0_pins/1760/good: lossi: long word writes"
+         , "With LoSSI long word writes enabled buffer writes write whole "
+           "words, single byte writes fail and restarting the conversation "
+           "disables long word writes"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  spi0_slave_context sc( spi0_slave::chip0
+                      , kilohertz(25)
+                      , spi0_mode::lossi
+                      );
+  sp.start_conversing(sc);
+  REQUIRE(sp.set_lossi_long_word_writes(true));
+  CHECK(sp.lossi_long_word_writes());
+  CHECK(spi0_ctrl::instance().regs->get_lossi_dma_enable());
+  CHECK(spi0_ctrl::instance().regs->get_lossi_long_word());
+  std::uint8_t data[6]{1U, 2U, 3U, 4U, 5U, 6U};
+  CHECK(sp.write(data, 6)==4U);
+  CHECK_FALSE(sp.write(data[4]));
+  sp.start_conversing(sc);
+  CHECK_FALSE(sp.lossi_long_word_writes());
+  CHECK_FALSE(spi0_ctrl::instance().regs->get_lossi_long_word());
+  spi0_ctrl::instance().regs->clear_fifo(spi0_fifo_clear_action::clear_tx);
+}
+
+TEST_CASE( "Platform-tests/spi0_pins/1770/bad: write_all/read_all not conversing"
+         , "Whole buffer writes and reads when not conversing are not "
+           "supported and transfer no bytes"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  std::uint8_t data[4]{1U, 2U, 3U, 4U};
+  REQUIRE_FALSE(sp.is_conversing());
+  spi0_io_result const wr{sp.write_all(data, 4U, std::chrono::milliseconds{1})};
+  CHECK(wr.bytes==0U);
+  CHECK(wr.status==spi0_io_status::not_supported);
+  spi0_io_result const rd{sp.read_all(data, 4U, std::chrono::milliseconds{1})};
+  CHECK(rd.bytes==0U);
+  CHECK(rd.status==spi0_io_status::not_supported);
+}
+
+TEST_CASE( "Platform-tests/spi0_pins/1780/good: std: write_all & read_all"
+         , "Whole buffer writes and reads of more bytes than the FIFOs hold "
+           "in a standard mode conversation complete and leave the FIFOs "
+           "empty"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  spi0_slave_context sc( spi0_slave::chip0, megahertz(1) );
+  sp.start_conversing(sc);
+  std::uint8_t data[100]{};
+  spi0_io_result const wr
+                  {sp.write_all(data, sizeof(data), std::chrono::seconds{1})};
+  CHECK(wr.bytes==sizeof(data));
+  CHECK(wr.status==spi0_io_status::complete);
+  spi0_io_result const rd
+                  {sp.read_all(data, sizeof(data), std::chrono::seconds{1})};
+  CHECK(rd.bytes==sizeof(data));
+  CHECK(rd.status==spi0_io_status::complete);
+  CHECK_FALSE(spi0_ctrl::instance().regs->get_rx_fifo_not_empty());
+  CHECK(spi0_ctrl::instance().regs->get_transfer_done());
+}
+
+TEST_CASE( "Platform-tests/spi0_pins/1790/bad: lossi: write_all part words"
+         , "Whole buffer writes of a number of bytes that is not a multiple "
+           "of 4 with LoSSI long word writes enabled are not supported"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  spi0_slave_context sc( spi0_slave::chip0
+                      , kilohertz(25)
+                      , spi0_mode::lossi
+                      );
+  sp.start_conversing(sc);
+  REQUIRE(sp.set_lossi_long_word_writes(true));
+  std::uint8_t data[6]{1U, 2U, 3U, 4U, 5U, 6U};
+  spi0_io_result const wr{sp.write_all(data, 6U, std::chrono::seconds{1})};
+  CHECK(wr.bytes==0U);
+  CHECK(wr.status==spi0_io_status::not_supported);
+}
+
+TEST_CASE( "Platform-tests/spi0_pins/1800/switch_conversation"
+         , "Switching conversation sets the same SPI0 register values as "
+           "starting conversing, retaining the chip select polarities"
+         )
+{
+  spi0_pins sp( rpi_p1_spi0_full_pin_set
+              , spi0_cs_polarity::low, spi0_cs_polarity::high
+              );
+  spi0_slave_context const sc0(spi0_slave::chip0, kilohertz(25));
+  spi0_slave_context const sc1( spi0_slave::chip1, megahertz(1)
+                              , spi0_mode::lossi, spi0_clk_polarity::high
+                              , spi0_clk_phase::start, 4U
+                              );
+  for (auto const * psc : {&sc0, &sc1})
+    {
+      sp.start_conversing(*psc);
+      std::uint32_t const cs{spi0_ctrl::instance().regs->control_and_status};
+      std::uint32_t const clk{spi0_ctrl::instance().regs->clock};
+      std::uint32_t const ltoh{spi0_ctrl::instance().regs->lossi_mode_toh};
+      sp.stop_conversing();
+      sp.switch_conversation(*psc);
+      CHECK(sp.is_conversing());
+      CHECK(spi0_ctrl::instance().regs->control_and_status==cs);
+      CHECK(spi0_ctrl::instance().regs->clock==clk);
+      CHECK(spi0_ctrl::instance().regs->lossi_mode_toh==ltoh);
+      CHECK_FALSE(spi0_ctrl::instance().regs->get_chip_select_polarity(0U));
+      CHECK(spi0_ctrl::instance().regs->get_chip_select_polarity(1U));
+    }
+  sp.switch_conversation(spi0_slave_context{spi0_slave::chip0, kilohertz(25)
+                                           , spi0_mode::none
+                                           });
+  CHECK_FALSE(sp.is_conversing());
+  CHECK_FALSE(spi0_ctrl::instance().regs->get_transfer_active());
+}
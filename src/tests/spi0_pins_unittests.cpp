@@ -57,3 +57,62 @@ TEST_CASE( "Platform-tests/rpi_p1_spi0_2_wire_only_pin_set/0000/pins in set as e
   CHECK(rpi_p1_spi0_2_wire_only_pin_set.mosi()==pin_id(spi_mosi));
   CHECK(rpi_p1_spi0_2_wire_only_pin_set.miso()==spi0_pin_not_used);
 }
+
+TEST_CASE( "Unit-tests/spi0_pin_supports/0000/pin SPI0 function support"
+         , "spi0_pin_supports is a compile time check of whether a GPIO pin "
+           "supports a SPI0 function"
+         )
+{
+  static_assert( spi0_pin_supports(8U, spi0_pin_fn::ce0)
+              && spi0_pin_supports(36U, spi0_pin_fn::ce0)
+              && spi0_pin_supports(7U, spi0_pin_fn::ce1)
+              && spi0_pin_supports(11U, spi0_pin_fn::sclk)
+              && spi0_pin_supports(10U, spi0_pin_fn::mosi)
+              && spi0_pin_supports(37U, spi0_pin_fn::miso)
+               , "SPI0 pins expected to support function"
+               );
+  CHECK_FALSE(spi0_pin_supports(0U, spi0_pin_fn::ce0));
+  CHECK_FALSE(spi0_pin_supports(7U, spi0_pin_fn::ce0));
+  CHECK_FALSE(spi0_pin_supports(8U, spi0_pin_fn::sclk));
+  CHECK_FALSE(spi0_pin_supports(9U, spi0_pin_fn::mosi));
+  CHECK_FALSE(spi0_pin_supports(spi0_pin_not_used, spi0_pin_fn::miso));
+}
+
+TEST_CASE( "Unit-tests/spi_pin_supports/0000/pin SPI3 to SPI6 function support"
+         , "spi_pin_supports is a compile time check of whether a GPIO pin "
+           "supports a function of SPI0 or one of the BCM2711 SPI3 to SPI6"
+         )
+{
+  static_assert( spi_pin_supports(8U, 0U, spi0_pin_fn::ce0)
+              && spi_pin_supports(0U, 3U, spi0_pin_fn::ce0)
+              && spi_pin_supports(24U, 3U, spi0_pin_fn::ce1)
+              && spi_pin_supports(7U, 4U, spi0_pin_fn::sclk)
+              && spi_pin_supports(14U, 5U, spi0_pin_fn::mosi)
+              && spi_pin_supports(19U, 6U, spi0_pin_fn::miso)
+               , "SPI pins expected to support function"
+               );
+  CHECK_FALSE(spi_pin_supports(0U, 0U, spi0_pin_fn::ce0));
+  CHECK_FALSE(spi_pin_supports(8U, 3U, spi0_pin_fn::ce0));
+  CHECK_FALSE(spi_pin_supports(0U, 4U, spi0_pin_fn::ce0));
+  CHECK_FALSE(spi_pin_supports(0U, 1U, spi0_pin_fn::ce0));
+  CHECK_FALSE(spi_pin_supports(0U, 7U, spi0_pin_fn::ce0));
+  CHECK(spi0_pin_set<18U, 27U, 21U, 20U, 19U, 6U>{}.spi()==6U);
+  CHECK(rpi_p1_spi0_full_pin_set.spi()==0U);
+}
+
+TEST_CASE( "Unit-tests/spi0_pins/0000/create fails for unsupported pin set"
+         , "Compile will fail if built with COMPILE_FAIL_TESTS #defined for "
+           "spi0_pins created from pin sets with pins that do not support "
+           "their SPI0 function"
+         )
+{
+  CHECK(spi0_pin_supports(8U, spi0_pin_fn::ce0)); // Compiles OK
+
+#ifdef COMPILE_FAIL_TESTS
+
+  spi0_pins bad_ce0{spi0_pin_set<0U,7U,11U,10U,9U>{}};   // Compile FAIL
+  spi0_pins bad_miso{spi0_pin_set<8U,7U,11U,10U,0U>{}};  // Compile FAIL
+  spi0_pins bad_sclk{spi0_pin_set<8U,7U,0U,10U>{}};      // Compile FAIL
+
+#endif
+}
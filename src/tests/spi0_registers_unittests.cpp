@@ -560,6 +560,17 @@ TEST_CASE( "Unit-tests/spi0_registers/0500/transmit_fifo_lossi_write"
   CHECK(spi0_regs.fifo==expected+256U);  
 }
 
+TEST_CASE( "Unit-tests/spi0_registers/0505/transmit_fifo_long_write"
+         , "transmit_fifo_long_write sets all 32 bits of the fifo register"
+         )
+{
+  spi0_registers spi0_regs;
+  std::memset(&spi0_regs, 0x00U, sizeof(spi0_regs));
+  std::uint32_t expected{0xA1B2C3D4U};
+  spi0_regs.transmit_fifo_long_write(expected);
+  CHECK(spi0_regs.fifo==expected);
+}
+
 TEST_CASE( "Unit-tests/spi0_registers/0510/receive_fifo_read"
          , "receive_fifo_read obtains correct byte data from "
            "fifo register DATA field"
@@ -0,0 +1,90 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file spi0_sampler_platformtests.cpp
+/// @brief Platform tests for spi0_sampler.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "spi0_sampler.h"
+#include "spi0_ctrl.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace dibase::rpi::peripherals;
+using namespace dibase::rpi::peripherals::internal;
+
+TEST_CASE( "Platform-tests/spi0_sampler/0000/create bad"
+         , "Creating a spi0_sampler with bad parameters fails"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  spi0_slave_context bidir( spi0_slave::chip0, megahertz(1)
+                          , spi0_mode::bidirectional
+                          );
+  spi0_slave_context sc( spi0_slave::chip0, megahertz(1) );
+  REQUIRE_THROWS_AS( spi0_sampler(sp, bidir, {0xd0U, 0U}, kilohertz(1), 64U)
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS( spi0_sampler(sp, sc, {}, kilohertz(1), 64U)
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS( spi0_sampler(sp, sc, {1U, 2U, 3U, 4U, 5U}
+                                 , kilohertz(1), 64U
+                                 )
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS( spi0_sampler(sp, sc, {0xd0U, 0U}, hertz(0), 64U)
+                   , std::invalid_argument
+                   );
+  REQUIRE_THROWS_AS( spi0_sampler(sp, sc, {0xd0U, 0U}, kilohertz(1), 60U)
+                   , std::invalid_argument
+                   );
+}
+
+TEST_CASE( "Platform-tests/spi0_sampler/0010/sample"
+         , "Samples are taken at the requested rate with increasing "
+           "timestamps, deasserting chip select between samples"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  spi0_slave_context sc( spi0_slave::chip0, megahertz(1) );
+  std::vector<spi0_sample> samples;
+  std::uint64_t overruns{0U};
+  {
+    spi0_sampler s(sp, sc, {0xd0U, 0U}, kilohertz(10), 4096U);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    spi0_sample batch[256];
+    std::size_t count{0U};
+    while ((count=s.pop(batch, 256U))!=0U)
+      {
+        samples.insert(samples.end(), batch, batch+count);
+      }
+    overruns = s.overruns();
+  }
+  CHECK_FALSE(sp.is_conversing());
+  CHECK_FALSE(spi0_ctrl::instance().regs->get_transfer_active());
+  CHECK(overruns==0U);
+  CHECK(samples.size()>=900U);
+  CHECK(samples.size()<=1100U);
+  std::size_t ordered{0U};
+  for (std::size_t idx=1; idx<samples.size(); ++idx)
+    {
+      if (samples[idx].timestamp_us>samples[idx-1].timestamp_us)
+        {
+          ++ordered;
+        }
+    }
+  CHECK(ordered+1U==samples.size());
+  if (samples.size()>1U)
+    {
+      std::uint64_t const span{ samples.back().timestamp_us
+                              - samples.front().timestamp_us
+                              };
+      std::uint64_t const mean_period_us{span/(samples.size()-1U)};
+      CHECK(mean_period_us>=99U);
+      CHECK(mean_period_us<=101U);
+    }
+}
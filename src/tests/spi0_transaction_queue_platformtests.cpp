@@ -0,0 +1,75 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file spi0_transaction_queue_platformtests.cpp
+/// @brief Platform tests for spi0_transaction_queue.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "spi0_transaction_queue.h"
+#include "spi0_ctrl.h"
+#include <thread>
+
+using namespace dibase::rpi::peripherals;
+using namespace dibase::rpi::peripherals::internal;
+
+TEST_CASE( "Platform-tests/spi0_transaction_queue/0000/create & destroy"
+         , "Creating and destroying a spi0_transaction_queue leaves SPI0 not "
+           "conversing"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  {
+    spi0_transaction_queue q(sp);
+  }
+  CHECK_FALSE(sp.is_conversing());
+  CHECK_FALSE(spi0_ctrl::instance().regs->get_transfer_active());
+}
+
+TEST_CASE( "Platform-tests/spi0_transaction_queue/0010/submit bad"
+         , "Submitting a transaction with a non-standard mode context or no "
+           "bytes fails"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  spi0_transaction_queue q(sp);
+  spi0_slave_context bidir( spi0_slave::chip0, megahertz(1)
+                          , spi0_mode::bidirectional
+                          );
+  spi0_slave_context sc( spi0_slave::chip0, megahertz(1) );
+  REQUIRE_THROWS_AS(q.submit(bidir, {1U, 2U}), std::invalid_argument);
+  REQUIRE_THROWS_AS(q.submit(sc, {}), std::invalid_argument);
+}
+
+TEST_CASE( "Platform-tests/spi0_transaction_queue/0020/good: many producers"
+         , "Transactions submitted from several threads to two slaves all "
+           "complete, each receiving as many bytes as were sent, with TA "
+           "cleared between transactions"
+         )
+{
+  spi0_pins sp(rpi_p1_spi0_full_pin_set);
+  spi0_slave_context adc( spi0_slave::chip0, megahertz(1) );
+  spi0_slave_context dac( spi0_slave::chip1, megahertz(2) );
+  spi0_transaction_queue q(sp);
+// Catch assertions are not thread safe: producers count good results
+  auto producer = [&q]( spi0_slave_context const & c, std::size_t count
+                      , std::size_t & good
+                      )
+                  {
+                    for (std::size_t n=1; n<=count; ++n)
+                      {
+                        std::vector<std::uint8_t> tx(n, 0x3CU);
+                        good += q.submit(c, tx).get().size()==n;
+                      }
+                  };
+  std::size_t adc_good{0U};
+  std::size_t dac_good{0U};
+  std::thread t1{producer, std::cref(adc), 20U, std::ref(adc_good)};
+  std::thread t2{producer, std::cref(dac), 20U, std::ref(dac_good)};
+  t1.join();
+  t2.join();
+  CHECK(adc_good==20U);
+  CHECK(dac_good==20U);
+  CHECK_FALSE(spi0_ctrl::instance().regs->get_transfer_active());
+}
@@ -0,0 +1,91 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file spsc_ring_unittests.cpp
+/// @brief Unit tests for spsc_ring type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "spsc_ring.h"
+#include <thread>
+#include <vector>
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/spsc_ring/0000/bad capacity fails"
+         , "Constructing a spsc_ring with a capacity that is not a non-zero "
+           "power of two throws"
+         )
+{
+  REQUIRE_THROWS_AS(spsc_ring<int>{0U}, std::invalid_argument);
+  REQUIRE_THROWS_AS(spsc_ring<int>{3U}, std::invalid_argument);
+  REQUIRE_THROWS_AS(spsc_ring<int>{12U}, std::invalid_argument);
+  spsc_ring<int> r{8U};
+  CHECK(r.capacity()==8U);
+  CHECK(r.empty());
+}
+
+TEST_CASE( "Unit-tests/spsc_ring/0010/push until full then pop in batches"
+         , "Pushes succeed until the ring is full and pops return elements in "
+           "order"
+         )
+{
+  spsc_ring<int> r{4U};
+  for (int v=0; v!=4; ++v)
+    {
+      CHECK(r.try_push(v));
+    }
+  CHECK(r.size()==4U);
+  CHECK_FALSE(r.try_push(4));
+  int out[4]{};
+  REQUIRE(r.pop(out, 3U)==3U);
+  CHECK(out[0]==0);
+  CHECK(out[1]==1);
+  CHECK(out[2]==2);
+  CHECK(r.try_push(4));
+  CHECK(r.try_push(5));
+  CHECK(r.try_push(6));
+  CHECK_FALSE(r.try_push(7));
+  REQUIRE(r.pop(out, 4U)==4U);
+  CHECK(out[0]==3);
+  CHECK(out[1]==4);
+  CHECK(out[2]==5);
+  CHECK(out[3]==6);
+  CHECK(r.pop(out, 4U)==0U);
+  CHECK(r.empty());
+}
+
+TEST_CASE( "Unit-tests/spsc_ring/0020/concurrent producer and consumer"
+         , "All elements pushed by a producer thread are popped in order by a "
+           "consumer thread"
+         )
+{
+  std::size_t const count{100000U};
+  spsc_ring<std::size_t> r{64U};
+  std::thread producer{ [&r, count]()
+                        {
+                          for (std::size_t v=0; v!=count; ++v)
+                            {
+                              while (!r.try_push(v))
+                                {
+                                  std::this_thread::yield();
+                                }
+                            }
+                        }
+                      };
+  std::size_t expected{0U};
+  bool in_order{true};
+  std::size_t out[16];
+  while (expected!=count)
+    {
+      std::size_t const n{r.pop(out, 16U)};
+      for (std::size_t idx=0; idx!=n; ++idx, ++expected)
+        {
+          in_order = in_order && out[idx]==expected;
+        }
+    }
+  producer.join();
+  CHECK(in_order);
+  CHECK(r.empty());
+}
@@ -0,0 +1,48 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file static_pin_unittests.cpp
+/// @brief Unit tests for compile time GPIO pin IO type support.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "static_pin.h"
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/static_pin_traits/0000/bank 0 pins"
+         , "Pins 0..31 are in register bank 0 with mask 1<<pin"
+         )
+{
+  CHECK(static_pin_traits<0>::bank==0U);
+  CHECK(static_pin_traits<0>::mask==1U);
+  CHECK(static_pin_traits<17>::bank==0U);
+  CHECK(static_pin_traits<17>::mask==(1U<<17));
+  CHECK(static_pin_traits<31>::bank==0U);
+  CHECK(static_pin_traits<31>::mask==0x80000000U);
+}
+
+TEST_CASE( "Unit-tests/static_pin_traits/0010/bank 1 pins"
+         , "Pins 32..53 are in register bank 1 with mask 1<<(pin-32)"
+         )
+{
+  CHECK(static_pin_traits<32>::bank==1U);
+  CHECK(static_pin_traits<32>::mask==1U);
+  CHECK(static_pin_traits<53>::bank==1U);
+  CHECK(static_pin_traits<53>::mask==(1U<<21));
+}
+
+TEST_CASE( "Unit-tests/static_pin_traits/0020/create fails for out of range pin"
+         , "Compile will fail if built with COMPILE_FAIL_TESTS #defined for "
+           "a pin value greater than 53"
+         )
+{
+  CHECK(static_pin_traits<53>::bank==1U); // Compiles OK
+
+#ifdef COMPILE_FAIL_TESTS
+
+  CHECK(static_pin_traits<54>::bank==1U); // Compile FAIL
+
+#endif
+}
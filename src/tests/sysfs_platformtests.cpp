@@ -185,3 +185,18 @@ TEST_CASE( "Platform_tests/0080/sysfs/repeat open same pin OK if edge event mode
     CHECK(is_exported(available_pin_id_2d)==false);
   }
 }
+
+TEST_CASE( "Platform_tests/0090/sysfs/export_pins_unexport_pins"
+         , "Batch export and unexport of pins exports and unexports all pins"
+         )
+{
+  pin_id const pins[]{available_pin_id_1d, available_pin_id_2d};
+  REQUIRE(is_exported(available_pin_id_1d)==false);
+  REQUIRE(is_exported(available_pin_id_2d)==false);
+  CHECK(export_pins(pins, 2U)==2U);
+  CHECK(is_exported(available_pin_id_1d)==true);
+  CHECK(is_exported(available_pin_id_2d)==true);
+  CHECK(unexport_pins(pins, 2U)==2U);
+  CHECK(is_exported(available_pin_id_1d)==false);
+  CHECK(is_exported(available_pin_id_2d)==false);
+}
@@ -0,0 +1,37 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file system_timer_platformtests.cpp
+/// @brief System tests for system timer clock type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "system_timer.h"
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Platform_tests/000/system_timer/now is steady"
+         , "Successive system_timer::now values never decrease"
+         )
+{
+  auto t0(system_timer::now());
+  auto t1(system_timer::now());
+  CHECK(t1>=t0);
+  CHECK(system_timer::now_us()>=static_cast<std::uint64_t>
+                                              (t1.time_since_epoch().count()));
+}
+
+TEST_CASE( "Platform_tests/010/system_timer/delays are not short"
+         , "delay_us and delay_ns wait for at least the requested time"
+         )
+{
+  auto t0(system_timer::now());
+  system_timer::delay_us(500U);
+  auto t1(system_timer::now());
+  CHECK((t1-t0)>=std::chrono::microseconds{500});
+  CHECK((t1-t0)<std::chrono::milliseconds{100});
+  t0 = system_timer::now();
+  system_timer::delay_ns(250500U);
+  t1 = system_timer::now();
+  CHECK((t1-t0)>=std::chrono::microseconds{250});
+}
@@ -0,0 +1,69 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file system_timer_registers_unittests.cpp
+/// @brief Unit tests for low-level system timer registers type.
+///
+/// Refer to the Broadcom BCM2835 Peripherals Datasheet PDF file for details:
+///
+/// http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf
+///
+/// Chapter 12 System Timer
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "system_timer_registers.h"
+#include <cstring>
+#include <cstdint>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef uint32_t RegisterType;
+typedef unsigned char Byte;
+
+// Register byte offsets, see BCM2835 peripherals manual System Timer Address
+// Map table in section 12.1 System Timer Registers
+enum RegisterOffsets 
+{  CS_OFFSET=0x00, CLO_OFFSET=0x04, CHI_OFFSET=0x08
+,  C0_OFFSET=0x0C,  C1_OFFSET=0x10,  C2_OFFSET=0x14, C3_OFFSET=0x18
+};
+
+TEST_CASE( "Unit-tests/system_timer_registers/0000/field offsets"
+         , "System timer registers should have the expected offsets"
+         )
+{
+  system_timer_registers st_regs;
+// initially start with all bytes of st_regs set to 0xFF:
+  std::memset(&st_regs, 0xFF, sizeof(st_regs));
+  Byte * reg_base_addr(reinterpret_cast<Byte *>(&st_regs));
+ 
+// Set each 32-bit register to the value of its offset:
+  st_regs.control_and_status = CS_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[CS_OFFSET])==CS_OFFSET );
+  st_regs.counter_low = CLO_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[CLO_OFFSET])==CLO_OFFSET );
+  st_regs.counter_high = CHI_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[CHI_OFFSET])==CHI_OFFSET );
+  st_regs.compare[0] = C0_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[C0_OFFSET])==C0_OFFSET );
+  st_regs.compare[1] = C1_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[C1_OFFSET])==C1_OFFSET );
+  st_regs.compare[2] = C2_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[C2_OFFSET])==C2_OFFSET );
+  st_regs.compare[3] = C3_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[C3_OFFSET])==C3_OFFSET );
+}
+
+TEST_CASE( "Unit-tests/system_timer_registers/0010/get counter"
+         , "Reading the counter returns CHI in upper and CLO in lower 32 bits"
+         )
+{
+  system_timer_registers st_regs;
+  std::memset(&st_regs, 0, sizeof(st_regs));
+  CHECK(st_regs.get_counter()==0U);
+  st_regs.counter_low = 0x89ABCDEFU;
+  st_regs.counter_high = 0x01234567U;
+  CHECK(st_regs.get_counter_low()==0x89ABCDEFU);
+  CHECK(st_regs.get_counter()==0x0123456789ABCDEFULL);
+}
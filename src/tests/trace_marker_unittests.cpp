@@ -0,0 +1,59 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file trace_marker_unittests.cpp
+/// @brief Unit tests for ftrace trace_marker record formatting.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "trace_marker.h"
+#include <string>
+#include <type_traits>
+
+using namespace dibase::rpi::peripherals::internal;
+
+TEST_CASE( "Unit-tests/trace_marker/0000/begin record"
+         , "Begin records are B|pid|rpi:name"
+         )
+{
+  char buffer[64];
+  std::size_t const length
+                  {format_trace_begin(buffer, sizeof(buffer), 1234, "wait")};
+  CHECK( std::string(buffer, length)=="B|1234|rpi:wait" );
+}
+
+TEST_CASE( "Unit-tests/trace_marker/0010/end record"
+         , "End records are E|pid"
+         )
+{
+  char buffer[64];
+  std::size_t const length{format_trace_end(buffer, sizeof(buffer), 42)};
+  CHECK( std::string(buffer, length)=="E|42" );
+}
+
+TEST_CASE( "Unit-tests/trace_marker/0020/truncation"
+         , "Records too long for the buffer are truncated to fit"
+         )
+{
+  char buffer[8];
+  std::size_t const length
+                  {format_trace_begin(buffer, sizeof(buffer), 1234, "wait")};
+  CHECK( length==7U );
+  CHECK( std::string(buffer, length)=="B|1234|" );
+  CHECK( format_trace_end(buffer, 0U, 1)==0U );
+}
+
+TEST_CASE( "Unit-tests/trace_marker/0030/trace scope"
+         , "trace_scope objects may be used whether or not tracing is on"
+         )
+{
+  {
+    trace_scope trace{"unit test"};
+  }
+  trace_begin("unit test");
+  trace_end();
+#ifndef DIBASE_RPI_PERIPHERALS_TRACE
+  CHECK( std::is_empty<trace_scope>::value );
+#endif
+}
@@ -0,0 +1,86 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file uart0_pins_platformtests.cpp
+/// @brief Platform tests for uart0_pins and uart0_dma_rx.
+///
+/// The loop back tests require the Raspberry Pi P1 TXD0 (GPIO14) and RXD0
+/// (GPIO15) pins to be connected together and the Linux serial console on
+/// /dev/ttyAMA0 to be disabled.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "uart0_pins.h"
+#include "uart0_dma_rx.h"
+#include "periexcept.h"
+#include <thread>
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Platform-tests/uart0_pins/0000/create and destroy"
+         , "Creating a uart0_pins object allocates UART0 which is freed on "
+           "destruction"
+         )
+{
+  {
+    uart0_pins uart{rpi_p1_uart0_pin_set, uart0_line_settings{hertz{9600U}}};
+    REQUIRE_THROWS_AS( (uart0_pins{ rpi_p1_uart0_pin_set
+                                  , uart0_line_settings{hertz{9600U}}
+                                  })
+                     , bad_peripheral_alloc
+                     );
+    CHECK(uart.line_settings().integer_divisor()==19U);
+  }
+  uart0_pins uart{rpi_p1_uart0_pin_set, uart0_line_settings{hertz{9600U}}};
+}
+
+TEST_CASE( "Platform-tests/uart0_pins/0010/bad pins fail"
+         , "Pins not supporting the UART0 functions throw"
+         )
+{
+  REQUIRE_THROWS_AS( (uart0_pins{ uart0_pin_set<4U,15U>{}
+                                , uart0_line_settings{hertz{9600U}}
+                                })
+                   , std::invalid_argument
+                   );
+}
+
+TEST_CASE( "Platform-tests/uart0_pins/0020/loop back write and read frame"
+         , "[.] Bytes written are read back as one frame (needs TXD0 "
+           "connected to RXD0)"
+         )
+{
+  uart0_pins uart{rpi_p1_uart0_pin_set, uart0_line_settings{hertz{115200U}}};
+  std::uint8_t const tx[20]{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10
+                           , 11, 12, 13, 14, 15, 16, 17, 18, 19, 20
+                           };
+  CHECK(uart.write_all(tx, sizeof(tx))==sizeof(tx));
+  std::uint8_t rx[32]{};
+  std::size_t const n{uart.read_frame( rx, sizeof(rx)
+                                     , std::chrono::milliseconds{100}
+                                     )};
+  REQUIRE(n==sizeof(tx));
+  CHECK(std::equal(tx, tx+sizeof(tx), rx));
+  CHECK(uart.read_frame(rx, sizeof(rx), std::chrono::milliseconds{10})==0U);
+  CHECK(uart.line_errors().framing==0U);
+}
+
+TEST_CASE( "Platform-tests/uart0_dma_rx/0000/loop back DMA receive"
+         , "[.] Bytes written are received into the DMA ring (needs TXD0 "
+           "connected to RXD0)"
+         )
+{
+  uart0_pins uart{rpi_p1_uart0_pin_set, uart0_line_settings{hertz{115200U}}};
+  uart0_dma_rx ring{uart, 64U};
+  CHECK(ring.available()==0U);
+  std::uint8_t const tx[40]{ 1 };
+  uart.write_all(tx, sizeof(tx));
+  uart.drain();
+  std::this_thread::sleep_for(std::chrono::milliseconds{2});
+  CHECK(ring.available()==sizeof(tx));
+  std::uint8_t rx[64]{};
+  CHECK(ring.read(rx, sizeof(rx))==sizeof(tx));
+  CHECK(std::equal(tx, tx+sizeof(tx), rx));
+  CHECK(ring.available()==0U);
+}
@@ -0,0 +1,67 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file uart0_pins_unittests.cpp
+/// @brief Unit tests for uart0_pins related types.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "uart0_pins.h"
+
+using namespace dibase::rpi::peripherals;
+
+TEST_CASE( "Unit-tests/uart0_pin_set/0000/pins in set as expected"
+         , "Defined uart0_pin_set returns expected (pin) values"
+         )
+{
+  uart0_pin_set<1U, 2U, 3U, 4U> flow_control_pin_set;
+  CHECK(flow_control_pin_set.txd()==1U);
+  CHECK(flow_control_pin_set.rxd()==2U);
+  CHECK(flow_control_pin_set.cts()==3U);
+  CHECK(flow_control_pin_set.rts()==4U);
+  CHECK(rpi_p1_uart0_pin_set.txd()==14U);
+  CHECK(rpi_p1_uart0_pin_set.rxd()==15U);
+  CHECK(rpi_p1_uart0_pin_set.cts()==uart0_pin_not_used);
+  CHECK(rpi_p1_uart0_pin_set.rts()==uart0_pin_not_used);
+}
+
+TEST_CASE( "Unit-tests/uart0_line_settings/0000/baud rate divisors"
+         , "Baud rate divisors are fc/(16*baud) rounded to the nearest 64th"
+         )
+{
+  uart0_line_settings s115200{hertz{115200U}};
+  CHECK(s115200.integer_divisor()==1U);
+  CHECK(s115200.fractional_divisor()==40U);
+  CHECK(s115200.actual_baud().count()==Approx(115200.0).epsilon(0.01));
+  CHECK(s115200.character_bits()==10U);
+  uart0_line_settings s9600{hertz{9600U}};
+  CHECK(s9600.integer_divisor()==19U);
+  CHECK(s9600.fractional_divisor()==34U);
+  CHECK_THROWS_AS( uart0_line_settings{hertz{250000U}}
+                 , std::out_of_range
+                 );
+  uart0_line_settings dmx512
+          { hertz{250000U}, 8U, uart0_parity::none, uart0_stop_bits::two
+          , megahertz{48U}
+          };
+  CHECK(dmx512.integer_divisor()==12U);
+  CHECK(dmx512.fractional_divisor()==0U);
+  CHECK(dmx512.character_bits()==11U);
+  CHECK_THROWS_AS( uart0_line_settings{hertz{0U}}, std::out_of_range );
+}
+
+TEST_CASE( "Unit-tests/uart0_line_settings/0010/bad data bits fail"
+         , "Data bits outside [5,8] throw"
+         )
+{
+  CHECK_THROWS_AS( uart0_line_settings(hertz{9600U}, 4U)
+                 , std::invalid_argument
+                 );
+  CHECK_THROWS_AS( uart0_line_settings(hertz{9600U}, 9U)
+                 , std::invalid_argument
+                 );
+  uart0_line_settings seven_even
+          {hertz{9600U}, 7U, uart0_parity::even, uart0_stop_bits::one};
+  CHECK(seven_even.character_bits()==10U);
+}
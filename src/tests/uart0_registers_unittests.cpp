@@ -0,0 +1,213 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file uart0_registers_unittests.cpp
+/// @brief Unit tests for low-level UART0 (PL011) control registers type.
+///
+/// Refer to the Broadcom BCM2835 Peripherals Datasheet PDF file for details:
+///
+/// http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf
+///
+/// Chapter 13 UART
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "uart0_registers.h"
+#include <cstring>
+#include <cstdint>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef uint32_t RegisterType;
+typedef unsigned char Byte;
+
+// Register byte offsets, see BCM2835 peripherals manual UART Address Map
+// table in section 13.4 Register View
+enum RegisterOffsets
+{    DR_OFFSET=0x00, RSRECR_OFFSET=0x04,   FR_OFFSET=0x18, IBRD_OFFSET=0x24
+, FBRD_OFFSET=0x28,   LCRH_OFFSET=0x2C,   CR_OFFSET=0x30, IFLS_OFFSET=0x34
+, IMSC_OFFSET=0x38,    RIS_OFFSET=0x3C,  MIS_OFFSET=0x40,  ICR_OFFSET=0x44
+, DMACR_OFFSET=0x48,  ITCR_OFFSET=0x80,  TDR_OFFSET=0x8C
+};
+
+TEST_CASE( "Unit-tests/uart0_registers/0000/field offsets"
+         , "UART0 registers should have the expected offsets"
+         )
+{
+  uart0_registers uart0_regs;
+  std::memset(&uart0_regs, 0xFF, sizeof(uart0_regs));
+  Byte * reg_base_addr(reinterpret_cast<Byte *>(&uart0_regs));
+
+  uart0_regs.data = DR_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[DR_OFFSET])==DR_OFFSET );
+  uart0_regs.receive_status = RSRECR_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[RSRECR_OFFSET])
+                                                              ==RSRECR_OFFSET );
+  uart0_regs.flags = FR_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[FR_OFFSET])==FR_OFFSET );
+  uart0_regs.integer_baud_divisor = IBRD_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[IBRD_OFFSET])
+                                                                ==IBRD_OFFSET );
+  uart0_regs.fractional_baud_divisor = FBRD_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[FBRD_OFFSET])
+                                                                ==FBRD_OFFSET );
+  uart0_regs.line_control = LCRH_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[LCRH_OFFSET])
+                                                                ==LCRH_OFFSET );
+  uart0_regs.control = CR_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[CR_OFFSET])==CR_OFFSET );
+  uart0_regs.fifo_level_select = IFLS_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[IFLS_OFFSET])
+                                                                ==IFLS_OFFSET );
+  uart0_regs.interrupt_mask = IMSC_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[IMSC_OFFSET])
+                                                                ==IMSC_OFFSET );
+  uart0_regs.raw_interrupt_status = RIS_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[RIS_OFFSET])
+                                                                 ==RIS_OFFSET );
+  uart0_regs.masked_interrupt_status = MIS_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[MIS_OFFSET])
+                                                                 ==MIS_OFFSET );
+  uart0_regs.interrupt_clear = ICR_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[ICR_OFFSET])
+                                                                 ==ICR_OFFSET );
+  uart0_regs.dma_control = DMACR_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[DMACR_OFFSET])
+                                                              ==DMACR_OFFSET );
+  uart0_regs.test_control = ITCR_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[ITCR_OFFSET])
+                                                                ==ITCR_OFFSET );
+  uart0_regs.test_data = TDR_OFFSET;
+  CHECK( reinterpret_cast<RegisterType&>(reg_base_addr[TDR_OFFSET])
+                                                                 ==TDR_OFFSET );
+}
+
+TEST_CASE( "Unit-tests/uart0_registers/0010/flags"
+         , "Flag register getters return the state of the FR register bits"
+         )
+{
+  uart0_registers uart0_regs;
+  std::memset(&uart0_regs, 0, sizeof(uart0_regs));
+  CHECK_FALSE(uart0_regs.get_busy());
+  CHECK_FALSE(uart0_regs.get_rx_fifo_empty());
+  CHECK_FALSE(uart0_regs.get_tx_fifo_full());
+  uart0_regs.flags = 0x08U;
+  CHECK(uart0_regs.get_busy());
+  uart0_regs.flags = 0x10U;
+  CHECK(uart0_regs.get_rx_fifo_empty());
+  uart0_regs.flags = 0x20U;
+  CHECK(uart0_regs.get_tx_fifo_full());
+  uart0_regs.flags = 0x40U;
+  CHECK(uart0_regs.get_rx_fifo_full());
+  uart0_regs.flags = 0x80U;
+  CHECK(uart0_regs.get_tx_fifo_empty());
+  CHECK_FALSE(uart0_regs.get_busy());
+  uart0_regs.flags = 0x01U;
+  CHECK(uart0_regs.get_clear_to_send());
+}
+
+TEST_CASE( "Unit-tests/uart0_registers/0020/baud divisors"
+         , "set_baud_divisors sets IBRD and FBRD only if in range"
+         )
+{
+  uart0_registers uart0_regs;
+  std::memset(&uart0_regs, 0, sizeof(uart0_regs));
+  CHECK(uart0_regs.set_baud_divisors(1U, 40U));
+  CHECK(uart0_regs.integer_baud_divisor==1U);
+  CHECK(uart0_regs.fractional_baud_divisor==40U);
+  CHECK(uart0_regs.get_integer_baud_divisor()==1U);
+  CHECK(uart0_regs.get_fractional_baud_divisor()==40U);
+  CHECK_FALSE(uart0_regs.set_baud_divisors(0U, 1U));
+  CHECK_FALSE(uart0_regs.set_baud_divisors(0x10000U, 0U));
+  CHECK_FALSE(uart0_regs.set_baud_divisors(2U, 64U));
+  CHECK_FALSE(uart0_regs.set_baud_divisors(0xFFFFU, 1U));
+  CHECK(uart0_regs.integer_baud_divisor==1U);
+  CHECK(uart0_regs.fractional_baud_divisor==40U);
+  CHECK(uart0_regs.set_baud_divisors(0xFFFFU, 0U));
+  CHECK(uart0_regs.integer_baud_divisor==0xFFFFU);
+}
+
+TEST_CASE( "Unit-tests/uart0_registers/0030/line control"
+         , "Line control setters change only their LCRH fields"
+         )
+{
+  uart0_registers uart0_regs;
+  std::memset(&uart0_regs, 0, sizeof(uart0_regs));
+  CHECK(uart0_regs.set_word_length(8U));
+  CHECK(uart0_regs.line_control==0x60U);
+  CHECK(uart0_regs.get_word_length()==8U);
+  CHECK(uart0_regs.set_word_length(5U));
+  CHECK(uart0_regs.line_control==0U);
+  CHECK_FALSE(uart0_regs.set_word_length(4U));
+  CHECK_FALSE(uart0_regs.set_word_length(9U));
+  CHECK(uart0_regs.get_word_length()==5U);
+  uart0_regs.set_fifo_enable(true);
+  CHECK(uart0_regs.line_control==0x10U);
+  CHECK(uart0_regs.get_fifo_enable());
+  uart0_regs.set_send_break(true);
+  CHECK(uart0_regs.line_control==0x11U);
+  uart0_regs.set_send_break(false);
+  uart0_regs.set_fifo_enable(false);
+  CHECK(uart0_regs.line_control==0U);
+}
+
+TEST_CASE( "Unit-tests/uart0_registers/0040/control"
+         , "Control setters change only their CR bits"
+         )
+{
+  uart0_registers uart0_regs;
+  std::memset(&uart0_regs, 0, sizeof(uart0_regs));
+  uart0_regs.set_enable(true);
+  CHECK(uart0_regs.control==0x301U);
+  CHECK(uart0_regs.get_enable());
+  uart0_regs.set_flow_control(true, false);
+  CHECK(uart0_regs.control==0x4301U);
+  uart0_regs.set_flow_control(false, true);
+  CHECK(uart0_regs.control==0x8301U);
+  uart0_regs.set_enable(false);
+  CHECK(uart0_regs.control==0x8000U);
+  CHECK_FALSE(uart0_regs.get_enable());
+}
+
+TEST_CASE( "Unit-tests/uart0_registers/0050/FIFO levels, interrupts and DMA"
+         , "IFLS, ICR and DMACR are set as expected"
+         )
+{
+  uart0_registers uart0_regs;
+  std::memset(&uart0_regs, 0, sizeof(uart0_regs));
+  uart0_regs.set_fifo_levels( uart0_fifo_level::half
+                            , uart0_fifo_level::eighth
+                            );
+  CHECK(uart0_regs.fifo_level_select==0x10U);
+  uart0_regs.set_fifo_levels( uart0_fifo_level::seven_eighths
+                            , uart0_fifo_level::three_quarters
+                            );
+  CHECK(uart0_regs.fifo_level_select==0x23U);
+  CHECK(uart0_registers::fifo_level_entries(uart0_fifo_level::eighth)==2U);
+  CHECK(uart0_registers::fifo_level_entries(uart0_fifo_level::half)==8U);
+  CHECK(uart0_registers::fifo_level_entries
+                              (uart0_fifo_level::seven_eighths)==14U);
+  uart0_regs.raw_interrupt_status = 0x40U;
+  CHECK(uart0_regs.get_raw_interrupt(uart0_registers::int_rx_timeout));
+  CHECK_FALSE(uart0_regs.get_raw_interrupt(uart0_registers::int_rx));
+  uart0_regs.clear_interrupts(0xFFFFFFFFU);
+  CHECK(uart0_regs.interrupt_clear==0x7F2U);
+  uart0_regs.set_rx_dma_enable(true);
+  CHECK(uart0_regs.dma_control==1U);
+  CHECK(uart0_regs.get_rx_dma_enable());
+  uart0_regs.set_rx_dma_enable(false);
+  CHECK(uart0_regs.dma_control==0U);
+}
+
+TEST_CASE( "Unit-tests/uart0_registers/0060/receive entries"
+         , "receive returns data and error bits of the DR register"
+         )
+{
+  uart0_registers uart0_regs;
+  std::memset(&uart0_regs, 0, sizeof(uart0_regs));
+  uart0_regs.data = 0xFFFFF5A5U;
+  CHECK(uart0_regs.receive()==0x5A5U);
+  uart0_regs.transmit(0x3CU);
+  CHECK(uart0_regs.data==0x3CU);
+}
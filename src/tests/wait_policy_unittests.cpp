@@ -0,0 +1,139 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file wait_policy_unittests.cpp
+/// @brief Unit tests for wait_policy, wait_stats and adaptive_wait types.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "wait_policy.h"
+#include "irq_event.h"
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace dibase::rpi::peripherals;
+
+static_assert( wait_policy::default_spin_count>0U
+            && wait_policy::default_yield_count>0U
+             , "Default wait policy should spin and yield"
+             );
+
+TEST_CASE( "Unit-tests/wait_policy/0000/construct"
+         , "wait_policy and wait_stats construct with expected values"
+         )
+{
+  wait_policy dflt;
+  CHECK(dflt.spin_count==2000U);
+  CHECK(dflt.yield_count==50U);
+  CHECK(dflt.sleep_time==std::chrono::microseconds(50));
+  wait_policy p(10U, 2U, std::chrono::microseconds(1));
+  CHECK(p.spin_count==10U);
+  CHECK(p.yield_count==2U);
+  CHECK(p.sleep_time==std::chrono::nanoseconds(1000));
+  CHECK(p.interrupt==nullptr);
+  wait_stats s;
+  CHECK(s.spin_waits==0U);
+  CHECK(s.yield_waits==0U);
+  CHECK(s.sleep_waits==0U);
+  CHECK(s.interrupt_waits==0U);
+}
+
+TEST_CASE( "Unit-tests/adaptive_wait/0010/stage counts"
+         , "Waits are counted by the stage they finished in; waits with no "
+           "pauses are not counted"
+         )
+{
+  wait_policy p(3U, 2U, std::chrono::nanoseconds(1000));
+  wait_stats s;
+  {
+    adaptive_wait w(p, s);
+  }
+  CHECK(s.spin_waits==0U);
+  {
+    adaptive_wait w(p, s);
+    for (int i=0; i!=3; ++i) w.pause();
+  }
+  CHECK(s.spin_waits==1U);
+  {
+    adaptive_wait w(p, s);
+    for (int i=0; i!=5; ++i) w.pause();
+  }
+  CHECK(s.yield_waits==1U);
+  {
+    adaptive_wait w(p, s);
+    for (int i=0; i!=8; ++i) w.pause();
+  }
+  CHECK(s.sleep_waits==1U);
+  CHECK(s.spin_waits==1U);
+  CHECK(s.yield_waits==1U);
+}
+
+TEST_CASE( "Unit-tests/adaptive_wait/0020/restart"
+         , "restart counts the current wait and starts a new one from the "
+           "spinning stage"
+         )
+{
+  wait_policy p(1U, 1U, std::chrono::nanoseconds(1000));
+  wait_stats s;
+  {
+    adaptive_wait w(p, s);
+    w.pause();
+    w.pause();
+    w.restart();
+    CHECK(s.yield_waits==1U);
+    w.restart();
+    CHECK(s.yield_waits==1U);
+    CHECK(s.spin_waits==0U);
+    w.pause();
+  }
+  CHECK(s.spin_waits==1U);
+  CHECK(s.yield_waits==1U);
+  CHECK(s.sleep_waits==0U);
+}
+
+TEST_CASE( "Unit-tests/adaptive_wait/0030/no spin or yield stages"
+         , "A policy with no spinning or yielding sleeps on the first pause"
+         )
+{
+  wait_policy p(0U, 0U, std::chrono::nanoseconds(1000));
+  wait_stats s;
+  {
+    adaptive_wait w(p, s);
+    w.pause();
+  }
+  CHECK(s.sleep_waits==1U);
+  CHECK(s.spin_waits==0U);
+  CHECK(s.yield_waits==0U);
+}
+
+TEST_CASE( "Unit-tests/adaptive_wait/0030/interrupt waits"
+         , "After spinning a policy with an interrupt enables and waits on the "
+           "interrupt, for at most the sleep time, in place of yielding and "
+           "sleeping"
+         )
+{
+// One end of a socket pair stands in for a UIO device
+  int fds[2];
+  REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds)==0);
+  irq_event irq{fds[0]};
+  wait_policy p(1U, 100U, std::chrono::milliseconds(2), &irq);
+  wait_stats s;
+  std::uint32_t value{0U};
+  {
+    adaptive_wait w(p, s);
+    w.pause(); // spin
+    w.pause(); // interrupt wait, times out
+    REQUIRE(::read(fds[1], &value, sizeof(value))==sizeof(value));
+    CHECK(value==1U); // interrupt enabled
+    CHECK(irq.interrupts()==0U);
+    value = 7U;
+    REQUIRE(::write(fds[1], &value, sizeof(value))==sizeof(value));
+    w.pause(); // interrupt wait, interrupt fires
+    CHECK(irq.interrupts()==1U);
+  }
+  CHECK(s.interrupt_waits==1U);
+  CHECK(s.yield_waits==0U);
+  CHECK(s.sleep_waits==0U);
+  ::close(fds[1]);
+}
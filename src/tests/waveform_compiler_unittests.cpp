@@ -0,0 +1,109 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file waveform_compiler_unittests.cpp
+/// @brief Unit tests for compiling waveform steps into DMA control blocks.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "waveform_compiler.h"
+#include <cstring>
+#include <cstdint>
+
+using namespace dibase::rpi::peripherals::internal;
+
+typedef std::uint32_t RegisterType;
+
+namespace
+{
+  RegisterType const region_bus{0xC0100000U};
+  RegisterType const gpset0_bus{0x7E20001CU};
+  RegisterType const gpclr0_bus{0x7E200028U};
+  RegisterType const pwm_fifo_bus{0x7E20C018U};
+
+  struct alignas(32) region_type
+  {
+    unsigned char bytes[512];
+  };
+}
+
+TEST_CASE( "Unit-tests/waveform_compiler/0000/empty waveform fails"
+         , "Compiling waveform steps that produce no control blocks throws"
+         )
+{
+  region_type region;
+  std::vector<waveform_bank_step> steps;
+  REQUIRE_THROWS_AS(compile_waveform(steps, false, &region, region_bus)
+                   , std::invalid_argument);
+  steps.push_back(waveform_bank_step{{0U,0U},{0U,0U},0U});
+  REQUIRE_THROWS_AS(compile_waveform(steps, false, &region, region_bus)
+                   , std::invalid_argument);
+  steps.push_back(waveform_bank_step{{1U,0U},{0U,0U},0x40000000U});
+  REQUIRE_THROWS_AS(compile_waveform(steps, false, &region, region_bus)
+                   , std::invalid_argument);
+}
+
+TEST_CASE( "Unit-tests/waveform_compiler/0010/compile one shot waveform"
+         , "Set, clear and delay control blocks chained in order and ended"
+         )
+{
+  std::vector<waveform_bank_step> steps
+    { waveform_bank_step{{0x10U,0x2U},{0x0U,0x0U},5U}
+    , waveform_bank_step{{0x0U,0x0U},{0x10U,0x0U},0U}
+    , waveform_bank_step{{0x0U,0x0U},{0x0U,0x0U},7U}
+    };
+  // 4 CBs of 32 bytes + (3*4+1) data words rounded up to 32 byte multiple
+  REQUIRE(compiled_waveform_size(steps)==4U*32U+64U);
+  region_type region;
+  std::memset(&region, 0xFF, sizeof(region));
+  REQUIRE(compile_waveform(steps, false, &region, region_bus)==4U);
+  dma_control_block const * cbs
+                  {reinterpret_cast<dma_control_block const *>(&region)};
+  RegisterType const * data{reinterpret_cast<RegisterType const *>(cbs+4)};
+  RegisterType const data_bus{region_bus+4U*32U};
+  RegisterType const write_ti{0x04000118U};
+  RegisterType const delay_ti{0x04050048U};
+
+  CHECK(cbs[0].transfer_info==write_ti);
+  CHECK(cbs[0].source_address==data_bus);
+  CHECK(cbs[0].dest_address==gpset0_bus);
+  CHECK(cbs[0].transfer_length==8U);
+  CHECK(cbs[0].next_control_block==region_bus+32U);
+  CHECK(data[0]==0x10U);
+  CHECK(data[1]==0x2U);
+
+  CHECK(cbs[1].transfer_info==delay_ti);
+  CHECK(cbs[1].source_address==data_bus+12U*4U);
+  CHECK(cbs[1].dest_address==pwm_fifo_bus);
+  CHECK(cbs[1].transfer_length==5U*4U);
+  CHECK(cbs[1].next_control_block==region_bus+64U);
+
+  CHECK(cbs[2].transfer_info==write_ti);
+  CHECK(cbs[2].source_address==data_bus+6U*4U);
+  CHECK(cbs[2].dest_address==gpclr0_bus);
+  CHECK(cbs[2].transfer_length==8U);
+  CHECK(data[6]==0x10U);
+  CHECK(data[7]==0x0U);
+
+  CHECK(cbs[3].transfer_info==delay_ti);
+  CHECK(cbs[3].transfer_length==7U*4U);
+  CHECK(cbs[3].next_control_block==0U);
+  CHECK(cbs[3].stride==0U);
+  CHECK(cbs[3].reserved_do_not_use[0]==0U);
+}
+
+TEST_CASE( "Unit-tests/waveform_compiler/0020/compile repeating waveform"
+         , "Last control block of a repeating waveform chains to the first"
+         )
+{
+  std::vector<waveform_bank_step> steps
+    { waveform_bank_step{{0x1U,0x0U},{0x0U,0x0U},10U}
+    , waveform_bank_step{{0x0U,0x0U},{0x1U,0x0U},10U}
+    };
+  region_type region;
+  REQUIRE(compile_waveform(steps, true, &region, region_bus)==4U);
+  dma_control_block const * cbs
+                  {reinterpret_cast<dma_control_block const *>(&region)};
+  CHECK(cbs[3].next_control_block==region_bus);
+}
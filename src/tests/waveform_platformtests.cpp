@@ -0,0 +1,40 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file waveform_platformtests.cpp
+/// @brief System tests for DMA paced GPIO waveform type.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+#include "waveform.h"
+#include "periexcept.h"
+#include <thread>
+
+using namespace dibase::rpi::peripherals;
+
+static pin_id const waveform_pin_id_0{17}; // P1 pin GPIO_GEN0
+static pin_id const waveform_pin_id_1{18}; // P1 pin GPIO_GEN1
+
+TEST_CASE( "Platform_tests/waveform/000/bad steps fail"
+         , "Creating a waveform with masks for pins not in the group or no "
+           "steps throws"
+         )
+{
+  opin_group pins{waveform_pin_id_0, waveform_pin_id_1};
+  REQUIRE_THROWS_AS((waveform{pins, {{0x4U, 0x0U, 1U}}}), std::invalid_argument);
+  REQUIRE_THROWS_AS((waveform{pins, {}}), std::invalid_argument);
+}
+
+TEST_CASE( "Platform_tests/waveform/010/play one shot waveform"
+         , "A one shot waveform plays to completion then stops"
+         )
+{
+  opin_group pins{waveform_pin_id_0, waveform_pin_id_1};
+  waveform wave{pins, {{0x3U, 0x0U, 100U}, {0x0U, 0x3U, 100U}}};
+  REQUIRE_THROWS_AS((waveform{pins, {{0x1U, 0x0U, 1U}}}), peripheral_in_use);
+  CHECK_FALSE(wave.is_playing());
+  wave.start();
+  CHECK(wave.is_playing());
+  std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  CHECK_FALSE(wave.is_playing());
+}
@@ -0,0 +1,58 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file ws2812_encoder_unittests.cpp
+/// @brief Unit tests for encoding WS2812 pixels as PWM serialiser patterns.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "ws2812_encoder.h"
+#include <cstdint>
+
+using namespace dibase::rpi::peripherals::internal;
+
+static_assert( ws2812_frame_words(1U)==3U+ws2812_reset_words
+            && ws2812_frame_words(4U)==9U+ws2812_reset_words
+            && ws2812_frame_words(5U)==12U+ws2812_reset_words
+             , "Unexpected ws2812_frame_words value"
+             );
+
+TEST_CASE( "Unit-tests/ws2812_encoder/0000/encode pixel 0"
+         , "Colours are encoded green, red, blue MSB first as 100 for 0 bits "
+           "and 110 for 1 bits"
+         )
+{
+  std::uint32_t words[3]{0U, 0U, 0U};
+  ws2812_encode_pixel(words, 0U, 0x000000U);
+  CHECK(words[0]==0x92492492U);
+  CHECK(words[1]==0x49249249U);
+  CHECK(words[2]==0x24000000U);
+  ws2812_encode_pixel(words, 0U, 0xFFFFFFU);
+  CHECK(words[0]==0xDB6DB6DBU);
+  CHECK(words[1]==0x6DB6DB6DU);
+  CHECK(words[2]==0xB6000000U);
+// Green 0x80 first: one 1 bit then 23 0 bits
+  ws2812_encode_pixel(words, 0U, 0x008000U);
+  CHECK(words[0]==0xD2492492U);
+  CHECK(words[1]==0x49249249U);
+  CHECK(words[2]==0x24000000U);
+// Blue 0x01 last: 23 0 bits then one 1 bit
+  ws2812_encode_pixel(words, 0U, 0x000001U);
+  CHECK(words[0]==0x92492492U);
+  CHECK(words[2]==0x26000000U);
+}
+
+TEST_CASE( "Unit-tests/ws2812_encoder/0010/encode pixel 1"
+         , "Re-encoding a pixel leaves neighbouring pixels' bits unchanged"
+         )
+{
+  std::uint32_t words[6]{0U, 0U, 0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU, 0U};
+  ws2812_encode_pixel(words, 1U, 0x000000U);
+  CHECK(words[0]==0U);
+  CHECK(words[1]==0U);
+  CHECK(words[2]==0xFF924924U);
+  CHECK(words[3]==0x92492492U);
+  CHECK(words[4]==0x4924FFFFU);
+  CHECK(words[5]==0U);
+}
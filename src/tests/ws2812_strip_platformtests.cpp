@@ -0,0 +1,55 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file ws2812_strip_platformtests.cpp
+/// @brief Platform tests for ws2812_strip.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "catch.hpp"
+
+#include "ws2812_strip.h"
+#include "pwm_ctrl.h"
+#include "periexcept.h"
+
+using namespace dibase::rpi::peripherals;
+using namespace dibase::rpi::peripherals::internal;
+
+TEST_CASE( "Platform-tests/ws2812_strip/0000/create & destroy"
+         , "Creating a ws2812_strip reserves the PWM channel and FIFO with "
+           "all pixels off; destroying it releases them"
+         )
+{
+  {
+    ws2812_strip strip{pin_id{18}, 100U}; // GPIO18, PWM0, ALT5
+    CHECK(strip.size()==100U);
+    CHECK(strip.get(99U)==0U);
+    CHECK_FALSE(strip.is_busy());
+    CHECK(pwm_ctrl::instance().alloc.is_in_use(0));
+    CHECK(pwm_ctrl::instance().fifo_alloc.is_in_use(0));
+    CHECK(pwm_ctrl::instance().regs->get_mode(pwm_channel::pwm_ch1)
+                                                      ==pwm_mode::serialiser);
+    CHECK_THROWS_AS(strip.get(100U), std::out_of_range);
+    CHECK_THROWS_AS(strip.set(100U, 0U), std::out_of_range);
+    CHECK_THROWS_AS(ws2812_strip(pin_id{19}, 1U), peripheral_in_use);
+  }
+  CHECK_FALSE(pwm_ctrl::instance().alloc.is_in_use(0));
+  CHECK_FALSE(pwm_ctrl::instance().fifo_alloc.is_in_use(0));
+  CHECK_THROWS_AS(ws2812_strip(pin_id{18}, 0U), std::invalid_argument);
+  CHECK_THROWS_AS(ws2812_strip(pin_id{17}, 1U), std::invalid_argument);
+}
+
+TEST_CASE( "Platform-tests/ws2812_strip/0010/show frames"
+         , "Showing frames sends them by DMA and set colours are kept"
+         )
+{
+  ws2812_strip strip{pin_id{18}, 1000U}; // GPIO18, PWM0, ALT5
+  strip.fill(0x102030U);
+  CHECK(strip.get(500U)==0x102030U);
+  strip.show();
+  CHECK(strip.is_busy());
+  strip.set(0U, 0xFF0000U);
+  CHECK(strip.get(0U)==0xFF0000U);
+  strip.show();
+  strip.wait();
+  CHECK_FALSE(strip.is_busy());
+}
@@ -0,0 +1,107 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file trace_marker.cpp
+/// @brief \b Internal : ftrace trace_marker hooks : implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "trace_marker.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      namespace
+      {
+        constexpr std::size_t max_record_size{128U};
+
+        int open_trace_marker()
+        {
+          int fd{::open("/sys/kernel/tracing/trace_marker"
+                       , O_WRONLY|O_CLOEXEC
+                       )};
+          if (fd==-1)
+            {
+              fd = ::open("/sys/kernel/debug/tracing/trace_marker"
+                         , O_WRONLY|O_CLOEXEC
+                         );
+            }
+          return fd;
+        }
+
+        int trace_marker_fd()
+        {
+          static int const fd{open_trace_marker()};
+          return fd;
+        }
+
+        std::size_t clamp_length(int rv, std::size_t size)
+        {
+          if (rv<0 || size==0U)
+            {
+              return 0U;
+            }
+          return static_cast<std::size_t>(rv)<size
+               ? static_cast<std::size_t>(rv) : size-1U;
+        }
+
+        void write_record(char const * record, std::size_t length)
+        { // Tracing is best effort: a failed write is not an error
+          if (length!=0U)
+            {
+              ssize_t const rv{::write(trace_marker_fd(), record, length)};
+              static_cast<void>(rv);
+            }
+        }
+      }
+
+      std::size_t format_trace_begin
+      ( char * buffer
+      , std::size_t size
+      , int pid
+      , char const * name
+      )
+      {
+        return clamp_length( std::snprintf( buffer, size, "B|%d|rpi:%s"
+                                          , pid, name
+                                          )
+                           , size
+                           );
+      }
+
+      std::size_t format_trace_end(char * buffer, std::size_t size, int pid)
+      {
+        return clamp_length(std::snprintf(buffer, size, "E|%d", pid), size);
+      }
+
+      void trace_begin(char const * name)
+      {
+        if (trace_marker_fd()==-1)
+          {
+            return;
+          }
+        char record[max_record_size];
+        write_record( record
+                    , format_trace_begin( record, sizeof(record)
+                                        , ::getpid(), name
+                                        )
+                    );
+      }
+
+      void trace_end()
+      {
+        if (trace_marker_fd()==-1)
+          {
+            return;
+          }
+        char record[max_record_size];
+        write_record( record
+                    , format_trace_end(record, sizeof(record), ::getpid())
+                    );
+      }
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
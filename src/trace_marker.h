@@ -0,0 +1,94 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file trace_marker.h
+/// @brief \b Internal : ftrace trace_marker hooks : type and function
+/// declarations.
+///
+/// If DIBASE_RPI_PERIPHERALS_TRACE is defined when building the library,
+/// waits for edge events, SPI0 and I2C transfers and waits for DMA
+/// completions write begin and end records to the kernel's ftrace
+/// trace_marker file, so they appear in a kernel trace (from trace-cmd,
+/// perf or Perfetto, for example) alongside the scheduling and interrupt
+/// events around them. Records use the "B|pid|name" and "E|pid" forms that
+/// trace viewers show as spans of the thread writing them.
+///
+/// The trace_marker file is opened on first use. If it cannot be opened -
+/// tracefs not mounted or no permission to write to it - nothing is
+/// written. Writing a record is one write system call, so is not free even
+/// when tracing is off. If DIBASE_RPI_PERIPHERALS_TRACE is not defined
+/// trace_scope objects are empty and do nothing.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_TRACE_MARKER_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_TRACE_MARKER_H
+
+# include <cstddef>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Format a trace_marker begin record.
+    /// @param[out] buffer  Buffer to format into.
+    /// @param[in]  size    Size of buffer in bytes.
+    /// @param[in]  pid     Id of the process writing the record.
+    /// @param[in]  name    Name of the span begun.
+    /// @returns Length of the record, truncated to fit buffer.
+      std::size_t format_trace_begin
+      ( char * buffer
+      , std::size_t size
+      , int pid
+      , char const * name
+      );
+
+    /// @brief Format a trace_marker end record.
+    /// @param[out] buffer  Buffer to format into.
+    /// @param[in]  size    Size of buffer in bytes.
+    /// @param[in]  pid     Id of the process writing the record.
+    /// @returns Length of the record, truncated to fit buffer.
+      std::size_t format_trace_end(char * buffer, std::size_t size, int pid);
+
+    /// @brief Write a begin record to trace_marker if it can be opened.
+    /// @param[in]  name    Name of the span begun.
+      void trace_begin(char const * name);
+
+    /// @brief Write an end record to trace_marker if it can be opened.
+      void trace_end();
+
+    /// @brief Scope traced as a trace_marker span if tracing is built in.
+# ifdef DIBASE_RPI_PERIPHERALS_TRACE
+      class trace_scope
+      {
+      public:
+      /// @brief Write a begin record.
+      /// @param[in]  name    Name of the span, a string literal.
+        explicit trace_scope(char const * name)
+        {
+          trace_begin(name);
+        }
+
+      /// @brief Write the matching end record.
+        ~trace_scope()
+        {
+          trace_end();
+        }
+
+        trace_scope(trace_scope const &) = delete;
+        trace_scope & operator=(trace_scope const &) = delete;
+      };
+# else
+      class trace_scope
+      {
+      public:
+        explicit trace_scope(char const *)
+        {}
+
+        trace_scope(trace_scope const &) = delete;
+        trace_scope & operator=(trace_scope const &) = delete;
+      };
+# endif
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_TRACE_MARKER_H
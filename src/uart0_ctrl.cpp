@@ -0,0 +1,29 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file uart0_ctrl.cpp
+/// @brief Internal UART0 control type implantation and definition.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "uart0_ctrl.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      uart0_ctrl::uart0_ctrl()
+      : regs( peripheral_window::instance()
+            , uart0_registers::physical_address
+            , register_block_size
+            )
+      , allocated(false)
+      {}
+
+      uart0_ctrl & uart0_ctrl::instance()
+      {
+        static uart0_ctrl uart0_control_area;
+        return uart0_control_area;
+      }
+    }
+  }
+}}
@@ -0,0 +1,49 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file uart0_ctrl.h
+/// @brief \b Internal : UART0 control type & supporting definitions.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_UART0_CTRL_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_UART0_CTRL_H
+
+# include "phymem_ptr.h"
+# include "uart0_registers.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief UART0 control type. There is only 1 (yes it's a singleton!)
+    ///
+    /// Maps BCM2708 / 2835 UART0 registers into the requisite physical memory
+    /// mapped area and provides a simple allocated flag for in-process UART0
+    /// use tracking.
+    ///
+    /// Note that this is the PL011 UART0 only; the auxiliary mini UART (UART1)
+    /// is controlled through the auxiliary peripheral registers.
+      struct uart0_ctrl
+      {
+      /// @brief Pointer to BCM2708 / BCM2835 UART0 control registers instance
+        phymem_ptr<volatile uart0_registers>        regs;
+
+      /// @brief UART0 channel allocation flag
+        bool  allocated;
+
+      /// @brief Singleton instance getter
+      /// @returns \e The instance of the UART0 control object.
+        static uart0_ctrl & instance();
+
+      private:
+        uart0_ctrl();
+
+        uart0_ctrl(uart0_ctrl const &) = delete;
+        uart0_ctrl(uart0_ctrl &&) = delete;
+        uart0_ctrl & operator=(uart0_ctrl const &) = delete;
+        uart0_ctrl & operator=(uart0_ctrl &&) = delete;
+      };
+   } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_UART0_CTRL_H
@@ -0,0 +1,128 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file uart0_dma_rx.cpp
+/// @brief DMA receive ring buffer for UART0 implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "uart0_dma_rx.h"
+#include "uart0_ctrl.h"
+#include "dma_ctrl.h"
+#include "dma_arena.h"
+#include <cstddef>
+#include <stdexcept>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using namespace internal;
+
+    namespace
+    {
+      register_t const uart0_data_bus_address
+                { peripheral_bus_address(uart0_registers::physical_address)
+                + static_cast<register_t>(offsetof(uart0_registers, data))
+                };
+    }
+
+    constexpr std::size_t uart0_dma_rx::default_ring_size;
+
+    uart0_dma_rx::uart0_dma_rx(uart0_pins & pins, std::size_t size)
+    : uart(pins)
+    , ring{nullptr}
+    , ring_size{size}
+    , ring_bus{0U}
+    , dma_channel{0U}
+    , tail{0U}
+    {
+      if (size==0U)
+        {
+          throw std::invalid_argument{"uart0_dma_rx::uart0_dma_rx: ring has "
+                                      "no entries."};
+        }
+      std::size_t const ring_bytes{size*sizeof(register_t)};
+      memory.reset(new dma_arena{ring_bytes+sizeof(dma_control_block)});
+      dma_control_block * cb{memory->allocate_control_blocks(1U)};
+      dma_buffer const ring_buffer{memory->allocate(ring_bytes)};
+      register_t * entries{static_cast<register_t *>(ring_buffer.address)};
+      for (std::size_t idx=0; idx!=size; ++idx)
+        {
+          entries[idx] = 0U;
+        }
+      ring = entries;
+      ring_bus = ring_buffer.bus_address;
+    // One control block linked to itself: the destination restarts at the
+    // ring's first entry each time the block is reloaded
+      cb->transfer_info = dma_control_block::ti_no_wide_bursts
+                        | dma_control_block::ti_wait_resp
+                        | dma_control_block::ti_src_dreq
+                        | dma_control_block::ti_dest_inc
+                        | dma_control_block::ti_permap(dma_dreq::uart_rx);
+      cb->source_address = uart0_data_bus_address;
+      cb->dest_address = ring_bus;
+      cb->transfer_length = static_cast<register_t>(ring_bytes);
+      cb->stride = 0U;
+      cb->next_control_block = memory->bus_address(cb);
+      cb->reserved_do_not_use[0] = 0U;
+      cb->reserved_do_not_use[1] = 0U;
+      dma_channel = dma_ctrl::instance().allocate_channel();
+      volatile dma_channel_registers &
+                          dma(dma_ctrl::instance().regs->channel[dma_channel]);
+      dma.reset();
+      dma.start(memory->bus_address(cb));
+      uart0_ctrl::instance().regs->set_rx_dma_enable(true);
+    }
+
+    uart0_dma_rx::~uart0_dma_rx()
+    {
+      uart0_ctrl::instance().regs->set_rx_dma_enable(false);
+      dma_ctrl::instance().deallocate_channel(dma_channel);
+    }
+
+    std::size_t uart0_dma_rx::head() const
+    {
+      register_t const dest
+              {dma_ctrl::instance().regs->channel[dma_channel].dest_address};
+      if (dest<ring_bus)
+        { // Control block not yet loaded
+          return 0U;
+        }
+      return ((dest-ring_bus)/sizeof(register_t))%ring_size;
+    }
+
+    std::size_t uart0_dma_rx::available() const
+    {
+      return (head()+ring_size-tail)%ring_size;
+    }
+
+    std::size_t uart0_dma_rx::read(std::uint8_t * pdata, std::size_t count)
+    {
+      std::size_t const pos{head()};
+      std::size_t n{0U};
+      while (tail!=pos && n!=count)
+        {
+          register_t const entry{ring[tail]};
+          tail = (tail+1U)%ring_size;
+          if (entry&uart0_registers::dr_overrun_error)
+            {
+              ++errors.overruns;
+            }
+          if (entry&uart0_registers::dr_break_error)
+            {
+              ++errors.breaks;
+              continue;
+            }
+          if (entry&uart0_registers::dr_framing_error)
+            {
+              ++errors.framing;
+            }
+          if (entry&uart0_registers::dr_parity_error)
+            {
+              ++errors.parity;
+            }
+          pdata[n++] = static_cast<std::uint8_t>(entry);
+        }
+      return n;
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
@@ -0,0 +1,540 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file uart0_pins.cpp
+/// @brief Use a set of GPIO pins for use with UART0: implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "uart0_pins.h"
+#include "gpio_alt_fn.h"
+#include "gpio_ctrl.h"
+#include "uart0_ctrl.h"
+#include "periexcept.h"
+#include "trace_marker.h"
+#include <algorithm>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    using internal::uart0_ctrl;
+    using internal::uart0_registers;
+    using internal::uart0_fifo_level;
+    using internal::gpio_ctrl;
+    using internal::pin_alt_fn::gpio_special_fn;
+    using internal::gpio_pin_fn;
+
+    namespace
+    {
+    // Receive FIFO level at which the RX raw interrupt status is set and the
+    // number of entries it guarantees may be read without checking status.
+      constexpr uart0_fifo_level rx_fifo_level{uart0_fifo_level::half};
+      constexpr std::size_t rx_burst
+                    {uart0_registers::fifo_level_entries(rx_fifo_level)};
+      constexpr std::size_t tx_burst{uart0_registers::fifo_depth};
+
+    // Bit periods of receive line idle time that end a frame: as the UART0
+    // receive timeout.
+      constexpr unsigned frame_gap_bits{32U};
+
+      gpio_pin_fn get_alt_fn(pin_id pin, gpio_special_fn special_fn)
+      {
+        using internal::pin_alt_fn::result_set;
+        using internal::pin_alt_fn::select;
+        auto pin_fn_info( select(pin,special_fn) );
+        if (pin_fn_info.empty())
+          {
+            throw std::invalid_argument
+                  { "uart0_pins::uart0_pins: Pin does not support "
+                    "requested UART0 special function."
+                  };
+          }
+        if (pin_fn_info.size()!=1)
+          {
+            throw std::range_error // NO pin has >1 UART0 function
+                  {"uart0_pins::uart0_pins: Internal data error: more than one "
+                   "pin alt function selected that supports the requested "
+                   "UART0 special function."
+                  };
+          }
+        return pin_fn_info[0].alt_fn();
+      }
+
+      void apply_line_settings
+      ( std::uint32_t ibrd
+      , std::uint32_t fbrd
+      , std::uint32_t lcrh
+      )
+      {
+        auto & regs(uart0_ctrl::instance().regs);
+        regs->set_baud_divisors(ibrd, fbrd);
+      // LCRH write latches the divisors so must be last
+        regs->line_control = lcrh;
+      }
+    }
+
+    constexpr auto txd_idx(0U);
+    constexpr auto rxd_idx(1U);
+    constexpr auto cts_idx(2U);
+    constexpr auto rts_idx(3U);
+
+    uart0_line_settings::uart0_line_settings
+    ( hertz           baud
+    , unsigned        data_bits
+    , uart0_parity    parity
+    , uart0_stop_bits stop
+    , hertz           fc
+    )
+    : ibrd_reg{0U}
+    , fbrd_reg{0U}
+    , lcrh_reg{uart0_registers::lcrh_fifo_enable}
+    , clock{fc}
+    {
+      if (data_bits<5U || data_bits>8U)
+        {
+          throw std::invalid_argument{"uart0_line_settings: data bits not in "
+                                      "the range [5,8]."};
+        }
+      if (baud.count()==0U)
+        {
+          throw std::out_of_range{"uart0_line_settings: baud rate is zero."};
+        }
+    // Divisor is fc/(16*baud) in 64ths, rounded to nearest
+      std::uint64_t const divisor
+              {(std::uint64_t{fc.count()}*8U/baud.count()+1U)/2U};
+      ibrd_reg = static_cast<std::uint32_t>
+                                  (divisor>>uart0_registers::fbrd_bits);
+      fbrd_reg = static_cast<std::uint32_t>
+                                  (divisor&uart0_registers::fbrd_mask);
+      if ( ibrd_reg==0U || divisor>(std::uint64_t{uart0_registers::ibrd_max}
+                                    <<uart0_registers::fbrd_bits)
+         )
+        {
+          throw std::out_of_range{"uart0_line_settings: baud rate not in the "
+                                  "range [fc/(16*65535), fc/16]."};
+        }
+      lcrh_reg |= (data_bits-5U)<<uart0_registers::lcrh_word_length_bit;
+      switch (parity)
+        {
+        case uart0_parity::none:
+          break;
+        case uart0_parity::odd:
+          lcrh_reg |= uart0_registers::lcrh_parity_enable;
+          break;
+        case uart0_parity::even:
+          lcrh_reg |= uart0_registers::lcrh_parity_enable
+                    | uart0_registers::lcrh_even_parity;
+          break;
+        case uart0_parity::mark:
+          lcrh_reg |= uart0_registers::lcrh_parity_enable
+                    | uart0_registers::lcrh_stick_parity;
+          break;
+        case uart0_parity::space:
+          lcrh_reg |= uart0_registers::lcrh_parity_enable
+                    | uart0_registers::lcrh_even_parity
+                    | uart0_registers::lcrh_stick_parity;
+          break;
+        default:
+          throw std::invalid_argument{"uart0_line_settings: invalid parity."};
+        }
+      if (stop==uart0_stop_bits::two)
+        {
+          lcrh_reg |= uart0_registers::lcrh_two_stop_bits;
+        }
+    }
+
+    f_hertz uart0_line_settings::actual_baud() const
+    {
+      return f_hertz{ 4.0*clock.count()
+                    / ((ibrd_reg<<uart0_registers::fbrd_bits)+fbrd_reg)
+                    };
+    }
+
+    unsigned uart0_line_settings::character_bits() const
+    {
+      return 1U
+           + ((lcrh_reg&uart0_registers::lcrh_word_length_mask)
+              >>uart0_registers::lcrh_word_length_bit) + 5U
+           + ((lcrh_reg&uart0_registers::lcrh_parity_enable) ? 1U : 0U)
+           + ((lcrh_reg&uart0_registers::lcrh_two_stop_bits) ? 2U : 1U);
+    }
+
+    bool uart0_pins::is_busy() const
+    {
+      return uart0_ctrl::instance().regs->get_busy();
+    }
+
+    bool uart0_pins::write_fifo_has_space() const
+    {
+      return !uart0_ctrl::instance().regs->get_tx_fifo_full();
+    }
+
+    bool uart0_pins::read_fifo_has_data() const
+    {
+      return !uart0_ctrl::instance().regs->get_rx_fifo_empty();
+    }
+
+    uart0_pins::~uart0_pins()
+    {
+      uart0_ctrl::instance().regs->set_enable(false);
+      for (auto pin : pins)
+        {
+          if (pin!=uart0_pin_not_used)
+            {
+              gpio_ctrl::instance().alloc.deallocate(pin_id(pin));
+            }
+        }
+      uart0_ctrl::instance().allocated = false;
+    }
+
+    void uart0_pins::construct
+    ( pin_id txd
+    , pin_id rxd
+    , pin_id cts
+    , pin_id rts
+    )
+    {
+      pins.fill(uart0_pin_not_used);
+      bool const use_cts(cts!=uart0_pin_not_used);
+      bool const use_rts(rts!=uart0_pin_not_used);
+    // Get each pin's alt function for its UART0 special function.
+    // Note: any of these can throw - but nothing allocated yet so OK
+      gpio_pin_fn alt_fn[number_of_pins]{};
+      alt_fn[txd_idx] = get_alt_fn(txd, gpio_special_fn::txd0);
+      alt_fn[rxd_idx] = get_alt_fn(rxd, gpio_special_fn::rxd0);
+      if (use_cts)
+        {
+          alt_fn[cts_idx] = get_alt_fn(cts, gpio_special_fn::cts0);
+        }
+      if (use_rts)
+        {
+          alt_fn[rts_idx] = get_alt_fn(rts, gpio_special_fn::rts0);
+        }
+    // Only one UART0 peripheral so can check whether it is in use before
+    // starting on pin allocations
+      if ( uart0_ctrl::instance().allocated )
+        {
+          throw bad_peripheral_alloc( "uart0_pins::uart0_pins: UART0 is "
+                                      "already being used locally."
+                                    );
+        }
+
+    // Speculatively allocate UART0 peripheral
+      uart0_ctrl::instance().allocated = true;
+
+      pin_id const requested[number_of_pins]{txd, rxd, cts, rts};
+      try
+      {
+        for (unsigned idx=0U; idx!=number_of_pins; ++idx)
+          {
+            if (requested[idx]!=uart0_pin_not_used)
+              {
+                gpio_ctrl::instance().alloc.allocate(requested[idx]);//CAN THROW
+                pins[idx] = requested[idx];
+              }
+          }
+      }
+      catch (...)
+      { // Oops - failed to complete resource acquisition and initialisation;
+      // Release resources allocated so far and re-throw
+        for (auto pin : pins)
+          {
+            if (pin!=uart0_pin_not_used)
+              {
+                gpio_ctrl::instance().alloc.deallocate(pin_id(pin));
+              }
+          }
+        uart0_ctrl::instance().allocated = false;
+        throw;
+      }
+
+      auto & regs(uart0_ctrl::instance().regs);
+      regs->set_enable(false);
+      regs->dma_control = 0U;
+      regs->interrupt_mask = 0U;
+      regs->clear_interrupts(uart0_registers::int_all_mask);
+      apply_line_settings( settings.ibrd_reg, settings.fbrd_reg
+                         , settings.lcrh_reg
+                         );
+      regs->set_fifo_levels(rx_fifo_level, uart0_fifo_level::eighth);
+      regs->set_flow_control(use_rts, use_cts);
+
+      internal::gpio_pin_fn_setting pin_fns[number_of_pins]
+      { {txd, alt_fn[txd_idx]}
+      , {rxd, alt_fn[rxd_idx]}
+      , {cts, alt_fn[cts_idx]}
+      , {rts, alt_fn[rts_idx]}
+      };
+      auto const pin_fns_end
+        (std::remove_if( pin_fns, pin_fns+number_of_pins
+                       , [](internal::gpio_pin_fn_setting const & setting)
+                         { return setting.pin==uart0_pin_not_used; }
+                       ));
+      gpio_ctrl::instance().config.set_pin_functions
+                                                        (pin_fns, pin_fns_end);
+      regs->set_enable(true);
+    }
+
+    void uart0_pins::set_line_settings(uart0_line_settings const & ls)
+    {
+      drain();
+      auto & regs(uart0_ctrl::instance().regs);
+      regs->set_enable(false);
+    // Clearing FEN flushes the FIFOs
+      regs->set_fifo_enable(false);
+      settings = ls;
+      apply_line_settings( settings.ibrd_reg, settings.fbrd_reg
+                         , settings.lcrh_reg
+                         );
+      regs->set_enable(true);
+    }
+
+    bool uart0_pins::receive_entry(std::uint32_t entry)
+    {
+      if (entry&uart0_registers::dr_overrun_error)
+        {
+          ++errors.overruns;
+        }
+    // A break also shows as a framing error on a zero data entry
+      if (entry&uart0_registers::dr_break_error)
+        {
+          ++errors.breaks;
+          return false;
+        }
+      if (entry&uart0_registers::dr_framing_error)
+        {
+          ++errors.framing;
+        }
+      if (entry&uart0_registers::dr_parity_error)
+        {
+          ++errors.parity;
+        }
+      return true;
+    }
+
+    bool uart0_pins::write(std::uint8_t data)
+    {
+      auto & regs(uart0_ctrl::instance().regs);
+      if (regs->get_tx_fifo_full())
+        {
+          counters.count(io_event::tx_fifo_full);
+          return false;
+        }
+      regs->transmit(data);
+      counters.count(io_event::bytes_written);
+      return true;
+    }
+
+    std::size_t uart0_pins::write(std::uint8_t const * pdata, std::size_t count)
+    {
+      auto & regs(uart0_ctrl::instance().regs);
+      std::size_t n{0U};
+      if (regs->get_tx_fifo_empty())
+        {
+          std::size_t const burst{std::min(count, tx_burst)};
+          for (; n!=burst; ++n)
+            {
+              regs->transmit(pdata[n]);
+            }
+        }
+      while (n!=count && !regs->get_tx_fifo_full())
+        {
+          regs->transmit(pdata[n]);
+          ++n;
+        }
+      if (n!=count)
+        {
+          counters.count(io_event::tx_fifo_full);
+        }
+      counters.count(io_event::bytes_written, n);
+      return n;
+    }
+
+    std::size_t uart0_pins::write_all
+    ( std::uint8_t const * pdata
+    , std::size_t count
+    )
+    {
+      internal::trace_scope trace{"uart0_pins write_all"};
+      std::size_t n{0U};
+      adaptive_wait waiter(waiting, wait_counts);
+      while (n!=count)
+        {
+          std::size_t const written{write(pdata+n, count-n)};
+          if (written==0U)
+            {
+              counters.count(io_event::wait_polls);
+              waiter.pause();
+            }
+          else
+            {
+              n += written;
+              waiter.restart();
+            }
+        }
+      return n;
+    }
+
+    bool uart0_pins::read(std::uint8_t & data)
+    {
+      auto & regs(uart0_ctrl::instance().regs);
+      if (regs->get_rx_fifo_empty())
+        {
+          counters.count(io_event::rx_fifo_empty);
+          return false;
+        }
+      std::uint32_t const entry{regs->receive()};
+      if (!receive_entry(entry))
+        {
+          return false;
+        }
+      data = static_cast<std::uint8_t>(entry);
+      counters.count(io_event::bytes_read);
+      return true;
+    }
+
+    std::size_t uart0_pins::read(std::uint8_t * pdata, std::size_t count)
+    {
+      auto & regs(uart0_ctrl::instance().regs);
+      std::size_t n{0U};
+      while (n!=count)
+        {
+          if ( count-n>=rx_burst
+            && regs->get_raw_interrupt(uart0_registers::int_rx)
+             )
+            { // At least rx_burst entries in the receive FIFO
+              for (std::size_t entries=0U; entries!=rx_burst; ++entries)
+                {
+                  std::uint32_t const entry{regs->receive()};
+                  if (receive_entry(entry))
+                    {
+                      pdata[n++] = static_cast<std::uint8_t>(entry);
+                    }
+                }
+            }
+          else if (!regs->get_rx_fifo_empty())
+            {
+              std::uint32_t const entry{regs->receive()};
+              if (receive_entry(entry))
+                {
+                  pdata[n++] = static_cast<std::uint8_t>(entry);
+                }
+            }
+          else
+            {
+              counters.count(io_event::rx_fifo_empty);
+              break;
+            }
+        }
+      counters.count(io_event::bytes_read, n);
+      return n;
+    }
+
+    std::size_t uart0_pins::read_frame
+    ( std::uint8_t * pdata
+    , std::size_t count
+    , system_timer::duration timeout
+    )
+    {
+      internal::trace_scope trace{"uart0_pins read_frame"};
+      auto & regs(uart0_ctrl::instance().regs);
+      std::uint64_t const gap_us
+        {static_cast<std::uint64_t>
+                    (frame_gap_bits*1000000.0/settings.actual_baud().count())
+        +1U
+        };
+      std::uint64_t const deadline_us
+        { system_timer::now_us()
+        + static_cast<std::uint64_t>(std::max<system_timer::rep>
+                                                      (timeout.count(), 0))
+        };
+      std::uint64_t last_us{0U};
+      std::size_t n{0U};
+      bool ended{false};
+      auto take = [&](std::uint32_t entry)
+                  {
+                    if ((entry&uart0_registers::dr_break_error) && n!=0U)
+                      {
+                        ended = true;
+                      }
+                    if (receive_entry(entry))
+                      {
+                        pdata[n++] = static_cast<std::uint8_t>(entry);
+                      }
+                  };
+      adaptive_wait waiter(waiting, wait_counts);
+      while (n!=count && !ended)
+        {
+          bool const rx_level(regs->get_raw_interrupt(uart0_registers::int_rx));
+          bool const rx_timeout
+                    (regs->get_raw_interrupt(uart0_registers::int_rx_timeout));
+          if (rx_level && count-n>=rx_burst)
+            { // Burst read, leaving any tail for the receive timeout
+              for (std::size_t entries=0U; entries!=rx_burst && !ended;
+                   ++entries
+                  )
+                {
+                  take(regs->receive());
+                }
+              last_us = system_timer::now_us();
+              waiter.restart();
+            }
+          else if (rx_timeout || rx_level)
+            { // Line idle, or buffer nearly full: drain
+              while (n!=count && !ended && !regs->get_rx_fifo_empty())
+                {
+                  take(regs->receive());
+                }
+              regs->clear_interrupts(uart0_registers::int_rx_timeout);
+              ended = ended || (rx_timeout && n!=0U);
+              last_us = system_timer::now_us();
+              waiter.restart();
+            }
+          else if (n==0U)
+            {
+              if (system_timer::now_us()>=deadline_us)
+                {
+                  counters.count(io_event::timeouts);
+                  break;
+                }
+              counters.count(io_event::wait_polls);
+              waiter.pause();
+            }
+          else if ( regs->get_rx_fifo_empty()
+                 && system_timer::now_us()-last_us>=gap_us
+                  )
+            { // Frame filled the bursts exactly so no receive timeout
+              ended = true;
+            }
+          else
+            {
+              counters.count(io_event::wait_polls);
+              waiter.pause();
+            }
+        }
+      counters.count(io_event::bytes_read, n);
+      return n;
+    }
+
+    void uart0_pins::drain()
+    {
+      auto & regs(uart0_ctrl::instance().regs);
+      adaptive_wait waiter(waiting, wait_counts);
+      while (regs->get_busy())
+        {
+          counters.count(io_event::wait_polls);
+          waiter.pause();
+        }
+    }
+
+    void uart0_pins::send_break(system_timer::duration length)
+    {
+      drain();
+      auto & regs(uart0_ctrl::instance().regs);
+      regs->set_send_break(true);
+      system_timer::delay_us
+        (static_cast<std::uint32_t>(std::max<system_timer::rep>
+                                                        (length.count(), 0)));
+      regs->set_send_break(false);
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
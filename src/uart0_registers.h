@@ -0,0 +1,344 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file uart0_registers.h
+/// @brief \b Internal : low-level UART0 (PL011) control registers type
+/// definition.
+///
+/// The details here relate to the BCM2835 ARM PrimeCell PL011 UART known as
+/// UART0, and _not_ the auxiliary mini UART (UART1).
+///
+/// Refer to the
+/// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+/// Broadcom BCM2835 ARM Peripherals Datasheet</a> Chapter 13 UART for details
+/// along with the ARM PrimeCell UART (PL011) Technical Reference Manual.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_UART0_REGISTERS_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_UART0_REGISTERS_H
+
+# include "peridef.h"
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Enumerated FIFO level trigger points for the IFLS register
+    /// transmit and receive interrupt (and burst) level select fields.
+    enum class uart0_fifo_level : register_t
+    { eighth          = 0U  ///< FIFO 1/8 full
+    , quarter         = 1U  ///< FIFO 1/4 full
+    , half            = 2U  ///< FIFO 1/2 full
+    , three_quarters  = 3U  ///< FIFO 3/4 full
+    , seven_eighths   = 4U  ///< FIFO 7/8 full
+    };
+
+    /// @brief Represents layout of UART0 control registers with operations.
+    ///
+    /// Permits access to BCM2835 PL011 UART0 interface registers when an
+    /// instance is mapped to the correct physical memory location.
+    ///
+    /// See the
+    /// <a href="http://www.raspberrypi.org/wp-content/uploads/2012/02/BCM2835-ARM-Peripherals.pdf">
+    /// Broadcom BCM2835 ARM Peripherals Datasheet</a> chapter 13 for published
+    /// details. Note that the BCM2835 PL011 FIFOs are 16 entries deep, not the
+    /// 32 of later PL011 revisions, and that the IrDA, modem status (other
+    /// than CTS) and test registers are not used.
+    ///
+    /// Member function operations are provided to query and set the various
+    /// fields and flags used for UART0 control.
+      struct uart0_registers
+      {
+        enum : register_t
+        { dr_data_mask      = 0xffU   ///< DR register data field bit-mask
+        , dr_framing_error  = 1U<<8   ///< DR register framing error FE bit
+        , dr_parity_error   = 1U<<9   ///< DR register parity error PE bit
+        , dr_break_error    = 1U<<10  ///< DR register break error BE bit
+        , dr_overrun_error  = 1U<<11  ///< DR register overrun error OE bit
+        , dr_error_mask     = 0xf00U  ///< DR register error bits bit-mask
+        , fr_cts            = 1U<<0   ///< FR register clear to send CTS bit
+        , fr_busy           = 1U<<3   ///< FR register UART busy BUSY bit
+        , fr_rx_fifo_empty  = 1U<<4   ///< FR receive FIFO empty RXFE bit
+        , fr_tx_fifo_full   = 1U<<5   ///< FR transmit FIFO full TXFF bit
+        , fr_rx_fifo_full   = 1U<<6   ///< FR receive FIFO full RXFF bit
+        , fr_tx_fifo_empty  = 1U<<7   ///< FR transmit FIFO empty TXFE bit
+        , ibrd_max          = 0xffffU ///< Maximum IBRD integer divisor value
+        , fbrd_bits         = 6U      ///< Number of FBRD fraction bits
+        , fbrd_mask         = 0x3fU   ///< FBRD register fraction bit-mask
+        , lcrh_break        = 1U<<0   ///< LCRH register send break BRK bit
+        , lcrh_parity_enable= 1U<<1   ///< LCRH register parity enable PEN bit
+        , lcrh_even_parity  = 1U<<2   ///< LCRH register even parity EPS bit
+        , lcrh_two_stop_bits= 1U<<3   ///< LCRH register two stop bits STP2 bit
+        , lcrh_fifo_enable  = 1U<<4   ///< LCRH register FIFOs enable FEN bit
+        , lcrh_word_length_bit = 5U   ///< LCRH WLEN field bit number
+        , lcrh_word_length_mask= 3U<<5///< LCRH WLEN field bit-mask
+        , lcrh_stick_parity = 1U<<7   ///< LCRH register stick parity SPS bit
+        , cr_uart_enable    = 1U<<0   ///< CR register UART enable UARTEN bit
+        , cr_loop_back      = 1U<<7   ///< CR register loop back enable LBE bit
+        , cr_tx_enable      = 1U<<8   ///< CR register transmit enable TXE bit
+        , cr_rx_enable      = 1U<<9   ///< CR register receive enable RXE bit
+        , cr_rts            = 1U<<11  ///< CR register request to send RTS bit
+        , cr_rts_enable     = 1U<<14  ///< CR RTS flow control RTSEN bit
+        , cr_cts_enable     = 1U<<15  ///< CR CTS flow control CTSEN bit
+        , ifls_tx_mask      = 7U      ///< IFLS register TXIFLSEL bit-mask
+        , ifls_rx_bit       = 3U      ///< IFLS register RXIFLSEL bit number
+        , ifls_rx_mask      = 7U<<3   ///< IFLS register RXIFLSEL bit-mask
+        , int_rx            = 1U<<4   ///< Interrupt receive level RX bit
+        , int_tx            = 1U<<5   ///< Interrupt transmit level TX bit
+        , int_rx_timeout    = 1U<<6   ///< Interrupt receive timeout RT bit
+        , int_framing_error = 1U<<7   ///< Interrupt framing error FE bit
+        , int_parity_error  = 1U<<8   ///< Interrupt parity error PE bit
+        , int_break_error   = 1U<<9   ///< Interrupt break error BE bit
+        , int_overrun_error = 1U<<10  ///< Interrupt overrun error OE bit
+        , int_all_mask      = 0x7f2U  ///< All implemented interrupt bits
+        , dmacr_rx_enable   = 1U<<0   ///< DMACR register RXDMAE bit
+        , dmacr_tx_enable   = 1U<<1   ///< DMACR register TXDMAE bit
+        , dmacr_dma_on_error= 1U<<2   ///< DMACR register DMAONERR bit
+        , fifo_depth        = 16U     ///< Entries in each FIFO
+        };
+
+      /// @brief Physical address of start of BCM2835 UART0 control registers
+        constexpr static physical_address_t
+                            physical_address = peripheral_base_address+0x201000;
+
+        register_t  data;                   ///< Data Register, DR
+        register_t  receive_status;         ///< Receive Status, RSRECR
+        register_t  reserved_do_not_use_0[4];///< Reserved, unused
+        register_t  flags;                  ///< Flag register, FR
+        register_t  reserved_do_not_use_1;  ///< Reserved, currently unused
+        register_t  irda_low_power;         ///< Not in use, ILPR
+        register_t  integer_baud_divisor;   ///< Integer Baud rate divisor, IBRD
+        register_t  fractional_baud_divisor;///< Fractional divisor, FBRD
+        register_t  line_control;           ///< Line Control register, LCRH
+        register_t  control;                ///< Control register, CR
+        register_t  fifo_level_select;      ///< FIFO Level Select, IFLS
+        register_t  interrupt_mask;         ///< Interrupt Mask Set Clear, IMSC
+        register_t  raw_interrupt_status;   ///< Raw Interrupt Status, RIS
+        register_t  masked_interrupt_status;///< Masked Int. Status, MIS
+        register_t  interrupt_clear;        ///< Interrupt Clear, ICR
+        register_t  dma_control;            ///< DMA Control, DMACR
+        register_t  reserved_do_not_use_2[13];///< Reserved, unused
+        register_t  test_control;           ///< Test Control, ITCR
+        register_t  test_input;             ///< Integration test input, ITIP
+        register_t  test_output;            ///< Integration test output, ITOP
+        register_t  test_data;              ///< Test Data, TDR
+
+      /// @brief Write a byte to the transmit FIFO
+      /// @param[in] value  Byte to write
+        void transmit(std::uint8_t value) volatile
+        {
+          data = value;
+        }
+
+      /// @brief Read an entry from the receive FIFO
+      /// @returns Received byte in bits [7:0] and its error flags in bits
+      ///          [11:8] (dr_framing_error, dr_parity_error, dr_break_error,
+      ///          dr_overrun_error).
+        register_t receive() volatile
+        {
+          return data&(dr_data_mask|dr_error_mask);
+        }
+
+      /// @brief Return the UART busy (BUSY) flag value
+      /// @returns \c true while transmitting data, including the stop bits of
+      ///          the last byte, or the transmit FIFO is not empty.
+        bool get_busy() volatile const
+        {
+          return flags & fr_busy;
+        }
+
+      /// @brief Return the receive FIFO empty (RXFE) flag value
+        bool get_rx_fifo_empty() volatile const
+        {
+          return flags & fr_rx_fifo_empty;
+        }
+
+      /// @brief Return the receive FIFO full (RXFF) flag value
+        bool get_rx_fifo_full() volatile const
+        {
+          return flags & fr_rx_fifo_full;
+        }
+
+      /// @brief Return the transmit FIFO empty (TXFE) flag value
+        bool get_tx_fifo_empty() volatile const
+        {
+          return flags & fr_tx_fifo_empty;
+        }
+
+      /// @brief Return the transmit FIFO full (TXFF) flag value
+        bool get_tx_fifo_full() volatile const
+        {
+          return flags & fr_tx_fifo_full;
+        }
+
+      /// @brief Return the clear to send (CTS) flag value
+      /// @returns \c true if the CTS line is asserted (low).
+        bool get_clear_to_send() volatile const
+        {
+          return flags & fr_cts;
+        }
+
+      /// @brief Set the integer and fractional baud rate divisors
+      ///
+      /// The new divisors take effect when the LCRH register is next written.
+      ///
+      /// @param[in] ibrd   Integer part of the divisor [1,65535].
+      /// @param[in] fbrd   Fractional part of the divisor in 64ths [0,63]. Must
+      ///                   be 0 if ibrd is 65535.
+      /// @returns \c true if the values were in range and set, \c false if not.
+        bool set_baud_divisors(register_t ibrd, register_t fbrd) volatile
+        {
+          if ( ibrd==0U || ibrd>ibrd_max || fbrd>fbrd_mask
+            || (ibrd==ibrd_max && fbrd!=0U)
+             )
+            {
+              return false;
+            }
+          integer_baud_divisor = ibrd;
+          fractional_baud_divisor = fbrd;
+          return true;
+        }
+
+      /// @brief Return the current integer baud rate divisor value
+        register_t get_integer_baud_divisor() volatile const
+        {
+          return integer_baud_divisor & ibrd_max;
+        }
+
+      /// @brief Return the current fractional baud rate divisor value
+        register_t get_fractional_baud_divisor() volatile const
+        {
+          return fractional_baud_divisor & fbrd_mask;
+        }
+
+      /// @brief Set the LCRH word length (WLEN) field.
+      /// @param[in] bits Data bits per character [5,8].
+      /// @returns \c true if bits was in range and set, \c false if not.
+        bool set_word_length(register_t bits) volatile
+        {
+          if (bits<5U || bits>8U)
+            {
+              return false;
+            }
+          line_control = (line_control&~lcrh_word_length_mask)
+                       | ((bits-5U)<<lcrh_word_length_bit);
+          return true;
+        }
+
+      /// @brief Return the LCRH word length (WLEN) field as data bits [5,8]
+        register_t get_word_length() volatile const
+        {
+          return ((line_control&lcrh_word_length_mask)>>lcrh_word_length_bit)
+                + 5U;
+        }
+
+      /// @brief Set or clear the LCRH send break (BRK) bit
+      /// @param[in] send \c true to hold the TXD line low after the current
+      ///                 character, \c false to release it.
+        void set_send_break(bool send) volatile
+        {
+          line_control = send ? (line_control|lcrh_break)
+                              : (line_control&~lcrh_break);
+        }
+
+      /// @brief Set or clear the LCRH FIFOs enable (FEN) bit
+      ///
+      /// Clearing FEN flushes the transmit and receive FIFOs.
+      ///
+      /// @param[in] enable \c true to enable the FIFOs, \c false to use
+      ///                   1-byte holding registers.
+        void set_fifo_enable(bool enable) volatile
+        {
+          line_control = enable ? (line_control|lcrh_fifo_enable)
+                                : (line_control&~lcrh_fifo_enable);
+        }
+
+      /// @brief Return the LCRH FIFOs enable (FEN) bit value
+        bool get_fifo_enable() volatile const
+        {
+          return line_control & lcrh_fifo_enable;
+        }
+
+      /// @brief Enable or disable the UART and its transmitter and receiver
+      /// @param[in] enable \c true to set UARTEN, TXE and RXE, \c false to
+      ///                   clear them.
+        void set_enable(bool enable) volatile
+        {
+          register_t const bits{cr_uart_enable|cr_tx_enable|cr_rx_enable};
+          control = enable ? (control|bits) : (control&~bits);
+        }
+
+      /// @brief Return the UART enable (UARTEN) bit value
+        bool get_enable() volatile const
+        {
+          return control & cr_uart_enable;
+        }
+
+      /// @brief Enable or disable RTS and CTS hardware flow control
+      /// @param[in] rts  \c true to assert RTS only while the receive FIFO has
+      ///                 space.
+      /// @param[in] cts  \c true to transmit only while CTS is asserted.
+        void set_flow_control(bool rts, bool cts) volatile
+        {
+          control = (control&~(cr_rts_enable|cr_cts_enable))
+                  | (rts ? register_t(cr_rts_enable) : 0U)
+                  | (cts ? register_t(cr_cts_enable) : 0U);
+        }
+
+      /// @brief Set the receive and transmit FIFO interrupt trigger levels
+      /// @param[in] rx Receive level: RX raw interrupt status is set while the
+      ///               receive FIFO holds at least this many entries.
+      /// @param[in] tx Transmit level: TX raw interrupt status is set while
+      ///               the transmit FIFO holds at most this many entries.
+        void set_fifo_levels(uart0_fifo_level rx, uart0_fifo_level tx) volatile
+        {
+          fifo_level_select = (static_cast<register_t>(rx)<<ifls_rx_bit)
+                            | static_cast<register_t>(tx);
+        }
+
+      /// @brief Return number of FIFO entries for a FIFO trigger level
+        constexpr static register_t fifo_level_entries(uart0_fifo_level level)
+        {
+          return level==uart0_fifo_level::eighth ? fifo_depth/8U
+               : level==uart0_fifo_level::quarter ? fifo_depth/4U
+               : level==uart0_fifo_level::half ? fifo_depth/2U
+               : level==uart0_fifo_level::three_quarters ? 3U*fifo_depth/4U
+               : 7U*fifo_depth/8U;
+        }
+
+      /// @brief Return whether raw interrupt status bits are set
+      /// @param[in] mask Raw interrupt status bits to test (int_rx, int_tx,
+      ///                 int_rx_timeout...).
+      /// @returns \c true if any bit in mask is set in the RIS register.
+        bool get_raw_interrupt(register_t mask) volatile const
+        {
+          return raw_interrupt_status & mask;
+        }
+
+      /// @brief Clear interrupts
+      /// @param[in] mask Interrupt bits to clear.
+        void clear_interrupts(register_t mask) volatile
+        {
+          interrupt_clear = mask&int_all_mask;
+        }
+
+      /// @brief Enable or disable receive DMA requests (DMACR RXDMAE)
+      /// @param[in] enable \c true to request DMA while the receive FIFO
+      ///                   holds data.
+        void set_rx_dma_enable(bool enable) volatile
+        {
+          dma_control = enable ? (dma_control|dmacr_rx_enable)
+                               : (dma_control&~dmacr_rx_enable);
+        }
+
+      /// @brief Return the receive DMA enable (DMACR RXDMAE) bit value
+        bool get_rx_dma_enable() volatile const
+        {
+          return dma_control & dmacr_rx_enable;
+        }
+      };
+   } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_UART0_REGISTERS_H
@@ -0,0 +1,173 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file vc_mailbox.cpp
+/// @brief \b Internal : VideoCore mailbox memory allocation implementation.
+///
+/// The mailbox property interface tags used are described on the Raspberry
+/// Pi firmware wiki Mailbox property interface page.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "vc_mailbox.h"
+#include <system_error>
+#include <new>
+#include <utility>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+      namespace
+      {
+        enum : register_t
+        { tag_allocate_memory = 0x3000C
+        , tag_lock_memory     = 0x3000D
+        , tag_unlock_memory   = 0x3000E
+        , tag_release_memory  = 0x3000F
+        , mem_flag_direct     = 1U<<2     // uncached, 0xC alias
+        , mem_flag_coherent   = 1U<<3     // non-allocating in L2, 0x8 alias
+        , response_success    = 0x80000000
+        , bus_alias_mask      = 0xC0000000
+        };
+
+        // Mailbox property interface ioctl request code, from vcio.h
+        unsigned long const ioctl_mbox_property{_IOWR(100, 0, char *)};
+
+        std::size_t const page_size{4096U};
+
+        int mailbox_fd()
+        {
+          static int fd{-1};
+          if (fd<0 && (fd = ::open("/dev/vcio", O_RDWR|O_CLOEXEC))<0)
+            {
+              throw std::system_error
+                    ( errno
+                    , std::system_category()
+                    , "open /dev/vcio failed. Did you forget to use 'sudo ..'? "
+                    );
+            }
+          return fd;
+        }
+
+      // Make a property call with one tag taking 1 to 3 request words and
+      // returning the first response word.
+        register_t mailbox_call
+        ( register_t tag
+        , register_t v0
+        , register_t v1 = 0U
+        , register_t v2 = 0U
+        )
+        {
+          register_t msg[9]
+                     { sizeof(msg)  // message size in bytes
+                     , 0U           // process request
+                     , tag
+                     , 12U          // tag value buffer size in bytes
+                     , 12U          // tag request size in bytes
+                     , v0, v1, v2
+                     , 0U           // end tag
+                     };
+          if (::ioctl(mailbox_fd(), ioctl_mbox_property, msg)<0)
+            {
+              throw std::system_error
+                    ( errno
+                    , std::system_category()
+                    , "vc_mem_block: mailbox property call failed with error "
+                      "from call to ioctl."
+                    );
+            }
+          if (msg[1]!=response_success)
+            {
+              throw std::system_error
+                    ( EIO
+                    , std::system_category()
+                    , "vc_mem_block: mailbox property call failed."
+                    );
+            }
+          return msg[5];
+        }
+
+        std::size_t to_page_multiple(std::size_t bytes)
+        {
+          return ((bytes==0U ? 1U : bytes)+page_size-1U)/page_size*page_size;
+        }
+
+        register_t allocate_vc_memory(std::size_t bytes)
+        {
+          register_t handle{mailbox_call( tag_allocate_memory
+                                        , static_cast<register_t>(bytes)
+                                        , page_size
+                                        , mem_flag_direct|mem_flag_coherent
+                                        )};
+          if (handle==0U)
+            {
+              throw std::bad_alloc{};
+            }
+          return handle;
+        }
+
+        register_t lock_vc_memory(register_t handle)
+        {
+          register_t bus_addr{0U};
+          try
+            {
+              bus_addr = mailbox_call(tag_lock_memory, handle);
+            }
+          catch (...)
+            {
+              mailbox_call(tag_release_memory, handle);
+              throw;
+            }
+          if (bus_addr==0U)
+            {
+              mailbox_call(tag_release_memory, handle);
+              throw std::bad_alloc{};
+            }
+          return bus_addr;
+        }
+
+        phymem_ptr<unsigned char> map_vc_memory
+        ( register_t handle
+        , register_t bus_addr
+        , std::size_t bytes
+        )
+        {
+          try
+            {
+              return phymem_ptr<unsigned char>(bus_addr&~bus_alias_mask, bytes);
+            }
+          catch (...)
+            {
+              mailbox_call(tag_unlock_memory, handle);
+              mailbox_call(tag_release_memory, handle);
+              throw;
+            }
+        }
+      }
+
+      vc_mem_block::vc_mem_block(std::size_t bytes)
+      : length{to_page_multiple(bytes)}
+      , handle{allocate_vc_memory(length)}
+      , bus_addr{lock_vc_memory(handle)}
+      , mapping{map_vc_memory(handle, bus_addr, length)}
+      {}
+
+      vc_mem_block::~vc_mem_block()
+      { // Allow no exceptions to escape.
+        { // Unmap before unlocking and releasing
+          phymem_ptr<unsigned char> unmapping{std::move(mapping)};
+        }
+        try
+          {
+            mailbox_call(tag_unlock_memory, handle);
+            mailbox_call(tag_release_memory, handle);
+          }
+        catch (...) {}
+      }
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
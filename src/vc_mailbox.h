@@ -0,0 +1,76 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file vc_mailbox.h
+/// @brief \b Internal : VideoCore mailbox memory allocation type definition.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_VC_MAILBOX_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_VC_MAILBOX_H
+
+# include "phymem_ptr.h"
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Block of locked, physically contiguous, uncached memory
+    /// allocated from the VideoCore using the /dev/vcio mailbox property
+    /// interface.
+    ///
+    /// The memory is mapped into the process through /dev/mem and has a
+    /// VideoCore bus address usable by DMA controllers. The block is unlocked
+    /// and released on destruction.
+      class vc_mem_block
+      {
+        std::size_t                 length;   ///< Block size in bytes
+        register_t                  handle;   ///< VideoCore memory handle
+        register_t                  bus_addr; ///< Block bus address
+        phymem_ptr<unsigned char>   mapping;  ///< Process mapping of block
+
+      public:
+      /// @brief Allocate, lock and map a block of VideoCore memory.
+      /// @param bytes  Minimum size of block. Rounded up to a page multiple.
+      /// @throws std::system_error if /dev/vcio or /dev/mem cannot be opened
+      ///         or a mailbox call fails.
+      /// @throws std::bad_alloc if the VideoCore cannot supply the memory.
+        explicit vc_mem_block(std::size_t bytes);
+
+      /// @brief Unmap, unlock and release the block.
+        ~vc_mem_block();
+
+        vc_mem_block(vc_mem_block const &) = delete;
+        vc_mem_block & operator=(vc_mem_block const &) = delete;
+
+      /// @brief Returns process address of start of block.
+        void * get()
+        {
+          return mapping.get();
+        }
+
+      /// @brief Returns size of block in bytes.
+        std::size_t size() const
+        {
+          return length;
+        }
+
+      /// @brief Returns bus address of start of block.
+        register_t bus_address() const
+        {
+          return bus_addr;
+        }
+
+      /// @brief Returns bus address of a location in the block.
+      /// @param p  Process address inside the block.
+        register_t bus_address(void const * p)
+        {
+          return bus_addr + static_cast<register_t>
+                              ( static_cast<unsigned char const *>(p)
+                              - mapping.get()
+                              );
+        }
+      };
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_VC_MAILBOX_H
@@ -0,0 +1,73 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file wait_policy.cpp
+/// @brief Adaptive wait implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "wait_policy.h"
+#include "irq_event.h"
+#include <thread>
+#include <sched.h>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    constexpr unsigned wait_policy::default_spin_count;
+    constexpr unsigned wait_policy::default_yield_count;
+    constexpr unsigned wait_policy::default_sleep_ns;
+
+    adaptive_wait::~adaptive_wait()
+    {
+      restart();
+    }
+
+    void adaptive_wait::restart()
+    {
+      if (polls==0U)
+        {
+          return;
+        }
+      if (polls<=policy.spin_count)
+        {
+          ++stats.spin_waits;
+        }
+      else if (policy.interrupt)
+        {
+          ++stats.interrupt_waits;
+        }
+      else if (polls-policy.spin_count<=policy.yield_count)
+        {
+          ++stats.yield_waits;
+        }
+      else
+        {
+          ++stats.sleep_waits;
+        }
+      polls = 0U;
+    }
+
+    void adaptive_wait::pause()
+    {
+      if (polls<policy.spin_count)
+        {
+          ++polls;
+        }
+      else if (policy.interrupt)
+        {
+          polls = policy.spin_count+1U;
+          policy.interrupt->wait(policy.sleep_time);
+        }
+      else if (polls-policy.spin_count<policy.yield_count)
+        {
+          ++polls;
+          ::sched_yield();
+        }
+      else
+        { // Stop counting once sleeping so polls cannot wrap around
+          polls = policy.spin_count+policy.yield_count+1U;
+          std::this_thread::sleep_for(policy.sleep_time);
+        }
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
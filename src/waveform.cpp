@@ -0,0 +1,273 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file waveform.cpp
+/// @brief DMA paced GPIO output waveform implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "waveform.h"
+#include "waveform_compiler.h"
+#include "dma_arena.h"
+#include "gpio_registers.h"
+#include "pwm_ctrl.h"
+#include "clock_parameters.h"
+#include "dma_ctrl.h"
+#include "periexcept.h"
+#include <cstddef>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      namespace
+      {
+        register_t const gpset0_bus_address
+                  { peripheral_bus_address(gpio_registers::physical_address)
+                  + static_cast<register_t>(offsetof(gpio_registers, gpset))
+                  };
+        register_t const gpclr0_bus_address
+                  { peripheral_bus_address(gpio_registers::physical_address)
+                  + static_cast<register_t>(offsetof(gpio_registers, gpclr))
+                  };
+        register_t const pwm_fifo_bus_address
+                  { peripheral_bus_address(pwm_registers::physical_address)
+                  + static_cast<register_t>(offsetof(pwm_registers, fifo_in))
+                  };
+
+      // Words per step in data area: GPSET0, GPSET1, GPCLR0, GPCLR1 values.
+        std::size_t const step_data_words{4U};
+
+      // Delay control block lengths are limited to the 30 bit TXFR_LEN field
+        std::uint32_t const max_delay_ticks{0x3FFFFFFFU/sizeof(register_t)};
+
+        std::size_t count_control_blocks
+        ( std::vector<waveform_bank_step> const & steps
+        )
+        {
+          std::size_t count{0U};
+          for (auto const & step : steps)
+            {
+              count += ((step.set[0]|step.set[1])!=0U)
+                     + ((step.clear[0]|step.clear[1])!=0U)
+                     + (step.delay_ticks!=0U);
+            }
+          return count;
+        }
+
+      // Data area size in bytes, including word written to PWM FIFO for delays
+        std::size_t data_size(std::size_t number_of_steps)
+        {
+          return (number_of_steps*step_data_words+1U)*sizeof(register_t);
+        }
+      }
+
+      std::size_t compiled_waveform_size
+      ( std::vector<waveform_bank_step> const & steps
+      )
+      {
+        std::size_t const cb_size{sizeof(dma_control_block)};
+        return count_control_blocks(steps)*cb_size
+             + (data_size(steps.size())+cb_size-1U)/cb_size*cb_size;
+      }
+
+      std::size_t compile_waveform
+      ( std::vector<waveform_bank_step> const & steps
+      , bool repeat
+      , void * region
+      , register_t region_bus
+      )
+      {
+        std::size_t const cb_count{count_control_blocks(steps)};
+        if (cb_count==0U)
+          {
+            throw std::invalid_argument{"compile_waveform: waveform has no "
+                                        "pin changes or delays."};
+          }
+        for (auto const & step : steps)
+          {
+            if (step.delay_ticks>max_delay_ticks)
+              {
+                throw std::invalid_argument{"compile_waveform: step delay is "
+                                            "too long."};
+              }
+          }
+        dma_control_block * cbs{static_cast<dma_control_block *>(region)};
+        register_t * data{reinterpret_cast<register_t *>(cbs+cb_count)};
+        register_t const data_bus
+          {region_bus+static_cast<register_t>(cb_count*sizeof(*cbs))};
+        register_t const fifo_word_bus
+          { data_bus
+          + static_cast<register_t>(steps.size()*step_data_words*sizeof(*data))
+          };
+        data[steps.size()*step_data_words] = 0U;
+
+        register_t const write_ti{ dma_control_block::ti_no_wide_bursts
+                                 | dma_control_block::ti_wait_resp
+                                 | dma_control_block::ti_src_inc
+                                 | dma_control_block::ti_dest_inc
+                                 };
+        register_t const delay_ti{ dma_control_block::ti_no_wide_bursts
+                                 | dma_control_block::ti_wait_resp
+                                 | dma_control_block::ti_dest_dreq
+                                 | dma_control_block::ti_permap(dma_dreq::pwm)
+                                 };
+        std::size_t cb_idx{0U};
+        auto add_cb = [&]( register_t ti, register_t src, register_t dest
+                         , register_t length
+                         )
+                      {
+                        dma_control_block & cb(cbs[cb_idx]);
+                        cb.transfer_info = ti;
+                        cb.source_address = src;
+                        cb.dest_address = dest;
+                        cb.transfer_length = length;
+                        cb.stride = 0U;
+                        ++cb_idx;
+                        cb.next_control_block
+                            = cb_idx!=cb_count
+                            ? region_bus+static_cast<register_t>
+                                                      (cb_idx*sizeof(cb))
+                            : (repeat ? region_bus : 0U);
+                        cb.reserved_do_not_use[0] = 0U;
+                        cb.reserved_do_not_use[1] = 0U;
+                      };
+        for (std::size_t idx=0; idx!=steps.size(); ++idx)
+          {
+            waveform_bank_step const & step(steps[idx]);
+            register_t * step_data{data+idx*step_data_words};
+            register_t const step_data_bus
+              { data_bus
+              + static_cast<register_t>(idx*step_data_words*sizeof(*data))
+              };
+            step_data[0] = step.set[0];
+            step_data[1] = step.set[1];
+            step_data[2] = step.clear[0];
+            step_data[3] = step.clear[1];
+            if ((step.set[0]|step.set[1])!=0U)
+              {
+                add_cb(write_ti, step_data_bus, gpset0_bus_address
+                      , 2U*sizeof(register_t)
+                      );
+              }
+            if ((step.clear[0]|step.clear[1])!=0U)
+              {
+                add_cb(write_ti, step_data_bus+2U*sizeof(register_t)
+                      , gpclr0_bus_address, 2U*sizeof(register_t)
+                      );
+              }
+            if (step.delay_ticks!=0U)
+              {
+                add_cb(delay_ti, fifo_word_bus, pwm_fifo_bus_address
+                      , step.delay_ticks*sizeof(register_t)
+                      );
+              }
+          }
+        return cb_count;
+      }
+
+      namespace
+      {
+      // PWM clock and range giving one PWM FIFO word consumed per microsecond
+        hertz const pwm_clock_source_frequency{megahertz{500U}};
+        hertz const pwm_clock_frequency{megahertz{10U}};
+        register_t const pwm_words_per_tick_range{10U};
+      }
+    } // namespace internal closed
+
+    using namespace internal;
+
+    waveform::waveform
+    ( opin_group const & pins
+    , std::vector<waveform_step> const & steps
+    , bool repeat
+    )
+    {
+      std::vector<waveform_bank_step> bank_steps;
+      bank_steps.reserve(steps.size());
+      for (auto const & step : steps)
+        {
+          if (((step.set|step.clear)&~pins.all_pins())!=0U)
+            {
+              throw std::invalid_argument{"waveform: step mask has pins not in "
+                                          "the opin_group."};
+            }
+          waveform_bank_step bank_step;
+          pins.to_bank_masks(step.set, bank_step.set);
+          pins.to_bank_masks(step.clear, bank_step.clear);
+          bank_step.delay_ticks = step.delay_us;
+          bank_steps.push_back(bank_step);
+        }
+      std::size_t const code_size{compiled_waveform_size(bank_steps)};
+      code.reset(new dma_arena{code_size});
+      dma_buffer const code_buffer
+                          {code->allocate(code_size, alignof(dma_control_block))};
+      code_bus = code_buffer.bus_address;
+      compile_waveform(bank_steps, repeat, code_buffer.address, code_bus);
+      pwm_ctrl & pwm(pwm_ctrl::instance());
+      pwm.set_clock(clock_parameters{ clock_source::plld
+                                    , pwm_clock_source_frequency
+                                    , clock_frequency{pwm_clock_frequency}
+                                    });
+      if (!pwm.alloc.allocate(0U))
+        {
+          throw bad_peripheral_alloc{"waveform: PWM channel 1 is in use."};
+        }
+      if (!pwm.fifo_alloc.allocate(0U))
+        {
+          pwm.alloc.deallocate(0U);
+          throw bad_peripheral_alloc{"waveform: PWM FIFO is in use."};
+        }
+      try
+        {
+          dma_channel = dma_ctrl::instance().allocate_channel();
+        }
+      catch (...)
+        {
+          pwm.fifo_alloc.deallocate(0U);
+          pwm.alloc.deallocate(0U);
+          throw;
+        }
+      pwm_channel const ch{pwm_channel::pwm_ch1};
+      pwm.regs->set_enable(ch, false);
+      pwm.regs->set_dma_enable(false);
+      pwm.regs->set_mode(ch, pwm_mode::serialiser);
+      pwm.regs->set_use_fifo(ch, true);
+      pwm.regs->set_range(ch, pwm_words_per_tick_range);
+      pwm.regs->clear_fifo();
+      pwm.regs->set_dma_data_req_threshold(15U);
+      pwm.regs->set_dma_panic_threshold(15U);
+      pwm.regs->set_dma_enable(true);
+      pwm.regs->set_enable(ch, true);
+    }
+
+    waveform::~waveform()
+    {
+      dma_ctrl::instance().deallocate_channel(dma_channel);
+      pwm_ctrl & pwm(pwm_ctrl::instance());
+      pwm.regs->set_enable(pwm_channel::pwm_ch1, false);
+      pwm.regs->set_dma_enable(false);
+      pwm.fifo_alloc.deallocate(0U);
+      pwm.alloc.deallocate(0U);
+    }
+
+    void waveform::start()
+    {
+      volatile dma_channel_registers &
+                              ch(dma_ctrl::instance().regs->channel[dma_channel]);
+      ch.reset();
+      pwm_ctrl::instance().regs->clear_fifo();
+      ch.start(code_bus);
+    }
+
+    void waveform::stop()
+    {
+      dma_ctrl::instance().regs->channel[dma_channel].reset();
+    }
+
+    bool waveform::is_playing() const
+    {
+      return dma_ctrl::instance().regs->channel[dma_channel].is_active();
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
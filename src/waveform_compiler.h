@@ -0,0 +1,61 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file waveform_compiler.h
+/// @brief \b Internal : compile GPIO waveform steps into DMA control blocks :
+/// type and function declarations.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_WAVEFORM_COMPILER_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_WAVEFORM_COMPILER_H
+
+# include "dma_registers.h"
+# include <vector>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Waveform step expressed as GPIO register bank masks.
+      struct waveform_bank_step
+      {
+        register_t    set[2];     ///< GPSET0, GPSET1 values
+        register_t    clear[2];   ///< GPCLR0, GPCLR1 values
+        std::uint32_t delay_ticks;///< Pacing ticks to wait after the writes
+      };
+
+    /// @brief Returns bytes needed for the compiled form of a waveform.
+    ///
+    /// The compiled form holds control blocks followed by their data words.
+    /// @param steps  Waveform steps to compile.
+    /// @returns Size in bytes (a multiple of 32) of the compiled waveform.
+      std::size_t compiled_waveform_size
+      ( std::vector<waveform_bank_step> const & steps
+      );
+
+    /// @brief Compile waveform steps into a DMA control block chain.
+    ///
+    /// Each step becomes up to three control blocks: one writing GPSET0/1 if
+    /// any pins are set, one writing GPCLR0/1 if any pins are cleared and one
+    /// writing delay_ticks words to the PWM FIFO, paced by the PWM DREQ
+    /// signal, if delay_ticks is non-zero.
+    ///
+    /// @param steps      Waveform steps to compile.
+    /// @param repeat     If true chain last control block back to the first,
+    ///                   otherwise end the chain.
+    /// @param region     32 byte aligned memory of at least
+    ///                   compiled_waveform_size(steps) bytes.
+    /// @param region_bus Bus address of region.
+    /// @returns Number of control blocks written.
+    /// @throws std::invalid_argument if steps produce no control blocks or a
+    ///         step delay is too long for one control block.
+      std::size_t compile_waveform
+      ( std::vector<waveform_bank_step> const & steps
+      , bool repeat
+      , void * region
+      , register_t region_bus
+      );
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_WAVEFORM_COMPILER_H
@@ -0,0 +1,52 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file ws2812_encoder.h
+/// @brief \b Internal : encode WS2812 LED pixel colours as PWM serialiser
+/// bit patterns : constant and function declarations.
+///
+/// Each WS2812 data bit is sent as 3 serialiser bits at 2.4MHz: 100 for a 0
+/// and 110 for a 1, giving 1.25us bit periods with high times of 417ns and
+/// 833ns. Pixels are 24 bits sent green, red then blue, most significant bit
+/// first, so each takes 72 serialiser bits. Serialiser words are shifted out
+/// most significant bit first.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#ifndef DIBASE_RPI_PERIPHERALS_INTERNAL_WS2812_ENCODER_H
+# define DIBASE_RPI_PERIPHERALS_INTERNAL_WS2812_ENCODER_H
+
+# include <cstddef>
+# include <cstdint>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  { namespace internal
+    {
+    /// @brief Serialiser bits per pixel.
+      constexpr std::size_t ws2812_bits_per_pixel{72U};
+
+    /// @brief Zero words ending a frame, holding the line low for over 300us
+    /// so the LEDs latch the frame.
+      constexpr std::size_t ws2812_reset_words{23U};
+
+    /// @brief Returns number of serialiser words in an encoded frame.
+    /// @param pixels Number of pixels in the frame.
+      constexpr std::size_t ws2812_frame_words(std::size_t pixels)
+      {
+        return (pixels*ws2812_bits_per_pixel+31U)/32U + ws2812_reset_words;
+      }
+
+    /// @brief Encode one pixel in an encoded frame, replacing its previous
+    /// encoding and leaving other pixels' bits unchanged.
+    /// @param words  Encoded frame serialiser words.
+    /// @param pixel  Index of pixel in frame.
+    /// @param rgb    Pixel colour as 0xRRGGBB.
+      void ws2812_encode_pixel
+      ( std::uint32_t * words
+      , std::size_t pixel
+      , std::uint32_t rgb
+      );
+    } // namespace internal closed
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed
+#endif // DIBASE_RPI_PERIPHERALS_INTERNAL_WS2812_ENCODER_H
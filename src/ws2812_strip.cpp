@@ -0,0 +1,232 @@
+// Project: Raspberry Pi BCM2708 / BCM2835 peripherals C++ library
+/// @file ws2812_strip.cpp
+/// @brief WS2812 LED strip driver implementation.
+///
+/// @copyright Copyright (c) Dibase Limited 2013
+/// @author Ralph E. McArdell
+
+#include "ws2812_strip.h"
+#include "ws2812_encoder.h"
+#include "dma_arena.h"
+#include "dma_ctrl.h"
+#include "pwm_ctrl.h"
+#include "periexcept.h"
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace dibase { namespace rpi {
+  namespace peripherals
+  {
+    namespace internal
+    {
+      namespace
+      {
+      // Serialiser bit patterns for WS2812 0 and 1 bits
+        std::uint32_t const zero_bit_pattern{4U};   // 100b
+        std::uint32_t const one_bit_pattern{6U};    // 110b
+        std::size_t const pattern_bits{3U};
+
+        void put_bit(std::uint32_t * words, std::size_t bit, bool value)
+        {
+          std::uint32_t const mask{0x80000000U>>(bit%32U)};
+          words[bit/32U] = value ? (words[bit/32U]|mask)
+                                 : (words[bit/32U]&~mask);
+        }
+      }
+
+      void ws2812_encode_pixel
+      ( std::uint32_t * words
+      , std::size_t pixel
+      , std::uint32_t rgb
+      )
+      {
+        std::uint32_t const grb{ ((rgb&0x00FF00U)<<8)
+                               | ((rgb&0xFF0000U)>>8)
+                               | (rgb&0x0000FFU)
+                               };
+        std::size_t bit{pixel*ws2812_bits_per_pixel};
+        for (std::uint32_t data_mask=0x800000U; data_mask!=0U; data_mask>>=1)
+          {
+            std::uint32_t const pattern{ (grb&data_mask) ? one_bit_pattern
+                                                         : zero_bit_pattern
+                                       };
+            for (std::size_t idx=pattern_bits; idx!=0U; --idx)
+              {
+                put_bit(words, bit++, (pattern>>(idx-1U))&1U);
+              }
+          }
+      }
+
+      namespace
+      {
+        register_t const pwm_fifo_bus_address
+                  { peripheral_bus_address(pwm_registers::physical_address)
+                  + static_cast<register_t>(offsetof(pwm_registers, fifo_in))
+                  };
+
+      // Control block transfer lengths are limited by the TXFR_LEN field
+        std::size_t const max_frame_words{0x3FFFFFFFU/sizeof(register_t)};
+
+      // Serialiser bits per FIFO word and frequency giving 3 bits per 1.25us
+        unsigned const serialiser_range{32U};
+        hertz const ws2812_pwm_clock_frequency{kilohertz{2400U}};
+      }
+    } // namespace internal closed
+
+    using namespace internal;
+
+    ws2812_strip::ws2812_strip(pin_id p, std::size_t pixels)
+    : colours(pixels, 0U)
+    , changed(pixels, false)
+    , frame{nullptr}
+    , cb_bus{0U}
+    , dma_channel{0U}
+    {
+      if (pixels==0U)
+        {
+          throw std::invalid_argument{"ws2812_strip::ws2812_strip: pixels "
+                                      "parameter is zero."};
+        }
+      std::size_t const words{ws2812_frame_words(pixels)};
+      if (words>max_frame_words)
+        {
+          throw std::invalid_argument{"ws2812_strip::ws2812_strip: pixels "
+                                      "parameter is too large."};
+        }
+      pwm_pin::set_clock( rpi_oscillator
+                        , clock_frequency{ws2812_pwm_clock_frequency}
+                        );
+      pin.reset(new pwm_pin{p, serialiser_range});
+      std::size_t const frame_size{words*sizeof(register_t)};
+      memory.reset(new dma_arena{sizeof(dma_control_block)+frame_size});
+      dma_control_block & cb(*memory->allocate_control_blocks(1U));
+      frame = static_cast<std::uint32_t *>
+                                    (memory->allocate(frame_size).address);
+      std::memset(frame, 0, frame_size);
+      for (std::size_t idx=0; idx!=pixels; ++idx)
+        {
+          ws2812_encode_pixel(frame, idx, 0U);
+        }
+      cb.transfer_info = dma_control_block::ti_no_wide_bursts
+                       | dma_control_block::ti_wait_resp
+                       | dma_control_block::ti_src_inc
+                       | dma_control_block::ti_dest_dreq
+                       | dma_control_block::ti_permap(dma_dreq::pwm);
+      cb.source_address = memory->bus_address(frame);
+      cb.dest_address = pwm_fifo_bus_address;
+      cb.transfer_length = static_cast<register_t>(frame_size);
+      cb.stride = 0U;
+      cb.next_control_block = 0U;
+      cb.reserved_do_not_use[0] = 0U;
+      cb.reserved_do_not_use[1] = 0U;
+      cb_bus = memory->bus_address(&cb);
+      pwm_ctrl & pwm(pwm_ctrl::instance());
+      if (!pwm.fifo_alloc.allocate(0))
+        {
+          throw bad_peripheral_alloc( "ws2812_strip::ws2812_strip: PWM FIFO "
+                                      "is already being used locally."
+                                    );
+        }
+      try
+        {
+          dma_channel = dma_ctrl::instance().allocate_channel();
+        }
+      catch (...)
+        {
+          pwm.fifo_alloc.deallocate(0);
+          throw;
+        }
+      pwm_channel const ch{static_cast<pwm_channel>(pin->pwm)};
+      pwm.regs->set_enable(ch, false);
+      pwm.regs->set_dma_enable(false);
+      pwm.regs->set_mode(ch, pwm_mode::serialiser);
+      pwm.regs->set_use_fifo(ch, true);
+      pwm.regs->clear_fifo();
+      pwm.regs->set_dma_data_req_threshold(7U);
+      pwm.regs->set_dma_panic_threshold(7U);
+      pwm.regs->set_dma_enable(true);
+      pwm.regs->set_enable(ch, true);
+    }
+
+    ws2812_strip::~ws2812_strip()
+    {
+      dma_ctrl::instance().regs->channel[dma_channel].reset();
+      dma_ctrl::instance().deallocate_channel(dma_channel);
+      pwm_channel const ch{static_cast<pwm_channel>(pin->pwm)};
+      pwm_ctrl & pwm(pwm_ctrl::instance());
+      pwm.regs->set_enable(ch, false);
+      pwm.regs->set_dma_enable(false);
+      pwm.regs->set_use_fifo(ch, false);
+      pwm.regs->set_mode(ch, pwm_mode::pwm);
+      pwm.regs->clear_fifo();
+      pwm.fifo_alloc.deallocate(0);
+    }
+
+    void ws2812_strip::set(std::size_t idx, std::uint32_t rgb)
+    {
+      if (idx>=colours.size())
+        {
+          throw std::out_of_range{"ws2812_strip::set: idx parameter is not "
+                                  "a pixel index."};
+        }
+      rgb &= 0xFFFFFFU;
+      if (colours[idx]!=rgb)
+        {
+          colours[idx] = rgb;
+          changed[idx] = true;
+        }
+    }
+
+    std::uint32_t ws2812_strip::get(std::size_t idx) const
+    {
+      if (idx>=colours.size())
+        {
+          throw std::out_of_range{"ws2812_strip::get: idx parameter is not "
+                                  "a pixel index."};
+        }
+      return colours[idx];
+    }
+
+    void ws2812_strip::fill(std::uint32_t rgb)
+    {
+      for (std::size_t idx=0; idx!=colours.size(); ++idx)
+        {
+          set(idx, rgb);
+        }
+    }
+
+    void ws2812_strip::show()
+    {
+      wait();
+      for (std::size_t idx=0; idx!=colours.size(); ++idx)
+        {
+          if (changed[idx])
+            {
+              ws2812_encode_pixel(frame, idx, colours[idx]);
+              changed[idx] = false;
+            }
+        }
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      volatile dma_channel_registers &
+                              ch(dma_ctrl::instance().regs->channel[dma_channel]);
+      ch.reset();
+      ch.start(cb_bus);
+    }
+
+    bool ws2812_strip::is_busy() const
+    {
+      return dma_ctrl::instance().regs->channel[dma_channel].is_active();
+    }
+
+    void ws2812_strip::wait() const
+    {
+      while (is_busy())
+        {
+          std::this_thread::yield();
+        }
+    }
+  } // namespace peripherals closed
+}} // namespaces rpi and dibase closed